@@ -115,6 +115,9 @@ type CommonInstanceConfig struct {
 	Name                  string   `yaml:"name"`
 	Namespace             string   `yaml:"namespace"`
 	NoIndex               bool     `yaml:"no_index"`
+	// MaxRunTime is the number of seconds after which a run of the check is interrupted, only
+	// honoured by python checks
+	MaxRunTime int `yaml:"max_run_time"`
 }
 
 // CommonGlobalConfig holds the reserved fields for the yaml init_config data
@@ -166,6 +166,55 @@ type ProviderConfiguration struct {
 
 	// eventIds for enabletrace = FALSE
 	DisabledIDs []uint16
+
+	// PayloadFilters let the provider drop the events based on the values of their fields, before they are delivered
+	// to the session. Events without a matching filter are not affected.
+	PayloadFilters []PayloadFilter
+}
+
+// PayloadFilterOperator is the comparison of a payload filter predicate, see PAYLOAD_OPERATOR
+type PayloadFilterOperator uint16
+
+// Payload filter operators, see https://learn.microsoft.com/en-us/windows/win32/api/tdh/ne-tdh-payload_operator
+//
+//revive:disable:exported
+const (
+	PayloadFilterEqual          PayloadFilterOperator = 0
+	PayloadFilterNotEqual       PayloadFilterOperator = 1
+	PayloadFilterLessOrEqual    PayloadFilterOperator = 2
+	PayloadFilterGreaterThan    PayloadFilterOperator = 3
+	PayloadFilterLessThan       PayloadFilterOperator = 4
+	PayloadFilterGreaterOrEqual PayloadFilterOperator = 5
+	PayloadFilterBetween        PayloadFilterOperator = 6
+	PayloadFilterNotBetween     PayloadFilterOperator = 7
+	PayloadFilterModulo         PayloadFilterOperator = 8
+	PayloadFilterContains       PayloadFilterOperator = 20
+	PayloadFilterDoesNotContain PayloadFilterOperator = 21
+	PayloadFilterIs             PayloadFilterOperator = 30
+	PayloadFilterIsNot          PayloadFilterOperator = 31
+)
+
+//revive:enable:exported
+
+// PayloadFilterPredicate compares a field of an event to a value, see PAYLOAD_FILTER_PREDICATE
+type PayloadFilterPredicate struct {
+	// FieldName is the name of the field, as defined in the manifest of the provider
+	FieldName string
+	// Operator is the comparison applied to the field
+	Operator PayloadFilterOperator
+	// Value is the value to compare the field to. Ranges are given as "low,high".
+	Value string
+}
+
+// PayloadFilter is the set of predicates applied to one event of a provider
+// See https://learn.microsoft.com/en-us/windows/win32/api/tdh/nf-tdh-tdhcreatepayloadfilter
+type PayloadFilter struct {
+	// Event is the descriptor of the filtered event
+	Event DDEventDescriptor
+	// MatchAny delivers the event when any predicate matches, rather than all of them
+	MatchAny bool
+	// Predicates are the comparisons applied to the event
+	Predicates []PayloadFilterPredicate
 }
 
 // ProviderConfigurationFunc is a function used to configure a provider
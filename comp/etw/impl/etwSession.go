@@ -18,6 +18,8 @@ import (
 )
 
 /*
+#cgo LDFLAGS: -ltdh
+#include <stdlib.h>
 #include "session.h"
 */
 import "C"
@@ -84,6 +86,20 @@ func (e *etwSession) EnableProvider(providerGUID windows.GUID) error {
 		disabledFilterCount = C.ULONG(len(cfg.DisabledIDs))
 	}
 
+	var payloadFilters *C.PVOID
+	var payloadFilterCount C.ULONG
+
+	if len(cfg.PayloadFilters) > 0 {
+		handles, err := createPayloadFilters(&providerGUID, cfg.PayloadFilters)
+		if err != nil {
+			return err
+		}
+		defer deletePayloadFilters(handles)
+
+		payloadFilters = (*C.PVOID)(unsafe.SliceData(handles))
+		payloadFilterCount = C.ULONG(len(handles))
+	}
+
 	ret := windows.Errno(C.DDEnableTrace(
 		e.hSession,
 		(*C.GUID)(unsafe.Pointer(&providerGUID)),
@@ -101,6 +117,8 @@ func (e *etwSession) EnableProvider(providerGUID windows.GUID) error {
 		enabledFilterCount,
 		disabledFilters,
 		disabledFilterCount,
+		payloadFilters,
+		payloadFilterCount,
 	))
 
 	if ret != windows.ERROR_SUCCESS {
@@ -109,6 +127,84 @@ func (e *etwSession) EnableProvider(providerGUID windows.GUID) error {
 	return nil
 }
 
+// createPayloadFilters builds the TDH payload filters of a provider, they must be released with deletePayloadFilters
+func createPayloadFilters(providerGUID *windows.GUID, filters []etw.PayloadFilter) ([]C.PVOID, error) {
+	handles := make([]C.PVOID, 0, len(filters))
+	for i := range filters {
+		handle, err := createPayloadFilter(providerGUID, &filters[i])
+		if err != nil {
+			deletePayloadFilters(handles)
+			return nil, err
+		}
+		handles = append(handles, handle)
+	}
+	return handles, nil
+}
+
+func createPayloadFilter(providerGUID *windows.GUID, filter *etw.PayloadFilter) (C.PVOID, error) {
+	count := len(filter.Predicates)
+	if count == 0 {
+		return nil, fmt.Errorf("payload filter of event %d has no predicate", filter.Event.ID)
+	}
+
+	// the predicates point to their field names and values, so they all have to live in C memory
+	predicates := unsafe.Slice((*C.PAYLOAD_FILTER_PREDICATE)(C.calloc(C.size_t(count), C.size_t(unsafe.Sizeof(C.PAYLOAD_FILTER_PREDICATE{})))), count)
+	defer func() {
+		for i := range predicates {
+			C.free(unsafe.Pointer(predicates[i].FieldName))
+			C.free(unsafe.Pointer(predicates[i].Value))
+		}
+		C.free(unsafe.Pointer(&predicates[0]))
+	}()
+
+	for i, predicate := range filter.Predicates {
+		var err error
+		if predicates[i].FieldName, err = cUTF16String(predicate.FieldName); err != nil {
+			return nil, err
+		}
+		if predicates[i].Value, err = cUTF16String(predicate.Value); err != nil {
+			return nil, err
+		}
+		predicates[i].CompareOp = C.USHORT(predicate.Operator)
+	}
+
+	var matchAny C.BOOLEAN
+	if filter.MatchAny {
+		matchAny = 1
+	}
+
+	var handle C.PVOID
+	ret := windows.Errno(C.TdhCreatePayloadFilter(
+		(*C.GUID)(unsafe.Pointer(providerGUID)),
+		(*C.EVENT_DESCRIPTOR)(unsafe.Pointer(&filter.Event)),
+		matchAny,
+		C.ULONG(count),
+		&predicates[0],
+		&handle,
+	))
+	if ret != windows.ERROR_SUCCESS {
+		return nil, fmt.Errorf("failed to create payload filter for event %d: %v", filter.Event.ID, ret)
+	}
+	return handle, nil
+}
+
+func deletePayloadFilters(handles []C.PVOID) {
+	for i := range handles {
+		C.TdhDeletePayloadFilter(&handles[i])
+	}
+}
+
+// cUTF16String returns a copy of s as a NUL terminated UTF-16 string allocated in C memory
+func cUTF16String(s string) (C.LPWSTR, error) {
+	u16, err := windows.UTF16FromString(s)
+	if err != nil {
+		return nil, err
+	}
+	p := C.malloc(C.size_t(len(u16) * 2))
+	copy(unsafe.Slice((*uint16)(p), len(u16)), u16)
+	return C.LPWSTR(p), nil
+}
+
 func (e *etwSession) DisableProvider(providerGUID windows.GUID) error {
 	ret := windows.Errno(C.EnableTraceEx2(
 		e.hSession,
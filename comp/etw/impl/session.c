@@ -1,6 +1,7 @@
 #include "session.h"
 
-// This constant defines the maximum number of filter types supported.
+// This constant defines the maximum number of filter types supported: pid, enabled and disabled event IDs, payload.
+// ETW accepts a single descriptor per type.
 #define MAX_FILTER_SUPPORTED                4
 
 extern void ddEtwCallbackC(PEVENT_RECORD);
@@ -34,7 +35,9 @@ ULONG DDEnableTrace(
     USHORT*     enableFilterIDs,
     ULONG       enableFilterIDCount,
     USHORT*     disableFilterIDs,
-    ULONG       disableFilterIDCount
+    ULONG       disableFilterIDCount,
+    PVOID*      payloadFilters,
+    ULONG       payloadFilterCount
 )
 {
     EVENT_FILTER_DESCRIPTOR eventFilterDescriptors[MAX_FILTER_SUPPORTED];
@@ -48,6 +51,7 @@ ULONG DDEnableTrace(
 
     PEVENT_FILTER_EVENT_ID  enabledFilters = NULL;
     PEVENT_FILTER_EVENT_ID  disabledFilters = NULL;
+    PEVENT_FILTER_DESCRIPTOR payloadDescriptor = NULL;
     if (PIDCount > 0)
     {
         eventFilterDescriptors[eventFilterDescriptorIndex].Ptr  = (ULONGLONG)PIDs;
@@ -96,17 +100,41 @@ ULONG DDEnableTrace(
         eventFilterDescriptorIndex++;
     }
 
-    ret = EnableTraceEx2(
-        TraceHandle,
-        ProviderId,
-        ControlCode,
-        Level,
-        MatchAnyKeyword,
-        MatchAllKeyword,
-        Timeout,
-        &enableParameters
-    );
+    if (payloadFilterCount > 0)
+    {
+        // the payload filters of all the events of the provider are merged into a single descriptor
+        ret = TdhAggregatePayloadFilters(
+            payloadFilterCount,
+            payloadFilters,
+            NULL,
+            &eventFilterDescriptors[eventFilterDescriptorIndex]);
+        if (ret == ERROR_SUCCESS)
+        {
+            payloadDescriptor = &eventFilterDescriptors[eventFilterDescriptorIndex];
+
+            enableParameters.FilterDescCount++;
+            eventFilterDescriptorIndex++;
+        }
+    }
 
+    if (ret == ERROR_SUCCESS)
+    {
+        ret = EnableTraceEx2(
+            TraceHandle,
+            ProviderId,
+            ControlCode,
+            Level,
+            MatchAnyKeyword,
+            MatchAllKeyword,
+            Timeout,
+            &enableParameters
+        );
+    }
+
+    if (payloadDescriptor != NULL)
+    {
+        TdhCleanupPayloadEventFilterDescriptor(payloadDescriptor);
+    }
     if (enabledFilters != NULL)
     {
         free(enabledFilters);
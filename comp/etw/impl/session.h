@@ -38,7 +38,9 @@ ULONG DDEnableTrace(
     USHORT*     enableFilterIDs,
     ULONG       enableFilterIDCount,
     USHORT*     disableFilterIDs,
-    ULONG       disableFilterIDCount
+    ULONG       disableFilterIDCount,
+    PVOID*      payloadFilters,
+    ULONG       payloadFilterCount
 );
 TRACEHANDLE DDStartTracing(LPWSTR name, uintptr_t context);
 
@@ -9,11 +9,11 @@
 #include "bpf_tracing.h"
 #include "bpf_builtins.h"
 
-static __always_inline int get_cgroup_name(char *buf, size_t sz) {
+// get_memory_cgroup_kn returns the kernfs node of the memory cgroup of the current task
+static __always_inline struct kernfs_node *get_memory_cgroup_kn() {
     if (!bpf_helper_exists(BPF_FUNC_get_current_task)) {
-        return 0;
+        return NULL;
     }
-    bpf_memset(buf, 0, sz);
 
     struct task_struct *cur_tsk = (struct task_struct *)bpf_get_current_task();
 
@@ -25,7 +25,40 @@ static __always_inline int get_cgroup_name(char *buf, size_t sz) {
 #else
     int cgrp_id = memory_cgrp_id;
 #endif
-    const char *name = BPF_CORE_READ(cur_tsk, cgroups, subsys[cgrp_id], cgroup, kn, name);
+    return BPF_CORE_READ(cur_tsk, cgroups, subsys[cgrp_id], cgroup, kn);
+}
+
+#ifdef COMPILE_CORE
+// before 5.5 the ID of kernfs nodes is a union of the inode number and generation
+struct kernfs_node___old {
+    union {
+        __u64 id;
+    } id;
+};
+#endif
+
+// get_kernfs_node_id returns the ID of a kernfs node, which is the cgroup ID for cgroups
+static __always_inline __u64 get_kernfs_node_id(struct kernfs_node *kn) {
+    __u64 id = 0;
+#ifdef COMPILE_CORE
+    if (bpf_core_field_exists(((struct kernfs_node___old *)0)->id.id)) {
+        BPF_CORE_READ_INTO(&id, (struct kernfs_node___old *)kn, id.id);
+        return id;
+    }
+#endif
+    // when runtime compiled, 8 bytes are read from the start of the union before 5.5, which is its `id` member
+    BPF_CORE_READ_INTO(&id, kn, id);
+    return id;
+}
+
+static __always_inline int get_cgroup_name(char *buf, size_t sz) {
+    bpf_memset(buf, 0, sz);
+
+    struct kernfs_node *kn = get_memory_cgroup_kn();
+    if (!kn) {
+        return 0;
+    }
+    const char *name = BPF_CORE_READ(kn, name);
     if (bpf_probe_read_kernel(buf, sz, name) < 0) {
         return 0;
     }
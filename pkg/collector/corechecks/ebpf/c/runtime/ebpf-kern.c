@@ -33,6 +33,10 @@ BPF_LRU_MAP(map_pids, u32, u32, 0)
 // pid+perfevent_fd -> mmap length + address. resize to (num cpus * maximum concurrent maps)
 BPF_LRU_MAP(perf_event_mmap, map_fd_t, mmap_region_t, 0)
 
+// map_id -> number of entries evicted from an LRU hash map. resize to maximum LRU maps tracked
+// read from userspace
+BPF_LRU_MAP(lru_evictions, u32, u64, 0)
+
 // *** temporary argument maps ***
 
 // pid_tgid -> struct bpf_map *
@@ -382,4 +386,21 @@ int BPF_KPROBE(k_map_update, int cmd, union bpf_attr *attr) {
     return 0;
 }
 
+// count the entries evicted from LRU hash maps to make room for new ones, which the kernel doesn't report
+// otherwise. htab_lru_map_delete_node is the eviction callback of the LRU, explicit deletions don't go through it.
+// Its first argument is the struct bpf_htab of the map, which starts with the struct bpf_map.
+SEC("kprobe/htab_lru_map_delete_node")
+int BPF_KPROBE(k_lru_evict, void *htab) {
+    u32 map_id = BPF_CORE_READ((struct bpf_map *)htab, id);
+    u64 *count = bpf_map_lookup_elem(&lru_evictions, &map_id);
+    if (count) {
+        __sync_fetch_and_add(count, 1);
+        return 0;
+    }
+
+    u64 one = 1;
+    bpf_map_update_elem(&lru_evictions, &map_id, &one, BPF_NOEXIST);
+    return 0;
+}
+
 char _license[] SEC("license") = "GPL";
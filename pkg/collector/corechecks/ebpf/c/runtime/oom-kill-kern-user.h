@@ -19,6 +19,8 @@ struct oom_stats {
     char tcomm[TASK_COMM_LEN];
     // Total number of pages
     __u64 pages;
+    // ID of the memory cgroup of the triggering process
+    __u64 cgroup_id;
     // Tracks if the OOM kill was triggered by a cgroup
     __u32 memcg_oom;
 };
@@ -18,6 +18,7 @@
 #include "bpf_tracing.h"
 #include "bpf_core_read.h"
 #include "map-defs.h"
+#include "compiler.h"
 
 /*
  * The `oom_stats` hash map is used to share with the userland program system-probe
@@ -26,25 +27,70 @@
 
 BPF_HASH_MAP(oom_stats, u32, struct oom_stats, 10240)
 
-SEC("kprobe/oom_kill_process")
-int BPF_KPROBE(kprobe__oom_kill_process, struct oom_control *oc) {
-    struct oom_stats zero = {};
-    struct oom_stats new = {};
-    u32 pid = bpf_get_current_pid_tgid() >> 32;
+/*
+ * The `oom_events` map is turned into a ring buffer by system-probe when ring buffers are supported,
+ * the OOM kills are then sent right away instead of being stored per pid until the next check run
+ */
+BPF_PERF_EVENT_ARRAY_MAP(oom_events, __u32)
 
-    bpf_map_update_elem(&oom_stats, &pid, &zero, BPF_NOEXIST);
-    struct oom_stats *s = bpf_map_lookup_elem(&oom_stats, &pid);
-    if (!s) {
-        return 0;
+struct cgroup_name {
+    char name[129];
+};
+
+/*
+ * The `cgroup_names` map caches the names of the memory cgroups by cgroup ID
+ */
+BPF_LRU_MAP(cgroup_names, __u64, struct cgroup_name, 1024)
+
+static __always_inline bool ringbuffer_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("ringbuffer_enabled", val);
+    return val > 0;
+}
+
+static __always_inline bool cgroup_name_cache_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("cgroup_name_cache_enabled", val);
+    return val > 0;
+}
+
+// get_oom_cgroup reads the ID and name of the memory cgroup of the current task into `s`,
+// which is on the stack
+static __always_inline void get_oom_cgroup(struct oom_stats *s) {
+    struct kernfs_node *kn = get_memory_cgroup_kn();
+    if (!kn) {
+        return;
+    }
+    s->cgroup_id = get_kernfs_node_id(kn);
+
+    bool cache = cgroup_name_cache_enabled();
+    if (cache) {
+        struct cgroup_name *cached = bpf_map_lookup_elem(&cgroup_names, &s->cgroup_id);
+        if (cached) {
+            bpf_memcpy(s->cgroup_name, cached->name, sizeof(s->cgroup_name));
+            return;
+        }
     }
 
+    const char *name = BPF_CORE_READ(kn, name);
+    if (bpf_probe_read_kernel(s->cgroup_name, sizeof(s->cgroup_name), name) < 0) {
+        return;
+    }
+    if (cache) {
+        bpf_map_update_elem(&cgroup_names, &s->cgroup_id, s->cgroup_name, BPF_ANY);
+    }
+}
+
+SEC("kprobe/oom_kill_process")
+int BPF_KPROBE(kprobe__oom_kill_process, struct oom_control *oc) {
     // for kernel before 4.11 the prototype for bpf_probe_read helpers
     // expected a pointer to stack memory. Therefore, we work on stack
     // variable and update the map value at the end
-    bpf_memcpy(&new, s, sizeof(struct oom_stats));
+    struct oom_stats new = {};
+    u32 pid = bpf_get_current_pid_tgid() >> 32;
 
     new.pid = pid;
-    get_cgroup_name(new.cgroup_name, sizeof(new.cgroup_name));
+    get_oom_cgroup(&new);
 
     struct task_struct *p = (struct task_struct *)BPF_CORE_READ(oc, chosen);
     if (!p) {
@@ -74,7 +120,12 @@ int BPF_KPROBE(kprobe__oom_kill_process, struct oom_control *oc) {
 
     new.memcg_oom = memcg != NULL ? 1 : 0;
 
-    bpf_memcpy(s, &new, sizeof(struct oom_stats));
+    if (ringbuffer_enabled()) {
+        bpf_ringbuf_output(&oom_events, &new, sizeof(struct oom_stats), 0);
+        return 0;
+    }
+
+    bpf_map_update_elem(&oom_stats, &pid, &new, BPF_ANY);
 
     return 0;
 }
@@ -7,9 +7,14 @@ struct stats_key {
     char cgroup[129];
 };
 
+// Number of buckets of the fill ratio histograms, each of them covers 10% of the queue
+#define TCP_QUEUE_USAGE_BUCKETS 10
+
 struct stats_value {
     __u32 read_buffer_max_usage;
     __u32 write_buffer_max_usage;
+    __u32 read_buffer_usage_hist[TCP_QUEUE_USAGE_BUCKETS];
+    __u32 write_buffer_usage_hist[TCP_QUEUE_USAGE_BUCKETS];
 };
 
 #endif /* defined(TCP_QUEUE_LENGTH_KERN_USER_H) */
@@ -3,6 +3,8 @@
 #ifdef COMPILE_RUNTIME
 #include "kconfig.h"
 #include <linux/tcp.h>
+#include <linux/memcontrol.h>
+#include <uapi/linux/in.h>
 
 #if LINUX_VERSION_CODE < KERNEL_VERSION(4, 8, 0)
 // 4.8 is the first version where `bpf_get_current_task` is available
@@ -16,6 +18,7 @@
 #include "bpf_tracing.h"
 #include "bpf_core_read.h"
 #include "map-defs.h"
+#include "compiler.h"
 
 /*
  * The `tcp_queue_stats` map is used to share with the userland program system-probe
@@ -31,19 +34,42 @@ BPF_HASH_MAP(who_recvmsg, u64, struct sock *, 100)
 
 BPF_HASH_MAP(who_sendmsg, u64, struct sock *, 100)
 
-static __always_inline void check_sock(struct sock *sk) {
-    struct stats_value zero = {
-        .read_buffer_max_usage = 0,
-        .write_buffer_max_usage = 0
-    };
+static __always_inline bool histograms_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("histograms_enabled", val);
+    return val > 0;
+}
 
-    struct stats_key k;
-    if (!get_cgroup_name(k.cgroup, sizeof(k.cgroup))) {
-        return;
+// usage_bucket returns the bucket of the fill ratio histograms of a usage in per mille,
+// the last bucket also holds the queues filled over their size
+static __always_inline __u32 usage_bucket(__u32 usage) {
+    __u32 bucket = usage / (1000 / TCP_QUEUE_USAGE_BUCKETS);
+    return bucket < TCP_QUEUE_USAGE_BUCKETS ? bucket : TCP_QUEUE_USAGE_BUCKETS - 1;
+}
+
+// get_sock_cgroup_name reads the name of the memory cgroup the socket is charged to, the
+// current task is unrelated to the socket in tracepoints fired from softirqs. Sockets are only
+// charged when socket memory accounting is enabled, which is always the case with cgroup v2.
+static __always_inline int get_sock_cgroup_name(struct sock *sk, char *buf, size_t sz) {
+    bpf_memset(buf, 0, sz);
+
+    struct mem_cgroup *memcg = BPF_CORE_READ(sk, sk_memcg);
+    if (!memcg) {
+        return 0;
     }
+    const char *name = BPF_CORE_READ(memcg, css.cgroup, kn, name);
+    if (bpf_probe_read_kernel(buf, sz, name) < 0) {
+        return 0;
+    }
+
+    return 1;
+}
 
-    bpf_map_update_elem(&tcp_queue_stats, &k, &zero, BPF_NOEXIST);
-    struct stats_value *v = bpf_map_lookup_elem(&tcp_queue_stats, &k);
+static __always_inline void check_sock(struct sock *sk, struct stats_key *k) {
+    struct stats_value zero = {};
+
+    bpf_map_update_elem(&tcp_queue_stats, k, &zero, BPF_NOEXIST);
+    struct stats_value *v = bpf_map_lookup_elem(&tcp_queue_stats, k);
     if (!v) {
         return;
     }
@@ -72,14 +98,27 @@ static __always_inline void check_sock(struct sock *sk) {
     if (wqueue_usage > v->write_buffer_max_usage) {
         v->write_buffer_max_usage = wqueue_usage;
     }
-    log_debug("check_sock: name=%s read_max=%d write_max=%d", k.cgroup, v->read_buffer_max_usage, v->write_buffer_max_usage);
+    // the values are per-CPU, they don't need to be incremented atomically
+    if (histograms_enabled()) {
+        v->read_buffer_usage_hist[usage_bucket(rqueue_usage)]++;
+        v->write_buffer_usage_hist[usage_bucket(wqueue_usage)]++;
+    }
+    log_debug("check_sock: name=%s read_max=%d write_max=%d", k->cgroup, v->read_buffer_max_usage, v->write_buffer_max_usage);
+}
+
+static __always_inline void check_current_sock(struct sock *sk) {
+    struct stats_key k;
+    if (!get_cgroup_name(k.cgroup, sizeof(k.cgroup))) {
+        return;
+    }
+    check_sock(sk, &k);
 }
 
 SEC("kprobe/tcp_recvmsg")
 int BPF_KPROBE(kprobe__tcp_recvmsg, struct sock *sk) {
     u64 pid_tgid = bpf_get_current_pid_tgid();
     bpf_map_update_elem(&who_recvmsg, &pid_tgid, &sk, BPF_ANY);
-    check_sock(sk);
+    check_current_sock(sk);
     return 0;
 }
 
@@ -88,7 +127,7 @@ int BPF_KRETPROBE(kretprobe__tcp_recvmsg) {
     u64 pid_tgid = bpf_get_current_pid_tgid();
     struct sock **sk = bpf_map_lookup_elem(&who_recvmsg, &pid_tgid);
     if (sk) {
-        check_sock(*sk);
+        check_current_sock(*sk);
     }
     bpf_map_delete_elem(&who_recvmsg, &pid_tgid);
     return 0;
@@ -98,7 +137,7 @@ SEC("kprobe/tcp_sendmsg")
 int BPF_KPROBE(kprobe__tcp_sendmsg, struct sock *sk) {
     u64 pid_tgid = bpf_get_current_pid_tgid();
     bpf_map_update_elem(&who_sendmsg, &pid_tgid, &sk, BPF_ANY);
-    check_sock(sk);
+    check_current_sock(sk);
     return 0;
 }
 
@@ -107,10 +146,38 @@ int BPF_KRETPROBE(kretprobe__tcp_sendmsg) {
     u64 pid_tgid = bpf_get_current_pid_tgid();
     struct sock **sk = bpf_map_lookup_elem(&who_sendmsg, &pid_tgid);
     if (sk) {
-        check_sock(*sk);
+        check_current_sock(*sk);
     }
     bpf_map_delete_elem(&who_sendmsg, &pid_tgid);
     return 0;
 }
 
+struct inet_sock_set_state_ctx {
+    __u64 unused;
+    const void *skaddr;
+    int oldstate;
+    int newstate;
+    __u16 sport;
+    __u16 dport;
+    __u16 family;
+    __u16 protocol;
+};
+
+// Samples the queues when TCP sockets change state instead of on each message, see
+// the sample_state_changes option of the tracer
+SEC("tracepoint/sock/inet_sock_set_state")
+int tracepoint__sock__inet_sock_set_state(struct inet_sock_set_state_ctx *ctx) {
+    if (ctx->protocol != IPPROTO_TCP) {
+        return 0;
+    }
+
+    struct sock *sk = (struct sock *)ctx->skaddr;
+    struct stats_key k;
+    if (!get_sock_cgroup_name(sk, k.cgroup, sizeof(k.cgroup))) {
+        return 0;
+    }
+    check_sock(sk, &k);
+    return 0;
+}
+
 char _license[] SEC("license") = "GPL";
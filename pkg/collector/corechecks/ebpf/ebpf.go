@@ -11,6 +11,7 @@ package ebpf
 import (
 	"fmt"
 	"strings"
+	"time"
 
 	"github.com/cihub/seelog"
 	"gopkg.in/yaml.v2"
@@ -123,6 +124,13 @@ func (m *EBPFCheck) Run() error {
 		}
 		if mapStats.Entries >= 0 {
 			sender.Gauge("ebpf.maps.entry_count", float64(mapStats.Entries), "", tags)
+			if mapStats.MaxEntries > 0 {
+				// full maps drop (or evict, for LRUs) new entries, this allows to right-size max_entries
+				sender.Gauge("ebpf.maps.occupancy", float64(mapStats.Entries)/float64(mapStats.MaxEntries), "", tags)
+			}
+		}
+		if mapStats.Evictions > 0 {
+			sender.MonotonicCount("ebpf.maps.lru_evictions", float64(mapStats.Evictions), "", tags)
 		}
 		moduleTotalMapMaxSize[mapStats.Module] += mapStats.MaxSize
 		moduleTotalMapRSS[mapStats.Module] += mapStats.RSS
@@ -157,8 +165,13 @@ func (m *EBPFCheck) Run() error {
 	moduleTotalProgRSS := make(map[string]uint64)
 	moduleTotalXlatedLen := make(map[string]uint64)
 	moduleTotalVerifiedCount := make(map[string]uint64)
+	// programs of unknown modules are included, to compare the CPU cost of the agent with other eBPF users
+	moduleTotalRuntime := make(map[string]time.Duration)
+	moduleTotalRunCount := make(map[string]uint64)
 	for _, progInfo := range stats.Programs {
 		totalProgRSS += progInfo.RSS
+		moduleTotalRuntime[progInfo.Module] += progInfo.RuntimeDelta
+		moduleTotalRunCount[progInfo.Module] += progInfo.RunCountDelta
 		if progInfo.Module == "unknown" {
 			continue
 		}
@@ -235,6 +248,16 @@ func (m *EBPFCheck) Run() error {
 			sender.Gauge("ebpf.programs.verified_instruction_count_permodule_total", float64(verifiedCount), "", []string{"module:" + mod})
 		}
 	}
+	for mod, runtime := range moduleTotalRuntime {
+		if runtime > 0 {
+			sender.Count("ebpf.programs.runtime_ns_permodule_total", float64(runtime.Nanoseconds()), "", []string{"module:" + mod})
+		}
+	}
+	for mod, runCount := range moduleTotalRunCount {
+		if runCount > 0 {
+			sender.Count("ebpf.programs.run_count_permodule_total", float64(runCount), "", []string{"module:" + mod})
+		}
+	}
 
 	sender.Commit()
 	return nil
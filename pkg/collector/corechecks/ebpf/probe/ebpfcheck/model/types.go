@@ -27,7 +27,8 @@ type EBPFMapStats struct {
 	RSS        uint64
 	MaxSize    uint64
 	Type       ebpf.MapType
-	Entries    int64 // Allow negative values to indicate that the number of entries could not be calculated
+	Entries    int64  // Allow negative values to indicate that the number of entries could not be calculated
+	Evictions  uint64 // Entries evicted from LRU hash maps to make room for new ones, since the probe was loaded
 
 	// used only for tests
 	NumCPUs uint32
@@ -46,4 +47,8 @@ type EBPFProgramStats struct {
 	Runtime         time.Duration
 	VerifiedInsns   uint32
 	Type            ebpf.ProgramType
+
+	// run stats since the previous check run, summed over the programs with the same name, type and module
+	RuntimeDelta  time.Duration
+	RunCountDelta uint64
 }
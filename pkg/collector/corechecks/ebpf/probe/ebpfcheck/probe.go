@@ -44,6 +44,15 @@ var minimumKernelVersion = kernel.VersionCode(5, 5, 0)
 
 const maxMapsTracked = 20
 
+// maxLRUMapsTracked is the number of LRU hash maps whose evictions are counted
+const maxLRUMapsTracked = 1024
+
+// optionalKprobes are the attach points that may be missing from some kernels, such as static functions which
+// could be inlined, and only disable the stats relying on them
+var optionalKprobes = map[string]struct{}{
+	"htab_lru_map_delete_node": {},
+}
+
 // Probe is the eBPF side of the eBPF check
 type Probe struct {
 	statsFD               io.Closer
@@ -51,10 +60,14 @@ type Probe struct {
 	perfBufferMap         *ebpf.Map
 	ringBufferMap         *ebpf.Map
 	pidMap                *ebpf.Map
+	lruEvictionsMap       *ebpf.Map
 	links                 []link.Link
 	mapBuffers            entryCountBuffers
 	entryCountMaxRestarts int
 
+	// cumulative run stats of the programs read during the previous call to GetAndFlush, by program ID
+	lastRunStats map[uint32]programRunStats
+
 	nrcpus uint32
 }
 
@@ -119,6 +132,8 @@ func startEBPFCheck(buf bytecode.AssetReader, opts manager.Options) (*Probe, err
 			ms.MaxEntries = maxMapsTracked
 		case "perf_buffers", "perf_event_mmap":
 			ms.MaxEntries = nrcpus * maxMapsTracked
+		case "lru_evictions":
+			ms.MaxEntries = maxLRUMapsTracked
 		}
 	}
 
@@ -134,6 +149,7 @@ func startEBPFCheck(buf bytecode.AssetReader, opts manager.Options) (*Probe, err
 	p.perfBufferMap = p.coll.Maps["perf_buffers"]
 	p.ringBufferMap = p.coll.Maps["ring_buffers"]
 	p.pidMap = p.coll.Maps["map_pids"]
+	p.lruEvictionsMap = p.coll.Maps["lru_evictions"]
 	AddNameMappingsCollection(p.coll, "ebpf_check")
 
 	if err := p.attach(collSpec); err != nil {
@@ -161,6 +177,10 @@ func (k *Probe) attach(collSpec *ebpf.CollectionSpec) (err error) {
 					TraceFSPrefix: "ddebpfc",
 				})
 				if err != nil {
+					if _, ok := optionalKprobes[attachPoint]; ok {
+						log.Warnf("link kprobe %s to %s, the stats relying on it will be unavailable: %s", spec.Name, attachPoint, err)
+						continue
+					}
 					return fmt.Errorf("link kprobe %s to %s: %s", spec.Name, attachPoint, err)
 				}
 				k.links = append(k.links, l)
@@ -231,9 +251,31 @@ func progKey(ps model.EBPFProgramStats) programKey {
 	}
 }
 
+// programRunStats are the cumulative run stats of a program, only updated by the kernel when BPF_STATS_RUN_TIME
+// is enabled
+type programRunStats struct {
+	runtime  time.Duration
+	runCount uint64
+}
+
+// runDelta returns the run stats of the program since the previous check run. A program that wasn't seen during the
+// previous run was loaded since then, so all its stats are reported, while nothing is reported on the first run.
+func runDelta(last map[uint32]programRunStats, id uint32, cur programRunStats) programRunStats {
+	if last == nil {
+		return programRunStats{}
+	}
+	prev := last[id]
+	if cur.runtime < prev.runtime || cur.runCount < prev.runCount {
+		return programRunStats{}
+	}
+	return programRunStats{runtime: cur.runtime - prev.runtime, runCount: cur.runCount - prev.runCount}
+}
+
 func (k *Probe) getProgramStats(stats *model.EBPFStats) error {
 	var err error
-	uniquePrograms := make(map[programKey]struct{})
+	// index in stats.Programs of the first program with the key
+	uniquePrograms := make(map[programKey]int)
+	runStats := make(map[uint32]programRunStats, len(k.lastRunStats))
 	progid := ebpf.ProgramID(0)
 	for progid, err = ebpf.ProgramGetNextID(progid); err == nil; progid, err = ebpf.ProgramGetNextID(progid) {
 		fd, err := ProgGetFdByID(&ProgGetFdByIDAttr{ID: uint32(progid)})
@@ -283,13 +325,22 @@ func (k *Probe) getProgramStats(stats *model.EBPFStats) error {
 			RunCount:        info.RunCnt,
 			RecursionMisses: info.RecursionMisses,
 		}
+		cur := programRunStats{runtime: ps.Runtime, runCount: ps.RunCount}
+		runStats[ps.ID] = cur
+		delta := runDelta(k.lastRunStats, ps.ID, cur)
+		ps.RuntimeDelta, ps.RunCountDelta = delta.runtime, delta.runCount
+
 		key := progKey(ps)
-		if _, ok := uniquePrograms[key]; ok {
+		if i, ok := uniquePrograms[key]; ok {
+			// the CPU cost of the duplicates is still accounted for
+			stats.Programs[i].RuntimeDelta += ps.RuntimeDelta
+			stats.Programs[i].RunCountDelta += ps.RunCountDelta
 			continue
 		}
-		uniquePrograms[key] = struct{}{}
+		uniquePrograms[key] = len(stats.Programs)
 		stats.Programs = append(stats.Programs, ps)
 	}
+	k.lastRunStats = runStats
 
 	log.Tracef("found %d programs", len(stats.Programs))
 	for _, ps := range stats.Programs {
@@ -365,6 +416,10 @@ func (k *Probe) getMapStats(stats *model.EBPFStats) error {
 				// unknown modules get discarded anyway (only RSS is used for total counts)
 				baseMapStats.Entries = hashMapNumberOfEntries(mp, &k.mapBuffers, k.entryCountMaxRestarts)
 			}
+			if isLRU(info.Type) {
+				// maps without any eviction have no entry
+				_ = k.lruEvictionsMap.Lookup(uint32(mapid), &baseMapStats.Evictions)
+			}
 		case ebpf.Array, ebpf.PerCPUArray, ebpf.ProgramArray, ebpf.CGroupArray, ebpf.ArrayOfMaps:
 			baseMapStats.MaxSize, baseMapStats.RSS = arrayMemoryUsage(info, uint64(k.nrcpus))
 		case ebpf.LPMTrie:
@@ -548,3 +548,16 @@ func TestHashMapNumberOfEntriesNoMemoryCorruption(t *testing.T) {
 		})
 	}
 }
+
+func TestRunDelta(t *testing.T) {
+	cur := programRunStats{runtime: 100, runCount: 10}
+	// nothing is reported on the first run
+	assert.Equal(t, programRunStats{}, runDelta(nil, 1, cur))
+
+	last := map[uint32]programRunStats{1: {runtime: 40, runCount: 4}}
+	assert.Equal(t, programRunStats{runtime: 60, runCount: 6}, runDelta(last, 1, cur))
+	// program loaded since the previous run
+	assert.Equal(t, cur, runDelta(last, 2, cur))
+	// program ID reused by a program with lower stats
+	assert.Equal(t, programRunStats{}, runDelta(last, 1, programRunStats{runtime: 10, runCount: 1}))
+}
@@ -9,6 +9,7 @@ package model
 // OOMKillStats contains the statistics of a given socket
 type OOMKillStats struct {
 	CgroupName string `json:"cgroupName"`
+	CgroupID   uint64 `json:"cgroupID"`
 	Pid        uint32 `json:"pid"`
 	TPid       uint32 `json:"tpid"`
 	FComm      string `json:"fcomm"`
@@ -14,13 +14,21 @@ package oomkill
 import (
 	"fmt"
 	"math"
+	"os"
+	"sync"
+	"unsafe"
 
 	"golang.org/x/sys/unix"
 
 	manager "github.com/DataDog/ebpf-manager"
+	cebpf "github.com/cilium/ebpf"
+	"github.com/cilium/ebpf/asm"
+	"github.com/cilium/ebpf/features"
+	"github.com/cilium/ebpf/ringbuf"
 
 	"github.com/DataDog/datadog-agent/pkg/collector/corechecks/ebpf/probe/ebpfcheck"
 	"github.com/DataDog/datadog-agent/pkg/collector/corechecks/ebpf/probe/oomkill/model"
+	aconfig "github.com/DataDog/datadog-agent/pkg/config"
 	"github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/bytecode"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/bytecode/runtime"
@@ -37,16 +45,41 @@ import (
 */
 import "C"
 
-const oomMapName = "oom_stats"
+const (
+	oomMapName       = "oom_stats"
+	oomEventsMapName = "oom_events"
+)
+
+// Config is the configuration of the OOM Kill probe
+type Config struct {
+	*ebpf.Config
+
+	// CacheCgroupNames caches the names of the memory cgroups by cgroup ID in the kernel
+	CacheCgroupNames bool
+}
+
+// NewConfig creates a [Config] from the system-probe configuration
+func NewConfig() *Config {
+	return &Config{
+		Config:           ebpf.NewConfig(),
+		CacheCgroupNames: aconfig.SystemProbe.GetBool("system_probe_config.oom_kill.cache_cgroup_names"),
+	}
+}
 
 // Probe is the eBPF side of the OOM Kill check
 type Probe struct {
 	m      *manager.Manager
 	oomMap *maps.GenericMap[uint32, C.struct_oom_stats]
+
+	// OOM kills received from the ring buffer since the last flush, used instead of oomMap when ring buffers are
+	// supported
+	ringBuffer bool
+	mu         sync.Mutex
+	events     []model.OOMKillStats
 }
 
 // NewProbe creates a [Probe]
-func NewProbe(cfg *ebpf.Config) (*Probe, error) {
+func NewProbe(cfg *Config) (*Probe, error) {
 	if cfg.EnableCORE {
 		probe, err := loadOOMKillCOREProbe(cfg)
 		if err == nil {
@@ -62,7 +95,7 @@ func NewProbe(cfg *ebpf.Config) (*Probe, error) {
 	return loadOOMKillRuntimeCompiledProbe(cfg)
 }
 
-func loadOOMKillCOREProbe(cfg *ebpf.Config) (*Probe, error) { //nolint:revive // TODO fix revive unused-parameter
+func loadOOMKillCOREProbe(cfg *Config) (*Probe, error) {
 	kv, err := kernel.HostVersion()
 	if err != nil {
 		return nil, fmt.Errorf("error detecting kernel version: %s", err)
@@ -73,7 +106,7 @@ func loadOOMKillCOREProbe(cfg *ebpf.Config) (*Probe, error) { //nolint:revive //
 
 	var probe *Probe
 	err = ebpf.LoadCOREAsset("oom-kill.o", func(buf bytecode.AssetReader, opts manager.Options) error {
-		probe, err = startOOMKillProbe(buf, opts)
+		probe, err = startOOMKillProbe(buf, opts, cfg)
 		return err
 	})
 	if err != nil {
@@ -84,14 +117,14 @@ func loadOOMKillCOREProbe(cfg *ebpf.Config) (*Probe, error) { //nolint:revive //
 	return probe, nil
 }
 
-func loadOOMKillRuntimeCompiledProbe(cfg *ebpf.Config) (*Probe, error) {
-	buf, err := runtime.OomKill.Compile(cfg, getCFlags(cfg), nil /* llc flags */, statsd.Client)
+func loadOOMKillRuntimeCompiledProbe(cfg *Config) (*Probe, error) {
+	buf, err := runtime.OomKill.Compile(cfg.Config, getCFlags(cfg.Config), nil /* llc flags */, statsd.Client)
 	if err != nil {
 		return nil, err
 	}
 	defer buf.Close()
 
-	return startOOMKillProbe(buf, manager.Options{})
+	return startOOMKillProbe(buf, manager.Options{}, cfg)
 }
 
 func getCFlags(config *ebpf.Config) []string {
@@ -102,20 +135,61 @@ func getCFlags(config *ebpf.Config) []string {
 	return cflags
 }
 
-func startOOMKillProbe(buf bytecode.AssetReader, managerOptions manager.Options) (*Probe, error) {
+func startOOMKillProbe(buf bytecode.AssetReader, managerOptions manager.Options, cfg *Config) (*Probe, error) {
 	m := &manager.Manager{
 		Probes: []*manager.Probe{
 			{ProbeIdentificationPair: manager.ProbeIdentificationPair{EBPFFuncName: "kprobe__oom_kill_process", UID: "oom"}},
 		},
 		Maps: []*manager.Map{
 			{Name: "oom_stats"},
+			{Name: "cgroup_names"},
 		},
 	}
+	p := &Probe{m: m}
 
 	managerOptions.RLimit = &unix.Rlimit{
 		Cur: math.MaxUint64,
 		Max: math.MaxUint64,
 	}
+	if managerOptions.MapSpecEditors == nil {
+		managerOptions.MapSpecEditors = make(map[string]manager.MapSpecEditor)
+	}
+
+	var ringBuffer, cacheCgroupNames uint64
+	p.ringBuffer = features.HaveMapType(cebpf.RingBuf) == nil
+	if p.ringBuffer {
+		ringBuffer = 1
+		// the ring buffer holds about 64 OOM kills with 4k pages
+		managerOptions.MapSpecEditors[oomEventsMapName] = manager.MapSpecEditor{
+			Type:       cebpf.RingBuf,
+			MaxEntries: uint32(4 * os.Getpagesize()),
+			KeySize:    0,
+			ValueSize:  0,
+			EditorFlag: manager.EditType | manager.EditMaxEntries | manager.EditKeyValue,
+		}
+		// the OOM kills are only stored in the map when ring buffers aren't supported
+		managerOptions.MapSpecEditors[oomMapName] = manager.MapSpecEditor{MaxEntries: 1, EditorFlag: manager.EditMaxEntries}
+		m.RingBuffers = []*manager.RingBuffer{{
+			Map: manager.Map{Name: oomEventsMapName},
+			RingBufferOptions: manager.RingBufferOptions{
+				RecordGetter:  func() *ringbuf.Record { return new(ringbuf.Record) },
+				RecordHandler: p.handleRecord,
+			},
+		}}
+	} else {
+		if err := ebpf.NewHelperCallRemover(asm.FnRingbufOutput).BeforeInit(m, nil); err != nil {
+			return nil, fmt.Errorf("failed to remove the ring buffer helper calls: %w", err)
+		}
+	}
+	if cfg.CacheCgroupNames {
+		cacheCgroupNames = 1
+	} else {
+		managerOptions.MapSpecEditors["cgroup_names"] = manager.MapSpecEditor{MaxEntries: 1, EditorFlag: manager.EditMaxEntries}
+	}
+	managerOptions.ConstantEditors = append(managerOptions.ConstantEditors,
+		manager.ConstantEditor{Name: "ringbuffer_enabled", Value: ringBuffer},
+		manager.ConstantEditor{Name: "cgroup_name_cache_enabled", Value: cacheCgroupNames},
+	)
 
 	if err := m.InitWithOptions(buf, managerOptions); err != nil {
 		return nil, fmt.Errorf("failed to init manager: %w", err)
@@ -129,12 +203,23 @@ func startOOMKillProbe(buf bytecode.AssetReader, managerOptions manager.Options)
 	if err != nil {
 		return nil, fmt.Errorf("failed to get map '%s': %w", oomMapName, err)
 	}
+	p.oomMap = oomMap
 	ebpfcheck.AddNameMappings(m, "oom_kill")
 
-	return &Probe{
-		m:      m,
-		oomMap: oomMap,
-	}, nil
+	return p, nil
+}
+
+// handleRecord receives an OOM kill from the ring buffer
+func (k *Probe) handleRecord(record *ringbuf.Record, _ *manager.RingBuffer, _ *manager.Manager) {
+	if len(record.RawSample) < int(C.sizeof_struct_oom_stats) {
+		log.Debugf("invalid OOM kill record of %d bytes", len(record.RawSample))
+		return
+	}
+	stat := convertStats(*(*C.struct_oom_stats)(unsafe.Pointer(&record.RawSample[0])))
+
+	k.mu.Lock()
+	k.events = append(k.events, stat)
+	k.mu.Unlock()
 }
 
 // Close releases all associated resources
@@ -147,6 +232,13 @@ func (k *Probe) Close() {
 
 // GetAndFlush gets the stats
 func (k *Probe) GetAndFlush() (results []model.OOMKillStats) {
+	if k.ringBuffer {
+		k.mu.Lock()
+		results, k.events = k.events, nil
+		k.mu.Unlock()
+		return results
+	}
+
 	var pid uint32
 	var stat C.struct_oom_stats
 	it := k.oomMap.Iterate()
@@ -174,6 +266,7 @@ func convertStats(in C.struct_oom_stats) (out model.OOMKillStats) {
 	out.FComm = C.GoString(&in.fcomm[0])
 	out.TComm = C.GoString(&in.tcomm[0])
 	out.Pages = uint64(in.pages)
+	out.CgroupID = uint64(in.cgroup_id)
 	out.MemCgOOM = uint32(in.memcg_oom)
 	return
 }
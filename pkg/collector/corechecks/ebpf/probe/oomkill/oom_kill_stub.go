@@ -13,11 +13,21 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/ebpf"
 )
 
+// Config is not implemented on non-linux systems
+type Config struct {
+	*ebpf.Config
+}
+
+// NewConfig is not implemented on non-linux systems
+func NewConfig() *Config {
+	return &Config{}
+}
+
 // Probe is not implemented on non-linux systems
 type Probe struct{}
 
 // NewProbe is not implemented on non-linux systems
-func NewProbe(*ebpf.Config) (*Probe, error) {
+func NewProbe(*Config) (*Probe, error) {
 	return nil, ebpf.ErrNotImplemented
 }
 
@@ -20,7 +20,6 @@ import (
 	"golang.org/x/sys/unix"
 
 	"github.com/DataDog/datadog-agent/pkg/collector/corechecks/ebpf/probe/oomkill/model"
-	"github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/bytecode/runtime"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/ebpftest"
 	"github.com/DataDog/datadog-agent/pkg/process/statsd"
@@ -37,7 +36,7 @@ func TestOOMKillCompile(t *testing.T) {
 
 		cfg := testConfig()
 		cfg.BPFDebug = true
-		out, err := runtime.OomKill.Compile(cfg, []string{"-g"}, nil, statsd.Client)
+		out, err := runtime.OomKill.Compile(cfg.Config, []string{"-g"}, nil, statsd.Client)
 		require.NoError(t, err)
 		_ = out.Close()
 	})
@@ -98,6 +97,7 @@ func TestOOMKillProbe(t *testing.T) {
 		}, 10*time.Second, 500*time.Millisecond, "failed to find an OOM killed process with pid %d", cmd.Process.Pid)
 
 		assert.Regexp(t, regexp.MustCompile("run-([0-9|a-z]*).scope"), result.CgroupName, "cgroup name")
+		assert.NotZero(t, result.CgroupID, "cgroup id")
 		assert.Equal(t, result.TPid, result.Pid, "tpid == pid")
 		assert.Equal(t, "dd", result.FComm, "fcomm")
 		assert.Equal(t, "dd", result.TComm, "tcomm")
@@ -106,7 +106,7 @@ func TestOOMKillProbe(t *testing.T) {
 	})
 }
 
-func testConfig() *ebpf.Config {
-	cfg := ebpf.NewConfig()
+func testConfig() *Config {
+	cfg := NewConfig()
 	return cfg
 }
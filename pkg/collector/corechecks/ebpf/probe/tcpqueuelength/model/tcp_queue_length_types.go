@@ -11,10 +11,13 @@ type TCPQueueLengthStatsKey struct {
 	CgroupName string `json:"cgroupName"`
 }
 
-// TCPQueueLengthStatsValue is the type of the `TCPQueueLengthStats` map value: the maximum fill rate of busiest read and write buffers
+// TCPQueueLengthStatsValue is the type of the `TCPQueueLengthStats` map value: the maximum fill rate of busiest read and write buffers.
+// When histograms are enabled, the usage histograms hold the number of samples of each 10% bucket of the fill rate.
 type TCPQueueLengthStatsValue struct {
-	ReadBufferMaxUsage  uint32 `json:"read_buffer_max_usage"`
-	WriteBufferMaxUsage uint32 `json:"write_buffer_max_usage"`
+	ReadBufferMaxUsage   uint32   `json:"read_buffer_max_usage"`
+	WriteBufferMaxUsage  uint32   `json:"write_buffer_max_usage"`
+	ReadBufferUsageHist  []uint32 `json:"read_buffer_usage_hist,omitempty"`
+	WriteBufferUsageHist []uint32 `json:"write_buffer_usage_hist,omitempty"`
 }
 
 // TCPQueueLengthStats is the map of the maximum fill rate of the read and write buffers per container
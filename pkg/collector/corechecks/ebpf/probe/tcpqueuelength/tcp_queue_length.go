@@ -21,6 +21,7 @@ import (
 
 	"github.com/DataDog/datadog-agent/pkg/collector/corechecks/ebpf/probe/ebpfcheck"
 	"github.com/DataDog/datadog-agent/pkg/collector/corechecks/ebpf/probe/tcpqueuelength/model"
+	aconfig "github.com/DataDog/datadog-agent/pkg/config"
 	"github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/bytecode"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/bytecode/runtime"
@@ -34,14 +35,47 @@ const (
 	statsMapName = "tcp_queue_stats"
 )
 
+// Config is the configuration of the TCP Queue Length tracer
+type Config struct {
+	*ebpf.Config
+
+	// Histograms enables the histograms of the fill rate of the queues, on top of their maximum
+	Histograms bool
+	// SampleStateChanges samples the queues when the sockets change state, with the
+	// sock:inet_sock_set_state tracepoint, instead of on each call to tcp_recvmsg and tcp_sendmsg.
+	// The samples are attributed to the memory cgroup the socket is charged to.
+	SampleStateChanges bool
+}
+
+// NewConfig creates a [Config] from the system-probe configuration
+func NewConfig() *Config {
+	cfg := aconfig.SystemProbe
+	return &Config{
+		Config:             ebpf.NewConfig(),
+		Histograms:         cfg.GetBool("system_probe_config.tcp_queue_length.enable_histograms"),
+		SampleStateChanges: cfg.GetBool("system_probe_config.tcp_queue_length.sample_state_changes"),
+	}
+}
+
 // Tracer is the eBPF side of the TCP Queue Length check
 type Tracer struct {
-	m        *manager.Manager
-	statsMap *ebpfmaps.GenericMap[StructStatsKey, []StructStatsValue]
+	m          *manager.Manager
+	statsMap   *ebpfmaps.GenericMap[StructStatsKey, []StructStatsValue]
+	histograms bool
 }
 
 // NewTracer creates a [Tracer]
-func NewTracer(cfg *ebpf.Config) (*Tracer, error) {
+func NewTracer(cfg *Config) (*Tracer, error) {
+	if cfg.SampleStateChanges {
+		kv, err := kernel.HostVersion()
+		if err != nil {
+			return nil, fmt.Errorf("error detecting kernel version: %s", err)
+		}
+		if kv < kernel.VersionCode(4, 16, 0) {
+			return nil, fmt.Errorf("detected kernel version %s, but the sock:inet_sock_set_state tracepoint requires a kernel version of at least 4.16.0", kv)
+		}
+	}
+
 	if cfg.EnableCORE {
 		probe, err := loadTCPQueueLengthCOREProbe(cfg)
 		if err != nil {
@@ -57,14 +91,21 @@ func NewTracer(cfg *ebpf.Config) (*Tracer, error) {
 	return loadTCPQueueLengthRuntimeCompiledProbe(cfg)
 }
 
-func startTCPQueueLengthProbe(buf bytecode.AssetReader, managerOptions manager.Options) (*Tracer, error) {
-	probes := []*manager.Probe{
-		{ProbeIdentificationPair: manager.ProbeIdentificationPair{EBPFFuncName: "kprobe__tcp_recvmsg", UID: "tcpq"}},
-		{ProbeIdentificationPair: manager.ProbeIdentificationPair{EBPFFuncName: "kretprobe__tcp_recvmsg", UID: "tcpq"}},
-		{ProbeIdentificationPair: manager.ProbeIdentificationPair{EBPFFuncName: "kprobe__tcp_sendmsg", UID: "tcpq"}},
-		{ProbeIdentificationPair: manager.ProbeIdentificationPair{EBPFFuncName: "kretprobe__tcp_sendmsg", UID: "tcpq"}},
+func startTCPQueueLengthProbe(buf bytecode.AssetReader, managerOptions manager.Options, cfg *Config) (*Tracer, error) {
+	messageProbes := []string{"kprobe__tcp_recvmsg", "kretprobe__tcp_recvmsg", "kprobe__tcp_sendmsg", "kretprobe__tcp_sendmsg"}
+	stateProbe := "tracepoint__sock__inet_sock_set_state"
+
+	enabled, disabled := messageProbes, []string{stateProbe}
+	if cfg.SampleStateChanges {
+		enabled, disabled = disabled, enabled
 	}
 
+	var probes []*manager.Probe
+	for _, name := range enabled {
+		probes = append(probes, &manager.Probe{ProbeIdentificationPair: manager.ProbeIdentificationPair{EBPFFuncName: name, UID: "tcpq"}})
+	}
+	managerOptions.ExcludedFunctions = append(managerOptions.ExcludedFunctions, disabled...)
+
 	maps := []*manager.Map{
 		{Name: "tcp_queue_stats"},
 		{Name: "who_recvmsg"},
@@ -76,6 +117,21 @@ func startTCPQueueLengthProbe(buf bytecode.AssetReader, managerOptions manager.O
 		Maps:   maps,
 	}
 
+	var histograms uint64
+	if cfg.Histograms {
+		histograms = 1
+	}
+	managerOptions.ConstantEditors = append(managerOptions.ConstantEditors, manager.ConstantEditor{Name: "histograms_enabled", Value: histograms})
+	if cfg.SampleStateChanges {
+		if managerOptions.MapSpecEditors == nil {
+			managerOptions.MapSpecEditors = make(map[string]manager.MapSpecEditor)
+		}
+		// the tcp_recvmsg and tcp_sendmsg probes aren't loaded
+		for _, name := range []string{"who_recvmsg", "who_sendmsg"} {
+			managerOptions.MapSpecEditors[name] = manager.MapSpecEditor{MaxEntries: 1, EditorFlag: manager.EditMaxEntries}
+		}
+	}
+
 	managerOptions.RLimit = &unix.Rlimit{
 		Cur: math.MaxUint64,
 		Max: math.MaxUint64,
@@ -96,8 +152,9 @@ func startTCPQueueLengthProbe(buf bytecode.AssetReader, managerOptions manager.O
 	ebpfcheck.AddNameMappings(m, "tcp_queue_length")
 
 	return &Tracer{
-		m:        m,
-		statsMap: statsMap,
+		m:          m,
+		statsMap:   statsMap,
+		histograms: cfg.Histograms,
 	}, nil
 }
 
@@ -126,6 +183,10 @@ func (t *Tracer) GetAndFlush() model.TCPQueueLengthStats {
 	for it.Next(&statsKey, &statsValue) {
 		cgroupName := string(statsKey.Cgroup[:])
 		max := model.TCPQueueLengthStatsValue{}
+		if t.histograms {
+			max.ReadBufferUsageHist = make([]uint32, TCPQueueUsageBuckets)
+			max.WriteBufferUsageHist = make([]uint32, TCPQueueUsageBuckets)
+		}
 		for cpu := 0; cpu < nbCpus; cpu++ {
 			if statsValue[cpu].Read_buffer_max_usage > max.ReadBufferMaxUsage {
 				max.ReadBufferMaxUsage = statsValue[cpu].Read_buffer_max_usage
@@ -133,6 +194,10 @@ func (t *Tracer) GetAndFlush() model.TCPQueueLengthStats {
 			if statsValue[cpu].Write_buffer_max_usage > max.WriteBufferMaxUsage {
 				max.WriteBufferMaxUsage = statsValue[cpu].Write_buffer_max_usage
 			}
+			if t.histograms {
+				addUsageHist(max.ReadBufferUsageHist, &statsValue[cpu].Read_buffer_usage_hist)
+				addUsageHist(max.WriteBufferUsageHist, &statsValue[cpu].Write_buffer_usage_hist)
+			}
 		}
 		result[cgroupName] = max
 		keys = append(keys, statsKey)
@@ -149,7 +214,14 @@ func (t *Tracer) GetAndFlush() model.TCPQueueLengthStats {
 	return result
 }
 
-func loadTCPQueueLengthCOREProbe(cfg *ebpf.Config) (*Tracer, error) {
+// addUsageHist adds the per-CPU buckets of a fill rate histogram to the buckets of the sum
+func addUsageHist(sum []uint32, hist *[TCPQueueUsageBuckets]uint32) {
+	for i := range sum {
+		sum[i] += hist[i]
+	}
+}
+
+func loadTCPQueueLengthCOREProbe(cfg *Config) (*Tracer, error) {
 	kv, err := kernel.HostVersion()
 	if err != nil {
 		return nil, fmt.Errorf("error detecting kernel version: %s", err)
@@ -165,7 +237,7 @@ func loadTCPQueueLengthCOREProbe(cfg *ebpf.Config) (*Tracer, error) {
 
 	var probe *Tracer
 	err = ebpf.LoadCOREAsset(filename, func(buf bytecode.AssetReader, opts manager.Options) error {
-		probe, err = startTCPQueueLengthProbe(buf, opts)
+		probe, err = startTCPQueueLengthProbe(buf, opts, cfg)
 		return err
 	})
 	if err != nil {
@@ -176,12 +248,12 @@ func loadTCPQueueLengthCOREProbe(cfg *ebpf.Config) (*Tracer, error) {
 	return probe, nil
 }
 
-func loadTCPQueueLengthRuntimeCompiledProbe(cfg *ebpf.Config) (*Tracer, error) {
-	compiledOutput, err := runtime.TcpQueueLength.Compile(cfg, []string{"-g"}, nil /* llc flags */, statsd.Client)
+func loadTCPQueueLengthRuntimeCompiledProbe(cfg *Config) (*Tracer, error) {
+	compiledOutput, err := runtime.TcpQueueLength.Compile(cfg.Config, []string{"-g"}, nil /* llc flags */, statsd.Client)
 	if err != nil {
 		return nil, err
 	}
 	defer compiledOutput.Close()
 
-	return startTCPQueueLengthProbe(compiledOutput, manager.Options{})
+	return startTCPQueueLengthProbe(compiledOutput, manager.Options{}, cfg)
 }
@@ -14,3 +14,5 @@ import "C"
 
 type StructStatsKey C.struct_stats_key
 type StructStatsValue C.struct_stats_value
+
+const TCPQueueUsageBuckets = C.TCP_QUEUE_USAGE_BUCKETS
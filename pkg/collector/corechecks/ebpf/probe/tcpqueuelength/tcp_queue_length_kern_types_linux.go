@@ -7,6 +7,10 @@ type StructStatsKey struct {
 	Cgroup [129]byte
 }
 type StructStatsValue struct {
-	Read_buffer_max_usage  uint32
-	Write_buffer_max_usage uint32
+	Read_buffer_max_usage   uint32
+	Write_buffer_max_usage  uint32
+	Read_buffer_usage_hist  [10]uint32
+	Write_buffer_usage_hist [10]uint32
 }
+
+const TCPQueueUsageBuckets = 0xa
@@ -13,11 +13,21 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/ebpf"
 )
 
+// Config is not implemented on non-linux systems
+type Config struct {
+	*ebpf.Config
+}
+
+// NewConfig is not implemented on non-linux systems
+func NewConfig() *Config {
+	return &Config{}
+}
+
 // Tracer is not implemented on non-linux systems
 type Tracer struct{}
 
 // NewTracer is not implemented on non-linux systems
-func NewTracer(*ebpf.Config) (*Tracer, error) {
+func NewTracer(*Config) (*Tracer, error) {
 	return nil, ebpf.ErrNotImplemented
 }
 
@@ -46,7 +46,7 @@ func TestTCPQueueLengthTracer(t *testing.T) {
 			t.Skipf("Kernel version %v is not supported by the OOM probe", kv)
 		}
 
-		cfg := ebpf.NewConfig()
+		cfg := NewConfig()
 		tcpTracer, err := NewTracer(cfg)
 		require.NoError(t, err)
 		t.Cleanup(tcpTracer.Close)
@@ -122,8 +122,20 @@ func (t *TCPQueueLengthCheck) Run() error {
 
 		sender.Gauge("tcp_queue.read_buffer_max_usage_pct", float64(v.ReadBufferMaxUsage)/1000.0, "", tags)
 		sender.Gauge("tcp_queue.write_buffer_max_usage_pct", float64(v.WriteBufferMaxUsage)/1000.0, "", tags)
+		submitUsageHist(sender, "tcp_queue.read_buffer_usage_pct", v.ReadBufferUsageHist, tags)
+		submitUsageHist(sender, "tcp_queue.write_buffer_usage_pct", v.WriteBufferUsageHist, tags)
 	}
 
 	sender.Commit()
 	return nil
 }
+
+// submitUsageHist submits the buckets of a fill rate histogram, which is empty unless histograms are enabled in
+// system-probe. The buckets are flushed by system-probe on each run.
+func submitUsageHist(s sender.Sender, metric string, hist []uint32, tags []string) {
+	for i, count := range hist {
+		lowerBound := float64(i) / float64(len(hist))
+		upperBound := float64(i+1) / float64(len(hist))
+		s.HistogramBucket(metric, int64(count), lowerBound, upperBound, false, "", tags, false)
+	}
+}
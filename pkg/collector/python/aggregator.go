@@ -11,6 +11,7 @@ package python
 import (
 	"unsafe"
 
+	"github.com/DataDog/datadog-agent/pkg/aggregator/sender"
 	checkid "github.com/DataDog/datadog-agent/pkg/collector/check/id"
 	metricsevent "github.com/DataDog/datadog-agent/pkg/metrics/event"
 	"github.com/DataDog/datadog-agent/pkg/metrics/servicecheck"
@@ -49,21 +50,62 @@ func SubmitMetric(checkID *C.char, metricType C.metric_type_t, metricName *C.cha
 	_tags := cStringArrayToSlice(tags)
 	_flushFirstValue := bool(flushFirstValue)
 
+	submitMetric(sender, metricType, _name, _value, _hostname, _tags, _flushFirstValue)
+}
+
+// SubmitMetricBatch is the method exposed to Python scripts to submit a batch of metrics
+// in a single call
+//
+//export SubmitMetricBatch
+func SubmitMetricBatch(checkID *C.char, batch *C.metric_batch_t) {
+	goCheckID := C.GoString(checkID)
+
+	checkContext, err := getCheckContext()
+	if err != nil {
+		log.Errorf("Python check context: %v", err)
+		return
+	}
+
+	sender, err := checkContext.senderManager.GetSender(checkid.ID(goCheckID))
+	if err != nil || sender == nil {
+		log.Errorf("Error submitting metric to the Sender: %v", err)
+		return
+	}
+
+	count := int(batch.count)
+	if count == 0 {
+		return
+	}
+
+	types := unsafe.Slice(batch.types, count)
+	names := unsafe.Slice(batch.names, count)
+	values := unsafe.Slice(batch.values, count)
+	hostnames := unsafe.Slice(batch.hostnames, count)
+	flushFirstValues := unsafe.Slice(batch.flush_first_values, count)
+	tagsOffsets := unsafe.Slice(batch.tags_offsets, count)
+
+	for i := 0; i < count; i++ {
+		_tags := cStringArrayToSlice((**C.char)(unsafe.Add(unsafe.Pointer(batch.tags), uintptr(tagsOffsets[i])*unsafe.Sizeof(*batch.tags))))
+		submitMetric(sender, types[i], C.GoString(names[i]), float64(values[i]), C.GoString(hostnames[i]), _tags, bool(flushFirstValues[i]))
+	}
+}
+
+func submitMetric(s sender.Sender, metricType C.metric_type_t, _name string, _value float64, _hostname string, _tags []string, _flushFirstValue bool) {
 	switch metricType {
 	case C.DATADOG_AGENT_RTLOADER_GAUGE:
-		sender.Gauge(_name, _value, _hostname, _tags)
+		s.Gauge(_name, _value, _hostname, _tags)
 	case C.DATADOG_AGENT_RTLOADER_RATE:
-		sender.Rate(_name, _value, _hostname, _tags)
+		s.Rate(_name, _value, _hostname, _tags)
 	case C.DATADOG_AGENT_RTLOADER_COUNT:
-		sender.Count(_name, _value, _hostname, _tags)
+		s.Count(_name, _value, _hostname, _tags)
 	case C.DATADOG_AGENT_RTLOADER_MONOTONIC_COUNT:
-		sender.MonotonicCountWithFlushFirstValue(_name, _value, _hostname, _tags, _flushFirstValue)
+		s.MonotonicCountWithFlushFirstValue(_name, _value, _hostname, _tags, _flushFirstValue)
 	case C.DATADOG_AGENT_RTLOADER_COUNTER:
-		sender.Counter(_name, _value, _hostname, _tags)
+		s.Counter(_name, _value, _hostname, _tags)
 	case C.DATADOG_AGENT_RTLOADER_HISTOGRAM:
-		sender.Histogram(_name, _value, _hostname, _tags)
+		s.Histogram(_name, _value, _hostname, _tags)
 	case C.DATADOG_AGENT_RTLOADER_HISTORATE:
-		sender.Historate(_name, _value, _hostname, _tags)
+		s.Historate(_name, _value, _hostname, _tags)
 	}
 }
 
@@ -164,6 +206,43 @@ func SubmitHistogramBucket(checkID *C.char, metricName *C.char, value C.longlong
 	sender.HistogramBucket(_name, _value, _lowerBound, _upperBound, _monotonic, _hostname, _tags, _flushFirstValue)
 }
 
+// SubmitHistogramBuckets is the method exposed to Python scripts to submit all the buckets of
+// a histogram in a single call
+//
+//export SubmitHistogramBuckets
+func SubmitHistogramBuckets(checkID *C.char, metricName *C.char, count C.int, values *C.longlong, lowerBounds *C.float, upperBounds *C.float, monotonic C.int, hostname *C.char, tags **C.char, flushFirstValue C.bool) {
+	goCheckID := C.GoString(checkID)
+	checkContext, err := getCheckContext()
+	if err != nil {
+		log.Errorf("Python check context: %v", err)
+		return
+	}
+
+	sender, err := checkContext.senderManager.GetSender(checkid.ID(goCheckID))
+	if err != nil || sender == nil {
+		log.Errorf("Error submitting histogram buckets to the Sender: %v", err)
+		return
+	}
+
+	n := int(count)
+	if n == 0 {
+		return
+	}
+
+	_name := C.GoString(metricName)
+	_values := unsafe.Slice(values, n)
+	_lowerBounds := unsafe.Slice(lowerBounds, n)
+	_upperBounds := unsafe.Slice(upperBounds, n)
+	_monotonic := (monotonic != 0)
+	_hostname := C.GoString(hostname)
+	_tags := cStringArrayToSlice(tags)
+	_flushFirstValue := bool(flushFirstValue)
+
+	for i := 0; i < n; i++ {
+		sender.HistogramBucket(_name, int64(_values[i]), float64(_lowerBounds[i]), float64(_upperBounds[i]), _monotonic, _hostname, _tags, _flushFirstValue)
+	}
+}
+
 // SubmitEventPlatformEvent is the method exposed to Python scripts to submit event platform events
 //
 //export SubmitEventPlatformEvent
@@ -182,3 +261,44 @@ func SubmitEventPlatformEvent(checkID *C.char, rawEventPtr *C.char, rawEventSize
 	}
 	sender.EventPlatformEvent(C.GoBytes(unsafe.Pointer(rawEventPtr), rawEventSize), C.GoString(eventType))
 }
+
+// SubmitEventPlatformEvents is the method exposed to Python scripts to submit a batch of event
+// platform events sharing the same event type in a single call
+//
+//export SubmitEventPlatformEvents
+func SubmitEventPlatformEvents(checkID *C.char, count C.int, rawEventPtrs **C.char, rawEventSizes *C.int, eventType *C.char) {
+	_checkID := C.GoString(checkID)
+	checkContext, err := getCheckContext()
+	if err != nil {
+		log.Errorf("Python check context: %v", err)
+		return
+	}
+
+	sender, err := checkContext.senderManager.GetSender(checkid.ID(_checkID))
+	if err != nil || sender == nil {
+		log.Errorf("Error submitting event platform events to the Sender: %v", err)
+		return
+	}
+
+	n := int(count)
+	if n == 0 {
+		return
+	}
+
+	ptrs := unsafe.Slice(rawEventPtrs, n)
+	sizes := unsafe.Slice(rawEventSizes, n)
+	total := 0
+	for _, size := range sizes {
+		total += int(size)
+	}
+
+	// the raw events point into the python objects, copy them all into a single buffer
+	// rather than allocating one per event
+	buf := make([]byte, 0, total)
+	_eventType := C.GoString(eventType)
+	for i := 0; i < n; i++ {
+		start := len(buf)
+		buf = append(buf, unsafe.Slice((*byte)(unsafe.Pointer(ptrs[i])), int(sizes[i]))...)
+		sender.EventPlatformEvent(buf[start:len(buf):len(buf)], _eventType)
+	}
+}
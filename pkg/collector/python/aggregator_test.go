@@ -21,6 +21,10 @@ func TestSubmitMetricEmptyHostname(t *testing.T) {
 	testSubmitMetricEmptyHostname(t)
 }
 
+func TestSubmitMetricBatch(t *testing.T) {
+	testSubmitMetricBatch(t)
+}
+
 func TestSubmitServiceCheck(t *testing.T) {
 	testSubmitServiceCheck(t)
 }
@@ -41,6 +45,14 @@ func TestSubmitHistogramBucket(t *testing.T) {
 	testSubmitHistogramBucket(t)
 }
 
+func TestSubmitHistogramBuckets(t *testing.T) {
+	testSubmitHistogramBuckets(t)
+}
+
 func TestSubmitEventPlatformEvent(t *testing.T) {
 	testSubmitEventPlatformEvent(t)
 }
+
+func TestSubmitEventPlatformEvents(t *testing.T) {
+	testSubmitEventPlatformEvents(t)
+}
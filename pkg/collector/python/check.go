@@ -29,6 +29,7 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/config"
 	"github.com/DataDog/datadog-agent/pkg/config/utils"
 	"github.com/DataDog/datadog-agent/pkg/diagnose/diagnosis"
+	"github.com/DataDog/datadog-agent/pkg/telemetry"
 	"github.com/DataDog/datadog-agent/pkg/util/log"
 )
 
@@ -47,6 +48,17 @@ const (
 	skipInstanceErrorPattern = "The integration refused to load the check configuration, it may be too old or too new."
 )
 
+var (
+	tlmCheckAllocatedBytes = telemetry.NewCounter("pymem", "check_alloc",
+		[]string{"check_name"}, "Number of bytes allocated by the python interpreter while running the check.")
+	tlmCheckWallTime = telemetry.NewCounter("python", "check_wall_time_ns",
+		[]string{"check_name"}, "Wall clock time spent running the check in the python interpreter, in nanoseconds.")
+	tlmCheckCPUTime = telemetry.NewCounter("python", "check_cpu_time_ns",
+		[]string{"check_name"}, "CPU time spent running the check in the python interpreter, in nanoseconds.")
+	tlmCheckInterruptions = telemetry.NewCounter("python", "check_interruptions",
+		[]string{"check_name"}, "Number of check runs interrupted for exceeding their max_run_time.")
+)
+
 // PythonCheck represents a Python check, implements `Check` interface
 //
 //nolint:revive // TODO(AML) Fix revive linter
@@ -58,6 +70,7 @@ type PythonCheck struct {
 	class          *C.rtloader_pyobject_t
 	ModuleName     string
 	interval       time.Duration
+	maxRunTime     time.Duration
 	lastWarnings   []error
 	source         string
 	telemetry      bool // whether or not the telemetry is enabled for this check
@@ -98,7 +111,14 @@ func (c *PythonCheck) runCheckImpl(commitMetrics bool) error {
 
 	log.Debugf("Running python check %s (version: '%s', id: '%s')", c.ModuleName, c.version, c.id)
 
+	if c.maxRunTime > 0 {
+		timer := time.AfterFunc(c.maxRunTime, c.interrupt)
+		defer timer.Stop()
+	}
+
+	setTaggerGeneration()
 	cResult := C.run_check(rtloader, c.instance)
+	c.collectRuntimeStats()
 	if cResult == nil {
 		if err := getRtLoaderError(); err != nil {
 			return err
@@ -125,6 +145,39 @@ func (c *PythonCheck) runCheckImpl(commitMetrics bool) error {
 	return errors.New(checkErrStr)
 }
 
+// interrupt raises an exception in the thread running the check once it exceeded
+// its max_run_time, so that it stops holding the GIL and delaying the other checks.
+// The check reports the exception like any other error and runs again at its next
+// interval.
+func (c *PythonCheck) interrupt() {
+	gstate, err := newStickyLock()
+	if err != nil {
+		log.Warnf("failed to interrupt check %s: %s", c.id, err)
+		return
+	}
+	defer gstate.unlock()
+
+	if C.interrupt_check(rtloader, c.instance) == 1 {
+		tlmCheckInterruptions.Inc(c.ModuleName)
+		log.Warnf("Python check %s exceeded its max_run_time of %s, interrupting it", c.id, c.maxRunTime)
+	}
+}
+
+// collectRuntimeStats reports the resources rtloader accounted for the last run of
+// the check. Must be called with the GIL held.
+func (c *PythonCheck) collectRuntimeStats() {
+	cID := TrackedCString(string(c.id))
+	defer C._free(unsafe.Pointer(cID))
+
+	var s C.check_runtime_stats_t
+	if C.get_check_runtime_stats(rtloader, cID, &s) == 0 {
+		return
+	}
+	tlmCheckAllocatedBytes.Add(float64(s.alloc), c.ModuleName)
+	tlmCheckWallTime.Add(float64(s.wall_time_ns), c.ModuleName)
+	tlmCheckCPUTime.Add(float64(s.cpu_time_ns), c.ModuleName)
+}
+
 func (c *PythonCheck) runCheck(commitMetrics bool) error {
 	ctx := context.Background()
 	var err error
@@ -267,6 +320,11 @@ func (c *PythonCheck) Configure(senderManager sender.SenderManager, integrationC
 		c.interval = time.Duration(commonOptions.MinCollectionInterval) * time.Second
 	}
 
+	// See if the runs of the check are given a time budget
+	if commonOptions.MaxRunTime > 0 {
+		c.maxRunTime = time.Duration(commonOptions.MaxRunTime) * time.Second
+	}
+
 	// Disable default hostname if specified
 	if commonOptions.EmptyDefaultHostname {
 		s, err := c.senderManager.GetSender(c.id)
@@ -8,6 +8,8 @@
 package python
 
 import (
+	"unsafe"
+
 	"github.com/DataDog/datadog-agent/pkg/util/log"
 
 	"github.com/DataDog/datadog-agent/pkg/util/containers"
@@ -46,6 +48,33 @@ func IsContainerExcluded(name, image, namespace *C.char) C.int {
 	return 0
 }
 
+// IsContainerExcludedMany sets the result of each container passed as parallel arrays of
+// names, image names and namespaces (NULL when not provided) to whether it should be
+// excluded. Used by `containers.is_excluded_many` to filter many containers at once.
+//
+//export IsContainerExcludedMany
+func IsContainerExcludedMany(count C.int, names, images, namespaces **C.char, results *C.int) {
+	// If init failed, fallback to False
+	if filter == nil || count <= 0 {
+		return
+	}
+
+	goNames := unsafe.Slice(names, count)
+	goImgs := unsafe.Slice(images, count)
+	goNamespaces := unsafe.Slice(namespaces, count)
+	goResults := unsafe.Slice(results, count)
+	for i := range goNames {
+		goNs := ""
+		if goNamespaces[i] != nil {
+			goNs = C.GoString(goNamespaces[i])
+		}
+
+		if filter.IsExcluded(nil, C.GoString(goNames[i]), C.GoString(goImgs[i]), goNs) {
+			goResults[i] = 1
+		}
+	}
+}
+
 // Separated to unit testing
 func initContainerFilter() {
 	var err error
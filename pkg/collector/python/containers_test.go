@@ -12,3 +12,7 @@ import "testing"
 func TestIsContainerExcluded(t *testing.T) {
 	testIsContainerExcluded(t)
 }
+
+func TestIsContainerExcludedMany(t *testing.T) {
+	testIsContainerExcludedMany(t)
+}
@@ -9,11 +9,14 @@ package python
 
 import (
 	"context"
+	"encoding/binary"
 	"encoding/json"
+	"strings"
 	"sync"
 	"unsafe"
 
-	yaml "gopkg.in/yaml.v2"
+	"github.com/cihub/seelog"
+	"go.uber.org/atomic"
 
 	"github.com/DataDog/datadog-agent/pkg/collector/check"
 	"github.com/DataDog/datadog-agent/pkg/collector/externalhost"
@@ -78,39 +81,65 @@ func TracemallocEnabled() C.bool {
 // Headers returns a basic set of HTTP headers that can be used by clients in Python checks.
 //
 //export Headers
-func Headers(yamlPayload **C.char) {
+func Headers(jsonPayload **C.char) {
 	h := util.HTTPHeaders()
 
-	data, err := yaml.Marshal(h)
+	data, err := json.Marshal(h)
 	if err != nil {
 		log.Errorf("datadog_agent: could not Marshal headers: %s", err)
-		*yamlPayload = nil
+		*jsonPayload = nil
 		return
 	}
-	// yamlPayload will be free by rtloader when it's done with it
-	*yamlPayload = TrackedCString(string(data))
+	// jsonPayload will be free by rtloader when it's done with it
+	*jsonPayload = TrackedCString(string(data))
 }
 
 // GetConfig returns a value from the agent configuration.
 // Indirectly used by the C function `get_config` that's mapped to `datadog_agent.get_config`.
 //
 //export GetConfig
-func GetConfig(key *C.char, yamlPayload **C.char) {
+func GetConfig(key *C.char, jsonPayload **C.char) {
 	goKey := C.GoString(key)
 	if !config.Datadog().IsSet(goKey) {
-		*yamlPayload = nil
+		*jsonPayload = nil
 		return
 	}
 
 	value := config.Datadog().Get(goKey)
-	data, err := yaml.Marshal(value)
+	// JSON is decoded by rtloader through the json C accelerator, which is much
+	// cheaper than yaml.load. Nested YAML maps must be converted first.
+	data, err := json.Marshal(util.GetJSONSerializableMap(value))
 	if err != nil {
-		log.Errorf("could not convert configuration value '%v' to YAML: %s", value, err)
-		*yamlPayload = nil
+		log.Errorf("could not convert configuration value '%v' to JSON: %s", value, err)
+		*jsonPayload = nil
 		return
 	}
-	// yaml Payload will be free by rtloader when it's done with it
-	*yamlPayload = TrackedCString(string(data))
+	// json Payload will be free by rtloader when it's done with it
+	*jsonPayload = TrackedCString(string(data))
+}
+
+// configGeneration is bumped each time the agent configuration changes, rtloader
+// drops the get_config results it cached whenever it is updated.
+var configGeneration = atomic.NewUint64(0)
+
+// initConfigGeneration enables the get_config cache in rtloader and keeps its
+// generation in sync with the agent configuration.
+func initConfigGeneration() {
+	setGeneration := func(generation uint64) {
+		glock, err := newStickyLock()
+		if err != nil {
+			log.Debugf("could not update the rtloader configuration generation: %s", err)
+			return
+		}
+		defer glock.unlock()
+
+		C.set_config_generation(rtloader, C.ulonglong(generation))
+	}
+
+	config.Datadog().OnUpdate(func(_ string, _, _ any) {
+		setGeneration(configGeneration.Inc())
+	})
+	setGeneration(configGeneration.Inc())
 }
 
 // LogMessage logs a message from python through the agent logger (see
@@ -140,6 +169,45 @@ func LogMessage(message *C.char, logLevel C.int) {
 	}
 }
 
+// pythonLogLevels maps the agent log levels to the python ones used by LogMessage, the messages are dropped by
+// rtloader when logged below the effective agent level
+var pythonLogLevels = map[seelog.LogLevel]int{
+	seelog.TraceLvl:    7,
+	seelog.DebugLvl:    10,
+	seelog.InfoLvl:     20,
+	seelog.WarnLvl:     30,
+	seelog.ErrorLvl:    40,
+	seelog.CriticalLvl: 50,
+	seelog.Off:         51,
+}
+
+// initLogLevel pushes the agent log level into rtloader and keeps it in sync with the log_level setting.
+func initLogLevel() {
+	setLevel := func(level string) {
+		level = strings.ToLower(level)
+		if level == "warning" {
+			level = "warn"
+		}
+		lvl, ok := seelog.LogLevelFromString(level)
+		if !ok {
+			// let all the messages through, the agent logger filters them
+			C.set_log_level(rtloader, 0)
+			return
+		}
+		C.set_log_level(rtloader, C.int(pythonLogLevels[lvl]))
+	}
+
+	config.Datadog().OnUpdate(func(setting string, _, newValue any) {
+		if setting != "log_level" {
+			return
+		}
+		if level, ok := newValue.(string); ok {
+			setLevel(level)
+		}
+	})
+	setLevel(config.Datadog().GetString("log_level"))
+}
+
 // SetExternalTags adds a set of tags for a given hostname to the External Host
 // Tags metadata provider cache.
 //
@@ -163,6 +231,57 @@ func SetExternalTags(hostname *C.char, sourceType *C.char, tags **C.char) {
 	externalhost.SetExternalTags(hname, stype, tagsStrings)
 }
 
+// SetExternalTagsBatch adds the tags of all the hostnames passed to a single
+// `set_external_tags` call to the External Host Tags metadata provider cache.
+// The buffer is packed by rtloader as described by cb_set_external_tags_batch_t.
+//
+//export SetExternalTagsBatch
+func SetExternalTagsBatch(buffer *C.char, size C.int) {
+	if size <= 0 {
+		return
+	}
+	buf := unsafe.Slice((*byte)(unsafe.Pointer(buffer)), int(size))
+
+	readUint32 := func() (uint32, bool) {
+		if len(buf) < 4 {
+			return 0, false
+		}
+		v := binary.NativeEndian.Uint32(buf)
+		buf = buf[4:]
+		return v, true
+	}
+	readString := func() (string, bool) {
+		l, ok := readUint32()
+		if !ok || uint64(len(buf)) < uint64(l) {
+			return "", false
+		}
+		s := string(buf[:l])
+		buf = buf[l:]
+		return s, true
+	}
+
+	for len(buf) > 0 {
+		hname, okHostname := readString()
+		stype, okSourceType := readString()
+		count, okCount := readUint32()
+		if !okHostname || !okSourceType || !okCount {
+			log.Errorf("Truncated external host tags batch")
+			return
+		}
+		// every tag takes at least its 4 bytes length
+		tagsStrings := make([]string, 0, min(int(count), len(buf)/4))
+		for i := uint32(0); i < count; i++ {
+			tag, ok := readString()
+			if !ok {
+				log.Errorf("Truncated external host tags batch for hostname %s", hname)
+				return
+			}
+			tagsStrings = append(tagsStrings, tag)
+		}
+		externalhost.SetExternalTags(hname, stype, tagsStrings)
+	}
+}
+
 // SetCheckMetadata updates a metadata value for one check instance in the cache.
 // Indirectly used by the C function `set_check_metadata` that's mapped to `datadog_agent.set_check_metadata`.
 //
@@ -202,11 +321,12 @@ func ReadPersistentCache(key *C.char) *C.char {
 }
 
 var (
-	// one obfuscator instance is shared across all python checks. It is not threadsafe but that is ok because
-	// the GIL is always locked when calling c code from python which means that the exported functions in this file
-	// will only ever be called by one goroutine at a time
+	// one obfuscator instance is shared across all python checks. It is not threadsafe and rtloader releases the
+	// GIL while the obfuscation callbacks run, so that other checks keep running, calls are serialized with
+	// obfuscatorLock instead
 	obfuscator       *obfuscate.Obfuscator
 	obfuscatorLoader sync.Once
+	obfuscatorLock   sync.Mutex
 )
 
 // lazyInitObfuscator initializes the obfuscator the first time it is used. We can't initialize during the package init
@@ -303,6 +423,7 @@ func ObfuscateSQL(rawQuery, opts *C.char, errResult **C.char) *C.char {
 		*errResult = TrackedCString(err.Error())
 	}
 	s := C.GoString(rawQuery)
+	obfuscatorLock.Lock()
 	obfuscatedQuery, err := lazyInitObfuscator().ObfuscateSQLStringWithOptions(s, &obfuscate.SQLConfig{
 		DBMS:                          sqlOpts.DBMS,
 		TableNames:                    sqlOpts.TableNames,
@@ -320,6 +441,7 @@ func ObfuscateSQL(rawQuery, opts *C.char, errResult **C.char) *C.char {
 		KeepTrailingSemicolon:         sqlOpts.KeepTrailingSemicolon,
 		KeepIdentifierQuotation:       sqlOpts.KeepIdentifierQuotation,
 	})
+	obfuscatorLock.Unlock()
 	if err != nil {
 		// memory will be freed by caller
 		*errResult = TrackedCString(err.Error())
@@ -344,10 +466,12 @@ func ObfuscateSQL(rawQuery, opts *C.char, errResult **C.char) *C.char {
 //
 //export ObfuscateSQLExecPlan
 func ObfuscateSQLExecPlan(jsonPlan *C.char, normalize C.bool, errResult **C.char) *C.char {
+	obfuscatorLock.Lock()
 	obfuscatedJSONPlan, err := lazyInitObfuscator().ObfuscateSQLExecPlan(
 		C.GoString(jsonPlan),
 		bool(normalize),
 	)
+	obfuscatorLock.Unlock()
 	if err != nil {
 		// memory will be freed by caller
 		*errResult = TrackedCString(err.Error())
@@ -563,9 +687,11 @@ func ObfuscateMongoDBString(cmd *C.char, errResult **C.char) *C.char {
 		*errResult = TrackedCString("Empty MongoDB command")
 		return nil
 	}
+	obfuscatorLock.Lock()
 	obfuscatedMongoDBString := lazyInitObfuscator().ObfuscateMongoDBString(
 		C.GoString(cmd),
 	)
+	obfuscatorLock.Unlock()
 	if obfuscatedMongoDBString == "" {
 		// memory will be freed by caller
 		*errResult = TrackedCString("Failed to obfuscate MongoDB command")
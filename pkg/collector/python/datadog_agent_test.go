@@ -34,3 +34,7 @@ func TestGetConfig(t *testing.T) {
 func TestSetExternalTags(t *testing.T) {
 	testSetExternalTags(t)
 }
+
+func TestSetExternalTagsBatch(t *testing.T) {
+	testSetExternalTagsBatch(t)
+}
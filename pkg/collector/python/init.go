@@ -52,6 +52,11 @@ void initMemoryTracker(void) {
 	set_memory_tracker_cb(MemoryTracker);
 }
 
+void MemoryTrackerBatch(rtloader_mem_record_t *, size_t);
+void initMemoryTrackerBatch(rtloader_t *rtloader) {
+	set_memory_tracker_batch_cb(rtloader, MemoryTrackerBatch);
+}
+
 //
 // init free method
 //
@@ -87,6 +92,7 @@ void Headers(char **);
 char * ReadPersistentCache(char *);
 void SetCheckMetadata(char *, char *, char *);
 void SetExternalTags(char *, char *, char **);
+void SetExternalTagsBatch(char *, int);
 void WritePersistentCache(char *, char *);
 bool TracemallocEnabled();
 char* ObfuscateSQL(char *, char *, char **);
@@ -102,6 +108,7 @@ void initDatadogAgentModule(rtloader_t *rtloader) {
 	set_headers_cb(rtloader, Headers);
 	set_set_check_metadata_cb(rtloader, SetCheckMetadata);
 	set_set_external_tags_cb(rtloader, SetExternalTags);
+	set_set_external_tags_batch_cb(rtloader, SetExternalTagsBatch);
 	set_write_persistent_cache_cb(rtloader, WritePersistentCache);
 	set_read_persistent_cache_cb(rtloader, ReadPersistentCache);
 	set_tracemalloc_enabled_cb(rtloader, TracemallocEnabled);
@@ -116,17 +123,23 @@ void initDatadogAgentModule(rtloader_t *rtloader) {
 //
 
 void SubmitMetric(char *, metric_type_t, char *, double, char **, char *, bool);
+void SubmitMetricBatch(char *, metric_batch_t *);
 void SubmitServiceCheck(char *, char *, int, char **, char *, char *);
 void SubmitEvent(char *, event_t *);
 void SubmitHistogramBucket(char *, char *, long long, float, float, int, char *, char **, bool);
+void SubmitHistogramBuckets(char *, char *, int, long long *, float *, float *, int, char *, char **, bool);
 void SubmitEventPlatformEvent(char *, char *, int, char *);
+void SubmitEventPlatformEvents(char *, int, char **, int *, char *);
 
 void initAggregatorModule(rtloader_t *rtloader) {
 	set_submit_metric_cb(rtloader, SubmitMetric);
+	set_submit_metric_batch_cb(rtloader, SubmitMetricBatch);
 	set_submit_service_check_cb(rtloader, SubmitServiceCheck);
 	set_submit_event_cb(rtloader, SubmitEvent);
 	set_submit_histogram_bucket_cb(rtloader, SubmitHistogramBucket);
+	set_submit_histogram_buckets_cb(rtloader, SubmitHistogramBuckets);
 	set_submit_event_platform_event_cb(rtloader, SubmitEventPlatformEvent);
+	set_submit_event_platform_events_cb(rtloader, SubmitEventPlatformEvents);
 }
 
 //
@@ -134,9 +147,12 @@ void initAggregatorModule(rtloader_t *rtloader) {
 //
 
 void GetSubprocessOutput(char **, char **, char **, char **, int*, char **);
+void StartSubprocess(char **, char **, int *, char **);
+void ReadSubprocessOutput(int, int, char **, int *, char **, int *, char **);
 
 void initUtilModule(rtloader_t *rtloader) {
 	set_get_subprocess_output_cb(rtloader, GetSubprocessOutput);
+	set_subprocess_output_stream_cbs(rtloader, StartSubprocess, ReadSubprocessOutput);
 }
 
 //
@@ -154,9 +170,11 @@ void initTaggerModule(rtloader_t *rtloader) {
 //
 
 int IsContainerExcluded(char *, char *, char *);
+void IsContainerExcludedMany(int, char **, char **, char **, int *);
 
 void initContainersModule(rtloader_t *rtloader) {
 	set_is_excluded_cb(rtloader, IsContainerExcluded);
+	set_is_excluded_many_cb(rtloader, IsContainerExcludedMany);
 }
 
 //
@@ -423,6 +441,12 @@ func Initialize(paths ...string) error {
 		return err
 	}
 
+	// Report rtloader allocations in bulk rather than crossing into Go on each of them
+	if config.Datadog().GetBool("memtrack_enabled") {
+		C.initMemoryTrackerBatch(rtloader)
+		startMemoryTrackerFlush()
+	}
+
 	if config.Datadog().GetBool("telemetry.enabled") && config.Datadog().GetBool("telemetry.python_memory") {
 		initPymemTelemetry()
 	}
@@ -450,6 +474,25 @@ func Initialize(paths ...string) error {
 		return addExpvarPythonInitErrors(err)
 	}
 
+	initConfigGeneration()
+	initLogLevel()
+	initTaggerGeneration()
+
+	if size := config.Datadog().GetInt("python_obfuscation_cache_size"); size > 0 {
+		C.set_obfuscation_cache_size(rtloader, C.size_t(size))
+		if config.Datadog().GetBool("telemetry.enabled") {
+			initObfuscationCacheTelemetry()
+		}
+	}
+
+	if config.Datadog().GetBool("python_persistent_cache_store") {
+		initPersistentCacheStore(filepath.Join(config.Datadog().GetString("run_path"), "python_persistent_cache.db"))
+	}
+
+	if modules := config.Datadog().GetStringSlice("python_preload_modules"); len(modules) > 0 {
+		preloadModules(modules)
+	}
+
 	// Lock the GIL
 	glock, err := newStickyLock()
 	if err != nil {
@@ -476,6 +519,55 @@ func Initialize(paths ...string) error {
 	return nil
 }
 
+// initPersistentCacheStore backs the persistent cache builtins with the rtloader store at
+// the given path. Failures are logged, the checks keep using the Go implementation then.
+func initPersistentCacheStore(path string) {
+	glock, err := newStickyLock()
+	if err != nil {
+		log.Warnf("could not open the python persistent cache store: %s", err)
+		return
+	}
+	defer glock.unlock()
+
+	cPath := TrackedCString(path)
+	defer C._free(unsafe.Pointer(cPath))
+
+	if C.set_persistent_cache_store(rtloader, cPath) == 0 {
+		log.Warnf("%s, falling back to one file per key", C.GoString(C.get_error(rtloader)))
+	}
+}
+
+// preloadModules imports the given modules so that import-heavy integrations are warm
+// before their checks first run. Failures are logged, the checks will report them again
+// when they get scheduled.
+func preloadModules(modules []string) {
+	glock, err := newStickyLock()
+	if err != nil {
+		log.Warnf("could not preload python modules: %s", err)
+		return
+	}
+	defer glock.unlock()
+
+	cModules := make([]*C.char, 0, len(modules)+1)
+	for _, m := range modules {
+		cModules = append(cModules, TrackedCString(m))
+	}
+	cModules = append(cModules, nil)
+	defer func() {
+		for _, m := range cModules[:len(modules)] {
+			C._free(unsafe.Pointer(m))
+		}
+	}()
+
+	start := time.Now()
+	failures := C.preload_modules(rtloader, &cModules[0])
+	if failures != 0 {
+		log.Warnf("could not preload %d out of %d python modules: %s", failures, len(modules), C.GoString(C.get_error(rtloader)))
+		return
+	}
+	log.Infof("preloaded %d python modules in %s", len(modules), time.Since(start))
+}
+
 // GetRtLoader returns the underlying rtloader_t struct. This is meant for testing and
 // tooling, use the rtloader_t struct at your own risk
 func GetRtLoader() *C.rtloader_t {
@@ -502,3 +594,25 @@ func initPymemTelemetry() {
 		}
 	}()
 }
+
+func initObfuscationCacheTelemetry() {
+	entries := telemetry.NewSimpleGauge("python_obfuscation_cache", "entries", "Number of SQL obfuscation results cached by rtloader.")
+	hits := telemetry.NewSimpleCounter("python_obfuscation_cache", "hits", "Number of SQL obfuscations served from the rtloader cache.")
+	misses := telemetry.NewSimpleCounter("python_obfuscation_cache", "misses", "Number of SQL obfuscations that missed the rtloader cache.")
+	evictions := telemetry.NewSimpleCounter("python_obfuscation_cache", "evictions", "Number of SQL obfuscation results evicted from the rtloader cache.")
+
+	go func() {
+		t := time.NewTicker(1 * time.Second)
+		var prev C.obfuscation_cache_stats_t
+
+		for range t.C {
+			var s C.obfuscation_cache_stats_t
+			C.get_obfuscation_cache_stats(rtloader, &s)
+			entries.Set(float64(s.entries))
+			hits.Add(float64(s.hits - prev.hits))
+			misses.Add(float64(s.misses - prev.misses))
+			evictions.Add(float64(s.evictions - prev.evictions))
+			prev = s
+		}
+	}()
+}
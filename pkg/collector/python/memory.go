@@ -12,6 +12,7 @@ import (
 	// "log"
 	"runtime/debug"
 	"sync"
+	"time"
 	"unsafe"
 
 	"github.com/cihub/seelog"
@@ -33,6 +34,11 @@ import "C"
 var (
 	pointerCache = sync.Map{}
 
+	// pendingFrees holds the batched frees of pointers whose allocation wasn't
+	// reported yet, batches not being ordered between each other.
+	pendingFrees     = map[unsafe.Pointer]struct{}{}
+	pendingFreesLock = sync.Mutex{}
+
 	// TODO(remy): if they're not exposed in the status page we may
 	// remove all these expvars
 	rtLoaderExpvars = expvar.NewMap("rtloader")
@@ -71,7 +77,88 @@ func init() {
 //export MemoryTracker
 func MemoryTracker(ptr unsafe.Pointer, sz C.size_t, op C.rtloader_mem_ops_t) {
 	// run sync for reliability reasons
+	trackMemoryOp(ptr, sz, op)
+}
+
+// MemoryTrackerBatch is the method exposed to the RTLoader to report the memory
+// operations it recorded in bulk. Batches can be reported concurrently and out of
+// order, a free reported before its allocation is kept pending until either the
+// allocation or the next periodic flush.
+//
+//export MemoryTrackerBatch
+func MemoryTrackerBatch(records *C.rtloader_mem_record_t, count C.size_t) {
+	pendingFreesLock.Lock()
+	defer pendingFreesLock.Unlock()
+
+	for _, r := range unsafe.Slice(records, int(count)) {
+		switch r.op {
+		case C.DATADOG_AGENT_RTLOADER_ALLOCATION:
+			if _, ok := pendingFrees[r.ptr]; ok {
+				delete(pendingFrees, r.ptr)
+				trackMemoryOp(r.ptr, r.sz, r.op)
+				trackMemoryOp(r.ptr, r.sz, C.DATADOG_AGENT_RTLOADER_FREE)
+				continue
+			}
+		case C.DATADOG_AGENT_RTLOADER_FREE:
+			if _, ok := pointerCache.Load(r.ptr); !ok {
+				pendingFrees[r.ptr] = struct{}{}
+				continue
+			}
+		}
+		trackMemoryOp(r.ptr, r.sz, r.op)
+	}
+}
+
+// expirePendingFrees reports the given pending frees as untracked if they're still
+// pending. It's called with the frees pending before a flush of all the threads, whose
+// allocation would otherwise have been reported by it.
+func expirePendingFrees(ptrs []unsafe.Pointer) {
+	pendingFreesLock.Lock()
+	defer pendingFreesLock.Unlock()
+
+	for _, ptr := range ptrs {
+		if _, ok := pendingFrees[ptr]; ok {
+			delete(pendingFrees, ptr)
+			trackMemoryOp(ptr, 0, C.DATADOG_AGENT_RTLOADER_FREE)
+		}
+	}
+}
+
+func getPendingFrees() []unsafe.Pointer {
+	pendingFreesLock.Lock()
+	defer pendingFreesLock.Unlock()
+
+	ptrs := make([]unsafe.Pointer, 0, len(pendingFrees))
+	for ptr := range pendingFrees {
+		ptrs = append(ptrs, ptr)
+	}
+	return ptrs
+}
+
+// flushMemoryTrackerInterval is the interval at which the memory operations recorded
+// by rtloader threads not running checks are reported.
+const flushMemoryTrackerInterval = 5 * time.Second
+
+func startMemoryTrackerFlush() {
+	go func() {
+		t := time.NewTicker(flushMemoryTrackerInterval)
+		defer t.Stop()
+
+		for range t.C {
+			pyDestroyLock.RLock()
+			if rtloader == nil {
+				pyDestroyLock.RUnlock()
+				return
+			}
+			pending := getPendingFrees()
+			C.flush_memory_tracker(rtloader)
+			pyDestroyLock.RUnlock()
+			expirePendingFrees(pending)
+		}
+	}()
+}
 
+func trackMemoryOp(ptr unsafe.Pointer, sz C.size_t, op C.rtloader_mem_ops_t) {
 	// This check looks redundant since the log level is also checked in pkg/util/log,
 	// but from profiling, even passing these vars through as arguments allocates to the heap.
 	// This is an optimization to avoid even evaluating the `Tracef` call if the trace log
@@ -10,6 +10,8 @@ package python
 import (
 	"unsafe"
 
+	"go.uber.org/atomic"
+
 	"github.com/DataDog/datadog-agent/comp/core/tagger"
 	"github.com/DataDog/datadog-agent/comp/core/tagger/types"
 	"github.com/DataDog/datadog-agent/pkg/util/log"
@@ -29,6 +31,34 @@ var (
 	tagsFunc = tagger.Tag
 )
 
+// taggerGeneration is bumped each time the tagger store changes, rtloader caches the
+// tags of each entity until the generation it was given changes.
+var taggerGeneration = atomic.NewUint64(0)
+
+// initTaggerGeneration bumps the tagger generation on every tagger store change. Tags
+// aren't cached by rtloader when no global tagger is available.
+func initTaggerGeneration() {
+	t := tagger.GetTaggerInstance()
+	if t == nil {
+		return
+	}
+
+	ch := t.Subscribe(types.HighCardinality)
+	taggerGeneration.Inc()
+	go func() {
+		for range ch {
+			taggerGeneration.Inc()
+		}
+	}()
+}
+
+// setTaggerGeneration hands the current tagger generation over to rtloader, checks
+// see the same tags for an entity during a run unless the tagger store changed
+// before. Must be called with the GIL held.
+func setTaggerGeneration() {
+	C.set_tagger_generation(rtloader, C.ulonglong(taggerGeneration.Load()))
+}
+
 // Tags bridges towards tagger.Tag to retrieve container tags
 //
 //export Tags
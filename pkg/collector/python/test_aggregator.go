@@ -133,6 +133,38 @@ func testSubmitMetricEmptyHostname(t *testing.T) {
 	sender.AssertMetric(t, "Gauge", "test_gauge", 21, "", nil)
 }
 
+func testSubmitMetricBatch(t *testing.T) {
+	sender := mocksender.NewMockSender(checkid.ID("testID"))
+	release := scopeInitCheckContext(sender.GetSenderManager())
+	defer release()
+
+	sender.SetupAcceptAll()
+
+	types := []C.metric_type_t{C.DATADOG_AGENT_RTLOADER_GAUGE, C.DATADOG_AGENT_RTLOADER_MONOTONIC_COUNT, C.DATADOG_AGENT_RTLOADER_RATE}
+	names := []*C.char{C.CString("test_gauge"), C.CString("test_monotonic_count"), C.CString("test_rate")}
+	values := []C.double{21, 22, 23}
+	hostnames := []*C.char{C.CString("my_hostname"), C.CString("my_hostname"), nil}
+	flushFirstValues := []C.bool{false, true, false}
+	tagsOffsets := []C.int{0, 3, 4}
+	cTags := []*C.char{C.CString("tag1"), C.CString("tag2"), nil, nil, C.CString("tag3"), nil}
+
+	batch := C.metric_batch_t{
+		count:              3,
+		types:              &types[0],
+		names:              &names[0],
+		values:             &values[0],
+		hostnames:          &hostnames[0],
+		flush_first_values: &flushFirstValues[0],
+		tags_offsets:       &tagsOffsets[0],
+		tags:               &cTags[0],
+	}
+	SubmitMetricBatch(C.CString("testID"), &batch)
+
+	sender.AssertMetric(t, "Gauge", "test_gauge", 21, "my_hostname", []string{"tag1", "tag2"})
+	sender.AssertMonotonicCount(t, "MonotonicCountWithFlushFirstValue", "test_monotonic_count", 22, "my_hostname", nil, true)
+	sender.AssertMetric(t, "Rate", "test_rate", 23, "", []string{"tag3"})
+}
+
 func testSubmitServiceCheck(t *testing.T) {
 	sender := mocksender.NewMockSender(checkid.ID("testID"))
 	release := scopeInitCheckContext(sender.GetSenderManager())
@@ -246,6 +278,34 @@ func testSubmitHistogramBucket(t *testing.T) {
 	sender.AssertHistogramBucket(t, "HistogramBucket", "test_histogram", 42, 1.0, 2.0, true, "my_hostname", []string{"tag1", "tag2"}, true)
 }
 
+func testSubmitHistogramBuckets(t *testing.T) {
+	sender := mocksender.NewMockSender(checkid.ID("testID"))
+	release := scopeInitCheckContext(sender.GetSenderManager())
+	defer release()
+
+	sender.SetupAcceptAll()
+
+	values := []C.longlong{3, 7}
+	lowerBounds := []C.float{0.0, 1.0}
+	upperBounds := []C.float{1.0, 2.0}
+	cTags := []*C.char{C.CString("tag1"), C.CString("tag2"), nil}
+	SubmitHistogramBuckets(
+		C.CString("testID"),
+		C.CString("test_histogram"),
+		C.int(2),
+		&values[0],
+		&lowerBounds[0],
+		&upperBounds[0],
+		C.int(0),
+		C.CString("my_hostname"),
+		&cTags[0],
+		false,
+	)
+
+	sender.AssertHistogramBucket(t, "HistogramBucket", "test_histogram", 3, 0.0, 1.0, false, "my_hostname", []string{"tag1", "tag2"}, false)
+	sender.AssertHistogramBucket(t, "HistogramBucket", "test_histogram", 7, 1.0, 2.0, false, "my_hostname", []string{"tag1", "tag2"}, false)
+}
+
 func testSubmitEventPlatformEvent(t *testing.T) {
 	sender := mocksender.NewMockSender("testID")
 	release := scopeInitCheckContext(sender.GetSenderManager())
@@ -262,6 +322,27 @@ func testSubmitEventPlatformEvent(t *testing.T) {
 	sender.AssertEventPlatformEvent(t, []byte("raw-event"), "dbm-sample")
 }
 
+func testSubmitEventPlatformEvents(t *testing.T) {
+	sender := mocksender.NewMockSender("testID")
+	release := scopeInitCheckContext(sender.GetSenderManager())
+	defer release()
+
+	sender.SetupAcceptAll()
+
+	rawEvents := []*C.char{C.CString("first-event"), C.CString("second")}
+	rawEventSizes := []C.int{C.int(len("first-event")), C.int(len("second"))}
+	SubmitEventPlatformEvents(
+		C.CString("testID"),
+		C.int(2),
+		&rawEvents[0],
+		&rawEventSizes[0],
+		C.CString("dbm-sample"),
+	)
+
+	sender.AssertEventPlatformEvent(t, []byte("first-event"), "dbm-sample")
+	sender.AssertEventPlatformEvent(t, []byte("second"), "dbm-sample")
+}
+
 func scopeInitCheckContext(senderManager sender.SenderManager) func() {
 	initializeCheckContext(senderManager)
 	return releaseCheckContext
@@ -96,6 +96,29 @@ void cancel_check(rtloader_t *s, rtloader_pyobject_t *check) {
 	return;
 }
 
+int interrupt_check_calls = 0;
+int interrupt_check_return = 0;
+rtloader_pyobject_t *interrupt_check_instance = NULL;
+int interrupt_check(rtloader_t *s, rtloader_pyobject_t *check) {
+	interrupt_check_instance = check;
+	interrupt_check_calls++;
+	return interrupt_check_return;
+}
+
+void set_tagger_generation(rtloader_t *s, unsigned long long generation) {
+	return;
+}
+
+int get_check_runtime_stats_calls = 0;
+int get_check_runtime_stats(rtloader_t *s, const char *check_id, check_runtime_stats_t *stats) {
+	get_check_runtime_stats_calls++;
+	stats->runs = 1;
+	stats->alloc = 1024;
+	stats->wall_time_ns = 2000;
+	stats->cpu_time_ns = 1000;
+	return 1;
+}
+
 char *get_check_diagnoses_return = NULL;
 int get_check_diagnoses_calls = 0;
 char *get_check_diagnoses(rtloader_t *s, rtloader_pyobject_t *check) {
@@ -183,6 +206,9 @@ void reset_check_mock() {
 	get_check_check = NULL;
 	cancel_check_calls = 0;
 	cancel_check_instance = NULL;
+	interrupt_check_calls = 0;
+	interrupt_check_return = 0;
+	interrupt_check_instance = NULL;
 
 	get_check_deprecated_calls = 0;
 	get_check_deprecated_return = 0;
@@ -196,6 +222,8 @@ void reset_check_mock() {
 
 	get_check_diagnoses_return = NULL;
 	get_check_diagnoses_calls = 0;
+
+	get_check_runtime_stats_calls = 0;
 }
 */
 import "C"
@@ -222,6 +250,7 @@ func testRunCheck(t *testing.T) {
 	assert.Equal(t, C.int(1), C.gil_unlocked_calls)
 	assert.Equal(t, C.int(1), C.run_check_calls)
 	assert.Equal(t, C.int(1), C.get_checks_warnings_calls)
+	assert.Equal(t, C.int(1), C.get_check_runtime_stats_calls)
 
 	assert.Equal(t, check.instance, C.run_check_instance)
 	assert.Equal(t, check.lastWarnings, []error{fmt.Errorf("warn1"), fmt.Errorf("warn2")})
@@ -310,6 +339,30 @@ func testCheckCancel(t *testing.T) {
 	assert.Equal(t, check.instance, C.cancel_check_instance)
 }
 
+func testCheckInterrupt(t *testing.T) {
+	rtloader = newMockRtLoaderPtr()
+	defer func() { rtloader = nil }()
+	check, err := NewPythonFakeCheck(aggregator.NewNoOpSenderManager())
+	if !assert.Nil(t, err) {
+		return
+	}
+
+	C.reset_check_mock()
+	check.instance = newMockPyObjectPtr()
+	check.maxRunTime = time.Second
+	C.interrupt_check_return = 1
+
+	check.interrupt()
+
+	// Check that the lock was acquired
+	assert.Equal(t, C.int(1), C.gil_locked_calls)
+	assert.Equal(t, C.int(1), C.gil_unlocked_calls)
+
+	// Check that the call was passed to C
+	assert.Equal(t, C.int(1), C.interrupt_check_calls)
+	assert.Equal(t, check.instance, C.interrupt_check_instance)
+}
+
 func testCheckCancelWhenRuntimeUnloaded(t *testing.T) {
 	rtloader = newMockRtLoaderPtr()
 	defer func() { rtloader = nil }()
@@ -10,12 +10,16 @@ package python
 import (
 	"regexp"
 	"testing"
+	"unsafe"
 
 	"github.com/stretchr/testify/assert"
 
 	"github.com/DataDog/datadog-agent/pkg/util/containers"
 )
 
+/*
+#include <stdlib.h>
+*/
 import "C"
 
 func testIsContainerExcluded(t *testing.T) {
@@ -41,3 +45,30 @@ func testIsContainerExcluded(t *testing.T) {
 	assert.Equal(t, IsContainerExcluded(C.CString("foo"), C.CString("baz"), C.CString("black")), C.int(1))
 	assert.Equal(t, IsContainerExcluded(C.CString("foo"), C.CString("baz"), nil), C.int(0))
 }
+
+func testIsContainerExcludedMany(t *testing.T) {
+	filter = &containers.Filter{
+		Enabled: true,
+	}
+	defer func() { filter = nil }()
+
+	r, err := regexp.Compile("bar")
+	assert.Nil(t, err)
+	filter.ImageExcludeList = append(filter.ImageExcludeList, r)
+
+	names := (**C.char)(C.malloc(C.size_t(2) * C.size_t(unsafe.Sizeof(uintptr(0)))))
+	images := (**C.char)(C.malloc(C.size_t(2) * C.size_t(unsafe.Sizeof(uintptr(0)))))
+	namespaces := (**C.char)(C.malloc(C.size_t(2) * C.size_t(unsafe.Sizeof(uintptr(0)))))
+	results := (*C.int)(C.calloc(2, C.size_t(unsafe.Sizeof(C.int(0)))))
+	defer C.free(unsafe.Pointer(names))
+	defer C.free(unsafe.Pointer(images))
+	defer C.free(unsafe.Pointer(namespaces))
+	defer C.free(unsafe.Pointer(results))
+
+	copy(unsafe.Slice(names, 2), []*C.char{C.CString("foo"), C.CString("foo")})
+	copy(unsafe.Slice(images, 2), []*C.char{C.CString("bar"), C.CString("baz")})
+	copy(unsafe.Slice(namespaces, 2), []*C.char{C.CString("ns"), nil})
+
+	IsContainerExcludedMany(2, names, images, namespaces, results)
+	assert.Equal(t, []C.int{1, 0}, unsafe.Slice(results, 2))
+}
@@ -9,6 +9,8 @@ package python
 
 import (
 	"context"
+	"encoding/binary"
+	"encoding/json"
 	"testing"
 
 	"github.com/stretchr/testify/assert"
@@ -22,6 +24,9 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/version"
 )
 
+/*
+#include <stdlib.h>
+*/
 import "C"
 
 func testGetVersion(t *testing.T) {
@@ -56,8 +61,8 @@ func testHeaders(t *testing.T) {
 	require.NotNil(t, headers)
 
 	h := util.HTTPHeaders()
-	yamlPayload, _ := yaml.Marshal(h)
-	assert.Equal(t, string(yamlPayload), C.GoString(headers))
+	jsonPayload, _ := json.Marshal(h)
+	assert.Equal(t, string(jsonPayload), C.GoString(headers))
 }
 
 func testGetConfig(t *testing.T) {
@@ -68,7 +73,7 @@ func testGetConfig(t *testing.T) {
 
 	GetConfig(C.CString("cmd_port"), &config)
 	require.NotNil(t, config)
-	assert.Equal(t, "5001\n", C.GoString(config))
+	assert.Equal(t, "5001", C.GoString(config))
 }
 
 func testSetExternalTags(t *testing.T) {
@@ -84,3 +89,32 @@ func testSetExternalTags(t *testing.T) {
 		"- - test_hostname\n  - test_source_type:\n    - tag1\n    - tag2\n",
 		string(yamlPayload))
 }
+
+func testSetExternalTagsBatch(t *testing.T) {
+	var buf []byte
+	appendString := func(s string) {
+		buf = binary.NativeEndian.AppendUint32(buf, uint32(len(s)))
+		buf = append(buf, s...)
+	}
+	appendString("test_hostname")
+	appendString("test_source_type")
+	buf = binary.NativeEndian.AppendUint32(buf, 2)
+	appendString("tag1")
+	appendString("tag2")
+
+	cbuf := C.CBytes(buf)
+	defer C.free(cbuf)
+	SetExternalTagsBatch((*C.char)(cbuf), C.int(len(buf)))
+
+	payload := externalhost.GetPayload()
+	require.NotNil(t, payload)
+
+	yamlPayload, _ := yaml.Marshal(payload)
+	assert.Equal(t,
+		"- - test_hostname\n  - test_source_type:\n    - tag1\n    - tag2\n",
+		string(yamlPayload))
+
+	// a truncated buffer only sets the complete entries
+	SetExternalTagsBatch((*C.char)(cbuf), C.int(len(buf)-1))
+	assert.Empty(t, *externalhost.GetPayload())
+}
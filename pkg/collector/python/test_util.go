@@ -11,6 +11,7 @@ import (
 	"testing"
 
 	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
 )
 
 import "C"
@@ -76,3 +77,76 @@ func testGetSubprocessOutputError(t *testing.T) {
 	assert.NotEqual(t, C.int(0), cRetCode)
 	assert.Nil(t, exception)
 }
+
+func testSubprocessOutputStream(t *testing.T) {
+	var argv []*C.char = []*C.char{C.CString("sh"), C.CString("-c"), C.CString("echo hello; echo world >&2; exit 3"), nil}
+	var env **C.char
+	var handle C.int
+	var exception *C.char
+
+	StartSubprocess(&argv[0], env, &handle, &exception)
+	require.Nil(t, exception)
+
+	output := ""
+	for {
+		var chunk *C.char
+		var chunkLen C.int
+		var cStderr *C.char
+		var cRetCode C.int
+
+		ReadSubprocessOutput(handle, 0, &chunk, &chunkLen, &cStderr, &cRetCode, &exception)
+		require.Nil(t, exception)
+		if chunk == nil {
+			assert.Equal(t, "world\n", C.GoString(cStderr))
+			assert.Equal(t, C.int(3), cRetCode)
+			break
+		}
+		output += C.GoStringN(chunk, chunkLen)
+	}
+	assert.Equal(t, "hello\n", output)
+
+	// the handle is released once the output is exhausted
+	var chunk *C.char
+	var chunkLen C.int
+	var cStderr *C.char
+	var cRetCode C.int
+	ReadSubprocessOutput(handle, 0, &chunk, &chunkLen, &cStderr, &cRetCode, &exception)
+	assert.NotNil(t, exception)
+}
+
+func testSubprocessOutputStreamCancel(t *testing.T) {
+	var argv []*C.char = []*C.char{C.CString("yes"), nil}
+	var env **C.char
+	var handle C.int
+	var exception *C.char
+
+	StartSubprocess(&argv[0], env, &handle, &exception)
+	require.Nil(t, exception)
+
+	var chunk *C.char
+	var chunkLen C.int
+	var cStderr *C.char
+	var cRetCode C.int
+	ReadSubprocessOutput(handle, 0, &chunk, &chunkLen, &cStderr, &cRetCode, &exception)
+	require.Nil(t, exception)
+	assert.NotNil(t, chunk)
+
+	chunk = nil
+	ReadSubprocessOutput(handle, 1, &chunk, &chunkLen, &cStderr, &cRetCode, &exception)
+	assert.Nil(t, exception)
+	assert.Nil(t, chunk)
+
+	subprocessStreamsMux.Lock()
+	defer subprocessStreamsMux.Unlock()
+	assert.NotContains(t, subprocessStreams, handle)
+}
+
+func testStartSubprocessUnknownBin(t *testing.T) {
+	var argv []*C.char = []*C.char{C.CString("unknown_command"), nil}
+	var env **C.char
+	var handle C.int
+	var exception *C.char
+
+	StartSubprocess(&argv[0], env, &handle, &exception)
+	assert.NotNil(t, exception)
+}
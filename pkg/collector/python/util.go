@@ -15,6 +15,8 @@ package python
 import "C"
 
 import (
+	"bytes"
+	"context"
 	"fmt"
 	"io"
 	"os/exec"
@@ -22,6 +24,24 @@ import (
 	"syscall"
 )
 
+// subprocessStreamChunkSize bounds the size of the output chunks handed over to rtloader
+// by ReadSubprocessOutput.
+const subprocessStreamChunkSize = 64 * 1024
+
+// subprocessStream is a command started by StartSubprocess, its stdout is read on demand.
+type subprocessStream struct {
+	cmd    *exec.Cmd
+	stdout io.ReadCloser
+	stderr bytes.Buffer
+	cancel context.CancelFunc
+}
+
+var (
+	subprocessStreamsMux    sync.Mutex
+	subprocessStreams       = map[C.int]*subprocessStream{}
+	subprocessStreamsLastID C.int
+)
+
 // GetSubprocessOutput runs the subprocess and returns the output
 // Indirectly used by the C function `get_subprocess_output` that's mapped to `_util.get_subprocess_output`.
 //
@@ -73,15 +93,111 @@ func GetSubprocessOutput(argv **C.char, env **C.char, cStdout **C.char, cStderr
 	// Wait for the pipes to be closed *before* waiting for the cmd to exit, as per os.exec docs
 	wg.Wait()
 
-	retCode := 0
-	err = cmd.Wait()
-	if exiterr, ok := err.(*exec.ExitError); ok {
-		if status, ok := exiterr.Sys().(syscall.WaitStatus); ok {
-			retCode = status.ExitStatus()
-		}
-	}
+	retCode := exitStatus(cmd.Wait())
 
 	*cStdout = TrackedCString(string(output))
 	*cStderr = TrackedCString(string(outputErr))
 	*cRetCode = C.int(retCode)
 }
+
+// StartSubprocess starts the subprocess and returns a handle to read its output with
+// ReadSubprocessOutput.
+// Indirectly used by the C function `subprocess_output_stream` that's mapped to `_util.subprocess_output_stream`.
+//
+//export StartSubprocess
+func StartSubprocess(argv **C.char, env **C.char, handle *C.int, exception **C.char) {
+	subprocessArgs := cStringArrayToSlice(argv)
+	// this should never happen as this case is filtered by rtloader
+	if len(subprocessArgs) == 0 {
+		*exception = TrackedCString("invalid command: empty list")
+		return
+	}
+
+	parentCtx, _ := GetSubprocessContextCancel()
+	ctx, cancel := context.WithCancel(parentCtx)
+	cmd := exec.CommandContext(ctx, subprocessArgs[0], subprocessArgs[1:]...)
+
+	subprocessEnv := cStringArrayToSlice(env)
+	if len(subprocessEnv) != 0 {
+		cmd.Env = subprocessEnv
+	}
+
+	s := &subprocessStream{cmd: cmd, cancel: cancel}
+	cmd.Stderr = &s.stderr
+
+	stdout, err := cmd.StdoutPipe()
+	if err != nil {
+		cancel()
+		*exception = TrackedCString(fmt.Sprintf("internal error creating stdout pipe: %v", err))
+		return
+	}
+	s.stdout = stdout
+
+	if err := cmd.Start(); err != nil {
+		cancel()
+		*exception = TrackedCString(fmt.Sprintf("could not start command: %v", err))
+		return
+	}
+
+	subprocessStreamsMux.Lock()
+	defer subprocessStreamsMux.Unlock()
+	subprocessStreamsLastID++
+	subprocessStreams[subprocessStreamsLastID] = s
+	*handle = subprocessStreamsLastID
+}
+
+// ReadSubprocessOutput returns the next chunk of the stdout of a subprocess started by
+// StartSubprocess. Once the output is exhausted, or when cancel is set, it waits for the
+// subprocess to exit, returns its stderr and exit code and releases the handle.
+// Indirectly used by the iterator returned by `_util.subprocess_output_stream`.
+//
+//export ReadSubprocessOutput
+func ReadSubprocessOutput(handle C.int, cancel C.int, chunk **C.char, chunkLen *C.int, cStderr **C.char, cRetCode *C.int, exception **C.char) {
+	subprocessStreamsMux.Lock()
+	s, ok := subprocessStreams[handle]
+	subprocessStreamsMux.Unlock()
+	if !ok {
+		*exception = TrackedCString(fmt.Sprintf("unknown subprocess handle %d", handle))
+		return
+	}
+
+	if cancel == 0 {
+		buf := make([]byte, subprocessStreamChunkSize)
+		for {
+			n, err := s.stdout.Read(buf)
+			if n > 0 {
+				*chunk = TrackedCString(string(buf[:n]))
+				*chunkLen = C.int(n)
+				return
+			}
+			if err != nil {
+				break
+			}
+		}
+	}
+
+	// the output is exhausted or the caller isn't interested in it anymore, killing the
+	// subprocess in the latter case
+	if cancel != 0 {
+		s.cancel()
+	}
+	retCode := exitStatus(s.cmd.Wait())
+	s.cancel()
+
+	subprocessStreamsMux.Lock()
+	delete(subprocessStreams, handle)
+	subprocessStreamsMux.Unlock()
+
+	*cStderr = TrackedCString(s.stderr.String())
+	*cRetCode = C.int(retCode)
+}
+
+// exitStatus returns the exit code of a subprocess from the error returned by exec.Cmd.Wait
+func exitStatus(err error) int {
+	if exiterr, ok := err.(*exec.ExitError); ok {
+		if status, ok := exiterr.Sys().(syscall.WaitStatus); ok {
+			return status.ExitStatus()
+		}
+	}
+	return 0
+}
@@ -30,3 +30,15 @@ func TestGetSubprocessOutputError(t *testing.T) {
 func TestGetSubprocessOutputEnv(t *testing.T) {
 	testGetSubprocessOutputEnv(t)
 }
+
+func TestSubprocessOutputStream(t *testing.T) {
+	testSubprocessOutputStream(t)
+}
+
+func TestSubprocessOutputStreamCancel(t *testing.T) {
+	testSubprocessOutputStreamCancel(t)
+}
+
+func TestStartSubprocessUnknownBin(t *testing.T) {
+	testStartSubprocessUnknownBin(t)
+}
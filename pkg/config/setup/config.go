@@ -290,6 +290,21 @@ func InitConfig(config pkgconfigmodel.Config) {
 	// library support will not work reliably in those environments)
 	config.BindEnvAndSetDefault("allow_python_path_heuristics_failure", false)
 
+	// Python modules imported when rtloader initializes, so that import-heavy
+	// integrations are warm before their checks are first scheduled.
+	config.BindEnvAndSetDefault("python_preload_modules", []string{})
+
+	// Maximum number of SQL obfuscation results cached by rtloader, 0 disables the cache.
+	// Database checks obfuscate the same statements on every run, the cache should be
+	// large enough to hold all of them.
+	config.BindEnvAndSetDefault("python_obfuscation_cache_size", 0)
+
+	// Store the persistent cache of python checks in a single memory-mapped file of the run
+	// path instead of one file per key. Values written before it was enabled remain readable.
+	// Only one process can use the store, `agent check` falls back to the files per key when
+	// the agent is running.
+	config.BindEnvAndSetDefault("python_persistent_cache_store", false)
+
 	// if/when the default is changed to true, make the default platform
 	// dependent; default should remain false on Windows to maintain backward
 	// compatibility with Agent5 behavior/win
@@ -151,6 +151,7 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	cfg.BindEnvAndSetDefault(join(spNS, "allow_precompiled_fallback"), true, "DD_ALLOW_PRECOMPILED_FALLBACK")
 	cfg.BindEnvAndSetDefault(join(spNS, "allow_runtime_compiled_fallback"), true, "DD_ALLOW_RUNTIME_COMPILED_FALLBACK")
 	cfg.BindEnvAndSetDefault(join(spNS, "runtime_compiler_output_dir"), defaultRuntimeCompilerOutputDir, "DD_RUNTIME_COMPILER_OUTPUT_DIR")
+	cfg.BindEnvAndSetDefault(join(spNS, "runtime_compiler_shared_dir"), "", "DD_RUNTIME_COMPILER_SHARED_DIR")
 	cfg.BindEnv(join(spNS, "enable_kernel_header_download"), "DD_ENABLE_KERNEL_HEADER_DOWNLOAD")
 	cfg.BindEnvAndSetDefault(join(spNS, "kernel_header_dirs"), []string{}, "DD_KERNEL_HEADER_DIRS")
 	cfg.BindEnvAndSetDefault(join(spNS, "kernel_header_download_dir"), defaultKernelHeadersDownloadDir, "DD_KERNEL_HEADER_DOWNLOAD_DIR")
@@ -196,6 +197,20 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	cfg.BindEnvAndSetDefault(join(spNS, "enable_conntrack_all_namespaces"), true, "DD_SYSTEM_PROBE_ENABLE_CONNTRACK_ALL_NAMESPACES")
 	cfg.BindEnvAndSetDefault(join(netNS, "enable_protocol_classification"), true, "DD_ENABLE_PROTOCOL_CLASSIFICATION")
 	cfg.BindEnvAndSetDefault(join(netNS, "enable_ringbuffers"), true, "DD_SYSTEM_PROBE_NETWORK_ENABLE_RINGBUFFERS")
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_percpu_conn_stats"), false, "DD_SYSTEM_PROBE_NETWORK_ENABLE_PERCPU_CONN_STATS")
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_udp_flow_aggregation"), false, "DD_SYSTEM_PROBE_NETWORK_ENABLE_UDP_FLOW_AGGREGATION")
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_tcp_conn_aggregation"), false, "DD_SYSTEM_PROBE_NETWORK_ENABLE_TCP_CONN_AGGREGATION")
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_delta_polling"), false, "DD_SYSTEM_PROBE_NETWORK_ENABLE_DELTA_POLLING")
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_tcp_stats_retransmits"), true, "DD_SYSTEM_PROBE_NETWORK_ENABLE_TCP_STATS_RETRANSMITS")
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_tcp_rtt_histogram"), false, "DD_SYSTEM_PROBE_NETWORK_ENABLE_TCP_RTT_HISTOGRAM")
+	cfg.BindEnvAndSetDefault(join(netNS, "conn_maps_no_prealloc"), false, "DD_SYSTEM_PROBE_NETWORK_CONN_MAPS_NO_PREALLOC")
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_conn_maps_lru"), false, "DD_SYSTEM_PROBE_NETWORK_ENABLE_CONN_MAPS_LRU")
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_tcp_failed_connects"), false, "DD_SYSTEM_PROBE_NETWORK_ENABLE_TCP_FAILED_CONNECTS")
+	cfg.BindEnvAndSetDefault(join(netNS, "max_ongoing_connects"), 1024, "DD_SYSTEM_PROBE_NETWORK_MAX_ONGOING_CONNECTS")
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_udp_tunnel_decap"), false, "DD_SYSTEM_PROBE_NETWORK_ENABLE_UDP_TUNNEL_DECAP")
+	cfg.BindEnvAndSetDefault(join(netNS, "enable_tls_handshake_tags"), false, "DD_SYSTEM_PROBE_NETWORK_ENABLE_TLS_HANDSHAKE_TAGS")
+	cfg.BindEnvAndSetDefault(join(netNS, "closed_conn_wakeup_watermark"), 0, "DD_SYSTEM_PROBE_NETWORK_CLOSED_CONN_WAKEUP_WATERMARK")
+	cfg.BindEnvAndSetDefault(join(netNS, "connection_sampling_rate"), 1, "DD_SYSTEM_PROBE_NETWORK_CONNECTION_SAMPLING_RATE")
 	cfg.BindEnvAndSetDefault(join(netNS, "ignore_conntrack_init_failure"), false, "DD_SYSTEM_PROBE_NETWORK_IGNORE_CONNTRACK_INIT_FAILURE")
 	cfg.BindEnvAndSetDefault(join(netNS, "conntrack_init_timeout"), 10*time.Second)
 	cfg.BindEnvAndSetDefault(join(netNS, "allow_netlink_conntracker_fallback"), true)
@@ -224,6 +239,7 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	// For backward compatibility
 	cfg.BindEnv(join(netNS, "enable_https_monitoring"), "DD_SYSTEM_PROBE_NETWORK_ENABLE_HTTPS_MONITORING")
 	cfg.BindEnv(join(smNS, "tls", "native", "enabled"))
+	cfg.BindEnvAndSetDefault(join(smNS, "tls", "native", "library_suffixes"), []string{"libssl", "crypto", "gnutls"})
 
 	// For backward compatibility
 	cfg.BindEnv(join(smNS, "enable_go_tls_support"))
@@ -233,6 +249,10 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	cfg.BindEnvAndSetDefault(join(smNS, "enable_http2_monitoring"), false)
 	cfg.BindEnvAndSetDefault(join(smNS, "enable_kafka_monitoring"), false)
 	cfg.BindEnv(join(smNS, "enable_postgres_monitoring"))
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_redis_monitoring"), false)
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_amqp_monitoring"), false)
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_mysql_monitoring"), false)
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_mongo_monitoring"), false)
 	cfg.BindEnvAndSetDefault(join(smNS, "tls", "istio", "enabled"), false)
 	cfg.BindEnv(join(smNS, "tls", "nodejs", "enabled"))
 	cfg.BindEnvAndSetDefault(join(smjtNS, "enabled"), false)
@@ -249,10 +269,38 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	cfg.BindEnv(join(smNS, "max_http_stats_buffered"))
 	cfg.BindEnvAndSetDefault(join(smNS, "max_kafka_stats_buffered"), 100000)
 	cfg.BindEnv(join(smNS, "max_postgres_stats_buffered"))
+	cfg.BindEnvAndSetDefault(join(smNS, "max_redis_stats_buffered"), 100000)
+	cfg.BindEnvAndSetDefault(join(smNS, "max_amqp_stats_buffered"), 100000)
+	cfg.BindEnvAndSetDefault(join(smNS, "max_mysql_stats_buffered"), 100000)
+	cfg.BindEnvAndSetDefault(join(smNS, "max_mongo_stats_buffered"), 100000)
 	cfg.BindEnv(join(smNS, "max_concurrent_requests"))
 	cfg.BindEnv(join(smNS, "enable_quantization"))
 	cfg.BindEnv(join(smNS, "enable_connection_rollup"))
 	cfg.BindEnv(join(smNS, "enable_ring_buffers"))
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_direct_ring_buffer_events"), false)
+	cfg.BindEnvAndSetDefault(join(smNS, "max_unclassified_packets"), 0)
+	cfg.BindEnvAndSetDefault(join(smNS, "monitored_ports"), []string{})
+	cfg.BindEnvAndSetDefault(join(smNS, "monitored_cgroups"), []string{})
+	cfg.BindEnvAndSetDefault(join(smNS, "http_path_only_capture"), false)
+	cfg.BindEnvAndSetDefault(join(smNS, "http_max_path_length"), 0)
+	cfg.BindEnvAndSetDefault(join(smNS, "kafka_in_kernel_aggregation"), false)
+	cfg.BindEnvAndSetDefault(join(smNS, "enable_cpu_cost_telemetry"), false)
+	cfg.BindEnv(join(smNS, "batch_pages_per_cpu"))
+	cfg.SetEnvKeyTransformer(join(smNS, "batch_pages_per_cpu"), func(in string) interface{} {
+		var out map[string]int
+		if err := json.Unmarshal([]byte(in), &out); err != nil {
+			log.Warnf(`%q can not be parsed: %v`, join(smNS, "batch_pages_per_cpu"), err)
+		}
+		return out
+	})
+	cfg.BindEnv(join(smNS, "cgroup_protocols"))
+	cfg.SetEnvKeyTransformer(join(smNS, "cgroup_protocols"), func(in string) interface{} {
+		var out []map[string]interface{}
+		if err := json.Unmarshal([]byte(in), &out); err != nil {
+			log.Warnf(`%q can not be parsed: %v`, join(smNS, "cgroup_protocols"), err)
+		}
+		return out
+	})
 	cfg.BindEnv(join(smNS, "enable_event_stream"))
 
 	oldHTTPRules := join(netNS, "http_replace_rules")
@@ -293,9 +341,12 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 
 	// oom_kill module
 	cfg.BindEnvAndSetDefault(join(spNS, "enable_oom_kill"), false)
+	cfg.BindEnvAndSetDefault(join(spNS, "oom_kill.cache_cgroup_names"), false)
 
 	// tcp_queue_length module
 	cfg.BindEnvAndSetDefault(join(spNS, "enable_tcp_queue_length"), false)
+	cfg.BindEnvAndSetDefault(join(spNS, "tcp_queue_length.enable_histograms"), false)
+	cfg.BindEnvAndSetDefault(join(spNS, "tcp_queue_length.sample_state_changes"), false)
 	// process module
 	// nested within system_probe_config to not conflict with process-agent's process_config
 	cfg.BindEnvAndSetDefault(join(spNS, "process_config.enabled"), false, "DD_SYSTEM_PROBE_PROCESS_ENABLED")
@@ -335,11 +386,16 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	eventMonitorBindEnv(cfg, join(evNS, "enable_approvers"))
 	eventMonitorBindEnv(cfg, join(evNS, "enable_discarders"))
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "flush_discarder_window"), 3)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "discarder_probation.threshold"), 0)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "discarder_probation.window"), 1000)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "jit_mprotect.threshold"), 0)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "jit_mprotect.summary_period"), 10000)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "pid_cache_size"), 10000)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "events_stats.tags_cardinality"), "high")
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "custom_sensitive_words"), []string{})
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "erpc_dentry_resolution_enabled"), true)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "map_dentry_resolution_enabled"), true)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "d_path_dentry_resolution_enabled"), false)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "dentry_cache_size"), 1024)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "remote_tagger"), true)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "runtime_monitor.enabled"), false)
@@ -350,13 +406,22 @@ func InitSystemProbeConfig(cfg pkgconfigmodel.Config) {
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "event_stream.use_fentry"), false)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "event_stream.use_fentry_amd64"), false)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "event_stream.use_fentry_arm64"), false)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "event_stream.batch_args_envs"), false)
 	eventMonitorBindEnv(cfg, join(evNS, "event_stream.buffer_size"))
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "event_stream.priority_buffer_size"), 0)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "envs_with_value"), []string{"LD_PRELOAD", "LD_LIBRARY_PATH", "PATH", "HISTSIZE", "HISTFILESIZE", "GLIBC_TUNABLES"})
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "envs_prefix_filter"), []string{})
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "runtime_compilation.enabled"), false)
 	eventMonitorBindEnv(cfg, join(evNS, "runtime_compilation.compiled_constants_enabled"))
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "network.enabled"), true)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "network.ingress.enabled"), false)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "network.dns_dedup_window"), 0)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "setxattr_dedup_window"), 0)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "credentials_dedup"), false)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "syscall_ctx_rules_only"), false)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "span_event_types"), []string{})
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "events_stats.polling_interval"), 20)
+	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "events_stats.sampling_rate"), 1)
 	eventMonitorBindEnvAndSetDefault(cfg, join(evNS, "syscalls_monitor.enabled"), false)
 	cfg.BindEnvAndSetDefault(join(evNS, "socket"), defaultEventMonitorAddress)
 	cfg.BindEnvAndSetDefault(join(evNS, "event_server.burst"), 40)
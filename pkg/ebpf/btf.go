@@ -424,3 +424,24 @@ var loadKernelSpec = funcs.CacheWithCallback[btf.Spec](btf.LoadKernelSpec, btf.F
 func GetKernelSpec() (*btf.Spec, error) {
 	return loadKernelSpec.Do()
 }
+
+// GetBTF returns the BTF of the running kernel, from the same sources as the CO-RE assets: the kernel, the
+// user-provided path or the embedded collection. Only the kernel BTF is looked up if [Setup] wasn't called.
+// It's very important that the caller of this function does not modify the returned value
+func GetBTF() (*btf.Spec, error) {
+	core.RLock()
+	loader := core.loader
+	core.RUnlock()
+
+	if loader == nil {
+		return GetKernelSpec()
+	}
+	ret, _, err := loader.btfLoader.Get()
+	if err != nil {
+		return nil, err
+	}
+	if ret == nil || ret.vmlinux == nil {
+		return nil, errors.New("no BTF found for the running kernel")
+	}
+	return ret.vmlinux, nil
+}
@@ -93,7 +93,7 @@ func (a *asset) Compile(config *ebpf.Config, additionalFlags []string, llcFlags
 		return nil, fmt.Errorf("error reading input file: %s", err)
 	}
 
-	out, result, err := compileToObjectFile(protectedFile.Name(), outputDir, a.filename, a.hash, additionalFlags, llcFlags, kernelHeaders)
+	out, result, err := compileToObjectFile(protectedFile.Name(), outputDir, config.RuntimeCompilerSharedDir, a.filename, a.hash, additionalFlags, llcFlags, kernelHeaders)
 	a.tm.compilationResult = result
 
 	return out, err
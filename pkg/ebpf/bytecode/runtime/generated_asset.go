@@ -87,7 +87,7 @@ func (a *generatedAsset) Compile(config *ebpf.Config, inputCode string, addition
 		}
 	}()
 
-	out, result, err := compileToObjectFile(protectedFile.Name(), outputDir, a.filename, inputHash, additionalFlags, llcFlags, kernelHeaders)
+	out, result, err := compileToObjectFile(protectedFile.Name(), outputDir, config.RuntimeCompilerSharedDir, a.filename, inputHash, additionalFlags, llcFlags, kernelHeaders)
 	a.tm.compilationResult = result
 
 	return out, err
@@ -51,8 +51,11 @@ var defaultFlags = []string{
 	"-nostdinc",
 }
 
-// compileToObjectFile compiles the input ebpf program & returns the compiled output
-func compileToObjectFile(inFile, outputDir, filename, inHash string, additionalFlags, llcFlags, kernelHeaders []string) (CompiledOutput, CompilationResult, error) {
+// compileToObjectFile compiles the input ebpf program & returns the compiled output.
+// When sharedDir is set, the output is copied from it if another host already compiled it, and published to it
+// otherwise. The name of the output includes the hashes of the kernel, the input and the flags, so it can be shared
+// between hosts running the same kernel.
+func compileToObjectFile(inFile, outputDir, sharedDir, filename, inHash string, additionalFlags, llcFlags, kernelHeaders []string) (CompiledOutput, CompilationResult, error) {
 	flags, flagHash := computeFlagsAndHash(additionalFlags)
 
 	outputFile, err := getOutputFilePath(outputDir, filename, inHash, flagHash)
@@ -61,6 +64,12 @@ func compileToObjectFile(inFile, outputDir, filename, inHash string, additionalF
 	}
 
 	var result CompilationResult
+	if _, err := os.Stat(outputFile); os.IsNotExist(err) && sharedDir != "" {
+		if err := copyFromSharedDir(sharedDir, outputFile); err != nil {
+			log.Debugf("unable to use the shared runtime version of %s: %s", filename, err)
+		}
+	}
+
 	if _, err := os.Stat(outputFile); err != nil {
 		if !os.IsNotExist(err) {
 			return nil, outputFileErr, fmt.Errorf("error stat-ing output file %s: %w", outputFile, err)
@@ -92,6 +101,12 @@ func compileToObjectFile(inFile, outputDir, filename, inHash string, additionalF
 
 		log.Infof("successfully compiled runtime version of %s", filename)
 		result = compilationSuccess
+
+		if sharedDir != "" {
+			if err := copyFile(outputFile, filepath.Join(sharedDir, filepath.Base(outputFile))); err != nil {
+				log.Warnf("unable to publish the runtime version of %s to %s: %s", filename, sharedDir, err)
+			}
+		}
 	} else {
 		log.Infof("found previously compiled runtime version of %s", filename)
 		result = compiledOutputFound
@@ -109,6 +124,43 @@ func compileToObjectFile(inFile, outputDir, filename, inHash string, additionalF
 	return out, result, nil
 }
 
+// copyFromSharedDir copies the compiled output from the shared directory to outputFile. Since the output is loaded in
+// the kernel, the shared copy must have the same permissions as the outputs of the local compiler.
+func copyFromSharedDir(sharedDir, outputFile string) error {
+	sharedFile := filepath.Join(sharedDir, filepath.Base(outputFile))
+	if err := bytecode.VerifyAssetPermissions(sharedFile); err != nil {
+		return err
+	}
+	return copyFile(sharedFile, outputFile)
+}
+
+// copyFile atomically copies src to dst, so that concurrent readers of dst never see a partial copy
+func copyFile(src, dst string) error {
+	in, err := os.Open(src)
+	if err != nil {
+		return err
+	}
+	defer in.Close()
+
+	tmp, err := os.CreateTemp(filepath.Dir(dst), filepath.Base(dst)+".*.tmp")
+	if err != nil {
+		return err
+	}
+	defer os.Remove(tmp.Name())
+
+	_, err = io.Copy(tmp, in)
+	if closeErr := tmp.Close(); err == nil {
+		err = closeErr
+	}
+	if err != nil {
+		return err
+	}
+	if err := os.Chmod(tmp.Name(), 0644); err != nil {
+		return err
+	}
+	return os.Rename(tmp.Name(), dst)
+}
+
 func computeFlagsAndHash(additionalFlags []string) ([]string, string) {
 	flags := make([]string, 0, len(defaultFlags)+len(additionalFlags)+1)
 	flags = append(flags, fmt.Sprintf("-D__TARGET_ARCH_%s", kernel.Arch()))
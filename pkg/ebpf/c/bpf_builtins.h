@@ -650,6 +650,49 @@ static __always_inline __maybe_unused __nobuiltin("memcpy") void bpf_memcpy(void
 	return __bpf_memcpy(d, s, len);
 }
 
+/* Size-specialised variants of bpf_memset() and bpf_memcpy() for the
+ * structs that are a multiple of 8 bytes, such as the events copied to
+ * the batches and ring buffers: the copy is unrolled into 8-byte moves
+ * whatever its size, rather than going through the jump tables above,
+ * which stop at 512 bytes. The destination and source must be 8 bytes
+ * aligned, and the length a compile-time constant, checked with
+ * _Static_assert() by the bpf_memzero_u64() and bpf_memcpy_u64() macros.
+ */
+static __always_inline __maybe_unused void __bpf_memzero_u64(void *d, __u64 len)
+{
+	if (!__builtin_constant_p(len) || len % 8 != 0)
+		__throw_build_bug();
+
+	__u64 *dst = d;
+#pragma unroll
+	for (__u64 i = 0; i < len / 8; i++)
+		dst[i] = 0;
+}
+
+static __always_inline __maybe_unused void __bpf_memcpy_u64(void *d, const void *s, __u64 len)
+{
+	if (!__builtin_constant_p(len) || len % 8 != 0)
+		__throw_build_bug();
+
+	__u64 *dst = d;
+	const __u64 *src = s;
+#pragma unroll
+	for (__u64 i = 0; i < len / 8; i++)
+		dst[i] = src[i];
+}
+
+#define bpf_memzero_u64(d, len)							\
+	({									\
+		_Static_assert(((len) % 8) == 0, "len must be a multiple of 8.");	\
+		__bpf_memzero_u64(d, len);					\
+	})
+
+#define bpf_memcpy_u64(d, s, len)						\
+	({									\
+		_Static_assert(((len) % 8) == 0, "len must be a multiple of 8.");	\
+		__bpf_memcpy_u64(d, s, len);					\
+	})
+
 static __always_inline __maybe_unused __u64
 __bpf_memcmp_builtin(const void *x, const void *y, __u64 len)
 {
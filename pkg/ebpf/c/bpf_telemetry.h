@@ -8,6 +8,9 @@
 #define STR(x) #x
 #define MK_KEY(key) STR(key##_telemetry_key)
 
+// Declared as plain hash maps so that they load on kernels without per-CPU hashes (< 4.6). Userspace upgrades them to
+// per-CPU hashes when the kernel supports them, so that error storms, such as a full map on every packet, don't turn
+// the telemetry into a cache line contended by all the CPUs. The values of the CPUs are then summed in userspace.
 BPF_HASH_MAP(map_err_telemetry_map, unsigned long, map_err_telemetry_t, 128)
 BPF_HASH_MAP(helper_err_telemetry_map, unsigned long, helper_err_telemetry_t, 256)
 
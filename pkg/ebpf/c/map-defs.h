@@ -13,6 +13,17 @@
         __uint(map_flags, _map_flags);                                               \
     } _name SEC(".maps");
 
+// BPF_MAP_NUMA places the memory of the map on the given NUMA node
+#define BPF_MAP_NUMA(_name, _type, _key_type, _value_type, _max_entries, _map_flags, _numa_node) \
+    struct {                                                                                   \
+        __uint(type, _type);                                                                   \
+        __uint(max_entries, _max_entries);                                                     \
+        __type(key, _key_type);                                                                \
+        __type(value, _value_type);                                                            \
+        __uint(map_flags, (_map_flags) | BPF_F_NUMA_NODE);                                     \
+        __uint(numa_node, _numa_node);                                                         \
+    } _name SEC(".maps");
+
 #define BPF_PERF_EVENT_ARRAY_MAP_PINNED(name, value_type, max_entries) \
     BPF_MAP(name, BPF_MAP_TYPE_PERF_EVENT_ARRAY, u32, value_type, max_entries, 1, 0)
 
@@ -28,6 +39,11 @@
 #define BPF_HASH_MAP(name, key_type, value_type, max_entries) \
     BPF_MAP(name, BPF_MAP_TYPE_HASH, key_type, value_type, max_entries, 0, 0)
 
+// BPF_HASH_MAP_FLAGS takes map flags such as BPF_F_NO_PREALLOC, which lets the memory of sparse maps scale with
+// their occupancy rather than their max_entries. Userspace can also set it at load time with a MapSpecEditor.
+#define BPF_HASH_MAP_FLAGS(name, key_type, value_type, max_entries, map_flags) \
+    BPF_MAP(name, BPF_MAP_TYPE_HASH, key_type, value_type, max_entries, 0, map_flags)
+
 #define BPF_PROG_ARRAY(name, max_entries) \
     BPF_MAP(name, BPF_MAP_TYPE_PROG_ARRAY, u32, u32, max_entries, 0, 0)
 
@@ -43,7 +59,13 @@
 #define BPF_PERCPU_HASH_MAP(name, key_type, value_type, max_entries) \
     BPF_MAP(name, BPF_MAP_TYPE_PERCPU_HASH, key_type, value_type, max_entries, 0, 0)
 
+#define BPF_PERCPU_HASH_MAP_FLAGS(name, key_type, value_type, max_entries, map_flags) \
+    BPF_MAP(name, BPF_MAP_TYPE_PERCPU_HASH, key_type, value_type, max_entries, 0, map_flags)
+
 #define BPF_PERCPU_ARRAY_MAP(name, value_type, max_entries) \
     BPF_MAP(name, BPF_MAP_TYPE_PERCPU_ARRAY, u32, value_type, max_entries, 0, 0)
 
+#define BPF_LPM_TRIE_MAP(name, key_type, value_type, max_entries) \
+    BPF_MAP(name, BPF_MAP_TYPE_LPM_TRIE, key_type, value_type, max_entries, 0, BPF_F_NO_PREALLOC)
+
 #endif
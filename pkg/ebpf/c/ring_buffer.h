@@ -0,0 +1,88 @@
+#ifndef __RING_BUFFER_H
+#define __RING_BUFFER_H
+
+#include "bpf_helpers.h"
+#include "compiler.h"
+#include "map-defs.h"
+
+// values of BPF_RB_AVAIL_DATA, BPF_RB_NO_WAKEUP and BPF_RB_FORCE_WAKEUP, which aren't defined by the kernel headers
+// used for the prebuilt assets
+#define RB_AVAIL_DATA 0
+#define RB_NO_WAKEUP 1
+#define RB_FORCE_WAKEUP 2
+
+// maximum time during which a CPU writing to a ring buffer doesn't wake up its consumer
+#define RING_BUFFER_WAKEUP_INTERVAL_NS 100000000
+
+// number of ring buffers of a program whose wakeups can be deferred with ring_buffer_output
+#define RING_BUFFER_WAKEUP_SLOTS 1
+
+// size of the records written by ring_buffer_flush, which hold no data and are skipped by the consumer
+#define RING_BUFFER_FLUSH_RECORD_SIZE 8
+
+// last time each CPU woke up the consumer of a ring buffer, indexed by the slot given to ring_buffer_output.
+// It is declared as an array so that the programs built with this header still load on the kernels without per-CPU
+// arrays when they use perf buffers; userspace makes it a per-CPU array when it uses the ring buffers.
+BPF_ARRAY_MAP(rb_last_wakeup, __u64, RING_BUFFER_WAKEUP_SLOTS)
+
+// ring_buffer_wakeup_watermark returns the number of bytes that can wait in a ring buffer before its consumer is
+// woken up, 0 if the consumer is woken up by the kernel as soon as it waits for records
+static __always_inline __u64 ring_buffer_wakeup_watermark() {
+    __u64 val = 0;
+    LOAD_CONSTANT("ring_buffer_wakeup_watermark", val);
+    return val;
+}
+
+// ring_buffer_wakeup_flags returns the flags a record is written with so that the consumer is only woken up once
+// the data waiting in the ring buffer reaches the watermark, or when it wasn't woken up by this CPU for
+// RING_BUFFER_WAKEUP_INTERVAL_NS. last_wakeup is the per-CPU time of the last wakeup.
+static __always_inline __u64 ring_buffer_wakeup_flags(void *ring_buffer, __u64 watermark, __u64 *last_wakeup) {
+    __u64 now = bpf_ktime_get_ns();
+    if (bpf_ringbuf_query(ring_buffer, RB_AVAIL_DATA) >= watermark ||
+        now - *last_wakeup >= RING_BUFFER_WAKEUP_INTERVAL_NS) {
+        *last_wakeup = now;
+        return RB_FORCE_WAKEUP;
+    }
+    return RB_NO_WAKEUP;
+}
+
+// ring_buffer_flags returns the flags a record is written to the ring buffer with, deferring the wakeup of its
+// consumer when the ring_buffer_wakeup_watermark constant is set. slot identifies the ring buffer among the ones
+// of the program. The records written below the watermark are delivered by the wakeup of a later record, or by
+// ring_buffer_flush, which userspace must run periodically to bound their latency. It is used for the closed
+// connections of NPM, flushed by each connections check. The CWS events aren't deferred: they feed the rule engine
+// and the kill action, which can't wait for a periodic flush.
+static __always_inline __u64 ring_buffer_flags(void *ring_buffer, __u32 slot) {
+    __u64 watermark = ring_buffer_wakeup_watermark();
+    if (watermark == 0) {
+        return 0;
+    }
+    __u64 *last_wakeup = bpf_map_lookup_elem(&rb_last_wakeup, &slot);
+    if (last_wakeup == NULL) {
+        return 0;
+    }
+    return ring_buffer_wakeup_flags(ring_buffer, watermark, last_wakeup);
+}
+
+// ring_buffer_output writes a record to the ring buffer, see ring_buffer_flags
+static __always_inline long ring_buffer_output(void *ring_buffer, void *data, __u64 size, __u32 slot) {
+    return bpf_ringbuf_output(ring_buffer, data, size, ring_buffer_flags(ring_buffer, slot));
+}
+
+// ring_buffer_submit submits a record reserved in the ring buffer, see ring_buffer_flags
+static __always_inline void ring_buffer_submit(void *ring_buffer, void *data, __u32 slot) {
+    bpf_ringbuf_submit(data, ring_buffer_flags(ring_buffer, slot));
+}
+
+// ring_buffer_flush wakes up the consumer of the records waiting in the ring buffer below the wakeup watermark, with
+// a record of RING_BUFFER_FLUSH_RECORD_SIZE bytes holding no data. It is run by userspace, with BPF_PROG_TEST_RUN,
+// so that the delivery of the records doesn't depend on a later record being written.
+static __always_inline void ring_buffer_flush(void *ring_buffer) {
+    if (bpf_ringbuf_query(ring_buffer, RB_AVAIL_DATA) == 0) {
+        return;
+    }
+    __u64 record = 0;
+    bpf_ringbuf_output(ring_buffer, &record, sizeof(record), RB_FORCE_WAKEUP);
+}
+
+#endif
@@ -58,6 +58,10 @@ type Config struct {
 	// RuntimeCompilerOutputDir is the directory where the runtime compiler will store compiled programs
 	RuntimeCompilerOutputDir string
 
+	// RuntimeCompilerSharedDir is a directory shared between hosts, where compiled programs are looked up before
+	// compiling them, and published after compiling them
+	RuntimeCompilerSharedDir string
+
 	// AptConfigDir is the path to the apt config directory
 	AptConfigDir string
 
@@ -102,6 +106,7 @@ func NewConfig() *Config {
 
 		EnableRuntimeCompiler:        cfg.GetBool(key(spNS, "enable_runtime_compiler")),
 		RuntimeCompilerOutputDir:     cfg.GetString(key(spNS, "runtime_compiler_output_dir")),
+		RuntimeCompilerSharedDir:     cfg.GetString(key(spNS, "runtime_compiler_shared_dir")),
 		EnableKernelHeaderDownload:   cfg.GetBool(key(spNS, "enable_kernel_header_download")),
 		KernelHeadersDirs:            cfg.GetStringSlice(key(spNS, "kernel_header_dirs")),
 		KernelHeadersDownloadDir:     cfg.GetString(key(spNS, "kernel_header_download_dir")),
@@ -0,0 +1,53 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux
+
+package ebpf
+
+import (
+	"math/bits"
+	"strconv"
+	"time"
+)
+
+// QueueingLatencyBuckets is the number of buckets of the queueing latency histograms, see QueueingLatencyClock.Bucket
+const QueueingLatencyBuckets = 24
+
+// QueueingLatencyClock measures the time events spent in the perf and ring buffers, from the bpf_ktime_get_ns()
+// timestamp they were given in the kernel. It reads the monotonic clock of the Go runtime, which is also based on
+// CLOCK_MONOTONIC, so that it can be called for every event without a syscall.
+type QueueingLatencyClock struct {
+	base      time.Time
+	baseKtime int64
+}
+
+// NewQueueingLatencyClock returns a new QueueingLatencyClock
+func NewQueueingLatencyClock() (*QueueingLatencyClock, error) {
+	base := time.Now()
+	baseKtime, err := NowNanoseconds()
+	if err != nil {
+		return nil, err
+	}
+	return &QueueingLatencyClock{base: base, baseKtime: baseKtime}, nil
+}
+
+// Bucket returns the bucket of the time elapsed since the given bpf_ktime_get_ns() timestamp. Bucket i counts the
+// latencies below 2^i microseconds, and the last bucket all the longer ones.
+func (c *QueueingLatencyClock) Bucket(ktime uint64) int {
+	now := c.baseKtime + int64(time.Since(c.base))
+	if now <= int64(ktime) {
+		return 0
+	}
+	return min(bits.Len64(uint64(now-int64(ktime))/uint64(time.Microsecond)), QueueingLatencyBuckets-1)
+}
+
+// QueueingLatencyBucketTag returns the tag of the given bucket, which holds its upper bound
+func QueueingLatencyBucketTag(bucket int) string {
+	if bucket >= QueueingLatencyBuckets-1 {
+		return "le:inf"
+	}
+	return "le:" + strconv.Itoa(1<<bucket) + "us"
+}
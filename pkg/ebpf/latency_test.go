@@ -0,0 +1,32 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux
+
+package ebpf
+
+import (
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+)
+
+func TestQueueingLatencyClock(t *testing.T) {
+	clock, err := NewQueueingLatencyClock()
+	require.NoError(t, err)
+
+	now, err := NowNanoseconds()
+	require.NoError(t, err)
+
+	assert.Equal(t, 0, clock.Bucket(uint64(now+int64(time.Second))), "events from the future should land in the first bucket")
+	assert.Equal(t, 20, clock.Bucket(uint64(now-int64(time.Second))))
+	assert.Equal(t, QueueingLatencyBuckets-1, clock.Bucket(uint64(now-int64(time.Hour))))
+
+	assert.Equal(t, "le:1us", QueueingLatencyBucketTag(0))
+	assert.Equal(t, "le:1024us", QueueingLatencyBucketTag(10))
+	assert.Equal(t, "le:inf", QueueingLatencyBucketTag(QueueingLatencyBuckets-1))
+}
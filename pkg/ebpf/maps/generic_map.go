@@ -150,6 +150,10 @@ func (g *GenericMap[K, V]) Put(key *K, value *V) error {
 
 // Update updates the value of an existing key in the map.
 func (g *GenericMap[K, V]) Update(key *K, value *V, flags ebpf.MapUpdateFlags) error {
+	if g.isPerCPU() {
+		return g.m.Update(unsafe.Pointer(key), *value, flags)
+	}
+
 	return g.m.Update(unsafe.Pointer(key), unsafe.Pointer(value), flags)
 }
 
@@ -59,7 +59,7 @@ func (e *EBPFErrorsCollector) Collect(ch chan<- prometheus.Metric) {
 	if e.T.helperErrMap != nil {
 		var hval HelperErrTelemetry
 		for probeName, k := range e.T.probeKeys {
-			err := e.T.helperErrMap.Lookup(&k, &hval)
+			err := e.T.lookupHelperErrors(k, &hval)
 			if err != nil {
 				log.Debugf("failed to get telemetry for probe:key %s:%d\n", probeName, k)
 				continue
@@ -78,7 +78,7 @@ func (e *EBPFErrorsCollector) Collect(ch chan<- prometheus.Metric) {
 	if e.T.mapErrMap != nil {
 		var val MapErrTelemetry
 		for m, k := range e.T.mapKeys {
-			err := e.T.mapErrMap.Lookup(&k, &val)
+			err := e.T.lookupMapErrors(k, &val)
 			if err != nil {
 				log.Debugf("failed to get telemetry for map:key %s:%d\n", m, k)
 				continue
@@ -21,8 +21,8 @@ import (
 	manager "github.com/DataDog/ebpf-manager"
 	"github.com/cilium/ebpf"
 	"github.com/cilium/ebpf/asm"
+	"github.com/cilium/ebpf/features"
 
-	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
 	"github.com/DataDog/datadog-agent/pkg/network/ebpf/probes"
 	"github.com/DataDog/datadog-agent/pkg/util/kernel"
 )
@@ -47,10 +47,14 @@ var helperNames = map[int]string{
 // are registered to have their telemetry collected.
 type EBPFTelemetry struct {
 	mtx          sync.Mutex
-	mapErrMap    *maps.GenericMap[uint64, MapErrTelemetry]
-	helperErrMap *maps.GenericMap[uint64, HelperErrTelemetry]
+	mapErrMap    *ebpf.Map
+	helperErrMap *ebpf.Map
 	mapKeys      map[string]uint64
 	probeKeys    map[string]uint64
+
+	// buffers for the per-CPU values of the telemetry maps, nil when the maps are plain hashes
+	mapErrValues    []MapErrTelemetry
+	helperErrValues []HelperErrTelemetry
 }
 
 // A singleton instance of the ebpf telemetry struct. Used by the collector and the ebpf managers (via ErrorsTelemetryModifier).
@@ -73,10 +77,27 @@ func (b *EBPFTelemetry) setupMapEditors(opts *manager.Options) {
 	}
 	// if the maps have already been loaded, setup editors to point to them
 	if b.mapErrMap != nil {
-		opts.MapEditors[probes.MapErrTelemetryMap] = b.mapErrMap.Map()
+		opts.MapEditors[probes.MapErrTelemetryMap] = b.mapErrMap
 	}
 	if b.helperErrMap != nil {
-		opts.MapEditors[probes.HelperErrTelemetryMap] = b.helperErrMap.Map()
+		opts.MapEditors[probes.HelperErrTelemetryMap] = b.helperErrMap
+	}
+}
+
+// setupMapSpecEditors upgrades the telemetry maps, declared as plain hashes, to per-CPU hashes when the kernel
+// supports them (4.6+)
+func setupMapSpecEditors(opts *manager.Options) {
+	if features.HaveMapType(ebpf.PerCPUHash) != nil {
+		return
+	}
+	if opts.MapSpecEditors == nil {
+		opts.MapSpecEditors = make(map[string]manager.MapSpecEditor)
+	}
+	for _, name := range []string{probes.MapErrTelemetryMap, probes.HelperErrTelemetryMap} {
+		editor := opts.MapSpecEditors[name]
+		editor.Type = ebpf.PerCPUHash
+		editor.EditorFlag |= manager.EditType
+		opts.MapSpecEditors[name] = editor
 	}
 }
 
@@ -87,11 +108,23 @@ func (b *EBPFTelemetry) populateMapsWithKeys(m *manager.Manager) error {
 	defer b.mtx.Unlock()
 
 	// first manager to call will populate the maps
-	if b.mapErrMap == nil {
-		b.mapErrMap, _ = maps.GetMap[uint64, MapErrTelemetry](m, probes.MapErrTelemetryMap)
-	}
-	if b.helperErrMap == nil {
-		b.helperErrMap, _ = maps.GetMap[uint64, HelperErrTelemetry](m, probes.HelperErrTelemetryMap)
+	if b.mapErrMap == nil || b.helperErrMap == nil {
+		cpus, err := ebpf.PossibleCPU()
+		if err != nil {
+			return fmt.Errorf("could not get the number of CPUs: %w", err)
+		}
+		if b.mapErrMap == nil {
+			b.mapErrMap, _, _ = m.GetMap(probes.MapErrTelemetryMap)
+			if b.mapErrMap != nil && b.mapErrMap.Type() == ebpf.PerCPUHash {
+				b.mapErrValues = make([]MapErrTelemetry, cpus)
+			}
+		}
+		if b.helperErrMap == nil {
+			b.helperErrMap, _, _ = m.GetMap(probes.HelperErrTelemetryMap)
+			if b.helperErrMap != nil && b.helperErrMap.Type() == ebpf.PerCPUHash {
+				b.helperErrValues = make([]HelperErrTelemetry, cpus)
+			}
+		}
 	}
 
 	if err := b.initializeMapErrTelemetryMap(m.Maps); err != nil {
@@ -108,7 +141,10 @@ func (b *EBPFTelemetry) initializeMapErrTelemetryMap(maps []*manager.Map) error
 		return nil
 	}
 
-	z := new(MapErrTelemetry)
+	var z any = new(MapErrTelemetry)
+	if b.mapErrValues != nil {
+		z = make([]MapErrTelemetry, len(b.mapErrValues))
+	}
 	h := keyHash()
 	for _, m := range maps {
 		// Some maps, such as the telemetry maps, are
@@ -133,7 +169,10 @@ func (b *EBPFTelemetry) initializeHelperErrTelemetryMap() error {
 	}
 
 	// the `probeKeys` get added during instruction patching, so we just try to insert entries for any that don't exist
-	z := new(HelperErrTelemetry)
+	var z any = new(HelperErrTelemetry)
+	if b.helperErrValues != nil {
+		z = make([]HelperErrTelemetry, len(b.helperErrValues))
+	}
 	for p, key := range b.probeKeys {
 		err := b.helperErrMap.Update(&key, z, ebpf.UpdateNoExist)
 		if err != nil && !errors.Is(err, ebpf.ErrKeyExist) {
@@ -143,6 +182,40 @@ func (b *EBPFTelemetry) initializeHelperErrTelemetryMap() error {
 	return nil
 }
 
+// lookupMapErrors reads the map errors of a map, summed over all the CPUs when the map is per-CPU
+func (b *EBPFTelemetry) lookupMapErrors(key uint64, val *MapErrTelemetry) error {
+	if b.mapErrValues == nil {
+		return b.mapErrMap.Lookup(&key, val)
+	}
+	if err := b.mapErrMap.Lookup(&key, b.mapErrValues); err != nil {
+		return err
+	}
+	*val = MapErrTelemetry{}
+	for i := range b.mapErrValues {
+		for errno, count := range b.mapErrValues[i].Count {
+			val.Count[errno] += count
+		}
+	}
+	return nil
+}
+
+// lookupHelperErrors reads the helper errors of a probe, summed over all the CPUs when the map is per-CPU
+func (b *EBPFTelemetry) lookupHelperErrors(key uint64, val *HelperErrTelemetry) error {
+	if b.helperErrValues == nil {
+		return b.helperErrMap.Lookup(&key, val)
+	}
+	if err := b.helperErrMap.Lookup(&key, b.helperErrValues); err != nil {
+		return err
+	}
+	*val = HelperErrTelemetry{}
+	for i := range b.helperErrValues {
+		for slot, count := range b.helperErrValues[i].Count {
+			val.Count[slot] += count
+		}
+	}
+	return nil
+}
+
 // setupForTelemetry sets up the manager to handle eBPF telemetry.
 // It will patch the instructions of all the manager probes and `undefinedProbes` provided.
 // Constants are replaced for map error and helper error keys with their respective values.
@@ -165,6 +238,7 @@ func setupForTelemetry(m *manager.Manager, options *manager.Options, bpfTelemetr
 			m.Maps = append(m.Maps, &manager.Map{Name: probes.HelperErrTelemetryMap})
 		}
 
+		setupMapSpecEditors(options)
 		if bpfTelemetry != nil {
 			bpfTelemetry.setupMapEditors(options)
 		}
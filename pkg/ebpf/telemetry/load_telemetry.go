@@ -0,0 +1,94 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package telemetry
+
+import (
+	"time"
+
+	manager "github.com/DataDog/ebpf-manager"
+
+	"github.com/DataDog/datadog-agent/pkg/telemetry"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
+)
+
+var loadTelemetry = struct {
+	duration       telemetry.Histogram
+	verifiedInsns  telemetry.Gauge
+	attachDuration telemetry.Histogram
+	attachedProbes telemetry.Counter
+}{
+	duration:       telemetry.NewHistogram("ebpf__load", "duration_seconds", []string{"subsystem"}, "time spent loading the eBPF programs and maps of a manager", []float64{0.1, 0.5, 1, 2, 5, 10, 20, 30, 60}),
+	verifiedInsns:  telemetry.NewGauge("ebpf__load", "verified_insns", []string{"subsystem", "program"}, "number of instructions processed by the verifier to load an eBPF program"),
+	attachDuration: telemetry.NewHistogram("ebpf__attach", "duration_seconds", []string{"subsystem"}, "time spent attaching the probes activated by an update of a manager", []float64{0.1, 0.5, 1, 2, 5, 10, 20, 30, 60}),
+	attachedProbes: telemetry.NewCounter("ebpf__attach", "probes", []string{"subsystem", "family"}, "number of probes attached, by family of hooks"),
+}
+
+// LoadTelemetryModifier is a modifier reporting the time spent initializing a manager, which is dominated by the
+// verification of its programs, and the number of instructions processed by the verifier for each program.
+// It holds the start time of the initialization, so each manager needs its own instance.
+type LoadTelemetryModifier struct {
+	// Subsystem tags the telemetry of the manager, for instance "tracer" or "usm"
+	Subsystem string
+
+	start time.Time
+}
+
+// String returns the name of the modifier.
+func (t *LoadTelemetryModifier) String() string {
+	return "LoadTelemetryModifier"
+}
+
+// BeforeInit records the start time of the manager initialization.
+func (t *LoadTelemetryModifier) BeforeInit(_ *manager.Manager, _ *manager.Options) error {
+	t.start = time.Now()
+	return nil
+}
+
+// AfterInit reports the time spent initializing the manager and the verifier cost of its programs.
+func (t *LoadTelemetryModifier) AfterInit(m *manager.Manager, _ *manager.Options) error {
+	ReportManagerLoad(m, t.Subsystem, time.Since(t.start))
+	return nil
+}
+
+// ReportManagerLoad reports the time spent initializing a manager and the number of instructions processed by the
+// verifier for each of its programs. The latter is only available from kernel 5.16.
+func ReportManagerLoad(m *manager.Manager, subsystem string, duration time.Duration) {
+	loadTelemetry.duration.Observe(duration.Seconds(), subsystem)
+	log.Debugf("%s eBPF manager initialized in %s", subsystem, duration)
+
+	programs, err := m.GetPrograms()
+	if err != nil {
+		log.Debugf("unable to get the programs of the %s eBPF manager: %s", subsystem, err)
+		return
+	}
+	for name, prog := range programs {
+		info, err := prog.Info()
+		if err != nil {
+			continue
+		}
+		insns, ok := info.VerifiedInstructions()
+		if !ok {
+			continue
+		}
+		loadTelemetry.verifiedInsns.Set(float64(insns), subsystem, name)
+		log.Tracef("%s eBPF program %s: %d instructions verified", subsystem, name, insns)
+	}
+}
+
+// ReportProbesAttach reports the time spent attaching the probes activated by an update of a manager, and the number
+// of probes it attached for each family of hooks, for instance the event type they report.
+func ReportProbesAttach(subsystem string, duration time.Duration, attachedPerFamily map[string]int) {
+	loadTelemetry.attachDuration.Observe(duration.Seconds(), subsystem)
+
+	total := 0
+	for family, count := range attachedPerFamily {
+		loadTelemetry.attachedProbes.Add(float64(count), subsystem, family)
+		total += count
+	}
+	log.Debugf("%s eBPF manager attached %d probes in %s", subsystem, total, duration)
+}
@@ -86,10 +86,26 @@ type Config struct {
 	// EnablePostgresMonitoring specifies whether the tracer should monitor Postgres traffic.
 	EnablePostgresMonitoring bool
 
+	// EnableRedisMonitoring specifies whether the tracer should monitor Redis traffic.
+	EnableRedisMonitoring bool
+
+	// EnableAMQPMonitoring specifies whether the tracer should monitor AMQP traffic.
+	EnableAMQPMonitoring bool
+
+	// EnableMySQLMonitoring specifies whether the tracer should monitor MySQL traffic.
+	EnableMySQLMonitoring bool
+
+	// EnableMongoMonitoring specifies whether the tracer should monitor Mongo traffic.
+	EnableMongoMonitoring bool
+
 	// EnableNativeTLSMonitoring specifies whether the USM should monitor HTTPS traffic via native libraries.
 	// Supported libraries: OpenSSL, GnuTLS, LibCrypto.
 	EnableNativeTLSMonitoring bool
 
+	// NativeTLSLibrarySuffixes are the endings of the names of the native TLS libraries, before ".so", which are
+	// reported by the kernel when opened, such as "libssl" for libssl.so. Each one holds up to 6 characters.
+	NativeTLSLibrarySuffixes []string
+
 	// EnableIstioMonitoring specifies whether USM should monitor Istio traffic
 	EnableIstioMonitoring bool
 
@@ -186,6 +202,22 @@ type Config struct {
 	// get flushed on every client request (default 30s check interval)
 	MaxPostgresStatsBuffered int
 
+	// MaxRedisStatsBuffered represents the maximum number of Redis stats we'll buffer in memory. These stats
+	// get flushed on every client request (default 30s check interval)
+	MaxRedisStatsBuffered int
+
+	// MaxAMQPStatsBuffered represents the maximum number of AMQP stats we'll buffer in memory. These stats
+	// get flushed on every client request (default 30s check interval)
+	MaxAMQPStatsBuffered int
+
+	// MaxMySQLStatsBuffered represents the maximum number of MySQL stats we'll buffer in memory. These stats
+	// get flushed on every client request (default 30s check interval)
+	MaxMySQLStatsBuffered int
+
+	// MaxMongoStatsBuffered represents the maximum number of Mongo stats we'll buffer in memory. These stats
+	// get flushed on every client request (default 30s check interval)
+	MaxMongoStatsBuffered int
+
 	// MaxConnectionsStateBuffered represents the maximum number of state objects that we'll store in memory. These state objects store
 	// the stats for a connection so we can accurately determine traffic change between client requests.
 	MaxConnectionsStateBuffered int
@@ -280,15 +312,122 @@ type Config struct {
 	// NPMRingbuffersEnabled specifies whether ringbuffers are enabled or not
 	NPMRingbuffersEnabled bool
 
+	// NPMPerCPUConnStatsEnabled specifies whether the connection stats are kept in per-CPU maps, on kernels
+	// supporting them, to avoid contention between the CPUs updating the same connections
+	NPMPerCPUConnStatsEnabled bool
+
+	// EnableUDPFlowAggregation specifies whether the UDP flows of a process sent from an ephemeral port to the same
+	// destination are aggregated in the kernel into a single connection with no source port. This keeps the number
+	// of entries in the conn_stats map down on hosts doing many DNS queries.
+	EnableUDPFlowAggregation bool
+
+	// EnableTCPConnAggregation specifies whether the client TCP connections of a process from an ephemeral port to the
+	// same destination are aggregated in the kernel into a single connection with no source port. This keeps the
+	// number of entries in the conn_stats map, and the payloads, down on nodes running service meshes. It is disabled
+	// along with USM, whose stats are keyed by the source port of the connections.
+	EnableTCPConnAggregation bool
+
+	// NPMDeltaPollingEnabled specifies whether only the connections updated since the previous poll are read from
+	// the conn_stats map, the other ones being reported with the stats they had on their last read
+	NPMDeltaPollingEnabled bool
+
+	// TCPStatsRetransmitsEnabled specifies whether the TCP retransmits are counted in the tcp_stats map, which is then
+	// keyed by the connection tuple without pid, instead of a separate tcp_retransmits map
+	TCPStatsRetransmitsEnabled bool
+
+	// TCPRTTHistogramEnabled specifies whether the RTT samples of the TCP connections are counted in a histogram,
+	// from which the RTT percentiles of the connections are reported as tags. The histograms are kept in their own
+	// tcp_rtt_hist map, which is only sized when this is enabled
+	TCPRTTHistogramEnabled bool
+
+	// ConnMapsNoPrealloc specifies whether the conn_stats and tcp_stats maps are created with BPF_F_NO_PREALLOC, their
+	// entries being allocated on insertion so that their memory follows the number of tracked connections rather
+	// than MaxTrackedConnections
+	ConnMapsNoPrealloc bool
+
+	// ConnMapsLRUEnabled specifies whether the conn_stats and tcp_stats maps are LRU maps, evicting the least
+	// recently updated connections rather than failing to track the new ones when they are full. This takes
+	// precedence over ConnMapsNoPrealloc since the LRU maps are always preallocated.
+	ConnMapsLRUEnabled bool
+
+	// TCPFailedConnectsEnabled specifies whether the closed TCP connections whose connect never completed report its
+	// error. The error isn't available with the prebuilt tracer.
+	TCPFailedConnectsEnabled bool
+
+	// MaxOngoingConnects is the maximum number of TCP connects tracked until they complete, the oldest ones being
+	// evicted when the kernel supports LRU maps
+	MaxOngoingConnects uint32
+
+	// UDPTunnelDecapEnabled specifies whether the socket filters classify the packet encapsulated in a VXLAN or
+	// Geneve packet rather than the tunnel packet itself
+	UDPTunnelDecapEnabled bool
+
+	// TLSHandshakeTagsEnabled specifies whether the classifier parses the ClientHello and ServerHello of the TLS
+	// connections to tag them with the TLS version, cipher suite and ALPN protocol
+	TLSHandshakeTagsEnabled bool
+
+	// NPMConnSamplingRate is N when only one connection out of N is tracked, the byte and packet counts of the
+	// tracked connections being scaled by N. The connections are sampled on a hash of their tuple.
+	NPMConnSamplingRate uint64
+
 	// EnableUSMConnectionRollup enables the aggregation of connection data belonging to a same (client, server) pair
 	EnableUSMConnectionRollup bool
 
+	// ClosedConnWakeupWatermark is the number of bytes of closed connections that can wait in the ring buffer before
+	// the kernel wakes up its consumer, 0 wakes it up as soon as it waits for records. A consumer is also woken up
+	// when a CPU writing to the ring buffer didn't wake it up for 100ms, and by each connections check, which flushes
+	// the ring buffer: the connections closed below the watermark are reported by the next check at the latest.
+	ClosedConnWakeupWatermark int
+
 	// EnableUSMRingBuffers enables the use of eBPF Ring Buffer types on
 	// supported kernels.
 	// Defaults to true. Setting this to false on a Kernel that supports ring
 	// buffers (>=5.8) will result in forcing the use of Perf Maps instead.
 	EnableUSMRingBuffers bool
 
+	// EnableUSMDirectRingBufferEvents makes USM write each event directly to the ring buffer, instead of copying it
+	// into a batch which is later copied to the ring buffer by the next flush.
+	// Only used when ring buffers are enabled.
+	EnableUSMDirectRingBufferEvents bool
+
+	// USMBatchPagesPerCPU sets the number of batch pages per CPU by protocol (http, http2, terminated_http2, kafka,
+	// postgres), between 1 and 64. The protocols not listed use 8 pages. More pages avoid dropping events
+	// when the batches of a busy host are not flushed often enough, fewer pages save memory on idle hosts.
+	USMBatchPagesPerCPU map[string]int
+
+	// USMMaxUnclassifiedPackets is the number of payload packets after which USM stops trying to classify the
+	// protocol of a connection, capping the cost of the connections it can't interpret. 0 means it never gives up.
+	USMMaxUnclassifiedPackets int
+
+	// USMMonitoredPorts restricts USM to the connections using one of these ports or port ranges, like "443" or
+	// "8000-8100". All the connections are monitored when empty.
+	USMMonitoredPorts []string
+
+	// USMMonitoredCgroups restricts the TLS monitoring to the processes of these cgroup v2 paths, absolute or
+	// relative to the cgroup mount point. All the processes are monitored when empty. It requires a 4.18 kernel, and
+	// doesn't apply to the plaintext traffic, whose socket filter doesn't run in the context of the socket owner.
+	USMMonitoredCgroups []string
+
+	// USMCgroupProtocols restricts the TLS decoding of the processes of some cgroups to the listed protocols (http,
+	// http2, kafka, postgres). The processes of the other cgroups decode all the enabled protocols. Like
+	// USMMonitoredCgroups, it requires a 4.18 kernel and doesn't apply to the plaintext traffic.
+	USMCgroupProtocols []*CgroupProtocols
+
+	// HTTPPathOnlyCapture makes the HTTP monitoring keep only the request line of the request fragments, up to the
+	// end of the path. The headers following it are cleared before the fragments leave the kernel.
+	HTTPPathOnlyCapture bool
+
+	// HTTPMaxPathLength truncates the paths captured when HTTPPathOnlyCapture is set. 0 keeps the whole fragment.
+	HTTPMaxPathLength int
+
+	// KafkaInKernelAggregation makes the Kafka monitoring aggregate the requests of each connection, topic, API key
+	// and version in a kernel map drained on each stats collection, instead of sending an event per request.
+	KafkaInKernelAggregation bool
+
+	// EnableUSMCPUCostTelemetry makes the protocol decoders of USM measure the time they spend on each packet or TLS
+	// payload, reported as log2 histograms by protocol in the USM telemetry.
+	EnableUSMCPUCostTelemetry bool
+
 	// EnableUSMEventStream enables USM to use the event stream instead
 	// of netlink for receiving process events.
 	EnableUSMEventStream bool
@@ -298,6 +437,15 @@ func join(pieces ...string) string {
 	return strings.Join(pieces, ".")
 }
 
+// CgroupProtocols lists the protocols decoded for the processes of a cgroup, see Config.USMCgroupProtocols.
+type CgroupProtocols struct {
+	// Cgroup is the path of the cgroup v2, absolute or relative to the cgroup mount point.
+	Cgroup string `mapstructure:"cgroup"`
+
+	// Protocols lists the names of the protocols decoded for the processes of the cgroup.
+	Protocols []string `mapstructure:"protocols"`
+}
+
 // New creates a config for the network tracer
 func New() *Config {
 	cfg := ddconfig.SystemProbe
@@ -340,19 +488,42 @@ func New() *Config {
 
 		ProtocolClassificationEnabled: cfg.GetBool(join(netNS, "enable_protocol_classification")),
 
-		NPMRingbuffersEnabled: cfg.GetBool(join(netNS, "enable_ringbuffers")),
+		NPMRingbuffersEnabled:      cfg.GetBool(join(netNS, "enable_ringbuffers")),
+		NPMPerCPUConnStatsEnabled:  cfg.GetBool(join(netNS, "enable_percpu_conn_stats")),
+		EnableUDPFlowAggregation:   cfg.GetBool(join(netNS, "enable_udp_flow_aggregation")),
+		EnableTCPConnAggregation:   cfg.GetBool(join(netNS, "enable_tcp_conn_aggregation")),
+		NPMDeltaPollingEnabled:     cfg.GetBool(join(netNS, "enable_delta_polling")),
+		TCPStatsRetransmitsEnabled: cfg.GetBool(join(netNS, "enable_tcp_stats_retransmits")),
+		TCPRTTHistogramEnabled:     cfg.GetBool(join(netNS, "enable_tcp_rtt_histogram")),
+		ConnMapsNoPrealloc:         cfg.GetBool(join(netNS, "conn_maps_no_prealloc")),
+		ConnMapsLRUEnabled:         cfg.GetBool(join(netNS, "enable_conn_maps_lru")),
+		TCPFailedConnectsEnabled:   cfg.GetBool(join(netNS, "enable_tcp_failed_connects")),
+		MaxOngoingConnects:         uint32(cfg.GetInt(join(netNS, "max_ongoing_connects"))),
+		UDPTunnelDecapEnabled:      cfg.GetBool(join(netNS, "enable_udp_tunnel_decap")),
+		TLSHandshakeTagsEnabled:    cfg.GetBool(join(netNS, "enable_tls_handshake_tags")),
+		ClosedConnWakeupWatermark:  cfg.GetInt(join(netNS, "closed_conn_wakeup_watermark")),
+		NPMConnSamplingRate:        uint64(cfg.GetInt64(join(netNS, "connection_sampling_rate"))),
 
 		EnableHTTPMonitoring:      cfg.GetBool(join(smNS, "enable_http_monitoring")),
 		EnableHTTP2Monitoring:     cfg.GetBool(join(smNS, "enable_http2_monitoring")),
 		EnableKafkaMonitoring:     cfg.GetBool(join(smNS, "enable_kafka_monitoring")),
 		EnablePostgresMonitoring:  cfg.GetBool(join(smNS, "enable_postgres_monitoring")),
+		EnableRedisMonitoring:     cfg.GetBool(join(smNS, "enable_redis_monitoring")),
+		EnableAMQPMonitoring:      cfg.GetBool(join(smNS, "enable_amqp_monitoring")),
+		EnableMySQLMonitoring:     cfg.GetBool(join(smNS, "enable_mysql_monitoring")),
+		EnableMongoMonitoring:     cfg.GetBool(join(smNS, "enable_mongo_monitoring")),
 		EnableNativeTLSMonitoring: cfg.GetBool(join(smNS, "tls", "native", "enabled")),
+		NativeTLSLibrarySuffixes:  cfg.GetStringSlice(join(smNS, "tls", "native", "library_suffixes")),
 		EnableIstioMonitoring:     cfg.GetBool(join(smNS, "tls", "istio", "enabled")),
 		EnableNodeJSMonitoring:    cfg.GetBool(join(smNS, "tls", "nodejs", "enabled")),
 		MaxUSMConcurrentRequests:  uint32(cfg.GetInt(join(smNS, "max_concurrent_requests"))),
 		MaxHTTPStatsBuffered:      cfg.GetInt(join(smNS, "max_http_stats_buffered")),
 		MaxKafkaStatsBuffered:     cfg.GetInt(join(smNS, "max_kafka_stats_buffered")),
 		MaxPostgresStatsBuffered:  cfg.GetInt(join(smNS, "max_postgres_stats_buffered")),
+		MaxRedisStatsBuffered:     cfg.GetInt(join(smNS, "max_redis_stats_buffered")),
+		MaxAMQPStatsBuffered:      cfg.GetInt(join(smNS, "max_amqp_stats_buffered")),
+		MaxMySQLStatsBuffered:     cfg.GetInt(join(smNS, "max_mysql_stats_buffered")),
+		MaxMongoStatsBuffered:     cfg.GetInt(join(smNS, "max_mongo_stats_buffered")),
 
 		MaxTrackedHTTPConnections: cfg.GetInt64(join(smNS, "max_tracked_http_connections")),
 		HTTPNotificationThreshold: cfg.GetInt64(join(smNS, "http_notification_threshold")),
@@ -399,6 +570,29 @@ func New() *Config {
 		EnableUSMConnectionRollup:   cfg.GetBool(join(smNS, "enable_connection_rollup")),
 		EnableUSMRingBuffers:        cfg.GetBool(join(smNS, "enable_ring_buffers")),
 		EnableUSMEventStream:        cfg.GetBool(join(smNS, "enable_event_stream")),
+
+		EnableUSMDirectRingBufferEvents: cfg.GetBool(join(smNS, "enable_direct_ring_buffer_events")),
+		USMMaxUnclassifiedPackets:       cfg.GetInt(join(smNS, "max_unclassified_packets")),
+		USMMonitoredPorts:               cfg.GetStringSlice(join(smNS, "monitored_ports")),
+		USMMonitoredCgroups:             cfg.GetStringSlice(join(smNS, "monitored_cgroups")),
+		HTTPPathOnlyCapture:             cfg.GetBool(join(smNS, "http_path_only_capture")),
+		HTTPMaxPathLength:               cfg.GetInt(join(smNS, "http_max_path_length")),
+		KafkaInKernelAggregation:        cfg.GetBool(join(smNS, "kafka_in_kernel_aggregation")),
+		EnableUSMCPUCostTelemetry:       cfg.GetBool(join(smNS, "enable_cpu_cost_telemetry")),
+	}
+
+	cgroupProtocolsKey := join(smNS, "cgroup_protocols")
+	if cfg.IsSet(cgroupProtocolsKey) {
+		if err := cfg.UnmarshalKey(cgroupProtocolsKey, &c.USMCgroupProtocols); err != nil {
+			log.Errorf("error parsing %q: %v", cgroupProtocolsKey, err)
+		}
+	}
+
+	batchPagesKey := join(smNS, "batch_pages_per_cpu")
+	if cfg.IsSet(batchPagesKey) {
+		if err := cfg.UnmarshalKey(batchPagesKey, &c.USMBatchPagesPerCPU); err != nil {
+			log.Errorf("error parsing %q: %v", batchPagesKey, err)
+		}
 	}
 
 	httpRRKey := join(smNS, "http_replace_rules")
@@ -428,6 +622,15 @@ func New() *Config {
 	if c.EnableProcessEventMonitoring {
 		log.Info("network process event monitoring enabled")
 	}
+	if c.EnableTCPConnAggregation && c.ServiceMonitoringEnabled {
+		log.Warn("disabling TCP connection aggregation since USM is enabled")
+		c.EnableTCPConnAggregation = false
+	}
+	if c.NPMConnSamplingRate == 0 {
+		c.NPMConnSamplingRate = 1
+	} else if c.NPMConnSamplingRate > 1 {
+		log.Infof("network tracer tracking one connection out of %d", c.NPMConnSamplingRate)
+	}
 	return c
 }
 
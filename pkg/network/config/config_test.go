@@ -1342,6 +1342,25 @@ service_monitoring_config:
 	})
 }
 
+func TestNativeTLSLibrarySuffixes(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := New()
+		assert.Equal(t, []string{"libssl", "crypto", "gnutls"}, cfg.NativeTLSLibrarySuffixes)
+	})
+
+	t.Run("via yaml", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := configurationFromYAML(t, `
+service_monitoring_config:
+  tls:
+    native:
+      library_suffixes: [libssl]
+`)
+		assert.Equal(t, []string{"libssl"}, cfg.NativeTLSLibrarySuffixes)
+	})
+}
+
 func TestNodeJSMonitoring(t *testing.T) {
 	t.Run("default value", func(t *testing.T) {
 		aconfig.ResetSystemProbeConfig(t)
@@ -1394,6 +1413,175 @@ service_monitoring_config:
 	})
 }
 
+func TestUSMBatchPagesPerCPU(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := New()
+		assert.Empty(t, cfg.USMBatchPagesPerCPU)
+	})
+
+	t.Run("via yaml", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := configurationFromYAML(t, `
+service_monitoring_config:
+  batch_pages_per_cpu:
+    http: 16
+    kafka: 2
+`)
+		assert.Equal(t, map[string]int{"http": 16, "kafka": 2}, cfg.USMBatchPagesPerCPU)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_BATCH_PAGES_PER_CPU", `{"http2": 4}`)
+
+		cfg := New()
+		assert.Equal(t, map[string]int{"http2": 4}, cfg.USMBatchPagesPerCPU)
+	})
+}
+
+func TestUSMCgroupProtocols(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := New()
+		assert.Empty(t, cfg.USMCgroupProtocols)
+	})
+
+	t.Run("via yaml", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := configurationFromYAML(t, `
+service_monitoring_config:
+  cgroup_protocols:
+    - cgroup: /system.slice/grpc-server.service
+      protocols:
+        - http2
+    - cgroup: kubepods/kafka-client
+      protocols:
+        - kafka
+        - http
+`)
+		assert.Equal(t, []*CgroupProtocols{
+			{Cgroup: "/system.slice/grpc-server.service", Protocols: []string{"http2"}},
+			{Cgroup: "kubepods/kafka-client", Protocols: []string{"kafka", "http"}},
+		}, cfg.USMCgroupProtocols)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_CGROUP_PROTOCOLS", `[{"cgroup": "/system.slice/grpc-server.service", "protocols": ["http2"]}]`)
+
+		cfg := New()
+		assert.Equal(t, []*CgroupProtocols{
+			{Cgroup: "/system.slice/grpc-server.service", Protocols: []string{"http2"}},
+		}, cfg.USMCgroupProtocols)
+	})
+}
+
+func TestUSMMaxUnclassifiedPackets(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := New()
+		assert.Zero(t, cfg.USMMaxUnclassifiedPackets)
+	})
+
+	t.Run("via yaml", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := configurationFromYAML(t, `
+service_monitoring_config:
+  max_unclassified_packets: 20
+`)
+		assert.Equal(t, 20, cfg.USMMaxUnclassifiedPackets)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_MAX_UNCLASSIFIED_PACKETS", "10")
+
+		cfg := New()
+		assert.Equal(t, 10, cfg.USMMaxUnclassifiedPackets)
+	})
+}
+
+func TestEnableUSMCPUCostTelemetry(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := New()
+		assert.False(t, cfg.EnableUSMCPUCostTelemetry)
+	})
+
+	t.Run("via yaml", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := configurationFromYAML(t, `
+service_monitoring_config:
+  enable_cpu_cost_telemetry: true
+`)
+		assert.True(t, cfg.EnableUSMCPUCostTelemetry)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_ENABLE_CPU_COST_TELEMETRY", "true")
+
+		cfg := New()
+		assert.True(t, cfg.EnableUSMCPUCostTelemetry)
+	})
+}
+
+func TestHTTPPathOnlyCapture(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := New()
+		assert.False(t, cfg.HTTPPathOnlyCapture)
+		assert.Zero(t, cfg.HTTPMaxPathLength)
+	})
+
+	t.Run("via yaml", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := configurationFromYAML(t, `
+service_monitoring_config:
+  http_path_only_capture: true
+  http_max_path_length: 64
+`)
+		assert.True(t, cfg.HTTPPathOnlyCapture)
+		assert.Equal(t, 64, cfg.HTTPMaxPathLength)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_HTTP_PATH_ONLY_CAPTURE", "true")
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_HTTP_MAX_PATH_LENGTH", "32")
+
+		cfg := New()
+		assert.True(t, cfg.HTTPPathOnlyCapture)
+		assert.Equal(t, 32, cfg.HTTPMaxPathLength)
+	})
+}
+
+func TestKafkaInKernelAggregation(t *testing.T) {
+	t.Run("default value", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := New()
+		assert.False(t, cfg.KafkaInKernelAggregation)
+	})
+
+	t.Run("via yaml", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		cfg := configurationFromYAML(t, `
+service_monitoring_config:
+  kafka_in_kernel_aggregation: true
+`)
+		assert.True(t, cfg.KafkaInKernelAggregation)
+	})
+
+	t.Run("via ENV variable", func(t *testing.T) {
+		aconfig.ResetSystemProbeConfig(t)
+		t.Setenv("DD_SERVICE_MONITORING_CONFIG_KAFKA_IN_KERNEL_AGGREGATION", "true")
+
+		cfg := New()
+		assert.True(t, cfg.KafkaInKernelAggregation)
+	})
+}
+
 func TestMaxUSMConcurrentRequests(t *testing.T) {
 	t.Run("default value", func(t *testing.T) {
 		aconfig.ResetSystemProbeConfig(t)
@@ -380,8 +380,13 @@ func (di *DriverInterface) GetClosedConnectionStats(closedBuf *ConnectionBuffer,
 func (db *driverReadBuffer) resizeDriverBuffer(compareSize int) driverResizeResult {
 	// Explicitly setting len to 0 causes the ReadFile syscall to break, so allocate buffer with cap = len
 	origcap := cap(*db)
-	if compareSize >= origcap*2 {
-		*db = make([]uint8, origcap*2)
+	if compareSize > origcap {
+		// grow enough for the next read to fit in a single DeviceIoControl, each call copying the buffer twice
+		newcap := origcap * 2
+		for newcap < compareSize {
+			newcap *= 2
+		}
+		*db = make([]uint8, newcap)
 		return ResizedIncreased
 	} else if compareSize <= origcap/2 {
 		// Take the max of driverReadBuffer/2 and compareSize to limit future array resizes
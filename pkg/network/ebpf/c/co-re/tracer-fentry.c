@@ -1,3 +1,5 @@
+#define TRACER_FENTRY
+
 #include "ktypes.h"
 #include "bpf_telemetry.h"
 #include "bpf_endian.h"
@@ -18,6 +20,11 @@
 
 BPF_PERCPU_HASH_MAP(udp6_send_skb_args, u64, u64, 1024)
 BPF_PERCPU_HASH_MAP(udp_send_skb_args, u64, conn_tuple_t, 1024)
+// Tuples of the established TCP sockets, stored in the socket local storage so that the send and
+// receive paths skip reading and normalizing the tuple from the socket. The tuples are stored
+// without pid and freed with their socket. The type is overridden at runtime if not supported,
+// see sk_storage_tuples_enabled.
+BPF_MAP(sock_tuples, BPF_MAP_TYPE_SK_STORAGE, int, conn_tuple_t, 0, 0, BPF_F_NO_PREALLOC)
 
 #define RETURN_IF_NOT_IN_SYSPROBE_TASK(prog_name)           \
     if (!event_in_task(prog_name)) {                        \
@@ -50,6 +57,45 @@ static __always_inline bool event_in_task(char *prog_name) {
     return !error;
 }
 
+// sk_storage_tuples_enabled returns true if the socket local storage can be used from
+// tracing programs, which is the case since kernel 5.11
+static __always_inline bool sk_storage_tuples_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("sk_storage_tuples_enabled", val);
+    return val > 0;
+}
+
+// read_tcp_conn_tuple reads the tuple of a TCP socket from its local storage, or from the
+// socket, caching it once the socket is established. An empty slot has no metadata.
+static __always_inline int read_tcp_conn_tuple(conn_tuple_t *t, struct sock *sk, u64 pid_tgid) {
+    if (!sk_storage_tuples_enabled()) {
+        return read_conn_tuple(t, sk, pid_tgid, CONN_TYPE_TCP);
+    }
+
+    conn_tuple_t *cached = bpf_sk_storage_get(&sock_tuples, sk, NULL, 0);
+    if (cached && cached->metadata) {
+        *t = *cached;
+        t->pid = pid_tgid >> 32;
+        return 1;
+    }
+
+    if (!read_conn_tuple(t, sk, pid_tgid, CONN_TYPE_TCP)) {
+        return 0;
+    }
+    // the addresses and ports of a socket don't change anymore once it is established
+    if (BPF_CORE_READ(sk, __sk_common.skc_state) != TCP_ESTABLISHED) {
+        return 1;
+    }
+    if (!cached) {
+        cached = bpf_sk_storage_get(&sock_tuples, sk, NULL, BPF_SK_STORAGE_GET_F_CREATE);
+    }
+    if (cached) {
+        *cached = *t;
+        cached->pid = 0;
+    }
+    return 1;
+}
+
 static __always_inline int read_conn_tuple_partial_from_flowi4(conn_tuple_t *t, struct flowi4 *fl4, u64 pid_tgid, metadata_mask_t type) {
     t->pid = pid_tgid >> 32;
     t->metadata = type;
@@ -146,7 +192,7 @@ int BPF_PROG(tcp_sendmsg_exit, struct sock *sk, struct msghdr *msg, size_t size,
     log_debug("fexit/tcp_sendmsg: pid_tgid: %llu, sent: %d, sock: %p", pid_tgid, sent, sk);
 
     conn_tuple_t t = {};
-    if (!read_conn_tuple(&t, sk, pid_tgid, CONN_TYPE_TCP)) {
+    if (!read_tcp_conn_tuple(&t, sk, pid_tgid)) {
         return 0;
     }
 
@@ -171,7 +217,7 @@ RETURN_IF_NOT_IN_SYSPROBE_TASK("fexit/tcp_sendpage");
     log_debug("fexit/tcp_sendpage: pid_tgid: %llu, sent: %d, sock: %p", pid_tgid, sent, sk);
 
     conn_tuple_t t = {};
-    if (!read_conn_tuple(&t, sk, pid_tgid, CONN_TYPE_TCP)) {
+    if (!read_tcp_conn_tuple(&t, sk, pid_tgid)) {
         return 0;
     }
 
@@ -203,6 +249,22 @@ int BPF_PROG(udp_sendpage_exit, struct sock *sk, struct page *page, int offset,
     return handle_message(&t, sent, 0, CONN_DIRECTION_UNKNOWN, 0, 0, PACKET_COUNT_NONE, sk);
 }
 
+// handle_tcp_recv_fentry is handle_tcp_recv reading the tuple with read_tcp_conn_tuple
+static __always_inline int handle_tcp_recv_fentry(u64 pid_tgid, struct sock *sk, int recv) {
+    conn_tuple_t t = {};
+    if (!read_tcp_conn_tuple(&t, sk, pid_tgid)) {
+        return 0;
+    }
+
+    handle_tcp_stats(&t, sk, 0);
+
+    __u32 packets_in = 0;
+    __u32 packets_out = 0;
+    get_tcp_segment_counts(sk, &packets_in, &packets_out);
+
+    return handle_message(&t, 0, recv, CONN_DIRECTION_UNKNOWN, packets_out, packets_in, PACKET_COUNT_ABSOLUTE, sk);
+}
+
 SEC("fexit/tcp_recvmsg")
 int BPF_PROG(tcp_recvmsg_exit, struct sock *sk, struct msghdr *msg, size_t len, int flags, int *addr_len, int copied) {
     RETURN_IF_NOT_IN_SYSPROBE_TASK("fexit/tcp_recvmsg");
@@ -211,7 +273,7 @@ int BPF_PROG(tcp_recvmsg_exit, struct sock *sk, struct msghdr *msg, size_t len,
     }
 
     u64 pid_tgid = bpf_get_current_pid_tgid();
-    return handle_tcp_recv(pid_tgid, sk, copied);
+    return handle_tcp_recv_fentry(pid_tgid, sk, copied);
 }
 
 SEC("fexit/tcp_recvmsg")
@@ -222,7 +284,7 @@ int BPF_PROG(tcp_recvmsg_exit_pre_5_19_0, struct sock *sk, struct msghdr *msg, s
     }
 
     u64 pid_tgid = bpf_get_current_pid_tgid();
-    return handle_tcp_recv(pid_tgid, sk, copied);
+    return handle_tcp_recv_fentry(pid_tgid, sk, copied);
 }
 
 SEC("fentry/tcp_close")
@@ -231,17 +293,25 @@ int BPF_PROG(tcp_close, struct sock *sk, long timeout) {
     conn_tuple_t t = {};
     u64 pid_tgid = bpf_get_current_pid_tgid();
 
-    // Should actually delete something only if the connection never got established
-    bpf_map_delete_elem(&tcp_ongoing_connect_pid, &sk);
+    // Should actually find something only if the connection never got established
+    tcp_ongoing_connect_t connect = {};
+    bool failed_connect = pop_failed_connect(sk, &connect);
+    if (failed_connect) {
+        pid_tgid = connect.pid_tgid;
+    }
 
     // Get network namespace id
     log_debug("fentry/tcp_close: tgid: %llu, pid: %llu", pid_tgid >> 32, pid_tgid & 0xFFFFFFFF);
-    if (!read_conn_tuple(&t, sk, pid_tgid, CONN_TYPE_TCP)) {
+    if (!read_tcp_conn_tuple(&t, sk, pid_tgid)) {
         return 0;
     }
+    if (sk_storage_tuples_enabled()) {
+        // the socket can be reconnected with another tuple after it was closed
+        bpf_sk_storage_delete(&sock_tuples, sk);
+    }
     log_debug("fentry/tcp_close: netns: %u, sport: %u, dport: %u", t.netns, t.sport, t.dport);
 
-    cleanup_conn(ctx, &t, sk);
+    cleanup_conn(ctx, &t, sk, failed_connect ? &connect : NULL);
     return 0;
 }
 
@@ -268,11 +338,9 @@ static __always_inline int handle_udp_send(struct sock *sk, int sent) {
     return 0;
 }
 
-SEC("kprobe/udp_v6_send_skb")
-int kprobe__udp_v6_send_skb(struct pt_regs *ctx) {
-    RETURN_IF_NOT_IN_SYSPROBE_TASK("kprobe/udp_v6_send_skb");
-    struct sk_buff *skb = (struct sk_buff*) PT_REGS_PARM1(ctx);
-    struct flowi6 *fl6 = (struct flowi6*) PT_REGS_PARM2(ctx);
+SEC("fentry/udp_v6_send_skb")
+int BPF_PROG(udp_v6_send_skb, struct sk_buff *skb, struct flowi6 *fl6) {
+    RETURN_IF_NOT_IN_SYSPROBE_TASK("fentry/udp_v6_send_skb");
     u64 pid_tgid = bpf_get_current_pid_tgid();
     struct sock *sk = BPF_CORE_READ(skb, sk);
     conn_tuple_t t;
@@ -295,11 +363,9 @@ int BPF_PROG(udpv6_sendmsg_exit, struct sock *sk, struct msghdr *msg, size_t len
     return handle_udp_send(sk, sent);
 }
 
-SEC("kprobe/udp_send_skb")
-int kprobe__udp_send_skb(struct pt_regs *ctx) {
-    RETURN_IF_NOT_IN_SYSPROBE_TASK("kprobe/udp_send_skb");
-    struct sk_buff *skb = (struct sk_buff*) PT_REGS_PARM1(ctx);
-    struct flowi4 *fl4 = (struct flowi4*) PT_REGS_PARM2(ctx);
+SEC("fentry/udp_send_skb")
+int BPF_PROG(udp_send_skb, struct sk_buff *skb, struct flowi4 *fl4) {
+    RETURN_IF_NOT_IN_SYSPROBE_TASK("fentry/udp_send_skb");
     u64 pid_tgid = bpf_get_current_pid_tgid();
     struct sock *sk = BPF_CORE_READ(skb, sk);
     conn_tuple_t t;
@@ -322,6 +388,8 @@ int BPF_PROG(udp_sendmsg_exit, struct sock *sk, struct msghdr *msg, size_t len,
     return handle_udp_send(sk, sent);
 }
 
+// The udp_recvmsg and udpv6_recvmsg programs are only used with skb_free_datagram_locked,
+// skb_consume_udp is passed a negative length for peeking calls
 static __always_inline int handle_udp_recvmsg(struct sock *sk, int flags) {
     if (flags & MSG_PEEK) {
         return 0;
@@ -400,47 +468,25 @@ int BPF_PROG(__skb_free_datagram_locked, struct sock *sk, struct sk_buff *skb, i
 SEC("fentry/skb_consume_udp")
 int BPF_PROG(skb_consume_udp, struct sock *sk, struct sk_buff *skb, int len) {
     RETURN_IF_NOT_IN_SYSPROBE_TASK("fentry/skb_consume_udp");
-    return handle_skb_consume_udp(sk, skb, len);
-}
-
-SEC("fentry/tcp_retransmit_skb")
-int BPF_PROG(tcp_retransmit_skb, struct sock *sk, struct sk_buff *skb, int segs, int err) {
-    RETURN_IF_NOT_IN_SYSPROBE_TASK("fentry/tcp_retransmit_skb");
-    log_debug("fexntry/tcp_retransmit");
-    u64 tid = bpf_get_current_pid_tgid();
-    tcp_retransmit_skb_args_t args = {};
-    args.retrans_out_pre = BPF_CORE_READ(tcp_sk(sk), retrans_out);
-    if (args.retrans_out_pre < 0) {
+    if (len < 0) {
+        // peeking or an error happened
         return 0;
     }
-
-    bpf_map_update_with_telemetry(pending_tcp_retransmit_skb, &tid, &args, BPF_ANY);
-
-    return 0;
+    return handle_udp_recv(sk, skb, bpf_get_current_pid_tgid());
 }
 
 SEC("fexit/tcp_retransmit_skb")
 int BPF_PROG(tcp_retransmit_skb_exit, struct sock *sk, struct sk_buff *skb, int segs, int err) {
     RETURN_IF_NOT_IN_SYSPROBE_TASK("fexit/tcp_retransmit_skb");
     log_debug("fexit/tcp_retransmit");
-    u64 tid = bpf_get_current_pid_tgid();
-    if (err < 0) {
-        bpf_map_delete_elem(&pending_tcp_retransmit_skb, &tid);
-        return 0;
-    }
-    tcp_retransmit_skb_args_t *args = bpf_map_lookup_elem(&pending_tcp_retransmit_skb, &tid);
-    if (args == NULL) {
+    if (err != 0) {
         return 0;
     }
-    u32 retrans_out_pre = args->retrans_out_pre;
-    u32 retrans_out = BPF_CORE_READ(tcp_sk(sk), retrans_out);
-    bpf_map_delete_elem(&pending_tcp_retransmit_skb, &tid);
 
-    if (retrans_out < 0) {
-        return 0;
-    }
-
-    return handle_retransmit(sk, retrans_out-retrans_out_pre);
+    // on success tcp_retransmit_skb adds the segment count of the skb to retrans_out,
+    // so unlike the kprobe there is no need to save its value on entry
+    struct tcp_skb_cb *cb = (struct tcp_skb_cb *)skb->cb;
+    return handle_retransmit(sk, BPF_CORE_READ(cb, tcp_gso_segs));
 }
 
 SEC("fentry/tcp_connect")
@@ -449,20 +495,28 @@ int BPF_PROG(tcp_connect, struct sock *sk) {
     u64 pid_tgid = bpf_get_current_pid_tgid();
     log_debug("fentry/tcp_connect: tgid: %llu, pid: %llu", pid_tgid >> 32, pid_tgid & 0xFFFFFFFF);
 
-    bpf_map_update_with_telemetry(tcp_ongoing_connect_pid, &sk, &pid_tgid, BPF_ANY);
+    tcp_ongoing_connect_t connect = { .pid_tgid = pid_tgid, .timestamp = bpf_ktime_get_ns() };
+    bpf_map_update_with_telemetry(tcp_ongoing_connect_pid, &sk, &connect, BPF_ANY);
 
     return 0;
 }
 
+SEC("fentry/tcp_done")
+int BPF_PROG(tcp_done, struct sock *sk) {
+    RETURN_IF_NOT_IN_SYSPROBE_TASK("fentry/tcp_done");
+    record_connect_err(sk);
+    return 0;
+}
+
 SEC("fentry/tcp_finish_connect")
 int BPF_PROG(tcp_finish_connect, struct sock *sk, struct sk_buff *skb, int rc) {
     RETURN_IF_NOT_IN_SYSPROBE_TASK("fentry/tcp_finish_connect");
-    u64 *pid_tgid_p = bpf_map_lookup_elem(&tcp_ongoing_connect_pid, &sk);
-    if (!pid_tgid_p) {
+    tcp_ongoing_connect_t *connect = bpf_map_lookup_elem(&tcp_ongoing_connect_pid, &sk);
+    if (!connect) {
         return 0;
     }
 
-    u64 pid_tgid = *pid_tgid_p;
+    u64 pid_tgid = connect->pid_tgid;
     bpf_map_delete_elem(&tcp_ongoing_connect_pid, &sk);
     log_debug("fentry/tcp_finish_connect: tgid: %llu, pid: %llu", pid_tgid >> 32, pid_tgid & 0xFFFFFFFF);
 
@@ -490,7 +544,7 @@ int BPF_PROG(inet_csk_accept_exit, struct sock *_sk, int flags, int *err, bool k
     log_debug("fexit/inet_csk_accept: tgid: %llu, pid: %llu", pid_tgid >> 32, pid_tgid & 0xFFFFFFFF);
 
     conn_tuple_t t = {};
-    if (!read_conn_tuple(&t, sk, pid_tgid, CONN_TYPE_TCP)) {
+    if (!read_tcp_conn_tuple(&t, sk, pid_tgid)) {
         return 0;
     }
     handle_tcp_stats(&t, sk, TCP_ESTABLISHED);
@@ -528,7 +582,7 @@ static __always_inline int handle_udp_destroy_sock(void *ctx, struct sock *sk) {
 
     __u16 lport = 0;
     if (valid_tuple) {
-        cleanup_conn(ctx, &tup, sk);
+        cleanup_conn(ctx, &tup, sk, NULL);
         lport = tup.sport;
     } else {
         // get the port for the current sock
@@ -604,4 +658,11 @@ int BPF_PROG(inet6_bind_exit, struct socket *sock, struct sockaddr *uaddr, int a
     return sys_exit_bind(rc);
 }
 
+// run by userspace with BPF_PROG_TEST_RUN before each connections check, see flush_conn_close_events
+SEC("socket/conn_close_flush")
+int socket__conn_close_flush(struct __sk_buff *skb) {
+    flush_conn_close_events();
+    return 0;
+}
+
 char _license[] SEC("license") = "GPL";
@@ -85,6 +85,9 @@ static __always_inline int nf_conntrack_tuple_to_conntrack_tuple(conntrack_tuple
                 t->daddr_l, t->daddr_h);
             return 0;
         }
+    } else {
+        // IPv6 isn't collected, don't store entries without addresses
+        return 0;
     }
 
     return 1;
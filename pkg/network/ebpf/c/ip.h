@@ -54,6 +54,29 @@ struct __tcphdr {
 #define __IPPROTO_TCP 6
 #define __IPPROTO_UDP 17
 
+// IPv6 extension headers, from uapi/linux/in6.h
+#define __IPPROTO_HOPOPTS 0
+#define __IPPROTO_ROUTING 43
+#define __IPPROTO_FRAGMENT 44
+#define __IPPROTO_AH 51
+#define __IPPROTO_DSTOPTS 60
+
+// mask of the fragment offset in the IPv6 fragment header, from net/ipv6.h
+#define IPV6_FRAG_OFFSET_MASK 0xFFF8
+#define IPV6_FRAG_HDR_LEN 8
+
+// maximum number of IPv6 extension headers skipped to reach the transport header
+#define IPV6_MAX_EXT_HEADERS 4
+
+// from uapi/linux/if_ether.h
+#define __ETH_P_TEB 0x6558 /* Trans Ether Bridging */
+
+// IANA ports of the UDP tunnels decapsulated by read_conn_tuple_skb
+#define VXLAN_PORT 4789
+#define GENEVE_PORT 6081
+#define VXLAN_HDR_LEN 8
+#define GENEVE_HDR_LEN 8
+
 // TODO: these are mostly hacky placeholders until we decide on what is the best
 // approach to work around the eBPF bug described here:
 // https://github.com/torvalds/linux/commit/e6a18d36118bea3bf497c9df4d9988b6df120689
@@ -125,14 +148,51 @@ typedef struct {
     __u8 tcp_flags;
 } skb_info_t;
 
-// On older kernels, clang can generate Wunused-function warnings on static inline functions defined in
-// header files, even if they are later used in source files. __maybe_unused prevents that issue
-__maybe_unused static __always_inline __u64 read_conn_tuple_skb(struct __sk_buff *skb, skb_info_t *info, conn_tuple_t *tup) {
-    bpf_memset(info, 0, sizeof(skb_info_t));
-    info->data_off = ETH_HLEN;
+static __always_inline bool udp_tunnel_decap_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("udp_tunnel_decap_enabled", val);
+    return val > 0;
+}
+
+// skip_ipv6_ext_headers moves info->data_off past the extension headers following the fixed IPv6 header, and returns
+// the protocol of the header it stops at. A non-first fragment carries no transport header, so 0 is returned.
+static __always_inline __u8 skip_ipv6_ext_headers(struct __sk_buff *skb, skb_info_t *info, __u8 nexthdr) {
+    __u32 hdr_len = 0;
+#pragma unroll
+    for (int i = 0; i < IPV6_MAX_EXT_HEADERS; i++) {
+        switch (nexthdr) {
+        case __IPPROTO_HOPOPTS:
+        case __IPPROTO_ROUTING:
+        case __IPPROTO_DSTOPTS:
+            // the length is in 8-octet units, not including the first 8 octets
+            hdr_len = (__load_byte(skb, info->data_off + 1) + 1) << 3;
+            break;
+        case __IPPROTO_AH:
+            // the length is in 4-octet units, minus 2
+            hdr_len = (__load_byte(skb, info->data_off + 1) + 2) << 2;
+            break;
+        case __IPPROTO_FRAGMENT:
+            if (__load_half(skb, info->data_off + 2) & IPV6_FRAG_OFFSET_MASK) {
+                return 0;
+            }
+            hdr_len = IPV6_FRAG_HDR_LEN;
+            break;
+        default:
+            return nexthdr;
+        }
+        nexthdr = __load_byte(skb, info->data_off);
+        info->data_off += hdr_len;
+    }
+    // an extension header still left is rejected by the caller as an unknown transport protocol
+    return nexthdr;
+}
 
-    __u16 l3_proto = __load_half(skb, offsetof(struct ethhdr, h_proto));
-    info->data_end = ETH_HLEN;
+// read_conn_tuple_skb_at parses the Ethernet frame starting at l2_off in the skb.
+static __always_inline __u64 read_conn_tuple_skb_at(struct __sk_buff *skb, skb_info_t *info, conn_tuple_t *tup, __u32 l2_off) {
+    info->data_off = l2_off + ETH_HLEN;
+
+    __u16 l3_proto = __load_half(skb, l2_off + offsetof(struct ethhdr, h_proto));
+    info->data_end = l2_off + ETH_HLEN;
     __u8 l4_proto = 0;
     switch (l3_proto) {
     case ETH_P_IP:
@@ -156,6 +216,7 @@ __maybe_unused static __always_inline __u64 read_conn_tuple_skb(struct __sk_buff
         read_ipv6_skb(skb, info->data_off + offsetof(struct ipv6hdr, saddr), &tup->saddr_l, &tup->saddr_h);
         read_ipv6_skb(skb, info->data_off + offsetof(struct ipv6hdr, daddr), &tup->daddr_l, &tup->daddr_h);
         info->data_off += sizeof(struct ipv6hdr);
+        l4_proto = skip_ipv6_ext_headers(skb, info, l4_proto);
         break;
     default:
         return 0;
@@ -189,6 +250,50 @@ __maybe_unused static __always_inline __u64 read_conn_tuple_skb(struct __sk_buff
     return 1;
 }
 
+// udp_tunnel_inner_frame returns the offset of the Ethernet frame encapsulated in a VXLAN or Geneve packet whose
+// outer headers were parsed into info and tup, 0 if the packet isn't one.
+static __always_inline __u32 udp_tunnel_inner_frame(struct __sk_buff *skb, skb_info_t *info, conn_tuple_t *tup) {
+    if (!(tup->metadata & CONN_TYPE_UDP)) {
+        return 0;
+    }
+    switch (tup->dport) {
+    case VXLAN_PORT:
+        return info->data_off + VXLAN_HDR_LEN;
+    case GENEVE_PORT:
+        if (__load_half(skb, info->data_off + 2) != __ETH_P_TEB) {
+            return 0;
+        }
+        // the options length is in 4-octet units
+        return info->data_off + GENEVE_HDR_LEN + ((__load_byte(skb, info->data_off) & 0x3f) << 2);
+    default:
+        return 0;
+    }
+}
+
+// On older kernels, clang can generate Wunused-function warnings on static inline functions defined in
+// header files, even if they are later used in source files. __maybe_unused prevents that issue
+//
+// When the udp_tunnel_decap_enabled constant is set, the tuple of a VXLAN or Geneve packet is the one of the
+// encapsulated packet, so overlay traffic whose tunnel isn't terminated by this host's kernel can be classified.
+__maybe_unused static __always_inline __u64 read_conn_tuple_skb(struct __sk_buff *skb, skb_info_t *info, conn_tuple_t *tup) {
+    bpf_memset(info, 0, sizeof(skb_info_t));
+    if (!read_conn_tuple_skb_at(skb, info, tup, 0)) {
+        return 0;
+    }
+    if (!udp_tunnel_decap_enabled()) {
+        return 1;
+    }
+
+    __u32 inner_off = udp_tunnel_inner_frame(skb, info, tup);
+    if (inner_off == 0) {
+        return 1;
+    }
+    // a single level of encapsulation is decapsulated
+    bpf_memset(info, 0, sizeof(skb_info_t));
+    bpf_memset(tup, 0, sizeof(conn_tuple_t));
+    return read_conn_tuple_skb_at(skb, info, tup, inner_off);
+}
+
 __maybe_unused static __always_inline bool is_equal(conn_tuple_t *t, conn_tuple_t *t2) {
     bool match = !bpf_memcmp(t, t2, sizeof(conn_tuple_t));
     return match;
@@ -6,6 +6,29 @@
 #include "offsets.h"
 #include "ip.h"
 
+#define DNS_HEADER_SIZE 12
+#define DNS_FLAGS_OFFSET 2
+#define DNS_QDCOUNT_OFFSET 4
+#define DNS_FLAG_QR 0x8000
+
+// is_skipped_dns_payload returns true for the UDP DNS messages the userspace parser would discard anyway, so that
+// they are dropped here rather than copied to the raw socket and decoded: messages without exactly one question, and
+// queries when DNS stats are disabled. TCP messages are left to userspace as they are length-prefixed and can span
+// several segments.
+static __always_inline bool is_skipped_dns_payload(struct __sk_buff *skb, skb_info_t *skb_info, conn_tuple_t *tup) {
+    if (tup->metadata & CONN_TYPE_TCP) {
+        return false;
+    }
+    if (skb_info->data_off + DNS_HEADER_SIZE > skb_info->data_end) {
+        return false;
+    }
+    if (__load_half(skb, skb_info->data_off + DNS_QDCOUNT_OFFSET) != 1) {
+        return true;
+    }
+    __u16 flags = __load_half(skb, skb_info->data_off + DNS_FLAGS_OFFSET);
+    return !(flags & DNS_FLAG_QR) && !dns_stats_enabled();
+}
+
 // This function is meant to be used as a BPF_PROG_TYPE_SOCKET_FILTER.
 // When attached to a RAW_SOCKET, this code filters out everything but DNS traffic.
 // All structs referenced here are kernel independent as they simply map protocol headers (Ethernet, IP and UDP).
@@ -20,6 +43,9 @@ int socket__dns_filter(struct __sk_buff* skb) {
     if (tup.sport != 53 && (!dns_stats_enabled() || tup.dport != 53)) {
         return 0;
     }
+    if (is_skipped_dns_payload(skb, &skb_info, &tup)) {
+        return 0;
+    }
 
     return -1;
 }
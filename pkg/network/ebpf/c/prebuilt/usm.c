@@ -5,13 +5,18 @@
 
 #include "offsets.h"
 
+#include "protocols/amqp/decoding.h"
 #include "protocols/classification/dispatcher-helpers.h"
+#include "protocols/classification/gc.h"
 #include "protocols/http/buffer.h"
 #include "protocols/http/http.h"
 #include "protocols/http2/decoding.h"
 #include "protocols/http2/decoding-tls.h"
 #include "protocols/kafka/kafka-parsing.h"
+#include "protocols/mongo/decoding.h"
+#include "protocols/mysql/decoding.h"
 #include "protocols/postgres/decoding.h"
+#include "protocols/redis/decoding.h"
 #include "protocols/sockfd-probes.h"
 #include "protocols/tls/java/erpc_dispatcher.h"
 #include "protocols/tls/java/erpc_handlers.h"
@@ -58,6 +63,18 @@ int tracepoint__net__netif_receive_skb(struct pt_regs* ctx) {
     terminated_http2_batch_flush(ctx);
     kafka_batch_flush(ctx);
     postgres_batch_flush(ctx);
+    redis_batch_flush(ctx);
+    amqp_batch_flush(ctx);
+    mysql_batch_flush(ctx);
+    mongo_batch_flush(ctx);
+    return 0;
+}
+
+// Arms the timer of the classification garbage collector, only loaded on the kernels supporting bpf_timer, see
+// protocols/classification/gc.h.
+SEC("tracepoint/net/netif_receive_skb")
+int tracepoint__net__netif_receive_skb_classification_gc(void *ctx) {
+    classification_gc_arm();
     return 0;
 }
 
@@ -0,0 +1,124 @@
+#ifndef __AMQP_DECODING_H
+#define __AMQP_DECODING_H
+
+#include "bpf_builtins.h"
+#include "bpf_endian.h"
+
+#include "protocols/amqp/decoding-maps.h"
+#include "protocols/amqp/defs.h"
+#include "protocols/amqp/types.h"
+#include "protocols/amqp/usm-events.h"
+#include "protocols/classification/dispatcher-helpers.h"
+#include "protocols/cpu-cost.h"
+#include "protocols/helpers/pktbuf.h"
+#include "protocols/read_into_buffer.h"
+
+PKTBUF_READ_INTO_BUFFER(amqp_exchange, AMQP_MAX_EXCHANGE_NAME_LEN, BLK_SIZE)
+
+// Returns the offset of the exchange name of the basic.publish or basic.deliver method whose frame starts at
+// `frame_off`, or 0 if it is out of the packet.
+static __always_inline __u32 amqp_exchange_offset(pktbuf_t pkt, __u32 frame_off, __u16 method_id) {
+    if (method_id == AMQP_METHOD_PUBLISH) {
+        return frame_off + AMQP_PUBLISH_EXCHANGE_OFFSET;
+    }
+
+    __u8 consumer_tag_len = 0;
+    const __u32 consumer_tag_off = frame_off + AMQP_DELIVER_CONSUMER_TAG_OFFSET;
+    if (consumer_tag_off + sizeof(consumer_tag_len) > pktbuf_data_end(pkt)) {
+        return 0;
+    }
+    pktbuf_load_bytes(pkt, consumer_tag_off, &consumer_tag_len, sizeof(consumer_tag_len));
+    return consumer_tag_off + sizeof(consumer_tag_len) + consumer_tag_len + AMQP_DELIVER_TAG_AND_REDELIVERED_SIZE;
+}
+
+// Enqueues the message carried by the basic.publish or basic.deliver method whose frame starts at `frame_off`. To
+// spare stack size, we take a scratch buffer from the map to prepare the event.
+static __always_inline void amqp_handle_message(pktbuf_t pkt, conn_tuple_t *tup, __u32 frame_off, __u16 method_id) {
+    const __u32 exchange_off = amqp_exchange_offset(pkt, frame_off, method_id);
+    __u8 exchange_len = 0;
+    if (exchange_off == 0 || exchange_off + sizeof(exchange_len) > pktbuf_data_end(pkt)) {
+        return;
+    }
+    pktbuf_load_bytes(pkt, exchange_off, &exchange_len, sizeof(exchange_len));
+
+    const u32 zero = 0;
+    amqp_event_t *event = bpf_map_lookup_elem(&amqp_scratch_buffer, &zero);
+    if (!event) {
+        return;
+    }
+
+    bpf_memset(event, 0, sizeof(amqp_event_t));
+    bpf_memcpy(&event->tuple, tup, sizeof(conn_tuple_t));
+    // The stats are keyed by the normalized tuple, like the other protocols.
+    normalize_tuple(&event->tuple);
+    pktbuf_read_into_buffer_amqp_exchange(event->message.exchange, pkt, exchange_off + sizeof(exchange_len));
+    event->message.exchange_len = exchange_len < AMQP_MAX_EXCHANGE_NAME_LEN ? exchange_len : AMQP_MAX_EXCHANGE_NAME_LEN;
+    event->message.method = method_id;
+    amqp_batch_enqueue(event);
+}
+
+// Scans the frames of the packet, enqueuing the messages of the basic.publish and basic.deliver methods. The scan
+// stops at the first frame which doesn't end in the packet, or isn't a valid frame, as in the middle of a large body.
+static __always_inline void amqp_entrypoint(pktbuf_t pkt, conn_tuple_t *tup) {
+    __u32 frame_off = pktbuf_data_offset(pkt);
+    const __u32 data_end = pktbuf_data_end(pkt);
+    amqp_frame_header frame_header;
+    amqp_header method_header;
+    __u8 frame_end = 0;
+
+#pragma unroll(AMQP_MAX_FRAMES_PER_PACKET)
+    for (__u8 i = 0; i < AMQP_MAX_FRAMES_PER_PACKET; ++i) {
+        if (frame_off + AMQP_FRAME_HEADER_SIZE > data_end) {
+            break;
+        }
+        pktbuf_load_bytes(pkt, frame_off, &frame_header, sizeof(frame_header));
+        const __u32 frame_size = bpf_ntohl(frame_header.size);
+        const __u32 frame_end_off = frame_off + AMQP_FRAME_HEADER_SIZE + frame_size;
+        if (frame_end_off < frame_off || frame_end_off + AMQP_FRAME_END_SIZE > data_end) {
+            break;
+        }
+        pktbuf_load_bytes(pkt, frame_end_off, &frame_end, sizeof(frame_end));
+        if (frame_end != AMQP_FRAME_END) {
+            break;
+        }
+
+        if (frame_header.type == AMQP_FRAME_METHOD_TYPE && frame_size >= sizeof(method_header)) {
+            pktbuf_load_bytes(pkt, frame_off + AMQP_FRAME_HEADER_SIZE, &method_header, sizeof(method_header));
+            const __u16 method_id = bpf_ntohs(method_header.method_id);
+            if (bpf_ntohs(method_header.class_id) == AMQP_BASIC_CLASS && (method_id == AMQP_METHOD_PUBLISH || method_id == AMQP_METHOD_DELIVER)) {
+                amqp_handle_message(pkt, tup, frame_off, method_id);
+            }
+        }
+
+        frame_off = frame_end_off + AMQP_FRAME_END_SIZE;
+    }
+}
+
+// Entrypoint to process plaintext AMQP traffic. Pulls the connection tuple and the packet buffer from the map and
+// calls the main processing function. As the messages are counted without tracking any state, the TCP terminations
+// need no handling.
+static __always_inline int __socket__amqp_process(struct __sk_buff* skb) {
+    skb_info_t skb_info = {};
+    conn_tuple_t conn_tuple = {};
+
+    if (!fetch_dispatching_arguments(&conn_tuple, &skb_info)) {
+        return 0;
+    }
+
+    if (is_tcp_termination(&skb_info)) {
+        return 0;
+    }
+
+    pktbuf_t pkt = pktbuf_from_skb(skb, &skb_info);
+    amqp_entrypoint(pkt, &conn_tuple);
+    return 0;
+}
+
+SEC("socket/amqp_process")
+int socket__amqp_process(struct __sk_buff* skb) {
+    const int ret = __socket__amqp_process(skb);
+    usm_cpu_cost_end();
+    return ret;
+}
+
+#endif
@@ -25,9 +25,34 @@
 #define AMQP_MIN_FRAME_LENGTH 8
 #define AMQP_MIN_PAYLOAD_LENGTH 11
 
+// AMQP frame types, besides the method frames.
+#define AMQP_FRAME_HEADER_TYPE 2
+#define AMQP_FRAME_BODY_TYPE 3
+#define AMQP_FRAME_HEARTBEAT_TYPE 8
+
+// The size of the header of a frame (type, channel and payload size), and of the frame-end octet following the payload.
+#define AMQP_FRAME_HEADER_SIZE 7
+#define AMQP_FRAME_END_SIZE 1
+#define AMQP_FRAME_END 0xCE
+
+// Offsets of the arguments of the basic.publish and basic.deliver methods, from the start of their frame.
+// basic.publish starts with a reserved short, followed by the exchange name.
+#define AMQP_PUBLISH_EXCHANGE_OFFSET 13
+// basic.deliver starts with the consumer tag short string, followed by the delivery tag, the redelivered bit and
+// the exchange name.
+#define AMQP_DELIVER_CONSUMER_TAG_OFFSET 11
+#define AMQP_DELIVER_TAG_AND_REDELIVERED_SIZE 9
+
 typedef struct {
     __u16 class_id;
     __u16 method_id;
 } amqp_header;
 
+// The header of every frame, followed by `size` bytes of payload and the frame-end octet.
+typedef struct {
+    __u8 type;
+    __u16 channel;
+    __u32 size;
+} __attribute__((packed)) amqp_frame_header;
+
 #endif
@@ -0,0 +1,31 @@
+#ifndef __AMQP_TYPES_H
+#define __AMQP_TYPES_H
+
+#include "conn_tuple.h"
+
+// Controls the number of AMQP messages read from userspace at a time.
+#define AMQP_BATCH_SIZE 40
+
+// Maximum length of the exchange name sent to userspace, the longer names are truncated.
+#define AMQP_MAX_EXCHANGE_NAME_LEN 32
+
+// Maximum number of frames of a single packet scanned for basic.publish and basic.deliver methods.
+#define AMQP_MAX_FRAMES_PER_PACKET 16
+
+// A message published to, or delivered from, an exchange.
+typedef struct {
+    // The name of the exchange, stored up to AMQP_MAX_EXCHANGE_NAME_LEN bytes. The default exchange has an empty name.
+    char exchange[AMQP_MAX_EXCHANGE_NAME_LEN];
+    // The size of the name stored in exchange.
+    __u8 exchange_len;
+    // The method carrying the message, either AMQP_METHOD_PUBLISH or AMQP_METHOD_DELIVER.
+    __u8 method;
+} amqp_message_t;
+
+// The struct we send to userspace, containing the connection tuple and the message information.
+typedef struct {
+    conn_tuple_t tuple;
+    amqp_message_t message;
+} amqp_event_t;
+
+#endif
@@ -12,6 +12,7 @@
 #include "protocols/mysql/defs.h"
 #include "protocols/redis/defs.h"
 #include "protocols/sql/defs.h"
+#include "protocols/tls/tags-types.h"
 
 // Represents the max buffer size required to classify protocols .
 // We need to round it to be multiplication of 16 since we are reading blocks of 16 bytes in read_into_buffer_skb_all_kernels.
@@ -36,6 +37,7 @@
 #define FLAG_SOCKET_FILTER_DELETION 1 << 4
 #define FLAG_SERVER_SIDE            1 << 5
 #define FLAG_CLIENT_SIDE            1 << 6
+#define FLAG_UNCLASSIFIABLE         1 << 7
 
 // The enum below represents all different protocols we're able to
 // classify. Entries are segmented such that it is possible to infer the
@@ -107,9 +109,21 @@ typedef struct {
 // prevents that, because we pretty much only store the wrapper type in the
 // connection_protocol map, but elsewhere in the code we're still using
 // protocol_stack_t, so this is change is "transparent" to most of the code.
+//
+// `unclassified_packets` counts the payload packets the USM socket filter failed to
+// classify, see `protocol_dispatcher_entrypoint`. It fits in the padding before `updated`.
+//
+// `tls_tags` holds the handshake details of the TLS connections, see `tls_process_handshake`.
+//
+// `tcp_seq` and `tcp_seq_flipped` are the latest TCP segments processed by the USM socket filter in each direction,
+// the flipped one being the direction whose tuple is reversed by `normalize_tuple`, see `has_sequence_seen_before`.
 typedef struct {
     protocol_stack_t stack;
+    __u32 unclassified_packets;
     __u64 updated;
+    tls_info_t tls_tags;
+    __u32 tcp_seq;
+    __u32 tcp_seq_flipped;
 } protocol_stack_wrapper_t;
 
 typedef enum {
@@ -144,7 +158,6 @@ typedef enum {
     PROG_HTTP2_HANDLE_FIRST_FRAME,
     PROG_HTTP2_FRAME_FILTER,
     PROG_HTTP2_HEADERS_PARSER,
-    PROG_HTTP2_DYNAMIC_TABLE_CLEANER,
     PROG_HTTP2_EOS_PARSER,
     PROG_KAFKA,
     PROG_KAFKA_RESPONSE_PARTITION_PARSER_V0,
@@ -154,6 +167,10 @@ typedef enum {
     PROG_GRPC,
     PROG_POSTGRES,
     PROG_POSTGRES_PROCESS_PARSE_MESSAGE,
+    PROG_REDIS,
+    PROG_AMQP,
+    PROG_MYSQL,
+    PROG_MONGO,
     // Add before this value.
     PROG_MAX,
 } protocol_prog_t;
@@ -165,7 +182,6 @@ typedef enum {
     TLS_HTTP2_FIRST_FRAME,
     TLS_HTTP2_FILTER,
     TLS_HTTP2_HEADERS_PARSER,
-    TLS_HTTP2_DYNAMIC_TABLE_CLEANER,
     TLS_HTTP2_EOS_PARSER,
     TLS_HTTP2_TERMINATION,
     TLS_KAFKA,
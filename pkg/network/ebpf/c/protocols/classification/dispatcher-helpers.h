@@ -9,14 +9,25 @@
 #include "protocols/classification/maps.h"
 #include "protocols/classification/structs.h"
 #include "protocols/classification/dispatcher-maps.h"
+#include "protocols/classification/signatures.h"
+#include "protocols/amqp/helpers.h"
+#include "protocols/amqp/usm-events.h"
+#include "protocols/cpu-cost.h"
 #include "protocols/http/classification-helpers.h"
 #include "protocols/http/usm-events.h"
 #include "protocols/http2/helpers.h"
 #include "protocols/http2/usm-events.h"
 #include "protocols/kafka/kafka-classification.h"
 #include "protocols/kafka/usm-events.h"
+#include "protocols/mongo/helpers.h"
+#include "protocols/mongo/usm-events.h"
+#include "protocols/mysql/helpers.h"
+#include "protocols/mysql/usm-events.h"
 #include "protocols/postgres/helpers.h"
 #include "protocols/postgres/usm-events.h"
+#include "protocols/redis/helpers.h"
+#include "protocols/redis/usm-events.h"
+#include "protocols/usm-filter.h"
 
 __maybe_unused static __always_inline protocol_prog_t protocol_to_program(protocol_t proto) {
     switch(proto) {
@@ -28,6 +39,14 @@ __maybe_unused static __always_inline protocol_prog_t protocol_to_program(protoc
         return PROG_KAFKA;
     case PROTOCOL_POSTGRES:
         return PROG_POSTGRES;
+    case PROTOCOL_REDIS:
+        return PROG_REDIS;
+    case PROTOCOL_AMQP:
+        return PROG_AMQP;
+    case PROTOCOL_MYSQL:
+        return PROG_MYSQL;
+    case PROTOCOL_MONGO:
+        return PROG_MONGO;
     default:
         if (proto != PROTOCOL_UNKNOWN) {
             log_debug("protocol doesn't have a matching program: %d", proto);
@@ -46,21 +65,22 @@ static __always_inline bool is_tcp_ack(skb_info_t *skb_info) {
 }
 
 // checks if we have seen that tcp packet before. It can happen if a packet travels multiple interfaces or retransmissions.
-static __always_inline bool has_sequence_seen_before(conn_tuple_t *tup, skb_info_t *skb_info) {
+// The latest segment of each direction is kept in the protocol stack wrapper of the connection, `flipped` telling
+// the direction of the packet apart.
+static __always_inline bool has_sequence_seen_before(protocol_stack_wrapper_t *wrapper, bool flipped, skb_info_t *skb_info) {
     if (!skb_info || !skb_info->tcp_seq) {
         return false;
     }
 
-    u32 *tcp_seq = bpf_map_lookup_elem(&connection_states, tup);
-
     // check if we've seen this TCP segment before. this can happen in the
     // context of localhost traffic where the same TCP segment can be seen
     // multiple times coming in and out from different interfaces
-    if (tcp_seq != NULL && *tcp_seq == skb_info->tcp_seq) {
+    __u32 *tcp_seq = flipped ? &wrapper->tcp_seq_flipped : &wrapper->tcp_seq;
+    if (*tcp_seq == skb_info->tcp_seq) {
         return true;
     }
 
-    bpf_map_update_elem(&connection_states, tup, &skb_info->tcp_seq, BPF_ANY);
+    *tcp_seq = skb_info->tcp_seq;
     return false;
 }
 
@@ -71,12 +91,21 @@ static __always_inline void classify_protocol_for_dispatcher(protocol_t *protoco
         return;
     }
 
-    if (is_http_monitoring_enabled() && is_http(buf, size)) {
+    const __u16 candidates = classification_candidates(buf);
+    if (candidates&CANDIDATE_HTTP && is_http_monitoring_enabled() && is_http(buf, size)) {
         *protocol = PROTOCOL_HTTP;
-    } else if (is_http2_monitoring_enabled() && is_http2(buf, size)) {
+    } else if (candidates&CANDIDATE_HTTP2 && is_http2_monitoring_enabled() && is_http2(buf, size)) {
         *protocol = PROTOCOL_HTTP2;
-    } else if (is_postgres_monitoring_enabled() && is_postgres(buf, size)) {
+    } else if (candidates&CANDIDATE_POSTGRES && is_postgres_monitoring_enabled() && is_postgres(buf, size)) {
         *protocol = PROTOCOL_POSTGRES;
+    } else if (candidates&CANDIDATE_REDIS && is_redis_monitoring_enabled() && is_redis(buf, size)) {
+        *protocol = PROTOCOL_REDIS;
+    } else if (candidates&CANDIDATE_AMQP && is_amqp_monitoring_enabled() && is_amqp(buf, size)) {
+        *protocol = PROTOCOL_AMQP;
+    } else if (candidates&CANDIDATE_MONGO && is_mongo_monitoring_enabled() && is_mongo(tup, buf, size)) {
+        *protocol = PROTOCOL_MONGO;
+    } else if (candidates&CANDIDATE_MYSQL && is_mysql_monitoring_enabled() && is_mysql(tup, buf, size)) {
+        *protocol = PROTOCOL_MYSQL;
     } else {
         *protocol = PROTOCOL_UNKNOWN;
     }
@@ -92,6 +121,28 @@ static __always_inline void dispatcher_delete_protocol_stack(conn_tuple_t *tuple
     }
 }
 
+// max_unclassified_packets returns the number of payload packets after which the socket filter stops trying to
+// classify a connection, 0 means it never gives up.
+static __always_inline __u32 max_unclassified_packets() {
+    __u64 val = 0;
+    LOAD_CONSTANT("max_unclassified_packets", val);
+    return (__u32)val;
+}
+
+// mark_unclassified_packet records a packet the socket filter failed to classify. Once `max_unclassified_packets`
+// packets were seen the connection is flagged as unclassifiable, so the following packets skip the classification.
+static __always_inline void mark_unclassified_packet(protocol_stack_wrapper_t *wrapper) {
+    const __u32 max_packets = max_unclassified_packets();
+    if (max_packets == 0) {
+        return;
+    }
+
+    wrapper->unclassified_packets++;
+    if (wrapper->unclassified_packets >= max_packets) {
+        set_protocol_flag(&wrapper->stack, FLAG_UNCLASSIFIABLE);
+    }
+}
+
 // A shared implementation for the runtime & prebuilt socket filter that classifies & dispatches the protocols of the connections.
 static __always_inline void protocol_dispatcher_entrypoint(struct __sk_buff *skb) {
     skb_info_t skb_info = {0};
@@ -102,27 +153,30 @@ static __always_inline void protocol_dispatcher_entrypoint(struct __sk_buff *skb
         return;
     }
 
+    // Traffic out of the scope of USM exits before any map is updated.
+    if (!is_usm_tuple_monitored(&skb_tup)) {
+        return;
+    }
+
     bool tcp_termination = is_tcp_termination(&skb_info);
     // We don't process non tcp packets, nor empty tcp packets which are not tcp termination packets.
     if (!is_tcp(&skb_tup) || (is_payload_empty(&skb_info) && !tcp_termination)) {
         return;
     }
 
-    // Making sure we've not processed the same tcp segment, which can happen when a single packet travels different
-    // interfaces.
-    if (has_sequence_seen_before(&skb_tup, &skb_info)) {
+    bool flipped = false;
+    protocol_stack_wrapper_t *wrapper = get_protocol_stack_wrapper_flipped(&skb_tup, &flipped);
+    if (!wrapper) {
+        // should never happen, but it is required by the eBPF verifier
         return;
     }
 
-    if (tcp_termination) {
-        bpf_map_delete_elem(&connection_states, &skb_tup);
-    }
-
-    protocol_stack_t *stack = get_protocol_stack(&skb_tup);
-    if (!stack) {
-        // should never happen, but it is required by the eBPF verifier
+    // Making sure we've not processed the same tcp segment, which can happen when a single packet travels different
+    // interfaces.
+    if (has_sequence_seen_before(wrapper, flipped, &skb_info)) {
         return;
     }
+    protocol_stack_t *stack = &wrapper->stack;
 
     // This is used to signal the tracer program that this protocol stack
     // is also shared with our USM program for the purposes of deletion.
@@ -138,6 +192,11 @@ static __always_inline void protocol_dispatcher_entrypoint(struct __sk_buff *skb
     }
 
     if (cur_fragment_protocol == PROTOCOL_UNKNOWN) {
+        if (stack->flags&FLAG_UNCLASSIFIABLE) {
+            // We gave up classifying this connection, see `mark_unclassified_packet`.
+            return;
+        }
+
         log_debug("[protocol_dispatcher_entrypoint]: %p was not classified", skb);
         char request_fragment[CLASSIFICATION_MAX_BUFFER];
         bpf_memset(request_fragment, 0, sizeof(request_fragment));
@@ -145,6 +204,11 @@ static __always_inline void protocol_dispatcher_entrypoint(struct __sk_buff *skb
         const size_t payload_length = skb_info.data_end - skb_info.data_off;
         const size_t final_fragment_size = payload_length < CLASSIFICATION_MAX_BUFFER ? payload_length : CLASSIFICATION_MAX_BUFFER;
         classify_protocol_for_dispatcher(&cur_fragment_protocol, &skb_tup, request_fragment, final_fragment_size);
+        if (cur_fragment_protocol == PROTOCOL_UNKNOWN && final_fragment_size > 0) {
+            // Counted before the Kafka tail call, which doesn't return. A Kafka connection classified by the
+            // last attempt is dispatched regardless of the flag, as its application layer is known.
+            mark_unclassified_packet(wrapper);
+        }
         if (is_kafka_monitoring_enabled() && cur_fragment_protocol == PROTOCOL_UNKNOWN) {
             bpf_tail_call_compat(skb, &dispatcher_classification_progs, DISPATCHER_KAFKA_PROG);
         }
@@ -168,6 +232,7 @@ static __always_inline void protocol_dispatcher_entrypoint(struct __sk_buff *skb
         bpf_memcpy(&args->skb_info, &skb_info, sizeof(skb_info_t));
 
         log_debug("dispatching to protocol number: %d", cur_fragment_protocol);
+        usm_cpu_cost_start(cur_fragment_protocol, false);
         bpf_tail_call_compat(skb, &protocols_progs, protocol_to_program(cur_fragment_protocol));
     }
 }
@@ -205,6 +270,7 @@ static __always_inline void dispatch_kafka(struct __sk_buff *skb) {
 
         // dispatch if possible
         log_debug("dispatching to protocol number: %d", cur_fragment_protocol);
+        usm_cpu_cost_start(cur_fragment_protocol, false);
         bpf_tail_call_compat(skb, &protocols_progs, protocol_to_program(cur_fragment_protocol));
     }
     return;
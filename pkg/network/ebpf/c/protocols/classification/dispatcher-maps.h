@@ -6,10 +6,6 @@
 #include "protocols/classification/defs.h"
 #include "protocols/classification/shared-tracer-maps.h"
 
-// Maps a connection tuple to latest tcp segment we've processed. Helps to detect same packets that travels multiple
-// interfaces or retransmissions.
-BPF_HASH_MAP(connection_states, conn_tuple_t, u32, 0)
-
 // Map used to store the sub program actually used by the socket filter.
 // This is done to avoid memory limitation when attaching a filter to
 // a socket.
@@ -0,0 +1,87 @@
+#ifndef __PROTOCOL_CLASSIFICATION_GC_H
+#define __PROTOCOL_CLASSIFICATION_GC_H
+
+#include "ktypes.h"
+#include "bpf_helpers.h"
+#include "map-defs.h"
+
+#include "protocols/classification/dispatcher-maps.h"
+#include "protocols/classification/shared-tracer-maps.h"
+
+// The classification garbage collector expires the entries of the connection_protocol map
+// which weren't updated for a while, as they leak whenever the termination of their connection is missed. It runs
+// from a bpf_timer (5.15+), armed by the first packet seen once the programs are attached, and replaces the userspace
+// map cleaner on the kernels supporting it.
+
+// struct bpf_timer is only defined by the uapi headers of the 5.15+ kernels
+#if defined(COMPILE_CORE) || !defined(LINUX_VERSION_CODE) || LINUX_VERSION_CODE < KERNEL_VERSION(5, 15, 0)
+struct bpf_timer {
+    __u64 :64;
+    __u64 :64;
+} __attribute__((aligned(8)));
+#endif
+
+#ifndef CLOCK_MONOTONIC
+#define CLOCK_MONOTONIC 1
+#endif
+
+typedef struct {
+    struct bpf_timer timer;
+    __u64 armed;
+} classification_gc_t;
+
+typedef struct {
+    __u64 now;
+    __u64 ttl;
+} classification_gc_ctx_t;
+
+BPF_ARRAY_MAP(classification_gc, classification_gc_t, 1)
+
+static __always_inline __u64 classification_gc_ttl() {
+    __u64 val = 0;
+    LOAD_CONSTANT("classification_gc_ttl_ns", val);
+    return val;
+}
+
+static __always_inline __u64 classification_gc_interval() {
+    __u64 val = 0;
+    LOAD_CONSTANT("classification_gc_interval_ns", val);
+    return val;
+}
+
+static long expire_connection_protocol(void *map, conn_tuple_t *tuple, protocol_stack_wrapper_t *wrapper, classification_gc_ctx_t *ctx) {
+    if (ctx->now - wrapper->updated > ctx->ttl) {
+        bpf_map_delete_elem(map, tuple);
+    }
+    return 0;
+}
+
+static int classification_gc_callback(void *map, __u32 *key, classification_gc_t *gc) {
+    classification_gc_ctx_t ctx = {
+        .now = bpf_ktime_get_ns(),
+        .ttl = classification_gc_ttl(),
+    };
+    bpf_for_each_map_elem(&connection_protocol, expire_connection_protocol, &ctx, 0);
+
+    bpf_timer_start(&gc->timer, classification_gc_interval(), 0);
+    return 0;
+}
+
+// Arms the timer of the garbage collector if it isn't yet. Racing CPUs are told apart by bpf_timer_init, which only
+// succeeds once.
+static __always_inline void classification_gc_arm() {
+    const __u32 zero = 0;
+    classification_gc_t *gc = bpf_map_lookup_elem(&classification_gc, &zero);
+    if (gc == NULL || gc->armed) {
+        return;
+    }
+
+    if (bpf_timer_init(&gc->timer, &classification_gc, CLOCK_MONOTONIC) != 0) {
+        return;
+    }
+    gc->armed = 1;
+    bpf_timer_set_callback(&gc->timer, classification_gc_callback);
+    bpf_timer_start(&gc->timer, classification_gc_interval(), 0);
+}
+
+#endif
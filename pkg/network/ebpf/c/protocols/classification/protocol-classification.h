@@ -24,6 +24,7 @@
 #include "protocols/redis/helpers.h"
 #include "protocols/postgres/helpers.h"
 #include "protocols/tls/tls.h"
+#include "protocols/tls/tls-handshake.h"
 
 // Some considerations about multiple protocol classification:
 //
@@ -89,11 +90,12 @@ static __always_inline void classify_grpc(usm_context_t *usm_ctx, protocol_stack
 }
 
 // Checks if a given buffer is http, http2, gRPC.
-static __always_inline protocol_t classify_applayer_protocols(const char *buf, __u32 size) {
-    if (is_http(buf, size)) {
+// `candidates` is the result of `classification_candidates` for the buffer.
+static __always_inline protocol_t classify_applayer_protocols(const char *buf, __u32 size, __u16 candidates) {
+    if (candidates&CANDIDATE_HTTP && is_http(buf, size)) {
         return PROTOCOL_HTTP;
     }
-    if (is_http2(buf, size)) {
+    if (candidates&CANDIDATE_HTTP2 && is_http2(buf, size)) {
         return PROTOCOL_HTTP2;
     }
 
@@ -101,20 +103,20 @@ static __always_inline protocol_t classify_applayer_protocols(const char *buf, _
 }
 
 // Checks if a given buffer is redis, mongo, postgres, or mysql.
-static __always_inline protocol_t classify_db_protocols(conn_tuple_t *tup, const char *buf, __u32 size) {
-    if (is_redis(buf, size)) {
+static __always_inline protocol_t classify_db_protocols(conn_tuple_t *tup, const char *buf, __u32 size, __u16 candidates) {
+    if (candidates&CANDIDATE_REDIS && is_redis(buf, size)) {
         return PROTOCOL_REDIS;
     }
 
-    if (is_mongo(tup, buf, size)) {
+    if (candidates&CANDIDATE_MONGO && is_mongo(tup, buf, size)) {
         return PROTOCOL_MONGO;
     }
 
-    if (is_postgres(buf, size)) {
+    if (candidates&CANDIDATE_POSTGRES && is_postgres(buf, size)) {
         return PROTOCOL_POSTGRES;
     }
 
-    if (is_mysql(tup, buf, size)) {
+    if (candidates&CANDIDATE_MYSQL && is_mysql(tup, buf, size)) {
         return PROTOCOL_MYSQL;
     }
 
@@ -122,8 +124,9 @@ static __always_inline protocol_t classify_db_protocols(conn_tuple_t *tup, const
 }
 
 // Checks if a given buffer is amqp, and soon - kafka..
-static __always_inline protocol_t classify_queue_protocols(struct __sk_buff *skb, skb_info_t *skb_info, const char *buf, __u32 size) {
-    if (is_amqp(buf, size)) {
+// Kafka has no signature, its classification depends on the api key and version of the request.
+static __always_inline protocol_t classify_queue_protocols(struct __sk_buff *skb, skb_info_t *skb_info, const char *buf, __u32 size, __u16 candidates) {
+    if (candidates&CANDIDATE_AMQP && is_amqp(buf, size)) {
         return PROTOCOL_AMQP;
     }
     if (is_kafka(skb, skb_info, buf, size)) {
@@ -153,22 +156,30 @@ __maybe_unused static __always_inline void protocol_classifier_entrypoint(struct
         return;
     }
 
-    protocol_stack_t *protocol_stack = get_protocol_stack(&usm_ctx->tuple);
-    if (!protocol_stack) {
+    protocol_stack_wrapper_t *wrapper = get_protocol_stack_wrapper(&usm_ctx->tuple);
+    if (!wrapper) {
         return;
     }
+    protocol_stack_t *protocol_stack = &wrapper->stack;
 
-    if (is_fully_classified(protocol_stack) || is_protocol_layer_known(protocol_stack, LAYER_ENCRYPTION)) {
+    if (is_fully_classified(protocol_stack)) {
+        return;
+    }
+
+    const char *buffer = &(usm_ctx->buffer.data[0]);
+    if (is_protocol_layer_known(protocol_stack, LAYER_ENCRYPTION)) {
+        // the ServerHello comes after the ClientHello the connection was classified with
+        tls_process_handshake(skb, &skb_info, buffer, usm_ctx->buffer.size, &wrapper->tls_tags);
         return;
     }
 
     // Load information that will be later on used to route tail-calls
     init_routing_cache(usm_ctx, protocol_stack);
 
-    const char *buffer = &(usm_ctx->buffer.data[0]);
     // TLS classification
     if (is_tls(buffer, usm_ctx->buffer.size, skb_info.data_end)) {
         update_protocol_information(usm_ctx, protocol_stack, PROTOCOL_TLS);
+        tls_process_handshake(skb, &skb_info, buffer, usm_ctx->buffer.size, &wrapper->tls_tags);
         // The connection is TLS encrypted, thus we cannot classify the protocol
         // using the socket filter and therefore we can bail out;
         return;
@@ -181,7 +192,7 @@ __maybe_unused static __always_inline void protocol_classifier_entrypoint(struct
     }
 
     if (app_layer_proto == PROTOCOL_UNKNOWN) {
-        app_layer_proto =  classify_applayer_protocols(buffer, usm_ctx->buffer.size);
+        app_layer_proto =  classify_applayer_protocols(buffer, usm_ctx->buffer.size, usm_ctx->candidates);
     }
 
     if (app_layer_proto != PROTOCOL_UNKNOWN) {
@@ -206,7 +217,7 @@ __maybe_unused static __always_inline void protocol_classifier_entrypoint_queues
         return;
     }
     const char *buffer = &(usm_ctx->buffer.data[0]);
-    protocol_t cur_fragment_protocol = classify_queue_protocols(skb, &usm_ctx->skb_info, buffer, usm_ctx->buffer.size);
+    protocol_t cur_fragment_protocol = classify_queue_protocols(skb, &usm_ctx->skb_info, buffer, usm_ctx->buffer.size, usm_ctx->candidates);
     if (!cur_fragment_protocol) {
         goto next_program;
     }
@@ -229,7 +240,7 @@ __maybe_unused static __always_inline void protocol_classifier_entrypoint_dbs(st
     }
 
     const char *buffer = &usm_ctx->buffer.data[0];
-    protocol_t cur_fragment_protocol = classify_db_protocols(&usm_ctx->tuple, buffer, usm_ctx->buffer.size);
+    protocol_t cur_fragment_protocol = classify_db_protocols(&usm_ctx->tuple, buffer, usm_ctx->buffer.size, usm_ctx->candidates);
     if (!cur_fragment_protocol) {
         goto next_program;
     }
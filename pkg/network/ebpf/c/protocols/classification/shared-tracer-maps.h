@@ -17,20 +17,36 @@ static __always_inline protocol_stack_t* __get_protocol_stack(conn_tuple_t* tupl
     return &wrapper->stack;
 }
 
-static __always_inline protocol_stack_t* get_protocol_stack(conn_tuple_t *skb_tup) {
+// get_protocol_stack_wrapper_flipped returns the `connection_protocol` entry of the tuple, creating it if needed.
+// `flipped` is set when the tuple is the reverse of the key of the entry.
+static __always_inline protocol_stack_wrapper_t* get_protocol_stack_wrapper_flipped(conn_tuple_t *skb_tup, bool *flipped) {
     conn_tuple_t normalized_tup = *skb_tup;
-    normalize_tuple(&normalized_tup);
+    *flipped = normalize_tuple(&normalized_tup);
     protocol_stack_wrapper_t* wrapper = bpf_map_lookup_elem(&connection_protocol, &normalized_tup);
     if (wrapper) {
         wrapper->updated = bpf_ktime_get_ns();
-        return &wrapper->stack;
+        return wrapper;
     }
 
     // this code path is executed once during the entire connection lifecycle
     protocol_stack_wrapper_t empty_wrapper = {0};
     empty_wrapper.updated = bpf_ktime_get_ns();
     bpf_map_update_with_telemetry(connection_protocol, &normalized_tup, &empty_wrapper, BPF_NOEXIST);
-    return __get_protocol_stack(&normalized_tup);
+    return bpf_map_lookup_elem(&connection_protocol, &normalized_tup);
+}
+
+// get_protocol_stack_wrapper returns the `connection_protocol` entry of the tuple, creating it if needed
+static __always_inline protocol_stack_wrapper_t* get_protocol_stack_wrapper(conn_tuple_t *skb_tup) {
+    bool flipped = false;
+    return get_protocol_stack_wrapper_flipped(skb_tup, &flipped);
+}
+
+static __always_inline protocol_stack_t* get_protocol_stack(conn_tuple_t *skb_tup) {
+    protocol_stack_wrapper_t* wrapper = get_protocol_stack_wrapper(skb_tup);
+    if (!wrapper) {
+        return NULL;
+    }
+    return &wrapper->stack;
 }
 
 __maybe_unused static __always_inline void update_protocol_stack(conn_tuple_t* skb_tup, protocol_t cur_fragment_protocol) {
@@ -0,0 +1,121 @@
+#ifndef __PROTOCOL_CLASSIFICATION_SIGNATURES_H
+#define __PROTOCOL_CLASSIFICATION_SIGNATURES_H
+
+#include "ktypes.h"
+
+#include "protocols/amqp/defs.h"
+#include "protocols/classification/defs.h"
+#include "protocols/http2/defs.h"
+#include "protocols/mongo/defs.h"
+#include "protocols/mysql/defs.h"
+#include "protocols/postgres/defs.h"
+
+// Signature matching is a cheap pre-filter of the protocol classification: the first
+// CLASSIFICATION_SIGNATURE_SIZE bytes of the buffer are loaded once into two 64-bit words,
+// which are compared against a set of (mask, value) signatures. Each signature is
+// associated to a protocol candidate bit, and only the helpers (`is_http`, `is_redis`, etc.)
+// of the candidates found are called afterwards.
+//
+// Signatures must be implied by their helper: if a helper classifies a buffer, one of the
+// signatures of its protocol must match the buffer. A signature matching a buffer the
+// helper rejects costs a helper call, a missing signature loses the classification.
+
+#define CLASSIFICATION_SIGNATURE_SIZE 16
+
+_Static_assert(CLASSIFICATION_SIGNATURE_SIZE <= CLASSIFICATION_MAX_BUFFER, "the signatures must fit in the classification buffer");
+
+#define CANDIDATE_HTTP     (1 << 0)
+#define CANDIDATE_HTTP2    (1 << 1)
+#define CANDIDATE_POSTGRES (1 << 2)
+#define CANDIDATE_REDIS    (1 << 3)
+#define CANDIDATE_MONGO    (1 << 4)
+#define CANDIDATE_MYSQL    (1 << 5)
+#define CANDIDATE_AMQP     (1 << 6)
+
+// The words are built byte by byte in little-endian order, whatever the host byte order,
+// so the byte at offset `i` of a word is `b << (i * 8)`.
+#define SIG_BYTE(b, i) ((__u64)(__u8)(b) << ((i) * 8))
+
+// Mask of the first `n` bytes of a word, 1 <= n <= 8
+#define SIG_PREFIX_MASK(n) ((n) == 8 ? ~0ULL : (1ULL << ((n) * 8)) - 1)
+
+#define SIG_STR4(a, b, c, d) (SIG_BYTE(a, 0) | SIG_BYTE(b, 1) | SIG_BYTE(c, 2) | SIG_BYTE(d, 3))
+#define SIG_STR5(a, b, c, d, e) (SIG_STR4(a, b, c, d) | SIG_BYTE(e, 4))
+#define SIG_STR6(a, b, c, d, e, f) (SIG_STR5(a, b, c, d, e) | SIG_BYTE(f, 5))
+#define SIG_STR7(a, b, c, d, e, f, g) (SIG_STR6(a, b, c, d, e, f) | SIG_BYTE(g, 6))
+#define SIG_STR8(a, b, c, d, e, f, g, h) (SIG_STR7(a, b, c, d, e, f, g) | SIG_BYTE(h, 7))
+
+// A little-endian 32-bit value at offset `i` of a word
+#define SIG_LE32(v, i) (SIG_BYTE((v), (i)) | SIG_BYTE((v) >> 8, (i) + 1) | SIG_BYTE((v) >> 16, (i) + 2) | SIG_BYTE((v) >> 24, (i) + 3))
+#define SIG_MASK32(i) SIG_LE32(0xffffffff, i)
+
+// SIGNATURE(word, mask, value, candidate)
+#define CLASSIFICATION_SIGNATURES(SIGNATURE)                                                                    \
+    /* is_http: a response or a request prefix */                                                               \
+    SIGNATURE(0, SIG_PREFIX_MASK(5), SIG_STR5('H', 'T', 'T', 'P', '/'), CANDIDATE_HTTP)                         \
+    SIGNATURE(0, SIG_PREFIX_MASK(5), SIG_STR5('G', 'E', 'T', ' ', '/'), CANDIDATE_HTTP)                         \
+    SIGNATURE(0, SIG_PREFIX_MASK(6), SIG_STR6('P', 'O', 'S', 'T', ' ', '/'), CANDIDATE_HTTP)                    \
+    SIGNATURE(0, SIG_PREFIX_MASK(5), SIG_STR5('P', 'U', 'T', ' ', '/'), CANDIDATE_HTTP)                         \
+    SIGNATURE(0, SIG_PREFIX_MASK(8), SIG_STR8('D', 'E', 'L', 'E', 'T', 'E', ' ', '/'), CANDIDATE_HTTP)          \
+    SIGNATURE(0, SIG_PREFIX_MASK(6), SIG_STR6('H', 'E', 'A', 'D', ' ', '/'), CANDIDATE_HTTP)                    \
+    SIGNATURE(0, SIG_PREFIX_MASK(8), SIG_STR8('O', 'P', 'T', 'I', 'O', 'N', 'S', ' '), CANDIDATE_HTTP)          \
+    SIGNATURE(0, SIG_PREFIX_MASK(7), SIG_STR7('P', 'A', 'T', 'C', 'H', ' ', '/'), CANDIDATE_HTTP)               \
+    SIGNATURE(0, SIG_PREFIX_MASK(7), SIG_STR7('T', 'R', 'A', 'C', 'E', ' ', '/'), CANDIDATE_HTTP)               \
+    /* is_http2: the connection preface or a settings frame */                                                  \
+    SIGNATURE(0, SIG_PREFIX_MASK(8), SIG_STR8('P', 'R', 'I', ' ', '*', ' ', 'H', 'T'), CANDIDATE_HTTP2)         \
+    SIGNATURE(0, SIG_BYTE(0xff, 3), SIG_BYTE(kSettingsFrame, 3), CANDIDATE_HTTP2)                               \
+    /* is_postgres: a query, a command complete or a startup message (big-endian version) */                    \
+    SIGNATURE(0, SIG_BYTE(0xff, 0), SIG_BYTE(POSTGRES_QUERY_MAGIC_BYTE, 0), CANDIDATE_POSTGRES)                 \
+    SIGNATURE(0, SIG_BYTE(0xff, 0), SIG_BYTE(POSTGRES_COMMAND_COMPLETE_MAGIC_BYTE, 0), CANDIDATE_POSTGRES)      \
+    SIGNATURE(0, SIG_MASK32(4), SIG_BYTE(PG_STARTUP_VERSION >> 16, 5), CANDIDATE_POSTGRES)                      \
+    /* is_redis: the RESP type prefix */                                                                        \
+    SIGNATURE(0, SIG_BYTE(0xff, 0), SIG_BYTE('+', 0), CANDIDATE_REDIS)                                          \
+    SIGNATURE(0, SIG_BYTE(0xff, 0), SIG_BYTE('-', 0), CANDIDATE_REDIS)                                          \
+    SIGNATURE(0, SIG_BYTE(0xff, 0), SIG_BYTE(':', 0), CANDIDATE_REDIS)                                          \
+    SIGNATURE(0, SIG_BYTE(0xff, 0), SIG_BYTE('$', 0), CANDIDATE_REDIS)                                          \
+    SIGNATURE(0, SIG_BYTE(0xff, 0), SIG_BYTE('*', 0), CANDIDATE_REDIS)                                          \
+    /* is_mongo: the op_code of the header, at offset 12 */                                                     \
+    SIGNATURE(1, SIG_MASK32(4), SIG_LE32(MONGO_OP_REPLY, 4), CANDIDATE_MONGO)                                   \
+    SIGNATURE(1, SIG_MASK32(4), SIG_LE32(MONGO_OP_UPDATE, 4), CANDIDATE_MONGO)                                  \
+    SIGNATURE(1, SIG_MASK32(4), SIG_LE32(MONGO_OP_INSERT, 4), CANDIDATE_MONGO)                                  \
+    SIGNATURE(1, SIG_MASK32(4), SIG_LE32(MONGO_OP_QUERY, 4), CANDIDATE_MONGO)                                   \
+    SIGNATURE(1, SIG_MASK32(4), SIG_LE32(MONGO_OP_GET_MORE, 4), CANDIDATE_MONGO)                                \
+    SIGNATURE(1, SIG_MASK32(4), SIG_LE32(MONGO_OP_DELETE, 4), CANDIDATE_MONGO)                                  \
+    SIGNATURE(1, SIG_MASK32(4), SIG_LE32(MONGO_OP_COMPRESSED, 4), CANDIDATE_MONGO)                              \
+    SIGNATURE(1, SIG_MASK32(4), SIG_LE32(MONGO_OP_MSG, 4), CANDIDATE_MONGO)                                     \
+    /* is_mysql: the command type of the header, at offset 4 */                                                 \
+    SIGNATURE(0, SIG_BYTE(0xff, 4), SIG_BYTE(MYSQL_COMMAND_QUERY, 4), CANDIDATE_MYSQL)                          \
+    SIGNATURE(0, SIG_BYTE(0xff, 4), SIG_BYTE(MYSQL_PREPARE_QUERY, 4), CANDIDATE_MYSQL)                          \
+    SIGNATURE(0, SIG_BYTE(0xff, 4), SIG_BYTE(MYSQL_SERVER_GREETING_V10, 4), CANDIDATE_MYSQL)                    \
+    SIGNATURE(0, SIG_BYTE(0xff, 4), SIG_BYTE(MYSQL_SERVER_GREETING_V9, 4), CANDIDATE_MYSQL)                     \
+    /* is_amqp: the protocol header or a method frame */                                                        \
+    SIGNATURE(0, SIG_PREFIX_MASK(4), SIG_STR4('A', 'M', 'Q', 'P'), CANDIDATE_AMQP)                              \
+    SIGNATURE(0, SIG_BYTE(0xff, 0), SIG_BYTE(AMQP_FRAME_METHOD_TYPE, 0), CANDIDATE_AMQP)
+
+#define __CLASSIFICATION_SIGNATURE_MATCH(word, mask, value, candidate)                                          \
+    if ((words[word] & (mask)) == (value)) {                                                                    \
+        candidates |= (candidate);                                                                              \
+    }
+
+// classification_candidates returns the mask of the protocols whose signatures match the buffer.
+// The buffer must be at least CLASSIFICATION_SIGNATURE_SIZE bytes long. Like the helpers, the
+// signatures don't look at the size of the payload, which they check themselves.
+static __always_inline __u16 classification_candidates(const char *buf) {
+    if (buf == NULL) {
+        return 0;
+    }
+
+    // The words are built from single byte loads, as the buffer may not be aligned and
+    // misaligned stack accesses are rejected by the verifier.
+    __u64 words[2] = {0};
+#pragma unroll (CLASSIFICATION_SIGNATURE_SIZE)
+    for (int i = 0; i < CLASSIFICATION_SIGNATURE_SIZE; i++) {
+        words[i / 8] |= SIG_BYTE(buf[i], i % 8);
+    }
+
+    __u16 candidates = 0;
+    CLASSIFICATION_SIGNATURES(__CLASSIFICATION_SIGNATURE_MATCH)
+    return candidates;
+}
+
+#endif
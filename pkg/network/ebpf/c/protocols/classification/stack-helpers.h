@@ -144,6 +144,23 @@ static __always_inline void merge_protocol_stacks(protocol_stack_t *this, protoc
     this->flags |= that->flags;
 }
 
+// merge_tls_tags modifies `this` by merging it with `that`
+static __always_inline void merge_tls_tags(tls_info_t *this, tls_info_t *that) {
+    if (!this || !that) {
+        return;
+    }
+
+    if (!this->chosen_version) {
+        this->chosen_version = that->chosen_version;
+    }
+    if (!this->cipher_suite) {
+        this->cipher_suite = that->cipher_suite;
+    }
+    this->offered_versions |= that->offered_versions;
+    this->alpn_requested |= that->alpn_requested;
+    this->alpn_chosen |= that->alpn_chosen;
+}
+
 static __always_inline void set_protocol_flag(protocol_stack_t *stack, u8 flag) {
     if (!stack) {
         return;
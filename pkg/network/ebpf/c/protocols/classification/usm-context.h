@@ -5,6 +5,7 @@
 #include "protocols/classification/common.h"
 #include "protocols/classification/defs.h"
 #include "protocols/classification/maps.h"
+#include "protocols/classification/signatures.h"
 #include "protocols/classification/stack-helpers.h"
 
 // from uapi/linux/if_packet.h
@@ -20,6 +21,8 @@ typedef struct {
     conn_tuple_t tuple;
     skb_info_t  skb_info;
     classification_buffer_t buffer;
+    // bit mask of the protocols whose signatures match the buffer, see `classification_candidates`
+    u16 candidates;
     // bit mask with layers that should be skiped
     u16 routing_skip_layers;
     classification_prog_t routing_current_program;
@@ -74,6 +77,7 @@ static __always_inline usm_context_t* usm_context_init(struct __sk_buff *skb, co
     usm_context->tuple = *tuple;
     usm_context->skb_info = *skb_info;
     __init_buffer(skb, skb_info, &usm_context->buffer);
+    usm_context->candidates = classification_candidates(usm_context->buffer.data);
     return usm_context;
 }
 
@@ -0,0 +1,92 @@
+#ifndef __USM_CPU_COST_H
+#define __USM_CPU_COST_H
+
+#include "ktypes.h"
+#include "bpf_helpers.h"
+#include "map-defs.h"
+
+#include "protocols/classification/defs.h"
+
+// The CPU cost telemetry measures the time spent by the protocol decoders on each packet or TLS payload, from the
+// tail call of the dispatcher to the return of the last program of the decoder, and counts it in log2 histograms.
+
+// Number of histograms per encryption, indexed by the number of the protocol within the application layer.
+#define USM_CPU_COST_PROTOCOLS 16
+// Bucket i counts the durations in [2^i, 2^(i+1)) nanoseconds, the last bucket counting all the longer ones.
+#define USM_CPU_COST_BUCKETS 24
+
+typedef struct {
+    __u64 buckets[USM_CPU_COST_BUCKETS];
+} usm_cpu_cost_histogram_t;
+
+// The decoder being measured on the current CPU.
+typedef struct {
+    __u64 start;
+    __u32 index;
+} usm_cpu_cost_start_t;
+
+// The histograms of the plaintext decoders, followed by the ones of the TLS decoders.
+BPF_PERCPU_ARRAY_MAP(usm_cpu_cost, usm_cpu_cost_histogram_t, 2 * USM_CPU_COST_PROTOCOLS)
+
+BPF_PERCPU_ARRAY_MAP(usm_cpu_cost_start, usm_cpu_cost_start_t, 1)
+
+static __always_inline bool is_usm_cpu_cost_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("usm_cpu_cost_enabled", val);
+    return val > 0;
+}
+
+// Starts measuring the decoder of the given protocol, right before the tail call into it.
+static __always_inline void usm_cpu_cost_start(protocol_t protocol, bool is_tls) {
+    if (!is_usm_cpu_cost_enabled()) {
+        return;
+    }
+
+    const __u32 zero = 0;
+    usm_cpu_cost_start_t *current = bpf_map_lookup_elem(&usm_cpu_cost_start, &zero);
+    if (current == NULL) {
+        return;
+    }
+    current->index = (protocol & (USM_CPU_COST_PROTOCOLS - 1)) + (is_tls ? USM_CPU_COST_PROTOCOLS : 0);
+    current->start = bpf_ktime_get_ns();
+}
+
+static __always_inline __u32 usm_cpu_cost_bucket(__u64 duration) {
+    __u32 bucket = 0;
+#pragma unroll
+    for (int shift = 16; shift > 0; shift /= 2) {
+        if (duration >= (1ULL << shift)) {
+            duration >>= shift;
+            bucket += shift;
+        }
+    }
+    return bucket < USM_CPU_COST_BUCKETS ? bucket : USM_CPU_COST_BUCKETS - 1;
+}
+
+// Ends the measure started by the dispatcher, if any. Called by the programs of the decoders when they return, as
+// the ones ending in a tail call don't.
+static __always_inline void usm_cpu_cost_end() {
+    if (!is_usm_cpu_cost_enabled()) {
+        return;
+    }
+
+    const __u32 zero = 0;
+    usm_cpu_cost_start_t *current = bpf_map_lookup_elem(&usm_cpu_cost_start, &zero);
+    if (current == NULL || current->start == 0) {
+        return;
+    }
+    const __u64 duration = bpf_ktime_get_ns() - current->start;
+    const __u32 index = current->index;
+    current->start = 0;
+
+    usm_cpu_cost_histogram_t *histogram = bpf_map_lookup_elem(&usm_cpu_cost, &index);
+    if (histogram == NULL) {
+        return;
+    }
+    const __u32 bucket = usm_cpu_cost_bucket(duration);
+    if (bucket < USM_CPU_COST_BUCKETS) {
+        histogram->buckets[bucket]++;
+    }
+}
+
+#endif
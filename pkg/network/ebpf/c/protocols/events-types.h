@@ -4,7 +4,18 @@
 #include "ktypes.h"
 
 #define BATCH_BUFFER_SIZE (4*1024)
+// default number of batch pages per CPU. The number of pages of each protocol can be set at load time with the
+// <name>_batch_pages constant, up to BATCH_MAX_PAGES_PER_CPU, while a flush sends at most BATCH_PAGES_PER_CPU batches
 #define BATCH_PAGES_PER_CPU 8
+#define BATCH_MAX_PAGES_PER_CPU 64
+
+// layouts of the events in batch_data_t->data:
+// * with the row layout, the events are stored back to back;
+// * with the columnar layout, each event is split at head_size bytes: the heads of the events are stored back to back,
+//   followed by their tails, starting at cap*head_size. This lets userspace walk the fixed fields of the events
+//   without loading their trailing buffers.
+#define USM_EVENTS_LAYOUT_ROW 0
+#define USM_EVENTS_LAYOUT_COLUMNAR 1
 
 typedef struct {
     // idx is a monotonic counter used for uniquely determining a batch within a CPU core
@@ -16,12 +27,17 @@ typedef struct {
     // * if idx_to_flush < idx, the batch at idx_to_flush needs to be sent to userspace;
     // (note that idx will never be less than idx_to_flush);
     __u64 idx_to_flush;
+    // the following fields are only used when the events are written directly to the ring buffer:
+    // * last_wakeup is the last time the CPU woke up the consumer of the ring buffer;
+    // * dropped_events counts the events dropped since the last record of the CPU, which reports them;
+    __u64 last_wakeup;
+    __u32 dropped_events;
 } batch_state_t;
 
 // this struct is used in the map lookup that returns the active batch for a certain CPU core
 typedef struct {
     __u16 cpu;
-    // page_num can be obtained from (batch_state_t->idx % BATCHES_PER_CPU)
+    // page_num can be obtained from (batch_state_t->idx % <name>_batch_pages)
     __u16 page_num;
 } batch_key_t;
 
@@ -33,6 +49,16 @@ typedef struct {
     __u16 event_size;
     __u32 dropped_events;
     __u32 failed_flushes;
+    // one of the USM_EVENTS_LAYOUT_* values, used by userspace to check it decodes the events the way they were
+    // written
+    __u16 layout;
+    // size of the head of the events with the columnar layout, 0 with the row layout
+    __u16 head_size;
+    // keeps the events 8 bytes aligned
+    __u32 reserved;
+    // bpf_ktime_get_ns() of the first event of the batch, used by userspace to measure how long the events waited
+    // before being read
+    __u64 ktime;
     char data[BATCH_BUFFER_SIZE];
 } batch_data_t;
 
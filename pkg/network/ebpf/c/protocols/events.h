@@ -1,18 +1,41 @@
 #ifndef __USM_EVENTS_H
 #define __USM_EVENTS_H
 
+#include "ring_buffer.h"
+
 #include "protocols/events-types.h"
 #define _STR(x) #x
 
+// records written directly to the ring buffer only hold a batch header followed by their events
+#define BATCH_HEADER_SIZE __builtin_offsetof(batch_data_t, data)
+
 /* USM_EVENTS_INIT defines two functions used for the purposes of buffering and sending
    data to userspace:
    1) <name>_batch_enqueue
    2) <name>_batch_flush
+   When the events are written directly to the ring buffer, <name>_batch_enqueue
+   reserves a record holding the event in the ring buffer, and <name>_batch_flush
+   only wakes up the consumer of the events that are still waiting in it.
+   USM_EVENTS_INIT stores the events with the row layout, and USM_EVENTS_INIT_COLUMNAR
+   with the columnar layout, their head ending at the given field of the event.
    For more information of this please refer to
    pkg/networks/protocols/events/README.md */
 #define USM_EVENTS_INIT(name, value, batch_size)                                                        \
+    __USM_EVENTS_INIT(name, value, batch_size, 0)
+
+#define USM_EVENTS_INIT_COLUMNAR(name, value, batch_size, tail_field)                                   \
+    __USM_EVENTS_INIT(name, value, batch_size, __builtin_offsetof(value, tail_field))
+
+#define __USM_EVENTS_INIT(name, value, batch_size, event_head_size)                                     \
     _Static_assert((sizeof(value)*batch_size) <= BATCH_BUFFER_SIZE,                                     \
                    _STR(name)" batch is too large");                                                    \
+    _Static_assert(event_head_size < sizeof(value), _STR(name)" event head is too large");              \
+    /* the events are copied with 8-byte moves, see bpf_memcpy_u64 */                                   \
+    _Static_assert((sizeof(value) % 8) == 0, _STR(name)" event size must be a multiple of 8");          \
+                                                                                                        \
+    static __always_inline __u16 name##_batch_layout() {                                                \
+        return event_head_size > 0 ? USM_EVENTS_LAYOUT_COLUMNAR : USM_EVENTS_LAYOUT_ROW;                \
+    }                                                                                                   \
                                                                                                         \
     BPF_PERCPU_ARRAY_MAP(name##_batch_state, batch_state_t, 1)                                          \
     BPF_PERF_EVENT_ARRAY_MAP(name##_batch_events, __u32)                                                \
@@ -22,12 +45,84 @@
         return batch && batch->len == batch_size;                                                       \
     }                                                                                                   \
                                                                                                         \
+    static __always_inline u64 name##_batch_pages() {                                                   \
+        __u64 val = 0;                                                                                  \
+        LOAD_CONSTANT(_STR(name##_batch_pages), val);                                                   \
+        if (val == 0 || val > BATCH_MAX_PAGES_PER_CPU) {                                                \
+            return BATCH_PAGES_PER_CPU;                                                                 \
+        }                                                                                               \
+        return val;                                                                                     \
+    }                                                                                                   \
+                                                                                                        \
     static __always_inline bool is_##name##_monitoring_enabled() {                                      \
         __u64 val = 0;                                                                                  \
         LOAD_CONSTANT(_STR(name##_monitoring_enabled), val);                                            \
         return val > 0;                                                                                 \
     }                                                                                                   \
                                                                                                         \
+    /* writes the event in a record reserved in the ring buffer, without going through a batch */       \
+    static __always_inline void name##_ring_buffer_enqueue(batch_state_t *batch_state, value *event) {  \
+        batch_data_t *record = bpf_ringbuf_reserve(&name##_batch_events,                                \
+                                                   BATCH_HEADER_SIZE + sizeof(value), 0);               \
+        if (record == NULL) {                                                                           \
+            batch_state->dropped_events++;                                                              \
+            _LOG(name, "enqueue error: cpu: %d dropping event because the ring buffer is full.",        \
+                 bpf_get_smp_processor_id());                                                           \
+            return;                                                                                     \
+        }                                                                                               \
+                                                                                                        \
+        record->idx = 0;                                                                                \
+        record->cpu = bpf_get_smp_processor_id();                                                       \
+        record->len = 1;                                                                                \
+        record->cap = 1;                                                                                \
+        record->event_size = sizeof(value);                                                             \
+        record->dropped_events = batch_state->dropped_events;                                           \
+        record->failed_flushes = 0;                                                                     \
+        /* with a single event, both layouts store it as it is */                                       \
+        record->layout = name##_batch_layout();                                                         \
+        record->head_size = event_head_size;                                                            \
+        record->reserved = 0;                                                                           \
+        record->ktime = bpf_ktime_get_ns();                                                             \
+        bpf_memcpy_u64(record->data, event, sizeof(value));                                             \
+        batch_state->dropped_events = 0;                                                                \
+                                                                                                        \
+        /* the consumer is woken up once a batch worth of events is available */                        \
+        bpf_ringbuf_submit(record, ring_buffer_wakeup_flags(&name##_batch_events, BATCH_BUFFER_SIZE,    \
+                                                            &batch_state->last_wakeup));                \
+    }                                                                                                   \
+                                                                                                        \
+    /* wakes up the consumer of the events waiting in the ring buffer below the wakeup watermark
+       with a record without events, which also reports the dropped events */                           \
+    static __always_inline void name##_ring_buffer_wakeup(batch_state_t *batch_state) {                 \
+        if (bpf_ringbuf_query(&name##_batch_events, RB_AVAIL_DATA) == 0 &&                              \
+            batch_state->dropped_events == 0) {                                                         \
+            return;                                                                                     \
+        }                                                                                               \
+        u64 now = bpf_ktime_get_ns();                                                                   \
+        if (now - batch_state->last_wakeup < RING_BUFFER_WAKEUP_INTERVAL_NS) {                          \
+            return;                                                                                     \
+        }                                                                                               \
+                                                                                                        \
+        batch_data_t *record = bpf_ringbuf_reserve(&name##_batch_events, BATCH_HEADER_SIZE, 0);         \
+        if (record == NULL) {                                                                           \
+            return;                                                                                     \
+        }                                                                                               \
+        record->idx = 0;                                                                                \
+        record->cpu = bpf_get_smp_processor_id();                                                       \
+        record->len = 0;                                                                                \
+        record->cap = 0;                                                                                \
+        record->event_size = sizeof(value);                                                             \
+        record->dropped_events = batch_state->dropped_events;                                           \
+        record->failed_flushes = 0;                                                                     \
+        record->layout = name##_batch_layout();                                                         \
+        record->head_size = event_head_size;                                                            \
+        record->reserved = 0;                                                                           \
+        record->ktime = now;                                                                            \
+        batch_state->dropped_events = 0;                                                                \
+        batch_state->last_wakeup = now;                                                                 \
+        bpf_ringbuf_submit(record, RB_FORCE_WAKEUP);                                                    \
+    }                                                                                                   \
+                                                                                                        \
     static __always_inline void name##_batch_flush(struct pt_regs *ctx) {                               \
         if (!is_##name##_monitoring_enabled()) {                                                        \
             return;                                                                                     \
@@ -39,6 +134,11 @@
             return;                                                                                     \
         }                                                                                               \
                                                                                                         \
+        if (is_direct_ring_buffer_enabled()) {                                                          \
+            name##_ring_buffer_wakeup(batch_state);                                                     \
+            return;                                                                                     \
+        }                                                                                               \
+                                                                                                        \
         u64 use_ring_buffer;                                                                            \
         LOAD_CONSTANT("use_ring_buffer", use_ring_buffer);                                              \
         long perf_ret;                                                                                  \
@@ -47,7 +147,7 @@
             for (int i = 0; i < BATCH_PAGES_PER_CPU; i++) {                                             \
                 if (batch_state->idx_to_flush == batch_state->idx) return;                              \
                                                                                                         \
-                batch_key_t key = get_batch_key(batch_state->idx_to_flush);                             \
+                batch_key_t key = get_batch_key(batch_state->idx_to_flush, name##_batch_pages());       \
                 batch_data_t *batch = bpf_map_lookup_elem(&name##_batches, &key);                       \
                 if (!batch) {                                                                           \
                     return;                                                                             \
@@ -84,14 +184,19 @@
             return;                                                                                     \
         }                                                                                               \
                                                                                                         \
-        batch_key_t key = get_batch_key(batch_state->idx);                                              \
+        if (is_direct_ring_buffer_enabled()) {                                                          \
+            name##_ring_buffer_enqueue(batch_state, event);                                             \
+            return;                                                                                     \
+        }                                                                                               \
+                                                                                                        \
+        batch_key_t key = get_batch_key(batch_state->idx, name##_batch_pages());                        \
         batch_data_t *batch = bpf_map_lookup_elem(&name##_batches, &key);                               \
         if (batch == NULL) {                                                                            \
             return;                                                                                     \
         }                                                                                               \
                                                                                                         \
         /* if this happens it indicates that <protocol>_batch_flush is not
-        executing often enough and/or that BATCH_PAGES_PER_CPU is not large
+        executing often enough and/or that <name>_batch_pages is not large
         enough */                                                                                       \
         if (name##_batch_full(batch)) {                                                                 \
             batch->dropped_events++;                                                                    \
@@ -102,13 +207,18 @@
                                                                                                         \
         /* this will copy the given event into an eBPF map entry representing the
            current active batch */                                                                      \
-        if (!__enqueue_event((void *)batch, event, sizeof(value))) {                                    \
+        if (!__enqueue_event((void *)batch, event, sizeof(value), event_head_size, batch_size)) {       \
             return;                                                                                     \
         }                                                                                               \
         /* annotate batch with metadata used by userspace */                                            \
         batch->cap = batch_size;                                                                        \
         batch->event_size = sizeof(value);                                                              \
+        batch->layout = name##_batch_layout();                                                          \
+        batch->head_size = event_head_size;                                                             \
         batch->idx = batch_state->idx;                                                                  \
+        if (batch->len == 1) {                                                                          \
+            batch->ktime = bpf_ktime_get_ns();                                                          \
+        }                                                                                               \
                                                                                                         \
         _LOG(name, "event enqueued: cpu: %d batch_idx: %llu len: %d",                                   \
              key.cpu, batch_state->idx, batch->len);                                                    \
@@ -120,21 +230,44 @@
         }                                                                                               \
     }                                                                                                   \
 
-static __always_inline batch_key_t get_batch_key(u64 batch_idx) {
+static __always_inline bool is_direct_ring_buffer_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("use_direct_ring_buffer", val);
+    return val > 0;
+}
+
+static __always_inline batch_key_t get_batch_key(u64 batch_idx, u64 batch_pages) {
     batch_key_t key = { 0 };
     key.cpu = bpf_get_smp_processor_id();
-    key.page_num = batch_idx % BATCH_PAGES_PER_CPU;
+    key.page_num = batch_idx % batch_pages;
     return key;
 }
 
-static __always_inline bool __enqueue_event(batch_data_t *batch, void *event, size_t event_size) {
-    /* bounds check to make eBPF verifier happy */
-    u32 offset = batch->len*event_size;
-    if (offset < 0 || offset+event_size>sizeof(batch->data)) {
+static __always_inline bool __enqueue_event(batch_data_t *batch, void *event, size_t event_size, size_t head_size, size_t batch_size) {
+    if (head_size == 0) {
+        /* bounds check to make eBPF verifier happy */
+        u32 offset = batch->len*event_size;
+        if (offset < 0 || offset+event_size>sizeof(batch->data)) {
+            return false;
+        }
+
+        // the event size is a multiple of 8, see __USM_EVENTS_INIT
+        __bpf_memcpy_u64(&batch->data[offset], event, event_size);
+        batch->len++;
+        return true;
+    }
+
+    /* with the columnar layout, the head goes after the heads of the previous events and the tail after their tails,
+       the tails starting at the end of the heads of a full batch */
+    const size_t tail_size = event_size - head_size;
+    u32 head_offset = batch->len*head_size;
+    u32 tail_offset = batch_size*head_size + batch->len*tail_size;
+    if (head_offset+head_size>sizeof(batch->data) || tail_offset+tail_size>sizeof(batch->data)) {
         return false;
     }
 
-    bpf_memcpy(&batch->data[offset], event, event_size);
+    bpf_memcpy(&batch->data[head_offset], event, head_size);
+    bpf_memcpy(&batch->data[tail_offset], (char *)event + head_size, tail_size);
     batch->len++;
     return true;
 }
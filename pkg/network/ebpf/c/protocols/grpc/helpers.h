@@ -6,7 +6,7 @@
 #include "protocols/http2/decoding-defs.h"
 #include "protocols/http2/defs.h"
 #include "protocols/http2/helpers.h"
-#include "protocols/http2/skb-common.h"
+#include "protocols/http2/pktbuf-common.h"
 #include "protocols/grpc/defs.h"
 
 // Number of frames to filter in a single packet, while looking for the first headers frame.
@@ -61,7 +61,8 @@ static __always_inline grpc_status_t scan_headers(struct __sk_buff *skb, skb_inf
     // Check that frame_end does not go beyond the skb
     frame_end = frame_end < skb->len + 1 ? frame_end : skb->len + 1;
 
-    handle_dynamic_table_update(skb, skb_info);
+    pktbuf_window_t window = {};
+    handle_dynamic_table_update(pktbuf_from_skb(skb, skb_info), &window);
 
 #pragma unroll(GRPC_MAX_HEADERS_TO_PROCESS)
     for (__u8 i = 0; i < GRPC_MAX_HEADERS_TO_PROCESS; ++i) {
@@ -69,7 +70,9 @@ static __always_inline grpc_status_t scan_headers(struct __sk_buff *skb, skb_inf
             break;
         }
 
-        bpf_skb_load_bytes(skb, skb_info->data_off, &current_ch, sizeof(current_ch));
+        if (!pktbuf_window_load_byte(pktbuf_from_skb(skb, skb_info), &window, skb_info->data_off, &current_ch)) {
+            break;
+        }
         skb_info->data_off++;
 
         if ((current_ch & 128) != 0) {
@@ -81,7 +84,7 @@ static __always_inline grpc_status_t scan_headers(struct __sk_buff *skb, skb_inf
         // if it is literal header with indexing, the max bits are 6, for the other two, the max bits are 4.
         max_bits = (current_ch & 192) == 64 ? MAX_6_BITS : MAX_4_BITS;
         index = 0;
-        if (!read_hpack_int_with_given_current_char(skb, skb_info, current_ch, max_bits, &index)) {
+        if (!read_hpack_int_with_given_current_char(pktbuf_from_skb(skb, skb_info), &window, current_ch, max_bits, &index)) {
             break;
         }
 
@@ -90,7 +93,7 @@ static __always_inline grpc_status_t scan_headers(struct __sk_buff *skb, skb_inf
             break;
         }
 
-        if (!process_and_skip_literal_headers(skb, skb_info, index)){
+        if (!process_and_skip_literal_headers(pktbuf_from_skb(skb, skb_info), &window, index)){
             break;
         }
     }
@@ -115,7 +118,7 @@ static __always_inline grpc_status_t is_grpc(struct __sk_buff *skb, const skb_in
 
     // Check if the skb starts with the HTTP2 magic, advance the info->data_off
     // to the first byte after it if the magic is present.
-    skip_preface(skb, &info);
+    skip_preface(pktbuf_from_skb(skb, &info));
 
     // Loop through the HTTP2 frames in the packet
 #pragma unroll(GRPC_MAX_FRAMES_TO_FILTER)
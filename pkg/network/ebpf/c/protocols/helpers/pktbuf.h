@@ -41,6 +41,20 @@ static __always_inline __maybe_unused void pktbuf_advance(pktbuf_t pkt, u32 offs
     pktbuf_invalid_operation();
 }
 
+static __always_inline __maybe_unused void pktbuf_set_offset(pktbuf_t pkt, u32 offset)
+{
+    switch (pkt.type) {
+    case PKTBUF_SKB:
+        pkt.skb_info->data_off = offset;
+        return;
+    case PKTBUF_TLS:
+        pkt.tls->data_off = offset;
+        return;
+    }
+
+    pktbuf_invalid_operation();
+}
+
 static __always_inline __maybe_unused u32 pktbuf_data_offset(pktbuf_t pkt)
 {
     switch (pkt.type) {
@@ -93,6 +107,43 @@ static __always_inline __maybe_unused long pktbuf_load_bytes(pktbuf_t pkt, u32 o
     return 0;
 }
 
+// A block of the packet cached on the stack, for the decoders walking the packet byte by byte: they load a block of
+// PKTBUF_WINDOW_SIZE bytes once, instead of calling a helper for each byte.
+#define PKTBUF_WINDOW_SIZE BLK_SIZE
+
+typedef struct {
+    u32 start;
+    u32 len;
+    u8 buf[PKTBUF_WINDOW_SIZE];
+} pktbuf_window_t;
+
+// Reads the byte at `offset` of the packet into `out`, loading the block starting at `offset` if the byte is out of
+// the window. Returns false if `offset` is out of the packet or the load failed.
+static __always_inline __maybe_unused bool pktbuf_window_load_byte(pktbuf_t pkt, pktbuf_window_t *window, u32 offset, u8 *out)
+{
+    u32 index = offset - window->start;
+    if (offset < window->start || index >= window->len) {
+        const u32 data_end = pktbuf_data_end(pkt);
+        if (offset >= data_end) {
+            return false;
+        }
+        u32 len = data_end - offset;
+        if (len > PKTBUF_WINDOW_SIZE) {
+            len = PKTBUF_WINDOW_SIZE;
+        }
+        if (pktbuf_load_bytes(pkt, offset, window->buf, len) < 0) {
+            window->len = 0;
+            return false;
+        }
+        window->start = offset;
+        window->len = len;
+        index = 0;
+    }
+
+    *out = window->buf[index & (PKTBUF_WINDOW_SIZE - 1)];
+    return true;
+}
+
 static __always_inline pktbuf_t pktbuf_from_skb(struct __sk_buff* skb, skb_info_t *skb_info)
 {
     return (pktbuf_t) {
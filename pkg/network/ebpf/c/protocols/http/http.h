@@ -7,6 +7,7 @@
 #include "protocols/sockfd.h"
 
 #include "protocols/classification/common.h"
+#include "protocols/cpu-cost.h"
 
 #include "protocols/http/types.h"
 #include "protocols/http/maps.h"
@@ -17,12 +18,52 @@ static __always_inline int http_responding(http_transaction_t *http) {
     return (http != NULL && http->response_status_code != 0);
 }
 
+static __always_inline bool is_http_path_only_capture() {
+    __u64 val = 0;
+    LOAD_CONSTANT("http_path_only_capture", val);
+    return val > 0;
+}
+
+static __always_inline __u64 http_max_path_length() {
+    __u64 val = 0;
+    LOAD_CONSTANT("http_max_path_length", val);
+    return val;
+}
+
+// http_trim_request_fragment clears the bytes of the fragment following its path when the path-only capture is
+// enabled: the byte ending the path is kept, so that userspace knows the path is complete, and the path is
+// truncated to `http_max_path_length` bytes. The method is already held by `request_method`.
+static __always_inline void http_trim_request_fragment(char *fragment) {
+    if (!is_http_path_only_capture()) {
+        return;
+    }
+
+    const __u64 max_path_length = http_max_path_length();
+    __u64 path_length = 0;
+    bool in_path = false;
+    bool done = false;
+#pragma unroll (HTTP_BUFFER_SIZE)
+    for (int i = 0; i < HTTP_BUFFER_SIZE; i++) {
+        if (done) {
+            fragment[i] = 0;
+        } else if (!in_path) {
+            in_path = fragment[i] == ' ';
+        } else if (fragment[i] == ' ' || fragment[i] == '?' || fragment[i] == '\r') {
+            done = true;
+        } else if (path_length++ >= max_path_length) {
+            fragment[i] = 0;
+            done = true;
+        }
+    }
+}
+
 static __always_inline void http_begin_request(http_transaction_t *http, http_method_t method, char *buffer) {
     http->request_method = method;
     http->request_started = bpf_ktime_get_ns();
     http->response_last_seen = 0;
     http->response_status_code = 0;
     bpf_memcpy(&http->request_fragment, buffer, HTTP_BUFFER_SIZE);
+    http_trim_request_fragment(http->request_fragment);
     log_debug("http_begin_request: htx=%p method=%d start=%llx", http, http->request_method, http->request_started);
 }
 
@@ -147,16 +188,93 @@ static __always_inline bool http_seen_before(http_transaction_t *http, skb_info_
 }
 
 static __always_inline http_transaction_t *http_fetch_state(conn_tuple_t *tuple, http_transaction_t *http, http_packet_t packet_type) {
-    if (packet_type == HTTP_PACKET_UNKNOWN) {
-        return bpf_map_lookup_elem(&http_in_flight, tuple);
+    http_transaction_t *state = bpf_map_lookup_elem(&http_in_flight, tuple);
+    if (state || packet_type == HTTP_PACKET_UNKNOWN) {
+        return state;
     }
 
-    // We detected either a request or a response
-    // In this case we initialize (or fetch) state associated to this tuple
+    // We detected either a request or a response, and the tuple has no state yet
+    // In this case we initialize the state associated to this tuple. The pipelined requests of
+    // a previous connection using the same tuple are dropped.
+    http_pipeline_key_t key = {0};
+    key.tup = *tuple;
+#pragma unroll (HTTP_PIPELINE_SLOTS)
+    for (int i = 0; i < HTTP_PIPELINE_SLOTS; i++) {
+        key.slot = i;
+        bpf_map_delete_elem(&http_pipeline, &key);
+    }
     bpf_map_update_with_telemetry(http_in_flight, tuple, http, BPF_NOEXIST);
     return bpf_map_lookup_elem(&http_in_flight, tuple);
 }
 
+static __always_inline __u8 http_pipeline_head(http_transaction_t *http) {
+    return http->pipeline & 0xf;
+}
+
+static __always_inline __u8 http_pipeline_len(http_transaction_t *http) {
+    return http->pipeline >> 4;
+}
+
+static __always_inline void http_pipeline_set(http_transaction_t *http, __u8 head, __u8 len) {
+    http->pipeline = (len << 4) | (head & (HTTP_PIPELINE_SLOTS - 1));
+}
+
+// Returns true if a request was sent before the response of the in-flight transaction, or while other requests are
+// still waiting for theirs.
+static __always_inline bool http_is_pipelined_request(http_transaction_t *http, http_packet_t packet_type) {
+    return packet_type == HTTP_REQUEST && http->request_started && (!http->response_status_code || http_pipeline_len(http));
+}
+
+// http_pipeline_push queues a pipelined request behind the in-flight transaction `http`. `request` holds the request
+// fragment. Returns false if the pipeline of the connection is full, in which case the request isn't tracked.
+static __always_inline bool http_pipeline_push(conn_tuple_t *tuple, http_transaction_t *http, http_transaction_t *request, http_method_t method, __u64 tags) {
+    const __u8 head = http_pipeline_head(http);
+    const __u8 len = http_pipeline_len(http);
+    if (len >= HTTP_PIPELINE_SLOTS) {
+        return false;
+    }
+
+    request->request_method = method;
+    request->request_started = bpf_ktime_get_ns();
+    request->tags |= tags;
+    http_trim_request_fragment(request->request_fragment);
+
+    http_pipeline_key_t key = {0};
+    key.tup = *tuple;
+    key.slot = (head + len) & (HTTP_PIPELINE_SLOTS - 1);
+    if (bpf_map_update_elem(&http_pipeline, &key, request, BPF_ANY) != 0) {
+        return false;
+    }
+    http_pipeline_set(http, head, len + 1);
+    log_debug("http_pipeline_push: htx=%p method=%d len=%d", http, method, len + 1);
+    return true;
+}
+
+// http_pipeline_pop replaces the in-flight transaction `http`, which was flushed, with the oldest pipelined request
+static __always_inline void http_pipeline_pop(conn_tuple_t *tuple, http_transaction_t *http) {
+    const __u8 head = http_pipeline_head(http);
+    const __u8 len = http_pipeline_len(http);
+    const __u32 tcp_seq = http->tcp_seq;
+
+    http_pipeline_key_t key = {0};
+    key.tup = *tuple;
+    key.slot = head;
+    http_transaction_t *request = bpf_map_lookup_elem(&http_pipeline, &key);
+    if (request) {
+        bpf_memcpy(http, request, sizeof(http_transaction_t));
+        bpf_map_delete_elem(&http_pipeline, &key);
+    } else {
+        // the request was evicted from the LRU map, the response starts a transaction without a request
+        http->request_started = 0;
+        http->request_method = HTTP_METHOD_UNKNOWN;
+        http->tags = 0;
+    }
+    http->response_last_seen = 0;
+    http->response_status_code = 0;
+    http->tcp_seq = tcp_seq;
+    http_pipeline_set(http, head + 1, len - 1);
+}
+
 
 
 // Returns true if the given http transaction should be flushed to the user mode.
@@ -185,7 +303,17 @@ static __always_inline void http_process(http_event_t *event, skb_info_t *skb_in
         return;
     }
 
-    if (http_should_flush_previous_state(http, packet_type)) {
+    if (http_is_pipelined_request(http, packet_type)) {
+        // The request waits for its response in the pipeline of the connection
+        http_pipeline_push(tuple, http, &event->http, method, tags);
+        return;
+    }
+
+    if (packet_type == HTTP_RESPONSE && http->response_status_code && http_pipeline_len(http)) {
+        // The in-flight transaction is complete, and the response belongs to the oldest pipelined request
+        http_batch_enqueue_wrapper(tuple, http);
+        http_pipeline_pop(tuple, http);
+    } else if (http_should_flush_previous_state(http, packet_type)) {
         http_batch_enqueue_wrapper(tuple, http);
         bpf_memcpy(http, &event->http, sizeof(http_transaction_t));
     }
@@ -230,8 +358,7 @@ static __always_inline bool http_allow_packet(conn_tuple_t *tuple, skb_info_t *s
     return true;
 }
 
-SEC("socket/http_filter")
-int socket__http_filter(struct __sk_buff* skb) {
+static __always_inline int __socket__http_filter(struct __sk_buff* skb) {
     skb_info_t skb_info;
     http_event_t event;
     bpf_memset(&event, 0, sizeof(http_event_t));
@@ -251,8 +378,14 @@ int socket__http_filter(struct __sk_buff* skb) {
     return 0;
 }
 
-SEC("uprobe/http_process")
-int uprobe__http_process(struct pt_regs *ctx) {
+SEC("socket/http_filter")
+int socket__http_filter(struct __sk_buff* skb) {
+    const int ret = __socket__http_filter(skb);
+    usm_cpu_cost_end();
+    return ret;
+}
+
+static __always_inline int __uprobe__http_process(struct pt_regs *ctx) {
     const __u32 zero = 0;
     tls_dispatcher_arguments_t *args = bpf_map_lookup_elem(&tls_dispatcher_arguments, &zero);
     if (args == NULL) {
@@ -269,8 +402,14 @@ int uprobe__http_process(struct pt_regs *ctx) {
     return 0;
 }
 
-SEC("uprobe/http_termination")
-int uprobe__http_termination(struct pt_regs *ctx) {
+SEC("uprobe/http_process")
+int uprobe__http_process(struct pt_regs *ctx) {
+    const int ret = __uprobe__http_process(ctx);
+    usm_cpu_cost_end();
+    return ret;
+}
+
+static __always_inline int __uprobe__http_termination(struct pt_regs *ctx) {
     const __u32 zero = 0;
     tls_dispatcher_arguments_t *args = bpf_map_lookup_elem(&tls_dispatcher_arguments, &zero);
     if (args == NULL) {
@@ -288,4 +427,11 @@ int uprobe__http_termination(struct pt_regs *ctx) {
     return 0;
 }
 
+SEC("uprobe/http_termination")
+int uprobe__http_termination(struct pt_regs *ctx) {
+    const int ret = __uprobe__http_termination(ctx);
+    usm_cpu_cost_end();
+    return ret;
+}
+
 #endif
@@ -9,6 +9,10 @@
 /* This map is used to keep track of in-flight HTTP transactions for each TCP connection */
 BPF_HASH_MAP(http_in_flight, conn_tuple_t, http_transaction_t, 0)
 
+/* This map holds the pipelined requests waiting for their response behind the in-flight transaction of a connection,
+   with up to HTTP_PIPELINE_SLOTS slots per connection. Pipelining is rare, hence the LRU map of a fixed size. */
+BPF_LRU_MAP(http_pipeline, http_pipeline_key_t, http_transaction_t, 1024)
+
 
 /* This map acts as a scratch buffer for "preparing" http_event_t objects before they're
    enqueued. The primary motivation here is to save eBPF stack memory. */
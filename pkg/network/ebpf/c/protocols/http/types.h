@@ -16,6 +16,10 @@
 // For more information see `http_seen_before`
 #define HTTP_TERMINATING 0xFFFFFFFF
 
+// Number of pipelined HTTP/1.1 requests which can wait for their response behind the in-flight transaction of a
+// connection, see `http_pipeline`. Must be a power of 2, lower than 16.
+#define HTTP_PIPELINE_SLOTS 4
+
 // This is needed to reduce code size on multiple copy optimizations that were made in
 // the http eBPF program.
 _Static_assert((HTTP_BUFFER_SIZE % 8) == 0, "HTTP_BUFFER_SIZE must be a multiple of 8.");
@@ -50,9 +54,17 @@ typedef struct {
     __u32 tcp_seq;
     __u16 response_status_code;
     __u8  request_method;
+    // pipelined requests of the connection: the bits 0-3 hold the slot of the oldest one, the bits 4-7 their number.
+    // Only used by the in-flight transaction, see `http_pipeline_push`.
+    __u8  pipeline;
     char request_fragment[HTTP_BUFFER_SIZE] __attribute__ ((aligned (8)));
 } http_transaction_t;
 
+typedef struct {
+    conn_tuple_t tup;
+    __u64 slot;
+} http_pipeline_key_t;
+
 typedef struct {
     conn_tuple_t tuple;
     http_transaction_t http;
@@ -84,6 +96,9 @@ typedef struct {
 typedef struct {
     conn_tuple_t tup;
     __u32 fd;
+    // Set once the session is classified as a protocol which isn't decoded over TLS, so its reads and writes are
+    // skipped from then on.
+    bool ignored;
 } ssl_sock_t;
 
 #endif
@@ -10,7 +10,14 @@
 #include "protocols/http2/decoding-defs.h"
 #include "protocols/http2/helpers.h"
 #include "protocols/http2/maps-defs.h"
+#include "protocols/http2/pktbuf-common.h"
 #include "protocols/classification/defs.h"
+#include "protocols/helpers/pktbuf.h"
+
+// The decoder is shared by the socket filter (plain text) and the uprobes (TLS) programs, which only differ by the
+// way they read the payload (see pktbuf.h), the dispatcher arguments and the maps holding their tail call state.
+
+PKTBUF_READ_INTO_BUFFER(http2_path, HTTP2_MAX_PATH_LEN, BLK_SIZE)
 
 // Returns true if the given index represents a path index.
 static __always_inline bool is_path_index(const __u64 index) {
@@ -27,6 +34,11 @@ static __always_inline bool is_status_index(const __u64 index) {
     return k200 <= index && index <= k500;
 }
 
+// Returns true if the given index represents a grpc-status header, see HTTP2_GRPC_STATUS_PSEUDO_INDEX.
+static __always_inline bool is_grpc_status_index(const __u64 index) {
+    return index == HTTP2_GRPC_STATUS_PSEUDO_INDEX;
+}
+
 // returns true if the given index is one of the relevant headers we care for in the static table.
 // The full table can be found in the user mode code `createStaticTable`.
 static __always_inline bool is_interesting_static_entry(const __u64 index) {
@@ -67,6 +79,22 @@ static __always_inline __u64 *get_dynamic_counter(conn_tuple_t *tup) {
     return &ptr->value;
 }
 
+// dynamic_table_slot returns the slot of the dynamic table ring of a connection holding the entry `index`.
+static __always_inline __u64 dynamic_table_slot(__u64 index) {
+    return index & (HTTP2_DYNAMIC_TABLE_SLOTS - 1);
+}
+
+// lookup_dynamic_table_entry returns the entry `index` of the dynamic table of the connection of `dynamic_index`,
+// or NULL if it was never added or was evicted by a newer entry.
+static __always_inline dynamic_table_entry_t *lookup_dynamic_table_entry(dynamic_table_index_t *dynamic_index, __u64 index) {
+    dynamic_index->index = dynamic_table_slot(index);
+    dynamic_table_entry_t *entry = bpf_map_lookup_elem(&http2_dynamic_table, dynamic_index);
+    if (entry == NULL || entry->index != index) {
+        return NULL;
+    }
+    return entry;
+}
+
 // parse_field_indexed parses fully-indexed headers.
 static __always_inline void parse_field_indexed(dynamic_table_index_t *dynamic_index, http2_header_t *restrict headers_to_process, __u8 index, __u64 global_dynamic_counter, __u8 *interesting_headers_counter) {
     if (headers_to_process == NULL) {
@@ -83,13 +111,11 @@ static __always_inline void parse_field_indexed(dynamic_table_index_t *dynamic_i
 
     // We change the index to match our internal dynamic table implementation index.
     // Our internal indexes start from 1, so we subtract 61 in order to match the given index.
-    dynamic_index->index = global_dynamic_counter - (index - MAX_STATIC_TABLE_INDEX);
-
-    headers_to_process->index = dynamic_index->index;
+    headers_to_process->index = global_dynamic_counter - (index - MAX_STATIC_TABLE_INDEX);
     headers_to_process->type = kExistingDynamicHeader;
     // If the entry exists, increase the counter. If the entry is missing, then we won't increase the counter.
     // This is a simple trick to spare if-clause, to reduce pressure on the complexity of the program.
-    *interesting_headers_counter += bpf_map_lookup_elem(&http2_dynamic_table, dynamic_index) != NULL;
+    *interesting_headers_counter += lookup_dynamic_table_entry(dynamic_index, headers_to_process->index) != NULL;
     return;
 }
 
@@ -166,4 +192,796 @@ static __always_inline void reset_frame(http2_frame_t *out) {
     *out = (http2_frame_t){ 0 };
 }
 
+// is_grpc_status_name returns true if the literal header name at the current offset, whose length is `name_len`, is
+// the grpc-status header name.
+static __always_inline bool is_grpc_status_name(pktbuf_t pkt, __u64 name_len, bool is_huffman_encoded) {
+    const __u64 expected_len = is_huffman_encoded ? GRPC_ENCODED_STATUS_HEADER_NAME_LEN : GRPC_STATUS_HEADER_NAME_LEN;
+    if (name_len != expected_len || pktbuf_data_offset(pkt) + name_len > pktbuf_data_end(pkt)) {
+        return false;
+    }
+
+    char name[GRPC_STATUS_HEADER_NAME_LEN];
+    if (is_huffman_encoded) {
+        pktbuf_load_bytes(pkt, pktbuf_data_offset(pkt), name, GRPC_ENCODED_STATUS_HEADER_NAME_LEN);
+        return bpf_memcmp(name, GRPC_ENCODED_STATUS_HEADER_NAME, GRPC_ENCODED_STATUS_HEADER_NAME_LEN) == 0;
+    }
+    pktbuf_load_bytes(pkt, pktbuf_data_offset(pkt), name, GRPC_STATUS_HEADER_NAME_LEN);
+    return bpf_memcmp(name, GRPC_STATUS_HEADER_NAME, GRPC_STATUS_HEADER_NAME_LEN) == 0;
+}
+
+// parse_field_literal parses a header with a literal value.
+//
+// We are only interested in path, method, status and grpc-status headers, that we will store in our internal
+// dynamic table, and will skip the other headers.
+static __always_inline bool parse_field_literal(pktbuf_t pkt, pktbuf_window_t *window, http2_header_t *headers_to_process, __u64 index, __u64 global_dynamic_counter, __u8 *interesting_headers_counter, http2_telemetry_t *http2_tel, bool save_header) {
+    __u64 str_len = 0;
+    bool is_huffman_encoded = false;
+    // String length supposed to be represented with at least 7 bits representation -https://datatracker.ietf.org/doc/html/rfc7541#section-5.2
+    if (!read_hpack_int(pkt, window, MAX_7_BITS, &str_len, &is_huffman_encoded)) {
+        return false;
+    }
+
+    // The header name is new. We skip it, and we keep the value only for the grpc-status header.
+    if (index == 0) {
+        const bool is_grpc_status = is_grpc_status_name(pkt, str_len, is_huffman_encoded);
+        pktbuf_advance(pkt, str_len);
+        str_len = 0;
+        // String length supposed to be represented with at least 7 bits representation -https://datatracker.ietf.org/doc/html/rfc7541#section-5.2
+        if (!read_hpack_int(pkt, window, MAX_7_BITS, &str_len, &is_huffman_encoded)) {
+            return false;
+        }
+        if (!is_grpc_status) {
+            goto end;
+        }
+        index = HTTP2_GRPC_STATUS_PSEUDO_INDEX;
+    }
+
+    // Path headers in HTTP2 that are not "/" or "/index.html"  are represented
+    // with an indexed name, literal value, reusing the index 4 and 5 in the
+    // static table. A different index means that the header is not a path, so
+    // we skip it.
+    if (is_path_index(index)) {
+        update_path_size_telemetry(http2_tel, str_len);
+    } else if ((!is_status_index(index)) && (!is_method_index(index)) && (!is_grpc_status_index(index))) {
+        goto end;
+    }
+
+    // We skip if:
+    // - The string is too big
+    // - This is not a path
+    // - We won't be able to store the header info
+    if (headers_to_process == NULL) {
+        goto end;
+    }
+
+    if (pktbuf_data_offset(pkt) + str_len > pktbuf_data_end(pkt)) {
+        __sync_fetch_and_add(&http2_tel->literal_value_exceeds_frame, 1);
+        goto end;
+    }
+
+    if (save_header) {
+        headers_to_process->index = global_dynamic_counter - 1;
+        headers_to_process->type = kNewDynamicHeader;
+    } else {
+        headers_to_process->type = kNewDynamicHeaderNotIndexed;
+    }
+    headers_to_process->original_index = index;
+    headers_to_process->new_dynamic_value_offset = pktbuf_data_offset(pkt);
+    headers_to_process->new_dynamic_value_size = str_len;
+    headers_to_process->is_huffman_encoded = is_huffman_encoded;
+    // If the string len (`str_len`) is in the range of [0, HTTP2_MAX_PATH_LEN], and we don't exceed packet boundaries
+    // (data_off + str_len <= data_end) and the index is kIndexPath, then we have a path header,
+    // and we're increasing the counter. In any other case, we're not increasing the counter.
+    *interesting_headers_counter += (str_len > 0 && str_len <= HTTP2_MAX_PATH_LEN);
+end:
+    pktbuf_advance(pkt, str_len);
+    return true;
+}
+
+// filter_relevant_headers parses the http2 headers frame, and filters headers
+// that are relevant for us, to be processed later on.
+// The return value is the number of relevant headers that were found and inserted
+// in the `headers_to_process` table.
+static __always_inline __u8 filter_relevant_headers(pktbuf_t pkt, conn_tuple_t *tup, dynamic_table_index_t *dynamic_index, http2_header_t *headers_to_process, __u32 frame_length, http2_telemetry_t *http2_tel) {
+    __u8 current_ch;
+    __u8 interesting_headers = 0;
+    http2_header_t *current_header;
+    const __u32 frame_end = pktbuf_data_offset(pkt) + frame_length;
+    const __u32 data_end = pktbuf_data_end(pkt);
+    const __u32 end = frame_end < data_end + 1 ? frame_end : data_end + 1;
+    bool is_indexed = false;
+    bool is_literal = false;
+    __u64 max_bits = 0;
+    __u64 index = 0;
+
+    __u64 *global_dynamic_counter = get_dynamic_counter(tup);
+    if (global_dynamic_counter == NULL) {
+        return 0;
+    }
+
+    // Most of the headers are encoded in a byte or two, so they are read through a window of the packet.
+    pktbuf_window_t window = {};
+    handle_dynamic_table_update(pkt, &window);
+
+#pragma unroll(HTTP2_MAX_PSEUDO_HEADERS_COUNT_FOR_FILTERING)
+    for (__u8 headers_index = 0; headers_index < HTTP2_MAX_PSEUDO_HEADERS_COUNT_FOR_FILTERING; ++headers_index) {
+        if (pktbuf_data_offset(pkt) >= end) {
+            break;
+        }
+        if (!pktbuf_window_load_byte(pkt, &window, pktbuf_data_offset(pkt), &current_ch)) {
+            break;
+        }
+        pktbuf_advance(pkt, 1);
+
+        is_indexed = (current_ch & 128) != 0;
+        is_literal = (current_ch & 192) == 64;
+        // If all (is_indexed, is_literal, is_dynamic_table_update) are false, then we
+        // have a literal header field without indexing (prefix 0000) or literal header field never indexed (prefix 0001).
+
+        max_bits = MAX_4_BITS;
+        // If we're in an indexed header - the max bits are 7.
+        max_bits = is_indexed ? MAX_7_BITS : max_bits;
+        // else, if we're in a literal header - the max bits are 6.
+        max_bits = is_literal ? MAX_6_BITS : max_bits;
+        // otherwise, we're in literal header without indexing or literal header never indexed - and for both, the
+        // max bits are 4.
+        // See RFC7541 - https://httpwg.org/specs/rfc7541.html#rfc.section.6.2.2
+
+        index = 0;
+        if (!read_hpack_int_with_given_current_char(pkt, &window, current_ch, max_bits, &index)) {
+            break;
+        }
+
+        current_header = NULL;
+        if (interesting_headers < HTTP2_MAX_HEADERS_COUNT_FOR_PROCESSING) {
+            current_header = &headers_to_process[interesting_headers];
+        }
+
+        if (is_indexed) {
+            // Indexed representation.
+            // MSB bit set.
+            // https://httpwg.org/specs/rfc7541.html#rfc.section.6.1
+            parse_field_indexed(dynamic_index, current_header, index, *global_dynamic_counter, &interesting_headers);
+            continue;
+        }
+        // Increment the global dynamic counter for each literal header field.
+        // We're not increasing the counter for literal without indexing or literal never indexed.
+        __sync_fetch_and_add(global_dynamic_counter, is_literal);
+        // 6.2.1 Literal Header Field with Incremental Indexing
+        // top two bits are 11
+        // https://httpwg.org/specs/rfc7541.html#rfc.section.6.2.1
+        if (!parse_field_literal(pkt, &window, current_header, index, *global_dynamic_counter, &interesting_headers, http2_tel, is_literal)) {
+            break;
+        }
+    }
+
+#pragma unroll(HTTP2_MAX_HEADERS_COUNT_FOR_FILTERING)
+    for (__u8 headers_index = 0; headers_index < HTTP2_MAX_HEADERS_COUNT_FOR_FILTERING; ++headers_index) {
+        if (pktbuf_data_offset(pkt) >= end) {
+            break;
+        }
+
+        if (!pktbuf_window_load_byte(pkt, &window, pktbuf_data_offset(pkt), &current_ch)) {
+            break;
+        }
+        pktbuf_advance(pkt, 1);
+
+        is_indexed = (current_ch & 128) != 0;
+        is_literal = (current_ch & 192) == 64;
+        // If all (is_indexed, is_literal, is_dynamic_table_update) are false, then we
+        // have a literal header field without indexing (prefix 0000) or literal header field never indexed (prefix 0001).
+
+        max_bits = MAX_4_BITS;
+        // If we're in an indexed header - the max bits are 7.
+        max_bits = is_indexed ? MAX_7_BITS : max_bits;
+        // else, if we're in a literal header - the max bits are 6.
+        max_bits = is_literal ? MAX_6_BITS : max_bits;
+        // otherwise, we're in literal header without indexing or literal header never indexed - and for both, the
+        // max bits are 4.
+        // See RFC7541 - https://httpwg.org/specs/rfc7541.html#rfc.section.6.2.2
+
+        index = 0;
+        if (!read_hpack_int_with_given_current_char(pkt, &window, current_ch, max_bits, &index)) {
+            break;
+        }
+
+        if (is_indexed) {
+            // Indexed representation.
+            // MSB bit set.
+            // https://httpwg.org/specs/rfc7541.html#rfc.section.6.1
+            continue;
+        }
+        // Increment the global dynamic counter for each literal header field.
+        // We're not increasing the counter for literal without indexing or literal never indexed.
+        __sync_fetch_and_add(global_dynamic_counter, is_literal);
+        // Handle frame headers which are not pseudo headers fields.
+        if (!process_and_skip_literal_headers(pkt, &window, index)) {
+            break;
+        }
+    }
+
+    return interesting_headers;
+}
+
+// process_headers processes the headers that were filtered in filter_relevant_headers,
+// looking for requests path, status code, method, and the grpc-status trailer.
+static __always_inline void process_headers(pktbuf_t pkt, dynamic_table_index_t *dynamic_index, http2_stream_t *current_stream, http2_header_t *headers_to_process, __u8 interesting_headers, http2_telemetry_t *http2_tel) {
+    http2_header_t *current_header;
+    dynamic_table_entry_t dynamic_value = {};
+
+#pragma unroll(HTTP2_MAX_HEADERS_COUNT_FOR_PROCESSING)
+    for (__u8 iteration = 0; iteration < HTTP2_MAX_HEADERS_COUNT_FOR_PROCESSING; ++iteration) {
+        if (iteration >= interesting_headers) {
+            break;
+        }
+
+        current_header = &headers_to_process[iteration];
+
+        if (current_header->type == kStaticHeader) {
+            if (is_method_index(current_header->index)) {
+                // TODO: mark request
+                current_stream->request_method.static_table_entry = current_header->index;
+                current_stream->request_method.finalized = true;
+                __sync_fetch_and_add(&http2_tel->request_seen, 1);
+            } else if (is_status_index(current_header->index)) {
+                current_stream->status_code.static_table_entry = current_header->index;
+                current_stream->status_code.finalized = true;
+                __sync_fetch_and_add(&http2_tel->response_seen, 1);
+            } else if (is_path_index(current_header->index)) {
+                current_stream->path.static_table_entry = current_header->index;
+                current_stream->path.finalized = true;
+            }
+            continue;
+        }
+
+        if (current_header->type == kExistingDynamicHeader) {
+            dynamic_table_entry_t *dynamic_value = lookup_dynamic_table_entry(dynamic_index, current_header->index);
+            if (dynamic_value == NULL) {
+                break;
+            }
+            if (is_path_index(dynamic_value->original_index)) {
+                current_stream->path.length = dynamic_value->string_len;
+                current_stream->path.is_huffman_encoded = dynamic_value->is_huffman_encoded;
+                current_stream->path.finalized = true;
+                bpf_memcpy(current_stream->path.raw_buffer, dynamic_value->buffer, HTTP2_MAX_PATH_LEN);
+            } else if (is_status_index(dynamic_value->original_index)) {
+                bpf_memcpy(current_stream->status_code.raw_buffer, dynamic_value->buffer, HTTP2_STATUS_CODE_MAX_LEN);
+                current_stream->status_code.is_huffman_encoded = dynamic_value->is_huffman_encoded;
+                current_stream->status_code.finalized = true;
+            } else if (is_method_index(dynamic_value->original_index)) {
+                bpf_memcpy(current_stream->request_method.raw_buffer, dynamic_value->buffer, HTTP2_METHOD_MAX_LEN);
+                current_stream->request_method.is_huffman_encoded = dynamic_value->is_huffman_encoded;
+                current_stream->request_method.length = dynamic_value->string_len;
+                current_stream->request_method.finalized = true;
+            } else if (is_grpc_status_index(dynamic_value->original_index)) {
+                bpf_memcpy(current_stream->grpc_status.raw_buffer, dynamic_value->buffer, HTTP2_GRPC_STATUS_MAX_LEN);
+                current_stream->grpc_status.is_huffman_encoded = dynamic_value->is_huffman_encoded;
+                current_stream->grpc_status.length = dynamic_value->string_len;
+                current_stream->grpc_status.finalized = true;
+            }
+        } else {
+            // We're in new dynamic header or new dynamic header not indexed states.
+            pktbuf_read_into_buffer_http2_path(dynamic_value.buffer, pkt, current_header->new_dynamic_value_offset);
+            // If the value is indexed - add it to the dynamic table.
+            if (current_header->type == kNewDynamicHeader) {
+                dynamic_value.string_len = current_header->new_dynamic_value_size;
+                dynamic_value.is_huffman_encoded = current_header->is_huffman_encoded;
+                dynamic_value.original_index = current_header->original_index;
+                dynamic_value.index = current_header->index;
+                // The entry replaces the one added HTTP2_DYNAMIC_TABLE_SLOTS entries earlier, if any.
+                dynamic_index->index = dynamic_table_slot(current_header->index);
+                bpf_map_update_elem(&http2_dynamic_table, dynamic_index, &dynamic_value, BPF_ANY);
+            }
+            if (is_path_index(current_header->original_index)) {
+                current_stream->path.length = current_header->new_dynamic_value_size;
+                current_stream->path.is_huffman_encoded = current_header->is_huffman_encoded;
+                current_stream->path.finalized = true;
+                bpf_memcpy(current_stream->path.raw_buffer, dynamic_value.buffer, HTTP2_MAX_PATH_LEN);
+            } else if (is_status_index(current_header->original_index)) {
+                bpf_memcpy(current_stream->status_code.raw_buffer, dynamic_value.buffer, HTTP2_STATUS_CODE_MAX_LEN);
+                current_stream->status_code.is_huffman_encoded = current_header->is_huffman_encoded;
+                current_stream->status_code.finalized = true;
+            } else if (is_method_index(current_header->original_index)) {
+                bpf_memcpy(current_stream->request_method.raw_buffer, dynamic_value.buffer, HTTP2_METHOD_MAX_LEN);
+                current_stream->request_method.is_huffman_encoded = current_header->is_huffman_encoded;
+                current_stream->request_method.length = current_header->new_dynamic_value_size;
+                current_stream->request_method.finalized = true;
+            } else if (is_grpc_status_index(current_header->original_index)) {
+                bpf_memcpy(current_stream->grpc_status.raw_buffer, dynamic_value.buffer, HTTP2_GRPC_STATUS_MAX_LEN);
+                current_stream->grpc_status.is_huffman_encoded = current_header->is_huffman_encoded;
+                current_stream->grpc_status.length = current_header->new_dynamic_value_size;
+                current_stream->grpc_status.finalized = true;
+            }
+        }
+    }
+}
+
+static __always_inline void process_headers_frame(pktbuf_t pkt, http2_stream_t *current_stream, conn_tuple_t *tup, dynamic_table_index_t *dynamic_index, http2_frame_t *current_frame_header, http2_telemetry_t *http2_tel) {
+    const __u32 zero = 0;
+
+    // Allocating an array of headers, to hold all interesting headers from the frame.
+    http2_header_t *headers_to_process = bpf_map_lookup_elem(&http2_headers_to_process, &zero);
+    if (headers_to_process == NULL) {
+        return;
+    }
+    bpf_memset(headers_to_process, 0, HTTP2_MAX_HEADERS_COUNT_FOR_PROCESSING * sizeof(http2_header_t));
+
+    __u8 interesting_headers = filter_relevant_headers(pkt, tup, dynamic_index, headers_to_process, current_frame_header->length, http2_tel);
+    process_headers(pkt, dynamic_index, current_stream, headers_to_process, interesting_headers, http2_tel);
+}
+
+// The function is trying to read the remaining of a split frame header. We have the first part in
+// `frame_state->buf` (from the previous packet), and now we're trying to read the remaining (`frame_state->remainder`
+// bytes from the current packet).
+static __always_inline void fix_header_frame(pktbuf_t pkt, char *out, frame_header_remainder_t *frame_state) {
+    bpf_memcpy(out, frame_state->buf, HTTP2_FRAME_HEADER_SIZE);
+    const __u32 data_off = pktbuf_data_offset(pkt);
+    // Verifier is unhappy with a single read with a variable length (although checking boundaries)
+    switch (frame_state->remainder) {
+    case 1:
+        pktbuf_load_bytes(pkt, data_off, out + HTTP2_FRAME_HEADER_SIZE - 1, 1);
+        break;
+    case 2:
+        pktbuf_load_bytes(pkt, data_off, out + HTTP2_FRAME_HEADER_SIZE - 2, 2);
+        break;
+    case 3:
+        pktbuf_load_bytes(pkt, data_off, out + HTTP2_FRAME_HEADER_SIZE - 3, 3);
+        break;
+    case 4:
+        pktbuf_load_bytes(pkt, data_off, out + HTTP2_FRAME_HEADER_SIZE - 4, 4);
+        break;
+    case 5:
+        pktbuf_load_bytes(pkt, data_off, out + HTTP2_FRAME_HEADER_SIZE - 5, 5);
+        break;
+    case 6:
+        pktbuf_load_bytes(pkt, data_off, out + HTTP2_FRAME_HEADER_SIZE - 6, 6);
+        break;
+    case 7:
+        pktbuf_load_bytes(pkt, data_off, out + HTTP2_FRAME_HEADER_SIZE - 7, 7);
+        break;
+    case 8:
+        pktbuf_load_bytes(pkt, data_off, out + HTTP2_FRAME_HEADER_SIZE - 8, 8);
+        break;
+    }
+    return;
+}
+
+static __always_inline bool get_first_frame(pktbuf_t pkt, frame_header_remainder_t *frame_state, http2_frame_t *current_frame, http2_telemetry_t *http2_tel) {
+    // Attempting to read the initial frame in the packet, or handling a state where there is no remainder and finishing reading the current frame.
+    if (frame_state == NULL) {
+        // Checking we have enough bytes in the packet to read a frame header.
+        if (pktbuf_data_offset(pkt) + HTTP2_FRAME_HEADER_SIZE > pktbuf_data_end(pkt)) {
+            // Not enough bytes, cannot read frame, so we have 0 interesting frames in that packet.
+            return false;
+        }
+
+        // Reading frame, and ensuring the frame is valid.
+        pktbuf_load_bytes(pkt, pktbuf_data_offset(pkt), (char *)current_frame, HTTP2_FRAME_HEADER_SIZE);
+        pktbuf_advance(pkt, HTTP2_FRAME_HEADER_SIZE);
+        if (!format_http2_frame_header(current_frame)) {
+            // Frame is not valid, so we have 0 interesting frames in that packet.
+            return false;
+        }
+        return true;
+    }
+
+    // Getting here means we have a frame state from the previous packets.
+    // Scenarios in order:
+    //  1. Check if we have a frame-header remainder - if so, we must try and read the rest of the frame header.
+    //     In case of a failure, we abort.
+    //  2. If we don't have a frame-header remainder, then we're trying to read a valid frame.
+    //     HTTP2 can send valid frames (like SETTINGS and PING) during a split DATA frame. If such a frame exists,
+    //     then we won't have the rest of the split frame in the same packet.
+    //  3. If we reached here, and we have a remainder, then we're consuming the remainder and checking we can read the
+    //     next frame header.
+    //  4. We failed reading any frame. Aborting.
+
+    // Frame-header-remainder.
+
+    if (frame_state->header_length == HTTP2_FRAME_HEADER_SIZE) {
+        // A case where we read an interesting valid frame header in the previous call, and now we're trying to read the
+        // rest of the frame payload. But, since we already read a valid frame, we just fill it as an interesting frame,
+        // and continue to the next tail call.
+        // Copy the cached frame header to the current frame.
+        bpf_memcpy((char *)current_frame, frame_state->buf, HTTP2_FRAME_HEADER_SIZE);
+        frame_state->remainder = 0;
+        return true;
+    }
+    if (frame_state->header_length > 0) {
+        fix_header_frame(pkt, (char *)current_frame, frame_state);
+        if (format_http2_frame_header(current_frame)) {
+            pktbuf_advance(pkt, frame_state->remainder);
+            frame_state->remainder = 0;
+            return true;
+        }
+        frame_state->remainder = 0;
+        // We couldn't read frame header using the remainder.
+        return false;
+    }
+
+    // We failed to read a frame, if we have a remainder trying to consume it and read the following frame.
+    if (frame_state->remainder > 0) {
+        const __u32 data_end = pktbuf_data_end(pkt);
+        // To make a "best effort," if we are in a state where we are left with a remainder, and the length of it from
+        // our current position is larger than the data end, we will attempt to handle the remaining buffer as much as possible.
+        if (pktbuf_data_offset(pkt) + frame_state->remainder > data_end) {
+            frame_state->remainder -= data_end - pktbuf_data_offset(pkt);
+            pktbuf_set_offset(pkt, data_end);
+            return false;
+        }
+        pktbuf_advance(pkt, frame_state->remainder);
+        frame_state->remainder = 0;
+        // The remainders "ends" the current packet. No interesting frames were found.
+        if (pktbuf_data_offset(pkt) == data_end) {
+            return false;
+        }
+        if (pktbuf_data_offset(pkt) + HTTP2_FRAME_HEADER_SIZE > data_end) {
+            return false;
+        }
+        reset_frame(current_frame);
+        pktbuf_load_bytes(pkt, pktbuf_data_offset(pkt), (char *)current_frame, HTTP2_FRAME_HEADER_SIZE);
+        if (format_http2_frame_header(current_frame)) {
+            pktbuf_advance(pkt, HTTP2_FRAME_HEADER_SIZE);
+            return true;
+        }
+    }
+    // still not valid / does not have a remainder - abort.
+    return false;
+}
+
+// record_relevant_frame adds the frame to the frames handled by the headers and EOS parsers, if it is relevant.
+//
+// We consider frames as relevant if they are either:
+// - HEADERS frames
+// - RST_STREAM frames
+// - DATA frames with the END_STREAM flag set
+// Other DATA frames, which make most of the frames of streaming workloads, are jumped over using their length.
+static __always_inline void record_relevant_frame(http2_tail_call_state_t *iteration_value, http2_frame_t *frame, __u32 offset) {
+    const bool is_headers = frame->type == kHeadersFrame;
+    const bool is_end_of_stream = frame->type == kRSTStreamFrame ||
+        ((frame->flags & HTTP2_END_OF_STREAM) == HTTP2_END_OF_STREAM && (is_headers || frame->type == kDataFrame));
+    if (!is_headers && !is_end_of_stream) {
+        return;
+    }
+    if (iteration_value->frames_count >= HTTP2_MAX_FRAMES_ITERATIONS) {
+        return;
+    }
+
+    iteration_value->frames_array[iteration_value->frames_count].frame = *frame;
+    iteration_value->frames_array[iteration_value->frames_count].offset = offset;
+    iteration_value->frames_count++;
+    iteration_value->headers_frames_count += is_headers;
+    iteration_value->eos_frames_count += is_end_of_stream;
+}
+
+// find_relevant_frames iterates over the packet and finds frames that are
+// relevant for us. The frames info and location are stored in the `iteration_value->frames_array` array,
+// and the number of frames found is being stored at iteration_value->frames_count.
+// This function returns true if there are more frames to filter and if the number of frames found is less than
+// HTTP2_MAX_FRAMES_ITERATIONS. This indicates that there are additional frames to filter, allowing parsing frames by
+// the next tail call. If false is returned, the subsequent tail call should not be executed.
+// See record_relevant_frame for the frames considered as relevant.
+static __always_inline bool find_relevant_frames(pktbuf_t pkt, http2_tail_call_state_t *iteration_value, http2_telemetry_t *http2_tel) {
+    http2_frame_t current_frame = {};
+
+    // if we already processed part of the packet, we should start from the last offset we processed.
+    if (iteration_value->filter_iterations != 0) {
+        pktbuf_set_offset(pkt, iteration_value->data_off);
+    }
+
+    // If we have found enough interesting frames, we should not process any new frame.
+    // The value of iteration_value->frames_count may potentially be greater than 0.
+    // It's essential to validate that this increase doesn't surpass the maximum number of frames we can process.
+    if (iteration_value->frames_count >= HTTP2_MAX_FRAMES_ITERATIONS) {
+        return false;
+    }
+
+    const __u32 data_end = pktbuf_data_end(pkt);
+    __u32 iteration = 0;
+#pragma unroll(HTTP2_MAX_FRAMES_TO_FILTER)
+    for (; iteration < HTTP2_MAX_FRAMES_TO_FILTER; ++iteration) {
+        // Checking we can read HTTP2_FRAME_HEADER_SIZE from the packet.
+        if (pktbuf_data_offset(pkt) + HTTP2_FRAME_HEADER_SIZE > data_end) {
+            break;
+        }
+
+        pktbuf_load_bytes(pkt, pktbuf_data_offset(pkt), (char *)&current_frame, HTTP2_FRAME_HEADER_SIZE);
+        pktbuf_advance(pkt, HTTP2_FRAME_HEADER_SIZE);
+        if (!format_http2_frame_header(&current_frame)) {
+            break;
+        }
+
+        record_relevant_frame(iteration_value, &current_frame, pktbuf_data_offset(pkt));
+
+        // The payload is never read by the filter, we jump to the next frame header.
+        pktbuf_advance(pkt, current_frame.length);
+
+        // If we have found enough interesting frames, we can stop iterating.
+        if (iteration_value->frames_count >= HTTP2_MAX_FRAMES_ITERATIONS) {
+            break;
+        }
+    }
+
+    if (iteration_value->frames_count == HTTP2_MAX_FRAMES_ITERATIONS) {
+        __sync_fetch_and_add(&http2_tel->exceeding_max_interesting_frames, 1);
+    }
+
+    // This function returns true if there are more frames to filter, which will be parsed by the next tail call,
+    // and if we have not yet reached the maximum number of frames we can process.
+    return (((iteration == HTTP2_MAX_FRAMES_TO_FILTER) &&
+            (pktbuf_data_offset(pkt) + HTTP2_FRAME_HEADER_SIZE <= data_end)) &&
+            iteration_value->frames_count < HTTP2_MAX_FRAMES_ITERATIONS);
+}
+
+// store_frame_header_remainder saves the beginning of a frame header split between the end of the current buffer
+// and the next buffer of the connection, so that get_first_frame can complete it.
+static __always_inline void store_frame_header_remainder(pktbuf_t pkt, conn_tuple_t *tup) {
+    const __u32 data_off = pktbuf_data_offset(pkt);
+    const __u32 data_end = pktbuf_data_end(pkt);
+    if (data_off >= data_end || data_off + HTTP2_FRAME_HEADER_SIZE <= data_end) {
+        return;
+    }
+
+    frame_header_remainder_t new_frame_state = { 0 };
+    new_frame_state.remainder = HTTP2_FRAME_HEADER_SIZE - (data_end - data_off);
+    bpf_memset(new_frame_state.buf, 0, HTTP2_FRAME_HEADER_SIZE);
+#pragma unroll(HTTP2_FRAME_HEADER_SIZE)
+    for (__u32 iteration = 0; iteration < HTTP2_FRAME_HEADER_SIZE && new_frame_state.remainder + iteration < HTTP2_FRAME_HEADER_SIZE; ++iteration) {
+        pktbuf_load_bytes(pkt, data_off + iteration, new_frame_state.buf + iteration, 1);
+    }
+    new_frame_state.header_length = HTTP2_FRAME_HEADER_SIZE - new_frame_state.remainder;
+    bpf_map_update_elem(&http2_remainder, tup, &new_frame_state, BPF_ANY);
+}
+
+// handle_first_frame reads the first frame of the buffer, which may be the continuation of a frame split by the
+// previous buffer of the connection. It returns true if the rest of the buffer must be handed over to the frames
+// filter, in which case the offset of the buffer points to the frame following the first one.
+static __always_inline bool handle_first_frame(pktbuf_t pkt, conn_tuple_t *tup, http2_tail_call_state_t *iteration_value, http2_telemetry_t *http2_tel) {
+    http2_frame_t current_frame = {};
+
+    iteration_value->frames_count = 0;
+    iteration_value->iteration = 0;
+    iteration_value->filter_iterations = 0;
+    iteration_value->headers_frames_count = 0;
+    iteration_value->eos_frames_count = 0;
+    iteration_value->data_off = 0;
+
+    // skip HTTP2 magic, if present
+    skip_preface(pkt);
+    if (pktbuf_data_offset(pkt) == pktbuf_data_end(pkt)) {
+        // Abort early if we reached to the end of the frame (a.k.a having only the HTTP2 magic in the packet).
+        return false;
+    }
+
+    frame_header_remainder_t *frame_state = bpf_map_lookup_elem(&http2_remainder, tup);
+
+    bool has_valid_first_frame = get_first_frame(pkt, frame_state, &current_frame, http2_tel);
+    // If we have a state and we consumed it, then delete it.
+    if (frame_state != NULL && frame_state->remainder == 0) {
+        bpf_map_delete_elem(&http2_remainder, tup);
+    }
+
+    if (!has_valid_first_frame) {
+        // Handling the case where we have a frame header remainder, and we couldn't read the frame header.
+        store_frame_header_remainder(pkt, tup);
+        return false;
+    }
+
+    record_relevant_frame(iteration_value, &current_frame, pktbuf_data_offset(pkt));
+
+    pktbuf_advance(pkt, current_frame.length);
+    // We're exceeding the packet boundaries, so we have a remainder.
+    if (pktbuf_data_offset(pkt) > pktbuf_data_end(pkt)) {
+        frame_header_remainder_t new_frame_state = { 0 };
+
+        // Saving the remainder.
+        new_frame_state.remainder = pktbuf_data_offset(pkt) - pktbuf_data_end(pkt);
+        // We did find an interesting frame (as frames_count == 1), so we cache the current frame and waiting for the
+        // next call.
+        if (iteration_value->frames_count == 1) {
+            new_frame_state.header_length = HTTP2_FRAME_HEADER_SIZE;
+            bpf_memcpy(new_frame_state.buf, (char *)&current_frame, HTTP2_FRAME_HEADER_SIZE);
+        }
+
+        iteration_value->frames_count = 0;
+        iteration_value->headers_frames_count = 0;
+        iteration_value->eos_frames_count = 0;
+        bpf_map_update_elem(&http2_remainder, tup, &new_frame_state, BPF_ANY);
+        // Not calling the next tail call as we have nothing to process.
+        return false;
+    }
+
+    return true;
+}
+
+// filter_frames looks for the relevant frames of the buffer, and saves the state of the frame split between the
+// buffer and the next buffer of the connection, if any. It returns true if there are more frames to filter, in which
+// case the filter program must be called again.
+static __always_inline bool filter_frames(pktbuf_t pkt, conn_tuple_t *tup, http2_tail_call_state_t *iteration_value, http2_telemetry_t *http2_tel) {
+    bool have_more_frames_to_process = find_relevant_frames(pkt, iteration_value, http2_tel);
+    // We have found there are more frames to filter, so we will call frame_filter again.
+    // Max current amount of tail calls would be 2, which will allow us to currently parse
+    // HTTP2_MAX_TAIL_CALLS_FOR_FRAMES_FILTER*HTTP2_MAX_FRAMES_ITERATIONS.
+    iteration_value->filter_iterations++;
+    if (have_more_frames_to_process && iteration_value->filter_iterations < HTTP2_MAX_TAIL_CALLS_FOR_FRAMES_FILTER) {
+        // save the offset, so the next prog will start from the offset of the next valid frame.
+        iteration_value->data_off = pktbuf_data_offset(pkt);
+        return true;
+    }
+
+    // if we left with more headers to process and we reached the max amount of tail calls we should update the telemetry.
+    if (have_more_frames_to_process) {
+        __sync_fetch_and_add(&http2_tel->exceeding_max_frames_to_filter, 1);
+    }
+
+    if (pktbuf_data_offset(pkt) > pktbuf_data_end(pkt)) {
+        // We have a remainder
+        frame_header_remainder_t new_frame_state = { 0 };
+        new_frame_state.remainder = pktbuf_data_offset(pkt) - pktbuf_data_end(pkt);
+        bpf_map_update_elem(&http2_remainder, tup, &new_frame_state, BPF_ANY);
+    } else {
+        // We may have a frame header remainder
+        store_frame_header_remainder(pkt, tup);
+    }
+
+    return false;
+}
+
+// init_headers_ctx creates the http2 ctx used by the headers parser for the frames of the connection.
+static __always_inline void init_headers_ctx(conn_tuple_t *tup, http2_ctx_t *http2_ctx) {
+    bpf_memset(http2_ctx, 0, sizeof(http2_ctx_t));
+    http2_ctx->http2_stream_key.tup = *tup;
+    normalize_tuple(&http2_ctx->http2_stream_key.tup);
+    http2_ctx->dynamic_index.tup = *tup;
+}
+
+// parse_next_headers_frame parses the next frame found by the frames filter if it is a headers frame, and tags its
+// stream with `tags`. It returns false once all the frames were parsed.
+// The loop calling it is left to the headers parser programs, as the number of frames parsed per tail call, and thus
+// the number of instructions, is set for each program.
+static __always_inline bool parse_next_headers_frame(pktbuf_t pkt, conn_tuple_t *tup, __u64 tags, http2_tail_call_state_t *tail_call_state, http2_ctx_t *http2_ctx, http2_telemetry_t *http2_tel) {
+    if (tail_call_state->iteration >= tail_call_state->frames_count) {
+        return false;
+    }
+    // This check must be next to the access of the array, otherwise the verifier will complain.
+    if (tail_call_state->iteration >= HTTP2_MAX_FRAMES_ITERATIONS) {
+        return false;
+    }
+    http2_frame_with_offset current_frame = tail_call_state->frames_array[tail_call_state->iteration];
+    tail_call_state->iteration += 1;
+
+    if (current_frame.frame.type != kHeadersFrame) {
+        return true;
+    }
+
+    http2_ctx->http2_stream_key.stream_id = current_frame.frame.stream_id;
+    http2_stream_t *current_stream = http2_fetch_stream(&http2_ctx->http2_stream_key);
+    if (current_stream == NULL) {
+        return true;
+    }
+    pktbuf_set_offset(pkt, current_frame.offset);
+    current_stream->tags |= tags;
+    process_headers_frame(pkt, current_stream, tup, &http2_ctx->dynamic_index, &current_frame.frame, http2_tel);
+    return true;
+}
+
+// has_headers_frames_left returns true if there are frames left to be parsed by another call of the headers parser,
+// which parses up to `max_frames` frames over all its calls.
+static __always_inline bool has_headers_frames_left(http2_tail_call_state_t *tail_call_state, __u32 max_frames) {
+    return tail_call_state->iteration < HTTP2_MAX_FRAMES_ITERATIONS &&
+           tail_call_state->iteration < tail_call_state->frames_count &&
+           tail_call_state->iteration < max_frames;
+}
+
+// handle_eos_frame finalizes the stream of the frame if the frame marks its end, and enqueues it.
+static __always_inline void handle_eos_frame(http2_frame_with_offset *current_frame, http2_ctx_t *http2_ctx, http2_telemetry_t *http2_tel) {
+    const bool is_rst = current_frame->frame.type == kRSTStreamFrame;
+    const bool is_end_of_stream = (current_frame->frame.flags & HTTP2_END_OF_STREAM) == HTTP2_END_OF_STREAM;
+    if (!is_rst && !is_end_of_stream) {
+        return;
+    }
+
+    http2_ctx->http2_stream_key.stream_id = current_frame->frame.stream_id;
+    // A new stream must start with a request, so if it does not exist, we should not process it.
+    http2_stream_t *current_stream = bpf_map_lookup_elem(&http2_in_flight, &http2_ctx->http2_stream_key);
+    if (current_stream == NULL) {
+        return;
+    }
+
+    // When we accept an RST, it means that the current stream is terminated.
+    // See: https://datatracker.ietf.org/doc/html/rfc7540#section-6.4
+    // If rst, and stream is empty (no status code, or no response) then delete from inflight
+    if (is_rst && (!current_stream->status_code.finalized || !current_stream->request_method.finalized || !current_stream->path.finalized)) {
+        bpf_map_delete_elem(&http2_in_flight, &http2_ctx->http2_stream_key);
+        return;
+    }
+
+    if (is_rst) {
+        __sync_fetch_and_add(&http2_tel->end_of_stream_rst, 1);
+    } else {
+        __sync_fetch_and_add(&http2_tel->end_of_stream, 1);
+    }
+    handle_end_of_stream(current_stream, &http2_ctx->http2_stream_key, http2_tel);
+
+    // If we reached here, it means that we saw End Of Stream. If the End of Stream came from a request,
+    // thus we except it to have a valid path and method. If the End of Stream came from a response, we except it to
+    // be after seeing a request, thus it should have a path and method as well.
+    if ((!current_stream->path.finalized) || (!current_stream->request_method.finalized)) {
+        bpf_map_delete_elem(&http2_in_flight, &http2_ctx->http2_stream_key);
+    }
+}
+
+static __always_inline void init_eos_ctx(conn_tuple_t *tup, http2_ctx_t *http2_ctx) {
+    bpf_memset(http2_ctx, 0, sizeof(http2_ctx_t));
+    http2_ctx->http2_stream_key.tup = *tup;
+    normalize_tuple(&http2_ctx->http2_stream_key.tup);
+}
+
+// parse_eos_frames handles the frames marking the end of a stream found by the frames filter, up to
+// HTTP2_MAX_FRAMES_FOR_EOS_PARSER_PER_TAIL_CALL frames per call, and enqueues the streams that ended.
+// It returns true if there are frames left to be handled by another call of the EOS parser.
+static __always_inline bool parse_eos_frames(conn_tuple_t *tup, http2_tail_call_state_t *tail_call_state, http2_ctx_t *http2_ctx, http2_telemetry_t *http2_tel) {
+    http2_frame_with_offset *frames_array = tail_call_state->frames_array;
+    http2_frame_with_offset current_frame;
+
+    init_eos_ctx(tup, http2_ctx);
+
+    #pragma unroll(HTTP2_MAX_FRAMES_FOR_EOS_PARSER_PER_TAIL_CALL)
+    for (__u16 index = 0; index < HTTP2_MAX_FRAMES_FOR_EOS_PARSER_PER_TAIL_CALL; index++) {
+        if (tail_call_state->iteration >= HTTP2_MAX_FRAMES_ITERATIONS) {
+            break;
+        }
+
+        current_frame = frames_array[tail_call_state->iteration];
+        // Having this condition after assignment and not before is due to a verifier issue.
+        if (tail_call_state->iteration >= tail_call_state->frames_count) {
+            break;
+        }
+        tail_call_state->iteration += 1;
+
+        handle_eos_frame(&current_frame, http2_ctx, http2_tel);
+    }
+
+    return tail_call_state->iteration < HTTP2_MAX_FRAMES_ITERATIONS &&
+           tail_call_state->iteration < tail_call_state->frames_count &&
+           tail_call_state->iteration < HTTP2_MAX_FRAMES_FOR_EOS_PARSER;
+}
+
+// The state shared by the iterations of parse_eos_frames_loop.
+typedef struct {
+    http2_tail_call_state_t *tail_call_state;
+    http2_ctx_t *http2_ctx;
+    http2_telemetry_t *http2_tel;
+} http2_eos_loop_ctx_t;
+
+// The bpf_loop callback of parse_eos_frames_loop, handling a single frame. Returns 1 to stop the loop.
+static long parse_eos_frame_callback(__u32 index, void *data) {
+    http2_eos_loop_ctx_t *loop_ctx = data;
+    http2_tail_call_state_t *tail_call_state = loop_ctx->tail_call_state;
+
+    const __u16 iteration = tail_call_state->iteration;
+    if (iteration >= HTTP2_MAX_FRAMES_ITERATIONS || iteration >= tail_call_state->frames_count) {
+        return 1;
+    }
+    http2_frame_with_offset current_frame = tail_call_state->frames_array[iteration];
+    tail_call_state->iteration = iteration + 1;
+
+    handle_eos_frame(&current_frame, loop_ctx->http2_ctx, loop_ctx->http2_tel);
+    return 0;
+}
+
+// parse_eos_frames_loop is the variant of parse_eos_frames for the kernels having bpf_loop (5.17+). The loop runs
+// in a callback verified once, so all the frames found by the frames filter are handled in a single program,
+// without the self tail calls and the lookups of the state they require.
+static __always_inline void parse_eos_frames_loop(conn_tuple_t *tup, http2_tail_call_state_t *tail_call_state, http2_ctx_t *http2_ctx, http2_telemetry_t *http2_tel) {
+    init_eos_ctx(tup, http2_ctx);
+
+    http2_eos_loop_ctx_t loop_ctx = {
+        .tail_call_state = tail_call_state,
+        .http2_ctx = http2_ctx,
+        .http2_tel = http2_tel,
+    };
+    bpf_loop(HTTP2_MAX_FRAMES_ITERATIONS, parse_eos_frame_callback, &loop_ctx, 0);
+}
+
 #endif
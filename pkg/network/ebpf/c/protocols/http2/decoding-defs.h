@@ -46,16 +46,15 @@
 // A limit of max pseudo headers which we process in the request/response.
 #define HTTP2_MAX_PSEUDO_HEADERS_COUNT_FOR_FILTERING 4
 
-// Threshold to to trigger the dynamic table cleanup.
-#define HTTP2_DYNAMIC_TABLE_CLEANUP_THRESHOLD 200
-// Represents the maximum number of dynamic_table entries to clean up in a single tail call.
-// This number is above the HTTP2_DYNAMIC_TABLE_CLEANUP_THRESHOLD to ensure that we clean up all entries, and not missing
-// anything.
-#define HTTP2_DYNAMIC_TABLE_CLEANUP_ITERATIONS 300
+// The number of entries of the dynamic table kept per connection. The table of a connection is a ring indexed by
+// the dynamic counter, so that a new entry evicts the oldest one like HPACK does. It holds the 128 entries of
+// the default 4KB table at least, as an entry takes 32 bytes of the table on top of its name and value.
+#define HTTP2_DYNAMIC_TABLE_SLOTS 256
+_Static_assert((HTTP2_DYNAMIC_TABLE_SLOTS & (HTTP2_DYNAMIC_TABLE_SLOTS - 1)) == 0, "HTTP2_DYNAMIC_TABLE_SLOTS must be a power of 2");
 
 
 // Per request or response we have fewer headers than HTTP2_MAX_HEADERS_COUNT_FOR_FILTERING that are interesting us.
-// For request - those are method, path. For response - status code.
+// For request - those are method, path. For response - status code, and grpc-status for the trailers.
 // Thus differentiating between the limits can allow reducing code size.
 #define HTTP2_MAX_HEADERS_COUNT_FOR_PROCESSING 2
 
@@ -98,6 +97,20 @@
 
 #define HTTP2_CONTENT_TYPE_IDX 31
 
+// The name of the grpc-status header sent in the trailers of the gRPC responses, which is not part of the static
+// table. The encoders Huffman-encode it, as its encoded form is shorter.
+#define GRPC_STATUS_HEADER_NAME "grpc-status"
+#define GRPC_STATUS_HEADER_NAME_LEN (sizeof(GRPC_STATUS_HEADER_NAME) - 1)
+#define GRPC_ENCODED_STATUS_HEADER_NAME "\x9a\xca\xc8\xb2\x12\x34\xda\x8f"
+#define GRPC_ENCODED_STATUS_HEADER_NAME_LEN (sizeof(GRPC_ENCODED_STATUS_HEADER_NAME) - 1)
+
+// The index given to the grpc-status headers in place of their static table index, as their name has none. It is
+// out of the range of the static table indexes.
+#define HTTP2_GRPC_STATUS_PSEUDO_INDEX 0x100
+
+// The gRPC status codes range from 0 to 16, so the raw and Huffman-encoded values are up to 2 bytes long.
+#define HTTP2_GRPC_STATUS_MAX_LEN 2
+
 #define MAX_FRAME_SIZE 16384
 
 typedef enum {
@@ -118,6 +131,8 @@ typedef enum {
 
 typedef struct {
     char buffer[HTTP2_MAX_PATH_LEN] __attribute__((aligned(8)));
+    // The dynamic counter of the entry, telling it from the older entries of its slot.
+    __u64 index;
     __u32 original_index;
     __u8 string_len;
     bool is_huffman_encoded;
@@ -165,6 +180,14 @@ typedef struct {
     bool finalized;
 } path_t;
 
+typedef struct {
+    __u8 raw_buffer[HTTP2_GRPC_STATUS_MAX_LEN];
+    __u8 length;
+    bool is_huffman_encoded;
+
+    bool finalized;
+} grpc_status_code_t;
+
 typedef struct {
     __u64 response_last_seen;
     __u64 request_started;
@@ -173,6 +196,8 @@ typedef struct {
     status_code_t status_code;
     method_t request_method;
     path_t path;
+    // The status of the gRPC call, read from the grpc-status trailer of the response.
+    grpc_status_code_t grpc_status;
     bool end_of_stream_seen;
 } http2_stream_t;
 
@@ -213,6 +238,11 @@ typedef struct {
     // Maintains the count of executions performed by the filter program.
     // Its purpose is to restrict the usage of tail calls within the filter program.
     __u16 filter_iterations;
+    // The number of HEADERS frames and of frames ending a stream (END_STREAM flag or RST_STREAM) among the
+    // frames_count frames. They let the filter and the headers parser skip the parser with nothing to do, which is
+    // the common case of DATA-heavy streams.
+    __u16 headers_frames_count;
+    __u16 eos_frames_count;
     // Saving the data offset is crucial for maintaining the current read position and ensuring proper utilization
     // of tail calls.
     __u32 data_off;
@@ -248,7 +278,6 @@ typedef struct {
 
 typedef struct {
     __u64 value;
-    __u64 previous;
 } dynamic_counter_t;
 
 #endif
@@ -6,13 +6,12 @@
 // packet, to the current one.
 BPF_HASH_MAP(http2_remainder, conn_tuple_t, frame_header_remainder_t, 0)
 
-/* http2_dynamic_table is the map that holding the supported dynamic values - the index is the static index and the
-   conn tuple and it is value is the buffer which contains the dynamic string. */
+/* http2_dynamic_table is the map that holding the supported dynamic values - the index is the slot of the entry in the
+   ring of the connection (see HTTP2_DYNAMIC_TABLE_SLOTS) and the conn tuple, and its value is the buffer which contains
+   the dynamic string. */
 BPF_HASH_MAP(http2_dynamic_table, dynamic_table_index_t, dynamic_table_entry_t, 0)
 
-// A map between a stream (connection and a stream id) to the current global dynamic counter.
-// The value also a field called "previous" which is used to cache the last index we've cleaned during our cleanup
-// tail calls.
+// A map between a connection to the current global dynamic counter.
 BPF_HASH_MAP(http2_dynamic_counter_table, conn_tuple_t, dynamic_counter_t, 0)
 
 /* This map is used to keep track of in-flight HTTP2 transactions for each TCP connection */
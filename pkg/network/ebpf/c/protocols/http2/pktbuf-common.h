@@ -1,11 +1,19 @@
-#ifndef __HTTP2_SKB_COMMON_H
-#define __HTTP2_SKB_COMMON_H
+#ifndef __HTTP2_PKTBUF_COMMON_H
+#define __HTTP2_PKTBUF_COMMON_H
 
+#include "bpf_builtins.h"
+
+#include "protocols/classification/structs.h"
+#include "protocols/helpers/pktbuf.h"
+#include "protocols/http2/decoding-defs.h"
 #include "protocols/http2/helpers.h"
 
+// The helpers below read the HTTP2 payload through the pktbuf abstraction, so that they are shared by the socket
+// filter (plain text) decoder, the uprobes (TLS) decoder and the gRPC classification.
+
 // Similar to read_hpack_int, but with a small optimization of getting the
 // current character as input argument.
-static __always_inline bool read_hpack_int_with_given_current_char(struct __sk_buff *skb, skb_info_t *skb_info, __u64 current_char_as_number, __u64 max_number_for_bits, __u64 *out) {
+static __always_inline bool read_hpack_int_with_given_current_char(pktbuf_t pkt, pktbuf_window_t *window, __u64 current_char_as_number, __u64 max_number_for_bits, __u64 *out) {
     current_char_as_number &= max_number_for_bits;
 
     // In HPACK, if the number is too big to be stored in max_number_for_bits
@@ -21,9 +29,9 @@ static __always_inline bool read_hpack_int_with_given_current_char(struct __sk_b
     // number of instructions we can use in a single eBPF program, so we only
     // parse one additional byte. The max value that can be parsed is
     // `(2^max_number_for_bits - 1) + 127`.
-    __u64 next_char = 0;
-    if (bpf_skb_load_bytes(skb, skb_info->data_off, &next_char, 1) >= 0 && (next_char & 128) == 0) {
-        skb_info->data_off++;
+    __u8 next_char = 0;
+    if (pktbuf_window_load_byte(pkt, window, pktbuf_data_offset(pkt), &next_char) && (next_char & 128) == 0) {
+        pktbuf_advance(pkt, 1);
         *out = current_char_as_number + (next_char & 127);
         return true;
     }
@@ -32,7 +40,7 @@ static __always_inline bool read_hpack_int_with_given_current_char(struct __sk_b
 }
 
 // read_hpack_int reads an unsigned variable length integer as specified in the
-// HPACK specification, from an skb.
+// HPACK specification, from a packet buffer.
 //
 // See https://httpwg.org/specs/rfc7541.html#rfc.section.5.1 for more details on
 // how numbers are represented in HPACK.
@@ -40,63 +48,68 @@ static __always_inline bool read_hpack_int_with_given_current_char(struct __sk_b
 // max_number_for_bits represents the number of bits in the first byte that are
 // used to represent the MSB of number. It must always be between 1 and 8.
 //
-// The parsed number is stored in out.
+// The parsed number is stored in out. The bytes are read through `window`, shared by the callers walking the
+// headers of a frame.
 //
 // read_hpack_int returns true if the integer was successfully parsed, and false
 // otherwise.
-static __always_inline bool read_hpack_int(struct __sk_buff *skb, skb_info_t *skb_info, __u64 max_number_for_bits, __u64 *out, bool *is_huffman_encoded) {
-    __u64 current_char_as_number = 0;
-    if (bpf_skb_load_bytes(skb, skb_info->data_off, &current_char_as_number, 1) < 0) {
+static __always_inline bool read_hpack_int(pktbuf_t pkt, pktbuf_window_t *window, __u64 max_number_for_bits, __u64 *out, bool *is_huffman_encoded) {
+    __u8 current_char_as_number = 0;
+    if (!pktbuf_window_load_byte(pkt, window, pktbuf_data_offset(pkt), &current_char_as_number)) {
         return false;
     }
-    skb_info->data_off++;
+    pktbuf_advance(pkt, 1);
     // We are only interested in the first bit of the first byte, which indicates if it is huffman encoded or not.
     // See: https://datatracker.ietf.org/doc/html/rfc7541#appendix-B for more details on huffman code.
     *is_huffman_encoded = (current_char_as_number & 128) > 0;
 
-    return read_hpack_int_with_given_current_char(skb, skb_info, current_char_as_number, max_number_for_bits, out);
+    return read_hpack_int_with_given_current_char(pkt, window, current_char_as_number, max_number_for_bits, out);
 }
 
 // Handles a literal header, and updates the offset. This function is meant to run on not interesting literal headers.
-static __always_inline bool process_and_skip_literal_headers(struct __sk_buff *skb, skb_info_t *skb_info, __u64 index) {
+static __always_inline bool process_and_skip_literal_headers(pktbuf_t pkt, pktbuf_window_t *window, __u64 index) {
     __u64 str_len = 0;
     bool is_huffman_encoded = false;
     // String length supposed to be represented with at least 7 bits representation -https://datatracker.ietf.org/doc/html/rfc7541#section-5.2
-    if (!read_hpack_int(skb, skb_info, MAX_7_BITS, &str_len, &is_huffman_encoded)) {
+    if (!read_hpack_int(pkt, window, MAX_7_BITS, &str_len, &is_huffman_encoded)) {
         return false;
     }
 
     // The header name is new and inserted in the dynamic table - we skip the new value.
     if (index == 0) {
-        skb_info->data_off += str_len;
+        pktbuf_advance(pkt, str_len);
         str_len = 0;
         // String length supposed to be represented with at least 7 bits representation -https://datatracker.ietf.org/doc/html/rfc7541#section-5.2
         // At this point the huffman code is not interesting due to the fact that we already read the string length,
         // We are reading the current size in order to skip it.
-        if (!read_hpack_int(skb, skb_info, MAX_7_BITS, &str_len, &is_huffman_encoded)) {
+        if (!read_hpack_int(pkt, window, MAX_7_BITS, &str_len, &is_huffman_encoded)) {
             return false;
         }
     }
-    skb_info->data_off += str_len;
+    pktbuf_advance(pkt, str_len);
     return true;
 }
 
 // handle_dynamic_table_update handles the dynamic table size update.
-static __always_inline void handle_dynamic_table_update(struct __sk_buff *skb, skb_info_t *restrict skb_info){
+static __always_inline void handle_dynamic_table_update(pktbuf_t pkt, pktbuf_window_t *window){
     // To determine the size of the dynamic table update, we read an integer representation byte by byte.
     // We continue reading bytes until we encounter a byte without the Most Significant Bit (MSB) set,
     // indicating that we've consumed the complete integer. While in the context of the dynamic table
     // update, we set the state as true if the MSB is set, and false otherwise. Then, we proceed to the next byte.
     // More on the feature - https://httpwg.org/specs/rfc7541.html#rfc.section.6.3.
-    __u8 current_ch;
-    bpf_skb_load_bytes(skb, skb_info->data_off, &current_ch, sizeof(current_ch));
+    __u8 current_ch = 0;
+    if (!pktbuf_window_load_byte(pkt, window, pktbuf_data_offset(pkt), &current_ch)) {
+        return;
+    }
     // If the top 3 bits are 001, then we have a dynamic table size update.
     if ((current_ch & 224) == 32) {
-        skb_info->data_off++;
+        pktbuf_advance(pkt, 1);
     #pragma unroll(HTTP2_MAX_DYNAMIC_TABLE_UPDATE_ITERATIONS)
         for (__u8 iter = 0; iter < HTTP2_MAX_DYNAMIC_TABLE_UPDATE_ITERATIONS; ++iter) {
-            bpf_skb_load_bytes(skb, skb_info->data_off, &current_ch, sizeof(current_ch));
-            skb_info->data_off++;
+            if (!pktbuf_window_load_byte(pkt, window, pktbuf_data_offset(pkt), &current_ch)) {
+                return;
+            }
+            pktbuf_advance(pkt, 1);
             if ((current_ch & 128) == 0) {
                 return;
             }
@@ -106,12 +119,12 @@ static __always_inline void handle_dynamic_table_update(struct __sk_buff *skb, s
 
 // skip_preface is a helper function to check for the HTTP2 magic sent at the beginning
 // of an HTTP2 connection, and skip it if present.
-static __always_inline void skip_preface(struct __sk_buff *skb, skb_info_t *skb_info) {
+static __always_inline void skip_preface(pktbuf_t pkt) {
     char preface[HTTP2_MARKER_SIZE];
     bpf_memset((char *)preface, 0, HTTP2_MARKER_SIZE);
-    bpf_skb_load_bytes(skb, skb_info->data_off, preface, HTTP2_MARKER_SIZE);
+    pktbuf_load_bytes(pkt, pktbuf_data_offset(pkt), preface, HTTP2_MARKER_SIZE);
     if (is_http2_preface(preface, HTTP2_MARKER_SIZE)) {
-        skb_info->data_off += HTTP2_MARKER_SIZE;
+        pktbuf_advance(pkt, HTTP2_MARKER_SIZE);
     }
 }
 
@@ -2,16 +2,29 @@
 #define __KAFKA_DEFS_H
 
 // Reference: https://kafka.apache.org/protocol.html#protocol_messages
-#define KAFKA_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION 12
+#define KAFKA_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION 16
 #define KAFKA_MAX_SUPPORTED_PRODUCE_REQUEST_API_VERSION 8
 
 #define KAFKA_MIN_LENGTH (sizeof(kafka_header_t))
 #define CLIENT_ID_SIZE_TO_VALIDATE 30
+// Rounded up to a multiple of 8 bytes so that the client id can be hashed a word at a time.
+#define CLIENT_ID_BUFFER_SIZE 32
 #define TOPIC_NAME_MAX_STRING_SIZE_TO_VALIDATE 48 // 16 * 3. Must be a factor of 16, otherwise a verifier issue can pop in kernel 4.14.
 #define TOPIC_NAME_MAX_ALLOWED_SIZE 255
 
 #define TOPIC_NAME_MAX_STRING_SIZE 80
 
+// The number of distinct topic names kept in the kafka_topic_names map.
+#define KAFKA_MAX_TOPIC_NAMES 1024
+
+// FNV-1a parameters of the topic name hash.
+#define KAFKA_TOPIC_NAME_HASH_OFFSET_BASIS 14695981039346656037ULL
+#define KAFKA_TOPIC_NAME_HASH_PRIME 1099511628211ULL
+
+// Starting with fetch v13, the topics are identified by their UUID rather than their name.
+#define KAFKA_MIN_FETCH_API_VERSION_WITH_TOPIC_ID 13
+#define KAFKA_TOPIC_ID_SIZE 16
+
 // The number of varint bytes required to support the specified values.
 // 127
 #define VARINT_BYTES_0000007f   1
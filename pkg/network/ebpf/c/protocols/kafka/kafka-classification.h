@@ -44,29 +44,42 @@ _Pragma( STRINGIFY(unroll(max_buffer_size)) )
     CHECK_STRING_COMPOSED_OF_ASCII(max_buffer_size, real_size, buffer, true)
 
 
-// Reads the client id (up to CLIENT_ID_SIZE_TO_VALIDATE bytes from the given offset), and verifies if it is valid,
-// namely, composed only from characters from [a-zA-Z0-9._-].
-static __always_inline bool is_valid_client_id(pktbuf_t pkt, u32 offset, u16 real_client_id_size) {
+// Reads the client id (up to CLIENT_ID_SIZE_TO_VALIDATE bytes from the given offset) into the per-cpu buffer.
+static __always_inline char *read_client_id(pktbuf_t pkt, u32 offset) {
     const u32 key = 0;
     // Fetch the client id buffer from per-cpu array, which gives us the ability to extend the size of the buffer,
     // as the stack is limited with the number of bytes we can allocate on.
     char *client_id = bpf_map_lookup_elem(&kafka_client_id, &key);
     if (client_id == NULL) {
-        return false;
+        return NULL;
     }
-    bpf_memset(client_id, 0, CLIENT_ID_SIZE_TO_VALIDATE);
+    bpf_memset(client_id, 0, CLIENT_ID_BUFFER_SIZE);
     pktbuf_load_bytes_with_telemetry(pkt, offset, (char *)client_id, CLIENT_ID_SIZE_TO_VALIDATE);
+    return client_id;
+}
 
-    // Returns true if client_id is composed out of the characters [a-z], [A-Z], [0-9], ".", "_", or "-".
+// Returns true if client_id is composed out of the characters [a-z], [A-Z], [0-9], ".", "_", or "-".
+static __always_inline bool is_valid_client_id_string(const char *client_id, u16 real_client_id_size) {
     CHECK_STRING_VALID_CLIENT_ID(CLIENT_ID_SIZE_TO_VALIDATE, real_client_id_size, client_id);
 }
 
+// Reads the client id (up to CLIENT_ID_SIZE_TO_VALIDATE bytes from the given offset), and verifies if it is valid,
+// namely, composed only from characters from [a-zA-Z0-9._-].
+static __always_inline bool is_valid_client_id(pktbuf_t pkt, u32 offset, u16 real_client_id_size) {
+    char *client_id = read_client_id(pkt, offset);
+    if (client_id == NULL) {
+        return false;
+    }
+
+    return is_valid_client_id_string(client_id, real_client_id_size);
+}
+
 // Checks the given kafka header represents a valid one.
 // 1. The message size should include the size of the header.
 // 2. The api key is FETCH or PRODUCE.
 // 3. The api version is not negative.
 // 4. The version of a PRODUCE message is not 0 or bigger than 8.
-// 5. The version of a FETCH message is not bigger than 11.
+// 5. The version of a FETCH message is not bigger than 16.
 // 6. Correlation ID is not negative.
 // 7. The client ID size if not negative.
 static __always_inline bool is_valid_kafka_request_header(const kafka_header_t *kafka_header) {
@@ -81,7 +94,7 @@ static __always_inline bool is_valid_kafka_request_header(const kafka_header_t *
     switch (kafka_header->api_key) {
     case KAFKA_FETCH:
         if (kafka_header->api_version > KAFKA_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION) {
-            // Fetch request version 13 and above is not supported.
+            // Fetch request version 17 and above is not supported.
             return false;
         }
         break;
@@ -228,6 +241,21 @@ static __always_inline bool validate_first_topic_name(pktbuf_t pkt, bool flexibl
     CHECK_STRING_VALID_TOPIC_NAME(TOPIC_NAME_MAX_STRING_SIZE_TO_VALIDATE, topic_name_size, topic_name);
 }
 
+// Reads the first topic ID (can be multiple) of a fetch v13+ request from the given offset, and verifies it is not
+// the zero UUID, which Kafka reserves for unknown topics.
+static __always_inline bool validate_first_topic_id(pktbuf_t pkt, u32 offset) {
+    if (!skip_varint_number_of_topics(pkt, &offset)) {
+        return false;
+    }
+
+    __u64 topic_id[KAFKA_TOPIC_ID_SIZE / sizeof(__u64)] = {0};
+    if (pktbuf_load_bytes(pkt, offset, topic_id, KAFKA_TOPIC_ID_SIZE) < 0) {
+        return false;
+    }
+
+    return topic_id[0] != 0 || topic_id[1] != 0;
+}
+
 // Getting the offset (out parameter) of the first topic name in the produce request.
 static __always_inline bool get_topic_offset_from_produce_request(const kafka_header_t *kafka_header, pktbuf_t pkt, u32 *out_offset) {
     const s16 api_version = kafka_header->api_version;
@@ -280,10 +308,14 @@ static __always_inline bool get_topic_offset_from_fetch_request(const kafka_head
         }
     }
 
-    // replica_id => INT32
+    if (api_version < 15) {
+        // replica_id => INT32, moved to the replica_state tagged field in v15.
+        *offset += sizeof(s32);
+    }
+
     // max_wait_ms => INT32
     // min_bytes => INT32
-    *offset += 3 * sizeof(s32);
+    *offset += 2 * sizeof(s32);
 
     if (api_version >= 3) {
         // max_bytes => INT32
@@ -318,6 +350,9 @@ static __always_inline bool is_kafka_request(const kafka_header_t *kafka_header,
         if (!get_topic_offset_from_fetch_request(kafka_header, pkt, &offset)) {
             return false;
         }
+        if (kafka_header->api_version >= KAFKA_MIN_FETCH_API_VERSION_WITH_TOPIC_ID) {
+            return validate_first_topic_id(pkt, offset);
+        }
         flexible = kafka_header->api_version >= 12;
         break;
     default:
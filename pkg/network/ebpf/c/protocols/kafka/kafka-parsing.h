@@ -3,6 +3,7 @@
 
 #include "bpf_builtins.h"
 #include "bpf_telemetry.h"
+#include "protocols/cpu-cost.h"
 #include "protocols/kafka/types.h"
 #include "protocols/kafka/parsing-maps.h"
 #include "protocols/kafka/usm-events.h"
@@ -40,14 +41,15 @@ _Pragma( STRINGIFY(unroll(max_buffer_size)) )
 static void __always_inline kafka_tcp_termination(conn_tuple_t *tup)
 {
     bpf_map_delete_elem(&kafka_response, tup);
+    bpf_map_delete_elem(&kafka_client_ids, tup);
     // Delete the opposite direction also like HTTP/2 does since the termination
     // for the other direction may not be reached in some cases (localhost).
     flip_tuple(tup);
     bpf_map_delete_elem(&kafka_response, tup);
+    bpf_map_delete_elem(&kafka_client_ids, tup);
 }
 
-SEC("socket/kafka_filter")
-int socket__kafka_filter(struct __sk_buff* skb) {
+static __always_inline int __socket__kafka_filter(struct __sk_buff* skb) {
     const u32 zero = 0;
     skb_info_t skb_info;
     kafka_info_t *kafka = bpf_map_lookup_elem(&kafka_heap, &zero);
@@ -91,8 +93,14 @@ int socket__kafka_filter(struct __sk_buff* skb) {
     return 0;
 }
 
-SEC("uprobe/kafka_tls_filter")
-int uprobe__kafka_tls_filter(struct pt_regs *ctx) {
+SEC("socket/kafka_filter")
+int socket__kafka_filter(struct __sk_buff* skb) {
+    const int ret = __socket__kafka_filter(skb);
+    usm_cpu_cost_end();
+    return ret;
+}
+
+static __always_inline int __uprobe__kafka_tls_filter(struct pt_regs *ctx) {
     const __u32 zero = 0;
 
     kafka_info_t *kafka = bpf_map_lookup_elem(&kafka_heap, &zero);
@@ -123,8 +131,14 @@ int uprobe__kafka_tls_filter(struct pt_regs *ctx) {
     return 0;
 }
 
-SEC("uprobe/kafka_tls_termination")
-int uprobe__kafka_tls_termination(struct pt_regs *ctx) {
+SEC("uprobe/kafka_tls_filter")
+int uprobe__kafka_tls_filter(struct pt_regs *ctx) {
+    const int ret = __uprobe__kafka_tls_filter(ctx);
+    usm_cpu_cost_end();
+    return ret;
+}
+
+static __always_inline int __uprobe__kafka_tls_termination(struct pt_regs *ctx) {
     const __u32 zero = 0;
 
     tls_dispatcher_arguments_t *args = bpf_map_lookup_elem(&tls_dispatcher_arguments, &zero);
@@ -139,9 +153,54 @@ int uprobe__kafka_tls_termination(struct pt_regs *ctx) {
     return 0;
 }
 
+SEC("uprobe/kafka_tls_termination")
+int uprobe__kafka_tls_termination(struct pt_regs *ctx) {
+    const int ret = __uprobe__kafka_tls_termination(ctx);
+    usm_cpu_cost_end();
+    return ret;
+}
+
 PKTBUF_READ_INTO_BUFFER(topic_name_parser, TOPIC_NAME_MAX_STRING_SIZE, BLK_SIZE)
 
+static __always_inline bool is_kafka_in_kernel_aggregation_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("kafka_in_kernel_aggregation", val);
+    return val > 0;
+}
+
+// kafka_aggregate_transaction adds the transaction to the stats of its connection, topic, API key and version.
+// Returns false if the kafka_aggregated_stats map is full, in which case the transaction is sent as an event.
+static __always_inline bool kafka_aggregate_transaction(kafka_info_t *kafka, conn_tuple_t *tup, kafka_transaction_t *transaction) {
+    // The key lives in the per-CPU heap as its padding must be zeroed, and the stack of the parsers is tight.
+    kafka_aggregation_key_t *key = &kafka->aggregation_key;
+    bpf_memset(key, 0, sizeof(kafka_aggregation_key_t));
+    bpf_memcpy(&key->tup, tup, sizeof(conn_tuple_t));
+    normalize_tuple(&key->tup);
+    key->topic_name_hash = transaction->topic_name_hash;
+    key->request_api_key = transaction->request_api_key;
+    key->request_api_version = transaction->request_api_version;
+    key->topic_name_size = transaction->topic_name_size;
+
+    kafka_aggregated_stats_t *stats = bpf_map_lookup_elem(&kafka_aggregated_stats, key);
+    if (stats == NULL) {
+        const kafka_aggregated_stats_t empty_stats = {};
+        bpf_map_update_elem(&kafka_aggregated_stats, key, &empty_stats, BPF_NOEXIST);
+        stats = bpf_map_lookup_elem(&kafka_aggregated_stats, key);
+        if (stats == NULL) {
+            return false;
+        }
+    }
+
+    __sync_fetch_and_add(&stats->requests_count, 1);
+    __sync_fetch_and_add(&stats->records_count, transaction->records_count);
+    return true;
+}
+
 static __always_inline void kafka_batch_enqueue_wrapper(kafka_info_t *kafka, conn_tuple_t *tup, kafka_transaction_t *transaction) {
+    if (is_kafka_in_kernel_aggregation_enabled() && kafka_aggregate_transaction(kafka, tup, transaction)) {
+        return;
+    }
+
     kafka_event_t *event = &kafka->event;
 
     bpf_memcpy(&event->tup, tup, sizeof(conn_tuple_t));
@@ -154,6 +213,78 @@ static __always_inline void kafka_batch_enqueue_wrapper(kafka_info_t *kafka, con
     kafka_batch_enqueue(event);
 }
 
+// kafka_topic_name_hash returns the FNV-1a hash of the topic name, computed over 8 bytes words rather than bytes to
+// save instructions. The buffer isn't zeroed past the end of the name, so the last word is masked, assuming a little
+// endian host.
+static __always_inline __u64 kafka_topic_name_hash(kafka_topic_name_t *topic_name) {
+    const __u64 *words = (const __u64 *)topic_name->topic_name;
+    const __u32 size = topic_name->topic_name_size;
+    __u64 hash = KAFKA_TOPIC_NAME_HASH_OFFSET_BASIS ^ size;
+
+#pragma unroll
+    for (__u32 i = 0; i < TOPIC_NAME_MAX_STRING_SIZE / sizeof(__u64); i++) {
+        const __u32 word_offset = i * sizeof(__u64);
+        if (word_offset >= size) {
+            break;
+        }
+        __u64 word = words[i];
+        const __u32 remaining = size - word_offset;
+        if (remaining < sizeof(__u64)) {
+            word &= (1ULL << (remaining * 8)) - 1;
+        }
+        hash ^= word;
+        hash *= KAFKA_TOPIC_NAME_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+// kafka_client_id_hash hashes the first CLIENT_ID_SIZE_TO_VALIDATE bytes of the client id and its size the same
+// way kafka_topic_name_hash does.
+static __always_inline __u64 kafka_client_id_hash(const char *client_id, __u16 real_client_id_size) {
+    const __u64 *words = (const __u64 *)client_id;
+    const __u32 size = real_client_id_size < CLIENT_ID_SIZE_TO_VALIDATE ? real_client_id_size : CLIENT_ID_SIZE_TO_VALIDATE;
+    __u64 hash = KAFKA_TOPIC_NAME_HASH_OFFSET_BASIS ^ real_client_id_size;
+
+#pragma unroll
+    for (__u32 i = 0; i < CLIENT_ID_BUFFER_SIZE / sizeof(__u64); i++) {
+        const __u32 word_offset = i * sizeof(__u64);
+        if (word_offset >= size) {
+            break;
+        }
+        __u64 word = words[i];
+        const __u32 remaining = size - word_offset;
+        if (remaining < sizeof(__u64)) {
+            word &= (1ULL << (remaining * 8)) - 1;
+        }
+        hash ^= word;
+        hash *= KAFKA_TOPIC_NAME_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+// Clients send the same client id on every request of a connection, so once it was found valid its hash is kept
+// in kafka_client_ids and the following requests only compare hashes instead of checking every character.
+static __always_inline bool is_valid_client_id_cached(conn_tuple_t *tup, pktbuf_t pkt, u32 offset, u16 real_client_id_size) {
+    char *client_id = read_client_id(pkt, offset);
+    if (client_id == NULL) {
+        return false;
+    }
+
+    __u64 hash = kafka_client_id_hash(client_id, real_client_id_size);
+    __u64 *cached_hash = bpf_map_lookup_elem(&kafka_client_ids, tup);
+    if (cached_hash != NULL && *cached_hash == hash) {
+        return true;
+    }
+
+    if (!is_valid_client_id_string(client_id, real_client_id_size)) {
+        return false;
+    }
+    bpf_map_update_elem(&kafka_client_ids, tup, &hash, BPF_ANY);
+    return true;
+}
+
 enum parse_result {
     // End of packet. This packet parsed successfully, but more data is needed
     // for the response to be completed.
@@ -548,7 +679,9 @@ static __always_inline enum parse_result kafka_continue_parse_response_partition
         // fallthrough
 
     case KAFKA_FETCH_RESPONSE_TOPIC_NAME_SIZE:
-        {
+        if (api_version >= KAFKA_MIN_FETCH_API_VERSION_WITH_TOPIC_ID) {
+            offset += KAFKA_TOPIC_ID_SIZE; // Skip topic_id
+        } else {
             s64 topic_name_size = 0;
             ret = read_varint_or_s16(flexible, response, pkt, &offset, data_end, &topic_name_size, true,
                                      VARINT_BYTES_TOPIC_NAME_SIZE);
@@ -1207,22 +1340,30 @@ static __always_inline int __socket__kafka_response_parser(struct __sk_buff *skb
 
 SEC("socket/kafka_response_partition_parser_v0")
 int socket__kafka_response_partition_parser_v0(struct __sk_buff *skb) {
-    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 0, 11);
+    const int ret = __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 0, 11);
+    usm_cpu_cost_end();
+    return ret;
 }
 
 SEC("socket/kafka_response_partition_parser_v12")
 int socket__kafka_response_partition_parser_v12(struct __sk_buff *skb) {
-    return __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 12, 12);
+    const int ret = __socket__kafka_response_parser(skb, PARSER_LEVEL_PARTITION, 12, KAFKA_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION);
+    usm_cpu_cost_end();
+    return ret;
 }
 
 SEC("socket/kafka_response_record_batch_parser_v0")
 int socket__kafka_response_record_batch_parser_v0(struct __sk_buff *skb) {
-    return __socket__kafka_response_parser(skb, PARSER_LEVEL_RECORD_BATCH, 0, 11);
+    const int ret = __socket__kafka_response_parser(skb, PARSER_LEVEL_RECORD_BATCH, 0, 11);
+    usm_cpu_cost_end();
+    return ret;
 }
 
 SEC("socket/kafka_response_record_batch_parser_v12")
 int socket__kafka_response_record_batch_parser_v12(struct __sk_buff *skb) {
-    return __socket__kafka_response_parser(skb, PARSER_LEVEL_RECORD_BATCH, 12, 12);
+    const int ret = __socket__kafka_response_parser(skb, PARSER_LEVEL_RECORD_BATCH, 12, KAFKA_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION);
+    usm_cpu_cost_end();
+    return ret;
 }
 
 static __always_inline int __uprobe__kafka_tls_response_parser(struct pt_regs *ctx, enum parser_level level, u32 min_api_version, u32 max_api_version) {
@@ -1246,22 +1387,30 @@ static __always_inline int __uprobe__kafka_tls_response_parser(struct pt_regs *c
 
 SEC("uprobe/kafka_tls_response_partition_parser_v0")
 int uprobe__kafka_tls_response_partition_parser_v0(struct pt_regs *ctx) {
-    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 0, 11);
+    const int ret = __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 0, 11);
+    usm_cpu_cost_end();
+    return ret;
 }
 
 SEC("uprobe/kafka_tls_response_partition_parser_v12")
 int uprobe__kafka_tls_response_partition_parser_v12(struct pt_regs *ctx) {
-    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 12, 12);
+    const int ret = __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_PARTITION, 12, KAFKA_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION);
+    usm_cpu_cost_end();
+    return ret;
 }
 
 SEC("uprobe/kafka_tls_response_record_batch_parser_v0")
 int uprobe__kafka_tls_response_record_batch_parser_v0(struct pt_regs *ctx) {
-    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_RECORD_BATCH, 0, 11);
+    const int ret = __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_RECORD_BATCH, 0, 11);
+    usm_cpu_cost_end();
+    return ret;
 }
 
 SEC("uprobe/kafka_tls_response_record_batch_parser_v12")
 int uprobe__kafka_tls_response_record_batch_parser_v12(struct pt_regs *ctx) {
-    return __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_RECORD_BATCH, 12, 12);
+    const int ret = __uprobe__kafka_tls_response_parser(ctx, PARSER_LEVEL_RECORD_BATCH, 12, KAFKA_MAX_SUPPORTED_FETCH_REQUEST_API_VERSION);
+    usm_cpu_cost_end();
+    return ret;
 }
 
 // Gets the next expected TCP sequence in the stream, assuming
@@ -1422,7 +1571,7 @@ static __always_inline bool kafka_process(conn_tuple_t *tup, kafka_info_t *kafka
     // Validate client ID
     // Client ID size can be equal to '-1' if the client id is null.
     if (kafka_header.client_id_size > 0) {
-        if (!is_valid_client_id(pkt, offset, kafka_header.client_id_size)) {
+        if (!is_valid_client_id_cached(tup, pkt, offset, kafka_header.client_id_size)) {
             return false;
         }
         offset += kafka_header.client_id_size;
@@ -1457,21 +1606,43 @@ static __always_inline bool kafka_process(conn_tuple_t *tup, kafka_info_t *kafka
         return false;
     }
 
-    s16 topic_name_size = read_first_topic_name_size(pkt, flexible, &offset);
-    if (topic_name_size <= 0 || topic_name_size > TOPIC_NAME_MAX_ALLOWED_SIZE) {
-        return false;
-    }
+    kafka_topic_name_t *topic_name = &kafka->topic_name;
+    bpf_memset(topic_name->topic_name, 0, TOPIC_NAME_MAX_STRING_SIZE);
+    const bool topic_id = kafka_header.api_key == KAFKA_FETCH && kafka_header.api_version >= KAFKA_MIN_FETCH_API_VERSION_WITH_TOPIC_ID;
+    if (topic_id) {
+        // The raw topic ID is stored in place of the name, userspace resolves it.
+        if (pktbuf_load_bytes(pkt, offset, topic_name->topic_name, KAFKA_TOPIC_ID_SIZE) < 0) {
+            return false;
+        }
+        offset += KAFKA_TOPIC_ID_SIZE;
+        topic_name->topic_name_size = KAFKA_TOPIC_ID_SIZE;
+    } else {
+        s16 topic_name_size = read_first_topic_name_size(pkt, flexible, &offset);
+        if (topic_name_size <= 0 || topic_name_size > TOPIC_NAME_MAX_ALLOWED_SIZE) {
+            return false;
+        }
 
-    extra_debug("topic_name_size: %u", topic_name_size);
-    update_topic_name_size_telemetry(kafka_tel, topic_name_size);
-    bpf_memset(kafka_transaction->topic_name, 0, TOPIC_NAME_MAX_STRING_SIZE);
-    pktbuf_read_into_buffer_topic_name_parser((char *)kafka_transaction->topic_name, pkt, offset);
-    offset += topic_name_size;
-    kafka_transaction->topic_name_size = topic_name_size;
+        extra_debug("topic_name_size: %u", topic_name_size);
+        update_topic_name_size_telemetry(kafka_tel, topic_name_size);
+        pktbuf_read_into_buffer_topic_name_parser((char *)topic_name->topic_name, pkt, offset);
+        offset += topic_name_size;
+        // Names longer than the buffer are truncated.
+        topic_name->topic_name_size = topic_name_size < TOPIC_NAME_MAX_STRING_SIZE ? topic_name_size : TOPIC_NAME_MAX_STRING_SIZE;
 
-    CHECK_STRING_COMPOSED_OF_ASCII_FOR_PARSING(TOPIC_NAME_MAX_STRING_SIZE_TO_VALIDATE, topic_name_size, kafka_transaction->topic_name);
+        log_debug("kafka: topic name is %s", topic_name->topic_name);
+    }
 
-    log_debug("kafka: topic name is %s", kafka_transaction->topic_name);
+    kafka_transaction->topic_name_size = topic_name->topic_name_size;
+    kafka_transaction->topic_name_hash = kafka_topic_name_hash(topic_name);
+    // The kafka_topic_names map is LRU, so a lookup doesn't cost as much as an update, which allocates a node even
+    // when the key exists. It only holds names which were already validated, so only the new ones are checked.
+    if (bpf_map_lookup_elem(&kafka_topic_names, &kafka_transaction->topic_name_hash) == NULL) {
+        if (!topic_id) {
+            // The truncation doesn't matter here, as the validated prefix is shorter than the buffer.
+            CHECK_STRING_COMPOSED_OF_ASCII_FOR_PARSING(TOPIC_NAME_MAX_STRING_SIZE_TO_VALIDATE, topic_name->topic_name_size, topic_name->topic_name);
+        }
+        bpf_map_update_elem(&kafka_topic_names, &kafka_transaction->topic_name_hash, topic_name, BPF_NOEXIST);
+    }
 
     switch (kafka_header.api_key) {
     case KAFKA_PRODUCE:
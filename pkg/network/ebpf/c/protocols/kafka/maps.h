@@ -15,7 +15,7 @@
         // requires us to read at offset that are not aligned. Such reads are forbidden
         // if done on the stack and will make the verifier complain about it, but they
         // are allowed on map elements, hence the need for this map.
-        BPF_PERCPU_ARRAY_MAP(kafka_client_id, char [CLIENT_ID_SIZE_TO_VALIDATE], 1)
+        BPF_PERCPU_ARRAY_MAP(kafka_client_id, char [CLIENT_ID_BUFFER_SIZE], 1)
         BPF_PERCPU_ARRAY_MAP(kafka_topic_name, char [TOPIC_NAME_MAX_STRING_SIZE_TO_VALIDATE], 1)
     #else
         // Kernels < 4.7.0 do not know about the per-cpu array map used
@@ -27,7 +27,7 @@
     #endif
 
 #else
-    BPF_PERCPU_ARRAY_MAP(kafka_client_id, char [CLIENT_ID_SIZE_TO_VALIDATE], 1)
+    BPF_PERCPU_ARRAY_MAP(kafka_client_id, char [CLIENT_ID_BUFFER_SIZE], 1)
     BPF_PERCPU_ARRAY_MAP(kafka_topic_name, char [TOPIC_NAME_MAX_STRING_SIZE_TO_VALIDATE], 1)
 #endif
 
@@ -6,6 +6,19 @@ BPF_PERCPU_ARRAY_MAP(kafka_heap, kafka_info_t, 1)
 BPF_HASH_MAP(kafka_in_flight, kafka_transaction_key_t, kafka_transaction_t, 0)
 BPF_HASH_MAP(kafka_response, conn_tuple_t, kafka_response_context_t, 0)
 
+// Maps the topic name hashes carried by the transactions to the topic names.
+// Filled on the first transaction of each topic, read by userspace when it
+// meets an unknown hash.
+BPF_LRU_MAP(kafka_topic_names, __u64, kafka_topic_name_t, KAFKA_MAX_TOPIC_NAMES)
+
+// Maps the connections to the hash of the last client id found valid on them, so
+// that the following requests reusing it skip its validation.
+BPF_LRU_MAP(kafka_client_ids, conn_tuple_t, __u64, 0)
+
+// Sums up the transactions when the `kafka_in_kernel_aggregation` constant is set.
+// Userspace drains it on each stats collection.
+BPF_HASH_MAP(kafka_aggregated_stats, kafka_aggregation_key_t, kafka_aggregated_stats_t, 1)
+
 /*
  * This BPF map is utilized for kernel-space telemetry.
  * Only key 0 is utilized, and its corresponding value is a Kafka telemetry object.
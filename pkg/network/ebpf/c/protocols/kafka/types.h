@@ -20,6 +20,9 @@ typedef struct {
 
 typedef struct kafka_transaction_t {
     __u64 request_started;
+    // The hash of the topic name, whose value is shipped to userspace once
+    // through the kafka_topic_names map.
+    __u64 topic_name_hash;
     __u32 records_count;
     // Request API key and version are 16-bit in the protocol but we store
     // them as u8 to reduce memory usage of the map since the APIs and
@@ -27,14 +30,36 @@ typedef struct kafka_transaction_t {
     __u8 request_api_key;
     __u8 request_api_version;
     __u8 topic_name_size;
-    char topic_name[TOPIC_NAME_MAX_STRING_SIZE];
 } kafka_transaction_t;
 
+// The value of the kafka_topic_names map, keyed by the topic name hash. The
+// name comes first and the struct is 8 bytes aligned, so that the name is
+// hashed 8 bytes at a time.
+typedef struct kafka_topic_name_t {
+    char topic_name[TOPIC_NAME_MAX_STRING_SIZE];
+    __u8 topic_name_size;
+} __attribute__ ((aligned (8))) kafka_topic_name_t;
+
 typedef struct kafka_event_t {
     conn_tuple_t tup;
     kafka_transaction_t transaction;
 } kafka_event_t;
 
+// The transactions sharing a kafka_aggregation_key_t are summed up in the
+// kafka_aggregated_stats map when the in-kernel aggregation is enabled.
+typedef struct kafka_aggregation_key_t {
+    conn_tuple_t tup;
+    __u64 topic_name_hash;
+    __u8 request_api_key;
+    __u8 request_api_version;
+    __u8 topic_name_size;
+} kafka_aggregation_key_t;
+
+typedef struct kafka_aggregated_stats_t {
+    __u64 requests_count;
+    __u64 records_count;
+} kafka_aggregated_stats_t;
+
 typedef struct kafka_transaction_key_t {
     conn_tuple_t tuple;
     __s32 correlation_id;
@@ -100,6 +125,8 @@ typedef struct kafka_response_context_t {
 typedef struct kafka_info_t {
     kafka_response_context_t response;
     kafka_event_t event;
+    kafka_aggregation_key_t aggregation_key;
+    kafka_topic_name_t topic_name;
     kafka_fetch_response_record_batches_array_t record_batches_arrays[KAFKA_MAX_RECORD_BATCHES_ARRAYS];
 } kafka_info_t;
 
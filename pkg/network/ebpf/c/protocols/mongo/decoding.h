@@ -0,0 +1,196 @@
+#ifndef __MONGO_DECODING_H
+#define __MONGO_DECODING_H
+
+#include "bpf_builtins.h"
+#include "bpf_telemetry.h"
+
+#include "protocols/classification/structs.h"
+#include "protocols/cpu-cost.h"
+#include "protocols/helpers/pktbuf.h"
+#include "protocols/mongo/decoding-maps.h"
+#include "protocols/mongo/defs.h"
+#include "protocols/mongo/types.h"
+#include "protocols/mongo/usm-events.h"
+#include "protocols/read_into_buffer.h"
+
+PKTBUF_READ_INTO_BUFFER(mongo_message, MONGO_BUFFER_SIZE, BLK_SIZE)
+
+// Enqueues a batch of events to the user-space. To spare stack size, we take a scratch buffer from the map, copy
+// the connection tuple and the transaction to it, and then enqueue the event.
+static __always_inline void mongo_batch_enqueue_wrapper(conn_tuple_t *tuple, mongo_transaction_t *tx) {
+    u32 zero = 0;
+    mongo_event_t *event = bpf_map_lookup_elem(&mongo_scratch_buffer, &zero);
+    if (!event) {
+        return;
+    }
+
+    bpf_memcpy(&event->tuple, tuple, sizeof(conn_tuple_t));
+    // The stats are keyed by the normalized tuple, like the other protocols.
+    normalize_tuple(&event->tuple);
+    bpf_memcpy(&event->tx, tx, sizeof(mongo_transaction_t));
+    mongo_batch_enqueue(event);
+}
+
+// Extracts the name of the command of an OP_MSG request, which is the name of the first element of its body, as
+// "find" in {find: "collection", filter: {...}}. Returns the length of the name, or 0 if the buffer doesn't hold it.
+static __always_inline __u8 mongo_read_command(const char *buf, char *command) {
+    if (buf[MONGO_SECTION_KIND_OFFSET] != MONGO_SECTION_KIND_BODY || buf[MONGO_FIRST_ELEMENT_TYPE_OFFSET] == 0) {
+        return 0;
+    }
+
+    __u8 len = 0;
+#pragma unroll(MONGO_BUFFER_SIZE - MONGO_FIRST_ELEMENT_NAME_OFFSET)
+    for (int i = MONGO_FIRST_ELEMENT_NAME_OFFSET; i < MONGO_BUFFER_SIZE; i++) {
+        char c = buf[i];
+        if (c == '\0') {
+            break;
+        }
+        if (!('a' <= c && c <= 'z') && !('A' <= c && c <= 'Z') && !('0' <= c && c <= '9') && c != '_' && c != '$') {
+            return 0;
+        }
+        if (len < MONGO_MAX_COMMAND_LEN) {
+            command[len] = c;
+            len++;
+        }
+    }
+
+    return len;
+}
+
+// Returns whether the body of an OP_MSG reply reports a failure. The servers put the "ok" field first in the replies
+// of the failed commands, as in {ok: 0, errmsg: "...", code: 26}, and last in the other replies.
+static __always_inline bool mongo_is_error_reply(const char *buf) {
+    const char *name = buf + MONGO_FIRST_ELEMENT_NAME_OFFSET;
+    if (buf[MONGO_SECTION_KIND_OFFSET] != MONGO_SECTION_KIND_BODY || name[0] != 'o' || name[1] != 'k' || name[2] != '\0') {
+        return false;
+    }
+
+    // The value follows the name, 0 being the only value whose bytes are all zeros in both types.
+    const char *value = name + 3;
+    __u8 size = 0;
+    switch (buf[MONGO_FIRST_ELEMENT_TYPE_OFFSET]) {
+    case MONGO_BSON_DOUBLE:
+        size = sizeof(__u64);
+        break;
+    case MONGO_BSON_INT32:
+        size = sizeof(__u32);
+        break;
+    default:
+        return false;
+    }
+
+    char bits = 0;
+#pragma unroll
+    for (__u8 i = 0; i < sizeof(__u64); i++) {
+        if (i < size) {
+            bits |= value[i];
+        }
+    }
+    return bits == 0;
+}
+
+// Handles a request, starting a transaction. Only the last request of a connection is timed: the in-flight one is
+// replaced, and the reply to a replaced request doesn't match the new one.
+static __always_inline void mongo_decode_request(const char *buf, mongo_msg_header *header, conn_tuple_t *tup) {
+    mongo_transaction_t tx = {};
+    switch (header->op_code) {
+    case MONGO_OP_MSG:
+        if (*((__u32 *)(buf + MONGO_FLAGS_OFFSET)) & MONGO_OP_MSG_MORE_TO_COME) {
+            return;
+        }
+        tx.command_len = mongo_read_command(buf, tx.command);
+        break;
+    case MONGO_OP_QUERY:
+    case MONGO_OP_GET_MORE:
+    case MONGO_OP_COMPRESSED:
+        break;
+    default:
+        // The legacy OP_INSERT, OP_UPDATE, OP_DELETE and OP_KILL_CURSORS get no reply.
+        return;
+    }
+
+    tx.request_id = header->request_id;
+    tx.op_code = header->op_code;
+    tx.request_started = bpf_ktime_get_ns();
+    bpf_map_update_with_telemetry(mongo_in_flight, tup, &tx, BPF_ANY);
+}
+
+// Handles the reply to the in-flight transaction, enqueuing it to userspace.
+static __always_inline void mongo_decode_response(const char *buf, mongo_msg_header *header, conn_tuple_t *tup, mongo_transaction_t *tx) {
+    switch (header->op_code) {
+    case MONGO_OP_MSG:
+        tx->is_error = mongo_is_error_reply(buf);
+        break;
+    case MONGO_OP_REPLY:
+        tx->is_error = (*((__u32 *)(buf + MONGO_FLAGS_OFFSET)) & MONGO_OP_REPLY_QUERY_FAILURE) != 0;
+        break;
+    }
+    tx->response_last_seen = bpf_ktime_get_ns();
+    mongo_batch_enqueue_wrapper(tup, tx);
+}
+
+// Processes a Mongo message. The requests have no responseTo, and the replies are matched to the in-flight transaction
+// of the reversed tuple by the responseTo, which holds the requestID of the request.
+static __always_inline void mongo_entrypoint(pktbuf_t pkt, conn_tuple_t *tup) {
+    if (pktbuf_data_offset(pkt) + MONGO_HEADER_LENGTH > pktbuf_data_end(pkt)) {
+        return;
+    }
+
+    char buf[MONGO_BUFFER_SIZE];
+    bpf_memset(buf, 0, sizeof(buf));
+    pktbuf_read_into_buffer_mongo_message(buf, pkt, pktbuf_data_offset(pkt));
+
+    mongo_msg_header header = *((mongo_msg_header *)buf);
+    if (header.message_length < MONGO_HEADER_LENGTH) {
+        return;
+    }
+
+    if (header.response_to == 0) {
+        mongo_decode_request(buf, &header, tup);
+        return;
+    }
+
+    conn_tuple_t request_tup = *tup;
+    flip_tuple(&request_tup);
+    mongo_transaction_t *tx = bpf_map_lookup_elem(&mongo_in_flight, &request_tup);
+    if (tx == NULL || tx->request_id != header.response_to) {
+        return;
+    }
+    mongo_decode_response(buf, &header, &request_tup, tx);
+    bpf_map_delete_elem(&mongo_in_flight, &request_tup);
+}
+
+static __always_inline void mongo_tcp_termination(conn_tuple_t *tup) {
+    bpf_map_delete_elem(&mongo_in_flight, tup);
+    flip_tuple(tup);
+    bpf_map_delete_elem(&mongo_in_flight, tup);
+}
+
+// Entrypoint to process plaintext Mongo traffic. Pulls the connection tuple and the packet buffer from the map and
+// calls the main processing function. If the packet is a TCP termination, it calls the termination function.
+static __always_inline int __socket__mongo_process(struct __sk_buff* skb) {
+    skb_info_t skb_info = {};
+    conn_tuple_t conn_tuple = {};
+
+    if (!fetch_dispatching_arguments(&conn_tuple, &skb_info)) {
+        return 0;
+    }
+
+    if (is_tcp_termination(&skb_info)) {
+        mongo_tcp_termination(&conn_tuple);
+        return 0;
+    }
+
+    pktbuf_t pkt = pktbuf_from_skb(skb, &skb_info);
+    mongo_entrypoint(pkt, &conn_tuple);
+    return 0;
+}
+
+SEC("socket/mongo_process")
+int socket__mongo_process(struct __sk_buff* skb) {
+    const int ret = __socket__mongo_process(skb);
+    usm_cpu_cost_end();
+    return ret;
+}
+
+#endif
@@ -18,4 +18,22 @@
 
 #define MONGO_HEADER_LENGTH 16
 
+// Offset of the flagBits of OP_MSG and of the responseFlags of OP_REPLY, which follow the header.
+#define MONGO_FLAGS_OFFSET MONGO_HEADER_LENGTH
+// The moreToCome bit of the flagBits of OP_MSG, set on the requests the server doesn't reply to.
+#define MONGO_OP_MSG_MORE_TO_COME (1 << 1)
+// The QueryFailure bit of the responseFlags of OP_REPLY.
+#define MONGO_OP_REPLY_QUERY_FAILURE (1 << 1)
+
+// The kind of the section of OP_MSG holding the body document, following the flagBits.
+#define MONGO_SECTION_KIND_BODY 0
+#define MONGO_SECTION_KIND_OFFSET (MONGO_FLAGS_OFFSET + 4)
+// Offsets of the type and of the name of the first element of the body document, following its size.
+#define MONGO_FIRST_ELEMENT_TYPE_OFFSET (MONGO_SECTION_KIND_OFFSET + 5)
+#define MONGO_FIRST_ELEMENT_NAME_OFFSET (MONGO_FIRST_ELEMENT_TYPE_OFFSET + 1)
+
+// BSON types of the "ok" field of the replies, see https://bsonspec.org/spec.html
+#define MONGO_BSON_DOUBLE 0x01
+#define MONGO_BSON_INT32 0x10
+
 #endif
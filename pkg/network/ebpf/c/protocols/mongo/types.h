@@ -0,0 +1,38 @@
+#ifndef __MONGO_TYPES_H
+#define __MONGO_TYPES_H
+
+#include "conn_tuple.h"
+
+// Controls the number of Mongo transactions read from userspace at a time.
+#define MONGO_BATCH_SIZE 25
+
+// Number of bytes of a message read to extract the name of the command of a request, or the first field of a reply.
+#define MONGO_BUFFER_SIZE 48
+
+// Maximum length of the command name sent to userspace, the longer names are truncated.
+#define MONGO_MAX_COMMAND_LEN 16
+
+// Mongo transaction information we store in the kernel.
+typedef struct {
+    // The name of the command of OP_MSG requests (find, insert, aggregate, etc.), stored up to MONGO_MAX_COMMAND_LEN
+    // bytes.
+    char command[MONGO_MAX_COMMAND_LEN];
+    __u64 request_started;
+    __u64 response_last_seen;
+    // The requestID of the request, matched against the responseTo of the replies.
+    __s32 request_id;
+    // The opCode of the request (OP_MSG, OP_QUERY, etc.).
+    __s32 op_code;
+    // The size of the name stored in command.
+    __u8 command_len;
+    // Whether the reply reports a failure.
+    __u8 is_error;
+} mongo_transaction_t;
+
+// The struct we send to userspace, containing the connection tuple and the transaction information.
+typedef struct {
+    conn_tuple_t tuple;
+    mongo_transaction_t tx;
+} mongo_event_t;
+
+#endif
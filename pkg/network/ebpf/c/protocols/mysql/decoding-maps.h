@@ -0,0 +1,15 @@
+#ifndef __MYSQL_MAPS_H
+#define __MYSQL_MAPS_H
+
+#include "bpf_helpers.h"
+#include "map-defs.h"
+
+#include "protocols/mysql/types.h"
+
+// Keeps track of the in-flight MySQL command of each connection, keyed by the tuple of the request.
+BPF_HASH_MAP(mysql_in_flight, conn_tuple_t, mysql_transaction_t, 0)
+
+// Acts as a scratch buffer for MySQL events, for preparing events before they are sent to userspace.
+BPF_PERCPU_ARRAY_MAP(mysql_scratch_buffer, mysql_event_t, 1)
+
+#endif
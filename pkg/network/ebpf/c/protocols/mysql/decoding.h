@@ -0,0 +1,169 @@
+#ifndef __MYSQL_DECODING_H
+#define __MYSQL_DECODING_H
+
+#include "bpf_builtins.h"
+#include "bpf_telemetry.h"
+
+#include "protocols/cpu-cost.h"
+#include "protocols/helpers/pktbuf.h"
+#include "protocols/mysql/decoding-maps.h"
+#include "protocols/mysql/defs.h"
+#include "protocols/mysql/types.h"
+#include "protocols/mysql/usm-events.h"
+#include "protocols/read_into_buffer.h"
+
+PKTBUF_READ_INTO_BUFFER(mysql_packet, MYSQL_BUFFER_SIZE, BLK_SIZE)
+
+// Enqueues a batch of events to the user-space. To spare stack size, we take a scratch buffer from the map, copy
+// the connection tuple and the transaction to it, and then enqueue the event.
+static __always_inline void mysql_batch_enqueue_wrapper(conn_tuple_t *tuple, mysql_transaction_t *tx) {
+    u32 zero = 0;
+    mysql_event_t *event = bpf_map_lookup_elem(&mysql_scratch_buffer, &zero);
+    if (!event) {
+        return;
+    }
+
+    bpf_memcpy(&event->tuple, tuple, sizeof(conn_tuple_t));
+    // The stats are keyed by the normalized tuple, like the other protocols.
+    normalize_tuple(&event->tuple);
+    bpf_memcpy(&event->tx, tx, sizeof(mysql_transaction_t));
+    mysql_batch_enqueue(event);
+}
+
+// Returns whether the header starts a command the server replies to. The greetings of the server share their first
+// byte with the deprecated COM_STATISTICS and COM_PROCESS_INFO, which are therefore not timed.
+static __always_inline bool mysql_is_command(mysql_hdr *header) {
+    if (header->seq_id != MYSQL_COMMAND_SEQ_ID || header->payload_length == 0) {
+        return false;
+    }
+
+    switch (header->command_type) {
+    case MYSQL_COMMAND_QUIT:
+    case MYSQL_COMMAND_STMT_SEND_LONG_DATA:
+    case MYSQL_COMMAND_STMT_CLOSE:
+    case MYSQL_SERVER_GREETING_V10:
+    case MYSQL_SERVER_GREETING_V9:
+        return false;
+    default:
+        return header->command_type > 0 && header->command_type <= MYSQL_COMMAND_MAX;
+    }
+}
+
+// Extracts the first keyword of the query following the header, as "SELECT" in "select * from t". The keyword is
+// upper-cased, as SQL is case insensitive. Returns the length of the keyword, or 0 if the query doesn't start with one,
+// as when it starts with a comment.
+static __always_inline __u8 mysql_read_operation(const char *buf, char *operation) {
+    __u8 len = 0;
+    // The query starts right after the header, whose size is MYSQL_MIN_LENGTH.
+#pragma unroll(MYSQL_BUFFER_SIZE - MYSQL_MIN_LENGTH)
+    for (int i = MYSQL_MIN_LENGTH; i < MYSQL_BUFFER_SIZE; i++) {
+        char c = buf[i];
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            if (len > 0) {
+                break;
+            }
+            continue;
+        }
+        if ('a' <= c && c <= 'z') {
+            c -= 'a' - 'A';
+        } else if (c < 'A' || c > 'Z') {
+            break;
+        }
+        if (len < MYSQL_MAX_OPERATION_LEN) {
+            operation[len] = c;
+            len++;
+        }
+    }
+
+    return len;
+}
+
+// Handles a command, starting a transaction. The commands of a connection are sequential, so a command replaces the
+// in-flight one, whose reply was missed.
+static __always_inline void mysql_handle_request(const char *buf, conn_tuple_t *tup) {
+    mysql_hdr header = *((mysql_hdr *)buf);
+    if (!mysql_is_command(&header)) {
+        return;
+    }
+
+    mysql_transaction_t tx = {};
+    tx.command = header.command_type;
+    if (tx.command == MYSQL_COMMAND_QUERY || tx.command == MYSQL_PREPARE_QUERY) {
+        tx.operation_len = mysql_read_operation(buf, tx.operation);
+    }
+    tx.request_started = bpf_ktime_get_ns();
+    bpf_map_update_with_telemetry(mysql_in_flight, tup, &tx, BPF_ANY);
+}
+
+// Handles the first packet of the reply to the in-flight transaction, enqueuing it to userspace. Returns false if the
+// packet doesn't start a reply, as the following packets of a result set.
+static __always_inline bool mysql_handle_response(const char *buf, conn_tuple_t *tup, mysql_transaction_t *tx) {
+    mysql_hdr header = *((mysql_hdr *)buf);
+    if (header.seq_id != MYSQL_RESPONSE_SEQ_ID || header.payload_length == 0) {
+        return false;
+    }
+
+    // The first byte of the payload tells an ERR packet from an OK packet or a result set.
+    tx->is_error = header.command_type == MYSQL_ERR_PACKET;
+    tx->response_last_seen = bpf_ktime_get_ns();
+    mysql_batch_enqueue_wrapper(tup, tx);
+    return true;
+}
+
+// Processes a MySQL packet. The direction of the packet is found by looking up the in-flight transaction of the
+// reversed tuple: a packet starting a reply was sent by the server, and any other packet may start a command. The
+// latency of a command is measured until the first packet of its reply.
+static __always_inline void mysql_entrypoint(pktbuf_t pkt, conn_tuple_t *tup) {
+    if (pktbuf_data_offset(pkt) + sizeof(mysql_hdr) > pktbuf_data_end(pkt)) {
+        return;
+    }
+
+    char buf[MYSQL_BUFFER_SIZE];
+    bpf_memset(buf, 0, sizeof(buf));
+    pktbuf_read_into_buffer_mysql_packet(buf, pkt, pktbuf_data_offset(pkt));
+
+    conn_tuple_t request_tup = *tup;
+    flip_tuple(&request_tup);
+    mysql_transaction_t *tx = bpf_map_lookup_elem(&mysql_in_flight, &request_tup);
+    if (tx != NULL && mysql_handle_response(buf, &request_tup, tx)) {
+        bpf_map_delete_elem(&mysql_in_flight, &request_tup);
+        return;
+    }
+
+    mysql_handle_request(buf, tup);
+}
+
+static __always_inline void mysql_tcp_termination(conn_tuple_t *tup) {
+    bpf_map_delete_elem(&mysql_in_flight, tup);
+    flip_tuple(tup);
+    bpf_map_delete_elem(&mysql_in_flight, tup);
+}
+
+// Entrypoint to process plaintext MySQL traffic. Pulls the connection tuple and the packet buffer from the map and
+// calls the main processing function. If the packet is a TCP termination, it calls the termination function.
+static __always_inline int __socket__mysql_process(struct __sk_buff* skb) {
+    skb_info_t skb_info = {};
+    conn_tuple_t conn_tuple = {};
+
+    if (!fetch_dispatching_arguments(&conn_tuple, &skb_info)) {
+        return 0;
+    }
+
+    if (is_tcp_termination(&skb_info)) {
+        mysql_tcp_termination(&conn_tuple);
+        return 0;
+    }
+
+    pktbuf_t pkt = pktbuf_from_skb(skb, &skb_info);
+    mysql_entrypoint(pkt, &conn_tuple);
+    return 0;
+}
+
+SEC("socket/mysql_process")
+int socket__mysql_process(struct __sk_buff* skb) {
+    const int ret = __socket__mysql_process(skb);
+    usm_cpu_cost_end();
+    return ret;
+}
+
+#endif
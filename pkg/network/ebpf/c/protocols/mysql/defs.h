@@ -21,6 +21,22 @@
 // Minium version string is <digit>.<digit>.<digit>
 #define MIN_VERSION_SIZE 5
 
+// Taken from https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_quit.html, the server doesn't reply to it.
+#define MYSQL_COMMAND_QUIT 0x1
+// Taken from https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_stmt_send_long_data.html, the server
+// doesn't reply to it.
+#define MYSQL_COMMAND_STMT_SEND_LONG_DATA 0x18
+// Taken from https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_com_stmt_close.html, the server doesn't
+// reply to it.
+#define MYSQL_COMMAND_STMT_CLOSE 0x19
+// The last command of the protocol, COM_RESET_CONNECTION.
+#define MYSQL_COMMAND_MAX 0x1f
+// The sequence id of the packets of the clients starting a command, and of the first packet of the replies.
+#define MYSQL_COMMAND_SEQ_ID 0
+#define MYSQL_RESPONSE_SEQ_ID 1
+// Taken from https://dev.mysql.com/doc/dev/mysql-server/latest/page_protocol_basic_err_packet.html
+#define MYSQL_ERR_PACKET 0xff
+
 // MySQL header format. Starts with 24 bits (3 bytes) of the length of the payload, a one byte of sequence id,
 // a one byte to represent the message type.
 typedef struct {
@@ -0,0 +1,36 @@
+#ifndef __MYSQL_TYPES_H
+#define __MYSQL_TYPES_H
+
+#include "conn_tuple.h"
+
+// Controls the number of MySQL transactions read from userspace at a time.
+#define MYSQL_BATCH_SIZE 25
+
+// Number of bytes of a command packet read to extract its command and the operation of its query.
+#define MYSQL_BUFFER_SIZE 32
+
+// Maximum length of the operation sent to userspace, the longer operations are truncated.
+#define MYSQL_MAX_OPERATION_LEN 16
+
+// MySQL transaction information we store in the kernel.
+typedef struct {
+    // The upper-cased first keyword of the query of COM_QUERY and COM_STMT_PREPARE (SELECT, INSERT, etc.), stored up
+    // to MYSQL_MAX_OPERATION_LEN bytes.
+    char operation[MYSQL_MAX_OPERATION_LEN];
+    __u64 request_started;
+    __u64 response_last_seen;
+    // The command of the request (COM_QUERY, COM_STMT_EXECUTE, COM_PING, etc.).
+    __u8 command;
+    // The size of the keyword stored in operation.
+    __u8 operation_len;
+    // Whether the reply is an ERR packet.
+    __u8 is_error;
+} mysql_transaction_t;
+
+// The struct we send to userspace, containing the connection tuple and the transaction information.
+typedef struct {
+    conn_tuple_t tuple;
+    mysql_transaction_t tx;
+} mysql_event_t;
+
+#endif
@@ -6,10 +6,16 @@
 
 #include "protocols/postgres/types.h"
 
-// Keeps track of in-flight Postgres transactions
-BPF_HASH_MAP(postgres_in_flight, conn_tuple_t, postgres_transaction_t, 0)
+// Keeps track of the in-flight Postgres transactions of each connection
+BPF_HASH_MAP(postgres_in_flight, conn_tuple_t, postgres_pipeline_t, 0)
 
 // Acts as a scratch buffer for Postgres events, for preparing events before they are sent to userspace.
 BPF_PERCPU_ARRAY_MAP(postgres_scratch_buffer, postgres_event_t, 1)
 
+// Acts as a scratch buffer for the new entries of postgres_in_flight, which are too large for the stack.
+BPF_PERCPU_ARRAY_MAP(postgres_pipeline_scratch_buffer, postgres_pipeline_t, 1)
+
+// Keeps the state of the extended query protocol parser across its tail calls.
+BPF_PERCPU_ARRAY_MAP(postgres_pipeline_parser_state, postgres_pipeline_parser_state_t, 1)
+
 #endif
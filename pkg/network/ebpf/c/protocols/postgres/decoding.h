@@ -6,6 +6,7 @@
 
 #include "protocols/sockfd.h"
 
+#include "protocols/cpu-cost.h"
 #include "protocols/helpers/pktbuf.h"
 #include "protocols/postgres/decoding-maps.h"
 #include "protocols/postgres/defs.h"
@@ -43,25 +44,147 @@ static __always_inline bool read_message_header(pktbuf_t pkt, struct pg_message_
     return true;
 }
 
-// Handles a new query by creating a new transaction and storing it in the map.
-// If a transaction already exists for the given connection, it is aborted.
+// Returns the fingerprint of the query fragment: the FNV-1a hash of its bytes, skipping the string literals and the
+// numeric literals, that is the digits which aren't part of an identifier. The executions of a statement with different
+// values thus share their fingerprint.
+static __always_inline __u64 postgres_query_fingerprint(const char *fragment, __u32 size) {
+    __u64 hash = POSTGRES_FINGERPRINT_OFFSET_BASIS;
+    bool in_string = false;
+    bool in_identifier = false;
+
+#pragma unroll(POSTGRES_BUFFER_SIZE)
+    for (__u32 i = 0; i < POSTGRES_BUFFER_SIZE; i++) {
+        if (i >= size) {
+            break;
+        }
+        const char c = fragment[i];
+        // An escaped quote toggles the state twice.
+        if (c == POSTGRES_STRING_LITERAL_QUOTE) {
+            in_string = !in_string;
+            continue;
+        }
+        if (in_string) {
+            continue;
+        }
+        const bool is_digit = c >= '0' && c <= '9';
+        if (is_digit && !in_identifier) {
+            continue;
+        }
+        in_identifier = is_digit || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+        hash ^= (__u8)c;
+        hash *= POSTGRES_FINGERPRINT_PRIME;
+    }
+
+    return hash;
+}
+
+// Returns the in-flight entry of the connection, creating it if it doesn't exist yet.
+static __always_inline postgres_pipeline_t *postgres_get_or_create_pipeline(conn_tuple_t *conn_tuple) {
+    postgres_pipeline_t *pipeline = bpf_map_lookup_elem(&postgres_in_flight, conn_tuple);
+    if (pipeline != NULL) {
+        return pipeline;
+    }
+
+    const __u32 zero = 0;
+    postgres_pipeline_t *new_pipeline = bpf_map_lookup_elem(&postgres_pipeline_scratch_buffer, &zero);
+    if (new_pipeline == NULL) {
+        return NULL;
+    }
+    // Only the queries between head and parsed are read, so the stale slots of the scratch buffer are left as is.
+    new_pipeline->last_seen = bpf_ktime_get_ns();
+    new_pipeline->head = 0;
+    new_pipeline->tail = 0;
+    new_pipeline->parsed = 0;
+    new_pipeline->overflow = 0;
+    bpf_map_update_elem(&postgres_in_flight, conn_tuple, new_pipeline, BPF_NOEXIST);
+    return bpf_map_lookup_elem(&postgres_in_flight, conn_tuple);
+}
+
+// Marks the query in the tail slot of the ring as executed, now awaiting its response.
+static __always_inline postgres_transaction_t *postgres_start_query(postgres_pipeline_t *pipeline) {
+    postgres_transaction_t *query = &pipeline->queries[pipeline->tail & (POSTGRES_MAX_PIPELINED_QUERIES - 1)];
+    pipeline->tail++;
+    query->request_started = bpf_ktime_get_ns();
+    query->response_last_seen = 0;
+    pipeline->last_seen = query->request_started;
+    return query;
+}
+
+// Pushes a new query to the tail of the ring, dropping the queries parsed but not executed yet. Returns NULL if the
+// ring is full, in which case the query is only counted so that its response is skipped.
+static __always_inline postgres_transaction_t *postgres_push_query(postgres_pipeline_t *pipeline) {
+    pipeline->parsed = pipeline->tail;
+    if (pipeline->overflow > 0 || pipeline->tail - pipeline->head >= POSTGRES_MAX_PIPELINED_QUERIES) {
+        pipeline->overflow++;
+        return NULL;
+    }
+
+    postgres_transaction_t *query = postgres_start_query(pipeline);
+    pipeline->parsed = pipeline->tail;
+    return query;
+}
+
+// Handles an Execute message. The statements are executed in the order they were parsed, so the oldest query parsed
+// but not executed yet is the one executed. A statement prepared before its Parse message could be seen still takes a
+// slot, with an empty query, to keep the order of the responses.
+static __always_inline void postgres_execute_query(postgres_pipeline_t *pipeline) {
+    if (pipeline->overflow == 0 && pipeline->tail != pipeline->parsed) {
+        postgres_start_query(pipeline);
+        return;
+    }
+
+    postgres_transaction_t *query = postgres_push_query(pipeline);
+    if (query != NULL) {
+        query->original_query_size = 0;
+        query->fingerprint = 0;
+    }
+}
+
+// Handles a new query by pushing it to the ring of the connection.
 // Query message format - https://www.postgresql.org/docs/current/protocol-message-formats.html#PROTOCOL-MESSAGE-FORMATS-QUERY
 // the first 5 bytes are the message header, and the query is the rest of the payload.
 static __always_inline void handle_new_query(pktbuf_t pkt, conn_tuple_t *conn_tuple, __u32 query_len) {
-    postgres_transaction_t new_transaction = {};
-    new_transaction.request_started = bpf_ktime_get_ns();
-    u32 data_off = pktbuf_data_offset(pkt);
-    pktbuf_read_into_buffer_postgres_query((char *)new_transaction.request_fragment, pkt, data_off);
-    new_transaction.original_query_size = query_len;
-    bpf_map_update_elem(&postgres_in_flight, conn_tuple, &new_transaction, BPF_ANY);
+    postgres_pipeline_t *pipeline = postgres_get_or_create_pipeline(conn_tuple);
+    if (pipeline == NULL) {
+        return;
+    }
+    postgres_transaction_t *query = postgres_push_query(pipeline);
+    if (query == NULL) {
+        return;
+    }
+
+    bpf_memset(query->request_fragment, 0, POSTGRES_BUFFER_SIZE);
+    pktbuf_read_into_buffer_postgres_query((char *)query->request_fragment, pkt, pktbuf_data_offset(pkt));
+    query->original_query_size = query_len;
+    query->fingerprint = postgres_query_fingerprint(query->request_fragment, query_len);
 }
 
-// Handles a command complete message by enqueuing the transaction and deleting it from the in-flight map.
-// The format of the command complete message is described here: https://www.postgresql.org/docs/current/protocol-message-formats.html#PROTOCOL-MESSAGE-FORMATS-COMMANDCOMPLETE
-static __always_inline void handle_command_complete(conn_tuple_t *conn_tuple, postgres_transaction_t *transaction) {
-    transaction->response_last_seen = bpf_ktime_get_ns();
-    postgres_batch_enqueue_wrapper(conn_tuple, transaction);
-    bpf_map_delete_elem(&postgres_in_flight, conn_tuple);
+// Handles the given number of command complete messages by popping as many queries from the head of the ring and
+// enqueuing them. The format of the command complete message is described here: https://www.postgresql.org/docs/current/protocol-message-formats.html#PROTOCOL-MESSAGE-FORMATS-COMMANDCOMPLETE
+static __always_inline void handle_command_complete(conn_tuple_t *conn_tuple, postgres_pipeline_t *pipeline, __u32 completed) {
+    const __u64 now = bpf_ktime_get_ns();
+    const __u32 queued = pipeline->tail - pipeline->head;
+    const __u32 to_pop = completed < queued ? completed : queued;
+
+#pragma unroll(POSTGRES_MAX_PIPELINED_QUERIES)
+    for (__u32 i = 0; i < POSTGRES_MAX_PIPELINED_QUERIES; ++i) {
+        if (i >= to_pop) {
+            break;
+        }
+        postgres_transaction_t *query = &pipeline->queries[pipeline->head & (POSTGRES_MAX_PIPELINED_QUERIES - 1)];
+        pipeline->head++;
+        // The executions of statements whose Parse message was missed are only queued to keep the order.
+        if (query->original_query_size == 0) {
+            continue;
+        }
+        query->response_last_seen = now;
+        postgres_batch_enqueue_wrapper(conn_tuple, query);
+    }
+
+    // The queries executed while the ring was full come after the queued ones.
+    completed -= to_pop;
+    pipeline->overflow = completed < pipeline->overflow ? pipeline->overflow - completed : 0;
+    pipeline->last_seen = now;
 }
 
 static void __always_inline postgres_tcp_termination(conn_tuple_t *tup) {
@@ -107,17 +230,16 @@ static int __always_inline skip_string(pktbuf_t pkt, int message_len) {
 }
 
 // Main processing logic for the Postgres protocol. It reads the first message header and decides what to do based on the
-// message tag. If the message is a new query, it stores the query in the in-flight map. If the message is a command
-// complete, it enqueues the transaction and deletes it from the in-flight map. If the message is not a command complete,
-// it tries to read up to POSTGRES_MAX_MESSAGES messages, looking for a command complete message.
-// If the message is not a new query or a command complete, it ignores the message.
+// message tag. If the message is a new query, it pushes the query to the pipeline of the connection. Otherwise, the
+// packet holds responses, so it reads up to POSTGRES_MAX_MESSAGES messages, counting the command complete messages,
+// and pops as many queries from the pipeline. An error response ends the pipeline, as the server skips the queries
+// sent until the next Sync message.
 static __always_inline void postgres_entrypoint(pktbuf_t pkt, conn_tuple_t *conn_tuple, struct pg_message_header *header) {
     // Read first message header
     // Advance the data offset to the end of the first message header.
     pktbuf_advance(pkt, sizeof(struct pg_message_header));
 
-    // If the message is a new query, we store the query in the in-flight map.
-    // If we had a transaction for the connection, we override it and drops the previous one.
+    // If the message is a new query, we push it to the pipeline of the connection.
     if (header->message_tag == POSTGRES_QUERY_MAGIC_BYTE) {
         // message_len includes size of the payload, 4 bytes of the message length itself, but not the message tag.
         // So if we want to know the size of the payload, we need to subtract the size of the message length.
@@ -125,58 +247,71 @@ static __always_inline void postgres_entrypoint(pktbuf_t pkt, conn_tuple_t *conn
         return;
     }
 
-    // We didn't find a new query, thus we assume we're in the middle of a transaction.
-    // We look up the transaction in the in-flight map, and if it doesn't exist, we ignore the message.
-    postgres_transaction_t *transaction = bpf_map_lookup_elem(&postgres_in_flight, conn_tuple);
-    if (!transaction) {
+    // We didn't find a new query, thus we assume we're reading responses.
+    // We look up the pipeline in the in-flight map, and if it doesn't exist, we ignore the message.
+    postgres_pipeline_t *pipeline = bpf_map_lookup_elem(&postgres_in_flight, conn_tuple);
+    if (!pipeline) {
         return;
     }
 
-    // If the message is a command complete, we enqueue the transaction and delete it from the in-flight map.
-    if (header->message_tag == POSTGRES_COMMAND_COMPLETE_MAGIC_BYTE) {
-        handle_command_complete(conn_tuple, transaction);
-        return;
-    }
-
-    // We're in the middle of a transaction, and the message is not a command complete, but it can be a chain of
-    // messages. So we try to read up to POSTGRES_MAX_MESSAGES messages, looking for a command complete message.
+    __u32 completed = header->message_tag == POSTGRES_COMMAND_COMPLETE_MAGIC_BYTE ? 1 : 0;
+    bool failed = header->message_tag == POSTGRES_ERROR_RESPONSE_MAGIC_BYTE;
 
     // Advance the data offset to the end of the first message (after the payload). The message length includes the size
     // of the payload, 4 bytes of the message length itself, but not the message tag. Since we already moved the data
     // offset to the end of the message header, we want to jump over the payload.
     pktbuf_advance(pkt, header->message_len - sizeof(__u32));
 
+    // The responses of several pipelined queries can share the packet, so we keep reading up to POSTGRES_MAX_MESSAGES
+    // messages.
 #pragma unroll(POSTGRES_MAX_MESSAGES)
     for (__u32 iteration = 0; iteration < POSTGRES_MAX_MESSAGES; ++iteration) {
-        if (!read_message_header(pkt, header)) {
+        if (failed || !read_message_header(pkt, header)) {
             break;
         }
         if (header->message_tag == POSTGRES_COMMAND_COMPLETE_MAGIC_BYTE) {
-            handle_command_complete(conn_tuple, transaction);
-            break;
+            completed++;
+        } else if (header->message_tag == POSTGRES_ERROR_RESPONSE_MAGIC_BYTE) {
+            failed = true;
         }
-        // We didn't find a command complete message, so we advance the data offset to the end of the message.
+        // We advance the data offset to the end of the message.
         // reminder, the message length includes the size of the payload, 4 bytes of the message length itself, but not
         // the message tag. So we need to add 1 to the message length to jump over the entire message.
         pktbuf_advance(pkt, header->message_len + 1);
     }
-    return;
+
+    handle_command_complete(conn_tuple, pipeline, completed);
+    // Following an error, the server skips the messages until the next Sync message, so the remaining queries won't
+    // get a response, and the statements parsed but not executed yet are discarded.
+    if (failed) {
+        pipeline->head = pipeline->tail = pipeline->parsed;
+        pipeline->overflow = 0;
+    }
+    if (pipeline->head == pipeline->parsed && pipeline->overflow == 0) {
+        bpf_map_delete_elem(&postgres_in_flight, conn_tuple);
+    }
 }
 
-// A dedicated function to handle the parse message. This function is called from a tail call from the main entrypoint.
-// The reason for this is that the main entrypoint is too large to be inlined, and the verifier has issues with it.
-static __always_inline void postgres_handle_parse_message(pktbuf_t pkt, conn_tuple_t *conn_tuple) {
-    // Read first message header
-    struct pg_message_header header;
-    if (!read_message_header(pkt, &header)) {
+// Reads the query of a Parse message into the next free slot of the ring. The data offset must point to the message
+// header. If the query cannot be read, the slot is still taken, with an empty query, to keep the order of the
+// statements.
+static __always_inline void postgres_handle_parse(pktbuf_t pkt, postgres_pipeline_t *pipeline, struct pg_message_header *header) {
+    // The statements parsed while the ring is full are dropped, their executions are then counted as overflowing.
+    if (pipeline->parsed - pipeline->head >= POSTGRES_MAX_PIPELINED_QUERIES) {
         return;
     }
-    // Advance the data offset to the end of the first message header.
+    postgres_transaction_t *parsed = &pipeline->queries[pipeline->parsed & (POSTGRES_MAX_PIPELINED_QUERIES - 1)];
+    pipeline->parsed++;
+    pipeline->last_seen = bpf_ktime_get_ns();
+    parsed->original_query_size = 0;
+    parsed->fingerprint = 0;
+
+    // Advance the data offset to the end of the message header.
     pktbuf_advance(pkt, sizeof(struct pg_message_header));
 
     // message_len includes size of the payload, 4 bytes of the message length itself, but not the message tag.
     // So if we want to know the size of the payload, we need to subtract the size of the message length.
-    __u32 payload_data_length = header.message_len - sizeof(__u32);
+    __u32 payload_data_length = header->message_len - sizeof(__u32);
     int length = skip_string(pkt, payload_data_length);
     if (length <= 0 || length >= payload_data_length) {
         // We failed to find the null terminator within the first 128 bytes of the message, so we cannot read the
@@ -186,20 +321,98 @@ static __always_inline void postgres_handle_parse_message(pktbuf_t pkt, conn_tup
         return;
     }
     pktbuf_advance(pkt, length);
-    header.message_len -= length;
 
-    // message_len includes size of the payload, 4 bytes of the message length itself, but not the message tag.
-    // So if we want to know the size of the payload, we need to subtract the size of the message length.
-    handle_new_query(pkt, conn_tuple, header.message_len - sizeof(__u32));
-    return;
+    bpf_memset(parsed->request_fragment, 0, POSTGRES_BUFFER_SIZE);
+    pktbuf_read_into_buffer_postgres_query((char *)parsed->request_fragment, pkt, pktbuf_data_offset(pkt));
+    parsed->original_query_size = payload_data_length - length;
+    parsed->fingerprint = postgres_query_fingerprint(parsed->request_fragment, parsed->original_query_size);
+}
+
+// A dedicated function to handle the extended query protocol, in which the client sends Parse, Bind, Describe,
+// Execute and Sync messages, and drivers pipeline these messages for several statements in a single packet. It is
+// called from a tail call from the main entrypoint, as it is too large to be inlined there, and handles a single
+// statement per call: a Parse message takes the next slot of the ring, and an Execute message starts the oldest parsed
+// query. Returns true if the packet holds another statement, in which case the caller tail calls itself. The last
+// allowed call only counts the remaining Execute messages, so that their responses are skipped.
+static __always_inline bool postgres_handle_parse_message(pktbuf_t pkt, conn_tuple_t *conn_tuple) {
+    const __u32 zero = 0;
+    postgres_pipeline_parser_state_t *state = bpf_map_lookup_elem(&postgres_pipeline_parser_state, &zero);
+    if (state == NULL) {
+        return false;
+    }
+    pktbuf_set_offset(pkt, state->data_off);
+    state->tail_calls++;
+    const bool last_call = state->tail_calls >= POSTGRES_MAX_PIPELINE_TAIL_CALLS;
+
+    postgres_pipeline_t *pipeline = postgres_get_or_create_pipeline(conn_tuple);
+    if (pipeline == NULL) {
+        return false;
+    }
+
+    struct pg_message_header header;
+    if (!read_message_header(pkt, &header)) {
+        return false;
+    }
+    if (header.message_tag == POSTGRES_PARSE_MAGIC_BYTE) {
+        // The message length doesn't include the message tag.
+        const __u32 next_message_off = pktbuf_data_offset(pkt) + header.message_len + 1;
+        postgres_handle_parse(pkt, pipeline, &header);
+        pktbuf_set_offset(pkt, next_message_off);
+    }
+
+    __u32 executions = 0;
+    bool found_statement = false;
+#pragma unroll(POSTGRES_MAX_MESSAGES)
+    for (__u32 iteration = 0; iteration < POSTGRES_MAX_MESSAGES; ++iteration) {
+        if (!read_message_header(pkt, &header)) {
+            break;
+        }
+        // The Parse message of the next statement is left to the next call.
+        if (header.message_tag == POSTGRES_PARSE_MAGIC_BYTE && !last_call) {
+            found_statement = true;
+            break;
+        }
+        pktbuf_advance(pkt, header.message_len + 1);
+        if (header.message_tag == POSTGRES_EXECUTE_MAGIC_BYTE) {
+            executions++;
+            if (!last_call) {
+                found_statement = true;
+                break;
+            }
+        }
+    }
+
+    if (executions > 0) {
+        postgres_execute_query(pipeline);
+        // The following executions come last, so counting them as overflowing skips their responses.
+        pipeline->overflow += executions - 1;
+    }
+
+    state->data_off = pktbuf_data_offset(pkt);
+    return found_statement;
+}
+
+// Resets the state of the extended query protocol parser before its first tail call for the packet.
+static __always_inline void postgres_reset_pipeline_parser_state(pktbuf_t pkt) {
+    const __u32 zero = 0;
+    postgres_pipeline_parser_state_t *state = bpf_map_lookup_elem(&postgres_pipeline_parser_state, &zero);
+    if (state == NULL) {
+        return;
+    }
+    state->data_off = pktbuf_data_offset(pkt);
+    state->tail_calls = 0;
+}
+
+// Returns true if the message starts a statement of the extended query protocol.
+static __always_inline bool is_postgres_extended_query_message(struct pg_message_header *header) {
+    return header->message_tag == POSTGRES_PARSE_MAGIC_BYTE || header->message_tag == POSTGRES_BIND_MAGIC_BYTE;
 }
 
 // Entrypoint to process plaintext Postgres traffic. Pulls the connection tuple and the packet buffer from the map and
 // calls the main processing function. If the packet is a TCP termination, it calls the termination function.
-// If the message is a parse message, it tail calls to the dedicated function to handle it as it is too large to be
-// inlined in the main entrypoint. Otherwise, it calls the main processing function.
-SEC("socket/postgres_process")
-int socket__postgres_process(struct __sk_buff* skb) {
+// If the message starts a statement of the extended query protocol, it tail calls to the dedicated function to handle it
+// as it is too large to be inlined in the main entrypoint. Otherwise, it calls the main processing function.
+static __always_inline int __socket__postgres_process(struct __sk_buff* skb) {
     skb_info_t skb_info = {};
     conn_tuple_t conn_tuple = {};
 
@@ -220,8 +433,10 @@ int socket__postgres_process(struct __sk_buff* skb) {
         return 0;
     }
 
-    // If the message is a parse message, we tail call to the dedicated function to handle it.
-    if (header.message_tag == POSTGRES_PARSE_MAGIC_BYTE) {
+    // If the message starts a statement of the extended query protocol, we tail call to the dedicated function to
+    // handle it.
+    if (is_postgres_extended_query_message(&header)) {
+        postgres_reset_pipeline_parser_state(pkt);
         bpf_tail_call_compat(skb, &protocols_progs, PROG_POSTGRES_PROCESS_PARSE_MESSAGE);
         return 0;
     }
@@ -230,10 +445,16 @@ int socket__postgres_process(struct __sk_buff* skb) {
     return 0;
 }
 
-// Handles plaintext Postgres Parse messages. Pulls the connection tuple and the packet buffer from the map and calls the
-// dedicated function to handle the message.
-SEC("socket/postgres_process_parse_message")
-int socket__postgres_process_parse_message(struct __sk_buff* skb) {
+SEC("socket/postgres_process")
+int socket__postgres_process(struct __sk_buff* skb) {
+    const int ret = __socket__postgres_process(skb);
+    usm_cpu_cost_end();
+    return ret;
+}
+
+// Handles the plaintext Postgres extended query protocol messages. Pulls the connection tuple and the packet buffer from
+// the map and calls the dedicated function to handle the next statement, then tail calls itself for the following one.
+static __always_inline int __socket__postgres_process_parse_message(struct __sk_buff* skb) {
     skb_info_t skb_info = {};
     conn_tuple_t conn_tuple = {};
 
@@ -244,15 +465,23 @@ int socket__postgres_process_parse_message(struct __sk_buff* skb) {
     normalize_tuple(&conn_tuple);
 
     pktbuf_t pkt = pktbuf_from_skb(skb, &skb_info);
-    postgres_handle_parse_message(pkt, &conn_tuple);
+    if (postgres_handle_parse_message(pkt, &conn_tuple)) {
+        bpf_tail_call_compat(skb, &protocols_progs, PROG_POSTGRES_PROCESS_PARSE_MESSAGE);
+    }
     return 0;
 }
 
+SEC("socket/postgres_process_parse_message")
+int socket__postgres_process_parse_message(struct __sk_buff* skb) {
+    const int ret = __socket__postgres_process_parse_message(skb);
+    usm_cpu_cost_end();
+    return ret;
+}
+
 // Entrypoint to process TLS Postgres traffic. Pulls the connection tuple and the packet buffer from the map and calls
-// the main processing function. If the packet is a Parse message, it tail calls to the dedicated function to handle it.
-// Otherwise, it calls the main processing function.
-SEC("uprobe/postgres_tls_process")
-int uprobe__postgres_tls_process(struct pt_regs *ctx) {
+// the main processing function. If the packet starts a statement of the extended query protocol, it tail calls to the
+// dedicated function to handle it. Otherwise, it calls the main processing function.
+static __always_inline int __uprobe__postgres_tls_process(struct pt_regs *ctx) {
     const __u32 zero = 0;
 
     tls_dispatcher_arguments_t *args = bpf_map_lookup_elem(&tls_dispatcher_arguments, &zero);
@@ -269,8 +498,10 @@ int uprobe__postgres_tls_process(struct pt_regs *ctx) {
         return 0;
     }
 
-    // If the message is a parse message, we tail call to the dedicated function to handle it.
-    if (header.message_tag == POSTGRES_PARSE_MAGIC_BYTE) {
+    // If the message starts a statement of the extended query protocol, we tail call to the dedicated function to
+    // handle it.
+    if (is_postgres_extended_query_message(&header)) {
+        postgres_reset_pipeline_parser_state(pkt);
         bpf_tail_call_compat(ctx, &tls_process_progs, TLS_PROG_POSTGRES_PROCESS_PARSE_MESSAGE);
         return 0;
     }
@@ -278,10 +509,16 @@ int uprobe__postgres_tls_process(struct pt_regs *ctx) {
     return 0;
 }
 
-// Handles TLS Postgres Parse messages. Pulls the connection tuple and the packet buffer from the map and calls the
-// dedicated function to handle the message.
-SEC("uprobe/postgres_tls_process_parse_message")
-int uprobe__postgres_tls_process_parse_message(struct pt_regs *ctx) {
+SEC("uprobe/postgres_tls_process")
+int uprobe__postgres_tls_process(struct pt_regs *ctx) {
+    const int ret = __uprobe__postgres_tls_process(ctx);
+    usm_cpu_cost_end();
+    return ret;
+}
+
+// Handles the TLS Postgres extended query protocol messages. Pulls the connection tuple and the packet buffer from the
+// map and calls the dedicated function to handle the next statement, then tail calls itself for the following one.
+static __always_inline int __uprobe__postgres_tls_process_parse_message(struct pt_regs *ctx) {
     const __u32 zero = 0;
 
     tls_dispatcher_arguments_t *args = bpf_map_lookup_elem(&tls_dispatcher_arguments, &zero);
@@ -293,13 +530,21 @@ int uprobe__postgres_tls_process_parse_message(struct pt_regs *ctx) {
     conn_tuple_t tup = args->tup;
 
     pktbuf_t pkt = pktbuf_from_tls(args);
-    postgres_handle_parse_message(pkt, &tup);
+    if (postgres_handle_parse_message(pkt, &tup)) {
+        bpf_tail_call_compat(ctx, &tls_process_progs, TLS_PROG_POSTGRES_PROCESS_PARSE_MESSAGE);
+    }
     return 0;
 }
 
+SEC("uprobe/postgres_tls_process_parse_message")
+int uprobe__postgres_tls_process_parse_message(struct pt_regs *ctx) {
+    const int ret = __uprobe__postgres_tls_process_parse_message(ctx);
+    usm_cpu_cost_end();
+    return ret;
+}
+
 // Handles connection termination for a TLS Postgres connection.
-SEC("uprobe/postgres_tls_termination")
-int uprobe__postgres_tls_termination(struct pt_regs *ctx) {
+static __always_inline int __uprobe__postgres_tls_termination(struct pt_regs *ctx) {
     const __u32 zero = 0;
 
     tls_dispatcher_arguments_t *args = bpf_map_lookup_elem(&tls_dispatcher_arguments, &zero);
@@ -313,4 +558,11 @@ int uprobe__postgres_tls_termination(struct pt_regs *ctx) {
     return 0;
 }
 
+SEC("uprobe/postgres_tls_termination")
+int uprobe__postgres_tls_termination(struct pt_regs *ctx) {
+    const int ret = __uprobe__postgres_tls_termination(ctx);
+    usm_cpu_cost_end();
+    return ret;
+}
+
 #endif
@@ -29,10 +29,19 @@
 #define POSTGRES_QUERY_MAGIC_BYTE 'Q'
 #define POSTGRES_PARSE_MAGIC_BYTE 'P'
 #define POSTGRES_COMMAND_COMPLETE_MAGIC_BYTE 'C'
+#define POSTGRES_BIND_MAGIC_BYTE 'B'
+// Execute and ErrorResponse share their tag, the former is sent by the client and the latter by the server.
+#define POSTGRES_EXECUTE_MAGIC_BYTE 'E'
+#define POSTGRES_ERROR_RESPONSE_MAGIC_BYTE 'E'
 
 #define POSTGRES_PING_BODY "-- ping"
 #define NULL_TERMINATOR '\0'
 
+// FNV-1a parameters of the query fingerprint.
+#define POSTGRES_FINGERPRINT_OFFSET_BASIS 14695981039346656037ULL
+#define POSTGRES_FINGERPRINT_PRIME 1099511628211ULL
+#define POSTGRES_STRING_LITERAL_QUOTE '\''
+
 #define POSTGRES_SKIP_STRING_ITERATIONS 8
 #define SKIP_STRING_FAILED 0
 
@@ -12,16 +12,47 @@
 // Maximum number of Postgres messages we can parse for a single packet.
 #define POSTGRES_MAX_MESSAGES 80
 
+// Maximum number of queries of a connection parsed or awaiting their response. Must be a power of 2.
+#define POSTGRES_MAX_PIPELINED_QUERIES 4
+
+// Maximum number of tail calls parsing the extended query protocol messages of a single packet. Each tail call handles
+// a single statement.
+#define POSTGRES_MAX_PIPELINE_TAIL_CALLS 8
+
 // Postgres transaction information we store in the kernel.
 typedef struct {
     // The Postgres query we are currently parsing. Stored up to POSTGRES_BUFFER_SIZE bytes.
     char request_fragment[POSTGRES_BUFFER_SIZE];
     __u64 request_started;
     __u64 response_last_seen;
+    // The hash of request_fragment ignoring its literals, shared by the executions of a statement with different
+    // values. 0 if the query couldn't be read.
+    __u64 fingerprint;
     // The actual size of the query stored in request_fragment.
     __u32 original_query_size;
 } postgres_transaction_t;
 
+// The queries of a connection, kept in a ring. The queries between head and tail await their response, matched in
+// order against the CommandComplete messages, and those between tail and parsed were parsed but not executed yet.
+typedef struct {
+    postgres_transaction_t queries[POSTGRES_MAX_PIPELINED_QUERIES];
+    // The last time a query was pushed or popped, used by the map cleaner.
+    __u64 last_seen;
+    // Free-running indexes of the ring.
+    __u32 head;
+    __u32 tail;
+    __u32 parsed;
+    // The number of queries executed while the ring was full. Their responses are skipped once the ring is drained.
+    __u32 overflow;
+} postgres_pipeline_t;
+
+// The state of the extended query protocol parser, kept across its tail calls.
+typedef struct {
+    // The offset of the next message to parse in the current packet.
+    __u32 data_off;
+    __u8 tail_calls;
+} postgres_pipeline_parser_state_t;
+
 // The struct we send to userspace, containing the connection tuple and the transaction information.
 typedef struct {
     conn_tuple_t tuple;
@@ -0,0 +1,148 @@
+#ifndef __REDIS_DECODING_H
+#define __REDIS_DECODING_H
+
+#include "bpf_builtins.h"
+#include "bpf_telemetry.h"
+
+#include "protocols/cpu-cost.h"
+#include "protocols/helpers/pktbuf.h"
+#include "protocols/redis/decoding-maps.h"
+#include "protocols/redis/defs.h"
+#include "protocols/redis/types.h"
+#include "protocols/redis/usm-events.h"
+#include "protocols/read_into_buffer.h"
+
+PKTBUF_READ_INTO_BUFFER(redis_request, REDIS_BUFFER_SIZE, BLK_SIZE)
+
+// Enqueues a batch of events to the user-space. To spare stack size, we take a scratch buffer from the map, copy
+// the connection tuple and the transaction to it, and then enqueue the event.
+static __always_inline void redis_batch_enqueue_wrapper(conn_tuple_t *tuple, redis_transaction_t *tx) {
+    u32 zero = 0;
+    redis_event_t *event = bpf_map_lookup_elem(&redis_scratch_buffer, &zero);
+    if (!event) {
+        return;
+    }
+
+    bpf_memcpy(&event->tuple, tuple, sizeof(conn_tuple_t));
+    // The stats are keyed by the normalized tuple, like the other protocols.
+    normalize_tuple(&event->tuple);
+    bpf_memcpy(&event->tx, tx, sizeof(redis_transaction_t));
+    redis_batch_enqueue(event);
+}
+
+// Extracts the name of the command from the request, sent by the clients as an array of bulk strings whose first
+// element is the name, as in "*2\r\n$3\r\nGET\r\n$3\r\nkey\r\n". The name is upper-cased, as the commands are case
+// insensitive. Returns the length of the name, or 0 if the buffer doesn't hold a command.
+static __always_inline __u8 redis_read_command(const char *buf, char *command) {
+    if (buf[0] != REDIS_ARRAY_PREFIX) {
+        return 0;
+    }
+
+    // The number of lines ended so far: the name starts after the array header and the bulk string header.
+    __u8 lines = 0;
+    __u8 len = 0;
+#pragma unroll(REDIS_BUFFER_SIZE - 1)
+    for (int i = 1; i < REDIS_BUFFER_SIZE; i++) {
+        char c = buf[i];
+        if (c == '\r') {
+            if (lines == 2) {
+                break;
+            }
+            lines++;
+            continue;
+        }
+        if (lines < 2 || c == '\n') {
+            continue;
+        }
+        if ('a' <= c && c <= 'z') {
+            c -= 'a' - 'A';
+        } else if (c < 'A' || c > 'Z') {
+            return 0;
+        }
+        if (len < REDIS_MAX_COMMAND_LEN) {
+            command[len] = c;
+            len++;
+        }
+    }
+
+    return lines == 2 ? len : 0;
+}
+
+// Handles a request, starting a transaction unless a command of the connection already awaits its reply. Only the
+// first command of a pipeline is timed, until its reply is seen.
+static __always_inline void redis_handle_request(pktbuf_t pkt, conn_tuple_t *tup) {
+    char buf[REDIS_BUFFER_SIZE];
+    bpf_memset(buf, 0, sizeof(buf));
+    pktbuf_read_into_buffer_redis_request(buf, pkt, pktbuf_data_offset(pkt));
+
+    redis_transaction_t tx = {};
+    tx.command_len = redis_read_command(buf, tx.command);
+    if (tx.command_len == 0) {
+        return;
+    }
+    tx.request_started = bpf_ktime_get_ns();
+    bpf_map_update_with_telemetry(redis_in_flight, tup, &tx, BPF_NOEXIST);
+}
+
+// Handles a reply to the in-flight transaction, enqueuing it to userspace.
+static __always_inline void redis_handle_response(pktbuf_t pkt, conn_tuple_t *tup, redis_transaction_t *tx) {
+    char prefix = 0;
+    pktbuf_load_bytes(pkt, pktbuf_data_offset(pkt), &prefix, sizeof(prefix));
+    tx->is_error = prefix == REDIS_ERROR_PREFIX;
+    tx->response_last_seen = bpf_ktime_get_ns();
+    redis_batch_enqueue_wrapper(tup, tx);
+}
+
+// Processes a Redis packet. The direction of the packet is found by looking up the in-flight transaction of the
+// reversed tuple: a packet is a reply if a request was sent the other way, and a request otherwise.
+static __always_inline void redis_entrypoint(pktbuf_t pkt, conn_tuple_t *tup) {
+    if (pktbuf_data_offset(pkt) >= pktbuf_data_end(pkt)) {
+        return;
+    }
+
+    conn_tuple_t request_tup = *tup;
+    flip_tuple(&request_tup);
+    redis_transaction_t *tx = bpf_map_lookup_elem(&redis_in_flight, &request_tup);
+    if (tx != NULL) {
+        redis_handle_response(pkt, &request_tup, tx);
+        bpf_map_delete_elem(&redis_in_flight, &request_tup);
+        return;
+    }
+
+    redis_handle_request(pkt, tup);
+}
+
+static __always_inline void redis_tcp_termination(conn_tuple_t *tup) {
+    bpf_map_delete_elem(&redis_in_flight, tup);
+    flip_tuple(tup);
+    bpf_map_delete_elem(&redis_in_flight, tup);
+}
+
+// Entrypoint to process plaintext Redis traffic. Pulls the connection tuple and the packet buffer from the map and
+// calls the main processing function. If the packet is a TCP termination, it calls the termination function.
+static __always_inline int __socket__redis_process(struct __sk_buff* skb) {
+    skb_info_t skb_info = {};
+    conn_tuple_t conn_tuple = {};
+
+    if (!fetch_dispatching_arguments(&conn_tuple, &skb_info)) {
+        return 0;
+    }
+
+    if (is_tcp_termination(&skb_info)) {
+        redis_tcp_termination(&conn_tuple);
+        return 0;
+    }
+
+    pktbuf_t pkt = pktbuf_from_skb(skb, &skb_info);
+    redis_entrypoint(pkt, &conn_tuple);
+    return 0;
+}
+
+SEC("socket/redis_process")
+int socket__redis_process(struct __sk_buff* skb) {
+    const int ret = __socket__redis_process(skb);
+    usm_cpu_cost_end();
+    return ret;
+}
+
+#endif
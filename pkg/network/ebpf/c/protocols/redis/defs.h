@@ -3,4 +3,9 @@
 
 #define REDIS_MIN_FRAME_LENGTH 3
 
+// The first byte of the RESP arrays, used by the clients to send the commands.
+#define REDIS_ARRAY_PREFIX '*'
+// The first byte of the RESP error replies.
+#define REDIS_ERROR_PREFIX '-'
+
 #endif
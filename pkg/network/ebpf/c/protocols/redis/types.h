@@ -0,0 +1,33 @@
+#ifndef __REDIS_TYPES_H
+#define __REDIS_TYPES_H
+
+#include "conn_tuple.h"
+
+// Controls the number of Redis transactions read from userspace at a time.
+#define REDIS_BATCH_SIZE 25
+
+// Number of bytes of a request read to extract the name of its command.
+#define REDIS_BUFFER_SIZE 32
+
+// Maximum length of the command name sent to userspace, the longer names are truncated.
+#define REDIS_MAX_COMMAND_LEN 16
+
+// Redis transaction information we store in the kernel.
+typedef struct {
+    // The upper-cased name of the command, stored up to REDIS_MAX_COMMAND_LEN bytes.
+    char command[REDIS_MAX_COMMAND_LEN];
+    __u64 request_started;
+    __u64 response_last_seen;
+    // The size of the name stored in command.
+    __u8 command_len;
+    // Whether the reply is an error, starting with '-'.
+    __u8 is_error;
+} redis_transaction_t;
+
+// The struct we send to userspace, containing the connection tuple and the transaction information.
+typedef struct {
+    conn_tuple_t tuple;
+    redis_transaction_t tx;
+} redis_event_t;
+
+#endif
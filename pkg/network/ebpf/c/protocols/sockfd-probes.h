@@ -33,7 +33,11 @@ int kprobe__tcp_close(struct pt_regs *ctx) {
 
     // Copy map value to stack so we can use it as a map key (needed for older kernels)
     pid_fd_t pid_fd_copy = *pid_fd;
-    bpf_map_delete_elem(&tuple_by_pid_fd, &pid_fd_copy);
+    // The FD may have been closed and reused by another connection already, whose entry must stay.
+    conn_tuple_t *fd_tuple = bpf_map_lookup_elem(&tuple_by_pid_fd, &pid_fd_copy);
+    if (fd_tuple != NULL && is_equal(fd_tuple, &t)) {
+        bpf_map_delete_elem(&tuple_by_pid_fd, &pid_fd_copy);
+    }
     bpf_map_delete_elem(&pid_fd_by_tuple, &t);
 
     // The cleanup of the map happens either during TCP termination or during the TLS shutdown event.
@@ -50,9 +54,8 @@ int kprobe__sockfd_lookup_light(struct pt_regs *ctx) {
     u64 pid_tgid = bpf_get_current_pid_tgid();
 
     // Check if have already a map entry for this pid_fd_t
-    // TODO: This lookup eliminates *4* map operations for existing entries
-    // but can reduce the accuracy of programs relying on socket FDs for
-    // processes with a lot of FD churn
+    // This lookup eliminates *4* map operations for existing entries. The
+    // entries are removed when their FD is closed, so a reused FD is indexed again.
     pid_fd_t key = {
         .pid = pid_tgid >> 32,
         .fd = sockfd,
@@ -66,6 +69,20 @@ int kprobe__sockfd_lookup_light(struct pt_regs *ctx) {
     return 0;
 }
 
+// Invalidates the connection of a socket FD when it is closed, as the FD number can be reused right away by another
+// connection, which kprobe__sockfd_lookup_light would otherwise skip. The connection itself may outlive the FD, as
+// another FD or process may share it, so pid_fd_by_tuple is left to tcp_close.
+SEC("tracepoint/syscalls/sys_enter_close")
+int tracepoint__syscalls__sys_enter_close(enter_sys_close_ctx *args) {
+    u64 pid_tgid = bpf_get_current_pid_tgid();
+    pid_fd_t key = {
+        .pid = pid_tgid >> 32,
+        .fd = args->fd,
+    };
+    bpf_map_delete_elem(&tuple_by_pid_fd, &key);
+    return 0;
+}
+
 static __always_inline const struct proto_ops * socket_proto_ops(struct socket *sock) {
     const struct proto_ops *proto_ops = NULL;
 #ifdef COMPILE_PREBUILT
@@ -13,8 +13,21 @@
 // * Value the socket FD;
 BPF_HASH_MAP(sockfd_lookup_args, __u64, __u32, 1024)
 
-BPF_HASH_MAP(tuple_by_pid_fd, pid_fd_t, conn_tuple_t, 1024)
+// The indexes between the socket FDs and the connections. They are LRU maps sized from the max_tracked_connections
+// configuration, so the processes with many sockets evict the least used ones instead of failing the new updates.
+// The entries are removed when the FD is closed, and when the connection is.
+BPF_LRU_MAP(tuple_by_pid_fd, pid_fd_t, conn_tuple_t, 1024)
 
-BPF_HASH_MAP(pid_fd_by_tuple, conn_tuple_t, pid_fd_t, 1024)
+BPF_LRU_MAP(pid_fd_by_tuple, conn_tuple_t, pid_fd_t, 1024)
+
+typedef struct {
+    unsigned short common_type;
+    unsigned char common_flags;
+    unsigned char common_preempt_count;
+    int common_pid;
+    long __syscall_nr;
+
+    unsigned int fd;
+} enter_sys_close_ctx;
 
 #endif
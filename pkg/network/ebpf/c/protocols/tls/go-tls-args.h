@@ -0,0 +1,38 @@
+#ifndef __GO_TLS_ARGS_H
+#define __GO_TLS_ARGS_H
+
+#include "protocols/tls/go-tls-location.h"
+#include "protocols/tls/go-tls-types.h"
+
+// With the stack ABI, the arguments live in the caller's frame, which is untouched by the time the callee returns.
+// The return probes, attached to the RET instructions rather than as uretprobes, find them at the same offsets
+// from the stack pointer as the entry probes. In that case the entry probes aren't attached, and the arguments
+// aren't saved in the go_tls_read_args and go_tls_write_args maps.
+static __always_inline bool go_tls_read_args_on_stack(tls_offsets_data_t *od) {
+    return !od->read_conn_pointer.in_register && !od->read_buffer.ptr.in_register;
+}
+
+static __always_inline bool go_tls_write_args_on_stack(tls_offsets_data_t *od) {
+    return !od->write_conn_pointer.in_register && !od->write_buffer.ptr.in_register && !od->write_buffer.len.in_register;
+}
+
+// func (c *Conn) Read(b []byte) (int, error)
+static __always_inline int read_go_tls_read_args(struct pt_regs *ctx, tls_offsets_data_t *od, go_tls_read_args_data_t *call_data) {
+    if (read_location(ctx, &od->read_conn_pointer, sizeof(call_data->conn_pointer), &call_data->conn_pointer)) {
+        return 1;
+    }
+    return read_location(ctx, &od->read_buffer.ptr, sizeof(call_data->b_data), &call_data->b_data);
+}
+
+// func (c *Conn) Write(b []byte) (int, error)
+static __always_inline int read_go_tls_write_args(struct pt_regs *ctx, tls_offsets_data_t *od, go_tls_write_args_data_t *call_data) {
+    if (read_location(ctx, &od->write_conn_pointer, sizeof(call_data->conn_pointer), &call_data->conn_pointer)) {
+        return 1;
+    }
+    if (read_location(ctx, &od->write_buffer.ptr, sizeof(call_data->b_data), &call_data->b_data)) {
+        return 1;
+    }
+    return read_location(ctx, &od->write_buffer.len, sizeof(call_data->b_len), &call_data->b_len);
+}
+
+#endif //__GO_TLS_ARGS_H
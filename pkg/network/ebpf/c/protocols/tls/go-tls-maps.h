@@ -9,6 +9,10 @@
 // offsets_data map contains the information about the locations of structs in the inspected binary, mapped by the binary's inode number.
 BPF_HASH_MAP(offsets_data, go_tls_offsets_data_key_t, tls_offsets_data_t, 1024)
 
+/* go_tls_offsets_data_keys caches the offsets_data key of the binary of each process, so that the uprobes don't
+   have to walk the task's mm->exe_file->f_inode on every call. The key is indexed by tgid. */
+BPF_LRU_MAP(go_tls_offsets_data_keys, __u32, go_tls_offsets_data_cache_t, 1024)
+
 /* go_tls_read_args is used to get the read function info when running in the read-return uprobe.
    The key contains the go routine id and the pid. */
 BPF_LRU_MAP(go_tls_read_args, go_tls_function_args_key_t, go_tls_read_args_data_t, 2048)
@@ -45,6 +45,12 @@ typedef struct {
     __u64 ino;
 } go_tls_offsets_data_key_t;
 
+typedef struct {
+    // the mm of the task the key was read from, it changes on exec
+    __u64 mm;
+    go_tls_offsets_data_key_t key;
+} go_tls_offsets_data_cache_t;
+
 typedef struct {
     goroutine_id_metadata_t goroutine_id;
     tls_conn_layout_t conn_layout;
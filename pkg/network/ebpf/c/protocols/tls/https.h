@@ -21,6 +21,7 @@
 #include "protocols/amqp/helpers.h"
 #include "protocols/classification/dispatcher-helpers.h"
 #include "protocols/classification/dispatcher-maps.h"
+#include "protocols/cpu-cost.h"
 #include "protocols/http/buffer.h"
 #include "protocols/http/types.h"
 #include "protocols/http/maps.h"
@@ -30,6 +31,7 @@
 #include "protocols/tls/native-tls-maps.h"
 #include "protocols/tls/tags-types.h"
 #include "protocols/tls/tls-maps.h"
+#include "protocols/usm-filter.h"
 
 static __always_inline void http_process(http_event_t *event, skb_info_t *skb_info, __u64 tags);
 
@@ -59,7 +61,13 @@ update_stack:
     set_protocol(stack, proto);
 }
 
-static __always_inline void tls_process(struct pt_regs *ctx, conn_tuple_t *t, void *buffer_ptr, size_t len, __u64 tags) {
+// Returns true if the connection is classified as a protocol which isn't decoded over TLS, so the callers can skip
+// the following payloads of the connection.
+static __always_inline bool tls_process(struct pt_regs *ctx, conn_tuple_t *t, void *buffer_ptr, size_t len, __u64 tags) {
+    if (!is_usm_task_monitored() || !is_usm_tuple_monitored(t)) {
+        return false;
+    }
+
     conn_tuple_t final_tuple = {0};
     conn_tuple_t normalized_tuple = *t;
     normalize_tuple(&normalized_tuple);
@@ -68,7 +76,7 @@ static __always_inline void tls_process(struct pt_regs *ctx, conn_tuple_t *t, vo
 
     protocol_stack_t *stack = get_protocol_stack(&normalized_tuple);
     if (!stack) {
-        return;
+        return false;
     }
 
     const __u32 zero = 0;
@@ -76,7 +84,7 @@ static __always_inline void tls_process(struct pt_regs *ctx, conn_tuple_t *t, vo
     if (protocol == PROTOCOL_UNKNOWN) {
         char *request_fragment = bpf_map_lookup_elem(&tls_classification_heap, &zero);
         if (request_fragment == NULL) {
-            return;
+            return false;
         }
         read_into_user_buffer_classification(request_fragment, buffer_ptr);
 
@@ -84,10 +92,10 @@ static __always_inline void tls_process(struct pt_regs *ctx, conn_tuple_t *t, vo
         protocol = get_protocol_from_stack(stack, LAYER_APPLICATION);
         // Could have a maybe_is_kafka() function to do an initial check here based on the
         // fragment buffer without the tail call.
-        if (is_kafka_monitoring_enabled() && protocol == PROTOCOL_UNKNOWN) {
+        if (is_kafka_monitoring_enabled() && protocol == PROTOCOL_UNKNOWN && is_usm_protocol_enabled_for_task(PROTOCOL_KAFKA)) {
             tls_dispatcher_arguments_t *args = bpf_map_lookup_elem(&tls_dispatcher_arguments, &zero);
             if (args == NULL) {
-                return;
+                return false;
             }
             *args = (tls_dispatcher_arguments_t){
                 .tup = *t,
@@ -117,14 +125,22 @@ static __always_inline void tls_process(struct pt_regs *ctx, conn_tuple_t *t, vo
         prog = TLS_POSTGRES;
         final_tuple = normalized_tuple;
         break;
+    case PROTOCOL_UNKNOWN:
+        // Not classified yet, the next payloads may be.
+        return false;
     default:
-        return;
+        return true;
+    }
+
+    // the protocol isn't decoded for the processes of this cgroup
+    if (!is_usm_protocol_enabled_for_task(protocol)) {
+        return true;
     }
 
     tls_dispatcher_arguments_t *args = bpf_map_lookup_elem(&tls_dispatcher_arguments, &zero);
     if (args == NULL) {
         log_debug("dispatcher failed to save arguments for tls tail call");
-        return;
+        return false;
     }
     *args = (tls_dispatcher_arguments_t){
         .tup = final_tuple,
@@ -133,7 +149,9 @@ static __always_inline void tls_process(struct pt_regs *ctx, conn_tuple_t *t, vo
         .data_end = len,
         .data_off = 0,
     };
+    usm_cpu_cost_start(protocol, true);
     bpf_tail_call_compat(ctx, &tls_process_progs, prog);
+    return false;
 }
 
 static __always_inline void tls_dispatch_kafka(struct pt_regs *ctx)
@@ -166,6 +184,7 @@ static __always_inline void tls_dispatch_kafka(struct pt_regs *ctx)
     }
 
     set_protocol(stack, PROTOCOL_KAFKA);
+    usm_cpu_cost_start(PROTOCOL_KAFKA, true);
     bpf_tail_call_compat(ctx, &tls_process_progs, TLS_KAFKA);
 }
 
@@ -217,6 +236,7 @@ static __always_inline void tls_finish(struct pt_regs *ctx, conn_tuple_t *t, boo
     }
     bpf_memset(args, 0, sizeof(tls_dispatcher_arguments_t));
     bpf_memcpy(&args->tup, &final_tuple, sizeof(conn_tuple_t));
+    usm_cpu_cost_start(protocol, true);
     bpf_tail_call_compat(ctx, &tls_process_progs, prog);
 }
 
@@ -257,6 +277,20 @@ static __always_inline conn_tuple_t* tup_from_ssl_ctx(void *ssl_ctx, u64 pid_tgi
     return &ssl_sock->tup;
 }
 
+// Returns true if the payloads of the SSL session are not decoded, in which case the uprobes return right away.
+static __always_inline bool is_ssl_sock_ignored(void *ssl_ctx) {
+    ssl_sock_t *ssl_sock = bpf_map_lookup_elem(&ssl_sock_by_ctx, &ssl_ctx);
+    return ssl_sock != NULL && ssl_sock->ignored;
+}
+
+// Marks the SSL session as classified as a protocol which isn't decoded over TLS.
+static __always_inline void ignore_ssl_sock(void *ssl_ctx) {
+    ssl_sock_t *ssl_sock = bpf_map_lookup_elem(&ssl_sock_by_ctx, &ssl_ctx);
+    if (ssl_sock != NULL) {
+        ssl_sock->ignored = true;
+    }
+}
+
 static __always_inline void init_ssl_sock(void *ssl_ctx, u32 socket_fd) {
     ssl_sock_t ssl_sock = { 0 };
     ssl_sock.fd = socket_fd;
@@ -288,17 +322,32 @@ static __always_inline void map_ssl_ctx_to_sock(struct sock *skp) {
 static __always_inline tls_offsets_data_t* get_offsets_data() {
     struct task_struct *t = (struct task_struct *) bpf_get_current_task();
     struct inode *inode;
-    go_tls_offsets_data_key_t key;
+    go_tls_offsets_data_cache_t cache = {};
+    go_tls_offsets_data_key_t *key = &cache.key;
     dev_t dev_id;
+    __u32 tgid = bpf_get_current_pid_tgid() >> 32;
+
+    struct mm_struct *mm = BPF_CORE_READ(t, mm);
+    if (!mm) {
+        log_debug("get_offsets_data: could not read mm field");
+        return NULL;
+    }
+    cache.mm = (__u64)mm;
+
+    // the process executed another binary if its mm changed
+    go_tls_offsets_data_cache_t *cached = bpf_map_lookup_elem(&go_tls_offsets_data_keys, &tgid);
+    if (cached && cached->mm == cache.mm) {
+        return bpf_map_lookup_elem(&offsets_data, &cached->key);
+    }
 
-    inode = BPF_CORE_READ(t, mm, exe_file, f_inode);
+    inode = BPF_CORE_READ(mm, exe_file, f_inode);
     if (!inode) {
         log_debug("get_offsets_data: could not read f_inode field");
         return NULL;
     }
 
     int err;
-    err = BPF_CORE_READ_INTO(&key.ino, inode, i_ino);
+    err = BPF_CORE_READ_INTO(&key->ino, inode, i_ino);
     if (err) {
         log_debug("get_offsets_data: could not read i_ino field");
         return NULL;
@@ -310,12 +359,13 @@ static __always_inline tls_offsets_data_t* get_offsets_data() {
         return NULL;
     }
 
-    key.device_id_major = MAJOR(dev_id);
-    key.device_id_minor = MINOR(dev_id);
+    key->device_id_major = MAJOR(dev_id);
+    key->device_id_minor = MINOR(dev_id);
 
-    log_debug("get_offsets_data: task binary inode number: %llu; device ID %x:%x", key.ino, key.device_id_major, key.device_id_minor);
+    log_debug("get_offsets_data: task binary inode number: %llu; device ID %x:%x", key->ino, key->device_id_major, key->device_id_minor);
 
-    return bpf_map_lookup_elem(&offsets_data, &key);
+    bpf_map_update_elem(&go_tls_offsets_data_keys, &tgid, &cache, BPF_ANY);
+    return bpf_map_lookup_elem(&offsets_data, key);
 }
 
 #endif
@@ -22,6 +22,7 @@ static int __always_inline is_usm_erpc_request(struct pt_regs *ctx) {
 */
 
 static void __always_inline handle_erpc_request(struct pt_regs *ctx) {
+    const u32 zero = 0;
     #ifdef DEBUG
         u64 pid_tgid = bpf_get_current_pid_tgid();
         u64 pid = pid_tgid >> 32;
@@ -43,6 +44,10 @@ static void __always_inline handle_erpc_request(struct pt_regs *ctx) {
         }
     #endif
 
+    // The handlers read their data from the map, as the BATCH handler dispatches an operation located further in
+    // the request.
+    void *data = req + 1;
+    bpf_map_update_elem(&java_tls_erpc_data, &zero, &data, BPF_ANY);
     bpf_tail_call_compat(ctx, &java_tls_erpc_handlers, op);
 }
 
@@ -2,12 +2,18 @@
 #define __ERPC_HANDLERS_H
 
 #include "conn_tuple.h"
+#include "protocols/tls/java/maps.h"
+#include "protocols/tls/java/types.h"
 #include "protocols/tls/tags-types.h"
 #include "protocols/tls/https.h"
 #include "port_range.h"
 
-// macro to get the data pointer from the ctx, we skip the 1st byte as it is the operation byte read by the erpc dispatcher
-#define GET_DATA_PTR(ctx) ((void *)(PT_REGS_PARM4(ctx) + 1))
+// returns the data pointer of the operation being handled, as stored by the erpc dispatcher after the operation byte
+static __always_inline void *get_erpc_data_ptr() {
+    const u32 zero = 0;
+    void **data = bpf_map_lookup_elem(&java_tls_erpc_data, &zero);
+    return data != NULL ? *data : NULL;
+}
 
 /*
   handle_sync_payload's pseudo format of *data that contains the http payload
@@ -27,7 +33,10 @@ int kprobe_handle_sync_payload(struct pt_regs *ctx) {
     u32 bytes_read = 0;
 
     //interactive pointer to read the data buffer
-    void* bufferPtr = GET_DATA_PTR(ctx);
+    void* bufferPtr = get_erpc_data_ptr();
+    if (bufferPtr == NULL) {
+        return 1;
+    }
 
     //read the connection tuple from the ioctl buffer
     if (0 != bpf_probe_read_user(&connection, sizeof(conn_tuple_t), bufferPtr)){
@@ -62,7 +71,10 @@ int kprobe_handle_sync_payload(struct pt_regs *ctx) {
 SEC("kprobe/handle_close_connection")
 int kprobe_handle_close_connection(struct pt_regs *ctx) {
     //interactive pointer to read the data buffer
-    void* bufferPtr = GET_DATA_PTR(ctx);
+    void* bufferPtr = get_erpc_data_ptr();
+    if (bufferPtr == NULL) {
+        return 1;
+    }
     //read the connection tuple from the ioctl buffer
     conn_tuple_t connection = {0};
     if (0 != bpf_probe_read_user(&connection, sizeof(conn_tuple_t), bufferPtr)){
@@ -94,7 +106,10 @@ int kprobe_handle_connection_by_peer(struct pt_regs *ctx) {
     peer_key.pid = pid_tgid >> 32;
 
     //interactive pointer to read the data buffer
-    void* bufferPtr = GET_DATA_PTR(ctx);
+    void* bufferPtr = get_erpc_data_ptr();
+    if (bufferPtr == NULL) {
+        return 1;
+    }
 
     //read the connection tuple from the ioctl buffer
     conn_tuple_t connection = {0};
@@ -131,7 +146,10 @@ int kprobe_handle_async_payload(struct pt_regs *ctx) {
     u32 bytes_read = 0;
 
     //interactive pointer to read the data buffer
-    void* bufferPtr = GET_DATA_PTR(ctx);
+    void* bufferPtr = get_erpc_data_ptr();
+    if (bufferPtr == NULL) {
+        return 1;
+    }
 
     connection_by_peer_key_t peer_key ={0};
     peer_key.pid = bpf_get_current_pid_tgid() >> 32;
@@ -177,4 +195,81 @@ int kprobe_handle_async_payload(struct pt_regs *ctx) {
     return 0;
 }
 
+/*
+  handle_batch registers many connections at once, and then dispatches the operation following them, if any, so the
+  java tracer can send the registrations of several connections along with a payload in a single ioctl.
+
+  struct {
+      u32 count;                          // up to MAX_BATCH_CONNECTIONS
+      struct {
+          conn_tuple_t connection;
+          peer_t peer;
+      } connections[count];               // same as the CONNECTION_BY_PEER operation
+      u8 operation;                       // MAX_MESSAGE_TYPE if no operation follows the batch
+      u8 data[];                          // data of the operation
+  }
+
+  As the payload and close operations end in a tail call, at most one of them can be handled per request.
+*/
+SEC("kprobe/handle_batch")
+int kprobe_handle_batch(struct pt_regs *ctx) {
+    connection_by_peer_key_t peer_key = {0};
+    peer_key.pid = bpf_get_current_pid_tgid() >> 32;
+    conn_tuple_t connection = {0};
+    u32 count = 0;
+
+    //interactive pointer to read the data buffer
+    void* bufferPtr = get_erpc_data_ptr();
+    if (bufferPtr == NULL) {
+        return 1;
+    }
+
+    if (0 != bpf_probe_read_user(&count, sizeof(count), bufferPtr)){
+        log_debug("[handle_batch] failed reading the number of connections for pid %d", peer_key.pid);
+        return 1;
+    }
+    bufferPtr+=sizeof(count);
+    if (count > MAX_BATCH_CONNECTIONS) {
+        log_debug("[handle_batch] too many connections (%d) for pid %d", count, peer_key.pid);
+        return 1;
+    }
+
+#pragma unroll
+    for (int i = 0; i < MAX_BATCH_CONNECTIONS; i++) {
+        if (i >= count) {
+            break;
+        }
+        if (0 != bpf_probe_read_user(&connection, sizeof(conn_tuple_t), bufferPtr)){
+            log_debug("[handle_batch] failed to parse connection info for pid: %d", peer_key.pid);
+            return 1;
+        }
+        normalize_tuple(&connection);
+        bufferPtr+=sizeof(conn_tuple_t);
+
+        if (0 != bpf_probe_read_user(&peer_key.peer, sizeof(peer_t), bufferPtr)){
+            log_debug("[handle_batch] failed reading peer tuple information for pid %d", peer_key.pid);
+            return 1;
+        }
+        bufferPtr+=sizeof(peer_t);
+
+        bpf_map_update_elem(&java_conn_tuple_by_peer, &peer_key, &connection, BPF_ANY);
+    }
+
+    u8 op = 0;
+    if (0 != bpf_probe_read_user(&op, sizeof(op), bufferPtr)){
+        log_debug("[handle_batch] failed to parse trailing opcode for pid %d", peer_key.pid);
+        return 1;
+    }
+    // a batch can't be nested in another one
+    if (op == BATCH || op >= MAX_MESSAGE_TYPE) {
+        return 0;
+    }
+
+    const u32 zero = 0;
+    bufferPtr+=sizeof(op);
+    bpf_map_update_elem(&java_tls_erpc_data, &zero, &bufferPtr, BPF_ANY);
+    bpf_tail_call_compat(ctx, &java_tls_erpc_handlers, op);
+    return 0;
+}
+
 #endif // __ERPC_HANDLERS_H
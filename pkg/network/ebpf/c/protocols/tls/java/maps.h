@@ -24,4 +24,8 @@ BPF_HASH_MAP(java_conn_tuple_by_peer, connection_by_peer_key_t, conn_tuple_t, 1)
 */
 BPF_PROG_ARRAY(java_tls_erpc_handlers, MAX_MESSAGE_TYPE)
 
+/* The address of the data of the eRPC operation being handled, following its operation byte. It is set by the
+   dispatcher, and moved forward by the BATCH handler before it dispatches the operation trailing the batch. */
+BPF_PERCPU_ARRAY_MAP(java_tls_erpc_data, void *, 1)
+
 #endif // __JAVA_MAPS_H
@@ -7,11 +7,15 @@
 // as it increases the size of structs defined below.
 #define MAX_DOMAIN_NAME_LENGTH 48
 
+// The maximum number of connections registered by a single BATCH eRPC request.
+#define MAX_BATCH_CONNECTIONS 32
+
 enum erpc_message_type {
     SYNCHRONOUS_PAYLOAD,
     CLOSE_CONNECTION,
     CONNECTION_BY_PEER,
     ASYNC_PAYLOAD,
+    BATCH,
     MAX_MESSAGE_TYPE,
 };
 
@@ -100,6 +100,9 @@ int uprobe__SSL_read(struct pt_regs *ctx) {
     args.buf = (void *)PT_REGS_PARM2(ctx);
     u64 pid_tgid = bpf_get_current_pid_tgid();
     log_debug("uprobe/SSL_read: pid_tgid=%llx ctx=%p", pid_tgid, args.ctx);
+    if (is_ssl_sock_ignored(args.ctx)) {
+        return 0;
+    }
     bpf_map_update_with_telemetry(ssl_read_args, &pid_tgid, &args, BPF_ANY);
 
     // Trigger mapping of SSL context to connection tuple in case it is missing.
@@ -137,7 +140,9 @@ static __always_inline int SSL_read_ret(struct pt_regs *ctx, __u64 tags) {
     // We want to guarantee write-TLS hooks generates the same connection tuple, while read-TLS hooks generate
     // the inverse direction, thus we're normalizing the tuples into a client <-> server direction.
     normalize_tuple(&copy);
-    tls_process(ctx, &copy, buffer_ptr, len, tags);
+    if (tls_process(ctx, &copy, buffer_ptr, len, tags)) {
+        ignore_ssl_sock(ssl_ctx);
+    }
     return 0;
 cleanup:
     bpf_map_delete_elem(&ssl_read_args, &pid_tgid);
@@ -166,6 +171,9 @@ int uprobe__SSL_write(struct pt_regs* ctx) {
     args.buf = (void *)PT_REGS_PARM2(ctx);
     u64 pid_tgid = bpf_get_current_pid_tgid();
     log_debug("uprobe/SSL_write: pid_tgid=%llx ctx=%p", pid_tgid, args.ctx);
+    if (is_ssl_sock_ignored(args.ctx)) {
+        return 0;
+    }
     bpf_map_update_with_telemetry(ssl_write_args, &pid_tgid, &args, BPF_ANY);
     return 0;
 }
@@ -183,7 +191,8 @@ static __always_inline int SSL_write_ret(struct pt_regs* ctx, __u64 flags) {
         return 0;
     }
 
-    conn_tuple_t *t = tup_from_ssl_ctx(args->ctx, pid_tgid);
+    void *ssl_ctx = args->ctx;
+    conn_tuple_t *t = tup_from_ssl_ctx(ssl_ctx, pid_tgid);
     if (t == NULL) {
         goto cleanup;
     }
@@ -197,7 +206,9 @@ static __always_inline int SSL_write_ret(struct pt_regs* ctx, __u64 flags) {
     // to the server <-> client direction.
     normalize_tuple(&copy);
     flip_tuple(&copy);
-    tls_process(ctx, &copy, buffer_ptr, write_len, flags);
+    if (tls_process(ctx, &copy, buffer_ptr, write_len, flags)) {
+        ignore_ssl_sock(ssl_ctx);
+    }
     return 0;
 cleanup:
     bpf_map_delete_elem(&ssl_write_args, &pid_tgid);
@@ -227,6 +238,9 @@ int uprobe__SSL_read_ex(struct pt_regs* ctx) {
     args.size_out_param = (size_t *)PT_REGS_PARM4(ctx);
     u64 pid_tgid = bpf_get_current_pid_tgid();
     log_debug("uprobe/SSL_read_ex: pid_tgid=%llx ctx=%p", pid_tgid, args.ctx);
+    if (is_ssl_sock_ignored(args.ctx)) {
+        return 0;
+    }
     bpf_map_update_elem(&ssl_read_ex_args, &pid_tgid, &args, BPF_ANY);
 
     // Trigger mapping of SSL context to connection tuple in case it is missing.
@@ -276,7 +290,9 @@ static __always_inline int SSL_read_ex_ret(struct pt_regs* ctx, __u64 tags) {
     // We want to guarantee write-TLS hooks generates the same connection tuple, while read-TLS hooks generate
     // the inverse direction, thus we're normalizing the tuples into a client <-> server direction.
     normalize_tuple(&copy);
-    tls_process(ctx, &copy, buffer_ptr, bytes_count, tags);
+    if (tls_process(ctx, &copy, buffer_ptr, bytes_count, tags)) {
+        ignore_ssl_sock(ssl_ctx);
+    }
     return 0;
 cleanup:
     bpf_map_delete_elem(&ssl_read_ex_args, &pid_tgid);
@@ -301,6 +317,9 @@ int uprobe__SSL_write_ex(struct pt_regs* ctx) {
     args.size_out_param = (size_t *)PT_REGS_PARM4(ctx);
     u64 pid_tgid = bpf_get_current_pid_tgid();
     log_debug("uprobe/SSL_write_ex: pid_tgid=%llx ctx=%p", pid_tgid, args.ctx);
+    if (is_ssl_sock_ignored(args.ctx)) {
+        return 0;
+    }
     bpf_map_update_elem(&ssl_write_ex_args, &pid_tgid, &args, BPF_ANY);
     return 0;
 }
@@ -331,7 +350,8 @@ static __always_inline int SSL_write_ex_ret(struct pt_regs* ctx, __u64 tags) {
         goto cleanup;
     }
 
-    conn_tuple_t *conn_tuple = tup_from_ssl_ctx(args->ctx, pid_tgid);
+    void *ssl_ctx = args->ctx;
+    conn_tuple_t *conn_tuple = tup_from_ssl_ctx(ssl_ctx, pid_tgid);
     if (conn_tuple == NULL) {
         log_debug("uretprobe/SSL_write_ex: pid_tgid=%llx: no conn tuple", pid_tgid);
         goto cleanup;
@@ -346,7 +366,9 @@ static __always_inline int SSL_write_ex_ret(struct pt_regs* ctx, __u64 tags) {
     // to the server <-> client direction.
     normalize_tuple(&copy);
     flip_tuple(&copy);
-    tls_process(ctx, &copy, buffer_ptr, bytes_count, tags);
+    if (tls_process(ctx, &copy, buffer_ptr, bytes_count, tags)) {
+        ignore_ssl_sock(ssl_ctx);
+    }
     return 0;
 cleanup:
     bpf_map_delete_elem(&ssl_write_ex_args, &pid_tgid);
@@ -453,6 +475,9 @@ int uprobe__gnutls_record_recv(struct pt_regs *ctx) {
     };
     u64 pid_tgid = bpf_get_current_pid_tgid();
     log_debug("gnutls_record_recv: pid=%llu ctx=%p", pid_tgid, ssl_session);
+    if (is_ssl_sock_ignored(ssl_session)) {
+        return 0;
+    }
     bpf_map_update_with_telemetry(ssl_read_args, &pid_tgid, &args, BPF_ANY);
     return 0;
 }
@@ -488,7 +513,9 @@ int uretprobe__gnutls_record_recv(struct pt_regs *ctx) {
     // We want to guarantee write-TLS hooks generates the same connection tuple, while read-TLS hooks generate
     // the inverse direction, thus we're normalizing the tuples into a client <-> server direction.
     normalize_tuple(&copy);
-    tls_process(ctx, &copy, buffer_ptr, read_len, LIBGNUTLS);
+    if (tls_process(ctx, &copy, buffer_ptr, read_len, LIBGNUTLS)) {
+        ignore_ssl_sock(ssl_session);
+    }
     return 0;
 cleanup:
     bpf_map_delete_elem(&ssl_read_args, &pid_tgid);
@@ -503,6 +530,9 @@ int uprobe__gnutls_record_send(struct pt_regs *ctx) {
     args.buf = (void *)PT_REGS_PARM2(ctx);
     u64 pid_tgid = bpf_get_current_pid_tgid();
     log_debug("uprobe/gnutls_record_send: pid=%llu ctx=%p", pid_tgid, args.ctx);
+    if (is_ssl_sock_ignored(args.ctx)) {
+        return 0;
+    }
     bpf_map_update_with_telemetry(ssl_write_args, &pid_tgid, &args, BPF_ANY);
     return 0;
 }
@@ -521,7 +551,8 @@ int uretprobe__gnutls_record_send(struct pt_regs *ctx) {
         return 0;
     }
 
-    conn_tuple_t *t = tup_from_ssl_ctx(args->ctx, pid_tgid);
+    void *ssl_ctx = args->ctx;
+    conn_tuple_t *t = tup_from_ssl_ctx(ssl_ctx, pid_tgid);
     if (t == NULL) {
         goto cleanup;
     }
@@ -535,7 +566,9 @@ int uretprobe__gnutls_record_send(struct pt_regs *ctx) {
     // to the server <-> client direction.
     normalize_tuple(&copy);
     flip_tuple(&copy);
-    tls_process(ctx, &copy, buffer_ptr, write_len, LIBGNUTLS);
+    if (tls_process(ctx, &copy, buffer_ptr, write_len, LIBGNUTLS)) {
+        ignore_ssl_sock(ssl_ctx);
+    }
     return 0;
 cleanup:
     bpf_map_delete_elem(&ssl_write_args, &pid_tgid);
@@ -13,4 +13,24 @@ enum static_tags {
     NODEJS = (1<<6),
 };
 
+// bits of tls_info_t.offered_versions
+#define TLS_VERSION10_BIT (1<<0)
+#define TLS_VERSION11_BIT (1<<1)
+#define TLS_VERSION12_BIT (1<<2)
+#define TLS_VERSION13_BIT (1<<3)
+
+// bits of tls_info_t.alpn_requested and tls_info_t.alpn_chosen, the values of the Windows driver
+#define TLS_ALPN_HTTP2 (1<<0)
+#define TLS_ALPN_HTTP11 (1<<1)
+
+// TLS handshake details of a connection, parsed from its ClientHello and ServerHello by the
+// classifier when tls_handshake_tags_enabled() is set
+typedef struct {
+    __u16 chosen_version;
+    __u16 cipher_suite;
+    __u8 offered_versions;
+    __u8 alpn_requested;
+    __u8 alpn_chosen;
+} tls_info_t;
+
 #endif
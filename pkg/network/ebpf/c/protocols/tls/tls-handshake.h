@@ -0,0 +1,189 @@
+#ifndef __TLS_HANDSHAKE_H
+#define __TLS_HANDSHAKE_H
+
+#include "ktypes.h"
+#include "compiler.h"
+#include "ip.h"
+
+#include "protocols/tls/tags-types.h"
+#include "protocols/tls/tls.h"
+
+/* https://www.rfc-editor.org/rfc/rfc8446#section-4.1.2 Client Hello */
+
+#define TLS_HANDSHAKE_HEADER_LEN 4
+#define TLS_RANDOM_LEN 32
+
+#define TLS_EXTENSION_ALPN 0x0010
+#define TLS_EXTENSION_SUPPORTED_VERSIONS 0x002b
+
+// maximum number of extensions walked through to find the supported_versions and ALPN ones
+#define TLS_MAX_EXTENSIONS 16
+// maximum number of entries read from the supported_versions extension of a ClientHello
+#define TLS_MAX_SUPPORTED_VERSIONS 8
+// maximum number of protocols read from the ALPN extension of a ClientHello
+#define TLS_MAX_ALPN_PROTOCOLS 4
+
+// "h2" and "http/1.1", as read by __load_half and __load_word
+#define ALPN_H2 0x6832
+#define ALPN_HTTP 0x68747470
+#define ALPN_SLASH_1_1 0x2f312e31
+
+static __always_inline bool tls_handshake_tags_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("tls_handshake_tags_enabled", val);
+    return val > 0;
+}
+
+static __always_inline __u8 tls_version_bit(__u16 version) {
+    switch (version) {
+    case TLS_VERSION10:
+        return TLS_VERSION10_BIT;
+    case TLS_VERSION11:
+        return TLS_VERSION11_BIT;
+    case TLS_VERSION12:
+        return TLS_VERSION12_BIT;
+    case TLS_VERSION13:
+        return TLS_VERSION13_BIT;
+    }
+    return 0;
+}
+
+// tls_alpn_bit returns the bit of the ALPN protocol of length len at offset off, 0 if it isn't a known one
+static __always_inline __u8 tls_alpn_bit(struct __sk_buff *skb, __u32 off, __u8 len) {
+    if (len == 2 && __load_half(skb, off) == ALPN_H2) {
+        return TLS_ALPN_HTTP2;
+    }
+    if (len == 8 && __load_word(skb, off) == ALPN_HTTP && __load_word(skb, off + 4) == ALPN_SLASH_1_1) {
+        return TLS_ALPN_HTTP11;
+    }
+    return 0;
+}
+
+// tls_find_extensions walks through the extensions starting at off and ending at end, and stores the offsets of the
+// data of the supported_versions and ALPN extensions, which are left to 0 when missing
+static __always_inline void tls_find_extensions(struct __sk_buff *skb, __u32 off, __u32 end, __u32 *supported_versions, __u32 *alpn) {
+#pragma unroll
+    for (int i = 0; i < TLS_MAX_EXTENSIONS; i++) {
+        if (off + 4 > end) {
+            return;
+        }
+        __u16 type = __load_half(skb, off);
+        __u16 len = __load_half(skb, off + 2);
+        if (type == TLS_EXTENSION_SUPPORTED_VERSIONS) {
+            *supported_versions = off + 4;
+        } else if (type == TLS_EXTENSION_ALPN) {
+            *alpn = off + 4;
+        }
+        off += 4 + len;
+    }
+}
+
+// tls_parse_client_hello fills the versions and ALPN protocols offered by the ClientHello whose handshake header is at
+// off. Only the part of the message carried by the packet is parsed.
+static __always_inline void tls_parse_client_hello(struct __sk_buff *skb, __u32 off, __u32 end, tls_info_t *tags) {
+    off += TLS_HANDSHAKE_HEADER_LEN;
+    __u16 legacy_version = __load_half(skb, off);
+    off += sizeof(__u16) + TLS_RANDOM_LEN;
+    // session id
+    off += 1 + __load_byte(skb, off);
+    // cipher suites
+    off += sizeof(__u16) + __load_half(skb, off);
+    // compression methods
+    off += 1 + __load_byte(skb, off);
+    if (off + sizeof(__u16) > end) {
+        tags->offered_versions |= tls_version_bit(legacy_version);
+        return;
+    }
+    __u32 extensions_end = off + sizeof(__u16) + __load_half(skb, off);
+    if (extensions_end > end) {
+        extensions_end = end;
+    }
+
+    __u32 supported_versions = 0;
+    __u32 alpn = 0;
+    tls_find_extensions(skb, off + sizeof(__u16), extensions_end, &supported_versions, &alpn);
+
+    if (supported_versions == 0) {
+        tags->offered_versions |= tls_version_bit(legacy_version);
+    } else {
+        __u8 list_len = __load_byte(skb, supported_versions);
+#pragma unroll
+        for (int i = 0; i < TLS_MAX_SUPPORTED_VERSIONS; i++) {
+            if (i * sizeof(__u16) >= list_len) {
+                break;
+            }
+            tags->offered_versions |= tls_version_bit(__load_half(skb, supported_versions + 1 + i * sizeof(__u16)));
+        }
+    }
+
+    if (alpn == 0) {
+        return;
+    }
+    __u32 protocols_end = alpn + sizeof(__u16) + __load_half(skb, alpn);
+    off = alpn + sizeof(__u16);
+#pragma unroll
+    for (int i = 0; i < TLS_MAX_ALPN_PROTOCOLS; i++) {
+        if (off >= protocols_end) {
+            break;
+        }
+        __u8 len = __load_byte(skb, off);
+        tags->alpn_requested |= tls_alpn_bit(skb, off + 1, len);
+        off += 1 + len;
+    }
+}
+
+// tls_parse_server_hello fills the version, cipher suite and ALPN protocol chosen by the ServerHello whose handshake
+// header is at off
+static __always_inline void tls_parse_server_hello(struct __sk_buff *skb, __u32 off, __u32 end, tls_info_t *tags) {
+    off += TLS_HANDSHAKE_HEADER_LEN;
+    __u16 legacy_version = __load_half(skb, off);
+    off += sizeof(__u16) + TLS_RANDOM_LEN;
+    // session id
+    off += 1 + __load_byte(skb, off);
+    tags->cipher_suite = __load_half(skb, off);
+    // cipher suite and compression method
+    off += sizeof(__u16) + 1;
+
+    __u32 supported_versions = 0;
+    __u32 alpn = 0;
+    if (off + sizeof(__u16) <= end) {
+        __u32 extensions_end = off + sizeof(__u16) + __load_half(skb, off);
+        if (extensions_end > end) {
+            extensions_end = end;
+        }
+        tls_find_extensions(skb, off + sizeof(__u16), extensions_end, &supported_versions, &alpn);
+    }
+
+    // TLS 1.3 negotiates its version in the supported_versions extension, the legacy one being 1.2
+    tags->chosen_version = supported_versions ? __load_half(skb, supported_versions) : legacy_version;
+    if (alpn) {
+        // the list of a ServerHello holds the single protocol chosen
+        tags->alpn_chosen |= tls_alpn_bit(skb, alpn + sizeof(__u16) + 1, __load_byte(skb, alpn + sizeof(__u16)));
+    }
+}
+
+// tls_process_handshake fills the TLS tags of a connection from the ClientHello or ServerHello starting the payload
+// of the packet. buf holds the beginning of the payload.
+static __always_inline void tls_process_handshake(struct __sk_buff *skb, skb_info_t *skb_info, const char *buf, __u32 buf_size, tls_info_t *tags) {
+    if (!tls_handshake_tags_enabled() || buf_size < (sizeof(tls_record_header_t) + sizeof(tls_hello_message_t))) {
+        return;
+    }
+
+    tls_record_header_t *tls_record_header = (tls_record_header_t *)buf;
+    if (tls_record_header->content_type != TLS_HANDSHAKE) {
+        return;
+    }
+
+    __u32 off = skb_info->data_off + sizeof(tls_record_header_t);
+    tls_hello_message_t *msg = (tls_hello_message_t *)(buf + sizeof(tls_record_header_t));
+    switch (msg->handshake_type) {
+    case TLS_HANDSHAKE_CLIENT_HELLO:
+        tls_parse_client_hello(skb, off, skb_info->data_end, tags);
+        break;
+    case TLS_HANDSHAKE_SERVER_HELLO:
+        tls_parse_server_hello(skb, off, skb_info->data_end, tags);
+        break;
+    }
+}
+
+#endif
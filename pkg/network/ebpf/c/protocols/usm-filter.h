@@ -0,0 +1,88 @@
+#ifndef __USM_FILTER_H
+#define __USM_FILTER_H
+
+#include "ktypes.h"
+#include "bpf_helpers.h"
+#include "map-defs.h"
+
+#include "conn_tuple.h"
+#include "protocols/classification/defs.h"
+
+// The USM filter restricts the monitoring to a set of ports and cgroups, so that the traffic of
+// the other services exits before any classification or map update.
+
+// Number of 64-bit words of the port bitmap, one bit per port
+#define USM_PORT_FILTER_WORDS (65536 / 64)
+
+// Bitmap of the ports monitored by USM: a connection is monitored if one of its ports is set.
+// Only used when the `usm_port_filter_enabled` constant is set.
+BPF_ARRAY_MAP(usm_port_filter, __u64, USM_PORT_FILTER_WORDS)
+
+// Set of the cgroup IDs monitored by the TLS uprobes. Only used when the `usm_cgroup_filter_enabled`
+// constant is set. Socket filters don't run in the context of the process owning the socket, so
+// they only use the port bitmap.
+BPF_HASH_MAP(usm_cgroup_filter, __u64, __u8, 1)
+
+// Maps the cgroup IDs whose TLS decoding is restricted to some protocols to the bitmap of these protocols, bit N being
+// set for the protocol number N of the application layer. Only used when the `usm_cgroup_protocols_enabled` constant
+// is set, with the same restriction to the TLS uprobes as the cgroup filter.
+BPF_HASH_MAP(usm_cgroup_protocols, __u64, __u32, 1)
+
+static __always_inline bool is_usm_port_filter_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("usm_port_filter_enabled", val);
+    return val > 0;
+}
+
+static __always_inline bool is_usm_cgroup_filter_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("usm_cgroup_filter_enabled", val);
+    return val > 0;
+}
+
+static __always_inline bool is_usm_cgroup_protocols_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("usm_cgroup_protocols_enabled", val);
+    return val > 0;
+}
+
+static __always_inline bool is_usm_port_monitored(__u16 port) {
+    const __u32 key = port / 64;
+    __u64 *word = bpf_map_lookup_elem(&usm_port_filter, &key);
+    return word != NULL && (*word & (1ULL << (port % 64))) != 0;
+}
+
+// is_usm_tuple_monitored returns false if the port filter is enabled and none of the ports of the tuple is monitored
+static __always_inline bool is_usm_tuple_monitored(conn_tuple_t *tup) {
+    if (!is_usm_port_filter_enabled()) {
+        return true;
+    }
+
+    return is_usm_port_monitored(tup->sport) || is_usm_port_monitored(tup->dport);
+}
+
+// is_usm_task_monitored returns false if the cgroup filter is enabled and the cgroup of the current task is not
+// monitored. The calls to `bpf_get_current_cgroup_id` are removed from the bytecode when the filter is disabled,
+// as it requires a 4.18 kernel.
+static __always_inline bool is_usm_task_monitored() {
+    if (!is_usm_cgroup_filter_enabled()) {
+        return true;
+    }
+
+    __u64 cgroup_id = bpf_get_current_cgroup_id();
+    return bpf_map_lookup_elem(&usm_cgroup_filter, &cgroup_id) != NULL;
+}
+
+// is_usm_protocol_enabled_for_task returns false if the protocols decoded for the cgroup of the current task are
+// restricted, and the given application protocol isn't one of them.
+static __always_inline bool is_usm_protocol_enabled_for_task(protocol_t protocol) {
+    if (!is_usm_cgroup_protocols_enabled()) {
+        return true;
+    }
+
+    __u64 cgroup_id = bpf_get_current_cgroup_id();
+    __u32 *protocols = bpf_map_lookup_elem(&usm_cgroup_protocols, &cgroup_id);
+    return protocols == NULL || (*protocols & (1U << (protocol & 0x1f))) != 0;
+}
+
+#endif
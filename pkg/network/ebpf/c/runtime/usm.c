@@ -12,19 +12,25 @@
 #include "sock.h"
 #include "port_range.h"
 
+#include "protocols/amqp/decoding.h"
 #include "protocols/classification/dispatcher-helpers.h"
+#include "protocols/classification/gc.h"
 #include "protocols/http/buffer.h"
 #include "protocols/http/http.h"
 #include "protocols/http2/decoding.h"
 #include "protocols/http2/decoding-tls.h"
 #include "protocols/kafka/kafka-parsing.h"
+#include "protocols/mongo/decoding.h"
+#include "protocols/mysql/decoding.h"
 #include "protocols/postgres/decoding.h"
+#include "protocols/redis/decoding.h"
 #include "protocols/sockfd-probes.h"
 #include "protocols/tls/java/erpc_dispatcher.h"
 #include "protocols/tls/java/erpc_handlers.h"
 #include "protocols/tls/go-tls-types.h"
 #include "protocols/tls/go-tls-goid.h"
 #include "protocols/tls/go-tls-location.h"
+#include "protocols/tls/go-tls-args.h"
 #include "protocols/tls/go-tls-conn.h"
 #include "protocols/tls/https.h"
 #include "protocols/tls/native-tls.h"
@@ -72,6 +78,18 @@ int tracepoint__net__netif_receive_skb(struct pt_regs* ctx) {
     terminated_http2_batch_flush(ctx);
     kafka_batch_flush(ctx);
     postgres_batch_flush(ctx);
+    redis_batch_flush(ctx);
+    amqp_batch_flush(ctx);
+    mysql_batch_flush(ctx);
+    mongo_batch_flush(ctx);
+    return 0;
+}
+
+// Arms the timer of the classification garbage collector, only loaded on the kernels supporting bpf_timer, see
+// protocols/classification/gc.h.
+SEC("tracepoint/net/netif_receive_skb")
+int tracepoint__net__netif_receive_skb_classification_gc(void *ctx) {
+    classification_gc_arm();
     return 0;
 }
 
@@ -129,59 +147,67 @@ int uprobe__crypto_tls_Conn_Write__return(struct pt_regs *ctx) {
         return 0;
     }
 
-    // Read the PID and goroutine ID to make the partial call key
-    go_tls_function_args_key_t call_key = {0};
-    call_key.pid = pid;
-
-    if (read_goroutine_id(ctx, &od->goroutine_id, &call_key.goroutine_id)) {
-        log_debug("[go-tls-write-return] failed reading go routine id for pid %llu", pid);
-        return 0;
+    go_tls_write_args_data_t call_data = {0};
+    if (go_tls_write_args_on_stack(od)) {
+        if (read_go_tls_write_args(ctx, od, &call_data)) {
+            log_debug("[go-tls-write-return] failed reading write arguments for pid %llu", pid);
+            return 0;
+        }
+    } else {
+        // Read the PID and goroutine ID to make the partial call key
+        go_tls_function_args_key_t call_key = {0};
+        call_key.pid = pid;
+
+        if (read_goroutine_id(ctx, &od->goroutine_id, &call_key.goroutine_id)) {
+            log_debug("[go-tls-write-return] failed reading go routine id for pid %llu", pid);
+            return 0;
+        }
+
+        go_tls_write_args_data_t *call_data_ptr = bpf_map_lookup_elem(&go_tls_write_args, &call_key);
+        if (call_data_ptr == NULL) {
+            log_debug("[go-tls-write-return] no write information in write-return for pid %llu", pid);
+            return 0;
+        }
+        bpf_memcpy(&call_data, call_data_ptr, sizeof(call_data));
+        bpf_map_delete_elem(&go_tls_write_args, &call_key);
     }
 
     uint64_t bytes_written = 0;
     if (read_location(ctx, &od->write_return_bytes, sizeof(bytes_written), &bytes_written)) {
-        bpf_map_delete_elem(&go_tls_write_args, &call_key);
         log_debug("[go-tls-write-return] failed reading write return bytes location for pid %llu", pid);
         return 0;
     }
 
     if (bytes_written <= 0) {
-        bpf_map_delete_elem(&go_tls_write_args, &call_key);
         log_debug("[go-tls-write-return] write returned non-positive for amount of bytes written for pid: %llu", pid);
         return 0;
     }
 
     uint64_t err_ptr = 0;
     if (read_location(ctx, &od->write_return_error, sizeof(err_ptr), &err_ptr)) {
-        bpf_map_delete_elem(&go_tls_write_args, &call_key);
         log_debug("[go-tls-write-return] failed reading write return error location for pid %llu", pid);
         return 0;
     }
 
     // check if err != nil
     if (err_ptr != 0) {
-        bpf_map_delete_elem(&go_tls_write_args, &call_key);
         log_debug("[go-tls-write-return] error in write for pid %llu: data will be ignored", pid);
         return 0;
     }
 
-    go_tls_write_args_data_t *call_data_ptr = bpf_map_lookup_elem(&go_tls_write_args, &call_key);
-    if (call_data_ptr == NULL) {
-        bpf_map_delete_elem(&go_tls_write_args, &call_key);
-        log_debug("[go-tls-write-return] no write information in write-return for pid %llu", pid);
-        return 0;
-    }
-
-    conn_tuple_t *t = conn_tup_from_tls_conn(od, (void*)call_data_ptr->conn_pointer, pid_tgid);
+    conn_tuple_t *t = conn_tup_from_tls_conn(od, (void*)call_data.conn_pointer, pid_tgid);
     if (t == NULL) {
         log_debug("[go-tls-write-return] failed getting conn tup from tls conn for pid %llu", pid);
-        bpf_map_delete_elem(&go_tls_write_args, &call_key);
         return 0;
     }
 
-    char *buffer_ptr = (char*)call_data_ptr->b_data;
+    char *buffer_ptr = (char*)call_data.b_data;
+    if (go_tls_write_args_on_stack(od)) {
+        // Write may have sliced off the head of `b` (as with the 1/n-1 record splitting of TLS 1.0), but the end of the
+        // buffer doesn't move, and as the write succeeded, all its bytes were written.
+        buffer_ptr = (char*)(call_data.b_data + call_data.b_len - bytes_written);
+    }
     log_debug("[go-tls-write] processing %s", buffer_ptr);
-    bpf_map_delete_elem(&go_tls_write_args, &call_key);
     conn_tuple_t copy = {0};
     bpf_memcpy(&copy, t, sizeof(conn_tuple_t));
     // We want to guarantee write-TLS hooks generates the same connection tuple, while read-TLS hooks generate
@@ -239,29 +265,38 @@ int uprobe__crypto_tls_Conn_Read__return(struct pt_regs *ctx) {
         return 0;
     }
 
-    // On 4.14 kernels we suffered from a verifier issue, that lost track on `call_key` and failed later when accessing
-    // to it. The workaround was to delay its creation, so we're getting the goroutine separately.
-    __s64 goroutine_id = 0;
-    // Read the PID and goroutine ID to make the partial call key
-    if (read_goroutine_id(ctx, &od->goroutine_id, &goroutine_id)) {
-        log_debug("[go-tls-read-return] failed reading go routine id for pid %llu", pid);
-        return 0;
-    }
-
-    go_tls_function_args_key_t call_key = {0};
-    call_key.pid = pid;
-    call_key.goroutine_id = goroutine_id;
-
-    go_tls_read_args_data_t* call_data_ptr = bpf_map_lookup_elem(&go_tls_read_args, &call_key);
-    if (call_data_ptr == NULL) {
-        log_debug("[go-tls-read-return] no read information in read-return for pid %llu", pid);
-        return 0;
+    go_tls_read_args_data_t call_data = {0};
+    if (go_tls_read_args_on_stack(od)) {
+        if (read_go_tls_read_args(ctx, od, &call_data)) {
+            log_debug("[go-tls-read-return] failed reading read arguments for pid %llu", pid);
+            return 0;
+        }
+    } else {
+        // On 4.14 kernels we suffered from a verifier issue, that lost track on `call_key` and failed later when accessing
+        // to it. The workaround was to delay its creation, so we're getting the goroutine separately.
+        __s64 goroutine_id = 0;
+        // Read the PID and goroutine ID to make the partial call key
+        if (read_goroutine_id(ctx, &od->goroutine_id, &goroutine_id)) {
+            log_debug("[go-tls-read-return] failed reading go routine id for pid %llu", pid);
+            return 0;
+        }
+
+        go_tls_function_args_key_t call_key = {0};
+        call_key.pid = pid;
+        call_key.goroutine_id = goroutine_id;
+
+        go_tls_read_args_data_t* call_data_ptr = bpf_map_lookup_elem(&go_tls_read_args, &call_key);
+        if (call_data_ptr == NULL) {
+            log_debug("[go-tls-read-return] no read information in read-return for pid %llu", pid);
+            return 0;
+        }
+        bpf_memcpy(&call_data, call_data_ptr, sizeof(call_data));
+        bpf_map_delete_elem(&go_tls_read_args, &call_key);
     }
 
     uint64_t bytes_read = 0;
     if (read_location(ctx, &od->read_return_bytes, sizeof(bytes_read), &bytes_read)) {
         log_debug("[go-tls-read-return] failed reading return bytes location for pid %llu", pid);
-        bpf_map_delete_elem(&go_tls_read_args, &call_key);
         return 0;
     }
 
@@ -271,19 +306,16 @@ int uprobe__crypto_tls_Conn_Read__return(struct pt_regs *ctx) {
     // and make sure it's greater than zero.
     if (bytes_read <= 0) {
         log_debug("[go-tls-read-return] read returned non-positive for amount of bytes read for pid: %llu", pid);
-        bpf_map_delete_elem(&go_tls_read_args, &call_key);
         return 0;
     }
 
-    conn_tuple_t* t = conn_tup_from_tls_conn(od, (void*) call_data_ptr->conn_pointer, pid_tgid);
+    conn_tuple_t* t = conn_tup_from_tls_conn(od, (void*) call_data.conn_pointer, pid_tgid);
     if (t == NULL) {
         log_debug("[go-tls-read-return] failed getting conn tup from tls conn for pid %llu", pid);
-        bpf_map_delete_elem(&go_tls_read_args, &call_key);
         return 0;
     }
 
-    char *buffer_ptr = (char*)call_data_ptr->b_data;
-    bpf_map_delete_elem(&go_tls_read_args, (go_tls_function_args_key_t*)&call_key);
+    char *buffer_ptr = (char*)call_data.b_data;
 
     // The read tuple should be flipped (compared to the write tuple).
     // tls_process and the appropriate parsers will flip it back if needed.
@@ -6,6 +6,12 @@
 
 BPF_LRU_MAP(open_at_args, __u64, lib_path_t, 1024)
 
+/* The suffixes of the libraries reported to userspace, set by userspace from the configuration */
+BPF_ARRAY_MAP(shared_libraries_suffixes, lib_suffixes_t, 1)
+
+/* The libraries already reported to userspace, by PID. Userspace removes the entry of a process when it exits */
+BPF_LRU_MAP(shared_libraries_seen, __u32, lib_seen_t, 1024)
+
 /* This map used for notifying userspace of a shared library being loaded */
 BPF_PERF_EVENT_ARRAY_MAP(shared_libraries, __u32)
 
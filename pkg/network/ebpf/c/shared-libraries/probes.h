@@ -2,6 +2,7 @@
 #define __SHARED_LIBRARIES_PROBES_H
 
 #include "bpf_telemetry.h"
+#include "shared-libraries/maps.h"
 #include "shared-libraries/types.h"
 
 static __always_inline void fill_path_safe(lib_path_t *path, const char *path_argument) {
@@ -15,6 +16,101 @@ static __always_inline void fill_path_safe(lib_path_t *path, const char *path_ar
     }
 }
 
+// Returns true if the path is the one of a library whose name, before ".so", ends with one of the suffixes set by
+// userspace, such as libssl.so, libcrypto.so and libgnutls.so.
+//
+// The matching is done in 2 stages here, first we look if the filename finished by ".so" 6 chars forward
+// this will give us the index (where the loop) for the 2nd stage
+// 2nd stage will try to match the suffixes
+// it's done this way to avoid unroll code generation complexity and some verifier don't allow that
+static __always_inline bool is_relevant_library(lib_path_t *path) {
+    const u32 zero = 0;
+    lib_suffixes_t *table = bpf_map_lookup_elem(&shared_libraries_suffixes, &zero);
+    if (table == NULL) {
+        return false;
+    }
+
+    bool is_shared_library = false;
+#define match3chars(_base, _a,_b,_c) (path->buf[_base+i] == _a && path->buf[_base+i+1] == _b && path->buf[_base+i+2] == _c)
+    int i = 0;
+#pragma unroll
+    for (i = 0; i < LIB_PATH_MAX_SIZE - (LIB_SO_SUFFIX_SIZE); i++) {
+        if(match3chars(LIB_SUFFIX_SIZE, '.','s','o')) {
+            is_shared_library = true;
+            break;
+        }
+    }
+    if (!is_shared_library) {
+        return false;
+    }
+
+#pragma unroll
+    for (int s = 0; s < LIB_SUFFIX_MAX_COUNT; s++) {
+        lib_suffix_t *suffix = &table->suffixes[s];
+        if (suffix->buf[LIB_SUFFIX_SIZE - 1] == 0) {
+            continue;
+        }
+        bool match = true;
+#pragma unroll
+        for (int j = 0; j < LIB_SUFFIX_SIZE; j++) {
+            if (suffix->buf[j] != 0 && suffix->buf[j] != path->buf[i+j]) {
+                match = false;
+            }
+        }
+        if (match) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// FNV-1a hash of the path, used to tell apart the libraries already reported for a process.
+static __always_inline __u64 lib_path_hash(lib_path_t *path) {
+    __u64 hash = 14695981039346656037ULL;
+#pragma unroll
+    for (int i = 0; i < LIB_PATH_MAX_SIZE; i++) {
+        if (i >= path->len) {
+            break;
+        }
+        hash ^= (__u8)path->buf[i];
+        hash *= 1099511628211ULL;
+    }
+    // 0 marks the empty slots
+    return hash != 0 ? hash : 1;
+}
+
+// Returns true if the library was already reported for the process, and remembers it otherwise. When all the slots
+// of the process are taken, the slot picked by the hash is overwritten.
+static __always_inline bool is_library_seen(lib_path_t *path) {
+    __u64 hash = lib_path_hash(path);
+    lib_seen_t *seen = bpf_map_lookup_elem(&shared_libraries_seen, &path->pid);
+    if (seen == NULL) {
+        lib_seen_t new_seen = {0};
+        new_seen.hashes[0] = hash;
+        bpf_map_update_with_telemetry(shared_libraries_seen, &path->pid, &new_seen, BPF_ANY);
+        return false;
+    }
+
+    __u32 slot = LIB_SEEN_MAX_COUNT;
+#pragma unroll
+    for (int i = 0; i < LIB_SEEN_MAX_COUNT; i++) {
+        if (seen->hashes[i] == hash) {
+            return true;
+        }
+        if (seen->hashes[i] == 0 && slot == LIB_SEEN_MAX_COUNT) {
+            slot = i;
+        }
+    }
+
+    if (slot == LIB_SEEN_MAX_COUNT) {
+        slot = hash % LIB_SEEN_MAX_COUNT;
+    }
+    if (slot < LIB_SEEN_MAX_COUNT) {
+        seen->hashes[slot] = hash;
+    }
+    return false;
+}
+
 static __always_inline void do_sys_open_helper_enter(const char *filename) {
     lib_path_t path = {0};
     if (bpf_probe_read_user_with_telemetry(path.buf, sizeof(path.buf), filename) >= 0) {
@@ -36,6 +132,11 @@ static __always_inline void do_sys_open_helper_enter(const char *filename) {
         return;
     }
 
+    // The path is filtered before the open is done, so the opens of other files skip the open_at_args map.
+    if (!is_relevant_library(&path)) {
+        return;
+    }
+
     u64 pid_tgid = bpf_get_current_pid_tgid();
     path.pid = pid_tgid >> 32;
     bpf_map_update_with_telemetry(open_at_args, &pid_tgid, &path, BPF_ANY);
@@ -55,32 +156,8 @@ static __always_inline void do_sys_open_helper_exit(exit_sys_ctx *args) {
         return;
     }
 
-// Check the last 9 characters of the following libraries to ensure the file is a relevant `.so`.
-// Libraries:
-//    libssl.so -> libssl.so
-// libcrypto.so -> crypto.so
-// libgnutls.so -> gnutls.so
-//
-// The matching is done in 2 stages here, first we look if the filename finished by ".so" 6 chars forward
-// this will give us the index (where the loop) for the 2nd stage
-// 2nd stage will try to match the remaining
-// it's done this way to avoid unroll code generation complexity and some verifier don't allow that
-    bool is_shared_library = false;
-#define match3chars(_base, _a,_b,_c) (path->buf[_base+i] == _a && path->buf[_base+i+1] == _b && path->buf[_base+i+2] == _c)
-#define match6chars(_base, _a,_b,_c,_d,_e,_f) (match3chars(_base,_a,_b,_c) && match3chars(_base+3,_d,_e,_f))
-    int i = 0;
-#pragma unroll
-    for (i = 0; i < LIB_PATH_MAX_SIZE - (LIB_SO_SUFFIX_SIZE); i++) {
-        if(match3chars(6, '.','s','o')) {
-            is_shared_library = true;
-            break;
-        }
-    }
-    if (!is_shared_library) {
-        goto cleanup;
-    }
-
-    if (!match6chars(0, 'l','i','b','s','s','l') && !match6chars(0, 'c','r','y','p','t','o') && !match6chars(0, 'g','n','u','t','l','s')) {
+    // Only the first open of a library by a process reaches userspace.
+    if (is_library_seen(path)) {
         goto cleanup;
     }
 
@@ -5,6 +5,11 @@
 
 #define LIB_SO_SUFFIX_SIZE 9
 #define LIB_PATH_MAX_SIZE 120
+// The number of characters preceding ".so" which are matched against the library suffixes.
+#define LIB_SUFFIX_SIZE 6
+#define LIB_SUFFIX_MAX_COUNT 8
+// The number of libraries remembered per process, to send each of them only once to userspace.
+#define LIB_SEEN_MAX_COUNT 4
 
 typedef struct {
     __u32 pid;
@@ -12,6 +17,20 @@ typedef struct {
     char buf[LIB_PATH_MAX_SIZE];
 } lib_path_t;
 
+// A suffix is right-aligned, the leading NUL characters matching any character. An empty suffix matches nothing.
+typedef struct {
+    char buf[LIB_SUFFIX_SIZE];
+} lib_suffix_t;
+
+typedef struct {
+    lib_suffix_t suffixes[LIB_SUFFIX_MAX_COUNT];
+} lib_suffixes_t;
+
+// The hashes of the paths of the libraries already sent to userspace for a process.
+typedef struct {
+    __u64 hashes[LIB_SEEN_MAX_COUNT];
+} lib_seen_t;
+
 typedef struct {
     unsigned short common_type;
     unsigned char common_flags;
@@ -42,6 +42,13 @@ int socket__classifier_grpc(struct __sk_buff *skb) {
     return 0;
 }
 
+// run by userspace with BPF_PROG_TEST_RUN before each connections check, see flush_conn_close_events
+SEC("socket/conn_close_flush")
+int socket__conn_close_flush(struct __sk_buff *skb) {
+    flush_conn_close_events();
+    return 0;
+}
+
 SEC("kprobe/tcp_sendmsg")
 int kprobe__tcp_sendmsg(struct pt_regs *ctx) {
     u64 pid_tgid = bpf_get_current_pid_tgid();
@@ -193,9 +200,12 @@ int kprobe__tcp_close(struct pt_regs *ctx) {
     u64 pid_tgid = bpf_get_current_pid_tgid();
     sk = (struct sock *)PT_REGS_PARM1(ctx);
 
-    // Should actually delete something only if the connection never got established & increment counter
-    if (bpf_map_delete_elem(&tcp_ongoing_connect_pid, &sk) == 0) {
+    // Should actually find something only if the connection never got established & increment counter
+    tcp_ongoing_connect_t connect = {};
+    bool failed_connect = pop_failed_connect(sk, &connect);
+    if (failed_connect) {
         increment_telemetry_count(tcp_failed_connect);
+        pid_tgid = connect.pid_tgid;
     }
 
     // Get network namespace id
@@ -205,11 +215,12 @@ int kprobe__tcp_close(struct pt_regs *ctx) {
     }
     log_debug("kprobe/tcp_close: netns: %u, sport: %u, dport: %u", t.netns, t.sport, t.dport);
 
-    cleanup_conn(ctx, &t, sk);
+    bool classified = cleanup_conn(ctx, &t, sk, failed_connect ? &connect : NULL);
 
     // If protocol classification is disabled, then we don't have kretprobe__tcp_close_clean_protocols hook
-    // so, there is no one to use the map and clean it.
-    if (is_protocol_classification_supported()) {
+    // so, there is no one to use the map and clean it. Connections that were never classified don't have
+    // anything to clean either, kretprobe__tcp_close_clean_protocols then only flushes the batch.
+    if (classified && is_protocol_classification_supported()) {
         bpf_map_update_with_telemetry(tcp_close_args, &pid_tgid, &t, BPF_ANY);
     }
     return 0;
@@ -799,12 +810,18 @@ int kprobe____skb_free_datagram_locked(struct pt_regs *ctx) {
     return handle_skb_consume_udp(sk, skb, len);
 }
 
+// skb_consume_udp is passed a negative length by peeking calls, so unlike skb_free_datagram_locked
+// it doesn't need the udp_recvmsg probes to tell them apart, see enableAdvancedUDP
 SEC("kprobe/skb_consume_udp")
 int kprobe__skb_consume_udp(struct pt_regs *ctx) {
     struct sock *sk = (struct sock *)PT_REGS_PARM1(ctx);
     struct sk_buff *skb = (struct sk_buff *)PT_REGS_PARM2(ctx);
     int len = (int)PT_REGS_PARM3(ctx);
-    return handle_skb_consume_udp(sk, skb, len);
+    if (len < 0) {
+        // peeking or an error happened
+        return 0;
+    }
+    return handle_udp_recv(sk, skb, bpf_get_current_pid_tgid());
 }
 
 
@@ -898,20 +915,28 @@ int kprobe__tcp_connect(struct pt_regs *ctx) {
     log_debug("kprobe/tcp_connect: tgid: %llu, pid: %llu", pid_tgid >> 32, pid_tgid & 0xFFFFFFFF);
     struct sock *skp = (struct sock *)PT_REGS_PARM1(ctx);
 
-    bpf_map_update_with_telemetry(tcp_ongoing_connect_pid, &skp, &pid_tgid, BPF_ANY);
+    tcp_ongoing_connect_t connect = { .pid_tgid = pid_tgid, .timestamp = bpf_ktime_get_ns() };
+    bpf_map_update_with_telemetry(tcp_ongoing_connect_pid, &skp, &connect, BPF_ANY);
 
     return 0;
 }
 
+SEC("kprobe/tcp_done")
+int kprobe__tcp_done(struct pt_regs *ctx) {
+    struct sock *skp = (struct sock *)PT_REGS_PARM1(ctx);
+    record_connect_err(skp);
+    return 0;
+}
+
 SEC("kprobe/tcp_finish_connect")
 int kprobe__tcp_finish_connect(struct pt_regs *ctx) {
     struct sock *skp = (struct sock *)PT_REGS_PARM1(ctx);
-    u64 *pid_tgid_p = bpf_map_lookup_elem(&tcp_ongoing_connect_pid, &skp);
-    if (!pid_tgid_p) {
+    tcp_ongoing_connect_t *connect = bpf_map_lookup_elem(&tcp_ongoing_connect_pid, &skp);
+    if (!connect) {
         return 0;
     }
 
-    u64 pid_tgid = *pid_tgid_p;
+    u64 pid_tgid = connect->pid_tgid;
     bpf_map_delete_elem(&tcp_ongoing_connect_pid, &skp);
     log_debug("kprobe/tcp_finish_connect: tgid: %llu, pid: %llu", pid_tgid >> 32, pid_tgid & 0xFFFFFFFF);
 
@@ -979,7 +1004,7 @@ static __always_inline int handle_udp_destroy_sock(void *ctx, struct sock *skp)
 
     __u16 lport = 0;
     if (valid_tuple) {
-        cleanup_conn(ctx, &tup, skp);
+        cleanup_conn(ctx, &tup, skp, NULL);
         lport = tup.sport;
     } else {
         lport = read_sport(skp);
@@ -1097,10 +1122,19 @@ int tracepoint__net__net_dev_queue(struct net_dev_queue_ctx* ctx) {
     sock_tup.netns = 0;
     sock_tup.pid = 0;
 
-    if (!is_equal(&skb_tup, &sock_tup)) {
-        normalize_tuple(&skb_tup);
-        normalize_tuple(&sock_tup);
-        bpf_map_update_with_telemetry(conn_tuple_to_socket_skb_conn_tuple, &sock_tup, &skb_tup, BPF_NOEXIST);
+    if (is_equal(&skb_tup, &sock_tup)) {
+        return 0;
+    }
+
+    normalize_tuple(&skb_tup);
+    normalize_tuple(&sock_tup);
+    // The mapping is set by the first packet of the connection, looking it up is cheaper than failing
+    // to insert it again for each of the following packets, which also counts as a map error
+    if (bpf_map_lookup_elem(&conn_tuple_to_socket_skb_conn_tuple, &sock_tup)) {
+        return 0;
+    }
+    if (bpf_map_update_with_telemetry(conn_tuple_to_socket_skb_conn_tuple, &sock_tup, &skb_tup, BPF_NOEXIST) == 0) {
+        increment_telemetry_count(skb_conn_tuple_mappings);
     }
 
     return 0;
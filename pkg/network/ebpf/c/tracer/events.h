@@ -4,6 +4,7 @@
 #include "bpf_helpers.h"
 #include "bpf_telemetry.h"
 #include "bpf_builtins.h"
+#include "ring_buffer.h"
 
 #include "tracer/tracer.h"
 #include "tracer/maps.h"
@@ -34,59 +35,208 @@ static __always_inline void clean_protocol_classification(conn_tuple_t *tup) {
     bpf_map_delete_elem(&conn_tuple_to_socket_skb_conn_tuple, &conn_tuple);
 }
 
+static __always_inline bool ringbuffers_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("ringbuffers_enabled", val);
+    return val > 0;
+}
+
+// conn_close_batching_disabled is set on kernels older than 4.11, whose perf buffers only accept
+// stack memory: the closed connections are then sent one by one, see flush_conn_close_if_full
+static __always_inline bool conn_close_batching_disabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("conn_close_batching_disabled", val);
+    return val > 0;
+}
+
+// tcp_failed_connections_enabled is set when the closed connections report the errors of the connects that never
+// completed, see record_connect_err
+static __always_inline bool tcp_failed_connections_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("tcp_failed_connections_enabled", val);
+    return val > 0;
+}
+
+// record_connect_err saves the error of a socket whose connect didn't complete when the kernel gives up on it, in
+// tcp_done: sk_err is cleared once read by the process, before it closes the socket. There is no offset guessed
+// for sk_err, so failed connects have no error with the prebuilt tracer.
+static __always_inline void record_connect_err(struct sock *sk) {
+#if defined(COMPILE_CORE) || defined(COMPILE_RUNTIME)
+    tcp_ongoing_connect_t *connect = bpf_map_lookup_elem(&tcp_ongoing_connect_pid, &sk);
+    if (connect == NULL) {
+        return;
+    }
+    int err = 0;
+    BPF_CORE_READ_INTO(&err, sk, sk_err);
+    connect->err = err;
+#endif
+}
+
+// pop_failed_connect moves the connect of a closed socket to `connect`. Returns false if there was none, which is
+// the case of the connections that got established.
+static __always_inline bool pop_failed_connect(struct sock *sk, tcp_ongoing_connect_t *connect) {
+    tcp_ongoing_connect_t *ongoing = bpf_map_lookup_elem(&tcp_ongoing_connect_pid, &sk);
+    if (ongoing == NULL) {
+        return false;
+    }
+    *connect = *ongoing;
+    return bpf_map_delete_elem(&tcp_ongoing_connect_pid, &sk) == 0;
+}
+
+// flush_conn_close_events wakes up the consumer of the closed connections waiting in the ring buffer below the
+// wakeup watermark, see ring_buffer_flush
+static __always_inline void flush_conn_close_events() {
+    if (ringbuffers_enabled()) {
+        ring_buffer_flush(&conn_close_event);
+    }
+}
+
 __maybe_unused static __always_inline void submit_event(void *ctx, int cpu, void *event_data, size_t data_size) {
-    __u64 ringbuffers_enabled = 0;
-    LOAD_CONSTANT("ringbuffers_enabled", ringbuffers_enabled);
-    if (ringbuffers_enabled > 0) {
-        bpf_ringbuf_output(&conn_close_event, event_data, data_size, 0);
+    if (ringbuffers_enabled()) {
+        ring_buffer_output(&conn_close_event, event_data, data_size, 0);
     } else {
         bpf_perf_event_output(ctx, &conn_close_event, cpu, event_data, data_size);
     }
 }
 
-static __always_inline void cleanup_conn(void *ctx, conn_tuple_t *tup, struct sock *sk) {
-    u32 cpu = bpf_get_smp_processor_id();
-    // Will hold the full connection data to send through the perf or ring buffer
-    conn_t conn = { .tup = *tup };
+// conn_close_size returns the size of the closed connection sent on its own, leaving out the
+// sections it doesn't have. Userspace tells them apart by the sections field of the record.
+static __always_inline __u64 conn_close_size(conn_t *conn) {
+    if (!(conn->sections & CONN_SECTION_TCP)) {
+        return CONN_SIZE_NO_TCP;
+    }
+    return sizeof(conn_t);
+}
+
+// get_conn_close_batch returns the batch of closed connections of the current CPU,
+// conn_close_batch is turned into a per-CPU array along with the ring buffer
+static __always_inline batch_t *get_conn_close_batch(u32 cpu) {
+    u32 key = ringbuffers_enabled() ? 0 : cpu;
+    return bpf_map_lookup_elem(&conn_close_batch, &key);
+}
+
+// closed_conn_classified returns whether the closed connection may have left protocol
+// classification state behind, in the connection_protocol and conn_tuple_to_socket_skb_conn_tuple
+// maps. Both are looked up by update_protocol_classification_information, which records a hit in
+// the protocol stack of the connection. The socket filter only creates state for payloads, so a
+// connection that didn't exchange any bytes and has nothing left to read has none.
+static __always_inline bool closed_conn_classified(conn_t *conn, bool found, struct sock *sk) {
+    if (!found || conn->conn_stats.protocol_stack.flags&FLAG_NPM_ENABLED) {
+        return true;
+    }
+    if (conn->conn_stats.sent_bytes || conn->conn_stats.recv_bytes) {
+        return true;
+    }
+#if defined(COMPILE_CORE) || defined(COMPILE_RUNTIME)
+    __u32 qlen = 0;
+    BPF_CORE_READ_INTO(&qlen, sk, sk_receive_queue.qlen);
+    return qlen > 0;
+#else
+    // there is no offset guessed for the receive queue
+    return true;
+#endif
+}
+
+// fill_closed_conn moves the stats of the closed connection from the maps to `conn`,
+// which must be zeroed. Returns false if there is nothing to report, `classified` is
+// set otherwise, see closed_conn_classified. failed_connect is the connect of a TCP
+// socket that never got established, NULL otherwise. The TCP section of `conn` is
+// only written when is_tcp is set, it may be left out of a UDP connection.
+static __always_inline bool fill_closed_conn(conn_t *conn, conn_tuple_t *tup, struct sock *sk, tcp_ongoing_connect_t *failed_connect, bool *classified, bool is_tcp) {
+    conn->tup = *tup;
     conn_stats_ts_t *cst = NULL;
     tcp_stats_t *tst = NULL;
     u32 *retrans = NULL;
-    bool is_tcp = get_proto(&conn.tup) == CONN_TYPE_TCP;
-    bool is_udp = get_proto(&conn.tup) == CONN_TYPE_UDP;
+    bool is_udp = !is_tcp;
+    bool found = false;
+    __u32 percpu_cpus = 0;
+
+    // aggregated connections stay in conn_stats and are expired by userspace,
+    // closing one of them only bumps the flow count of the entry. Failed
+    // connects have no stats of their own and are still reported one by one.
+    conn_tuple_t key = *tup;
+    if (failed_connect == NULL && aggregate_conn(&key)) {
+        cst = bpf_map_lookup_elem(&conn_stats, &key);
+        if (cst) {
+            __sync_fetch_and_add(&cst->flow_count, 1);
+            mark_conn_touched(&key, cst);
+        }
+        return false;
+    }
+
+#ifdef PERCPU_CONN_STATS_SUPPORTED
+    percpu_cpus = percpu_conn_stats_cpus();
+    if (percpu_cpus > 0) {
+        found = fold_percpu_conn_stats(conn, percpu_cpus, is_tcp);
+    }
+#endif
 
     if (is_tcp) {
-        tst = bpf_map_lookup_elem(&tcp_stats, &(conn.tup));
-        if (tst) {
-            conn.tcp_stats = *tst;
-            bpf_map_delete_elem(&tcp_stats, &(conn.tup));
+        conn->sections |= CONN_SECTION_TCP;
+        bool retransmits_in_stats = tcp_stats_retransmits_enabled();
+        if (retransmits_in_stats) {
+            conn->tup.pid = 0;
+        }
+        if (percpu_cpus > 0) {
+            bpf_map_delete_elem(&tcp_stats, &(conn->tup));
+        } else {
+            tst = bpf_map_lookup_elem(&tcp_stats, &(conn->tup));
+            if (tst) {
+                conn->tcp_stats = *tst;
+                bpf_map_delete_elem(&tcp_stats, &(conn->tup));
+            }
         }
 
-        conn.tup.pid = 0;
-        retrans = bpf_map_lookup_elem(&tcp_retransmits, &(conn.tup));
-        if (retrans) {
-            conn.tcp_retransmits = *retrans;
-            bpf_map_delete_elem(&tcp_retransmits, &(conn.tup));
+        if (retransmits_in_stats) {
+            conn->tcp_retransmits = conn->tcp_stats.retransmits;
+        } else {
+            conn->tup.pid = 0;
+            retrans = bpf_map_lookup_elem(&tcp_retransmits, &(conn->tup));
+            if (retrans) {
+                conn->tcp_retransmits = *retrans;
+                bpf_map_delete_elem(&tcp_retransmits, &(conn->tup));
+            }
         }
-        conn.tup.pid = tup->pid;
+        conn->tup.pid = tup->pid;
 
-        conn.tcp_stats.state_transitions |= (1 << TCP_CLOSE);
+        conn->tcp_stats.state_transitions |= (1 << TCP_CLOSE);
     }
 
-    cst = bpf_map_lookup_elem(&conn_stats, &(conn.tup));
+    if (percpu_cpus == 0) {
+        cst = bpf_map_lookup_elem(&conn_stats, &(conn->tup));
+        if (cst) {
+            conn->conn_stats = *cst;
+            found = true;
+        }
+    }
 
-    if (cst) {
-        conn.conn_stats = *cst;
-        bpf_map_delete_elem(&conn_stats, &(conn.tup));
+    if (found) {
+        bpf_map_delete_elem(&conn_stats, &(conn->tup));
+        // userspace reads the deleted entry on the next poll to stop reporting it
+        mark_conn_touched(&conn->tup, NULL);
     } else {
         if (is_udp) {
             increment_telemetry_count(udp_dropped_conns);
-            return; // nothing to report
+            return false; // nothing to report
         }
         // we don't have any stats for the connection,
         // so cookie is not set, set it here
-        conn.conn_stats.cookie = get_sk_cookie(sk);
+        conn->conn_stats.cookie = get_sk_cookie(sk);
         // make sure direction is set correctly
-        determine_connection_direction(&conn.tup, &conn.conn_stats);
+        determine_connection_direction(&conn->tup, &conn->conn_stats);
+    }
+
+    if (is_tcp) {
+        *classified = closed_conn_classified(conn, found, sk);
+    }
+
+    if (is_tcp && failed_connect != NULL && tcp_failed_connections_enabled()) {
+        if (!found) {
+            // the connection only lasted from the connect, see the duration update below
+            conn->conn_stats.duration = failed_connect->timestamp;
+            conn->conn_stats.direction = CONN_DIRECTION_OUTGOING;
+        }
+        conn->tcp_stats.failed_connect_err = failed_connect->err;
     }
 
     // update the `duration` field to reflect the duration of the
@@ -94,67 +244,123 @@ static __always_inline void cleanup_conn(void *ctx, conn_tuple_t *tup, struct so
     // the conn_stats_ts_t object up to now. we re-use this field
     // for the duration since we would overrun stack size limits
     // if we added another field
-    conn.conn_stats.duration = bpf_ktime_get_ns() - conn.conn_stats.duration;
+    conn->conn_stats.duration = bpf_ktime_get_ns() - conn->conn_stats.duration;
+    return true;
+}
+
+// reserve_closed_conn fills the closed connection in place, in a record reserved in the ring
+// buffer. The record of a UDP connection leaves out the TCP section: is_tcp must be a constant,
+// so that the verifier knows the size of the record each write goes to. Returns false if no
+// record could be reserved, the ring buffer being full.
+static __always_inline bool reserve_closed_conn(conn_tuple_t *tup, struct sock *sk, tcp_ongoing_connect_t *failed_connect, bool *classified, const bool is_tcp) {
+    conn_t *conn = bpf_ringbuf_reserve(&conn_close_event, is_tcp ? sizeof(conn_t) : CONN_SIZE_NO_TCP, 0);
+    if (conn == NULL) {
+        return false;
+    }
+
+    if (is_tcp) {
+        bpf_memzero_u64(conn, sizeof(conn_t));
+    } else {
+        bpf_memset(conn, 0, CONN_SIZE_NO_TCP);
+    }
+    if (fill_closed_conn(conn, tup, sk, failed_connect, classified, is_tcp)) {
+        ring_buffer_submit(&conn_close_event, conn, 0);
+    } else {
+        bpf_ringbuf_discard(conn, 0);
+    }
+    return true;
+}
+
+// cleanup_conn reports the closed connection. It returns whether the protocol classification
+// state of a TCP connection must be cleaned up, see closed_conn_classified.
+static __always_inline bool cleanup_conn(void *ctx, conn_tuple_t *tup, struct sock *sk, tcp_ongoing_connect_t *failed_connect) {
+    u32 cpu = bpf_get_smp_processor_id();
+    bool classified = true;
+
+    bool is_tcp = get_proto(tup) == CONN_TYPE_TCP;
+    bool is_udp = get_proto(tup) == CONN_TYPE_UDP;
+
+    // With ring buffers the connection is written in place in a record reserved in the ring
+    // buffer, there is no need for batching. We only fall back to the batch when the ring
+    // buffer is full.
+    if (ringbuffers_enabled()) {
+        bool reserved = is_tcp ? reserve_closed_conn(tup, sk, failed_connect, &classified, true)
+                               : reserve_closed_conn(tup, sk, failed_connect, &classified, false);
+        if (reserved) {
+            return classified;
+        }
+    }
+
+    // Will hold the full connection data to send through the perf or ring buffer
+    conn_t conn = {};
+    if (!fill_closed_conn(&conn, tup, sk, failed_connect, &classified, is_tcp)) {
+        return classified;
+    }
+
+    if (conn_close_batching_disabled()) {
+        submit_event(ctx, cpu, &conn, conn_close_size(&conn));
+        return classified;
+    }
 
     // Batch TCP closed connections before generating a perf event
-    batch_t *batch_ptr = bpf_map_lookup_elem(&conn_close_batch, &cpu);
+    batch_t *batch_ptr = get_conn_close_batch(cpu);
     if (batch_ptr == NULL) {
-        return;
+        return classified;
     }
 
     // TODO: Can we turn this into a macro based on TCP_CLOSED_BATCH_SIZE?
     switch (batch_ptr->len) {
     case 0:
-        batch_ptr->c0 = conn;
+        bpf_memcpy_u64(&batch_ptr->c0, &conn, sizeof(conn_t));
         batch_ptr->len++;
-        return;
+        return classified;
     case 1:
-        batch_ptr->c1 = conn;
+        bpf_memcpy_u64(&batch_ptr->c1, &conn, sizeof(conn_t));
         batch_ptr->len++;
-        return;
+        return classified;
     case 2:
-        batch_ptr->c2 = conn;
+        bpf_memcpy_u64(&batch_ptr->c2, &conn, sizeof(conn_t));
         batch_ptr->len++;
-        return;
+        return classified;
     case 3:
-        batch_ptr->c3 = conn;
+        bpf_memcpy_u64(&batch_ptr->c3, &conn, sizeof(conn_t));
         batch_ptr->len++;
         // In this case the batch is ready to be flushed, which we defer to kretprobe/tcp_close
         // in order to cope with the eBPF stack limitation of 512 bytes.
-        return;
+        return classified;
     }
 
     // If we hit this section it means we had one or more interleaved tcp_close calls.
     // We send the connection outside of a batch anyway. This is likely not as
     // frequent of a case to cause performance issues and avoid cases where
     // we drop whole connections, which impacts things USM connection matching.
-    submit_event(ctx, cpu, &conn, sizeof(conn_t));
+    submit_event(ctx, cpu, &conn, conn_close_size(&conn));
     if (is_tcp) {
         increment_telemetry_count(unbatched_tcp_close);
     }
     if (is_udp) {
         increment_telemetry_count(unbatched_udp_close);
     }
+    return classified;
 }
 
 
 // This function is used to flush the conn_close_batch to the perf or ring buffer.
 static __always_inline void flush_conn_close_if_full(void *ctx) {
+    if (conn_close_batching_disabled()) {
+        return;
+    }
     u32 cpu = bpf_get_smp_processor_id();
-    batch_t *batch_ptr = bpf_map_lookup_elem(&conn_close_batch, &cpu);
+    batch_t *batch_ptr = get_conn_close_batch(cpu);
     if (!batch_ptr || batch_ptr->len != CONN_CLOSED_BATCH_SIZE) {
         return;
     }
 
-    // Here we copy the batch data to a variable allocated in the eBPF stack
-    // This is necessary for older Kernel versions only (we validated this behavior on 4.4.0),
-    // since you can't directly write a map entry to the perf buffer.
-    batch_t batch_copy = {};
-    bpf_memcpy(&batch_copy, batch_ptr, sizeof(batch_copy));
+    // The batch is larger than the 512 bytes of the eBPF stack, it is output straight from the map:
+    // ring buffers and, since 4.11, perf buffers accept map values.
+    submit_event(ctx, cpu, batch_ptr, sizeof(batch_t));
     batch_ptr->len = 0;
     batch_ptr->id++;
-
-    submit_event(ctx, cpu, &batch_copy, sizeof(batch_t));
 }
 
 #endif // __TRACER_EVENTS_H
@@ -8,6 +8,9 @@
 
 /* This is a key/value store with the keys being a conn_tuple_t for send & recv calls
  * and the values being conn_stats_ts_t *.
+ * When per-CPU conn stats are enabled, userspace turns this map and tcp_stats into
+ * BPF_MAP_TYPE_PERCPU_HASH maps, so that updates don't contend on the bucket locks,
+ * and the values of all CPUs are folded when they are collected.
  */
 BPF_HASH_MAP(conn_stats, conn_tuple_t, conn_stats_ts_t, 0)
 
@@ -16,6 +19,36 @@ BPF_HASH_MAP(conn_stats, conn_tuple_t, conn_stats_ts_t, 0)
  */
 BPF_HASH_MAP(tcp_stats, conn_tuple_t, tcp_stats_t, 0)
 
+/* RTT histograms of the TCP connections, keyed like tcp_stats. They are kept apart so that
+ * tcp_stats_t and the closed connections don't grow when the histogram isn't collected:
+ * userspace only sizes this map when network_config.enable_tcp_rtt_histogram is set.
+ * The entries of closed connections are read and deleted by userspace. Userspace makes
+ * this map an LRU when the kernel supports it (4.10+), which bounds the ones it misses.
+ */
+BPF_HASH_MAP(tcp_rtt_hist, conn_tuple_t, tcp_rtt_hist_t, 1)
+
+/* Folding the per-CPU conn_stats and tcp_stats values when a connection is closed
+ * requires bpf_map_lookup_percpu_elem (5.19+) and bounded loops (5.3+). The fentry
+ * tracer only loads on kernels with bounded loops and userspace checks for the helper,
+ * the runtime compiled tracer knows the kernel it runs on.
+ */
+#if defined(TRACER_FENTRY) || (defined(COMPILE_RUNTIME) && LINUX_VERSION_CODE >= KERNEL_VERSION(5, 19, 0))
+#define PERCPU_CONN_STATS_SUPPORTED
+#endif
+
+/* Epoch of the connection polls, incremented by userspace on each poll when delta
+ * polling is enabled
+ */
+BPF_ARRAY_MAP(conn_poll_epoch, __u32, 1)
+
+/* Tuples of the connections updated since the last poll, so that userspace doesn't
+ * have to read the whole conn_stats map to find them. When delta polling is enabled,
+ * userspace turns this map into a BPF_MAP_TYPE_PERCPU_ARRAY with one entry for each
+ * parity of the epoch: the tuples of the previous epoch can then be read while the
+ * ones of the current epoch are recorded.
+ */
+BPF_ARRAY_MAP(conn_touched, conn_touched_t, 1)
+
 /*
  * Hash map to store conn_tuple_t to retransmits. We use a separate map
  * for retransmits from tcp_stats above since we don't normally
@@ -23,8 +56,10 @@ BPF_HASH_MAP(tcp_stats, conn_tuple_t, tcp_stats_t, 0)
 */
 BPF_HASH_MAP(tcp_retransmits, conn_tuple_t, __u32, 0)
 
-/* Will hold the PIDs initiating TCP connections */
-BPF_HASH_MAP(tcp_ongoing_connect_pid, struct sock *, __u64, 1024)
+/* Will hold the PIDs initiating TCP connections, until the connection is established or closed.
+ * Userspace sizes it with network_config.max_ongoing_connects and turns it into an LRU when supported
+ */
+BPF_HASH_MAP(tcp_ongoing_connect_pid, struct sock *, tcp_ongoing_connect_t, 1024)
 
 /* Will hold the tcp/udp close events
  * The keys are the cpu number and the values a perf file descriptor for a perf event
@@ -35,6 +70,9 @@ BPF_PERF_EVENT_ARRAY_MAP(conn_close_event, __u32)
  * The key represents the CPU core. Ideally we should use a BPF_MAP_TYPE_PERCPU_HASH map
  * or BPF_MAP_TYPE_PERCPU_ARRAY, but they are not available in
  * some of the Kernels we support (4.4 ~ 4.6)
+ * When ring buffers are enabled (5.8+), userspace turns this map into a single entry
+ * BPF_MAP_TYPE_PERCPU_ARRAY. Closed connections are then written directly to the
+ * ring buffer and only batched when it is full, see cleanup_conn in tracer/events.h.
  */
 BPF_HASH_MAP(conn_close_batch, __u32, batch_t, 1024)
 
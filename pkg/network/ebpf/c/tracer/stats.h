@@ -102,21 +102,31 @@ static __always_inline void update_protocol_classification_information(conn_tupl
     conn_tuple_copy.pid = 0;
     normalize_tuple(&conn_tuple_copy);
 
-    protocol_stack_t *protocol_stack = __get_protocol_stack(&conn_tuple_copy);
+    protocol_stack_wrapper_t *wrapper = bpf_map_lookup_elem(&connection_protocol, &conn_tuple_copy);
+    protocol_stack_t *protocol_stack = wrapper ? &wrapper->stack : NULL;
     set_protocol_flag(protocol_stack, FLAG_NPM_ENABLED);
     mark_protocol_direction(t, &conn_tuple_copy, protocol_stack);
     merge_protocol_stacks(&stats->protocol_stack, protocol_stack);
+    if (wrapper) {
+        merge_tls_tags(&stats->tls_tags, &wrapper->tls_tags);
+    }
 
     conn_tuple_t *cached_skb_conn_tup_ptr = bpf_map_lookup_elem(&conn_tuple_to_socket_skb_conn_tuple, &conn_tuple_copy);
     if (!cached_skb_conn_tup_ptr) {
         return;
     }
 
+    // the mapping is deleted along with the protocol stacks on tcp_close, see closed_conn_classified
+    set_protocol_flag(&stats->protocol_stack, FLAG_NPM_ENABLED);
     conn_tuple_copy = *cached_skb_conn_tup_ptr;
-    protocol_stack = __get_protocol_stack(&conn_tuple_copy);
+    wrapper = bpf_map_lookup_elem(&connection_protocol, &conn_tuple_copy);
+    protocol_stack = wrapper ? &wrapper->stack : NULL;
     set_protocol_flag(protocol_stack, FLAG_NPM_ENABLED);
     mark_protocol_direction(t, &conn_tuple_copy, protocol_stack);
     merge_protocol_stacks(&stats->protocol_stack, protocol_stack);
+    if (wrapper) {
+        merge_tls_tags(&stats->tls_tags, &wrapper->tls_tags);
+    }
 }
 
 static __always_inline void determine_connection_direction(conn_tuple_t *t, conn_stats_ts_t *conn_stats) {
@@ -136,14 +146,133 @@ static __always_inline void determine_connection_direction(conn_tuple_t *t, conn
     conn_stats->direction = (port_count != NULL && *port_count > 0) ? CONN_DIRECTION_INCOMING : CONN_DIRECTION_OUTGOING;
 }
 
+static __always_inline bool delta_polling_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("conn_delta_polling_enabled", val);
+    return val > 0;
+}
+
+// mark_conn_touched records the tuple of a connection updated, or closed when `stats` is NULL, in the
+// conn_touched list of the current poll epoch. A connection is recorded once per epoch, and userspace
+// falls back to reading the whole conn_stats map when the list overflows.
+static __always_inline void mark_conn_touched(conn_tuple_t *t, conn_stats_ts_t *stats) {
+    if (!delta_polling_enabled()) {
+        return;
+    }
+
+    __u32 zero = 0;
+    __u32 *epoch_ptr = bpf_map_lookup_elem(&conn_poll_epoch, &zero);
+    if (!epoch_ptr) {
+        return;
+    }
+    __u32 epoch = *epoch_ptr;
+    if (stats && stats->dirty_epoch == (__u16)epoch) {
+        return;
+    }
+
+    __u32 slot = epoch & 1;
+    conn_touched_t *touched = bpf_map_lookup_elem(&conn_touched, &slot);
+    if (!touched) {
+        return;
+    }
+    if (touched->epoch != epoch) {
+        // userspace is done with the tuples of two epochs ago
+        touched->epoch = epoch;
+        touched->len = 0;
+    }
+
+    __u32 len = touched->len;
+    if (len >= CONN_TOUCHED_MAX) {
+        touched->len = CONN_TOUCHED_MAX + 1;
+        return;
+    }
+    touched->tuples[len] = *t;
+    touched->len = len + 1;
+    if (stats) {
+        stats->dirty_epoch = (__u16)epoch;
+    }
+}
+
+static __always_inline bool udp_flow_aggregation_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("udp_flow_aggregation_enabled", val);
+    return val > 0;
+}
+
+// aggregate_udp_flow zeroes the source port of `t` when it is a client UDP flow, sent from an
+// unbound ephemeral port to a non-ephemeral port, so that the flows of a process to the same
+// destination (DNS queries, statsd metrics, ...) share a single conn_stats entry.
+// Returns true if the tuple was modified.
+static __always_inline bool aggregate_udp_flow(conn_tuple_t *t) {
+    if (get_proto(t) != CONN_TYPE_UDP || !udp_flow_aggregation_enabled()) {
+        return false;
+    }
+    if (!is_ephemeral_port(t->sport) || is_ephemeral_port(t->dport)) {
+        return false;
+    }
+
+    port_binding_t pb = {};
+    pb.port = t->sport;
+    pb.netns = t->netns;
+    u32 *port_count = bpf_map_lookup_elem(&udp_port_bindings, &pb);
+    if (port_count != NULL && *port_count > 0) {
+        return false;
+    }
+
+    t->sport = 0;
+    return true;
+}
+
+static __always_inline bool tcp_conn_aggregation_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("tcp_conn_aggregation_enabled", val);
+    return val > 0;
+}
+
+// aggregate_tcp_conn zeroes the source port of `t` when it is a client TCP connection, from an
+// ephemeral port that isn't listening to a non-ephemeral port, so that the connections of a process
+// to the same destination (service mesh sidecars, churning connection pools, ...) share a single
+// conn_stats and tcp_stats entry.
+// Returns true if the tuple was modified.
+static __always_inline bool aggregate_tcp_conn(conn_tuple_t *t) {
+    if (get_proto(t) != CONN_TYPE_TCP || !tcp_conn_aggregation_enabled()) {
+        return false;
+    }
+    if (!is_ephemeral_port(t->sport) || is_ephemeral_port(t->dport)) {
+        return false;
+    }
+
+    port_binding_t pb = {};
+    pb.port = t->sport;
+    pb.netns = t->netns;
+    u32 *port_count = bpf_map_lookup_elem(&port_bindings, &pb);
+    if (port_count != NULL && *port_count > 0) {
+        return false;
+    }
+
+    t->sport = 0;
+    return true;
+}
+
+// aggregate_conn returns the conn_stats key of a connection in `t`, see aggregate_udp_flow and
+// aggregate_tcp_conn. Returns true if the tuple was modified.
+static __always_inline bool aggregate_conn(conn_tuple_t *t) {
+    return aggregate_udp_flow(t) || aggregate_tcp_conn(t);
+}
+
 // update_conn_stats update the connection metadata : protocol, tags, timestamp, direction, packets, bytes sent and received
 static __always_inline void update_conn_stats(conn_tuple_t *t, size_t sent_bytes, size_t recv_bytes, u64 ts, conn_direction_t dir,
     __u32 packets_out, __u32 packets_in, packet_count_increment_t segs_type, struct sock *sk) {
+    // the protocol classification and the direction are still based on the actual tuple
+    conn_tuple_t key = *t;
+    aggregate_conn(&key);
+
     conn_stats_ts_t *val = NULL;
-    val = get_conn_stats(t, sk);
+    val = get_conn_stats(&key, sk);
     if (!val) {
         return;
     }
+    mark_conn_touched(&key, val);
 
     update_protocol_classification_information(t, val);
 
@@ -178,13 +307,129 @@ static __always_inline void update_conn_stats(conn_tuple_t *t, size_t sent_bytes
     }
 }
 
+// conn_sampling_rate returns N when only one connection out of N is tracked, see conn_sampled
+static __always_inline __u64 conn_sampling_rate() {
+    __u64 val = 0;
+    LOAD_CONSTANT("conn_sampling_rate", val);
+    return val;
+}
+
+// conn_hash_mix is the 64-bit finalizer of MurmurHash3
+static __always_inline __u64 conn_hash_mix(__u64 h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// conn_sampled returns true if the connection is tracked when sampling is enabled.
+// The decision only depends on the addresses, ports, netns and type of the connection, so that
+// all the probes of a connection, whatever the process context they run in, agree on it.
+// Userspace scales the byte and packet counts of the sampled connections by the sampling rate.
+static __always_inline bool conn_sampled(conn_tuple_t *t) {
+    __u64 rate = conn_sampling_rate();
+    if (rate <= 1) {
+        return true;
+    }
+
+    __u64 h = conn_hash_mix(t->saddr_h ^ ((__u64)t->metadata << 32 | t->netns));
+    h = conn_hash_mix(h ^ t->saddr_l);
+    h = conn_hash_mix(h ^ t->daddr_h);
+    h = conn_hash_mix(h ^ t->daddr_l);
+    h = conn_hash_mix(h ^ ((__u64)t->sport << 16 | t->dport));
+    return h % rate == 0;
+}
+
+// tcp_stats_retransmits_enabled returns true if the retransmits are counted in tcp_stats instead of the
+// tcp_retransmits map. tcp_stats is then keyed like tcp_retransmits, by the tuple without pid, since the
+// retransmits aren't done in the context of the process.
+static __always_inline bool tcp_stats_retransmits_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("tcp_stats_retransmits_enabled", val);
+    return val > 0;
+}
+
+// tcp_stats_key returns the tcp_stats key of a connection, see tcp_stats_retransmits_enabled and
+// aggregate_tcp_conn
+static __always_inline conn_tuple_t tcp_stats_key(conn_tuple_t *t) {
+    conn_tuple_t key = *t;
+    if (tcp_stats_retransmits_enabled()) {
+        key.pid = 0;
+    }
+    aggregate_tcp_conn(&key);
+    return key;
+}
+
+static __always_inline bool tcp_rtt_histogram_enabled() {
+    __u64 val = 0;
+    LOAD_CONSTANT("tcp_rtt_histogram_enabled", val);
+    return val > 0;
+}
+
+// Smallest RTT in µs counted past the first bucket of the histogram, as a power of 2
+#define TCP_RTT_HIST_MIN_SHIFT 6
+
+// rtt_hist_bucket returns the histogram bucket of an RTT in µs: bucket 0 holds the RTTs below
+// 2^TCP_RTT_HIST_MIN_SHIFT µs, bucket i the RTTs in [2^(i+TCP_RTT_HIST_MIN_SHIFT-1), 2^(i+TCP_RTT_HIST_MIN_SHIFT))
+// and the last bucket everything above.
+// This must be kept in sync with rttHistBucketUpperBound in pkg/network/tracer/connection/tracer.go
+static __always_inline __u32 rtt_hist_bucket(__u32 rtt) {
+    rtt >>= TCP_RTT_HIST_MIN_SHIFT;
+    if (rtt == 0) {
+        return 0;
+    }
+
+    // 1 + log2(rtt)
+    __u32 bucket = 1;
+    if (rtt >= (1 << 16)) {
+        rtt >>= 16;
+        bucket += 16;
+    }
+    if (rtt >= (1 << 8)) {
+        rtt >>= 8;
+        bucket += 8;
+    }
+    if (rtt >= (1 << 4)) {
+        rtt >>= 4;
+        bucket += 4;
+    }
+    if (rtt >= (1 << 2)) {
+        rtt >>= 2;
+        bucket += 2;
+    }
+    if (rtt >= (1 << 1)) {
+        bucket += 1;
+    }
+    return bucket < TCP_RTT_HIST_BUCKETS ? bucket : TCP_RTT_HIST_BUCKETS - 1;
+}
+
+// update_tcp_rtt_hist counts an RTT sample in µs in the histogram of a TCP connection
+static __always_inline void update_tcp_rtt_hist(conn_tuple_t *key, __u32 rtt) {
+    tcp_rtt_hist_t empty = {};
+    bpf_map_update_with_telemetry(tcp_rtt_hist, key, &empty, BPF_NOEXIST);
+
+    tcp_rtt_hist_t *hist = bpf_map_lookup_elem(&tcp_rtt_hist, key);
+    if (hist == NULL) {
+        return;
+    }
+
+    __u32 bucket = rtt_hist_bucket(rtt);
+    if (bucket < TCP_RTT_HIST_BUCKETS) {
+        __sync_fetch_and_add(&hist->buckets[bucket], 1);
+    }
+}
+
 // update_tcp_stats update rtt, retransmission and state on of a TCP connection
 static __always_inline void update_tcp_stats(conn_tuple_t *t, tcp_stats_t stats) {
+    conn_tuple_t key = tcp_stats_key(t);
+
     // initialize-if-no-exist the connection state, and load it
     tcp_stats_t empty = {};
-    bpf_map_update_with_telemetry(tcp_stats, t, &empty, BPF_NOEXIST);
+    bpf_map_update_with_telemetry(tcp_stats, &key, &empty, BPF_NOEXIST);
 
-    tcp_stats_t *val = bpf_map_lookup_elem(&tcp_stats, t);
+    tcp_stats_t *val = bpf_map_lookup_elem(&tcp_stats, &key);
     if (val == NULL) {
         return;
     }
@@ -194,6 +439,10 @@ static __always_inline void update_tcp_stats(conn_tuple_t *t, tcp_stats_t stats)
         // https://elixir.bootlin.com/linux/v4.6/source/net/ipv4/tcp.c#L2686
         val->rtt = stats.rtt >> 3;
         val->rtt_var = stats.rtt_var >> 2;
+
+        if (tcp_rtt_histogram_enabled()) {
+            update_tcp_rtt_hist(&key, val->rtt);
+        }
     }
 
     if (stats.state_transitions > 0) {
@@ -201,8 +450,101 @@ static __always_inline void update_tcp_stats(conn_tuple_t *t, tcp_stats_t stats)
     }
 }
 
+#ifdef PERCPU_CONN_STATS_SUPPORTED
+// Maximum number of CPUs the per-CPU conn_stats and tcp_stats values are folded for,
+// userspace doesn't enable per-CPU conn stats on hosts with more possible CPUs
+#define PERCPU_CONN_STATS_MAX_CPUS 512
+
+// percpu_conn_stats_cpus returns the number of possible CPUs if conn_stats and tcp_stats
+// are per-CPU maps, 0 otherwise
+static __always_inline __u32 percpu_conn_stats_cpus() {
+    __u64 val = 0;
+    LOAD_CONSTANT("percpu_conn_stats_cpus", val);
+    return (__u32)val;
+}
+
+// merge_percpu_conn_stats merges the conn_stats_ts_t of one CPU into `dst`.
+// Byte counters and UDP packet counters are incremented on each CPU and summed, while TCP packet
+// counters are absolute values read from the socket and the highest one wins. Only the CPU that
+// created the entry has its duration and cookie set.
+static __always_inline void merge_percpu_conn_stats(conn_stats_ts_t *dst, conn_stats_ts_t *src, bool is_tcp) {
+    dst->sent_bytes += src->sent_bytes;
+    dst->recv_bytes += src->recv_bytes;
+    if (is_tcp) {
+        if (src->sent_packets > dst->sent_packets) {
+            dst->sent_packets = src->sent_packets;
+        }
+        if (src->recv_packets > dst->recv_packets) {
+            dst->recv_packets = src->recv_packets;
+        }
+    } else {
+        dst->sent_packets += src->sent_packets;
+        dst->recv_packets += src->recv_packets;
+    }
+    if (src->timestamp > dst->timestamp) {
+        dst->timestamp = src->timestamp;
+    }
+    if (src->duration > 0 && (dst->duration == 0 || src->duration < dst->duration)) {
+        dst->duration = src->duration;
+    }
+    if (dst->cookie == 0) {
+        dst->cookie = src->cookie;
+    }
+    merge_protocol_stacks(&dst->protocol_stack, &src->protocol_stack);
+    merge_tls_tags(&dst->tls_tags, &src->tls_tags);
+    dst->flags |= src->flags;
+    dst->flow_count += src->flow_count;
+    if (dst->direction == CONN_DIRECTION_UNKNOWN) {
+        dst->direction = src->direction;
+    }
+}
+
+// fold_percpu_conn_stats folds the per-CPU conn_stats and, for TCP, tcp_stats values of the
+// connection into `conn`. The RTT is the one of the CPU that updated the connection last.
+// This must be kept in sync with foldPerCPUConnStats in pkg/network/tracer/connection/percpu_stats.go
+// Returns false if the connection isn't in the conn_stats map.
+static __always_inline bool fold_percpu_conn_stats(conn_t *conn, __u32 cpus, bool is_tcp) {
+    bool found = false;
+    __u64 rtt_timestamp = 0;
+    conn_tuple_t tcp_key = tcp_stats_key(&conn->tup);
+
+    for (__u32 cpu = 0; cpu < PERCPU_CONN_STATS_MAX_CPUS && cpu < cpus; cpu++) {
+        conn_stats_ts_t *cst = bpf_map_lookup_percpu_elem(&conn_stats, &conn->tup, cpu);
+        if (cst) {
+            found = true;
+            merge_percpu_conn_stats(&conn->conn_stats, cst, is_tcp);
+        }
+        if (!is_tcp) {
+            continue;
+        }
+
+        tcp_stats_t *tst = bpf_map_lookup_percpu_elem(&tcp_stats, &tcp_key, cpu);
+        if (!tst) {
+            continue;
+        }
+        conn->tcp_stats.retransmits += tst->retransmits;
+        conn->tcp_stats.state_transitions |= tst->state_transitions;
+        if (tst->rtt > 0 && (conn->tcp_stats.rtt == 0 || (cst && cst->timestamp > rtt_timestamp))) {
+            conn->tcp_stats.rtt = tst->rtt;
+            conn->tcp_stats.rtt_var = tst->rtt_var;
+            rtt_timestamp = cst ? cst->timestamp : 0;
+        }
+    }
+
+    // each CPU tracks its own handshake, traffic seen in both directions is enough once they are folded
+    if (!is_tcp && (conn->conn_stats.flags & CONN_L_INIT) && (conn->conn_stats.flags & CONN_R_INIT)) {
+        conn->conn_stats.flags |= CONN_ASSURED;
+    }
+
+    return found;
+}
+#endif
+
 static __always_inline int handle_message(conn_tuple_t *t, size_t sent_bytes, size_t recv_bytes, conn_direction_t dir,
     __u32 packets_out, __u32 packets_in, packet_count_increment_t segs_type, struct sock *sk) {
+    if (!conn_sampled(t)) {
+        return 0;
+    }
     u64 ts = bpf_ktime_get_ns();
     update_conn_stats(t, sent_bytes, recv_bytes, ts, dir, packets_out, packets_in, segs_type, sk);
     return 0;
@@ -214,6 +556,26 @@ static __always_inline int handle_retransmit(struct sock *sk, int count) {
     if (!read_conn_tuple(&t, sk, zero, CONN_TYPE_TCP)) {
         return 0;
     }
+    if (!conn_sampled(&t)) {
+        return 0;
+    }
+    // the retransmits of aggregated connections are summed
+    aggregate_tcp_conn(&t);
+
+    if (tcp_stats_retransmits_enabled()) {
+        // the connection usually already has TCP stats
+        tcp_stats_t *stats = bpf_map_lookup_elem(&tcp_stats, &t);
+        if (stats == NULL) {
+            tcp_stats_t empty = {};
+            bpf_map_update_with_telemetry(tcp_stats, &t, &empty, BPF_NOEXIST);
+            stats = bpf_map_lookup_elem(&tcp_stats, &t);
+            if (stats == NULL) {
+                return 0;
+            }
+        }
+        __sync_fetch_and_add(&stats->retransmits, count);
+        return 0;
+    }
 
     // initialize-if-no-exist the connection state, and load it
     u32 u32_zero = 0;
@@ -229,6 +591,10 @@ static __always_inline int handle_retransmit(struct sock *sk, int count) {
 }
 
 static __always_inline void handle_tcp_stats(conn_tuple_t* t, struct sock* sk, u8 state) {
+    if (!conn_sampled(t)) {
+        return;
+    }
+
     u32 rtt = 0, rtt_var = 0;
 #ifdef COMPILE_PREBUILT
     bpf_probe_read_kernel(&rtt, sizeof(rtt), (char*)sk + offset_rtt());
@@ -245,18 +611,8 @@ static __always_inline void handle_tcp_stats(conn_tuple_t* t, struct sock* sk, u
     update_tcp_stats(t, stats);
 }
 
-static __always_inline int handle_skb_consume_udp(struct sock *sk, struct sk_buff *skb, int len) {
-    if (len < 0) {
-        // peeking or an error happened
-        return 0;
-    }
-
-    u64 pid_tgid = bpf_get_current_pid_tgid();
-    udp_recv_sock_t *st = bpf_map_lookup_elem(&udp_recv_sock, &pid_tgid);
-    if (!st) { // no entry means a peek
-        return 0;
-    }
-
+// handle_udp_recv counts a datagram received by a non-peeking recvmsg call
+static __always_inline int handle_udp_recv(struct sock *sk, struct sk_buff *skb, u64 pid_tgid) {
     conn_tuple_t t;
     bpf_memset(&t, 0, sizeof(conn_tuple_t));
     int data_len = sk_buff_to_tuple(skb, &t);
@@ -273,6 +629,21 @@ static __always_inline int handle_skb_consume_udp(struct sock *sk, struct sk_buf
     return handle_message(&t, 0, data_len, CONN_DIRECTION_UNKNOWN, 0, 1, PACKET_COUNT_INCREMENT, sk);
 }
 
+static __always_inline int handle_skb_consume_udp(struct sock *sk, struct sk_buff *skb, int len) {
+    if (len < 0) {
+        // peeking or an error happened
+        return 0;
+    }
+
+    u64 pid_tgid = bpf_get_current_pid_tgid();
+    udp_recv_sock_t *st = bpf_map_lookup_elem(&udp_recv_sock, &pid_tgid);
+    if (!st) { // no entry means a peek
+        return 0;
+    }
+
+    return handle_udp_recv(sk, skb, pid_tgid);
+}
+
 static __always_inline int handle_tcp_recv(u64 pid_tgid, struct sock *skp, int recv) {
     conn_tuple_t t = {};
     if (!read_conn_tuple(&t, skp, pid_tgid, CONN_TYPE_TCP)) {
@@ -51,6 +51,16 @@ typedef struct {
     protocol_stack_t protocol_stack;
     __u8 flags;
     __u8 direction;
+    // low bits of the poll epoch during which
+    // the connection was last added to the
+    // conn_touched list, see mark_conn_touched
+    __u16 dirty_epoch;
+    // number of closed flows folded into this
+    // entry when UDP flow or TCP connection
+    // aggregation is enabled, see aggregate_conn
+    // in tracer/stats.h
+    __u32 flow_count;
+    tls_info_t tls_tags;
 } conn_stats_ts_t;
 
 // Connection flags
@@ -64,19 +74,53 @@ typedef enum
 typedef struct {
     __u32 rtt;
     __u32 rtt_var;
+    // only counted here when tcp_stats_retransmits_enabled(),
+    // the tcp_retransmits map is used otherwise
+    __u32 retransmits;
 
     // Bit mask containing all TCP state transitions tracked by our tracer
     __u16 state_transitions;
+
+    // errno of a connect that never completed, only set when tcp_failed_connections_enabled()
+    __u16 failed_connect_err;
 } tcp_stats_t;
 
-// Full data for a tcp connection
+// Number of log2 buckets of the RTT histogram, see rtt_hist_bucket
+#define TCP_RTT_HIST_BUCKETS 16
+
+// Number of RTT samples of a TCP connection per log2 bucket, see the tcp_rtt_hist map
+typedef struct {
+    __u32 buckets[TCP_RTT_HIST_BUCKETS];
+} tcp_rtt_hist_t;
+
+// Connect of a socket that didn't complete yet, see tcp_ongoing_connect_pid
+typedef struct {
+    __u64 pid_tgid;
+    __u64 timestamp;
+    // error of the socket when the kernel gave up on the connect, see record_connect_err
+    __u32 err;
+} tcp_ongoing_connect_t;
+
+// Sections of conn_t that only some connections use
+typedef enum
+{
+    CONN_SECTION_TCP = 1 << 0, // tcp_retransmits and tcp_stats
+} conn_section_t;
+
+// Full data for a tcp connection. The sections only some connections use come last, so that
+// they can be left out of the closed connections sent on their own, see conn_close_size
 typedef struct {
     conn_tuple_t tup;
     conn_stats_ts_t conn_stats;
-    tcp_stats_t tcp_stats;
+    // conn_section_t flags of the sections that follow
+    __u32 sections;
     __u32 tcp_retransmits;
+    tcp_stats_t tcp_stats;
 } conn_t;
 
+// Size of a closed connection without its TCP section
+#define CONN_SIZE_NO_TCP __builtin_offsetof(conn_t, tcp_retransmits)
+
 // Must match the number of conn_t objects embedded in the batch_t struct
 #ifndef CONN_CLOSED_BATCH_SIZE
 #define CONN_CLOSED_BATCH_SIZE 4
@@ -95,6 +139,19 @@ typedef struct {
     __u16 len;
 } batch_t;
 
+// Must be small enough for a per-CPU map value (32KB)
+#ifndef CONN_TOUCHED_MAX
+#define CONN_TOUCHED_MAX 512
+#endif
+
+// Tuples of the connections updated during a poll epoch
+typedef struct {
+    __u32 epoch;
+    // number of tuples, CONN_TOUCHED_MAX + 1 when some of them were dropped
+    __u32 len;
+    conn_tuple_t tuples[CONN_TOUCHED_MAX];
+} conn_touched_t;
+
 // Telemetry names
 typedef struct {
     __u64 tcp_failed_connect;
@@ -104,6 +161,7 @@ typedef struct {
     __u64 udp_sends_processed;
     __u64 udp_sends_missed;
     __u64 udp_dropped_conns;
+    __u64 skb_conn_tuple_mappings;
 } telemetry_t;
 
 typedef struct {
@@ -18,9 +18,11 @@ import "C"
 
 type ConnTuple C.conn_tuple_t
 type TCPStats C.tcp_stats_t
+type TCPRTTHist C.tcp_rtt_hist_t
 type ConnStats C.conn_stats_ts_t
 type Conn C.conn_t
 type Batch C.batch_t
+type ConnTouched C.conn_touched_t
 type Telemetry C.telemetry_t
 type PortBinding C.port_binding_t
 type PIDFD C.pid_fd_t
@@ -28,6 +30,7 @@ type UDPRecvSock C.udp_recv_sock_t
 type BindSyscallArgs C.bind_syscall_args_t
 type ProtocolStack C.protocol_stack_t
 type ProtocolStackWrapper C.protocol_stack_wrapper_t
+type TLSTags C.tls_info_t
 
 // udp_recv_sock_t have *sock and *msghdr struct members, we make them opaque here
 type _Ctype_struct_sock uint64
@@ -49,10 +52,21 @@ const (
 	Assured ConnFlags = C.CONN_ASSURED
 )
 
+type ConnSection uint32
+
+const (
+	ConnSectionTCP ConnSection = C.CONN_SECTION_TCP
+)
+
 const BatchSize = C.CONN_CLOSED_BATCH_SIZE
 const SizeofBatch = C.sizeof_batch_t
 
 const SizeofConn = C.sizeof_conn_t
+const SizeofConnNoTCP = C.CONN_SIZE_NO_TCP
+
+const ConnTouchedMax = C.CONN_TOUCHED_MAX
+
+const TCPRTTHistBuckets = C.TCP_RTT_HIST_BUCKETS
 
 type ClassificationProgram = uint32
 
@@ -15,10 +15,14 @@ type ConnTuple struct {
 	Metadata uint32
 }
 type TCPStats struct {
-	Rtt               uint32
-	Rtt_var           uint32
-	State_transitions uint16
-	Pad_cgo_0         [2]byte
+	Rtt                uint32
+	Rtt_var            uint32
+	Retransmits        uint32
+	State_transitions  uint16
+	Failed_connect_err uint16
+}
+type TCPRTTHist struct {
+	Buckets [16]uint32
 }
 type ConnStats struct {
 	Sent_bytes     uint64
@@ -31,13 +35,16 @@ type ConnStats struct {
 	Protocol_stack ProtocolStack
 	Flags          uint8
 	Direction      uint8
-	Pad_cgo_0      [6]byte
+	Dirty_epoch    uint16
+	Flow_count     uint32
+	Tls_tags       TLSTags
 }
 type Conn struct {
 	Tup             ConnTuple
 	Conn_stats      ConnStats
-	Tcp_stats       TCPStats
+	Sections        uint32
 	Tcp_retransmits uint32
+	Tcp_stats       TCPStats
 }
 type Batch struct {
 	C0        Conn
@@ -49,14 +56,20 @@ type Batch struct {
 	Len       uint16
 	Pad_cgo_0 [2]byte
 }
+type ConnTouched struct {
+	Epoch  uint32
+	Len    uint32
+	Tuples [512]ConnTuple
+}
 type Telemetry struct {
-	Tcp_failed_connect  uint64
-	Tcp_sent_miscounts  uint64
-	Unbatched_tcp_close uint64
-	Unbatched_udp_close uint64
-	Udp_sends_processed uint64
-	Udp_sends_missed    uint64
-	Udp_dropped_conns   uint64
+	Tcp_failed_connect      uint64
+	Tcp_sent_miscounts      uint64
+	Unbatched_tcp_close     uint64
+	Unbatched_udp_close     uint64
+	Udp_sends_processed     uint64
+	Udp_sends_missed        uint64
+	Udp_dropped_conns       uint64
+	Skb_conn_tuple_mappings uint64
 }
 type PortBinding struct {
 	Netns     uint32
@@ -82,8 +95,20 @@ type ProtocolStack struct {
 	Flags       uint8
 }
 type ProtocolStackWrapper struct {
-	Stack   ProtocolStack
-	Updated uint64
+	Stack                ProtocolStack
+	Unclassified_packets uint32
+	Updated              uint64
+	Tls_tags             TLSTags
+	Tcp_seq              uint32
+	Tcp_seq_flipped      uint32
+}
+type TLSTags struct {
+	Chosen_version   uint16
+	Cipher_suite     uint16
+	Offered_versions uint8
+	Alpn_requested   uint8
+	Alpn_chosen      uint8
+	Pad_cgo_0        [1]byte
 }
 
 type _Ctype_struct_sock uint64
@@ -105,10 +130,21 @@ const (
 	Assured ConnFlags = 0x4
 )
 
+type ConnSection uint32
+
+const (
+	ConnSectionTCP ConnSection = 0x1
+)
+
 const BatchSize = 0x4
-const SizeofBatch = 0x1f0
+const SizeofBatch = 0x230
+
+const SizeofConn = 0x88
+const SizeofConnNoTCP = 0x74
+
+const ConnTouchedMax = 0x200
 
-const SizeofConn = 0x78
+const TCPRTTHistBuckets = 0x10
 
 type ClassificationProgram = uint32
 
@@ -20,6 +20,8 @@ const (
 	// TCPFinishConnect traces tcp_finish_connect() kernel function. This is
 	// used to know when a TCP connection switches to the ESTABLISHED state
 	TCPFinishConnect ProbeFuncName = "kprobe__tcp_finish_connect"
+	// TCPDone traces the tcp_done() kernel function, to record the error of the connects that fail
+	TCPDone ProbeFuncName = "kprobe__tcp_done"
 	// TCPv6Connect traces the v6 connect() system call
 	TCPv6Connect ProbeFuncName = "kprobe__tcp_v6_connect"
 	// TCPv6ConnectReturn traces the return value for the v6 connect() system call
@@ -34,6 +36,10 @@ const (
 	// ProtocolClassifierGRPCSocketFilter runs a classification rules for gRPC protocols.
 	ProtocolClassifierGRPCSocketFilter ProbeFuncName = "socket__classifier_grpc"
 
+	// ConnCloseFlush wakes up the consumer of the closed connections waiting in the ring buffer, it is run by
+	// userspace rather than attached
+	ConnCloseFlush ProbeFuncName = "socket__conn_close_flush"
+
 	// NetDevQueue runs a tracepoint that allows us to correlate __sk_buf (in a socket filter) with the `struct sock*`
 	// belongs (but hidden) for it.
 	NetDevQueue ProbeFuncName = "tracepoint__net__net_dev_queue"
@@ -186,12 +192,20 @@ const (
 	ConnMap BPFMapName = "conn_stats"
 	// TCPStatsMap is the map storing TCP stats
 	TCPStatsMap BPFMapName = "tcp_stats"
+	// TCPRTTHistMap is the map storing the RTT histograms of the TCP connections
+	TCPRTTHistMap BPFMapName = "tcp_rtt_hist"
+	// ConnPollEpochMap is the map storing the epoch of the connection polls
+	ConnPollEpochMap BPFMapName = "conn_poll_epoch"
+	// ConnTouchedMap is the map storing the tuples of the connections updated since the last poll
+	ConnTouchedMap BPFMapName = "conn_touched"
 	// TCPRetransmitsMap is the map storing TCP retransmits
 	TCPRetransmitsMap BPFMapName = "tcp_retransmits"
 	// TCPConnectSockPidMap is the map storing the PIDs of ongoing TCP connections
 	TCPConnectSockPidMap BPFMapName = "tcp_ongoing_connect_pid"
 	// ConnCloseEventMap is the map storing connection close events
 	ConnCloseEventMap BPFMapName = "conn_close_event"
+	// RingBufferLastWakeupMap is the map storing the last time each CPU woke up the consumer of the ring buffer
+	RingBufferLastWakeupMap BPFMapName = "rb_last_wakeup"
 	// TracerStatusMap is the map storing the status of the tracer
 	TracerStatusMap BPFMapName = "tracer_status"
 	// ConntrackStatusMap is the map storing the status of the conntrack
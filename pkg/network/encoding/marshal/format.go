@@ -7,6 +7,7 @@ package marshal
 
 import (
 	"math"
+	"strconv"
 
 	"github.com/twmb/murmur3"
 
@@ -49,6 +50,19 @@ func mergeDynamicTags(dynamicTags ...map[string]struct{}) (out map[string]struct
 	return
 }
 
+// rttDynamicTags returns the RTT percentiles of a TCP connection as tags, they are only set when
+// network_config.enable_tcp_rtt_histogram is. Their values are the upper bounds of the buckets of
+// the RTT histogram, which keeps the number of distinct tags low.
+func rttDynamicTags(conn network.ConnectionStats) map[string]struct{} {
+	if conn.RTTP99 == 0 {
+		return nil
+	}
+	return map[string]struct{}{
+		"tcp.rtt_p50_us:" + strconv.FormatUint(uint64(conn.RTTP50), 10): {},
+		"tcp.rtt_p99_us:" + strconv.FormatUint(uint64(conn.RTTP99), 10): {},
+	}
+}
+
 // FormatConnection converts a ConnectionStats into an model.Connection
 func FormatConnection(builder *model.ConnectionBuilder, conn network.ConnectionStats, routes map[string]RouteIdx,
 	httpEncoder *httpEncoder, http2Encoder *http2Encoder, kafkaEncoder *kafkaEncoder, postgresEncoder *postgresEncoder,
@@ -99,6 +113,12 @@ func FormatConnection(builder *model.ConnectionBuilder, conn network.ConnectionS
 	builder.SetIntraHost(conn.IntraHost)
 	builder.SetLastTcpEstablished(conn.Last.TCPEstablished)
 	builder.SetLastTcpClosed(conn.Last.TCPClosed)
+	for errno, count := range conn.TCPFailures {
+		builder.AddTcpFailuresByErrCode(func(w *model.Connection_TcpFailuresByErrCodeEntryBuilder) {
+			w.SetKey(uint32(errno))
+			w.SetValue(count)
+		})
+	}
 	builder.SetProtocol(func(w *model.ProtocolStackBuilder) {
 		ps := FormatProtocolStack(conn.ProtocolStack, conn.StaticTags)
 		for _, p := range ps.Stack {
@@ -113,7 +133,7 @@ func FormatConnection(builder *model.ConnectionBuilder, conn network.ConnectionS
 	http2StaticTags, http2DynamicTags := http2Encoder.WriteHTTP2AggregationsAndTags(conn, builder)
 
 	staticTags := httpStaticTags | http2StaticTags
-	dynamicTags := mergeDynamicTags(httpDynamicTags, http2DynamicTags)
+	dynamicTags := mergeDynamicTags(conn.TLSTags.GetDynamicTags(), httpDynamicTags, http2DynamicTags, rttDynamicTags(conn))
 
 	kafkaEncoder.WriteKafkaAggregations(conn, builder)
 	postgresEncoder.WritePostgresAggregations(conn, builder)
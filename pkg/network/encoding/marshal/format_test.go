@@ -106,3 +106,19 @@ func BenchmarkFormatTags(b *testing.B) {
 		formatTags(c, tagSet, nil)
 	}
 }
+
+func TestFormatRTTPercentileTags(t *testing.T) {
+	var c network.ConnectionStats
+	require.Nil(t, rttDynamicTags(c))
+
+	c.RTTP50 = 128
+	c.RTTP99 = 4096
+	tagSet := network.NewTagsSet()
+	tagsIdx, _ := formatTags(c, tagSet, rttDynamicTags(c))
+
+	var tags []string
+	for _, idx := range tagsIdx {
+		tags = append(tags, tagSet.GetStrings()[idx])
+	}
+	require.ElementsMatch(t, []string{"tcp.rtt_p50_us:128", "tcp.rtt_p99_us:4096"}, tags)
+}
@@ -16,9 +16,15 @@ import (
 
 	"github.com/DataDog/datadog-agent/pkg/network/dns"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/amqp"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/http"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/http2"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/kafka"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/mongo"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/mysql"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/postgres"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/redis"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/tls"
 	"github.com/DataDog/datadog-agent/pkg/process/util"
 )
 
@@ -139,6 +145,11 @@ type Connections struct {
 	HTTP2                       map[http.Key]*http.RequestStats
 	Kafka                       map[kafka.Key]*kafka.RequestStat
 	Postgres                    map[postgres.Key]*postgres.RequestStat
+	Redis                       map[redis.Key]*redis.RequestStat
+	AMQP                        map[amqp.Key]*amqp.RequestStat
+	MySQL                       map[mysql.Key]*mysql.RequestStat
+	Mongo                       map[mongo.Key]*mongo.RequestStat
+	GRPC                        map[http2.GRPCKey]*http2.GRPCStat
 }
 
 // NewConnections create a new Connections object
@@ -263,6 +274,10 @@ type ConnectionStats struct {
 
 	RTT    uint32 // Stored in µs
 	RTTVar uint32
+	// Upper bounds in µs of the RTT histogram buckets holding the median and 99th percentile, only set when
+	// network_config.enable_tcp_rtt_histogram is enabled
+	RTTP50 uint32
+	RTTP99 uint32
 
 	Pid   uint32
 	NetNS uint32
@@ -285,8 +300,13 @@ type ConnectionStats struct {
 	}
 
 	ProtocolStack protocols.Stack
+	TLSTags       tls.Tags
 
 	DNSStats map[dns.Hostname]map[dns.QueryType]dns.Stats
+
+	// Number of connects that never completed per errno, only set when network_config.enable_tcp_failed_connects is
+	// enabled
+	TCPFailures map[uint16]uint32
 }
 
 // Via has info about the routing decision for a flow
@@ -409,6 +429,12 @@ func ConnectionSummary(c *ConnectionStats, names map[util.Address][]dns.Hostname
 			c.Monotonic.TCPEstablished, c.Last.TCPEstablished,
 			c.Monotonic.TCPClosed, c.Last.TCPClosed,
 		)
+		if c.RTTP99 > 0 {
+			str += fmt.Sprintf(", RTT p50 %s p99 %s",
+				time.Duration(c.RTTP50)*time.Microsecond,
+				time.Duration(c.RTTP99)*time.Microsecond,
+			)
+		}
 	}
 
 	str += fmt.Sprintf(", last update epoch: %d, cookie: %d", c.LastUpdateEpoch, c.Cookie)
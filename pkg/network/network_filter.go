@@ -146,6 +146,18 @@ func parsePortFilter(pf string) (uint64, uint64, ConnTypeFilter, error) {
 	return lowerPort, upperPort, connTypeFilter, nil
 }
 
+// ParsePortRange parses a port or a port range, like "8080" or "8000-8100"
+func ParsePortRange(pr string) (uint16, uint16, error) {
+	lowerPort, upperPort, _, err := parsePortFilter(pr)
+	if err != nil {
+		return 0, 0, err
+	}
+	if lowerPort == 0 {
+		return 0, 0, fmt.Errorf("invalid port range %q", pr)
+	}
+	return uint16(lowerPort), uint16(upperPort), nil
+}
+
 func parsePortString(port string) (uint64, error) {
 	p, err := strconv.ParseUint(port, 10, 16)
 	if err != nil {
@@ -0,0 +1,53 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package amqp
+
+import (
+	"fmt"
+
+	"github.com/DataDog/datadog-agent/pkg/network/types"
+)
+
+// ConnTuple returns the connection tuple for the message
+func (e *EbpfEvent) ConnTuple() types.ConnectionKey {
+	return types.ConnectionKey{
+		SrcIPHigh: e.Tuple.Saddr_h,
+		SrcIPLow:  e.Tuple.Saddr_l,
+		DstIPHigh: e.Tuple.Daddr_h,
+		DstIPLow:  e.Tuple.Daddr_l,
+		SrcPort:   e.Tuple.Sport,
+		DstPort:   e.Tuple.Dport,
+	}
+}
+
+// Exchange returns the name of the exchange of the message, truncated to the size of the kernel buffer. The default
+// exchange has an empty name.
+func (e *EbpfEvent) Exchange() []byte {
+	size := int(e.Message.Exchange_len)
+	if size > len(e.Message.Exchange) {
+		size = len(e.Message.Exchange)
+	}
+	return e.Message.Exchange[:size]
+}
+
+// Method returns the method carrying the message.
+func (e *EbpfEvent) Method() Method {
+	switch e.Message.Method {
+	case methodPublish:
+		return PublishMethod
+	case methodDeliver:
+		return DeliverMethod
+	default:
+		return UnknownMethod
+	}
+}
+
+// String returns a string representation of the underlying event
+func (e *EbpfEvent) String() string {
+	return fmt.Sprintf("ebpfMessage{Method: %s, Exchange: %q}", e.Method(), e.Exchange())
+}
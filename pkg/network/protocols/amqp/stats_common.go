@@ -0,0 +1,65 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+package amqp
+
+import (
+	"github.com/DataDog/datadog-agent/pkg/network/types"
+	"github.com/DataDog/datadog-agent/pkg/process/util"
+)
+
+// This file contains the structs used to store and combine the stats for the AMQP protocol.
+// The file does not have any build tag, so it can be used in any build as it is used by the tracer package.
+
+// Method is the AMQP method carrying the messages.
+type Method uint8
+
+const (
+	// UnknownMethod represents an unknown method
+	UnknownMethod Method = iota
+	// PublishMethod represents the basic.publish method, sending a message to an exchange
+	PublishMethod
+	// DeliverMethod represents the basic.deliver method, delivering a message of an exchange to a consumer
+	DeliverMethod
+)
+
+// String returns the name of the method
+func (m Method) String() string {
+	switch m {
+	case PublishMethod:
+		return "basic.publish"
+	case DeliverMethod:
+		return "basic.deliver"
+	default:
+		return "unknown"
+	}
+}
+
+// Key is an identifier for a group of AMQP messages
+type Key struct {
+	Exchange string
+	Method   Method
+	types.ConnectionKey
+}
+
+// NewKey creates a new amqp key
+func NewKey(saddr, daddr util.Address, sport, dport uint16, exchange string, method Method) Key {
+	return Key{
+		ConnectionKey: types.NewConnectionKey(saddr, daddr, sport, dport),
+		Exchange:      exchange,
+		Method:        method,
+	}
+}
+
+// RequestStat represents a group of AMQP messages that has a shared key.
+type RequestStat struct {
+	Count int
+}
+
+// CombineWith merges the data in 2 RequestStats objects
+// newStats is kept as it is, while the method receiver gets mutated
+func (r *RequestStat) CombineWith(newStats *RequestStat) {
+	r.Count += newStats.Count
+}
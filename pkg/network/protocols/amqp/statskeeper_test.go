@@ -0,0 +1,57 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package amqp
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/require"
+
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+)
+
+func newEvent(exchange string, method uint8) *EbpfEvent {
+	event := &EbpfEvent{
+		Message: EbpfMessage{
+			Exchange_len: uint8(len(exchange)),
+			Method:       method,
+		},
+	}
+	copy(event.Message.Exchange[:], exchange)
+	return event
+}
+
+func TestStatKeeperProcess(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxAMQPStatsBuffered = 100
+	s := NewStatkeeper(cfg)
+	for i := 0; i < 10; i++ {
+		s.Process(newEvent("orders", methodPublish))
+	}
+	s.Process(newEvent("orders", methodDeliver))
+	s.Process(newEvent("", methodPublish))
+
+	stats := s.GetAndResetAllStats()
+	require.Len(t, stats, 3)
+	require.Equal(t, 10, stats[Key{Exchange: "orders", Method: PublishMethod}].Count)
+	require.Equal(t, 1, stats[Key{Exchange: "orders", Method: DeliverMethod}].Count)
+	require.Equal(t, 1, stats[Key{Exchange: "", Method: PublishMethod}].Count)
+	require.Empty(t, s.GetAndResetAllStats())
+}
+
+func TestStatKeeperMaxEntries(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxAMQPStatsBuffered = 1
+	s := NewStatkeeper(cfg)
+	s.Process(newEvent("orders", methodPublish))
+	s.Process(newEvent("payments", methodPublish))
+
+	stats := s.GetAndResetAllStats()
+	require.Len(t, stats, 1)
+	require.Contains(t, stats, Key{Exchange: "orders", Method: PublishMethod})
+}
@@ -0,0 +1,32 @@
+// Code generated by cmd/cgo -godefs; DO NOT EDIT.
+// cgo -godefs -- -I ../../ebpf/c -I ../../../ebpf/c -fsigned-char types.go
+
+package amqp
+
+type ConnTuple = struct {
+	Saddr_h  uint64
+	Saddr_l  uint64
+	Daddr_h  uint64
+	Daddr_l  uint64
+	Sport    uint16
+	Dport    uint16
+	Netns    uint32
+	Pid      uint32
+	Metadata uint32
+}
+
+type EbpfEvent struct {
+	Tuple     ConnTuple
+	Message   EbpfMessage
+	Pad_cgo_0 [6]byte
+}
+type EbpfMessage struct {
+	Exchange     [32]byte
+	Exchange_len uint8
+	Method       uint8
+}
+
+const (
+	methodPublish = 0x28
+	methodDeliver = 0x3c
+)
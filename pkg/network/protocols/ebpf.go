@@ -47,8 +47,6 @@ const (
 	ProgramHTTP2FrameFilter ProgramType = C.PROG_HTTP2_FRAME_FILTER
 	// ProgramHTTP2HeadersParser is the Golang representation of the C.PROG_HTTP2_HEADERS_PARSER enum
 	ProgramHTTP2HeadersParser ProgramType = C.PROG_HTTP2_HEADERS_PARSER
-	// ProgramHTTP2DynamicTableCleaner is the Golang representation of the C.PROG_HTTP2_DYNAMIC_TABLE_CLEANER enum
-	ProgramHTTP2DynamicTableCleaner ProgramType = C.PROG_HTTP2_DYNAMIC_TABLE_CLEANER
 	// ProgramHTTP2EOSParser is the Golang representation of the C.PROG_HTTP2_EOS_PARSER enum
 	ProgramHTTP2EOSParser ProgramType = C.PROG_HTTP2_EOS_PARSER
 	// ProgramKafka is the Golang representation of the C.PROG_KAFKA enum
@@ -65,6 +63,14 @@ const (
 	ProgramPostgres ProgramType = C.PROG_POSTGRES
 	// ProgramPostgresParseMessage is the Golang representation of the C.PROG_POSTGRES_PROCESS_PARSE_MESSAGE enum
 	ProgramPostgresParseMessage ProgramType = C.PROG_POSTGRES_PROCESS_PARSE_MESSAGE
+	// ProgramRedis is the Golang representation of the C.PROG_REDIS enum
+	ProgramRedis ProgramType = C.PROG_REDIS
+	// ProgramAMQP is the Golang representation of the C.PROG_AMQP enum
+	ProgramAMQP ProgramType = C.PROG_AMQP
+	// ProgramMySQL is the Golang representation of the C.PROG_MYSQL enum
+	ProgramMySQL ProgramType = C.PROG_MYSQL
+	// ProgramMongo is the Golang representation of the C.PROG_MONGO enum
+	ProgramMongo ProgramType = C.PROG_MONGO
 )
 
 // Application layer of the protocol stack.
@@ -132,8 +138,6 @@ const (
 	ProgramTLSHTTP2Filter TLSProgramType = C.TLS_HTTP2_FILTER
 	// ProgramTLSHTTP2HeaderParser is tail call to parse the previously filtered http2 header frames.
 	ProgramTLSHTTP2HeaderParser TLSProgramType = C.TLS_HTTP2_HEADERS_PARSER
-	// ProgramTLSHTTP2DynamicTableCleaner is tail call to clean the dynamic table.
-	ProgramTLSHTTP2DynamicTableCleaner TLSProgramType = C.TLS_HTTP2_DYNAMIC_TABLE_CLEANER
 	// ProgramTLSHTTP2EOSParser is tail call to process End-Of-Stream frames.
 	ProgramTLSHTTP2EOSParser TLSProgramType = C.TLS_HTTP2_EOS_PARSER
 	// ProgramTLSHTTP2Termination is tail call to process TLS HTTP2 termination.
@@ -21,14 +21,15 @@ var batchPool = sync.Pool{
 
 type batchReader struct {
 	sync.Mutex
-	numCPUs    int
-	batchMap   *maps.GenericMap[batchKey, batch]
-	offsets    *offsetManager
-	workerPool *workerPool
-	stopped    bool
+	numCPUs     int
+	pagesPerCPU int
+	batchMap    *maps.GenericMap[batchKey, batch]
+	offsets     *offsetManager
+	workerPool  *workerPool
+	stopped     bool
 }
 
-func newBatchReader(offsetManager *offsetManager, batchMap *maps.GenericMap[batchKey, batch], numCPUs int) (*batchReader, error) {
+func newBatchReader(offsetManager *offsetManager, batchMap *maps.GenericMap[batchKey, batch], numCPUs int, pagesPerCPU int) (*batchReader, error) {
 	// initialize eBPF maps
 	batch := new(batch)
 	for i := 0; i < numCPUs; i++ {
@@ -36,7 +37,7 @@ func newBatchReader(offsetManager *offsetManager, batchMap *maps.GenericMap[batc
 		// batch entry with a CPU during startup. This information is used by
 		// the code that does the batch offset tracking.
 		batch.Cpu = uint16(i)
-		for j := 0; j < batchPagesPerCPU; j++ {
+		for j := 0; j < pagesPerCPU; j++ {
 			key := &batchKey{Cpu: batch.Cpu, Num: uint16(j)}
 			err := batchMap.Put(key, batch)
 			if err != nil {
@@ -51,10 +52,11 @@ func newBatchReader(offsetManager *offsetManager, batchMap *maps.GenericMap[batc
 	}
 
 	return &batchReader{
-		numCPUs:    numCPUs,
-		offsets:    offsetManager,
-		batchMap:   batchMap,
-		workerPool: workerPool,
+		numCPUs:     numCPUs,
+		pagesPerCPU: pagesPerCPU,
+		offsets:     offsetManager,
+		batchMap:    batchMap,
+		workerPool:  workerPool,
 	}, nil
 }
 
@@ -114,7 +116,7 @@ func (r *batchReader) Stop() {
 
 func (r *batchReader) generateBatchKey(cpu int) (batchID int, key *batchKey) {
 	batchID = r.offsets.NextBatchID(cpu)
-	pageNum := uint64(batchID) % uint64(batchPagesPerCPU)
+	pageNum := uint64(batchID) % uint64(r.pagesPerCPU)
 	return batchID, &batchKey{
 		Cpu: uint16(cpu),
 		Num: uint16(pageNum),
@@ -50,10 +50,15 @@ func Configure(cfg *config.Config, proto string, m *manager.Manager, o *manager.
 		log.Error("unable to detect number of CPUs. assuming 96 cores")
 	}
 
-	configureBatchMaps(proto, o, numCPUs)
+	pages := batchPagesPerCPU
+	if n, ok := cfg.USMBatchPagesPerCPU[proto]; ok {
+		pages = min(max(n, 1), batchMaxPagesPerCPU)
+	}
+	configureBatchMaps(proto, o, numCPUs, pages)
 
 	useRingBuffer := cfg.EnableUSMRingBuffers && features.HaveMapType(ebpf.RingBuf) == nil
 	utils.AddBoolConst(o, useRingBuffer, "use_ring_buffer")
+	utils.AddBoolConst(o, useRingBuffer && cfg.EnableUSMDirectRingBufferEvents, "use_direct_ring_buffer")
 
 	if useRingBuffer {
 		setupPerfRing(proto, m, o, numCPUs)
@@ -119,15 +124,21 @@ func setupPerfRing(proto string, m *manager.Manager, o *manager.Options, numCPUs
 	setHandler(proto, handler)
 }
 
-func configureBatchMaps(proto string, o *manager.Options, numCPUs int) {
+// configureBatchMaps sizes the batch map of the protocol for the given number of batch pages per CPU. The consumer
+// reads it back from the size of the map.
+func configureBatchMaps(proto string, o *manager.Options, numCPUs int, pages int) {
 	if o.MapSpecEditors == nil {
 		o.MapSpecEditors = make(map[string]manager.MapSpecEditor)
 	}
 
 	o.MapSpecEditors[proto+batchMapSuffix] = manager.MapSpecEditor{
-		MaxEntries: uint32(numCPUs * batchPagesPerCPU),
+		MaxEntries: uint32(numCPUs * pages),
 		EditorFlag: manager.EditMaxEntries,
 	}
+	o.ConstantEditors = append(o.ConstantEditors, manager.ConstantEditor{
+		Name:  proto + "_batch_pages",
+		Value: uint64(pages),
+	})
 }
 
 func eventMapName(proto string) string {
@@ -159,7 +170,7 @@ func removeRingBufferHelperCalls(m *manager.Manager) {
 	// TODO: this is not the intended API usage of a `ebpf.Modifier`.
 	// Once we have access to the `ddebpf.Manager`, add this modifier to its list of
 	// `EnabledModifiers` and let it control the execution of the callbacks
-	patcher := ddebpf.NewHelperCallRemover(asm.FnRingbufOutput)
+	patcher := ddebpf.NewHelperCallRemover(asm.FnRingbufOutput, asm.FnRingbufReserve, asm.FnRingbufSubmit, asm.FnRingbufQuery)
 	err := patcher.BeforeInit(m, nil)
 
 	if err != nil {
@@ -8,6 +8,7 @@
 package events
 
 import (
+	"encoding/binary"
 	"errors"
 	"fmt"
 	"sync"
@@ -26,9 +27,14 @@ const (
 	batchMapSuffix  = "_batches"
 	eventsMapSuffix = "_batch_events"
 	sizeOfBatch     = int(unsafe.Sizeof(batch{}))
+	// records written directly to the ring buffer only hold a batch header followed by their events
+	sizeOfBatchHeader = int(unsafe.Offsetof(batch{}.Data))
 )
 
-var errInvalidPerfEvent = errors.New("invalid perf event")
+var (
+	errInvalidPerfEvent = errors.New("invalid perf event")
+	errInvalidLayout    = errors.New("events layout doesn't match the consumer")
+)
 
 // Consumer provides a standardized abstraction for consuming (batched) events from eBPF
 type Consumer[V any] struct {
@@ -40,6 +46,16 @@ type Consumer[V any] struct {
 	batchReader *batchReader
 	callback    func([]V)
 
+	// columnarCallback replaces callback for the events written with the columnar layout, see NewColumnarConsumer.
+	// It is given the data of a batch, its capacity and the range of events to process.
+	columnarCallback func(data unsafe.Pointer, capacity, begin, length int)
+
+	// layout, eventSize and headSize describe the events expected from the kernel, so that a batch written for
+	// another event type or layout is counted as invalid instead of being decoded
+	layout    uint16
+	eventSize int
+	headSize  int
+
 	// termination
 	eventLoopWG sync.WaitGroup
 	stopped     bool
@@ -50,6 +66,11 @@ type Consumer[V any] struct {
 	failedFlushesCount *telemetry.Counter
 	kernelDropsCount   *telemetry.Counter
 	invalidEventsCount *telemetry.Counter
+
+	// queueingLatency counts the events by the time they waited in the kernel before being read, bucketed by the
+	// powers of two of microseconds. The wait of the first event of a batch is used for all its events.
+	latencyClock    *ddebpf.QueueingLatencyClock
+	queueingLatency [ddebpf.QueueingLatencyBuckets]*telemetry.Counter
 }
 
 // NewConsumer instantiates a new event Consumer
@@ -57,6 +78,44 @@ type Consumer[V any] struct {
 // 1) copy the data it wishes to hold since the underlying byte array is reclaimed;
 // 2) be thread-safe, as the callback may be executed concurrently from multiple go-routines;
 func NewConsumer[V any](proto string, ebpf *manager.Manager, callback func([]V)) (*Consumer[V], error) {
+	var zero V
+	return newConsumer(proto, ebpf, callback, layoutRow, int(unsafe.Sizeof(zero)), 0)
+}
+
+// NewColumnarConsumer instantiates a new event Consumer for the events enqueued by USM_EVENTS_INIT_COLUMNAR.
+// `callback` is given the heads of the events, of type H, and their tails, of type T, in two slices of the same
+// length, so that it only loads the tails it needs. H must mirror the fields of the event before its tail field, and
+// T the following ones. The same requirements as for NewConsumer apply to `callback`.
+func NewColumnarConsumer[H, T any](proto string, ebpf *manager.Manager, callback func([]H, []T)) (*Consumer[H], error) {
+	var head H
+	var tail T
+	headSize := int(unsafe.Sizeof(head))
+	tailSize := int(unsafe.Sizeof(tail))
+
+	c, err := newConsumer[H](proto, ebpf, nil, layoutColumnar, headSize+tailSize, headSize)
+	if err != nil {
+		return nil, err
+	}
+	c.columnarCallback = columnarDecoder(callback)
+	return c, nil
+}
+
+// columnarDecoder returns a function slicing the heads and the tails of the events of a batch with the columnar
+// layout, and passing them to `callback`.
+func columnarDecoder[H, T any](callback func([]H, []T)) func(data unsafe.Pointer, capacity, begin, length int) {
+	var head H
+	var tail T
+	headSize := int(unsafe.Sizeof(head))
+	tailSize := int(unsafe.Sizeof(tail))
+
+	return func(data unsafe.Pointer, capacity, begin, length int) {
+		heads := unsafe.Slice((*H)(unsafe.Add(data, begin*headSize)), length)
+		tails := unsafe.Slice((*T)(unsafe.Add(data, capacity*headSize+begin*tailSize)), length)
+		callback(heads, tails)
+	}
+}
+
+func newConsumer[V any](proto string, ebpf *manager.Manager, callback func([]V), layout uint16, eventSize, headSize int) (*Consumer[V], error) {
 	batchMapName := proto + batchMapSuffix
 	batchMap, err := maps.GetMap[batchKey, batch](ebpf, batchMapName)
 	if err != nil {
@@ -69,8 +128,11 @@ func NewConsumer[V any](proto string, ebpf *manager.Manager, callback func([]V))
 		log.Errorf("unable to detect number of CPUs. assuming 96 cores: %s", err)
 	}
 
+	// see configureBatchMaps
+	pagesPerCPU := max(int(batchMap.Map().MaxEntries())/numCPUs, 1)
+
 	offsets := newOffsetManager(numCPUs)
-	batchReader, err := newBatchReader(offsets, batchMap, numCPUs)
+	batchReader, err := newBatchReader(offsets, batchMap, numCPUs, pagesPerCPU)
 	if err != nil {
 		return nil, err
 	}
@@ -104,6 +166,15 @@ func NewConsumer[V any](proto string, ebpf *manager.Manager, callback func([]V))
 	// `kernel_dropped_events`.
 	failedFlushesCount := metricGroup.NewCounter("failed_flushes")
 
+	latencyClock, err := ddebpf.NewQueueingLatencyClock()
+	if err != nil {
+		return nil, fmt.Errorf("unable to initialize the queueing latency clock: %w", err)
+	}
+	var queueingLatency [ddebpf.QueueingLatencyBuckets]*telemetry.Counter
+	for i := range queueingLatency {
+		queueingLatency[i] = metricGroup.NewCounter("queueing_latency", ddebpf.QueueingLatencyBucketTag(i))
+	}
+
 	return &Consumer[V]{
 		proto:       proto,
 		callback:    callback,
@@ -111,6 +182,9 @@ func NewConsumer[V any](proto string, ebpf *manager.Manager, callback func([]V))
 		offsets:     offsets,
 		handler:     handler,
 		batchReader: batchReader,
+		layout:      layout,
+		eventSize:   eventSize,
+		headSize:    headSize,
 
 		// telemetry
 		metricGroup:        metricGroup,
@@ -118,6 +192,8 @@ func NewConsumer[V any](proto string, ebpf *manager.Manager, callback func([]V))
 		failedFlushesCount: failedFlushesCount,
 		kernelDropsCount:   kernelDropsCount,
 		invalidEventsCount: invalidEventsCount,
+		latencyClock:       latencyClock,
+		queueingLatency:    queueingLatency,
 	}, nil
 }
 
@@ -135,6 +211,14 @@ func (c *Consumer[V]) Start() {
 					return
 				}
 
+				if len(dataEvent.Data) < sizeOfBatch {
+					if err := c.processRecord(dataEvent.Data); err != nil {
+						c.invalidEventsCount.Add(1)
+					}
+					dataEvent.Done()
+					break
+				}
+
 				b, err := batchFromEventData(dataEvent.Data)
 
 				if err != nil {
@@ -226,7 +310,21 @@ func (c *Consumer[V]) process(b *batch, syncing bool) {
 		return
 	}
 
+	if c.checkLayout(b.Layout, b.Event_size, b.Head_size, int(b.Cap)) != nil {
+		c.invalidEventsCount.Add(1)
+		return
+	}
+
 	c.eventsCount.Add(int64(end - begin))
+	// the timestamp is the one of the first event, which was already read if the batch was partially read by Sync
+	if begin == 0 {
+		c.queueingLatency[c.latencyClock.Bucket(b.Ktime)].Add(int64(length))
+	}
+
+	if c.columnarCallback != nil {
+		c.columnarCallback(unsafe.Pointer(&b.Data[0]), int(b.Cap), begin, length)
+		return
+	}
 
 	// generate a slice of type []V from the batch
 	ptr := pointerToElement[V](b, begin)
@@ -235,6 +333,56 @@ func (c *Consumer[V]) process(b *batch, syncing bool) {
 	c.callback(events)
 }
 
+// processRecord processes a record written directly to the ring buffer, see USM_EVENTS_INIT. These records aren't
+// read from the batch maps by Sync, so they are processed as they are.
+func (c *Consumer[V]) processRecord(data []byte) error {
+	if len(data) < sizeOfBatchHeader {
+		return errInvalidPerfEvent
+	}
+
+	length := int(binary.NativeEndian.Uint16(data[unsafe.Offsetof(batch{}.Len):]))
+	c.kernelDropsCount.Add(int64(binary.NativeEndian.Uint32(data[unsafe.Offsetof(batch{}.Dropped_events):])))
+	// records without events are only sent to wake up the consumer
+	if length == 0 {
+		return nil
+	}
+
+	capacity := int(binary.NativeEndian.Uint16(data[unsafe.Offsetof(batch{}.Cap):]))
+	if length > capacity || sizeOfBatchHeader+capacity*c.eventSize > len(data) {
+		return errInvalidPerfEvent
+	}
+
+	layout := binary.NativeEndian.Uint16(data[unsafe.Offsetof(batch{}.Layout):])
+	eventSize := binary.NativeEndian.Uint16(data[unsafe.Offsetof(batch{}.Event_size):])
+	headSize := binary.NativeEndian.Uint16(data[unsafe.Offsetof(batch{}.Head_size):])
+	if err := c.checkLayout(layout, eventSize, headSize, capacity); err != nil {
+		return err
+	}
+
+	c.eventsCount.Add(int64(length))
+	ktime := binary.NativeEndian.Uint64(data[unsafe.Offsetof(batch{}.Ktime):])
+	c.queueingLatency[c.latencyClock.Bucket(ktime)].Add(int64(length))
+	if c.columnarCallback != nil {
+		c.columnarCallback(unsafe.Pointer(&data[sizeOfBatchHeader]), capacity, 0, length)
+		return nil
+	}
+	events := unsafe.Slice((*V)(unsafe.Pointer(&data[sizeOfBatchHeader])), length)
+	c.callback(events)
+	return nil
+}
+
+// checkLayout returns an error if the events of a batch weren't written with the layout and the sizes expected by the
+// consumer, which happens when userspace and the eBPF programs disagree on the event type.
+func (c *Consumer[V]) checkLayout(layout, eventSize, headSize uint16, capacity int) error {
+	if layout != c.layout || int(eventSize) != c.eventSize || int(headSize) != c.headSize {
+		return errInvalidLayout
+	}
+	if capacity*c.eventSize > batchBufferSize {
+		return errInvalidLayout
+	}
+	return nil
+}
+
 func batchFromEventData(data []byte) (*batch, error) {
 	if len(data) < sizeOfBatch {
 		// For some reason the eBPF program sent us a perf event with a size
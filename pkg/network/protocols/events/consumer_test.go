@@ -8,6 +8,8 @@
 package events
 
 import (
+	"encoding/binary"
+	"fmt"
 	"math"
 	"os"
 	"path/filepath"
@@ -22,8 +24,10 @@ import (
 	"github.com/stretchr/testify/require"
 	"golang.org/x/sys/unix"
 
+	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/bytecode"
 	"github.com/DataDog/datadog-agent/pkg/network/config"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/telemetry"
 	"github.com/DataDog/datadog-agent/pkg/util/kernel"
 )
 
@@ -76,6 +80,107 @@ func TestConsumer(t *testing.T) {
 	}
 }
 
+func TestConsumerProcessRecord(t *testing.T) {
+	var result []uint64
+	metricGroup := telemetry.NewMetricGroup("usm.test_records")
+	consumer := &Consumer[uint64]{
+		callback: func(events []uint64) {
+			result = append(result, events...)
+		},
+		eventsCount:      metricGroup.NewCounter("events_captured"),
+		kernelDropsCount: metricGroup.NewCounter("kernel_dropped_events"),
+		layout:           layoutRow,
+		eventSize:        8,
+	}
+	setupQueueingLatency(t, consumer, metricGroup)
+
+	record := func(dropped uint32, events ...uint64) []byte {
+		data := make([]byte, sizeOfBatchHeader+8*len(events))
+		binary.NativeEndian.PutUint16(data[unsafe.Offsetof(batch{}.Len):], uint16(len(events)))
+		binary.NativeEndian.PutUint16(data[unsafe.Offsetof(batch{}.Cap):], uint16(len(events)))
+		binary.NativeEndian.PutUint16(data[unsafe.Offsetof(batch{}.Event_size):], 8)
+		binary.NativeEndian.PutUint32(data[unsafe.Offsetof(batch{}.Dropped_events):], dropped)
+		for i, event := range events {
+			binary.NativeEndian.PutUint64(data[sizeOfBatchHeader+8*i:], event)
+		}
+		return data
+	}
+
+	require.NoError(t, consumer.processRecord(record(0, 42)))
+	// wakeup record
+	require.NoError(t, consumer.processRecord(record(3)))
+	assert.Equal(t, []uint64{42}, result)
+	assert.Equal(t, int64(1), consumer.eventsCount.Get())
+	assert.Equal(t, int64(3), consumer.kernelDropsCount.Get())
+	// the record has no timestamp, as if it was written at boot
+	assert.Equal(t, int64(1), consumer.queueingLatency[ddebpf.QueueingLatencyBuckets-1].Get())
+
+	truncated := record(0, 43)
+	assert.Error(t, consumer.processRecord(truncated[:len(truncated)-1]))
+	assert.Error(t, consumer.processRecord(truncated[:sizeOfBatchHeader-1]))
+
+	columnar := record(0, 44)
+	binary.NativeEndian.PutUint16(columnar[unsafe.Offsetof(batch{}.Layout):], layoutColumnar)
+	binary.NativeEndian.PutUint16(columnar[unsafe.Offsetof(batch{}.Head_size):], 4)
+	assert.ErrorIs(t, consumer.processRecord(columnar), errInvalidLayout)
+	assert.Equal(t, []uint64{42}, result)
+}
+
+func TestConsumerProcessColumnar(t *testing.T) {
+	type head struct{ ID uint32 }
+	type tail struct{ Payload [4]byte }
+
+	var heads []head
+	var tails []tail
+	metricGroup := telemetry.NewMetricGroup("usm.test_columnar")
+	consumer := &Consumer[head]{
+		offsets:            newOffsetManager(1),
+		eventsCount:        metricGroup.NewCounter("events_captured"),
+		invalidEventsCount: metricGroup.NewCounter("invalid_events"),
+		layout:             layoutColumnar,
+		eventSize:          8,
+		headSize:           4,
+		columnarCallback: columnarDecoder(func(h []head, t []tail) {
+			heads = append(heads, h...)
+			tails = append(tails, t...)
+		}),
+	}
+	setupQueueingLatency(t, consumer, metricGroup)
+
+	// a full batch of 4 events: the heads come first, followed by the tails
+	b := &batch{Len: 4, Cap: 4, Event_size: 8, Layout: layoutColumnar, Head_size: 4}
+	for i := 0; i < 4; i++ {
+		binary.NativeEndian.PutUint32(unsafe.Slice((*byte)(unsafe.Pointer(&b.Data[4*i])), 4), uint32(i))
+		copy(unsafe.Slice((*byte)(unsafe.Pointer(&b.Data[16+4*i])), 4), fmt.Sprintf("ev%d.", i))
+	}
+
+	consumer.process(b, false)
+	require.Len(t, heads, 4)
+	require.Len(t, tails, 4)
+	for i := range heads {
+		assert.Equal(t, uint32(i), heads[i].ID)
+		assert.Equal(t, fmt.Sprintf("ev%d.", i), string(tails[i].Payload[:]))
+	}
+	assert.Equal(t, int64(4), consumer.eventsCount.Get())
+
+	// a batch written with the row layout isn't decoded
+	b.Idx++
+	b.Layout = layoutRow
+	b.Head_size = 0
+	consumer.process(b, false)
+	assert.Len(t, heads, 4)
+	assert.Equal(t, int64(1), consumer.invalidEventsCount.Get())
+}
+
+func setupQueueingLatency[V any](t *testing.T, consumer *Consumer[V], metricGroup *telemetry.MetricGroup) {
+	var err error
+	consumer.latencyClock, err = ddebpf.NewQueueingLatencyClock()
+	require.NoError(t, err)
+	for i := range consumer.queueingLatency {
+		consumer.queueingLatency[i] = metricGroup.NewCounter("queueing_latency", ddebpf.QueueingLatencyBucketTag(i))
+	}
+}
+
 type eventGenerator struct {
 	// map used for coordinating test with eBPF program space
 	testMap *ebpf.Map
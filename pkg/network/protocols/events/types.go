@@ -16,6 +16,10 @@ type batch C.batch_data_t
 type batchKey C.batch_key_t
 
 const (
-	batchPagesPerCPU = C.BATCH_PAGES_PER_CPU
-	batchBufferSize  = C.BATCH_BUFFER_SIZE
+	batchPagesPerCPU    = C.BATCH_PAGES_PER_CPU
+	batchMaxPagesPerCPU = C.BATCH_MAX_PAGES_PER_CPU
+	batchBufferSize     = C.BATCH_BUFFER_SIZE
+
+	layoutRow      = C.USM_EVENTS_LAYOUT_ROW
+	layoutColumnar = C.USM_EVENTS_LAYOUT_COLUMNAR
 )
@@ -11,6 +11,10 @@ type batch struct {
 	Event_size     uint16
 	Dropped_events uint32
 	Failed_flushes uint32
+	Layout         uint16
+	Head_size      uint16
+	Reserved       uint32
+	Ktime          uint64
 	Data           [4096]int8
 }
 type batchKey struct {
@@ -19,6 +23,10 @@ type batchKey struct {
 }
 
 const (
-	batchPagesPerCPU = 0x8
-	batchBufferSize  = 0x1000
+	batchPagesPerCPU    = 0x8
+	batchMaxPagesPerCPU = 0x40
+	batchBufferSize     = 0x1000
+
+	layoutRow      = 0x0
+	layoutColumnar = 0x1
 )
@@ -60,6 +60,9 @@ type HttpDriverInterface struct {
 	maxTransactions       uint64
 	notificationThreshold uint64
 	maxRequestFragment    uint64
+
+	// readBuffer receives the transactions flushed by the driver, guarded by readMux
+	readBuffer []byte
 }
 
 //nolint:revive // TODO(WKIT) Fix revive linter
@@ -69,6 +72,7 @@ func NewDriverInterface(c *config.Config, dh driver.Handle) (*HttpDriverInterfac
 		notificationThreshold: uint64(c.HTTPNotificationThreshold),
 		maxRequestFragment:    uint64(c.HTTPMaxRequestFragment),
 	}
+	d.readBuffer = make([]byte, (driver.HttpTransactionTypeSize+d.maxRequestFragment)*d.maxTransactions)
 	err := d.setupHTTPHandle(dh)
 	if err != nil {
 		return nil, err
@@ -154,7 +158,7 @@ func (di *HttpDriverInterface) StartReadingBuffers() {
 func (di *HttpDriverInterface) readPendingTransactions() ([]WinHttpTransaction, error) {
 	var (
 		bytesRead uint32
-		buf       = make([]byte, (driver.HttpTransactionTypeSize+di.maxRequestFragment)*di.maxTransactions)
+		buf       = di.readBuffer
 	)
 
 	err := di.driverHTTPHandle.DeviceIoControl(
@@ -171,14 +175,17 @@ func (di *HttpDriverInterface) readPendingTransactions() ([]WinHttpTransaction,
 	if bytesRead == 0 {
 		return nil, nil
 	}
-	transactionBatch := make([]WinHttpTransaction, 0)
+	transactionBatch := make([]WinHttpTransaction, 0, uint64(bytesRead)/(driver.HttpTransactionTypeSize+di.maxRequestFragment)+1)
 
+	// the read buffer is reused by the next flush, the fragments of the batch are copied to a single allocation
+	fragments := make([]byte, 0, bytesRead)
 	for i := uint32(0); i < bytesRead; {
 		var tx WinHttpTransaction
 		tx.Txn = *(*driver.HttpTransactionType)(unsafe.Pointer(&buf[i]))
-		tx.RequestFragment = make([]byte, tx.Txn.MaxRequestFragment)
 		i += driver.HttpTransactionTypeSize
-		copy(tx.RequestFragment, buf[i:i+uint32(tx.Txn.MaxRequestFragment)])
+		start := len(fragments)
+		fragments = append(fragments, buf[i:i+uint32(tx.Txn.MaxRequestFragment)]...)
+		tx.RequestFragment = fragments[start:len(fragments):len(fragments)]
 		i += uint32(tx.Txn.MaxRequestFragment)
 		transactionBatch = append(transactionBatch, tx)
 	}
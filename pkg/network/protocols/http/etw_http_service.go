@@ -1351,6 +1351,28 @@ func (hei *EtwInterface) OnEvent(eventInfo *etw.DDEventRecord) {
 	}
 }
 
+// processedHttpServiceEventIDs lists the events handled by OnEvent, it must be kept in sync with it
+var processedHttpServiceEventIDs = []uint16{
+	EVENT_ID_HttpService_HTTPConnectionTraceTaskConnConn,
+	EVENT_ID_HttpService_HTTPConnectionTraceTaskConnCleanup,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskRecvReq,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskParse,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskDeliver,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskRecvResp,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskFastResp,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskSrvdFrmCache,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskCachedNotModified,
+	EVENT_ID_HttpService_HTTPCacheTraceTaskAddedCacheEntry,
+	EVENT_ID_HttpService_HTTPCacheTraceTaskFlushedCache,
+	EVENT_ID_HttpService_HTTPSSLTraceTaskSslConnEvent,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskSendComplete,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskCachedAndSend,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskFastSend,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskZeroSend,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskLastSndError,
+	EVENT_ID_HttpService_HTTPRequestTraceTaskRequestRejectedArgs,
+}
+
 // can be called multiple times
 //
 //nolint:revive // TODO(WKIT) Fix revive linter
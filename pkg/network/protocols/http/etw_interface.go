@@ -65,6 +65,11 @@ func NewEtwInterface(c *config.Config) (*EtwInterface, error) {
 		cfg.TraceLevel = etw.TRACE_LEVEL_INFORMATION
 		cfg.PIDs = pidsList
 		cfg.MatchAnyKeyword = 0x136
+		// let the provider drop the events that the callback doesn't process, rather than paying a cgo callback for
+		// each of them. The verbose logs report the unprocessed events, keep them in that case.
+		if HttpServiceLogVerbosity == HttpServiceLogNone {
+			cfg.EnabledIDs = processedHttpServiceEventIDs
+		}
 	})
 	err = ei.session.EnableProvider(ei.httpguid)
 	if err != nil {
@@ -68,6 +68,23 @@ func TestPathHandlesNullTerminator(t *testing.T) {
 	assert.False(t, fullPath)
 }
 
+func TestPathOnlyCapture(t *testing.T) {
+	bs := getBufferSize()
+
+	// the fragment is cleared after the byte ending the path
+	tx := makeTxnFromRequestString("GET /foo/bar?")
+	b := make([]byte, bs)
+	path, fullPath := tx.Path(b)
+	assert.Equal(t, "/foo/bar", string(path))
+	assert.True(t, fullPath)
+
+	// the path was truncated to the maximum length
+	tx = makeTxnFromRequestString("GET /foo/b")
+	path, fullPath = tx.Path(b)
+	assert.Equal(t, "/foo/b", string(path))
+	assert.False(t, fullPath)
+}
+
 func TestLatency(t *testing.T) {
 	tx := makeTxnFromLatency(2e6, 1e6)
 	// quantization brings it down
@@ -63,6 +63,9 @@ var Spec = &protocols.ProtocolSpec{
 		{
 			Name: "http_batches",
 		},
+		{
+			Name: "http_pipeline",
+		},
 	},
 	TailCalls: []manager.TailCallRoute{
 		{
@@ -120,6 +123,7 @@ func (p *protocol) Name() string {
 // ConfigureOptions add the necessary options for the http monitoring to work,
 // to be used by the manager. These are:
 // - Set the `http_in_flight` map size to the value of the `max_tracked_connection` configuration variable.
+// - Set the constants of the path-only capture of the request fragments.
 //
 // We also configure the http event stream with the manager and its options.
 func (p *protocol) ConfigureOptions(mgr *manager.Manager, opts *manager.Options) {
@@ -128,10 +132,23 @@ func (p *protocol) ConfigureOptions(mgr *manager.Manager, opts *manager.Options)
 		EditorFlag: manager.EditMaxEntries,
 	}
 	utils.EnableOption(opts, "http_monitoring_enabled")
+	utils.AddBoolConst(opts, p.cfg.HTTPPathOnlyCapture, "http_path_only_capture")
+	opts.ConstantEditors = append(opts.ConstantEditors, manager.ConstantEditor{
+		Name:  "http_max_path_length",
+		Value: maxPathLength(p.cfg),
+	})
 	// Configure event stream
 	events.Configure(p.cfg, eventStream, mgr, opts)
 }
 
+// maxPathLength returns the length of the paths captured in path-only mode, a fragment holds at most BufferSize bytes
+func maxPathLength(c *config.Config) uint64 {
+	if c.HTTPMaxPathLength <= 0 || c.HTTPMaxPathLength > BufferSize {
+		return BufferSize
+	}
+	return uint64(c.HTTPMaxPathLength)
+}
+
 func (p *protocol) PreStart(mgr *manager.Manager) (err error) {
 	p.eventsConsumer, err = events.NewConsumer(
 		"http",
@@ -17,7 +17,8 @@ type ConnTuple = struct {
 type SslSock struct {
 	Tup       ConnTuple
 	Fd        uint32
-	Pad_cgo_0 [4]byte
+	Ignored   bool
+	Pad_cgo_0 [3]byte
 }
 type SslReadArgs struct {
 	Ctx *byte
@@ -35,7 +36,7 @@ type EbpfTx struct {
 	Tcp_seq              uint32
 	Response_status_code uint16
 	Request_method       uint8
-	Pad_cgo_0            [1]byte
+	Pipeline             uint8
 	Request_fragment     [208]byte
 }
 
@@ -0,0 +1,60 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package http2
+
+import (
+	"sync"
+)
+
+// grpcStatKeeper counts the gRPC calls by connection and status code.
+type grpcStatKeeper struct {
+	stats      map[GRPCKey]*GRPCStat
+	statsMutex sync.Mutex
+	maxEntries int
+}
+
+func newGRPCStatKeeper(maxEntries int) *grpcStatKeeper {
+	s := &grpcStatKeeper{
+		maxEntries: maxEntries,
+	}
+	s.resetNoLock()
+	return s
+}
+
+// process counts the gRPC call of the transaction, whose status was read from its grpc-status trailer.
+func (s *grpcStatKeeper) process(tx *EbpfTx, status uint8) {
+	s.statsMutex.Lock()
+	defer s.statsMutex.Unlock()
+
+	key := GRPCKey{
+		Status:        status,
+		ConnectionKey: tx.ConnTuple(),
+	}
+	stat, ok := s.stats[key]
+	if !ok {
+		if len(s.stats) >= s.maxEntries {
+			return
+		}
+		stat = new(GRPCStat)
+		s.stats[key] = stat
+	}
+	stat.Count++
+}
+
+// getAndResetAllStats returns all the records and resets the statskeeper
+func (s *grpcStatKeeper) getAndResetAllStats() map[GRPCKey]*GRPCStat {
+	s.statsMutex.Lock()
+	defer s.statsMutex.Unlock()
+	ret := s.stats // No deep copy needed since `s.stats` gets reset
+	s.resetNoLock()
+	return ret
+}
+
+func (s *grpcStatKeeper) resetNoLock() {
+	s.stats = make(map[GRPCKey]*GRPCStat)
+}
@@ -0,0 +1,39 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+package http2
+
+import (
+	"github.com/DataDog/datadog-agent/pkg/network/types"
+	"github.com/DataDog/datadog-agent/pkg/process/util"
+)
+
+// This file contains the structs used to store and combine the gRPC stats.
+// The file does not have any build tag, so it can be used in any build as it is used by the tracer package.
+
+// GRPCKey is an identifier for a group of gRPC calls, by connection and status code.
+type GRPCKey struct {
+	Status uint8
+	types.ConnectionKey
+}
+
+// NewGRPCKey creates a new gRPC key
+func NewGRPCKey(saddr, daddr util.Address, sport, dport uint16, status uint8) GRPCKey {
+	return GRPCKey{
+		ConnectionKey: types.NewConnectionKey(saddr, daddr, sport, dport),
+		Status:        status,
+	}
+}
+
+// GRPCStat represents a group of gRPC calls that has a shared key.
+type GRPCStat struct {
+	Count int
+}
+
+// CombineWith merges the data in 2 GRPCStat objects
+// newStats is kept as it is, while the method receiver gets mutated
+func (r *GRPCStat) CombineWith(newStats *GRPCStat) {
+	r.Count += newStats.Count
+}
@@ -0,0 +1,54 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package http2
+
+import (
+	"google.golang.org/grpc/codes"
+
+	libtelemetry "github.com/DataDog/datadog-agent/pkg/network/protocols/telemetry"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
+)
+
+// grpcStatusCount is the number of gRPC status codes, from OK (0) to Unauthenticated (16).
+const grpcStatusCount = int(codes.Unauthenticated) + 1
+
+// grpcTelemetry counts the gRPC calls by the status read from the grpc-status trailer of their response.
+type grpcTelemetry struct {
+	// metricGroup is used here mostly for building the log message below
+	metricGroup *libtelemetry.MetricGroup
+
+	// byStatus Count of gRPC calls per status code.
+	byStatus [grpcStatusCount]*libtelemetry.Counter
+	// unknownStatus Count of gRPC calls whose status is out of the range of the status codes.
+	unknownStatus *libtelemetry.Counter
+}
+
+func newGRPCTelemetry() *grpcTelemetry {
+	metricGroup := libtelemetry.NewMetricGroup("usm.grpc", libtelemetry.OptPrometheus)
+	t := &grpcTelemetry{
+		metricGroup:   metricGroup,
+		unknownStatus: metricGroup.NewCounter("responses", "status:unknown"),
+	}
+	for code := range t.byStatus {
+		t.byStatus[code] = metricGroup.NewCounter("responses", "status:"+codes.Code(code).String())
+	}
+	return t
+}
+
+// count records the gRPC status of a transaction, read from its grpc-status trailer.
+func (t *grpcTelemetry) count(code uint8) {
+	if int(code) >= grpcStatusCount {
+		t.unknownStatus.Add(1)
+		return
+	}
+	t.byStatus[code].Add(1)
+}
+
+func (t *grpcTelemetry) log() {
+	log.Debugf("grpc telemetry summary: %s", t.metricGroup.Summary())
+}
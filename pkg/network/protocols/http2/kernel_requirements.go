@@ -8,6 +8,10 @@
 package http2
 
 import (
+	"github.com/cilium/ebpf"
+	"github.com/cilium/ebpf/asm"
+	"github.com/cilium/ebpf/features"
+
 	"github.com/DataDog/datadog-agent/pkg/util/kernel"
 	"github.com/DataDog/datadog-agent/pkg/util/log"
 )
@@ -30,3 +34,14 @@ func Supported() bool {
 
 	return kversion >= MinimumKernelVersion
 }
+
+// bpfLoopSupported returns true if the kernel has the bpf_loop helper (5.17+), for both the socket filters and the
+// uprobes, letting the EOS parsers handle all the frames of a packet in a single program.
+func bpfLoopSupported() bool {
+	for _, progType := range []ebpf.ProgramType{ebpf.SocketFilter, ebpf.Kprobe} {
+		if err := features.HaveProgramHelper(progType, asm.FnLoop); err != nil {
+			return false
+		}
+	}
+	return true
+}
@@ -28,6 +28,9 @@ import (
 
 var oversizedLogLimit = log.NewLogLimit(10, time.Minute*10)
 
+// pathCache caches the decoded Huffman-encoded paths of all the transactions
+var pathCache = newHuffmanPathCache(huffmanPathCacheSize)
+
 // validatePath validates the given path.
 func validatePath(str string) error {
 	if len(str) == 0 {
@@ -90,7 +93,7 @@ func (tx *EbpfTx) Path(buffer []byte) ([]byte, bool) {
 	var res []byte
 	var err error
 	if tx.Stream.Path.Is_huffman_encoded {
-		res, err = decodeHTTP2Path(tx.Stream.Path.Raw_buffer, tx.Stream.Path.Length)
+		res, err = pathCache.decode(&tx.Stream.Path.Raw_buffer, tx.Stream.Path.Length)
 		if err != nil {
 			if oversizedLogLimit.ShouldLog() {
 				log.Warnf("unable to decode HTTP2 path (%#v) due to: %s", tx.Stream.Path.Raw_buffer[:tx.Stream.Path.Length], err)
@@ -267,6 +270,29 @@ func (tx *EbpfTx) StatusCode() uint16 {
 	return uint16(code)
 }
 
+// GRPCStatus returns the gRPC status code of the transaction, read from the grpc-status trailer of the response.
+// It returns false if the response has no grpc-status trailer, or if its value could not be decoded.
+func (tx *EbpfTx) GRPCStatus() (uint8, bool) {
+	status := &tx.Stream.Grpc_status
+	if !status.Finalized || status.Length == 0 || int(status.Length) > http2RawGRPCStatusMaxLength {
+		return 0, false
+	}
+
+	raw := status.Raw_buffer[:status.Length]
+	value := string(raw)
+	if status.Is_huffman_encoded {
+		var err error
+		if value, err = hpack.HuffmanDecodeToString(raw); err != nil {
+			return 0, false
+		}
+	}
+	code, err := strconv.ParseUint(value, 10, 8)
+	if err != nil {
+		return 0, false
+	}
+	return uint8(code), true
+}
+
 // SetStatusCode sets the HTTP status code of the transaction.
 func (tx *EbpfTx) SetStatusCode(code uint16) {
 	val := strconv.Itoa(int(code))
@@ -90,6 +90,30 @@ func TestHTTP2Path(t *testing.T) {
 	}
 }
 
+func TestHuffmanPathCache(t *testing.T) {
+	cache := newHuffmanPathCache(1)
+
+	var arr [maxHTTP2Path]uint8
+	n := copy(arr[:], hpack.AppendHuffmanString(nil, "/hello.HelloService/SayHello"))
+	path, err := cache.decode(&arr, uint8(n))
+	assert.NoError(t, err)
+	assert.Equal(t, "/hello.HelloService/SayHello", string(path))
+	assert.Equal(t, 1, cache.cache.Len())
+
+	// the bytes following the path don't change the key
+	arr[n] = 0xff
+	path, err = cache.decode(&arr, uint8(n))
+	assert.NoError(t, err)
+	assert.Equal(t, "/hello.HelloService/SayHello", string(path))
+	assert.Equal(t, 1, cache.cache.Len())
+
+	// invalid paths aren't cached
+	n = copy(arr[:], hpack.AppendHuffmanString(nil, "hello.HelloService/SayHello"))
+	_, err = cache.decode(&arr, uint8(n))
+	assert.Error(t, err)
+	assert.Equal(t, 1, cache.cache.Len())
+}
+
 func TestHTTP2Method(t *testing.T) {
 	tests := []struct {
 		name   string
@@ -145,3 +169,66 @@ func TestHTTP2Method(t *testing.T) {
 		})
 	}
 }
+
+func TestHTTP2GRPCStatus(t *testing.T) {
+	tests := []struct {
+		name          string
+		rawStatus     string
+		finalized     bool
+		expectedCode  uint8
+		expectedFound bool
+	}{
+		{
+			name:          "OK",
+			rawStatus:     "0",
+			finalized:     true,
+			expectedCode:  0,
+			expectedFound: true,
+		},
+		{
+			name:          "Two digits",
+			rawStatus:     "14",
+			finalized:     true,
+			expectedCode:  14,
+			expectedFound: true,
+		},
+		{
+			name:      "Not a number",
+			rawStatus: "a",
+			finalized: true,
+		},
+		{
+			name:      "No trailer",
+			rawStatus: "0",
+		},
+	}
+
+	for _, tt := range tests {
+		for _, huffmanEnabled := range []bool{false, true} {
+			testNameSuffix := fmt.Sprintf("huffman-enabled=%v", huffmanEnabled)
+			t.Run(tt.name+testNameSuffix, func(t *testing.T) {
+				buf := []byte(tt.rawStatus)
+				if huffmanEnabled {
+					buf = hpack.AppendHuffmanString(nil, tt.rawStatus)
+				}
+				var arr [http2RawGRPCStatusMaxLength]uint8
+				copy(arr[:], buf)
+
+				request := &EbpfTx{
+					Stream: HTTP2Stream{
+						Grpc_status: http2GRPCStatus{
+							Raw_buffer:         arr,
+							Length:             uint8(len(buf)),
+							Is_huffman_encoded: huffmanEnabled,
+							Finalized:          tt.finalized,
+						},
+					},
+				}
+
+				code, found := request.GRPCStatus()
+				assert.Equal(t, tt.expectedFound, found)
+				assert.Equal(t, tt.expectedCode, code)
+			})
+		}
+	}
+}
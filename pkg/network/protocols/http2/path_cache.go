@@ -0,0 +1,55 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package http2
+
+import (
+	lru "github.com/hashicorp/golang-lru/v2"
+)
+
+// huffmanPathCacheSize is the number of decoded paths kept by the cache. gRPC services repeat a few hundred
+// method paths, which are all kept.
+const huffmanPathCacheSize = 1024
+
+// huffmanPathKey is a Huffman-encoded path, the bytes following the path are zeroed.
+type huffmanPathKey struct {
+	buf [maxHTTP2Path]byte
+	len uint8
+}
+
+// huffmanPathCache maps the Huffman-encoded paths to their decoded value, so that the paths repeated by the events
+// are decoded once.
+type huffmanPathCache struct {
+	cache *lru.Cache[huffmanPathKey, []byte]
+}
+
+func newHuffmanPathCache(size int) *huffmanPathCache {
+	// lru.New only fails with a non-positive size
+	cache, _ := lru.New[huffmanPathKey, []byte](size)
+	return &huffmanPathCache{cache: cache}
+}
+
+// decode returns the decoded path of the encoded path, using decodeHTTP2Path for the paths not in the cache.
+// The returned slice is shared by the callers and must not be modified.
+func (c *huffmanPathCache) decode(buf *[maxHTTP2Path]byte, pathSize uint8) ([]byte, error) {
+	if err := validatePathSize(pathSize); err != nil {
+		return nil, err
+	}
+
+	key := huffmanPathKey{len: pathSize}
+	copy(key.buf[:pathSize], buf[:pathSize])
+	if path, ok := c.cache.Get(key); ok {
+		return path, nil
+	}
+
+	path, err := decodeHTTP2Path(*buf, pathSize)
+	if err != nil {
+		return nil, err
+	}
+	c.cache.Add(key, path)
+	return path, nil
+}
@@ -10,6 +10,7 @@ package http2
 import (
 	"fmt"
 	"io"
+	"slices"
 	"time"
 	"unsafe"
 
@@ -33,7 +34,9 @@ type Protocol struct {
 	cfg                     *config.Config
 	mgr                     *manager.Manager
 	telemetry               *http.Telemetry
+	grpcTelemetry           *grpcTelemetry
 	statkeeper              *http.StatKeeper
+	grpcStatkeeper          *grpcStatKeeper
 	http2InFlightMapCleaner *ddebpf.MapCleaner[HTTP2StreamKey, HTTP2Stream]
 	eventsConsumer          *events.Consumer[EbpfTx]
 
@@ -55,8 +58,8 @@ const (
 	firstFrameHandlerTailCall = "socket__http2_handle_first_frame"
 	filterTailCall            = "socket__http2_filter"
 	headersParserTailCall     = "socket__http2_headers_parser"
-	dynamicTableCleaner       = "socket__http2_dynamic_table_cleaner"
 	eosParserTailCall         = "socket__http2_eos_parser"
+	eosParserLoopTailCall     = "socket__http2_eos_parser_loop"
 	eventStream               = "http2"
 
 	// TelemetryMap is the name of the map used to retrieve plaintext metrics from the kernel
@@ -67,8 +70,8 @@ const (
 	tlsFirstFrameTailCall    = "uprobe__http2_tls_handle_first_frame"
 	tlsFilterTailCall        = "uprobe__http2_tls_filter"
 	tlsHeadersParserTailCall = "uprobe__http2_tls_headers_parser"
-	tlsDynamicTableCleaner   = "uprobe__http2_dynamic_table_cleaner"
 	tlsEOSParserTailCall     = "uprobe__http2_tls_eos_parser"
+	tlsEOSParserLoopTailCall = "uprobe__http2_tls_eos_parser_loop"
 	tlsTerminationTailCall   = "uprobe__http2_tls_termination"
 )
 
@@ -149,16 +152,17 @@ var Spec = &protocols.ProtocolSpec{
 		},
 		{
 			ProgArrayName: protocols.ProtocolDispatcherProgramsMap,
-			Key:           uint32(protocols.ProgramHTTP2DynamicTableCleaner),
+			Key:           uint32(protocols.ProgramHTTP2EOSParser),
 			ProbeIdentificationPair: manager.ProbeIdentificationPair{
-				EBPFFuncName: dynamicTableCleaner,
+				EBPFFuncName: eosParserTailCall,
 			},
 		},
+		// Only one of the EOS parsers is loaded, see ConfigureOptions.
 		{
 			ProgArrayName: protocols.ProtocolDispatcherProgramsMap,
 			Key:           uint32(protocols.ProgramHTTP2EOSParser),
 			ProbeIdentificationPair: manager.ProbeIdentificationPair{
-				EBPFFuncName: eosParserTailCall,
+				EBPFFuncName: eosParserLoopTailCall,
 			},
 		},
 		{
@@ -184,16 +188,16 @@ var Spec = &protocols.ProtocolSpec{
 		},
 		{
 			ProgArrayName: protocols.TLSDispatcherProgramsMap,
-			Key:           uint32(protocols.ProgramTLSHTTP2DynamicTableCleaner),
+			Key:           uint32(protocols.ProgramTLSHTTP2EOSParser),
 			ProbeIdentificationPair: manager.ProbeIdentificationPair{
-				EBPFFuncName: tlsDynamicTableCleaner,
+				EBPFFuncName: tlsEOSParserTailCall,
 			},
 		},
 		{
 			ProgArrayName: protocols.TLSDispatcherProgramsMap,
 			Key:           uint32(protocols.ProgramTLSHTTP2EOSParser),
 			ProbeIdentificationPair: manager.ProbeIdentificationPair{
-				EBPFFuncName: tlsEOSParserTailCall,
+				EBPFFuncName: tlsEOSParserLoopTailCall,
 			},
 		},
 		{
@@ -221,6 +225,8 @@ func newHTTP2Protocol(cfg *config.Config) (protocols.Protocol, error) {
 	return &Protocol{
 		cfg:                        cfg,
 		telemetry:                  telemetry,
+		grpcTelemetry:              newGRPCTelemetry(),
+		grpcStatkeeper:             newGRPCStatKeeper(cfg.MaxHTTPStatsBuffered),
 		http2Telemetry:             http2KernelTelemetry,
 		kernelTelemetryStopChannel: make(chan struct{}),
 		dynamicTable:               NewDynamicTable(cfg),
@@ -239,6 +245,7 @@ const (
 // ConfigureOptions add the necessary options for http2 monitoring to work,
 // to be used by the manager. These are:
 // - Set the `http2_in_flight` map size to the value of the `max_tracked_connection` configuration variable.
+// - Pick the EOS parsers iterating with bpf_loop on the kernels supporting it, and the tail-call chained ones otherwise.
 //
 // We also configure the http2 event stream with the manager and its options.
 func (p *Protocol) ConfigureOptions(mgr *manager.Manager, opts *manager.Options) {
@@ -267,6 +274,16 @@ func (p *Protocol) ConfigureOptions(mgr *manager.Manager, opts *manager.Options)
 		EditorFlag: manager.EditMaxEntries,
 	}
 
+	unusedEOSParsers := []string{eosParserLoopTailCall, tlsEOSParserLoopTailCall}
+	if bpfLoopSupported() {
+		unusedEOSParsers = []string{eosParserTailCall, tlsEOSParserTailCall}
+	}
+	opts.ExcludedFunctions = append(opts.ExcludedFunctions, unusedEOSParsers...)
+	// The router is shared with the manager, hence the copy.
+	opts.TailCallRouter = slices.DeleteFunc(slices.Clone(opts.TailCallRouter), func(route manager.TailCallRoute) bool {
+		return slices.Contains(unusedEOSParsers, route.ProbeIdentificationPair.EBPFFuncName)
+	})
+
 	utils.EnableOption(opts, "http2_monitoring_enabled")
 	utils.EnableOption(opts, "terminated_http2_monitoring_enabled")
 	// Configure event stream
@@ -398,6 +415,10 @@ func (p *Protocol) processHTTP2(events []EbpfTx) {
 	for i := range events {
 		tx := &events[i]
 		p.telemetry.Count(tx)
+		if status, ok := tx.GRPCStatus(); ok {
+			p.grpcTelemetry.count(status)
+			p.grpcStatkeeper.process(tx, status)
+		}
 		p.statkeeper.Process(tx)
 	}
 }
@@ -432,12 +453,24 @@ func (p *Protocol) setupHTTP2InFlightMapCleaner(mgr *manager.Manager) {
 func (p *Protocol) GetStats() *protocols.ProtocolStats {
 	p.eventsConsumer.Sync()
 	p.telemetry.Log()
+	p.grpcTelemetry.log()
 	return &protocols.ProtocolStats{
 		Type:  protocols.HTTP2,
 		Stats: p.statkeeper.GetAndResetAllStats(),
 	}
 }
 
+// GetExtraStats returns the gRPC stats, counted by connection and status code. It is called right after
+// GetStats, which synced the events consumer.
+func (p *Protocol) GetExtraStats() []*protocols.ProtocolStats {
+	return []*protocols.ProtocolStats{
+		{
+			Type:  protocols.GRPC,
+			Stats: p.grpcStatkeeper.getAndResetAllStats(),
+		},
+	}
+}
+
 // IsBuildModeSupported returns always true, as http2 module is supported by all modes.
 func (*Protocol) IsBuildModeSupported(buildmode.Type) bool {
 	return true
@@ -21,6 +21,8 @@ const (
 	// The upper limit for the size of the raw status code.
 	// If the status code is huffman encoded, the size is 2 characters, while if it is not encoded, the size is 3 characters.
 	http2RawStatusCodeMaxLength = C.HTTP2_STATUS_CODE_MAX_LEN
+	// The upper limit for the size of the raw grpc-status value, either huffman encoded or not.
+	http2RawGRPCStatusMaxLength = C.HTTP2_GRPC_STATUS_MAX_LEN
 	// The max number of headers we process in the request/response.
 	Http2MaxHeadersCountPerFiltering = C.HTTP2_MAX_HEADERS_COUNT_FOR_FILTERING
 )
@@ -32,6 +34,7 @@ type HTTP2StreamKey C.http2_stream_key_t
 type http2StatusCode C.status_code_t
 type http2requestMethod C.method_t
 type http2Path C.path_t
+type http2GRPCStatus C.grpc_status_code_t
 type HTTP2Stream C.http2_stream_t
 type EbpfTx C.http2_event_t
 type HTTP2Telemetry C.http2_telemetry_t
@@ -11,6 +11,8 @@ const (
 
 	http2RawStatusCodeMaxLength = 0x3
 
+	http2RawGRPCStatusMaxLength = 0x2
+
 	Http2MaxHeadersCountPerFiltering = 0x21
 )
 
@@ -31,6 +33,7 @@ type HTTP2DynamicTableIndex struct {
 }
 type HTTP2DynamicTableEntry struct {
 	Buffer             [160]int8
+	Index              uint64
 	Original_index     uint32
 	String_len         uint8
 	Is_huffman_encoded bool
@@ -61,6 +64,12 @@ type http2Path struct {
 	Length             uint8
 	Finalized          bool
 }
+type http2GRPCStatus struct {
+	Raw_buffer         [2]uint8
+	Length             uint8
+	Is_huffman_encoded bool
+	Finalized          bool
+}
 type HTTP2Stream struct {
 	Response_last_seen uint64
 	Request_started    uint64
@@ -68,8 +77,9 @@ type HTTP2Stream struct {
 	Status_code        http2StatusCode
 	Request_method     http2requestMethod
 	Path               http2Path
+	Grpc_status        http2GRPCStatus
 	End_of_stream_seen bool
-	Pad_cgo_0          [1]byte
+	Pad_cgo_0          [4]byte
 }
 type EbpfTx struct {
 	Tuple  ConnTuple
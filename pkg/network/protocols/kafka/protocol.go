@@ -9,6 +9,7 @@ package kafka
 
 import (
 	"io"
+	"math"
 	"time"
 	"unsafe"
 
@@ -32,6 +33,10 @@ type protocol struct {
 	inFlightMapCleaner *ddebpf.MapCleaner[KafkaTransactionKey, KafkaTransaction]
 	eventsConsumer     *events.Consumer[EbpfTx]
 
+	// aggregatedStatsMap is only set when the in-kernel aggregation is enabled
+	aggregatedStatsMap *ebpf.Map
+	topicNamesMap      *ebpf.Map
+
 	kernelTelemetry            *kernelTelemetry
 	kernelTelemetryStopChannel chan struct{}
 }
@@ -49,6 +54,9 @@ const (
 	kafkaHeapMap       = "kafka_heap"
 	inFlightMap        = "kafka_in_flight"
 	responseMap        = "kafka_response"
+	aggregatedStatsMap = "kafka_aggregated_stats"
+	topicNamesMap      = "kafka_topic_names"
+	clientIDsMap       = "kafka_client_ids"
 
 	tlsFilterTailCall = "uprobe__kafka_tls_filter"
 
@@ -76,6 +84,15 @@ var Spec = &protocols.ProtocolSpec{
 		{
 			Name: responseMap,
 		},
+		{
+			Name: aggregatedStatsMap,
+		},
+		{
+			Name: topicNamesMap,
+		},
+		{
+			Name: clientIDsMap,
+		},
 		{
 			Name: "kafka_client_id",
 		},
@@ -220,8 +237,19 @@ func (p *protocol) ConfigureOptions(mgr *manager.Manager, opts *manager.Options)
 		MaxEntries: p.cfg.MaxUSMConcurrentRequests,
 		EditorFlag: manager.EditMaxEntries,
 	}
+	opts.MapSpecEditors[clientIDsMap] = manager.MapSpecEditor{
+		MaxEntries: p.cfg.MaxUSMConcurrentRequests,
+		EditorFlag: manager.EditMaxEntries,
+	}
+	if p.cfg.KafkaInKernelAggregation {
+		opts.MapSpecEditors[aggregatedStatsMap] = manager.MapSpecEditor{
+			MaxEntries: p.cfg.MaxUSMConcurrentRequests,
+			EditorFlag: manager.EditMaxEntries,
+		}
+	}
 	events.Configure(p.cfg, eventStreamName, mgr, opts)
 	utils.EnableOption(opts, "kafka_monitoring_enabled")
+	utils.AddBoolConst(opts, p.cfg.KafkaInKernelAggregation, "kafka_in_kernel_aggregation")
 }
 
 // PreStart creates the kafka events consumer and starts it.
@@ -236,7 +264,12 @@ func (p *protocol) PreStart(mgr *manager.Manager) error {
 		return err
 	}
 
-	p.statkeeper = NewStatkeeper(p.cfg, p.telemetry)
+	p.topicNamesMap, _, err = mgr.GetMap(topicNamesMap)
+	if err != nil {
+		return err
+	}
+
+	p.statkeeper = NewStatkeeper(p.cfg, p.telemetry, p.lookupTopicName)
 	p.eventsConsumer.Start()
 
 	return nil
@@ -245,6 +278,13 @@ func (p *protocol) PreStart(mgr *manager.Manager) error {
 // PostStart starts the map cleaner.
 func (p *protocol) PostStart(mgr *manager.Manager) error {
 	p.setUpKernelTelemetryCollection(mgr)
+	if p.cfg.KafkaInKernelAggregation {
+		aggregatedStats, _, err := mgr.GetMap(aggregatedStatsMap)
+		if err != nil {
+			return err
+		}
+		p.aggregatedStatsMap = aggregatedStats
+	}
 	return p.setupInFlightMapCleaner(mgr)
 }
 
@@ -279,6 +319,30 @@ func (p *protocol) DumpMaps(w io.Writer, mapName string, currentMap *ebpf.Map) {
 		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
 			spew.Fdump(w, key, value)
 		}
+	case aggregatedStatsMap:
+		var key KafkaAggregationKey
+		var value KafkaAggregatedStats
+		protocols.WriteMapDumpHeader(w, currentMap, mapName, key, value)
+		iter := currentMap.Iterate()
+		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
+			spew.Fdump(w, key, value)
+		}
+	case topicNamesMap:
+		var key uint64
+		var value KafkaTopicName
+		protocols.WriteMapDumpHeader(w, currentMap, mapName, key, value)
+		iter := currentMap.Iterate()
+		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
+			spew.Fdump(w, key, value)
+		}
+	case clientIDsMap:
+		var key ConnTuple
+		var value uint64
+		protocols.WriteMapDumpHeader(w, currentMap, mapName, key, value)
+		iter := currentMap.Iterate()
+		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
+			spew.Fdump(w, key, value)
+		}
 	}
 }
 
@@ -290,6 +354,58 @@ func (p *protocol) processKafka(events []EbpfTx) {
 	}
 }
 
+// lookupTopicName reads the topic name having the given hash from the kafka_topic_names map.
+func (p *protocol) lookupTopicName(hash uint64) (string, bool) {
+	var value KafkaTopicName
+	if err := p.topicNamesMap.Lookup(unsafe.Pointer(&hash), unsafe.Pointer(&value)); err != nil {
+		return "", false
+	}
+	size := min(int(value.Topic_name_size), len(value.Topic_name))
+	return string(value.Topic_name[:size]), true
+}
+
+// drainAggregatedStats moves the stats aggregated in the kernel to the statkeeper.
+func (p *protocol) drainAggregatedStats() {
+	if p.aggregatedStatsMap == nil {
+		return
+	}
+
+	// The keys are collected first, as deleting the entries of a hash map while iterating over it restarts the
+	// iteration.
+	var key KafkaAggregationKey
+	var value KafkaAggregatedStats
+	var keys []KafkaAggregationKey
+	iter := p.aggregatedStatsMap.Iterate()
+	for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
+		keys = append(keys, key)
+	}
+	if err := iter.Err(); err != nil {
+		log.Warnf("unable to iterate %q map: %s", aggregatedStatsMap, err)
+	}
+
+	for i := range keys {
+		// Reading each value right before deleting its entry narrows the window in which the kernel increments are
+		// lost.
+		if err := p.aggregatedStatsMap.Lookup(unsafe.Pointer(&keys[i]), unsafe.Pointer(&value)); err != nil {
+			continue
+		}
+		_ = p.aggregatedStatsMap.Delete(unsafe.Pointer(&keys[i]))
+
+		tx := EbpfTx{
+			Tup: keys[i].Tup,
+			Transaction: KafkaTransaction{
+				Records_count:       uint32(min(value.Records_count, math.MaxUint32)),
+				Request_api_key:     keys[i].Request_api_key,
+				Request_api_version: keys[i].Request_api_version,
+				Topic_name_hash:     keys[i].Topic_name_hash,
+				Topic_name_size:     keys[i].Topic_name_size,
+			},
+		}
+		p.telemetry.CountRequests(&tx.Transaction, int64(value.Requests_count))
+		p.statkeeper.Process(&tx)
+	}
+}
+
 func (p *protocol) setupInFlightMapCleaner(mgr *manager.Manager) error {
 	inFlightMap, _, err := mgr.GetMap(inFlightMap)
 	if err != nil {
@@ -314,6 +430,7 @@ func (p *protocol) setupInFlightMapCleaner(mgr *manager.Manager) error {
 // [source, dest tuple, request path] -> RequestStats object
 func (p *protocol) GetStats() *protocols.ProtocolStats {
 	p.eventsConsumer.Sync()
+	p.drainAggregatedStats()
 	p.telemetry.Log()
 	return &protocols.ProtocolStats{
 		Type:  protocols.Kafka,
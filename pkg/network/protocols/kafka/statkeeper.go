@@ -10,6 +10,8 @@ package kafka
 import (
 	"sync"
 
+	"github.com/google/uuid"
+
 	"github.com/DataDog/datadog-agent/pkg/network/config"
 	"github.com/DataDog/datadog-agent/pkg/util/log"
 )
@@ -21,18 +23,21 @@ type StatKeeper struct {
 	maxEntries int
 	telemetry  *Telemetry
 
-	// topicNames stores interned versions of the all topics currently stored in
-	// the `StatKeeper`
-	topicNames map[string]string
+	// topicNames resolves the topic name hashes of the transactions
+	topicNames *topicNameCache
+
+	// topicIDs resolves the topic IDs of the fetch v13+ requests
+	topicIDs *topicIDCache
 }
 
 // NewStatkeeper creates a new StatKeeper
-func NewStatkeeper(c *config.Config, telemetry *Telemetry) *StatKeeper {
+func NewStatkeeper(c *config.Config, telemetry *Telemetry, lookupTopicName TopicNameLookup) *StatKeeper {
 	return &StatKeeper{
 		stats:      make(map[Key]*RequestStat),
 		maxEntries: c.MaxKafkaStatsBuffered,
 		telemetry:  telemetry,
-		topicNames: make(map[string]string),
+		topicNames: newTopicNameCache(topicNameCacheSize, lookupTopicName),
+		topicIDs:   newTopicIDCache(topicIDCacheSize),
 	}
 }
 
@@ -41,10 +46,16 @@ func (statKeeper *StatKeeper) Process(tx *EbpfTx) {
 	statKeeper.statsMutex.Lock()
 	defer statKeeper.statsMutex.Unlock()
 
+	topicName, ok := statKeeper.extractTopicName(&tx.Transaction)
+	if !ok {
+		statKeeper.telemetry.unknownTopicName.Add(1)
+		return
+	}
+
 	key := Key{
 		RequestAPIKey:  tx.APIKey(),
 		RequestVersion: tx.APIVersion(),
-		TopicName:      statKeeper.extractTopicName(&tx.Transaction),
+		TopicName:      topicName,
 		ConnectionKey:  tx.ConnTuple(),
 	}
 	requestStats, ok := statKeeper.stats[key]
@@ -65,26 +76,21 @@ func (statKeeper *StatKeeper) GetAndResetAllStats() map[Key]*RequestStat {
 	defer statKeeper.statsMutex.RUnlock()
 	ret := statKeeper.stats // No deep copy needed since `statKeeper.stats` gets reset
 	statKeeper.stats = make(map[Key]*RequestStat)
-	statKeeper.topicNames = make(map[string]string)
 	return ret
 }
 
-func (statKeeper *StatKeeper) extractTopicName(tx *KafkaTransaction) string {
-	// Limit tx.Topic_name_size to not exceed the actual length of tx.Topic_name
-	if uint16(tx.Topic_name_size) > uint16(len(tx.Topic_name)) {
-		log.Debugf("Topic name size was changed from %d, to size: %d", tx.Topic_name_size, len(tx.Topic_name))
-		tx.Topic_name_size = uint8(len(tx.Topic_name))
+func (statKeeper *StatKeeper) extractTopicName(tx *KafkaTransaction) (string, bool) {
+	name, ok := statKeeper.topicNames.resolve(tx.Topic_name_hash)
+	if !ok {
+		log.Debugf("unknown kafka topic name hash: %x", tx.Topic_name_hash)
+		return "", false
 	}
-	b := tx.Topic_name[:tx.Topic_name_size]
 
-	// the trick here is that the Go runtime doesn't allocate the string used in
-	// the map lookup, so if we have seen this topic name before, we don't
-	// perform any allocations
-	if v, ok := statKeeper.topicNames[string(b)]; ok {
-		return v
+	if tx.Request_api_key == FetchAPIKey && tx.Request_api_version >= minFetchAPIVersionWithTopicID {
+		if id, err := uuid.FromBytes([]byte(name)); err == nil {
+			return statKeeper.topicIDs.resolve(id), true
+		}
 	}
 
-	v := string(b)
-	statKeeper.topicNames[v] = v
-	return v
+	return name, true
 }
@@ -8,23 +8,31 @@
 package kafka
 
 import (
-	"strings"
 	"testing"
 
+	"github.com/google/uuid"
+	"github.com/stretchr/testify/assert"
+
 	"github.com/DataDog/datadog-agent/pkg/network/config"
 )
 
+// newTopicNameLookup returns a TopicNameLookup serving the given names, keyed by their hash.
+func newTopicNameLookup(names map[uint64]string) TopicNameLookup {
+	return func(hash uint64) (string, bool) {
+		name, ok := names[hash]
+		return name, ok
+	}
+}
+
 func BenchmarkStatKeeperSameTX(b *testing.B) {
 	cfg := &config.Config{MaxKafkaStatsBuffered: 1000}
 	tel := NewTelemetry()
-	sk := NewStatkeeper(cfg, tel)
-
-	topicName := []byte("foobar")
-	topicNameSize := len(topicName)
+	sk := NewStatkeeper(cfg, tel, newTopicNameLookup(map[uint64]string{1: "foobar"}))
 
-	tx := new(KafkaTransaction)
-	copy(tx.Topic_name[:], topicName)
-	tx.Topic_name_size = uint8(topicNameSize)
+	tx := &KafkaTransaction{
+		Topic_name_hash: 1,
+		Topic_name_size: uint8(len("foobar")),
+	}
 
 	b.ReportAllocs()
 	b.ResetTimer()
@@ -34,37 +42,65 @@ func BenchmarkStatKeeperSameTX(b *testing.B) {
 }
 
 func TestStatKeeper_extractTopicName(t *testing.T) {
-	tests := []struct {
-		name string
-		tx   *KafkaTransaction
-		want string
-	}{
-		{
-			name: "slice bigger then Topic_name",
-			tx: &KafkaTransaction{
-				Topic_name:      [80]byte{},
-				Topic_name_size: 85,
-			},
-			want: strings.Repeat("*", 80),
-		},
-		{
-			name: "slice smaller then Topic_name",
-			tx: &KafkaTransaction{
-				Topic_name:      [80]byte{},
-				Topic_name_size: 60,
-			},
-			want: strings.Repeat("*", 60),
-		},
+	lookups := 0
+	lookup := func(hash uint64) (string, bool) {
+		lookups++
+		if hash != 1 {
+			return "", false
+		}
+		return "orders", true
+	}
+	statKeeper := &StatKeeper{
+		topicNames: newTopicNameCache(topicNameCacheSize, lookup),
+	}
+
+	tx := &KafkaTransaction{Topic_name_hash: 1}
+	for i := 0; i < 3; i++ {
+		name, ok := statKeeper.extractTopicName(tx)
+		assert.True(t, ok)
+		assert.Equal(t, "orders", name)
+	}
+	// The kafka_topic_names map is only read on the first miss.
+	assert.Equal(t, 1, lookups)
+
+	tx.Topic_name_hash = 2
+	_, ok := statKeeper.extractTopicName(tx)
+	assert.False(t, ok)
+}
+
+func TestStatKeeper_unknownTopicName(t *testing.T) {
+	cfg := &config.Config{MaxKafkaStatsBuffered: 1000}
+	sk := NewStatkeeper(cfg, NewTelemetry(), newTopicNameLookup(nil))
+
+	// The telemetry metrics are registered globally, so they may already have been incremented.
+	unknown := sk.telemetry.unknownTopicName.Get()
+	sk.Process(&EbpfTx{Transaction: KafkaTransaction{Topic_name_hash: 1}})
+	assert.Empty(t, sk.GetAndResetAllStats())
+	assert.Equal(t, unknown+1, sk.telemetry.unknownTopicName.Get())
+}
+
+func TestStatKeeper_extractTopicID(t *testing.T) {
+	id := uuid.MustParse("5c4d2f8a-1b3e-4f6a-9d7c-0e1f2a3b4c5d")
+	tx := &KafkaTransaction{
+		Request_api_key:     FetchAPIKey,
+		Request_api_version: minFetchAPIVersionWithTopicID,
+		Topic_name_hash:     1,
+		Topic_name_size:     uint8(len(id)),
 	}
-	for _, tt := range tests {
-		t.Run(tt.name, func(t *testing.T) {
-			statKeeper := &StatKeeper{
-				topicNames: map[string]string{},
-			}
-			copy(tt.tx.Topic_name[:], strings.Repeat("*", len(tt.tx.Topic_name)))
-			if got := statKeeper.extractTopicName(tt.tx); len(got) != len(tt.want) {
-				t.Errorf("extractTopicName() = %v, want %v", got, tt.want)
-			}
-		})
+
+	statKeeper := &StatKeeper{
+		topicNames: newTopicNameCache(topicNameCacheSize, newTopicNameLookup(map[uint64]string{1: string(id[:])})),
+		topicIDs:   newTopicIDCache(topicIDCacheSize),
 	}
+	name, _ := statKeeper.extractTopicName(tx)
+	assert.Equal(t, id.String(), name)
+
+	statKeeper.topicIDs.add(id, "orders")
+	name, _ = statKeeper.extractTopicName(tx)
+	assert.Equal(t, "orders", name)
+
+	// The same bytes are a topic name for the older fetch versions.
+	tx.Request_api_version = minFetchAPIVersionWithTopicID - 1
+	name, _ = statKeeper.extractTopicName(tx)
+	assert.Equal(t, string(id[:]), name)
 }
@@ -18,6 +18,7 @@ type Telemetry struct {
 
 	produceHits, fetchHits *apiVersionCounter
 	dropped                *libtelemetry.Counter // this happens when KafkaStatKeeper reaches capacity
+	unknownTopicName       *libtelemetry.Counter // this happens when a topic name is evicted before being read
 }
 
 // NewTelemetry creates a new Telemetry
@@ -25,20 +26,26 @@ func NewTelemetry() *Telemetry {
 	metricGroup := libtelemetry.NewMetricGroup("usm.kafka")
 
 	return &Telemetry{
-		metricGroup: metricGroup,
-		produceHits: newAPIVersionCounter(metricGroup, "total_hits", "operation:produce", libtelemetry.OptStatsd),
-		fetchHits:   newAPIVersionCounter(metricGroup, "total_hits", "operation:fetch", libtelemetry.OptStatsd),
-		dropped:     metricGroup.NewCounter("dropped", libtelemetry.OptStatsd),
+		metricGroup:      metricGroup,
+		produceHits:      newAPIVersionCounter(metricGroup, "total_hits", "operation:produce", libtelemetry.OptStatsd),
+		fetchHits:        newAPIVersionCounter(metricGroup, "total_hits", "operation:fetch", libtelemetry.OptStatsd),
+		dropped:          metricGroup.NewCounter("dropped", libtelemetry.OptStatsd),
+		unknownTopicName: metricGroup.NewCounter("unknown_topic_name", libtelemetry.OptStatsd),
 	}
 }
 
 // Count increments the total hits counter
 func (t *Telemetry) Count(tx *KafkaTransaction) {
+	t.CountRequests(tx, 1)
+}
+
+// CountRequests increments the total hits counter by the number of requests aggregated in the transaction
+func (t *Telemetry) CountRequests(tx *KafkaTransaction, requests int64) {
 	switch tx.Request_api_key {
 	case 0:
-		t.produceHits.Add(tx)
+		t.produceHits.Add(tx, requests)
 	case 1:
-		t.fetchHits.Add(tx)
+		t.fetchHits.Add(tx, requests)
 	default:
 		log.Errorf("unsupported request api key: %d", tx.Request_api_key)
 	}
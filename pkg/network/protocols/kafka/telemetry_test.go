@@ -93,3 +93,15 @@ func verifyHitsCount(t *testing.T, telemetry *Telemetry, tx *KafkaTransaction) {
 		assert.Equal(t, telemetry.fetchHits.hitsVersions[tx.Request_api_version-1].Get(), int64(1), "fetchHits count is incorrect")
 	}
 }
+
+func TestTelemetry_CountRequests(t *testing.T) {
+	telemetry.Clear()
+	tel := NewTelemetry()
+	tx := &KafkaTransaction{
+		Request_api_key:     1,
+		Request_api_version: 12,
+	}
+	tel.CountRequests(tx, 42)
+	tel.Count(tx)
+	assert.Equal(t, int64(43), tel.fetchHits.hitsVersions[tx.Request_api_version-1].Get(), "fetchHits count is incorrect")
+}
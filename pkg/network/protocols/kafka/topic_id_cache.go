@@ -0,0 +1,51 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package kafka
+
+import (
+	"github.com/google/uuid"
+	lru "github.com/hashicorp/golang-lru/v2"
+)
+
+const (
+	// minFetchAPIVersionWithTopicID is the first fetch version identifying the topics by their ID rather than their
+	// name, matching KAFKA_MIN_FETCH_API_VERSION_WITH_TOPIC_ID in the eBPF code.
+	minFetchAPIVersionWithTopicID = 13
+
+	// topicIDCacheSize is the number of topic IDs kept by the cache.
+	topicIDCacheSize = 1024
+)
+
+// topicIDCache maps the topic IDs sent by the fetch v13+ requests to the name reported for the topic. Unlike the
+// interned topic names of the StatKeeper, the cache outlives the stats flushes, as the IDs of a topic never change.
+type topicIDCache struct {
+	cache *lru.Cache[uuid.UUID, string]
+}
+
+func newTopicIDCache(size int) *topicIDCache {
+	// lru.New only fails with a non-positive size
+	cache, _ := lru.New[uuid.UUID, string](size)
+	return &topicIDCache{cache: cache}
+}
+
+// add records the name of the topic having the given ID.
+func (c *topicIDCache) add(id uuid.UUID, name string) {
+	c.cache.Add(id, name)
+}
+
+// resolve returns the name of the topic having the given ID. The topics whose name is unknown are reported by the
+// canonical form of their ID.
+func (c *topicIDCache) resolve(id uuid.UUID) string {
+	if name, ok := c.cache.Get(id); ok {
+		return name
+	}
+
+	name := id.String()
+	c.cache.Add(id, name)
+	return name
+}
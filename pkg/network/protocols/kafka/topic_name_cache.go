@@ -0,0 +1,50 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package kafka
+
+import (
+	lru "github.com/hashicorp/golang-lru/v2"
+)
+
+// topicNameCacheSize is the number of topic names kept by the cache, matching KAFKA_MAX_TOPIC_NAMES in the eBPF code.
+const topicNameCacheSize = 1024
+
+// TopicNameLookup returns the topic name whose hash is given, as stored in the kafka_topic_names eBPF map.
+type TopicNameLookup func(hash uint64) (string, bool)
+
+// topicNameCache maps the topic name hashes carried by the transactions to the topic names. The kernel only sends a
+// name once, so the cache reads the kafka_topic_names map on a miss. Like the topic IDs cache, it outlives the stats
+// flushes, and as it returns the same string for a given hash, it also interns the topic names.
+type topicNameCache struct {
+	cache  *lru.Cache[uint64, string]
+	lookup TopicNameLookup
+}
+
+func newTopicNameCache(size int, lookup TopicNameLookup) *topicNameCache {
+	// lru.New only fails with a non-positive size
+	cache, _ := lru.New[uint64, string](size)
+	return &topicNameCache{cache: cache, lookup: lookup}
+}
+
+// resolve returns the raw topic name having the given hash. It returns false if the name was evicted from the
+// kafka_topic_names map before being read.
+func (c *topicNameCache) resolve(hash uint64) (string, bool) {
+	if name, ok := c.cache.Get(hash); ok {
+		return name, true
+	}
+	if c.lookup == nil {
+		return "", false
+	}
+
+	name, ok := c.lookup(hash)
+	if !ok {
+		return "", false
+	}
+	c.cache.Add(hash, name)
+	return name, true
+}
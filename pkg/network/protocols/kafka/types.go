@@ -21,9 +21,14 @@ type ConnTuple C.conn_tuple_t
 
 type EbpfTx C.kafka_event_t
 
+type KafkaAggregationKey C.kafka_aggregation_key_t
+type KafkaAggregatedStats C.kafka_aggregated_stats_t
+
 type KafkaTransactionKey C.kafka_transaction_key_t
 type KafkaTransaction C.kafka_transaction_t
 
+type KafkaTopicName C.kafka_topic_name_t
+
 type KafkaResponseContext C.kafka_response_context_t
 
 type RawKernelTelemetry C.kafka_telemetry_t
@@ -24,6 +24,19 @@ type EbpfTx struct {
 	Transaction KafkaTransaction
 }
 
+type KafkaAggregationKey struct {
+	Tup                 ConnTuple
+	Topic_name_hash     uint64
+	Request_api_key     uint8
+	Request_api_version uint8
+	Topic_name_size     uint8
+	Pad_cgo_0           [5]byte
+}
+type KafkaAggregatedStats struct {
+	Requests_count uint64
+	Records_count  uint64
+}
+
 type KafkaTransactionKey struct {
 	Tuple     ConnTuple
 	Id        int32
@@ -31,14 +44,20 @@ type KafkaTransactionKey struct {
 }
 type KafkaTransaction struct {
 	Request_started     uint64
+	Topic_name_hash     uint64
 	Records_count       uint32
 	Request_api_key     uint8
 	Request_api_version uint8
 	Topic_name_size     uint8
-	Topic_name          [80]byte
 	Pad_cgo_0           [1]byte
 }
 
+type KafkaTopicName struct {
+	Topic_name      [80]byte
+	Topic_name_size uint8
+	Pad_cgo_0       [7]byte
+}
+
 type KafkaResponseContext struct {
 	Transaction                 KafkaTransaction
 	State                       uint8
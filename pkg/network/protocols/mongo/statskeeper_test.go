@@ -0,0 +1,83 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package mongo
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/require"
+
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+)
+
+const (
+	opQuery = 2004
+	opMsg   = 2013
+)
+
+// newEvent creates an OP_QUERY event if the command is empty, and an OP_MSG one otherwise.
+func newEvent(command string, isError bool) *EbpfEvent {
+	event := &EbpfEvent{
+		Tx: EbpfTx{
+			Request_started:    1,
+			Response_last_seen: 10,
+			Op_code:            opMsg,
+			Command_len:        uint8(len(command)),
+		},
+	}
+	copy(event.Tx.Command[:], command)
+	if command == "" {
+		event.Tx.Op_code = opQuery
+	}
+	if isError {
+		event.Tx.Is_error = 1
+	}
+	return event
+}
+
+func TestStatKeeperProcess(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxMongoStatsBuffered = 100
+	s := NewStatkeeper(cfg)
+	for i := 0; i < 20; i++ {
+		s.Process(newEvent("find", false))
+	}
+	s.Process(newEvent("find", true))
+	s.Process(newEvent("", false))
+
+	stats := s.GetAndResetAllStats()
+	require.Len(t, stats, 3)
+	for k, stat := range stats {
+		if k.Command == "OP_QUERY" {
+			require.Equal(t, 1, stat.Count)
+			continue
+		}
+		require.Equal(t, "find", k.Command)
+		if k.IsError {
+			require.Equal(t, 1, stat.Count)
+			continue
+		}
+		require.Equal(t, 20, stat.Count)
+		require.Equal(t, float64(20), stat.Latencies.GetCount())
+	}
+	require.Empty(t, s.GetAndResetAllStats())
+}
+
+func TestStatKeeperMaxEntries(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxMongoStatsBuffered = 1
+	s := NewStatkeeper(cfg)
+	s.Process(newEvent("find", false))
+	s.Process(newEvent("insert", false))
+
+	stats := s.GetAndResetAllStats()
+	require.Len(t, stats, 1)
+	for k := range stats {
+		require.Equal(t, "find", k.Command)
+	}
+}
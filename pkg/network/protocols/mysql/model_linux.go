@@ -0,0 +1,98 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package mysql
+
+import (
+	"fmt"
+
+	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	"github.com/DataDog/datadog-agent/pkg/network/types"
+)
+
+// ConnTuple returns the connection tuple for the transaction
+func (e *EbpfEvent) ConnTuple() types.ConnectionKey {
+	return types.ConnectionKey{
+		SrcIPHigh: e.Tuple.Saddr_h,
+		SrcIPLow:  e.Tuple.Saddr_l,
+		DstIPHigh: e.Tuple.Daddr_h,
+		DstIPLow:  e.Tuple.Daddr_l,
+		SrcPort:   e.Tuple.Sport,
+		DstPort:   e.Tuple.Dport,
+	}
+}
+
+// commandNames maps the commands of the MySQL client/server protocol the decoder times to their name.
+var commandNames = map[uint8]string{
+	0x02: "INIT_DB",
+	0x03: "QUERY",
+	0x04: "FIELD_LIST",
+	0x05: "CREATE_DB",
+	0x06: "DROP_DB",
+	0x07: "REFRESH",
+	0x08: "SHUTDOWN",
+	0x0b: "CONNECT",
+	0x0c: "PROCESS_KILL",
+	0x0d: "DEBUG",
+	0x0e: "PING",
+	0x11: "CHANGE_USER",
+	0x12: "BINLOG_DUMP",
+	0x13: "TABLE_DUMP",
+	0x15: "REGISTER_SLAVE",
+	0x16: "STMT_PREPARE",
+	0x17: "STMT_EXECUTE",
+	0x1a: "STMT_RESET",
+	0x1b: "SET_OPTION",
+	0x1c: "STMT_FETCH",
+	0x1e: "BINLOG_DUMP_GTID",
+	0x1f: "RESET_CONNECTION",
+}
+
+// Command returns the name of the command (QUERY, STMT_EXECUTE, PING, etc.), or its hexadecimal code if it has no
+// name.
+func (e *EbpfEvent) Command() string {
+	if name, ok := commandNames[e.Tx.Command]; ok {
+		return name
+	}
+	return fmt.Sprintf("0x%02x", e.Tx.Command)
+}
+
+// Operation returns the upper-cased first keyword of the query of QUERY and STMT_PREPARE commands (SELECT, INSERT,
+// etc.), truncated to MaxOperationLen bytes. It is empty for the other commands.
+func (e *EbpfEvent) Operation() []byte {
+	size := int(e.Tx.Operation_len)
+	if size > len(e.Tx.Operation) {
+		size = len(e.Tx.Operation)
+	}
+	return e.Tx.Operation[:size]
+}
+
+// IsError returns true if the reply of the command is an error.
+func (e *EbpfEvent) IsError() bool {
+	return e.Tx.Is_error != 0
+}
+
+// RequestLatency returns the latency of the request in nanoseconds
+func (e *EbpfEvent) RequestLatency() float64 {
+	if uint64(e.Tx.Request_started) == 0 || uint64(e.Tx.Response_last_seen) == 0 {
+		return 0
+	}
+	return protocols.NSTimestampToFloat(e.Tx.Response_last_seen - e.Tx.Request_started)
+}
+
+const template = `
+ebpfTx{
+	Command: %s,
+	Operation: %q,
+	Is Error: %t,
+	Latency: %f
+}`
+
+// String returns a string representation of the underlying event
+func (e *EbpfEvent) String() string {
+	return fmt.Sprintf(template, e.Command(), e.Operation(), e.IsError(), e.RequestLatency())
+}
@@ -0,0 +1,81 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package mysql
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/require"
+
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+)
+
+const (
+	comQuery = 0x03
+	comPing  = 0x0e
+)
+
+func newEvent(command uint8, operation string, isError bool) *EbpfEvent {
+	event := &EbpfEvent{
+		Tx: EbpfTx{
+			Request_started:    1,
+			Response_last_seen: 10,
+			Command:            command,
+			Operation_len:      uint8(len(operation)),
+		},
+	}
+	copy(event.Tx.Operation[:], operation)
+	if isError {
+		event.Tx.Is_error = 1
+	}
+	return event
+}
+
+func TestStatKeeperProcess(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxMySQLStatsBuffered = 100
+	s := NewStatkeeper(cfg)
+	for i := 0; i < 20; i++ {
+		s.Process(newEvent(comQuery, "SELECT", false))
+	}
+	s.Process(newEvent(comQuery, "SELECT", true))
+	s.Process(newEvent(comPing, "", false))
+
+	stats := s.GetAndResetAllStats()
+	require.Len(t, stats, 3)
+	for k, stat := range stats {
+		if k.Command == "PING" {
+			require.Empty(t, k.Operation)
+			require.Equal(t, 1, stat.Count)
+			continue
+		}
+		require.Equal(t, "QUERY", k.Command)
+		require.Equal(t, "SELECT", k.Operation)
+		if k.IsError {
+			require.Equal(t, 1, stat.Count)
+			continue
+		}
+		require.Equal(t, 20, stat.Count)
+		require.Equal(t, float64(20), stat.Latencies.GetCount())
+	}
+	require.Empty(t, s.GetAndResetAllStats())
+}
+
+func TestStatKeeperMaxEntries(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxMySQLStatsBuffered = 1
+	s := NewStatkeeper(cfg)
+	s.Process(newEvent(comQuery, "SELECT", false))
+	s.Process(newEvent(comQuery, "INSERT", false))
+
+	stats := s.GetAndResetAllStats()
+	require.Len(t, stats, 1)
+	for k := range stats {
+		require.Equal(t, "SELECT", k.Operation)
+	}
+}
@@ -35,8 +35,7 @@ type EventWrapper struct {
 // NewEventWrapper creates a new EventWrapper from an ebpf event.
 func NewEventWrapper(e *EbpfEvent) *EventWrapper {
 	return &EventWrapper{
-		EbpfEvent:  e,
-		normalizer: sqllexer.NewNormalizer(sqllexer.WithCollectTables(true)),
+		EbpfEvent: e,
 	}
 }
 
@@ -81,6 +80,11 @@ func (e *EventWrapper) extractTableName() string {
 	// it from the fragment if found.
 	fragment = re.ReplaceAllString(fragment, "")
 
+	// The normalizer is only created when needed, as the table names of the queries whose fingerprint was seen before
+	// are cached by the StatKeeper.
+	if e.normalizer == nil {
+		e.normalizer = sqllexer.NewNormalizer(sqllexer.WithCollectTables(true))
+	}
 	// Normalize the query without obfuscating it.
 	_, statementMetadata, err := e.normalizer.Normalize(fragment, sqllexer.WithDBMS(sqllexer.DBMSPostgres))
 	if err != nil {
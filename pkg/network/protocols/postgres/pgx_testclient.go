@@ -12,6 +12,7 @@ import (
 	"errors"
 	"time"
 
+	"github.com/jackc/pgx/v5"
 	"github.com/jackc/pgx/v5/pgxpool"
 )
 
@@ -57,3 +58,14 @@ func (c *PGXClient) RunQuery(query string, args ...any) error {
 	res.Close()
 	return err
 }
+
+// RunBatch runs the given queries on the database, pipelined in a single batch.
+func (c *PGXClient) RunBatch(queries ...string) error {
+	ctx, cancel := context.WithTimeout(context.Background(), 300*time.Second)
+	defer cancel()
+	batch := &pgx.Batch{}
+	for _, query := range queries {
+		batch.Queue(query)
+	}
+	return c.DB.SendBatch(ctx, batch).Close()
+}
@@ -28,21 +28,23 @@ import (
 
 const (
 	// InFlightMap is the name of the in-flight map.
-	InFlightMap             = "postgres_in_flight"
-	scratchBufferMap        = "postgres_scratch_buffer"
-	processTailCall         = "socket__postgres_process"
-	parseMessageTailCall    = "socket__postgres_process_parse_message"
-	tlsProcessTailCall      = "uprobe__postgres_tls_process"
-	tlsParseMessageTailCall = "uprobe__postgres_tls_process_parse_message"
-	tlsTerminationTailCall  = "uprobe__postgres_tls_termination"
-	eventStream             = "postgres"
+	InFlightMap              = "postgres_in_flight"
+	scratchBufferMap         = "postgres_scratch_buffer"
+	pipelineScratchBufferMap = "postgres_pipeline_scratch_buffer"
+	pipelineParserStateMap   = "postgres_pipeline_parser_state"
+	processTailCall          = "socket__postgres_process"
+	parseMessageTailCall     = "socket__postgres_process_parse_message"
+	tlsProcessTailCall       = "uprobe__postgres_tls_process"
+	tlsParseMessageTailCall  = "uprobe__postgres_tls_process_parse_message"
+	tlsTerminationTailCall   = "uprobe__postgres_tls_termination"
+	eventStream              = "postgres"
 )
 
 // protocol holds the state of the postgres protocol monitoring.
 type protocol struct {
 	cfg            *config.Config
 	eventsConsumer *events.Consumer[EbpfEvent]
-	mapCleaner     *ddebpf.MapCleaner[netebpf.ConnTuple, EbpfTx]
+	mapCleaner     *ddebpf.MapCleaner[netebpf.ConnTuple, EbpfPipeline]
 	statskeeper    *StatKeeper
 }
 
@@ -56,6 +58,12 @@ var Spec = &protocols.ProtocolSpec{
 		{
 			Name: scratchBufferMap,
 		},
+		{
+			Name: pipelineScratchBufferMap,
+		},
+		{
+			Name: pipelineParserStateMap,
+		},
 		{
 			Name: "postgres_batch_events",
 		},
@@ -167,9 +175,9 @@ func (p *protocol) Stop(*manager.Manager) {
 
 // DumpMaps dumps map contents for debugging.
 func (p *protocol) DumpMaps(w io.Writer, mapName string, currentMap *ebpf.Map) {
-	if mapName == InFlightMap { // maps/postgres_in_flight (BPF_MAP_TYPE_HASH), key ConnTuple, value EbpfTx
+	if mapName == InFlightMap { // maps/postgres_in_flight (BPF_MAP_TYPE_HASH), key ConnTuple, value EbpfPipeline
 		var key netebpf.ConnTuple
-		var value EbpfTx
+		var value EbpfPipeline
 		protocols.WriteMapDumpHeader(w, currentMap, mapName, key, value)
 		iter := currentMap.Iterate()
 		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
@@ -206,7 +214,7 @@ func (p *protocol) setupMapCleaner(mgr *manager.Manager) {
 		log.Errorf("error getting %s map: %s", InFlightMap, err)
 		return
 	}
-	mapCleaner, err := ddebpf.NewMapCleaner[netebpf.ConnTuple, EbpfTx](postgresInflight, 1024)
+	mapCleaner, err := ddebpf.NewMapCleaner[netebpf.ConnTuple, EbpfPipeline](postgresInflight, 1024)
 	if err != nil {
 		log.Errorf("error creating map cleaner: %s", err)
 		return
@@ -214,13 +222,9 @@ func (p *protocol) setupMapCleaner(mgr *manager.Manager) {
 
 	// Clean up idle connections. We currently use the same TTL as HTTP, but we plan to rename this variable to be more generic.
 	ttl := p.cfg.HTTPIdleConnectionTTL.Nanoseconds()
-	mapCleaner.Clean(p.cfg.HTTPMapCleanerInterval, nil, nil, func(now int64, key netebpf.ConnTuple, val EbpfTx) bool {
-		if updated := int64(val.Response_last_seen); updated > 0 {
-			return (now - updated) > ttl
-		}
-
-		started := int64(val.Request_started)
-		return started > 0 && (now-started) > ttl
+	mapCleaner.Clean(p.cfg.HTTPMapCleanerInterval, nil, nil, func(now int64, key netebpf.ConnTuple, val EbpfPipeline) bool {
+		updated := int64(val.Last_seen)
+		return updated > 0 && (now-updated) > ttl
 	})
 
 	p.mapCleaner = mapCleaner
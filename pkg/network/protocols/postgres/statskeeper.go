@@ -10,21 +10,39 @@ package postgres
 import (
 	"sync"
 
+	lru "github.com/hashicorp/golang-lru/v2"
+
 	"github.com/DataDog/datadog-agent/pkg/network/config"
 	"github.com/DataDog/datadog-agent/pkg/util/log"
 )
 
+// queryInfoCacheSize is the number of query fingerprints whose operation and table name are cached.
+const queryInfoCacheSize = 1024
+
+// queryInfo holds the operation and table name shared by the queries of a fingerprint.
+type queryInfo struct {
+	operation Operation
+	tableName string
+}
+
 // StatKeeper is a struct to hold the records for the postgres protocol
 type StatKeeper struct {
 	stats      map[Key]*RequestStat
 	statsMutex sync.RWMutex
 	maxEntries int
+
+	// queryInfos caches the operation and table name of the query fingerprints computed by the kernel, sparing the
+	// normalization of the queries seen before. Unlike the stats, it outlives the flushes.
+	queryInfos *lru.Cache[uint64, queryInfo]
 }
 
 // NewStatkeeper creates a new StatKeeper
 func NewStatkeeper(c *config.Config) *StatKeeper {
+	// lru.New only fails with a non-positive size
+	queryInfos, _ := lru.New[uint64, queryInfo](queryInfoCacheSize)
 	newStatKeeper := &StatKeeper{
 		maxEntries: c.MaxPostgresStatsBuffered,
+		queryInfos: queryInfos,
 	}
 	newStatKeeper.resetNoLock()
 	return newStatKeeper
@@ -35,9 +53,10 @@ func (s *StatKeeper) Process(tx *EventWrapper) {
 	s.statsMutex.Lock()
 	defer s.statsMutex.Unlock()
 
+	info := s.getQueryInfo(tx)
 	key := Key{
-		Operation:     tx.Operation(),
-		TableName:     tx.TableName(),
+		Operation:     info.operation,
+		TableName:     info.tableName,
 		ConnectionKey: tx.ConnTuple(),
 	}
 	requestStats, ok := s.stats[key]
@@ -66,6 +85,21 @@ func (s *StatKeeper) Process(tx *EventWrapper) {
 	}
 }
 
+// getQueryInfo returns the operation and table name of the query, looking them up by the query fingerprint first.
+func (s *StatKeeper) getQueryInfo(tx *EventWrapper) queryInfo {
+	fingerprint := tx.Tx.Fingerprint
+	if fingerprint == 0 {
+		return queryInfo{operation: tx.Operation(), tableName: tx.TableName()}
+	}
+	if info, ok := s.queryInfos.Get(fingerprint); ok {
+		return info
+	}
+
+	info := queryInfo{operation: tx.Operation(), tableName: tx.TableName()}
+	s.queryInfos.Add(fingerprint, info)
+	return info
+}
+
 // GetAndResetAllStats returns all the records and resets the statskeeper
 func (s *StatKeeper) GetAndResetAllStats() map[Key]*RequestStat {
 	s.statsMutex.RLock()
@@ -42,3 +42,45 @@ func TestStatKeeperProcess(t *testing.T) {
 		require.Equal(t, float64(20), stat.Latencies.GetCount())
 	}
 }
+
+func TestStatKeeperQueryInfoCache(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxPostgresStatsBuffered = 100
+	s := NewStatkeeper(cfg)
+
+	newEvent := func(query string, fingerprint uint64) *EventWrapper {
+		return NewEventWrapper(&EbpfEvent{
+			Tx: EbpfTx{
+				Request_fragment:    requestFragment([]byte(query)),
+				Request_started:     1,
+				Response_last_seen:  10,
+				Fingerprint:         fingerprint,
+				Original_query_size: uint32(len(query)),
+			},
+		})
+	}
+
+	s.Process(newEvent("SELECT * FROM dummy WHERE id = 1", 1))
+	// The operation and table name of a known fingerprint are not extracted again.
+	cached := newEvent("SELECT * FROM dummy WHERE id = 2", 1)
+	s.Process(cached)
+	require.False(t, cached.operationSet)
+	require.False(t, cached.tableNameSet)
+	// The queries without fingerprint are always parsed.
+	s.Process(newEvent("DELETE FROM other", 0))
+
+	stats := s.GetAndResetAllStats()
+	require.Len(t, stats, 2)
+	for k, stat := range stats {
+		switch k.Operation {
+		case SelectOP:
+			require.Equal(t, "dummy", k.TableName)
+			require.Equal(t, 2, stat.Count)
+		case DeleteTableOP:
+			require.Equal(t, "other", k.TableName)
+			require.Equal(t, 1, stat.Count)
+		default:
+			t.Fatalf("unexpected operation %s", k.Operation)
+		}
+	}
+}
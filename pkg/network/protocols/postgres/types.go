@@ -17,6 +17,7 @@ type ConnTuple = C.conn_tuple_t
 
 type EbpfEvent C.postgres_event_t
 type EbpfTx C.postgres_transaction_t
+type EbpfPipeline C.postgres_pipeline_t
 
 const (
 	BufferSize = C.POSTGRES_BUFFER_SIZE
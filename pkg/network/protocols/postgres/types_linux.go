@@ -23,9 +23,18 @@ type EbpfTx struct {
 	Request_fragment    [64]byte
 	Request_started     uint64
 	Response_last_seen  uint64
+	Fingerprint         uint64
 	Original_query_size uint32
 	Pad_cgo_0           [4]byte
 }
+type EbpfPipeline struct {
+	Queries   [4]EbpfTx
+	Last_seen uint64
+	Head      uint32
+	Tail      uint32
+	Parsed    uint32
+	Overflow  uint32
+}
 
 const (
 	BufferSize = 0x40
@@ -65,6 +65,14 @@ type Protocol interface {
 	IsBuildModeSupported(buildmode.Type) bool
 }
 
+// ExtraStatsProvider is implemented by the protocols that also report the stats of
+// other protocol types, such as HTTP2 for the gRPC calls it carries.
+type ExtraStatsProvider interface {
+	// GetExtraStats returns the latest stats of the other protocol types. It is
+	// called right after GetStats.
+	GetExtraStats() []*ProtocolStats
+}
+
 // ProtocolStats is a "tuple" struct that represents monitoring data from a
 // Protocol implementation. It associates a ProtocolType and stats from this
 // protocols' monitoring.
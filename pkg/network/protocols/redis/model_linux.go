@@ -0,0 +1,61 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package redis
+
+import (
+	"fmt"
+
+	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	"github.com/DataDog/datadog-agent/pkg/network/types"
+)
+
+// ConnTuple returns the connection tuple for the transaction
+func (e *EbpfEvent) ConnTuple() types.ConnectionKey {
+	return types.ConnectionKey{
+		SrcIPHigh: e.Tuple.Saddr_h,
+		SrcIPLow:  e.Tuple.Saddr_l,
+		DstIPHigh: e.Tuple.Daddr_h,
+		DstIPLow:  e.Tuple.Daddr_l,
+		SrcPort:   e.Tuple.Sport,
+		DstPort:   e.Tuple.Dport,
+	}
+}
+
+// Command returns the upper-cased name of the command (GET, SET, HGETALL, etc.), truncated to MaxCommandLen bytes.
+func (e *EbpfEvent) Command() []byte {
+	size := int(e.Tx.Command_len)
+	if size > len(e.Tx.Command) {
+		size = len(e.Tx.Command)
+	}
+	return e.Tx.Command[:size]
+}
+
+// IsError returns true if the reply of the command is an error.
+func (e *EbpfEvent) IsError() bool {
+	return e.Tx.Is_error != 0
+}
+
+// RequestLatency returns the latency of the request in nanoseconds
+func (e *EbpfEvent) RequestLatency() float64 {
+	if uint64(e.Tx.Request_started) == 0 || uint64(e.Tx.Response_last_seen) == 0 {
+		return 0
+	}
+	return protocols.NSTimestampToFloat(e.Tx.Response_last_seen - e.Tx.Request_started)
+}
+
+const template = `
+ebpfTx{
+	Command: %q,
+	Is Error: %t,
+	Latency: %f
+}`
+
+// String returns a string representation of the underlying event
+func (e *EbpfEvent) String() string {
+	return fmt.Sprintf(template, e.Command(), e.IsError(), e.RequestLatency())
+}
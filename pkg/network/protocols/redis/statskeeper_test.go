@@ -0,0 +1,68 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package redis
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/require"
+
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+)
+
+func newEvent(command string, isError bool) *EbpfEvent {
+	event := &EbpfEvent{
+		Tx: EbpfTx{
+			Request_started:    1,
+			Response_last_seen: 10,
+			Command_len:        uint8(len(command)),
+		},
+	}
+	copy(event.Tx.Command[:], command)
+	if isError {
+		event.Tx.Is_error = 1
+	}
+	return event
+}
+
+func TestStatKeeperProcess(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxRedisStatsBuffered = 100
+	s := NewStatkeeper(cfg)
+	for i := 0; i < 20; i++ {
+		s.Process(newEvent("GET", false))
+	}
+	s.Process(newEvent("GET", true))
+
+	stats := s.GetAndResetAllStats()
+	require.Len(t, stats, 2)
+	for k, stat := range stats {
+		require.Equal(t, "GET", k.Command)
+		if k.IsError {
+			require.Equal(t, 1, stat.Count)
+			continue
+		}
+		require.Equal(t, 20, stat.Count)
+		require.Equal(t, float64(20), stat.Latencies.GetCount())
+	}
+	require.Empty(t, s.GetAndResetAllStats())
+}
+
+func TestStatKeeperMaxEntries(t *testing.T) {
+	cfg := config.New()
+	cfg.MaxRedisStatsBuffered = 1
+	s := NewStatkeeper(cfg)
+	s.Process(newEvent("GET", false))
+	s.Process(newEvent("SET", false))
+
+	stats := s.GetAndResetAllStats()
+	require.Len(t, stats, 1)
+	for k := range stats {
+		require.Equal(t, "GET", k.Command)
+	}
+}
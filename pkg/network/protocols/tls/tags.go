@@ -0,0 +1,112 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+// Package tls holds the TLS handshake details the classifier parses from the ClientHello and ServerHello of a
+// connection
+package tls
+
+import "fmt"
+
+// Bits of Tags.OfferedVersions, see tags-types.h
+const (
+	Version10Bit uint8 = 1 << iota
+	Version11Bit
+	Version12Bit
+	Version13Bit
+)
+
+// Bits of Tags.ALPNRequested and Tags.ALPNChosen, see tags-types.h
+const (
+	ALPNHTTP2 uint8 = 1 << iota
+	ALPNHTTP11
+)
+
+// TLS versions as found on the wire
+const (
+	version10 uint16 = 0x0301
+	version11 uint16 = 0x0302
+	version12 uint16 = 0x0303
+	version13 uint16 = 0x0304
+)
+
+var versionTags = map[uint16]string{
+	version10: "tls_1.0",
+	version11: "tls_1.1",
+	version12: "tls_1.2",
+	version13: "tls_1.3",
+}
+
+var versionBits = map[uint8]string{
+	Version10Bit: "tls_1.0",
+	Version11Bit: "tls_1.1",
+	Version12Bit: "tls_1.2",
+	Version13Bit: "tls_1.3",
+}
+
+var alpnBits = map[uint8]string{
+	ALPNHTTP2:  "h2",
+	ALPNHTTP11: "http/1.1",
+}
+
+// Tags holds the TLS handshake details of a connection
+type Tags struct {
+	// ChosenVersion is the version chosen by the server, 0 if its ServerHello wasn't seen
+	ChosenVersion uint16
+	// CipherSuite is the cipher suite chosen by the server, 0 if its ServerHello wasn't seen
+	CipherSuite uint16
+	// OfferedVersions is a bit mask of the versions offered by the client
+	OfferedVersions uint8
+	// ALPNRequested is a bit mask of the known ALPN protocols offered by the client
+	ALPNRequested uint8
+	// ALPNChosen is a bit mask of the known ALPN protocols chosen by the server
+	ALPNChosen uint8
+}
+
+// IsEmpty returns true if no handshake detail was recorded
+func (t Tags) IsEmpty() bool {
+	return t == Tags{}
+}
+
+// MergeWith merges the other tags into the current ones
+func (t *Tags) MergeWith(other Tags) {
+	if t.ChosenVersion == 0 {
+		t.ChosenVersion = other.ChosenVersion
+	}
+	if t.CipherSuite == 0 {
+		t.CipherSuite = other.CipherSuite
+	}
+	t.OfferedVersions |= other.OfferedVersions
+	t.ALPNRequested |= other.ALPNRequested
+	t.ALPNChosen |= other.ALPNChosen
+}
+
+// GetDynamicTags returns the connection tags describing the handshake
+func (t Tags) GetDynamicTags() map[string]struct{} {
+	if t.IsEmpty() {
+		return nil
+	}
+
+	tags := make(map[string]struct{})
+	if version, ok := versionTags[t.ChosenVersion]; ok {
+		tags["tls.version:"+version] = struct{}{}
+	}
+	if t.CipherSuite != 0 {
+		tags[fmt.Sprintf("tls.cipher_suite_id:0x%04X", t.CipherSuite)] = struct{}{}
+	}
+	for bit, version := range versionBits {
+		if t.OfferedVersions&bit != 0 {
+			tags["tls.client_version:"+version] = struct{}{}
+		}
+	}
+	for bit, protocol := range alpnBits {
+		if t.ALPNRequested&bit != 0 {
+			tags["tls.alpn_requested:"+protocol] = struct{}{}
+		}
+		if t.ALPNChosen&bit != 0 {
+			tags["tls.alpn:"+protocol] = struct{}{}
+		}
+	}
+	return tags
+}
@@ -0,0 +1,50 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+package tls
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+)
+
+func TestGetDynamicTags(t *testing.T) {
+	assert.Nil(t, Tags{}.GetDynamicTags())
+
+	tags := Tags{
+		ChosenVersion:   0x0304,
+		CipherSuite:     0x1301,
+		OfferedVersions: Version12Bit | Version13Bit,
+		ALPNRequested:   ALPNHTTP2 | ALPNHTTP11,
+		ALPNChosen:      ALPNHTTP2,
+	}
+	assert.Equal(t, map[string]struct{}{
+		"tls.version:tls_1.3":         {},
+		"tls.cipher_suite_id:0x1301":  {},
+		"tls.client_version:tls_1.2":  {},
+		"tls.client_version:tls_1.3":  {},
+		"tls.alpn_requested:h2":       {},
+		"tls.alpn_requested:http/1.1": {},
+		"tls.alpn:h2":                 {},
+	}, tags.GetDynamicTags())
+}
+
+func TestMergeWith(t *testing.T) {
+	client := Tags{OfferedVersions: Version12Bit, ALPNRequested: ALPNHTTP11}
+	client.MergeWith(Tags{ChosenVersion: 0x0303, CipherSuite: 0xc02f, ALPNChosen: ALPNHTTP11})
+	assert.Equal(t, Tags{
+		ChosenVersion:   0x0303,
+		CipherSuite:     0xc02f,
+		OfferedVersions: Version12Bit,
+		ALPNRequested:   ALPNHTTP11,
+		ALPNChosen:      ALPNHTTP11,
+	}, client)
+
+	// the first chosen version and cipher suite win
+	client.MergeWith(Tags{ChosenVersion: 0x0304, CipherSuite: 0x1301})
+	assert.Equal(t, uint16(0x0303), client.ChosenVersion)
+	assert.Equal(t, uint16(0xc02f), client.CipherSuite)
+}
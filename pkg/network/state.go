@@ -17,9 +17,14 @@ import (
 
 	"github.com/DataDog/datadog-agent/pkg/network/dns"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/amqp"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/http"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/http2"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/kafka"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/mongo"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/mysql"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/postgres"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/redis"
 	"github.com/DataDog/datadog-agent/pkg/network/slice"
 	"github.com/DataDog/datadog-agent/pkg/process/util"
 	"github.com/DataDog/datadog-agent/pkg/telemetry"
@@ -42,6 +47,11 @@ var stateTelemetry = struct {
 	http2StatsDropped      *telemetry.StatCounterWrapper
 	kafkaStatsDropped      *telemetry.StatCounterWrapper
 	postgresStatsDropped   *telemetry.StatCounterWrapper
+	redisStatsDropped      *telemetry.StatCounterWrapper
+	amqpStatsDropped       *telemetry.StatCounterWrapper
+	mysqlStatsDropped      *telemetry.StatCounterWrapper
+	mongoStatsDropped      *telemetry.StatCounterWrapper
+	grpcStatsDropped       *telemetry.StatCounterWrapper
 	dnsPidCollisions       *telemetry.StatCounterWrapper
 	incomingDirectionFixes telemetry.Counter
 	outgoingDirectionFixes telemetry.Counter
@@ -56,6 +66,11 @@ var stateTelemetry = struct {
 	telemetry.NewStatCounterWrapper(stateModuleName, "http2_stats_dropped", []string{}, "Counter measuring the number of http2 stats dropped"),
 	telemetry.NewStatCounterWrapper(stateModuleName, "kafka_stats_dropped", []string{}, "Counter measuring the number of kafka stats dropped"),
 	telemetry.NewStatCounterWrapper(stateModuleName, "postgres_stats_dropped", []string{}, "Counter measuring the number of postgres stats dropped"),
+	telemetry.NewStatCounterWrapper(stateModuleName, "redis_stats_dropped", []string{}, "Counter measuring the number of redis stats dropped"),
+	telemetry.NewStatCounterWrapper(stateModuleName, "amqp_stats_dropped", []string{}, "Counter measuring the number of amqp stats dropped"),
+	telemetry.NewStatCounterWrapper(stateModuleName, "mysql_stats_dropped", []string{}, "Counter measuring the number of mysql stats dropped"),
+	telemetry.NewStatCounterWrapper(stateModuleName, "mongo_stats_dropped", []string{}, "Counter measuring the number of mongo stats dropped"),
+	telemetry.NewStatCounterWrapper(stateModuleName, "grpc_stats_dropped", []string{}, "Counter measuring the number of grpc stats dropped"),
 	telemetry.NewStatCounterWrapper(stateModuleName, "dns_pid_collisions", []string{}, "Counter measuring the number of DNS PID collisions"),
 	telemetry.NewCounter(stateModuleName, "incoming_direction_fixes", []string{}, "Counter measuring the number of udp direction fixes for incoming connections"),
 	telemetry.NewCounter(stateModuleName, "outgoing_direction_fixes", []string{}, "Counter measuring the number of udp/tcp direction fixes for outgoing connections"),
@@ -127,6 +142,11 @@ type Delta struct {
 	HTTP2    map[http.Key]*http.RequestStats
 	Kafka    map[kafka.Key]*kafka.RequestStat
 	Postgres map[postgres.Key]*postgres.RequestStat
+	Redis    map[redis.Key]*redis.RequestStat
+	AMQP     map[amqp.Key]*amqp.RequestStat
+	MySQL    map[mysql.Key]*mysql.RequestStat
+	Mongo    map[mongo.Key]*mongo.RequestStat
+	GRPC     map[http2.GRPCKey]*http2.GRPCStat
 }
 
 type lastStateTelemetry struct {
@@ -140,6 +160,11 @@ type lastStateTelemetry struct {
 	http2StatsDropped     int64
 	kafkaStatsDropped     int64
 	postgresStatsDropped  int64
+	redisStatsDropped     int64
+	amqpStatsDropped      int64
+	mysqlStatsDropped     int64
+	mongoStatsDropped     int64
+	grpcStatsDropped      int64
 	dnsPidCollisions      int64
 }
 
@@ -241,6 +266,11 @@ type client struct {
 	http2StatsDelta    map[http.Key]*http.RequestStats
 	kafkaStatsDelta    map[kafka.Key]*kafka.RequestStat
 	postgresStatsDelta map[postgres.Key]*postgres.RequestStat
+	redisStatsDelta    map[redis.Key]*redis.RequestStat
+	amqpStatsDelta     map[amqp.Key]*amqp.RequestStat
+	mysqlStatsDelta    map[mysql.Key]*mysql.RequestStat
+	mongoStatsDelta    map[mongo.Key]*mongo.RequestStat
+	grpcStatsDelta     map[http2.GRPCKey]*http2.GRPCStat
 	lastTelemetries    map[ConnTelemetryType]int64
 }
 
@@ -257,6 +287,11 @@ func (c *client) Reset() {
 	c.http2StatsDelta = make(map[http.Key]*http.RequestStats)
 	c.kafkaStatsDelta = make(map[kafka.Key]*kafka.RequestStat)
 	c.postgresStatsDelta = make(map[postgres.Key]*postgres.RequestStat)
+	c.redisStatsDelta = make(map[redis.Key]*redis.RequestStat)
+	c.amqpStatsDelta = make(map[amqp.Key]*amqp.RequestStat)
+	c.mysqlStatsDelta = make(map[mysql.Key]*mysql.RequestStat)
+	c.mongoStatsDelta = make(map[mongo.Key]*mongo.RequestStat)
+	c.grpcStatsDelta = make(map[http2.GRPCKey]*http2.GRPCStat)
 }
 
 type networkState struct {
@@ -276,6 +311,10 @@ type networkState struct {
 	maxHTTPStats                int
 	maxKafkaStats               int
 	maxPostgresStats            int
+	maxRedisStats               int
+	maxAMQPStats                int
+	maxMySQLStats               int
+	maxMongoStats               int
 	enableConnectionRollup      bool
 	processEventConsumerEnabled bool
 
@@ -285,7 +324,7 @@ type networkState struct {
 }
 
 // NewState creates a new network state
-func NewState(clientExpiry time.Duration, maxClosedConns uint32, maxClientStats, maxDNSStats, maxHTTPStats, maxKafkaStats, maxPostgresStats int, enableConnectionRollup bool, processEventConsumerEnabled bool) State {
+func NewState(clientExpiry time.Duration, maxClosedConns uint32, maxClientStats, maxDNSStats, maxHTTPStats, maxKafkaStats, maxPostgresStats, maxRedisStats, maxAMQPStats, maxMySQLStats, maxMongoStats int, enableConnectionRollup bool, processEventConsumerEnabled bool) State {
 	ns := &networkState{
 		clients:                map[string]*client{},
 		clientExpiry:           clientExpiry,
@@ -295,6 +334,10 @@ func NewState(clientExpiry time.Duration, maxClosedConns uint32, maxClientStats,
 		maxHTTPStats:           maxHTTPStats,
 		maxKafkaStats:          maxKafkaStats,
 		maxPostgresStats:       maxPostgresStats,
+		maxRedisStats:          maxRedisStats,
+		maxAMQPStats:           maxAMQPStats,
+		maxMySQLStats:          maxMySQLStats,
+		maxMongoStats:          maxMongoStats,
 		enableConnectionRollup: enableConnectionRollup,
 		mergeStatsBuffers: [2][]byte{
 			make([]byte, ConnectionByteKeyMaxLen),
@@ -414,6 +457,21 @@ func (ns *networkState) GetDelta(
 		case protocols.Postgres:
 			stats := protocolStats.(map[postgres.Key]*postgres.RequestStat)
 			ns.storePostgresStats(stats)
+		case protocols.Redis:
+			stats := protocolStats.(map[redis.Key]*redis.RequestStat)
+			ns.storeRedisStats(stats)
+		case protocols.AMQP:
+			stats := protocolStats.(map[amqp.Key]*amqp.RequestStat)
+			ns.storeAMQPStats(stats)
+		case protocols.MySQL:
+			stats := protocolStats.(map[mysql.Key]*mysql.RequestStat)
+			ns.storeMySQLStats(stats)
+		case protocols.Mongo:
+			stats := protocolStats.(map[mongo.Key]*mongo.RequestStat)
+			ns.storeMongoStats(stats)
+		case protocols.GRPC:
+			stats := protocolStats.(map[http2.GRPCKey]*http2.GRPCStat)
+			ns.storeGRPCStats(stats)
 		}
 	}
 
@@ -423,6 +481,11 @@ func (ns *networkState) GetDelta(
 		HTTP2:    client.http2StatsDelta,
 		Kafka:    client.kafkaStatsDelta,
 		Postgres: client.postgresStatsDelta,
+		Redis:    client.redisStatsDelta,
+		AMQP:     client.amqpStatsDelta,
+		MySQL:    client.mysqlStatsDelta,
+		Mongo:    client.mongoStatsDelta,
+		GRPC:     client.grpcStatsDelta,
 	}
 }
 
@@ -476,11 +539,18 @@ func (ns *networkState) logTelemetry() {
 	http2StatsDroppedDelta := stateTelemetry.http2StatsDropped.Load() - ns.lastTelemetry.http2StatsDropped
 	kafkaStatsDroppedDelta := stateTelemetry.kafkaStatsDropped.Load() - ns.lastTelemetry.kafkaStatsDropped
 	postgresStatsDroppedDelta := stateTelemetry.postgresStatsDropped.Load() - ns.lastTelemetry.postgresStatsDropped
+	redisStatsDroppedDelta := stateTelemetry.redisStatsDropped.Load() - ns.lastTelemetry.redisStatsDropped
+	amqpStatsDroppedDelta := stateTelemetry.amqpStatsDropped.Load() - ns.lastTelemetry.amqpStatsDropped
+	mysqlStatsDroppedDelta := stateTelemetry.mysqlStatsDropped.Load() - ns.lastTelemetry.mysqlStatsDropped
+	mongoStatsDroppedDelta := stateTelemetry.mongoStatsDropped.Load() - ns.lastTelemetry.mongoStatsDropped
+	grpcStatsDroppedDelta := stateTelemetry.grpcStatsDropped.Load() - ns.lastTelemetry.grpcStatsDropped
 	dnsPidCollisionsDelta := stateTelemetry.dnsPidCollisions.Load() - ns.lastTelemetry.dnsPidCollisions
 
 	// Flush log line if any metric is non-zero
 	if connDroppedDelta > 0 || closedConnDroppedDelta > 0 || dnsStatsDroppedDelta > 0 || httpStatsDroppedDelta > 0 ||
-		http2StatsDroppedDelta > 0 || kafkaStatsDroppedDelta > 0 || postgresStatsDroppedDelta > 0 {
+		http2StatsDroppedDelta > 0 || kafkaStatsDroppedDelta > 0 || postgresStatsDroppedDelta > 0 ||
+		redisStatsDroppedDelta > 0 || amqpStatsDroppedDelta > 0 || mysqlStatsDroppedDelta > 0 ||
+		mongoStatsDroppedDelta > 0 || grpcStatsDroppedDelta > 0 {
 		s := "State telemetry: "
 		s += " [%d connections dropped due to stats]"
 		s += " [%d closed connections dropped]"
@@ -489,6 +559,11 @@ func (ns *networkState) logTelemetry() {
 		s += " [%d HTTP2 stats dropped]"
 		s += " [%d Kafka stats dropped]"
 		s += " [%d postgres stats dropped]"
+		s += " [%d redis stats dropped]"
+		s += " [%d amqp stats dropped]"
+		s += " [%d mysql stats dropped]"
+		s += " [%d mongo stats dropped]"
+		s += " [%d grpc stats dropped]"
 		log.Warnf(s,
 			connDroppedDelta,
 			closedConnDroppedDelta,
@@ -497,6 +572,11 @@ func (ns *networkState) logTelemetry() {
 			http2StatsDroppedDelta,
 			kafkaStatsDroppedDelta,
 			postgresStatsDroppedDelta,
+			redisStatsDroppedDelta,
+			amqpStatsDroppedDelta,
+			mysqlStatsDroppedDelta,
+			mongoStatsDroppedDelta,
+			grpcStatsDroppedDelta,
 		)
 	}
 
@@ -526,6 +606,11 @@ func (ns *networkState) logTelemetry() {
 	ns.lastTelemetry.http2StatsDropped = stateTelemetry.http2StatsDropped.Load()
 	ns.lastTelemetry.kafkaStatsDropped = stateTelemetry.kafkaStatsDropped.Load()
 	ns.lastTelemetry.postgresStatsDropped = stateTelemetry.postgresStatsDropped.Load()
+	ns.lastTelemetry.redisStatsDropped = stateTelemetry.redisStatsDropped.Load()
+	ns.lastTelemetry.amqpStatsDropped = stateTelemetry.amqpStatsDropped.Load()
+	ns.lastTelemetry.mysqlStatsDropped = stateTelemetry.mysqlStatsDropped.Load()
+	ns.lastTelemetry.mongoStatsDropped = stateTelemetry.mongoStatsDropped.Load()
+	ns.lastTelemetry.grpcStatsDropped = stateTelemetry.grpcStatsDropped.Load()
 	ns.lastTelemetry.dnsPidCollisions = stateTelemetry.dnsPidCollisions.Load()
 }
 
@@ -798,6 +883,162 @@ func (ns *networkState) storePostgresStats(allStats map[postgres.Key]*postgres.R
 	}
 }
 
+// storeRedisStats stores the latest Redis stats for all clients
+func (ns *networkState) storeRedisStats(allStats map[redis.Key]*redis.RequestStat) {
+	if len(ns.clients) == 1 {
+		for _, client := range ns.clients {
+			if len(client.redisStatsDelta) == 0 && len(allStats) <= ns.maxRedisStats {
+				// optimization for the common case:
+				// if there is only one client and no previous state, no memory allocation is needed
+				client.redisStatsDelta = allStats
+				return
+			}
+		}
+	}
+
+	for key, stats := range allStats {
+		for _, client := range ns.clients {
+			prevStats, ok := client.redisStatsDelta[key]
+			if !ok && len(client.redisStatsDelta) >= ns.maxRedisStats {
+				stateTelemetry.redisStatsDropped.Inc()
+				continue
+			}
+
+			if prevStats != nil {
+				prevStats.CombineWith(stats)
+				client.redisStatsDelta[key] = prevStats
+			} else {
+				client.redisStatsDelta[key] = stats
+			}
+		}
+	}
+}
+
+// storeAMQPStats stores the latest AMQP stats for all clients
+func (ns *networkState) storeAMQPStats(allStats map[amqp.Key]*amqp.RequestStat) {
+	if len(ns.clients) == 1 {
+		for _, client := range ns.clients {
+			if len(client.amqpStatsDelta) == 0 && len(allStats) <= ns.maxAMQPStats {
+				// optimization for the common case:
+				// if there is only one client and no previous state, no memory allocation is needed
+				client.amqpStatsDelta = allStats
+				return
+			}
+		}
+	}
+
+	for key, stats := range allStats {
+		for _, client := range ns.clients {
+			prevStats, ok := client.amqpStatsDelta[key]
+			if !ok && len(client.amqpStatsDelta) >= ns.maxAMQPStats {
+				stateTelemetry.amqpStatsDropped.Inc()
+				continue
+			}
+
+			if prevStats != nil {
+				prevStats.CombineWith(stats)
+				client.amqpStatsDelta[key] = prevStats
+			} else {
+				client.amqpStatsDelta[key] = stats
+			}
+		}
+	}
+}
+
+// storeMySQLStats stores the latest MySQL stats for all clients
+func (ns *networkState) storeMySQLStats(allStats map[mysql.Key]*mysql.RequestStat) {
+	if len(ns.clients) == 1 {
+		for _, client := range ns.clients {
+			if len(client.mysqlStatsDelta) == 0 && len(allStats) <= ns.maxMySQLStats {
+				// optimization for the common case:
+				// if there is only one client and no previous state, no memory allocation is needed
+				client.mysqlStatsDelta = allStats
+				return
+			}
+		}
+	}
+
+	for key, stats := range allStats {
+		for _, client := range ns.clients {
+			prevStats, ok := client.mysqlStatsDelta[key]
+			if !ok && len(client.mysqlStatsDelta) >= ns.maxMySQLStats {
+				stateTelemetry.mysqlStatsDropped.Inc()
+				continue
+			}
+
+			if prevStats != nil {
+				prevStats.CombineWith(stats)
+				client.mysqlStatsDelta[key] = prevStats
+			} else {
+				client.mysqlStatsDelta[key] = stats
+			}
+		}
+	}
+}
+
+// storeMongoStats stores the latest Mongo stats for all clients
+func (ns *networkState) storeMongoStats(allStats map[mongo.Key]*mongo.RequestStat) {
+	if len(ns.clients) == 1 {
+		for _, client := range ns.clients {
+			if len(client.mongoStatsDelta) == 0 && len(allStats) <= ns.maxMongoStats {
+				// optimization for the common case:
+				// if there is only one client and no previous state, no memory allocation is needed
+				client.mongoStatsDelta = allStats
+				return
+			}
+		}
+	}
+
+	for key, stats := range allStats {
+		for _, client := range ns.clients {
+			prevStats, ok := client.mongoStatsDelta[key]
+			if !ok && len(client.mongoStatsDelta) >= ns.maxMongoStats {
+				stateTelemetry.mongoStatsDropped.Inc()
+				continue
+			}
+
+			if prevStats != nil {
+				prevStats.CombineWith(stats)
+				client.mongoStatsDelta[key] = prevStats
+			} else {
+				client.mongoStatsDelta[key] = stats
+			}
+		}
+	}
+}
+
+// storeGRPCStats stores the latest gRPC stats for all clients
+func (ns *networkState) storeGRPCStats(allStats map[http2.GRPCKey]*http2.GRPCStat) {
+	if len(ns.clients) == 1 {
+		for _, client := range ns.clients {
+			if len(client.grpcStatsDelta) == 0 && len(allStats) <= ns.maxHTTPStats {
+				// optimization for the common case:
+				// if there is only one client and no previous state, no memory allocation is needed
+				client.grpcStatsDelta = allStats
+				return
+			}
+		}
+	}
+
+	for key, stats := range allStats {
+		for _, client := range ns.clients {
+			prevStats, ok := client.grpcStatsDelta[key]
+			// Like HTTP2, gRPC is bounded by maxHTTPStats.
+			if !ok && len(client.grpcStatsDelta) >= ns.maxHTTPStats {
+				stateTelemetry.grpcStatsDropped.Inc()
+				continue
+			}
+
+			if prevStats != nil {
+				prevStats.CombineWith(stats)
+				client.grpcStatsDelta[key] = prevStats
+			} else {
+				client.grpcStatsDelta[key] = stats
+			}
+		}
+	}
+}
+
 func (ns *networkState) getClient(clientID string) *client {
 	if c, ok := ns.clients[clientID]; ok {
 		return c
@@ -812,6 +1053,11 @@ func (ns *networkState) getClient(clientID string) *client {
 		http2StatsDelta:    map[http.Key]*http.RequestStats{},
 		kafkaStatsDelta:    map[kafka.Key]*kafka.RequestStat{},
 		postgresStatsDelta: map[postgres.Key]*postgres.RequestStat{},
+		redisStatsDelta:    map[redis.Key]*redis.RequestStat{},
+		amqpStatsDelta:     map[amqp.Key]*amqp.RequestStat{},
+		mysqlStatsDelta:    map[mysql.Key]*mysql.RequestStat{},
+		mongoStatsDelta:    map[mongo.Key]*mongo.RequestStat{},
+		grpcStatsDelta:     map[http2.GRPCKey]*http2.GRPCStat{},
 		lastTelemetries:    make(map[ConnTelemetryType]int64),
 	}
 	ns.clients[clientID] = c
@@ -852,9 +1098,8 @@ func (ns *networkState) mergeConnections(id string, active []ConnectionStats) (_
 
 		ns.updateConnWithStats(client, cookie, closedConn)
 
-		//nolint:gosimple // TODO(NET) Fix gosimple linter
-		if closedConn.Last.IsZero() {
-			// not reporting an "empty" connection
+		if closedConn.Last.IsZero() && len(closedConn.TCPFailures) == 0 {
+			// not reporting an "empty" connection, unless its connect failed
 			return false
 		}
 
@@ -1182,9 +1427,11 @@ type aggregationKey struct {
 }
 
 type connectionAggregator struct {
-	conns                       map[aggregationKey][]*aggregateConnection
-	buf                         []byte
-	dnsStats                    dns.StatsByKeyByNameByType
+	conns    map[aggregationKey][]*aggregateConnection
+	buf      []byte
+	dnsStats dns.StatsByKeyByNameByType
+	// dnsStats keys indexed by their key without client port, built on demand, see aggregatedDNS
+	dnsKeysByServer             map[dns.Key][]dns.Key
 	enablePortRollups           bool
 	processEventConsumerEnabled bool
 }
@@ -1296,9 +1543,42 @@ func (a *connectionAggregator) dns(c *ConnectionStats) map[dns.Hostname]map[dns.
 		return stats
 	}
 
+	if c.Type == UDP && key.ClientPort == 0 {
+		return a.aggregatedDNS(key)
+	}
+
 	return nil
 }
 
+// aggregatedDNS returns the DNS stats of all the client ports of a UDP connection aggregated by the
+// tracer, see network_config.enable_udp_flow_aggregation
+func (a *connectionAggregator) aggregatedDNS(key dns.Key) map[dns.Hostname]map[dns.QueryType]dns.Stats {
+	if a.dnsKeysByServer == nil {
+		a.dnsKeysByServer = make(map[dns.Key][]dns.Key)
+		for k := range a.dnsStats {
+			serverKey := k
+			serverKey.ClientPort = 0
+			a.dnsKeysByServer[serverKey] = append(a.dnsKeysByServer[serverKey], k)
+		}
+	}
+
+	var stats map[dns.Hostname]map[dns.QueryType]dns.Stats
+	for _, k := range a.dnsKeysByServer[key] {
+		s, ok := a.dnsStats[k]
+		if !ok {
+			continue
+		}
+		delete(a.dnsStats, k)
+		if stats == nil {
+			stats = s
+			continue
+		}
+		mergeDNSStats(stats, s)
+	}
+	delete(a.dnsKeysByServer, key)
+	return stats
+}
+
 // Aggregate aggregates a connection. The connection is only
 // aggregated if:
 // - it is not in the collection
@@ -1373,6 +1653,9 @@ func (ac *aggregateConnection) merge(c *ConnectionStats) {
 	ac.Last = ac.Last.Add(c.Last)
 	ac.rttSum += uint64(c.RTT)
 	ac.rttVarSum += uint64(c.RTTVar)
+	// the histograms aren't kept, the worst percentiles are reported
+	ac.RTTP50 = max(ac.RTTP50, c.RTTP50)
+	ac.RTTP99 = max(ac.RTTP99, c.RTTP99)
 	ac.count++
 	if ac.LastUpdateEpoch < c.LastUpdateEpoch {
 		ac.LastUpdateEpoch = c.LastUpdateEpoch
@@ -1382,36 +1665,54 @@ func (ac *aggregateConnection) merge(c *ConnectionStats) {
 	}
 
 	ac.ProtocolStack.MergeWith(c.ProtocolStack)
+	ac.TLSTags.MergeWith(c.TLSTags)
+
+	if len(c.TCPFailures) > 0 {
+		// the map may be shared with a stored closed connection, it is copied before adding to it
+		failures := make(map[uint16]uint32, len(ac.TCPFailures)+len(c.TCPFailures))
+		for errno, count := range ac.TCPFailures {
+			failures[errno] = count
+		}
+		for errno, count := range c.TCPFailures {
+			failures[errno] += count
+		}
+		ac.TCPFailures = failures
+	}
 
 	if ac.DNSStats == nil {
 		ac.DNSStats = c.DNSStats
 	} else {
-		for hostname, statsByQuery := range c.DNSStats {
-			hostStats := ac.DNSStats[hostname]
-			if hostStats == nil {
-				hostStats = make(map[dns.QueryType]dns.Stats)
-				ac.DNSStats[hostname] = hostStats
+		mergeDNSStats(ac.DNSStats, c.DNSStats)
+	}
+
+	// no need to hold on to dns stats on the aggregated connection
+	c.DNSStats = nil
+}
+
+// mergeDNSStats adds the DNS stats of src to dst
+func mergeDNSStats(dst, src map[dns.Hostname]map[dns.QueryType]dns.Stats) {
+	for hostname, statsByQuery := range src {
+		hostStats := dst[hostname]
+		if hostStats == nil {
+			hostStats = make(map[dns.QueryType]dns.Stats)
+			dst[hostname] = hostStats
+		}
+		for q, stats := range statsByQuery {
+			queryStats, ok := hostStats[q]
+			if !ok {
+				hostStats[q] = stats
+				continue
 			}
-			for q, stats := range statsByQuery {
-				queryStats, ok := hostStats[q]
-				if !ok {
-					hostStats[q] = stats
-					continue
-				}
 
-				queryStats.FailureLatencySum += stats.FailureLatencySum
-				queryStats.SuccessLatencySum += stats.SuccessLatencySum
-				queryStats.Timeouts += stats.Timeouts
-				for rcode, count := range stats.CountByRcode {
-					queryStats.CountByRcode[rcode] += count
-				}
-				hostStats[q] = queryStats
+			queryStats.FailureLatencySum += stats.FailureLatencySum
+			queryStats.SuccessLatencySum += stats.SuccessLatencySum
+			queryStats.Timeouts += stats.Timeouts
+			for rcode, count := range stats.CountByRcode {
+				queryStats.CountByRcode[rcode] += count
 			}
+			hostStats[q] = queryStats
 		}
 	}
-
-	// no need to hold on to dns stats on the aggregated connection
-	c.DNSStats = nil
 }
 
 func (a *connectionAggregator) finalize() {
@@ -1445,6 +1746,11 @@ func (ns *networkState) mergeConnectionStats(a, b *ConnectionStats) (collision b
 	}
 
 	a.ProtocolStack.MergeWith(b.ProtocolStack)
+	a.TLSTags.MergeWith(b.TLSTags)
+
+	if a.TCPFailures == nil {
+		a.TCPFailures = b.TCPFailures
+	}
 
 	return false
 }
@@ -1452,5 +1758,5 @@ func (ns *networkState) mergeConnectionStats(a, b *ConnectionStats) (collision b
 func isEmpty(conn ConnectionStats) bool {
 	return conn.Monotonic.RecvBytes == 0 && conn.Monotonic.RecvPackets == 0 &&
 		conn.Monotonic.SentBytes == 0 && conn.Monotonic.SentPackets == 0 &&
-		conn.Monotonic.Retransmits == 0
+		conn.Monotonic.Retransmits == 0 && len(conn.TCPFailures) == 0
 }
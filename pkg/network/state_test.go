@@ -25,8 +25,13 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/config"
 	"github.com/DataDog/datadog-agent/pkg/network/dns"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/amqp"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/http"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/http2"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/kafka"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/mongo"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/mysql"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/redis"
 	"github.com/DataDog/datadog-agent/pkg/network/slice"
 	"github.com/DataDog/datadog-agent/pkg/process/util"
 )
@@ -544,7 +549,7 @@ func TestNoPriorRegistrationActiveConnections(t *testing.T) {
 func TestCleanupClient(t *testing.T) {
 	clientID := "1"
 
-	state := NewState(100*time.Millisecond, 50000, 75000, 75000, 7500, 75000, 75000, false, false)
+	state := NewState(100*time.Millisecond, 50000, 75000, 75000, 7500, 75000, 75000, 75000, 75000, 75000, 75000, false, false)
 	clients := state.(*networkState).getClients()
 	assert.Equal(t, 0, len(clients))
 
@@ -1553,6 +1558,34 @@ func TestAggregateClosedConnectionsTimestamp(t *testing.T) {
 	assert.Equal(t, conn.LastUpdateEpoch, delta.Conns[0].LastUpdateEpoch)
 }
 
+func TestAggregateClosedConnectionsTCPFailures(t *testing.T) {
+	conn := ConnectionStats{
+		Pid:             123,
+		Type:            TCP,
+		Family:          AFINET,
+		Source:          util.AddressFromString("127.0.0.1"),
+		Dest:            util.AddressFromString("127.0.0.1"),
+		SPort:           31890,
+		DPort:           80,
+		Direction:       OUTGOING,
+		LastUpdateEpoch: latestEpochTime(),
+	}
+
+	client := "client"
+	state := newDefaultState()
+	state.RegisterClient(client)
+
+	for cookie, errno := range []uint16{111, 111, 110} {
+		conn.Cookie = StatCookie(cookie)
+		conn.TCPFailures = map[uint16]uint32{errno: 1}
+		state.StoreClosedConnections([]ConnectionStats{conn})
+	}
+
+	delta := state.GetDelta(client, latestEpochTime(), nil, nil, nil)
+	require.Len(t, delta.Conns, 1)
+	assert.Equal(t, map[uint16]uint32{111: 2, 110: 1}, delta.Conns[0].TCPFailures)
+}
+
 func TestDNSStatsWithMultipleClients(t *testing.T) {
 	c := ConnectionStats{
 		Pid:    123,
@@ -1629,6 +1662,43 @@ func TestDNSStatsWithMultipleClients(t *testing.T) {
 	assert.EqualValues(t, 3, rcode)
 }
 
+func TestDNSStatsWithAggregatedUDPFlows(t *testing.T) {
+	// UDP flows aggregated by the tracer have no source port
+	c := ConnectionStats{
+		Pid:    123,
+		Type:   UDP,
+		Family: AFINET,
+		Source: util.AddressFromString("10.0.0.1"),
+		Dest:   util.AddressFromString("10.0.0.2"),
+		DPort:  53,
+	}
+
+	d := dns.ToHostname("foo.com")
+	dnsStats := make(dns.StatsByKeyByNameByType)
+	for _, port := range []uint16{40000, 40001} {
+		key := dns.Key{ClientIP: c.Source, ClientPort: port, ServerIP: c.Dest, Protocol: getIPProtocol(c.Type)}
+		dnsStats[key] = map[dns.Hostname]map[dns.QueryType]dns.Stats{
+			d: {dns.TypeA: {CountByRcode: map[uint32]uint32{uint32(DNSResponseCodeNoError): 1}}},
+		}
+	}
+	// stats of another server are not merged
+	otherKey := dns.Key{ClientIP: c.Source, ClientPort: 40002, ServerIP: util.AddressFromString("10.0.0.3"), Protocol: getIPProtocol(c.Type)}
+	dnsStats[otherKey] = map[dns.Hostname]map[dns.QueryType]dns.Stats{
+		d: {dns.TypeA: {CountByRcode: map[uint32]uint32{uint32(DNSResponseCodeNoError): 1}}},
+	}
+
+	state := newDefaultState()
+	state.RegisterClient("client")
+
+	c.Monotonic = StatCounters{SentBytes: 100, RecvBytes: 200}
+	c.Cookie = 1
+	c.LastUpdateEpoch = latestEpochTime()
+	delta := state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, dnsStats, nil)
+	require.Len(t, delta.Conns, 1)
+	require.Contains(t, delta.Conns[0].DNSStats, d)
+	assert.EqualValues(t, 2, delta.Conns[0].DNSStats[d][dns.TypeA].CountByRcode[uint32(DNSResponseCodeNoError)])
+}
+
 func TestHTTPStats(t *testing.T) {
 	t.Run("status code", func(t *testing.T) {
 		testHTTPStats(t, true)
@@ -2345,6 +2415,262 @@ func TestKafkaStatsWithMultipleClients(t *testing.T) {
 	assert.Len(t, delta.Kafka, 2)
 }
 
+func TestRedisStats(t *testing.T) {
+	c := ConnectionStats{
+		Source: util.AddressFromString("1.1.1.1"),
+		Dest:   util.AddressFromString("0.0.0.0"),
+		SPort:  1000,
+		DPort:  6379,
+	}
+
+	key := redis.NewKey(c.Source, c.Dest, c.SPort, c.DPort, "GET", false)
+
+	redisStats := make(map[redis.Key]*redis.RequestStat)
+	redisStats[key] = &redis.RequestStat{Count: 2}
+	usmStats := make(map[protocols.ProtocolType]interface{})
+	usmStats[protocols.Redis] = redisStats
+
+	// Register client & pass in Redis stats
+	state := newDefaultState()
+	delta := state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, nil, usmStats)
+
+	// Verify the Redis stats were stored
+	require.Len(t, delta.Redis, 1)
+	assert.Equal(t, 2, delta.Redis[key].Count)
+
+	// Verify Redis data has been flushed
+	delta = state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, nil, nil)
+	assert.Len(t, delta.Redis, 0)
+}
+
+func TestRedisStatsWithMultipleClients(t *testing.T) {
+	c := ConnectionStats{
+		Source: util.AddressFromString("1.1.1.1"),
+		Dest:   util.AddressFromString("0.0.0.0"),
+		SPort:  1000,
+		DPort:  6379,
+	}
+
+	getStats := func(command string, count int) map[protocols.ProtocolType]interface{} {
+		redisStats := make(map[redis.Key]*redis.RequestStat)
+		key := redis.NewKey(c.Source, c.Dest, c.SPort, c.DPort, command, false)
+		redisStats[key] = &redis.RequestStat{Count: count}
+
+		usmStats := make(map[protocols.ProtocolType]interface{})
+		usmStats[protocols.Redis] = redisStats
+
+		return usmStats
+	}
+	getKey := redis.NewKey(c.Source, c.Dest, c.SPort, c.DPort, "GET", false)
+	setKey := redis.NewKey(c.Source, c.Dest, c.SPort, c.DPort, "SET", false)
+
+	client1 := "client1"
+	client2 := "client2"
+	client3 := "client3"
+	state := newDefaultState()
+
+	// Register the first two clients
+	state.RegisterClient(client1)
+	state.RegisterClient(client2)
+
+	// We should have nothing on first call
+	assert.Len(t, state.GetDelta(client1, latestEpochTime(), nil, nil, nil).Redis, 0)
+	assert.Len(t, state.GetDelta(client2, latestEpochTime(), nil, nil, nil).Redis, 0)
+
+	// Store the connection to both clients & pass Redis stats to the first client
+	c.LastUpdateEpoch = latestEpochTime()
+	state.StoreClosedConnections([]ConnectionStats{c})
+
+	delta := state.GetDelta(client1, latestEpochTime(), nil, nil, getStats("GET", 2))
+	require.Len(t, delta.Redis, 1)
+	assert.Equal(t, 2, delta.Redis[getKey].Count)
+
+	// Verify that the Redis stats were also stored in the second client
+	delta = state.GetDelta(client2, latestEpochTime(), nil, nil, nil)
+	require.Len(t, delta.Redis, 1)
+	assert.Equal(t, 2, delta.Redis[getKey].Count)
+
+	// Register a third client & verify that it does not have the Redis stats
+	delta = state.GetDelta(client3, latestEpochTime(), []ConnectionStats{c}, nil, nil)
+	assert.Len(t, delta.Redis, 0)
+
+	c.LastUpdateEpoch = latestEpochTime()
+	state.StoreClosedConnections([]ConnectionStats{c})
+
+	// Pass in new Redis stats to the first client, twice
+	delta = state.GetDelta(client1, latestEpochTime(), nil, nil, getStats("GET", 3))
+	require.Len(t, delta.Redis, 1)
+	assert.Equal(t, 3, delta.Redis[getKey].Count)
+	delta = state.GetDelta(client1, latestEpochTime(), nil, nil, getStats("SET", 1))
+	require.Len(t, delta.Redis, 1)
+	assert.Equal(t, 1, delta.Redis[setKey].Count)
+
+	// The second and third clients accumulated the stats of both calls
+	delta = state.GetDelta(client2, latestEpochTime(), nil, nil, nil)
+	require.Len(t, delta.Redis, 2)
+	assert.Equal(t, 3, delta.Redis[getKey].Count)
+	assert.Equal(t, 1, delta.Redis[setKey].Count)
+
+	delta = state.GetDelta(client3, latestEpochTime(), nil, nil, nil)
+	assert.Len(t, delta.Redis, 2)
+}
+
+func TestRedisStatsAggregation(t *testing.T) {
+	c := ConnectionStats{
+		Source: util.AddressFromString("1.1.1.1"),
+		Dest:   util.AddressFromString("0.0.0.0"),
+		SPort:  1000,
+		DPort:  6379,
+	}
+	key := redis.NewKey(c.Source, c.Dest, c.SPort, c.DPort, "GET", false)
+	getStats := func(count int) map[protocols.ProtocolType]interface{} {
+		return map[protocols.ProtocolType]interface{}{
+			protocols.Redis: map[redis.Key]*redis.RequestStat{key: {Count: count}},
+		}
+	}
+
+	client1 := "client1"
+	client2 := "client2"
+	state := newDefaultState()
+	state.RegisterClient(client1)
+	state.RegisterClient(client2)
+
+	// The stats of the same key are combined until the second client reads them
+	state.GetDelta(client1, latestEpochTime(), nil, nil, getStats(2))
+	state.GetDelta(client1, latestEpochTime(), nil, nil, getStats(3))
+
+	delta := state.GetDelta(client2, latestEpochTime(), nil, nil, nil)
+	require.Len(t, delta.Redis, 1)
+	assert.Equal(t, 5, delta.Redis[key].Count)
+
+	delta = state.GetDelta(client2, latestEpochTime(), nil, nil, nil)
+	assert.Len(t, delta.Redis, 0)
+}
+
+func TestAMQPStats(t *testing.T) {
+	c := ConnectionStats{
+		Source: util.AddressFromString("1.1.1.1"),
+		Dest:   util.AddressFromString("0.0.0.0"),
+		SPort:  1000,
+		DPort:  5672,
+	}
+
+	publishKey := amqp.NewKey(c.Source, c.Dest, c.SPort, c.DPort, "", amqp.PublishMethod)
+	deliverKey := amqp.NewKey(c.Source, c.Dest, c.SPort, c.DPort, "", amqp.DeliverMethod)
+
+	amqpStats := make(map[amqp.Key]*amqp.RequestStat)
+	amqpStats[publishKey] = &amqp.RequestStat{Count: 2}
+	amqpStats[deliverKey] = &amqp.RequestStat{Count: 3}
+	usmStats := make(map[protocols.ProtocolType]interface{})
+	usmStats[protocols.AMQP] = amqpStats
+
+	// Register client & pass in AMQP stats
+	state := newDefaultState()
+	delta := state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, nil, usmStats)
+
+	// Verify the AMQP stats were stored
+	require.Len(t, delta.AMQP, 2)
+	assert.Equal(t, 2, delta.AMQP[publishKey].Count)
+	assert.Equal(t, 3, delta.AMQP[deliverKey].Count)
+
+	// Verify AMQP data has been flushed
+	delta = state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, nil, nil)
+	assert.Len(t, delta.AMQP, 0)
+}
+
+func TestMySQLStats(t *testing.T) {
+	c := ConnectionStats{
+		Source: util.AddressFromString("1.1.1.1"),
+		Dest:   util.AddressFromString("0.0.0.0"),
+		SPort:  1000,
+		DPort:  3306,
+	}
+
+	selectKey := mysql.NewKey(c.Source, c.Dest, c.SPort, c.DPort, "QUERY", "SELECT", false)
+	pingKey := mysql.NewKey(c.Source, c.Dest, c.SPort, c.DPort, "PING", "", false)
+
+	mysqlStats := make(map[mysql.Key]*mysql.RequestStat)
+	mysqlStats[selectKey] = &mysql.RequestStat{Count: 2}
+	mysqlStats[pingKey] = &mysql.RequestStat{Count: 1}
+	usmStats := make(map[protocols.ProtocolType]interface{})
+	usmStats[protocols.MySQL] = mysqlStats
+
+	// Register client & pass in MySQL stats
+	state := newDefaultState()
+	delta := state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, nil, usmStats)
+
+	// Verify the MySQL stats were stored
+	require.Len(t, delta.MySQL, 2)
+	assert.Equal(t, 2, delta.MySQL[selectKey].Count)
+	assert.Equal(t, 1, delta.MySQL[pingKey].Count)
+
+	// Verify MySQL data has been flushed
+	delta = state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, nil, nil)
+	assert.Len(t, delta.MySQL, 0)
+}
+
+func TestMongoStats(t *testing.T) {
+	c := ConnectionStats{
+		Source: util.AddressFromString("1.1.1.1"),
+		Dest:   util.AddressFromString("0.0.0.0"),
+		SPort:  1000,
+		DPort:  27017,
+	}
+
+	findKey := mongo.NewKey(c.Source, c.Dest, c.SPort, c.DPort, "find", false)
+	findErrorKey := mongo.NewKey(c.Source, c.Dest, c.SPort, c.DPort, "find", true)
+
+	mongoStats := make(map[mongo.Key]*mongo.RequestStat)
+	mongoStats[findKey] = &mongo.RequestStat{Count: 3}
+	mongoStats[findErrorKey] = &mongo.RequestStat{Count: 1}
+	usmStats := make(map[protocols.ProtocolType]interface{})
+	usmStats[protocols.Mongo] = mongoStats
+
+	// Register client & pass in Mongo stats
+	state := newDefaultState()
+	delta := state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, nil, usmStats)
+
+	// Verify the Mongo stats were stored
+	require.Len(t, delta.Mongo, 2)
+	assert.Equal(t, 3, delta.Mongo[findKey].Count)
+	assert.Equal(t, 1, delta.Mongo[findErrorKey].Count)
+
+	// Verify Mongo data has been flushed
+	delta = state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, nil, nil)
+	assert.Len(t, delta.Mongo, 0)
+}
+
+func TestGRPCStats(t *testing.T) {
+	c := ConnectionStats{
+		Source: util.AddressFromString("1.1.1.1"),
+		Dest:   util.AddressFromString("0.0.0.0"),
+		SPort:  1000,
+		DPort:  5050,
+	}
+
+	okKey := http2.NewGRPCKey(c.Source, c.Dest, c.SPort, c.DPort, 0)
+	notFoundKey := http2.NewGRPCKey(c.Source, c.Dest, c.SPort, c.DPort, 5)
+
+	grpcStats := make(map[http2.GRPCKey]*http2.GRPCStat)
+	grpcStats[okKey] = &http2.GRPCStat{Count: 4}
+	grpcStats[notFoundKey] = &http2.GRPCStat{Count: 1}
+	usmStats := make(map[protocols.ProtocolType]interface{})
+	usmStats[protocols.GRPC] = grpcStats
+
+	// Register client & pass in gRPC stats
+	state := newDefaultState()
+	delta := state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, nil, usmStats)
+
+	// Verify the gRPC stats were stored
+	require.Len(t, delta.GRPC, 2)
+	assert.Equal(t, 4, delta.GRPC[okKey].Count)
+	assert.Equal(t, 1, delta.GRPC[notFoundKey].Count)
+
+	// Verify gRPC data has been flushed
+	delta = state.GetDelta("client", latestEpochTime(), []ConnectionStats{c}, nil, nil)
+	assert.Len(t, delta.GRPC, 0)
+}
+
 func TestConnectionRollup(t *testing.T) {
 	conns := []ConnectionStats{
 		{
@@ -2849,7 +3175,7 @@ func latestEpochTime() uint64 {
 
 func newDefaultState() *networkState {
 	// Using values from ebpf.NewConfig()
-	return NewState(2*time.Minute, 50000, 75000, 75000, 7500, 7500, 7500, false, false).(*networkState)
+	return NewState(2*time.Minute, 50000, 75000, 75000, 7500, 7500, 7500, 7500, 7500, 7500, 7500, false, false).(*networkState)
 }
 
 func getIPProtocol(nt ConnectionType) uint8 {
@@ -0,0 +1,278 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package connection
+
+import (
+	"errors"
+	"fmt"
+	"sync"
+
+	manager "github.com/DataDog/ebpf-manager"
+	"github.com/cilium/ebpf"
+
+	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
+	"github.com/DataDog/datadog-agent/pkg/network"
+	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
+	"github.com/DataDog/datadog-agent/pkg/network/ebpf/probes"
+	"github.com/DataDog/datadog-agent/pkg/telemetry"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
+)
+
+// deltaPollingFullScanInterval is the number of polls after which the whole conn_stats map is read again
+const deltaPollingFullScanInterval = 10
+
+var deltaPollingTelemetry = struct {
+	fullScans    telemetry.Counter
+	touchedConns telemetry.Counter
+}{
+	telemetry.NewCounter(connTracerModuleName, "delta_polling_full_scans", []string{}, "Counter measuring the number of times the whole connection map was read with delta polling"),
+	telemetry.NewCounter(connTracerModuleName, "delta_polling_touched_conns", []string{}, "Counter measuring the number of updated connections read with delta polling"),
+}
+
+// connEntry holds the values read from the eBPF maps for a connection
+type connEntry struct {
+	stats          netebpf.ConnStats
+	tcpStats       netebpf.TCPStats
+	retransmits    uint32
+	hasTCPStats    bool
+	hasRetransmits bool
+}
+
+// deltaPoller only reads the connections updated since the previous poll from the conn_stats map, using the
+// tuples recorded by the tracer in the conn_touched map, see mark_conn_touched in
+// pkg/network/ebpf/c/tracer/stats.h. The other connections are reported with the values of their last read.
+// These are monotonic counters, so a connection whose tuple was dropped is only reported late: the whole map is
+// read every deltaPollingFullScanInterval polls, and when the list of a CPU overflows.
+type deltaPoller struct {
+	epochMap   *maps.GenericMap[uint32, uint32]
+	touchedMap *maps.GenericMap[uint32, []netebpf.ConnTouched]
+	touched    []netebpf.ConnTouched
+	epoch      uint32
+	polls      int
+
+	// the closed connections consumer stops reporting the connections it receives
+	mu    sync.Mutex
+	conns map[netebpf.ConnTuple]connEntry
+}
+
+func newDeltaPoller(m *manager.Manager) (*deltaPoller, error) {
+	cpus, err := ebpf.PossibleCPU()
+	if err != nil {
+		return nil, fmt.Errorf("could not get the number of CPUs: %w", err)
+	}
+
+	d := &deltaPoller{touched: make([]netebpf.ConnTouched, cpus)}
+	if d.epochMap, err = maps.GetMap[uint32, uint32](m, probes.ConnPollEpochMap); err != nil {
+		return nil, fmt.Errorf("error retrieving the bpf %s map: %s", probes.ConnPollEpochMap, err)
+	}
+	if d.touchedMap, err = maps.GetMap[uint32, []netebpf.ConnTouched](m, probes.ConnTouchedMap); err != nil {
+		return nil, fmt.Errorf("error retrieving the bpf %s map: %s", probes.ConnTouchedMap, err)
+	}
+	return d, nil
+}
+
+// advance starts a new poll epoch. It returns whether the whole conn_stats map must be read, the tuples
+// recorded during the previous epoch are otherwise in d.touched.
+func (d *deltaPoller) advance() (fullScan bool, err error) {
+	prev := d.epoch
+	d.epoch++
+	d.polls++
+	defer func() {
+		if fullScan {
+			d.polls = 0
+		}
+	}()
+
+	var zero uint32
+	if err := d.epochMap.Put(&zero, &d.epoch); err != nil {
+		return true, fmt.Errorf("error updating the poll epoch: %w", err)
+	}
+	if d.conns == nil || d.polls >= deltaPollingFullScanInterval {
+		return true, nil
+	}
+
+	slot := prev & 1
+	if err := d.touchedMap.Lookup(&slot, &d.touched); err != nil {
+		return true, fmt.Errorf("error reading the touched connections: %w", err)
+	}
+	for i := range d.touched {
+		if d.touched[i].Epoch == prev && d.touched[i].Len > netebpf.ConnTouchedMax {
+			return true, nil
+		}
+	}
+	return false, nil
+}
+
+// forget stops reporting a connection until it is read again from the conn_stats map
+func (d *deltaPoller) forget(tuple *netebpf.ConnTuple) {
+	d.mu.Lock()
+	delete(d.conns, *tuple)
+	d.mu.Unlock()
+}
+
+// forgetClosed wraps the callback receiving the closed connections to stop reporting them
+func (d *deltaPoller) forgetClosed(callback func([]network.ConnectionStats)) func([]network.ConnectionStats) {
+	var tuple netebpf.ConnTuple
+	return func(conns []network.ConnectionStats) {
+		d.mu.Lock()
+		for i := range conns {
+			connTupleFromConn(&tuple, &conns[i])
+			delete(d.conns, tuple)
+		}
+		d.mu.Unlock()
+		callback(conns)
+	}
+}
+
+// touchedTuples calls fn for each tuple recorded during the epoch, a tuple can be recorded by several CPUs
+func touchedTuples(values []netebpf.ConnTouched, epoch uint32, fn func(*netebpf.ConnTuple)) {
+	for i := range values {
+		v := &values[i]
+		if v.Epoch != epoch {
+			continue
+		}
+		n := min(v.Len, netebpf.ConnTouchedMax)
+		for j := uint32(0); j < n; j++ {
+			fn(&v.Tuples[j])
+		}
+	}
+}
+
+// getConnectionsDelta implements GetConnections when delta polling is enabled, see deltaPoller
+func (t *tracer) getConnectionsDelta(buffer *network.ConnectionBuffer, filter func(*network.ConnectionStats) bool) error {
+	fullScan, err := t.delta.advance()
+	if err != nil {
+		log.Warnf("reading all connections: %s", err)
+	}
+
+	t.delta.mu.Lock()
+	defer t.delta.mu.Unlock()
+
+	if fullScan {
+		deltaPollingTelemetry.fullScans.Inc()
+		if err := t.readAllConnections(); err != nil {
+			return err
+		}
+	} else {
+		t.readTouchedConnections()
+	}
+
+	// Cached objects
+	conn := new(network.ConnectionStats)
+	seen := make(map[netebpf.ConnTuple]struct{})
+	hist := new(netebpf.TCPRTTHist)
+
+	var counts connCounts
+	for key, e := range t.delta.conns {
+		populateConnStats(conn, &key, &e.stats, t.ch)
+		counts.add(conn)
+
+		if filter != nil && !filter(conn) {
+			continue
+		}
+
+		if e.hasTCPStats {
+			updateTCPStats(conn, &e.tcpStats, 0)
+		}
+		t.getRTTPercentiles(conn, &key, hist, false)
+		if key.Type() == netebpf.TCP {
+			var retransmits uint32
+			if e.hasRetransmits {
+				// This is required to avoid (over)reporting retransmits for connections sharing the same socket.
+				key.Pid = 0
+				if _, reported := seen[key]; reported {
+					ConnTracerTelemetry.PidCollisions.Inc()
+				} else {
+					seen[key] = struct{}{}
+					retransmits = e.retransmits
+				}
+			}
+			updateTCPStats(conn, nil, retransmits)
+		}
+		scaleSampledConn(conn, t.config.NPMConnSamplingRate)
+
+		*buffer.Next() = *conn
+	}
+
+	updateTelemetry(counts.tcp4, counts.tcp6, counts.udp4, counts.udp6)
+
+	return nil
+}
+
+// readAllConnections replaces the connections of the delta poller with the content of the conn_stats map
+func (t *tracer) readAllConnections() error {
+	conns := make(map[netebpf.ConnTuple]connEntry, len(t.delta.conns))
+	key := &netebpf.ConnTuple{}
+	var e connEntry
+
+	entries := t.iterateConns()
+	for entries.Next(key, &e.stats) {
+		if _, exists := conns[*key]; exists {
+			// already seen the connection in current batch processing,
+			// due to race between the iterator and bpf_map_delete
+			ConnTracerTelemetry.iterationDups.Inc()
+			continue
+		}
+
+		t.readTCPEntry(key, &e)
+		conns[*key] = e
+	}
+
+	if err := entries.Err(); err != nil {
+		if !errors.Is(err, ebpf.ErrIterationAborted) {
+			return fmt.Errorf("unable to iterate connection map: %w", err)
+		}
+
+		log.Warn("eBPF conn_stats map iteration aborted. Some connections may not be reported")
+		ConnTracerTelemetry.iterationAborts.Inc()
+	}
+
+	t.delta.conns = conns
+	return nil
+}
+
+// readTouchedConnections reads the connections updated during the previous epoch
+func (t *tracer) readTouchedConnections() {
+	read := make(map[netebpf.ConnTuple]struct{})
+	var e connEntry
+	touchedTuples(t.delta.touched, t.delta.epoch-1, func(key *netebpf.ConnTuple) {
+		if _, ok := read[*key]; ok {
+			return
+		}
+		read[*key] = struct{}{}
+
+		e = connEntry{}
+		if !t.lookupConnStats(key, &e.stats) {
+			// the connection was closed or removed
+			delete(t.delta.conns, *key)
+			return
+		}
+		t.readTCPEntry(key, &e)
+		t.delta.conns[*key] = e
+		deltaPollingTelemetry.touchedConns.Inc()
+	})
+}
+
+// readTCPEntry reads the TCP stats and retransmits of the connection whose stats were just read
+func (t *tracer) readTCPEntry(key *netebpf.ConnTuple, e *connEntry) {
+	e.hasTCPStats = t.getTCPStats(&e.tcpStats, key)
+	e.hasRetransmits = false
+	if key.Type() != netebpf.TCP {
+		return
+	}
+	if t.config.TCPStatsRetransmitsEnabled {
+		e.retransmits, e.hasRetransmits = e.tcpStats.Retransmits, e.hasTCPStats
+		return
+	}
+
+	// The PID isn't used as a key in the retransmits map
+	pid := key.Pid
+	key.Pid = 0
+	e.hasRetransmits = t.tcpRetransmits.Lookup(key, &e.retransmits) == nil
+	key.Pid = pid
+}
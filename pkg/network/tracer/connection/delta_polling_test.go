@@ -0,0 +1,38 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package connection
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+
+	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
+)
+
+func TestTouchedTuples(t *testing.T) {
+	values := make([]netebpf.ConnTouched, 3)
+	values[0].Epoch = 4
+	values[0].Len = 2
+	values[0].Tuples[0].Sport = 1
+	values[0].Tuples[1].Sport = 2
+	// list of two epochs ago, not reset since the CPU didn't update any connection
+	values[1].Epoch = 2
+	values[1].Len = 1
+	values[1].Tuples[0].Sport = 3
+	// overflowed list
+	values[2].Epoch = 4
+	values[2].Len = netebpf.ConnTouchedMax + 1
+
+	var ports []uint16
+	touchedTuples(values, 4, func(tuple *netebpf.ConnTuple) {
+		ports = append(ports, tuple.Sport)
+	})
+	assert.Len(t, ports, 2+netebpf.ConnTouchedMax)
+	assert.Equal(t, []uint16{1, 2}, ports[:2])
+}
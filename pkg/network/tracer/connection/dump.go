@@ -73,24 +73,47 @@ func dumpMapsHandler(w io.Writer, manager *manager.Manager, mapName string, curr
 		}
 		spew.Fdump(w, telemetry)
 
-	case probes.ConnMap: // maps/conn_stats (BPF_MAP_TYPE_HASH), key ConnTuple, value ConnStatsWithTimestamp
+	case probes.ConnMap: // maps/conn_stats (BPF_MAP_TYPE_HASH or BPF_MAP_TYPE_PERCPU_HASH), key ConnTuple, value ConnStatsWithTimestamp
 		io.WriteString(w, "Map: '"+mapName+"', key: 'ConnTuple', value: 'ConnStatsWithTimestamp'\n")
 		iter := currentMap.Iterate()
 		var key ddebpf.ConnTuple
+		if currentMap.Type() == ebpf.PerCPUHash || currentMap.Type() == ebpf.LRUCPUHash {
+			var values []ddebpf.ConnStats
+			for iter.Next(unsafe.Pointer(&key), &values) {
+				spew.Fdump(w, key, values)
+			}
+			break
+		}
 		var value ddebpf.ConnStats
 		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
 			spew.Fdump(w, key, value)
 		}
 
-	case probes.TCPStatsMap: // maps/tcp_stats (BPF_MAP_TYPE_HASH), key ConnTuple, value TCPStats
+	case probes.TCPStatsMap: // maps/tcp_stats (BPF_MAP_TYPE_HASH or BPF_MAP_TYPE_PERCPU_HASH), key ConnTuple, value TCPStats
 		io.WriteString(w, "Map: '"+mapName+"', key: 'ConnTuple', value: 'TCPStats'\n")
 		iter := currentMap.Iterate()
 		var key ddebpf.ConnTuple
+		if currentMap.Type() == ebpf.PerCPUHash || currentMap.Type() == ebpf.LRUCPUHash {
+			var values []ddebpf.TCPStats
+			for iter.Next(unsafe.Pointer(&key), &values) {
+				spew.Fdump(w, key, values)
+			}
+			break
+		}
 		var value ddebpf.TCPStats
 		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
 			spew.Fdump(w, key, value)
 		}
 
+	case probes.TCPRTTHistMap: // maps/tcp_rtt_hist (BPF_MAP_TYPE_HASH or BPF_MAP_TYPE_LRU_HASH), key ConnTuple, value TCPRTTHist
+		io.WriteString(w, "Map: '"+mapName+"', key: 'ConnTuple', value: 'TCPRTTHist'\n")
+		iter := currentMap.Iterate()
+		var key ddebpf.ConnTuple
+		var value ddebpf.TCPRTTHist
+		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
+			spew.Fdump(w, key, value)
+		}
+
 	case probes.ConnCloseBatchMap: // maps/conn_close_batch (BPF_MAP_TYPE_HASH), key C.__u32, value batch
 		io.WriteString(w, "Map: '"+mapName+"', key: 'C.__u32', value: 'batch'\n")
 		iter := currentMap.Iterate()
@@ -10,8 +10,12 @@ package fentry
 import (
 	"fmt"
 
+	cebpf "github.com/cilium/ebpf"
+	"github.com/cilium/ebpf/features"
+
 	"github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/network/config"
+	"github.com/DataDog/datadog-agent/pkg/network/ebpf/probes"
 	"github.com/DataDog/datadog-agent/pkg/util/kernel"
 )
 
@@ -24,6 +28,8 @@ const (
 	// tcpFinishConnect traces tcp_finish_connect() kernel function. This is
 	// used to know when a TCP connection switches to the ESTABLISHED state
 	tcpFinishConnect = "tcp_finish_connect"
+	// tcpDone traces the tcp_done() kernel function, to record the error of the connects that fail
+	tcpDone = "tcp_done"
 
 	// tcpSendMsgReturn traces the return value for the tcp_sendmsg() system call
 	tcpSendMsgReturn  = "tcp_sendmsg_exit"
@@ -43,7 +49,7 @@ const (
 	udpRecvMsgReturn        = "udp_recvmsg_exit"
 	udpRecvMsgPre5190Return = "udp_recvmsg_exit_pre_5_19_0"
 	udpSendMsgReturn        = "udp_sendmsg_exit"
-	udpSendSkb              = "kprobe__udp_send_skb"
+	udpSendSkb              = "udp_send_skb"
 
 	skbFreeDatagramLocked = "skb_free_datagram_locked"
 	//nolint:revive // TODO(NET) Fix revive linter
@@ -55,7 +61,7 @@ const (
 	udpv6RecvMsgReturn        = "udpv6_recvmsg_exit"
 	udpv6RecvMsgPre5190Return = "udpv6_recvmsg_exit_pre_5_19_0"
 	udpv6SendMsgReturn        = "udpv6_sendmsg_exit"
-	udpv6SendSkb              = "kprobe__udp_v6_send_skb"
+	udpv6SendSkb              = "udp_v6_send_skb"
 
 	// udpDestroySock traces the udp_destroy_sock() function
 	udpDestroySock = "udp_destroy_sock"
@@ -65,8 +71,6 @@ const (
 	udpv6DestroySock       = "udpv6_destroy_sock"
 	udpv6DestroySockReturn = "udpv6_destroy_sock_exit"
 
-	// tcpRetransmit traces the tcp_retransmit_skb() kernel function
-	tcpRetransmit = "tcp_retransmit_skb"
 	// tcpRetransmitRet traces the return of the tcp_retransmit_skb() system call
 	tcpRetransmitRet = "tcp_retransmit_skb_exit"
 
@@ -95,7 +99,7 @@ var programs = map[string]struct{}{
 	tcpCloseReturn:            {},
 	tcpConnect:                {},
 	tcpFinishConnect:          {},
-	tcpRetransmit:             {},
+	tcpDone:                   {},
 	tcpRetransmitRet:          {},
 	tcpSendMsgReturn:          {},
 	tcpSendPageReturn:         {},
@@ -143,9 +147,11 @@ func enabledPrograms(c *config.Config) (map[string]struct{}, error) {
 		enableProgram(enabled, tcpCloseReturn)
 		enableProgram(enabled, tcpConnect)
 		enableProgram(enabled, tcpFinishConnect)
+		if c.TCPFailedConnectsEnabled {
+			enableProgram(enabled, tcpDone)
+		}
 		enableProgram(enabled, inetCskAcceptReturn)
 		enableProgram(enabled, inetCskListenStop)
-		enableProgram(enabled, tcpRetransmit)
 		enableProgram(enabled, tcpRetransmitRet)
 
 		// TODO: see comments above on availability for these
@@ -163,8 +169,6 @@ func enabledPrograms(c *config.Config) (map[string]struct{}, error) {
 		enableProgram(enabled, udpDestroySockReturn)
 		enableProgram(enabled, inetBind)
 		enableProgram(enabled, inetBindRet)
-		enableProgram(enabled, udpRecvMsg)
-		enableProgram(enabled, selectVersionBasedProbe(kv, udpRecvMsgReturn, udpRecvMsgPre5190Return, kv5190))
 		enableProgram(enabled, udpSendMsgReturn)
 		enableProgram(enabled, udpSendSkb)
 	}
@@ -175,14 +179,12 @@ func enabledPrograms(c *config.Config) (map[string]struct{}, error) {
 		enableProgram(enabled, udpv6DestroySockReturn)
 		enableProgram(enabled, inet6Bind)
 		enableProgram(enabled, inet6BindRet)
-		enableProgram(enabled, udpv6RecvMsg)
-		enableProgram(enabled, selectVersionBasedProbe(kv, udpv6RecvMsgReturn, udpv6RecvMsgPre5190Return, kv5190))
 		enableProgram(enabled, udpv6SendMsgReturn)
 		enableProgram(enabled, udpv6SendSkb)
 	}
 
 	if c.CollectUDPv4Conns || c.CollectUDPv6Conns {
-		if err := enableAdvancedUDP(enabled); err != nil {
+		if err := enableAdvancedUDP(enabled, c, kv); err != nil {
 			return nil, err
 		}
 	}
@@ -190,23 +192,60 @@ func enabledPrograms(c *config.Config) (map[string]struct{}, error) {
 	return enabled, nil
 }
 
-func enableAdvancedUDP(enabled map[string]struct{}) error {
+func enableAdvancedUDP(enabled map[string]struct{}, c *config.Config, kv kernel.Version) error {
 	missing, err := ebpf.VerifyKernelFuncs("skb_consume_udp", "__skb_free_datagram_locked", "skb_free_datagram_locked")
 	if err != nil {
 		return fmt.Errorf("error verifying kernel function presence: %s", err)
 	}
 	if _, miss := missing["skb_consume_udp"]; !miss {
+		// skb_consume_udp is passed a negative length by peeking calls, the receive calls don't need to be traced
 		enableProgram(enabled, skbConsumeUdp)
-	} else if _, miss := missing["__skb_free_datagram_locked"]; !miss {
+		return nil
+	}
+
+	if _, miss := missing["__skb_free_datagram_locked"]; !miss {
 		enableProgram(enabled, __skbFreeDatagramLocked)
 	} else if _, miss := missing["skb_free_datagram_locked"]; !miss {
 		enableProgram(enabled, skbFreeDatagramLocked)
 	} else {
 		return fmt.Errorf("missing desired UDP receive kernel functions")
 	}
+
+	// skb_free_datagram_locked doesn't know whether the receive call was peeking
+	kv5190 := kernel.VersionCode(5, 19, 0)
+	if c.CollectUDPv4Conns {
+		enableProgram(enabled, udpRecvMsg)
+		enableProgram(enabled, selectVersionBasedProbe(kv, udpRecvMsgReturn, udpRecvMsgPre5190Return, kv5190))
+	}
+	if c.CollectUDPv6Conns {
+		enableProgram(enabled, udpv6RecvMsg)
+		enableProgram(enabled, selectVersionBasedProbe(kv, udpv6RecvMsgReturn, udpv6RecvMsgPre5190Return, kv5190))
+	}
 	return nil
 }
 
+// unusedMaps returns the maps storing the arguments of the kprobe tracer programs that aren't needed by the
+// enabled fentry/fexit programs
+func unusedMaps(enabled map[string]struct{}) []string {
+	unused := []string{"pending_tcp_retransmit_skb", probes.IPMakeSkbArgsMap}
+	if _, ok := enabled[skbConsumeUdp]; ok {
+		unused = append(unused, "udp_recv_sock", "udpv6_recv_sock")
+	}
+	return unused
+}
+
+// sockTuplesMap caches the tuples of the established TCP sockets in their local storage
+const sockTuplesMap = "sock_tuples"
+
+// skStorageTuplesSupported returns true if the socket local storage can be used from fentry programs
+func skStorageTuplesSupported() (bool, error) {
+	kv, err := kernel.HostVersion()
+	if err != nil {
+		return false, err
+	}
+	return kv >= kernel.VersionCode(5, 11, 0) && features.HaveMapType(cebpf.SkStorage) == nil, nil
+}
+
 func selectVersionBasedProbe(kv kernel.Version, dfault string, versioned string, reqVer kernel.Version) string {
 	if kv < reqVer {
 		return versioned
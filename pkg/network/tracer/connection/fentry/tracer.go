@@ -14,6 +14,7 @@ import (
 	"syscall"
 
 	manager "github.com/DataDog/ebpf-manager"
+	"github.com/cilium/ebpf"
 
 	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/bytecode"
@@ -35,7 +36,7 @@ func LoadTracer(config *config.Config, mgrOpts manager.Options, connCloseEventHa
 		return nil, nil, ErrorNotSupported
 	}
 
-	m := ddebpf.NewManagerWithDefault(&manager.Manager{}, &ebpftelemetry.ErrorsTelemetryModifier{})
+	m := ddebpf.NewManagerWithDefault(&manager.Manager{}, &ebpftelemetry.ErrorsTelemetryModifier{}, &ebpftelemetry.LoadTelemetryModifier{Subsystem: "tracer"})
 	err := ddebpf.LoadCOREAsset(netebpf.ModuleFileName("tracer-fentry", config.BPFDebug), func(ar bytecode.AssetReader, o manager.Options) error {
 		o.RLimit = mgrOpts.RLimit
 		o.MapSpecEditors = mgrOpts.MapSpecEditors
@@ -71,6 +72,29 @@ func LoadTracer(config *config.Config, mgrOpts manager.Options, connCloseEventHa
 		if ringbufferEnabled {
 			util.EnableRingbuffersViaMapEditor(&mgrOpts)
 		}
+		// the map spec editors are shared with the kprobe tracer, which is loaded if this fails
+		editors := make(map[string]manager.MapSpecEditor, len(o.MapSpecEditors))
+		for name, editor := range o.MapSpecEditors {
+			editors[name] = editor
+		}
+		for _, name := range unusedMaps(enabledProbes) {
+			editors[name] = manager.MapSpecEditor{MaxEntries: 1, EditorFlag: manager.EditMaxEntries}
+		}
+		skStorageTuples, err := skStorageTuplesSupported()
+		if err != nil {
+			return fmt.Errorf("could not determine the kernel version: %w", err)
+		}
+		util.AddBoolConst(&o, "sk_storage_tuples_enabled", skStorageTuples)
+		if !skStorageTuples {
+			editors[sockTuplesMap] = manager.MapSpecEditor{
+				Type:       ebpf.Hash,
+				MaxEntries: 1,
+				EditorFlag: manager.EditType | manager.EditMaxEntries,
+			}
+		}
+		o.MapSpecEditors = editors
+		// the fentry tracer is always built to fold per-CPU connection stats
+		util.SetupPerCPUConnStats(m, &o, config, true)
 
 		// exclude all non-enabled probes to ensure we don't run into problems with unsupported probe types
 		for _, p := range m.Probes {
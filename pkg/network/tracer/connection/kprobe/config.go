@@ -60,6 +60,9 @@ func enabledProbes(c *config.Config, runtimeTracer, coreTracer bool) (map[probes
 		enableProbe(enabled, probes.TCPCloseFlushReturn)
 		enableProbe(enabled, probes.TCPConnect)
 		enableProbe(enabled, probes.TCPFinishConnect)
+		if c.TCPFailedConnectsEnabled && (runtimeTracer || coreTracer) {
+			enableProbe(enabled, probes.TCPDone)
+		}
 		enableProbe(enabled, probes.InetCskAcceptReturn)
 		enableProbe(enabled, probes.InetCskListenStop)
 		// special case for tcp_retransmit_skb probe: on CO-RE,
@@ -135,6 +138,22 @@ func enabledProbes(c *config.Config, runtimeTracer, coreTracer bool) (map[probes
 	return enabled, nil
 }
 
+// udpRecvMsgProbes tell the peeking receive calls apart for the skb_free_datagram_locked probes
+var udpRecvMsgProbes = []probes.ProbeFuncName{
+	probes.UDPRecvMsg,
+	probes.UDPRecvMsgPre5190,
+	probes.UDPRecvMsgPre470,
+	probes.UDPRecvMsgPre410,
+	probes.UDPRecvMsgReturn,
+	probes.UDPRecvMsgReturnPre470,
+	probes.UDPv6RecvMsg,
+	probes.UDPv6RecvMsgPre5190,
+	probes.UDPv6RecvMsgPre470,
+	probes.UDPv6RecvMsgPre410,
+	probes.UDPv6RecvMsgReturn,
+	probes.UDPv6RecvMsgReturnPre470,
+}
+
 func enableAdvancedUDP(enabled map[probes.ProbeFuncName]struct{}) error {
 	missing, err := ebpf.VerifyKernelFuncs("skb_consume_udp", "__skb_free_datagram_locked", "skb_free_datagram_locked")
 	if err != nil {
@@ -142,7 +161,11 @@ func enableAdvancedUDP(enabled map[probes.ProbeFuncName]struct{}) error {
 	}
 
 	if _, miss := missing["skb_consume_udp"]; !miss {
+		// skb_consume_udp is passed a negative length by peeking calls, the receive calls don't need to be traced
 		enableProbe(enabled, probes.SKBConsumeUDP)
+		for _, p := range udpRecvMsgProbes {
+			delete(enabled, p)
+		}
 	} else if _, miss := missing["__skb_free_datagram_locked"]; !miss {
 		enableProbe(enabled, probes.UnderscoredSKBFreeDatagramLocked)
 	} else if _, miss := missing["skb_free_datagram_locked"]; !miss {
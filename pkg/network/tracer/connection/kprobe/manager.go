@@ -35,6 +35,7 @@ var mainProbes = []probes.ProbeFuncName{
 	probes.TCPCloseFlushReturn,
 	probes.TCPConnect,
 	probes.TCPFinishConnect,
+	probes.TCPDone,
 	probes.IPMakeSkb,
 	probes.IPMakeSkbReturn,
 	probes.IP6MakeSkb,
@@ -174,7 +174,7 @@ func LoadTracer(cfg *config.Config, mgrOpts manager.Options, connCloseEventHandl
 }
 
 func loadTracerFromAsset(buf bytecode.AssetReader, runtimeTracer, coreTracer bool, config *config.Config, mgrOpts manager.Options, connCloseEventHandler ddebpf.EventHandler) (*manager.Manager, func(), error) {
-	m := ddebpf.NewManagerWithDefault(&manager.Manager{}, &ebpftelemetry.ErrorsTelemetryModifier{})
+	m := ddebpf.NewManagerWithDefault(&manager.Manager{}, &ebpftelemetry.ErrorsTelemetryModifier{}, &ebpftelemetry.LoadTelemetryModifier{Subsystem: "tracer"})
 	if err := initManager(m, connCloseEventHandler, runtimeTracer, config); err != nil {
 		return nil, nil, fmt.Errorf("could not initialize manager: %w", err)
 	}
@@ -187,6 +187,11 @@ func loadTracerFromAsset(buf bytecode.AssetReader, runtimeTracer, coreTracer boo
 	if ringbufferEnabled {
 		util.EnableRingbuffersViaMapEditor(&mgrOpts)
 	}
+	// the batch of closed connections is output from its map, which perf buffers only accept since 4.11
+	if kv, err := kernel.HostVersion(); err == nil {
+		util.AddBoolConst(&mgrOpts, "conn_close_batching_disabled", !ringbufferEnabled && kv < kernel.VersionCode(4, 11, 0))
+	}
+	util.SetupPerCPUConnStats(m, &mgrOpts, config, runtimeTracer && runtimeTracerFoldsPerCPUConnStats())
 
 	var undefinedProbes []manager.ProbeIdentificationPair
 
@@ -243,6 +248,13 @@ func loadTracerFromAsset(buf bytecode.AssetReader, runtimeTracer, coreTracer boo
 		}
 	}
 
+	if _, ok := enabledProbes[probes.SKBConsumeUDP]; ok {
+		// the receive calls aren't traced, see enableAdvancedUDP
+		for _, name := range []string{"udp_recv_sock", "udpv6_recv_sock"} {
+			mgrOpts.MapSpecEditors[name] = manager.MapSpecEditor{MaxEntries: 1, EditorFlag: manager.EditMaxEntries}
+		}
+	}
+
 	_, udpSendPageEnabled := enabledProbes[probes.UDPSendPage]
 	util.AddBoolConst(&mgrOpts, "udp_send_page_enabled", udpSendPageEnabled)
 
@@ -315,6 +327,16 @@ func loadPrebuiltTracer(config *config.Config, mgrOpts manager.Options, connClos
 	return tracerLoaderFromAsset(buf, false, false, config, mgrOpts, connCloseEventHandler)
 }
 
+// runtimeTracerFoldsPerCPUConnStats returns whether the runtime compiled tracer is built to fold per-CPU connection
+// stats, which depends on the version of the kernel headers it is compiled with
+func runtimeTracerFoldsPerCPUConnStats() bool {
+	kv, err := kernel.HostVersion()
+	if err != nil {
+		return false
+	}
+	return kv >= kernel.VersionCode(5, 19, 0)
+}
+
 func isCORETracerSupported() error {
 	kv, err := kernel.HostVersion()
 	if err != nil {
@@ -0,0 +1,163 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package connection
+
+import (
+	"fmt"
+
+	manager "github.com/DataDog/ebpf-manager"
+	"github.com/cilium/ebpf"
+
+	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
+	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
+	"github.com/DataDog/datadog-agent/pkg/network/ebpf/probes"
+)
+
+// perCPUConnStats reads the conn_stats and tcp_stats maps when they are per-CPU maps, see util.SetupPerCPUConnStats.
+// The per-CPU values are folded like fold_percpu_conn_stats in pkg/network/ebpf/c/tracer/stats.h does for closed
+// connections.
+type perCPUConnStats struct {
+	conns    *maps.GenericMap[netebpf.ConnTuple, []netebpf.ConnStats]
+	tcpStats *maps.GenericMap[netebpf.ConnTuple, []netebpf.TCPStats]
+
+	// per-CPU values of the last connection returned by the iterator, used to fold its TCP stats
+	connValues []netebpf.ConnStats
+	tcpValues  []netebpf.TCPStats
+}
+
+func newPerCPUConnStats(m *manager.Manager) (*perCPUConnStats, error) {
+	cpus, err := ebpf.PossibleCPU()
+	if err != nil {
+		return nil, fmt.Errorf("could not get the number of CPUs: %w", err)
+	}
+
+	p := &perCPUConnStats{
+		connValues: make([]netebpf.ConnStats, cpus),
+		tcpValues:  make([]netebpf.TCPStats, cpus),
+	}
+	if p.conns, err = maps.GetMap[netebpf.ConnTuple, []netebpf.ConnStats](m, probes.ConnMap); err != nil {
+		return nil, fmt.Errorf("error retrieving the bpf %s map: %s", probes.ConnMap, err)
+	}
+	if p.tcpStats, err = maps.GetMap[netebpf.ConnTuple, []netebpf.TCPStats](m, probes.TCPStatsMap); err != nil {
+		return nil, fmt.Errorf("error retrieving the bpf %s map: %s", probes.TCPStatsMap, err)
+	}
+	return p, nil
+}
+
+// Iterate returns an iterator over the conn_stats map returning the folded values
+func (p *perCPUConnStats) Iterate() maps.GenericMapIterator[netebpf.ConnTuple, netebpf.ConnStats] {
+	return &perCPUConnStatsIterator{it: p.conns.Iterate(), p: p}
+}
+
+// lookup reads the folded stats of a connection
+func (p *perCPUConnStats) lookup(tuple *netebpf.ConnTuple, stats *netebpf.ConnStats) bool {
+	if err := p.conns.Lookup(tuple, &p.connValues); err != nil {
+		return false
+	}
+	foldPerCPUConnStats(stats, p.connValues, tuple.Type() == netebpf.TCP)
+	return true
+}
+
+// getTCPStats reads the TCP stats of the last connection returned by the iterator or lookup
+func (p *perCPUConnStats) getTCPStats(stats *netebpf.TCPStats, tuple *netebpf.ConnTuple) bool {
+	if err := p.tcpStats.Lookup(tuple, &p.tcpValues); err != nil {
+		return false
+	}
+	foldPerCPUTCPStats(stats, p.tcpValues, p.connValues)
+	return true
+}
+
+type perCPUConnStatsIterator struct {
+	it maps.GenericMapIterator[netebpf.ConnTuple, []netebpf.ConnStats]
+	p  *perCPUConnStats
+}
+
+func (i *perCPUConnStatsIterator) Next(key *netebpf.ConnTuple, stats *netebpf.ConnStats) bool {
+	if !i.it.Next(key, &i.p.connValues) {
+		return false
+	}
+	foldPerCPUConnStats(stats, i.p.connValues, key.Type() == netebpf.TCP)
+	return true
+}
+
+func (i *perCPUConnStatsIterator) Err() error {
+	return i.it.Err()
+}
+
+// foldPerCPUConnStats folds the per-CPU values of a conn_stats entry.
+// Byte counters and UDP packet counters are incremented on each CPU and summed, while TCP packet counters are
+// absolute values read from the socket and the highest one wins. Only the CPU that created the entry has its
+// duration and cookie set.
+func foldPerCPUConnStats(stats *netebpf.ConnStats, values []netebpf.ConnStats, isTCP bool) {
+	*stats = netebpf.ConnStats{}
+	for i := range values {
+		v := &values[i]
+		stats.Sent_bytes += v.Sent_bytes
+		stats.Recv_bytes += v.Recv_bytes
+		if isTCP {
+			stats.Sent_packets = max(stats.Sent_packets, v.Sent_packets)
+			stats.Recv_packets = max(stats.Recv_packets, v.Recv_packets)
+		} else {
+			stats.Sent_packets += v.Sent_packets
+			stats.Recv_packets += v.Recv_packets
+		}
+		stats.Timestamp = max(stats.Timestamp, v.Timestamp)
+		if v.Duration > 0 && (stats.Duration == 0 || v.Duration < stats.Duration) {
+			stats.Duration = v.Duration
+		}
+		if stats.Cookie == 0 {
+			stats.Cookie = v.Cookie
+		}
+		if stats.Protocol_stack.Api == 0 {
+			stats.Protocol_stack.Api = v.Protocol_stack.Api
+		}
+		if stats.Protocol_stack.Application == 0 {
+			stats.Protocol_stack.Application = v.Protocol_stack.Application
+		}
+		if stats.Protocol_stack.Encryption == 0 {
+			stats.Protocol_stack.Encryption = v.Protocol_stack.Encryption
+		}
+		stats.Protocol_stack.Flags |= v.Protocol_stack.Flags
+		stats.Flags |= v.Flags
+		stats.Flow_count += v.Flow_count
+		// CONN_DIRECTION_UNKNOWN
+		if stats.Direction == 0 {
+			stats.Direction = v.Direction
+		}
+	}
+
+	// each CPU tracks its own handshake, traffic seen in both directions is enough once they are folded
+	if !isTCP && stats.Flags&uint8(netebpf.LInit) != 0 && stats.Flags&uint8(netebpf.RInit) != 0 {
+		stats.Flags |= uint8(netebpf.Assured)
+	}
+}
+
+// foldPerCPUTCPStats folds the per-CPU values of a tcp_stats entry. The RTT is the one of the CPU that updated the
+// connection last, according to the per-CPU values of its conn_stats entry.
+func foldPerCPUTCPStats(stats *netebpf.TCPStats, values []netebpf.TCPStats, conns []netebpf.ConnStats) {
+	*stats = netebpf.TCPStats{}
+	var rttTimestamp uint64
+	for i := range values {
+		v := &values[i]
+		stats.Retransmits += v.Retransmits
+		stats.State_transitions |= v.State_transitions
+		if v.Rtt == 0 {
+			continue
+		}
+
+		var timestamp uint64
+		if i < len(conns) {
+			timestamp = conns[i].Timestamp
+		}
+		if stats.Rtt == 0 || timestamp > rttTimestamp {
+			stats.Rtt = v.Rtt
+			stats.Rtt_var = v.Rtt_var
+			rttTimestamp = timestamp
+		}
+	}
+}
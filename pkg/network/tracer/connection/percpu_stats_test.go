@@ -0,0 +1,73 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package connection
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+
+	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
+)
+
+func TestFoldPerCPUConnStats(t *testing.T) {
+	t.Run("tcp", func(t *testing.T) {
+		values := []netebpf.ConnStats{
+			{Sent_bytes: 10, Recv_bytes: 20, Sent_packets: 3, Recv_packets: 4, Timestamp: 200, Duration: 100, Cookie: 42, Direction: uint8(netebpf.Outgoing)},
+			{},
+			{Sent_bytes: 5, Recv_bytes: 1, Sent_packets: 5, Recv_packets: 2, Timestamp: 300, Protocol_stack: netebpf.ProtocolStack{Application: 2}, Direction: uint8(netebpf.Outgoing)},
+		}
+
+		var stats netebpf.ConnStats
+		foldPerCPUConnStats(&stats, values, true)
+		assert.Equal(t, uint64(15), stats.Sent_bytes)
+		assert.Equal(t, uint64(21), stats.Recv_bytes)
+		// TCP packet counts are absolute
+		assert.Equal(t, uint32(5), stats.Sent_packets)
+		assert.Equal(t, uint32(4), stats.Recv_packets)
+		assert.Equal(t, uint64(300), stats.Timestamp)
+		assert.Equal(t, uint64(100), stats.Duration)
+		assert.Equal(t, uint32(42), stats.Cookie)
+		assert.Equal(t, uint8(2), stats.Protocol_stack.Application)
+		assert.Equal(t, netebpf.Outgoing, stats.ConnectionDirection())
+	})
+
+	t.Run("udp", func(t *testing.T) {
+		values := []netebpf.ConnStats{
+			{Sent_bytes: 10, Sent_packets: 1, Timestamp: 200, Duration: 100, Flags: uint8(netebpf.LInit), Flow_count: 1},
+			{Recv_bytes: 20, Recv_packets: 2, Timestamp: 100, Flags: uint8(netebpf.RInit), Direction: uint8(netebpf.Incoming), Flow_count: 2},
+		}
+
+		var stats netebpf.ConnStats
+		foldPerCPUConnStats(&stats, values, false)
+		assert.Equal(t, uint64(10), stats.Sent_bytes)
+		assert.Equal(t, uint64(20), stats.Recv_bytes)
+		assert.Equal(t, uint32(1), stats.Sent_packets)
+		assert.Equal(t, uint32(2), stats.Recv_packets)
+		assert.Equal(t, uint32(3), stats.Flow_count)
+		assert.True(t, stats.IsAssured())
+		assert.Equal(t, netebpf.Incoming, stats.ConnectionDirection())
+	})
+}
+
+func TestFoldPerCPUTCPStats(t *testing.T) {
+	conns := []netebpf.ConnStats{{Timestamp: 300}, {Timestamp: 100}, {}}
+	values := []netebpf.TCPStats{
+		{Rtt: 10, Rtt_var: 1, Retransmits: 2, State_transitions: 1 << netebpf.Established},
+		{Rtt: 20, Rtt_var: 2, Retransmits: 1},
+		{State_transitions: 1 << netebpf.Close},
+	}
+
+	var stats netebpf.TCPStats
+	foldPerCPUTCPStats(&stats, values, conns)
+	// the RTT of the CPU that updated the connection last wins
+	assert.Equal(t, uint32(10), stats.Rtt)
+	assert.Equal(t, uint32(1), stats.Rtt_var)
+	assert.Equal(t, uint32(3), stats.Retransmits)
+	assert.Equal(t, uint16(1<<netebpf.Established|1<<netebpf.Close), stats.State_transitions)
+}
@@ -30,8 +30,10 @@ const defaultExpiredStateInterval = 60 * time.Second
 // The motivation is to impose an upper limit on how long a TCP close connection
 // event remains stored in the eBPF map before being processed by the NetworkAgent.
 type perfBatchManager struct {
-	// eBPF
-	batchMap *maps.GenericMap[uint32, netebpf.Batch]
+	// eBPF, the batches are in percpuBatchMap instead of batchMap when it is a per-CPU array
+	batchMap       *maps.GenericMap[uint32, netebpf.Batch]
+	percpuBatchMap *maps.GenericMap[uint32, []netebpf.Batch]
+	batches        []netebpf.Batch
 
 	// stateByCPU contains the state of each batch.
 	// The slice is indexed by the CPU core number.
@@ -49,27 +51,51 @@ func newPerfBatchManager(batchMap *maps.GenericMap[uint32, netebpf.Batch], numCP
 		return nil, fmt.Errorf("batchMap is nil")
 	}
 
+	p := newBatchManagerState(numCPUs)
+	for cpu := uint32(0); cpu < numCPUs; cpu++ {
+		if err := batchMap.Put(&cpu, &p.batches[cpu]); err != nil {
+			return nil, fmt.Errorf("error initializing perf batch manager maps: %w", err)
+		}
+	}
+	p.batchMap = batchMap
+	return p, nil
+}
+
+// newPerCPUBatchManager returns a new `PerfBatchManager` and initializes the eBPF
+// per-CPU array that holds the tcp_close batch objects, see EnableRingbuffersViaMapEditor.
+func newPerCPUBatchManager(batchMap *maps.GenericMap[uint32, []netebpf.Batch], numCPUs uint32) (*perfBatchManager, error) {
+	if batchMap == nil {
+		return nil, fmt.Errorf("batchMap is nil")
+	}
+
+	p := newBatchManagerState(numCPUs)
+	var zero uint32
+	if err := batchMap.Put(&zero, &p.batches); err != nil {
+		return nil, fmt.Errorf("error initializing perf batch manager maps: %w", err)
+	}
+	p.percpuBatchMap = batchMap
+	return p, nil
+}
+
+func newBatchManagerState(numCPUs uint32) *perfBatchManager {
 	state := make([]percpuState, numCPUs)
+	batches := make([]netebpf.Batch, numCPUs)
 	for cpu := uint32(0); cpu < numCPUs; cpu++ {
-		b := new(netebpf.Batch)
 		// Ring buffer events don't have CPU information, so we associate each
 		// batch entry with a CPU during startup. This information is used by
 		// the code that does the batch offset tracking.
-		b.Cpu = cpu
-		if err := batchMap.Put(&cpu, b); err != nil {
-			return nil, fmt.Errorf("error initializing perf batch manager maps: %w", err)
-		}
+		batches[cpu].Cpu = cpu
 		state[cpu] = percpuState{
 			processed: make(map[uint64]batchState),
 		}
 	}
 
 	return &perfBatchManager{
-		batchMap:             batchMap,
+		batches:              batches,
 		stateByCPU:           state,
 		expiredStateInterval: defaultExpiredStateInterval,
 		ch:                   newCookieHasher(),
-	}, nil
+	}
 }
 
 // ExtractBatchInto extracts from the given batch all connections that haven't been processed yet.
@@ -94,13 +120,21 @@ func (p *perfBatchManager) ExtractBatchInto(buffer *network.ConnectionBuffer, b
 // It tracks which connections have been processed by this call, by batch id.
 // This prevents double-processing of connections between GetPendingConns and Extract.
 func (p *perfBatchManager) GetPendingConns(buffer *network.ConnectionBuffer) {
-	b := new(netebpf.Batch)
+	if p.percpuBatchMap != nil {
+		var zero uint32
+		if err := p.percpuBatchMap.Lookup(&zero, &p.batches); err != nil {
+			return
+		}
+	}
+
 	for cpu := uint32(0); cpu < uint32(len(p.stateByCPU)); cpu++ {
 		cpuState := &p.stateByCPU[cpu]
 
-		err := p.batchMap.Lookup(&cpu, b)
-		if err != nil {
-			continue
+		b := &p.batches[cpu]
+		if p.percpuBatchMap == nil {
+			if err := p.batchMap.Lookup(&cpu, b); err != nil {
+				continue
+			}
 		}
 
 		batchLen := b.Len
@@ -173,16 +207,22 @@ func (p *perfBatchManager) cleanupExpiredState(now time.Time) {
 }
 
 func newConnBatchManager(mgr *manager.Manager) (*perfBatchManager, error) {
-	connCloseMap, err := maps.GetMap[uint32, netebpf.Batch](mgr, probes.ConnCloseBatchMap)
-	if err != nil {
-		return nil, fmt.Errorf("unable to get map %s: %s", probes.ConnCloseBatchMap, err)
-	}
 	numCPUs, err := cebpf.PossibleCPU()
 	if err != nil {
 		return nil, fmt.Errorf("unable to get number of CPUs: %s", err)
 	}
+
+	if m, _, _ := mgr.GetMap(probes.ConnCloseBatchMap); m != nil && m.Type() == cebpf.PerCPUArray {
+		connCloseMap, err := maps.GetMap[uint32, []netebpf.Batch](mgr, probes.ConnCloseBatchMap)
+		if err != nil {
+			return nil, fmt.Errorf("unable to get map %s: %s", probes.ConnCloseBatchMap, err)
+		}
+		return newPerCPUBatchManager(connCloseMap, uint32(numCPUs))
+	}
+
+	connCloseMap, err := maps.GetMap[uint32, netebpf.Batch](mgr, probes.ConnCloseBatchMap)
 	if err != nil {
-		return nil, err
+		return nil, fmt.Errorf("unable to get map %s: %s", probes.ConnCloseBatchMap, err)
 	}
 	batchMgr, err := newPerfBatchManager(connCloseMap, uint32(numCPUs))
 	if err != nil {
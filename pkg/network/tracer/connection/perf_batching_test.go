@@ -126,6 +126,46 @@ func TestGetPendingConns(t *testing.T) {
 	assert.True(t, found, "could not find batched connection for pid %d", pidMax+3)
 }
 
+func TestGetPendingConnsPerCPU(t *testing.T) {
+	require.NoError(t, rlimit.RemoveMemlock())
+	numCPUs, err := ebpf.PossibleCPU()
+	require.NoError(t, err)
+	m, err := ebpf.NewMap(&ebpf.MapSpec{
+		Type:       ebpf.PerCPUArray,
+		KeySize:    4,
+		ValueSize:  netebpf.SizeofBatch,
+		MaxEntries: 1,
+	})
+	require.NoError(t, err)
+	t.Cleanup(func() { m.Close() })
+
+	gm, err := ebpfmaps.Map[uint32, []netebpf.Batch](m)
+	require.NoError(t, err)
+	manager, err := newPerCPUBatchManager(gm, uint32(numCPUs))
+	require.NoError(t, err)
+
+	batches := make([]netebpf.Batch, numCPUs)
+	cpu := numCPUs - 1
+	batches[cpu].Cpu = uint32(cpu)
+	batches[cpu].C0.Tup.Pid = pidMax + 1
+	batches[cpu].C1.Tup.Pid = pidMax + 2
+	batches[cpu].Len = 2
+	var zero uint32
+	require.NoError(t, gm.Put(&zero, &batches))
+
+	buffer := network.NewConnectionBuffer(256, 256)
+	manager.GetPendingConns(buffer)
+	pendingConns := buffer.Connections()
+	require.Len(t, pendingConns, 2)
+	assert.Equal(t, pidMax+1, pendingConns[0].Pid)
+	assert.Equal(t, pidMax+2, pendingConns[1].Pid)
+
+	// the connections were already processed
+	buffer.Reset()
+	manager.GetPendingConns(buffer)
+	assert.Empty(t, buffer.Connections())
+}
+
 func TestPerfBatchStateCleanup(t *testing.T) {
 	manager := newTestBatchManager(t)
 	manager.expiredStateInterval = 100 * time.Millisecond
@@ -12,6 +12,8 @@ import (
 	"time"
 	"unsafe"
 
+	"github.com/cilium/ebpf"
+
 	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/network"
 	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
@@ -22,6 +24,10 @@ import (
 
 const closeConsumerModuleName = "network_tracer__ebpf"
 
+// ringBufferFlushRecordSize is the size of the records without connection written by socket__conn_close_flush, see
+// RING_BUFFER_FLUSH_RECORD_SIZE
+const ringBufferFlushRecordSize = 8
+
 // Telemetry
 var closeConsumerTelemetry = struct {
 	perfReceived telemetry.Counter
@@ -39,12 +45,18 @@ type tcpCloseConsumer struct {
 	once         sync.Once
 	closed       chan struct{}
 	ch           *cookieHasher
+	// holds the connections sent without their trailing sections, see extractConn
+	partialConn netebpf.Conn
+	// flushProg wakes up the consumer of the closed connections waiting in the ring buffer below the wakeup
+	// watermark, nil when their wakeup isn't deferred
+	flushProg *ebpf.Program
 }
 
-func newTCPCloseConsumer(eventHandler ddebpf.EventHandler, batchManager *perfBatchManager) *tcpCloseConsumer {
+func newTCPCloseConsumer(eventHandler ddebpf.EventHandler, batchManager *perfBatchManager, flushProg *ebpf.Program) *tcpCloseConsumer {
 	return &tcpCloseConsumer{
 		eventHandler: eventHandler,
 		batchManager: batchManager,
+		flushProg:    flushProg,
 		requests:     make(chan chan struct{}),
 		buffer:       network.NewConnectionBuffer(netebpf.BatchSize, netebpf.BatchSize),
 		closed:       make(chan struct{}),
@@ -63,6 +75,8 @@ func (c *tcpCloseConsumer) FlushPending() {
 	default:
 	}
 
+	c.flushRingBuffer()
+
 	wait := make(chan struct{})
 	select {
 	case <-c.closed:
@@ -71,6 +85,18 @@ func (c *tcpCloseConsumer) FlushPending() {
 	}
 }
 
+// flushRingBuffer wakes up the consumer of the closed connections waiting in the ring buffer below the wakeup
+// watermark, so that they are reported by the next check at the latest rather than when a later connection is closed
+func (c *tcpCloseConsumer) flushRingBuffer() {
+	if c.flushProg == nil {
+		return
+	}
+	// the program is a socket filter, which needs at least an ethernet header worth of data to run
+	if _, err := c.flushProg.Run(&ebpf.RunOptions{Data: make([]byte, 14)}); err != nil {
+		log.Debugf("error flushing the closed connections ring buffer: %s", err)
+	}
+}
+
 func (c *tcpCloseConsumer) Stop() {
 	if c == nil {
 		return
@@ -81,8 +107,17 @@ func (c *tcpCloseConsumer) Stop() {
 	})
 }
 
+// extractConn decodes a connection sent on its own, whose sections are listed in its sections
+// field: the TCP section is left out when it isn't used, see conn_close_size in
+// pkg/network/ebpf/c/tracer/events.h. Perf buffer records are padded, the bytes after the
+// sections that are present are ignored.
 func (c *tcpCloseConsumer) extractConn(data []byte) {
 	ct := (*netebpf.Conn)(unsafe.Pointer(&data[0]))
+	if ct.Sections&uint32(netebpf.ConnSectionTCP) == 0 || len(data) < netebpf.SizeofConn {
+		c.partialConn = netebpf.Conn{}
+		copy(unsafe.Slice((*byte)(unsafe.Pointer(&c.partialConn)), netebpf.SizeofConn), data[:netebpf.SizeofConnNoTCP])
+		ct = &c.partialConn
+	}
 	conn := c.buffer.Next()
 	populateConnStats(conn, &ct.Tup, &ct.Conn_stats, c.ch)
 	updateTCPStats(conn, &ct.Tcp_stats, ct.Tcp_retransmits)
@@ -126,10 +161,14 @@ func (c *tcpCloseConsumer) Start(callback func([]network.ConnectionStats)) {
 				case l >= netebpf.SizeofBatch:
 					batch := netebpf.ToBatch(batchData.Data)
 					c.batchManager.ExtractBatchInto(c.buffer, batch)
-				case l >= netebpf.SizeofConn:
+				case l >= netebpf.SizeofConnNoTCP:
 					c.extractConn(batchData.Data)
+				case l == ringBufferFlushRecordSize:
+					// written by flushRingBuffer to wake us up, it holds no connection
+					batchData.Done()
+					continue
 				default:
-					log.Errorf("unknown type received from perf buffer, skipping. data size=%d, expecting %d or %d", len(batchData.Data), netebpf.SizeofConn, netebpf.SizeofBatch)
+					log.Errorf("unknown type received from perf buffer, skipping. data size=%d, expecting %d to %d or %d", len(batchData.Data), netebpf.SizeofConnNoTCP, netebpf.SizeofConn, netebpf.SizeofBatch)
 					continue
 				}
 
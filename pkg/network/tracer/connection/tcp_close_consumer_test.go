@@ -9,19 +9,67 @@ package connection
 
 import (
 	"testing"
+	"unsafe"
 
+	"github.com/stretchr/testify/assert"
 	"github.com/stretchr/testify/require"
 
 	"github.com/DataDog/datadog-agent/pkg/ebpf"
+	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
 )
 
 func TestTcpCloseConsumerStopRace(t *testing.T) {
 	pf := ebpf.NewPerfHandler(10)
 	require.NotNil(t, pf)
 
-	c := newTCPCloseConsumer(pf, nil)
+	c := newTCPCloseConsumer(pf, nil, nil)
 	require.NotNil(t, c)
 
 	c.Stop()
 	c.FlushPending()
 }
+
+func TestTcpCloseConsumerExtractConnSections(t *testing.T) {
+	c := newTCPCloseConsumer(ebpf.NewPerfHandler(10), nil, nil)
+	t.Cleanup(c.Stop)
+
+	t.Run("without TCP section", func(t *testing.T) {
+		// the bytes after the connection are perf buffer padding, which must be ignored
+		ct := netebpf.Conn{
+			Tup:             netebpf.ConnTuple{Sport: 1234, Dport: 53, Metadata: uint32(netebpf.UDP)},
+			Conn_stats:      netebpf.ConnStats{Sent_bytes: 42},
+			Tcp_retransmits: 7,
+			Tcp_stats:       netebpf.TCPStats{Rtt: 10},
+		}
+		data := unsafe.Slice((*byte)(unsafe.Pointer(&ct)), netebpf.SizeofConn)
+
+		c.buffer.Reset()
+		c.extractConn(data[:netebpf.SizeofConnNoTCP+4])
+		require.Equal(t, 1, c.buffer.Len())
+		conn := c.buffer.Connections()[0]
+		assert.Equal(t, uint16(1234), conn.SPort)
+		assert.Equal(t, uint64(42), conn.Monotonic.SentBytes)
+		assert.Zero(t, c.partialConn.Tcp_retransmits)
+		assert.Zero(t, c.partialConn.Tcp_stats.Rtt)
+	})
+
+	t.Run("with TCP section", func(t *testing.T) {
+		ct := netebpf.Conn{
+			Tup:             netebpf.ConnTuple{Sport: 1234, Dport: 80, Metadata: uint32(netebpf.TCP)},
+			Conn_stats:      netebpf.ConnStats{Sent_bytes: 42},
+			Sections:        uint32(netebpf.ConnSectionTCP),
+			Tcp_retransmits: 7,
+			Tcp_stats:       netebpf.TCPStats{Rtt: 10, Rtt_var: 2},
+		}
+		data := unsafe.Slice((*byte)(unsafe.Pointer(&ct)), netebpf.SizeofConn)
+
+		c.buffer.Reset()
+		c.extractConn(data)
+		require.Equal(t, 1, c.buffer.Len())
+		conn := c.buffer.Connections()[0]
+		assert.Equal(t, uint16(80), conn.DPort)
+		assert.Equal(t, uint32(7), conn.Monotonic.Retransmits)
+		assert.Equal(t, uint32(10), conn.RTT)
+		assert.Equal(t, uint32(2), conn.RTTVar)
+	})
+}
@@ -19,6 +19,7 @@ import (
 
 	"github.com/cihub/seelog"
 	"github.com/cilium/ebpf"
+	"github.com/cilium/ebpf/features"
 	"github.com/prometheus/client_golang/prometheus"
 	"github.com/twmb/murmur3"
 	"go.uber.org/atomic"
@@ -35,6 +36,7 @@ import (
 	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/network/ebpf/probes"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/tls"
 	"github.com/DataDog/datadog-agent/pkg/network/tracer/connection/fentry"
 	"github.com/DataDog/datadog-agent/pkg/network/tracer/connection/kprobe"
 	"github.com/DataDog/datadog-agent/pkg/process/util"
@@ -113,10 +115,11 @@ var ConnTracerTelemetry = struct {
 	//nolint:revive // TODO(NET) Fix revive linter
 	UdpSendsMissed *prometheus.Desc
 	//nolint:revive // TODO(NET) Fix revive linter
-	UdpDroppedConns *prometheus.Desc
-	PidCollisions   *telemetry.StatCounterWrapper
-	iterationDups   telemetry.Counter
-	iterationAborts telemetry.Counter
+	UdpDroppedConns      *prometheus.Desc
+	skbConnTupleMappings *prometheus.Desc
+	PidCollisions        *telemetry.StatCounterWrapper
+	iterationDups        telemetry.Counter
+	iterationAborts      telemetry.Counter
 
 	//nolint:revive // TODO(NET) Fix revive linter
 	lastTcpFailedConnects *atomic.Int64
@@ -131,7 +134,8 @@ var ConnTracerTelemetry = struct {
 	//nolint:revive // TODO(NET) Fix revive linter
 	lastUdpSendsMissed *atomic.Int64
 	//nolint:revive // TODO(NET) Fix revive linter
-	lastUdpDroppedConns *atomic.Int64
+	lastUdpDroppedConns      *atomic.Int64
+	lastSkbConnTupleMappings *atomic.Int64
 }{
 	telemetry.NewGauge(connTracerModuleName, "connections", []string{"ip_proto", "family"}, "Gauge measuring the number of active connections in the EBPF map"),
 	prometheus.NewDesc(connTracerModuleName+"__tcp_failed_connects", "Counter measuring the number of failed TCP connections in the EBPF map", nil, nil),
@@ -141,6 +145,7 @@ var ConnTracerTelemetry = struct {
 	prometheus.NewDesc(connTracerModuleName+"__udp_sends_processed", "Counter measuring the number of processed UDP sends in EBPF", nil, nil),
 	prometheus.NewDesc(connTracerModuleName+"__udp_sends_missed", "Counter measuring failures to process UDP sends in EBPF", nil, nil),
 	prometheus.NewDesc(connTracerModuleName+"__udp_dropped_conns", "Counter measuring the number of dropped UDP connections in the EBPF map", nil, nil),
+	prometheus.NewDesc(connTracerModuleName+"__skb_conn_tuple_mappings", "Counter measuring the number of socket to packet connection tuple mappings created in EBPF", nil, nil),
 	telemetry.NewStatCounterWrapper(connTracerModuleName, "pid_collisions", []string{}, "Counter measuring number of process collisions"),
 	telemetry.NewCounter(connTracerModuleName, "iteration_dups", []string{}, "Counter measuring the number of connections iterated more than once"),
 	telemetry.NewCounter(connTracerModuleName, "iteration_aborts", []string{}, "Counter measuring how many times ebpf iteration of connection map was aborted"),
@@ -151,6 +156,7 @@ var ConnTracerTelemetry = struct {
 	atomic.NewInt64(0),
 	atomic.NewInt64(0),
 	atomic.NewInt64(0),
+	atomic.NewInt64(0),
 }
 
 type tracer struct {
@@ -161,6 +167,15 @@ type tracer struct {
 	tcpRetransmits *maps.GenericMap[netebpf.ConnTuple, uint32]
 	config         *config.Config
 
+	// set when the RTT histograms of the TCP connections are collected
+	tcpRTTHist *maps.GenericMap[netebpf.ConnTuple, netebpf.TCPRTTHist]
+
+	// set instead of conns and tcpStats when they are per-CPU maps
+	perCPU *perCPUConnStats
+
+	// set when only the connections updated since the last poll are read
+	delta *deltaPoller
+
 	// tcp_close events
 	closeConsumer *tcpCloseConsumer
 
@@ -197,10 +212,21 @@ func NewTracer(config *config.Config) (Tracer, error) {
 			probes.UDPPortBindingsMap:                {MaxEntries: config.MaxTrackedConnections, EditorFlag: manager.EditMaxEntries},
 			probes.ConnectionProtocolMap:             {MaxEntries: config.MaxTrackedConnections, EditorFlag: manager.EditMaxEntries},
 			probes.ConnectionTupleToSocketSKBConnMap: {MaxEntries: config.MaxTrackedConnections, EditorFlag: manager.EditMaxEntries},
+			probes.TCPConnectSockPidMap:              {MaxEntries: config.MaxOngoingConnects, EditorFlag: manager.EditMaxEntries},
 		},
 		ConstantEditors: []manager.ConstantEditor{
 			boolConst("tcpv6_enabled", config.CollectTCPv6Conns),
 			boolConst("udpv6_enabled", config.CollectUDPv6Conns),
+			boolConst("udp_flow_aggregation_enabled", config.EnableUDPFlowAggregation),
+			boolConst("tcp_conn_aggregation_enabled", config.EnableTCPConnAggregation),
+			boolConst("conn_delta_polling_enabled", config.NPMDeltaPollingEnabled),
+			boolConst("tcp_stats_retransmits_enabled", config.TCPStatsRetransmitsEnabled),
+			boolConst("tcp_rtt_histogram_enabled", config.TCPRTTHistogramEnabled),
+			boolConst("tcp_failed_connections_enabled", config.TCPFailedConnectsEnabled),
+			boolConst("udp_tunnel_decap_enabled", config.UDPTunnelDecapEnabled),
+			boolConst("tls_handshake_tags_enabled", config.TLSHandshakeTagsEnabled),
+			{Name: "conn_sampling_rate", Value: config.NPMConnSamplingRate},
+			{Name: "ring_buffer_wakeup_watermark", Value: uint64(config.ClosedConnWakeupWatermark)},
 		},
 		VerifierOptions: ebpf.CollectionOptions{
 			Programs: ebpf.ProgramOptions{
@@ -210,6 +236,68 @@ func NewTracer(config *config.Config) (Tracer, error) {
 		DefaultKProbeMaxActive: maxActive,
 	}
 
+	if config.TCPStatsRetransmitsEnabled {
+		// the retransmits are counted in tcp_stats
+		mgrOptions.MapSpecEditors[probes.TCPRetransmitsMap] = manager.MapSpecEditor{MaxEntries: 1, EditorFlag: manager.EditMaxEntries}
+	}
+
+	if config.TCPRTTHistogramEnabled {
+		// the map only has a single entry otherwise
+		mgrOptions.MapSpecEditors[probes.TCPRTTHistMap] = manager.MapSpecEditor{MaxEntries: config.MaxTrackedConnections, EditorFlag: manager.EditMaxEntries}
+	}
+
+	if features.HaveMapType(ebpf.LRUHash) == nil {
+		// evict the oldest connects rather than losing the pid of the new ones when the map is full
+		editor := mgrOptions.MapSpecEditors[probes.TCPConnectSockPidMap]
+		editor.Type = ebpf.LRUHash
+		editor.EditorFlag |= manager.EditType
+		mgrOptions.MapSpecEditors[probes.TCPConnectSockPidMap] = editor
+
+		// evict the histograms of the closed connections missed by userspace rather than the new ones
+		editor = mgrOptions.MapSpecEditors[probes.TCPRTTHistMap]
+		editor.Type = ebpf.LRUHash
+		editor.EditorFlag |= manager.EditType
+		mgrOptions.MapSpecEditors[probes.TCPRTTHistMap] = editor
+	}
+
+	connMapsLRU := false
+	if config.ConnMapsLRUEnabled {
+		if err := features.HaveMapType(ebpf.LRUHash); err == nil {
+			// when full the least recently updated connections are evicted, the TCP ones are still reported when
+			// they close, without their stats, by fill_closed_conn
+			connMapsLRU = true
+			for _, name := range []string{probes.ConnMap, probes.TCPStatsMap} {
+				editor := mgrOptions.MapSpecEditors[name]
+				editor.Type = ebpf.LRUHash
+				editor.EditorFlag |= manager.EditType
+				mgrOptions.MapSpecEditors[name] = editor
+			}
+		} else {
+			log.Warnf("LRU connection maps disabled, LRU hash maps are not supported: %s", err)
+		}
+	}
+
+	if config.ConnMapsNoPrealloc && connMapsLRU {
+		log.Warn("conn_maps_no_prealloc is ignored, the LRU connection maps are always preallocated")
+	} else if config.ConnMapsNoPrealloc {
+		// the entries are allocated on insertion, this composes with the per-CPU type set by SetupPerCPUConnStats
+		for _, name := range []string{probes.ConnMap, probes.TCPStatsMap} {
+			editor := mgrOptions.MapSpecEditors[name]
+			editor.Flags = unix.BPF_F_NO_PREALLOC
+			editor.EditorFlag |= manager.EditFlags
+			mgrOptions.MapSpecEditors[name] = editor
+		}
+	}
+
+	if config.NPMDeltaPollingEnabled {
+		// one list of touched connections per CPU and parity of the poll epoch, see mark_conn_touched
+		mgrOptions.MapSpecEditors[probes.ConnTouchedMap] = manager.MapSpecEditor{
+			Type:       ebpf.PerCPUArray,
+			MaxEntries: 2,
+			EditorFlag: manager.EditType | manager.EditMaxEntries,
+		}
+	}
+
 	begin, end := network.EphemeralRange()
 	mgrOptions.ConstantEditors = append(mgrOptions.ConstantEditors,
 		manager.ConstantEditor{Name: "ephemeral_range_begin", Value: uint64(begin)},
@@ -253,7 +341,17 @@ func NewTracer(config *config.Config) (Tracer, error) {
 		return nil, fmt.Errorf("could not create connection batch manager: %w", err)
 	}
 
-	closeConsumer := newTCPCloseConsumer(connCloseEventHandler, batchMgr)
+	var flushProg *ebpf.Program
+	if config.RingBufferSupportedNPM() && config.ClosedConnWakeupWatermark > 0 {
+		// the wakeup of the closed connections is deferred, each check flushes the ones waiting in the ring buffer
+		progs, found, err := m.GetProgram(manager.ProbeIdentificationPair{EBPFFuncName: probes.ConnCloseFlush})
+		if err != nil || !found || len(progs) == 0 || progs[0] == nil {
+			return nil, fmt.Errorf("could not find the %s program: %v", probes.ConnCloseFlush, err)
+		}
+		flushProg = progs[0]
+	}
+
+	closeConsumer := newTCPCloseConsumer(connCloseEventHandler, batchMgr, flushProg)
 
 	tr := &tracer{
 		m:              m,
@@ -266,16 +364,23 @@ func NewTracer(config *config.Config) (Tracer, error) {
 		ch:             newCookieHasher(),
 	}
 
-	tr.conns, err = maps.GetMap[netebpf.ConnTuple, netebpf.ConnStats](m, probes.ConnMap)
-	if err != nil {
-		tr.Stop()
-		return nil, fmt.Errorf("error retrieving the bpf %s map: %s", probes.ConnMap, err)
-	}
+	if connMap, _, _ := m.GetMap(probes.ConnMap); connMap != nil && (connMap.Type() == ebpf.PerCPUHash || connMap.Type() == ebpf.LRUCPUHash) {
+		if tr.perCPU, err = newPerCPUConnStats(m); err != nil {
+			tr.Stop()
+			return nil, err
+		}
+	} else {
+		tr.conns, err = maps.GetMap[netebpf.ConnTuple, netebpf.ConnStats](m, probes.ConnMap)
+		if err != nil {
+			tr.Stop()
+			return nil, fmt.Errorf("error retrieving the bpf %s map: %s", probes.ConnMap, err)
+		}
 
-	tr.tcpStats, err = maps.GetMap[netebpf.ConnTuple, netebpf.TCPStats](m, probes.TCPStatsMap)
-	if err != nil {
-		tr.Stop()
-		return nil, fmt.Errorf("error retrieving the bpf %s map: %s", probes.TCPStatsMap, err)
+		tr.tcpStats, err = maps.GetMap[netebpf.ConnTuple, netebpf.TCPStats](m, probes.TCPStatsMap)
+		if err != nil {
+			tr.Stop()
+			return nil, fmt.Errorf("error retrieving the bpf %s map: %s", probes.TCPStatsMap, err)
+		}
 	}
 
 	if tr.tcpRetransmits, err = maps.GetMap[netebpf.ConnTuple, uint32](m, probes.TCPRetransmitsMap); err != nil {
@@ -283,6 +388,20 @@ func NewTracer(config *config.Config) (Tracer, error) {
 		return nil, fmt.Errorf("error retrieving the bpf %s map: %s", probes.TCPRetransmitsMap, err)
 	}
 
+	if config.TCPRTTHistogramEnabled {
+		if tr.tcpRTTHist, err = maps.GetMap[netebpf.ConnTuple, netebpf.TCPRTTHist](m, probes.TCPRTTHistMap); err != nil {
+			tr.Stop()
+			return nil, fmt.Errorf("error retrieving the bpf %s map: %s", probes.TCPRTTHistMap, err)
+		}
+	}
+
+	if config.NPMDeltaPollingEnabled {
+		if tr.delta, err = newDeltaPoller(m); err != nil {
+			tr.Stop()
+			return nil, err
+		}
+	}
+
 	return tr, nil
 }
 
@@ -314,6 +433,33 @@ func (t *tracer) Start(callback func([]network.ConnectionStats)) (err error) {
 		return fmt.Errorf("could not start ebpf manager: %s", err)
 	}
 
+	if t.delta != nil {
+		callback = t.delta.forgetClosed(callback)
+	}
+	if rate := t.config.NPMConnSamplingRate; rate > 1 {
+		closedCallback := callback
+		callback = func(conns []network.ConnectionStats) {
+			for i := range conns {
+				scaleSampledConn(&conns[i], rate)
+			}
+			closedCallback(conns)
+		}
+	}
+	if t.tcpRTTHist != nil {
+		// the kernel leaves the RTT histograms of the closed connections for us to read and delete
+		closedCallback := callback
+		tuple := new(netebpf.ConnTuple)
+		hist := new(netebpf.TCPRTTHist)
+		callback = func(conns []network.ConnectionStats) {
+			for i := range conns {
+				if conns[i].Type == network.TCP {
+					connTupleFromConn(tuple, &conns[i])
+					t.getRTTPercentiles(&conns[i], tuple, hist, true)
+				}
+			}
+			closedCallback(conns)
+		}
+	}
 	t.closeConsumer.Start(callback)
 	return nil
 }
@@ -361,6 +507,10 @@ func (t *tracer) GetMap(name string) *ebpf.Map {
 }
 
 func (t *tracer) GetConnections(buffer *network.ConnectionBuffer, filter func(*network.ConnectionStats) bool) error {
+	if t.delta != nil {
+		return t.getConnectionsDelta(buffer, filter)
+	}
+
 	// Iterate through all key-value pairs in map
 	key, stats := &netebpf.ConnTuple{}, &netebpf.ConnStats{}
 	seen := make(map[netebpf.ConnTuple]struct{})
@@ -374,9 +524,10 @@ func (t *tracer) GetConnections(buffer *network.ConnectionBuffer, filter func(*n
 	// Cached objects
 	conn := new(network.ConnectionStats)
 	tcp := new(netebpf.TCPStats)
+	hist := new(netebpf.TCPRTTHist)
 
-	var tcp4, tcp6, udp4, udp6 float64
-	entries := t.conns.Iterate()
+	var counts connCounts
+	entries := t.iterateConns()
 	for entries.Next(key, stats) {
 		if _, exists := connsByTuple[*key]; exists {
 			// already seen the connection in current batch processing,
@@ -387,33 +538,21 @@ func (t *tracer) GetConnections(buffer *network.ConnectionBuffer, filter func(*n
 
 		populateConnStats(conn, key, stats, t.ch)
 		connsByTuple[*key] = struct{}{}
-
-		isTCP := conn.Type == network.TCP
-		switch conn.Family {
-		case network.AFINET6:
-			if isTCP {
-				tcp6++
-			} else {
-				udp6++
-			}
-		case network.AFINET:
-			if isTCP {
-				tcp4++
-			} else {
-				udp4++
-			}
-		}
+		counts.add(conn)
 
 		if filter != nil && !filter(conn) {
 			continue
 		}
 
-		if t.getTCPStats(tcp, key) {
+		hasTCPStats := t.getTCPStats(tcp, key)
+		if hasTCPStats {
 			updateTCPStats(conn, tcp, 0)
 		}
-		if retrans, ok := t.getTCPRetransmits(key, seen); ok {
+		t.getRTTPercentiles(conn, key, hist, false)
+		if retrans, ok := t.getTCPRetransmits(key, tcp, hasTCPStats, seen); ok {
 			updateTCPStats(conn, nil, retrans)
 		}
+		scaleSampledConn(conn, t.config.NPMConnSamplingRate)
 
 		*buffer.Next() = *conn
 	}
@@ -427,11 +566,49 @@ func (t *tracer) GetConnections(buffer *network.ConnectionBuffer, filter func(*n
 		ConnTracerTelemetry.iterationAborts.Inc()
 	}
 
-	updateTelemetry(tcp4, tcp6, udp4, udp6)
+	updateTelemetry(counts.tcp4, counts.tcp6, counts.udp4, counts.udp6)
 
 	return nil
 }
 
+func (t *tracer) iterateConns() maps.GenericMapIterator[netebpf.ConnTuple, netebpf.ConnStats] {
+	if t.perCPU != nil {
+		return t.perCPU.Iterate()
+	}
+	return t.conns.Iterate()
+}
+
+// lookupConnStats reads the stats of a connection from the conn_stats map
+func (t *tracer) lookupConnStats(tuple *netebpf.ConnTuple, stats *netebpf.ConnStats) bool {
+	if t.perCPU != nil {
+		return t.perCPU.lookup(tuple, stats)
+	}
+	return t.conns.Lookup(tuple, stats) == nil
+}
+
+// connCounts counts the connections by protocol and family for the connections gauge
+type connCounts struct {
+	tcp4, tcp6, udp4, udp6 float64
+}
+
+func (c *connCounts) add(conn *network.ConnectionStats) {
+	isTCP := conn.Type == network.TCP
+	switch conn.Family {
+	case network.AFINET6:
+		if isTCP {
+			c.tcp6++
+		} else {
+			c.udp6++
+		}
+	case network.AFINET:
+		if isTCP {
+			c.tcp4++
+		} else {
+			c.udp4++
+		}
+	}
+}
+
 func updateTelemetry(tcp4 float64, tcp6 float64, udp4 float64, udp6 float64) {
 	ConnTracerTelemetry.connections.Set(tcp4, "tcp", "v4")
 	ConnTracerTelemetry.connections.Set(tcp6, "tcp", "v6")
@@ -457,26 +634,39 @@ func removeConnection(conn *network.ConnectionStats) {
 	}
 }
 
-func (t *tracer) Remove(conn *network.ConnectionStats) error {
-	t.removeTuple.Sport = conn.SPort
-	t.removeTuple.Dport = conn.DPort
-	t.removeTuple.Netns = conn.NetNS
-	t.removeTuple.Pid = conn.Pid
-	t.removeTuple.Saddr_l, t.removeTuple.Saddr_h = util.ToLowHigh(conn.Source)
-	t.removeTuple.Daddr_l, t.removeTuple.Daddr_h = util.ToLowHigh(conn.Dest)
+// connTupleFromConn sets the eBPF map key of a connection
+func connTupleFromConn(tuple *netebpf.ConnTuple, conn *network.ConnectionStats) {
+	tuple.Sport = conn.SPort
+	tuple.Dport = conn.DPort
+	tuple.Netns = conn.NetNS
+	tuple.Pid = conn.Pid
+	tuple.Saddr_l, tuple.Saddr_h = util.ToLowHigh(conn.Source)
+	tuple.Daddr_l, tuple.Daddr_h = util.ToLowHigh(conn.Dest)
 
 	if conn.Family == network.AFINET6 {
-		t.removeTuple.Metadata = uint32(netebpf.IPv6)
+		tuple.Metadata = uint32(netebpf.IPv6)
 	} else {
-		t.removeTuple.Metadata = uint32(netebpf.IPv4)
+		tuple.Metadata = uint32(netebpf.IPv4)
 	}
 	if conn.Type == network.TCP {
-		t.removeTuple.Metadata |= uint32(netebpf.TCP)
+		tuple.Metadata |= uint32(netebpf.TCP)
 	} else {
-		t.removeTuple.Metadata |= uint32(netebpf.UDP)
+		tuple.Metadata |= uint32(netebpf.UDP)
+	}
+}
+
+func (t *tracer) Remove(conn *network.ConnectionStats) error {
+	connTupleFromConn(t.removeTuple, conn)
+	if t.delta != nil {
+		t.delta.forget(t.removeTuple)
 	}
 
-	err := t.conns.Delete(t.removeTuple)
+	var err error
+	if t.perCPU != nil {
+		err = t.perCPU.conns.Delete(t.removeTuple)
+	} else {
+		err = t.conns.Delete(t.removeTuple)
+	}
 	if err != nil {
 		// If this entry no longer exists in the eBPF map it means `tcp_close` has executed
 		// during this function call. In that case state.StoreClosedConnection() was already called for this connection,
@@ -492,7 +682,14 @@ func (t *tracer) Remove(conn *network.ConnectionStats) error {
 	t.removeTuple.Pid = 0
 	if conn.Type == network.TCP {
 		// We can ignore the error for this map since it will not always contain the entry
-		_ = t.tcpStats.Delete(t.removeTuple)
+		if t.perCPU != nil {
+			_ = t.perCPU.tcpStats.Delete(t.removeTuple)
+		} else {
+			_ = t.tcpStats.Delete(t.removeTuple)
+		}
+		if t.tcpRTTHist != nil {
+			_ = t.tcpRTTHist.Delete(t.removeTuple)
+		}
 	}
 	return nil
 }
@@ -526,6 +723,7 @@ func (t *tracer) Describe(ch chan<- *prometheus.Desc) {
 	ch <- ConnTracerTelemetry.UdpSendsProcessed
 	ch <- ConnTracerTelemetry.UdpSendsMissed
 	ch <- ConnTracerTelemetry.UdpDroppedConns
+	ch <- ConnTracerTelemetry.skbConnTupleMappings
 }
 
 // Collect returns the current state of all metrics of the collector
@@ -561,6 +759,10 @@ func (t *tracer) Collect(ch chan<- prometheus.Metric) {
 	delta = int64(ebpfTelemetry.Udp_dropped_conns) - ConnTracerTelemetry.lastUdpDroppedConns.Load()
 	ConnTracerTelemetry.lastUdpDroppedConns.Store(int64(ebpfTelemetry.Udp_dropped_conns))
 	ch <- prometheus.MustNewConstMetric(ConnTracerTelemetry.UdpDroppedConns, prometheus.CounterValue, float64(delta))
+
+	delta = int64(ebpfTelemetry.Skb_conn_tuple_mappings) - ConnTracerTelemetry.lastSkbConnTupleMappings.Load()
+	ConnTracerTelemetry.lastSkbConnTupleMappings.Store(int64(ebpfTelemetry.Skb_conn_tuple_mappings))
+	ch <- prometheus.MustNewConstMetric(ConnTracerTelemetry.skbConnTupleMappings, prometheus.CounterValue, float64(delta))
 }
 
 // DumpMaps (for debugging purpose) returns all maps content by default or selected maps from maps parameter.
@@ -583,13 +785,8 @@ func initializePortBindingMaps(config *config.Config, m *manager.Manager) error
 	if err != nil {
 		return fmt.Errorf("failed to get TCP port binding map: %w", err)
 	}
-	for p, count := range tcpPorts {
-		log.Debugf("adding initial TCP port binding: netns: %d port: %d", p.Ino, p.Port)
-		pb := netebpf.PortBinding{Netns: p.Ino, Port: p.Port}
-		err = tcpPortMap.Update(&pb, &count, ebpf.UpdateNoExist)
-		if err != nil && !errors.Is(err, ebpf.ErrKeyExist) {
-			return fmt.Errorf("failed to update TCP port binding map: %w", err)
-		}
+	if err := loadPortBindings(tcpPortMap, tcpPorts); err != nil {
+		return fmt.Errorf("failed to update TCP port binding map: %w", err)
 	}
 
 	udpPorts, err := network.ReadInitialState(config.ProcRoot, network.UDP, config.CollectUDPv6Conns)
@@ -601,25 +798,58 @@ func initializePortBindingMaps(config *config.Config, m *manager.Manager) error
 	if err != nil {
 		return fmt.Errorf("failed to get UDP port binding map: %w", err)
 	}
-	for p, count := range udpPorts {
+	for p := range udpPorts {
 		// ignore ephemeral port binds as they are more likely to be from
 		// clients calling bind with port 0
 		if network.IsPortInEphemeralRange(network.AFINET, network.UDP, p.Port) == network.EphemeralTrue {
 			log.Debugf("ignoring initial ephemeral UDP port bind to %d", p)
-			continue
+			delete(udpPorts, p)
 		}
+	}
+	if err := loadPortBindings(udpPortMap, udpPorts); err != nil {
+		return fmt.Errorf("failed to update UDP port binding map: %w", err)
+	}
+	return nil
+}
+
+// loadPortBindings writes the initial port bindings to a port binding map, in a single batch update when
+// the kernel supports it. On nodes running many containers, each listening in its own netns, there can be
+// tens of thousands of them.
+func loadPortBindings(m *maps.GenericMap[netebpf.PortBinding, uint32], ports map[network.PortMapping]uint32) error {
+	if len(ports) == 0 {
+		return nil
+	}
 
-		log.Debugf("adding initial UDP port binding: netns: %d port: %d", p.Ino, p.Port)
+	if maps.BatchAPISupported() {
+		keys := make([]netebpf.PortBinding, 0, len(ports))
+		values := make([]uint32, 0, len(ports))
+		for p, count := range ports {
+			keys = append(keys, netebpf.PortBinding{Netns: p.Ino, Port: p.Port})
+			values = append(values, count)
+		}
+		// the programs aren't attached yet, the map is empty
+		if _, err := m.BatchUpdate(keys, values, nil); err == nil {
+			log.Debugf("added %d initial port bindings", len(keys))
+			return nil
+		} else if !errors.Is(err, ebpf.ErrNotSupported) {
+			return err
+		}
+	}
+
+	for p, count := range ports {
+		log.Debugf("adding initial port binding: netns: %d port: %d", p.Ino, p.Port)
 		pb := netebpf.PortBinding{Netns: p.Ino, Port: p.Port}
-		err = udpPortMap.Update(&pb, &count, ebpf.UpdateNoExist)
+		err := m.Update(&pb, &count, ebpf.UpdateNoExist)
 		if err != nil && !errors.Is(err, ebpf.ErrKeyExist) {
-			return fmt.Errorf("failed to update UDP port binding map: %w", err)
+			return err
 		}
 	}
 	return nil
 }
 
-func (t *tracer) getTCPRetransmits(tuple *netebpf.ConnTuple, seen map[netebpf.ConnTuple]struct{}) (uint32, bool) {
+// getTCPRetransmits reads the retransmits of a connection, from the TCP stats just read for it when they are
+// counted in tcp_stats
+func (t *tracer) getTCPRetransmits(tuple *netebpf.ConnTuple, tcpStats *netebpf.TCPStats, hasTCPStats bool, seen map[netebpf.ConnTuple]struct{}) (uint32, bool) {
 	if tuple.Type() != netebpf.TCP {
 		return 0, false
 	}
@@ -629,7 +859,13 @@ func (t *tracer) getTCPRetransmits(tuple *netebpf.ConnTuple, seen map[netebpf.Co
 	tuple.Pid = 0
 
 	var retransmits uint32
-	if err := t.tcpRetransmits.Lookup(tuple, &retransmits); err == nil {
+	var found bool
+	if t.config.TCPStatsRetransmitsEnabled {
+		retransmits, found = tcpStats.Retransmits, hasTCPStats
+	} else {
+		found = t.tcpRetransmits.Lookup(tuple, &retransmits) == nil
+	}
+	if found {
 		// This is required to avoid (over)reporting retransmits for connections sharing the same socket.
 		if _, reported := seen[*tuple]; reported {
 			ConnTracerTelemetry.PidCollisions.Inc()
@@ -649,9 +885,43 @@ func (t *tracer) getTCPStats(stats *netebpf.TCPStats, tuple *netebpf.ConnTuple)
 		return false
 	}
 
+	if t.config.TCPStatsRetransmitsEnabled {
+		// tcp_stats is keyed by the tuple without pid, like tcp_retransmits
+		pid := tuple.Pid
+		tuple.Pid = 0
+		defer func() { tuple.Pid = pid }()
+	}
+
+	if t.perCPU != nil {
+		return t.perCPU.getTCPStats(stats, tuple)
+	}
 	return t.tcpStats.Lookup(tuple, stats) == nil
 }
 
+// getRTTPercentiles sets the RTT percentiles of a TCP connection from its histogram, which is deleted
+// along when remove is set
+func (t *tracer) getRTTPercentiles(conn *network.ConnectionStats, tuple *netebpf.ConnTuple, hist *netebpf.TCPRTTHist, remove bool) {
+	if t.tcpRTTHist == nil || tuple.Type() != netebpf.TCP {
+		return
+	}
+
+	if t.config.TCPStatsRetransmitsEnabled {
+		// tcp_rtt_hist is keyed like tcp_stats
+		pid := tuple.Pid
+		tuple.Pid = 0
+		defer func() { tuple.Pid = pid }()
+	}
+
+	if err := t.tcpRTTHist.Lookup(tuple, hist); err != nil {
+		return
+	}
+	conn.RTTP50 = rttHistPercentile(&hist.Buckets, 0.5)
+	conn.RTTP99 = rttHistPercentile(&hist.Buckets, 0.99)
+	if remove {
+		_ = t.tcpRTTHist.Delete(tuple)
+	}
+}
+
 func populateConnStats(stats *network.ConnectionStats, t *netebpf.ConnTuple, s *netebpf.ConnStats, ch *cookieHasher) {
 	*stats = network.ConnectionStats{
 		Pid:    t.Pid,
@@ -680,6 +950,13 @@ func populateConnStats(stats *network.ConnectionStats, t *netebpf.ConnTuple, s *
 		Application: protocols.Application(s.Protocol_stack.Application),
 		Encryption:  protocols.Encryption(s.Protocol_stack.Encryption),
 	}
+	stats.TLSTags = tls.Tags{
+		ChosenVersion:   s.Tls_tags.Chosen_version,
+		CipherSuite:     s.Tls_tags.Cipher_suite,
+		OfferedVersions: s.Tls_tags.Offered_versions,
+		ALPNRequested:   s.Tls_tags.Alpn_requested,
+		ALPNChosen:      s.Tls_tags.Alpn_chosen,
+	}
 
 	if t.Type() == netebpf.TCP {
 		stats.Type = network.TCP
@@ -721,7 +998,56 @@ func updateTCPStats(conn *network.ConnectionStats, tcpStats *netebpf.TCPStats, r
 		conn.Monotonic.TCPClosed = uint32(tcpStats.State_transitions >> netebpf.Close & 1)
 		conn.RTT = tcpStats.Rtt
 		conn.RTTVar = tcpStats.Rtt_var
+		if tcpStats.Failed_connect_err != 0 {
+			conn.TCPFailures = map[uint16]uint32{tcpStats.Failed_connect_err: 1}
+		}
+	}
+}
+
+// scaleSampledConn scales the byte and packet counts of a connection tracked when only one connection out of rate is,
+// see conn_sampled in pkg/network/ebpf/c/tracer/stats.h
+func scaleSampledConn(conn *network.ConnectionStats, rate uint64) {
+	if rate <= 1 {
+		return
+	}
+	conn.Monotonic.SentBytes *= rate
+	conn.Monotonic.RecvBytes *= rate
+	conn.Monotonic.SentPackets *= rate
+	conn.Monotonic.RecvPackets *= rate
+}
+
+// rttHistMinShift must match TCP_RTT_HIST_MIN_SHIFT in pkg/network/ebpf/c/tracer/stats.h
+const rttHistMinShift = 6
+
+// rttHistBucketUpperBound returns the upper bound in µs of a bucket of the RTT histogram, see rtt_hist_bucket in
+// pkg/network/ebpf/c/tracer/stats.h. The last bucket isn't bounded, its lower bound is returned.
+func rttHistBucketUpperBound(bucket int) uint32 {
+	if bucket == netebpf.TCPRTTHistBuckets-1 {
+		return 1 << (bucket + rttHistMinShift - 1)
+	}
+	return 1 << (bucket + rttHistMinShift)
+}
+
+// rttHistPercentile returns the upper bound of the histogram bucket holding the percentile p of the RTT samples,
+// 0 if there aren't any
+func rttHistPercentile(hist *[netebpf.TCPRTTHistBuckets]uint32, p float64) uint32 {
+	var total uint64
+	for _, count := range hist {
+		total += uint64(count)
+	}
+	if total == 0 {
+		return 0
+	}
+
+	rank := uint64(math.Ceil(p * float64(total)))
+	var cumulative uint64
+	for i, count := range hist {
+		cumulative += uint64(count)
+		if cumulative >= rank {
+			return rttHistBucketUpperBound(i)
+		}
 	}
+	return rttHistBucketUpperBound(len(hist) - 1)
 }
 
 type cookieHasher struct {
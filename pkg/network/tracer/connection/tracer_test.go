@@ -0,0 +1,39 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package connection
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+
+	"github.com/DataDog/datadog-agent/pkg/network"
+	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
+)
+
+func TestRTTHistPercentile(t *testing.T) {
+	var hist [netebpf.TCPRTTHistBuckets]uint32
+	assert.Zero(t, rttHistPercentile(&hist, 0.5))
+
+	// 98 samples below 64µs, 1 in [128µs, 256µs) and 1 above 1s
+	hist[0] = 98
+	hist[2] = 1
+	hist[netebpf.TCPRTTHistBuckets-1] = 1
+	assert.Equal(t, uint32(64), rttHistPercentile(&hist, 0.5))
+	assert.Equal(t, uint32(256), rttHistPercentile(&hist, 0.99))
+	assert.Equal(t, uint32(1<<20), rttHistPercentile(&hist, 1))
+}
+
+func TestScaleSampledConn(t *testing.T) {
+	conn := network.ConnectionStats{Monotonic: network.StatCounters{SentBytes: 10, RecvBytes: 20, SentPackets: 1, RecvPackets: 2, Retransmits: 3}}
+	scaleSampledConn(&conn, 1)
+	assert.Equal(t, uint64(10), conn.Monotonic.SentBytes)
+
+	scaleSampledConn(&conn, 8)
+	assert.Equal(t, network.StatCounters{SentBytes: 80, RecvBytes: 160, SentPackets: 8, RecvPackets: 16, Retransmits: 3}, conn.Monotonic)
+}
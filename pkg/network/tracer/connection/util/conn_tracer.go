@@ -15,6 +15,7 @@ import (
 	manager "github.com/DataDog/ebpf-manager"
 	cebpf "github.com/cilium/ebpf"
 	"github.com/cilium/ebpf/asm"
+	"github.com/cilium/ebpf/features"
 
 	"github.com/DataDog/datadog-agent/pkg/ebpf"
 	ebpftelemetry "github.com/DataDog/datadog-agent/pkg/ebpf/telemetry"
@@ -23,6 +24,9 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/util/log"
 )
 
+// maxPerCPUConnStatsCPUs must match PERCPU_CONN_STATS_MAX_CPUS in pkg/network/ebpf/c/tracer/stats.h
+const maxPerCPUConnStatsCPUs = 512
+
 // toPowerOf2 converts a number to its nearest power of 2
 func toPowerOf2(x int) int {
 	log2 := math.Log2(float64(x))
@@ -45,7 +49,8 @@ func computeDefaultClosedConnPerfBufferSize() int {
 	return 8 * os.Getpagesize()
 }
 
-// EnableRingbuffersViaMapEditor sets up the ring buffer for closed connection events via a map editor
+// EnableRingbuffersViaMapEditor sets up the ring buffer for closed connection events, and the per-CPU batches
+// used when it is full, via map editors
 func EnableRingbuffersViaMapEditor(mgrOpts *manager.Options) {
 	mgrOpts.MapSpecEditors[probes.ConnCloseEventMap] = manager.MapSpecEditor{
 		Type:       cebpf.RingBuf,
@@ -54,6 +59,17 @@ func EnableRingbuffersViaMapEditor(mgrOpts *manager.Options) {
 		ValueSize:  0,
 		EditorFlag: manager.EditType | manager.EditMaxEntries | manager.EditKeyValue,
 	}
+	// closed connections are only batched when the ring buffer is full, with a batch per CPU
+	mgrOpts.MapSpecEditors[probes.ConnCloseBatchMap] = manager.MapSpecEditor{
+		Type:       cebpf.PerCPUArray,
+		MaxEntries: 1,
+		EditorFlag: manager.EditType | manager.EditMaxEntries,
+	}
+	// the time of the last wakeup of the consumer is kept per CPU, see ring_buffer_flags
+	mgrOpts.MapSpecEditors[probes.RingBufferLastWakeupMap] = manager.MapSpecEditor{
+		Type:       cebpf.PerCPUArray,
+		EditorFlag: manager.EditType,
+	}
 }
 
 // SetupClosedConnHandler sets up the closed connection event handler
@@ -88,7 +104,7 @@ func SetupClosedConnHandler(connCloseEventHandler ebpf.EventHandler, mgr *ebpf.M
 		}
 		mgr.PerfMaps = []*manager.PerfMap{pm}
 		ebpftelemetry.ReportPerfMapTelemetry(pm)
-		helperCallRemover := ebpf.NewHelperCallRemover(asm.FnRingbufOutput)
+		helperCallRemover := ebpf.NewHelperCallRemover(asm.FnRingbufOutput, asm.FnRingbufReserve, asm.FnRingbufSubmit, asm.FnRingbufDiscard, asm.FnRingbufQuery)
 		err := helperCallRemover.BeforeInit(mgr.Manager, nil)
 		if err != nil {
 			log.Error("Failed to remove helper calls from eBPF programs: ", err)
@@ -96,6 +112,68 @@ func SetupClosedConnHandler(connCloseEventHandler ebpf.EventHandler, mgr *ebpf.M
 	}
 }
 
+// SetupPerCPUConnStats turns the conn_stats and tcp_stats maps into per-CPU maps if this is enabled and supported
+// by the kernel. folded tells whether the tracer was built to fold the per-CPU values of closed connections, see
+// PERCPU_CONN_STATS_SUPPORTED in pkg/network/ebpf/c/tracer/maps.h
+func SetupPerCPUConnStats(mgr *ebpf.Manager, mgrOpts *manager.Options, cfg *config.Config, folded bool) {
+	cpus := 0
+	if folded && cfg.NPMPerCPUConnStatsEnabled {
+		cpus = perCPUConnStatsCPUs()
+	}
+	mgrOpts.ConstantEditors = append(mgrOpts.ConstantEditors, manager.ConstantEditor{
+		Name:  "percpu_conn_stats_cpus",
+		Value: uint64(cpus),
+	})
+
+	if cpus == 0 {
+		if folded {
+			// the helper is only called with per-CPU conn stats, but kernels that don't know it reject the programs
+			helperCallRemover := ebpf.NewHelperCallRemover(asm.FnMapLookupPercpuElem)
+			if err := helperCallRemover.BeforeInit(mgr.Manager, nil); err != nil {
+				log.Error("Failed to remove helper calls from eBPF programs: ", err)
+			}
+		}
+		return
+	}
+
+	// the editors are shared with the tracers we fall back to, which may not fold per-CPU values
+	editors := make(map[string]manager.MapSpecEditor, len(mgrOpts.MapSpecEditors))
+	for name, editor := range mgrOpts.MapSpecEditors {
+		editors[name] = editor
+	}
+	for _, name := range []string{probes.ConnMap, probes.TCPStatsMap} {
+		editor := editors[name]
+		// keep the LRU eviction of the maps set up by ConnMapsLRUEnabled
+		if editor.Type == cebpf.LRUHash {
+			editor.Type = cebpf.LRUCPUHash
+		} else {
+			editor.Type = cebpf.PerCPUHash
+		}
+		editor.EditorFlag |= manager.EditType
+		editors[name] = editor
+	}
+	mgrOpts.MapSpecEditors = editors
+	log.Infof("per-CPU connection stats enabled for %d CPUs", cpus)
+}
+
+// perCPUConnStatsCPUs returns the number of CPUs to keep connection stats for, 0 if per-CPU stats aren't supported
+func perCPUConnStatsCPUs() int {
+	if err := features.HaveProgramHelper(cebpf.Kprobe, asm.FnMapLookupPercpuElem); err != nil {
+		log.Warnf("per-CPU connection stats disabled, bpf_map_lookup_percpu_elem is not supported: %s", err)
+		return 0
+	}
+	cpus, err := cebpf.PossibleCPU()
+	if err != nil {
+		log.Warnf("per-CPU connection stats disabled, could not get the number of CPUs: %s", err)
+		return 0
+	}
+	if cpus > maxPerCPUConnStatsCPUs {
+		log.Warnf("per-CPU connection stats disabled, %d CPUs is more than the supported %d", cpus, maxPerCPUConnStatsCPUs)
+		return 0
+	}
+	return cpus
+}
+
 // AddBoolConst modifies the options to include a constant editor for a boolean value
 func AddBoolConst(options *manager.Options, name string, flag bool) {
 	val := uint64(1)
@@ -181,7 +181,12 @@ func (e *ebpfConntracker) dumpInitialTables(ctx context.Context, cfg *config.Con
 	}
 	defer e.consumer.Stop()
 
-	for _, family := range []uint8{unix.AF_INET, unix.AF_INET6} {
+	families := []uint8{unix.AF_INET}
+	// the IPv6 entries aren't stored by the probes when IPv6 isn't collected, there's no need to dump them
+	if cfg.CollectTCPv6Conns || cfg.CollectUDPv6Conns {
+		families = append(families, unix.AF_INET6)
+	}
+	for _, family := range families {
 		done, err := e.consumer.DumpAndDiscardTable(family)
 		if err != nil {
 			return err
@@ -448,10 +453,13 @@ func getManager(cfg *config.Config, buf io.ReaderAt, opts manager.Options) (*man
 	}
 	opts.VerifierOptions.Programs.LogSize = 10 * 1024 * 1024
 
+	// with an LRU map, the least recently used translations are evicted instead of the new ones being dropped
+	// when the map is full, on NAT gateways tracking more connections than ConntrackMaxStateSize
 	if err := features.HaveMapType(ebpf.LRUHash); err == nil {
 		me := opts.MapSpecEditors[probes.ConntrackMap]
 		me.Type = ebpf.LRUHash
 		me.EditorFlag |= manager.EditType
+		opts.MapSpecEditors[probes.ConntrackMap] = me
 	}
 
 	err = mgr.InitWithOptions(buf, &opts)
@@ -0,0 +1,130 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package offsetguess
+
+import (
+	"fmt"
+	"strings"
+
+	manager "github.com/DataDog/ebpf-manager"
+	"github.com/cilium/ebpf/btf"
+
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+)
+
+// btfOffset is a constant of the prebuilt tracer resolved from the kernel BTF, the offset of the first of the
+// member paths found in the struct
+type btfOffset struct {
+	constant   string
+	structName string
+	paths      [][]string
+}
+
+var tracerBTFOffsets = []btfOffset{
+	{"offset_saddr", "sock", [][]string{{"__sk_common", "skc_rcv_saddr"}}},
+	{"offset_daddr", "sock", [][]string{{"__sk_common", "skc_daddr"}}},
+	{"offset_sport", "inet_sock", [][]string{{"inet_sport"}}},
+	{"offset_dport", "sock", [][]string{{"__sk_common", "skc_dport"}}},
+	{"offset_netns", "sock", [][]string{{"__sk_common", "skc_net"}}},
+	// ns_common was introduced in 3.19
+	{"offset_ino", "net", [][]string{{"ns", "inum"}, {"proc_inum"}}},
+	{"offset_family", "sock", [][]string{{"__sk_common", "skc_family"}}},
+	{"offset_rtt", "tcp_sock", [][]string{{"srtt_us"}}},
+	{"offset_rtt_var", "tcp_sock", [][]string{{"mdev_us"}}},
+	{"offset_daddr_ipv6", "sock", [][]string{{"__sk_common", "skc_v6_daddr"}}},
+	{"offset_saddr_fl4", "flowi4", [][]string{{"saddr"}}},
+	{"offset_daddr_fl4", "flowi4", [][]string{{"daddr"}}},
+	{"offset_sport_fl4", "flowi4", [][]string{{"uli", "ports", "sport"}}},
+	{"offset_dport_fl4", "flowi4", [][]string{{"uli", "ports", "dport"}}},
+	{"offset_saddr_fl6", "flowi6", [][]string{{"saddr"}}},
+	{"offset_daddr_fl6", "flowi6", [][]string{{"daddr"}}},
+	{"offset_sport_fl6", "flowi6", [][]string{{"uli", "ports", "sport"}}},
+	{"offset_dport_fl6", "flowi6", [][]string{{"uli", "ports", "dport"}}},
+	{"offset_socket_sk", "socket", [][]string{{"sk"}}},
+	{"offset_sk_buff_sock", "sk_buff", [][]string{{"sk"}}},
+	{"offset_sk_buff_transport_header", "sk_buff", [][]string{{"transport_header"}}},
+	{"offset_sk_buff_head", "sk_buff", [][]string{{"head"}}},
+}
+
+// btfTracerOffsets returns the constant editors of the prebuilt tracer, like the offset guesser does, with the
+// offsets read from the kernel BTF. It fails if any of the offsets isn't found.
+func btfTracerOffsets(spec *btf.Spec, cfg *config.Config) ([]manager.ConstantEditor, error) {
+	editors := make([]manager.ConstantEditor, 0, len(tracerBTFOffsets)+4)
+	for _, o := range tracerBTFOffsets {
+		offset, err := btfStructOffset(spec, o.structName, o.paths)
+		if err != nil {
+			return nil, fmt.Errorf("%s: %w", o.constant, err)
+		}
+		editors = append(editors, manager.ConstantEditor{Name: o.constant, Value: offset})
+	}
+
+	tcpv6, udpv6 := getIpv6Configuration(cfg)
+	return append(editors,
+		manager.ConstantEditor{Name: "fl4_offsets", Value: uint64(enabled)},
+		manager.ConstantEditor{Name: "fl6_offsets", Value: uint64(enabled)},
+		manager.ConstantEditor{Name: "tcpv6_enabled", Value: boolToUint64(tcpv6)},
+		manager.ConstantEditor{Name: "udpv6_enabled", Value: boolToUint64(udpv6)},
+	), nil
+}
+
+// btfStructOffset returns the offset in bytes of the first of the member paths found in the struct
+func btfStructOffset(spec *btf.Spec, name string, paths [][]string) (uint64, error) {
+	var s *btf.Struct
+	if err := spec.TypeByName(name, &s); err != nil {
+		return 0, fmt.Errorf("could not find struct %s: %w", name, err)
+	}
+
+	for _, path := range paths {
+		if offset, ok := btfMemberOffset(s, path); ok {
+			return offset, nil
+		}
+	}
+	return 0, fmt.Errorf("could not find %s in struct %s", strings.Join(paths[0], "."), name)
+}
+
+// btfMemberOffset returns the offset in bytes of a member path in a struct or union. The members of the
+// anonymous structs and unions are looked up as if they were members of their parent, like in C.
+func btfMemberOffset(typ btf.Type, path []string) (uint64, bool) {
+	var offset uint64
+	for _, name := range path {
+		member, memberOffset, ok := btfFindMember(typ, name)
+		if !ok {
+			return 0, false
+		}
+		offset += memberOffset
+		typ = btf.UnderlyingType(member.Type)
+	}
+	return offset, true
+}
+
+func btfFindMember(typ btf.Type, name string) (*btf.Member, uint64, bool) {
+	var members []btf.Member
+	switch t := typ.(type) {
+	case *btf.Struct:
+		members = t.Members
+	case *btf.Union:
+		members = t.Members
+	default:
+		return nil, 0, false
+	}
+
+	for i := range members {
+		if members[i].Name == name {
+			return &members[i], uint64(members[i].Offset.Bytes()), true
+		}
+	}
+	for i := range members {
+		if members[i].Name != "" {
+			continue
+		}
+		if member, offset, ok := btfFindMember(btf.UnderlyingType(members[i].Type), name); ok {
+			return member, uint64(members[i].Offset.Bytes()) + offset, true
+		}
+	}
+	return nil, 0, false
+}
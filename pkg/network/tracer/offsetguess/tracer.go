@@ -27,6 +27,7 @@ import (
 	manager "github.com/DataDog/ebpf-manager"
 
 	"github.com/DataDog/datadog-agent/pkg/collector/corechecks/ebpf/probe/ebpfcheck"
+	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
 	"github.com/DataDog/datadog-agent/pkg/network/config"
 	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
@@ -1128,6 +1129,16 @@ func (o *tracerOffsets) Offsets(cfg *config.Config) ([]manager.ConstantEditor, e
 		return o.offsets, o.err
 	}
 
+	spec, err := ddebpf.GetBTF()
+	if err == nil {
+		o.offsets, err = btfTracerOffsets(spec, cfg)
+	}
+	if err == nil {
+		log.Info("tracer offsets resolved from BTF")
+		return o.offsets, nil
+	}
+	log.Warnf("could not resolve the tracer offsets from BTF, guessing them: %s", err)
+
 	offsetBuf, err := netebpf.ReadOffsetBPFModule(cfg.BPFDir, cfg.BPFDebug)
 	if err != nil {
 		o.err = fmt.Errorf("could not read offset bpf module: %s", err)
@@ -213,6 +213,10 @@ func newTracer(cfg *config.Config) (_ *Tracer, reterr error) {
 		cfg.MaxHTTPStatsBuffered,
 		cfg.MaxKafkaStatsBuffered,
 		cfg.MaxPostgresStatsBuffered,
+		cfg.MaxRedisStatsBuffered,
+		cfg.MaxAMQPStatsBuffered,
+		cfg.MaxMySQLStatsBuffered,
+		cfg.MaxMongoStatsBuffered,
 		cfg.EnableNPMConnectionRollup,
 		cfg.EnableProcessEventMonitoring,
 	)
@@ -423,6 +427,11 @@ func (t *Tracer) GetActiveConnections(clientID string) (*network.Connections, er
 	conns.HTTP2 = delta.HTTP2
 	conns.Kafka = delta.Kafka
 	conns.Postgres = delta.Postgres
+	conns.Redis = delta.Redis
+	conns.AMQP = delta.AMQP
+	conns.MySQL = delta.MySQL
+	conns.Mongo = delta.Mongo
+	conns.GRPC = delta.GRPC
 	conns.ConnTelemetry = t.state.GetTelemetryDelta(clientID, t.getConnTelemetry(len(active)))
 	conns.CompilationTelemetryByAsset = t.getRuntimeCompilationTelemetry()
 	conns.KernelHeaderFetchResult = int32(kernel.HeaderProvider.GetResult())
@@ -744,9 +753,10 @@ func (t *Tracer) connectionExpired(conn *network.ConnectionStats, latestTime uin
 		return false
 	}
 
-	// skip connection check for udp connections or if
-	// the pid for the connection is dead
-	if conn.Type == network.UDP || !procutil.PidExists(int(conn.Pid)) {
+	// skip connection check for udp connections, tcp connections aggregated
+	// by the tracer, which conntrack doesn't know, or if the pid for the
+	// connection is dead
+	if conn.Type == network.UDP || conn.SPort == 0 || !procutil.PidExists(int(conn.Pid)) {
 		return true
 	}
 
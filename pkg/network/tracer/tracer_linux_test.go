@@ -1860,6 +1860,47 @@ func (s *TracerSuite) TestPreexistingConnectionDirection() {
 	assert.Equal(t, network.INCOMING, incoming.Direction)
 }
 
+func (s *TracerSuite) TestClosedConnWakeupWatermark() {
+	t := s.T()
+	if features.HaveMapType(ebpf.RingBuf) != nil {
+		t.Skip("skipping test as ringbuffers are not supported on this kernel")
+	}
+	cfg := testConfig()
+	cfg.NPMRingbuffersEnabled = true
+	// no closed connection reaches the watermark, they are only delivered by the wakeups of the CPUs and the flushes
+	cfg.ClosedConnWakeupWatermark = 1 << 20
+	tr := setupTracer(t, cfg)
+
+	server := NewTCPServer(func(c net.Conn) {
+		c.Close()
+	})
+	t.Cleanup(server.Shutdown)
+	require.NoError(t, server.Run())
+
+	// the first closed connection of a CPU wakes up the consumer, the next ones wait below the watermark
+	var clients []net.Conn
+	for i := 0; i < 5; i++ {
+		c, err := net.DialTimeout("tcp", server.address, 2*time.Second)
+		require.NoError(t, err)
+		clients = append(clients, c)
+	}
+	for _, c := range clients {
+		require.NoError(t, c.Close())
+	}
+
+	// each check flushes the closed connections waiting in the ring buffer
+	found := make(map[string]struct{}, len(clients))
+	require.Eventually(t, func() bool {
+		connections := getConnections(t, tr)
+		for _, c := range clients {
+			if _, ok := findConnection(c.LocalAddr(), c.RemoteAddr(), connections); ok {
+				found[c.LocalAddr().String()] = struct{}{}
+			}
+		}
+		return len(found) == len(clients)
+	}, 3*time.Second, 100*time.Millisecond, "could not find the closed connections")
+}
+
 func (s *TracerSuite) TestPreexistingEmptyIncomingConnectionDirection() {
 	t := s.T()
 	t.Run("ringbuf_enabled", func(t *testing.T) {
@@ -82,6 +82,10 @@ func NewTracer(config *config.Config) (*Tracer, error) {
 		config.MaxHTTPStatsBuffered,
 		config.MaxKafkaStatsBuffered,
 		config.MaxPostgresStatsBuffered,
+		config.MaxRedisStatsBuffered,
+		config.MaxAMQPStatsBuffered,
+		config.MaxMySQLStatsBuffered,
+		config.MaxMongoStatsBuffered,
 		config.EnableNPMConnectionRollup,
 		config.EnableProcessEventMonitoring,
 	)
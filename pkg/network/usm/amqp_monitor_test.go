@@ -0,0 +1,110 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package usm
+
+import (
+	"fmt"
+	"net"
+	"reflect"
+	"testing"
+	"time"
+
+	"github.com/stretchr/testify/require"
+	"github.com/stretchr/testify/suite"
+
+	"github.com/DataDog/datadog-agent/pkg/ebpf/ebpftest"
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/amqp"
+)
+
+const (
+	amqpPort      = "5672"
+	amqpQueueName = "usm-test"
+)
+
+type amqpProtocolParsingSuite struct {
+	suite.Suite
+}
+
+func TestAMQPMonitoring(t *testing.T) {
+	skipTestIfKernelNotSupported(t)
+
+	ebpftest.TestBuildModes(t, []ebpftest.BuildMode{ebpftest.Prebuilt, ebpftest.RuntimeCompiled, ebpftest.CORE}, "", func(t *testing.T) {
+		suite.Run(t, new(amqpProtocolParsingSuite))
+	})
+}
+
+func (s *amqpProtocolParsingSuite) TestLoadAMQPBinary() {
+	t := s.T()
+	for name, debug := range map[string]bool{"enabled": true, "disabled": false} {
+		t.Run(name, func(t *testing.T) {
+			cfg := getAMQPDefaultTestConfiguration()
+			cfg.BPFDebug = debug
+			setupUSMTLSMonitor(t, cfg)
+		})
+	}
+}
+
+func (s *amqpProtocolParsingSuite) TestPublishAndDeliver() {
+	t := s.T()
+
+	serverHost := "127.0.0.1"
+	require.NoError(t, amqp.RunServer(t, serverHost, amqpPort, amqp.Plaintext))
+
+	// Declare the queue before the monitor starts, so only the messages are captured.
+	client, err := amqp.NewClient(amqp.Options{ServerAddress: net.JoinHostPort(serverHost, amqpPort)})
+	require.NoError(t, err)
+	t.Cleanup(func() {
+		require.NoError(t, client.DeleteQueues())
+		client.Terminate()
+	})
+	require.NoError(t, client.DeclareQueue(amqpQueueName, client.PublishChannel))
+	require.NoError(t, client.DeclareQueue(amqpQueueName, client.ConsumeChannel))
+
+	monitor := setupUSMTLSMonitor(t, getAMQPDefaultTestConfiguration())
+
+	const messages = 10
+	for i := 0; i < messages; i++ {
+		require.NoError(t, client.Publish(amqpQueueName, fmt.Sprintf("message-%d", i)))
+	}
+	received, err := client.Consume(amqpQueueName, messages)
+	require.NoError(t, err)
+	require.Len(t, received, messages)
+
+	// Messages published on the default exchange have an empty exchange name.
+	validateAMQP(t, monitor, map[amqp.Method]int{
+		amqp.PublishMethod: messages,
+		amqp.DeliverMethod: messages,
+	})
+}
+
+func getAMQPDefaultTestConfiguration() *config.Config {
+	cfg := config.New()
+	cfg.EnableAMQPMonitoring = true
+	cfg.MaxTrackedConnections = 1000
+	return cfg
+}
+
+func validateAMQP(t *testing.T, monitor *Monitor, expectedStats map[amqp.Method]int) {
+	found := make(map[amqp.Method]int)
+	require.Eventually(t, func() bool {
+		amqpProtocolStats, exists := monitor.GetProtocolStats()[protocols.AMQP]
+		if !exists {
+			return false
+		}
+		currentStats := amqpProtocolStats.(map[amqp.Key]*amqp.RequestStat)
+		for key, stats := range currentStats {
+			if key.Exchange != "" || (key.DstPort != 5672 && key.SrcPort != 5672) {
+				continue
+			}
+			found[key.Method] += stats.Count
+		}
+		return reflect.DeepEqual(expectedStats, found)
+	}, time.Second*5, time.Millisecond*100, "Expected to find %v stats, instead captured %v", &expectedStats, &found)
+}
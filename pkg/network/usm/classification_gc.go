@@ -0,0 +1,30 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package usm
+
+import (
+	"github.com/cilium/ebpf"
+	"github.com/cilium/ebpf/asm"
+	"github.com/cilium/ebpf/features"
+)
+
+const (
+	classificationGCMap   = "classification_gc"
+	classificationGCProbe = "tracepoint__net__netif_receive_skb_classification_gc"
+)
+
+// classificationGCSupported returns true if the kernel has the bpf_timer and bpf_for_each_map_elem helpers (5.15+),
+// letting the classification maps be expired in the kernel rather than by the userspace map cleaner.
+func classificationGCSupported() bool {
+	for _, helper := range []asm.BuiltinFunc{asm.FnTimerInit, asm.FnForEachMapElem} {
+		if err := features.HaveProgramHelper(ebpf.TracePoint, helper); err != nil {
+			return false
+		}
+	}
+	return true
+}
@@ -0,0 +1,158 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package usm
+
+import (
+	"strconv"
+	"time"
+
+	manager "github.com/DataDog/ebpf-manager"
+	"github.com/cilium/ebpf"
+
+	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	libtelemetry "github.com/DataDog/datadog-agent/pkg/network/protocols/telemetry"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
+)
+
+const (
+	cpuCostMap      = "usm_cpu_cost"
+	cpuCostStartMap = "usm_cpu_cost_start"
+
+	// cpuCostProtocols is the number of histograms per encryption, see USM_CPU_COST_PROTOCOLS
+	cpuCostProtocols = 16
+	// cpuCostBuckets is the number of log2 buckets of a histogram, see USM_CPU_COST_BUCKETS
+	cpuCostBuckets = 24
+)
+
+// applicationProtocolNames maps the number of the decoded protocols within the application layer of protocol_t to their
+// name, see pkg/network/ebpf/c/protocols/classification/defs.h
+var applicationProtocolNames = map[int]string{
+	1: "http",
+	2: "http2",
+	3: "kafka",
+	4: "mongo",
+	5: "postgres",
+	6: "amqp",
+	7: "redis",
+	8: "mysql",
+}
+
+// cpuCostHistogram mirrors usm_cpu_cost_histogram_t: bucket i counts the durations in [2^i, 2^(i+1)) nanoseconds.
+type cpuCostHistogram struct {
+	Buckets [cpuCostBuckets]uint64
+}
+
+// cpuCostTelemetry reports the time spent by the protocol decoders in the kernel, as counters tagged by protocol,
+// encryption and bucket.
+type cpuCostTelemetry struct {
+	// metricGroup holds the counters below
+	metricGroup *libtelemetry.MetricGroup
+
+	// buckets Count of decoder runs per histogram index and duration bucket, nil for the protocols not decoded.
+	buckets [2 * cpuCostProtocols][cpuCostBuckets]*libtelemetry.Counter
+
+	// lastState represents the latest histograms observed from the kernel, summed over the CPUs
+	lastState [2 * cpuCostProtocols]cpuCostHistogram
+
+	stopChannel chan struct{}
+}
+
+func newCPUCostTelemetry() *cpuCostTelemetry {
+	metricGroup := libtelemetry.NewMetricGroup("usm.cpu_cost", libtelemetry.OptPrometheus)
+	t := &cpuCostTelemetry{
+		metricGroup: metricGroup,
+		stopChannel: make(chan struct{}),
+	}
+
+	for number, name := range applicationProtocolNames {
+		for _, tls := range []bool{false, true} {
+			index := cpuCostIndex(number, tls)
+			for bucket := range t.buckets[index] {
+				t.buckets[index][bucket] = metricGroup.NewCounter(
+					"duration_bucket_"+strconv.Itoa(bucket),
+					"protocol:"+name,
+					"tls:"+strconv.FormatBool(tls),
+				)
+			}
+		}
+	}
+
+	return t
+}
+
+// cpuCostIndex returns the index of the histogram of a protocol in the usm_cpu_cost map.
+func cpuCostIndex(number int, tls bool) int {
+	if tls {
+		return number + cpuCostProtocols
+	}
+	return number
+}
+
+// update adds the delta between the given histograms and the last seen ones to the counters.
+func (t *cpuCostTelemetry) update(histograms *[2 * cpuCostProtocols]cpuCostHistogram) {
+	for index := range histograms {
+		for bucket, counter := range t.buckets[index] {
+			if counter == nil {
+				continue
+			}
+			counter.Add(int64(histograms[index].Buckets[bucket] - t.lastState[index].Buckets[bucket]))
+		}
+	}
+	t.lastState = *histograms
+}
+
+// readCPUCost sums the per-CPU histograms of the kernel map.
+func readCPUCost(mp *ebpf.Map, histograms *[2 * cpuCostProtocols]cpuCostHistogram) error {
+	var perCPU []cpuCostHistogram
+	for index := range histograms {
+		key := uint32(index)
+		if err := mp.Lookup(&key, &perCPU); err != nil {
+			return err
+		}
+		histograms[index] = cpuCostHistogram{}
+		for _, histogram := range perCPU {
+			for bucket, count := range histogram.Buckets {
+				histograms[index].Buckets[bucket] += count
+			}
+		}
+	}
+	return nil
+}
+
+// start polls the kernel histograms until stop is called.
+func (t *cpuCostTelemetry) start(mgr *manager.Manager) {
+	mp, err := protocols.GetMap(mgr, cpuCostMap)
+	if err != nil {
+		log.Warn(err)
+		return
+	}
+
+	histograms := &[2 * cpuCostProtocols]cpuCostHistogram{}
+	ticker := time.NewTicker(30 * time.Second)
+
+	go func() {
+		defer ticker.Stop()
+
+		for {
+			select {
+			case <-ticker.C:
+				if err := readCPUCost(mp, histograms); err != nil {
+					log.Errorf("unable to lookup %q map: %s", cpuCostMap, err)
+					return
+				}
+				t.update(histograms)
+			case <-t.stopChannel:
+				return
+			}
+		}
+	}()
+}
+
+func (t *cpuCostTelemetry) stop() {
+	close(t.stopChannel)
+}
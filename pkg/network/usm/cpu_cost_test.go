@@ -0,0 +1,36 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package usm
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+)
+
+func TestCPUCostTelemetryUpdate(t *testing.T) {
+	tel := newCPUCostTelemetry()
+	httpIndex := cpuCostIndex(1, false)
+	kafkaTLSIndex := cpuCostIndex(3, true)
+
+	histograms := &[2 * cpuCostProtocols]cpuCostHistogram{}
+	histograms[httpIndex].Buckets[10] = 5
+	histograms[kafkaTLSIndex].Buckets[12] = 2
+	tel.update(histograms)
+	assert.Equal(t, int64(5), tel.buckets[httpIndex][10].Get())
+	assert.Equal(t, int64(2), tel.buckets[kafkaTLSIndex][12].Get())
+
+	// Only the delta with the last seen histograms is added.
+	histograms[httpIndex].Buckets[10] = 8
+	tel.update(histograms)
+	assert.Equal(t, int64(8), tel.buckets[httpIndex][10].Get())
+	assert.Equal(t, int64(2), tel.buckets[kafkaTLSIndex][12].Get())
+
+	// The histograms of the protocols without decoder have no counters.
+	assert.Nil(t, tel.buckets[cpuCostIndex(4, false)][0])
+}
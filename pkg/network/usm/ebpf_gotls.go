@@ -42,6 +42,7 @@ import (
 
 const (
 	offsetsDataMap            = "offsets_data"
+	offsetsDataKeysMap        = "go_tls_offsets_data_keys"
 	goTLSReadArgsMap          = "go_tls_read_args"
 	goTLSWriteArgsMap         = "go_tls_write_args"
 	connectionTupleByGoTLSMap = "conn_tup_by_go_tls_conn"
@@ -60,16 +61,21 @@ const (
 type uprobesInfo struct {
 	functionInfo string
 	returnInfo   string
+	// argsReadOnReturn is set when the return probes read the arguments themselves if the binary uses the stack
+	// ABI, in which case the entry probe isn't attached.
+	argsReadOnReturn bool
 }
 
 var functionToProbes = map[string]uprobesInfo{
 	bininspect.ReadGoTLSFunc: {
-		functionInfo: connReadProbe,
-		returnInfo:   connReadRetProbe,
+		functionInfo:     connReadProbe,
+		returnInfo:       connReadRetProbe,
+		argsReadOnReturn: true,
 	},
 	bininspect.WriteGoTLSFunc: {
-		functionInfo: connWriteProbe,
-		returnInfo:   connWriteRetProbe,
+		functionInfo:     connWriteProbe,
+		returnInfo:       connWriteRetProbe,
+		argsReadOnReturn: true,
 	},
 	bininspect.CloseGoTLSFunc: {
 		functionInfo: connCloseProbe,
@@ -115,6 +121,10 @@ type goTLSProgram struct {
 	// inodes.
 	offsetsDataMap *ebpf.Map
 
+	// eBPF map caching the offsets_data key of the binary of each process,
+	// indexed by pid.
+	offsetsDataKeysMap *ebpf.Map
+
 	// binAnalysisMetric handles telemetry on the time spent doing binary
 	// analysis
 	binAnalysisMetric *libtelemetry.Counter
@@ -128,6 +138,7 @@ var _ utils.Attacher = &goTLSProgram{}
 var goTLSSpec = &protocols.ProtocolSpec{
 	Maps: []*manager.Map{
 		{Name: offsetsDataMap},
+		{Name: offsetsDataKeysMap},
 		{Name: goTLSReadArgsMap},
 		{Name: goTLSWriteArgsMap},
 		{Name: connectionTupleByGoTLSMap},
@@ -213,6 +224,11 @@ func (p *goTLSProgram) PreStart(m *manager.Manager) error {
 		return fmt.Errorf("could not get offsets_data map: %s", err)
 	}
 
+	p.offsetsDataKeysMap, _, err = m.GetMap(offsetsDataKeysMap)
+	if err != nil {
+		return fmt.Errorf("could not get %s map: %s", offsetsDataKeysMap, err)
+	}
+
 	procMonitor := monitor.GetProcessMonitor()
 	cleanupExec := procMonitor.SubscribeExec(p.handleProcessStart)
 	cleanupExit := procMonitor.SubscribeExit(p.handleProcessExit)
@@ -385,6 +401,9 @@ func registerCBCreator(mgr *manager.Manager, offsetsDataMap *ebpf.Map, probeIDs
 
 func (p *goTLSProgram) handleProcessExit(pid pid) {
 	_ = p.DetachPID(pid)
+	// the key is validated against the mm of the process, drop it before a
+	// new process gets the pid
+	_ = p.offsetsDataKeysMap.Delete(unsafe.Pointer(&pid))
 }
 
 func (p *goTLSProgram) handleProcessStart(pid pid) {
@@ -451,7 +470,9 @@ func attachHooks(mgr *manager.Manager, result *bininspect.Result, binPath string
 			}
 		}
 
-		if uprobes.functionInfo != "" {
+		// With the stack ABI, the arguments are still in the caller's frame when the return probes are hit, so
+		// they don't need to be saved by the entry probe.
+		if uprobes.functionInfo != "" && !(uprobes.argsReadOnReturn && result.ABI == bininspect.GoABIStack) {
 			probeID := manager.ProbeIdentificationPair{
 				EBPFFuncName: uprobes.functionInfo,
 				UID:          uid,
@@ -38,12 +38,14 @@ const (
 	javaTLSConnectionsMap       = "java_tls_connections"
 	javaDomainsToConnectionsMap = "java_conn_tuple_by_peer"
 	eRPCHandlersMap             = "java_tls_erpc_handlers"
+	eRPCDataMap                 = "java_tls_erpc_data"
 
 	doVfsIoctlKprobeName             = "kprobe__do_vfs_ioctl"
 	handleSyncPayloadKprobeName      = "kprobe_handle_sync_payload"
 	handleCloseConnectionKprobeName  = "kprobe_handle_close_connection"
 	handleConnectionByPeerKprobeName = "kprobe_handle_connection_by_peer"
 	handleAsyncPayloadKprobeName     = "kprobe_handle_async_payload"
+	handleBatchKprobeName            = "kprobe_handle_batch"
 )
 
 const (
@@ -55,6 +57,8 @@ const (
 	connectionByPeer
 	// asyncPayload is the key to the program that handles the ASYNC_PAYLOAD eRPC operation
 	asyncPayload
+	// batch is the key to the program that handles the BATCH eRPC operation
+	batch
 )
 
 var (
@@ -92,6 +96,9 @@ var javaTLSSpec = &protocols.ProtocolSpec{
 		{
 			Name: eRPCHandlersMap,
 		},
+		{
+			Name: eRPCDataMap,
+		},
 	},
 	Probes: []*manager.Probe{
 		{
@@ -130,6 +137,13 @@ var javaTLSSpec = &protocols.ProtocolSpec{
 				EBPFFuncName: handleAsyncPayloadKprobeName,
 			},
 		},
+		{
+			ProgArrayName: eRPCHandlersMap,
+			Key:           batch,
+			ProbeIdentificationPair: manager.ProbeIdentificationPair{
+				EBPFFuncName: handleBatchKprobeName,
+			},
+		},
 	},
 }
 
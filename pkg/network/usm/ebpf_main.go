@@ -30,10 +30,14 @@ import (
 	netebpf "github.com/DataDog/datadog-agent/pkg/network/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/network/ebpf/probes"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/amqp"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/http"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/http2"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/kafka"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/mongo"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/mysql"
 	"github.com/DataDog/datadog-agent/pkg/network/protocols/postgres"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/redis"
 	"github.com/DataDog/datadog-agent/pkg/network/tracer/offsetguess"
 	"github.com/DataDog/datadog-agent/pkg/network/usm/buildmode"
 	"github.com/DataDog/datadog-agent/pkg/network/usm/utils"
@@ -49,6 +53,10 @@ var (
 		http2.Spec,
 		kafka.Spec,
 		postgres.Spec,
+		redis.Spec,
+		amqp.Spec,
+		mysql.Spec,
+		mongo.Spec,
 		javaTLSSpec,
 		// opensslSpec is unique, as we're modifying its factory during runtime to allow getting more parameters in the
 		// factory.
@@ -61,13 +69,13 @@ const (
 	// ELF section of the BPF_PROG_TYPE_SOCKET_FILTER program used
 	// to classify protocols and dispatch the correct handlers.
 	protocolDispatcherSocketFilterFunction = "socket__protocol_dispatcher"
-	connectionStatesMap                    = "connection_states"
 	sockFDLookupArgsMap                    = "sockfd_lookup_args"
 	tupleByPidFDMap                        = "tuple_by_pid_fd"
 	pidFDByTupleMap                        = "pid_fd_by_tuple"
 
 	sockFDLookup    = "kprobe__sockfd_lookup_light"
 	sockFDLookupRet = "kretprobe__sockfd_lookup_light"
+	sockFDClose     = "tracepoint__syscalls__sys_enter_close"
 
 	tcpCloseProbe = "kprobe__tcp_close"
 
@@ -84,6 +92,11 @@ type ebpfProgram struct {
 	cfg                   *config.Config
 	tailCallRouter        []manager.TailCallRoute
 	connectionProtocolMap *ebpf.Map
+	filter                *usmFilter
+	cpuCost               *cpuCostTelemetry
+
+	// classificationGC is true when the classification maps are expired in the kernel, see classificationGCSupported
+	classificationGC bool
 
 	enabledProtocols  []*protocols.ProtocolSpec
 	disabledProtocols []*protocols.ProtocolSpec
@@ -100,10 +113,15 @@ func newEBPFProgram(c *config.Config, connectionProtocolMap *ebpf.Map) (*ebpfPro
 			{Name: protocols.ProtocolDispatcherProgramsMap},
 			{Name: protocols.ProtocolDispatcherClassificationPrograms},
 			{Name: protocols.TLSProtocolDispatcherClassificationPrograms},
-			{Name: connectionStatesMap},
 			{Name: sockFDLookupArgsMap},
 			{Name: tupleByPidFDMap},
 			{Name: pidFDByTupleMap},
+			{Name: usmPortFilterMap},
+			{Name: usmCgroupFilterMap},
+			{Name: usmCgroupProtosMap},
+			{Name: cpuCostMap},
+			{Name: cpuCostStartMap},
+			{Name: classificationGCMap},
 		},
 		Probes: []*manager.Probe{
 			{
@@ -149,14 +167,38 @@ func newEBPFProgram(c *config.Config, connectionProtocolMap *ebpf.Map) (*ebpfPro
 						UID:          probeUID,
 					},
 				},
+				{
+					ProbeIdentificationPair: manager.ProbeIdentificationPair{
+						EBPFFuncName: sockFDClose,
+						UID:          probeUID,
+					},
+				},
 			}...)
 		}
 	}
 
+	classificationGC := classificationGCSupported()
+	if classificationGC {
+		mgr.Probes = append(mgr.Probes, &manager.Probe{
+			ProbeIdentificationPair: manager.ProbeIdentificationPair{
+				EBPFFuncName: classificationGCProbe,
+				UID:          probeUID,
+			},
+		})
+	}
+
+	filter := newUSMFilter(c)
+	modifiers := append([]ddebpf.Modifier{&ebpftelemetry.ErrorsTelemetryModifier{}}, filter.modifiers()...)
+	modifiers = append(modifiers, &ebpftelemetry.LoadTelemetryModifier{Subsystem: "usm"})
 	program := &ebpfProgram{
-		Manager:               ddebpf.NewManager(mgr, &ebpftelemetry.ErrorsTelemetryModifier{}),
+		Manager:               ddebpf.NewManager(mgr, modifiers...),
 		cfg:                   c,
 		connectionProtocolMap: connectionProtocolMap,
+		filter:                filter,
+		classificationGC:      classificationGC,
+	}
+	if c.EnableUSMCPUCostTelemetry {
+		program.cpuCost = newCPUCostTelemetry()
 	}
 
 	opensslSpec.Factory = newSSLProgramProtocolFactory(mgr)
@@ -214,6 +256,9 @@ func (e *ebpfProgram) Init() error {
 // Start starts the ebpf program and the enabled protocols.
 func (e *ebpfProgram) Start() error {
 	initializeTupleMaps(e.Manager)
+	if err := e.filter.populate(e.Manager.Manager); err != nil {
+		return err
+	}
 
 	// Mainly for tests, but possible for other cases as well, we might have a nil (not shared) connection protocol map
 	// between NPM and USM. In such a case we just create our own instance, but we don't modify the
@@ -225,11 +270,14 @@ func (e *ebpfProgram) Start() error {
 		}
 		e.connectionProtocolMap = m
 	}
-	mapCleaner, err := e.setupMapCleaner()
-	if err != nil {
-		log.Errorf("error creating map cleaner: %s", err)
-	} else {
-		e.mapCleaner = mapCleaner
+	// The kernel expires the connection_protocol entries itself when it supports it
+	if !e.classificationGC {
+		mapCleaner, err := e.setupMapCleaner()
+		if err != nil {
+			log.Errorf("error creating map cleaner: %s", err)
+		} else {
+			e.mapCleaner = mapCleaner
+		}
 	}
 
 	e.enabledProtocols = e.executePerProtocol(e.enabledProtocols, "pre-start",
@@ -241,7 +289,7 @@ func (e *ebpfProgram) Start() error {
 		return errNoProtocols
 	}
 
-	err = e.Manager.Start()
+	err := e.Manager.Start()
 	if err != nil {
 		return err
 	}
@@ -261,6 +309,10 @@ func (e *ebpfProgram) Start() error {
 		return errNoProtocols
 	}
 
+	if e.cpuCost != nil {
+		e.cpuCost.start(e.Manager.Manager)
+	}
+
 	for _, protocolName := range e.enabledProtocols {
 		log.Infof("enabled USM protocol: %s", protocolName.Instance.Name())
 	}
@@ -271,6 +323,9 @@ func (e *ebpfProgram) Start() error {
 // Close stops the ebpf program and cleans up all resources.
 func (e *ebpfProgram) Close() error {
 	e.mapCleaner.Stop()
+	if e.cpuCost != nil {
+		e.cpuCost.stop()
+	}
 	stopProtocolWrapper := func(protocol protocols.Protocol, m *manager.Manager) error {
 		protocol.Stop(m)
 		return nil
@@ -383,10 +438,6 @@ func (e *ebpfProgram) init(buf bytecode.AssetReader, options manager.Options) er
 	}
 
 	options.MapSpecEditors = map[string]manager.MapSpecEditor{
-		connectionStatesMap: {
-			MaxEntries: e.cfg.MaxTrackedConnections,
-			EditorFlag: manager.EditMaxEntries,
-		},
 		probes.ConnectionProtocolMap: {
 			MaxEntries: e.cfg.MaxTrackedConnections,
 			EditorFlag: manager.EditMaxEntries,
@@ -411,7 +462,14 @@ func (e *ebpfProgram) init(buf bytecode.AssetReader, options manager.Options) er
 	begin, end := network.EphemeralRange()
 	options.ConstantEditors = append(options.ConstantEditors,
 		manager.ConstantEditor{Name: "ephemeral_range_begin", Value: uint64(begin)},
-		manager.ConstantEditor{Name: "ephemeral_range_end", Value: uint64(end)})
+		manager.ConstantEditor{Name: "ephemeral_range_end", Value: uint64(end)},
+		manager.ConstantEditor{Name: "max_unclassified_packets", Value: uint64(max(e.cfg.USMMaxUnclassifiedPackets, 0))},
+		manager.ConstantEditor{Name: "classification_gc_ttl_ns", Value: uint64(connProtoTTL.Nanoseconds())},
+		manager.ConstantEditor{Name: "classification_gc_interval_ns", Value: uint64(connProtoCleaningInterval.Nanoseconds())})
+	if !e.classificationGC {
+		// the timer helpers are unknown to the verifiers of the kernels not supporting them
+		options.ExcludedFunctions = append(options.ExcludedFunctions, classificationGCProbe)
+	}
 
 	for _, p := range e.Manager.Probes {
 		options.ActivatedProbes = append(options.ActivatedProbes, &manager.ProbeSelector{ProbeIdentificationPair: p.ProbeIdentificationPair})
@@ -420,6 +478,9 @@ func (e *ebpfProgram) init(buf bytecode.AssetReader, options manager.Options) er
 	// Some parts of USM (https capturing, and part of the classification) use `read_conn_tuple`, and has some if
 	// clauses that handled IPV6, for USM we care (ATM) only from TCP connections, so adding the sole config about tcpv6.
 	utils.AddBoolConst(&options, e.cfg.CollectTCPv6Conns, "tcpv6_enabled")
+	utils.AddBoolConst(&options, e.cfg.EnableUSMCPUCostTelemetry, "usm_cpu_cost_enabled")
+	utils.AddBoolConst(&options, e.cfg.UDPTunnelDecapEnabled, "udp_tunnel_decap_enabled")
+	e.filter.configureOptions(&options)
 
 	options.DefaultKProbeMaxActive = maxActive
 	options.DefaultKprobeAttachMethod = kprobeAttachMethod
@@ -498,14 +559,6 @@ func getAssetName(module string, debug bool) string {
 
 func (e *ebpfProgram) dumpMapsHandler(w io.Writer, _ *manager.Manager, mapName string, currentMap *ebpf.Map) {
 	switch mapName {
-	case connectionStatesMap: // maps/connection_states (BPF_MAP_TYPE_HASH), key C.conn_tuple_t, value C.__u32
-		io.WriteString(w, "Map: '"+mapName+"', key: 'C.conn_tuple_t', value: 'C.__u32'\n")
-		iter := currentMap.Iterate()
-		var key http.ConnTuple
-		var value uint32
-		for iter.Next(unsafe.Pointer(&key), unsafe.Pointer(&value)) {
-			spew.Fdump(w, key, value)
-		}
 	case sockFDLookupArgsMap: // maps/sockfd_lookup_args (BPF_MAP_TYPE_HASH), key C.__u64, value C.__u32
 		io.WriteString(w, "Map: '"+mapName+"', key: 'C.__u64', value: 'C.__u32'\n")
 		iter := currentMap.Iterate()
@@ -515,7 +568,7 @@ func (e *ebpfProgram) dumpMapsHandler(w io.Writer, _ *manager.Manager, mapName s
 			spew.Fdump(w, key, value)
 		}
 
-	case tupleByPidFDMap: // maps/tuple_by_pid_fd (BPF_MAP_TYPE_HASH), key C.pid_fd_t, value C.conn_tuple_t
+	case tupleByPidFDMap: // maps/tuple_by_pid_fd (BPF_MAP_TYPE_LRU_HASH), key C.pid_fd_t, value C.conn_tuple_t
 		io.WriteString(w, "Map: '"+mapName+"', key: 'C.pid_fd_t', value: 'C.conn_tuple_t'\n")
 		iter := currentMap.Iterate()
 		var key netebpf.PIDFD
@@ -524,7 +577,7 @@ func (e *ebpfProgram) dumpMapsHandler(w io.Writer, _ *manager.Manager, mapName s
 			spew.Fdump(w, key, value)
 		}
 
-	case pidFDByTupleMap: // maps/pid_fd_by_tuple (BPF_MAP_TYPE_HASH), key C.conn_tuple_t, value C.pid_fd_t
+	case pidFDByTupleMap: // maps/pid_fd_by_tuple (BPF_MAP_TYPE_LRU_HASH), key C.conn_tuple_t, value C.pid_fd_t
 		io.WriteString(w, "Map: '"+mapName+"', key: 'C.conn_tuple_t', value: 'C.pid_fd_t'\n")
 		iter := currentMap.Iterate()
 		var key http.ConnTuple
@@ -548,6 +601,11 @@ func (e *ebpfProgram) getProtocolStats() map[protocols.ProtocolType]interface{}
 		if ps != nil {
 			ret[ps.Type] = ps.Stats
 		}
+		if esp, ok := protocol.Instance.(protocols.ExtraStatsProvider); ok {
+			for _, ps := range esp.GetExtraStats() {
+				ret[ps.Type] = ps.Stats
+			}
+		}
 	}
 
 	return ret
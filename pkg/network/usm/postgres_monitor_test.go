@@ -395,6 +395,33 @@ func testDecoding(t *testing.T, isTLS bool) {
 				})
 			},
 		},
+		{
+			name: "pipelined queries",
+			preMonitorSetup: func(t *testing.T, ctx testContext) {
+				pg, err := postgres.NewPGXClient(postgres.ConnectionOptions{
+					ServerAddress: ctx.serverAddress,
+					EnableTLS:     isTLS,
+				})
+				require.NoError(t, err)
+				require.NoError(t, pg.Ping())
+				ctx.extras["pg"] = pg
+				require.NoError(t, pg.RunQuery(createTableQuery))
+				require.NoError(t, pg.RunQuery(createInsertQuery(generateTestValues(0, 5)...)))
+			},
+			postMonitorSetup: func(t *testing.T, ctx testContext) {
+				pg := ctx.extras["pg"].(*postgres.PGXClient)
+				// The statements are parsed in a single packet, then executed in another one.
+				require.NoError(t, pg.RunBatch(generateSelectLimitQuery(1), updateSingleValueQuery, generateSelectLimitQuery(2)))
+			},
+			validation: func(t *testing.T, ctx testContext, monitor *Monitor) {
+				validatePostgres(t, monitor, map[string]map[postgres.Operation]int{
+					"dummy": {
+						postgres.SelectOP: adjustCount(2),
+						postgres.UpdateOP: adjustCount(1),
+					},
+				})
+			},
+		},
 		{
 			name: "too many messages in a single packet",
 			preMonitorSetup: func(t *testing.T, ctx testContext) {
@@ -464,13 +491,13 @@ func testDecoding(t *testing.T, isTLS bool) {
 }
 
 // getPostgresInFlightEntries returns the entries in the in-flight map.
-func getPostgresInFlightEntries(t *testing.T, monitor *Monitor) map[postgres.ConnTuple]postgres.EbpfTx {
+func getPostgresInFlightEntries(t *testing.T, monitor *Monitor) map[postgres.ConnTuple]postgres.EbpfPipeline {
 	postgresInFlightMap, _, err := monitor.ebpfProgram.GetMap(postgres.InFlightMap)
 	require.NoError(t, err)
 
 	var key postgres.ConnTuple
-	var value postgres.EbpfTx
-	entries := make(map[postgres.ConnTuple]postgres.EbpfTx)
+	var value postgres.EbpfPipeline
+	entries := make(map[postgres.ConnTuple]postgres.EbpfPipeline)
 	iter := postgresInFlightMap.Iterate()
 	for iter.Next(&key, &value) {
 		entries[key] = value
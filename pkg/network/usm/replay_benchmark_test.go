@@ -0,0 +1,461 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package usm
+
+import (
+	"bytes"
+	"encoding/binary"
+	"errors"
+	"flag"
+	"fmt"
+	"io"
+	"net"
+	"os"
+	"path/filepath"
+	"testing"
+	"time"
+
+	manager "github.com/DataDog/ebpf-manager"
+	"github.com/cilium/ebpf"
+	"github.com/google/gopacket"
+	"github.com/google/gopacket/layers"
+	"github.com/google/gopacket/pcapgo"
+	"github.com/jackc/pgx/v5/pgproto3"
+	"github.com/stretchr/testify/require"
+	"github.com/twmb/franz-go/pkg/kmsg"
+	"golang.org/x/net/http2"
+	"golang.org/x/net/http2/hpack"
+	"golang.org/x/sys/unix"
+
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+	"github.com/DataDog/datadog-agent/pkg/network/protocols/http"
+	usmhttp2 "github.com/DataDog/datadog-agent/pkg/network/protocols/http2"
+)
+
+// replayPcapDir points to a directory holding <workload>.pcap captures (Ethernet link type) replacing the synthesized
+// conversations of the replay benchmark, e.g. -replay-pcap-dir=/tmp/captures
+var replayPcapDir = flag.String("replay-pcap-dir", "", "directory of the pcap files replayed by BenchmarkSocketFilterReplay")
+
+// replaySeqStride shifts the TCP sequence numbers of each replay of a conversation, so the dispatcher doesn't drop
+// the packets as already seen.
+const replaySeqStride = 1 << 20
+
+// replayWorkloads are the conversations replayed by BenchmarkSocketFilterReplay. They are synthesized, unless
+// replayPcapDir is set, in which case they are read from the <name>.pcap files of that directory.
+var replayWorkloads = []struct {
+	name       string
+	synthesize func(tb testing.TB) [][]byte
+}{
+	{name: "http1_keepalive", synthesize: synthesizeHTTP1KeepAlive},
+	{name: "grpc_streaming", synthesize: synthesizeGRPCStreaming},
+	{name: "kafka_fetch", synthesize: synthesizeKafkaFetch},
+	{name: "postgres_pipelined", synthesize: synthesizePostgresPipelined},
+}
+
+// BenchmarkSocketFilterReplay feeds the packets of a few workloads to the protocol dispatcher socket filter with
+// BPF_PROG_TEST_RUN, reporting the time spent per packet, and the run time and size of each program involved,
+// including the decoders reached through tail calls.
+func BenchmarkSocketFilterReplay(b *testing.B) {
+	if kv < http.MinimumKernelVersion {
+		b.Skipf("USM is not supported on %v", kv)
+	}
+
+	cfg := config.New()
+	cfg.EnableHTTPMonitoring = true
+	cfg.EnableHTTP2Monitoring = usmhttp2.Supported()
+	cfg.EnableKafkaMonitoring = true
+	cfg.EnablePostgresMonitoring = true
+	monitor, err := NewMonitor(cfg, nil)
+	require.NoError(b, err)
+	require.NotNil(b, monitor)
+	require.NoError(b, monitor.Start())
+	b.Cleanup(monitor.Stop)
+
+	// the run time of the programs is only accounted while the stats are enabled
+	stats, err := ebpf.EnableStats(uint32(unix.BPF_STATS_RUN_TIME))
+	require.NoError(b, err)
+	b.Cleanup(func() { stats.Close() })
+
+	programs := replayPrograms(b, monitor.ebpfProgram)
+	dispatcher := programs[protocolDispatcherSocketFilterFunction]
+	require.NotNil(b, dispatcher)
+
+	for _, workload := range replayWorkloads {
+		b.Run(workload.name, func(b *testing.B) {
+			packets := loadReplayPackets(b, workload.name, workload.synthesize)
+			before := readReplayStats(programs)
+
+			var elapsed time.Duration
+			b.ResetTimer()
+			for i := 0; i < b.N; i++ {
+				for _, p := range packets {
+					p.setSeqShift(uint32(i) * replaySeqStride)
+					_, duration, err := dispatcher.Benchmark(p.data, 1, nil)
+					if err != nil {
+						b.Fatal(err)
+					}
+					elapsed += duration
+				}
+			}
+			b.StopTimer()
+
+			b.ReportMetric(float64(elapsed.Nanoseconds())/float64(b.N*len(packets)), "ns/packet")
+			reportReplayStats(b, programs, before)
+		})
+	}
+}
+
+// replayPacket is a packet of a conversation, along with the offset and original value of its TCP sequence number.
+type replayPacket struct {
+	data      []byte
+	seqOffset int
+	seq       uint32
+}
+
+func (p *replayPacket) setSeqShift(shift uint32) {
+	binary.BigEndian.PutUint32(p.data[p.seqOffset:], p.seq+shift)
+}
+
+// newReplayPacket returns the replay packet of an Ethernet frame, or nil if it doesn't carry a TCP segment.
+func newReplayPacket(data []byte) *replayPacket {
+	packet := gopacket.NewPacket(data, layers.LayerTypeEthernet, gopacket.NoCopy)
+	tcp, ok := packet.Layer(layers.LayerTypeTCP).(*layers.TCP)
+	if !ok {
+		return nil
+	}
+	tcpOffset := len(data) - len(tcp.LayerContents()) - len(tcp.LayerPayload())
+	return &replayPacket{
+		data:      data,
+		seqOffset: tcpOffset + 4,
+		seq:       tcp.Seq,
+	}
+}
+
+// loadReplayPackets reads the TCP packets of the capture of the workload, or synthesizes them if there is none.
+func loadReplayPackets(tb testing.TB, name string, synthesize func(tb testing.TB) [][]byte) []*replayPacket {
+	var frames [][]byte
+	if *replayPcapDir != "" {
+		frames = readPcap(tb, filepath.Join(*replayPcapDir, name+".pcap"))
+	} else {
+		frames = synthesize(tb)
+	}
+
+	packets := make([]*replayPacket, 0, len(frames))
+	for _, frame := range frames {
+		if p := newReplayPacket(frame); p != nil {
+			packets = append(packets, p)
+		}
+	}
+	require.NotEmpty(tb, packets, "no TCP packet to replay for %s", name)
+	return packets
+}
+
+func readPcap(tb testing.TB, path string) [][]byte {
+	f, err := os.Open(path)
+	require.NoError(tb, err)
+	defer f.Close()
+
+	r, err := pcapgo.NewReader(f)
+	require.NoError(tb, err)
+	require.Equal(tb, layers.LinkTypeEthernet, r.LinkType(), "%s is not an Ethernet capture", path)
+
+	var frames [][]byte
+	for {
+		data, _, err := r.ReadPacketData()
+		if errors.Is(err, io.EOF) {
+			return frames
+		}
+		require.NoError(tb, err)
+		frames = append(frames, data)
+	}
+}
+
+// replayPrograms returns the dispatcher socket filter and the programs it tail calls, by name.
+func replayPrograms(tb testing.TB, e *ebpfProgram) map[string]*ebpf.Program {
+	programs := make(map[string]*ebpf.Program)
+	ids := []manager.ProbeIdentificationPair{{EBPFFuncName: protocolDispatcherSocketFilterFunction, UID: probeUID}}
+	for _, route := range e.tailCallRouter {
+		ids = append(ids, route.ProbeIdentificationPair)
+	}
+	for _, id := range ids {
+		progs, found, err := e.Manager.GetProgram(id)
+		require.NoError(tb, err)
+		if found && len(progs) > 0 {
+			programs[id.EBPFFuncName] = progs[0]
+		}
+	}
+	return programs
+}
+
+// replayStats holds the run counters of a program, as reported by the kernel while the BPF stats are enabled.
+type replayStats struct {
+	runs    uint64
+	runtime time.Duration
+}
+
+func readReplayStats(programs map[string]*ebpf.Program) map[string]replayStats {
+	stats := make(map[string]replayStats, len(programs))
+	for name, prog := range programs {
+		info, err := prog.Info()
+		if err != nil {
+			continue
+		}
+		runs, _ := info.RunCount()
+		runtime, _ := info.Runtime()
+		stats[name] = replayStats{runs: runs, runtime: runtime}
+	}
+	return stats
+}
+
+// reportReplayStats reports the mean run time of the programs which ran since `before`, and their number of
+// instructions once translated by the kernel.
+func reportReplayStats(b *testing.B, programs map[string]*ebpf.Program, before map[string]replayStats) {
+	for name, after := range readReplayStats(programs) {
+		runs := after.runs - before[name].runs
+		if runs == 0 {
+			continue
+		}
+		runtime := after.runtime - before[name].runtime
+		b.ReportMetric(float64(runtime.Nanoseconds())/float64(runs), name+"-ns/run")
+		b.ReportMetric(float64(runs)/float64(b.N), name+"-runs/op")
+
+		info, err := programs[name].Info()
+		if err != nil {
+			continue
+		}
+		if insns, err := info.Instructions(); err == nil {
+			b.ReportMetric(float64(len(insns)), name+"-insns")
+		}
+	}
+}
+
+// replayConn builds the Ethernet frames of a TCP conversation between a client and a server.
+type replayConn struct {
+	tb         testing.TB
+	client     net.IP
+	server     net.IP
+	clientPort layers.TCPPort
+	serverPort layers.TCPPort
+	clientSeq  uint32
+	serverSeq  uint32
+	frames     [][]byte
+}
+
+func newReplayConn(tb testing.TB, serverPort uint16) *replayConn {
+	return &replayConn{
+		tb:         tb,
+		client:     net.IPv4(10, 0, 0, 1),
+		server:     net.IPv4(10, 0, 0, 2),
+		clientPort: 45678,
+		serverPort: layers.TCPPort(serverPort),
+		clientSeq:  1000,
+		serverSeq:  5000,
+	}
+}
+
+func (c *replayConn) send(fromClient bool, payload []byte) {
+	eth := &layers.Ethernet{
+		SrcMAC:       net.HardwareAddr{0x02, 0, 0, 0, 0, 1},
+		DstMAC:       net.HardwareAddr{0x02, 0, 0, 0, 0, 2},
+		EthernetType: layers.EthernetTypeIPv4,
+	}
+	ip := &layers.IPv4{Version: 4, TTL: 64, Protocol: layers.IPProtocolTCP, SrcIP: c.client, DstIP: c.server}
+	tcp := &layers.TCP{
+		SrcPort: c.clientPort,
+		DstPort: c.serverPort,
+		Seq:     c.clientSeq,
+		Ack:     c.serverSeq,
+		PSH:     true,
+		ACK:     true,
+		Window:  65535,
+	}
+	if !fromClient {
+		eth.SrcMAC, eth.DstMAC = eth.DstMAC, eth.SrcMAC
+		ip.SrcIP, ip.DstIP = ip.DstIP, ip.SrcIP
+		tcp.SrcPort, tcp.DstPort = tcp.DstPort, tcp.SrcPort
+		tcp.Seq, tcp.Ack = c.serverSeq, c.clientSeq
+	}
+	require.NoError(c.tb, tcp.SetNetworkLayerForChecksum(ip))
+
+	buf := gopacket.NewSerializeBuffer()
+	opts := gopacket.SerializeOptions{FixLengths: true, ComputeChecksums: true}
+	require.NoError(c.tb, gopacket.SerializeLayers(buf, opts, eth, ip, tcp, gopacket.Payload(payload)))
+	c.frames = append(c.frames, bytes.Clone(buf.Bytes()))
+
+	if fromClient {
+		c.clientSeq += uint32(len(payload))
+	} else {
+		c.serverSeq += uint32(len(payload))
+	}
+}
+
+// synthesizeHTTP1KeepAlive builds a keep-alive connection carrying 10 HTTP/1.1 requests and their responses.
+func synthesizeHTTP1KeepAlive(tb testing.TB) [][]byte {
+	conn := newReplayConn(tb, 8080)
+	for i := 0; i < 10; i++ {
+		conn.send(true, []byte(fmt.Sprintf("GET /api/v1/items/%d HTTP/1.1\r\nHost: replay\r\nConnection: keep-alive\r\n\r\n", i)))
+		conn.send(false, []byte("HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nContent-Length: 2\r\n\r\nok"))
+	}
+	return conn.frames
+}
+
+// synthesizeGRPCStreaming builds a bidirectional gRPC stream exchanging 10 messages in each direction.
+func synthesizeGRPCStreaming(tb testing.TB) [][]byte {
+	conn := newReplayConn(tb, 50051)
+	var buf, clientHeaders, serverHeaders bytes.Buffer
+	framer := http2.NewFramer(&buf, nil)
+	clientEncoder := hpack.NewEncoder(&clientHeaders)
+	serverEncoder := hpack.NewEncoder(&serverHeaders)
+
+	headers := func(enc *hpack.Encoder, block *bytes.Buffer, fields ...string) []byte {
+		block.Reset()
+		for i := 0; i+1 < len(fields); i += 2 {
+			require.NoError(tb, enc.WriteField(hpack.HeaderField{Name: fields[i], Value: fields[i+1]}))
+		}
+		return block.Bytes()
+	}
+	flush := func(fromClient bool) {
+		conn.send(fromClient, bytes.Clone(buf.Bytes()))
+		buf.Reset()
+	}
+	message := []byte{0, 0, 0, 0, 5, 'h', 'e', 'l', 'l', 'o'}
+
+	buf.WriteString(http2.ClientPreface)
+	require.NoError(tb, framer.WriteSettings())
+	require.NoError(tb, framer.WriteHeaders(http2.HeadersFrameParam{
+		StreamID:   1,
+		EndHeaders: true,
+		BlockFragment: headers(clientEncoder, &clientHeaders,
+			":method", "POST", ":scheme", "http", ":authority", "replay", ":path", "/replay.Service/Stream",
+			"content-type", "application/grpc", "te", "trailers"),
+	}))
+	flush(true)
+
+	require.NoError(tb, framer.WriteSettings())
+	require.NoError(tb, framer.WriteHeaders(http2.HeadersFrameParam{
+		StreamID:      1,
+		EndHeaders:    true,
+		BlockFragment: headers(serverEncoder, &serverHeaders, ":status", "200", "content-type", "application/grpc"),
+	}))
+	flush(false)
+
+	for i := 0; i < 10; i++ {
+		require.NoError(tb, framer.WriteData(1, i == 9, message))
+		flush(true)
+		require.NoError(tb, framer.WriteData(1, false, message))
+		flush(false)
+	}
+
+	require.NoError(tb, framer.WriteHeaders(http2.HeadersFrameParam{
+		StreamID:      1,
+		EndHeaders:    true,
+		EndStream:     true,
+		BlockFragment: headers(serverEncoder, &serverHeaders, "grpc-status", "0"),
+	}))
+	flush(false)
+	return conn.frames
+}
+
+// synthesizeKafkaFetch builds a connection carrying 10 fetch requests (v4) and their responses, each holding a
+// record batch.
+func synthesizeKafkaFetch(tb testing.TB) [][]byte {
+	conn := newReplayConn(tb, 9092)
+	clientID := "replay"
+
+	for i := 0; i < 10; i++ {
+		correlationID := int32(i + 1)
+
+		req := kmsg.NewPtrFetchRequest()
+		req.Version = 4
+		req.ReplicaID = -1
+		req.MaxWaitMillis = 500
+		req.MinBytes = 1
+		req.MaxBytes = 1 << 20
+		topic := kmsg.NewFetchRequestTopic()
+		topic.Topic = "replay-topic"
+		partition := kmsg.NewFetchRequestTopicPartition()
+		partition.FetchOffset = int64(i)
+		partition.PartitionMaxBytes = 1 << 20
+		topic.Partitions = append(topic.Partitions, partition)
+		req.Topics = append(req.Topics, topic)
+
+		header := binary.BigEndian.AppendUint16(nil, uint16(req.Key()))
+		header = binary.BigEndian.AppendUint16(header, uint16(req.Version))
+		header = binary.BigEndian.AppendUint32(header, uint32(correlationID))
+		header = binary.BigEndian.AppendUint16(header, uint16(len(clientID)))
+		header = append(header, clientID...)
+		conn.send(true, kafkaFrame(append(header, req.AppendTo(nil)...)))
+
+		batch := kmsg.NewRecordBatch()
+		batch.FirstOffset = int64(i)
+		batch.Magic = 2
+		batch.NumRecords = 1
+		batch.Records = []byte("replayed record")
+		// Length covers the fields following it
+		batch.Length = int32(len(batch.AppendTo(nil)) - 12)
+
+		resp := kmsg.NewPtrFetchResponse()
+		resp.Version = 4
+		respTopic := kmsg.NewFetchResponseTopic()
+		respTopic.Topic = "replay-topic"
+		respPartition := kmsg.NewFetchResponseTopicPartition()
+		respPartition.HighWatermark = int64(i + 1)
+		respPartition.RecordBatches = batch.AppendTo(nil)
+		respTopic.Partitions = append(respTopic.Partitions, respPartition)
+		resp.Topics = append(resp.Topics, respTopic)
+
+		body := binary.BigEndian.AppendUint32(nil, uint32(correlationID))
+		conn.send(false, kafkaFrame(resp.AppendTo(body)))
+	}
+	return conn.frames
+}
+
+// kafkaFrame prefixes a Kafka message with its size.
+func kafkaFrame(message []byte) []byte {
+	return append(binary.BigEndian.AppendUint32(nil, uint32(len(message))), message...)
+}
+
+// synthesizePostgresPipelined builds a connection carrying 10 pipelines of 5 extended protocol queries, each
+// pipeline being sent in a single packet and answered in a single packet.
+func synthesizePostgresPipelined(tb testing.TB) [][]byte {
+	conn := newReplayConn(tb, 5432)
+
+	encode := func(dst []byte, messages ...interface{ Encode([]byte) ([]byte, error) }) []byte {
+		var err error
+		for _, m := range messages {
+			dst, err = m.Encode(dst)
+			require.NoError(tb, err)
+		}
+		return dst
+	}
+
+	for i := 0; i < 10; i++ {
+		var request, response []byte
+		for q := 0; q < 5; q++ {
+			request = encode(request,
+				&pgproto3.Parse{Query: "SELECT id, name FROM items WHERE id = $1"},
+				&pgproto3.Bind{Parameters: [][]byte{[]byte(fmt.Sprint(i*5 + q))}},
+				&pgproto3.Describe{ObjectType: 'P'},
+				&pgproto3.Execute{},
+			)
+			response = encode(response,
+				&pgproto3.ParseComplete{},
+				&pgproto3.BindComplete{},
+				&pgproto3.RowDescription{Fields: []pgproto3.FieldDescription{
+					{Name: []byte("id"), DataTypeOID: 23, DataTypeSize: 4, TypeModifier: -1},
+					{Name: []byte("name"), DataTypeOID: 25, DataTypeSize: -1, TypeModifier: -1},
+				}},
+				&pgproto3.DataRow{Values: [][]byte{[]byte(fmt.Sprint(i*5 + q)), []byte("replayed")}},
+				&pgproto3.CommandComplete{CommandTag: []byte("SELECT 1")},
+			)
+		}
+		conn.send(true, encode(request, &pgproto3.Sync{}))
+		conn.send(false, encode(response, &pgproto3.ReadyForQuery{TxStatus: 'I'}))
+	}
+	return conn.frames
+}
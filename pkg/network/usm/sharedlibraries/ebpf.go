@@ -12,6 +12,7 @@ import (
 	"math"
 	"os"
 	"runtime"
+	"unsafe"
 
 	manager "github.com/DataDog/ebpf-manager"
 	"golang.org/x/sys/unix"
@@ -28,6 +29,8 @@ import (
 const (
 	maxActive              = 1024
 	sharedLibrariesPerfMap = "shared_libraries"
+	suffixesMap            = "shared_libraries_suffixes"
+	seenMap                = "shared_libraries_seen"
 	probeUID               = "so"
 
 	// probe used for streaming shared library events
@@ -162,6 +165,46 @@ func (e *ebpfProgram) initPrebuilt() error {
 	return e.init(bc, manager.Options{})
 }
 
+// newLibSuffixes builds the table of the suffixes matched by the kernel against the characters preceding ".so" in the
+// paths of the opened files. The suffixes are right-aligned, the leading NUL characters matching any character.
+func newLibSuffixes(suffixes []string) (libSuffixes, error) {
+	var table libSuffixes
+	if len(suffixes) > libSuffixMaxCount {
+		return table, fmt.Errorf("too many library suffixes (%d), the maximum is %d", len(suffixes), libSuffixMaxCount)
+	}
+	for i, suffix := range suffixes {
+		if len(suffix) == 0 || len(suffix) > libSuffixSize {
+			return table, fmt.Errorf("library suffix %q must have between 1 and %d characters", suffix, libSuffixSize)
+		}
+		copy(table.Suffixes[i].Buf[libSuffixSize-len(suffix):], suffix)
+	}
+	return table, nil
+}
+
+// setLibrarySuffixes sets the suffixes of the libraries reported by the kernel.
+func (e *ebpfProgram) setLibrarySuffixes(suffixes []string) error {
+	table, err := newLibSuffixes(suffixes)
+	if err != nil {
+		return err
+	}
+
+	suffixesTable, _, err := e.GetMap(suffixesMap)
+	if err != nil {
+		return fmt.Errorf("could not get %s map: %w", suffixesMap, err)
+	}
+	key := uint32(0)
+	return suffixesTable.Put(unsafe.Pointer(&key), unsafe.Pointer(&table))
+}
+
+// forgetPID removes the libraries reported for the given process, so they are reported again if its PID is reused.
+func (e *ebpfProgram) forgetPID(pid uint32) {
+	seen, _, err := e.GetMap(seenMap)
+	if err != nil {
+		return
+	}
+	_ = seen.Delete(unsafe.Pointer(&pid))
+}
+
 func sysOpenAt2Supported() bool {
 	missing, err := ddebpf.VerifyKernelFuncs("do_sys_openat2")
 
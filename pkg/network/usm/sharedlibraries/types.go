@@ -13,7 +13,11 @@ package sharedlibraries
 import "C"
 
 type libPath C.lib_path_t
+type libSuffix C.lib_suffix_t
+type libSuffixes C.lib_suffixes_t
 
 const (
-	libPathMaxSize = C.LIB_PATH_MAX_SIZE
+	libPathMaxSize    = C.LIB_PATH_MAX_SIZE
+	libSuffixSize     = C.LIB_SUFFIX_SIZE
+	libSuffixMaxCount = C.LIB_SUFFIX_MAX_COUNT
 )
@@ -8,7 +8,15 @@ type libPath struct {
 	Len uint32
 	Buf [120]byte
 }
+type libSuffix struct {
+	Buf [6]byte
+}
+type libSuffixes struct {
+	Suffixes [8]libSuffix
+}
 
 const (
-	libPathMaxSize = 0x78
+	libPathMaxSize    = 0x78
+	libSuffixSize     = 0x6
+	libSuffixMaxCount = 0x8
 )
@@ -30,6 +30,10 @@ const (
 	// The interval of the periodic scan for terminated processes. Increasing the interval, might cause larger spikes in cpu
 	// and lowering it might cause constant cpu usage.
 	scanTerminatedProcessesInterval = 30 * time.Second
+
+	// The delay during which the hooks of a library stay attached once the last process using it terminated. The
+	// libraries of the short-lived workers of process pools would otherwise be hooked and unhooked over and over.
+	libraryDeactivationDelay = 2 * time.Minute
 )
 
 func toLibPath(data []byte) libPath {
@@ -73,6 +77,13 @@ func NewWatcher(cfg *config.Config, rules ...Rule) (*Watcher, error) {
 	if err != nil {
 		return nil, fmt.Errorf("error initializing shared library program: %w", err)
 	}
+	if err := ebpfProgram.setLibrarySuffixes(cfg.NativeTLSLibrarySuffixes); err != nil {
+		ebpfProgram.Stop()
+		return nil, fmt.Errorf("error setting the shared library suffixes: %w", err)
+	}
+
+	registry := utils.NewFileRegistry("shared_libraries")
+	registry.SetDeactivationDelay(libraryDeactivationDelay)
 
 	return &Watcher{
 		wg:             sync.WaitGroup{},
@@ -82,7 +93,7 @@ func NewWatcher(cfg *config.Config, rules ...Rule) (*Watcher, error) {
 		loadEvents:     ebpfProgram.GetPerfHandler(),
 		processMonitor: monitor.GetProcessMonitor(),
 		ebpfProgram:    ebpfProgram,
-		registry:       utils.NewFileRegistry("shared_libraries"),
+		registry:       registry,
 
 		libHits:    telemetry.NewCounter("usm.so_watcher.hits", telemetry.OptPrometheus),
 		libMatches: telemetry.NewCounter("usm.so_watcher.matches", telemetry.OptPrometheus),
@@ -136,6 +147,7 @@ func parseMapsFile(scanner *bufio.Scanner, callback parseMapsFileCB) {
 
 // DetachPID detaches a given pid from the eBPF program
 func (w *Watcher) DetachPID(pid uint32) error {
+	w.ebpfProgram.forgetPID(pid)
 	return w.registry.Unregister(pid)
 }
 
@@ -220,7 +232,10 @@ func (w *Watcher) Start() {
 		return nil
 	})
 
-	cleanupExit := w.processMonitor.SubscribeExit(func(pid uint32) { _ = w.registry.Unregister(pid) })
+	cleanupExit := w.processMonitor.SubscribeExit(func(pid uint32) {
+		w.ebpfProgram.forgetPID(pid)
+		_ = w.registry.Unregister(pid)
+	})
 
 	w.wg.Add(1)
 	go func() {
@@ -250,6 +265,7 @@ func (w *Watcher) Start() {
 				for deletedPid := range deletedPids {
 					_ = w.registry.Unregister(deletedPid)
 				}
+				w.registry.DeactivateExpired()
 			case event, ok := <-dataChannel:
 				if !ok {
 					return
@@ -449,6 +449,21 @@ func Test_parseMapsFile(t *testing.T) {
 	require.Equal(t, expectedEntries, extractedEntries)
 }
 
+func Test_newLibSuffixes(t *testing.T) {
+	table, err := newLibSuffixes([]string{"libssl", "ssl"})
+	require.NoError(t, err)
+	assert.Equal(t, [libSuffixSize]byte{'l', 'i', 'b', 's', 's', 'l'}, table.Suffixes[0].Buf)
+	assert.Equal(t, [libSuffixSize]byte{0, 0, 0, 's', 's', 'l'}, table.Suffixes[1].Buf)
+	assert.Equal(t, libSuffix{}, table.Suffixes[2])
+
+	_, err = newLibSuffixes([]string{"libcrypto"})
+	assert.Error(t, err)
+	_, err = newLibSuffixes([]string{""})
+	assert.Error(t, err)
+	_, err = newLibSuffixes(make([]string, libSuffixMaxCount+1))
+	assert.Error(t, err)
+}
+
 func hasPID(w *Watcher, cmd *exec.Cmd) bool {
 	activePIDs := w.registry.GetRegisteredProcesses()
 	_, ok := activePIDs[uint32(cmd.Process.Pid)]
@@ -0,0 +1,205 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package usm
+
+import (
+	"fmt"
+	"path/filepath"
+
+	manager "github.com/DataDog/ebpf-manager"
+	"github.com/cilium/ebpf/asm"
+	"golang.org/x/sys/unix"
+
+	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
+	"github.com/DataDog/datadog-agent/pkg/ebpf/maps"
+	"github.com/DataDog/datadog-agent/pkg/network"
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+	"github.com/DataDog/datadog-agent/pkg/network/usm/utils"
+	"github.com/DataDog/datadog-agent/pkg/util/kernel"
+	"github.com/DataDog/datadog-agent/pkg/util/log"
+)
+
+const (
+	usmPortFilterMap   = "usm_port_filter"
+	usmCgroupFilterMap = "usm_cgroup_filter"
+	usmCgroupProtosMap = "usm_cgroup_protocols"
+
+	// usmPortFilterWords is the number of 64-bit words of the usm_port_filter bitmap, see USM_PORT_FILTER_WORDS
+	usmPortFilterWords = 65536 / 64
+)
+
+// usmFilter restricts USM to the configured ports and cgroups, see pkg/network/ebpf/c/protocols/usm-filter.h
+type usmFilter struct {
+	ports     [usmPortFilterWords]uint64
+	hasPorts  bool
+	cgroupIDs []uint64
+	// cgroupProtocols maps the IDs of the cgroups whose TLS decoding is restricted to the bitmap of their protocols
+	cgroupProtocols map[uint64]uint32
+}
+
+func newUSMFilter(c *config.Config) *usmFilter {
+	f := &usmFilter{}
+	for _, pr := range c.USMMonitoredPorts {
+		lower, upper, err := network.ParsePortRange(pr)
+		if err != nil {
+			log.Errorf("ignoring USM monitored port %q: %s", pr, err)
+			continue
+		}
+		f.addPorts(lower, upper)
+	}
+
+	if len(c.USMMonitoredCgroups) == 0 && len(c.USMCgroupProtocols) == 0 {
+		return f
+	}
+	if v, err := kernel.HostVersion(); err != nil || v < kernel.VersionCode(4, 18, 0) {
+		log.Warn("the USM cgroup filters require a 4.18 kernel, monitoring all the processes and protocols")
+		return f
+	}
+	for _, path := range c.USMMonitoredCgroups {
+		id, err := cgroupID(path)
+		if err != nil {
+			log.Errorf("ignoring USM monitored cgroup %q: %s", path, err)
+			continue
+		}
+		f.cgroupIDs = append(f.cgroupIDs, id)
+	}
+	for _, cp := range c.USMCgroupProtocols {
+		bitmap, err := protocolsBitmap(cp.Protocols)
+		if err != nil {
+			log.Errorf("ignoring the USM protocols of cgroup %q: %s", cp.Cgroup, err)
+			continue
+		}
+		id, err := cgroupID(cp.Cgroup)
+		if err != nil {
+			log.Errorf("ignoring the USM protocols of cgroup %q: %s", cp.Cgroup, err)
+			continue
+		}
+		if f.cgroupProtocols == nil {
+			f.cgroupProtocols = make(map[uint64]uint32)
+		}
+		f.cgroupProtocols[id] = bitmap
+	}
+	return f
+}
+
+// protocolsBitmap returns the bitmap of the given protocols, bit N being set for the protocol number N of the
+// application layer, see applicationProtocolNames.
+func protocolsBitmap(names []string) (uint32, error) {
+	var bitmap uint32
+	for _, name := range names {
+		found := false
+		for number, protocolName := range applicationProtocolNames {
+			if protocolName == name {
+				bitmap |= 1 << number
+				found = true
+				break
+			}
+		}
+		if !found {
+			return 0, fmt.Errorf("unknown protocol %q", name)
+		}
+	}
+	return bitmap, nil
+}
+
+func (f *usmFilter) addPorts(lower, upper uint16) {
+	for p := uint32(lower); p <= uint32(upper); p++ {
+		f.ports[p/64] |= 1 << (p % 64)
+	}
+	f.hasPorts = true
+}
+
+// cgroupID returns the ID of a cgroup v2, which is the inode number of its directory
+func cgroupID(path string) (uint64, error) {
+	if !filepath.IsAbs(path) {
+		path = filepath.Join(kernel.SysFSRoot(), "fs/cgroup", path)
+	}
+
+	var fs unix.Statfs_t
+	if err := unix.Statfs(path, &fs); err != nil {
+		return 0, err
+	}
+	if fs.Type != unix.CGROUP2_SUPER_MAGIC {
+		return 0, fmt.Errorf("%s is not a cgroup v2", path)
+	}
+
+	var st unix.Stat_t
+	if err := unix.Stat(path, &st); err != nil {
+		return 0, err
+	}
+	return st.Ino, nil
+}
+
+// configureOptions sets the constants enabling the filters and the size of the cgroup set
+func (f *usmFilter) configureOptions(options *manager.Options) {
+	utils.AddBoolConst(options, f.hasPorts, "usm_port_filter_enabled")
+	utils.AddBoolConst(options, len(f.cgroupIDs) > 0, "usm_cgroup_filter_enabled")
+	utils.AddBoolConst(options, len(f.cgroupProtocols) > 0, "usm_cgroup_protocols_enabled")
+	options.MapSpecEditors[usmCgroupFilterMap] = manager.MapSpecEditor{
+		MaxEntries: uint32(max(len(f.cgroupIDs), 1)),
+		EditorFlag: manager.EditMaxEntries,
+	}
+	options.MapSpecEditors[usmCgroupProtosMap] = manager.MapSpecEditor{
+		MaxEntries: uint32(max(len(f.cgroupProtocols), 1)),
+		EditorFlag: manager.EditMaxEntries,
+	}
+}
+
+// modifiers returns the modifiers required by the filter: without cgroup filters, the calls to
+// bpf_get_current_cgroup_id are removed so that the programs keep loading on kernels older than 4.18.
+func (f *usmFilter) modifiers() []ddebpf.Modifier {
+	if len(f.cgroupIDs) > 0 || len(f.cgroupProtocols) > 0 {
+		return nil
+	}
+	return []ddebpf.Modifier{ddebpf.NewHelperCallRemover(asm.FnGetCurrentCgroupId)}
+}
+
+// populate writes the monitored ports and cgroups to the filter maps
+func (f *usmFilter) populate(m *manager.Manager) error {
+	if f.hasPorts {
+		portsMap, err := maps.GetMap[uint32, uint64](m, usmPortFilterMap)
+		if err != nil {
+			return fmt.Errorf("error retrieving the bpf %s map: %w", usmPortFilterMap, err)
+		}
+		for i := range f.ports {
+			if f.ports[i] == 0 {
+				continue
+			}
+			key := uint32(i)
+			if err := portsMap.Put(&key, &f.ports[i]); err != nil {
+				return fmt.Errorf("error updating the bpf %s map: %w", usmPortFilterMap, err)
+			}
+		}
+	}
+
+	if len(f.cgroupIDs) > 0 {
+		cgroupsMap, err := maps.GetMap[uint64, uint8](m, usmCgroupFilterMap)
+		if err != nil {
+			return fmt.Errorf("error retrieving the bpf %s map: %w", usmCgroupFilterMap, err)
+		}
+		monitored := uint8(1)
+		for i := range f.cgroupIDs {
+			if err := cgroupsMap.Put(&f.cgroupIDs[i], &monitored); err != nil {
+				return fmt.Errorf("error updating the bpf %s map: %w", usmCgroupFilterMap, err)
+			}
+		}
+	}
+
+	if len(f.cgroupProtocols) > 0 {
+		protocolsMap, err := maps.GetMap[uint64, uint32](m, usmCgroupProtosMap)
+		if err != nil {
+			return fmt.Errorf("error retrieving the bpf %s map: %w", usmCgroupProtosMap, err)
+		}
+		for id, bitmap := range f.cgroupProtocols {
+			if err := protocolsMap.Put(&id, &bitmap); err != nil {
+				return fmt.Errorf("error updating the bpf %s map: %w", usmCgroupProtosMap, err)
+			}
+		}
+	}
+	return nil
+}
@@ -0,0 +1,46 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux_bpf
+
+package usm
+
+import (
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+	"github.com/stretchr/testify/require"
+
+	"github.com/DataDog/datadog-agent/pkg/network/config"
+)
+
+func TestUSMFilterPorts(t *testing.T) {
+	cfg := config.New()
+	cfg.USMMonitoredPorts = []string{"443", "8000-8064", "invalid", "0"}
+	f := newUSMFilter(cfg)
+
+	monitored := func(port uint16) bool {
+		return f.ports[port/64]&(1<<(port%64)) != 0
+	}
+	assert.True(t, f.hasPorts)
+	assert.True(t, monitored(443))
+	assert.True(t, monitored(8000))
+	assert.True(t, monitored(8064))
+	assert.False(t, monitored(80))
+	assert.False(t, monitored(8065))
+	assert.False(t, monitored(0))
+	assert.Len(t, f.modifiers(), 1)
+
+	assert.False(t, newUSMFilter(config.New()).hasPorts)
+}
+
+func TestUSMFilterProtocolsBitmap(t *testing.T) {
+	bitmap, err := protocolsBitmap([]string{"http", "kafka"})
+	require.NoError(t, err)
+	assert.Equal(t, uint32(1<<1|1<<3), bitmap)
+
+	_, err = protocolsBitmap([]string{"http2", "smtp"})
+	assert.Error(t, err)
+}
@@ -515,6 +515,44 @@ func (s *usmGRPCSuite) TestLargeBodiesGRPCScenarios() {
 	}
 }
 
+func (s *usmGRPCSuite) TestGRPCStatusCodes() {
+	t := s.T()
+
+	srv, cancel := grpc.NewGRPCTLSServer(t, srvAddr, s.isTLS)
+	t.Cleanup(cancel)
+
+	usmMonitor := setupUSMTLSMonitor(t, s.getConfig())
+	if s.isTLS {
+		utils.WaitForProgramsToBeTraced(t, "go-tls", srv.Process.Pid)
+	}
+
+	clients, cleanup := getGRPCClientsArray(t, 1, s.isTLS)
+	const requests = 100
+	for i := 0; i < requests; i++ {
+		require.NoError(t, clients[0].HandleUnary(context.Background(), "first"))
+	}
+	cleanup()
+
+	// Every call succeeded, so all of them must be reported with the OK (0) status.
+	count := 0
+	assert.Eventually(t, func() bool {
+		stats, ok := usmMonitor.GetProtocolStats()[protocols.GRPC]
+		if !ok {
+			return false
+		}
+		for key, stat := range stats.(map[http2.GRPCKey]*http2.GRPCStat) {
+			if key.DstPort != 5050 && key.SrcPort != 5050 {
+				continue
+			}
+			if !assert.Zero(t, key.Status, "unexpected gRPC status") {
+				return false
+			}
+			count += stat.Count
+		}
+		return count >= requests-1 && count <= requests
+	}, time.Second*5, time.Millisecond*100, "expected ~%d gRPC OK statuses, captured %d", requests, &count)
+}
+
 func (s *usmGRPCSuite) testGRPCScenarios(t *testing.T, srvPID int, runClientCallback func(*testing.T, int), expectedEndpoints map[http.Key]captureRange, clientCount int) {
 	usmMonitor := setupUSMTLSMonitor(t, s.getConfig())
 	if s.isTLS {
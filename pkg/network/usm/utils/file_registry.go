@@ -12,6 +12,7 @@ import (
 	"fmt"
 	"os"
 	"sync"
+	"time"
 
 	"github.com/hashicorp/golang-lru/v2/simplelru"
 
@@ -41,6 +42,11 @@ import (
 // PID 60 opens /foobar => no callback is executed; /foobar references=2
 // PID 50 terminates => no callback is executed; /foobar references=1
 // PID 60 terminates => *deactivation* callback is executed; /foobar references=0
+//
+// With a deactivation delay, see SetDeactivationDelay, the deactivation
+// callback of a file is only executed once it stayed unreferenced for the
+// delay, a file referenced again before that is reused without executing its
+// activation callback.
 type FileRegistry struct {
 	m        sync.RWMutex
 	stopped  bool
@@ -48,6 +54,11 @@ type FileRegistry struct {
 	byID     map[PathIdentifier]*registration
 	byPID    map[uint32]pathIdentifierSet
 
+	// files without references whose deactivation is delayed, by the time they
+	// lost their last reference
+	deactivationDelay time.Duration
+	inactiveByID      map[PathIdentifier]time.Time
+
 	// if we can't execute a callback for a given file we don't try more than once
 	blocklistByID *simplelru.LRU[PathIdentifier, struct{}]
 
@@ -91,6 +102,7 @@ func NewFileRegistry(programName string) *FileRegistry {
 		procRoot:      kernel.ProcFSRoot(),
 		byID:          make(map[PathIdentifier]*registration),
 		byPID:         make(map[uint32]pathIdentifierSet),
+		inactiveByID:  make(map[PathIdentifier]time.Time),
 		blocklistByID: blocklistByID,
 		telemetry:     newRegistryTelemetry(programName),
 	}
@@ -102,6 +114,14 @@ func NewFileRegistry(programName string) *FileRegistry {
 	return r
 }
 
+// SetDeactivationDelay delays the deactivation of the files that lost their
+// last reference, so that the files of short-lived processes, which are
+// referenced again shortly after, don't go through their deactivation and
+// activation callbacks every time. It must be called before any registration.
+func (r *FileRegistry) SetDeactivationDelay(delay time.Duration) {
+	r.deactivationDelay = delay
+}
+
 var (
 	errPidIsNotRegistered      = errors.New("pid is not registered")
 	errCallbackIsMissing       = errors.New("activationCB and deactivationCB must be both non-nil")
@@ -139,7 +159,15 @@ func (r *FileRegistry) Register(namespacedPath string, pid uint32, activationCB,
 		}
 	}
 
+	r.deactivateExpired(time.Now())
+
 	if reg, found := r.byID[pathID]; found {
+		if _, found := r.inactiveByID[pathID]; found {
+			// the file lost its last reference less than deactivationDelay ago, it is still active
+			delete(r.inactiveByID, pathID)
+			reg.uniqueProcessesCount.Store(0)
+			r.telemetry.fileReactivated.Add(1)
+		}
 		if _, found := r.byPID[pid][pathID]; !found {
 			reg.uniqueProcessesCount.Inc()
 			// can happen if a new process opens an already active file
@@ -201,23 +229,58 @@ func (r *FileRegistry) Unregister(pid uint32) error {
 		return errPidIsNotRegistered
 	}
 
+	now := time.Now()
 	for pathID := range paths {
 		reg, found := r.byID[pathID]
 		if !found {
 			r.telemetry.fileUnregisterPathIDNotFound.Add(1)
 			continue
 		}
+		if r.deactivationDelay > 0 && reg.uniqueProcessesCount.Load() == 1 {
+			// keep the registration until deactivateExpired, unless a process references the file again
+			r.inactiveByID[pathID] = now
+			continue
+		}
 		if reg.unregisterPath(pathID) {
 			// we need to clean up our entries as there are no more processes using this ELF
 			delete(r.byID, pathID)
 		}
 	}
 	delete(r.byPID, pid)
+	r.deactivateExpired(now)
 	r.telemetry.totalFiles.Set(int64(len(r.byID)))
 	r.telemetry.totalPIDs.Set(int64(len(r.byPID)))
 	return nil
 }
 
+// deactivateExpired executes the deactivation callback of the files that stayed
+// unreferenced for deactivationDelay. Must be called with the lock held.
+func (r *FileRegistry) deactivateExpired(now time.Time) {
+	for pathID, since := range r.inactiveByID {
+		if now.Sub(since) < r.deactivationDelay {
+			continue
+		}
+		delete(r.inactiveByID, pathID)
+		if reg, found := r.byID[pathID]; found && reg.unregisterPath(pathID) {
+			delete(r.byID, pathID)
+		}
+	}
+}
+
+// DeactivateExpired executes the deactivation callback of the files that stayed
+// unreferenced for the deactivation delay, it is meant to be called
+// periodically when the registry is used with a deactivation delay.
+func (r *FileRegistry) DeactivateExpired() {
+	r.m.Lock()
+	defer r.m.Unlock()
+	if r.stopped {
+		return
+	}
+
+	r.deactivateExpired(time.Now())
+	r.telemetry.totalFiles.Set(int64(len(r.byID)))
+}
+
 // GetRegisteredProcesses returns a set with all PIDs currently being tracked by
 // the `FileRegistry`
 func (r *FileRegistry) GetRegisteredProcesses() map[uint32]struct{} {
@@ -316,6 +379,7 @@ type registryTelemetry struct {
 	// a file can be :
 	//  o Registered : it's a new file
 	//  o AlreadyRegistered : we have already hooked (uprobe) this file (unique by pathID)
+	//  o Reactivated : the file was referenced again before its delayed deactivation, see SetDeactivationDelay
 	//  o HookFailed : uprobe registration failed for one file
 	//  o Blocked : previous uprobe registration failed, so we block further call
 	//  o Unregistered : a file hook is unregistered, meaning there are no more refcount to the corresponding pathID
@@ -324,6 +388,7 @@ type registryTelemetry struct {
 	//  o UnregisterPathIDNotFound : we can't find the pathID registration, it's a bug, this value should be always 0
 	fileRegistered               *telemetry.Counter
 	fileAlreadyRegistered        *telemetry.Counter
+	fileReactivated              *telemetry.Counter
 	fileHookFailed               *telemetry.Counter
 	fileBlocked                  *telemetry.Counter
 	fileUnregistered             *telemetry.Counter
@@ -350,6 +415,7 @@ func newRegistryTelemetry(programName string) registryTelemetry {
 		fileHookFailed:               metricGroup.NewCounter("hook_failed"),
 		fileRegistered:               metricGroup.NewCounter("registered"),
 		fileAlreadyRegistered:        metricGroup.NewCounter("already_registered"),
+		fileReactivated:              metricGroup.NewCounter("reactivated"),
 		fileBlocked:                  metricGroup.NewCounter("blocked"),
 		fileUnregistered:             metricGroup.NewCounter("unregistered"),
 		fileUnregisterErrors:         metricGroup.NewCounter("unregister_errors"),
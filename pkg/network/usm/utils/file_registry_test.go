@@ -13,6 +13,7 @@ import (
 	"path/filepath"
 	"strconv"
 	"testing"
+	"time"
 
 	"github.com/stretchr/testify/assert"
 	"github.com/stretchr/testify/require"
@@ -86,6 +87,45 @@ func TestMultiplePIDsSharingSameFile(t *testing.T) {
 	assert.Equal(t, int64(1), r.telemetry.fileUnregistered.Get())
 }
 
+func TestDelayedDeactivation(t *testing.T) {
+	registerRecorder := new(CallbackRecorder)
+	registerCallback := registerRecorder.Callback()
+
+	unregisterRecorder := new(CallbackRecorder)
+	unregisterCallback := unregisterRecorder.Callback()
+
+	r := newFileRegistry()
+	r.SetDeactivationDelay(time.Hour)
+	path, pathID := createTempTestFile(t, "foobar")
+
+	cmd1, err := testutil.OpenFromAnotherProcess(t, path)
+	require.NoError(t, err)
+	cmd2, err := testutil.OpenFromAnotherProcess(t, path)
+	require.NoError(t, err)
+
+	pid1 := uint32(cmd1.Process.Pid)
+	pid2 := uint32(cmd2.Process.Pid)
+
+	// The file stays active once pid1 terminated, and is reused by pid2
+	require.NoError(t, r.Register(path, pid1, registerCallback, unregisterCallback))
+	require.NoError(t, r.Unregister(pid1))
+	assert.Equal(t, 0, unregisterRecorder.CallsForPathID(pathID))
+	require.Equal(t, errPathIsAlreadyRegistered, r.Register(path, pid2, registerCallback, unregisterCallback))
+	assert.Equal(t, 1, registerRecorder.CallsForPathID(pathID))
+	assert.Equal(t, int64(1), r.telemetry.fileReactivated.Get())
+
+	// The file is only deactivated once it stayed unreferenced for the delay
+	require.NoError(t, r.Unregister(pid2))
+	r.DeactivateExpired()
+	assert.Equal(t, 0, unregisterRecorder.CallsForPathID(pathID))
+
+	r.deactivationDelay = time.Nanosecond
+	r.DeactivateExpired()
+	assert.Equal(t, 1, unregisterRecorder.CallsForPathID(pathID))
+	assert.Empty(t, r.byID)
+	assert.Equal(t, int64(1), r.telemetry.fileUnregistered.Get())
+}
+
 func TestRepeatedRegistrationsFromSamePID(t *testing.T) {
 	registerRecorder := new(CallbackRecorder)
 	registerCallback := registerRecorder.Callback()
@@ -95,6 +95,9 @@ type RuntimeSecurityConfig struct {
 	// ActivityDumpTracedCgroupsCount defines the maximum count of cgroups that should be monitored concurrently. Leave this parameter to 0 to prevent the generation
 	// of activity dumps based on cgroups.
 	ActivityDumpTracedCgroupsCount int
+	// ActivityDumpCgroupOnly restricts the activity dumps to the ones of cgroups, so that the kernel doesn't look up the
+	// comm of the processes on each event. The dumps of a comm can't be requested in this mode.
+	ActivityDumpCgroupOnly bool
 	// ActivityDumpTracedEventTypes defines the list of events that should be captured in an activity dump. Leave this
 	// parameter empty to monitor all event types. If not already present, the `exec` event will automatically be added
 	// to this list.
@@ -103,6 +106,9 @@ type RuntimeSecurityConfig struct {
 	ActivityDumpCgroupDumpTimeout time.Duration
 	// ActivityDumpRateLimiter defines the kernel rate of max events per sec for activity dumps.
 	ActivityDumpRateLimiter int
+	// ActivityDumpEventTypesRateLimiter defines the kernel rate of max events per sec of each file event type for
+	// activity dumps, overriding ActivityDumpRateLimiter. Each event type has its own budget.
+	ActivityDumpEventTypesRateLimiter map[model.EventType]int
 	// ActivityDumpCgroupWaitListTimeout defines the time to wait before a cgroup can be dumped again.
 	ActivityDumpCgroupWaitListTimeout time.Duration
 	// ActivityDumpCgroupDifferentiateArgs defines if system-probe should differentiate process nodes using process
@@ -337,9 +343,11 @@ func NewRuntimeSecurityConfig() (*RuntimeSecurityConfig, error) {
 		ActivityDumpLoadControlPeriod:         coreconfig.SystemProbe.GetDuration("runtime_security_config.activity_dump.load_controller_period"),
 		ActivityDumpLoadControlMinDumpTimeout: coreconfig.SystemProbe.GetDuration("runtime_security_config.activity_dump.min_timeout"),
 		ActivityDumpTracedCgroupsCount:        coreconfig.SystemProbe.GetInt("runtime_security_config.activity_dump.traced_cgroups_count"),
+		ActivityDumpCgroupOnly:                coreconfig.SystemProbe.GetBool("runtime_security_config.activity_dump.cgroup_only"),
 		ActivityDumpTracedEventTypes:          parseEventTypeStringSlice(coreconfig.SystemProbe.GetStringSlice("runtime_security_config.activity_dump.traced_event_types")),
 		ActivityDumpCgroupDumpTimeout:         coreconfig.SystemProbe.GetDuration("runtime_security_config.activity_dump.dump_duration"),
 		ActivityDumpRateLimiter:               coreconfig.SystemProbe.GetInt("runtime_security_config.activity_dump.rate_limiter"),
+		ActivityDumpEventTypesRateLimiter:     parseEventTypeInts(coreconfig.SystemProbe, "runtime_security_config.activity_dump.event_types_rate_limiter"),
 		ActivityDumpCgroupWaitListTimeout:     coreconfig.SystemProbe.GetDuration("runtime_security_config.activity_dump.cgroup_wait_list_timeout"),
 		ActivityDumpCgroupDifferentiateArgs:   coreconfig.SystemProbe.GetBool("runtime_security_config.activity_dump.cgroup_differentiate_args"),
 		ActivityDumpLocalStorageDirectory:     coreconfig.SystemProbe.GetString("runtime_security_config.activity_dump.local_storage.output_directory"),
@@ -563,6 +571,16 @@ func parseEventTypeDurations(cfg coreconfig.Config, prefix string) map[model.Eve
 	return eventTypeDurations
 }
 
+// parseEventTypeInts converts a map of integers indexed by event types
+func parseEventTypeInts(cfg coreconfig.Config, prefix string) map[model.EventType]int {
+	eventTypeMap := cfg.GetStringMap(prefix)
+	eventTypeInts := make(map[model.EventType]int, len(eventTypeMap))
+	for eventType := range eventTypeMap {
+		eventTypeInts[ParseEvalEventType(eventType)] = cfg.GetInt(prefix + "." + eventType)
+	}
+	return eventTypeInts
+}
+
 // parseHashAlgorithmStringSlice converts a string list to a list of hash algorithms
 func parseHashAlgorithmStringSlice(algorithms []string) []model.HashAlgorithm {
 	var output []model.HashAlgorithm
@@ -6,6 +6,7 @@
 #define TTY_NAME_LEN 64
 #define CONTAINER_ID_LEN 64
 #define MAX_XATTR_NAME_LEN 200
+#define MAX_XATTR_DEDUP_VALUE_LEN 64
 #define CHAR_TO_UINT32_BASE_10_MAX_LEN 11
 #define BASENAME_FILTER_SIZE 256
 #define FSTYPE_LEN 16
@@ -15,6 +16,11 @@
 #define PID_DISCARDER_TYPE 1
 #define BASENAME_APPROVER_TYPE 0
 #define FLAG_APPROVER_TYPE 1
+#define PREFIX_APPROVER_TYPE 2
+#define PREFIX_FILTER_SIZE 128
+#define PREFIX_APPROVER_MAX_DEPTH 16
+#define PREFIX_APPROVER_MAX_MOUNTS 4
+#define KILL_RULE_CONTAINER_ONLY (1 << 0)
 
 enum MONITOR_KEYS {
     ERPC_MONITOR_KEY = 1,
@@ -23,8 +29,16 @@ enum MONITOR_KEYS {
 };
 
 #define PATH_ID_MAP_SIZE 512
+#define INODE_PATH_ID_FLAG (1 << 31) // distinguishes the path ids of the inodes from the ones of the mounts
+
+// path id invalidation modes
+#define PATH_ID_INVALIDATE_MOUNT 1 // the names of all the inodes of the mount may have changed
+#define PATH_ID_INVALIDATE_INODE 2 // only the name of the inode changed
+#define AD_RL_EVENT_TYPES 16 // must cover the discarder event types
 
 #define MAX_PERF_STR_BUFF_LEN 256
+#define MAX_RINGBUF_STR_BUFF_LEN 4096 // must be a power of 2, see parse_args_envs_batched
+#define ENV_PREFIX_MAX_LEN 32
 #define MAX_STR_BUFF_LEN (1 << 15)
 #define MAX_ARRAY_ELEMENT_SIZE 4096
 #define MAX_ARRAY_ELEMENT_PER_TAIL 27
@@ -54,6 +68,7 @@ enum DENTRY_RESOLVER_KEYS {
 };
 
 #define DR_ERPC_BUFFER_LENGTH 8*4096
+#define DR_ERPC_MAX_BATCH 8 // number of paths of a batch request, each one is resolved in its own slot of the buffer
 
 enum DENTRY_ERPC_RESOLUTION_CODE {
     DR_ERPC_OK,
@@ -72,7 +87,14 @@ enum TC_TAIL_CALL_KEYS {
     IMDS_REQUEST,
 };
 
+#define MPROTECT_VM_WRITE 0x2 // VM_WRITE
+#define MPROTECT_PROT_EXEC 0x4 // PROT_EXEC
+
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
 #define DNS_MAX_LENGTH 256
+#define DNS_MAX_REPEAT_COUNT 0xFFFF
 #define DNS_EVENT_KEY 0
 
 #define EGRESS 1
@@ -80,8 +102,14 @@ enum TC_TAIL_CALL_KEYS {
 #define ACT_OK TC_ACT_UNSPEC
 #define ACT_SHOT TC_ACT_SHOT
 #define PACKET_KEY 0
+#define FLOW_VERDICT_SKIP 1
 #define IMDS_EVENT_KEY 0
 #define IMDS_MAX_LENGTH 2048
+// userspace drops the payloads shorter than this
+#define IMDS_MIN_LENGTH 10
+// fd00:ec2::254, the IPv6 address of the AWS IMDS
+#define IMDS_IPV6_PREFIX 0xfd000ec2
+#define IMDS_IPV6_SUFFIX 0x254
 
 #define STATE_NULL 0
 #define STATE_NEWLINK 1
@@ -126,12 +154,25 @@ enum TC_TAIL_CALL_KEYS {
 #define MAX_SYSCALL_ARG_MAX_SIZE 128
 #define MAX_SYSCALL_CTX_SIZE MAX_SYSCALL_ARG_MAX_SIZE*3 + 4 + 1 // id + types octet + 3 args
 
+// is_activity_dumps_enabled lets the verifier drop the activity dump paths when the feature is disabled
+__attribute__((always_inline)) u64 is_activity_dumps_enabled() {
+    u64 activity_dumps_enabled;
+    LOAD_CONSTANT("activity_dumps_enabled", activity_dumps_enabled);
+    return activity_dumps_enabled != 0;
+}
+
 __attribute__((always_inline)) u64 is_cgroup_activity_dumps_enabled() {
     u64 cgroup_activity_dumps_enabled;
     LOAD_CONSTANT("cgroup_activity_dumps_enabled", cgroup_activity_dumps_enabled);
     return cgroup_activity_dumps_enabled != 0;
 }
 
+__attribute__((always_inline)) u64 is_activity_dump_cgroup_only() {
+    u64 cgroup_only;
+    LOAD_CONSTANT("activity_dump_cgroup_only", cgroup_only);
+    return cgroup_only != 0;
+}
+
 #define CGROUP_DEFAULT  1
 #define CGROUP_CENTOS_7 2
 
@@ -147,6 +188,42 @@ static __attribute__((always_inline)) u64 get_discarder_retention() {
     return retention ? retention : SEC_TO_NS(5);
 }
 
+static __always_inline u64 is_priority_ring_buffer_used() {
+    u64 used = 0;
+    LOAD_CONSTANT("use_priority_ring_buffer", used);
+    return used;
+}
+
+static __always_inline u64 is_args_envs_batched() {
+    u64 batched = 0;
+    LOAD_CONSTANT("args_envs_batched", batched);
+    return batched;
+}
+
+static __always_inline u64 is_envs_filter_enabled() {
+    u64 enabled = 0;
+    LOAD_CONSTANT("envs_filter_enabled", enabled);
+    return enabled;
+}
+
+static __attribute__((always_inline)) u64 get_events_stats_sampling_mask() {
+    u64 mask;
+    LOAD_CONSTANT("events_stats_sampling_mask", mask);
+    return mask;
+}
+
+static __attribute__((always_inline)) u64 get_discarder_probation_threshold() {
+    u64 threshold = 0;
+    LOAD_CONSTANT("discarder_probation_threshold", threshold);
+    return threshold;
+}
+
+static __attribute__((always_inline)) u64 get_discarder_probation_window() {
+    u64 window = 0;
+    LOAD_CONSTANT("discarder_probation_window", window);
+    return window ? window : SEC_TO_NS(1);
+}
+
 static __always_inline u32 is_runtime_discarded() {
     u64 discarded = 0;
     LOAD_CONSTANT("runtime_discarded", discarded);
@@ -185,6 +262,48 @@ static __attribute__((always_inline)) u64 is_anomaly_syscalls_enabled() {
     return anomaly;
 };
 
+static __attribute__((always_inline)) u64 get_jit_mprotect_threshold() {
+    u64 threshold = 0;
+    LOAD_CONSTANT("jit_mprotect_threshold", threshold);
+    return threshold;
+}
+
+static __attribute__((always_inline)) u64 get_jit_mprotect_summary_period() {
+    u64 period = 0;
+    LOAD_CONSTANT("jit_mprotect_summary_period", period);
+    return period ? period : SEC_TO_NS(10);
+}
+
+static __attribute__((always_inline)) u64 get_dns_dedup_window() {
+    u64 window = 0;
+    LOAD_CONSTANT("dns_dedup_window", window);
+    return window;
+}
+
+static __attribute__((always_inline)) u64 get_setxattr_dedup_window() {
+    u64 window = 0;
+    LOAD_CONSTANT("setxattr_dedup_window", window);
+    return window;
+}
+
+static __attribute__((always_inline)) u64 is_credentials_dedup_enabled() {
+    u64 enabled = 0;
+    LOAD_CONSTANT("credentials_dedup", enabled);
+    return enabled;
+}
+
+static __attribute__((always_inline)) u64 is_syscall_ctx_rules_only() {
+    u64 enabled = 0;
+    LOAD_CONSTANT("syscall_ctx_rules_only", enabled);
+    return enabled;
+}
+
+static __attribute__((always_inline)) u64 get_span_event_mask() {
+    u64 mask = 0;
+    LOAD_CONSTANT("span_event_mask", mask);
+    return mask;
+}
+
 static __attribute__((always_inline)) u64 get_imds_ip() {
     u64 imds_ip;
     LOAD_CONSTANT("imds_ip", imds_ip);
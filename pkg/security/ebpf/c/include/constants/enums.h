@@ -74,6 +74,8 @@ enum {
 enum {
     ACTIVITY_DUMP_RUNNING = 1<<0, // defines if an activity dump is running
     SAVED_BY_ACTIVITY_DUMP = 1<<1, // defines if the dentry should have been discarded, but was saved because of an activity dump
+    DR_CACHED_PATH = 1<<2, // defines if the dentry resolver follows the pathnames entries of an already resolved path
+    DR_D_PATH = 1<<3, // defines if the path was already resolved by bpf_d_path, only the leaf discarder is checked
 };
 
 enum policy_mode {
@@ -87,6 +89,7 @@ enum policy_flags {
     FLAGS = 2,
     MODE = 4,
     PARENT_NAME = 8,
+    PREFIX = 16,
 };
 
 enum tls_format {
@@ -176,6 +179,8 @@ enum erpc_op {
     BUMP_DISCARDERS_REVISION,
     GET_RINGBUF_USAGE,
     USER_SESSION_CONTEXT_OP,
+    RESOLVE_PATHS_OP,
+    REJECT_DISCARDER_PROBATION_OP,
 };
 
 enum selinux_source_event_t {
@@ -79,6 +79,12 @@ int __attribute__((always_inline)) get_vfsmount_mount_flags(struct vfsmount *mnt
     return mount_flags;
 }
 
+struct vfsmount * __attribute__((always_inline)) get_path_vfsmount(struct path *path) {
+    struct vfsmount *mnt;
+    bpf_probe_read(&mnt, sizeof(mnt), &path->mnt);
+    return mnt;
+}
+
 int __attribute__((always_inline)) get_path_mount_flags(struct path *path) {
     struct vfsmount *mnt;
     bpf_probe_read(&mnt, sizeof(mnt), &path->mnt);
@@ -93,6 +99,12 @@ int __attribute__((always_inline)) get_mount_mount_id(void *mnt) {
     return mount_id;
 }
 
+struct mount * __attribute__((always_inline)) get_mount_parent(struct mount *mnt) {
+    struct mount *parent;
+    bpf_probe_read(&parent, sizeof(parent), (char *)mnt + 16);
+    return parent;
+}
+
 struct dentry * __attribute__((always_inline)) get_mount_mountpoint_dentry(struct mount *mnt) {
     struct dentry *dentry;
     bpf_probe_read(&dentry, sizeof(dentry), (char *)mnt + 24);
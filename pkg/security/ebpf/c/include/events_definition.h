@@ -15,7 +15,7 @@ struct bind_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     u64 addr[2];
@@ -27,7 +27,7 @@ struct bpf_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     struct bpf_map_t map;
@@ -43,11 +43,18 @@ struct args_envs_event_t {
     char value[MAX_PERF_STR_BUFF_LEN];
 };
 
+struct args_envs_batch_event_t {
+    struct kevent_t event;
+    u32 id;
+    u32 size;
+    char value[MAX_RINGBUF_STR_BUFF_LEN * 2 + MAX_ARRAY_ELEMENT_SIZE];
+};
+
 struct process_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_context_t syscall_ctx;
     struct process_entry_t proc_entry;
     struct pid_cache_t pid_entry;
@@ -62,7 +69,7 @@ struct exit_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     u32 exit_code;
 };
 
@@ -70,7 +77,7 @@ struct setuid_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     u32 uid;
     u32 euid;
     u32 fsuid;
@@ -80,7 +87,7 @@ struct setgid_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     u32 gid;
     u32 egid;
     u32 fsgid;
@@ -90,7 +97,7 @@ struct capset_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     u64 cap_effective;
     u64 cap_permitted;
 };
@@ -106,7 +113,7 @@ struct utimes_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct file_t file;
     struct ktimeval atime, mtime;
@@ -116,7 +123,7 @@ struct chmod_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct syscall_context_t syscall_ctx;
     struct file_t file;
@@ -128,7 +135,7 @@ struct chown_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct file_t file;
     uid_t uid;
@@ -139,7 +146,7 @@ struct mmap_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     struct file_t file;
@@ -154,7 +161,7 @@ struct dns_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct network_context_t network;
 
     u16 id;
@@ -162,6 +169,7 @@ struct dns_event_t {
     u16 qtype;
     u16 qclass;
     u16 size;
+    u16 repeat_count;
     char name[DNS_MAX_LENGTH];
 };
 
@@ -169,7 +177,7 @@ struct imds_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct network_context_t network;
 
     u8 body[IMDS_MAX_LENGTH];
@@ -179,7 +187,7 @@ struct link_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct file_t source;
     struct file_t target;
@@ -189,7 +197,7 @@ struct mkdir_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct file_t file;
     u32 mode;
@@ -200,7 +208,7 @@ struct init_module_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     struct file_t file;
@@ -215,7 +223,7 @@ struct delete_module_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     char name[MODULE_NAME_LEN];
@@ -225,7 +233,7 @@ struct mount_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct mount_fields_t mountfields;
 };
@@ -239,20 +247,22 @@ struct mprotect_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     u64 vm_start;
     u64 vm_end;
     u64 vm_protection;
     u64 req_protection;
+    u32 suppressed_count;
+    u32 padding;
 };
 
 struct net_device_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     struct device_t device;
@@ -262,7 +272,7 @@ struct veth_pair_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     struct device_t host_device;
@@ -273,18 +283,23 @@ struct open_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct file_t file;
     u32 flags;
     u32 mode;
 };
 
+struct open_d_path_event_t {
+    struct open_event_t open;
+    struct dr_d_path_t d_path;
+};
+
 struct ptrace_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     u32 request;
@@ -296,7 +311,7 @@ struct syscall_monitor_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
 
     union {
         struct syscall_monitor_entry_t syscalls;
@@ -308,7 +323,7 @@ struct rename_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct file_t old;
     struct file_t new;
@@ -318,7 +333,7 @@ struct rmdir_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct file_t file;
 };
@@ -327,7 +342,7 @@ struct selinux_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct file_t file;
     u32 event_kind;
     union selinux_write_payload_t payload;
@@ -337,7 +352,7 @@ struct setxattr_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct file_t file;
     char name[MAX_XATTR_NAME_LEN];
@@ -347,7 +362,7 @@ struct signal_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     u32 pid;
@@ -358,7 +373,7 @@ struct splice_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
 
     struct file_t file;
@@ -370,7 +385,7 @@ struct umount_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     u32 mount_id;
 };
@@ -379,7 +394,7 @@ struct unlink_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct file_t file;
     u32 flags;
@@ -390,7 +405,7 @@ struct chdir_event_t {
     struct kevent_t event;
     struct process_context_t process;
     struct span_context_t span;
-    struct container_context_t container;
+    struct container_key_context_t container;
     struct syscall_t syscall;
     struct syscall_context_t syscall_ctx;
     struct file_t file;
@@ -12,6 +12,10 @@
 #include "process.h"
 
 __attribute__((always_inline)) struct activity_dump_config *lookup_or_delete_traced_pid(u32 pid, u64 now, u64 *cookie) {
+    if (!is_activity_dumps_enabled()) {
+        return NULL;
+    }
+
     if (cookie == NULL) {
         cookie = bpf_map_lookup_elem(&traced_pids, &pid);
     }
@@ -43,6 +47,14 @@ __attribute__((always_inline)) struct activity_dump_config *lookup_or_delete_tra
     return config;
 }
 
+// set_traced_pid attaches a pid to a dump, without writing to traced_pids when the pid is already attached to it
+__attribute__((always_inline)) void set_traced_pid(u32 pid, u64 cookie) {
+    u64 *current = bpf_map_lookup_elem(&traced_pids, &pid);
+    if (current == NULL || *current != cookie) {
+        bpf_map_update_elem(&traced_pids, &pid, &cookie, BPF_ANY);
+    }
+}
+
 __attribute__((always_inline)) struct cgroup_tracing_event_t *get_cgroup_tracing_event() {
     u32 key = bpf_get_current_pid_tgid() % EVENT_GEN_SIZE;
     struct cgroup_tracing_event_t *evt = bpf_map_lookup_elem(&cgroup_tracing_event_gen, &key);
@@ -141,7 +153,7 @@ __attribute__((always_inline)) u64 should_trace_new_process_comm(void *ctx, u64
     }
 
     // we're still tracing this comm, update the pid cookie
-    bpf_map_update_elem(&traced_pids, &pid, &cookie_val, BPF_ANY);
+    set_traced_pid(pid, cookie_val);
     return cookie_val;
 }
 
@@ -181,7 +193,7 @@ __attribute__((always_inline)) u64 should_trace_new_process_cgroup(void *ctx, u6
             }
 
             // We're still tracing this cgroup, update the pid cookie
-            bpf_map_update_elem(&traced_pids, &pid, &cookie_val, BPF_ANY);
+            set_traced_pid(pid, cookie_val);
             return cookie_val;
 
         } else {
@@ -217,13 +229,57 @@ union container_id_comm_combo {
     char comm[TASK_COMM_LEN];
 };
 
-__attribute__((always_inline)) u64 should_trace_new_process(void *ctx, u64 now, u32 pid, char* cgroup_p, char* comm_p) {
+// get_cached_cgroup_cookie returns the cookie of the dump of the container last seen by this CPU if it is the
+// container of the process, sparing the lookup of its 64 bytes long ID in traced_cgroups. 0 is returned when the
+// container isn't the cached one or when its dump isn't running anymore, the slow path taking care of the cleanup.
+__attribute__((always_inline)) u64 get_cached_cgroup_cookie(u64 now, u32 pid, u64 container_key, struct activity_dump_cgroup_cache_t *cache) {
+    if (container_key == 0 || cache->container_key != container_key) {
+        return 0;
+    }
+
+    u64 cookie_val = cache->cookie;
+    struct activity_dump_config *config = bpf_map_lookup_elem(&activity_dumps_config, &cookie_val);
+    if (config == NULL || config->paused || now > config->end_timestamp) {
+        cache->container_key = 0;
+        return 0;
+    }
+
+    set_traced_pid(pid, cookie_val);
+    return cookie_val;
+}
+
+__attribute__((always_inline)) u64 should_trace_new_process(void *ctx, u64 now, u32 pid, char* cgroup_p, char* comm_p, u64 container_key) {
+    if (!is_activity_dumps_enabled()) {
+        return 0;
+    }
+
+    // in cgroup only mode, the dumps are only selected by the container of the process
+    struct activity_dump_cgroup_cache_t *cache = NULL;
+    if (is_activity_dump_cgroup_only()) {
+        u32 zero = 0;
+        cache = bpf_map_lookup_elem(&activity_dump_cgroup_cache, &zero);
+        if (cache != NULL) {
+            u64 cookie = get_cached_cgroup_cookie(now, pid, container_key, cache);
+            if (cookie) {
+                return cookie;
+            }
+        }
+    }
+
     // prepare comm and cgroup (for compatibility with old kernels)
     union container_id_comm_combo buffer = {};
 
     bpf_probe_read(&buffer.container_id, sizeof(buffer.container_id), cgroup_p);
     u64 cookie = should_trace_new_process_cgroup(ctx, now, pid, buffer.container_id);
 
+    if (is_activity_dump_cgroup_only()) {
+        if (cookie && container_key && cache != NULL) {
+            cache->container_key = container_key;
+            cache->cookie = cookie;
+        }
+        return cookie;
+    }
+
     // prioritize the cookie from the cgroup to the cookie from the comm
     if (!cookie) {
         bpf_probe_read(&buffer.comm, sizeof(buffer.comm), comm_p);
@@ -232,14 +288,18 @@ __attribute__((always_inline)) u64 should_trace_new_process(void *ctx, u64 now,
     return cookie;
 }
 
-__attribute__((always_inline)) void inherit_traced_state(void *ctx, u32 ppid, u32 pid, char* cgroup_p, char* comm_p) {
+__attribute__((always_inline)) void inherit_traced_state(void *ctx, u32 ppid, u32 pid, char* cgroup_p, char* comm_p, u64 container_key) {
+    if (!is_activity_dumps_enabled()) {
+        return;
+    }
+
     u64 now = bpf_ktime_get_ns();
 
     // check if the parent is traced, update the child timeout if need be
     u64 *ppid_cookie = bpf_map_lookup_elem(&traced_pids, &ppid);
     if (ppid_cookie == NULL) {
         // check if the current pid should be traced
-        should_trace_new_process(ctx, now, pid, cgroup_p, comm_p);
+        should_trace_new_process(ctx, now, pid, cgroup_p, comm_p, container_key);
         return;
     }
 
@@ -277,133 +337,74 @@ __attribute__((always_inline)) void cleanup_traced_state(u32 pid) {
     bpf_map_delete_elem(&traced_pids, &pid);
 }
 
-enum rate_limiter_algo_ids {
-    RL_ALGO_BASIC = 0,
-    RL_ALGO_BASIC_HALF,
-    RL_ALGO_DECREASING_DROPRATE,
-    RL_ALGO_INCREASING_DROPRATE,
-    RL_ALGO_TOTAL_NUMBER,
-};
-
-__attribute__((always_inline)) u8 activity_dump_rate_limiter_reset_period(u64 now, struct activity_dump_rate_limiter_ctx* rate_ctx_p) {
-    rate_ctx_p->current_period = now;
-    rate_ctx_p->counter = 0;
-#ifndef __BALOUM__ // do not change algo during unit tests
-    rate_ctx_p->algo_id = now % RL_ALGO_TOTAL_NUMBER;
-#endif /* __BALOUM__ */
-    return 1;
-}
-
-__attribute__((always_inline)) u8 activity_dump_rate_limiter_allow_basic(struct activity_dump_config *config, u64 now, struct activity_dump_rate_limiter_ctx* rate_ctx_p, u64 delta) {
-    if (delta > 1000000000) { // if more than 1 sec ellapsed we reset the period
-        return activity_dump_rate_limiter_reset_period(now, rate_ctx_p);
-    }
-
-    if (rate_ctx_p->counter >= config->events_rate) { // if we already allowed more than rate
-        return 0;
-    } else {
-        return 1;
-    }
-}
-
-__attribute__((always_inline)) u8 activity_dump_rate_limiter_allow_basic_half(struct activity_dump_config *config, u64 now, struct activity_dump_rate_limiter_ctx* rate_ctx_p, u64 delta) {
-    if (delta > 1000000000 / 2) { // if more than 0.5 sec ellapsed we reset the period
-        return activity_dump_rate_limiter_reset_period(now, rate_ctx_p);
-    }
-
-    if (rate_ctx_p->counter >= config->events_rate / 2) { // if we already allowed more than rate / 2
-        return 0;
-    } else {
-        return 1;
+__attribute__((always_inline)) u32 get_activity_dump_event_type_rate(struct activity_dump_config *config, u32 event_type) {
+    u32 index = event_type - EVENT_FIRST_DISCARDER;
+    if (index < AD_RL_EVENT_TYPES && config->event_type_rates[index] > 0) {
+        return config->event_type_rates[index];
     }
+    return config->events_rate;
 }
 
-__attribute__((always_inline)) u8 activity_dump_rate_limiter_allow_decreasing_droprate(struct activity_dump_config *config, u64 now, struct activity_dump_rate_limiter_ctx* rate_ctx_p, u64 delta) {
-    if (delta > 1000000000) { // if more than 1 sec ellapsed we reset the period
-        return activity_dump_rate_limiter_reset_period(now, rate_ctx_p);
-    }
-
-    if (rate_ctx_p->counter >= config->events_rate) { // if we already allowed more than rate
+// activity_dump_rate_limiter_allow implements a token bucket per dump and per event type, so that a noisy event type
+// can't exhaust the budget of the others. The bucket holds at most one second of events and is refilled continuously.
+__attribute__((always_inline)) u8 activity_dump_rate_limiter_allow(struct activity_dump_config *config, u64 cookie, u64 now, u32 event_type, u8 should_count) {
+    s64 rate = get_activity_dump_event_type_rate(config, event_type);
+    if (rate == 0) {
         return 0;
-    } else if (rate_ctx_p->counter < (config->events_rate / 4)) { // first 1/4 is not rate limited
-        return 1;
     }
 
-    // if we are between rate / 4 and rate, apply a decreasing rate of:
-    // (counter * 100) / (rate) %
-    else if (now % ((rate_ctx_p->counter * 100) / config->events_rate) == 0) {
+    struct activity_dump_rate_limiter_key_t key = {
+        .cookie = cookie,
+        .event_type = event_type,
+    };
+    struct activity_dump_rate_limiter_ctx *bucket = bpf_map_lookup_elem(&activity_dump_rate_limiters, &key);
+    if (bucket == NULL) {
+        struct activity_dump_rate_limiter_ctx new_bucket = {
+            .last_refill = now,
+            .tokens = rate - should_count,
+        };
+        bpf_map_update_elem(&activity_dump_rate_limiters, &key, &new_bucket, BPF_NOEXIST);
         return 1;
     }
-    return 0;
-}
 
-__attribute__((always_inline)) u8 activity_dump_rate_limiter_allow_increasing_droprate(struct activity_dump_config *config, u64 now, struct activity_dump_rate_limiter_ctx* rate_ctx_p, u64 delta) {
-    if (delta > 1000000000) { // if more than 1 sec ellapsed we reset the period
-        return activity_dump_rate_limiter_reset_period(now, rate_ctx_p);
+    // concurrent refills may race, the error is bounded by the number of CPUs refilling at the same time
+    if (now > bucket->last_refill) {
+        u64 period = SEC_TO_NS(1);
+        u64 delta = now - bucket->last_refill;
+        if (delta >= period) {
+            bucket->tokens = rate;
+            bucket->last_refill = now;
+        } else {
+            s64 refill = delta * rate / period;
+            if (refill > 0) {
+                bucket->tokens = bucket->tokens + refill > rate ? rate : bucket->tokens + refill;
+                // keep the remainder of the elapsed time for the next refill
+                bucket->last_refill += refill * period / rate;
+            }
+        }
     }
 
-    if (rate_ctx_p->counter >= config->events_rate) { // if we already allowed more than rate
+    if (bucket->tokens <= 0) {
         return 0;
-    } else if (rate_ctx_p->counter < (config->events_rate / 4)) { // first 1/4 is not rate limited
-        return 1;
     }
 
-    // if we are between rate / 4 and rate, apply an increasing rate of:
-    // 100 - ((counter * 100) / (rate)) %
-    else if (now % (100 - ((rate_ctx_p->counter * 100) / config->events_rate)) == 0) {
-        return 1;
+    if (should_count) {
+        __sync_fetch_and_add(&bucket->tokens, -1);
     }
-    return 0;
+    return 1;
 }
 
-__attribute__((always_inline)) u8 activity_dump_rate_limiter_allow(struct activity_dump_config *config, u64 cookie, u64 now, u8 should_count) {
-    struct activity_dump_rate_limiter_ctx* rate_ctx_p = bpf_map_lookup_elem(&activity_dump_rate_limiters, &cookie);
-    if (rate_ctx_p == NULL) {
-        struct activity_dump_rate_limiter_ctx rate_ctx = {
-            .current_period = now,
-            .counter = should_count,
-            .algo_id = now % RL_ALGO_TOTAL_NUMBER,
-        };
-        bpf_map_update_elem(&activity_dump_rate_limiters, &cookie, &rate_ctx, BPF_ANY);
-        return 1;
-    }
-
-    if (now < rate_ctx_p->current_period) { // this should never happen, ignore
-        return 0;
-    }
-    u64 delta = now - rate_ctx_p->current_period;
-
-    u8 allow;
-    switch (rate_ctx_p->algo_id) {
-    case RL_ALGO_BASIC:
-        allow = activity_dump_rate_limiter_allow_basic(config, now, rate_ctx_p, delta);
-        break;
-    case RL_ALGO_BASIC_HALF:
-        allow = activity_dump_rate_limiter_allow_basic_half(config, now, rate_ctx_p, delta);
-        break;
-    case RL_ALGO_DECREASING_DROPRATE:
-        allow = activity_dump_rate_limiter_allow_decreasing_droprate(config, now, rate_ctx_p, delta);
-        break;
-    case RL_ALGO_INCREASING_DROPRATE:
-        allow = activity_dump_rate_limiter_allow_increasing_droprate(config, now, rate_ctx_p, delta);
-        break;
-    default: // should never happen, ignore
+__attribute__((always_inline)) u32 is_activity_dump_running(void *ctx, u32 pid, u64 now, u32 event_type) {
+    if (!is_activity_dumps_enabled()) {
         return 0;
     }
 
-    if (allow && should_count) {
-        __sync_fetch_and_add(&rate_ctx_p->counter, 1);
-    }
-    return (allow);
-}
-
-__attribute__((always_inline)) u32 is_activity_dump_running(void *ctx, u32 pid, u64 now, u32 event_type) {
     u64 cookie = 0;
     struct activity_dump_config *config = NULL;
 
     struct proc_cache_t *pc = get_proc_cache(pid);
     if (pc) {
-        cookie = should_trace_new_process(ctx, now, pid, pc->container.container_id, pc->entry.comm);
+        cookie = should_trace_new_process(ctx, now, pid, pc->container.container_id, pc->entry.comm, pc->container_key);
     }
 
     if (cookie != 0) {
@@ -431,7 +432,7 @@ __attribute__((always_inline)) u32 is_activity_dump_running(void *ctx, u32 pid,
         return 0;
     }
 
-    if (!activity_dump_rate_limiter_allow(config, cookie, now, 1)) {
+    if (!activity_dump_rate_limiter_allow(config, cookie, now, event_type, 1)) {
         return 0;
     }
 
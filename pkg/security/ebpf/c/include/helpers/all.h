@@ -9,6 +9,7 @@
 #include "dentry_resolver.h"
 #include "discaders.h"
 #include "dns.h"
+#include "enforcement.h"
 #include "imds.h"
 #include "erpc.h"
 #include "events.h"
@@ -2,6 +2,7 @@
 #define _APPROVERS_H
 
 #include "constants/enums.h"
+#include "constants/offsets/filesystem.h"
 #include "maps.h"
 
 void __attribute__((always_inline)) monitor_event_approved(u64 event_type, u32 approver_type) {
@@ -20,6 +21,8 @@ void __attribute__((always_inline)) monitor_event_approved(u64 event_type, u32 a
         __sync_fetch_and_add(&stats->event_approved_by_basename, 1);
     } else if (approver_type == FLAG_APPROVER_TYPE) {
         __sync_fetch_and_add(&stats->event_approved_by_flag, 1);
+    } else if (approver_type == PREFIX_APPROVER_TYPE) {
+        __sync_fetch_and_add(&stats->event_approved_by_prefix, 1);
     }
 }
 
@@ -37,6 +40,80 @@ int __attribute__((always_inline)) approve_by_basename(struct dentry *dentry, u6
     return 0;
 }
 
+// Approves the events on the files whose path, as resolved in their mount namespace, starts with one of the prefixes of
+// the prefix_approvers trie. The path is built from the dentries and mounts walked up to the namespace root, and the
+// event is approved whenever it can't be fully resolved, so that no event of a prefix is dropped.
+int __attribute__((always_inline)) approve_by_prefix(struct dentry *dentry, struct vfsmount *vfsmount, u64 event_type) {
+    u32 zero = 0;
+    struct prefix_approver_gen_t *gen = bpf_map_lookup_elem(&prefix_approver_gen, &zero);
+    if (!gen || !vfsmount) {
+        return 1;
+    }
+
+    struct mount *mnt = (struct mount *)((char *)vfsmount - MNT_OFFSETOF_MNT);
+    struct dentry *mnt_root = get_vfsmount_dentry(vfsmount);
+    struct dentry *d_parent = NULL;
+    int depth = 0;
+    int resolved = 0;
+
+#pragma unroll
+    for (int i = 0; i < PREFIX_APPROVER_MAX_DEPTH + PREFIX_APPROVER_MAX_MOUNTS; i++) {
+        if (dentry == mnt_root) {
+            struct mount *parent = get_mount_parent(mnt);
+            if (parent == mnt) {
+                resolved = 1;
+                break;
+            }
+
+            // cross to the mountpoint within the parent mount
+            dentry = get_mount_mountpoint_dentry(mnt);
+            mnt = parent;
+            mnt_root = get_vfsmount_dentry(get_mount_vfsmount(mnt));
+            continue;
+        }
+
+        bpf_probe_read(&d_parent, sizeof(d_parent), &dentry->d_parent);
+        if (d_parent == dentry || depth >= PREFIX_APPROVER_MAX_DEPTH) {
+            break;
+        }
+
+        gen->dentries[depth & (PREFIX_APPROVER_MAX_DEPTH - 1)] = dentry;
+        depth++;
+        dentry = d_parent;
+    }
+
+    if (!resolved) {
+        return 1;
+    }
+
+    struct qstr qstr;
+    u32 len = 0;
+
+#pragma unroll
+    for (int i = PREFIX_APPROVER_MAX_DEPTH - 1; i >= 0; i--) {
+        if (i < depth && len < PREFIX_FILTER_SIZE) {
+            gen->path[len & (PREFIX_FILTER_SIZE - 1)] = '/';
+            len++;
+
+            bpf_probe_read(&qstr, sizeof(qstr), &gen->dentries[i]->d_name);
+            long ret = bpf_probe_read_str(&gen->path[len & (PREFIX_FILTER_SIZE - 1)], PREFIX_FILTER_SIZE, (void *)qstr.name);
+            if (ret > 0) {
+                len += ret - 1;
+            }
+        }
+    }
+
+    // a path truncated to the size of the trie key still matches the prefixes, which can't be larger
+    gen->prefixlen = (len < PREFIX_FILTER_SIZE ? len : PREFIX_FILTER_SIZE) * 8;
+
+    struct basename_filter_t *filter = bpf_map_lookup_elem(&prefix_approvers, &gen->prefixlen);
+    if (filter && filter->event_mask & (1 << (event_type-1))) {
+        monitor_event_approved(event_type, PREFIX_APPROVER_TYPE);
+        return 1;
+    }
+    return 0;
+}
+
 int __attribute__((always_inline)) basename_approver(struct syscall_cache_t *syscall, struct dentry *dentry, u64 event_type) {
     if ((syscall->policy.flags & BASENAME) > 0) {
         return approve_by_basename(dentry, event_type);
@@ -164,6 +241,10 @@ int __attribute__((always_inline)) open_approvers(struct syscall_cache_t *syscal
         pass_to_userspace = approve_by_basename(syscall->open.dentry, EVENT_OPEN);
     }
 
+    if (!pass_to_userspace && (syscall->policy.flags & PREFIX) > 0) {
+        pass_to_userspace = approve_by_prefix(syscall->open.dentry, syscall->open.vfsmount, EVENT_OPEN);
+    }
+
     if (!pass_to_userspace && (syscall->policy.flags & FLAGS) > 0) {
         pass_to_userspace = approve_by_flags(syscall);
     }
@@ -2,6 +2,7 @@
 #define _HELPERS_CONTAINER_H_
 
 #include "constants/custom.h"
+#include "maps.h"
 #include "utils.h"
 
 static __attribute__((always_inline)) void copy_container_id(const char src[CONTAINER_ID_LEN], char dst[CONTAINER_ID_LEN]) {
@@ -10,9 +11,38 @@ static __attribute__((always_inline)) void copy_container_id(const char src[CONT
 
 #define copy_container_id_no_tracing(src, dst) __builtin_memmove(dst, src, CONTAINER_ID_LEN)
 
-static void __attribute__((always_inline)) fill_container_context(struct proc_cache_t *entry, struct container_context_t *context) {
+// hash_container_id returns the key of a container ID, the FNV-1a hash of its CONTAINER_ID_LEN bytes (0 for no container)
+static __attribute__((always_inline)) u64 hash_container_id(const char id[CONTAINER_ID_LEN]) {
+    if (id[0] == 0) {
+        return 0;
+    }
+
+    u64 hash = FNV_OFFSET_BASIS;
+#pragma unroll
+    for (int i = 0; i < CONTAINER_ID_LEN; i++) {
+        hash ^= (u8)id[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// register_container_id stores the container ID of a proc cache entry once per container, so that the events only
+// carry its key
+static __attribute__((always_inline)) void register_container_id(struct proc_cache_t *entry) {
+    entry->container_key = hash_container_id(entry->container.container_id);
+    if (entry->container_key) {
+        bpf_map_update_elem(&container_ids, &entry->container_key, &entry->container, BPF_ANY);
+    }
+}
+
+static __attribute__((always_inline)) void copy_container_context(struct proc_cache_t *src, struct proc_cache_t *dst) {
+    copy_container_id(src->container.container_id, dst->container.container_id);
+    dst->container_key = src->container_key;
+}
+
+static void __attribute__((always_inline)) fill_container_context(struct proc_cache_t *entry, struct container_key_context_t *context) {
     if (entry) {
-        copy_container_id(entry->container.container_id, context->container_id);
+        context->container_key = entry->container_key;
     }
 }
 
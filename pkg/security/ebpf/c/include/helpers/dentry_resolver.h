@@ -64,19 +64,83 @@ u32 __attribute__((always_inline)) parse_erpc_request(struct dr_erpc_state_t *st
     state->iteration = 0;
     state->ret = 0;
     state->cursor = 0;
+    state->batch_index = 0;
+    state->batch_count = 1;
+    state->slot_size = state->buffer_size;
+    state->slot_end = state->buffer_size;
 
 exit:
     return err;
 }
 
-int __attribute__((always_inline)) handle_dr_request(ctx_t *ctx, void *data, u32 dr_erpc_key) {
+// A batch request resolves up to DR_ERPC_MAX_BATCH paths with a single eRPC call, the buffer being split in as many
+// slots, the path of the n-th key being written in the n-th slot.
+u32 __attribute__((always_inline)) parse_erpc_batch_request(struct dr_erpc_state_t *state, void *data) {
+    u32 err = 0;
+    int ret = bpf_probe_read(&state->userspace_buffer, sizeof(state->userspace_buffer), data + offsetof(struct dr_erpc_batch_request_t, userspace_buffer));
+    if (ret < 0) {
+        err = DR_ERPC_READ_PAGE_FAULT;
+        goto exit;
+    }
+    ret = bpf_probe_read(&state->buffer_size, sizeof(state->buffer_size), data + offsetof(struct dr_erpc_batch_request_t, buffer_size));
+    if (ret < 0) {
+        err = DR_ERPC_READ_PAGE_FAULT;
+        goto exit;
+    }
+    ret = bpf_probe_read(&state->challenge, sizeof(state->challenge), data + offsetof(struct dr_erpc_batch_request_t, challenge));
+    if (ret < 0) {
+        err = DR_ERPC_READ_PAGE_FAULT;
+        goto exit;
+    }
+    ret = bpf_probe_read(&state->batch_count, sizeof(state->batch_count), data + offsetof(struct dr_erpc_batch_request_t, count));
+    if (ret < 0) {
+        err = DR_ERPC_READ_PAGE_FAULT;
+        goto exit;
+    }
+    ret = bpf_probe_read(&state->batch_keys, sizeof(state->batch_keys), data + offsetof(struct dr_erpc_batch_request_t, keys));
+    if (ret < 0) {
+        err = DR_ERPC_READ_PAGE_FAULT;
+        goto exit;
+    }
+
+    if (state->batch_count == 0 || state->batch_count > DR_ERPC_MAX_BATCH) {
+        err = DR_ERPC_UNKNOWN_ERROR;
+        goto exit;
+    }
+
+    state->key = state->batch_keys[0];
+    state->iteration = 0;
+    state->ret = 0;
+    state->cursor = 0;
+    state->batch_index = 0;
+    state->slot_size = state->buffer_size / DR_ERPC_MAX_BATCH;
+    state->slot_end = state->slot_size;
+
+exit:
+    return err;
+}
+
+// Moves to the next path of a batch request, returns 0 once all the paths of the request were resolved.
+int __attribute__((always_inline)) dr_erpc_next_path(struct dr_erpc_state_t *state) {
+    state->batch_index++;
+    if (state->batch_index >= state->batch_count || state->batch_index >= DR_ERPC_MAX_BATCH) {
+        return 0;
+    }
+
+    state->key = state->batch_keys[state->batch_index & (DR_ERPC_MAX_BATCH - 1)];
+    state->cursor = state->batch_index * state->slot_size;
+    state->slot_end = state->cursor + state->slot_size;
+    return 1;
+}
+
+int __attribute__((always_inline)) handle_dr_request(ctx_t *ctx, void *data, u8 op, u32 dr_erpc_key) {
     u32 key = 0;
     struct dr_erpc_state_t *state = bpf_map_lookup_elem(&dr_erpc_state, &key);
     if (state == NULL) {
         return 0;
     }
 
-    u32 resolution_err = parse_erpc_request(state, data);
+    u32 resolution_err = op == RESOLVE_PATHS_OP ? parse_erpc_batch_request(state, data) : parse_erpc_request(state, data);
     if (resolution_err > 0) {
         goto exit;
     }
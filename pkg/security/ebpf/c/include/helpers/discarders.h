@@ -40,42 +40,96 @@ int __attribute__((always_inline)) monitor_discarded(u64 event_type) {
     return 0;
 }
 
-int __attribute__((always_inline)) get_mount_discarder_revision(u32 mount_id) {
-    u32 i = mount_id % REVISION_ARRAY_SIZE;
-    u32 *revision = bpf_map_lookup_elem(&inode_disc_revisions, &i);
+struct discarders_revision_t * __attribute__((always_inline)) get_discarders_revisions() {
+    u32 key = 0;
+    return bpf_map_lookup_elem(&discarders_revision, &key);
+}
 
-    return revision ? *revision : 0;
+// get_current_discarders_revision returns the revision of the discarders added now
+u32 __attribute__((always_inline)) get_current_discarders_revision() {
+    struct discarders_revision_t *revisions = get_discarders_revisions();
+
+    return revisions ? revisions->counter : 0;
 }
 
-int __attribute__((always_inline)) bump_mount_discarder_revision(u32 mount_id) {
-    u32 i = mount_id % REVISION_ARRAY_SIZE;
-    u32 *revision = bpf_map_lookup_elem(&inode_disc_revisions, &i);
-    if (!revision) {
+u32 __attribute__((always_inline)) next_discarders_revision(struct discarders_revision_t *revisions) {
+    __sync_fetch_and_add(&revisions->counter, 1);
+
+    return revisions->counter;
+}
+
+// get_discarders_revision returns the minimum revision of the valid discarders of the given event type
+u32 __attribute__((always_inline)) get_discarders_revision(u64 event_type) {
+    struct discarders_revision_t *revisions = get_discarders_revisions();
+    if (!revisions) {
         return 0;
     }
 
-    __sync_fetch_and_add(revision, 1);
+    u32 revision = revisions->all;
+    if (event_type < EVENT_MAX && revisions->event_types[event_type] > revision) {
+        revision = revisions->event_types[event_type];
+    }
 
-    return *revision;
+    return revision;
 }
 
-void __attribute__((always_inline)) bump_discarders_revision() {
-    u32 key = 0;
-    u32 *revision = bpf_map_lookup_elem(&discarders_revision, &key);
-    if (!revision) {
+// bump_discarders_revision invalidates the discarders of the given event type, of all of them for EVENT_ANY
+void __attribute__((always_inline)) bump_discarders_revision(u64 event_type) {
+    struct discarders_revision_t *revisions = get_discarders_revisions();
+    if (!revisions) {
         return;
     }
 
-    __sync_fetch_and_add(revision, 1);
+    u32 revision = next_discarders_revision(revisions);
+    if (event_type == EVENT_ANY) {
+        revisions->all = revision;
+    } else if (event_type < EVENT_MAX) {
+        revisions->event_types[event_type] = revision;
+    }
 }
 
-int __attribute__((always_inline)) get_discarders_revision() {
-    u32 key = 0;
-    u32 *revision = bpf_map_lookup_elem(&discarders_revision, &key);
+// get_valid_discarders_mask returns the event types of the mask whose discarders are still valid at the given revision
+u64 __attribute__((always_inline)) get_valid_discarders_mask(u64 event_mask, u32 revision) {
+    struct discarders_revision_t *revisions = get_discarders_revisions();
+    if (!revisions) {
+        return event_mask;
+    }
+
+    if (revision < revisions->all) {
+        return 0;
+    }
+
+#pragma unroll
+    for (int i = EVENT_FIRST_DISCARDER; i < EVENT_MAX; i++) {
+        if (revision < revisions->event_types[i]) {
+            event_mask &= ~((u64)1 << (u64)(i - EVENT_FIRST_DISCARDER));
+        }
+    }
+
+    return event_mask;
+}
+
+u32 __attribute__((always_inline)) get_mount_discarder_revision(u32 mount_id) {
+    u32 *revision = bpf_map_lookup_elem(&inode_disc_revisions, &mount_id);
 
     return revision ? *revision : 0;
 }
 
+int __attribute__((always_inline)) bump_mount_discarder_revision(u32 mount_id) {
+    struct discarders_revision_t *revisions = get_discarders_revisions();
+    if (!revisions) {
+        return 0;
+    }
+
+    u32 revision = next_discarders_revision(revisions);
+    if (bpf_map_update_elem(&inode_disc_revisions, &mount_id, &revision, BPF_ANY) < 0) {
+        // no more room for the mount, invalidate all the discarders instead
+        revisions->all = revision;
+    }
+
+    return revision;
+}
+
 u64* __attribute__((always_inline)) get_discarder_timestamp(struct discarder_params_t *params, u64 event_type) {
     switch (event_type) {
         case EVENT_OPEN:
@@ -148,6 +202,17 @@ void * __attribute__((always_inline)) is_discarded(void *discarder_map, void *ke
 
 int __attribute__((always_inline)) expire_inode_discarders(u32 mount_id, u64 inode);
 
+// The leaf discarders, discarding a file, are stored in inode_discarders while the parent ones, discarding all the
+// descendants of a directory, are stored in subtree_discarders. The latter are checked at each level of the dentry
+// resolution so that a single entry discards a whole tree, and are kept apart from the leaf discarders to not be
+// evicted by their churn.
+void * __attribute__((always_inline)) get_inode_discarders_map(u32 is_leaf) {
+    if (is_leaf) {
+        return &inode_discarders;
+    }
+    return &subtree_discarders;
+}
+
 struct inode_discarder_params_t * __attribute__((always_inline)) get_inode_discarder_params(u32 mount_id, u64 inode, u32 is_leaf) {
     struct inode_discarder_t key = {
         .path_key = {
@@ -157,7 +222,7 @@ struct inode_discarder_params_t * __attribute__((always_inline)) get_inode_disca
         .is_leaf = is_leaf,
     };
 
-    return bpf_map_lookup_elem(&inode_discarders, &key);
+    return bpf_map_lookup_elem(get_inode_discarders_map(is_leaf), &key);
 }
 
 int __attribute__((always_inline)) discard_inode(u64 event_type, u32 mount_id, u64 inode, u64 timeout, u32 is_leaf) {
@@ -178,12 +243,14 @@ int __attribute__((always_inline)) discard_inode(u64 event_type, u32 mount_id, u
     u64 *discarder_timestamp;
     u64 timestamp = timeout ? now + timeout : 0;
 
-    u32 revision = get_discarders_revision();
+    u32 revision = get_current_discarders_revision();
+    u32 type_revision = get_discarders_revision(event_type);
     u32 mount_revision = get_mount_discarder_revision(mount_id);
 
-    struct inode_discarder_params_t *inode_params = bpf_map_lookup_elem(&inode_discarders, &key);
+    void *discarders = get_inode_discarders_map(is_leaf);
+    struct inode_discarder_params_t *inode_params = bpf_map_lookup_elem(discarders, &key);
     if (inode_params) {
-        if (!inode_params->params.is_retained && inode_params->params.revision != revision) {
+        if (!inode_params->params.is_retained && inode_params->params.revision < type_revision) {
             return expire_inode_discarders(mount_id, inode);
         }
 
@@ -191,12 +258,14 @@ int __attribute__((always_inline)) discard_inode(u64 event_type, u32 mount_id, u
         if (!inode_params->params.is_retained || inode_params->params.expire_at < now) {
             inode_params->params.is_retained = 0;
 
-            // the revision change, all the discarders are invalidated,
-            // we need to add only the current event type and to use the current revision
-            if (inode_params->params.revision != revision || inode_params->mount_revision != mount_revision) {
+            if (inode_params->params.revision < mount_revision) {
+                // the mount revision changed, all the event types are invalidated
                 inode_params->params.event_mask = 0;
                 inode_params->params.revision = revision;
-                inode_params->mount_revision = mount_revision;
+            } else if (inode_params->params.revision < type_revision) {
+                // only keep the event types whose revision didn't change
+                inode_params->params.event_mask = get_valid_discarders_mask(inode_params->params.event_mask, inode_params->params.revision);
+                inode_params->params.revision = revision;
             }
             add_event_to_mask(&inode_params->params.event_mask, event_type);
 
@@ -207,14 +276,13 @@ int __attribute__((always_inline)) discard_inode(u64 event_type, u32 mount_id, u
     } else {
         struct inode_discarder_params_t new_inode_params = {
             .params.revision = revision,
-            .mount_revision = mount_revision,
         };
         add_event_to_mask(&new_inode_params.params.event_mask, event_type);
 
         if ((discarder_timestamp = get_discarder_timestamp(&new_inode_params.params, event_type)) != NULL) {
             *discarder_timestamp = timestamp;
         }
-        bpf_map_update_elem(&inode_discarders, &key, &new_inode_params, BPF_NOEXIST);
+        bpf_map_update_elem(discarders, &key, &new_inode_params, BPF_NOEXIST);
     }
 
     monitor_discarder_added(event_type);
@@ -225,24 +293,101 @@ int __attribute__((always_inline)) discard_inode(u64 event_type, u32 mount_id, u
 discard_check_state __attribute__((always_inline)) is_discarded_by_inode(struct is_discarded_by_inode_t *params) {
     // start with the "normal" discarder check
     struct inode_discarder_t key = params->discarder;
-    struct inode_discarder_params_t *inode_params = (struct inode_discarder_params_t *) is_discarded(&inode_discarders, &key, params->discarder_type, params->now);
+    struct inode_discarder_params_t *inode_params = (struct inode_discarder_params_t *) is_discarded(get_inode_discarders_map(key.is_leaf), &key, params->discarder_type, params->now);
     if (!inode_params) {
         return NOT_DISCARDED;
     }
 
-    bool are_revisions_equal = inode_params->mount_revision == get_mount_discarder_revision(params->discarder.path_key.mount_id);
-    if (!are_revisions_equal) {
+    u32 revision = inode_params->params.revision;
+    if (revision < get_mount_discarder_revision(params->discarder.path_key.mount_id)) {
         return NOT_DISCARDED;
     }
 
-    u32 revision = get_discarders_revision();
-    if (inode_params->params.revision != revision) {
+    if (revision < get_discarders_revision(params->discarder_type)) {
         return NOT_DISCARDED;
     }
 
     return DISCARDED;
 }
 
+u64 __attribute__((always_inline)) get_probation_cookie(u32 tgid) {
+    struct pid_cache_t *pid_entry = (struct pid_cache_t *) bpf_map_lookup_elem(&pid_cache, &tgid);
+    return pid_entry ? pid_entry->cookie : 0;
+}
+
+// is_discarded_by_probation suppresses the events of a same event type, inode, flags, mode and process once more than
+// the probation threshold of them were sent within the probation window, until the window ends. This bounds the number
+// of identical events sent before userspace pushes a discarder, or rejects the probation if the events matched a rule.
+// The process is identified by its exec cookie and the entry by the discarders revision, so that an exec or a rule set
+// reload starts a new probation, as the events may then match a rule.
+int __attribute__((always_inline)) is_discarded_by_probation(struct is_discarded_by_inode_t *params, struct dentry_resolver_input_t *input) {
+    u64 threshold = get_discarder_probation_threshold();
+    if (!threshold || params->discarder_type < EVENT_FIRST_DISCARDER || params->discarder_type > EVENT_LAST_DISCARDER) {
+        return 0;
+    }
+
+    struct discarder_probation_key_t key = {
+        .inode = params->discarder.path_key.ino,
+        .mount_id = params->discarder.path_key.mount_id,
+        .tgid = bpf_get_current_pid_tgid() >> 32,
+        .flags = input->discarder_flags,
+        .mode = input->discarder_mode,
+        .event_type = params->discarder_type,
+    };
+    u64 cookie = get_probation_cookie(key.tgid);
+
+    struct discarder_probation_t *probation = bpf_map_lookup_elem(&discarder_probations, &key);
+    if (!probation || probation->cookie != cookie || probation->revision < get_discarders_revision(params->discarder_type)) {
+        struct discarder_probation_t new_probation = {
+            .window_start = params->now,
+            .cookie = cookie,
+            .count = 1,
+            .revision = get_current_discarders_revision(),
+        };
+        bpf_map_update_elem(&discarder_probations, &key, &new_probation, BPF_ANY);
+        return 0;
+    }
+
+    if (probation->rejected) {
+        return 0;
+    }
+
+    if (params->now > probation->window_start + get_discarder_probation_window()) {
+        probation->window_start = params->now;
+        probation->count = 1;
+        return 0;
+    }
+
+    __sync_fetch_and_add(&probation->count, 1);
+
+    return probation->count > threshold;
+}
+
+int __attribute__((always_inline)) reject_discarder_probation(struct reject_discarder_probation_t *req) {
+    struct discarder_probation_key_t key = {
+        .inode = req->inode,
+        .mount_id = req->mount_id,
+        .tgid = req->tgid,
+        .flags = req->flags,
+        .mode = req->mode,
+        .event_type = req->event_type,
+    };
+
+    // the rejection only holds for the process image that sent the event
+    if (req->cookie != get_probation_cookie(req->tgid)) {
+        return 0;
+    }
+
+    struct discarder_probation_t probation = {
+        .cookie = req->cookie,
+        .rejected = 1,
+        .revision = get_current_discarders_revision(),
+    };
+    bpf_map_update_elem(&discarder_probations, &key, &probation, BPF_ANY);
+
+    return 0;
+}
+
 int __attribute__((always_inline)) expire_inode_discarders(u32 mount_id, u64 inode) {
     if (!mount_id || !inode) {
         return 0;
@@ -259,24 +404,24 @@ int __attribute__((always_inline)) expire_inode_discarders(u32 mount_id, u64 ino
 
     struct inode_discarder_params_t new_inode_params = {
         .params = {
-            .revision = get_discarders_revision(),
+            .revision = get_current_discarders_revision(),
             .is_retained = 1,
             .expire_at = expire_at,
         },
-        .mount_revision = get_mount_discarder_revision(mount_id),
     };
 
     #pragma unroll
     for (int i = 0; i != 2; i++) {
         key.is_leaf = i;
 
-        struct inode_discarder_params_t *inode_params = bpf_map_lookup_elem(&inode_discarders, &key);
+        void *discarders = get_inode_discarders_map(i);
+        struct inode_discarder_params_t *inode_params = bpf_map_lookup_elem(discarders, &key);
         if (inode_params) {
             inode_params->params.is_retained = 1;
             inode_params->params.expire_at = expire_at;
         } else {
             // add a retention anyway
-            bpf_map_update_elem(&inode_discarders, &key, &new_inode_params, BPF_NOEXIST);
+            bpf_map_update_elem(discarders, &key, &new_inode_params, BPF_NOEXIST);
         }
     }
 
@@ -295,11 +440,12 @@ int __attribute__((always_inline)) discard_pid(u64 event_type, u32 tgid, u64 tim
     u64 *discarder_timestamp;
     u64 timestamp = timeout ? now + timeout : 0;
 
-    u32 revision = get_discarders_revision();
+    u32 revision = get_current_discarders_revision();
+    u32 type_revision = get_discarders_revision(event_type);
 
     struct pid_discarder_params_t *pid_params = bpf_map_lookup_elem(&pid_discarders, &key);
     if (pid_params) {
-        if (!pid_params->params.is_retained && pid_params->params.revision != revision) {
+        if (!pid_params->params.is_retained && pid_params->params.revision < type_revision) {
             return expire_pid_discarder(tgid);
         }
 
@@ -307,10 +453,9 @@ int __attribute__((always_inline)) discard_pid(u64 event_type, u32 tgid, u64 tim
         if (!pid_params->params.is_retained || pid_params->params.expire_at < now) {
             pid_params->params.is_retained = 0;
 
-            // the revision change, all the discarders are invalidated,
-            // we need to add only the current event type and to use the current revision
-            if (pid_params->params.revision != revision) {
-                pid_params->params.event_mask = 0;
+            // only keep the event types whose revision didn't change
+            if (pid_params->params.revision < type_revision) {
+                pid_params->params.event_mask = get_valid_discarders_mask(pid_params->params.event_mask, pid_params->params.revision);
                 pid_params->params.revision = revision;
             }
             add_event_to_mask(&pid_params->params.event_mask, event_type);
@@ -346,8 +491,7 @@ int __attribute__((always_inline)) is_discarded_by_pid(u64 event_type, u32 tgid)
         return NOT_DISCARDED;
     }
 
-    u32 revision = get_discarders_revision();
-    if (pid_params->params.revision != revision) {
+    if (pid_params->params.revision < get_discarders_revision(event_type)) {
         return NOT_DISCARDED;
     }
 
@@ -355,10 +499,15 @@ int __attribute__((always_inline)) is_discarded_by_pid(u64 event_type, u32 tgid)
 }
 
 int __attribute__((always_inline)) is_discarded_by_process(const char mode, u64 event_type) {
+    // the hooks stay attached when all the probes are enabled, skip the event types that nothing consumes
+    if (!is_event_enabled(event_type)) {
+        return 1;
+    }
+
     u64 pid_tgid = bpf_get_current_pid_tgid();
     u32 tgid = pid_tgid >> 32;
 
-    if (is_runtime_discarded() && is_runtime_request()) {
+    if (is_runtime_discarded() && (is_runtime_request() || bpf_map_lookup_elem(&agent_tgids, &tgid) != NULL)) {
         return 1;
     }
 
@@ -32,11 +32,11 @@ __attribute__((always_inline)) struct dns_event_t *reset_dns_event(struct __sk_b
     // network context
     fill_network_context(&evt->network, skb, pkt);
 
-    struct proc_cache_t *entry = get_proc_cache(evt->process.pid);
+    struct proc_cache_t *entry = lookup_proc_cache(evt->process.pid);
     if (entry == NULL) {
-        evt->container.container_id[0] = 0;
+        evt->container.container_key = 0;
     } else {
-        copy_container_id_no_tracing(entry->container.container_id, &evt->container.container_id);
+        evt->container.container_key = entry->container_key;
     }
 
     // should we sample this event for activity dumps ?
@@ -50,4 +50,43 @@ __attribute__((always_inline)) struct dns_event_t *reset_dns_event(struct __sk_b
     return evt;
 }
 
+// is_dns_request_repeated returns 1 when the process already sent the same question within the dedup window. Otherwise
+// the count of the questions suppressed since the previous event is attached to the event, and a new window starts.
+__attribute__((always_inline)) int is_dns_request_repeated(struct dns_event_t *evt, u64 qname_hash) {
+    evt->repeat_count = 0;
+
+    u64 window = get_dns_dedup_window();
+    if (window == 0) {
+        return 0;
+    }
+
+    struct dns_dedup_key_t key = {
+        .qname_hash = qname_hash,
+        .pid = evt->process.pid,
+        .qtype = evt->qtype,
+    };
+    u64 now = bpf_ktime_get_ns();
+
+    struct dns_dedup_entry_t *entry = bpf_map_lookup_elem(&dns_dedup, &key);
+    if (entry == NULL) {
+        struct dns_dedup_entry_t new_entry = {
+            .window_start = now,
+        };
+        bpf_map_update_elem(&dns_dedup, &key, &new_entry, BPF_ANY);
+        return 0;
+    }
+
+    if (now - entry->window_start < window) {
+        if (entry->repeat_count < DNS_MAX_REPEAT_COUNT) {
+            __sync_fetch_and_add(&entry->repeat_count, 1);
+        }
+        return 1;
+    }
+
+    evt->repeat_count = entry->repeat_count;
+    entry->window_start = now;
+    entry->repeat_count = 0;
+    return 0;
+}
+
 #endif
@@ -0,0 +1,50 @@
+#ifndef _HELPERS_ENFORCEMENT_H_
+#define _HELPERS_ENFORCEMENT_H_
+
+#include "constants/custom.h"
+#include "maps.h"
+
+#include "approvers.h"
+#include "process.h"
+
+// enforce_kill_rules sends the signal of the kernel kill rule matching the event type and the basename of the dentry
+// to the current process, so that the kill action of the rule doesn't wait for the event to be evaluated in userspace.
+// Like the userspace process killer, it never signals init, the runtime itself or the other agent processes.
+void __attribute__((always_inline)) enforce_kill_rules(struct dentry *dentry, u64 event_type) {
+    if (!is_send_signal_available() || is_runtime_request()) {
+        return;
+    }
+
+    u32 zero = 0;
+    struct kill_rule_key_t *key = bpf_map_lookup_elem(&kill_rule_gen, &zero);
+    if (!key) {
+        return;
+    }
+    __builtin_memset(key, 0, sizeof(*key));
+    get_dentry_name(dentry, &key->basename, sizeof(key->basename));
+    key->event_type = event_type;
+
+    struct kill_rule_t *rule = bpf_map_lookup_elem(&kill_rules, key);
+    if (!rule || !rule->signal) {
+        return;
+    }
+
+    u32 tgid = bpf_get_current_pid_tgid() >> 32;
+    if (tgid <= 1 || bpf_map_lookup_elem(&agent_tgids, &tgid) != NULL) {
+        return;
+    }
+
+    if (rule->flags & KILL_RULE_CONTAINER_ONLY) {
+        struct proc_cache_t *pc = get_proc_cache(tgid);
+        if (!pc || pc->container.container_id[0] == 0) {
+            return;
+        }
+    }
+
+#ifdef DEBUG
+    bpf_printk("Sending signal %d to pid %d from kill rule\n", rule->signal, tgid);
+#endif
+    bpf_send_signal(rule->signal);
+}
+
+#endif
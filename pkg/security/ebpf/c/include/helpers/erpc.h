@@ -36,6 +36,17 @@ int __attribute__((always_inline)) handle_expire_inode_discarder(void *data) {
     return 0;
 }
 
+int __attribute__((always_inline)) handle_reject_discarder_probation(void *data) {
+    if (!is_runtime_request()) {
+        return 0;
+    }
+
+    struct reject_discarder_probation_t req;
+    bpf_probe_read(&req, sizeof(req), data);
+
+    return reject_discarder_probation(&req);
+}
+
 int __attribute__((always_inline)) handle_discard_pid(void *data) {
     if (!is_runtime_request()) {
         return 0;
@@ -65,7 +76,10 @@ int __attribute__((always_inline)) handle_bump_discarders_revision(void *data) {
         return 0;
     }
 
-    bump_discarders_revision();
+    u64 event_type;
+    bpf_probe_read(&event_type, sizeof(event_type), data);
+
+    bump_discarders_revision(event_type);
 
     return 0;
 }
@@ -122,7 +136,8 @@ int __attribute__((always_inline)) handle_erpc_request(ctx_t *ctx) {
 
     switch (op) {
         case RESOLVE_PATH_OP:
-            return handle_dr_request(ctx, data, DR_ERPC_KEY);
+        case RESOLVE_PATHS_OP:
+            return handle_dr_request(ctx, data, op, DR_ERPC_KEY);
         case USER_SESSION_CONTEXT_OP:
             return handle_register_user_session(data);
         case REGISTER_SPAN_TLS_OP:
@@ -133,6 +148,8 @@ int __attribute__((always_inline)) handle_erpc_request(ctx_t *ctx) {
             return handle_expire_pid_discarder(data);
         case BUMP_DISCARDERS_REVISION:
             return handle_bump_discarders_revision(data);
+        case REJECT_DISCARDER_PROBATION_OP:
+            return handle_reject_discarder_probation(data);
 #if USE_RING_BUFFER == 1
         case GET_RINGBUF_USAGE:
             return handle_get_ringbuf_usage(data);
@@ -4,6 +4,7 @@
 #include "constants/offsets/filesystem.h"
 #include "constants/fentry_macro.h"
 
+#include "enforcement.h"
 #include "process.h"
 
 int __attribute__((always_inline)) handle_exec_event(ctx_t *ctx, struct syscall_cache_t *syscall, struct file *file, struct path *path, struct inode *inode) {
@@ -14,12 +15,15 @@ int __attribute__((always_inline)) handle_exec_event(ctx_t *ctx, struct syscall_
 
     syscall->exec.dentry = get_file_dentry(file);
 
+    // handle the kernel kill rules
+    enforce_kill_rules(syscall->exec.dentry, EVENT_EXEC);
+
     // set mount_id to 0 is this is a fileless exec, meaning that the vfs type is tmpfs and that is an internal mount
     u32 mount_id = is_tmpfs(syscall->exec.dentry) && get_path_mount_flags(path) & MNT_INTERNAL ? 0 : get_path_mount_id(path);
 
     syscall->exec.file.path_key.ino = get_inode_ino(inode);
     syscall->exec.file.path_key.mount_id = mount_id;
-    syscall->exec.file.path_key.path_id = get_path_id(mount_id, 0);
+    update_path_id(&syscall->exec.file.path_key, 0);
 
     inc_mount_ref(mount_id);
 
@@ -39,8 +39,52 @@ static __attribute__((always_inline)) u32 get_path_id(u32 mount_id, int invalida
     return id;
 }
 
+static __attribute__((always_inline)) u32 new_inode_path_id() {
+    u32 key = 0;
+    u32 *gen = bpf_map_lookup_elem(&inode_path_id_gen, &key);
+    if (!gen) {
+        return INODE_PATH_ID_FLAG;
+    }
+    return INODE_PATH_ID_FLAG | __sync_fetch_and_add(gen, 1);
+}
+
+// get_inode_path_id returns the path id of an inode. The renamed files are given their own path id, so that only
+// their cached path is invalidated, while the other modifications invalidate the paths of the whole mount. The path
+// id of an inode is only valid as long as the one of its mount doesn't change.
+static __attribute__((always_inline)) u32 get_inode_path_id(u64 ino, u32 mount_id, int invalidate) {
+    u32 mount_path_id = get_path_id(mount_id, invalidate == PATH_ID_INVALIDATE_MOUNT);
+    u32 id = mount_path_id;
+
+    struct path_key_t key = {
+        .ino = ino,
+        .mount_id = mount_id,
+    };
+    struct inode_path_id_t *inode_path_id = bpf_map_lookup_elem(&inode_path_ids, &key);
+    if (inode_path_id) {
+        if (inode_path_id->mount_path_id == mount_path_id) {
+            id = inode_path_id->path_id;
+        }
+        if (inode_path_id->mount_path_id != mount_path_id || invalidate == PATH_ID_INVALIDATE_MOUNT) {
+            bpf_map_delete_elem(&inode_path_ids, &key);
+        }
+    }
+
+    if (invalidate == PATH_ID_INVALIDATE_INODE) {
+        struct inode_path_id_t new_inode_path_id = {
+            .mount_path_id = mount_path_id,
+            .path_id = new_inode_path_id(),
+        };
+        if (bpf_map_update_elem(&inode_path_ids, &key, &new_inode_path_id, BPF_ANY) < 0) {
+            // too many renamed inodes, fall back to the invalidation of the mount
+            bump_path_id(mount_id);
+        }
+    }
+
+    return id;
+}
+
 static __attribute__((always_inline)) void update_path_id(struct path_key_t *path_key, int invalidate) {
-    path_key->path_id = get_path_id(path_key->mount_id, invalidate);
+    path_key->path_id = get_inode_path_id(path_key->ino, path_key->mount_id, invalidate);
 }
 
 static __attribute__((always_inline)) void inc_mount_ref(u32 mount_id) {
@@ -127,7 +171,6 @@ void __attribute__((always_inline)) fill_file(struct dentry* dentry, struct file
 #define get_inode_key_path(inode, path) (struct path_key_t) { .ino = get_inode_ino(inode), .mount_id = get_path_mount_id(path) }
 
 static __attribute__((always_inline)) void set_file_inode(struct dentry *dentry, struct file_t *file, int invalidate) {
-    file->path_key.path_id = get_path_id(file->path_key.mount_id, invalidate);
     if (!file->path_key.ino) {
         file->path_key.ino = get_dentry_ino(dentry);
     }
@@ -135,6 +178,17 @@ static __attribute__((always_inline)) void set_file_inode(struct dentry *dentry,
     if (is_overlayfs(dentry)) {
         set_overlayfs_ino(dentry, &file->path_key.ino, &file->flags);
     }
+
+    if (invalidate == PATH_ID_INVALIDATE_INODE) {
+        u16 mode = 0;
+        bpf_probe_read(&mode, sizeof(mode), &get_dentry_inode(dentry)->i_mode);
+        // renaming a directory changes the paths of its whole subtree
+        if (S_ISDIR(mode)) {
+            invalidate = PATH_ID_INVALIDATE_MOUNT;
+        }
+    }
+
+    update_path_id(&file->path_key, invalidate);
 }
 
 #endif
@@ -13,6 +13,33 @@ __attribute__((always_inline)) struct imds_event_t *get_imds_event() {
     return bpf_map_lookup_elem(&imds_event, &key);
 }
 
+#define HTTP_PREFIX_MATCHES(prefix, str) ((prefix)[0] == (str)[0] && (prefix)[1] == (str)[1] && (prefix)[2] == (str)[2] && (prefix)[3] == (str)[3])
+
+// is_http_start returns 1 if the payload starts with an HTTP request line or status line, the only ones userspace
+// parses. It is checked before the payload is copied to the event so that the other packets of the IMDS flows, such
+// as the continuation segments of a response, are dropped early.
+__attribute__((always_inline)) int is_http_start(struct __sk_buff *skb, struct packet_t *pkt) {
+    char prefix[4] = {};
+
+    if (pkt->payload_len < IMDS_MIN_LENGTH) {
+        return 0;
+    }
+    if (bpf_skb_load_bytes(skb, pkt->offset, prefix, sizeof(prefix)) < 0) {
+        return 0;
+    }
+
+    return HTTP_PREFIX_MATCHES(prefix, "HTTP") ||
+        HTTP_PREFIX_MATCHES(prefix, "GET ") ||
+        HTTP_PREFIX_MATCHES(prefix, "PUT ") ||
+        HTTP_PREFIX_MATCHES(prefix, "POST") ||
+        HTTP_PREFIX_MATCHES(prefix, "HEAD") ||
+        HTTP_PREFIX_MATCHES(prefix, "PATC") ||
+        HTTP_PREFIX_MATCHES(prefix, "DELE") ||
+        HTTP_PREFIX_MATCHES(prefix, "CONN") ||
+        HTTP_PREFIX_MATCHES(prefix, "OPTI") ||
+        HTTP_PREFIX_MATCHES(prefix, "TRAC");
+}
+
 __attribute__((always_inline)) struct imds_event_t *reset_imds_event(struct __sk_buff *skb, struct packet_t *pkt) {
     struct imds_event_t *evt = get_imds_event();
     if (evt == NULL) {
@@ -29,11 +56,11 @@ __attribute__((always_inline)) struct imds_event_t *reset_imds_event(struct __sk
     // network context
     fill_network_context(&evt->network, skb, pkt);
 
-    struct proc_cache_t *entry = get_proc_cache(evt->process.pid);
+    struct proc_cache_t *entry = lookup_proc_cache(evt->process.pid);
     if (entry == NULL) {
-        evt->container.container_id[0] = 0;
+        evt->container.container_key = 0;
     } else {
-        copy_container_id_no_tracing(entry->container.container_id, &evt->container.container_id);
+        evt->container.container_key = entry->container_key;
     }
 
     // should we sample this event for activity dumps ?
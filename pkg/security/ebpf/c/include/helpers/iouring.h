@@ -25,12 +25,38 @@ u64 __attribute__((always_inline)) get_pid_tgid_from_iouring(void *req) {
     bpf_printk("ioctx out = %p", ioctx);
 #endif
 
+    // the ops of a submission batch run in the submitting process, either inline or from its io-wq and sqpoll threads,
+    // reuse the last resolution of this CPU instead of looking up io_uring_ctx_pid for each op
+    u32 key = 0;
+    struct io_uring_ctx_cache_t *cache = bpf_map_lookup_elem(&io_uring_ctx_cache, &key);
+    if (cache && cache->ioctx == ioctx && (cache->pid_tgid >> 32) == (bpf_get_current_pid_tgid() >> 32)) {
+        return cache->pid_tgid;
+    }
+
     u64 *pid_tgid_ptr = bpf_map_lookup_elem(&io_uring_ctx_pid, &ioctx);
-    if (pid_tgid_ptr) {
-        return *pid_tgid_ptr;
-    } else {
+    if (pid_tgid_ptr == NULL) {
         return 0;
     }
+
+    if (cache) {
+        cache->ioctx = ioctx;
+        cache->pid_tgid = *pid_tgid_ptr;
+    }
+    return *pid_tgid_ptr;
+}
+
+void __attribute__((always_inline)) cache_submit_ioctx(void *ioctx) {
+    u32 key = 0;
+    struct io_uring_ctx_cache_t *cache = bpf_map_lookup_elem(&io_uring_ctx_cache, &key);
+    if (cache == NULL || cache->ioctx == ioctx) {
+        return;
+    }
+
+    u64 *pid_tgid_ptr = bpf_map_lookup_elem(&io_uring_ctx_pid, &ioctx);
+    if (pid_tgid_ptr) {
+        cache->ioctx = ioctx;
+        cache->pid_tgid = *pid_tgid_ptr;
+    }
 }
 
 #endif
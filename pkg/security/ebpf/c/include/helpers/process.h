@@ -39,7 +39,7 @@ void __attribute__((always_inline)) copy_proc_entry(struct process_entry_t* src,
 }
 
 void __attribute__((always_inline)) copy_proc_cache(struct proc_cache_t *src, struct proc_cache_t *dst) {
-    copy_container_id(src->container.container_id, dst->container.container_id);
+    copy_container_context(src, dst);
     copy_proc_entry(&src->entry, &dst->entry);
 }
 
@@ -67,7 +67,9 @@ struct pid_cache_t * __attribute__((always_inline)) get_pid_cache(u32 tgid) {
     return (struct pid_cache_t *) bpf_map_lookup_elem(&pid_cache, &tgid);
 }
 
-struct proc_cache_t * __attribute__((always_inline)) get_proc_cache(u32 tgid) {
+// lookup_proc_cache returns the proc_cache entry of a process, it must be used by the programs that don't run in the
+// context of the process, and to update the entry
+struct proc_cache_t * __attribute__((always_inline)) lookup_proc_cache(u32 tgid) {
     struct pid_cache_t *pid_entry = get_pid_cache(tgid);
     if (!pid_entry) {
         return NULL;
@@ -77,6 +79,57 @@ struct proc_cache_t * __attribute__((always_inline)) get_proc_cache(u32 tgid) {
     return get_proc_from_cookie(pid_entry->cookie);
 }
 
+#ifdef USE_FENTRY
+static __always_inline u64 use_process_task_storage() {
+    u64 enabled = 0;
+    LOAD_CONSTANT("use_process_task_storage", enabled);
+    return enabled;
+}
+#endif
+
+// store_current_proc_cache copies the proc_cache entry of the current process in the task storage of the current task
+void __attribute__((always_inline)) store_current_proc_cache(u64 cookie, struct proc_cache_t *pc) {
+#ifdef USE_FENTRY
+    if (!use_process_task_storage()) {
+        return;
+    }
+
+    struct proc_cache_task_storage_t *storage = bpf_task_storage_get(&proc_cache_task_storage, bpf_get_current_task_btf(), 0, BPF_LOCAL_STORAGE_GET_F_CREATE);
+    if (storage) {
+        bpf_probe_read(&storage->entry, sizeof(storage->entry), pc);
+        storage->cookie = cookie;
+    }
+#endif
+}
+
+// get_proc_cache returns the proc_cache entry of a process. In fentry mode, the entry of the current process is read
+// from the task storage, so that it survives the eviction of the pid_cache and proc_cache entries.
+struct proc_cache_t * __attribute__((always_inline)) get_proc_cache(u32 tgid) {
+#ifdef USE_FENTRY
+    u32 current_tgid = bpf_get_current_pid_tgid() >> 32;
+    if (use_process_task_storage() && tgid == current_tgid) {
+        struct proc_cache_task_storage_t *storage = bpf_task_storage_get(&proc_cache_task_storage, bpf_get_current_task_btf(), 0, 0);
+        if (storage && storage->cookie) {
+            return &storage->entry;
+        }
+    }
+#endif
+
+    struct pid_cache_t *pid_entry = get_pid_cache(tgid);
+    if (!pid_entry) {
+        return NULL;
+    }
+
+    u64 cookie = pid_entry->cookie;
+    struct proc_cache_t *pc = get_proc_from_cookie(cookie);
+#ifdef USE_FENTRY
+    if (pc && tgid == current_tgid) {
+        store_current_proc_cache(cookie, pc);
+    }
+#endif
+    return pc;
+}
+
 static struct proc_cache_t * __attribute__((always_inline)) fill_process_context_with_pid_tgid(struct process_context_t *data, u64 pid_tgid) {
     u32 tgid = pid_tgid >> 32;
 
@@ -24,15 +24,36 @@ __attribute__((always_inline)) void syscall_monitor_entry_insert(struct syscall_
     }
 }
 
-__attribute__((always_inline)) struct syscall_monitor_entry_t *fetch_sycall_monitor_entry(struct syscall_monitor_entry_t *zero, u32 pid, u64 now, u8 syscall_monitor_type) {
+__attribute__((always_inline)) struct syscall_monitor_entry_t *lookup_sycall_monitor_entry(u32 pid, u8 syscall_monitor_type) {
+    if (syscall_monitor_type == SYSCALL_MONITOR_TYPE_DUMP) {
+        return bpf_map_lookup_elem(&syscall_monitor_dumps, &pid);
+    }
+
     struct syscall_monitor_key_t key = {
         .type = syscall_monitor_type,
         .pid = pid,
     };
-    struct syscall_monitor_entry_t *entry = bpf_map_lookup_elem(&syscall_monitor, &key);
+    return bpf_map_lookup_elem(&syscall_monitor, &key);
+}
+
+__attribute__((always_inline)) void insert_syscall_monitor_entry(u32 pid, struct syscall_monitor_entry_t *zero, u8 syscall_monitor_type) {
+    if (syscall_monitor_type == SYSCALL_MONITOR_TYPE_DUMP) {
+        bpf_map_update_elem(&syscall_monitor_dumps, &pid, zero, BPF_NOEXIST);
+        return;
+    }
+
+    struct syscall_monitor_key_t key = {
+        .type = syscall_monitor_type,
+        .pid = pid,
+    };
+    bpf_map_update_elem(&syscall_monitor, &key, zero, BPF_NOEXIST);
+}
+
+__attribute__((always_inline)) struct syscall_monitor_entry_t *fetch_sycall_monitor_entry(struct syscall_monitor_entry_t *zero, u32 pid, u64 now, u8 syscall_monitor_type) {
+    struct syscall_monitor_entry_t *entry = lookup_sycall_monitor_entry(pid, syscall_monitor_type);
     if (entry == NULL) {
-        bpf_map_update_elem(&syscall_monitor, &key, zero, BPF_NOEXIST);
-        entry = bpf_map_lookup_elem(&syscall_monitor, &key);
+        insert_syscall_monitor_entry(pid, zero, syscall_monitor_type);
+        entry = lookup_sycall_monitor_entry(pid, syscall_monitor_type);
         if (entry == NULL) {
             // should not happen, ignore
             return NULL;
@@ -44,6 +65,11 @@ __attribute__((always_inline)) struct syscall_monitor_entry_t *fetch_sycall_moni
 }
 
 __attribute__((always_inline)) void delete_syscall_monitor_entry(u32 pid, u8 syscall_monitor_type) {
+    if (syscall_monitor_type == SYSCALL_MONITOR_TYPE_DUMP) {
+        bpf_map_delete_elem(&syscall_monitor_dumps, &pid);
+        return;
+    }
+
     struct syscall_monitor_key_t key = {
         .type = syscall_monitor_type,
         .pid = pid,
@@ -95,7 +121,7 @@ shoud_send_event:
         entry->dirty = 0;
 
         // fill span context
-        fill_span_context(&event->span);
+        fill_span_context(&event->span, EVENT_SYSCALLS);
 
         // remove last_sent and dirty from the event size, we don't care about these fields
         send_event_with_size_ptr(args, EVENT_SYSCALLS, event, offsetof(struct syscall_monitor_event_t, syscall_data) + SYSCALL_ENCODING_TABLE_SIZE);
@@ -105,7 +131,8 @@ shoud_send_event:
     if (is_syscall(&key)) {
         // reset syscalls map for the new process
         bpf_probe_read(&entry->syscalls[0], sizeof(entry->syscalls), &zero->syscalls[0]);
-        entry->dirty = 1;
+        // an empty list of unexpected syscalls isn't worth an event, only the dumps need the reset to be reported
+        entry->dirty = syscall_monitor_type == SYSCALL_MONITOR_TYPE_DUMP;
         entry->last_sent = now;
     }
     key.syscall_key = EXIT_SYSCALL_KEY;
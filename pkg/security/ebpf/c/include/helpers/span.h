@@ -1,8 +1,10 @@
 #ifndef _HELPERS_SPAN_H_
 #define _HELPERS_SPAN_H_
 
+#include "constants/custom.h"
 #include "maps.h"
 
+#include "events.h"
 #include "process.h"
 
 int __attribute__((always_inline)) handle_register_span_memory(void *data) {
@@ -26,19 +28,37 @@ int __attribute__((always_inline)) unregister_span_memory() {
    return 0;
 }
 
-void __attribute__((always_inline)) fill_span_context(struct span_context_t *span) {
+// get_span_ns_tid returns the namespaced tid of the current thread, which indexes its span slot. It is cached per thread
+// to avoid walking the pid namespaces of the task on each event.
+u32 __attribute__((always_inline)) get_span_ns_tid(u32 tid) {
+   u32 *cached = bpf_map_lookup_elem(&span_ns_tids, &tid);
+   if (cached) {
+      return *cached;
+   }
+
+   u32 ns_tid = tid;
+   struct task_struct *current_ptr = (struct task_struct *)bpf_get_current_task();
+   u32 pid = get_namespace_nr_from_task_struct(current_ptr);
+   if (pid) {
+      ns_tid = pid;
+   }
+   bpf_map_update_elem(&span_ns_tids, &tid, &ns_tid, BPF_ANY);
+
+   return ns_tid;
+}
+
+void __attribute__((always_inline)) fill_span_context(struct span_context_t *span, enum event_type event_type) {
+   u64 mask = get_span_event_mask();
+   if (mask && !mask_has_event(mask, event_type)) {
+      return;
+   }
+
    u64 pid_tgid = bpf_get_current_pid_tgid();
    u32 tgid = pid_tgid >> 32;
 
    struct span_tls_t *tls = bpf_map_lookup_elem(&span_tls, &tgid);
    if (tls) {
-      u32 tid = pid_tgid;
-
-      struct task_struct *current_ptr = (struct task_struct *)bpf_get_current_task();
-      u32 pid = get_namespace_nr_from_task_struct(current_ptr);
-      if (pid) {
-         tid = pid;
-      }
+      u32 tid = get_span_ns_tid(pid_tgid);
 
       int offset = (tid % tls->max_threads) * sizeof(struct span_context_t);
       int ret = bpf_probe_read(span, sizeof(struct span_context_t), tls->base + offset);
@@ -19,7 +19,22 @@
 #define IS_SYSCALL_CTX_ARG_STR(types, pos) IS_SYSCALL_CTX_ARG(types, SYSCALL_CTX_STR_TYPE, pos)
 #define IS_SYSCALL_CTX_ARG_INT(types, pos) IS_SYSCALL_CTX_ARG(types, SYSCALL_CTX_INT_TYPE, pos)
 
+// is_syscall_ctx_needed returns whether the syscall context of the event type is referenced by the loaded rules
+int __attribute__((always_inline)) is_syscall_ctx_needed(u64 event_type) {
+    if (!is_syscall_ctx_rules_only()) {
+        return 1;
+    }
+
+    u32 key = 0;
+    u64 *mask = bpf_map_lookup_elem(&syscall_ctx_events, &key);
+    return mask != NULL && mask_has_event(*mask, event_type);
+}
+
 void __attribute__((always_inline)) collect_syscall_ctx(struct syscall_cache_t *syscall, u8 types, void *arg1, void *arg2, void *arg3) {
+    if (!is_syscall_ctx_needed(syscall->type)) {
+        return;
+    }
+
     u32 key = 0;
     u32 *id = bpf_map_lookup_elem(&syscall_ctx_gen_id, &key);
     if (!id) {
@@ -104,6 +119,42 @@ struct policy_t __attribute__((always_inline)) fetch_policy(u64 event_type) {
     return empty_policy;
 }
 
+#ifdef USE_FENTRY
+static __always_inline u64 use_syscall_task_storage() {
+    u64 enabled = 0;
+    LOAD_CONSTANT("use_syscall_task_storage", enabled);
+    return enabled;
+}
+#endif
+
+// lookup_current_syscall returns the syscall cached by the current task
+struct syscall_cache_t *__attribute__((always_inline)) lookup_current_syscall() {
+#ifdef USE_FENTRY
+    if (use_syscall_task_storage()) {
+        struct syscall_cache_t *syscall = bpf_task_storage_get(&syscalls_task_storage, bpf_get_current_task_btf(), 0, 0);
+        if (!syscall || !syscall->cached) {
+            return NULL;
+        }
+        return syscall;
+    }
+#endif
+    u64 pid_tgid = bpf_get_current_pid_tgid();
+    return (struct syscall_cache_t *)bpf_map_lookup_elem(&syscalls, &pid_tgid);
+}
+
+// delete_current_syscall removes the syscall cached by the current task, the entry remains readable until the program returns
+void __attribute__((always_inline)) delete_current_syscall(struct syscall_cache_t *syscall) {
+#ifdef USE_FENTRY
+    if (use_syscall_task_storage()) {
+        // keep the slot allocated for the next syscall of the task
+        syscall->cached = 0;
+        return;
+    }
+#endif
+    u64 pid_tgid = bpf_get_current_pid_tgid();
+    bpf_map_delete_elem(&syscalls, &pid_tgid);
+}
+
 // cache_syscall checks the event policy in order to see if the syscall struct can be cached
 void __attribute__((always_inline)) cache_syscall(struct syscall_cache_t *syscall) {
     u64 pid_tgid = bpf_get_current_pid_tgid();
@@ -112,6 +163,18 @@ void __attribute__((always_inline)) cache_syscall(struct syscall_cache_t *syscal
     // handle kill action
     send_signal(pid);
 
+#ifdef USE_FENTRY
+    if (use_syscall_task_storage()) {
+        struct syscall_cache_t *slot = bpf_task_storage_get(&syscalls_task_storage, bpf_get_current_task_btf(), 0, BPF_LOCAL_STORAGE_GET_F_CREATE);
+        if (slot) {
+            bpf_probe_read(slot, sizeof(*slot), syscall);
+            slot->cached = 1;
+        }
+        monitor_syscalls(syscall->type, 1);
+        return;
+    }
+#endif
+
     bpf_map_update_elem(&syscalls, &pid_tgid, syscall, BPF_ANY);
 
     monitor_syscalls(syscall->type, 1);
@@ -129,13 +192,18 @@ struct syscall_cache_t *__attribute__((always_inline)) peek_task_syscall(u64 pid
 }
 
 struct syscall_cache_t *__attribute__((always_inline)) peek_syscall(u64 type) {
-    u64 key = bpf_get_current_pid_tgid();
-    return peek_task_syscall(key, type);
+    struct syscall_cache_t *syscall = lookup_current_syscall();
+    if (!syscall) {
+        return NULL;
+    }
+    if (!type || syscall->type == type) {
+        return syscall;
+    }
+    return NULL;
 }
 
 struct syscall_cache_t *__attribute__((always_inline)) peek_syscall_with(int (*predicate)(u64 type)) {
-    u64 key = bpf_get_current_pid_tgid();
-    struct syscall_cache_t *syscall = (struct syscall_cache_t *)bpf_map_lookup_elem(&syscalls, &key);
+    struct syscall_cache_t *syscall = lookup_current_syscall();
     if (!syscall) {
         return NULL;
     }
@@ -146,13 +214,12 @@ struct syscall_cache_t *__attribute__((always_inline)) peek_syscall_with(int (*p
 }
 
 struct syscall_cache_t *__attribute__((always_inline)) pop_syscall_with(int (*predicate)(u64 type)) {
-    u64 key = bpf_get_current_pid_tgid();
-    struct syscall_cache_t *syscall = (struct syscall_cache_t *)bpf_map_lookup_elem(&syscalls, &key);
+    struct syscall_cache_t *syscall = lookup_current_syscall();
     if (!syscall) {
         return NULL;
     }
     if (predicate(syscall->type)) {
-        bpf_map_delete_elem(&syscalls, &key);
+        delete_current_syscall(syscall);
 
         monitor_syscalls(syscall->type, -1);
         return syscall;
@@ -176,8 +243,17 @@ struct syscall_cache_t *__attribute__((always_inline)) pop_task_syscall(u64 pid_
 }
 
 struct syscall_cache_t *__attribute__((always_inline)) pop_syscall(u64 type) {
-    u64 key = bpf_get_current_pid_tgid();
-    struct syscall_cache_t *syscall = pop_task_syscall(key, type);
+    struct syscall_cache_t *syscall = lookup_current_syscall();
+    if (syscall) {
+        u64 event_type = syscall->type; // fixes 4.14 verifier issue
+        if (!type || event_type == type) {
+            delete_current_syscall(syscall);
+
+            monitor_syscalls(event_type, -1);
+        } else {
+            syscall = NULL;
+        }
+    }
 #ifdef DEBUG
     if (!syscall) {
         bpf_printk("Failed to pop syscall with type %d", type);
@@ -187,8 +263,7 @@ struct syscall_cache_t *__attribute__((always_inline)) pop_syscall(u64 type) {
 }
 
 int __attribute__((always_inline)) discard_syscall(struct syscall_cache_t *syscall) {
-    u64 key = bpf_get_current_pid_tgid();
-    bpf_map_delete_elem(&syscalls, &key);
+    delete_current_syscall(syscall);
     monitor_syscalls(syscall->type, -1);
     return 0;
 }
@@ -209,6 +284,10 @@ int __attribute__((always_inline)) filter_syscall(struct syscall_cache_t *syscal
         pass_to_userspace = check_approvers(syscall);
     }
 
+    if (!is_activity_dumps_enabled()) {
+        return !pass_to_userspace;
+    }
+
     u32 tgid = bpf_get_current_pid_tgid() >> 32;
     u64 *cookie = bpf_map_lookup_elem(&traced_pids, &tgid);
     if (cookie != NULL) {
@@ -217,7 +296,7 @@ int __attribute__((always_inline)) filter_syscall(struct syscall_cache_t *syscal
         if (config != NULL) {
             // is this event type traced ?
             if (mask_has_event(config->event_mask, syscall->type)
-                && activity_dump_rate_limiter_allow(config, *cookie, now, 0)) {
+                && activity_dump_rate_limiter_allow(config, *cookie, now, syscall->type, 0)) {
                 if (!pass_to_userspace) {
                     syscall->resolver.flags |= SAVED_BY_ACTIVITY_DUMP;
                 }
@@ -235,6 +314,12 @@ int __attribute__((always_inline)) filter_syscall(struct syscall_cache_t *syscal
 struct syscall_cache_t *__attribute__((always_inline)) peek_current_or_impersonated_exec_syscall() {
     struct syscall_cache_t *syscall = peek_syscall(EVENT_EXEC);
     if (!syscall) {
+#ifdef USE_FENTRY
+        // the task storage follows the task when it takes the pid of its thread group leader
+        if (use_syscall_task_storage()) {
+            return NULL;
+        }
+#endif
         u64 pid_tgid = bpf_get_current_pid_tgid();
         u32 tgid = pid_tgid >> 32;
         u32 pid = pid_tgid;
@@ -256,6 +341,11 @@ struct syscall_cache_t *__attribute__((always_inline)) peek_current_or_impersona
 
 struct syscall_cache_t *__attribute__((always_inline)) pop_current_or_impersonated_exec_syscall() {
     struct syscall_cache_t *syscall = pop_syscall(EVENT_EXEC);
+#ifdef USE_FENTRY
+    if (use_syscall_task_storage()) {
+        return syscall;
+    }
+#endif
 
     u64 pid_tgid = bpf_get_current_pid_tgid();
     u32 tgid = pid_tgid >> 32;
@@ -283,7 +373,7 @@ int __attribute__((always_inline)) fill_exec_context() {
     }
 
     // call it here before the memory get replaced
-    fill_span_context(&syscall->exec.span_context);
+    fill_span_context(&syscall->exec.span_context, EVENT_EXEC);
 
     return 0;
 }
@@ -18,7 +18,7 @@ __attribute__((always_inline)) void send_bpf_event(void *ctx, struct syscall_cac
 
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_BPF);
 
     u32 id = 0;
 
@@ -49,12 +49,54 @@ __attribute__((always_inline)) void send_bpf_event(void *ctx, struct syscall_cac
     send_event(ctx, EVENT_BPF, event);
 }
 
+// is_bpf_cmd_filtered returns true when the command would be dropped by the approvers at exit anyway, so that the
+// frequent map lookups and updates don't go through the syscall cache. The commands that create or expose an object
+// are always cached as the security_bpf_map and security_bpf_prog hooks collect the object metadata from there.
+int __attribute__((always_inline)) is_bpf_cmd_filtered(struct policy_t policy, int cmd) {
+    if (policy.mode != DENY) {
+        return 0;
+    }
+
+    switch (cmd) {
+    case BPF_MAP_CREATE:
+    case BPF_PROG_LOAD:
+    case BPF_OBJ_GET:
+    case BPF_MAP_GET_FD_BY_ID:
+    case BPF_PROG_GET_FD_BY_ID:
+        return 0;
+    }
+
+    if ((policy.flags & FLAGS) > 0) {
+        u32 key = 0;
+        u64 *cmd_bitmask = bpf_map_lookup_elem(&bpf_cmd_approvers, &key);
+        if (cmd_bitmask != NULL && ((1 << cmd) & *cmd_bitmask) > 0) {
+            return 0;
+        }
+    }
+
+    // activity dumps may still want the event
+    if (!is_activity_dumps_enabled()) {
+        return 1;
+    }
+
+    u32 tgid = bpf_get_current_pid_tgid() >> 32;
+    if (bpf_map_lookup_elem(&traced_pids, &tgid) != NULL) {
+        return 0;
+    }
+
+    return 1;
+}
+
 HOOK_SYSCALL_ENTRY3(bpf, int, cmd, union bpf_attr __user *, uattr, unsigned int, size) {
     struct policy_t policy = fetch_policy(EVENT_BPF);
     if (is_discarded_by_process(policy.mode, EVENT_BPF)) {
         return 0;
     }
 
+    if (is_bpf_cmd_filtered(policy, cmd)) {
+        return 0;
+    }
+
     struct syscall_cache_t syscall = {
         .policy = policy,
         .type = EVENT_BPF,
@@ -75,17 +117,18 @@ __attribute__((always_inline)) int sys_bpf_ret(void *ctx, int retval) {
         return 0;
     }
 
-    if (filter_syscall(syscall, bpf_approvers)) {
-        return mark_as_discarded(syscall);
-    }
-
     syscall->bpf.retval = retval;
 
-    // save file descriptor <-> map_id mapping if applicable
-    if (syscall->bpf.map_id != 0 || syscall->bpf.prog_id != 0) {
+    // save file descriptor <-> map_id mapping if applicable. This is why the commands exposing an object went through
+    // the entry filter, so it has to be done even if the approvers drop the event.
+    if (retval >= 0 && (syscall->bpf.map_id != 0 || syscall->bpf.prog_id != 0)) {
         save_obj_fd(syscall);
     }
 
+    if (filter_syscall(syscall, bpf_approvers)) {
+        return mark_as_discarded(syscall);
+    }
+
     // populate map_id or prog_id if applicable
     populate_map_id_and_prog_id(syscall);
 
@@ -107,17 +150,23 @@ int hook_security_bpf_map(ctx_t *ctx) {
 
     struct bpf_map *map = (struct bpf_map *)CTX_PARM1(ctx);
 
-    // collect relevant map metadata
     struct bpf_map_t m = {};
     bpf_probe_read(&m.id, sizeof(m.id), (void *)map + get_bpf_map_id_offset());
+
+    // update context
+    syscall->bpf.map_id = m.id;
+
+    // the metadata of a map never changes, only collect it the first time an fd is handed out for it
+    if (bpf_map_lookup_elem(&bpf_maps, &m.id) != NULL) {
+        return 0;
+    }
+
+    // collect relevant map metadata
     bpf_probe_read(&m.name, sizeof(m.name), (void *)map + get_bpf_map_name_offset());
     bpf_probe_read(&m.map_type, sizeof(m.map_type), (void *)map + get_bpf_map_type_offset());
 
     // save map metadata
     bpf_map_update_elem(&bpf_maps, &m.id, &m, BPF_ANY);
-
-    // update context
-    syscall->bpf.map_id = m.id;
     return 0;
 }
 
@@ -132,9 +181,19 @@ int hook_security_bpf_prog(ctx_t *ctx) {
     struct bpf_prog_aux *prog_aux = 0;
     bpf_probe_read(&prog_aux, sizeof(prog_aux), (void *)prog + get_bpf_prog_aux_offset());
 
-    // collect relevant prog metadata
     struct bpf_prog_t p = {};
     bpf_probe_read(&p.id, sizeof(p.id), (void *)prog_aux + get_bpf_prog_aux_id_offset());
+
+    // update context
+    syscall->bpf.prog_id = p.id;
+
+    // the helpers are only known when the program is loaded, don't overwrite them when an fd is handed out for a
+    // program that is already known
+    if (syscall->bpf.cmd != BPF_PROG_LOAD && bpf_map_lookup_elem(&bpf_progs, &p.id) != NULL) {
+        return 0;
+    }
+
+    // collect relevant prog metadata
     bpf_probe_read(&p.prog_type, sizeof(p.prog_type), (void *)prog + get_bpf_prog_type_offset());
     if (get_bpf_prog_attach_type_offset() > 0) {
         bpf_probe_read(&p.attach_type, sizeof(p.attach_type), (void *)prog + get_bpf_prog_attach_type_offset());
@@ -142,9 +201,6 @@ int hook_security_bpf_prog(ctx_t *ctx) {
     bpf_probe_read(&p.name, sizeof(p.name), (void *)prog_aux + get_bpf_prog_aux_name_offset());
     bpf_probe_read(&p.tag, sizeof(p.tag), (void *)prog + get_bpf_prog_tag_offset());
 
-    // update context
-    syscall->bpf.prog_id = p.id;
-
     // add prog helpers
     p.helpers[0] = syscall->bpf.helpers[0];
     p.helpers[1] = syscall->bpf.helpers[1];
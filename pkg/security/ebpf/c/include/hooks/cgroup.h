@@ -47,8 +47,6 @@ static __attribute__((always_inline)) int trace__cgroup_write(ctx_t *ctx) {
     }
 
     struct dentry *container_d;
-    struct qstr container_qstr;
-    char *container_id;
 
     switch (cgroup_write_type) {
         case CGROUP_DEFAULT: {
@@ -60,15 +58,11 @@ static __attribute__((always_inline)) int trace__cgroup_write(ctx_t *ctx) {
 
             // The last dentry in the cgroup path should be `cgroup.procs`, thus the container ID should be its parent.
             bpf_probe_read(&container_d, sizeof(container_d), &dentry->d_parent);
-            bpf_probe_read(&container_qstr, sizeof(container_qstr), &container_d->d_name);
-            container_id = (void*) container_qstr.name;
             break;
         }
         case CGROUP_CENTOS_7: {
             void *cgroup = (void *) CTX_PARM1(ctx);
             bpf_probe_read(&container_d, sizeof(container_d), cgroup + 72); // offsetof(struct cgroup, dentry)
-            bpf_probe_read(&container_qstr, sizeof(container_qstr), &container_d->d_name);
-            container_id = (void*) container_qstr.name;
             break;
         }
         default:
@@ -76,6 +70,31 @@ static __attribute__((always_inline)) int trace__cgroup_write(ctx_t *ctx) {
             return 0;
     }
 
+    // the container of a cgroup is only parsed from its name the first time a process is attached to it, the
+    // container runtimes writing to the same cgroup for each process they start
+    struct cgroup_key_t cgroup_key = {
+        .ino = get_dentry_ino(container_d),
+        .dev = get_dentry_dev(container_d),
+    };
+    u64 *container_key = bpf_map_lookup_elem(&cgroup_container_keys, &cgroup_key);
+    if (container_key) {
+        if (*container_key == 0) {
+            // not a container cgroup
+            return 0;
+        }
+
+        struct container_context_t *container = bpf_map_lookup_elem(&container_ids, container_key);
+        if (container) {
+            copy_container_id(container->container_id, new_entry.container.container_id);
+            new_entry.container_key = *container_key;
+            goto update;
+        }
+    }
+
+    struct qstr container_qstr;
+    bpf_probe_read(&container_qstr, sizeof(container_qstr), &container_d->d_name);
+    char *container_id = (void*) container_qstr.name;
+
     char prefix[15];
     bpf_probe_read(&prefix, sizeof(prefix), container_id);
     if (prefix[0] == 'd' && prefix[1] == 'o' && prefix[2] == 'c' && prefix[3] == 'k' && prefix[4] == 'e'
@@ -97,11 +116,21 @@ static __attribute__((always_inline)) int trace__cgroup_write(ctx_t *ctx) {
 
     bpf_probe_read(&new_entry.container.container_id, sizeof(new_entry.container.container_id), container_id);
     if (!is_container_id_valid(new_entry.container.container_id)) {
+        u64 no_container = 0;
+        bpf_map_update_elem(&cgroup_container_keys, &cgroup_key, &no_container, BPF_ANY);
         return 0;
     }
+    register_container_id(&new_entry);
+    bpf_map_update_elem(&cgroup_container_keys, &cgroup_key, &new_entry.container_key, BPF_ANY);
 
+update:
     bpf_map_update_elem(&proc_cache, &cookie, &new_entry, BPF_ANY);
 
+    // the task storage of the other processes is refreshed by their next exec
+    if (pid == bpf_get_current_pid_tgid() >> 32) {
+        store_current_proc_cache(cookie, &new_entry);
+    }
+
     if (new_cookie) {
         struct pid_cache_t new_pid_entry = {
             .cookie = cookie,
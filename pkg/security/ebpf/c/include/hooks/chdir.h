@@ -134,7 +134,7 @@ int __attribute__((always_inline)) dr_chdir_callback(void *ctx) {
     fill_file(syscall->chdir.dentry, &event.file);
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_CHDIR);
 
     send_event(ctx, EVENT_CHDIR, event);
     return 0;
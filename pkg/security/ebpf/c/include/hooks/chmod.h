@@ -60,7 +60,7 @@ int __attribute__((always_inline)) sys_chmod_ret(void *ctx, int retval) {
 
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_CHMOD);
 
     // dentry resolution in setattr.h
 
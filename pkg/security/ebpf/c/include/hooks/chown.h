@@ -73,7 +73,7 @@ int __attribute__((always_inline)) sys_chown_ret(void *ctx, int retval) {
 
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_CHOWN);
 
     // dentry resolution in setattr.h
 
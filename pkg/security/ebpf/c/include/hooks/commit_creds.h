@@ -2,6 +2,7 @@
 #define _HOOKS_COMMIT_CREDS_H_
 
 #include "constants/syscall_macro.h"
+#include "helpers/discarders.h"
 #include "helpers/syscalls.h"
 #include "helpers/events_predicates.h"
 
@@ -10,10 +11,39 @@ int __attribute__((always_inline)) credentials_update(u64 type) {
         .type = type,
     };
 
+    if (is_credentials_dedup_enabled()) {
+        u32 pid = bpf_get_current_pid_tgid() >> 32;
+        struct pid_cache_t *pid_entry = (struct pid_cache_t *)bpf_map_lookup_elem(&pid_cache, &pid);
+        if (pid_entry) {
+            syscall.creds.credentials = pid_entry->credentials;
+            syscall.creds.known = 1;
+        }
+    }
+
     cache_syscall(&syscall);
     return 0;
 }
 
+// credentials_unchanged returns whether the credentials reported by an event of this type are the ones the process
+// had before the syscall, as when a daemon switches to the credentials it already has, or when the libc applies the
+// change of the first thread to the other threads of the process
+int __attribute__((always_inline)) credentials_unchanged(struct syscall_cache_t *syscall, struct credentials_t *credentials) {
+    if (!syscall->creds.known) {
+        return 0;
+    }
+
+    struct credentials_t *previous = &syscall->creds.credentials;
+    switch (syscall->type) {
+    case EVENT_SETUID:
+        return previous->uid == credentials->uid && previous->euid == credentials->euid && previous->fsuid == credentials->fsuid;
+    case EVENT_SETGID:
+        return previous->gid == credentials->gid && previous->egid == credentials->egid && previous->fsgid == credentials->fsgid;
+    case EVENT_CAPSET:
+        return previous->cap_effective == credentials->cap_effective && previous->cap_permitted == credentials->cap_permitted;
+    }
+    return 0;
+}
+
 int __attribute__((always_inline)) credentials_update_ret(void *ctx, int retval) {
     struct syscall_cache_t *syscall = pop_syscall_with(credentials_predicate);
     if (!syscall) {
@@ -30,12 +60,17 @@ int __attribute__((always_inline)) credentials_update_ret(void *ctx, int retval)
         return 0;
     }
 
+    if (credentials_unchanged(syscall, &pid_entry->credentials)) {
+        monitor_discarded(syscall->type);
+        return 0;
+    }
+
     switch (syscall->type) {
     case EVENT_SETUID: {
         struct setuid_event_t event = {};
         struct proc_cache_t *entry = fill_process_context(&event.process);
         fill_container_context(entry, &event.container);
-        fill_span_context(&event.span);
+        fill_span_context(&event.span, EVENT_SETUID);
 
         event.uid = pid_entry->credentials.uid;
         event.euid = pid_entry->credentials.euid;
@@ -47,7 +82,7 @@ int __attribute__((always_inline)) credentials_update_ret(void *ctx, int retval)
         struct setgid_event_t event = {};
         struct proc_cache_t *entry = fill_process_context(&event.process);
         fill_container_context(entry, &event.container);
-        fill_span_context(&event.span);
+        fill_span_context(&event.span, EVENT_SETGID);
 
         event.gid = pid_entry->credentials.gid;
         event.egid = pid_entry->credentials.egid;
@@ -59,7 +94,7 @@ int __attribute__((always_inline)) credentials_update_ret(void *ctx, int retval)
         struct capset_event_t event = {};
         struct proc_cache_t *entry = fill_process_context(&event.process);
         fill_container_context(entry, &event.container);
-        fill_span_context(&event.span);
+        fill_span_context(&event.span, EVENT_CAPSET);
 
         event.cap_effective = pid_entry->credentials.cap_effective;
         event.cap_permitted = pid_entry->credentials.cap_permitted;
@@ -6,8 +6,41 @@
 #include "helpers/discarders.h"
 #include "helpers/syscalls.h"
 
+// Checks the ancestor found in the subtree discarders by the current iteration of the resolution, if any. Only the
+// closest ancestor is fully checked to keep the per level cost of the resolution to a single map lookup.
+int __attribute__((always_inline)) is_discarded_by_subtree(struct dentry_resolver_input_t *input, struct is_discarded_by_inode_t *params) {
+    if (!params->discarder.path_key.ino || !is_discarded_by_inode(params)) {
+        return 0;
+    }
+
+    if (input->flags & ACTIVITY_DUMP_RUNNING) {
+        input->flags |= SAVED_BY_ACTIVITY_DUMP;
+        return 0;
+    }
+
+    return 1;
+}
+
+// Returns whether the resolution can stop at an ancestor already in pathnames. The path_id being changed by the hooks
+// changing the association of the inodes and names, the mount one for the directories and the inode one for the
+// files, the entries of the same path_id were resolved from the same tree. When the discarders have to be checked, the resolution keeps following the cached entries, without reading
+// the dentries, until an ancestor is found in the subtree discarders.
+int __attribute__((always_inline)) is_cached_path(struct dentry_resolver_input_t *input, struct is_discarded_by_inode_t *params, struct path_key_t *key) {
+    if (key->ino == 0 || !bpf_map_lookup_elem(&pathnames, key)) {
+        return 0;
+    }
+
+    if (!input->discarder_type || params->discarder.path_key.ino) {
+        return 1;
+    }
+
+    input->flags |= DR_CACHED_PATH;
+    return 0;
+}
+
 int __attribute__((always_inline)) resolve_dentry_tail_call(void *ctx, struct dentry_resolver_input_t *input) {
     struct path_leaf_t map_value = {};
+    struct path_leaf_t *cached_value = NULL;
     struct path_key_t key = input->key;
     struct path_key_t next_key = input->key;
     struct qstr qstr;
@@ -28,65 +61,118 @@ int __attribute__((always_inline)) resolve_dentry_tail_call(void *ctx, struct de
         return DENTRY_INVALID;
     }
 
+    // the resolver input can be reused by the resolutions of a same syscall
+    if (input->iteration == 1) {
+        input->flags &= ~DR_CACHED_PATH;
+    }
+
 #pragma unroll
     for (int i = 0; i < DR_MAX_ITERATION_DEPTH; i++)
     {
-        bpf_probe_read(&d_parent, sizeof(d_parent), &dentry->d_parent);
-
         key = next_key;
-        if (dentry != d_parent) {
-            next_key.ino = get_dentry_ino(d_parent);
+        if (input->flags & DR_CACHED_PATH) {
+            cached_value = bpf_map_lookup_elem(&pathnames, &key);
+            if (cached_value) {
+                next_key = cached_value->parent;
+            } else {
+                // evicted meanwhile, the path ends here
+                next_key.ino = 0;
+                next_key.mount_id = 0;
+            }
         } else {
-            next_key.ino = 0;
-            next_key.mount_id = 0;
+            bpf_probe_read(&d_parent, sizeof(d_parent), &dentry->d_parent);
+
+            if (dentry != d_parent) {
+                next_key.ino = get_dentry_ino(d_parent);
+            } else {
+                next_key.ino = 0;
+                next_key.mount_id = 0;
+            }
         }
 
-        if (input->discarder_type && input->iteration == 1 && i <= 3) {
+        if (input->discarder_type && input->iteration == 1 && i == 0) {
             params->discarder.path_key.ino = key.ino;
             params->discarder.path_key.mount_id = key.mount_id;
-            params->discarder.is_leaf = i == 0;
+            params->discarder.is_leaf = 1;
 
-            if (is_discarded_by_inode(params)) {
+            if (is_discarded_by_inode(params) || is_discarded_by_probation(params, input)) {
                 if (input->flags & ACTIVITY_DUMP_RUNNING) {
                     input->flags |= SAVED_BY_ACTIVITY_DUMP;
                 } else {
                     return DENTRY_DISCARDED;
                 }
             }
-        }
-
-        bpf_probe_read(&qstr, sizeof(qstr), &dentry->d_name);
 
-        long len = bpf_probe_read_str(&map_value.name, sizeof(map_value.name), (void *)qstr.name);
-        if (len < 0) {
-            len = 0;
+            params->discarder = (struct inode_discarder_t){};
+        } else if (input->discarder_type && !params->discarder.path_key.ino) {
+            struct inode_discarder_t subtree = {
+                .path_key = {
+                    .ino = key.ino,
+                    .mount_id = key.mount_id,
+                },
+            };
+
+            if (bpf_map_lookup_elem(&subtree_discarders, &subtree)) {
+                params->discarder = subtree;
+            }
         }
-        map_value.len = len;
 
-        if (map_value.name[0] == '/' || map_value.name[0] == 0) {
-            next_key.ino = 0;
-            next_key.mount_id = 0;
+        // the path was already resolved by bpf_d_path and is sent with the event, only the leaf had to be checked
+        if (input->flags & DR_D_PATH) {
+            input->key.ino = 0;
+            return 1;
         }
 
-        map_value.parent = next_key;
+        if (input->flags & DR_CACHED_PATH) {
+            // only the closest ancestor in the subtree discarders is checked, stop there
+            if (params->discarder.path_key.ino) {
+                next_key.ino = 0;
+            }
+        } else {
+            bpf_probe_read(&qstr, sizeof(qstr), &dentry->d_name);
+
+            long len = bpf_probe_read_str(&map_value.name, sizeof(map_value.name), (void *)qstr.name);
+            if (len < 0) {
+                len = 0;
+            }
+            map_value.len = len;
+
+            if (map_value.name[0] == '/' || map_value.name[0] == 0) {
+                next_key.ino = 0;
+                next_key.mount_id = 0;
+            }
+
+            map_value.parent = next_key;
 
-        bpf_map_update_elem(&pathnames, &key, &map_value, BPF_ANY);
+            bpf_map_update_elem(&pathnames, &key, &map_value, BPF_ANY);
+
+            if (is_cached_path(input, params, &next_key)) {
+                next_key.ino = 0;
+            }
+        }
 
         dentry = d_parent;
         if (next_key.ino == 0) {
             // mark the path resolution as complete which will stop the tail calls
             input->key.ino = 0;
+            if (is_discarded_by_subtree(input, params)) {
+                return DENTRY_DISCARDED;
+            }
             return i + 1;
         }
     }
 
-    if (input->iteration == DR_MAX_TAIL_CALL) {
+    if (input->iteration == DR_MAX_TAIL_CALL && !(input->flags & DR_CACHED_PATH)) {
         map_value.name[0] = 0;
         map_value.parent.mount_id = 0;
         map_value.parent.ino = 0;
         bpf_map_update_elem(&pathnames, &next_key, &map_value, BPF_ANY);
     }
 
+    if (is_discarded_by_subtree(input, params)) {
+        return DENTRY_DISCARDED;
+    }
+
     // prepare for the next iteration
     input->dentry = d_parent;
     input->key = next_key;
@@ -153,38 +239,38 @@ int __attribute__((always_inline)) dentry_resolver_erpc_write_user(void *ctx, in
         map_value = bpf_map_lookup_elem(&pathnames, &iteration_key);
         if (map_value == NULL) {
             resolution_err = DR_ERPC_CACHE_MISS;
-            goto exit;
+            goto next_path;
         }
 
         // make sure we do not write outside of the provided buffer
-        if (state->cursor + sizeof(state->key) >= state->buffer_size) {
+        if (state->cursor + sizeof(state->key) >= state->slot_end) {
             resolution_err = DR_ERPC_BUFFER_SIZE;
-            goto exit;
+            goto next_path;
         }
 
         state->ret = bpf_probe_write_user((void *) state->userspace_buffer + state->cursor, &state->key, sizeof(state->key));
         if (state->ret < 0) {
             resolution_err = state->ret == -14 ? DR_ERPC_WRITE_PAGE_FAULT : DR_ERPC_UNKNOWN_ERROR;
-            goto exit;
+            goto next_path;
         }
         state->ret = bpf_probe_write_user((void *) state->userspace_buffer + state->cursor + offsetof(struct path_key_t, path_id), &state->challenge, sizeof(state->challenge));
         if (state->ret < 0) {
             resolution_err = state->ret == -14 ? DR_ERPC_WRITE_PAGE_FAULT : DR_ERPC_UNKNOWN_ERROR;
-            goto exit;
+            goto next_path;
         }
 
         state->cursor += sizeof(state->key);
 
         // make sure we do not write outside of the provided buffer
-        if (state->cursor + map_value->len >= state->buffer_size) {
+        if (state->cursor + map_value->len >= state->slot_end) {
             resolution_err = DR_ERPC_BUFFER_SIZE;
-            goto exit;
+            goto next_path;
         }
 
         state->ret = bpf_probe_write_user((void *) state->userspace_buffer + state->cursor, map_value->name, DR_MAX_SEGMENT_LENGTH + 1);
         if (state->ret < 0) {
             resolution_err = state->ret == -14 ? DR_ERPC_WRITE_PAGE_FAULT : DR_ERPC_UNKNOWN_ERROR;
-            goto exit;
+            goto next_path;
         }
 
         state->cursor += map_value->len;
@@ -193,7 +279,15 @@ int __attribute__((always_inline)) dentry_resolver_erpc_write_user(void *ctx, in
         state->key.path_id = map_value->parent.path_id;
         state->key.mount_id = map_value->parent.mount_id;
         if (state->key.ino == 0) {
-            goto exit;
+            goto next_path;
+        }
+        continue;
+
+    next_path:
+        monitor_resolution_err(resolution_err);
+        resolution_err = 0;
+        if (!dr_erpc_next_path(state)) {
+            return 0;
         }
     }
     if (state->iteration < DR_MAX_TAIL_CALL) {
@@ -201,7 +295,6 @@ int __attribute__((always_inline)) dentry_resolver_erpc_write_user(void *ctx, in
         resolution_err = DR_ERPC_TAIL_CALL_ERROR;
     }
 
-exit:
     monitor_resolution_err(resolution_err);
     return 0;
 }
@@ -237,39 +330,39 @@ int __attribute__((always_inline)) dentry_resolver_erpc_mmap(void *ctx, int dr_t
         map_value = bpf_map_lookup_elem(&pathnames, &iteration_key);
         if (map_value == NULL) {
             resolution_err = DR_ERPC_CACHE_MISS;
-            goto exit;
+            goto next_path;
         }
 
         // make sure we do not write outside of the provided buffer
-        if (state->cursor + sizeof(state->key) >= state->buffer_size) {
+        if (state->cursor + sizeof(state->key) >= state->slot_end) {
             resolution_err = DR_ERPC_BUFFER_SIZE;
-            goto exit;
+            goto next_path;
         }
 
         state->ret = bpf_probe_read((void *) mmapped_userspace_buffer + (state->cursor & 0x7FFF), sizeof(state->key), &state->key);
         if (state->ret < 0) {
             resolution_err = state->ret == -14 ? DR_ERPC_WRITE_PAGE_FAULT : DR_ERPC_UNKNOWN_ERROR;
-            goto exit;
+            goto next_path;
         }
 
         state->ret = bpf_probe_read((void *) mmapped_userspace_buffer + ((state->cursor + offsetof(struct path_key_t, path_id)) & 0x7FFF), sizeof(state->challenge), &state->challenge);
         if (state->ret < 0) {
             resolution_err = state->ret == -14 ? DR_ERPC_WRITE_PAGE_FAULT : DR_ERPC_UNKNOWN_ERROR;
-            goto exit;
+            goto next_path;
         }
 
         state->cursor += sizeof(state->key);
 
         // make sure we do not write outside of the provided buffer
-        if (state->cursor + map_value->len >= state->buffer_size) {
+        if (state->cursor + map_value->len >= state->slot_end) {
             resolution_err = DR_ERPC_BUFFER_SIZE;
-            goto exit;
+            goto next_path;
         }
 
         state->ret = bpf_probe_read((void *) mmapped_userspace_buffer + (state->cursor & 0x7FFF), DR_MAX_SEGMENT_LENGTH + 1, map_value->name);
         if (state->ret < 0) {
             resolution_err = state->ret == -14 ? DR_ERPC_WRITE_PAGE_FAULT : DR_ERPC_UNKNOWN_ERROR;
-            goto exit;
+            goto next_path;
         }
 
         state->cursor += map_value->len;
@@ -278,7 +371,15 @@ int __attribute__((always_inline)) dentry_resolver_erpc_mmap(void *ctx, int dr_t
         state->key.path_id = map_value->parent.path_id;
         state->key.mount_id = map_value->parent.mount_id;
         if (state->key.ino == 0) {
-            goto exit;
+            goto next_path;
+        }
+        continue;
+
+    next_path:
+        monitor_resolution_err(resolution_err);
+        resolution_err = 0;
+        if (!dr_erpc_next_path(state)) {
+            return 0;
         }
     }
     if (state->iteration < DR_MAX_TAIL_CALL) {
@@ -286,7 +387,6 @@ int __attribute__((always_inline)) dentry_resolver_erpc_mmap(void *ctx, int dr_t
         resolution_err = DR_ERPC_TAIL_CALL_ERROR;
     }
 
-exit:
     monitor_resolution_err(resolution_err);
     return 0;
 }
@@ -63,7 +63,7 @@ int __attribute__((always_inline)) handle_interpreted_exec_event(void *ctx, stru
     bpf_probe_read(&interpreter_inode, sizeof(interpreter_inode), get_file_f_inode_addr(file));
 
     syscall->exec.linux_binprm.interpreter = get_inode_key_path(interpreter_inode, get_file_f_path_addr(file));
-    syscall->exec.linux_binprm.interpreter.path_id = get_path_id(syscall->exec.linux_binprm.interpreter.mount_id, 0);
+    update_path_id(&syscall->exec.linux_binprm.interpreter, 0);
 
 #ifdef DEBUG
     bpf_printk("interpreter file: %llx", file);
@@ -207,7 +207,7 @@ int sched_process_fork(struct _tracepoint_sched_process_fork *args) {
 
     struct process_context_t *on_stack_process = &event->process;
     fill_process_context(on_stack_process);
-    fill_span_context(&event->span);
+    fill_span_context(&event->span, EVENT_FORK);
 
     // the `parent_pid` entry of `sched_process_fork` might point to the TID (and not PID) of the parent. Since we
     // only work with PID, we can't use the TID. This is why we use the PID generated by the eBPF context instead.
@@ -223,12 +223,14 @@ int sched_process_fork(struct _tracepoint_sched_process_fork *args) {
         return 0;
     }
 
+    struct container_context_t container = {};
     struct pid_cache_t *parent_pid_entry = (struct pid_cache_t *) bpf_map_lookup_elem(&pid_cache, &ppid);
     if (parent_pid_entry) {
         // ensure pid and ppid point to the same cookie
         event->pid_entry.cookie = parent_pid_entry->cookie;
 
-        // ensure pid and ppid point to the same user session
+        // ensure pid and ppid point to the same user session. Only the session id is inherited, the session data is
+        // written once in user_sessions when the session is registered.
         event->pid_entry.user_session_id = parent_pid_entry->user_session_id;
 
         // ensure pid and ppid have the same credentials
@@ -239,6 +241,7 @@ int sched_process_fork(struct _tracepoint_sched_process_fork *args) {
         struct proc_cache_t *parent_pc = get_proc_from_cookie(on_stack_cookie);
         if (parent_pc) {
             fill_container_context(parent_pc, &event->container);
+            copy_container_id(parent_pc->container.container_id, container.container_id);
             copy_proc_entry(&parent_pc->entry, &event->proc_entry);
         }
     }
@@ -248,7 +251,7 @@ int sched_process_fork(struct _tracepoint_sched_process_fork *args) {
     bpf_map_update_elem(&pid_cache, &pid, &on_stack_pid_entry, BPF_ANY);
 
     // [activity_dump] inherit tracing state
-    inherit_traced_state(args, ppid, pid, event->container.container_id, event->proc_entry.comm);
+    inherit_traced_state(args, ppid, pid, container.container_id, event->proc_entry.comm, event->container.container_key);
 
     // send the entry to maintain userspace cache
     send_event_ptr(args, EVENT_FORK, event);
@@ -282,12 +285,16 @@ int hook_do_exit(ctx_t *ctx) {
 
     // delete netns entry
     bpf_map_delete_elem(&netns_cache, &pid);
+    // delete the namespaced tid of the span context
+    bpf_map_delete_elem(&span_ns_tids, &pid);
 
     u64 *pid_tgid_execing = (u64 *)bpf_map_lookup_elem(&exec_pid_transfer, &tgid);
 
     // only send the exit event if this is the thread group leader that isn't being killed by an execing thread
     if (tgid == pid && pid_tgid_execing == NULL) {
         expire_pid_discarder(tgid);
+        bpf_map_delete_elem(&jit_processes, &tgid);
+        bpf_map_delete_elem(&agent_tgids, &tgid);
 
         // update exit time
         struct pid_cache_t *pid_entry = (struct pid_cache_t *) bpf_map_lookup_elem(&pid_cache, &tgid);
@@ -305,7 +312,7 @@ int hook_do_exit(ctx_t *ctx) {
             dec_mount_ref(ctx, pc->entry.executable.path_key.mount_id);
         }
         fill_container_context(pc, &event.container);
-        fill_span_context(&event.span);
+        fill_span_context(&event.span, EVENT_EXIT);
         event.exit_code = (u32)(u64)CTX_PARM1(ctx);
         u8 *in_coredump = (u8 *)bpf_map_lookup_elem(&tasks_in_coredump, &pid_tgid);
         if (in_coredump) {
@@ -337,7 +344,7 @@ int hook_exit_itimers(ctx_t *ctx) {
     u64 pid_tgid = bpf_get_current_pid_tgid();
     u32 tgid = pid_tgid >> 32;
 
-    struct proc_cache_t *pc = get_proc_cache(tgid);
+    struct proc_cache_t *pc = lookup_proc_cache(tgid);
     if (pc) {
         u64 tty_offset;
         LOAD_CONSTANT("tty_offset", tty_offset);
@@ -350,6 +357,11 @@ int hook_exit_itimers(ctx_t *ctx) {
         if (tty) {
             bpf_probe_read_str(pc->entry.tty_name, TTY_NAME_LEN, (char *)tty + tty_name_offset);
         }
+
+        struct pid_cache_t *pid_entry = get_pid_cache(tgid);
+        if (pid_entry) {
+            store_current_proc_cache(pid_entry->cookie, pc);
+        }
     }
 
     return 0;
@@ -422,7 +434,110 @@ int tail_call_target_get_envs_offset(void *ctx) {
     return 0;
 }
 
-void __attribute__((always_inline)) parse_args_envs(void *ctx, struct args_envs_parsing_context_t *args_envs_ctx, struct args_envs_t *args_envs) {
+// is_env_allowed returns 1 if the environment variable starts with one of the prefixes of the envs_prefix_filter map
+int __attribute__((always_inline)) is_env_allowed(const char *env, int len) {
+    struct env_prefix_t key = {};
+    if (len > ENV_PREFIX_MAX_LEN) {
+        len = ENV_PREFIX_MAX_LEN;
+    }
+    key.prefixlen = len * 8;
+    bpf_probe_read(&key.name, sizeof(key.name), (void *)env);
+
+    return bpf_map_lookup_elem(&envs_prefix_filter, &key) != NULL;
+}
+
+// parse_args_envs_batched reads the strings directly into a ring buffer sized event, and sends them by chunks of up to
+// MAX_RINGBUF_STR_BUFF_LEN bytes instead of MAX_PERF_STR_BUFF_LEN
+void __attribute__((always_inline)) parse_args_envs_batched(void *ctx, struct args_envs_parsing_context_t *args_envs_ctx, struct args_envs_t *args_envs, int filter_envs) {
+    const char *args_start = args_envs_ctx->args_start;
+    int offset = args_envs_ctx->parsing_offset;
+
+    args_envs->truncated = 0;
+
+    u32 key = 0;
+    struct args_envs_batch_event_t *event = bpf_map_lookup_elem(&args_envs_batch_event_gen, &key);
+    if (!event) {
+        return;
+    }
+    event->event.flags = 0;
+    event->id = args_envs->id;
+    event->size = 0;
+
+    int i = 0;
+    int bytes_read = 0;
+
+#pragma unroll
+    for (i = 0; i < MAX_ARRAY_ELEMENT_PER_TAIL; i++) {
+        if (args_envs->counter == args_envs->count) {
+            break;
+        }
+
+        // event->size is lower than MAX_RINGBUF_STR_BUFF_LEN, the mask only bounds the offset for the verifier
+        char *string_array_ptr = &(event->value[(event->size + sizeof(bytes_read)) & (MAX_RINGBUF_STR_BUFF_LEN * 2 - 1)]);
+
+        bytes_read = bpf_probe_read_str((void *)string_array_ptr, MAX_ARRAY_ELEMENT_SIZE, (void *)(args_start + offset));
+        // skip empty strings
+        // depending on the kernel version, bpf_probe_read_str() may return 0 or 1 when reading empty strings
+        if (bytes_read == 0 || (bytes_read == 1 && *string_array_ptr == '\0')) {
+            offset += 1;
+            args_envs->counter++;
+        } else if (bytes_read > 0) {
+            bytes_read--; // remove trailing 0
+
+            // skip the environment variables not matching the in-kernel filter
+            if (filter_envs && !is_env_allowed(string_array_ptr, bytes_read)) {
+                offset += bytes_read + 1; // count trailing 0
+                args_envs->counter++;
+                continue;
+            }
+
+            // insert size before the string
+            bpf_probe_read(&(event->value[event->size & (MAX_RINGBUF_STR_BUFF_LEN * 2 - 1)]), sizeof(bytes_read), &bytes_read);
+
+            int data_length = bytes_read + sizeof(bytes_read);
+            if (event->size + data_length >= MAX_RINGBUF_STR_BUFF_LEN) {
+                // only one argument overflows the limit
+                if (event->size == 0) {
+                    event->size = MAX_RINGBUF_STR_BUFF_LEN;
+                    args_envs->counter++;
+                    offset += bytes_read + 1; // count trailing 0
+                }
+                // otherwise the string is read again at the beginning of the next chunk
+
+                u64 size = offsetof(struct args_envs_batch_event_t, value) + event->size;
+                if (size > sizeof(struct args_envs_batch_event_t)) {
+                    size = sizeof(struct args_envs_batch_event_t);
+                }
+                send_event_with_size_ptr(ctx, EVENT_ARGS_ENVS, event, size);
+                event->size = 0;
+            } else {
+                event->size += data_length;
+                args_envs->counter++;
+                offset += bytes_read + 1; // count trailing 0
+            }
+        } else {
+            break;
+        }
+    }
+    args_envs_ctx->parsing_offset = offset;
+    args_envs->truncated = i == MAX_ARRAY_ELEMENT_PER_TAIL;
+
+    // flush remaining values
+    if (event->size > 0) {
+        u64 size = offsetof(struct args_envs_batch_event_t, value) + event->size;
+        if (size > sizeof(struct args_envs_batch_event_t)) {
+            size = sizeof(struct args_envs_batch_event_t);
+        }
+        send_event_with_size_ptr(ctx, EVENT_ARGS_ENVS, event, size);
+    }
+}
+
+void __attribute__((always_inline)) parse_args_envs(void *ctx, struct args_envs_parsing_context_t *args_envs_ctx, struct args_envs_t *args_envs, int filter_envs) {
+    if (is_args_envs_batched()) {
+        parse_args_envs_batched(ctx, args_envs_ctx, args_envs, filter_envs);
+        return;
+    }
+
     const char *args_start = args_envs_ctx->args_start;
     int offset = args_envs_ctx->parsing_offset;
 
@@ -460,6 +575,13 @@ void __attribute__((always_inline)) parse_args_envs(void *ctx, struct args_envs_
         } else if (bytes_read > 0) {
             bytes_read--; // remove trailing 0
 
+            // skip the environment variables not matching the in-kernel filter
+            if (filter_envs && !is_env_allowed(string_array_ptr, bytes_read)) {
+                offset += bytes_read + 1; // count trailing 0
+                args_envs->counter++;
+                continue;
+            }
+
             // insert size before the string
             bpf_probe_read(&(buff->value[event.size&(MAX_STR_BUFF_LEN - MAX_ARRAY_ELEMENT_SIZE - 1)]), sizeof(bytes_read), &bytes_read);
 
@@ -509,6 +631,7 @@ int tail_call_target_parse_args_envs_split(void *ctx) {
     }
 
     struct args_envs_t *args_envs;
+    int filter_envs = 0;
 
     if (syscall->exec.args.counter < syscall->exec.args.count && syscall->exec.args.counter <= MAX_ARGS_ELEMENTS) {
         args_envs = &syscall->exec.args;
@@ -517,11 +640,12 @@ int tail_call_target_parse_args_envs_split(void *ctx) {
             syscall->exec.args_envs_ctx.parsing_offset = syscall->exec.args_envs_ctx.envs_offset;
         }
         args_envs = &syscall->exec.envs;
+        filter_envs = is_envs_filter_enabled();
     } else {
         return 0;
     }
 
-    parse_args_envs(ctx, &syscall->exec.args_envs_ctx, args_envs);
+    parse_args_envs(ctx, &syscall->exec.args_envs_ctx, args_envs, filter_envs);
 
     bpf_tail_call_compat(ctx, &args_envs_progs, EXEC_PARSE_ARGS_ENVS_SPLIT);
 
@@ -538,16 +662,18 @@ int tail_call_target_parse_args_envs(void *ctx) {
     }
 
     struct args_envs_t *args_envs;
+    int filter_envs = 0;
 
     if (syscall->exec.args.counter < syscall->exec.args.count) {
         args_envs = &syscall->exec.args;
     } else if (syscall->exec.envs.counter < syscall->exec.envs.count) {
         args_envs = &syscall->exec.envs;
+        filter_envs = is_envs_filter_enabled();
     } else {
         return 0;
     }
 
-    parse_args_envs(ctx, &syscall->exec.args_envs_ctx, args_envs);
+    parse_args_envs(ctx, &syscall->exec.args_envs_ctx, args_envs, filter_envs);
 
     bpf_tail_call_compat(ctx, &args_envs_progs, EXEC_PARSE_ARGS_ENVS);
 
@@ -690,7 +816,7 @@ int __attribute__((always_inline)) send_exec_event(ctx_t *ctx) {
             parent_inode = parent_pc->entry.executable.path_key.ino;
 
             // inherit the parent container context
-            fill_container_context(parent_pc, &pc.container);
+            copy_container_context(parent_pc, &pc);
             dec_mount_ref(ctx, parent_pc->entry.executable.path_key.mount_id);
         }
     }
@@ -699,6 +825,11 @@ int __attribute__((always_inline)) send_exec_event(ctx_t *ctx) {
     // the container ID before saving the entry in proc_cache. Modifying entry after insertion won't work.)
     u64 cookie = rand64();
     bpf_map_update_elem(&proc_cache, &cookie, &pc, BPF_ANY);
+    store_current_proc_cache(cookie, &pc);
+
+    // the new image has to be flagged as a JIT runtime or as an agent process again
+    bpf_map_delete_elem(&jit_processes, &tgid);
+    bpf_map_delete_elem(&agent_tgids, &tgid);
 
     // update pid <-> cookie mapping
     if (fork_entry) {
@@ -738,7 +869,7 @@ int __attribute__((always_inline)) send_exec_event(ctx_t *ctx) {
     fill_args_envs(event, syscall);
 
     // [activity_dump] check if this process should be traced
-    should_trace_new_process(ctx, now, tgid, event->container.container_id, event->proc_entry.comm);
+    should_trace_new_process(ctx, now, tgid, pc.container.container_id, event->proc_entry.comm, pc.container_key);
 
     // add interpreter path info
     event->linux_binprm.interpreter = syscall->exec.linux_binprm.interpreter;
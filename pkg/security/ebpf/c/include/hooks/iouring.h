@@ -33,4 +33,11 @@ int hook_io_sq_offload_start(ctx_t *ctx) {
     return 0;
 }
 
+HOOK_ENTRY("io_submit_sqes")
+int hook_io_submit_sqes(ctx_t *ctx) {
+    void *ioctx = (void *)CTX_PARM1(ctx);
+    cache_submit_ioctx(ioctx);
+    return 0;
+}
+
 #endif
@@ -68,7 +68,7 @@ int hook_vfs_link(ctx_t *ctx) {
     syscall->link.src_file.path_key.mount_id = get_path_mount_id(syscall->link.target_path);
 
     // force a new path id to force path resolution
-    set_file_inode(src_dentry, &syscall->link.src_file, 1);
+    set_file_inode(src_dentry, &syscall->link.src_file, PATH_ID_INVALIDATE_INODE);
 
     if (filter_syscall(syscall, link_approvers)) {
         return mark_as_discarded(syscall);
@@ -194,7 +194,7 @@ int __attribute__((always_inline)) dr_link_dst_callback(void *ctx) {
 
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_LINK);
 
     send_event(ctx, EVENT_LINK, event);
 
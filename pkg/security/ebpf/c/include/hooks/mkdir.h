@@ -81,6 +81,7 @@ int __attribute__((always_inline)) sys_mkdir_ret(void *ctx, int retval, int dr_t
     syscall->resolver.key = syscall->mkdir.file.path_key;
     syscall->resolver.dentry = syscall->mkdir.dentry;
     syscall->resolver.discarder_type = syscall->policy.mode != NO_FILTER ? EVENT_MKDIR : 0;
+    syscall->resolver.discarder_mode = syscall->mkdir.mode;
     syscall->resolver.callback = select_dr_key(dr_type, DR_MKDIR_CALLBACK_KPROBE_KEY, DR_MKDIR_CALLBACK_TRACEPOINT_KEY);
     syscall->resolver.iteration = 0;
     syscall->resolver.ret = 0;
@@ -151,7 +152,7 @@ int __attribute__((always_inline)) dr_mkdir_callback(void *ctx) {
     fill_file(syscall->mkdir.dentry, &event.file);
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_MKDIR);
 
     send_event(ctx, EVENT_MKDIR, event);
     return 0;
@@ -125,7 +125,7 @@ int __attribute__((always_inline)) trace_init_module_ret(void *ctx, int retval,
 
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_INIT_MODULE);
 
     send_event(ctx, EVENT_INIT_MODULE, event);
     return 0;
@@ -190,7 +190,7 @@ int __attribute__((always_inline)) trace_delete_module_ret(void *ctx, int retval
 
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_DELETE_MODULE);
 
     send_event(ctx, EVENT_DELETE_MODULE, event);
     return 0;
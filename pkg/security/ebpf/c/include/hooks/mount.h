@@ -232,7 +232,7 @@ int __attribute__((always_inline)) dr_mount_stage_two_callback(void *ctx) {
         fill_mount_fields(syscall, &event.mountfields);
         struct proc_cache_t *entry = fill_process_context(&event.process);
         fill_container_context(entry, &event.container);
-        fill_span_context(&event.span);
+        fill_span_context(&event.span, EVENT_MOUNT);
 
         pop_syscall(EVENT_MOUNT);
         send_event(ctx, EVENT_MOUNT, event);
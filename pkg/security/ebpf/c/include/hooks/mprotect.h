@@ -37,6 +37,55 @@ int hook_security_file_mprotect(ctx_t *ctx) {
     bpf_probe_read(&syscall->mprotect.vm_start, sizeof(syscall->mprotect.vm_start), &vma->vm_start);
     bpf_probe_read(&syscall->mprotect.vm_end, sizeof(syscall->mprotect.vm_end), &vma->vm_end);
     syscall->mprotect.req_protection = (u64)CTX_PARM2(ctx);
+
+    struct file *vm_file = NULL;
+    bpf_probe_read(&vm_file, sizeof(vm_file), &vma->vm_file);
+    syscall->mprotect.anonymous = vm_file == NULL;
+    return 0;
+}
+
+// is_jit_mprotect_suppressed returns 1 when an anonymous write to exec transition comes from a process flagged as a JIT
+// runtime: a process that made jit_mprotect_threshold such transitions within a summary period. The suppressed
+// transitions are counted and attached to the first transition of the next period.
+int __attribute__((always_inline)) is_jit_mprotect_suppressed(struct syscall_cache_t *syscall, struct mprotect_event_t *event) {
+    u64 threshold = get_jit_mprotect_threshold();
+    if (threshold == 0 || !syscall->mprotect.anonymous
+        || !(syscall->mprotect.vm_protection & MPROTECT_VM_WRITE) || !(syscall->mprotect.req_protection & MPROTECT_PROT_EXEC)) {
+        return 0;
+    }
+
+    u32 tgid = bpf_get_current_pid_tgid() >> 32;
+    u64 now = bpf_ktime_get_ns();
+
+    struct jit_process_t *jit = bpf_map_lookup_elem(&jit_processes, &tgid);
+    if (jit == NULL) {
+        struct jit_process_t new_jit = {
+            .window_start = now,
+            .transitions = 1,
+        };
+        bpf_map_update_elem(&jit_processes, &tgid, &new_jit, BPF_ANY);
+        return 0;
+    }
+
+    if (now - jit->window_start >= get_jit_mprotect_summary_period()) {
+        event->suppressed_count = jit->suppressed;
+        jit->window_start = now;
+        jit->suppressed = 0;
+        if (!jit->flagged) {
+            jit->transitions = 1;
+        }
+        return 0;
+    }
+
+    if (jit->flagged) {
+        __sync_fetch_and_add(&jit->suppressed, 1);
+        return 1;
+    }
+
+    jit->transitions++;
+    if (jit->transitions >= threshold) {
+        jit->flagged = 1;
+    }
     return 0;
 }
 
@@ -57,9 +106,13 @@ int __attribute__((always_inline)) sys_mprotect_ret(void *ctx, int retval) {
         .vm_end = syscall->mprotect.vm_end,
     };
 
+    if (is_jit_mprotect_suppressed(syscall, &event)) {
+        return 0;
+    }
+
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_MPROTECT);
 
     send_event(ctx, EVENT_MPROTECT, event);
     return 0;
@@ -5,9 +5,10 @@
 #include "helpers/network.h"
 #include "perf_ring.h"
 
-__attribute__((always_inline)) int parse_dns_request(struct __sk_buff *skb, struct packet_t *pkt, struct dns_event_t *evt) {
+__attribute__((always_inline)) int parse_dns_request(struct __sk_buff *skb, struct packet_t *pkt, struct dns_event_t *evt, u64 *qname_hash) {
     u16 qname_length = 0;
     u8 end_of_name = 0;
+    u64 hash = FNV_OFFSET_BASIS;
 
     // Handle DNS request
     #pragma unroll
@@ -23,6 +24,7 @@ __attribute__((always_inline)) int parse_dns_request(struct __sk_buff *skb, stru
 
         qname_length += 1;
         pkt->offset += 1;
+        hash = (hash ^ (u8)evt->name[i]) * FNV_PRIME;
 
         if (evt->name[i] == 0) {
             end_of_name = 1;
@@ -43,6 +45,7 @@ __attribute__((always_inline)) int parse_dns_request(struct __sk_buff *skb, stru
     evt->qclass = htons(evt->qclass);
     pkt->offset += sizeof(u16);
 
+    *qname_hash = hash;
     return qname_length;
 }
 
@@ -100,7 +103,8 @@ int classifier_dns_request_parser(struct __sk_buff *skb) {
         return ACT_OK;
     }
 
-    int qname_length = parse_dns_request(skb, pkt, evt);
+    u64 qname_hash = 0;
+    int qname_length = parse_dns_request(skb, pkt, evt, &qname_hash);
     if (qname_length < 0) {
         // couldn't parse DNS request
         return ACT_OK;
@@ -112,8 +116,10 @@ int classifier_dns_request_parser(struct __sk_buff *skb) {
         return ACT_OK;
     }
 
-    // send DNS event
-    send_event_with_size_ptr(skb, EVENT_DNS, evt, offsetof(struct dns_event_t, name) + qname_length);
+    // send DNS event, unless the same question was just sent
+    if (!is_dns_request_repeated(evt, qname_hash)) {
+        send_event_with_size_ptr(skb, EVENT_DNS, evt, offsetof(struct dns_event_t, name) + qname_length);
+    }
 
     if (!is_dns_request_parsing_done(skb, pkt)) {
         tail_call_to_classifier(skb, DNS_REQUEST_PARSER);
@@ -13,6 +13,10 @@ int classifier_imds_request(struct __sk_buff *skb) {
         return ACT_OK;
     }
 
+    if (skb == NULL || !is_http_start(skb, pkt)) {
+        return ACT_OK;
+    }
+
     struct imds_event_t *evt = reset_imds_event(skb, pkt);
     if (evt == NULL || skb == NULL) {
         // should never happen
@@ -105,6 +105,11 @@ int hook___dev_get_by_index(ctx_t *ctx) {
         cache->ifindex = entry;
     }
 
+    // this function is called by most of the device lookups, only the veth devices matter to dev_change_net_namespace
+    if (bpf_map_lookup_elem(&veth_devices, &entry) == NULL) {
+        return 0;
+    }
+
     bpf_map_update_elem(&netdevice_lookup_cache, &id, &entry, BPF_ANY);
     return 0;
 };
@@ -167,6 +172,9 @@ int rethook_register_netdevice(ctx_t *ctx) {
     char *name = get_net_device_name(entry->device);
     bpf_probe_read(&device.name, sizeof(device.name), name);
 
+    // the registration is over, stale entries would fill up the map
+    bpf_map_delete_elem(&register_netdevice_cache, &id);
+
     // check where we're at in the veth state machine
     struct veth_state_t *state = bpf_map_lookup_elem(&veth_state_machine, &id);
     if (state == NULL) {
@@ -177,7 +185,7 @@ int rethook_register_netdevice(ctx_t *ctx) {
 
         struct proc_cache_t *entry = fill_process_context(&evt.process);
         fill_container_context(entry, &evt.container);
-        fill_span_context(&evt.span);
+        fill_span_context(&evt.span, EVENT_NET_DEVICE);
 
         send_event(ctx, EVENT_NET_DEVICE, evt);
         return 0;
@@ -226,7 +234,7 @@ int rethook_register_netdevice(ctx_t *ctx) {
 
                 struct proc_cache_t *proc_entry = fill_process_context(&evt.process);
                 fill_container_context(proc_entry, &evt.container);
-                fill_span_context(&evt.span);
+                fill_span_context(&evt.span, EVENT_VETH_PAIR);
 
                 send_event(ctx, EVENT_VETH_PAIR, evt);
             }
@@ -245,9 +253,10 @@ __attribute__((always_inline)) int trace_dev_change_net_namespace(ctx_t *ctx) {
     if (ifindex == NULL) {
         return 0;
     }
+    struct device_ifindex_t key = *ifindex;
+    bpf_map_delete_elem(&netdevice_lookup_cache, &id);
 
     // lookup device
-    struct device_ifindex_t key = *ifindex;
     struct device_t *device = bpf_map_lookup_elem(&veth_devices, &key);
     if (device == NULL) {
         return 0;
@@ -273,7 +282,7 @@ __attribute__((always_inline)) int trace_dev_change_net_namespace(ctx_t *ctx) {
 
     struct proc_cache_t *entry = fill_process_context(&evt.process);
     fill_container_context(entry, &evt.container);
-    fill_span_context(&evt.span);
+    fill_span_context(&evt.span, EVENT_VETH_PAIR);
 
     send_event(ctx, EVENT_VETH_PAIR, evt);
     return 0;
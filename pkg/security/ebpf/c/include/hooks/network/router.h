@@ -3,7 +3,37 @@
 
 #include "helpers/network.h"
 
+__attribute__((always_inline)) int is_imds_ipv6(struct in6_addr *addr) {
+    return addr->in6_u.u6_addr32[0] == htonl(IMDS_IPV6_PREFIX) && addr->in6_u.u6_addr32[1] == 0 && addr->in6_u.u6_addr32[2] == 0 && addr->in6_u.u6_addr32[3] == htonl(IMDS_IPV6_SUFFIX);
+}
+
+__attribute__((always_inline)) int is_imds_flow(struct packet_t *pkt) {
+    if (pkt->l4_protocol != IPPROTO_TCP) {
+        return 0;
+    }
+
+    switch (pkt->eth.h_proto) {
+        case htons(ETH_P_IP):
+            return pkt->ipv4.saddr == get_imds_ip() || pkt->ipv4.daddr == get_imds_ip();
+        case htons(ETH_P_IPV6):
+            return is_imds_ipv6(&pkt->ipv6.saddr) || is_imds_ipv6(&pkt->ipv6.daddr);
+    }
+    return 0;
+}
+
 __attribute__((always_inline)) int route_pkt(struct __sk_buff *skb, struct packet_t *pkt, int network_direction) {
+    // fast path: only the DNS and IMDS requests are routed, skip the conntrack and pid lookups of the other flows. IMDS
+    // flows are matched on the packet itself, DNS flows on the translated flow, hence the verdict cache for UDP.
+    if (pkt->l4_protocol == IPPROTO_TCP && !is_imds_flow(pkt)) {
+        return ACT_OK;
+    }
+    if (pkt->l4_protocol == IPPROTO_UDP) {
+        u8 *verdict = bpf_map_lookup_elem(&udp_flow_verdicts, &pkt->ns_flow);
+        if (verdict && *verdict == FLOW_VERDICT_SKIP) {
+            return ACT_OK;
+        }
+    }
+
     struct pid_route_t pid_route = {};
     struct namespaced_flow_t tmp_ns_flow = pkt->ns_flow; // for compatibility with older kernels
     pkt->translated_ns_flow = pkt->ns_flow;
@@ -44,12 +74,17 @@ __attribute__((always_inline)) int route_pkt(struct __sk_buff *skb, struct packe
     // TODO: l3 / l4 firewall
 
     // route DNS requests
-    if (pkt->l4_protocol == IPPROTO_UDP && pkt->translated_ns_flow.flow.dport == htons(53)) {
-        tail_call_to_classifier(skb, DNS_REQUEST);
+    if (pkt->l4_protocol == IPPROTO_UDP) {
+        if (pkt->translated_ns_flow.flow.dport == htons(53)) {
+            tail_call_to_classifier(skb, DNS_REQUEST);
+        } else {
+            u8 verdict = FLOW_VERDICT_SKIP;
+            bpf_map_update_elem(&udp_flow_verdicts, &pkt->ns_flow, &verdict, BPF_ANY);
+        }
     }
 
     // route IMDS requests
-    if (pkt->l4_protocol == IPPROTO_TCP && ((pkt->ns_flow.flow.saddr[0] & 0xFFFFFFFF) == get_imds_ip() || (pkt->ns_flow.flow.daddr[0] & 0xFFFFFFFF) == get_imds_ip() )) {
+    if (is_imds_flow(pkt)) {
         tail_call_to_classifier(skb, IMDS_REQUEST);
     }
 
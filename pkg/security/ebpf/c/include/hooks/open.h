@@ -5,6 +5,7 @@
 #include "constants/fentry_macro.h"
 #include "helpers/approvers.h"
 #include "helpers/discarders.h"
+#include "helpers/enforcement.h"
 #include "helpers/filesystem.h"
 #include "helpers/exec.h"
 #include "helpers/iouring.h"
@@ -77,10 +78,14 @@ int __attribute__((always_inline)) handle_open_event(struct syscall_cache_t *sys
     struct dentry *dentry = get_path_dentry(path);
 
     syscall->open.dentry = dentry;
+    syscall->open.vfsmount = get_path_vfsmount(path);
     syscall->open.file.path_key = get_inode_key_path(inode, path);
 
     set_file_inode(dentry, &syscall->open.file, 0);
 
+    // handle the kernel kill rules
+    enforce_kill_rules(dentry, EVENT_OPEN);
+
     if (filter_syscall(syscall, open_approvers)) {
         return mark_as_discarded(syscall);
     }
@@ -108,6 +113,7 @@ int hook_vfs_truncate(ctx_t *ctx) {
     }
 
     syscall->open.dentry = dentry;
+    syscall->open.vfsmount = get_path_vfsmount(path);
     syscall->open.file.path_key = get_dentry_key_path(syscall->open.dentry, path);
 
     set_file_inode(dentry, &syscall->open.file, 0);
@@ -139,6 +145,43 @@ int hook_vfs_open(ctx_t *ctx) {
     return handle_open_event(syscall, file, path, inode);
 }
 
+#ifdef USE_FENTRY
+// bpf_d_path is only allowed on a few hooks, security_file_open being the one shared by all the open paths. The path
+// it resolves is sent with the event, the dentry resolver then only checks the leaf discarder. This hook is excluded
+// unless the d_path dentry resolution is enabled.
+HOOK_ENTRY("security_file_open")
+int hook_security_file_open(ctx_t *ctx) {
+    struct syscall_cache_t *syscall = peek_syscall(EVENT_OPEN);
+    if (!syscall || syscall->discarded || (syscall->resolver.flags & DR_D_PATH)) {
+        return 0;
+    }
+
+    // the name of a O_TMPFILE file is suffixed by bpf_d_path, leave it to the dentry resolver
+    if (syscall->open.flags & __O_TMPFILE) {
+        return 0;
+    }
+
+    struct file *file = (struct file *)CTX_PARM1(ctx);
+
+    // ignore the nested opens, such as the ones of the backing files of overlayfs
+    if (get_file_dentry(file) != syscall->open.dentry) {
+        return 0;
+    }
+
+    struct dr_d_path_t d_path = {};
+    if (bpf_d_path(get_file_f_path_addr(file), d_path.path, sizeof(d_path.path)) < 0 || d_path.path[0] != '/') {
+        return 0;
+    }
+
+    u64 pid_tgid = bpf_get_current_pid_tgid();
+    if (bpf_map_update_elem(&dr_d_paths, &pid_tgid, &d_path, BPF_ANY) == 0) {
+        syscall->resolver.flags |= DR_D_PATH;
+    }
+
+    return 0;
+}
+#endif
+
 HOOK_ENTRY("do_dentry_open")
 int hook_do_dentry_open(ctx_t *ctx) {
     struct syscall_cache_t *syscall = peek_syscall(EVENT_EXEC);
@@ -168,7 +211,7 @@ int __attribute__((always_inline)) trace_io_openat(ctx_t *ctx) {
         umode_t mode = req.how.mode & S_IALLUGO;
         return trace__sys_openat2(ASYNC_SYSCALL, flags, mode, pid_tgid);
     } else {
-        syscall->open.pid_tgid = get_pid_tgid_from_iouring(raw_req);
+        syscall->open.pid_tgid = pid_tgid;
     }
     return 0;
 }
@@ -204,6 +247,8 @@ int __attribute__((always_inline)) sys_open_ret(void *ctx, int retval, int dr_ty
     syscall->resolver.key = syscall->open.file.path_key;
     syscall->resolver.dentry = syscall->open.dentry;
     syscall->resolver.discarder_type = syscall->policy.mode != NO_FILTER ? EVENT_OPEN : 0;
+    syscall->resolver.discarder_flags = syscall->open.flags;
+    syscall->resolver.discarder_mode = syscall->open.mode;
     syscall->resolver.callback = select_dr_key(dr_type, DR_OPEN_CALLBACK_KPROBE_KEY, DR_OPEN_CALLBACK_TRACEPOINT_KEY);
     syscall->resolver.iteration = 0;
     syscall->resolver.ret = 0;
@@ -308,7 +353,22 @@ int __attribute__((always_inline)) dr_open_callback(void *ctx) {
         entry = fill_process_context(&event.process);
     }
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_OPEN);
+
+    if (syscall->resolver.flags & DR_D_PATH) {
+        u32 zero = 0;
+        u64 pid_tgid = bpf_get_current_pid_tgid();
+        struct open_d_path_event_t *d_path_event = bpf_map_lookup_elem(&open_d_path_event_gen, &zero);
+        struct dr_d_path_t *d_path = bpf_map_lookup_elem(&dr_d_paths, &pid_tgid);
+        if (d_path_event && d_path) {
+            d_path_event->open = event;
+            d_path_event->d_path = *d_path;
+            bpf_map_delete_elem(&dr_d_paths, &pid_tgid);
+
+            send_event_ptr(ctx, EVENT_OPEN, d_path_event);
+            return 0;
+        }
+    }
 
     send_event(ctx, EVENT_OPEN, event);
     return 0;
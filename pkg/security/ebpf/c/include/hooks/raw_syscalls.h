@@ -20,26 +20,32 @@ int sys_enter(struct _tracepoint_raw_syscalls_sys_enter *args) {
     fill_container_context(proc_cache_entry, &event.container);
 
     // check if this event should trigger a syscall drift event
-    if (is_anomaly_syscalls_enabled() && event.container.container_id[0] != 0) {
+    if (is_anomaly_syscalls_enabled() && proc_cache_entry && proc_cache_entry->container.container_id[0] != 0) {
         // fetch the profile for the current container
-        struct security_profile_t *profile = bpf_map_lookup_elem(&security_profiles, &event.container);
+        struct security_profile_t *profile = bpf_map_lookup_elem(&security_profiles, &proc_cache_entry->container);
         if (profile) {
             u64 cookie = profile->cookie;
             struct security_profile_syscalls_t *syscalls = bpf_map_lookup_elem(&secprofs_syscalls, &cookie);
             if (syscalls) {
-                // fetch the current syscall monitor entry
-                struct syscall_monitor_entry_t *entry = fetch_sycall_monitor_entry(&zero, pid, now, SYSCALL_MONITOR_TYPE_DRIFT);
-                if (entry == NULL) {
-                    // should never happen
-                    return 0;
-                }
+                struct syscall_monitor_entry_t *entry = NULL;
                 // is the current syscall in the profile ?
                 if (!syscall_mask_contains(syscalls->syscalls, args->id)) {
+                    // fetch the current syscall monitor entry
+                    entry = fetch_sycall_monitor_entry(&zero, pid, now, SYSCALL_MONITOR_TYPE_DRIFT);
+                    if (entry == NULL) {
+                        // should never happen
+                        return 0;
+                    }
                     syscall_monitor_entry_insert(entry, args->id);
+                } else {
+                    // the syscall is expected, only a process that already drifted has pending syscalls to flush
+                    entry = lookup_sycall_monitor_entry(pid, SYSCALL_MONITOR_TYPE_DRIFT);
+                }
+                if (entry) {
+                    // send an event if need be
+                    event.event.flags = EVENT_FLAGS_ANOMALY_DETECTION_EVENT;
+                    send_or_skip_syscall_monitor_event(args, &event, entry, &zero, SYSCALL_MONITOR_TYPE_DRIFT);
                 }
-                // send an event if need be
-                event.event.flags = EVENT_FLAGS_ANOMALY_DETECTION_EVENT;
-                send_or_skip_syscall_monitor_event(args, &event, entry, &zero, SYSCALL_MONITOR_TYPE_DRIFT);
             }
         }
     }
@@ -75,7 +75,7 @@ int hook_vfs_rename(ctx_t *ctx) {
 
     // use src_dentry as target inode is currently empty and the target file will
     // have the src inode anyway
-    set_file_inode(src_dentry, &syscall->rename.target_file, 1);
+    set_file_inode(src_dentry, &syscall->rename.target_file, PATH_ID_INVALIDATE_INODE);
 
     // we generate a fake source key as the inode is (can be ?) reused
     syscall->rename.src_file.path_key.ino = FAKE_INODE_MSW<<32 | bpf_get_prandom_u32();
@@ -84,6 +84,8 @@ int hook_vfs_rename(ctx_t *ctx) {
     u64 inode = get_dentry_ino(target_dentry);
     if (inode) {
         expire_inode_discarders(syscall->rename.target_file.path_key.mount_id, inode);
+        // the replaced inode can be reused, its cached path mustn't be
+        get_inode_path_id(inode, syscall->rename.target_file.path_key.mount_id, PATH_ID_INVALIDATE_INODE);
     }
 
     // always return after any invalidate_inode call
@@ -208,7 +210,7 @@ int __attribute__((always_inline)) dr_rename_callback(void *ctx) {
 
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_RENAME);
 
     send_event(ctx, EVENT_RENAME, event);
 
@@ -51,7 +51,7 @@ int hook_security_inode_rmdir(ctx_t *ctx) {
 
             // we resolve all the information before the file is actually removed
             dentry = (struct dentry *)CTX_PARM2(ctx);
-            set_file_inode(dentry, &syscall->rmdir.file, 1);
+            set_file_inode(dentry, &syscall->rmdir.file, PATH_ID_INVALIDATE_MOUNT);
             fill_file(dentry, &syscall->rmdir.file);
 
             // the mount id of path_key is resolved by kprobe/mnt_want_write. It is already set by the time we reach this probe.
@@ -70,7 +70,7 @@ int hook_security_inode_rmdir(ctx_t *ctx) {
 
             // we resolve all the information before the file is actually removed
             dentry = (struct dentry *) CTX_PARM2(ctx);
-            set_file_inode(dentry, &syscall->unlink.file, 1);
+            set_file_inode(dentry, &syscall->unlink.file, PATH_ID_INVALIDATE_MOUNT);
             fill_file(dentry, &syscall->unlink.file);
 
             // the mount id of path_key is resolved by kprobe/mnt_want_write. It is already set by the time we reach this probe.
@@ -141,7 +141,7 @@ int __attribute__((always_inline)) sys_rmdir_ret(void *ctx, int retval) {
 
         struct proc_cache_t *entry = fill_process_context(&event.process);
         fill_container_context(entry, &event.container);
-        fill_span_context(&event.span);
+        fill_span_context(&event.span, EVENT_RMDIR);
 
         send_event(ctx, EVENT_RMDIR, event);
     }
@@ -93,7 +93,7 @@ int __attribute__((always_inline)) dr_selinux_callback(void *ctx, int retval) {
 
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_SELINUX);
 
     send_event(ctx, EVENT_SELINUX, event);
     return 0;
@@ -85,6 +85,7 @@ int hook_security_inode_setattr(ctx_t *ctx) {
     syscall->resolver.dentry = syscall->setattr.dentry;
     syscall->resolver.key = syscall->setattr.file.path_key;
     syscall->resolver.discarder_type = syscall->policy.mode != NO_FILTER ? event_type : 0;
+    syscall->resolver.discarder_mode = event_type == EVENT_CHMOD ? syscall->setattr.mode : 0;
     syscall->resolver.callback = DR_SETATTR_CALLBACK_KPROBE_KEY;
     syscall->resolver.iteration = 0;
     syscall->resolver.ret = 0;
@@ -6,7 +6,63 @@
 #include "helpers/filesystem.h"
 #include "helpers/syscalls.h"
 
-int __attribute__((always_inline)) trace__sys_setxattr(const char *xattr_name) {
+// hash_xattr_value returns the hash of a xattr value, or 0 if the value is too large to be deduplicated
+u64 __attribute__((always_inline)) hash_xattr_value(const void *value, size_t size) {
+    if (get_setxattr_dedup_window() == 0 || size > MAX_XATTR_DEDUP_VALUE_LEN) {
+        return 0;
+    }
+
+    char buffer[MAX_XATTR_DEDUP_VALUE_LEN] = {};
+    if (size > 0 && bpf_probe_read(&buffer, sizeof(buffer), (void *)value) < 0) {
+        return 0;
+    }
+
+    u64 hash = FNV_OFFSET_BASIS ^ size;
+#pragma unroll
+    for (int i = 0; i < MAX_XATTR_DEDUP_VALUE_LEN; i++) {
+        if (i >= size) {
+            break;
+        }
+        hash ^= (u8)buffer[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// is_setxattr_repeated returns 1 when the same value was already set to the same xattr of the inode within the
+// dedup window. Image extractions set identical capabilities and labels over and over.
+int __attribute__((always_inline)) is_setxattr_repeated(struct setxattr_event_t *event, u64 value_hash) {
+    u64 window = get_setxattr_dedup_window();
+    if (window == 0 || value_hash == 0) {
+        return 0;
+    }
+
+    struct setxattr_dedup_key_t key = {
+        .path_key = event->file.path_key,
+        .name_hash = FNV_OFFSET_BASIS,
+        .value_hash = value_hash,
+    };
+
+#pragma unroll
+    for (int i = 0; i < MAX_XATTR_NAME_LEN; i++) {
+        if (event->name[i] == 0) {
+            break;
+        }
+        key.name_hash ^= (u8)event->name[i];
+        key.name_hash *= FNV_PRIME;
+    }
+
+    u64 now = bpf_ktime_get_ns();
+    u64 *last_seen = bpf_map_lookup_elem(&setxattr_dedup, &key);
+    if (last_seen != NULL && now - *last_seen < window) {
+        return 1;
+    }
+
+    bpf_map_update_elem(&setxattr_dedup, &key, &now, BPF_ANY);
+    return 0;
+}
+
+int __attribute__((always_inline)) trace__sys_setxattr(const char *xattr_name, const void *value, size_t size) {
     struct policy_t policy = fetch_policy(EVENT_SETXATTR);
     if (is_discarded_by_process(policy.mode, EVENT_SETXATTR)) {
         return 0;
@@ -17,6 +73,7 @@ int __attribute__((always_inline)) trace__sys_setxattr(const char *xattr_name) {
         .policy = policy,
         .xattr = {
             .name = xattr_name,
+            .value_hash = hash_xattr_value(value, size),
         }
     };
 
@@ -25,16 +82,16 @@ int __attribute__((always_inline)) trace__sys_setxattr(const char *xattr_name) {
     return 0;
 }
 
-HOOK_SYSCALL_ENTRY2(setxattr, const char *, filename, const char *, name) {
-    return trace__sys_setxattr(name);
+HOOK_SYSCALL_ENTRY4(setxattr, const char *, filename, const char *, name, const void *, value, size_t, size) {
+    return trace__sys_setxattr(name, value, size);
 }
 
-HOOK_SYSCALL_ENTRY2(lsetxattr, const char *, filename, const char *, name) {
-    return trace__sys_setxattr(name);
+HOOK_SYSCALL_ENTRY4(lsetxattr, const char *, filename, const char *, name, const void *, value, size_t, size) {
+    return trace__sys_setxattr(name, value, size);
 }
 
-HOOK_SYSCALL_ENTRY2(fsetxattr, int, fd, const char *, name) {
-    return trace__sys_setxattr(name);
+HOOK_SYSCALL_ENTRY4(fsetxattr, int, fd, const char *, name, const void *, value, size_t, size) {
+    return trace__sys_setxattr(name, value, size);
 }
 
 int __attribute__((always_inline)) trace__sys_removexattr(const char *xattr_name) {
@@ -148,10 +205,15 @@ int __attribute__((always_inline)) sys_xattr_ret(void *ctx, int retval, u64 even
     // copy xattr name
     bpf_probe_read_str(&event.name, MAX_XATTR_NAME_LEN, (void*) syscall->xattr.name);
 
+    if (event_type == EVENT_SETXATTR && retval >= 0 && is_setxattr_repeated(&event, syscall->xattr.value_hash)) {
+        monitor_discarded(EVENT_SETXATTR);
+        return 0;
+    }
+
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
     fill_file(syscall->xattr.dentry, &event.file);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, event_type);
 
     send_event(ctx, event_type, event);
 
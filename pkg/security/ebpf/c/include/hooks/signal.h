@@ -68,7 +68,7 @@ int rethook_check_kill_permission(ctx_t* ctx) {
     };
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_SIGNAL);
     send_event(ctx, EVENT_SIGNAL, event);
     return 0;
 }
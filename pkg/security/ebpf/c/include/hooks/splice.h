@@ -33,7 +33,18 @@ int hook_get_pipe_info(ctx_t *ctx) {
     // resolve the "in" file path
     if (!syscall->splice.file_found) {
         struct file *f = (struct file*) CTX_PARM1(ctx);
-        syscall->splice.dentry = get_file_dentry(f);
+        struct dentry *dentry = get_file_dentry(f);
+
+        // the proxies splice sockets to pipes, which no rule cares about, drop these calls before any resolution
+        u16 mode = 0;
+        bpf_probe_read(&mode, sizeof(mode), &get_dentry_inode(dentry)->i_mode);
+        if (S_ISSOCK(mode)) {
+            pop_syscall(EVENT_SPLICE);
+            monitor_discarded(EVENT_SPLICE);
+            return 0;
+        }
+
+        syscall->splice.dentry = dentry;
         syscall->splice.file.path_key.mount_id = get_file_mount_id(f);
         set_file_inode(syscall->splice.dentry, &syscall->splice.file, 0);
     }
@@ -105,7 +116,7 @@ int __attribute__((always_inline)) sys_splice_ret(void *ctx, int retval) {
 
     struct proc_cache_t *entry = fill_process_context(&event.process);
     fill_container_context(entry, &event.container);
-    fill_span_context(&event.span);
+    fill_span_context(&event.span, EVENT_SPLICE);
 
     send_event(ctx, EVENT_SPLICE, event);
 
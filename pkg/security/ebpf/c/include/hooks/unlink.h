@@ -61,7 +61,7 @@ int hook_vfs_unlink(ctx_t *ctx) {
 
     // we resolve all the information before the file is actually removed
     syscall->unlink.dentry = dentry;
-    set_file_inode(dentry, &syscall->unlink.file, 1);
+    set_file_inode(dentry, &syscall->unlink.file, PATH_ID_INVALIDATE_MOUNT);
     fill_file(dentry, &syscall->unlink.file);
 
     if (filter_syscall(syscall, unlink_approvers)) {
@@ -126,7 +126,7 @@ int __attribute__((always_inline)) sys_unlink_ret(void *ctx, int retval) {
 
             struct proc_cache_t *entry = fill_process_context(&event.process);
             fill_container_context(entry, &event.container);
-            fill_span_context(&event.span);
+            fill_span_context(&event.span, EVENT_RMDIR);
 
             send_event(ctx, EVENT_RMDIR, event);
         } else {
@@ -139,7 +139,7 @@ int __attribute__((always_inline)) sys_unlink_ret(void *ctx, int retval) {
 
             struct proc_cache_t *entry = fill_process_context(&event.process);
             fill_container_context(entry, &event.container);
-            fill_span_context(&event.span);
+            fill_span_context(&event.span, EVENT_UNLINK);
 
             send_event(ctx, EVENT_UNLINK, event);
         }
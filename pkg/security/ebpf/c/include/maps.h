@@ -11,8 +11,7 @@ BPF_ARRAY_MAP(path_id, u32, PATH_ID_MAP_SIZE)
 BPF_ARRAY_MAP(enabled_events, u64, 1)
 BPF_ARRAY_MAP(buffer_selector, u32, 4)
 BPF_ARRAY_MAP(dr_erpc_buffer, char[DR_ERPC_BUFFER_LENGTH*2], 1)
-BPF_ARRAY_MAP(inode_disc_revisions, u32, REVISION_ARRAY_SIZE)
-BPF_ARRAY_MAP(discarders_revision, u32, 1)
+BPF_ARRAY_MAP(discarders_revision, struct discarders_revision_t, 1)
 BPF_ARRAY_MAP(filter_policy, struct policy_t, EVENT_MAX)
 BPF_ARRAY_MAP(mmap_flags_approvers, u32, 1)
 BPF_ARRAY_MAP(mmap_protection_approvers, u32, 1)
@@ -26,21 +25,28 @@ BPF_ARRAY_MAP(bpf_cmd_approvers, u64, 1)
 BPF_ARRAY_MAP(syscalls_stats_enabled, u32, 1)
 BPF_ARRAY_MAP(syscall_ctx_gen_id, u32, 1)
 BPF_ARRAY_MAP(syscall_ctx, char[MAX_SYSCALL_CTX_SIZE], MAX_SYSCALL_CTX_ENTRIES)
+BPF_ARRAY_MAP(syscall_ctx_events, u64, 1)
+BPF_ARRAY_MAP(inode_path_id_gen, u32, 1)
 
 BPF_HASH_MAP(activity_dumps_config, u64, struct activity_dump_config, 1) // max entries will be overridden at runtime
+BPF_HASH_MAP(inode_disc_revisions, u32, u32, REVISION_ARRAY_SIZE)
 BPF_HASH_MAP(activity_dump_config_defaults, u32, struct activity_dump_config, 1)
 BPF_HASH_MAP(traced_cgroups, struct container_context_t, u64, 1) // max entries will be overridden at runtime
 BPF_HASH_MAP(cgroup_wait_list, struct container_context_t, u64, 1) // max entries will be overridden at runtime
 BPF_HASH_MAP(traced_pids, u32, u64, 8192) // max entries will be overridden at runtime
 BPF_HASH_MAP(traced_comms, char[TASK_COMM_LEN], u64, 200)
 BPF_HASH_MAP(basename_approvers, struct basename_t, struct basename_filter_t, 255)
+BPF_LPM_TRIE_MAP(prefix_approvers, struct prefix_approver_key_t, struct basename_filter_t, 255)
 BPF_HASH_MAP(register_netdevice_cache, u64, struct register_netdevice_cache_t, 1024)
 BPF_HASH_MAP(netdevice_lookup_cache, u64, struct device_ifindex_t, 1024)
 BPF_HASH_MAP(fd_link_pid, u8, u32, 1)
+BPF_HASH_MAP(agent_tgids, u32, u8, 64)
 BPF_HASH_MAP(security_profiles, struct container_context_t, struct security_profile_t, 1) // max entries will be overriden at runtime
 BPF_HASH_MAP(secprofs_syscalls, u64, struct security_profile_syscalls_t, 1) // max entries will be overriden at runtime
+BPF_HASH_MAP(kill_rules, struct kill_rule_key_t, struct kill_rule_t, 128)
+BPF_HASH_MAP(inode_path_ids, struct path_key_t, struct inode_path_id_t, 8192)
 
-BPF_LRU_MAP(activity_dump_rate_limiters, u64, struct activity_dump_rate_limiter_ctx, 1) // max entries will be overridden at runtime
+BPF_LRU_MAP(activity_dump_rate_limiters, struct activity_dump_rate_limiter_key_t, struct activity_dump_rate_limiter_ctx, 1) // max entries will be overridden at runtime
 BPF_LRU_MAP(mount_ref, u32, struct mount_ref_t, 64000)
 BPF_LRU_MAP(bpf_maps, u32, struct bpf_map_t, 4096)
 BPF_LRU_MAP(bpf_progs, u32, struct bpf_prog_t, 4096)
@@ -48,27 +54,42 @@ BPF_LRU_MAP(tgid_fd_map_id, struct bpf_tgid_fd_t, u32, 4096)
 BPF_LRU_MAP(tgid_fd_prog_id, struct bpf_tgid_fd_t, u32, 4096)
 BPF_LRU_MAP(proc_cache, u64, struct proc_cache_t, 1) // max entries will be overridden at runtime
 BPF_LRU_MAP(pid_cache, u32, struct pid_cache_t, 1) // max entries will be overridden at runtime
+BPF_LRU_MAP(jit_processes, u32, struct jit_process_t, 4096)
+BPF_LRU_MAP(container_ids, u64, struct container_context_t, 1024)
+BPF_LRU_MAP(cgroup_container_keys, struct cgroup_key_t, u64, 1024)
 BPF_LRU_MAP(pid_ignored, u32, u32, 16738)
 BPF_LRU_MAP(exec_pid_transfer, u32, u64, 512)
 BPF_LRU_MAP(netns_cache, u32, u32, 40960)
 BPF_LRU_MAP(span_tls, u32, struct span_tls_t, 4096)
+BPF_LRU_MAP(span_ns_tids, u32, u32, 40960)
 BPF_LRU_MAP(inode_discarders, struct inode_discarder_t, struct inode_discarder_params_t, 4096)
+BPF_LRU_MAP(subtree_discarders, struct inode_discarder_t, struct inode_discarder_params_t, 1024)
 BPF_LRU_MAP(pid_discarders, u32, struct pid_discarder_params_t, 512)
 BPF_LRU_MAP(pathnames, struct path_key_t, struct path_leaf_t, 1) // edited
+BPF_LRU_MAP(dr_d_paths, u64, struct dr_d_path_t, 1024)
 BPF_LRU_MAP(flow_pid, struct pid_route_t, u32, 10240)
 BPF_LRU_MAP(conntrack, struct namespaced_flow_t, struct namespaced_flow_t, 4096)
+BPF_LRU_MAP(udp_flow_verdicts, struct namespaced_flow_t, u8, 8192)
+BPF_LRU_MAP(dns_dedup, struct dns_dedup_key_t, struct dns_dedup_entry_t, 4096)
+BPF_LRU_MAP(setxattr_dedup, struct setxattr_dedup_key_t, u64, 4096)
 BPF_LRU_MAP(io_uring_ctx_pid, void*, u64, 2048)
 BPF_LRU_MAP(veth_state_machine, u64, struct veth_state_t, 1024)
 BPF_LRU_MAP(veth_devices, struct device_ifindex_t, struct device_t, 1024)
 BPF_LRU_MAP(veth_device_name_to_ifindex, struct device_name_t, struct device_ifindex_t, 1024)
 BPF_LRU_MAP(exec_file_cache, u64, struct file_t, 4096)
 BPF_LRU_MAP(syscall_monitor, struct syscall_monitor_key_t, struct syscall_monitor_entry_t, 2048)
+BPF_LRU_MAP(syscall_monitor_dumps, u32, struct syscall_monitor_entry_t, 8192) // same size as traced_pids so that the entries of the traced processes aren't evicted
 BPF_LRU_MAP(syscall_table, struct syscall_table_key_t, u8, 50)
 BPF_LRU_MAP(kill_list, u32, u32, 32)
+BPF_LRU_MAP(discarder_probations, struct discarder_probation_key_t, struct discarder_probation_t, 8192)
 BPF_LRU_MAP(user_sessions, struct user_session_key_t, struct user_session_t, 1024)
 
 BPF_LRU_MAP_FLAGS(tasks_in_coredump, u64, u8, 64, BPF_F_NO_COMMON_LRU)
 BPF_LRU_MAP_FLAGS(syscalls, u64, struct syscall_cache_t, 1, BPF_F_NO_COMMON_LRU) // max entries will be overridden at runtime
+#ifdef USE_FENTRY
+BPF_MAP(syscalls_task_storage, BPF_MAP_TYPE_TASK_STORAGE, int, struct syscall_cache_t, 0, 0, BPF_F_NO_PREALLOC) // type will be overridden at runtime if not supported
+BPF_MAP(proc_cache_task_storage, BPF_MAP_TYPE_TASK_STORAGE, int, struct proc_cache_task_storage_t, 0, 0, BPF_F_NO_PREALLOC) // type will be overridden at runtime if not supported
+#endif
 
 BPF_PERCPU_ARRAY_MAP(dr_erpc_state, struct dr_erpc_state_t, 1)
 BPF_PERCPU_ARRAY_MAP(cgroup_tracing_event_gen, struct cgroup_tracing_event_t, EVENT_GEN_SIZE)
@@ -77,12 +98,19 @@ BPF_PERCPU_ARRAY_MAP(bb_discarder_stats, struct discarder_stats_t, EVENT_LAST_DI
 BPF_PERCPU_ARRAY_MAP(fb_approver_stats, struct approver_stats_t, EVENT_LAST_APPROVER+1)
 BPF_PERCPU_ARRAY_MAP(bb_approver_stats, struct approver_stats_t, EVENT_LAST_APPROVER+1)
 BPF_PERCPU_ARRAY_MAP(str_array_buffers, struct str_array_buffer_t, 1)
+BPF_PERCPU_ARRAY_MAP(args_envs_batch_event_gen, struct args_envs_batch_event_t, 1)
+BPF_LPM_TRIE_MAP(envs_prefix_filter, struct env_prefix_t, u8, 64)
 BPF_PERCPU_ARRAY_MAP(process_event_gen, struct process_event_t, EVENT_GEN_SIZE)
 BPF_PERCPU_ARRAY_MAP(dr_erpc_stats_fb, struct dr_erpc_stats_t, 6)
 BPF_PERCPU_ARRAY_MAP(dr_erpc_stats_bb, struct dr_erpc_stats_t, 6)
 BPF_PERCPU_ARRAY_MAP(is_discarded_by_inode_gen, struct is_discarded_by_inode_t, 1)
+BPF_PERCPU_ARRAY_MAP(prefix_approver_gen, struct prefix_approver_gen_t, 1)
+BPF_PERCPU_ARRAY_MAP(activity_dump_cgroup_cache, struct activity_dump_cgroup_cache_t, 1)
+BPF_PERCPU_ARRAY_MAP(kill_rule_gen, struct kill_rule_key_t, 1)
+BPF_PERCPU_ARRAY_MAP(open_d_path_event_gen, struct open_d_path_event_t, 1)
 BPF_PERCPU_ARRAY_MAP(dns_event, struct dns_event_t, 1)
 BPF_PERCPU_ARRAY_MAP(imds_event, struct imds_event_t, 1)
+BPF_PERCPU_ARRAY_MAP(io_uring_ctx_cache, struct io_uring_ctx_cache_t, 1)
 BPF_PERCPU_ARRAY_MAP(packets, struct packet_t, 1)
 BPF_PERCPU_ARRAY_MAP(selinux_write_buffer, struct selinux_write_buffer_t, 1)
 BPF_PERCPU_ARRAY_MAP(is_new_kthread, u32, 1)
@@ -21,6 +21,27 @@ BPF_PERCPU_ARRAY_MAP(events_stats, struct perf_map_stats_t, EVENT_MAX)
 
 #if USE_RING_BUFFER == 1
 BPF_ARRAY_MAP(events_ringbuf_stats, u64, 1)
+BPF_PERF_EVENT_ARRAY_MAP(events_priority, u32) // turned into a ring buffer at runtime when used
+
+// is_priority_event returns true for the events sent to the priority ring buffer, so that a flood of file events can't
+// cause their loss. The args and envs are sent along with the exec events they belong to.
+int __attribute__((always_inline)) is_priority_event(u64 event_type) {
+    switch (event_type) {
+    case EVENT_FORK:
+    case EVENT_EXEC:
+    case EVENT_EXIT:
+    case EVENT_ARGS_ENVS:
+    case EVENT_SETUID:
+    case EVENT_SETGID:
+    case EVENT_CAPSET:
+    case EVENT_BPF:
+    case EVENT_PTRACE:
+    case EVENT_INIT_MODULE:
+    case EVENT_DELETE_MODULE:
+        return 1;
+    }
+    return 0;
+}
 
 void __attribute__((always_inline)) store_ring_buffer_stats() {
     // check needed for code elimination
@@ -47,7 +68,11 @@ void __attribute__((always_inline)) send_event_with_size_ptr(void *ctx, u64 even
     LOAD_CONSTANT("use_ring_buffer", use_ring_buffer);
     int perf_ret;
     if (use_ring_buffer) {
-        perf_ret = bpf_ringbuf_output(&events, kernel_event, kernel_event_size, 0);
+        if (is_priority_ring_buffer_used() && is_priority_event(event_type)) {
+            perf_ret = bpf_ringbuf_output(&events_priority, kernel_event, kernel_event_size, 0);
+        } else {
+            perf_ret = bpf_ringbuf_output(&events, kernel_event, kernel_event_size, 0);
+        }
     } else {
         perf_ret = bpf_perf_event_output(ctx, &events, cpu, kernel_event, kernel_event_size);
     }
@@ -55,12 +80,18 @@ void __attribute__((always_inline)) send_event_with_size_ptr(void *ctx, u64 even
     int perf_ret = bpf_perf_event_output(ctx, &events, cpu, kernel_event, kernel_event_size);
 #endif
 
+    // the sent events are sampled based on the low bits of their timestamp, the lost ones are always counted
+    u64 sampling_mask = get_events_stats_sampling_mask();
+    if (!perf_ret && (header->timestamp & sampling_mask)) {
+        return;
+    }
+
     if (event_type < EVENT_MAX) {
         struct perf_map_stats_t *stats = bpf_map_lookup_elem(&events_stats, &event_type);
         if (stats != NULL) {
             if (!perf_ret) {
-                __sync_fetch_and_add(&stats->bytes, kernel_event_size + 4);
-                __sync_fetch_and_add(&stats->count, 1);
+                __sync_fetch_and_add(&stats->bytes, (kernel_event_size + 4) * (sampling_mask + 1));
+                __sync_fetch_and_add(&stats->count, sampling_mask + 1);
             } else {
                 __sync_fetch_and_add(&stats->lost, 1);
             }
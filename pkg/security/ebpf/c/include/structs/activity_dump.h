@@ -1,11 +1,21 @@
 #ifndef _STRUCTS_ACTIVITY_DUMP_H_
 #define _STRUCTS_ACTIVITY_DUMP_H_
 
+struct activity_dump_rate_limiter_key_t {
+    u64 cookie;
+    u32 event_type;
+    u32 padding;
+};
+
+// activity_dump_cgroup_cache_t holds the traced container last seen by a CPU
+struct activity_dump_cgroup_cache_t {
+    u64 container_key;
+    u64 cookie;
+};
+
 struct activity_dump_rate_limiter_ctx {
-    u64 current_period;
-    u32 counter;
-    u8 algo_id;
-    u8 padding[3];
+    u64 last_refill;
+    s64 tokens;
 };
 
 struct activity_dump_config {
@@ -16,6 +26,7 @@ struct activity_dump_config {
     u64 end_timestamp;
     u32 events_rate;
     u32 paused;
+    u32 event_type_rates[AD_RL_EVENT_TYPES]; // indexed by event_type - EVENT_FIRST_DISCARDER, 0 means events_rate
 };
 
 #endif
@@ -9,22 +9,45 @@ struct path_key_t {
     u32 path_id;
 };
 
+struct inode_path_id_t {
+    u32 mount_path_id;
+    u32 path_id;
+};
+
 struct path_leaf_t {
   struct path_key_t parent;
   char name[DR_MAX_SEGMENT_LENGTH + 1];
   u16 len;
 };
 
+struct dr_d_path_t {
+    char path[MAX_PATH_LEN];
+};
+
 struct dr_erpc_state_t {
     char *userspace_buffer;
     struct path_key_t key;
+    struct path_key_t batch_keys[DR_ERPC_MAX_BATCH];
     int ret;
     int iteration;
     u32 buffer_size;
     u32 challenge;
+    u32 batch_index;
+    u32 batch_count;
+    u32 slot_size;
+    u32 slot_end;
     u16 cursor;
 };
 
+struct dr_erpc_batch_request_t {
+    char *userspace_buffer;
+    u32 buffer_size;
+    u32 challenge;
+    u32 count;
+    u32 padding;
+    struct path_key_t keys[DR_ERPC_MAX_BATCH];
+};
+
 struct dr_erpc_stats_t {
     u64 count;
 };
@@ -33,6 +56,8 @@ struct dentry_resolver_input_t {
     struct path_key_t key;
     struct dentry *dentry;
     u64 discarder_type;
+    u32 discarder_flags; // flags of the event, keying its discarder probation
+    u32 discarder_mode; // mode of the event, keying its discarder probation
     s64 sysretval;
     int callback;
     int ret;
@@ -25,4 +25,17 @@ struct dnshdr {
     uint16_t arcount;
 };
 
+struct dns_dedup_key_t {
+    u64 qname_hash;
+    u32 pid;
+    u16 qtype;
+    u16 padding;
+};
+
+struct dns_dedup_entry_t {
+    u64 window_start;
+    u32 repeat_count;
+    u32 padding;
+};
+
 #endif
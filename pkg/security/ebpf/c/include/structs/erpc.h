@@ -18,6 +18,16 @@ struct expire_inode_discarder_t {
     u32 mount_id;
 };
 
+struct reject_discarder_probation_t {
+    u64 event_type;
+    u64 inode;
+    u32 mount_id;
+    u32 tgid;
+    u32 flags;
+    u32 mode;
+    u64 cookie;
+};
+
 struct discard_pid_t {
     struct discard_request_t req;
     u32 pid;
@@ -36,6 +36,11 @@ struct container_context_t {
     char container_id[CONTAINER_ID_LEN];
 };
 
+// container_key_context_t is the container context sent with the events, see container_ids for the resolution of the key
+struct container_key_context_t {
+    u64 container_key;
+};
+
 struct ktimeval {
     long tv_sec;
     long tv_nsec;
@@ -14,6 +14,12 @@ struct mount_ref_t {
     s32 counter;
 };
 
+struct setxattr_dedup_key_t {
+    struct path_key_t path_key;
+    u64 name_hash;
+    u64 value_hash;
+};
+
  struct mount_fields_t {
     struct path_key_t root_key;
     struct path_key_t mountpoint_key;
@@ -15,6 +15,7 @@ struct policy_t {
 struct approver_stats_t {
     u64 event_approved_by_basename;
     u64 event_approved_by_flag;
+    u64 event_approved_by_prefix;
 };
 
 struct basename_t {
@@ -25,6 +26,32 @@ struct basename_filter_t {
     u64 event_mask;
 };
 
+struct prefix_approver_key_t {
+    u32 prefixlen;
+    char path[PREFIX_FILTER_SIZE];
+};
+
+// Kernel kill rules
+
+struct kill_rule_key_t {
+    struct basename_t basename;
+    u32 event_type;
+    u32 padding;
+};
+
+struct kill_rule_t {
+    u32 signal;
+    u32 flags;
+};
+
+struct prefix_approver_gen_t {
+    struct dentry *dentries[PREFIX_APPROVER_MAX_DEPTH];
+    // prefixlen and path are laid out as a prefix_approver_key_t, path being twice as large to keep the writes of
+    // the segments in bounds
+    u32 prefixlen;
+    char path[PREFIX_FILTER_SIZE * 2];
+};
+
 // Discarders
 
 struct discarder_stats_t {
@@ -42,7 +69,32 @@ struct discarder_params_t {
 
 struct inode_discarder_params_t {
     struct discarder_params_t params;
-    u32 mount_revision;
+};
+
+// The revisions are generations of a single counter: a discarder is valid as long as its revision is not lower than
+// the revision of its event type and of its mount.
+struct discarders_revision_t {
+    u32 counter;
+    u32 all;
+    u32 event_types[EVENT_MAX];
+};
+
+struct discarder_probation_key_t {
+    u64 inode;
+    u32 mount_id;
+    u32 tgid;
+    u32 flags;
+    u32 mode;
+    u64 event_type;
+};
+
+struct discarder_probation_t {
+    u64 window_start;
+    u64 cookie;
+    u32 count;
+    u32 rejected;
+    u32 revision;
+    u32 padding;
 };
 
 struct pid_discarder_params_t {
@@ -20,4 +20,9 @@ struct io_open {
     struct openat2_open_how how;
 };
 
+struct io_uring_ctx_cache_t {
+    void *ioctx;
+    u64 pid_tgid;
+};
+
 #endif
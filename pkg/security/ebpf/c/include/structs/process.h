@@ -16,6 +16,26 @@ struct process_entry_t {
 struct proc_cache_t {
     struct container_context_t container;
     struct process_entry_t entry;
+    u64 container_key;
+};
+
+struct proc_cache_task_storage_t {
+    u64 cookie; // 0 until the entry is filled
+    struct proc_cache_t entry;
+};
+
+// cgroup_key_t identifies a cgroup directory, the device telling apart the cgroup v1 hierarchies
+struct cgroup_key_t {
+    u64 ino;
+    u32 dev;
+    u32 padding;
+};
+
+struct jit_process_t {
+    u64 window_start;
+    u32 transitions;
+    u32 suppressed;
+    u8 flagged;
 };
 
 struct credentials_t {
@@ -46,6 +66,11 @@ struct args_envs_t {
     u8 truncated;
 };
 
+struct env_prefix_t {
+    u32 prefixlen; // in bits, as expected by the LPM trie
+    char name[ENV_PREFIX_MAX_LEN];
+};
+
 struct args_envs_parsing_context_t {
     const char *args_start;
     u64 envs_offset;
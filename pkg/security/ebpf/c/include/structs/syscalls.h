@@ -34,6 +34,7 @@ struct syscall_cache_t {
     u64 type;
     u8 discarded;
     u8 async;
+    u8 cached; // only used by the task storage, as its entries are kept from one syscall to another
     u32 ctx_id;
 
     struct dentry_resolver_input_t resolver;
@@ -43,6 +44,7 @@ struct syscall_cache_t {
             int flags;
             umode_t mode;
             struct dentry *dentry;
+            struct vfsmount *vfsmount;
             struct file_t file;
             u64 pid_tgid;
         } open;
@@ -119,6 +121,7 @@ struct syscall_cache_t {
             struct dentry *dentry;
             struct file_t file;
             const char *name;
+            u64 value_hash;
         } xattr;
 
         struct {
@@ -173,6 +176,7 @@ struct syscall_cache_t {
             u64 vm_end;
             u64 vm_protection;
             u64 req_protection;
+            u8 anonymous;
         } mprotect;
 
         struct {
@@ -214,6 +218,11 @@ struct syscall_cache_t {
             struct path *path;
             struct file_t file;
         } chdir;
+
+        struct {
+            struct credentials_t credentials; // credentials of the process before the syscall
+            u8 known;
+        } creds;
     };
 };
 
@@ -6,122 +6,101 @@
 #include "baloum.h"
 
 #define AD_RL_TEST_RATE 500
+#define AD_RL_TEST_MKDIR_RATE 10
 #define NUMBER_OF_PERIOD_PER_TEST 10
 
-SEC("test/ad_ratelimiter_basic")
-int test_ad_ratelimiter_basic()
+SEC("test/ad_ratelimiter_token_bucket")
+int test_ad_ratelimiter_token_bucket()
 {
     u64 now = bpf_ktime_get_ns();
 
-    struct activity_dump_config config;
+    struct activity_dump_config config = {};
     config.events_rate = AD_RL_TEST_RATE;
-
-    struct activity_dump_rate_limiter_ctx ctx;
-    ctx.counter = 0;
-    ctx.current_period = now;
-    ctx.algo_id = RL_ALGO_BASIC; // force algo basic
     u64 cookie = 0;
-    bpf_map_update_elem(&activity_dump_rate_limiters, &cookie, &ctx, BPF_ANY);
 
     for (int period_cpt = 0; period_cpt < NUMBER_OF_PERIOD_PER_TEST; period_cpt++, now += SEC_TO_NS(2)) {
-        assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now, 0),
+        assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_OPEN, 0),
                         "event not allowed which should be");
         for (int i = 0; i < AD_RL_TEST_RATE; i++) {
-            assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now + i, 1),
+            assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now + i, EVENT_OPEN, 1),
                             "event not allowed which should be");
         }
 
-        assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, 0),
+        assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_OPEN, 0),
                     "event allowed which should not be");
         for (int i = 0; i < AD_RL_TEST_RATE; i++) {
-            assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now + i, 1),
+            assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now + i, EVENT_OPEN, 1),
                         "event allowed which should not be");
         }
-        assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, 0),
+        assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_OPEN, 0),
                     "event allowed which should not be");
     }
     return 0;
 }
 
-SEC("test/ad_ratelimiter_basic_half")
-int test_ad_ratelimiter_basic_half()
+SEC("test/ad_ratelimiter_refill")
+int test_ad_ratelimiter_refill()
 {
     u64 now = bpf_ktime_get_ns();
 
-    struct activity_dump_config config;
+    struct activity_dump_config config = {};
     config.events_rate = AD_RL_TEST_RATE;
-
-    struct activity_dump_rate_limiter_ctx ctx;
-    ctx.counter = 0;
-    ctx.current_period = now;
-    ctx.algo_id = RL_ALGO_BASIC_HALF; // force algo basic half
     u64 cookie = 0;
-    bpf_map_update_elem(&activity_dump_rate_limiters, &cookie, &ctx, BPF_ANY);
 
-    for (int period_cpt = 0; period_cpt < NUMBER_OF_PERIOD_PER_TEST; period_cpt++, now += SEC_TO_NS(1)) {
-        assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now, 0),
+    for (int i = 0; i < AD_RL_TEST_RATE; i++) {
+        assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_OPEN, 1),
                         "event not allowed which should be");
-        for (int i = 0; i < AD_RL_TEST_RATE / 2; i++) {
-            assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now + i, 1),
-                            "event not allowed which should be");
-        }
+    }
+    assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_OPEN, 1),
+                "event allowed which should not be");
 
-        assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, 0),
-                    "event allowed which should not be");
-        for (int i = 0; i < AD_RL_TEST_RATE / 2; i++) {
-            assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now + i, 1),
-                        "event allowed which should not be");
-        }
-        assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, 0),
-                    "event allowed which should not be");
+    // half a second later, half of the bucket should have been refilled
+    now += SEC_TO_NS(1) / 2;
+    for (int i = 0; i < AD_RL_TEST_RATE / 2; i++) {
+        assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_OPEN, 1),
+                        "event not allowed which should be");
     }
+    assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_OPEN, 1),
+                "event allowed which should not be");
+
     return 0;
 }
 
-__attribute__((always_inline)) int test_ad_ratelimiter_variable_droprate(int algo)
+SEC("test/ad_ratelimiter_event_type_budgets")
+int test_ad_ratelimiter_event_type_budgets()
 {
     u64 now = bpf_ktime_get_ns();
 
-    struct activity_dump_config config;
+    struct activity_dump_config config = {};
     config.events_rate = AD_RL_TEST_RATE;
-
-    struct activity_dump_rate_limiter_ctx ctx;
-    ctx.counter = 0;
-    ctx.current_period = now;
-    ctx.algo_id = algo; // force algo
+    config.event_type_rates[EVENT_MKDIR - EVENT_FIRST_DISCARDER] = AD_RL_TEST_MKDIR_RATE;
     u64 cookie = 0;
-    bpf_map_update_elem(&activity_dump_rate_limiters, &cookie, &ctx, BPF_ANY);
 
-    for (int period_cpt = 0; period_cpt < NUMBER_OF_PERIOD_PER_TEST; period_cpt++, now += SEC_TO_NS(2)) {
-    assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now, 0),
-                    "event not allowed which should be");
-    for (int i = 0; i < AD_RL_TEST_RATE / 4; i++) {
-        assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now + i, 1),
+    // exhaust the open budget
+    for (int i = 0; i < AD_RL_TEST_RATE; i++) {
+        assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_OPEN, 1),
                         "event not allowed which should be");
     }
+    assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_OPEN, 1),
+                "event allowed which should not be");
 
-    int total_allowed = 0;
-    for (int i = 0; i < AD_RL_TEST_RATE * 10; i++) {
-        if (activity_dump_rate_limiter_allow(&config, cookie, now + i, 1)) {
-            total_allowed++;
-        }
-    }
-    assert_greater_than(total_allowed, AD_RL_TEST_RATE * 3 / 4, "nope");
-    assert_lesser_than(total_allowed, AD_RL_TEST_RATE / 10, "nope");
+    // mkdir events have their own budget
+    for (int i = 0; i < AD_RL_TEST_MKDIR_RATE; i++) {
+        assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_MKDIR, 1),
+                        "event not allowed which should be");
     }
-    return 0;
-}
+    assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_MKDIR, 1),
+                "event allowed which should not be");
 
-SEC("test/ad_ratelimiter_decreasing_droprate")
-int test_ad_ratelimiter_decreasing_droprate()
-{
-    return test_ad_ratelimiter_variable_droprate(RL_ALGO_DECREASING_DROPRATE);
-}
+    // unlink events fall back to the default rate
+    for (int i = 0; i < AD_RL_TEST_RATE; i++) {
+        assert_not_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_UNLINK, 1),
+                        "event not allowed which should be");
+    }
+    assert_zero(activity_dump_rate_limiter_allow(&config, cookie, now, EVENT_UNLINK, 1),
+                "event allowed which should not be");
 
-SEC("test/ad_ratelimiter_increasing_droprate")
-int test_ad_ratelimiter_increasing_droprate()
-{
-    return test_ad_ratelimiter_variable_droprate(RL_ALGO_INCREASING_DROPRATE);
+    return 0;
 }
 
 #endif /* _ACTIVITY_DUMP_RATELIMITER_TEST_H_ */
@@ -0,0 +1,58 @@
+#ifndef _BENCHMARKS_TEST_H
+#define _BENCHMARKS_TEST_H
+
+#include "helpers/container.h"
+#include "helpers/discarders.h"
+#include "baloum.h"
+
+#define BENCH_MOUNT_ID 123
+#define BENCH_INODE 456
+
+SEC("test/bench_discarder_hit")
+int test_bench_discarder_hit()
+{
+    struct is_discarded_by_inode_t params = {
+        .discarder_type = EVENT_OPEN,
+        .discarder = {
+            .path_key.ino = BENCH_INODE,
+            .path_key.mount_id = BENCH_MOUNT_ID,
+        }
+    };
+
+    if (!is_discarded_by_inode(&params)) {
+        int ret = discard_inode(EVENT_OPEN, BENCH_MOUNT_ID, BENCH_INODE, 0, 0);
+        assert_zero(ret, "failed to discard the inode");
+    }
+
+    return 0;
+}
+
+SEC("test/bench_discarder_miss")
+int test_bench_discarder_miss()
+{
+    struct is_discarded_by_inode_t params = {
+        .discarder_type = EVENT_OPEN,
+        .discarder = {
+            .path_key.ino = BENCH_INODE + 1,
+            .path_key.mount_id = BENCH_MOUNT_ID,
+        }
+    };
+
+    int ret = is_discarded_by_inode(&params);
+    assert_zero(ret, "inode shouldn't be discarded");
+
+    return 0;
+}
+
+SEC("test/bench_container_key")
+int test_bench_container_key()
+{
+    char id[CONTAINER_ID_LEN] = "0123456789abcdef0123456789abcdef0123456789abcdef0123456789abcdef";
+
+    u64 key = hash_container_id(id);
+    assert_not_zero(key, "empty container key");
+
+    return 0;
+}
+
+#endif
@@ -120,7 +120,7 @@ int test_discarders_revision()
     assert_not_zero(ret, "inode should be discarded");
 
     // expire the discarders
-    bump_discarders_revision();
+    bump_discarders_revision(EVENT_ANY);
 
     // now all the discarders whatever their mount id should be discarded
     ret = _is_discarded_by_inode(EVENT_OPEN, mount_id1, inode1);
@@ -148,6 +148,46 @@ int test_discarders_revision()
     return 0;
 }
 
+SEC("test/discarders_event_type_revision")
+int test_discarders_event_type_revision()
+{
+    u32 mount_id = 123;
+    u64 inode = 456;
+
+    int ret = discard_inode(EVENT_OPEN, mount_id, inode, 0, 0);
+    assert_zero(ret, "failed to discard the inode");
+
+    ret = discard_inode(EVENT_CHMOD, mount_id, inode, 0, 0);
+    assert_zero(ret, "failed to discard the inode");
+
+    // expire the open discarders only
+    bump_discarders_revision(EVENT_OPEN);
+
+    ret = _is_discarded_by_inode(EVENT_OPEN, mount_id, inode);
+    assert_zero(ret, "inode shouldn't be discarded");
+
+    ret = _is_discarded_by_inode(EVENT_CHMOD, mount_id, inode);
+    assert_not_zero(ret, "inode should be discarded");
+
+    // the first open discarder adds a retention period
+    ret = discard_inode(EVENT_OPEN, mount_id, inode, 0, 0);
+    assert_zero(ret, "able to discard the inode");
+
+    baloum_sleep(get_discarder_retention() + 1);
+
+    // the chmod event type is kept along the new open one
+    ret = discard_inode(EVENT_OPEN, mount_id, inode, 0, 0);
+    assert_zero(ret, "failed to discard the inode");
+
+    ret = _is_discarded_by_inode(EVENT_OPEN, mount_id, inode);
+    assert_not_zero(ret, "inode should be discarded");
+
+    ret = _is_discarded_by_inode(EVENT_CHMOD, mount_id, inode);
+    assert_not_zero(ret, "inode should be discarded");
+
+    return 0;
+}
+
 SEC("test/discarders_mount_revision")
 int test_discarders_mount_revision()
 {
@@ -190,4 +230,43 @@ int test_discarders_mount_revision()
     return 0;
 }
 
+SEC("test/discarders_subtree")
+int test_discarders_subtree()
+{
+    u32 mount_id = 123;
+    u64 inode = 456;
+
+    // a parent discarder goes to the subtree discarders only
+    int ret = discard_inode(EVENT_OPEN, mount_id, inode, 0, 0);
+    assert_zero(ret, "failed to discard the inode");
+
+    struct inode_discarder_params_t *inode_params = get_inode_discarder_params(mount_id, inode, 0);
+    assert_not_null(inode_params, "unable to find the subtree discarder entry");
+
+    inode_params = get_inode_discarder_params(mount_id, inode, 1);
+    assert_null(inode_params, "the subtree discarder shouldn't be a leaf discarder");
+
+    ret = discard_inode(EVENT_OPEN, mount_id, inode, 0, 1);
+    assert_zero(ret, "failed to discard the inode");
+
+    inode_params = get_inode_discarder_params(mount_id, inode, 1);
+    assert_not_null(inode_params, "unable to find the leaf discarder entry");
+
+    // expiring the inode retains both discarders
+    expire_inode_discarders(mount_id, inode);
+
+    inode_params = get_inode_discarder_params(mount_id, inode, 0);
+    assert_not_null(inode_params, "unable to find the subtree discarder entry");
+    assert_not_zero(inode_params->params.is_retained, "the subtree discarder should be retained");
+
+    inode_params = get_inode_discarder_params(mount_id, inode, 1);
+    assert_not_null(inode_params, "unable to find the leaf discarder entry");
+    assert_not_zero(inode_params->params.is_retained, "the leaf discarder should be retained");
+
+    ret = _is_discarded_by_inode(EVENT_OPEN, mount_id, inode);
+    assert_zero(ret, "inode shouldn't be discarded");
+
+    return 0;
+}
+
 #endif
@@ -3,5 +3,6 @@
 
 #include "discarders_test.h"
 #include "activity_dump_ratelimiter_test.h"
+#include "benchmarks_test.h"
 
 #endif
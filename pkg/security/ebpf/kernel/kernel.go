@@ -317,6 +317,11 @@ func (k *Version) HaveLegacyPipeInodeInfoStruct() bool {
 	return k.Code != 0 && k.Code < Kernel5_5
 }
 
+// HaveDPathHelper returns whether the kernel provides the bpf_d_path helper, which was introduced in 5.10
+func (k *Version) HaveDPathHelper() bool {
+	return k.Code != 0 && k.Code >= Kernel5_10
+}
+
 // HaveFentrySupport returns whether the kernel supports fentry probes
 func (k *Version) HaveFentrySupport() bool {
 	if features.HaveProgramType(ebpf.Tracing) != nil {
@@ -351,6 +356,21 @@ func (k *Version) HaveFentrySupport() bool {
 	return true
 }
 
+// HaveTaskStorageSupport returns whether the kernel provides the task storage maps to the tracepoints and kprobes,
+// which was introduced in 6.2
+func (k *Version) HaveTaskStorageSupport() bool {
+	if features.HaveMapType(ebpf.TaskStorage) != nil {
+		return false
+	}
+
+	for _, progType := range []ebpf.ProgramType{ebpf.Kprobe, ebpf.TracePoint, ebpf.RawTracepoint} {
+		if features.HaveProgramHelper(progType, asm.FnTaskStorageGet) != nil {
+			return false
+		}
+	}
+	return true
+}
+
 // SupportBPFSendSignal returns true if the eBPF function bpf_send_signal is available
 func (k *Version) SupportBPFSendSignal() bool {
 	return k.Code != 0 && k.Code >= Kernel5_3
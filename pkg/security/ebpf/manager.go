@@ -49,13 +49,13 @@ func NewDefaultOptions() manager.Options {
 }
 
 // NewRuntimeSecurityManager returns a new instance of the runtime security module manager
-func NewRuntimeSecurityManager(supportsRingBuffers, useFentry bool) *manager.Manager {
+func NewRuntimeSecurityManager(supportsRingBuffers, usePriorityRingBuffer, useFentry bool) *manager.Manager {
 	manager := &manager.Manager{
 		Probes: probes.AllProbes(useFentry),
 		Maps:   probes.AllMaps(),
 	}
 	if supportsRingBuffers {
-		manager.RingBuffers = probes.AllRingBuffers()
+		manager.RingBuffers = probes.AllRingBuffers(usePriorityRingBuffer)
 	} else {
 		manager.PerfMaps = probes.AllPerfMaps()
 	}
@@ -81,6 +81,30 @@ func (i *StringMapItem) MarshalBinary() ([]byte, error) {
 	return rep, nil
 }
 
+// PrefixMapItem describes the key of a LPM trie map, made of the length of the prefix in bits and of the prefix
+type PrefixMapItem struct {
+	prefix string
+	size   int
+}
+
+// MarshalBinary returns the binary representation of a PrefixMapItem
+func (i *PrefixMapItem) MarshalBinary() ([]byte, error) {
+	n := i.size
+	if len(i.prefix) < i.size {
+		n = len(i.prefix)
+	}
+
+	rep := make([]byte, 4+i.size)
+	binary.NativeEndian.PutUint32(rep[0:4], uint32(n*8))
+	copy(rep[4:], i.prefix[0:n])
+	return rep, nil
+}
+
+// NewPrefixMapItem returns a new PrefixMapItem
+func NewPrefixMapItem(prefix string, size int) *PrefixMapItem {
+	return &PrefixMapItem{prefix: prefix, size: size}
+}
+
 // NewStringMapItem returns a new StringMapItem
 func NewStringMapItem(str string, size int) *StringMapItem {
 	return &StringMapItem{str: str, size: size}
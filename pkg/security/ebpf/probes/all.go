@@ -108,9 +108,11 @@ func AllMaps() []*manager.Map {
 		// Filters
 		{Name: "filter_policy"},
 		{Name: "inode_discarders"},
+		{Name: "subtree_discarders"},
 		{Name: "pid_discarders"},
 		{Name: "inode_disc_revisions"},
 		{Name: "basename_approvers"},
+		{Name: "prefix_approvers"},
 		// Dentry resolver table
 		{Name: "pathnames"},
 		// Snapshot table
@@ -126,9 +128,11 @@ func AllMaps() []*manager.Map {
 		{Name: "selinux_enforce_status"},
 		// Enabled event mask
 		{Name: "enabled_events"},
+		{Name: "syscall_ctx_events"},
 		// Syscall stats monitor (inflight syscall)
 		{Name: "syscalls_stats_enabled"},
 		{Name: "kill_list"},
+		{Name: "kill_rules"},
 	}
 }
 
@@ -147,8 +151,11 @@ type MapSpecEditorOpts struct {
 	UseMmapableMaps         bool
 	UseRingBuffers          bool
 	RingBufferSize          uint32
+	PriorityRingBufferSize  uint32
 	PathResolutionEnabled   bool
 	SecurityProfileMaxCount int
+	UseFentry               bool
+	UseTaskStorage          bool
 }
 
 // AllMapSpecEditors returns the list of map editors
@@ -172,7 +179,7 @@ func AllMapSpecEditors(numCPU int, opts MapSpecEditorOpts) map[string]manager.Ma
 			EditorFlag: manager.EditMaxEntries,
 		},
 		"activity_dump_rate_limiters": {
-			MaxEntries: model.MaxTracedCgroupsCount,
+			MaxEntries: model.MaxTracedCgroupsCount * uint32(model.LastApproverEventType),
 			EditorFlag: manager.EditMaxEntries,
 		},
 		"cgroup_wait_list": {
@@ -203,6 +210,25 @@ func AllMapSpecEditors(numCPU int, opts MapSpecEditorOpts) map[string]manager.Ma
 		}
 	}
 
+	if opts.UseTaskStorage {
+		// the syscalls are cached in the task storage instead
+		editors["syscalls"] = manager.MapSpecEditor{
+			MaxEntries: 1,
+			EditorFlag: manager.EditMaxEntries,
+		}
+	} else if opts.UseFentry {
+		editors["syscalls_task_storage"] = manager.MapSpecEditor{
+			Type:       ebpf.Hash,
+			MaxEntries: 1,
+			EditorFlag: manager.EditType | manager.EditMaxEntries,
+		}
+		editors["proc_cache_task_storage"] = manager.MapSpecEditor{
+			Type:       ebpf.Hash,
+			MaxEntries: 1,
+			EditorFlag: manager.EditType | manager.EditMaxEntries,
+		}
+	}
+
 	if opts.UseMmapableMaps {
 		editors["dr_erpc_buffer"] = manager.MapSpecEditor{
 			Flags:      unix.BPF_F_MMAPABLE,
@@ -218,6 +244,13 @@ func AllMapSpecEditors(numCPU int, opts MapSpecEditorOpts) map[string]manager.Ma
 			Type:       ebpf.RingBuf,
 			EditorFlag: manager.EditMaxEntries | manager.EditType | manager.EditKeyValue,
 		}
+		if opts.PriorityRingBufferSize > 0 {
+			editors["events_priority"] = manager.MapSpecEditor{
+				MaxEntries: opts.PriorityRingBufferSize,
+				Type:       ebpf.RingBuf,
+				EditorFlag: manager.EditMaxEntries | manager.EditType | manager.EditKeyValue,
+			}
+		}
 	}
 	return editors
 }
@@ -232,12 +265,18 @@ func AllPerfMaps() []*manager.PerfMap {
 }
 
 // AllRingBuffers returns the list of ring buffers of the runtime security module
-func AllRingBuffers() []*manager.RingBuffer {
-	return []*manager.RingBuffer{
+func AllRingBuffers(usePriorityRingBuffer bool) []*manager.RingBuffer {
+	ringBuffers := []*manager.RingBuffer{
 		{
 			Map: manager.Map{Name: "events"},
 		},
 	}
+	if usePriorityRingBuffer {
+		ringBuffers = append(ringBuffers, &manager.RingBuffer{
+			Map: manager.Map{Name: "events_priority"},
+		})
+	}
+	return ringBuffers
 }
 
 // AllTailRoutes returns the list of all the tail call routes
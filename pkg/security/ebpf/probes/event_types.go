@@ -173,6 +173,7 @@ func GetSelectorsPerEventType(fentry bool) map[eval.EventType][]manager.ProbesSe
 					kprobeOrFentry("io_sq_offload_start"),
 					kretprobeOrFexit("io_ring_ctx_alloc"),
 				}},
+				kprobeOrFentry("io_submit_sqes"),
 			}},
 
 			// Mount probes
@@ -473,6 +474,13 @@ func GetSelectorsPerEventType(fentry bool) map[eval.EventType][]manager.ProbesSe
 		}
 	}
 
+	// bpf_d_path is only allowed on fentry, the hook is excluded unless the d_path dentry resolution is enabled
+	if fentry {
+		selectorsPerEventTypeStore["open"] = append(selectorsPerEventTypeStore["open"], &manager.BestEffort{Selectors: []manager.ProbesSelector{
+			kprobeOrFentry("security_file_open"),
+		}})
+	}
+
 	if ShouldUseModuleLoadTracepoint() {
 		selectorsPerEventTypeStore["load_module"] = append(selectorsPerEventTypeStore["load_module"], &manager.BestEffort{Selectors: []manager.ProbesSelector{
 			&manager.ProbeSelector{ProbeIdentificationPair: manager.ProbeIdentificationPair{UID: SecurityAgentUID, EBPFFuncName: "module_load"}},
@@ -36,5 +36,11 @@ func getIouringProbes() []*manager.Probe {
 				EBPFFuncName: "hook_io_sq_offload_start",
 			},
 		},
+		{
+			ProbeIdentificationPair: manager.ProbeIdentificationPair{
+				UID:          SecurityAgentUID,
+				EBPFFuncName: "hook_io_submit_sqes",
+			},
+		},
 	}
 }
@@ -92,5 +92,17 @@ func getOpenProbes(fentry bool) []*manager.Probe {
 		},
 		SyscallFuncName: "openat2",
 	}, fentry, EntryAndExit)...)
+
+	if fentry {
+		openProbes = append(openProbes, &manager.Probe{
+			ProbeIdentificationPair: manager.ProbeIdentificationPair{
+				UID:          SecurityAgentUID,
+				EBPFFuncName: DPathProgramFunction,
+			},
+		})
+	}
 	return openProbes
 }
+
+// DPathProgramFunction is the program resolving the paths of the open events with bpf_d_path
+const DPathProgramFunction = "hook_security_file_open"
@@ -14,33 +14,25 @@ import (
 	"github.com/safchain/baloum/pkg/baloum"
 )
 
-func TestActivityDumpRateLimiterBasic(t *testing.T) {
+func TestActivityDumpRateLimiterTokenBucket(t *testing.T) {
 	var ctx baloum.StdContext
-	code, err := newVM(t).RunProgram(&ctx, "test/ad_ratelimiter_basic")
+	code, err := newVM(t).RunProgram(&ctx, "test/ad_ratelimiter_token_bucket")
 	if err != nil || code != 0 {
 		t.Errorf("unexpected error: %v, %d", err, code)
 	}
 }
 
-func TestActivityDumpRateLimiterBasicHalf(t *testing.T) {
+func TestActivityDumpRateLimiterRefill(t *testing.T) {
 	var ctx baloum.StdContext
-	code, err := newVM(t).RunProgram(&ctx, "test/ad_ratelimiter_basic_half")
+	code, err := newVM(t).RunProgram(&ctx, "test/ad_ratelimiter_refill")
 	if err != nil || code != 0 {
 		t.Errorf("unexpected error: %v, %d", err, code)
 	}
 }
 
-func TestActivityDumpRateLimiterDecreasingDroprate(t *testing.T) {
+func TestActivityDumpRateLimiterEventTypeBudgets(t *testing.T) {
 	var ctx baloum.StdContext
-	code, err := newVM(t).RunProgram(&ctx, "test/ad_ratelimiter_decreasing_droprate")
-	if err != nil || code != 0 {
-		t.Errorf("unexpected error: %v, %d", err, code)
-	}
-}
-
-func TestActivityDumpRateLimiterIncreasingDroprate(t *testing.T) {
-	var ctx baloum.StdContext
-	code, err := newVM(t).RunProgram(&ctx, "test/ad_ratelimiter_increasing_droprate")
+	code, err := newVM(t).RunProgram(&ctx, "test/ad_ratelimiter_event_type_budgets")
 	if err != nil || code != 0 {
 		t.Errorf("unexpected error: %v, %d", err, code)
 	}
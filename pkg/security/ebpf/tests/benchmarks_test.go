@@ -0,0 +1,40 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux && ebpf_bindata
+
+// Package tests holds tests related files
+package tests
+
+import (
+	"testing"
+
+	"github.com/safchain/baloum/pkg/baloum"
+)
+
+func benchmarkProgram(b *testing.B, section string) {
+	vm := newVM(b)
+
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		var ctx baloum.StdContext
+		code, err := vm.RunProgram(&ctx, section)
+		if err != nil || code != 0 {
+			b.Fatalf("unexpected error: %v, %d", err, code)
+		}
+	}
+}
+
+func BenchmarkDiscarderHit(b *testing.B) {
+	benchmarkProgram(b, "test/bench_discarder_hit")
+}
+
+func BenchmarkDiscarderMiss(b *testing.B) {
+	benchmarkProgram(b, "test/bench_discarder_miss")
+}
+
+func BenchmarkContainerKey(b *testing.B) {
+	benchmarkProgram(b, "test/bench_container_key")
+}
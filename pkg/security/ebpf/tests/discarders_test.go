@@ -38,6 +38,14 @@ func TestDiscarderRevision(t *testing.T) {
 	}
 }
 
+func TestDiscarderEventTypeRevision(t *testing.T) {
+	var ctx baloum.StdContext
+	code, err := newVM(t).RunProgram(&ctx, "test/discarders_event_type_revision")
+	if err != nil || code != 0 {
+		t.Errorf("unexpected error: %v, %d", err, code)
+	}
+}
+
 func TestDiscarderMountRevision(t *testing.T) {
 	var ctx baloum.StdContext
 	code, err := newVM(t).RunProgram(&ctx, "test/discarders_mount_revision")
@@ -45,3 +53,11 @@ func TestDiscarderMountRevision(t *testing.T) {
 		t.Errorf("unexpected error: %v, %d", err, code)
 	}
 }
+
+func TestDiscarderSubtree(t *testing.T) {
+	var ctx baloum.StdContext
+	code, err := newVM(t).RunProgram(&ctx, "test/discarders_subtree")
+	if err != nil || code != 0 {
+		t.Errorf("unexpected error: %v, %d", err, code)
+	}
+}
@@ -22,7 +22,7 @@ import (
 )
 
 type testLogger struct {
-	t     *testing.T
+	t     testing.TB
 	trace bool
 }
 
@@ -56,7 +56,7 @@ func (l *testLogger) Errorf(format string, params ...interface{}) {
 
 var trace bool
 
-func newVM(t *testing.T) *baloum.VM {
+func newVM(t testing.TB) *baloum.VM {
 	useSyscallWrapper, err := secebpf.IsSyscallWrapperRequired()
 	if err != nil {
 		t.Fatal(err)
@@ -121,6 +121,11 @@ var (
 	// Tags: -
 	MetricPerfBufferSortingAvgOp = newRuntimeMetric(".perf_buffer.sorting_avg_op")
 
+	// MetricPerfBufferQueueingLatency is the name of the metric used to count the events read from the event stream by
+	// the time they spent in it, from their kernel timestamp to their dispatch
+	// Tags: map, le
+	MetricPerfBufferQueueingLatency = newRuntimeMetric(".perf_buffer.queueing_latency")
+
 	// MetricPerfBufferInvalidEventsCount is the name of the metric used to count the number of invalid events retrieved from the event stream
 	// Tags: map, cause
 	MetricPerfBufferInvalidEventsCount = newRuntimeMetric(".perf_buffer.invalid_events.count")
@@ -57,6 +57,22 @@ type Config struct {
 	// This is used during reload to avoid removing all the discarders at the same time.
 	FlushDiscarderWindow int
 
+	// DiscarderProbationThreshold defines the number of identical events, same event type, file, flags, mode and
+	// process image, sent within the probation window before the kernel suppresses the next ones. 0 disables the
+	// probation.
+	DiscarderProbationThreshold int
+
+	// DiscarderProbationWindow defines the discarder probation window, in milliseconds
+	DiscarderProbationWindow int
+
+	// JITMProtectThreshold defines the number of anonymous write to exec mprotect transitions, within a summary period,
+	// after which a process is considered as a JIT runtime and its transitions are only reported once per period.
+	// 0 disables the suppression.
+	JITMProtectThreshold int
+
+	// JITMProtectSummaryPeriod defines the summary period of the JIT mprotect suppression, in milliseconds
+	JITMProtectSummaryPeriod int
+
 	// SocketPath is the path to the socket that is used to communicate with the security agent and process agent
 	SocketPath string
 
@@ -78,6 +94,9 @@ type Config struct {
 	// MapDentryResolutionEnabled determines if the map resolution is enabled
 	MapDentryResolutionEnabled bool
 
+	// DPathDentryResolutionEnabled determines if the paths of the open events are resolved by bpf_d_path, in fentry mode
+	DPathDentryResolutionEnabled bool
+
 	// DentryCacheSize is the size of the user space dentry cache
 	DentryCacheSize int
 
@@ -88,6 +107,9 @@ type Config struct {
 	// EnvsWithValue lists environnement variables that will be fully exported
 	EnvsWithValue []string
 
+	// EnvsPrefixFilter lists the prefixes of the environment variables collected by the kernel, all of them when empty
+	EnvsPrefixFilter []string
+
 	// RuntimeMonitor defines if the Go runtime and system monitor should be enabled
 	RuntimeMonitor bool
 
@@ -97,9 +119,18 @@ type Config struct {
 	// EventStreamBufferSize specifies the buffer size of the eBPF map used for events
 	EventStreamBufferSize int
 
+	// EventStreamPriorityBufferSize specifies the buffer size of the dedicated ring buffer used for the process
+	// lifecycle and privileged operations events. 0 sends all the events to the same buffer. When used, the events of
+	// both ring buffers are reordered by kernel timestamp, which delays their handling by about 250ms.
+	EventStreamPriorityBufferSize int
+
 	// EventStreamUseFentry specifies whether to use eBPF fentry when available instead of kprobes
 	EventStreamUseFentry bool
 
+	// EventStreamBatchArgsEnvs specifies whether to send the args and envs of an exec in as few ring buffer records as
+	// possible, instead of 256 bytes chunks
+	EventStreamBatchArgsEnvs bool
+
 	// RuntimeCompilationEnabled defines if the runtime-compilation is enabled
 	RuntimeCompilationEnabled bool
 
@@ -131,9 +162,33 @@ type Config struct {
 	// NetworkIngressEnabled defines if the network ingress probes should be activated
 	NetworkIngressEnabled bool
 
+	// NetworkDNSDedupWindow defines the window, in milliseconds, during which the identical DNS questions of a process
+	// are only reported once. 0 disables the deduplication.
+	NetworkDNSDedupWindow int
+
+	// SetXattrDedupWindow defines the window, in milliseconds, during which setting the same value to the same xattr of
+	// a file is only reported once. 0 disables the deduplication.
+	SetXattrDedupWindow int
+
+	// CredentialsDedup suppresses the setuid, setgid and capset events that leave the reported credentials of the
+	// process unchanged
+	CredentialsDedup bool
+
+	// SyscallCtxRulesOnly restricts the collection of the syscall arguments to the event types whose rules reference
+	// them. The arguments of the other event types are then missing from the serialized events.
+	SyscallCtxRulesOnly bool
+
+	// SpanEventTypes lists the event types the span context of the traced applications is captured for, all of them
+	// when empty
+	SpanEventTypes []string
+
 	// StatsPollingInterval determines how often metrics should be polled
 	StatsPollingInterval time.Duration
 
+	// StatsSamplingRate defines that only one sent event out of StatsSamplingRate, rounded up to a power of 2, is
+	// counted in the kernel events statistics. The lost events are always counted.
+	StatsSamplingRate int
+
 	// SyscallsMonitorEnabled defines if syscalls monitoring metrics should be collected
 	SyscallsMonitorEnabled bool
 }
@@ -145,31 +200,45 @@ func NewConfig() (*Config, error) {
 	setEnv()
 
 	c := &Config{
-		Config:                       *ebpf.NewConfig(),
-		EnableAllProbes:              getBool("enable_all_probes"),
-		EnableKernelFilters:          getBool("enable_kernel_filters"),
-		EnableApprovers:              getBool("enable_approvers"),
-		EnableDiscarders:             getBool("enable_discarders"),
-		FlushDiscarderWindow:         getInt("flush_discarder_window"),
-		PIDCacheSize:                 getInt("pid_cache_size"),
-		StatsTagsCardinality:         getString("events_stats.tags_cardinality"),
-		CustomSensitiveWords:         getStringSlice("custom_sensitive_words"),
-		ERPCDentryResolutionEnabled:  getBool("erpc_dentry_resolution_enabled"),
-		MapDentryResolutionEnabled:   getBool("map_dentry_resolution_enabled"),
-		DentryCacheSize:              getInt("dentry_cache_size"),
-		RemoteTaggerEnabled:          getBool("remote_tagger"),
-		RuntimeMonitor:               getBool("runtime_monitor.enabled"),
-		NetworkLazyInterfacePrefixes: getStringSlice("network.lazy_interface_prefixes"),
-		NetworkClassifierPriority:    uint16(getInt("network.classifier_priority")),
-		NetworkClassifierHandle:      uint16(getInt("network.classifier_handle")),
-		EventStreamUseRingBuffer:     getBool("event_stream.use_ring_buffer"),
-		EventStreamBufferSize:        getInt("event_stream.buffer_size"),
-		EventStreamUseFentry:         getEventStreamFentryValue(),
-		EnvsWithValue:                getStringSlice("envs_with_value"),
-		NetworkEnabled:               getBool("network.enabled"),
-		NetworkIngressEnabled:        getBool("network.ingress.enabled"),
-		StatsPollingInterval:         time.Duration(getInt("events_stats.polling_interval")) * time.Second,
-		SyscallsMonitorEnabled:       getBool("syscalls_monitor.enabled"),
+		Config:                        *ebpf.NewConfig(),
+		EnableAllProbes:               getBool("enable_all_probes"),
+		EnableKernelFilters:           getBool("enable_kernel_filters"),
+		EnableApprovers:               getBool("enable_approvers"),
+		EnableDiscarders:              getBool("enable_discarders"),
+		FlushDiscarderWindow:          getInt("flush_discarder_window"),
+		DiscarderProbationThreshold:   getInt("discarder_probation.threshold"),
+		DiscarderProbationWindow:      getInt("discarder_probation.window"),
+		JITMProtectThreshold:          getInt("jit_mprotect.threshold"),
+		JITMProtectSummaryPeriod:      getInt("jit_mprotect.summary_period"),
+		PIDCacheSize:                  getInt("pid_cache_size"),
+		StatsTagsCardinality:          getString("events_stats.tags_cardinality"),
+		CustomSensitiveWords:          getStringSlice("custom_sensitive_words"),
+		ERPCDentryResolutionEnabled:   getBool("erpc_dentry_resolution_enabled"),
+		MapDentryResolutionEnabled:    getBool("map_dentry_resolution_enabled"),
+		DPathDentryResolutionEnabled:  getBool("d_path_dentry_resolution_enabled"),
+		DentryCacheSize:               getInt("dentry_cache_size"),
+		RemoteTaggerEnabled:           getBool("remote_tagger"),
+		RuntimeMonitor:                getBool("runtime_monitor.enabled"),
+		NetworkLazyInterfacePrefixes:  getStringSlice("network.lazy_interface_prefixes"),
+		NetworkClassifierPriority:     uint16(getInt("network.classifier_priority")),
+		NetworkClassifierHandle:       uint16(getInt("network.classifier_handle")),
+		EventStreamUseRingBuffer:      getBool("event_stream.use_ring_buffer"),
+		EventStreamBufferSize:         getInt("event_stream.buffer_size"),
+		EventStreamPriorityBufferSize: getInt("event_stream.priority_buffer_size"),
+		EventStreamUseFentry:          getEventStreamFentryValue(),
+		EventStreamBatchArgsEnvs:      getBool("event_stream.batch_args_envs"),
+		EnvsWithValue:                 getStringSlice("envs_with_value"),
+		EnvsPrefixFilter:              getStringSlice("envs_prefix_filter"),
+		NetworkEnabled:                getBool("network.enabled"),
+		NetworkIngressEnabled:         getBool("network.ingress.enabled"),
+		NetworkDNSDedupWindow:         getInt("network.dns_dedup_window"),
+		SetXattrDedupWindow:           getInt("setxattr_dedup_window"),
+		CredentialsDedup:              getBool("credentials_dedup"),
+		SyscallCtxRulesOnly:           getBool("syscall_ctx_rules_only"),
+		SpanEventTypes:                getStringSlice("span_event_types"),
+		StatsPollingInterval:          time.Duration(getInt("events_stats.polling_interval")) * time.Second,
+		StatsSamplingRate:             getInt("events_stats.sampling_rate"),
+		SyscallsMonitorEnabled:        getBool("syscalls_monitor.enabled"),
 
 		// event server
 		SocketPath:       coreconfig.SystemProbe.GetString(join(evNS, "socket")),
@@ -207,6 +276,10 @@ func (c *Config) sanitize() error {
 		return fmt.Errorf("runtime_security_config.event_stream.buffer_size must be a power of 2 and a multiple of %d", os.Getpagesize())
 	}
 
+	if c.EventStreamPriorityBufferSize%os.Getpagesize() != 0 || c.EventStreamPriorityBufferSize&(c.EventStreamPriorityBufferSize-1) != 0 {
+		return fmt.Errorf("runtime_security_config.event_stream.priority_buffer_size must be a power of 2 and a multiple of %d", os.Getpagesize())
+	}
+
 	if !isSet("enable_approvers") && c.EnableKernelFilters {
 		c.EnableApprovers = true
 	}
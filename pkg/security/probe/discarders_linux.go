@@ -9,8 +9,10 @@ import (
 	"encoding/binary"
 	"errors"
 	"fmt"
+	"hash/fnv"
 	"math"
 	"path"
+	"slices"
 	"strings"
 	"time"
 
@@ -32,9 +34,10 @@ const (
 	// pipeline for already deleted file in kernel space.
 	DiscardRetention = 5 * time.Second
 
-	// maxParentDiscarderDepth defines the maximum parent depth to find parent discarders
-	// the eBPF part need to be adapted accordingly
-	maxParentDiscarderDepth = 3
+	// maxParentDiscarderDepth defines the maximum parent depth to find parent discarders. As the parent discarders are
+	// subtree discarders, checked at each level of the path resolution by the eBPF part, the topmost one found
+	// discards the whole tree below it.
+	maxParentDiscarderDepth = 8
 
 	// allEventTypes is a mask to match all the events
 	allEventTypes = math.MaxUint32 //nolint:deadcode,unused
@@ -83,12 +86,116 @@ var InvalidDiscarders = map[eval.Field][]string{
 	"chdir.file.path":              dentryInvalidDiscarder,
 }
 
-// bumpDiscardersRevision sends an eRPC request to bump the discarders revisionr
-func bumpDiscardersRevision(e *erpc.ERPC) error {
+// getDiscarderProbationThreshold returns the discarder probation threshold, 0 when the probation is disabled
+func getDiscarderProbationThreshold(cfg *pconfig.Config) uint64 {
+	if !cfg.EnableDiscarders || cfg.DiscarderProbationThreshold <= 0 {
+		return 0
+	}
+	return uint64(cfg.DiscarderProbationThreshold)
+}
+
+// bumpDiscardersRevision sends an eRPC request to bump the discarders revision of an event type, of all the event
+// types for model.UnknownEventType
+func bumpDiscardersRevision(e *erpc.ERPC, eventType model.EventType) error {
 	req := erpc.NewERPCRequest(erpc.BumpDiscardersRevision)
+	binary.NativeEndian.PutUint64(req.Data[0:8], uint64(eventType))
 	return e.Request(req)
 }
 
+// probationFiles returns the file checked by the discarder probation of each event type, see is_discarded_by_probation
+var probationFiles = map[model.EventType]func(ev *model.Event) *model.FileEvent{
+	model.FileOpenEventType:        func(ev *model.Event) *model.FileEvent { return &ev.Open.File },
+	model.FileMkdirEventType:       func(ev *model.Event) *model.FileEvent { return &ev.Mkdir.File },
+	model.FileLinkEventType:        func(ev *model.Event) *model.FileEvent { return &ev.Link.Source },
+	model.FileUnlinkEventType:      func(ev *model.Event) *model.FileEvent { return &ev.Unlink.File },
+	model.FileRmdirEventType:       func(ev *model.Event) *model.FileEvent { return &ev.Rmdir.File },
+	model.FileChmodEventType:       func(ev *model.Event) *model.FileEvent { return &ev.Chmod.File },
+	model.FileChownEventType:       func(ev *model.Event) *model.FileEvent { return &ev.Chown.File },
+	model.FileUtimesEventType:      func(ev *model.Event) *model.FileEvent { return &ev.Utimes.File },
+	model.FileSetXAttrEventType:    func(ev *model.Event) *model.FileEvent { return &ev.SetXAttr.File },
+	model.FileRemoveXAttrEventType: func(ev *model.Event) *model.FileEvent { return &ev.RemoveXAttr.File },
+	model.FileChdirEventType:       func(ev *model.Event) *model.FileEvent { return &ev.Chdir.File },
+}
+
+// getProbationFlagsAndMode returns the flags and mode keying the discarder probation of an event, they have to match
+// the ones set by the kernel hooks in the dentry resolver input
+func getProbationFlagsAndMode(ev *model.Event) (uint32, uint32) {
+	switch ev.GetEventType() {
+	case model.FileOpenEventType:
+		return ev.Open.Flags, ev.Open.Mode
+	case model.FileMkdirEventType:
+		return 0, ev.Mkdir.Mode
+	case model.FileChmodEventType:
+		return 0, ev.Chmod.Mode
+	default:
+		return 0, 0
+	}
+}
+
+// newRejectDiscarderProbationRequest returns the eRPC request stopping the in-kernel suppression of the events
+// identical to the given one, nil if the event type has no probation
+func newRejectDiscarderProbationRequest(ev *model.Event) *erpc.Request {
+	eventType := ev.GetEventType()
+
+	getFile, exists := probationFiles[eventType]
+	if !exists {
+		return nil
+	}
+	file := getFile(ev)
+	flags, mode := getProbationFlagsAndMode(ev)
+
+	req := erpc.NewERPCRequest(erpc.RejectDiscarderProbationOp)
+	binary.NativeEndian.PutUint64(req.Data[0:8], uint64(eventType))
+	binary.NativeEndian.PutUint64(req.Data[8:16], file.PathKey.Inode)
+	binary.NativeEndian.PutUint32(req.Data[16:20], file.PathKey.MountID)
+	binary.NativeEndian.PutUint32(req.Data[20:24], ev.ProcessContext.Pid)
+	binary.NativeEndian.PutUint32(req.Data[24:28], flags)
+	binary.NativeEndian.PutUint32(req.Data[28:32], mode)
+	binary.NativeEndian.PutUint64(req.Data[32:40], ev.ProcessContext.Cookie)
+
+	return req
+}
+
+// rejectDiscarderProbation sends an eRPC request to stop the in-kernel suppression of the events identical to the
+// given one, as it matched a rule
+func rejectDiscarderProbation(e *erpc.ERPC, ev *model.Event) error {
+	req := newRejectDiscarderProbationRequest(ev)
+	if req == nil {
+		return nil
+	}
+	return e.Request(req)
+}
+
+// getDiscardersFingerprints returns a fingerprint of the rules of each event type. The discarders of an event type
+// only depend on its rules, so they remain valid as long as its fingerprint doesn't change.
+func getDiscardersFingerprints(rs *rules.RuleSet) map[eval.EventType]uint64 {
+	fingerprints := make(map[eval.EventType]uint64)
+
+	for _, eventType := range rs.GetEventTypes() {
+		bucket := rs.GetBucket(eventType)
+		if bucket == nil {
+			continue
+		}
+
+		bucketRules := slices.Clone(bucket.GetRules())
+		slices.SortFunc(bucketRules, func(a, b *rules.Rule) int {
+			return strings.Compare(a.ID, b.ID)
+		})
+
+		h := fnv.New64a()
+		for _, rule := range bucketRules {
+			fmt.Fprintf(h, "%s:%s;", rule.ID, rule.Expression)
+			// the field values hold the expanded macros
+			for _, field := range rule.GetEvaluator().GetFields() {
+				fmt.Fprintf(h, "%s:%v;", field, rule.GetFieldValues(field))
+			}
+		}
+		fingerprints[eventType] = h.Sum64()
+	}
+
+	return fingerprints
+}
+
 func marshalDiscardHeader(req *erpc.Request, eventType model.EventType, timeout uint64) int {
 	binary.NativeEndian.PutUint64(req.Data[0:8], uint64(eventType))
 	binary.NativeEndian.PutUint64(req.Data[8:16], timeout)
@@ -132,7 +239,6 @@ type InodeDiscarderEntry struct {
 // InodeDiscarderParams describes a map value
 type InodeDiscarderParams struct {
 	DiscarderParams `yaml:"params"`
-	Revision        uint32
 }
 
 // PidDiscarderParams describes a map value
@@ -534,10 +640,11 @@ type InodeDiscarderDump struct {
 
 // DiscardersDump describes a dump of discarders
 type DiscardersDump struct {
-	Date   time.Time                  `yaml:"date"`
-	Inodes []InodeDiscarderDump       `yaml:"inodes"`
-	Pids   []PidDiscarderDump         `yaml:"pids"`
-	Stats  map[string]discarder.Stats `yaml:"stats"`
+	Date     time.Time                  `yaml:"date"`
+	Inodes   []InodeDiscarderDump       `yaml:"inodes"`
+	Subtrees []InodeDiscarderDump       `yaml:"subtrees"`
+	Pids     []PidDiscarderDump         `yaml:"pids"`
+	Stats    map[string]discarder.Stats `yaml:"stats"`
 }
 
 func dumpPidDiscarders(pidMap *ebpf.Map) ([]PidDiscarderDump, error) {
@@ -644,7 +751,7 @@ func dumpDiscarderStats(buffers ...*ebpf.Map) (map[string]discarder.Stats, error
 }
 
 // DumpDiscarders removes all the discarders
-func dumpDiscarders(resolver *dentry.Resolver, pidMap, inodeMap, statsFB, statsBB *ebpf.Map) (DiscardersDump, error) {
+func dumpDiscarders(resolver *dentry.Resolver, pidMap, inodeMap, subtreeMap, statsFB, statsBB *ebpf.Map) (DiscardersDump, error) {
 	seclog.Debugf("Dumping discarders")
 
 	dump := DiscardersDump{
@@ -663,6 +770,12 @@ func dumpDiscarders(resolver *dentry.Resolver, pidMap, inodeMap, statsFB, statsB
 	}
 	dump.Inodes = inodes
 
+	subtrees, err := dumpInodeDiscarders(resolver, subtreeMap)
+	if err != nil {
+		return dump, err
+	}
+	dump.Subtrees = subtrees
+
 	stats, err := dumpDiscarderStats(statsFB, statsBB)
 	if err != nil {
 		return dump, err
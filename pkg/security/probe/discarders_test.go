@@ -9,6 +9,8 @@
 package probe
 
 import (
+	"encoding/binary"
+	"syscall"
 	"testing"
 	"time"
 
@@ -475,3 +477,88 @@ func TestIsRecentlyAddedOverflow(t *testing.T) {
 		t.Error("should be marked as added")
 	}
 }
+
+func TestDiscardersFingerprints(t *testing.T) {
+	enabled := map[eval.EventType]bool{"*": true}
+
+	var evalOpts eval.Opts
+	evalOpts.
+		WithConstants(model.SECLConstants()).
+		WithLegacyFields(model.SECLLegacyFields).
+		WithVariables(model.SECLVariables)
+
+	var opts rules.Opts
+	opts.
+		WithEventTypeEnabled(enabled).
+		WithLogger(seclog.DefaultLogger)
+
+	rs := rules.NewRuleSet(&model.Model{}, newFakeEvent, &opts, &evalOpts)
+	rules.AddTestRuleExpr(t, rs, `unlink.file.path == "/etc/passwd"`, `open.file.path == "/etc/shadow"`)
+	previous := getDiscardersFingerprints(rs)
+
+	rs = rules.NewRuleSet(&model.Model{}, newFakeEvent, &opts, &evalOpts)
+	rules.AddTestRuleExpr(t, rs, `unlink.file.path == "/etc/passwd"`, `open.file.path == "/etc/shadow"`)
+	fingerprints := getDiscardersFingerprints(rs)
+
+	if previous["unlink"] != fingerprints["unlink"] || previous["open"] != fingerprints["open"] {
+		t.Error("the fingerprints of the same rules should be equal")
+	}
+
+	rs = rules.NewRuleSet(&model.Model{}, newFakeEvent, &opts, &evalOpts)
+	rules.AddTestRuleExpr(t, rs, `unlink.file.path == "/etc/passwd"`, `open.file.path == "/etc/group"`)
+	fingerprints = getDiscardersFingerprints(rs)
+
+	if previous["unlink"] != fingerprints["unlink"] {
+		t.Error("the unlink fingerprint shouldn't change")
+	}
+
+	if previous["open"] == fingerprints["open"] {
+		t.Error("the open fingerprint should change")
+	}
+}
+
+func TestRejectDiscarderProbationRequest(t *testing.T) {
+	ev := model.NewFakeEvent()
+	ev.Type = uint32(model.FileOpenEventType)
+	ev.Open.File.PathKey.Inode = 42
+	ev.Open.File.PathKey.MountID = 7
+	ev.Open.Flags = syscall.O_RDWR
+	ev.Open.Mode = 0644
+	ev.ProcessContext = &model.ProcessContext{}
+	ev.ProcessContext.Pid = 1234
+	ev.ProcessContext.Cookie = 0xdeadbeef
+
+	req := newRejectDiscarderProbationRequest(ev)
+	if req == nil {
+		t.Fatal("expected a request for an open event")
+	}
+
+	if eventType := binary.NativeEndian.Uint64(req.Data[0:8]); eventType != uint64(model.FileOpenEventType) {
+		t.Errorf("wrong event type: %d", eventType)
+	}
+	if inode := binary.NativeEndian.Uint64(req.Data[8:16]); inode != 42 {
+		t.Errorf("wrong inode: %d", inode)
+	}
+	if mountID := binary.NativeEndian.Uint32(req.Data[16:20]); mountID != 7 {
+		t.Errorf("wrong mount id: %d", mountID)
+	}
+	if pid := binary.NativeEndian.Uint32(req.Data[20:24]); pid != 1234 {
+		t.Errorf("wrong pid: %d", pid)
+	}
+	// the probation of a read write open is not the one of a read only open of the same file
+	if flags := binary.NativeEndian.Uint32(req.Data[24:28]); flags != syscall.O_RDWR {
+		t.Errorf("wrong flags: %d", flags)
+	}
+	if mode := binary.NativeEndian.Uint32(req.Data[28:32]); mode != 0644 {
+		t.Errorf("wrong mode: %o", mode)
+	}
+	// the rejection only holds for the process image that sent the event
+	if cookie := binary.NativeEndian.Uint64(req.Data[32:40]); cookie != 0xdeadbeef {
+		t.Errorf("wrong cookie: %x", cookie)
+	}
+
+	ev.Type = uint32(model.ExecEventType)
+	if req := newRejectDiscarderProbationRequest(ev); req != nil {
+		t.Error("exec events have no probation")
+	}
+}
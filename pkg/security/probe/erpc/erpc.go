@@ -44,6 +44,10 @@ const (
 	GetRingbufUsage
 	// UserSessionContextOp is used to inject the Kubernetes User context
 	UserSessionContextOp
+	// ResolvePathsOp resolves a batch of paths, each one in its own slot of the segment
+	ResolvePathsOp
+	// RejectDiscarderProbationOp is used to stop the suppression of the events identical to an event matching a rule
+	RejectDiscarderProbationOp
 )
 
 // ERPC defines a krpc object
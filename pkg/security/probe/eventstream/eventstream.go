@@ -10,3 +10,6 @@ package eventstream
 
 // EventStreamMap defines the event stream map name
 const EventStreamMap = "events"
+
+// EventStreamPriorityMap defines the name of the ring buffer of the process lifecycle and privileged operations events
+const EventStreamPriorityMap = "events_priority"
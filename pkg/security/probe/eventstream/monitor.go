@@ -18,6 +18,7 @@ import (
 	lib "github.com/cilium/ebpf"
 	"go.uber.org/atomic"
 
+	ddebpf "github.com/DataDog/datadog-agent/pkg/ebpf"
 	"github.com/DataDog/datadog-agent/pkg/security/ebpf/probes"
 	"github.com/DataDog/datadog-agent/pkg/security/metrics"
 	"github.com/DataDog/datadog-agent/pkg/security/probe/config"
@@ -114,6 +115,11 @@ type Monitor struct {
 	// lastTimestamp is used to track the timestamp of the last event retrieved from the perf map
 	lastTimestamp uint64
 
+	// latencyClock and queueingLatency track the time the events spent in the kernel buffers before being read,
+	// bucketed by the powers of two of microseconds
+	latencyClock    *ddebpf.QueueingLatencyClock
+	queueingLatency map[string][ddebpf.QueueingLatencyBuckets]*atomic.Uint64
+
 	// call that can be used to get notify when events are lost
 	onEventLost func(perfMapName string, perEvent map[string]uint64)
 }
@@ -145,9 +151,16 @@ func NewEventStreamMonitor(config *config.Config, eRPC *erpc.ERPC, manager *mana
 		readLostEvents:    make(map[string][]*atomic.Uint64),
 		sortingErrorStats: make(map[string][model.MaxKernelEventType]*atomic.Int64),
 		invalidEventStats: make(map[string][maxInvalidEventCause]*invalidEventStats),
+		queueingLatency:   make(map[string][ddebpf.QueueingLatencyBuckets]*atomic.Uint64),
 
 		onEventLost: onEventLost,
 	}
+	latencyClock, err := ddebpf.NewQueueingLatencyClock()
+	if err != nil {
+		return nil, fmt.Errorf("couldn't initialize the queueing latency clock: %w", err)
+	}
+	pbm.latencyClock = latencyClock
+
 	numCPU, err := utils.NumCPU()
 	if err != nil {
 		return nil, fmt.Errorf("couldn't fetch the host CPU count: %w", err)
@@ -202,6 +215,7 @@ func NewEventStreamMonitor(config *config.Config, eRPC *erpc.ERPC, manager *mana
 		var usrLostEvents []*atomic.Uint64
 		var sortingErrorStats [model.MaxKernelEventType]*atomic.Int64
 		var invalidEventStats [maxInvalidEventCause]*invalidEventStats
+		var queueingLatency [ddebpf.QueueingLatencyBuckets]*atomic.Uint64
 
 		for i := 0; i < pbm.numCPU; i++ {
 			stats = append(stats, initEventStreamMapStatsArray())
@@ -217,11 +231,16 @@ func NewEventStreamMonitor(config *config.Config, eRPC *erpc.ERPC, manager *mana
 			invalidEventStats[i] = newInvalidEventStats()
 		}
 
+		for i := range queueingLatency {
+			queueingLatency[i] = atomic.NewUint64(0)
+		}
+
 		pbm.stats[mapName] = stats
 		pbm.kernelStats[mapName] = kernelStats
 		pbm.readLostEvents[mapName] = usrLostEvents
 		pbm.sortingErrorStats[mapName] = sortingErrorStats
 		pbm.invalidEventStats[mapName] = invalidEventStats
+		pbm.queueingLatency[mapName] = queueingLatency
 	}
 	log.Debugf("monitoring perf ring buffer on %d CPU, %d events", pbm.numCPU, model.MaxKernelEventType)
 	return &pbm, nil
@@ -443,6 +462,7 @@ func (pbm *Monitor) CountEvent(eventType model.EventType, timestamp uint64, coun
 
 	pbm.stats[mapName][cpu][eventType].Count.Add(count)
 	pbm.stats[mapName][cpu][eventType].Bytes.Add(size)
+	pbm.queueingLatency[mapName][pbm.latencyClock.Bucket(timestamp)].Add(count)
 }
 
 // CountInvalidEvent counts the size of one invalid event of the specified cause
@@ -488,6 +508,18 @@ func (pbm *Monitor) sendEventsAndBytesReadStats(client statsd.ClientInterface) e
 		}
 	}
 
+	for mapName, buckets := range pbm.queueingLatency {
+		tags := []string{pbm.config.StatsTagsCardinality, fmt.Sprintf("map:%s", mapName), ""}
+		for bucket, count := range buckets {
+			if value := count.Swap(0); value > 0 {
+				tags[2] = ddebpf.QueueingLatencyBucketTag(bucket)
+				if err := client.Count(metrics.MetricPerfBufferQueueingLatency, int64(value), tags, 1.0); err != nil {
+					return err
+				}
+			}
+		}
+	}
+
 	for mapName, causes := range pbm.invalidEventStats {
 		for cause, stats := range causes {
 			count, bytes := stats.getAndReset()
@@ -9,23 +9,34 @@
 package ringbuffer
 
 import (
+	"context"
 	"fmt"
 	"sync"
+	"time"
 
 	manager "github.com/DataDog/ebpf-manager"
+	"github.com/cilium/ebpf/perf"
 	"github.com/cilium/ebpf/ringbuf"
 
 	ebpfTelemetry "github.com/DataDog/datadog-agent/pkg/ebpf/telemetry"
 	"github.com/DataDog/datadog-agent/pkg/security/probe/config"
 	"github.com/DataDog/datadog-agent/pkg/security/probe/eventstream"
+	"github.com/DataDog/datadog-agent/pkg/security/probe/eventstream/reorderer"
 )
 
 // RingBuffer implements the EventStream interface
 // using an eBPF map of type BPF_MAP_TYPE_RINGBUF
 type RingBuffer struct {
+	ctx        context.Context
 	ringBuffer *manager.RingBuffer
-	handler    func(int, []byte)
-	recordPool *sync.Pool
+	// priorityRingBuffer holds the process lifecycle and privileged operations events, nil when not used
+	priorityRingBuffer *manager.RingBuffer
+	handler            func(int, []byte)
+	recordPool         *sync.Pool
+	// reOrderer merges the events of both ring buffers by kernel timestamp, like the perf buffer reorderer, so that
+	// an exec or an exit isn't handled before the file events sent earlier. nil without the priority ring buffer.
+	reOrderer        *reorderer.ReOrderer
+	reOrdererRecords *reorderer.RecordPool
 }
 
 // Init the ring buffer
@@ -34,8 +45,19 @@ func (rb *RingBuffer) Init(mgr *manager.Manager, config *config.Config) error {
 	if rb.ringBuffer, ok = mgr.GetRingBuffer(eventstream.EventStreamMap); !ok {
 		return fmt.Errorf("couldn't find %q ring buffer", eventstream.EventStreamMap)
 	}
+	rb.initRingBuffer(rb.ringBuffer, config, config.EventStreamBufferSize)
 
-	rb.ringBuffer.RingBufferOptions = manager.RingBufferOptions{
+	if priorityRingBuffer, ok := mgr.GetRingBuffer(eventstream.EventStreamPriorityMap); ok {
+		rb.priorityRingBuffer = priorityRingBuffer
+		rb.initRingBuffer(rb.priorityRingBuffer, config, config.EventStreamPriorityBufferSize)
+		rb.initReOrderer()
+	}
+
+	return nil
+}
+
+func (rb *RingBuffer) initRingBuffer(ringBuffer *manager.RingBuffer, config *config.Config, size int) {
+	ringBuffer.RingBufferOptions = manager.RingBufferOptions{
 		RecordGetter: func() *ringbuf.Record {
 			return rb.recordPool.Get().(*ringbuf.Record)
 		},
@@ -43,16 +65,42 @@ func (rb *RingBuffer) Init(mgr *manager.Manager, config *config.Config) error {
 		TelemetryEnabled: config.InternalTelemetryEnabled,
 	}
 
-	if config.EventStreamBufferSize != 0 {
-		rb.ringBuffer.RingBufferOptions.RingBufferSize = config.EventStreamBufferSize
+	if size != 0 {
+		ringBuffer.RingBufferOptions.RingBufferSize = size
 	}
 
-	ebpfTelemetry.ReportRingBufferTelemetry(rb.ringBuffer)
-	return nil
+	ebpfTelemetry.ReportRingBufferTelemetry(ringBuffer)
+}
+
+func (rb *RingBuffer) initReOrderer() {
+	rb.reOrdererRecords = reorderer.NewRecordPool()
+	rb.reOrderer = reorderer.NewReOrderer(rb.ctx,
+		func(record *perf.Record) {
+			defer rb.reOrdererRecords.Release(record)
+			rb.handler(0, record.RawSample)
+		},
+		reorderer.ExtractEventInfo,
+		reorderer.Opts{
+			QueueSize:       10000,
+			Rate:            50 * time.Millisecond,
+			Retention:       5,
+			MetricRate:      5 * time.Second,
+			HeapShrinkDelta: 1000,
+		})
 }
 
 // Start the event stream.
-func (rb *RingBuffer) Start(_ *sync.WaitGroup) error {
+func (rb *RingBuffer) Start(wg *sync.WaitGroup) error {
+	if rb.reOrderer != nil {
+		wg.Add(1)
+		go rb.reOrderer.Start(wg)
+	}
+
+	if rb.priorityRingBuffer != nil {
+		if err := rb.priorityRingBuffer.Start(); err != nil {
+			return err
+		}
+	}
 	return rb.ringBuffer.Start()
 }
 
@@ -60,8 +108,18 @@ func (rb *RingBuffer) Start(_ *sync.WaitGroup) error {
 func (rb *RingBuffer) SetMonitor(_ eventstream.LostEventCounter) {}
 
 func (rb *RingBuffer) handleEvent(record *ringbuf.Record, _ *manager.RingBuffer, _ *manager.Manager) {
-	rb.handler(0, record.RawSample)
+	if rb.reOrderer == nil {
+		rb.handler(0, record.RawSample)
+		rb.recordPool.Put(record)
+		return
+	}
+
+	// hand the sample over to the reorderer, swapping the buffers to avoid a copy
+	ordered := rb.reOrdererRecords.Get()
+	ordered.RawSample, record.RawSample = record.RawSample, ordered.RawSample[:0]
 	rb.recordPool.Put(record)
+
+	rb.reOrderer.HandleEvent(ordered, nil, nil)
 }
 
 // Pause the event stream. Do nothing when using ring buffer
@@ -75,7 +133,7 @@ func (rb *RingBuffer) Resume() error {
 }
 
 // New returns a new ring buffer based event stream.
-func New(handler func(int, []byte)) *RingBuffer {
+func New(ctx context.Context, handler func(int, []byte)) *RingBuffer {
 	recordPool := &sync.Pool{
 		New: func() interface{} {
 			return new(ringbuf.Record)
@@ -83,6 +141,7 @@ func New(handler func(int, []byte)) *RingBuffer {
 	}
 
 	return &RingBuffer{
+		ctx:        ctx,
 		recordPool: recordPool,
 		handler:    handler,
 	}
@@ -0,0 +1,62 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux
+
+// Package ringbuffer holds ringbuffer related files
+package ringbuffer
+
+import (
+	"context"
+	"encoding/binary"
+	"sync"
+	"testing"
+	"time"
+
+	"github.com/cilium/ebpf/ringbuf"
+	"github.com/stretchr/testify/assert"
+)
+
+func newRecord(timestamp uint64) *ringbuf.Record {
+	record := &ringbuf.Record{RawSample: make([]byte, 8)}
+	binary.NativeEndian.PutUint64(record.RawSample, timestamp)
+	return record
+}
+
+func TestPriorityRingBufferOrder(t *testing.T) {
+	ctx, cancel := context.WithCancel(context.Background())
+
+	var lock sync.Mutex
+	var timestamps []uint64
+	rb := New(ctx, func(_ int, data []byte) {
+		lock.Lock()
+		timestamps = append(timestamps, binary.NativeEndian.Uint64(data[0:8]))
+		lock.Unlock()
+	})
+	rb.initReOrderer()
+
+	var wg sync.WaitGroup
+	wg.Add(1)
+	go rb.reOrderer.Start(&wg)
+	defer func() {
+		cancel()
+		wg.Wait()
+	}()
+
+	// file events read from the main ring buffer, then an exit sent in between read from the priority one
+	rb.handleEvent(newRecord(100), nil, nil)
+	rb.handleEvent(newRecord(300), nil, nil)
+	rb.handleEvent(newRecord(200), nil, nil)
+
+	assert.Eventually(t, func() bool {
+		lock.Lock()
+		defer lock.Unlock()
+		return len(timestamps) == 3
+	}, 5*time.Second, 50*time.Millisecond)
+
+	lock.Lock()
+	defer lock.Unlock()
+	assert.Equal(t, []uint64{100, 200, 300}, timestamps)
+}
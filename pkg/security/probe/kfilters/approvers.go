@@ -17,8 +17,12 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/security/secl/rules"
 )
 
-// BasenameApproverKernelMapName defines the basename approver kernel map name
-const BasenameApproverKernelMapName = "basename_approvers"
+const (
+	// BasenameApproverKernelMapName defines the basename approver kernel map name
+	BasenameApproverKernelMapName = "basename_approvers"
+	// PrefixApproverKernelMapName defines the prefix approver kernel map name
+	PrefixApproverKernelMapName = "prefix_approvers"
+)
 
 type onApproverHandler func(approvers rules.Approvers) (ActiveApprovers, error)
 type activeApprover = activeKFilter
@@ -38,6 +42,15 @@ func approveBasename(tableName string, eventType model.EventType, basename strin
 	}, nil
 }
 
+func approvePrefix(tableName string, eventType model.EventType, prefix string) (activeApprover, error) {
+	return &mapEventMask{
+		tableName: tableName,
+		key:       prefix,
+		tableKey:  ebpf.NewPrefixMapItem(prefix, PrefixFilterSize),
+		eventMask: uint64(1 << (eventType - 1)),
+	}, nil
+}
+
 func approveBasenames(tableName string, eventType model.EventType, basenames ...string) (approvers []activeApprover, _ error) {
 	for _, basename := range basenames {
 		activeApprover, err := approveBasename(tableName, eventType, basename)
@@ -113,8 +126,17 @@ func onNewBasenameApprovers(eventType model.EventType, field string, approvers r
 			basenameApprovers = append(basenameApprovers, activeApprovers...)
 
 		case prefix + model.PathSuffix:
-			for _, value := range stringValues(values) {
-				basename := path.Base(value)
+			for _, value := range values {
+				if dirPrefix, ok := prefixFilter(value); ok {
+					activeApprover, err := approvePrefix(PrefixApproverKernelMapName, eventType, dirPrefix)
+					if err != nil {
+						return nil, err
+					}
+					basenameApprovers = append(basenameApprovers, activeApprover)
+					continue
+				}
+
+				basename := path.Base(value.Value.(string))
 				activeApprover, err := approveBasename(BasenameApproverKernelMapName, eventType, basename)
 				if err != nil {
 					return nil, err
@@ -82,3 +82,64 @@ func TestApproverAncestors3(t *testing.T) {
 		t.Fatalf("expected approver not found: %v", values)
 	}
 }
+
+func TestApproverPrefix(t *testing.T) {
+	enabled := map[eval.EventType]bool{"*": true}
+
+	ruleOpts, evalOpts := rules.NewBothOpts(enabled)
+
+	rs := rules.NewRuleSet(&model.Model{}, newFakeEvent, ruleOpts, evalOpts)
+	rules.AddTestRuleExpr(t, rs, `open.file.path =~ "/etc/*"`, `open.file.path =~ "/var/lib/*.db"`, `open.file.path == "/tmp/test"`)
+	capabilities, exists := allCapabilities["open"]
+	if !exists {
+		t.Fatal("no capabilities for open")
+	}
+	approvers, err := rs.GetEventApprovers("open", capabilities.GetFieldCapabilities())
+	if err != nil {
+		t.Fatal(err)
+	}
+	values, exists := approvers["open.file.path"]
+	if !exists || len(values) != 3 {
+		t.Fatalf("expected approver not found: %v", values)
+	}
+
+	var prefixes []string
+	for _, value := range values {
+		if prefix, ok := prefixFilter(value); ok {
+			prefixes = append(prefixes, prefix)
+		}
+	}
+	if len(prefixes) != 2 || !hasPrefixApprovers(approvers) {
+		t.Fatalf("expected prefix approvers not found: %v", prefixes)
+	}
+
+	activeApprovers, err := openOnNewApprovers(approvers)
+	if err != nil {
+		t.Fatal(err)
+	}
+	for _, prefix := range []string{"/etc/", "/var/lib/"} {
+		if !activeApprovers.HasKey(mapHash{tableName: PrefixApproverKernelMapName, key: prefix}) {
+			t.Errorf("expected prefix approver `%s` not found", prefix)
+		}
+	}
+}
+
+func TestApproverPrefixRoot(t *testing.T) {
+	enabled := map[eval.EventType]bool{"*": true}
+
+	ruleOpts, evalOpts := rules.NewBothOpts(enabled)
+
+	rs := rules.NewRuleSet(&model.Model{}, newFakeEvent, ruleOpts, evalOpts)
+	rules.AddTestRuleExpr(t, rs, `open.file.path =~ "/*"`)
+	capabilities, exists := allCapabilities["open"]
+	if !exists {
+		t.Fatal("no capabilities for open")
+	}
+	approvers, err := rs.GetEventApprovers("open", capabilities.GetFieldCapabilities())
+	if err != nil {
+		t.Fatal(err)
+	}
+	if values, exists := approvers["open.file.path"]; exists {
+		t.Fatalf("unexpected approver found: %v", values)
+	}
+}
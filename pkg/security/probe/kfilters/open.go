@@ -18,9 +18,9 @@ import (
 
 var openCapabilities = Capabilities{
 	"open.file.path": {
-		PolicyFlags:     PolicyFlagBasename,
+		PolicyFlags:     PolicyFlagBasename | PolicyFlagPrefix,
 		FieldValueTypes: eval.ScalarValueType | eval.PatternValueType | eval.GlobValueType,
-		ValidateFnc:     validateBasenameFilter,
+		ValidateFnc:     validateOpenPathFilter,
 		FilterWeight:    15,
 	},
 	"open.file.name": {
@@ -34,6 +34,15 @@ var openCapabilities = Capabilities{
 	},
 }
 
+// validateOpenPathFilter accepts the paths approved by their basename, or by their directory prefix
+func validateOpenPathFilter(value rules.FilterValue) bool {
+	if validateBasenameFilter(value) {
+		return true
+	}
+	_, ok := prefixFilter(value)
+	return ok
+}
+
 func openOnNewApprovers(approvers rules.Approvers) (ActiveApprovers, error) {
 	openApprovers, err := onNewBasenameApprovers(model.FileOpenEventType, "file", approvers)
 	if err != nil {
@@ -29,9 +29,12 @@ const (
 	PolicyFlagBasename PolicyFlag = 1
 	PolicyFlagFlags    PolicyFlag = 2
 	PolicyFlagMode     PolicyFlag = 4
+	PolicyFlagPrefix   PolicyFlag = 16
 
 	// need to be aligned with the kernel size
 	BasenameFilterSize = 256
+	// PrefixFilterSize need to be aligned with the kernel size
+	PrefixFilterSize = 128
 )
 
 func (m PolicyMode) String() string {
@@ -75,6 +78,9 @@ func (f PolicyFlag) StringArray() []string {
 	if f&PolicyFlagMode != 0 {
 		flags = append(flags, "mode")
 	}
+	if f&PolicyFlagPrefix != 0 {
+		flags = append(flags, "prefix")
+	}
 
 	return flags
 }
@@ -0,0 +1,56 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+// Package kfilters holds kfilters related files
+package kfilters
+
+import (
+	"path"
+	"strings"
+
+	"github.com/DataDog/datadog-agent/pkg/security/secl/compiler/eval"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/model"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/rules"
+)
+
+// prefixFilter returns the directory prefix a path glob can be approved on in the kernel, as `/etc/` for `/etc/*` or
+// `/etc/ssh/` for `/etc/ssh/*.conf`. Only the globs whose basename contains a wildcard qualify, the others being
+// approved by their basename.
+func prefixFilter(value rules.FilterValue) (string, bool) {
+	if value.Type != eval.GlobValueType {
+		return "", false
+	}
+
+	pattern, ok := value.Value.(string)
+	if !ok || !strings.Contains(path.Base(pattern), "*") {
+		return "", false
+	}
+
+	literal := pattern[:strings.IndexByte(pattern, '*')]
+	prefix := literal[:strings.LastIndexByte(literal, '/')+1]
+
+	// never approve the whole filesystem, and keep the prefix within the kernel key
+	if len(prefix) <= 1 || prefix[0] != '/' || len(prefix) > PrefixFilterSize {
+		return "", false
+	}
+
+	return prefix, true
+}
+
+// hasPrefixApprovers returns whether some of the path approvers are prefix approvers
+func hasPrefixApprovers(approvers rules.Approvers) bool {
+	for field, values := range approvers {
+		if !strings.HasSuffix(field, model.PathSuffix) {
+			continue
+		}
+
+		for _, value := range values {
+			if _, ok := prefixFilter(value); ok {
+				return true
+			}
+		}
+	}
+	return false
+}
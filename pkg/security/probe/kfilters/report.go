@@ -56,6 +56,11 @@ func NewApplyRuleSetReport(config *config.Config, rs *rules.RuleSet) (*ApplyRule
 
 		if values, exists := approvers[eventType]; exists {
 			report.Approvers = values
+
+			// the prefix approvers resolve the path in the kernel, skip it when none are used
+			if !hasPrefixApprovers(values) {
+				report.Flags &^= PolicyFlagPrefix
+			}
 		} else {
 			report.Mode = PolicyModeAccept
 		}
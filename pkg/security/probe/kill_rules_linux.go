@@ -0,0 +1,151 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux
+
+// Package probe holds probe related files
+package probe
+
+import (
+	"encoding/binary"
+	"slices"
+
+	"github.com/DataDog/datadog-agent/pkg/security/config"
+	"github.com/DataDog/datadog-agent/pkg/security/probe/kfilters"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/compiler/eval"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/model"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/rules"
+)
+
+const (
+	// kernelKillRuleContainerOnly restricts a kernel kill rule to the processes running in a container
+	kernelKillRuleContainerOnly = 1 << 0
+
+	// kernelKillRuleContainerID is the container ID used to check whether a rule only matches containers
+	kernelKillRuleContainerID = "kernel-kill-rule-container"
+)
+
+// kernelKillRuleEventTypes lists the event types whose kill rules can be enforced by the kernel
+var kernelKillRuleEventTypes = []model.EventType{model.ExecEventType, model.FileOpenEventType}
+
+// kernelKillRuleKey is the key of a kernel kill rule, see struct kill_rule_key_t
+type kernelKillRuleKey struct {
+	eventType model.EventType
+	basename  string
+}
+
+// MarshalBinary returns the binary representation of the key
+func (k kernelKillRuleKey) MarshalBinary() ([]byte, error) {
+	b := make([]byte, kfilters.BasenameFilterSize+8)
+	copy(b, k.basename)
+	binary.NativeEndian.PutUint32(b[kfilters.BasenameFilterSize:], uint32(k.eventType))
+	return b, nil
+}
+
+// kernelKillRule is the signal sent by a kernel kill rule, see struct kill_rule_t
+type kernelKillRule struct {
+	Signal uint32
+	Flags  uint32
+}
+
+// getKernelKillSignal returns the signal of the kill action of the rule, if it can be sent by the kernel
+func getKernelKillSignal(rule *rules.Rule) (uint32, bool) {
+	for _, action := range rule.Definition.Actions {
+		if action.Kill == nil || action.Filter != nil {
+			continue
+		}
+		if action.Kill.Scope != "" && action.Kill.Scope != "process" {
+			continue
+		}
+		if sig := model.SignalConstants[action.Kill.Signal]; sig > 0 {
+			return uint32(sig), true
+		}
+	}
+	return 0, false
+}
+
+// evalKernelKillRule evaluates the rule against an event with the given file basename and container ID
+func evalKernelKillRule(rs *rules.RuleSet, rule *rules.Rule, field eval.Field, basename string, containerID string) bool {
+	event := rs.NewEvent()
+	if err := event.SetFieldValue(field, basename); err != nil {
+		return false
+	}
+	if err := event.SetFieldValue("container.id", containerID); err != nil {
+		return false
+	}
+	return rule.Eval(eval.NewContext(event))
+}
+
+// isContainerCheck returns whether the rule only checks that the container ID isn't empty
+func isContainerCheck(rule *rules.Rule) bool {
+	for _, value := range rule.GetFieldValues("container.id") {
+		if value.Type != eval.ScalarValueType || value.Value != "" {
+			return false
+		}
+	}
+	return true
+}
+
+// getKernelKillRules returns the kill rules enforced by the kernel, from the hook of the event, without waiting for
+// the event to be evaluated in userspace. Only the exec and open rules whose outcome depends on the basename of the
+// file, and optionally on the process running in a container, are compiled to kernel kill rules.
+func getKernelKillRules(rs *rules.RuleSet) map[kernelKillRuleKey]kernelKillRule {
+	killRules := make(map[kernelKillRuleKey]kernelKillRule)
+
+LOOP:
+	for _, rule := range rs.GetRules() {
+		signal, ok := getKernelKillSignal(rule)
+		if !ok {
+			continue
+		}
+
+		eventTypes, err := rule.GetEventTypes()
+		if err != nil || len(eventTypes) != 1 {
+			continue
+		}
+		eventType := config.ParseEvalEventType(eventTypes[0])
+		if !slices.Contains(kernelKillRuleEventTypes, eventType) {
+			continue
+		}
+
+		field := eventTypes[0] + ".file.name"
+		withContainer := false
+		for _, ruleField := range rule.GetFields() {
+			switch ruleField {
+			case field:
+			case "container.id":
+				withContainer = true
+			default:
+				continue LOOP
+			}
+		}
+		if withContainer && !isContainerCheck(rule) {
+			continue
+		}
+
+		for _, value := range rule.GetFieldValues(field) {
+			basename, ok := value.Value.(string)
+			if value.Type != eval.ScalarValueType || !ok || basename == "" || len(basename) >= kfilters.BasenameFilterSize {
+				continue
+			}
+
+			var flags uint32
+			inContainer := evalKernelKillRule(rs, rule, field, basename, kernelKillRuleContainerID)
+			onHost := evalKernelKillRule(rs, rule, field, basename, "")
+			if !inContainer {
+				continue
+			} else if !onHost {
+				flags |= kernelKillRuleContainerOnly
+			}
+
+			killRules[kernelKillRuleKey{eventType: eventType, basename: basename}] = kernelKillRule{
+				Signal: signal,
+				Flags:  flags,
+			}
+		}
+	}
+
+	return killRules
+}
@@ -0,0 +1,88 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux
+
+// Package probe holds probe related files
+package probe
+
+import (
+	"fmt"
+	"testing"
+
+	"github.com/DataDog/datadog-agent/pkg/security/secl/compiler/ast"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/compiler/eval"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/model"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/rules"
+	"github.com/DataDog/datadog-agent/pkg/security/seclog"
+)
+
+func newKillRuleSet(t *testing.T, exprs ...string) *rules.RuleSet {
+	enabled := map[eval.EventType]bool{"*": true}
+
+	var evalOpts eval.Opts
+	evalOpts.
+		WithConstants(model.SECLConstants()).
+		WithLegacyFields(model.SECLLegacyFields).
+		WithVariables(model.SECLVariables)
+
+	var opts rules.Opts
+	opts.
+		WithEventTypeEnabled(enabled).
+		WithLogger(seclog.DefaultLogger)
+
+	var ruleDefs []*rules.RuleDefinition
+	for i, expr := range exprs {
+		ruleDefs = append(ruleDefs, &rules.RuleDefinition{
+			ID:         fmt.Sprintf("ID%d", i),
+			Expression: expr,
+			Tags:       make(map[string]string),
+			Actions: []*rules.ActionDefinition{
+				{Kill: &rules.KillDefinition{Signal: "SIGKILL"}},
+			},
+		})
+	}
+
+	rs := rules.NewRuleSet(&model.Model{}, newFakeEvent, &opts, &evalOpts)
+	if err := rs.AddRules(ast.NewParsingContext(), ruleDefs); err != nil {
+		t.Fatal(err)
+	}
+	return rs
+}
+
+func TestKernelKillRules(t *testing.T) {
+	sigkill := uint32(model.SignalConstants["SIGKILL"])
+
+	rs := newKillRuleSet(t,
+		`exec.file.name in ["xmrig", "minerd"]`,
+		`open.file.name == "shadow" && container.id != ""`,
+	)
+	killRules := getKernelKillRules(rs)
+
+	expected := map[kernelKillRuleKey]kernelKillRule{
+		{eventType: model.ExecEventType, basename: "xmrig"}:      {Signal: sigkill},
+		{eventType: model.ExecEventType, basename: "minerd"}:     {Signal: sigkill},
+		{eventType: model.FileOpenEventType, basename: "shadow"}: {Signal: sigkill, Flags: kernelKillRuleContainerOnly},
+	}
+	if len(killRules) != len(expected) {
+		t.Fatalf("expected %d kernel kill rules, got %d: %+v", len(expected), len(killRules), killRules)
+	}
+	for key, rule := range expected {
+		if killRules[key] != rule {
+			t.Errorf("expected %+v for %+v, got %+v", rule, key, killRules[key])
+		}
+	}
+
+	rs = newKillRuleSet(t,
+		`exec.file.name == "xmrig" && process.uid == 0`,
+		`exec.file.name != "xmrig"`,
+		`exec.file.name =~ "xm*"`,
+		`open.file.name == "shadow" && container.id == "abc"`,
+		`unlink.file.name == "shadow"`,
+	)
+	if killRules = getKernelKillRules(rs); len(killRules) != 0 {
+		t.Errorf("expected no kernel kill rule, got %+v", killRules)
+	}
+}
@@ -28,6 +28,7 @@ import (
 type Stats struct {
 	EventApprovedByBasename uint64
 	EventApprovedByFlag     uint64
+	EventApprovedByPrefix   uint64
 }
 
 // Monitor defines an approver monitor
@@ -58,11 +59,12 @@ func (d *Monitor) SendStats() error {
 		for _, stat := range statsAcrossAllCPUs {
 			statsByEventType[eventType].EventApprovedByBasename += stat.EventApprovedByBasename
 			statsByEventType[eventType].EventApprovedByFlag += stat.EventApprovedByFlag
+			statsByEventType[eventType].EventApprovedByPrefix += stat.EventApprovedByPrefix
 		}
 	}
 
 	for eventType, stats := range statsByEventType {
-		if stats.EventApprovedByBasename == 0 && stats.EventApprovedByFlag == 0 {
+		if stats.EventApprovedByBasename == 0 && stats.EventApprovedByFlag == 0 && stats.EventApprovedByPrefix == 0 {
 			continue
 		}
 
@@ -75,9 +77,14 @@ func (d *Monitor) SendStats() error {
 			"approver_type:flag",
 			eventTypeTag,
 		}
+		tagsForPrefixApprovedEvents := []string{
+			"approver_type:prefix",
+			eventTypeTag,
+		}
 
 		_ = d.statsdClient.Count(metrics.MetricEventApproved, int64(stats.EventApprovedByBasename), tagsForBasenameApprovedEvents, 1.0)
 		_ = d.statsdClient.Count(metrics.MetricEventApproved, int64(stats.EventApprovedByFlag), tagsForFlagApprovedEvents, 1.0)
+		_ = d.statsdClient.Count(metrics.MetricEventApproved, int64(stats.EventApprovedByPrefix), tagsForPrefixApprovedEvents, 1.0)
 	}
 	for i := uint32(0); i != uint32(model.LastApproverEventType); i++ {
 		_ = buffer.Put(i, d.statsZero)
@@ -10,13 +10,16 @@ package probe
 
 import (
 	"context"
+	"encoding/binary"
 	"errors"
 	"fmt"
 	"math"
+	"math/bits"
 	"os"
 	"path/filepath"
 	"runtime"
 	"slices"
+	"strings"
 	"sync"
 	"time"
 
@@ -66,6 +69,9 @@ import (
 	"github.com/DataDog/datadog-agent/pkg/util/optional"
 )
 
+// agentInstallDir is the installation directory of the agent executables, on hosts and in the agent images
+const agentInstallDir = "/opt/datadog-agent/"
+
 // EventStream describes the interface implemented by reordered perf maps or ring buffers
 type EventStream interface {
 	Init(*manager.Manager, *pconfig.Config) error
@@ -123,6 +129,8 @@ type EBPFProbe struct {
 	inodeDiscarders          *inodeDiscarders
 	discarderPushedCallbacks []DiscarderPushedCallback
 	approvers                map[eval.EventType]kfilters.ActiveApprovers
+	discardersFingerprints   map[eval.EventType]uint64
+	staleDiscarderEventTypes []model.EventType
 
 	// Approvers / discarders section
 	discarderPushedCallbacksLock sync.RWMutex
@@ -130,10 +138,13 @@ type EBPFProbe struct {
 
 	// kill action
 	killListMap           *lib.Map
+	killRulesMap          *lib.Map
+	kernelKillRules       map[kernelKillRuleKey]kernelKillRule
 	supportsBPFSendSignal bool
 	processKiller         *ProcessKiller
 
 	isRuntimeDiscarded bool
+	agentTgidsMap      *lib.Map
 	constantOffsets    map[string]uint64
 	runtimeCompiled    bool
 	useFentry          bool
@@ -285,9 +296,15 @@ func (p *EBPFProbe) Init() error {
 
 	p.managerOptions.ActivatedProbes = append(p.managerOptions.ActivatedProbes, probes.SnapshotSelectors()...)
 
+	initStart := time.Now()
 	if err := p.Manager.InitWithOptions(bytecodeReader, p.managerOptions); err != nil {
 		return fmt.Errorf("failed to init manager: %w", err)
 	}
+	ebpftelemetry.ReportManagerLoad(p.Manager, "cws", time.Since(initStart))
+
+	if err := p.setupEnvsPrefixFilter(); err != nil {
+		return err
+	}
 
 	p.inodeDiscarders = newInodeDiscarders(p.Erpc, p.Resolvers.DentryResolver)
 
@@ -313,6 +330,16 @@ func (p *EBPFProbe) Init() error {
 		return err
 	}
 
+	p.killRulesMap, err = managerhelper.Map(p.Manager, "kill_rules")
+	if err != nil {
+		return err
+	}
+
+	p.agentTgidsMap, err = managerhelper.Map(p.Manager, "agent_tgids")
+	if err != nil {
+		return err
+	}
+
 	return nil
 }
 
@@ -466,11 +493,18 @@ func (p *EBPFProbe) EventMarshallerCtor(event *model.Event) func() events.EventM
 }
 
 func (p *EBPFProbe) unmarshalContexts(data []byte, event *model.Event) (int, error) {
-	read, err := model.UnmarshalBinary(data, &event.PIDContext, &event.SpanContext, event.ContainerContext)
+	read, err := model.UnmarshalBinary(data, &event.PIDContext, &event.SpanContext)
 	if err != nil {
 		return 0, err
 	}
 
+	// the events only carry the key of their container ID, see container_key_context_t
+	if len(data[read:]) < 8 {
+		return 0, model.ErrNotEnoughData
+	}
+	event.ContainerContext.ID = p.Resolvers.ContainerResolver.ResolveContainerKey(binary.NativeEndian.Uint64(data[read : read+8]))
+	read += 8
+
 	return read, nil
 }
 
@@ -679,6 +713,7 @@ func (p *EBPFProbe) handleEvent(CPU int, data []byte) {
 			}
 		} else {
 			p.Resolvers.ProcessResolver.AddExecEntry(event.ProcessCacheEntry, event.PIDContext.ExecInode)
+			p.registerAgentProcess(event.ProcessCacheEntry)
 		}
 
 		event.Exec.Process = &event.ProcessCacheEntry.Process
@@ -1099,8 +1134,11 @@ func (p *EBPFProbe) SetApprovers(eventType eval.EventType, approvers rules.Appro
 func getApproverType(approverTableName string) string {
 	approverType := "flag"
 
-	if approverTableName == kfilters.BasenameApproverKernelMapName {
+	switch approverTableName {
+	case kfilters.BasenameApproverKernelMapName:
 		approverType = "basename"
+	case kfilters.PrefixApproverKernelMapName:
+		approverType = "prefix"
 	}
 
 	return approverType
@@ -1157,11 +1195,21 @@ func (p *EBPFProbe) updateProbes(ruleEventTypes []eval.EventType, needRawSyscall
 	}
 
 	activatedProbes := probes.SnapshotSelectors()
+	// number of probes attached by this update for each event type, see countProbesToAttach
+	attachedPerEventType := make(map[string]int)
+
+	// event types sent by the kernel, the hooks of the others exit early when all the probes are enabled
+	enabledEventTypes := append([]eval.EventType{}, eventTypes...)
 
 	// extract probe to activate per the event types
 	for eventType, selectors := range probes.GetSelectorsPerEventType(p.useFentry) {
-		if (eventType == "*" || slices.Contains(eventTypes, eventType) || p.isNeededForActivityDump(eventType) || p.isNeededForSecurityProfile(eventType) || p.config.Probe.EnableAllProbes) && p.validEventTypeForConfig(eventType) {
+		neededForProfiles := p.isNeededForActivityDump(eventType) || p.isNeededForSecurityProfile(eventType)
+		if (eventType == "*" || slices.Contains(eventTypes, eventType) || neededForProfiles || p.config.Probe.EnableAllProbes) && p.validEventTypeForConfig(eventType) {
 			activatedProbes = append(activatedProbes, selectors...)
+			p.countProbesToAttach(attachedPerEventType, eventType, selectors)
+		}
+		if neededForProfiles && !slices.Contains(enabledEventTypes, eventType) {
+			enabledEventTypes = append(enabledEventTypes, eventType)
 		}
 	}
 
@@ -1211,7 +1259,7 @@ func (p *EBPFProbe) updateProbes(ruleEventTypes []eval.EventType, needRawSyscall
 	}
 
 	enabledEvents := uint64(0)
-	for _, eventName := range eventTypes {
+	for _, eventName := range enabledEventTypes {
 		if eventName != "*" {
 			eventType := config.ParseEvalEventType(eventName)
 			if eventType == model.UnknownEventType {
@@ -1225,7 +1273,26 @@ func (p *EBPFProbe) updateProbes(ruleEventTypes []eval.EventType, needRawSyscall
 		return fmt.Errorf("failed to set enabled events: %w", err)
 	}
 
-	return p.Manager.UpdateActivatedProbes(activatedProbes)
+	attachStart := time.Now()
+	if err := p.Manager.UpdateActivatedProbes(activatedProbes); err != nil {
+		return err
+	}
+	ebpftelemetry.ReportProbesAttach("cws", time.Since(attachStart), attachedPerEventType)
+	return nil
+}
+
+// countProbesToAttach counts the probes of the selectors of an event type that aren't attached yet
+func (p *EBPFProbe) countProbesToAttach(counts map[string]int, eventType eval.EventType, selectors []manager.ProbesSelector) {
+	if eventType == "*" {
+		eventType = "default"
+	}
+	for _, selector := range selectors {
+		for _, id := range selector.GetProbesIdentificationPairList() {
+			if probe, found := p.Manager.GetProbe(id); found && !probe.IsRunning() {
+				counts[eventType]++
+			}
+		}
+	}
 }
 
 // GetDiscarders retrieve the discarders
@@ -1235,6 +1302,11 @@ func (p *EBPFProbe) GetDiscarders() (*DiscardersDump, error) {
 		return nil, err
 	}
 
+	subtreeMap, err := managerhelper.Map(p.Manager, "subtree_discarders")
+	if err != nil {
+		return nil, err
+	}
+
 	pidMap, err := managerhelper.Map(p.Manager, "pid_discarders")
 	if err != nil {
 		return nil, err
@@ -1250,7 +1322,7 @@ func (p *EBPFProbe) GetDiscarders() (*DiscardersDump, error) {
 		return nil, err
 	}
 
-	dump, err := dumpDiscarders(p.Resolvers.DentryResolver, pidMap, inodeMap, statsFB, statsBB)
+	dump, err := dumpDiscarders(p.Resolvers.DentryResolver, pidMap, inodeMap, subtreeMap, statsFB, statsBB)
 	if err != nil {
 		return nil, err
 	}
@@ -1287,9 +1359,20 @@ func (p *EBPFProbe) DumpDiscarders() (string, error) {
 	return fp.Name(), err
 }
 
-// FlushDiscarders flush the discarders
+// FlushDiscarders flush the discarders of the event types whose rules changed with the last applied rule set
 func (p *EBPFProbe) FlushDiscarders() error {
-	return bumpDiscardersRevision(p.Erpc)
+	if p.discardersFingerprints == nil {
+		return bumpDiscardersRevision(p.Erpc, model.UnknownEventType)
+	}
+
+	for _, eventType := range p.staleDiscarderEventTypes {
+		if err := bumpDiscardersRevision(p.Erpc, eventType); err != nil {
+			return err
+		}
+	}
+	p.staleDiscarderEventTypes = nil
+
+	return nil
 }
 
 // RefreshUserCache refreshes the user cache
@@ -1302,7 +1385,25 @@ func (p *EBPFProbe) RefreshUserCache(containerID string) error {
 func (p *EBPFProbe) Snapshot() error {
 	// the snapshot for the read of a lot of file which can allocate a lot of memory.
 	defer runtime.GC()
-	return p.Resolvers.Snapshot()
+	if err := p.Resolvers.Snapshot(); err != nil {
+		return err
+	}
+
+	p.Resolvers.ProcessResolver.Walk(p.registerAgentProcess)
+	return nil
+}
+
+// registerAgentProcess pushes the pid of an agent process to the kernel. The kernel kill rules never signal it and, when
+// the runtime is discarded, its events, such as the /proc scans of the process-agent, are dropped at hook entry like the
+// ones of system-probe.
+func (p *EBPFProbe) registerAgentProcess(entry *model.ProcessCacheEntry) {
+	if entry.Pid != entry.Tid || !entry.ExitTime.IsZero() || !strings.HasPrefix(entry.FileEvent.PathnameStr, agentInstallDir) {
+		return
+	}
+
+	if err := p.agentTgidsMap.Put(entry.Pid, uint8(1)); err != nil {
+		seclog.Debugf("failed to register agent process %d: %s", entry.Pid, err)
+	}
 }
 
 // Stop the probe
@@ -1419,6 +1520,9 @@ func (p *EBPFProbe) handleNewMount(ev *model.Event, m *model.Mount) error {
 	// so we remove all dentry entries belonging to the mountID.
 	p.Resolvers.DentryResolver.DelCacheEntries(m.MountID)
 
+	// Resolve the mount point and the root with a single eRPC request
+	p.Resolvers.DentryResolver.Prefetch(m.ParentPathKey, m.RootPathKey)
+
 	// Resolve mount point
 	if err := p.Resolvers.PathResolver.SetMountPoint(ev, m); err != nil {
 		return fmt.Errorf("failed to set mount point: %w", err)
@@ -1458,6 +1562,34 @@ func (p *EBPFProbe) applyDefaultFilterPolicies() {
 	}
 }
 
+// envPrefixMaxLen is the maximum length of the env prefixes pushed to the kernel, see ENV_PREFIX_MAX_LEN
+const envPrefixMaxLen = 32
+
+// setupEnvsPrefixFilter pushes the prefixes of the environment variables to collect to the kernel
+func (p *EBPFProbe) setupEnvsPrefixFilter() error {
+	if len(p.config.Probe.EnvsPrefixFilter) == 0 {
+		return nil
+	}
+
+	m, err := managerhelper.Map(p.Manager, "envs_prefix_filter")
+	if err != nil {
+		return err
+	}
+
+	for _, prefix := range p.config.Probe.EnvsPrefixFilter {
+		// mirrors env_prefix_t, longer prefixes are truncated
+		key := make([]byte, 4+envPrefixMaxLen)
+		n := copy(key[4:], prefix)
+		binary.NativeEndian.PutUint32(key[0:4], uint32(n*8))
+
+		if err := m.Put(key, uint8(1)); err != nil {
+			return fmt.Errorf("failed to push the env prefix `%s`: %w", prefix, err)
+		}
+	}
+
+	return nil
+}
+
 func isKillActionPresent(rs *rules.RuleSet) bool {
 	for _, rule := range rs.GetRules() {
 		for _, action := range rule.Definition.Actions {
@@ -1469,6 +1601,26 @@ func isKillActionPresent(rs *rules.RuleSet) bool {
 	return false
 }
 
+// applyKernelKillRules replaces the kill rules enforced by the kernel
+func (p *EBPFProbe) applyKernelKillRules(killRules map[kernelKillRuleKey]kernelKillRule) {
+	for key := range p.kernelKillRules {
+		if _, exists := killRules[key]; !exists {
+			if err := p.killRulesMap.Delete(key); err != nil {
+				seclog.Warnf("failed to remove the kernel kill rule of `%s`: %s", key.basename, err)
+			}
+		}
+	}
+
+	for key, rule := range killRules {
+		if err := p.killRulesMap.Put(key, rule); err != nil {
+			seclog.Warnf("failed to add the kernel kill rule of `%s`: %s", key.basename, err)
+			delete(killRules, key)
+		}
+	}
+
+	p.kernelKillRules = killRules
+}
+
 // ApplyRuleSet apply the required update to handle the new ruleset
 func (p *EBPFProbe) ApplyRuleSet(rs *rules.RuleSet) (*kfilters.ApplyRuleSetReport, error) {
 	if p.opts.SyscallsMonitorEnabled {
@@ -1491,6 +1643,15 @@ func (p *EBPFProbe) ApplyRuleSet(rs *rules.RuleSet) (*kfilters.ApplyRuleSetRepor
 		}
 	}
 
+	fingerprints := getDiscardersFingerprints(rs)
+	for eventType, fingerprint := range fingerprints {
+		// the discarders of the removed event types remain valid, less rules can only discard more
+		if previous, exists := p.discardersFingerprints[eventType]; !exists || previous != fingerprint {
+			p.staleDiscarderEventTypes = append(p.staleDiscarderEventTypes, config.ParseEvalEventType(eventType))
+		}
+	}
+	p.discardersFingerprints = fingerprints
+
 	eventTypes := rs.GetEventTypes()
 
 	// activity dump & security profiles
@@ -1517,6 +1678,20 @@ func (p *EBPFProbe) ApplyRuleSet(rs *rules.RuleSet) (*kfilters.ApplyRuleSetRepor
 		return nil, fmt.Errorf("failed to select probes: %w", err)
 	}
 
+	if p.config.RuntimeSecurity.EnforcementEnabled && p.supportsBPFSendSignal {
+		p.applyKernelKillRules(getKernelKillRules(rs))
+	}
+
+	if p.config.Probe.SyscallCtxRulesOnly {
+		syscallCtxEventsMap, err := managerhelper.Map(p.Manager, "syscall_ctx_events")
+		if err != nil {
+			return nil, err
+		}
+		if err := syscallCtxEventsMap.Put(ebpf.ZeroUint32MapItem, getSyscallCtxEventMask(rs)); err != nil {
+			return nil, fmt.Errorf("failed to set the syscall context event types: %w", err)
+		}
+	}
+
 	if p.opts.SyscallsMonitorEnabled {
 		if err := p.monitors.syscallsMonitor.Flush(); err != nil {
 			return nil, err
@@ -1544,6 +1719,55 @@ func (p *EBPFProbe) DumpProcessCache(withArgs bool) (string, error) {
 	return p.Resolvers.ProcessResolver.ToDot(withArgs)
 }
 
+// getEventsStatsSamplingMask returns the mask applied to the event timestamps to sample the kernel events statistics
+func getEventsStatsSamplingMask(samplingRate int) uint64 {
+	if samplingRate <= 1 {
+		return 0
+	}
+	return uint64(1)<<bits.Len(uint(samplingRate-1)) - 1
+}
+
+// getSpanEventMask returns the mask of the event types the span context is captured for, 0 standing for all of them
+func getSpanEventMask(eventTypes []string) uint64 {
+	var mask uint64
+	for _, eventType := range eventTypes {
+		evt := config.ParseEvalEventType(eventType)
+		if evt == model.UnknownEventType || evt >= model.MaxKernelEventType {
+			seclog.Warnf("unknown span event type `%s`", eventType)
+			continue
+		}
+		mask |= 1 << (evt - model.FirstDiscarderEventType)
+	}
+	return mask
+}
+
+// getSyscallCtxEventMask returns the mask of the event types whose syscall context is referenced by the rules
+func getSyscallCtxEventMask(rs *rules.RuleSet) uint64 {
+	var mask uint64
+	for _, eventType := range rs.GetEventTypes() {
+		bucket := rs.GetBucket(eventType)
+		if bucket == nil {
+			continue
+		}
+
+		evt := config.ParseEvalEventType(eventType)
+		if evt == model.UnknownEventType || evt >= model.MaxKernelEventType {
+			continue
+		}
+
+	RULES:
+		for _, rule := range bucket.GetRules() {
+			for _, field := range rule.GetEvaluator().GetFields() {
+				if strings.HasPrefix(field, eventType+".syscall.") {
+					mask |= 1 << (evt - model.FirstDiscarderEventType)
+					break RULES
+				}
+			}
+		}
+	}
+	return mask
+}
+
 // NewEBPFProbe instantiates a new runtime security agent probe
 func NewEBPFProbe(probe *Probe, config *config.Config, opts Opts, wmeta optional.Option[workloadmeta.Component]) (*EBPFProbe, error) {
 	nerpc, err := erpc.NewERPC()
@@ -1590,9 +1814,12 @@ func NewEBPFProbe(probe *Probe, config *config.Config, opts Opts, wmeta optional
 	p.selectFentryMode()
 
 	useRingBuffers := p.UseRingBuffers()
+	usePriorityRingBuffer := useRingBuffers && config.Probe.EventStreamPriorityBufferSize > 0
 	useMmapableMaps := p.kernelVersion.HaveMmapableMaps()
+	// the task storage is only used by the fentry programs, which always come with BTF
+	useTaskStorage := p.useFentry && p.kernelVersion.HaveTaskStorageSupport()
 
-	p.Manager = ebpf.NewRuntimeSecurityManager(useRingBuffers, p.useFentry)
+	p.Manager = ebpf.NewRuntimeSecurityManager(useRingBuffers, usePriorityRingBuffer, p.useFentry)
 
 	p.supportsBPFSendSignal = p.kernelVersion.SupportBPFSendSignal()
 
@@ -1610,8 +1837,11 @@ func NewEBPFProbe(probe *Probe, config *config.Config, opts Opts, wmeta optional
 		UseRingBuffers:          useRingBuffers,
 		UseMmapableMaps:         useMmapableMaps,
 		RingBufferSize:          uint32(config.Probe.EventStreamBufferSize),
+		PriorityRingBufferSize:  uint32(config.Probe.EventStreamPriorityBufferSize),
 		PathResolutionEnabled:   probe.Opts.PathResolutionEnabled,
 		SecurityProfileMaxCount: config.RuntimeSecurity.SecurityProfileMaxCount,
+		UseFentry:               p.useFentry,
+		UseTaskStorage:          useTaskStorage,
 	})
 
 	if config.RuntimeSecurity.ActivityDumpEnabled {
@@ -1695,10 +1925,18 @@ func NewEBPFProbe(probe *Probe, config *config.Config, opts Opts, wmeta optional
 			Name:  "check_helper_call_input",
 			Value: getCheckHelperCallInputType(p.kernelVersion),
 		},
+		manager.ConstantEditor{
+			Name:  "activity_dumps_enabled",
+			Value: utils.BoolTouint64(config.RuntimeSecurity.ActivityDumpEnabled),
+		},
 		manager.ConstantEditor{
 			Name:  "cgroup_activity_dumps_enabled",
 			Value: utils.BoolTouint64(config.RuntimeSecurity.ActivityDumpEnabled && areCGroupADsEnabled),
 		},
+		manager.ConstantEditor{
+			Name:  "activity_dump_cgroup_only",
+			Value: utils.BoolTouint64(config.RuntimeSecurity.ActivityDumpCgroupOnly),
+		},
 		manager.ConstantEditor{
 			Name:  "net_struct_type",
 			Value: getNetStructType(p.kernelVersion),
@@ -1723,6 +1961,26 @@ func NewEBPFProbe(probe *Probe, config *config.Config, opts Opts, wmeta optional
 			Name:  "imds_ip",
 			Value: uint64(config.RuntimeSecurity.IMDSIPv4),
 		},
+		manager.ConstantEditor{
+			Name:  "dns_dedup_window",
+			Value: uint64((time.Duration(config.Probe.NetworkDNSDedupWindow) * time.Millisecond).Nanoseconds()),
+		},
+		manager.ConstantEditor{
+			Name:  "setxattr_dedup_window",
+			Value: uint64((time.Duration(config.Probe.SetXattrDedupWindow) * time.Millisecond).Nanoseconds()),
+		},
+		manager.ConstantEditor{
+			Name:  "credentials_dedup",
+			Value: utils.BoolTouint64(config.Probe.CredentialsDedup),
+		},
+		manager.ConstantEditor{
+			Name:  "syscall_ctx_rules_only",
+			Value: utils.BoolTouint64(config.Probe.SyscallCtxRulesOnly),
+		},
+		manager.ConstantEditor{
+			Name:  "span_event_mask",
+			Value: getSpanEventMask(config.Probe.SpanEventTypes),
+		},
 	)
 
 	p.managerOptions.ConstantEditors = append(p.managerOptions.ConstantEditors, DiscarderConstants...)
@@ -1733,6 +1991,46 @@ func NewEBPFProbe(probe *Probe, config *config.Config, opts Opts, wmeta optional
 			Name:  "use_ring_buffer",
 			Value: utils.BoolTouint64(useRingBuffers),
 		},
+		manager.ConstantEditor{
+			Name:  "events_stats_sampling_mask",
+			Value: getEventsStatsSamplingMask(config.Probe.StatsSamplingRate),
+		},
+		manager.ConstantEditor{
+			Name:  "use_priority_ring_buffer",
+			Value: utils.BoolTouint64(usePriorityRingBuffer),
+		},
+		manager.ConstantEditor{
+			Name:  "args_envs_batched",
+			Value: utils.BoolTouint64(useRingBuffers && config.Probe.EventStreamBatchArgsEnvs),
+		},
+		manager.ConstantEditor{
+			Name:  "use_syscall_task_storage",
+			Value: utils.BoolTouint64(useTaskStorage),
+		},
+		manager.ConstantEditor{
+			Name:  "use_process_task_storage",
+			Value: utils.BoolTouint64(useTaskStorage),
+		},
+		manager.ConstantEditor{
+			Name:  "discarder_probation_threshold",
+			Value: getDiscarderProbationThreshold(config.Probe),
+		},
+		manager.ConstantEditor{
+			Name:  "discarder_probation_window",
+			Value: uint64((time.Duration(config.Probe.DiscarderProbationWindow) * time.Millisecond).Nanoseconds()),
+		},
+		manager.ConstantEditor{
+			Name:  "jit_mprotect_threshold",
+			Value: uint64(config.Probe.JITMProtectThreshold),
+		},
+		manager.ConstantEditor{
+			Name:  "jit_mprotect_summary_period",
+			Value: uint64((time.Duration(config.Probe.JITMProtectSummaryPeriod) * time.Millisecond).Nanoseconds()),
+		},
+		manager.ConstantEditor{
+			Name:  "envs_filter_enabled",
+			Value: utils.BoolTouint64(len(config.Probe.EnvsPrefixFilter) > 0),
+		},
 	)
 
 	if p.kernelVersion.HavePIDLinkStruct() {
@@ -1765,6 +2063,10 @@ func NewEBPFProbe(probe *Probe, config *config.Config, opts Opts, wmeta optional
 		p.managerOptions.ExcludedFunctions = append(p.managerOptions.ExcludedFunctions, probes.GetAllTCProgramFunctions()...)
 	}
 
+	if p.useFentry && (!config.Probe.DPathDentryResolutionEnabled || !p.kernelVersion.HaveDPathHelper()) {
+		p.managerOptions.ExcludedFunctions = append(p.managerOptions.ExcludedFunctions, probes.DPathProgramFunction)
+	}
+
 	if p.useFentry {
 		afBasedExcluder, err := newAvailableFunctionsBasedExcluder()
 		if err != nil {
@@ -1790,9 +2092,10 @@ func NewEBPFProbe(probe *Probe, config *config.Config, opts Opts, wmeta optional
 	p.fieldHandlers = &EBPFFieldHandlers{config: config, resolvers: p.Resolvers}
 
 	if useRingBuffers {
-		p.eventStream = ringbuffer.New(p.handleEvent)
+		p.eventStream = ringbuffer.New(p.ctx, p.handleEvent)
 		p.managerOptions.SkipRingbufferReaderStartup = map[string]bool{
-			eventstream.EventStreamMap: true,
+			eventstream.EventStreamMap:         true,
+			eventstream.EventStreamPriorityMap: true,
 		}
 	} else {
 		p.eventStream, err = reorderer.NewOrderedPerfMap(p.ctx, p.handleEvent, probe.StatsdClient)
@@ -2030,6 +2333,12 @@ func AppendProbeRequestsToFetcher(constantFetcher constantfetch.ConstantFetcher,
 func (p *EBPFProbe) HandleActions(ctx *eval.Context, rule *rules.Rule) {
 	ev := ctx.Event.(*model.Event)
 
+	if p.config.Probe.DiscarderProbationThreshold > 0 {
+		if err := rejectDiscarderProbation(p.Erpc, ev); err != nil {
+			seclog.Debugf("failed to reject the discarder probation: %v", err)
+		}
+	}
+
 	for _, action := range rule.Definition.Actions {
 		if !action.IsAccepted(ctx) {
 			continue
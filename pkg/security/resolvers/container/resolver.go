@@ -9,14 +9,94 @@
 package container
 
 import (
+	"sync"
+
+	manager "github.com/DataDog/ebpf-manager"
+	lib "github.com/cilium/ebpf"
+	"github.com/hashicorp/golang-lru/v2/simplelru"
+
+	"github.com/DataDog/datadog-agent/pkg/security/probe/managerhelper"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/model"
 	"github.com/DataDog/datadog-agent/pkg/security/utils"
 )
 
+const containerIDsCacheSize = 1024 // see kernel definition of container_ids
+
 // Resolver is used to resolve the container context of the events
-type Resolver struct{}
+type Resolver struct {
+	sync.Mutex
+	containerIDsMap *lib.Map
+	containerIDs    *simplelru.LRU[uint64, string]
+}
 
 // GetContainerID returns the container id of the given pid
 func (cr *Resolver) GetContainerID(pid uint32) (utils.ContainerID, error) {
 	// Parse /proc/[pid]/task/[pid]/cgroup
 	return utils.GetProcContainerID(pid, pid)
 }
+
+// Start the container resolver
+func (cr *Resolver) Start(manager *manager.Manager) error {
+	containerIDsMap, err := managerhelper.Map(manager, "container_ids")
+	if err != nil {
+		return err
+	}
+
+	containerIDs, err := simplelru.NewLRU[uint64, string](containerIDsCacheSize, nil)
+	if err != nil {
+		return err
+	}
+
+	cr.Lock()
+	defer cr.Unlock()
+
+	cr.containerIDsMap = containerIDsMap
+	cr.containerIDs = containerIDs
+	return nil
+}
+
+// AddContainerID registers the key of a container ID that the kernel did not parse itself
+func (cr *Resolver) AddContainerID(id string) {
+	key := model.ContainerKey(id)
+	if key == 0 {
+		return
+	}
+
+	cr.Lock()
+	defer cr.Unlock()
+
+	if cr.containerIDs != nil {
+		cr.containerIDs.Add(key, id)
+	}
+}
+
+// ResolveContainerKey returns the container ID of the key sent with the events
+func (cr *Resolver) ResolveContainerKey(key uint64) string {
+	if key == 0 {
+		return ""
+	}
+
+	cr.Lock()
+	defer cr.Unlock()
+
+	if cr.containerIDs == nil {
+		return ""
+	}
+
+	if id, ok := cr.containerIDs.Get(key); ok {
+		return id
+	}
+
+	var raw [model.ContainerIDLen]byte
+	if err := cr.containerIDsMap.Lookup(key, &raw); err != nil {
+		return ""
+	}
+
+	id, err := model.UnmarshalString(raw[:], model.ContainerIDLen)
+	if err != nil || id == "" {
+		return ""
+	}
+	cr.containerIDs.Add(key, id)
+
+	return id
+}
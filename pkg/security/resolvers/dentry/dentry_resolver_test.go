@@ -9,9 +9,13 @@
 package dentry
 
 import (
+	"encoding/binary"
 	"testing"
 
 	"github.com/stretchr/testify/assert"
+
+	"github.com/DataDog/datadog-agent/pkg/security/probe/config"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/model"
 )
 
 func TestComputeFilenameFromParts(t *testing.T) {
@@ -44,3 +48,46 @@ func TestComputeFilenameFromParts(t *testing.T) {
 		})
 	}
 }
+
+// writeERPCSegment writes the given entries as the kernel does in response to an eRPC request
+func writeERPCSegment(segment []byte, challenge uint32, keys []model.PathKey, names []string) {
+	i := 0
+	for n, key := range keys {
+		binary.NativeEndian.PutUint64(segment[i:i+8], key.Inode)
+		binary.NativeEndian.PutUint32(segment[i+8:i+12], key.MountID)
+		binary.NativeEndian.PutUint32(segment[i+12:i+16], challenge)
+		i += 16
+		i += copy(segment[i:], names[n])
+		segment[i] = 0
+		i++
+	}
+}
+
+func TestResolveFromERPCSegment(t *testing.T) {
+	dr, err := NewResolver(&config.Config{DentryCacheSize: 16}, nil, nil)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	keys := []model.PathKey{{Inode: 3, MountID: 1}, {Inode: 2, MountID: 1}, {Inode: 1, MountID: 1}}
+	names := []string{"b", "a", "/"}
+
+	// each path of a batch request is written in its own slot
+	segment := make([]byte, 2*128)
+	writeERPCSegment(segment[128:], 42, keys, names)
+
+	t.Run("resolved", func(t *testing.T) {
+		path, err := dr.resolveFromERPCSegment(segment[128:], 42, true)
+		assert.NoError(t, err)
+		assert.Equal(t, "/a/b", path)
+
+		entry, err := dr.lookupInodeFromCache(keys[0])
+		assert.NoError(t, err)
+		assert.Equal(t, PathEntry{Parent: keys[1], Name: "b"}, entry)
+	})
+
+	t.Run("not-processed", func(t *testing.T) {
+		_, err := dr.resolveFromERPCSegment(segment[:128], 42, true)
+		assert.ErrorIs(t, err, errERPCRequestNotProcessed)
+	})
+}
@@ -40,6 +40,9 @@ var (
 	fakeInodeMSW = uint64(0xdeadc001)
 )
 
+// erpcMaxBatch is the number of paths resolved by a batch eRPC request, see DR_ERPC_MAX_BATCH
+const erpcMaxBatch = 8
+
 type counterEntry struct {
 	resolutionType string
 	resolution     string
@@ -63,6 +66,7 @@ type Resolver struct {
 	erpcSegmentSize       int
 	useBPFProgWriteUser   bool
 	erpcRequest           *erpc.Request
+	erpcBatchRequest      *erpc.Request
 	erpcStatsZero         []eRPCStats
 	numCPU                int
 	challenge             uint32
@@ -71,6 +75,7 @@ type Resolver struct {
 	filenameParts    []string
 	keys             []model.PathKey
 	cacheNameEntries []string
+	batchKeys        []model.PathKey
 
 	hitsCounters map[counterEntry]*atomic.Int64
 	missCounters map[counterEntry]*atomic.Int64
@@ -465,6 +470,27 @@ func (dr *Resolver) requestResolve(op uint8, pathKey model.PathKey) (uint32, err
 	return challenge, dr.erpc.Request(dr.erpcRequest)
 }
 
+// requestResolveBatch resolves the paths of up to erpcMaxBatch keys with a single eRPC request, the path of the n-th
+// key being written in the n-th slot of the segment.
+func (dr *Resolver) requestResolveBatch(pathKeys []model.PathKey) (uint32, error) {
+	challenge := dr.challenge
+	dr.challenge++
+
+	// 0-12 populated at start
+	binary.NativeEndian.PutUint32(dr.erpcBatchRequest.Data[12:16], challenge)
+	binary.NativeEndian.PutUint32(dr.erpcBatchRequest.Data[16:20], uint32(len(pathKeys)))
+	for i := range pathKeys {
+		pathKeys[i].Write(dr.erpcBatchRequest.Data[24+i*model.PathKeySize:])
+	}
+
+	// if we don't try to access the segment, the eBPF program can't write to it ... (major page fault)
+	if dr.useBPFProgWriteUser {
+		dr.preventSegmentMajorPageFault()
+	}
+
+	return challenge, dr.erpc.Request(dr.erpcBatchRequest)
+}
+
 func (dr *Resolver) cacheEntries(keys []model.PathKey, names []string) error {
 	if len(keys) != len(names) {
 		return errors.New("out of bound")
@@ -484,19 +510,19 @@ func (dr *Resolver) cacheEntries(keys []model.PathKey, names []string) error {
 	return nil
 }
 
-func (dr *Resolver) computeSegmentCount() int {
+func computeSegmentCount(segment []byte) int {
 	count := 0
 	i := 0
-	for i < dr.erpcSegmentSize {
+	for i < len(segment) {
 		i += 16 // skip the path key
 
-		if i < dr.erpcSegmentSize {
-			if dr.erpcSegment[i] == '/' {
+		if i < len(segment) {
+			if segment[i] == '/' {
 				break
 			}
 
 			// skip the segment
-			i += bytes.IndexByte(dr.erpcSegment[i:], 0)
+			i += bytes.IndexByte(segment[i:], 0)
 		}
 
 		i++ // skip the null terminator
@@ -507,9 +533,6 @@ func (dr *Resolver) computeSegmentCount() int {
 
 // ResolveFromERPC resolves the path of the provided inode / mount id / path id
 func (dr *Resolver) ResolveFromERPC(pathKey model.PathKey, cache bool) (string, error) {
-	var resolutionErr error
-	depth := int64(0)
-
 	entry := counterEntry{
 		resolutionType: metrics.ERPCTag,
 		resolution:     metrics.PathResolutionTag,
@@ -522,20 +545,70 @@ func (dr *Resolver) ResolveFromERPC(pathKey model.PathKey, cache bool) (string,
 		return "", fmt.Errorf("unable to resolve the path of mountID `%d` and inode `%d` with eRPC: %w", pathKey.MountID, pathKey.Inode, err)
 	}
 
-	segmentCount := dr.computeSegmentCount()
+	return dr.resolveFromERPCSegment(dr.erpcSegment, challenge, cache)
+}
+
+// Prefetch resolves the paths of the provided keys which are not in the cache, in batches of erpcMaxBatch paths per
+// eRPC request. The next resolutions of these paths are then served by the cache.
+func (dr *Resolver) Prefetch(pathKeys ...model.PathKey) {
+	if !dr.config.ERPCDentryResolutionEnabled {
+		return
+	}
+
+	dr.batchKeys = dr.batchKeys[:0]
+	for _, pathKey := range pathKeys {
+		if pathKey.Inode == 0 || IsFakeInode(pathKey.Inode) {
+			continue
+		}
+		if _, err := dr.lookupInodeFromCache(pathKey); err == nil {
+			continue
+		}
+		dr.batchKeys = append(dr.batchKeys, pathKey)
+	}
+
+	slotSize := dr.erpcSegmentSize / erpcMaxBatch
+	for len(dr.batchKeys) > 0 {
+		batch := dr.batchKeys[:min(len(dr.batchKeys), erpcMaxBatch)]
+		dr.batchKeys = dr.batchKeys[len(batch):]
+
+		challenge, err := dr.requestResolveBatch(batch)
+		if err != nil {
+			return
+		}
+
+		// the paths which couldn't be resolved are left to the regular resolution
+		for i := range batch {
+			_, _ = dr.resolveFromERPCSegment(dr.erpcSegment[i*slotSize:(i+1)*slotSize], challenge, true)
+		}
+	}
+}
+
+// resolveFromERPCSegment parses the path written by the kernel in the provided segment in response to the eRPC request
+// of the provided challenge
+func (dr *Resolver) resolveFromERPCSegment(segment []byte, challenge uint32, cache bool) (string, error) {
+	var resolutionErr error
+	var pathKey model.PathKey
+	depth := int64(0)
+
+	entry := counterEntry{
+		resolutionType: metrics.ERPCTag,
+		resolution:     metrics.PathResolutionTag,
+	}
+
+	segmentCount := computeSegmentCount(segment)
 	dr.prepareBuffersWithCapacity(segmentCount)
 
 	i := 0
 	// make sure that we keep room for at least one pathKey + character + \0 => (sizeof(pathID) + 1 = 17)
-	for i < dr.erpcSegmentSize-17 {
+	for i < len(segment)-17 {
 		depth++
 
 		// parse the path_key_t structure
-		pathKey.Inode = binary.NativeEndian.Uint64(dr.erpcSegment[i : i+8])
-		pathKey.MountID = binary.NativeEndian.Uint32(dr.erpcSegment[i+8 : i+12])
+		pathKey.Inode = binary.NativeEndian.Uint64(segment[i : i+8])
+		pathKey.MountID = binary.NativeEndian.Uint32(segment[i+8 : i+12])
 
 		// check challenge
-		if challenge != binary.NativeEndian.Uint32(dr.erpcSegment[i+12:i+16]) {
+		if challenge != binary.NativeEndian.Uint32(segment[i+12:i+16]) {
 			if depth >= model.MaxPathDepth {
 				resolutionErr = errTruncatedParentsERPC
 				break
@@ -547,7 +620,7 @@ func (dr *Resolver) ResolveFromERPC(pathKey model.PathKey, cache bool) (string,
 		// skip PathID
 		i += 16
 
-		if dr.erpcSegment[i] == 0 {
+		if segment[i] == 0 {
 			if depth >= model.MaxPathDepth {
 				resolutionErr = errTruncatedParentsERPC
 			} else {
@@ -556,17 +629,17 @@ func (dr *Resolver) ResolveFromERPC(pathKey model.PathKey, cache bool) (string,
 			break
 		}
 
-		if dr.erpcSegment[i] == '/' {
+		if segment[i] == '/' {
 			break
 		}
 
-		segment := model.NullTerminatedString(dr.erpcSegment[i:])
-		dr.filenameParts = append(dr.filenameParts, segment)
-		i += len(segment) + 1
+		name := model.NullTerminatedString(segment[i:])
+		dr.filenameParts = append(dr.filenameParts, name)
+		i += len(name) + 1
 
 		if !IsFakeInode(pathKey.Inode) && cache {
 			dr.keys = append(dr.keys, pathKey)
-			dr.cacheNameEntries = append(dr.cacheNameEntries, segment)
+			dr.cacheNameEntries = append(dr.cacheNameEntries, name)
 		}
 	}
 
@@ -720,10 +793,12 @@ func (dr *Resolver) Start(manager *manager.Manager) error {
 		dr.useBPFProgWriteUser = true
 
 		binary.NativeEndian.PutUint64(dr.erpcRequest.Data[16:24], uint64(uintptr(unsafe.Pointer(&dr.erpcSegment[0]))))
+		binary.NativeEndian.PutUint64(dr.erpcBatchRequest.Data[0:8], uint64(uintptr(unsafe.Pointer(&dr.erpcSegment[0]))))
 	}
 
 	dr.erpcSegmentSize = len(dr.erpcSegment)
 	binary.NativeEndian.PutUint32(dr.erpcRequest.Data[24:28], uint32(dr.erpcSegmentSize))
+	binary.NativeEndian.PutUint32(dr.erpcBatchRequest.Data[8:12], uint32(dr.erpcSegmentSize))
 
 	return nil
 }
@@ -804,15 +879,16 @@ func NewResolver(config *config.Config, statsdClient statsd.ClientInterface, e *
 	}
 
 	return &Resolver{
-		config:        config,
-		statsdClient:  statsdClient,
-		cache:         make(map[uint32]*lru.Cache[model.PathKey, PathEntry]),
-		erpc:          e,
-		erpcRequest:   erpc.NewERPCRequest(0),
-		erpcStatsZero: make([]eRPCStats, numCPU),
-		hitsCounters:  hitsCounters,
-		missCounters:  missCounters,
-		numCPU:        numCPU,
-		challenge:     rand.Uint32(),
+		config:           config,
+		statsdClient:     statsdClient,
+		cache:            make(map[uint32]*lru.Cache[model.PathKey, PathEntry]),
+		erpc:             e,
+		erpcRequest:      erpc.NewERPCRequest(0),
+		erpcBatchRequest: erpc.NewERPCRequest(erpc.ResolvePathsOp),
+		erpcStatsZero:    make([]eRPCStats, numCPU),
+		hitsCounters:     hitsCounters,
+		missCounters:     missCounters,
+		numCPU:           numCPU,
+		challenge:        rand.Uint32(),
 	}, nil
 }
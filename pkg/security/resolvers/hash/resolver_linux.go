@@ -81,6 +81,36 @@ type LRUCacheKey struct {
 	containerID string
 	inode       uint64
 	pathID      uint32
+	mountID     uint32
+	mtime       uint64
+	ctime       uint64
+}
+
+// newLRUCacheKey returns the cache key of a file. A file whose mount and modification time are known is identified by
+// its mount, inode, modification and change times: its hashes are shared by all the paths and containers it is
+// accessed from, such as a kernel module loaded several times, and computed again once it is modified.
+func newLRUCacheKey(process *model.Process, file *model.FileEvent) LRUCacheKey {
+	if file.MountID != 0 && file.MTime != 0 {
+		return LRUCacheKey{
+			inode:   file.Inode,
+			mountID: file.MountID,
+			mtime:   file.MTime,
+			ctime:   file.CTime,
+		}
+	}
+
+	return LRUCacheKey{
+		path:        file.PathnameStr,
+		containerID: process.ContainerID,
+		inode:       file.Inode,
+		pathID:      file.PathKey.PathID,
+	}
+}
+
+// isFileIdentity returns true if the key identifies the content of the file rather than one of its paths. The
+// outcome of hashing such a file never changes, even when no hash could be computed because of its size.
+func (k LRUCacheKey) isFileIdentity() bool {
+	return k.path == ""
 }
 
 // LRUCacheEntry is the structure used to cache hashes
@@ -232,12 +262,7 @@ func (resolver *Resolver) hash(eventType model.EventType, process *model.Process
 	}
 
 	// check if the hash(es) of this file is in cache
-	fileKey := LRUCacheKey{
-		path:        file.PathnameStr,
-		containerID: process.ContainerID,
-		inode:       file.Inode,
-		pathID:      file.PathKey.PathID,
-	}
+	fileKey := newLRUCacheKey(process, file)
 	if resolver.cache != nil {
 		cacheEntry, ok := resolver.cache.Get(fileKey)
 		if ok {
@@ -300,6 +325,7 @@ func (resolver *Resolver) hash(eventType model.EventType, process *model.Process
 	if size > resolver.opts.MaxFileSize {
 		resolver.hashMiss[eventType][model.FileTooBig].Inc()
 		file.HashState = model.FileTooBig
+		resolver.cacheFailure(fileKey, model.FileTooBig)
 		return
 	}
 
@@ -307,6 +333,7 @@ func (resolver *Resolver) hash(eventType model.EventType, process *model.Process
 	if size == 0 {
 		resolver.hashMiss[eventType][model.FileEmpty].Inc()
 		file.HashState = model.FileEmpty
+		resolver.cacheFailure(fileKey, model.FileEmpty)
 		return
 	}
 
@@ -333,6 +360,7 @@ func (resolver *Resolver) hash(eventType model.EventType, process *model.Process
 		if errors.Is(err, ErrSizeLimitReached) {
 			resolver.hashMiss[eventType][model.FileTooBig].Inc()
 			file.HashState = model.FileTooBig
+			resolver.cacheFailure(fileKey, model.FileTooBig)
 			return
 		}
 		// We can't read this file, most likely because it isn't a regular file (despite the check above). Example seen
@@ -378,6 +406,15 @@ func (resolver *Resolver) hash(eventType model.EventType, process *model.Process
 	}
 }
 
+// cacheFailure caches a hashing failure which depends only on the content of the file, so that binaries too big to be
+// hashed aren't opened again on each execution.
+func (resolver *Resolver) cacheFailure(fileKey LRUCacheKey, state model.HashState) {
+	if resolver.cache == nil || !fileKey.isFileIdentity() {
+		return
+	}
+	resolver.cache.Add(fileKey, &LRUCacheEntry{state: state})
+}
+
 // SendStats sends the resolver metrics
 func (resolver *Resolver) SendStats() error {
 	if !resolver.opts.Enabled {
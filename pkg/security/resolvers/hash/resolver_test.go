@@ -527,3 +527,71 @@ func BenchmarkHashFunctions(b *testing.B) {
 		b.Errorf("couldn't delete benchmark file: %v", err)
 	}
 }
+
+func TestNewLRUCacheKey(t *testing.T) {
+	newFile := func(path string, mtime uint64) *model.FileEvent {
+		file := &model.FileEvent{PathnameStr: path}
+		file.Inode = 42
+		file.MountID = 7
+		file.MTime = mtime
+		file.CTime = mtime
+		return file
+	}
+
+	hostModule := newLRUCacheKey(&model.Process{}, newFile("/lib/modules/nf_tables.ko", 1000))
+	containerModule := newLRUCacheKey(&model.Process{ContainerID: "abc"}, newFile("/host/lib/modules/nf_tables.ko", 1000))
+	assert.Equal(t, hostModule, containerModule, "the same file should share its cache entry")
+
+	modified := newLRUCacheKey(&model.Process{}, newFile("/lib/modules/nf_tables.ko", 2000))
+	assert.NotEqual(t, hostModule, modified, "a modified file should be hashed again")
+
+	noMetadata := newLRUCacheKey(&model.Process{}, newFile("/lib/modules/nf_tables.ko", 0))
+	noMetadataInContainer := newLRUCacheKey(&model.Process{ContainerID: "abc"}, newFile("/lib/modules/nf_tables.ko", 0))
+	assert.NotEqual(t, noMetadata, noMetadataInContainer, "the files without metadata should be keyed by path and container")
+}
+
+func TestResolver_CacheFailures(t *testing.T) {
+	resolver, err := NewResolver(&config.RuntimeSecurityConfig{
+		HashResolverEnabled:        true,
+		HashResolverEventTypes:     []model.EventType{model.ExecEventType},
+		HashResolverHashAlgorithms: []model.HashAlgorithm{model.SHA1},
+		HashResolverMaxHashRate:    10,
+		HashResolverMaxHashBurst:   10,
+		HashResolverMaxFileSize:    4,
+		HashResolverCacheSize:      10,
+	}, statsdclient.NewStatsdClient(), nil)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	if err := os.WriteFile("/tmp/hash_test_too_big", generateFileData(10), 0666); err != nil {
+		t.Fatal(err)
+	}
+	defer os.Remove("/tmp/hash_test_too_big")
+
+	process := &model.Process{PIDContext: model.PIDContext{Pid: uint32(os.Getpid())}}
+	newFile := func(mtime uint64) *model.FileEvent {
+		file := &model.FileEvent{
+			PathnameStr:           "/tmp/hash_test_too_big",
+			IsPathnameStrResolved: true,
+		}
+		file.Inode = 42
+		file.MountID = 7
+		file.MTime = mtime
+		return file
+	}
+
+	resolver.ComputeHashes(model.ExecEventType, process, newFile(1000))
+	assert.Equal(t, uint64(1), resolver.hashMiss[model.ExecEventType][model.FileTooBig].Load())
+
+	file := newFile(1000)
+	resolver.ComputeHashes(model.ExecEventType, process, file)
+	assert.Equal(t, model.FileTooBig, file.HashState)
+	assert.Equal(t, uint64(1), resolver.hashCacheHit[model.ExecEventType].Load(), "the failure should be cached")
+
+	file = newFile(0)
+	resolver.ComputeHashes(model.ExecEventType, process, file)
+	resolver.ComputeHashes(model.ExecEventType, process, newFile(0))
+	assert.Equal(t, model.FileTooBig, file.HashState)
+	assert.Equal(t, uint64(1), resolver.hashCacheHit[model.ExecEventType].Load(), "the failures of files without metadata shouldn't be cached")
+}
@@ -35,6 +35,8 @@ const (
 	numAllowedMountIDsToResolvePerPeriod = 5
 	fallbackLimiterPeriod                = time.Second
 	redemptionTime                       = 2 * time.Second
+	mountNamespacesCacheSize             = 1024
+	mountNamespaceSyncPeriod             = 30 * time.Second
 )
 
 type redemptionEntry struct {
@@ -42,6 +44,12 @@ type redemptionEntry struct {
 	insertedAt time.Time
 }
 
+// mountNamespace holds the mounts parsed from the mountinfo file of a process of a mount namespace
+type mountNamespace struct {
+	mountIDs []uint32
+	syncedAt time.Time
+}
+
 // newMountFromMountInfo - Creates a new Mount from parsed MountInfo data
 func newMountFromMountInfo(mnt *mountinfo.Info) *model.Mount {
 	root := mnt.Root
@@ -91,6 +99,7 @@ type Resolver struct {
 	minMountID      uint32 // used to find the first userspace visible mount ID
 	redemption      *simplelru.LRU[uint32, *redemptionEntry]
 	fallbackLimiter *utils.Limiter[uint64]
+	mountNamespaces *simplelru.LRU[uint32, *mountNamespace]
 
 	// stats
 	cacheHitsStats *atomic.Int64
@@ -132,12 +141,29 @@ func (mr *Resolver) SyncCache(pid uint32) error {
 }
 
 func (mr *Resolver) syncPid(pid uint32) error {
+	// all the processes of a mount namespace share the same mountinfo, parse it once per namespace. The mounts created
+	// after the parsing are inserted from the kernel events.
+	mntNS, nsErr := utils.GetProcessMountNamespace(pid)
+	if nsErr == nil {
+		if ns, exists := mr.mountNamespaces.Get(mntNS); exists && time.Since(ns.syncedAt) < mountNamespaceSyncPeriod {
+			for _, mountID := range ns.mountIDs {
+				if m, ok := mr.mounts[mountID]; ok {
+					mr.updatePidMapping(m, pid)
+				}
+			}
+			return nil
+		}
+	}
+
 	mnts, err := kernel.ParseMountInfoFile(int32(pid))
 	if err != nil {
 		return err
 	}
 
+	mountIDs := make([]uint32, 0, len(mnts))
 	for _, mnt := range mnts {
+		mountIDs = append(mountIDs, uint32(mnt.ID))
+
 		if m, exists := mr.mounts[uint32(mnt.ID)]; exists {
 			mr.updatePidMapping(m, pid)
 			continue
@@ -147,6 +173,13 @@ func (mr *Resolver) syncPid(pid uint32) error {
 		mr.insert(m, pid)
 	}
 
+	if nsErr == nil {
+		mr.mountNamespaces.Add(mntNS, &mountNamespace{
+			mountIDs: mountIDs,
+			syncedAt: time.Now(),
+		})
+	}
+
 	return nil
 }
 
@@ -655,5 +688,11 @@ func NewResolver(statsdClient statsd.ClientInterface, cgroupsResolver *cgroup.Re
 	}
 	mr.fallbackLimiter = limiter
 
+	mountNamespaces, err := simplelru.NewLRU[uint32, *mountNamespace](mountNamespacesCacheSize, nil)
+	if err != nil {
+		return nil, err
+	}
+	mr.mountNamespaces = mountNamespaces
+
 	return mr, nil
 }
@@ -10,6 +10,7 @@ package mount
 
 import (
 	"fmt"
+	"os"
 	"testing"
 	"time"
 
@@ -17,6 +18,7 @@ import (
 
 	"github.com/DataDog/datadog-agent/pkg/security/resolvers/cgroup"
 	"github.com/DataDog/datadog-agent/pkg/security/secl/model"
+	"github.com/DataDog/datadog-agent/pkg/security/utils"
 )
 
 func TestMountResolver(t *testing.T) {
@@ -571,3 +573,35 @@ func BenchmarkGetParentPath(b *testing.B) {
 		_, _, _, _ = mr.getMountPath(100, 44, 1)
 	}
 }
+
+func TestMountNamespaceSync(t *testing.T) {
+	pid, ppid := uint32(os.Getpid()), uint32(os.Getppid())
+
+	mntNS, err := utils.GetProcessMountNamespace(pid)
+	if err != nil {
+		t.Skipf("mount namespace not available: %v", err)
+	}
+	if parentMntNS, err := utils.GetProcessMountNamespace(ppid); err != nil || parentMntNS != mntNS {
+		t.Skip("the parent process isn't in the same mount namespace")
+	}
+
+	cr, _ := cgroup.NewResolver(nil)
+	mr, _ := NewResolver(nil, cr, ResolverOpts{UseProcFS: true})
+
+	if err := mr.SyncCache(pid); err != nil {
+		t.Fatal(err)
+	}
+	ns, exists := mr.mountNamespaces.Get(mntNS)
+	if !assert.True(t, exists) {
+		return
+	}
+	syncedAt := ns.syncedAt
+
+	// the second process of the namespace reuses the parsed mounts
+	if err := mr.SyncCache(ppid); err != nil {
+		t.Fatal(err)
+	}
+	ns, _ = mr.mountNamespaces.Get(mntNS)
+	assert.Equal(t, syncedAt, ns.syncedAt)
+	assert.Equal(t, len(mr.pidToMounts[pid]), len(mr.pidToMounts[ppid]))
+}
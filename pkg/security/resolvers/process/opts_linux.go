@@ -9,6 +9,7 @@ package process
 // ResolverOpts options of resolver
 type ResolverOpts struct {
 	ttyFallbackEnabled bool
+	argsEnvsBatched    bool
 	envsWithValue      map[string]bool
 }
 
@@ -26,6 +27,12 @@ func (o *ResolverOpts) WithTTYFallbackEnabled() *ResolverOpts {
 	return o
 }
 
+// WithArgsEnvsBatched specifies that the args and envs are sent in ring buffer records larger than a single argument
+func (o *ResolverOpts) WithArgsEnvsBatched() *ResolverOpts {
+	o.argsEnvsBatched = true
+	return o
+}
+
 // NewResolverOpts returns a new set of process resolver options
 func NewResolverOpts() *ResolverOpts {
 	return &ResolverOpts{
@@ -250,10 +250,12 @@ type argsEnvsCacheEntry struct {
 
 var argsEnvsInterner = utils.NewLRUStringInterner(argsEnvsValueCacheSize)
 
-func parseStringArray(data []byte) ([]string, bool) {
+// parseStringArray parses the values sent in a chunk of at most chunkSize bytes, a full chunk holding a single value
+// which was truncated
+func parseStringArray(data []byte, chunkSize int) ([]string, bool) {
 	truncated := false
 	values, err := model.UnmarshalStringArray(data)
-	if err != nil || len(data) == model.MaxArgEnvSize {
+	if err != nil || len(data) == chunkSize {
 		if len(values) > 0 {
 			values[len(values)-1] += "..."
 		}
@@ -264,16 +266,16 @@ func parseStringArray(data []byte) ([]string, bool) {
 	return values, truncated
 }
 
-func newArgsEnvsCacheEntry(event *model.ArgsEnvsEvent) *argsEnvsCacheEntry {
-	values, truncated := parseStringArray(event.ValuesRaw[:event.Size])
+func newArgsEnvsCacheEntry(event *model.ArgsEnvsEvent, chunkSize int) *argsEnvsCacheEntry {
+	values, truncated := parseStringArray(event.ValuesRaw[:event.Size], chunkSize)
 	return &argsEnvsCacheEntry{
 		values:    values,
 		truncated: truncated,
 	}
 }
 
-func (e *argsEnvsCacheEntry) extend(event *model.ArgsEnvsEvent) {
-	values, truncated := parseStringArray(event.ValuesRaw[:event.Size])
+func (e *argsEnvsCacheEntry) extend(event *model.ArgsEnvsEvent, chunkSize int) {
+	values, truncated := parseStringArray(event.ValuesRaw[:event.Size], chunkSize)
 	if truncated {
 		e.truncated = true
 	}
@@ -282,10 +284,15 @@ func (e *argsEnvsCacheEntry) extend(event *model.ArgsEnvsEvent) {
 
 // UpdateArgsEnvs updates arguments or environment variables of the given id
 func (p *EBPFResolver) UpdateArgsEnvs(event *model.ArgsEnvsEvent) {
+	chunkSize := model.MaxArgEnvSize
+	if p.opts.argsEnvsBatched {
+		chunkSize = model.MaxArgsEnvsBatchSize
+	}
+
 	if list, found := p.argsEnvsCache.Get(event.ID); found {
-		list.extend(event)
+		list.extend(event, chunkSize)
 	} else {
-		p.argsEnvsCache.Add(event.ID, newArgsEnvsCacheEntry(event))
+		p.argsEnvsCache.Add(event.ID, newArgsEnvsCacheEntry(event, chunkSize))
 	}
 }
 
@@ -1220,8 +1227,11 @@ func (p *EBPFResolver) syncCache(proc *process.Process, filledProc *utils.Filled
 
 	bootTime := p.timeResolver.GetBootTime()
 
+	// the kernel only knows the container IDs it parsed itself, register the key of this one
+	p.containerResolver.AddContainerID(entry.ContainerID)
+
 	// insert new entry in kernel maps
-	procCacheEntryB := make([]byte, 224)
+	procCacheEntryB := make([]byte, 232)
 	_, err := entry.Process.MarshalProcCache(procCacheEntryB, bootTime)
 	if err != nil {
 		seclog.Errorf("couldn't marshal proc_cache entry: %s", err)
@@ -142,6 +142,9 @@ func NewEBPFResolvers(config *config.Config, manager *manager.Manager, statsdCli
 	if opts.TTYFallbackEnabled {
 		processOpts.WithTTYFallbackEnabled()
 	}
+	if opts.UseRingBuffer && config.Probe.EventStreamBatchArgsEnvs {
+		processOpts.WithArgsEnvsBatched()
+	}
 
 	processResolver, err := process.NewEBPFResolver(manager, config.Probe, statsdClient,
 		scrubber, containerResolver, mountResolver, cgroupsResolver, userGroupResolver, timeResolver, pathResolver, processOpts)
@@ -198,6 +201,10 @@ func (r *EBPFResolvers) Start(ctx context.Context) error {
 		return err
 	}
 
+	if err := r.ContainerResolver.Start(r.manager); err != nil {
+		return err
+	}
+
 	r.CGroupResolver.Start(ctx)
 	if r.SBOMResolver != nil {
 		r.SBOMResolver.Start(ctx)
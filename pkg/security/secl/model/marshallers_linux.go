@@ -8,6 +8,7 @@ package model
 
 import (
 	"encoding/binary"
+	"hash/fnv"
 	"math"
 	"time"
 )
@@ -84,7 +85,7 @@ func (e *Process) MarshalProcCache(data []byte, bootTime time.Time) (int, error)
 	}
 	written += toAdd
 
-	if len(data[written:]) < 88 {
+	if len(data[written:]) < 96 {
 		return 0, ErrNotEnoughSpace
 	}
 
@@ -96,9 +97,27 @@ func (e *Process) MarshalProcCache(data []byte, bootTime time.Time) (int, error)
 
 	copy(data[written:written+16], e.Comm)
 	written += 16
+
+	binary.NativeEndian.PutUint64(data[written:written+8], ContainerKey(e.ContainerID))
+	written += 8
 	return written, nil
 }
 
+// ContainerKey returns the key of a container ID, as computed by the kernel: the FNV-1a hash of the ContainerIDLen
+// bytes of the zero padded ID, 0 for an empty ID
+func ContainerKey(id string) uint64 {
+	if len(id) == 0 {
+		return 0
+	}
+
+	var raw [ContainerIDLen]byte
+	copy(raw[:], id)
+
+	h := fnv.New64a()
+	_, _ = h.Write(raw[:])
+	return h.Sum64()
+}
+
 func marshalTime(data []byte, t time.Duration) {
 	binary.NativeEndian.PutUint64(data, uint64(t.Nanoseconds()))
 }
@@ -147,7 +166,7 @@ func (e *Process) MarshalPidCache(data []byte, bootTime time.Time) (int, error)
 
 // MarshalBinary marshals a binary representation of itself
 func (adlc *ActivityDumpLoadConfig) MarshalBinary() ([]byte, error) {
-	raw := make([]byte, 48)
+	raw := make([]byte, 48+4*ActivityDumpRateLimiterEventTypes)
 
 	var eventMask uint64
 	for _, evt := range adlc.TracedEventTypes {
@@ -160,6 +179,13 @@ func (adlc *ActivityDumpLoadConfig) MarshalBinary() ([]byte, error) {
 	binary.NativeEndian.PutUint64(raw[32:40], adlc.EndTimestampRaw)
 	binary.NativeEndian.PutUint32(raw[40:44], adlc.Rate)
 	binary.NativeEndian.PutUint32(raw[44:48], adlc.Paused)
+	for evt, rate := range adlc.EventTypeRates {
+		if evt < FirstDiscarderEventType || evt >= FirstDiscarderEventType+ActivityDumpRateLimiterEventTypes {
+			continue
+		}
+		offset := 48 + 4*int(evt-FirstDiscarderEventType)
+		binary.NativeEndian.PutUint32(raw[offset:offset+4], rate)
+	}
 
 	return raw, nil
 }
@@ -359,6 +359,9 @@ func (p *PathKey) MarshalBinary() ([]byte, error) {
 // PathKeySize defines the path key size
 const PathKeySize = 16
 
+// DPathSize defines the size of the path resolved by bpf_d_path, see dr_d_path_t
+const DPathSize = 256
+
 // PathLeafSize defines path_leaf struct size
 const PathLeafSize = PathKeySize + MaxSegmentLength + 1 + 2 + 6 // path_key + name + len + padding
 
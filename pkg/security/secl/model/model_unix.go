@@ -499,6 +499,8 @@ type MProtectEvent struct {
 	VMEnd         uint64 `field:"-"`
 	VMProtection  int    `field:"vm_protection"`  // SECLDoc[vm_protection] Definition:`initial memory segment protection` Constants:`Virtual Memory flags`
 	ReqProtection int    `field:"req_protection"` // SECLDoc[req_protection] Definition:`new memory segment protection` Constants:`Virtual Memory flags`
+
+	SuppressedCount uint32 `field:"-"`
 }
 
 // LoadModuleEvent represents a load_module event
@@ -545,6 +547,10 @@ type CgroupTracingEvent struct {
 	ConfigCookie     uint64
 }
 
+// ActivityDumpRateLimiterEventTypes is the number of event types, starting at FirstDiscarderEventType, that can have
+// their own activity dump rate, see AD_RL_EVENT_TYPES
+const ActivityDumpRateLimiterEventTypes = 16
+
 // ActivityDumpLoadConfig represents the load configuration of an activity dump
 type ActivityDumpLoadConfig struct {
 	TracedEventTypes     []EventType
@@ -554,6 +560,7 @@ type ActivityDumpLoadConfig struct {
 	EndTimestampRaw      uint64
 	Rate                 uint32 // max number of events per sec
 	Paused               uint32
+	EventTypeRates       map[EventType]uint32 // max number of events per sec of an event type, overrides Rate
 }
 
 // NetworkDeviceContext represents the network device context of a network event
@@ -316,8 +316,8 @@ func (e *ArgsEnvsEvent) UnmarshalBinary(data []byte) (int, error) {
 
 	e.ID = binary.NativeEndian.Uint32(data[0:4])
 	e.Size = binary.NativeEndian.Uint32(data[4:8])
-	if e.Size > MaxArgEnvSize {
-		e.Size = MaxArgEnvSize
+	if e.Size > MaxArgsEnvsBatchSize {
+		e.Size = MaxArgsEnvsBatchSize
 	}
 
 	argsEnvSize := int(e.Size)
@@ -326,11 +326,7 @@ func (e *ArgsEnvsEvent) UnmarshalBinary(data []byte) (int, error) {
 		return 8, ErrNotEnoughData
 	}
 
-	for i := range e.ValuesRaw {
-		e.ValuesRaw[i] = 0
-	}
-
-	SliceToArray(data[:argsEnvSize], e.ValuesRaw[:argsEnvSize])
+	e.ValuesRaw = data[:argsEnvSize]
 
 	return 8 + argsEnvSize, nil
 }
@@ -471,7 +467,19 @@ func (e *OpenEvent) UnmarshalBinary(data []byte) (int, error) {
 
 	e.Flags = binary.NativeEndian.Uint32(data[0:4])
 	e.Mode = binary.NativeEndian.Uint32(data[4:8])
-	return n + 8, nil
+	n += 8
+
+	// the path resolved in the kernel by bpf_d_path, if any, follows the event
+	if len(data) >= 8+DPathSize {
+		path, err := UnmarshalString(data[8:], DPathSize)
+		if err != nil {
+			return n, err
+		}
+		e.File.SetPathnameStr(path)
+		n += DPathSize
+	}
+
+	return n, nil
 }
 
 // UnmarshalBinary unmarshalls a binary representation of itself
@@ -833,7 +841,7 @@ func (e *MProtectEvent) UnmarshalBinary(data []byte) (int, error) {
 		return 0, err
 	}
 
-	if len(data)-read < 32 {
+	if len(data)-read < 40 {
 		return 0, ErrNotEnoughData
 	}
 
@@ -841,7 +849,8 @@ func (e *MProtectEvent) UnmarshalBinary(data []byte) (int, error) {
 	e.VMEnd = binary.NativeEndian.Uint64(data[read+8 : read+16])
 	e.VMProtection = int(binary.NativeEndian.Uint32(data[read+16 : read+24]))
 	e.ReqProtection = int(binary.NativeEndian.Uint32(data[read+24 : read+32]))
-	return read + 32, nil
+	e.SuppressedCount = binary.NativeEndian.Uint32(data[read+32 : read+36])
+	return read + 40, nil
 }
 
 // UnmarshalBinary unmarshals a binary representation of itself
@@ -951,7 +960,8 @@ func (e *CgroupTracingEvent) UnmarshalBinary(data []byte) (int, error) {
 
 // EventUnmarshalBinary unmarshals a binary representation of itself
 func (adlc *ActivityDumpLoadConfig) EventUnmarshalBinary(data []byte) (int, error) {
-	if len(data) < 48 {
+	size := 48 + 4*ActivityDumpRateLimiterEventTypes
+	if len(data) < size {
 		return 0, ErrNotEnoughData
 	}
 
@@ -967,7 +977,15 @@ func (adlc *ActivityDumpLoadConfig) EventUnmarshalBinary(data []byte) (int, erro
 	adlc.EndTimestampRaw = binary.NativeEndian.Uint64(data[32:40])
 	adlc.Rate = binary.NativeEndian.Uint32(data[40:44])
 	adlc.Paused = binary.NativeEndian.Uint32(data[44:48])
-	return 48, nil
+	for i := 0; i < ActivityDumpRateLimiterEventTypes; i++ {
+		if rate := binary.NativeEndian.Uint32(data[48+4*i : 52+4*i]); rate > 0 {
+			if adlc.EventTypeRates == nil {
+				adlc.EventTypeRates = make(map[EventType]uint32)
+			}
+			adlc.EventTypeRates[FirstDiscarderEventType+EventType(i)] = rate
+		}
+	}
+	return size, nil
 }
 
 // UnmarshalBinary unmarshals a binary representation of itself
@@ -1022,7 +1040,7 @@ func (e *NetworkContext) UnmarshalBinary(data []byte) (int, error) {
 
 // UnmarshalBinary unmarshalls a binary representation of itself
 func (e *DNSEvent) UnmarshalBinary(data []byte) (int, error) {
-	if len(data) < 10 {
+	if len(data) < 12 {
 		return 0, ErrNotEnoughData
 	}
 
@@ -1031,8 +1049,9 @@ func (e *DNSEvent) UnmarshalBinary(data []byte) (int, error) {
 	e.Type = binary.NativeEndian.Uint16(data[4:6])
 	e.Class = binary.NativeEndian.Uint16(data[6:8])
 	e.Size = binary.NativeEndian.Uint16(data[8:10])
+	e.RepeatCount = binary.NativeEndian.Uint16(data[10:12])
 	var err error
-	e.Name, err = decodeDNSName(data[10:])
+	e.Name, err = decodeDNSName(data[12:])
 	if err != nil {
 		return 0, err
 	}
@@ -16,13 +16,17 @@ const (
 	MaxArgEnvSize = 256
 	// MaxArgsEnvsSize maximum number of args and/or envs
 	MaxArgsEnvsSize = 256
+	// MaxArgsEnvsBatchSize maximum size of the args or envs sent in a single ring buffer record, see
+	// MAX_RINGBUF_STR_BUFF_LEN
+	MaxArgsEnvsBatchSize = 4096
 )
 
 // ArgsEnvs raw value for args and envs
 type ArgsEnvs struct {
-	ID        uint32
-	Size      uint32
-	ValuesRaw [MaxArgEnvSize]byte
+	ID   uint32
+	Size uint32
+	// ValuesRaw points to the event data, it is only valid while the event is handled
+	ValuesRaw []byte
 }
 
 // ArgsEntry defines a args cache entry
@@ -533,6 +533,8 @@ type DNSEvent struct {
 	Class uint16 `field:"question.class"`                                                  // SECLDoc[question.class] Definition:`the class looked up by the DNS question` Constants:`DNS qclasses`
 	Size  uint16 `field:"question.length"`                                                 // SECLDoc[question.length] Definition:`the total DNS request size in bytes`
 	Count uint16 `field:"question.count"`                                                  // SECLDoc[question.count] Definition:`the total count of questions in the DNS request`
+
+	RepeatCount uint16 `field:"-"`
 }
 
 // Matches returns true if the two DNS events matches
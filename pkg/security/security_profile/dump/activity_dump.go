@@ -99,12 +99,18 @@ type ActivityDump struct {
 }
 
 // NewActivityDumpLoadConfig returns a new instance of ActivityDumpLoadConfig
-func NewActivityDumpLoadConfig(evt []model.EventType, timeout time.Duration, waitListTimeout time.Duration, rate int, start time.Time, resolver *stime.Resolver) *model.ActivityDumpLoadConfig {
+func NewActivityDumpLoadConfig(evt []model.EventType, timeout time.Duration, waitListTimeout time.Duration, rate int, eventTypeRates map[model.EventType]int, start time.Time, resolver *stime.Resolver) *model.ActivityDumpLoadConfig {
 	adlc := &model.ActivityDumpLoadConfig{
 		TracedEventTypes: evt,
 		Timeout:          timeout,
 		Rate:             uint32(rate),
 	}
+	if len(eventTypeRates) > 0 {
+		adlc.EventTypeRates = make(map[model.EventType]uint32, len(eventTypeRates))
+		for eventType, eventTypeRate := range eventTypeRates {
+			adlc.EventTypeRates[eventType] = uint32(eventTypeRate)
+		}
+	}
 	if resolver != nil {
 		adlc.StartTimestampRaw = uint64(resolver.ComputeMonotonicTimestamp(start))
 		adlc.EndTimestampRaw = uint64(resolver.ComputeMonotonicTimestamp(start.Add(timeout)))
@@ -151,6 +157,7 @@ func NewActivityDump(adm *ActivityDumpManager, options ...WithDumpOption) *Activ
 		adm.config.RuntimeSecurity.ActivityDumpCgroupDumpTimeout,
 		adm.config.RuntimeSecurity.ActivityDumpCgroupWaitListTimeout,
 		adm.config.RuntimeSecurity.ActivityDumpRateLimiter,
+		adm.config.RuntimeSecurity.ActivityDumpEventTypesRateLimiter,
 		now,
 		adm.resolvers.TimeResolver,
 	)
@@ -203,6 +210,7 @@ func NewActivityDumpFromMessage(msg *api.ActivityDumpMessage) (*ActivityDump, er
 		timeout,
 		0,
 		0,
+		nil,
 		startTime,
 		nil,
 	)
@@ -10,6 +10,7 @@ package dump
 
 import (
 	"fmt"
+	"maps"
 	"time"
 
 	"github.com/cilium/ebpf"
@@ -64,6 +65,7 @@ func (lc *ActivityDumpLoadController) getDefaultLoadConfig() *model.ActivityDump
 		lc.adm.config.RuntimeSecurity.ActivityDumpCgroupDumpTimeout,
 		0,
 		lc.adm.config.RuntimeSecurity.ActivityDumpRateLimiter,
+		lc.adm.config.RuntimeSecurity.ActivityDumpEventTypesRateLimiter,
 		time.Now(),
 		lc.adm.resolvers.TimeResolver,
 	)
@@ -109,6 +111,7 @@ func (lc *ActivityDumpLoadController) NextPartialDump(ad *ActivityDump) *Activit
 	newDump.LoadConfig.TracedEventTypes = make([]model.EventType, len(ad.LoadConfig.TracedEventTypes))
 	copy(newDump.LoadConfig.TracedEventTypes, ad.LoadConfig.TracedEventTypes)
 	newDump.LoadConfig.Rate = ad.LoadConfig.Rate
+	newDump.LoadConfig.EventTypeRates = maps.Clone(ad.LoadConfig.EventTypeRates)
 	newDump.LoadConfigCookie = ad.LoadConfigCookie
 
 	if timeToThreshold < lc.minDumpTimeout {
@@ -134,6 +137,9 @@ func (lc *ActivityDumpLoadController) NextPartialDump(ad *ActivityDump) *Activit
 // reduceDumpRate reduces the dump rate configuration and applies the updated value to kernel space
 func (lc *ActivityDumpLoadController) reduceDumpRate(old, new *ActivityDump) error {
 	new.LoadConfig.Rate = old.LoadConfig.Rate * 3 / 4 // reduce by 25%
+	for evt, rate := range old.LoadConfig.EventTypeRates {
+		new.LoadConfig.EventTypeRates[evt] = rate * 3 / 4
+	}
 
 	// send metric
 	return lc.sendLoadControllerTriggeredMetric([]string{"reduction:rate"})
@@ -547,6 +547,11 @@ func (adm *ActivityDumpManager) DumpActivity(params *api.ActivityDumpParams) (*a
 	adm.Lock()
 	defer adm.Unlock()
 
+	if params.GetComm() != "" && adm.config.RuntimeSecurity.ActivityDumpCgroupOnly {
+		errMsg := fmt.Errorf("couldn't start tracing [comm:%s]: the activity dumps are restricted to cgroups", params.GetComm())
+		return &api.ActivityDumpMessage{Error: errMsg.Error()}, errMsg
+	}
+
 	newDump := NewActivityDump(adm, func(ad *ActivityDump) {
 		ad.Metadata.Comm = params.GetComm()
 		ad.Metadata.ContainerID = params.GetContainerID()
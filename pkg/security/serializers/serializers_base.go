@@ -181,6 +181,8 @@ type DNSEventSerializer struct {
 	ID uint16 `json:"id"`
 	// question is a DNS question for the DNS request
 	Question DNSQuestionSerializer `json:"question"`
+	// repeat_count is the number of identical questions sent by the process since the previous event and not reported
+	RepeatCount uint16 `json:"repeat_count,omitempty"`
 }
 
 // DDContextSerializer serializes a span context to JSON
@@ -240,6 +242,7 @@ func newDNSEventSerializer(d *model.DNSEvent) *DNSEventSerializer {
 			Size:  d.Size,
 			Count: d.Count,
 		},
+		RepeatCount: d.RepeatCount,
 	}
 }
 
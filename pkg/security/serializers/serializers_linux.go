@@ -366,6 +366,8 @@ type MProtectEventSerializer struct {
 	VMProtection string `json:"vm_protection"`
 	// new memory segment protection
 	ReqProtection string `json:"req_protection"`
+	// number of anonymous write to exec transitions of the JIT process that were not reported since the previous event
+	SuppressedCount uint32 `json:"suppressed_count,omitempty"`
 }
 
 // PTraceEventSerializer serializes a mmap event to JSON
@@ -798,10 +800,11 @@ func newMMapEventSerializer(e *model.Event) *MMapEventSerializer {
 
 func newMProtectEventSerializer(e *model.Event) *MProtectEventSerializer {
 	return &MProtectEventSerializer{
-		VMStart:       fmt.Sprintf("0x%x", e.MProtect.VMStart),
-		VMEnd:         fmt.Sprintf("0x%x", e.MProtect.VMEnd),
-		VMProtection:  model.VMFlag(e.MProtect.VMProtection).String(),
-		ReqProtection: model.VMFlag(e.MProtect.ReqProtection).String(),
+		VMStart:         fmt.Sprintf("0x%x", e.MProtect.VMStart),
+		VMEnd:           fmt.Sprintf("0x%x", e.MProtect.VMEnd),
+		VMProtection:    model.VMFlag(e.MProtect.VMProtection).String(),
+		ReqProtection:   model.VMFlag(e.MProtect.ReqProtection).String(),
+		SuppressedCount: e.MProtect.SuppressedCount,
 	}
 }
 
@@ -188,3 +188,66 @@ func TestActionKill(t *testing.T) {
 		assert.NoError(t, err)
 	})
 }
+
+func TestActionKillKernelRuleSkipsRuntime(t *testing.T) {
+	SkipIfNotAvailable(t)
+
+	if ebpfLessEnabled {
+		t.Skip("kernel kill rules require eBPF")
+	}
+
+	checkKernelCompatibility(t, "bpf_send_signal is not supported on this kernel", func(kv *kernel.Version) bool {
+		return !kv.SupportBPFSendSignal()
+	})
+
+	// the rule only depends on the basename of the file, so it is enforced by the kernel
+	ruleDefs := []*rules.RuleDefinition{
+		{
+			ID:         "kernel_kill_runtime",
+			Expression: `open.file.name == "test-kernel-kill-runtime"`,
+			Actions: []*rules.ActionDefinition{
+				{
+					Kill: &rules.KillDefinition{
+						Signal: "SIGUSR2",
+					},
+				},
+			},
+		},
+	}
+
+	test, err := newTestModule(t, nil, ruleDefs)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer test.Close()
+
+	testFile, _, err := test.Path("test-kernel-kill-runtime")
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer os.Remove(testFile)
+
+	sigCh := make(chan os.Signal, 1)
+	signal.Notify(sigCh, syscall.SIGUSR2)
+	defer signal.Stop(sigCh)
+
+	// the test process is the runtime, opening the file must not signal it
+	err = test.GetEventSent(t, func() error {
+		f, err := os.Create(testFile)
+		if err != nil {
+			return err
+		}
+		return f.Close()
+	}, func(rule *rules.Rule, event *model.Event) bool {
+		return assert.Equal(t, uint32(os.Getpid()), event.ProcessContext.Pid, "wrong pid")
+	}, time.Second*3, "kernel_kill_runtime")
+	if err != nil {
+		t.Error(err)
+	}
+
+	select {
+	case <-sigCh:
+		t.Error("the runtime was signaled by a kill rule")
+	case <-time.After(time.Second * 2):
+	}
+}
@@ -0,0 +1,74 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2016-present Datadog, Inc.
+
+//go:build linux && functionaltests
+
+// Package tests holds tests related files
+package tests
+
+import (
+	"os"
+	"syscall"
+	"testing"
+
+	"github.com/stretchr/testify/assert"
+
+	"github.com/DataDog/datadog-agent/pkg/security/secl/model"
+	"github.com/DataDog/datadog-agent/pkg/security/secl/rules"
+)
+
+func TestDiscarderProbation(t *testing.T) {
+	SkipIfNotAvailable(t)
+
+	rule := &rules.RuleDefinition{
+		ID:         "test_rule_probation",
+		Expression: `open.file.path == "{{.Root}}/test-probation" && open.flags & O_RDWR != 0`,
+	}
+
+	test, err := newTestModule(t, nil, []*rules.RuleDefinition{rule}, withStaticOpts(testOpts{discarderProbationThreshold: 2}))
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer test.Close()
+
+	testFile, _, err := test.Path("test-probation")
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	// write only, the creation doesn't match the rule
+	fd, err := syscall.Open(testFile, syscall.O_CREAT|syscall.O_WRONLY, 0644)
+	if err != nil {
+		t.Fatal(err)
+	}
+	syscall.Close(fd)
+	defer os.Remove(testFile)
+
+	t.Run("matching-flags-after-probation", func(t *testing.T) {
+		test.WaitSignal(t, func() error {
+			// the read only opens don't match the rule, past the threshold the kernel suppresses them
+			for i := 0; i < 10; i++ {
+				fd, err := syscall.Open(testFile, syscall.O_RDONLY, 0)
+				if err != nil {
+					return err
+				}
+				if err := syscall.Close(fd); err != nil {
+					return err
+				}
+			}
+
+			// the probation is keyed on the flags, a read write open of the same file must still be sent
+			fd, err := syscall.Open(testFile, syscall.O_RDWR, 0)
+			if err != nil {
+				return err
+			}
+			return syscall.Close(fd)
+		}, func(event *model.Event, r *rules.Rule) {
+			assert.Equal(t, "open", event.GetType(), "wrong event type")
+			assert.Equal(t, syscall.O_RDWR, int(event.Open.Flags), "wrong flags")
+			assertInode(t, event.Open.File.Inode, getInode(t, testFile))
+		})
+	})
+}
@@ -730,6 +730,7 @@ func genTestConfigs(cfgDir string, opts testOpts) (*emconfig.Config, *secconfig.
 		"TestPoliciesDir":                            cfgDir,
 		"DisableApprovers":                           opts.disableApprovers,
 		"DisableDiscarders":                          opts.disableDiscarders,
+		"DiscarderProbationThreshold":                opts.discarderProbationThreshold,
 		"EnableActivityDump":                         opts.enableActivityDump,
 		"ActivityDumpRateLimiter":                    opts.activityDumpRateLimiter,
 		"ActivityDumpTagRules":                       opts.activityDumpTagRules,
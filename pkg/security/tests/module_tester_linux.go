@@ -91,6 +91,8 @@ event_monitoring_config:
 {{if .DisableDiscarders}}
   enable_discarders: false
 {{end}}
+  discarder_probation:
+    threshold: {{ .DiscarderProbationThreshold }}
   erpc_dentry_resolution_enabled: {{ .ErpcDentryResolutionEnabled }}
   map_dentry_resolution_enabled: {{ .MapDentryResolutionEnabled }}
   envs_with_value:
@@ -18,6 +18,8 @@
 #include <pthread.h>
 #include <signal.h>
 #include <errno.h>
+#include <time.h>
+#include <limits.h>
 #include <arpa/inet.h>
 #include <linux/un.h>
 #include <err.h>
@@ -710,6 +712,129 @@ int test_new_netns_exec(int argc, char **argv) {
     return EXIT_FAILURE;
 }
 
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static int bench_op(const char *op, const char *dir, int i, char *self) {
+    char path[PATH_MAX], new_path[PATH_MAX];
+    // rename moves the file back and forth, the other operations work on bench-0
+    int index = strcmp(op, "rename") == 0 ? i % 2 : 0;
+    snprintf(path, sizeof(path), "%s/bench-%d", dir, index);
+    snprintf(new_path, sizeof(new_path), "%s/bench-%d", dir, 1 - index);
+
+    if (strcmp(op, "open") == 0) {
+        int fd = open(path, O_RDONLY | O_CREAT, 0600);
+        if (fd < 0) {
+            return -1;
+        }
+        return close(fd);
+    } else if (strcmp(op, "chmod") == 0) {
+        return chmod(path, i % 2 ? 0600 : 0400);
+    } else if (strcmp(op, "rename") == 0) {
+        return rename(path, new_path);
+    } else if (strcmp(op, "fork") == 0 || strcmp(op, "exec") == 0) {
+        pid_t child = fork();
+        if (child < 0) {
+            return -1;
+        }
+        if (child == 0) {
+            if (op[0] == 'e') {
+                char *argv[] = { self, "check", NULL };
+                execv(self, argv);
+            }
+            _exit(EXIT_SUCCESS);
+        }
+        return waitpid(child, NULL, 0) < 0 ? -1 : 0;
+    } else if (strcmp(op, "connect") == 0) {
+        struct sockaddr_in addr = {
+            .sin_family = AF_INET,
+            .sin_port = htons(4242),
+            .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+        };
+        int sock = socket(AF_INET, SOCK_DGRAM, 0);
+        if (sock < 0) {
+            return -1;
+        }
+        int ret = connect(sock, (struct sockaddr *)&addr, sizeof(addr));
+        close(sock);
+        return ret;
+    }
+
+    fprintf(stderr, "Unknown bench operation `%s`\n", op);
+    return -1;
+}
+
+// test_bench runs an operation in a loop, at a fixed rate if given, and reports its latency percentiles and
+// throughput. Run it with and without the probe loaded to get the overhead added to the syscalls.
+int test_bench(int argc, char **argv) {
+    if (argc < 4) {
+        fprintf(stderr, "%s: Please pass an operation (open, chmod, rename, fork, exec, connect), an iteration count, a directory and optionally a rate per second.\n", __FUNCTION__);
+        return EXIT_FAILURE;
+    }
+
+    const char *op = argv[1];
+    int iterations = atoi(argv[2]);
+    const char *dir = argv[3];
+    int rate = argc > 4 ? atoi(argv[4]) : 0;
+    if (iterations <= 0) {
+        fprintf(stderr, "Please specify a valid iteration count\n");
+        return EXIT_FAILURE;
+    }
+
+    char path[PATH_MAX];
+    snprintf(path, sizeof(path), "%s/bench-0", dir);
+    int fd = open(path, O_RDONLY | O_CREAT, 0600);
+    if (fd < 0) {
+        return EXIT_FAILURE;
+    }
+    close(fd);
+
+    uint64_t *latencies = calloc(iterations, sizeof(uint64_t));
+    if (latencies == NULL) {
+        return EXIT_FAILURE;
+    }
+
+    uint64_t interval = rate > 0 ? 1000000000ULL / rate : 0;
+    uint64_t start = now_ns();
+    for (int i = 0; i < iterations; i++) {
+        uint64_t op_start = now_ns();
+        if (bench_op(op, dir, i, argv[0]) < 0) {
+            free(latencies);
+            return EXIT_FAILURE;
+        }
+        latencies[i] = now_ns() - op_start;
+
+        if (interval) {
+            uint64_t next = start + (i + 1) * interval, current = now_ns();
+            if (next > current) {
+                struct timespec ts = { .tv_sec = (next - current) / 1000000000ULL, .tv_nsec = (next - current) % 1000000000ULL };
+                nanosleep(&ts, NULL);
+            }
+        }
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    qsort(latencies, iterations, sizeof(uint64_t), cmp_u64);
+    printf("op=%s iterations=%d p50_ns=%lu p99_ns=%lu ops_per_sec=%lu\n", op, iterations,
+        (unsigned long)latencies[iterations / 2], (unsigned long)latencies[(iterations * 99) / 100],
+        (unsigned long)(iterations * 1000000000ULL / (elapsed ? elapsed : 1)));
+
+    unlink(path);
+    snprintf(path, sizeof(path), "%s/bench-1", dir);
+    unlink(path);
+
+    free(latencies);
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char **argv) {
     setbuf(stdout, NULL);
 
@@ -783,6 +908,8 @@ int main(int argc, char **argv) {
             exit_code = test_new_netns_exec(sub_argc, sub_argv);
         } else if (strcmp(cmd, "slow-cat") == 0) {
             exit_code = test_slow_cat(sub_argc, sub_argv);
+        } else if (strcmp(cmd, "bench") == 0) {
+            exit_code = test_bench(sub_argc, sub_argv);
         } else {
             fprintf(stderr, "Unknown command `%s`\n", cmd);
             exit_code = EXIT_FAILURE;
@@ -48,6 +48,7 @@ type testOpts struct {
 	anomalyDetectionMinimumStablePeriodDNS     time.Duration
 	anomalyDetectionWarmupPeriod               time.Duration
 	disableDiscarders                          bool
+	discarderProbationThreshold                int
 	disableERPCDentryResolution                bool
 	disableMapDentryResolution                 bool
 	envsWithValue                              []string
@@ -119,6 +120,7 @@ func (to testOpts) Equal(opts testOpts) bool {
 		to.anomalyDetectionMinimumStablePeriodDNS == opts.anomalyDetectionMinimumStablePeriodDNS &&
 		to.anomalyDetectionWarmupPeriod == opts.anomalyDetectionWarmupPeriod &&
 		to.disableDiscarders == opts.disableDiscarders &&
+		to.discarderProbationThreshold == opts.discarderProbationThreshold &&
 		to.disableFilters == opts.disableFilters &&
 		to.disableERPCDentryResolution == opts.disableERPCDentryResolution &&
 		to.disableMapDentryResolution == opts.disableMapDentryResolution &&
@@ -17,6 +17,7 @@ import (
 	"strconv"
 	"strings"
 	"sync"
+	"syscall"
 
 	"github.com/DataDog/datadog-agent/pkg/security/secl/model"
 	"github.com/DataDog/datadog-agent/pkg/util/kernel"
@@ -93,6 +94,20 @@ func (path *NetNSPath) GetProcessNetworkNamespace() (uint32, error) {
 	return uint32(netns), nil
 }
 
+// GetProcessMountNamespace returns the mount namespace of a pid, the inode of /proc/[pid]/ns/mnt
+func GetProcessMountNamespace(pid uint32) (uint32, error) {
+	fi, err := os.Stat(procPidPath(pid, "ns/mnt"))
+	if err != nil {
+		return 0, err
+	}
+
+	stat, ok := fi.Sys().(*syscall.Stat_t)
+	if !ok {
+		return 0, fmt.Errorf("couldn't stat the mount namespace of %d", pid)
+	}
+	return uint32(stat.Ino), nil
+}
+
 // CgroupTaskPath returns the path to the cgroup file of a pid in /proc
 func CgroupTaskPath(tgid, pid uint32) string {
 	return kernel.HostProc(strconv.FormatUint(uint64(tgid), 10), "task", strconv.FormatUint(uint64(pid), 10), "cgroup")
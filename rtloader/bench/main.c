@@ -0,0 +1,265 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2019-present Datadog, Inc.
+
+// Microbenchmarks of the RtLoader builtins and entrypoints, reporting the time and the
+// allocations per call. Builtins are called from a Python loop, whose own overhead is
+// reported by the `python loop` baseline, the entrypoints are called from C.
+#include "datadog_agent_rtloader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_ITERATIONS 100000
+
+static rtloader_t *rtloader;
+static rtloader_pyobject_t *py_class;
+static rtloader_pyobject_t *check;
+
+// number of allocations made through the RtLoader allocator
+static unsigned long long allocations = 0;
+
+static void memory_tracker(void *ptr, size_t sz, rtloader_mem_ops_t op)
+{
+    if (op == DATADOG_AGENT_RTLOADER_ALLOCATION) {
+        allocations++;
+    }
+}
+
+/*
+ * agent callbacks, returned data is freed by RtLoader with the cgo_free callback
+ */
+
+static void submit_metric(char *id, metric_type_t mt, char *name, double val, char **tags, char *hostname,
+                          bool flush_first_val)
+{
+}
+
+static char **tags(char *id, int cardinality)
+{
+    char **data = malloc(sizeof(*data) * 3);
+    data[0] = strdup("image_name:redis");
+    data[1] = strdup("kube_namespace:default");
+    data[2] = NULL;
+    return data;
+}
+
+static void get_config(char *key, char **value)
+{
+    *value = strdup("{instances: [{host: localhost, port: 6379}], min_collection_interval: 15}");
+}
+
+/*
+ * benchmarks
+ */
+
+static unsigned long long now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void report(const char *name, unsigned long long elapsed, unsigned long long allocs, size_t pymem_alloc,
+                   int iterations)
+{
+    printf("%-24s %12.1f %14.2f %16.1f\n", name, (double)elapsed / iterations, (double)allocs / iterations,
+           (double)pymem_alloc / iterations);
+}
+
+/*! \fn static int bench_python(const char *name, const char *statement, int iterations)
+    \brief Runs the Python statement in a loop and reports the cost of one iteration.
+    \return an int value - 1 for success; 0 if the statement raised.
+*/
+static int bench_python(const char *name, const char *statement, int iterations)
+{
+    char code[1024];
+    snprintf(code, sizeof(code), "for _ in range(%d):\n    %s\n", iterations, statement);
+
+    // warm up
+    char warmup[1024];
+    snprintf(warmup, sizeof(warmup), "for _ in range(%d):\n    %s\n", iterations / 10 + 1, statement);
+    if (!run_simple_string(rtloader, warmup)) {
+        fprintf(stderr, "%s: the statement raised an exception\n", name);
+        return 0;
+    }
+
+    pymem_stats_t pymem_start = { 0 }, pymem_end = { 0 };
+    get_pymem_stats(rtloader, &pymem_start);
+    unsigned long long allocs_start = allocations;
+    unsigned long long start = now_ns();
+
+    run_simple_string(rtloader, code);
+
+    unsigned long long elapsed = now_ns() - start;
+    get_pymem_stats(rtloader, &pymem_end);
+    report(name, elapsed, allocations - allocs_start, pymem_end.alloc - pymem_start.alloc, iterations);
+    return 1;
+}
+
+/*! \fn static int bench_c(const char *name, int (*call)(void), int iterations)
+    \brief Calls the function in a loop and reports the cost of one call.
+    \return an int value - 1 for success; 0 if a call failed.
+*/
+static int bench_c(const char *name, int (*call)(void), int iterations)
+{
+    int i;
+
+    // warm up
+    for (i = 0; i < iterations / 10 + 1; i++) {
+        if (!call()) {
+            fprintf(stderr, "%s: %s\n", name, has_error(rtloader) ? get_error(rtloader) : "call failed");
+            return 0;
+        }
+    }
+
+    pymem_stats_t pymem_start = { 0 }, pymem_end = { 0 };
+    get_pymem_stats(rtloader, &pymem_start);
+    unsigned long long allocs_start = allocations;
+    unsigned long long start = now_ns();
+
+    for (i = 0; i < iterations; i++) {
+        call();
+    }
+
+    unsigned long long elapsed = now_ns() - start;
+    get_pymem_stats(rtloader, &pymem_end);
+    report(name, elapsed, allocations - allocs_start, pymem_end.alloc - pymem_start.alloc, iterations);
+    return 1;
+}
+
+// get_check parses the configuration with from_yaml
+static int call_get_check()
+{
+    rtloader_pyobject_t *instance = NULL;
+    if (!get_check(rtloader, py_class, "{timeout: 10}", "{host: localhost, port: 6379, tags: [env:prod]}",
+                   "bench_check:123", "fake_check", &instance)) {
+        return 0;
+    }
+    rtloader_decref(rtloader, instance);
+    return 1;
+}
+
+// run_check converts the result with as_string
+static int call_run_check()
+{
+    char *result = run_check(rtloader, check);
+    if (result == NULL) {
+        return 0;
+    }
+    rtloader_free(rtloader, result);
+    return 1;
+}
+
+static int call_get_checks_warnings()
+{
+    char **warnings = get_checks_warnings(rtloader, check);
+    if (warnings == NULL) {
+        return 0;
+    }
+    char **w;
+    for (w = warnings; *w != NULL; w++) {
+        rtloader_free(rtloader, *w);
+    }
+    rtloader_free(rtloader, warnings);
+    return 1;
+}
+
+// get_integration_list serializes the wheels list with as_yaml
+static int call_get_integration_list()
+{
+    char *list = get_integration_list(rtloader);
+    if (list == NULL) {
+        return 0;
+    }
+    rtloader_free(rtloader, list);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        printf("Please run: rtloader-bench <2|3> [path_to_python_home] [iterations]. For example:\n\n");
+        printf("rtloader-bench 3 $VIRTUAL_ENV 100000\n");
+        return 1;
+    }
+
+    char *python_home = NULL;
+    if (argc >= 3 && strlen(argv[2]) > 0) {
+        python_home = argv[2];
+    }
+    int iterations = argc >= 4 ? atoi(argv[3]) : DEFAULT_ITERATIONS;
+    if (iterations <= 0) {
+        printf("Invalid number of iterations: %s\n", argv[3]);
+        return 1;
+    }
+
+    set_memory_tracker_cb(memory_tracker);
+
+    char *init_error = NULL;
+    if (strcmp(argv[1], "2") == 0) {
+        rtloader = make2(python_home, "", &init_error);
+    } else if (strcmp(argv[1], "3") == 0) {
+        rtloader = make3(python_home, "", &init_error);
+    } else {
+        printf("Unrecognized version: %s\n", argv[1]);
+        return 2;
+    }
+    if (!rtloader) {
+        printf("Unable to init Python%s: %s\n", argv[1], init_error);
+        return 1;
+    }
+
+    set_cgo_free_cb(rtloader, free);
+    set_submit_metric_cb(rtloader, submit_metric);
+    set_tags_cb(rtloader, tags);
+    set_get_config_cb(rtloader, get_config);
+    add_python_path(rtloader, BENCH_PYTHON_PATH);
+    init_pymem_stats(rtloader);
+
+    if (!init(rtloader)) {
+        printf("Error initializing rtloader: %s\n", get_error(rtloader));
+        return 1;
+    }
+
+    rtloader_gilstate_t state = ensure_gil(rtloader);
+
+    py_info_t *info = get_py_info(rtloader);
+    if (info) {
+        printf("Python %s\n", info->version);
+        free_py_info(rtloader, info);
+    }
+
+    rtloader_pyobject_t *py_module = NULL;
+    if (!get_class(rtloader, "fake_check", &py_module, &py_class)
+        || !get_check(rtloader, py_class, "", "{}", "bench_check:1", "fake_check", &check)) {
+        printf("Unable to load the benchmark check: %s\n", get_error(rtloader));
+        return 1;
+    }
+    run_simple_string(rtloader, "import aggregator, datadog_agent, tagger");
+
+    printf("%d iterations\n\n", iterations);
+    printf("%-24s %12s %14s %16s\n", "benchmark", "ns/call", "allocs/call", "pymem bytes/call");
+
+    int ok = 1;
+    ok &= bench_python("python loop", "pass", iterations);
+    ok &= bench_python("submit_metric",
+                       "aggregator.submit_metric(None, 'id', aggregator.GAUGE, 'bench.metric', 1.0, ['env:prod'], "
+                       "'host', False)",
+                       iterations);
+    ok &= bench_python("tag", "tagger.tag('container_id://abc', tagger.LOW)", iterations);
+    ok &= bench_python("get_config", "datadog_agent.get_config('redis')", iterations);
+    ok &= bench_c("get_check", call_get_check, iterations);
+    ok &= bench_c("run_check", call_run_check, iterations);
+    ok &= bench_c("get_checks_warnings", call_get_checks_warnings, iterations);
+    ok &= bench_c("get_integration_list", call_get_integration_list, iterations / 100 + 1);
+
+    rtloader_decref(rtloader, check);
+    release_gil(rtloader, state);
+    destroy(rtloader);
+
+    return ok ? 0 : 1;
+}
@@ -4,6 +4,7 @@
 // Copyright 2019-present Datadog, Inc.
 #include "_util.h"
 #include "cgo_free.h"
+#include "free_threading.h"
 #include "rtloader_mem.h"
 #include "stringutils.h"
 
@@ -11,8 +12,20 @@
 
 // must be set by the caller
 static cb_get_subprocess_output_t cb_get_subprocess_output = NULL;
+static cb_start_subprocess_t cb_start_subprocess = NULL;
+static cb_read_subprocess_output_t cb_read_subprocess_output = NULL;
+
+// command arguments and environment, as NULL terminated C-string arrays
+typedef struct {
+    char **args;
+    int args_sz;
+    char **env;
+    int env_sz;
+} subprocess_command_t;
 
 static PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw);
+static PyObject *subprocess_output_stream(PyObject *self, PyObject *args, PyObject *kw);
+static PyTypeObject SubprocessOutputStreamType;
 
 // Exceptions
 
@@ -31,6 +44,8 @@ static PyMethodDef methods[] = {
       "Exec a process and return the output." },
     { "get_subprocess_output", (PyCFunction)subprocess_output, METH_VARARGS | METH_KEYWORDS,
       "Exec a process and return the output." },
+    { "subprocess_output_stream", (PyCFunction)subprocess_output_stream, METH_VARARGS | METH_KEYWORDS,
+      "Exec a process and return an iterator over the lines of its output." },
     { NULL, NULL } // guards
 };
 
@@ -39,7 +54,12 @@ static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, _UTIL_MODULE_NAM
 
 PyMODINIT_FUNC PyInit__util(void)
 {
+    if (PyType_Ready(&SubprocessOutputStreamType) < 0) {
+        return NULL;
+    }
+
     PyObject *m = PyModule_Create(&module_def);
+    RTLOADER_MODULE_GIL_NOT_USED(m);
     addSubprocessException(m);
     return m;
 }
@@ -49,6 +69,10 @@ static PyObject *module;
 
 void Py2_init__util()
 {
+    if (PyType_Ready(&SubprocessOutputStreamType) < 0) {
+        return;
+    }
+
     module = Py_InitModule(_UTIL_MODULE_NAME, methods);
     addSubprocessException(module);
 }
@@ -59,6 +83,12 @@ void _set_get_subprocess_output_cb(cb_get_subprocess_output_t cb)
     cb_get_subprocess_output = cb;
 }
 
+void _set_subprocess_output_stream_cbs(cb_start_subprocess_t start, cb_read_subprocess_output_t read)
+{
+    cb_start_subprocess = start;
+    cb_read_subprocess_output = read;
+}
+
 /*! \fn void raiseEmptyOutputError()
     \brief sets the SubprocessOutputEmptyError exception as the interpreter error.
 
@@ -86,121 +116,85 @@ static void raiseEmptyOutputError()
     Py_DecRef(utilModule);
 }
 
-/*! \fn PyObject *subprocess_output(PyObject *self, PyObject *args)
-    \brief This function implements the `_util.subprocess_output` _and_ `_util.get_subprocess_output`
-    python method, allowing to execute a subprocess and collect its output.
-    \param self A PyObject* pointer to the _util module.
-    \param args A PyObject* pointer to the args tuple with the desired subprocess commands, and
-    optionally a boolean raise_on_empty flag.
-    \param kw A PyObject* pointer to the kw dict with optionally an env dict.
-    \return a PyObject * pointer to a python tuple with the stdout, stderr output and the
-    command exit code.
+/*! \fn static int build_subprocess_command(PyObject *cmd_args, PyObject *cmd_env, subprocess_command_t *cmd)
+    \brief Converts the python command arguments list and environment dict to C-string arrays.
+    \param cmd_args A PyObject* pointer to the python list of command arguments.
+    \param cmd_env A PyObject* pointer to the python env dict, NULL or None when not provided.
+    \param cmd A subprocess_command_t* pointer to the zeroed command to fill.
+    \return an int value - non-zero for success; zero for failure, with a python error set.
 
-    This function is callable as the `_util.subprocess_output` or `_util.get_subprocess_output`
-    python methods. The command arguments list is fed to the CGO callback, where the command is
-    executed in go-land. The stdout, stderr and exit codes for the command are returned by the
-    callback; these are then converted into python strings and integer respectively and returned
-    in a tuple. If the optional `raise_on_empty` boolean flag is set, and the command output is
-    empty an exception will be raised: the error will be set in the interpreter and NULL will be
-    returned.
+    The command must be released with free_subprocess_command() in both cases.
 */
-PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
+static int build_subprocess_command(PyObject *cmd_args, PyObject *cmd_env, subprocess_command_t *cmd)
 {
     int i;
-    int raise = 0;
-    int ret_code = 0;
-    int subprocess_args_sz = 0;
-    int subprocess_env_sz = 0;
-    char **subprocess_args = NULL;
-    char **subprocess_env = NULL;
-    char *c_stdout = NULL;
-    char *c_stderr = NULL;
-    char *exception = NULL;
-    PyObject *cmd_args = NULL;
-    PyObject *cmd_raise_on_empty = NULL;
-    PyObject *cmd_env = NULL;
-    PyObject *pyResult = NULL;
-
-    if (!cb_get_subprocess_output) {
-        Py_RETURN_NONE;
-    }
-
-    PyGILState_STATE gstate = PyGILState_Ensure();
-
-    static char *keywords[] = { "command", "raise_on_empty", "env", NULL };
-    // `cmd_args` is mandatory and should be a list, `cmd_raise_on_empty` is an optional
-    // boolean. The string after the ':' is used as the function name in error messages.
-    if (!PyArg_ParseTupleAndKeywords(args, kw, "O|O" PY_ARG_PARSE_TUPLE_KEYWORD_ONLY "O:get_subprocess_output",
-                                     keywords, &cmd_args, &cmd_raise_on_empty, &cmd_env)) {
-        goto cleanup;
-    }
 
     if (!PyList_Check(cmd_args)) {
         PyErr_SetString(PyExc_TypeError, "command args is not a list");
-        goto cleanup;
+        return 0;
     }
 
     // We already PyList_Check cmd_args, so PyList_Size won't fail and return -1
-    subprocess_args_sz = PyList_Size(cmd_args);
-    if (subprocess_args_sz == 0) {
+    cmd->args_sz = PyList_Size(cmd_args);
+    if (cmd->args_sz == 0) {
         PyErr_SetString(PyExc_TypeError, "invalid command: empty list");
-        goto cleanup;
+        return 0;
     }
 
-    if (!(subprocess_args = (char **)_malloc(sizeof(*subprocess_args) * (subprocess_args_sz + 1)))) {
+    if (!(cmd->args = (char **)_malloc(sizeof(*cmd->args) * (cmd->args_sz + 1)))) {
         PyErr_SetString(PyExc_MemoryError, "unable to allocate memory, bailing out");
-        goto cleanup;
+        return 0;
     }
 
     // init to NULL for safety - could use memset, but this is safer.
-    for (i = 0; i <= subprocess_args_sz; i++) {
-        subprocess_args[i] = NULL;
+    for (i = 0; i <= cmd->args_sz; i++) {
+        cmd->args[i] = NULL;
     }
 
-    for (i = 0; i < subprocess_args_sz; i++) {
+    for (i = 0; i < cmd->args_sz; i++) {
         char *subprocess_arg = as_string(PyList_GetItem(cmd_args, i));
 
         if (subprocess_arg == NULL) {
             PyErr_SetString(PyExc_TypeError, "command argument must be valid strings");
-            goto cleanup;
+            return 0;
         }
 
-        subprocess_args[i] = subprocess_arg;
+        cmd->args[i] = subprocess_arg;
     }
 
     if (cmd_env != NULL && cmd_env != Py_None) {
         if (!PyDict_Check(cmd_env)) {
             PyErr_SetString(PyExc_TypeError, "env is not a dict");
-            goto cleanup;
+            return 0;
         }
 
-        subprocess_env_sz = PyDict_Size(cmd_env);
-        if (subprocess_env_sz != 0) {
+        cmd->env_sz = PyDict_Size(cmd_env);
+        if (cmd->env_sz != 0) {
 
-            if (!(subprocess_env = (char **)_malloc(sizeof(*subprocess_env) * (subprocess_env_sz + 1)))) {
+            if (!(cmd->env = (char **)_malloc(sizeof(*cmd->env) * (cmd->env_sz + 1)))) {
                 PyErr_SetString(PyExc_MemoryError, "unable to allocate memory, bailing out");
-                goto cleanup;
+                return 0;
             }
 
-            for (i = 0; i <= subprocess_env_sz; i++) {
-                subprocess_env[i] = NULL;
+            for (i = 0; i <= cmd->env_sz; i++) {
+                cmd->env[i] = NULL;
             }
 
             Py_ssize_t pos = 0;
             PyObject *key = NULL, *value = NULL;
-            for (i = 0; i < subprocess_env_sz && PyDict_Next(cmd_env, &pos, &key, &value); i++) {
+            for (i = 0; i < cmd->env_sz && PyDict_Next(cmd_env, &pos, &key, &value); i++) {
 
                 char *env_key = as_string(key);
                 if (env_key == NULL) {
                     PyErr_SetString(PyExc_TypeError, "env key is not a string");
-                    goto cleanup;
+                    return 0;
                 }
 
                 char *env_value = as_string(value);
                 if (env_value == NULL) {
                     PyErr_SetString(PyExc_TypeError, "env value is not a string");
                     _free(env_key);
-                    goto cleanup;
+                    return 0;
                 }
 
                 char *env = (char *)_malloc((strlen(env_key) + 1 + strlen(env_value) + 1) * sizeof(*env));
@@ -208,7 +202,7 @@ PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
                     PyErr_SetString(PyExc_MemoryError, "unable to allocate memory, bailing out");
                     _free(env_key);
                     _free(env_value);
-                    goto cleanup;
+                    return 0;
                 }
 
                 strcpy(env, env_key);
@@ -218,11 +212,86 @@ PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
                 _free(env_key);
                 _free(env_value);
 
-                subprocess_env[i] = env;
+                cmd->env[i] = env;
             }
         }
     }
 
+
+    return 1;
+}
+
+/*! \fn static void free_subprocess_command(subprocess_command_t *cmd)
+    \brief Frees the C-string arrays allocated by build_subprocess_command().
+*/
+static void free_subprocess_command(subprocess_command_t *cmd)
+{
+    int i;
+
+    if (cmd->args) {
+        for (i = 0; i <= cmd->args_sz && cmd->args[i]; i++) {
+            _free(cmd->args[i]);
+        }
+        _free(cmd->args);
+    }
+
+    if (cmd->env) {
+        for (i = 0; i <= cmd->env_sz && cmd->env[i]; i++) {
+            _free(cmd->env[i]);
+        }
+        _free(cmd->env);
+    }
+}
+
+/*! \fn PyObject *subprocess_output(PyObject *self, PyObject *args)
+    \brief This function implements the `_util.subprocess_output` _and_ `_util.get_subprocess_output`
+    python method, allowing to execute a subprocess and collect its output.
+    \param self A PyObject* pointer to the _util module.
+    \param args A PyObject* pointer to the args tuple with the desired subprocess commands, and
+    optionally a boolean raise_on_empty flag.
+    \param kw A PyObject* pointer to the kw dict with optionally an env dict.
+    \return a PyObject * pointer to a python tuple with the stdout, stderr output and the
+    command exit code.
+
+    This function is callable as the `_util.subprocess_output` or `_util.get_subprocess_output`
+    python methods. The command arguments list is fed to the CGO callback, where the command is
+    executed in go-land. The stdout, stderr and exit codes for the command are returned by the
+    callback; these are then converted into python strings and integer respectively and returned
+    in a tuple. If the optional `raise_on_empty` boolean flag is set, and the command output is
+    empty an exception will be raised: the error will be set in the interpreter and NULL will be
+    returned.
+*/
+PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
+{
+    int raise = 0;
+    int ret_code = 0;
+    subprocess_command_t cmd = { 0 };
+    char *c_stdout = NULL;
+    char *c_stderr = NULL;
+    char *exception = NULL;
+    PyObject *cmd_args = NULL;
+    PyObject *cmd_raise_on_empty = NULL;
+    PyObject *cmd_env = NULL;
+    PyObject *pyResult = NULL;
+
+    if (!cb_get_subprocess_output) {
+        Py_RETURN_NONE;
+    }
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    static char *keywords[] = { "command", "raise_on_empty", "env", NULL };
+    // `cmd_args` is mandatory and should be a list, `cmd_raise_on_empty` is an optional
+    // boolean. The string after the ':' is used as the function name in error messages.
+    if (!PyArg_ParseTupleAndKeywords(args, kw, "O|O" PY_ARG_PARSE_TUPLE_KEYWORD_ONLY "O:get_subprocess_output",
+                                     keywords, &cmd_args, &cmd_raise_on_empty, &cmd_env)) {
+        goto cleanup;
+    }
+
+    if (!build_subprocess_command(cmd_args, cmd_env, &cmd)) {
+        goto cleanup;
+    }
+
     if (cmd_raise_on_empty != NULL && !PyBool_Check(cmd_raise_on_empty)) {
         PyErr_SetString(PyExc_TypeError, "bad raise_on_empty argument: should be bool");
         goto cleanup;
@@ -236,7 +305,7 @@ PyObject *subprocess_output(PyObject *self, PyObject *args, PyObject *kw)
     PyGILState_Release(gstate);
     PyThreadState *Tstate = PyEval_SaveThread();
 
-    cb_get_subprocess_output(subprocess_args, subprocess_env, &c_stdout, &c_stderr, &ret_code, &exception);
+    cb_get_subprocess_output(cmd.args, cmd.env, &c_stdout, &c_stderr, &ret_code, &exception);
 
     // Acquire the GIL now that Go is done
     PyEval_RestoreThread(Tstate);
@@ -288,23 +357,310 @@ cleanup:
         cgo_free(exception);
     }
 
-    if (subprocess_args) {
-        for (i = 0; i <= subprocess_args_sz && subprocess_args[i]; i++) {
-            _free(subprocess_args[i]);
+    free_subprocess_command(&cmd);
+
+    // Please note that if we get here we have a matching PyGILState_Ensure above, so we're safe.
+    PyGILState_Release(gstate);
+
+    // pyResult will be NULL in the face of error to raise the exception set by PyErr_SetString
+    return pyResult;
+}
+
+// Output stream of a command started by `_util.subprocess_output_stream`
+typedef struct {
+    PyObject_HEAD
+    int handle;
+    int running; // the command handle is still valid
+    int reading; // a thread is waiting for the next chunk without the GIL
+    char *buf; // output received and not consumed yet
+    size_t buf_pos;
+    size_t buf_len;
+    size_t buf_cap;
+    PyObject *py_stderr; // None until the output is exhausted
+    PyObject *py_ret_code; // None until the output is exhausted
+} subprocess_stream_t;
+
+/*! \fn static int stream_read(subprocess_stream_t *self, int cancel)
+    \brief Appends the next chunk of the command output to the stream buffer, or kills the
+    command when `cancel` is set.
+    \return an int value - 1 when a chunk was read, 0 once the output is exhausted and -1 on
+    error, with a python error set.
+
+    Must be called with the GIL held, it is released while waiting for the command.
+*/
+static int stream_read(subprocess_stream_t *self, int cancel)
+{
+    char *chunk = NULL;
+    int chunk_len = 0;
+    char *c_stderr = NULL;
+    int ret_code = 0;
+    char *exception = NULL;
+    int retval = 0;
+
+    if (!self->running) {
+        return 0;
+    }
+    if (self->reading) {
+        PyErr_SetString(PyExc_RuntimeError, "subprocess output is already being read by another thread");
+        return -1;
+    }
+
+    self->reading = 1;
+    Py_BEGIN_ALLOW_THREADS
+    cb_read_subprocess_output(self->handle, cancel, &chunk, &chunk_len, &c_stderr, &ret_code, &exception);
+    Py_END_ALLOW_THREADS
+    self->reading = 0;
+
+    if (exception) {
+        // the handle is released by the agent on errors
+        self->running = 0;
+        PyErr_SetString(PyExc_Exception, exception);
+        retval = -1;
+        goto cleanup;
+    }
+
+    if (chunk == NULL) {
+        self->running = 0;
+        Py_XDECREF(self->py_stderr);
+        Py_XDECREF(self->py_ret_code);
+        if (c_stderr) {
+            self->py_stderr = PyStringFromCString(c_stderr);
+        } else {
+            Py_INCREF(Py_None);
+            self->py_stderr = Py_None;
         }
-        _free(subprocess_args);
+#ifdef DATADOG_AGENT_THREE
+        self->py_ret_code = PyLong_FromLong(ret_code);
+#else
+        self->py_ret_code = PyInt_FromLong(ret_code);
+#endif
+        goto cleanup;
     }
 
-    if (subprocess_env) {
-        for (i = 0; i <= subprocess_env_sz && subprocess_env[i]; i++) {
-            _free(subprocess_env[i]);
+    // drop the consumed output before growing the buffer
+    if (self->buf_pos > 0) {
+        memmove(self->buf, self->buf + self->buf_pos, self->buf_len - self->buf_pos);
+        self->buf_len -= self->buf_pos;
+        self->buf_pos = 0;
+    }
+    if (self->buf_len + chunk_len > self->buf_cap) {
+        size_t cap = self->buf_cap ? self->buf_cap * 2 : (size_t)chunk_len;
+        while (cap < self->buf_len + chunk_len) {
+            cap *= 2;
         }
-        _free(subprocess_env);
+        char *buf = (char *)_malloc(cap);
+        if (buf == NULL) {
+            PyErr_SetString(PyExc_MemoryError, "unable to allocate memory, bailing out");
+            retval = -1;
+            goto cleanup;
+        }
+        if (self->buf) {
+            memcpy(buf, self->buf, self->buf_len);
+            _free(self->buf);
+        }
+        self->buf = buf;
+        self->buf_cap = cap;
     }
+    memcpy(self->buf + self->buf_len, chunk, chunk_len);
+    self->buf_len += chunk_len;
+    retval = 1;
 
-    // Please note that if we get here we have a matching PyGILState_Ensure above, so we're safe.
-    PyGILState_Release(gstate);
+cleanup:
+    if (chunk) {
+        cgo_free(chunk);
+    }
+    if (c_stderr) {
+        cgo_free(c_stderr);
+    }
+    if (exception) {
+        cgo_free(exception);
+    }
+    return retval;
+}
 
-    // pyResult will be NULL in the face of error to raise the exception set by PyErr_SetString
-    return pyResult;
+/*! \fn static void stream_release_buffer(subprocess_stream_t *self)
+    \brief Frees the output buffer once the stream is exhausted or closed.
+*/
+static void stream_release_buffer(subprocess_stream_t *self)
+{
+    _free(self->buf);
+    self->buf = NULL;
+    self->buf_pos = self->buf_len = self->buf_cap = 0;
+}
+
+/*! \fn static PyObject *stream_iternext(subprocess_stream_t *self)
+    \brief Returns the next line of the command output, trailing newline included.
+    \return a PyObject * pointer to a python string, or NULL once the output is exhausted or
+    in an error.
+*/
+static PyObject *stream_iternext(subprocess_stream_t *self)
+{
+    for (;;) {
+        char *line = self->buf + self->buf_pos;
+        size_t avail = self->buf_len - self->buf_pos;
+        char *newline = avail ? memchr(line, '\n', avail) : NULL;
+
+        if (newline != NULL || (!self->running && avail > 0)) {
+            size_t line_len = newline != NULL ? (size_t)(newline - line) + 1 : avail;
+            self->buf_pos += line_len;
+#ifdef DATADOG_AGENT_THREE
+            return PyUnicode_DecodeUTF8(line, line_len, NULL);
+#else
+            return PyString_FromStringAndSize(line, line_len);
+#endif
+        }
+
+        int read = stream_read(self, 0);
+        if (read < 0) {
+            return NULL;
+        } else if (read == 0 && self->buf_pos == self->buf_len) {
+            // stop the iteration without setting an error once the output is exhausted
+            stream_release_buffer(self);
+            return NULL;
+        }
+    }
+}
+
+/*! \fn static PyObject *stream_close(subprocess_stream_t *self, PyObject *args)
+    \brief Kills the command if it is still running, the remaining output is discarded.
+    \return a PyObject * pointer to None, or NULL in an error.
+*/
+static PyObject *stream_close(subprocess_stream_t *self, PyObject *args)
+{
+    if (stream_read(self, 1) < 0) {
+        return NULL;
+    }
+    stream_release_buffer(self);
+    Py_RETURN_NONE;
+}
+
+static void stream_dealloc(subprocess_stream_t *self)
+{
+    // don't leave the command running when the stream isn't exhausted
+    if (stream_read(self, 1) < 0) {
+        PyErr_Clear();
+    }
+    _free(self->buf);
+    Py_XDECREF(self->py_stderr);
+    Py_XDECREF(self->py_ret_code);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *stream_get_stderr(subprocess_stream_t *self, void *closure)
+{
+    PyObject *retval = self->py_stderr ? self->py_stderr : Py_None;
+    Py_INCREF(retval);
+    return retval;
+}
+
+static PyObject *stream_get_returncode(subprocess_stream_t *self, void *closure)
+{
+    PyObject *retval = self->py_ret_code ? self->py_ret_code : Py_None;
+    Py_INCREF(retval);
+    return retval;
+}
+
+static PyMethodDef stream_methods[] = {
+    { "close", (PyCFunction)stream_close, METH_NOARGS, "Kill the process and discard the remaining output." },
+    { NULL, NULL } // guards
+};
+
+static PyGetSetDef stream_getset[] = {
+    { "stderr", (getter)stream_get_stderr, NULL, "The process stderr, None until the output is exhausted.", NULL },
+    { "returncode", (getter)stream_get_returncode, NULL, "The process exit code, None until the output is exhausted.",
+      NULL },
+    { NULL } // guards
+};
+
+static PyTypeObject SubprocessOutputStreamType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = _UTIL_MODULE_NAME _DOT "SubprocessOutputStream",
+    .tp_basicsize = sizeof(subprocess_stream_t),
+    .tp_dealloc = (destructor)stream_dealloc,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Iterator over the lines of the output of a process.",
+    .tp_iter = PyObject_SelfIter,
+    .tp_iternext = (iternextfunc)stream_iternext,
+    .tp_methods = stream_methods,
+    .tp_getset = stream_getset,
+};
+
+/*! \fn PyObject *subprocess_output_stream(PyObject *self, PyObject *args, PyObject *kw)
+    \brief This function implements the `_util.subprocess_output_stream` python method, allowing
+    to execute a subprocess and iterate over its output while it runs.
+    \param self A PyObject* pointer to the _util module.
+    \param args A PyObject* pointer to the args tuple with the desired subprocess commands.
+    \param kw A PyObject* pointer to the kw dict with optionally an env dict.
+    \return a PyObject * pointer to a `_util.SubprocessOutputStream` iterator, None if the
+    callbacks aren't set, or NULL in an error.
+
+    The command is started in go-land by the cb_start_subprocess callback and its stdout is
+    pulled chunk by chunk with cb_read_subprocess_output as the iterator is consumed, so only
+    the output not consumed yet is kept in memory and parsing overlaps with the command
+    execution. Once the iterator is exhausted its `stderr` and `returncode` attributes are set.
+    Closing the iterator, or dropping it before the end of the output, kills the command.
+*/
+PyObject *subprocess_output_stream(PyObject *self, PyObject *args, PyObject *kw)
+{
+    int handle = 0;
+    char *exception = NULL;
+    subprocess_command_t cmd = { 0 };
+    PyObject *cmd_args = NULL;
+    PyObject *cmd_env = NULL;
+    subprocess_stream_t *stream = NULL;
+
+    if (!cb_start_subprocess || !cb_read_subprocess_output) {
+        Py_RETURN_NONE;
+    }
+
+    static char *keywords[] = { "command", "env", NULL };
+    if (!PyArg_ParseTupleAndKeywords(args, kw, "O|" PY_ARG_PARSE_TUPLE_KEYWORD_ONLY "O:subprocess_output_stream",
+                                     keywords, &cmd_args, &cmd_env)) {
+        goto cleanup;
+    }
+
+    if (!build_subprocess_command(cmd_args, cmd_env, &cmd)) {
+        goto cleanup;
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    cb_start_subprocess(cmd.args, cmd.env, &handle, &exception);
+    Py_END_ALLOW_THREADS
+
+    if (exception) {
+        PyErr_SetString(PyExc_Exception, exception);
+        goto cleanup;
+    }
+
+    stream = PyObject_New(subprocess_stream_t, &SubprocessOutputStreamType);
+    if (stream == NULL) {
+        // don't leave the command running
+        char *chunk = NULL, *c_stderr = NULL;
+        int chunk_len = 0, ret_code = 0;
+        cb_read_subprocess_output(handle, 1, &chunk, &chunk_len, &c_stderr, &ret_code, &exception);
+        if (chunk) {
+            cgo_free(chunk);
+        }
+        if (c_stderr) {
+            cgo_free(c_stderr);
+        }
+        goto cleanup;
+    }
+    stream->handle = handle;
+    stream->running = 1;
+    stream->reading = 0;
+    stream->buf = NULL;
+    stream->buf_pos = 0;
+    stream->buf_len = 0;
+    stream->buf_cap = 0;
+    stream->py_stderr = NULL;
+    stream->py_ret_code = NULL;
+
+cleanup:
+    if (exception) {
+        cgo_free(exception);
+    }
+    free_subprocess_command(&cmd);
+
+    return (PyObject *)stream;
 }
@@ -37,6 +37,16 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn void _set_subprocess_output_stream_cbs(cb_start_subprocess_t, cb_read_subprocess_output_t)
+    \brief Sets the callbacks to be used by rtloader to run subprocess commands and stream
+    their output.
+    \param start A function pointer with cb_start_subprocess_t prototype to the callback
+    function starting a command.
+    \param read A function pointer with cb_read_subprocess_output_t prototype to the callback
+    function reading the output of a started command.
+
+    The callbacks are expected to be provided by the rtloader caller - in go-context: CGO.
+*/
 
 #define _DOT "."
 #define _UTIL_MODULE_NAME "_util"
@@ -63,6 +73,7 @@ void Py2_init__util();
 #endif
 
 void _set_get_subprocess_output_cb(cb_get_subprocess_output_t);
+void _set_subprocess_output_stream_cbs(cb_start_subprocess_t, cb_read_subprocess_output_t);
 #ifdef __cplusplus
 }
 #endif
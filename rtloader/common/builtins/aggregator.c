@@ -3,29 +3,40 @@
 // This product includes software developed at Datadog (https://www.datadoghq.com/).
 // Copyright 2019-present Datadog, Inc.
 #include "aggregator.h"
+#include "fastcall.h"
+#include "free_threading.h"
 #include "rtloader_mem.h"
 #include "stringutils.h"
 
 // these must be set by the Agent
 static cb_submit_metric_t cb_submit_metric = NULL;
+static cb_submit_metric_batch_t cb_submit_metric_batch = NULL;
 static cb_submit_service_check_t cb_submit_service_check = NULL;
 static cb_submit_event_t cb_submit_event = NULL;
 static cb_submit_histogram_bucket_t cb_submit_histogram_bucket = NULL;
+static cb_submit_histogram_buckets_t cb_submit_histogram_buckets = NULL;
 static cb_submit_event_platform_event_t cb_submit_event_platform_event = NULL;
+static cb_submit_event_platform_events_t cb_submit_event_platform_events = NULL;
 
 // forward declarations
-static PyObject *submit_metric(PyObject *self, PyObject *args);
-static PyObject *submit_service_check(PyObject *self, PyObject *args);
-static PyObject *submit_event(PyObject *self, PyObject *args);
-static PyObject *submit_histogram_bucket(PyObject *self, PyObject *args);
-static PyObject *submit_event_platform_event(PyObject *self, PyObject *args);
+static PyObject *submit_metric(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *submit_metrics_batch(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *submit_service_check(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *submit_event(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *submit_histogram_bucket(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *submit_histogram_buckets(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *submit_event_platform_event(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *submit_event_platform_events(PyObject *self, RTLOADER_FASTCALL_ARGS);
 
 static PyMethodDef methods[] = {
-    { "submit_metric", (PyCFunction)submit_metric, METH_VARARGS, "Submit metrics." },
-    { "submit_service_check", (PyCFunction)submit_service_check, METH_VARARGS, "Submit service checks." },
-    { "submit_event", (PyCFunction)submit_event, METH_VARARGS, "Submit events." },
-    { "submit_histogram_bucket", (PyCFunction)submit_histogram_bucket, METH_VARARGS, "Submit histogram bucket." },
-    { "submit_event_platform_event", (PyCFunction)submit_event_platform_event, METH_VARARGS, "Submit event platform event." },
+    { "submit_metric", (PyCFunction)submit_metric, RTLOADER_METH_FASTCALL, "Submit metrics." },
+    { "submit_metrics_batch", (PyCFunction)submit_metrics_batch, RTLOADER_METH_FASTCALL, "Submit a batch of metrics." },
+    { "submit_service_check", (PyCFunction)submit_service_check, RTLOADER_METH_FASTCALL, "Submit service checks." },
+    { "submit_event", (PyCFunction)submit_event, RTLOADER_METH_FASTCALL, "Submit events." },
+    { "submit_histogram_bucket", (PyCFunction)submit_histogram_bucket, RTLOADER_METH_FASTCALL, "Submit histogram bucket." },
+    { "submit_histogram_buckets", (PyCFunction)submit_histogram_buckets, RTLOADER_METH_FASTCALL, "Submit all the buckets of a histogram." },
+    { "submit_event_platform_event", (PyCFunction)submit_event_platform_event, RTLOADER_METH_FASTCALL, "Submit event platform event." },
+    { "submit_event_platform_events", (PyCFunction)submit_event_platform_events, RTLOADER_METH_FASTCALL, "Submit a batch of event platform events." },
     { NULL, NULL } // guards
 };
 
@@ -54,6 +65,7 @@ static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, AGGREGATOR_MODUL
 PyMODINIT_FUNC PyInit_aggregator(void)
 {
     PyObject *m = PyModule_Create(&module_def);
+    RTLOADER_MODULE_GIL_NOT_USED(m);
     add_constants(m);
     return m;
 }
@@ -73,6 +85,11 @@ void _set_submit_metric_cb(cb_submit_metric_t cb)
     cb_submit_metric = cb;
 }
 
+void _set_submit_metric_batch_cb(cb_submit_metric_batch_t cb)
+{
+    cb_submit_metric_batch = cb;
+}
+
 void _set_submit_service_check_cb(cb_submit_service_check_t cb)
 {
     cb_submit_service_check = cb;
@@ -88,11 +105,21 @@ void _set_submit_histogram_bucket_cb(cb_submit_histogram_bucket_t cb)
     cb_submit_histogram_bucket = cb;
 }
 
+void _set_submit_histogram_buckets_cb(cb_submit_histogram_buckets_t cb)
+{
+    cb_submit_histogram_buckets = cb;
+}
+
 void _set_submit_event_platform_event_cb(cb_submit_event_platform_event_t cb)
 {
     cb_submit_event_platform_event = cb;
 }
 
+void _set_submit_event_platform_events_cb(cb_submit_event_platform_events_t cb)
+{
+    cb_submit_event_platform_events = cb;
+}
+
 
 /*! \fn py_tag_to_c(PyObject *py_tags)
     \brief A function to convert a list of python strings (tags) into an
@@ -100,9 +127,12 @@ void _set_submit_event_platform_event_cb(cb_submit_event_platform_event_t cb)
     \return a char ** pointer to the C-representation of the provided python
     tag list. In the event of failure NULL is returned.
 
-    The returned char ** string array pointer is heap allocated here and should
-    be subsequently freed by the caller. This function may set and raise python
-    interpreter errors. The function is static and not in the builtin's API.
+    The returned char ** string array pointer is allocated from the arena of the
+    calling thread, the caller releases it by resetting the arena to a mark taken
+    beforehand. The tags themselves are interned and owned by the shared intern table,
+    the caller must hold it with `acquire_interned_strings` until it's done with them.
+    This function may set and raise python interpreter errors. The function is static
+    and not in the builtin's API.
 */
 static char **py_tag_to_c(PyObject *py_tags)
 {
@@ -119,7 +149,7 @@ static char **py_tag_to_c(PyObject *py_tags)
         PyErr_SetString(PyExc_RuntimeError, "could not compute tags length");
         return NULL;
     } else if (len == 0) {
-        if (!(tags = _malloc(sizeof(*tags)))) {
+        if (!(tags = _arena_malloc(sizeof(*tags)))) {
             PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for tags");
             return NULL;
         }
@@ -132,7 +162,7 @@ static char **py_tag_to_c(PyObject *py_tags)
         goto done;
     }
 
-    if (!(tags = _malloc(sizeof(*tags) * (len + 1)))) {
+    if (!(tags = _arena_malloc(sizeof(*tags) * (len + 1)))) {
         PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for tags");
         goto done;
     }
@@ -142,7 +172,7 @@ static char **py_tag_to_c(PyObject *py_tags)
         // `item` is borrowed, no need to decref
         PyObject *item = PySequence_Fast_GET_ITEM(py_tags_list, i);
 
-        char *ctag = as_string(item);
+        char *ctag = as_interned_string(item);
         if (ctag == NULL) {
             continue;
         }
@@ -156,33 +186,17 @@ done:
     return tags;
 }
 
-/*! \fn free_tags(char **tags)
-    \brief A helper function to free the memory allocated by the py_tag_to_c() function.
-
-    This function is for internal use and expects the tag array to be properly intialized,
-    and have a NULL canary at the end of the array, just like py_tag_to_c() initializes and
-    populates the array. Be mindful if using this function in any other context.
-*/
-static void free_tags(char **tags)
-{
-    int i;
-    for (i = 0; tags[i] != NULL; i++) {
-        _free(tags[i]);
-    }
-    _free(tags);
-}
-
-/*! \fn submit_metric(PyObject *self, PyObject *args)
+/*! \fn submit_metric(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief Aggregator builtin class method for metric submission.
     \param self A PyObject * pointer to self - the aggregator module.
-    \param args A PyObject * pointer to the python args or kwargs.
+    \param args The python positional args, see RTLOADER_FASTCALL_ARGS.
     \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
 
     This function implements the `submit_metric` python callable in C and is used from the python code.
     More specifically, in the context of rtloader and datadog-agent, this is called from our python base check
     class to submit metrics to the aggregator.
 */
-static PyObject *submit_metric(PyObject *self, PyObject *args)
+static PyObject *submit_metric(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     if (cb_submit_metric == NULL) {
         Py_RETURN_NONE;
@@ -199,9 +213,11 @@ static PyObject *submit_metric(PyObject *self, PyObject *args)
     int mt;
     double value;
     bool flush_first_value = false;
+    rtloader_arena_mark_t mark = _arena_mark();
+    acquire_interned_strings();
 
     // Python call: aggregator.submit_metric(self, check_id, aggregator.metric_type.GAUGE, name, value, tags, hostname, flush_first_value)
-    if (!PyArg_ParseTuple(args, "OsisdOs|b", &check, &check_id, &mt, &name, &value, &py_tags, &hostname, &flush_first_value)) {
+    if (!RTLOADER_PARSE_ARGS("OsisdOs|b", &check, &check_id, &mt, &name, &value, &py_tags, &hostname, &flush_first_value)) {
         goto error;
     }
 
@@ -210,27 +226,198 @@ static PyObject *submit_metric(PyObject *self, PyObject *args)
 
     cb_submit_metric(check_id, mt, name, value, tags, hostname, flush_first_value);
 
-    free_tags(tags);
-
+    release_interned_strings();
+    _arena_reset(mark);
     PyGILState_Release(gstate);
     Py_RETURN_NONE;
 
 error:
+    release_interned_strings();
+    _arena_reset(mark);
     PyGILState_Release(gstate);
     return NULL;
 }
 
-/*! \fn submit_service_check(PyObject *self, PyObject *args)
+/*! \fn free_metric_batch(metric_batch_t *batch)
+    \brief A helper function to free the memory allocated by submit_metrics_batch().
+    \param batch A metric_batch_t * pointer to the batch to release.
+
+    Names and hostnames are borrowed from the python objects and tags are owned by the
+    intern table, none of them are freed here.
+*/
+static void free_metric_batch(metric_batch_t *batch)
+{
+    _free(batch->types);
+    _free(batch->names);
+    _free(batch->values);
+    _free(batch->hostnames);
+    _free(batch->flush_first_values);
+    _free(batch->tags_offsets);
+    _free(batch->tags);
+}
+
+/*! \fn submit_metrics_batch(PyObject *self, RTLOADER_FASTCALL_ARGS)
+    \brief Aggregator builtin class method for batched metric submission.
+    \param self A PyObject * pointer to self - the aggregator module.
+    \param args The python positional args, see RTLOADER_FASTCALL_ARGS.
+    \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
+
+    This function implements the `submit_metrics_batch` python callable in C. Each item of the
+    `metrics` sequence is a `(metric_type, name, value, tags, hostname[, flush_first_value])`
+    tuple. The whole sequence is packed into a columnar metric_batch_t and handed over to the
+    agent in a single callback, instead of crossing into go-land once per sample.
+*/
+static PyObject *submit_metrics_batch(PyObject *self, RTLOADER_FASTCALL_ARGS)
+{
+    if (cb_submit_metric_batch == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    PyObject *check = NULL; // borrowed
+    PyObject *py_metrics = NULL; // borrowed
+    PyObject *py_metrics_list = NULL; // new reference
+    PyObject **py_tags = NULL; // borrowed items
+    PyObject *retval = NULL;
+    char *check_id = NULL;
+    metric_batch_t batch = { 0 };
+    Py_ssize_t count = 0;
+    Py_ssize_t tags_cap = 0;
+    int tags_len = 0;
+    int i;
+
+    acquire_interned_strings();
+
+    // Python call: aggregator.submit_metrics_batch(self, check_id, [(aggregator.GAUGE, name, value, tags, hostname, flush_first_value), ...])
+    if (!RTLOADER_PARSE_ARGS("OsO", &check, &check_id, &py_metrics)) {
+        goto done;
+    }
+
+    py_metrics_list = PySequence_Fast(py_metrics, "metrics must be a sequence"); // new reference
+    if (py_metrics_list == NULL) {
+        goto done;
+    }
+
+    count = PySequence_Fast_GET_SIZE(py_metrics_list);
+    if (count == 0) {
+        Py_INCREF(Py_None);
+        retval = Py_None;
+        goto done;
+    } else if (count > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "too many metrics in batch");
+        goto done;
+    }
+
+    batch.count = (int)count;
+    batch.types = _malloc(sizeof(*batch.types) * count);
+    batch.names = _malloc(sizeof(*batch.names) * count);
+    batch.values = _malloc(sizeof(*batch.values) * count);
+    batch.hostnames = _malloc(sizeof(*batch.hostnames) * count);
+    batch.flush_first_values = _malloc(sizeof(*batch.flush_first_values) * count);
+    batch.tags_offsets = _malloc(sizeof(*batch.tags_offsets) * count);
+    py_tags = _malloc(sizeof(*py_tags) * count);
+    if (!batch.types || !batch.names || !batch.values || !batch.hostnames || !batch.flush_first_values
+        || !batch.tags_offsets || !py_tags) {
+        PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for metrics batch");
+        goto done;
+    }
+
+    // first pass: unpack every sample and compute an upper bound of the number of tags,
+    // one NULL canary per sample included. Strings returned by the argument parsing are owned
+    // by the python objects that stay alive for the whole call.
+    tags_cap = count;
+    for (i = 0; i < count; i++) {
+        // `item` is borrowed, no need to decref
+        PyObject *item = PySequence_Fast_GET_ITEM(py_metrics_list, i);
+        int mt;
+        bool flush_first_value = false;
+
+        if (!PyTuple_Check(item)) {
+            PyErr_SetString(PyExc_TypeError, "metrics must be tuples");
+            goto done;
+        }
+#ifdef DATADOG_AGENT_THREE
+        if (!parse_fastcall_args(PySequence_Fast_ITEMS(item), PyTuple_GET_SIZE(item), "isdOs|b", &mt,
+                                 &batch.names[i], &batch.values[i], &py_tags[i], &batch.hostnames[i],
+                                 &flush_first_value)) {
+#else
+        if (!PyArg_ParseTuple(item, "isdOs|b", &mt, &batch.names[i], &batch.values[i], &py_tags[i],
+                              &batch.hostnames[i], &flush_first_value)) {
+#endif
+            goto done;
+        }
+        if (!PySequence_Check(py_tags[i])) {
+            PyErr_SetString(PyExc_TypeError, "tags must be a sequence");
+            goto done;
+        }
+        Py_ssize_t len = PySequence_Length(py_tags[i]);
+        if (len == -1) {
+            PyErr_SetString(PyExc_RuntimeError, "could not compute tags length");
+            goto done;
+        }
+        batch.types[i] = mt;
+        batch.flush_first_values[i] = flush_first_value;
+        tags_cap += len;
+    }
+
+    if (tags_cap > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "too many tags in batch");
+        goto done;
+    }
+    if (!(batch.tags = _malloc(sizeof(*batch.tags) * tags_cap))) {
+        PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for tags");
+        goto done;
+    }
+
+    // second pass: flatten the tags, skipping the invalid ones like py_tag_to_c() does
+    for (i = 0; i < count; i++) {
+        PyObject *py_tags_list = PySequence_Fast(py_tags[i], "py_tags is not a sequence"); // new reference
+        if (py_tags_list == NULL) {
+            goto done;
+        }
+
+        batch.tags_offsets[i] = tags_len;
+        Py_ssize_t j;
+        for (j = 0; j < PySequence_Fast_GET_SIZE(py_tags_list); j++) {
+            // `tag` is borrowed, no need to decref
+            PyObject *tag = PySequence_Fast_GET_ITEM(py_tags_list, j);
+
+            char *ctag = as_interned_string(tag);
+            if (ctag == NULL) {
+                continue;
+            }
+            batch.tags[tags_len++] = ctag;
+        }
+        batch.tags[tags_len++] = NULL;
+        Py_XDECREF(py_tags_list);
+    }
+
+    cb_submit_metric_batch(check_id, &batch);
+
+    Py_INCREF(Py_None);
+    retval = Py_None;
+
+done:
+    free_metric_batch(&batch);
+    _free(py_tags);
+    Py_XDECREF(py_metrics_list);
+    release_interned_strings();
+    PyGILState_Release(gstate);
+    return retval;
+}
+
+/*! \fn submit_service_check(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief Aggregator builtin class method for service_check submission.
     \param self A PyObject * pointer to self - the aggregator module.
-    \param args A PyObject * pointer to the python args or kwargs.
+    \param args The python positional args, see RTLOADER_FASTCALL_ARGS.
     \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
 
     This function implements the `submit_service_check` python callable in C and is used from the python code.
     More specifically, in the context of rtloader and datadog-agent, this is called from our python base check
     class to submit service_checks to the aggregator.
 */
-static PyObject *submit_service_check(PyObject *self, PyObject *args)
+static PyObject *submit_service_check(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     if (cb_submit_service_check == NULL) {
         Py_RETURN_NONE;
@@ -247,9 +434,11 @@ static PyObject *submit_service_check(PyObject *self, PyObject *args)
     char *message = NULL;
     char *check_id = NULL;
     char **tags = NULL;
+    rtloader_arena_mark_t mark = _arena_mark();
+    acquire_interned_strings();
 
     // aggregator.submit_service_check(self, check_id, name, status, tags, hostname, message)
-    if (!PyArg_ParseTuple(args, "OssiOss", &check, &check_id, &name, &status, &py_tags, &hostname, &message)) {
+    if (!RTLOADER_PARSE_ARGS("OssiOss", &check, &check_id, &name, &status, &py_tags, &hostname, &message)) {
         goto error;
     }
 
@@ -258,27 +447,29 @@ static PyObject *submit_service_check(PyObject *self, PyObject *args)
 
     cb_submit_service_check(check_id, name, status, tags, hostname, message);
 
-    free_tags(tags);
-
+    release_interned_strings();
+    _arena_reset(mark);
     PyGILState_Release(gstate);
     Py_RETURN_NONE;
 
 error:
+    release_interned_strings();
+    _arena_reset(mark);
     PyGILState_Release(gstate);
     return NULL;
 }
 
-/*! \fn submit_event(PyObject *self, PyObject *args)
+/*! \fn submit_event(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief Aggregator builtin class method for event submission.
     \param self A PyObject * pointer to self - the aggregator module.
-    \param args A PyObject * pointer to the python args or kwargs.
+    \param args The python positional args, see RTLOADER_FASTCALL_ARGS.
     \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
 
     This function implements the `submit_event` python callable in C and is used from the python code.
     More specifically, in the context of rtloader and datadog-agent, this is called from our python base check
     class to submit events to the aggregator.
 */
-static PyObject *submit_event(PyObject *self, PyObject *args)
+static PyObject *submit_event(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     if (cb_submit_event == NULL) {
         Py_RETURN_NONE;
@@ -292,10 +483,12 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
     char *check_id = NULL;
     event_t *ev = NULL;
     PyObject * retval = NULL;
+    rtloader_arena_mark_t mark = _arena_mark();
+    acquire_interned_strings();
 
     // aggregator.submit_event(self, check_id, event)
-    if (!PyArg_ParseTuple(args, "OsO", &check, &check_id, &event_dict)) {
-        // error is set by PyArg_ParseTuple but we return NULL to raise
+    if (!RTLOADER_PARSE_ARGS("OsO", &check, &check_id, &event_dict)) {
+        // error is set by RTLOADER_PARSE_ARGS but we return NULL to raise
         retval = NULL;
         goto gstate_cleanup;
     }
@@ -307,15 +500,16 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
         goto gstate_cleanup;
     }
 
-    if (!(ev = (event_t *)_malloc(sizeof(event_t)))) {
+    if (!(ev = (event_t *)_arena_malloc(sizeof(event_t)))) {
         PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for event");
         retval = NULL;
         goto gstate_cleanup;
     }
 
-    // notice: PyDict_GetItemString returns a borrowed ref or NULL if key was not found
-    ev->title = as_string(PyDict_GetItemString(event_dict, "msg_title"));
-    ev->text = as_string(PyDict_GetItemString(event_dict, "msg_text"));
+    // notice: PyDict_GetItemString returns a borrowed ref or NULL if key was not found.
+    // Strings are borrowed from the event dict that is kept alive for the whole call.
+    ev->title = (char *)as_borrowed_utf8(PyDict_GetItemString(event_dict, "msg_title"));
+    ev->text = (char *)as_borrowed_utf8(PyDict_GetItemString(event_dict, "msg_text"));
     // PyLong_AsLong will fail if called passing a NULL argument, be safe
     if (PyDict_GetItemString(event_dict, "timestamp") != NULL) {
         ev->ts = PyLong_AsLong(PyDict_GetItemString(event_dict, "timestamp"));
@@ -329,12 +523,12 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
     } else {
         ev->ts = 0;
     }
-    ev->priority = as_string(PyDict_GetItemString(event_dict, "priority"));
-    ev->host = as_string(PyDict_GetItemString(event_dict, "host"));
-    ev->alert_type = as_string(PyDict_GetItemString(event_dict, "alert_type"));
-    ev->aggregation_key = as_string(PyDict_GetItemString(event_dict, "aggregation_key"));
-    ev->source_type_name = as_string(PyDict_GetItemString(event_dict, "source_type_name"));
-    ev->event_type = as_string(PyDict_GetItemString(event_dict, "event_type"));
+    ev->priority = (char *)as_borrowed_utf8(PyDict_GetItemString(event_dict, "priority"));
+    ev->host = (char *)as_borrowed_utf8(PyDict_GetItemString(event_dict, "host"));
+    ev->alert_type = (char *)as_borrowed_utf8(PyDict_GetItemString(event_dict, "alert_type"));
+    ev->aggregation_key = (char *)as_borrowed_utf8(PyDict_GetItemString(event_dict, "aggregation_key"));
+    ev->source_type_name = (char *)as_borrowed_utf8(PyDict_GetItemString(event_dict, "source_type_name"));
+    ev->event_type = (char *)as_borrowed_utf8(PyDict_GetItemString(event_dict, "event_type"));
     // process the list of tags, set ev->tags = NULL if tags are missing
     py_tags = PyDict_GetItemString(event_dict, "tags");
     if (py_tags != NULL) {
@@ -342,7 +536,7 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
         if (ev->tags == NULL) {
             // we need to return NULL to raise the exception set by PyErr_SetString in py_tag_to_c
             retval = NULL;
-            goto ev_cleanup;
+            goto gstate_cleanup;
         }
     } else {
         ev->tags = NULL;
@@ -355,27 +549,16 @@ static PyObject *submit_event(PyObject *self, PyObject *args)
     Py_INCREF(Py_None); //Increment, sice we are not using the macro Py_RETURN_NONE that does it for us
     retval = Py_None;
 
-ev_cleanup:
-    if (ev->tags != NULL) {
-        free_tags(ev->tags);
-    }
-    _free(ev->title);
-    _free(ev->text);
-    _free(ev->priority);
-    _free(ev->host);
-    _free(ev->alert_type);
-    _free(ev->aggregation_key);
-    _free(ev->source_type_name);
-    _free(ev->event_type);
-    _free(ev);
-
 gstate_cleanup:
+    // releases the event and its tags
+    release_interned_strings();
+    _arena_reset(mark);
     PyGILState_Release(gstate);
 
     return retval;
 }
 
-static PyObject *submit_histogram_bucket(PyObject *self, PyObject *args)
+static PyObject *submit_histogram_bucket(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     if (cb_submit_histogram_bucket == NULL) {
         Py_RETURN_NONE;
@@ -394,9 +577,11 @@ static PyObject *submit_histogram_bucket(PyObject *self, PyObject *args)
     char *hostname = NULL;
     char **tags = NULL;
     bool flush_first_value = false;
+    rtloader_arena_mark_t mark = _arena_mark();
+    acquire_interned_strings();
 
     // Python call: aggregator.submit_histogram_bucket(self, metric string, value, lowerBound, upperBound, monotonic, hostname, tags, flush_first_value)
-    if (!PyArg_ParseTuple(args, "OssLffisO|b", &check, &check_id, &name, &value, &lower_bound, &upper_bound, &monotonic, &hostname, &py_tags, &flush_first_value)) {
+    if (!RTLOADER_PARSE_ARGS("OssLffisO|b", &check, &check_id, &name, &value, &lower_bound, &upper_bound, &monotonic, &hostname, &py_tags, &flush_first_value)) {
         goto error;
     }
 
@@ -405,17 +590,224 @@ static PyObject *submit_histogram_bucket(PyObject *self, PyObject *args)
 
     cb_submit_histogram_bucket(check_id, name, value, lower_bound, upper_bound, monotonic, hostname, tags, flush_first_value);
 
-    free_tags(tags);
-
+    release_interned_strings();
+    _arena_reset(mark);
     PyGILState_Release(gstate);
     Py_RETURN_NONE;
 
 error:
+    release_interned_strings();
+    _arena_reset(mark);
     PyGILState_Release(gstate);
     return NULL;
 }
 
-static PyObject *submit_event_platform_event(PyObject *self, PyObject *args)
+/*! \fn submit_histogram_buckets(PyObject *self, RTLOADER_FASTCALL_ARGS)
+    \brief Aggregator builtin class method for the submission of a whole histogram.
+    \param self A PyObject * pointer to self - the aggregator module.
+    \param args The python positional args, see RTLOADER_FASTCALL_ARGS.
+    \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
+
+    This function implements the `submit_histogram_buckets` python callable in C. The buckets
+    of a histogram share their name, hostname and tags, and are given as three sequences of
+    the same length: the bucket values and their lower and upper bounds. The shared tags are
+    converted once and all the buckets are handed over to the agent in a single callback,
+    instead of one `submit_histogram_bucket` call per bucket.
+*/
+static PyObject *submit_histogram_buckets(PyObject *self, RTLOADER_FASTCALL_ARGS)
+{
+    if (cb_submit_histogram_buckets == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    PyObject *check = NULL; // borrowed
+    PyObject *py_tags = NULL; // borrowed
+    PyObject *py_values = NULL; // borrowed
+    PyObject *py_lower_bounds = NULL; // borrowed
+    PyObject *py_upper_bounds = NULL; // borrowed
+    PyObject *py_values_list = NULL; // new reference
+    PyObject *py_lower_bounds_list = NULL; // new reference
+    PyObject *py_upper_bounds_list = NULL; // new reference
+    PyObject *retval = NULL;
+    char *check_id = NULL;
+    char *name = NULL;
+    char *hostname = NULL;
+    char **tags = NULL;
+    long long *values = NULL;
+    float *lower_bounds = NULL;
+    float *upper_bounds = NULL;
+    int monotonic;
+    bool flush_first_value = false;
+    Py_ssize_t count;
+    Py_ssize_t i;
+    rtloader_arena_mark_t mark = _arena_mark();
+    acquire_interned_strings();
+
+    // Python call: aggregator.submit_histogram_buckets(self, check_id, name, values, lower_bounds, upper_bounds, monotonic, hostname, tags, flush_first_value)
+    if (!RTLOADER_PARSE_ARGS("OssOOOisO|b", &check, &check_id, &name, &py_values, &py_lower_bounds, &py_upper_bounds,
+                             &monotonic, &hostname, &py_tags, &flush_first_value)) {
+        goto done;
+    }
+
+    py_values_list = PySequence_Fast(py_values, "values must be a sequence"); // new reference
+    if (py_values_list == NULL) {
+        goto done;
+    }
+    py_lower_bounds_list = PySequence_Fast(py_lower_bounds, "lower bounds must be a sequence"); // new reference
+    if (py_lower_bounds_list == NULL) {
+        goto done;
+    }
+    py_upper_bounds_list = PySequence_Fast(py_upper_bounds, "upper bounds must be a sequence"); // new reference
+    if (py_upper_bounds_list == NULL) {
+        goto done;
+    }
+
+    count = PySequence_Fast_GET_SIZE(py_values_list);
+    if (PySequence_Fast_GET_SIZE(py_lower_bounds_list) != count
+        || PySequence_Fast_GET_SIZE(py_upper_bounds_list) != count) {
+        PyErr_SetString(PyExc_ValueError, "values and bounds must have the same length");
+        goto done;
+    } else if (count == 0) {
+        Py_INCREF(Py_None);
+        retval = Py_None;
+        goto done;
+    } else if (count > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "too many histogram buckets");
+        goto done;
+    }
+
+    values = _arena_malloc(sizeof(*values) * count);
+    lower_bounds = _arena_malloc(sizeof(*lower_bounds) * count);
+    upper_bounds = _arena_malloc(sizeof(*upper_bounds) * count);
+    if (!values || !lower_bounds || !upper_bounds) {
+        PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for histogram buckets");
+        goto done;
+    }
+
+    for (i = 0; i < count; i++) {
+        // items are borrowed, no need to decref
+        PyObject *value = PySequence_Fast_GET_ITEM(py_values_list, i);
+        double lower_bound;
+        double upper_bound;
+
+        if (PyFloat_Check(value)) {
+            PyErr_SetString(PyExc_TypeError, "integer argument expected, got float");
+            goto done;
+        }
+        if ((values[i] = PyLong_AsLongLong(value)) == -1 && PyErr_Occurred()) {
+            goto done;
+        }
+        lower_bound = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(py_lower_bounds_list, i));
+        if (lower_bound == -1.0 && PyErr_Occurred()) {
+            goto done;
+        }
+        upper_bound = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(py_upper_bounds_list, i));
+        if (upper_bound == -1.0 && PyErr_Occurred()) {
+            goto done;
+        }
+        lower_bounds[i] = (float)lower_bound;
+        upper_bounds[i] = (float)upper_bound;
+    }
+
+    if ((tags = py_tag_to_c(py_tags)) == NULL) {
+        goto done;
+    }
+
+    cb_submit_histogram_buckets(check_id, name, (int)count, values, lower_bounds, upper_bounds, monotonic, hostname,
+                                tags, flush_first_value);
+
+    Py_INCREF(Py_None);
+    retval = Py_None;
+
+done:
+    // releases the tags and the buckets
+    release_interned_strings();
+    _arena_reset(mark);
+    Py_XDECREF(py_values_list);
+    Py_XDECREF(py_lower_bounds_list);
+    Py_XDECREF(py_upper_bounds_list);
+    PyGILState_Release(gstate);
+    return retval;
+}
+
+/*! event_payload_t
+    \brief A raw event platform event borrowed from a python object.
+
+    `ptr` points into the buffer of the python object, `view` holds the buffer when the
+    payload was exported through the buffer protocol and must be released with
+    release_event_payload().
+*/
+typedef struct event_payload_s {
+    char *ptr;
+    Py_ssize_t len;
+    Py_buffer view;
+    bool has_view;
+} event_payload_t;
+
+/*! \fn release_event_payload(event_payload_t *payload)
+    \brief Releases a payload filled by get_event_payload().
+*/
+static void release_event_payload(event_payload_t *payload)
+{
+    if (payload->has_view) {
+        PyBuffer_Release(&payload->view);
+        payload->has_view = false;
+    }
+}
+
+/*! \fn get_event_payload(PyObject *py_event, event_payload_t *payload)
+    \brief Borrows the raw payload of an event platform event without copying it.
+    \param py_event A PyObject * pointer to the event: a string or any object supporting
+    the buffer protocol, like bytes, bytearray or memoryview.
+    \param payload A event_payload_t * pointer to the payload to fill.
+    \return an int value - non-zero for success; zero for failure, with a python error set.
+
+    The payload points into the python object and is only valid while the GIL is held and
+    the object is alive, the callbacks have to copy it if they need to retain it.
+*/
+static int get_event_payload(PyObject *py_event, event_payload_t *payload)
+{
+    payload->has_view = false;
+
+    if (PyObject_CheckBuffer(py_event)) {
+        if (PyObject_GetBuffer(py_event, &payload->view, PyBUF_SIMPLE) == -1) {
+            return 0;
+        }
+        payload->has_view = true;
+        payload->ptr = payload->view.buf;
+        payload->len = payload->view.len;
+    } else if (PyUnicode_Check(py_event)) {
+        // strings expose their UTF-8 representation, cached on the object
+        if (!PyArg_Parse(py_event, "s#", &payload->ptr, &payload->len)) {
+            return 0;
+        }
+    } else {
+        PyErr_Format(PyExc_TypeError, "raw event must be a string or a bytes-like object, not %.50s",
+                     Py_TYPE(py_event)->tp_name);
+        return 0;
+    }
+
+    if (payload->len > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "event is too large");
+        release_event_payload(payload);
+        return 0;
+    }
+    return 1;
+}
+
+
+/*! \fn submit_event_platform_event(PyObject *self, RTLOADER_FASTCALL_ARGS)
+    \brief Aggregator builtin class method for event platform event submission.
+    \param self A PyObject * pointer to self - the aggregator module.
+    \param args The python positional args, see RTLOADER_FASTCALL_ARGS.
+    \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
+
+    The raw event is handed over to the agent as a pointer into the python object buffer,
+    see get_event_payload().
+*/
+static PyObject *submit_event_platform_event(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     if (cb_submit_event_platform_event == NULL) {
         Py_RETURN_NONE;
@@ -423,24 +815,114 @@ static PyObject *submit_event_platform_event(PyObject *self, PyObject *args)
 
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    PyObject *check = NULL;
+    PyObject *check = NULL; // borrowed
+    PyObject *py_event = NULL; // borrowed
     char *check_id = NULL;
-    char *raw_event_ptr = NULL;
-    Py_ssize_t raw_event_sz = 0;
     char *event_type = NULL;
+    event_payload_t payload;
 
-    if (!PyArg_ParseTuple(args, "Oss#s", &check, &check_id, &raw_event_ptr, &raw_event_sz, &event_type)) {
+    // Python call: aggregator.submit_event_platform_event(self, check_id, raw_event, event_type)
+    if (!RTLOADER_PARSE_ARGS("OsOs", &check, &check_id, &py_event, &event_type)) {
         PyGILState_Release(gstate);
         return NULL;
     }
 
-    if (raw_event_sz > INT_MAX) {
-        PyErr_SetString(PyExc_ValueError, "event is too large");
+    if (!get_event_payload(py_event, &payload)) {
         PyGILState_Release(gstate);
         return NULL;
     }
 
-    cb_submit_event_platform_event(check_id, raw_event_ptr, raw_event_sz, event_type);
+    cb_submit_event_platform_event(check_id, payload.ptr, (int)payload.len, event_type);
+
+    release_event_payload(&payload);
     PyGILState_Release(gstate);
     Py_RETURN_NONE;
 }
+
+/*! \fn submit_event_platform_events(PyObject *self, RTLOADER_FASTCALL_ARGS)
+    \brief Aggregator builtin class method for batched event platform event submission.
+    \param self A PyObject * pointer to self - the aggregator module.
+    \param args The python positional args, see RTLOADER_FASTCALL_ARGS.
+    \return This function returns a new reference to None (already INCREF'd), or NULL in case of error.
+
+    This function implements the `submit_event_platform_events` python callable in C. All the
+    raw events of the `events` sequence share the same event type and are handed over to the
+    agent in a single callback, as pointers into the python objects buffers.
+*/
+static PyObject *submit_event_platform_events(PyObject *self, RTLOADER_FASTCALL_ARGS)
+{
+    if (cb_submit_event_platform_events == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    PyObject *check = NULL; // borrowed
+    PyObject *py_events = NULL; // borrowed
+    PyObject *py_events_list = NULL; // new reference
+    PyObject *retval = NULL;
+    char *check_id = NULL;
+    char *event_type = NULL;
+    event_payload_t *payloads = NULL;
+    char **events = NULL;
+    int *sizes = NULL;
+    Py_ssize_t count = 0;
+    Py_ssize_t nb_payloads = 0;
+    Py_ssize_t i;
+
+    // Python call: aggregator.submit_event_platform_events(self, check_id, [raw_event, ...], event_type)
+    if (!RTLOADER_PARSE_ARGS("OsOs", &check, &check_id, &py_events, &event_type)) {
+        goto done;
+    }
+
+    py_events_list = PySequence_Fast(py_events, "events must be a sequence"); // new reference
+    if (py_events_list == NULL) {
+        goto done;
+    }
+
+    count = PySequence_Fast_GET_SIZE(py_events_list);
+    if (count == 0) {
+        Py_INCREF(Py_None);
+        retval = Py_None;
+        goto done;
+    } else if (count > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "too many events in batch");
+        goto done;
+    }
+
+    payloads = _malloc(sizeof(*payloads) * count);
+    events = _malloc(sizeof(*events) * count);
+    sizes = _malloc(sizeof(*sizes) * count);
+    if (!payloads || !events || !sizes) {
+        PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for events batch");
+        goto done;
+    }
+
+    for (i = 0; i < count; i++) {
+        // `item` is borrowed, no need to decref
+        PyObject *item = PySequence_Fast_GET_ITEM(py_events_list, i);
+
+        if (!get_event_payload(item, &payloads[i])) {
+            goto done;
+        }
+        nb_payloads++;
+        events[i] = payloads[i].ptr;
+        sizes[i] = (int)payloads[i].len;
+    }
+
+    cb_submit_event_platform_events(check_id, (int)count, events, sizes, event_type);
+
+    Py_INCREF(Py_None);
+    retval = Py_None;
+
+done:
+    for (i = 0; i < nb_payloads; i++) {
+        release_event_payload(&payloads[i]);
+    }
+    _free(payloads);
+    _free(events);
+    _free(sizes);
+    Py_XDECREF(py_events_list);
+    PyGILState_Release(gstate);
+    return retval;
+}
@@ -34,6 +34,14 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn void _set_submit_metric_batch_cb(cb_submit_metric_batch_t)
+    \brief Sets the submit metric batch callback to be used by rtloader for batched metric
+    submission.
+    \param cb A function pointer with cb_submit_metric_batch_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
 /*! \fn void _set_submit_service_check_cb(cb_submit_service_check_t)
     \brief Sets the submit service_check callback to be used by rtloader for service_check
     submission.
@@ -56,6 +64,14 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn void _set_submit_histogram_buckets_cb(cb_submit_histogram_buckets_t)
+    \brief Sets the submit histogram buckets callback to be used by rtloader for the
+    submission of all the buckets of a histogram at once.
+    \param cb A function pointer with cb_submit_histogram_buckets_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
 /*! \fn void _set_submit_event_platform_event_cb(cb_submit_event_platform_event_t)
     \brief Sets the submit event callback to be used by rtloader for event-platform event submission.
     \param cb A function pointer with cb_submit_event_platform_event_t prototype to the callback
@@ -63,6 +79,14 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn void _set_submit_event_platform_events_cb(cb_submit_event_platform_events_t)
+    \brief Sets the submit event callback to be used by rtloader for batched event-platform event
+    submission.
+    \param cb A function pointer with cb_submit_event_platform_events_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
 
 #define PY_SSIZE_T_CLEAN
 #include <Python.h>
@@ -82,10 +106,13 @@ void Py2_init_aggregator();
 #endif
 
 void _set_submit_metric_cb(cb_submit_metric_t cb);
+void _set_submit_metric_batch_cb(cb_submit_metric_batch_t cb);
 void _set_submit_service_check_cb(cb_submit_service_check_t cb);
 void _set_submit_event_cb(cb_submit_event_t cb);
 void _set_submit_histogram_bucket_cb(cb_submit_histogram_bucket_t cb);
+void _set_submit_histogram_buckets_cb(cb_submit_histogram_buckets_t cb);
 void _set_submit_event_platform_event_cb(cb_submit_event_platform_event_t cb);
+void _set_submit_event_platform_events_cb(cb_submit_event_platform_events_t cb);
 
 #ifdef __cplusplus
 }
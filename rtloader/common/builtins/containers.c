@@ -3,18 +3,25 @@
 // This product includes software developed at Datadog (https://www.datadoghq.com/).
 // Copyright 2019-present Datadog, Inc.
 #include "containers.h"
+#include "fastcall.h"
+#include "free_threading.h"
+#include "rtloader_mem.h"
 
 #include <stringutils.h>
 
 // these must be set by the Agent
 static cb_is_excluded_t cb_is_excluded = NULL;
+static cb_is_excluded_many_t cb_is_excluded_many = NULL;
 
 // forward declarations
-static PyObject *is_excluded(PyObject *self, PyObject *args);
+static PyObject *is_excluded(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *is_excluded_many(PyObject *self, RTLOADER_FASTCALL_ARGS);
 
 static PyMethodDef methods[] = {
-    { "is_excluded", (PyCFunction)is_excluded, METH_VARARGS,
+    { "is_excluded", (PyCFunction)is_excluded, RTLOADER_METH_FASTCALL,
       "Returns whether a container is excluded per name, image and namespace." },
+    { "is_excluded_many", (PyCFunction)is_excluded_many, RTLOADER_METH_FASTCALL,
+      "Returns whether each container of a list of (name, image[, namespace]) tuples is excluded." },
     { NULL, NULL } // guards
 };
 
@@ -23,7 +30,9 @@ static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, CONTAINERS_MODUL
 
 PyMODINIT_FUNC PyInit_containers(void)
 {
-    return PyModule_Create(&module_def);
+    PyObject *m = PyModule_Create(&module_def);
+    RTLOADER_MODULE_GIL_NOT_USED(m);
+    return m;
 }
 #elif defined(DATADOG_AGENT_TWO)
 // in Python2 keep the object alive for the program lifetime
@@ -40,7 +49,12 @@ void _set_is_excluded_cb(cb_is_excluded_t cb)
     cb_is_excluded = cb;
 }
 
-/*! \fn PyObject *is_excluded(PyObject *self, PyObject *args)
+void _set_is_excluded_many_cb(cb_is_excluded_many_t cb)
+{
+    cb_is_excluded_many = cb;
+}
+
+/*! \fn PyObject *is_excluded(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief Method to determine whether a container is excluded from metric
     collection or not.
     \param self A PyObject* pointer to the containers module.
@@ -53,7 +67,7 @@ void _set_is_excluded_cb(cb_is_excluded_t cb)
     cb_is_excluded callback. The cgo callback is not expected to have any memory side
     effects and so no additional cleanup is necessary after invoking it.
 */
-PyObject *is_excluded(PyObject *self, PyObject *args)
+PyObject *is_excluded(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     // callback must be set
     if (cb_is_excluded == NULL) {
@@ -63,7 +77,7 @@ PyObject *is_excluded(PyObject *self, PyObject *args)
     char *name;
     char *image;
     char *namespace = NULL;
-    if (!PyArg_ParseTuple(args, "ss|s", &name, &image, &namespace)) {
+    if (!RTLOADER_PARSE_ARGS("ss|s", &name, &image, &namespace)) {
         return NULL;
     }
 
@@ -74,3 +88,109 @@ PyObject *is_excluded(PyObject *self, PyObject *args)
     }
     Py_RETURN_FALSE;
 }
+
+/*! \fn PyObject *is_excluded_many(PyObject *self, RTLOADER_FASTCALL_ARGS)
+    \brief Method to determine which containers of a list are excluded from metric
+    collection.
+    \param self A PyObject* pointer to the containers module.
+    \param args The python args, expected to contain a sequence of tuples holding the
+    container name, the image name and an optional namespace as strings.
+    \return a PyObject * pointer to a list of booleans reflecting if each container
+    should be excluded, None if no callback has been defined, or NULL in an error.
+
+    All the containers are checked with a single call to the cgo-bound cb_is_excluded_many
+    callback, checks listing many containers on every run don't cross into go-land once
+    per container. When only cb_is_excluded is set it is called for each container.
+    The strings are borrowed from the python objects, which are alive for the whole call.
+*/
+PyObject *is_excluded_many(PyObject *self, RTLOADER_FASTCALL_ARGS)
+{
+    // one of the callbacks must be set
+    if (cb_is_excluded_many == NULL && cb_is_excluded == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    PyObject *py_containers = NULL; // borrowed
+    PyObject *py_containers_list = NULL; // new reference
+    PyObject *retval = NULL;
+    char **names = NULL;
+    char **images = NULL;
+    char **namespaces = NULL;
+    int *results = NULL;
+    Py_ssize_t count = 0;
+    Py_ssize_t i;
+
+    // containers.is_excluded_many([(name, image, namespace), ...])
+    if (!RTLOADER_PARSE_ARGS("O", &py_containers)) {
+        return NULL;
+    }
+
+    py_containers_list = PySequence_Fast(py_containers, "containers must be a sequence"); // new reference
+    if (py_containers_list == NULL) {
+        return NULL;
+    }
+
+    count = PySequence_Fast_GET_SIZE(py_containers_list);
+    if (count > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "too many containers");
+        goto done;
+    } else if (count == 0) {
+        retval = PyList_New(0);
+        goto done;
+    }
+
+    names = _malloc(sizeof(*names) * count);
+    images = _malloc(sizeof(*images) * count);
+    namespaces = _malloc(sizeof(*namespaces) * count);
+    results = _malloc(sizeof(*results) * count);
+    if (!names || !images || !namespaces || !results) {
+        PyErr_SetString(PyExc_RuntimeError, "could not allocate memory for containers");
+        goto done;
+    }
+
+    for (i = 0; i < count; i++) {
+        // `item` is borrowed, no need to decref
+        PyObject *item = PySequence_Fast_GET_ITEM(py_containers_list, i);
+
+        if (!PyTuple_Check(item)) {
+            PyErr_SetString(PyExc_TypeError, "containers must be tuples");
+            goto done;
+        }
+        namespaces[i] = NULL;
+        results[i] = 0;
+#ifdef DATADOG_AGENT_THREE
+        if (!parse_fastcall_args(PySequence_Fast_ITEMS(item), PyTuple_GET_SIZE(item), "ss|s", &names[i], &images[i],
+                                 &namespaces[i])) {
+#else
+        if (!PyArg_ParseTuple(item, "ss|s", &names[i], &images[i], &namespaces[i])) {
+#endif
+            goto done;
+        }
+    }
+
+    if (cb_is_excluded_many != NULL) {
+        cb_is_excluded_many((int)count, names, images, namespaces, results);
+    } else {
+        for (i = 0; i < count; i++) {
+            results[i] = cb_is_excluded(names[i], images[i], namespaces[i]);
+        }
+    }
+
+    if ((retval = PyList_New(count)) == NULL) {
+        goto done;
+    }
+    for (i = 0; i < count; i++) {
+        PyObject *excluded = results[i] > 0 ? Py_True : Py_False;
+        // PyList_SET_ITEM steals the reference
+        Py_INCREF(excluded);
+        PyList_SET_ITEM(retval, i, excluded);
+    }
+
+done:
+    _free(names);
+    _free(images);
+    _free(namespaces);
+    _free(results);
+    Py_XDECREF(py_containers_list);
+    return retval;
+}
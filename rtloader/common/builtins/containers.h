@@ -36,6 +36,14 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn void _set_is_excluded_many_cb(cb_is_excluded_many_t)
+    \brief Sets a callback to be used by rtloader to determine which containers of a set
+    are excluded from metric collection.
+    \param object A function pointer with cb_is_excluded_many_t function prototype to the
+    callback function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
 
 #include <Python.h>
 #include <rtloader_types.h>
@@ -55,6 +63,7 @@ void Py2_init_containers();
 #endif
 
 void _set_is_excluded_cb(cb_is_excluded_t);
+void _set_is_excluded_many_cb(cb_is_excluded_many_t);
 
 #ifdef __cplusplus
 }
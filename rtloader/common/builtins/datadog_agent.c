@@ -4,11 +4,19 @@
 // Copyright 2019-present Datadog, Inc.
 #include "datadog_agent.h"
 #include "cgo_free.h"
+#include "fastcall.h"
+#include "free_threading.h"
+#include "persistent_store.h"
 #include "rtloader_mem.h"
 #include "stringutils.h"
 
 #include <log.h>
 
+#include <errno.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
 // these must be set by the Agent
 static cb_get_clustername_t cb_get_clustername = NULL;
 static cb_get_config_t cb_get_config = NULL;
@@ -18,6 +26,7 @@ static cb_get_version_t cb_get_version = NULL;
 static cb_headers_t cb_headers = NULL;
 static cb_set_check_metadata_t cb_set_check_metadata = NULL;
 static cb_set_external_tags_t cb_set_external_tags = NULL;
+static cb_set_external_tags_batch_t cb_set_external_tags_batch = NULL;
 static cb_write_persistent_cache_t cb_write_persistent_cache = NULL;
 static cb_read_persistent_cache_t cb_read_persistent_cache = NULL;
 static cb_obfuscate_sql_t cb_obfuscate_sql = NULL;
@@ -25,18 +34,66 @@ static cb_obfuscate_sql_exec_plan_t cb_obfuscate_sql_exec_plan = NULL;
 static cb_get_process_start_time_t cb_get_process_start_time = NULL;
 static cb_obfuscate_mongodb_string_t cb_obfuscate_mongodb_string = NULL;
 
+// get_config results, keyed by configuration key. The cache is only used once the
+// Agent provided a configuration generation and is dropped whenever it changes.
+static PyObject *config_cache = NULL;
+static unsigned long long config_generation = 0;
+static unsigned long long config_cache_generation = 0;
+RTLOADER_MUTEX(config_cache_mutex);
+
+// get_version, get_hostname and get_clustername results, cached once the Agent provided
+// a configuration generation. The version never changes, the other values are dropped
+// whenever the generation changes.
+static PyObject *version_cache = NULL;
+static PyObject *hostname_cache = NULL;
+static PyObject *clustername_cache = NULL;
+static unsigned long long identity_cache_generation = 0;
+RTLOADER_MUTEX(identity_cache_mutex);
+
+// obfuscate_sql and obfuscate_sql_exec_plan results, keyed by the (kind, input, options)
+// tuple. Hits move the entry to the end of the dict so the first entry is always the least
+// recently used one and gets evicted when the cache is full. Python 2 dicts are unordered,
+// evictions are arbitrary there.
+static PyObject *obfuscation_cache = NULL;
+static size_t obfuscation_cache_size = 0;
+static obfuscation_cache_stats_t obfuscation_cache_stats = { 0 };
+RTLOADER_MUTEX(obfuscation_cache_mutex);
+
+enum { OBFUSCATE_SQL = 0, OBFUSCATE_SQL_EXEC_PLAN };
+
+// write_persistent_cache and read_persistent_cache go through the store when it is set,
+// the callbacks are only used to read the keys written before it was enabled. The store
+// isn't thread safe, its calls are serialized by the mutex in the free-threaded builds.
+static persistent_store_t *persistent_store = NULL;
+RTLOADER_MUTEX(persistent_store_mutex);
+
+#ifdef DATADOG_AGENT_THREE
+// buffer exporter backing the memoryviews returned by read_persistent_cache_view, it keeps
+// the store mapping the value points into alive
+typedef struct {
+    PyObject_HEAD
+    persistent_store_mapping_t *mapping;
+    const char *value;
+    Py_ssize_t len;
+} persistent_cache_value_t;
+
+static PyTypeObject PersistentCacheValueType;
+#endif
+
 // forward declarations
 static PyObject *get_clustername(PyObject *self, PyObject *args);
-static PyObject *get_config(PyObject *self, PyObject *args);
+static PyObject *get_config(PyObject *self, RTLOADER_FASTCALL_ARGS);
 static PyObject *get_hostname(PyObject *self, PyObject *args);
 static PyObject *tracemalloc_enabled(PyObject *self, PyObject *args);
 static PyObject *get_version(PyObject *self, PyObject *args);
 static PyObject *headers(PyObject *self, PyObject *args, PyObject *kwargs);
-static PyObject *log_message(PyObject *self, PyObject *args);
-static PyObject *set_check_metadata(PyObject *self, PyObject *args);
-static PyObject *set_external_tags(PyObject *self, PyObject *args);
-static PyObject *write_persistent_cache(PyObject *self, PyObject *args);
-static PyObject *read_persistent_cache(PyObject *self, PyObject *args);
+static PyObject *log_message(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *get_log_level(PyObject *self, PyObject *args);
+static PyObject *set_check_metadata(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *set_external_tags(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *write_persistent_cache(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *read_persistent_cache(PyObject *self, RTLOADER_FASTCALL_ARGS);
+static PyObject *read_persistent_cache_view(PyObject *self, RTLOADER_FASTCALL_ARGS);
 static PyObject *obfuscate_sql(PyObject *self, PyObject *args, PyObject *kwargs);
 static PyObject *obfuscate_sql_exec_plan(PyObject *self, PyObject *args, PyObject *kwargs);
 static PyObject *get_process_start_time(PyObject *self, PyObject *args, PyObject *kwargs);
@@ -44,16 +101,18 @@ static PyObject *obfuscate_mongodb_string(PyObject *self, PyObject *args, PyObje
 
 static PyMethodDef methods[] = {
     { "get_clustername", get_clustername, METH_NOARGS, "Get the cluster name." },
-    { "get_config", get_config, METH_VARARGS, "Get an Agent config item." },
+    { "get_config", (PyCFunction)get_config, RTLOADER_METH_FASTCALL, "Get an Agent config item." },
     { "get_hostname", get_hostname, METH_NOARGS, "Get the hostname." },
     { "tracemalloc_enabled", tracemalloc_enabled, METH_VARARGS, "Gets if tracemalloc is enabled." },
     { "get_version", get_version, METH_NOARGS, "Get Agent version." },
     { "headers", (PyCFunction)headers, METH_VARARGS | METH_KEYWORDS, "Get standard set of HTTP headers." },
-    { "log", log_message, METH_VARARGS, "Log a message through the agent logger." },
-    { "set_check_metadata", set_check_metadata, METH_VARARGS, "Send metadata for Checks." },
-    { "set_external_tags", set_external_tags, METH_VARARGS, "Send external host tags." },
-    { "write_persistent_cache", write_persistent_cache, METH_VARARGS, "Store a value for a given key." },
-    { "read_persistent_cache", read_persistent_cache, METH_VARARGS, "Retrieve the value associated with a key." },
+    { "log", (PyCFunction)log_message, RTLOADER_METH_FASTCALL, "Log a message through the agent logger." },
+    { "get_log_level", get_log_level, METH_NOARGS, "Get the lowest log level forwarded to the agent logger." },
+    { "set_check_metadata", (PyCFunction)set_check_metadata, RTLOADER_METH_FASTCALL, "Send metadata for Checks." },
+    { "set_external_tags", (PyCFunction)set_external_tags, RTLOADER_METH_FASTCALL, "Send external host tags." },
+    { "write_persistent_cache", (PyCFunction)write_persistent_cache, RTLOADER_METH_FASTCALL, "Store a value for a given key." },
+    { "read_persistent_cache", (PyCFunction)read_persistent_cache, RTLOADER_METH_FASTCALL, "Retrieve the value associated with a key." },
+    { "read_persistent_cache_view", (PyCFunction)read_persistent_cache_view, RTLOADER_METH_FASTCALL, "Retrieve the value associated with a key as a read-only memoryview." },
     { "obfuscate_sql", (PyCFunction)obfuscate_sql, METH_VARARGS|METH_KEYWORDS, "Obfuscate & normalize a SQL string." },
     { "obfuscate_sql_exec_plan", (PyCFunction)obfuscate_sql_exec_plan, METH_VARARGS|METH_KEYWORDS, "Obfuscate & normalize a SQL Execution Plan." },
     { "get_process_start_time", (PyCFunction)get_process_start_time, METH_NOARGS, "Get agent process startup time, in seconds since the epoch." },
@@ -66,7 +125,12 @@ static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, DATADOG_AGENT_MO
 
 PyMODINIT_FUNC PyInit_datadog_agent(void)
 {
-    return PyModule_Create(&module_def);
+    if (PyType_Ready(&PersistentCacheValueType) < 0) {
+        return NULL;
+    }
+    PyObject *m = PyModule_Create(&module_def);
+    RTLOADER_MODULE_GIL_NOT_USED(m);
+    return m;
 }
 #elif defined(DATADOG_AGENT_TWO)
 // in Python2 keep the object alive for the program lifetime
@@ -88,6 +152,28 @@ void _set_get_config_cb(cb_get_config_t cb)
     cb_get_config = cb;
 }
 
+void _set_config_generation(unsigned long long generation)
+{
+    config_generation = generation;
+}
+
+unsigned long long _get_config_generation(void)
+{
+    return config_generation;
+}
+
+void _set_obfuscation_cache_size(size_t size)
+{
+    obfuscation_cache_size = size;
+}
+
+void _get_obfuscation_cache_stats(obfuscation_cache_stats_t *stats)
+{
+    RTLOADER_LOCK(obfuscation_cache_mutex);
+    *stats = obfuscation_cache_stats;
+    RTLOADER_UNLOCK(obfuscation_cache_mutex);
+}
+
 void _set_headers_cb(cb_headers_t cb)
 {
     cb_headers = cb;
@@ -123,6 +209,11 @@ void _set_set_external_tags_cb(cb_set_external_tags_t cb)
     cb_set_external_tags = cb;
 }
 
+void _set_set_external_tags_batch_cb(cb_set_external_tags_batch_t cb)
+{
+    cb_set_external_tags_batch = cb;
+}
+
 void _set_tracemalloc_enabled_cb(cb_tracemalloc_enabled_t cb)
 {
     cb_tracemalloc_enabled = cb;
@@ -148,6 +239,53 @@ void _set_obfuscate_mongodb_string_cb(cb_obfuscate_mongodb_string_t cb) {
 }
 
 
+/*! \fn static PyObject *get_identity(void (*cb)(char **), PyObject **cache)
+    \brief Returns an identity value of the Agent, from the cache when it is enabled.
+    \param cb The callback retrieving the value from the Agent, must be set.
+    \param cache A PyObject** pointer to the cache of the value.
+    \return a new reference to a python string with the value, or `None` if the Agent
+    returned no value.
+
+    Empty values, returned by the Agent when it failed to get them, aren't cached.
+*/
+static PyObject *get_identity(void (*cb)(char **), PyObject **cache)
+{
+    PyObject *cached = NULL; // new ref
+    RTLOADER_LOCK(identity_cache_mutex);
+    if (identity_cache_generation != config_generation) {
+        Py_CLEAR(hostname_cache);
+        Py_CLEAR(clustername_cache);
+        identity_cache_generation = config_generation;
+    }
+    cached = *cache;
+    Py_XINCREF(cached);
+    RTLOADER_UNLOCK(identity_cache_mutex);
+
+    if (cached != NULL) {
+        return cached;
+    }
+
+    char *v = NULL;
+    cb(&v);
+    if (v == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    PyObject *retval = PyStringFromCString(v);
+    if (retval != NULL && v[0] != '\0' && config_generation != 0) {
+        Py_INCREF(retval);
+        RTLOADER_LOCK(identity_cache_mutex);
+        PyObject *previous = *cache;
+        *cache = retval;
+        RTLOADER_UNLOCK(identity_cache_mutex);
+        Py_XDECREF(previous);
+    }
+    // v is allocated from CGO and thus requires being freed with the
+    // cgo_free callback for windows safety.
+    cgo_free(v);
+    return retval;
+}
+
 /*! \fn PyObject *get_version(PyObject *self, PyObject *args)
     \brief This function implements the `datadog-agent.get_version` method, collecting
     the agent version from the agent.
@@ -165,20 +303,34 @@ PyObject *get_version(PyObject *self, PyObject *args)
         Py_RETURN_NONE;
     }
 
-    char *v = NULL;
-    cb_get_version(&v);
+    return get_identity(cb_get_version, &version_cache);
+}
 
-    if (v != NULL) {
-        PyObject *retval = PyStringFromCString(v);
-        // v is allocated from CGO and thus requires being freed with the
-        // cgo_free callback for windows safety.
-        cgo_free(v);
-        return retval;
+/*! \fn PyObject *decode_config_payload(const char *data)
+    \brief Decodes a configuration payload returned by the Agent into a python object.
+    \param data A C-string with the JSON payload, YAML is accepted as a fallback.
+    \return a new reference to the decoded python object, or NULL on error.
+
+    The Agent marshals configuration values to JSON as decoding it with the json C
+    accelerator is much cheaper than going through `yaml.load`, particularly on hosts
+    without libyaml. YAML payloads are still decoded for callers returning them, JSON
+    being valid YAML the Python2 build keeps using `from_yaml` so strings are still
+    returned as `str` and not `unicode`.
+*/
+static PyObject *decode_config_payload(const char *data)
+{
+#ifdef DATADOG_AGENT_THREE
+    PyObject *value = from_json(data);
+    if (value != NULL) {
+        return value;
     }
-    Py_RETURN_NONE;
+    // clear error set by `from_json`
+    PyErr_Clear();
+#endif
+    return from_yaml(data);
 }
 
-/*! \fn PyObject *get_config(PyObject *self, PyObject *args)
+/*! \fn PyObject *get_config(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief This function implements the `datadog-agent.get_config` method, allowing
     to collect elements in the agent configuration, from the agent.
     \param self A PyObject* pointer to the `datadog_agent` module.
@@ -190,21 +342,23 @@ PyObject *get_version(PyObject *self, PyObject *args)
     uses the`cb_get_config()` callback to retrieve the element in the agent configuration
     associated with the key passed in with the args argument. The value returned
     will depend on the element type found for the key, and is a python object
-    unmarshaled by the `yaml.safe_load` function when calling `from_yaml()` with
-    the payload returned by callback. If no callback is set, `None` will be returned.
+    decoded by `decode_config_payload()` from the payload returned by callback. If no
+    callback is set, `None` will be returned.
 
     Before RtLoader the Agent used reflection to inspect the contents of a configuration
     value and the CPython API to perform conversion to a Python equivalent. Such
-    a conversion wouldn't be possible in a Python-agnostic way so we use YAML to
-    pass the data from Go to Python. The configuration value is loaded in the Agent,
-    marshalled into YAML and passed as a `char*` to RtLoader, where the string is
-    decoded back to Python and passed to the caller. YAML usage is transparent to
-    the caller, who would receive a Python object as returned from `yaml.safe_load`.
-    YAML is used instead of JSON since the `json.load` return unicode for
-    string, for python2, which would be a breaking change from the previous
-    version of the agent.
+    a conversion wouldn't be possible in a Python-agnostic way so we serialize the data
+    to pass it from Go to Python. The configuration value is loaded in the Agent,
+    marshalled into JSON and passed as a `char*` to RtLoader, where the string is
+    decoded back to Python and passed to the caller.
+
+    Integrations typically call this method from their check loop, so once the Agent set
+    a configuration generation with `set_config_generation` results are cached per key
+    until the generation changes. Immutable values are cached as is, containers are
+    cached as their payload and decoded again on every call so callers mutating the
+    returned object don't affect each other.
 */
-PyObject *get_config(PyObject *self, PyObject *args)
+PyObject *get_config(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     // callback must be set
     if (cb_get_config == NULL) {
@@ -212,23 +366,72 @@ PyObject *get_config(PyObject *self, PyObject *args)
     }
 
     char *key = NULL;
-    // PyArg_ParseTuple returns a pointer to the existing string in &key
+    // RTLOADER_PARSE_ARGS returns a pointer to the existing string in &key
     // No need to free the result.
-    if (!PyArg_ParseTuple(args, "s", &key)) {
+    if (!RTLOADER_PARSE_ARGS("s", &key)) {
         return NULL;
     }
 
+    PyObject *cached = NULL; // new ref
+    RTLOADER_LOCK(config_cache_mutex);
+    if (config_generation != 0) {
+        if (config_cache == NULL) {
+            config_cache = PyDict_New();
+        } else if (config_cache_generation != config_generation) {
+            PyDict_Clear(config_cache);
+        }
+        config_cache_generation = config_generation;
+    }
+
+    if (config_generation != 0 && config_cache != NULL) {
+        cached = PyDict_GetItemString(config_cache, key);
+        Py_XINCREF(cached);
+    }
+    RTLOADER_UNLOCK(config_cache_mutex);
+
+    if (cached != NULL) {
+        if (PyBytes_Check(cached)) {
+            PyObject *value = decode_config_payload(PyBytes_AS_STRING(cached));
+            Py_DECREF(cached);
+            if (value != NULL) {
+                return value;
+            }
+            PyErr_Clear();
+            Py_RETURN_NONE;
+        }
+        return cached;
+    }
+
     char *data = NULL;
     cb_get_config(key, &data);
 
-    // new ref
-    PyObject *value = from_yaml(data);
-    cgo_free(data);
+    // new ref, a NULL payload means the key isn't set and None should be returned
+    PyObject *value = data != NULL ? decode_config_payload(data) : Py_BuildValue("");
     if (value == NULL) {
-        // clear error set by `from_yaml`
+        // clear error set by `decode_config_payload`
         PyErr_Clear();
+        cgo_free(data);
         Py_RETURN_NONE;
     }
+
+    if (config_generation != 0 && config_cache != NULL) {
+        PyObject *entry = NULL;
+        if (PyDict_Check(value) || PyList_Check(value)) {
+            entry = PyBytes_FromString(data);
+        } else {
+            entry = value;
+            Py_INCREF(entry);
+        }
+        // caching is best effort
+        RTLOADER_LOCK(config_cache_mutex);
+        if (entry == NULL || config_cache == NULL || PyDict_SetItemString(config_cache, key, entry) != 0) {
+            PyErr_Clear();
+        }
+        RTLOADER_UNLOCK(config_cache_mutex);
+        Py_XDECREF(entry);
+    }
+    cgo_free(data);
+
     return value;
 }
 
@@ -261,10 +464,10 @@ PyObject *headers(PyObject *self, PyObject *args, PyObject *kwargs)
     cb_headers(&data);
 
     // new ref
-    PyObject *headers_dict = from_yaml(data);
+    PyObject *headers_dict = decode_config_payload(data);
     cgo_free(data);
     if (headers_dict == NULL || !PyDict_Check(headers_dict)) {
-        // clear error set by `from_yaml`
+        // clear error set by `decode_config_payload`
         PyErr_Clear();
         // if headers_dict is not a dict we don't need to hold a ref to it
         Py_XDECREF(headers_dict);
@@ -312,15 +515,7 @@ PyObject *get_hostname(PyObject *self, PyObject *args)
         Py_RETURN_NONE;
     }
 
-    char *v = NULL;
-    cb_get_hostname(&v);
-
-    if (v != NULL) {
-        PyObject *retval = PyStringFromCString(v);
-        cgo_free(v);
-        return retval;
-    }
-    Py_RETURN_NONE;
+    return get_identity(cb_get_hostname, &hostname_cache);
 }
 
 /*! \fn PyObject *get_clustername(PyObject *self, PyObject *args)
@@ -342,15 +537,7 @@ PyObject *get_clustername(PyObject *self, PyObject *args)
         Py_RETURN_NONE;
     }
 
-    char *v = NULL;
-    cb_get_clustername(&v);
-
-    if (v != NULL) {
-        PyObject *retval = PyStringFromCString(v);
-        cgo_free(v);
-        return retval;
-    }
-    Py_RETURN_NONE;
+    return get_identity(cb_get_clustername, &clustername_cache);
 }
 
 /*! \fn PyObject *tracemalloc_enabled(PyObject *self, PyObject *args)
@@ -378,7 +565,7 @@ PyObject *tracemalloc_enabled(PyObject *self, PyObject *args)
     Py_RETURN_FALSE;
 }
 
-/*! \fn PyObject *log_message(PyObject *self, PyObject *args)
+/*! \fn PyObject *log_message(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief This function implements the `datadog_agent.log` method, allowing to log
     python messages using the agent's go logging subsytem and its facilities.
     \param self A PyObject* pointer to the `datadog_agent` module.
@@ -391,27 +578,48 @@ PyObject *tracemalloc_enabled(PyObject *self, PyObject *args)
     the agent logging facilities from python-land.
     Should the callback not be available the function will do nothing.
 */
-static PyObject *log_message(PyObject *self, PyObject *args)
+static PyObject *log_message(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     char *message = NULL;
     int log_level;
 
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    // PyArg_ParseTuple returns a pointer to the existing string in &message
+    // RTLOADER_PARSE_ARGS returns a pointer to the existing string in &message
     // No need to free the result.
-    if (!PyArg_ParseTuple(args, "si", &message, &log_level)) {
+    if (!RTLOADER_PARSE_ARGS("si", &message, &log_level)) {
         PyGILState_Release(gstate);
         return NULL;
     }
 
     PyGILState_Release(gstate);
 
+    // filtered messages are dropped here rather than by the agent logger, saving a CGO call
     agent_log(log_level, message);
     Py_RETURN_NONE;
 }
 
-/*! \fn PyObject *set_check_metadata(PyObject *self, PyObject *args)
+/*! \fn PyObject *get_log_level(PyObject *self, PyObject *args)
+    \brief This function implements the `datadog_agent.get_log_level` method, returning the
+    lowest log level forwarded to the agent logger.
+    \param self A PyObject* pointer to the `datadog_agent` module.
+    \param args A PyObject* pointer to an empty tuple, as no input args are taken.
+    \return A PyObject* pointer to the log level as a python int, 0 if the agent didn't set
+    one.
+
+    The levels match the ones of the python `logging` module, this lets the checks loggers
+    implement `isEnabledFor` without calling `datadog_agent.log`.
+*/
+static PyObject *get_log_level(PyObject *self, PyObject *args)
+{
+#ifdef DATADOG_AGENT_THREE
+    return PyLong_FromLong(_get_log_level());
+#else
+    return PyInt_FromLong(_get_log_level());
+#endif
+}
+
+/*! \fn PyObject *set_check_metadata(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief This function implements the `datadog_agent.set_check_metadata` method, updating
     the value in the cache.
     \param self A PyObject* pointer to the `datadog_agent` module.
@@ -423,7 +631,7 @@ static PyObject *log_message(PyObject *self, PyObject *args)
     uses the `cb_set_check_metadata()` callback to retrieve the value from the agent
     with CGO. If the callback has not been set `None` will be returned.
 */
-static PyObject *set_check_metadata(PyObject *self, PyObject *args)
+static PyObject *set_check_metadata(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     // callback must be set
     if (cb_set_check_metadata == NULL) {
@@ -435,7 +643,7 @@ static PyObject *set_check_metadata(PyObject *self, PyObject *args)
     PyGILState_STATE gstate = PyGILState_Ensure();
 
     // datadog_agent.set_check_metadata(check_id, name, value)
-    if (!PyArg_ParseTuple(args, "sss", &check_id, &name, &value)) {
+    if (!RTLOADER_PARSE_ARGS("sss", &check_id, &name, &value)) {
         PyGILState_Release(gstate);
         return NULL;
     }
@@ -446,28 +654,78 @@ static PyObject *set_check_metadata(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
-/*! \fn PyObject *write_persistent_cache(PyObject *self, PyObject *args)
+int _set_persistent_cache_store(const char *path)
+{
+    int ret = 1;
+
+    RTLOADER_LOCK(persistent_store_mutex);
+    persistent_store_close(persistent_store);
+    persistent_store = NULL;
+
+    if (path != NULL) {
+        persistent_store = persistent_store_open(path);
+        ret = persistent_store != NULL;
+    }
+    RTLOADER_UNLOCK(persistent_store_mutex);
+    return ret;
+}
+
+/*! \fn static int persistent_store_read_locked(const char *key, size_t key_len, const char **value, size_t *value_len, persistent_store_mapping_t **mapping)
+    \brief Looks up the key in the persistent store, see `persistent_store_read`.
+    \return an int value - 1 if the key was found; 0 if it wasn't or the store isn't set; -1
+    for failure with `errno` set accordingly.
+*/
+static int persistent_store_read_locked(const char *key, size_t key_len, const char **value, size_t *value_len,
+                                        persistent_store_mapping_t **mapping)
+{
+    int found = 0;
+    int err = 0;
+
+    RTLOADER_LOCK(persistent_store_mutex);
+    if (persistent_store != NULL) {
+        found = persistent_store_read(persistent_store, key, key_len, value, value_len, mapping);
+        err = errno;
+    }
+    RTLOADER_UNLOCK(persistent_store_mutex);
+    errno = err;
+    return found;
+}
+
+/*! \fn PyObject *write_persistent_cache(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief This function implements the `datadog_agent.write_persistent_cache` method, storing
     the value for the key.
     \param self A PyObject* pointer to the `datadog_agent` module.
     \param args A PyObject* pointer to a 2-ary tuple containing the key and the value to store.
     \return A PyObject* pointer to `None`.
 
-    This function is callable as the `datadog_agent.write_persistent_cache` Python method and
-    uses the `cb_write_persistent_cache()` callback to retrieve the value from the agent
-    with CGO. If the callback has not been set `None` will be returned.
+    This function is callable as the `datadog_agent.write_persistent_cache` Python method. The
+    value is appended to the persistent store when it is set, otherwise, or if the write fails,
+    the `cb_write_persistent_cache()` callback is used to store the value in the agent with
+    CGO. If the callback has not been set `None` will be returned.
 */
-static PyObject *write_persistent_cache(PyObject *self, PyObject *args)
+static PyObject *write_persistent_cache(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
+    char *key, *value;
+
+    // datadog_agent.write_persistent_cache(key, value)
+    Py_ssize_t key_len, value_len;
+    if (!RTLOADER_PARSE_ARGS("s#s#", &key, &key_len, &value, &value_len)) {
+        return NULL;
+    }
+    RTLOADER_LOCK(persistent_store_mutex);
+    int written
+        = persistent_store != NULL && persistent_store_write(persistent_store, key, key_len, value, value_len);
+    RTLOADER_UNLOCK(persistent_store_mutex);
+    if (written) {
+        Py_RETURN_NONE;
+    }
+
     // callback must be set
     if (cb_write_persistent_cache == NULL) {
         Py_RETURN_NONE;
     }
 
-    char *key, *value;
-
-    // datadog_agent.write_persistent_cache(key, value)
-    if (!PyArg_ParseTuple(args, "ss", &key, &value)) {
+    if (!RTLOADER_PARSE_ARGS("ss", &key, &value)) {
         return NULL;
     }
 
@@ -478,47 +736,381 @@ static PyObject *write_persistent_cache(PyObject *self, PyObject *args)
     Py_RETURN_NONE;
 }
 
-/*! \fn PyObject *read_persistent_cache(PyObject *self, PyObject *args)
+/*! \fn static char *read_persistent_cache_cb(char *key)
+    \brief Reads the value of the key with the `cb_read_persistent_cache()` callback.
+    \return a char * pointer to the value, to be freed with `cgo_free()`, or NULL with a
+    python error set.
+*/
+static char *read_persistent_cache_cb(char *key)
+{
+    char *v = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    v = cb_read_persistent_cache(key);
+    Py_END_ALLOW_THREADS
+
+    if (v == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "failed to read data");
+    }
+    return v;
+}
+
+/*! \fn PyObject *read_persistent_cache(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief This function implements the `datadog_agent.read_persistent_cache` method, retrieving
     the value for the key previously stored.
     \param self A PyObject* pointer to the `datadog_agent` module.
     \param args A PyObject* pointer to a tuple containing the key to retrieve.
     \return A PyObject* pointer to the value.
 
-    This function is callable as the `datadog_agent.read_persistent_cache` Python method and
-    uses the `cb_read_persistent_cache()` callback to retrieve the value from the agent
-    with CGO. If the callback has not been set `None` will be returned.
+    This function is callable as the `datadog_agent.read_persistent_cache` Python method. The
+    value is looked up in the persistent store when it is set, keys missing from the store are
+    retrieved from the agent with the `cb_read_persistent_cache()` callback with CGO. If the
+    callback has not been set `None` will be returned.
 */
-static PyObject *read_persistent_cache(PyObject *self, PyObject *args)
+static PyObject *read_persistent_cache(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
+    char *key;
+    Py_ssize_t key_len;
+
+    // datadog_agent.read_persistent_cache(key)
+    if (!RTLOADER_PARSE_ARGS("s#", &key, &key_len)) {
+        return NULL;
+    }
+
+    const char *value;
+    size_t value_len;
+    persistent_store_mapping_t *mapping;
+
+    int found = persistent_store_read_locked(key, key_len, &value, &value_len, &mapping);
+    if (found < 0) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    } else if (found) {
+#ifdef DATADOG_AGENT_THREE
+        PyObject *retval = PyUnicode_DecodeUTF8(value, value_len, NULL);
+#else
+        PyObject *retval = PyString_FromStringAndSize(value, value_len);
+#endif
+        persistent_store_mapping_release(mapping);
+        return retval;
+    }
+
     // callback must be set
     if (cb_read_persistent_cache == NULL) {
         Py_RETURN_NONE;
     }
 
+    if (!RTLOADER_PARSE_ARGS("s", &key)) {
+        return NULL;
+    }
+
+    char *v = read_persistent_cache_cb(key);
+    if (v == NULL) {
+        return NULL;
+    }
+
+    PyObject *retval = PyStringFromCString(v);
+    cgo_free(v);
+    return retval;
+}
+
+#ifdef DATADOG_AGENT_THREE
+static int persistent_cache_value_getbuffer(persistent_cache_value_t *self, Py_buffer *view, int flags)
+{
+    return PyBuffer_FillInfo(view, (PyObject *)self, (void *)self->value, self->len, 1, flags);
+}
+
+static void persistent_cache_value_dealloc(persistent_cache_value_t *self)
+{
+    persistent_store_mapping_release(self->mapping);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyBufferProcs persistent_cache_value_as_buffer = {
+    .bf_getbuffer = (getbufferproc)persistent_cache_value_getbuffer,
+};
+
+static PyTypeObject PersistentCacheValueType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = DATADOG_AGENT_MODULE_NAME ".PersistentCacheValue",
+    .tp_basicsize = sizeof(persistent_cache_value_t),
+    .tp_dealloc = (destructor)persistent_cache_value_dealloc,
+    .tp_as_buffer = &persistent_cache_value_as_buffer,
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Value of the persistent store, exported as a read-only buffer.",
+};
+#endif
+
+/*! \fn PyObject *read_persistent_cache_view(PyObject *self, RTLOADER_FASTCALL_ARGS)
+    \brief This function implements the `datadog_agent.read_persistent_cache_view` method,
+    retrieving the value for the key previously stored without copying it.
+    \param self A PyObject* pointer to the `datadog_agent` module.
+    \param args A PyObject* pointer to a tuple containing the key to retrieve.
+    \return A PyObject* pointer to a read-only memoryview of the value.
+
+    This function is callable as the `datadog_agent.read_persistent_cache_view` Python method.
+    Values found in the persistent store are exposed straight from its memory mapping, the
+    memoryview can outlive later writes to the key. Otherwise the value is retrieved with the
+    `cb_read_persistent_cache()` callback like `read_persistent_cache` does. With Python 2 the
+    value is returned as a str. If the callback has not been set `None` will be returned.
+*/
+static PyObject *read_persistent_cache_view(PyObject *self, RTLOADER_FASTCALL_ARGS)
+{
     char *key;
+    Py_ssize_t key_len;
 
-    // datadog_agent.read_persistent_cache(key)
-    if (!PyArg_ParseTuple(args, "s", &key)) {
+    // datadog_agent.read_persistent_cache_view(key)
+    if (!RTLOADER_PARSE_ARGS("s#", &key, &key_len)) {
         return NULL;
     }
 
-    char *v = NULL;
-    Py_BEGIN_ALLOW_THREADS
-    v = cb_read_persistent_cache(key);
-    Py_END_ALLOW_THREADS
+    const char *value;
+    size_t value_len;
+    persistent_store_mapping_t *mapping;
+
+    int found = persistent_store_read_locked(key, key_len, &value, &value_len, &mapping);
+    if (found < 0) {
+        return PyErr_SetFromErrno(PyExc_OSError);
+    } else if (found) {
+#ifdef DATADOG_AGENT_THREE
+        persistent_cache_value_t *exporter = PyObject_New(persistent_cache_value_t, &PersistentCacheValueType);
+        if (exporter == NULL) {
+            persistent_store_mapping_release(mapping);
+            return NULL;
+        }
+        exporter->mapping = mapping;
+        exporter->value = value;
+        exporter->len = value_len;
 
+        PyObject *retval = PyMemoryView_FromObject((PyObject *)exporter);
+        Py_DECREF(exporter);
+        return retval;
+#else
+        PyObject *retval = PyString_FromStringAndSize(value, value_len);
+        persistent_store_mapping_release(mapping);
+        return retval;
+#endif
+    }
+
+    // callback must be set
+    if (cb_read_persistent_cache == NULL) {
+        Py_RETURN_NONE;
+    }
+
+    if (!RTLOADER_PARSE_ARGS("s", &key)) {
+        return NULL;
+    }
+
+    char *v = read_persistent_cache_cb(key);
     if (v == NULL) {
-        PyErr_SetString(PyExc_RuntimeError, "failed to read data");
         return NULL;
     }
 
-    PyObject *retval = PyStringFromCString(v);
+#ifdef DATADOG_AGENT_THREE
+    PyObject *bytes = PyBytes_FromString(v);
+    cgo_free(v);
+    if (bytes == NULL) {
+        return NULL;
+    }
+    PyObject *retval = PyMemoryView_FromObject(bytes);
+    Py_DECREF(bytes);
+    return retval;
+#else
+    PyObject *retval = PyString_FromString(v);
     cgo_free(v);
     return retval;
+#endif
+}
+
+/*! \fn int external_tags_string(PyObject *object, const char **str, Py_ssize_t *len)
+    \brief Gets the UTF-8 representation of a string without copying it.
+    \param object A PyObject* pointer to the string.
+    \param str A const char** pointer set to the bytes of the string, which are owned by `object`.
+    \param len A Py_ssize_t* pointer set to the length of the string.
+    \return 1 on success, 0 if the object isn't a valid string. No exception is left set.
+*/
+static int external_tags_string(PyObject *object, const char **str, Py_ssize_t *len)
+{
+// DATADOG_AGENT_THREE implementation is the default
+#ifdef DATADOG_AGENT_TWO
+    char *tmp = NULL;
+
+    if (!PyString_Check(object) && !PyUnicode_Check(object)) {
+        return 0;
+    }
+    // unicode objects are encoded with the default encoding, like as_string() does
+    if (PyString_AsStringAndSize(object, &tmp, len) == -1) {
+        PyErr_Clear();
+        return 0;
+    }
+    *str = tmp;
+#else
+    if (PyBytes_Check(object)) {
+        *str = PyBytes_AS_STRING(object);
+        *len = PyBytes_GET_SIZE(object);
+    } else if (PyUnicode_Check(object)) {
+        // the UTF-8 representation is cached by the object
+        *str = PyUnicode_AsUTF8AndSize(object, len);
+        if (*str == NULL) {
+            PyErr_Clear();
+            return 0;
+        }
+    } else {
+        return 0;
+    }
+#endif
+    return *len <= UINT32_MAX;
+}
+
+/*! \fn void pack_uint32(char *buf, Py_ssize_t cap, Py_ssize_t off, uint32_t value)
+    \brief Writes an integer at the given offset of a buffer packed by pack_external_tags(),
+    unless the buffer is NULL or too small.
+*/
+static void pack_uint32(char *buf, Py_ssize_t cap, Py_ssize_t off, uint32_t value)
+{
+    if (buf != NULL && off + (Py_ssize_t)sizeof(value) <= cap) {
+        memcpy(buf + off, &value, sizeof(value));
+    }
+}
+
+/*! \fn void pack_string(char *buf, Py_ssize_t cap, Py_ssize_t *off, const char *str, Py_ssize_t len)
+    \brief Appends a length-prefixed string to a buffer packed by pack_external_tags(), only
+    moving the offset forward when the buffer is NULL or too small.
+*/
+static void pack_string(char *buf, Py_ssize_t cap, Py_ssize_t *off, const char *str, Py_ssize_t len)
+{
+    pack_uint32(buf, cap, *off, (uint32_t)len);
+    *off += sizeof(uint32_t);
+    if (buf != NULL && *off + len <= cap) {
+        memcpy(buf + *off, str, len);
+    }
+    *off += len;
+}
+
+/*! \fn Py_ssize_t pack_external_tags(PyObject *input_list, char *buf, Py_ssize_t cap)
+    \brief Packs the external tags passed to `set_external_tags` in the format expected by
+    `cb_set_external_tags_batch`.
+    \param input_list A PyObject* pointer to the list of `(hostname, {source_type: [tags]})`.
+    \param buf A char* pointer to the buffer to fill, or NULL to only compute its size.
+    \param cap The size of the buffer.
+    \return the size of the packed data, or -1 if an exception is raised.
+
+    The list is validated the same way the per-host path does: invalid tags are skipped and the
+    hosts with an empty dictionary ignored. Strings are borrowed from the python objects, so
+    nothing but the buffer is allocated.
+*/
+static Py_ssize_t pack_external_tags(PyObject *input_list, char *buf, Py_ssize_t cap)
+{
+    Py_ssize_t off = 0;
+    Py_ssize_t input_len = PyList_Size(input_list);
+    Py_ssize_t i;
+    for (i = 0; i < input_len; i++) {
+        PyObject *tuple = PyList_GetItem(input_list, i);
+        const char *hostname = NULL, *source_type = NULL;
+        Py_ssize_t hostname_len = 0, source_type_len = 0;
+
+        if (!PyTuple_Check(tuple)) {
+            PyErr_SetString(PyExc_TypeError, "external host tags list must contain only tuples");
+            return -1;
+        }
+
+        if (!external_tags_string(PyTuple_GetItem(tuple, 0), &hostname, &hostname_len)) {
+            PyErr_SetString(PyExc_TypeError, "hostname is not a valid string");
+            return -1;
+        }
+
+        PyObject *dict = PyTuple_GetItem(tuple, 1);
+        if (!PyDict_Check(dict)) {
+            PyErr_SetString(PyExc_TypeError, "second elem of the host tags tuple must be a dict");
+            return -1;
+        }
+
+        // dict contains only 1 key, if dict is empty don't do anything
+        Py_ssize_t pos = 0;
+        PyObject *key = NULL, *value = NULL;
+        if (!PyDict_Next(dict, &pos, &key, &value)) {
+            continue;
+        }
+
+        if (!external_tags_string(key, &source_type, &source_type_len)) {
+            PyErr_SetString(PyExc_TypeError, "source_type is not a valid string");
+            return -1;
+        }
+
+        if (!PyList_Check(value)) {
+            PyErr_SetString(PyExc_TypeError, "dict value must be a list of tags");
+            return -1;
+        }
+
+        pack_string(buf, cap, &off, hostname, hostname_len);
+        pack_string(buf, cap, &off, source_type, source_type_len);
+
+        // the number of tags is only known once the invalid ones are skipped
+        Py_ssize_t count_off = off;
+        uint32_t count = 0;
+        off += sizeof(uint32_t);
+
+        Py_ssize_t tags_len = PyList_Size(value);
+        Py_ssize_t j;
+        for (j = 0; j < tags_len; j++) {
+            const char *tag = NULL;
+            Py_ssize_t tag_len = 0;
+
+            // ignore invalid tag
+            if (!external_tags_string(PyList_GetItem(value, j), &tag, &tag_len)) {
+                continue;
+            }
+            pack_string(buf, cap, &off, tag, tag_len);
+            count++;
+        }
+        pack_uint32(buf, cap, count_off, count);
+    }
+
+    return off;
 }
 
-/*! \fn PyObject *set_external_tags(PyObject *self, PyObject *args)
+/*! \fn PyObject *set_external_tags_batch(PyObject *input_list)
+    \brief Sends the external tags passed to `set_external_tags` with a single call to
+    `cb_set_external_tags_batch`.
+    \param input_list A PyObject* pointer to the list of `(hostname, {source_type: [tags]})`.
+    \return a PyObject * pointer to `None`, or `NULL` if an exception is raised, in which case no
+    tags are sent.
+
+    The GIL must be held. The list is walked twice, to size the buffer and then to fill it.
+*/
+static PyObject *set_external_tags_batch(PyObject *input_list)
+{
+    Py_ssize_t size = pack_external_tags(input_list, NULL, 0);
+    if (size < 0) {
+        return NULL;
+    }
+    if (size == 0) {
+        Py_RETURN_NONE;
+    }
+    if (size > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "too many external tags in batch");
+        return NULL;
+    }
+
+    char *buf = _malloc(size);
+    if (buf == NULL) {
+        PyErr_SetString(PyExc_MemoryError, "unable to allocate memory, bailing out");
+        return NULL;
+    }
+
+    Py_ssize_t packed = pack_external_tags(input_list, buf, size);
+    if (packed == size) {
+        cb_set_external_tags_batch(buf, (int)size);
+    } else if (packed >= 0) {
+        PyErr_SetString(PyExc_RuntimeError, "external tags changed while being packed");
+    }
+    _free(buf);
+
+    if (packed != size) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+/*! \fn PyObject *set_external_tags(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief This function implements the `datadog_agent.set_external_tags` method,
     allowing to set additional external tags for hostnames.
     \param self A PyObject* pointer to the `datadog_agent` module.
@@ -533,19 +1125,20 @@ static PyObject *read_persistent_cache(PyObject *self, PyObject *args)
     the second element is a dictionary with `source_type` as the key, and a list of tags for
     said `source_type`. For instance: `[('hostname', {'source_type': ['tag1', 'tag2']})]`.
     This function will iterate the python list, and call the `cb_set_external_tags` successively
-    for each element in the list.
+    for each element in the list, unless `cb_set_external_tags_batch` is set, in which case the
+    whole list is packed by `set_external_tags_batch()` and sent in a single call.
     If everything goes well `None` will be returned, otherwise an exception will be set in the
     interpreter and NULL will be returned.
 
     A few integrations such as vsphere or openstack require this functionality to add additional
     tagging for their hosts.
 */
-static PyObject *set_external_tags(PyObject *self, PyObject *args)
+static PyObject *set_external_tags(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     PyObject *input_list = NULL;
 
     // callback must be set
-    if (cb_set_external_tags == NULL) {
+    if (cb_set_external_tags == NULL && cb_set_external_tags_batch == NULL) {
         Py_RETURN_NONE;
     }
 
@@ -554,7 +1147,7 @@ static PyObject *set_external_tags(PyObject *self, PyObject *args)
     // function expects only one positional arg containing a list
     // the reference count in the returned object (input list) is _not_
     // incremented
-    if (!PyArg_ParseTuple(args, "O", &input_list)) {
+    if (!RTLOADER_PARSE_ARGS("O", &input_list)) {
         PyGILState_Release(gstate);
         return NULL;
     }
@@ -566,9 +1159,14 @@ static PyObject *set_external_tags(PyObject *self, PyObject *args)
         return NULL;
     }
 
+    if (cb_set_external_tags_batch != NULL) {
+        PyObject *retval = set_external_tags_batch(input_list);
+        PyGILState_Release(gstate);
+        return retval;
+    }
+
     int error = 0;
-    char *hostname = NULL;
-    char *source_type = NULL;
+    rtloader_arena_mark_t mark = _arena_mark();
     // We already PyList_Check input_list, so PyList_Size won't fail and return -1
     int input_len = PyList_Size(input_list);
     int i;
@@ -582,8 +1180,9 @@ static PyObject *set_external_tags(PyObject *self, PyObject *args)
             goto done;
         }
 
-        // first elem is the hostname
-        hostname = as_string(PyTuple_GetItem(tuple, 0));
+        // first elem is the hostname, the strings are borrowed from the list which outlives the
+        // callback
+        const char *hostname = as_borrowed_utf8(PyTuple_GetItem(tuple, 0));
         if (hostname == NULL) {
             PyErr_SetString(PyExc_TypeError, "hostname is not a valid string");
             error = 1;
@@ -602,13 +1201,11 @@ static PyObject *set_external_tags(PyObject *self, PyObject *args)
         Py_ssize_t pos = 0;
         PyObject *key = NULL, *value = NULL;
         if (!PyDict_Next(dict, &pos, &key, &value)) {
-            _free(hostname);
-            hostname = NULL;
             continue;
         }
 
         // key is the source type (e.g. 'vsphere') value is the list of tags
-        source_type = as_string(key);
+        const char *source_type = as_borrowed_utf8(key);
         if (source_type == NULL) {
             PyErr_SetString(PyExc_TypeError, "source_type is not a valid string");
             error = 1;
@@ -621,17 +1218,18 @@ static PyObject *set_external_tags(PyObject *self, PyObject *args)
             goto done;
         }
 
-        // allocate an array of char* to store the tags we'll send to the Go function
+        // allocate an array of char* to store the tags we'll send to the Go function, it
+        // is released along with the arrays of the other hosts when returning
         char **tags;
         // We already PyList_Check value, so PyList_Size won't fail and return -1
         int tags_len = PyList_Size(value);
-        if (!(tags = (char **)_malloc(sizeof(*tags) * tags_len + 1))) {
+        if (!(tags = (char **)_arena_malloc(sizeof(*tags) * (tags_len + 1)))) {
             PyErr_SetString(PyExc_MemoryError, "unable to allocate memory, bailing out");
             error = 1;
             goto done;
         }
 
-        // copy the list of tags into an array of char*
+        // fill the array of char* with the borrowed tags
         int j, actual_size = 0;
         for (j = 0; j < tags_len; j++) {
             PyObject *s = PyList_GetItem(value, j);
@@ -640,42 +1238,22 @@ static PyObject *set_external_tags(PyObject *self, PyObject *args)
                 break;
             }
 
-            char *tag = as_string(s);
+            const char *tag = as_borrowed_utf8(s);
             if (tag == NULL) {
                 // ignore invalid tag
                 continue;
             }
 
-            tags[actual_size] = tag;
+            tags[actual_size] = (char *)tag;
             actual_size++;
         }
         tags[actual_size] = NULL;
 
-        cb_set_external_tags(hostname, source_type, tags);
-
-        // cleanup
-        for (j = 0; j < actual_size; j++) {
-            _free(tags[j]);
-        }
-        _free(tags);
-
-        if (hostname) {
-            _free(hostname);
-            hostname = NULL;
-        }
-        if (source_type) {
-            _free(source_type);
-            source_type = NULL;
-        }
+        cb_set_external_tags((char *)hostname, (char *)source_type, tags);
     }
 
 done:
-    if (hostname) {
-        _free(hostname);
-    }
-    if (source_type) {
-        _free(source_type);
-    }
+    _arena_reset(mark);
     PyGILState_Release(gstate);
 
     // we need to return NULL to raise the exception set by PyErr_SetString
@@ -686,6 +1264,99 @@ done:
 
 }
 
+// obfuscation_cache_get, called with obfuscation_cache_mutex held
+static PyObject *obfuscation_cache_lookup(PyObject *key)
+{
+    if (obfuscation_cache_size == 0) {
+        Py_CLEAR(obfuscation_cache);
+        obfuscation_cache_stats.entries = 0;
+        return NULL;
+    }
+    if (key == NULL) {
+        PyErr_Clear();
+        return NULL;
+    }
+
+    PyObject *cached = obfuscation_cache != NULL ? PyDict_GetItem(obfuscation_cache, key) : NULL; // borrowed
+    if (cached == NULL) {
+        obfuscation_cache_stats.misses++;
+        return NULL;
+    }
+    obfuscation_cache_stats.hits++;
+
+    // re-insert the entry to mark it as the most recently used one
+    Py_INCREF(cached);
+    if (PyDict_DelItem(obfuscation_cache, key) != 0 || PyDict_SetItem(obfuscation_cache, key, cached) != 0) {
+        PyErr_Clear();
+        obfuscation_cache_stats.entries = PyDict_Size(obfuscation_cache);
+    }
+    return cached;
+}
+
+/*! \fn static PyObject *obfuscation_cache_get(PyObject *key)
+    \brief Looks up a cached obfuscation result.
+    \param key A PyObject* pointer to the cache key, may be NULL.
+    \return A new reference to the cached result, or NULL if it isn't cached. No python
+    error is set in either case.
+
+    Also drops the cache once it has been disabled.
+*/
+static PyObject *obfuscation_cache_get(PyObject *key)
+{
+    RTLOADER_LOCK(obfuscation_cache_mutex);
+    PyObject *cached = obfuscation_cache_lookup(key);
+    RTLOADER_UNLOCK(obfuscation_cache_mutex);
+    return cached;
+}
+
+// obfuscation_cache_put, called with obfuscation_cache_mutex held
+static void obfuscation_cache_store(PyObject *key, PyObject *value)
+{
+    if (obfuscation_cache == NULL && (obfuscation_cache = PyDict_New()) == NULL) {
+        PyErr_Clear();
+        return;
+    }
+
+    while ((size_t)PyDict_Size(obfuscation_cache) >= obfuscation_cache_size) {
+        Py_ssize_t pos = 0;
+        PyObject *oldest = NULL; // borrowed
+        if (!PyDict_Next(obfuscation_cache, &pos, &oldest, NULL)) {
+            break;
+        }
+        Py_INCREF(oldest);
+        int err = PyDict_DelItem(obfuscation_cache, oldest);
+        Py_DECREF(oldest);
+        if (err != 0) {
+            PyErr_Clear();
+            break;
+        }
+        obfuscation_cache_stats.evictions++;
+    }
+
+    if (PyDict_SetItem(obfuscation_cache, key, value) != 0) {
+        PyErr_Clear();
+    }
+    obfuscation_cache_stats.entries = PyDict_Size(obfuscation_cache);
+}
+
+/*! \fn static void obfuscation_cache_put(PyObject *key, PyObject *value)
+    \brief Caches an obfuscation result, evicting the least recently used ones when the
+    cache is full.
+    \param key A PyObject* pointer to the cache key, may be NULL.
+    \param value A PyObject* pointer to the result, may be NULL.
+
+    Failures to cache the result are silently ignored.
+*/
+static void obfuscation_cache_put(PyObject *key, PyObject *value)
+{
+    if (obfuscation_cache_size == 0 || key == NULL || value == NULL) {
+        return;
+    }
+    RTLOADER_LOCK(obfuscation_cache_mutex);
+    obfuscation_cache_store(key, value);
+    RTLOADER_UNLOCK(obfuscation_cache_mutex);
+}
+
 /*! \fn PyObject *obfuscate_sql(PyObject *self, PyObject *args, PyObject *kwargs)
     \brief This function implements the `datadog_agent.obfuscate_sql` method, obfuscating
     the provided sql string.
@@ -696,7 +1367,9 @@ done:
 
     This function is callable as the `datadog_agent.obfuscate_sql` Python method and
     uses the `cb_obfuscate_sql()` callback to retrieve the value from the agent
-    with CGO. If the callback has not been set `None` will be returned.
+    with CGO, the GIL is released while it runs. If the callback has not been set `None` will
+    be returned. Results are cached by query and options once the Agent set an obfuscation
+    cache size.
 */
 static PyObject *obfuscate_sql(PyObject *self, PyObject *args, PyObject *kwargs)
 {
@@ -715,11 +1388,24 @@ static PyObject *obfuscate_sql(PyObject *self, PyObject *args, PyObject *kwargs)
         return NULL;
     }
 
+    PyObject *key = NULL;
+    if (obfuscation_cache_size != 0) {
+        key = Py_BuildValue("(iss)", OBFUSCATE_SQL, rawQuery, optionsObj);
+    }
+    PyObject *retval = obfuscation_cache_get(key);
+    if (retval != NULL) {
+        Py_XDECREF(key);
+        PyGILState_Release(gstate);
+        return retval;
+    }
+
     char *obfQuery = NULL;
     char *error_message = NULL;
+    // the arguments are owned by the call arguments, they outlive the callback
+    Py_BEGIN_ALLOW_THREADS
     obfQuery = cb_obfuscate_sql(rawQuery, optionsObj, &error_message);
+    Py_END_ALLOW_THREADS
 
-    PyObject *retval = NULL;
     if (error_message != NULL) {
         PyErr_SetString(PyExc_RuntimeError, error_message);
     } else if (obfQuery == NULL) {
@@ -727,8 +1413,10 @@ static PyObject *obfuscate_sql(PyObject *self, PyObject *args, PyObject *kwargs)
         PyErr_SetString(PyExc_RuntimeError, "internal error: empty cb_obfuscate_sql response");
     } else {
         retval = PyStringFromCString(obfQuery);
+        obfuscation_cache_put(key, retval);
     }
 
+    Py_XDECREF(key);
     cgo_free(error_message);
     cgo_free(obfQuery);
     PyGILState_Release(gstate);
@@ -753,10 +1441,23 @@ static PyObject *obfuscate_sql_exec_plan(PyObject *self, PyObject *args, PyObjec
     }
     bool normalize = (normalizeObj != NULL && PyBool_Check(normalizeObj) && normalizeObj == Py_True);
 
+    PyObject *key = NULL;
+    if (obfuscation_cache_size != 0) {
+        key = Py_BuildValue("(isO)", OBFUSCATE_SQL_EXEC_PLAN, rawPlan, normalize ? Py_True : Py_False);
+    }
+    PyObject *retval = obfuscation_cache_get(key);
+    if (retval != NULL) {
+        Py_XDECREF(key);
+        PyGILState_Release(gstate);
+        return retval;
+    }
+
     char *error_message = NULL;
-    char *obfPlan = cb_obfuscate_sql_exec_plan(rawPlan, normalize, &error_message);
+    char *obfPlan = NULL;
+    Py_BEGIN_ALLOW_THREADS
+    obfPlan = cb_obfuscate_sql_exec_plan(rawPlan, normalize, &error_message);
+    Py_END_ALLOW_THREADS
 
-    PyObject *retval = NULL;
     if (error_message != NULL) {
         PyErr_SetString(PyExc_RuntimeError, error_message);
     } else if (obfPlan == NULL) {
@@ -764,8 +1465,10 @@ static PyObject *obfuscate_sql_exec_plan(PyObject *self, PyObject *args, PyObjec
         PyErr_SetString(PyExc_RuntimeError, "internal error: empty cb_obfuscate_sql_exec_plan response");
     } else {
         retval = PyStringFromCString(obfPlan);
+        obfuscation_cache_put(key, retval);
     }
 
+    Py_XDECREF(key);
     cgo_free(error_message);
     cgo_free(obfPlan);
     PyGILState_Release(gstate);
@@ -810,7 +1513,8 @@ static PyObject *get_process_start_time(PyObject *self, PyObject *args, PyObject
 
     This function is callable as the `datadog_agent.obfuscate_mongodb_string` Python method and
     uses the `cb_obfuscate_mongodb_string()` callback to retrieve the value from the agent
-    with CGO. If the callback has not been set `None` will be returned.
+    with CGO, the GIL is released while it runs. If the callback has not been set `None`
+    will be returned.
 */
 static PyObject *obfuscate_mongodb_string(PyObject *self, PyObject *args, PyObject *kwargs)
 {
@@ -829,7 +1533,9 @@ static PyObject *obfuscate_mongodb_string(PyObject *self, PyObject *args, PyObje
 
     char *obfCmd = NULL;
     char *error_message = NULL;
+    Py_BEGIN_ALLOW_THREADS
     obfCmd = cb_obfuscate_mongodb_string(cmd, &error_message);
+    Py_END_ALLOW_THREADS
 
     PyObject *retval = NULL;
     if (error_message != NULL) {
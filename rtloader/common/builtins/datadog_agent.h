@@ -42,6 +42,29 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn void _set_config_generation(unsigned long long)
+    \brief Sets the Agent configuration generation used to invalidate cached `get_config`,
+    `get_hostname`, `get_clustername` and `kubeutil.get_connection_info` results.
+    \param generation The current configuration generation, 0 disables the caches.
+
+    Must be called with the GIL held.
+*/
+/*! \fn unsigned long long _get_config_generation(void)
+    \brief Returns the Agent configuration generation, for the other builtins caching
+    values derived from the configuration.
+    \return The current configuration generation, 0 if the caches are disabled.
+*/
+/*! \fn void _set_obfuscation_cache_size(size_t)
+    \brief Sets the maximum number of `obfuscate_sql` and `obfuscate_sql_exec_plan` results
+    to cache.
+    \param size The maximum number of cached results, 0 disables the cache.
+
+    The cache is trimmed on the next obfuscation call.
+*/
+/*! \fn void _get_obfuscation_cache_stats(obfuscation_cache_stats_t *)
+    \brief Retrieves a snapshot of the obfuscation cache counters.
+    \param stats A pointer to the obfuscation_cache_stats_t structure to fill.
+*/
 /*! \fn void _set_headers_cb(cb_headers_t)
     \brief Sets a callback to be used by rtloader to collect the typical HTTP headers for
     agent requests.
@@ -74,6 +97,11 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn void _set_log_level(int)
+    \brief Sets the lowest log level forwarded to the agent logger, the messages below it are
+    dropped by `datadog_agent.log` without calling back into the agent.
+    \param log_level The effective log level of the agent, 0 forwards all the messages.
+*/
 /*! \fn void _set_set_check_metadata_cb(cb_set_check_metadata_t)
     \brief Sets a callback to be used by rtloader to allow setting metadata for a given
     check instance.
@@ -90,6 +118,14 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn void _set_set_external_tags_batch_cb(cb_set_external_tags_batch_t)
+    \brief Sets a callback to be used by rtloader to set the external tags of all the hostnames
+    passed to `set_external_tags` at once.
+    \param object A function pointer with cb_set_external_tags_batch_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
 /*! \fn PyObject *_public_headers(PyObject *self, PyObject *args, PyObject *kwargs);
     \brief Non-static entrypoint to the headers function; providing HTTP headers for agent
     requests.
@@ -119,7 +155,17 @@
 
     The callback is expected to be provided by the rtloader caller - in go-context: CGO.
 */
+/*! \fn int _set_persistent_cache_store(const char *path)
+    \brief Sets the persistent store backing `write_persistent_cache` and `read_persistent_cache`.
+    \param path The path of the store file, NULL closes the current store.
+    \return an int value - 1 for success; 0 for failure with `errno` set, no store is used in
+    that case.
+
+    Keys missing from the store are still read with the `cb_read_persistent_cache` callback.
+    Must be called with the GIL held.
+*/
 
+#define PY_SSIZE_T_CLEAN
 #include <Python.h>
 #include <rtloader_types.h>
 
@@ -137,15 +183,22 @@ void Py2_init_datadog_agent();
 
 void _set_get_clustername_cb(cb_get_clustername_t);
 void _set_get_config_cb(cb_get_config_t);
+void _set_config_generation(unsigned long long);
+unsigned long long _get_config_generation(void);
+void _set_obfuscation_cache_size(size_t);
+void _get_obfuscation_cache_stats(obfuscation_cache_stats_t *);
 void _set_get_hostname_cb(cb_get_hostname_t);
 void _set_tracemalloc_enabled_cb(cb_tracemalloc_enabled_t);
 void _set_get_version_cb(cb_get_version_t);
 void _set_headers_cb(cb_headers_t);
 void _set_log_cb(cb_log_t);
+void _set_log_level(int);
 void _set_set_check_metadata_cb(cb_set_check_metadata_t);
 void _set_set_external_tags_cb(cb_set_external_tags_t);
+void _set_set_external_tags_batch_cb(cb_set_external_tags_batch_t);
 void _set_write_persistent_cache_cb(cb_write_persistent_cache_t);
 void _set_read_persistent_cache_cb(cb_read_persistent_cache_t);
+int _set_persistent_cache_store(const char *);
 void _set_obfuscate_sql_cb(cb_obfuscate_sql_t);
 void _set_obfuscate_sql_exec_plan_cb(cb_obfuscate_sql_exec_plan_t);
 void _set_get_process_start_time_cb(cb_get_process_start_time_t);
@@ -5,12 +5,26 @@
 #include "kubeutil.h"
 
 #include "cgo_free.h"
+#include "datadog_agent.h"
+#include "free_threading.h"
 #include "stringutils.h"
 
+#include <time.h>
+
+#define CONNECTION_INFO_CACHE_TTL 60
+
 
 // these must be set by the Agent
 static cb_get_connection_info_t cb_get_connection_info = NULL;
 
+// get_connection_info result, cached until the Agent configuration generation changes or
+// for CONNECTION_INFO_CACHE_TTL seconds, as the token it holds is rotated. Callers get a
+// copy of it as they may mutate the returned dict.
+static PyObject *connection_info_cache = NULL;
+static unsigned long long connection_info_cache_generation = 0;
+static time_t connection_info_cache_expiration = 0;
+RTLOADER_MUTEX(connection_info_cache_mutex);
+
 // forward declarations
 static PyObject *get_connection_info();
 
@@ -24,7 +38,9 @@ static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, KUBEUTIL_MODULE_
 
 PyMODINIT_FUNC PyInit_kubeutil(void)
 {
-    return PyModule_Create(&module_def);
+    PyObject *m = PyModule_Create(&module_def);
+    RTLOADER_MODULE_GIL_NOT_USED(m);
+    return m;
 }
 #elif defined(DATADOG_AGENT_TWO)
 // in Python2 keep the object alive for the program lifetime
@@ -49,7 +65,9 @@ void _set_get_connection_info_cb(cb_get_connection_info_t cb)
     \return a PyObject * pointer to a python dictionary containing the K8s connection info.
 
     This function is callable as the `kubeutil.get_connection_info` python method, the
-    callback is expected to have been set previously, if not `None` will be returned.
+    callback is expected to have been set previously, if not `None` will be returned. The
+    GIL is released while the callback runs. Once the Agent set a configuration generation
+    the result is cached for a minute, until the generation changes.
 */
 PyObject *get_connection_info(PyObject *self, PyObject *args)
 {
@@ -60,7 +78,28 @@ PyObject *get_connection_info(PyObject *self, PyObject *args)
         Py_RETURN_NONE;
     }
 
+    unsigned long long generation = _get_config_generation();
+    time_t now = time(NULL);
+    PyObject *cached = NULL; // new ref
+    RTLOADER_LOCK(connection_info_cache_mutex);
+    if (connection_info_cache_generation != generation || now >= connection_info_cache_expiration) {
+        Py_CLEAR(connection_info_cache);
+        connection_info_cache_generation = generation;
+    }
+    cached = connection_info_cache;
+    Py_XINCREF(cached);
+    RTLOADER_UNLOCK(connection_info_cache_mutex);
+
+    if (cached != NULL) {
+        PyObject *copy = PyDict_Copy(cached);
+        Py_DECREF(cached);
+        return copy;
+    }
+
+    // the kubelet may have to be queried
+    Py_BEGIN_ALLOW_THREADS
     cb_get_connection_info(&data);
+    Py_END_ALLOW_THREADS
 
     // create a new ref
     PyObject *conn_info_dict = from_yaml(data);
@@ -76,5 +115,20 @@ PyObject *get_connection_info(PyObject *self, PyObject *args)
         return PyDict_New();
     }
 
+    // empty dicts are returned when the kubelet couldn't be reached, don't cache them
+    if (generation != 0 && PyDict_Size(conn_info_dict) > 0) {
+        PyObject *copy = PyDict_Copy(conn_info_dict);
+        if (copy == NULL) {
+            PyErr_Clear();
+        } else {
+            RTLOADER_LOCK(connection_info_cache_mutex);
+            PyObject *previous = connection_info_cache;
+            connection_info_cache = copy;
+            connection_info_cache_expiration = now + CONNECTION_INFO_CACHE_TTL;
+            RTLOADER_UNLOCK(connection_info_cache_mutex);
+            Py_XDECREF(previous);
+        }
+    }
+
     return conn_info_dict;
 }
@@ -6,15 +6,27 @@
 #include "tagger.h"
 
 #include "cgo_free.h"
+#include "fastcall.h"
+#include "free_threading.h"
 #include "stringutils.h"
 
 // these must be set by the Agent
 static cb_tags_t cb_tags = NULL;
 
-/*! \fn int parseArgs(PyObject *args, char **id, int *cardinality)
+// cb_tags results, keyed by (entity id, cardinality). The cache is only used once the
+// Agent provided a tagger generation and is dropped whenever it changes.
+static PyObject *tags_cache = NULL;
+static unsigned long long tagger_generation = 0;
+static unsigned long long tags_cache_generation = 0;
+RTLOADER_MUTEX(tags_cache_mutex);
+
+// bound the cache when the generation doesn't change for a long time
+#define MAX_TAGS_CACHE_ENTRIES 4096
+
+/*! \fn int parseArgs(RTLOADER_FASTCALL_ARGS, char **id, int *cardinality)
     \brief This function parses the python arguments to it's C homonyms for
     entity id and cardinality.
-    \param args A PyObject* pointer to the corresponding python args.
+    \param args The corresponding python args, see RTLOADER_FASTCALL_ARGS.
     \param id A char** C-string pointer, it will be set to the entity id string.
     \param cardinality An int* pointer, it will be set to the corresponding tag
     cardinality for the entity id.
@@ -25,11 +37,11 @@ static cb_tags_t cb_tags = NULL;
     not be used after calling this function. The list and string python references
     are created by this function, no futher considerations are necessary.
 */
-int parseArgs(PyObject *args, char **id, int *cardinality)
+int parseArgs(RTLOADER_FASTCALL_ARGS, char **id, int *cardinality)
 {
     PyGILState_STATE gstate = PyGILState_Ensure();
 
-    if (!PyArg_ParseTuple(args, "si", id, cardinality)) {
+    if (!RTLOADER_PARSE_ARGS("si", id, cardinality)) {
         PyGILState_Release(gstate);
         return 0;
     }
@@ -68,7 +80,71 @@ PyObject *buildTagsList(char **tags)
     return res;
 }
 
-/*! \fn PyObject *tag(PyObject *self, PyObject *args)
+/*! \fn PyObject *fetchTags(char *id, int cardinality)
+    \brief Returns the tag list of an entity, from the cache when possible.
+    \param id A C-string with the entity id.
+    \param cardinality The tag cardinality.
+    \return a PyObject * pointer to a new python tag list, or NULL in an error.
+
+    Without a tagger generation set this is a plain call to the cb_tags callback. Otherwise
+    the tags are cached as an immutable tuple per entity and cardinality until the generation
+    changes, and every caller gets a fresh list built from it: no CGO round trip nor string
+    allocation is needed for entities already looked up.
+*/
+static PyObject *fetchTags(char *id, int cardinality)
+{
+    if (tagger_generation == 0) {
+        return buildTagsList(cb_tags(id, cardinality));
+    }
+
+    PyGILState_STATE gstate = PyGILState_Ensure();
+
+    PyObject *retval = NULL;
+    PyObject *cached = NULL; // new reference
+    PyObject *key = Py_BuildValue("(si)", id, cardinality); // new reference
+    if (key == NULL) {
+        goto done;
+    }
+
+    RTLOADER_LOCK(tags_cache_mutex);
+    if (tags_cache == NULL) {
+        tags_cache = PyDict_New();
+    } else if (tags_cache_generation != tagger_generation || PyDict_Size(tags_cache) >= MAX_TAGS_CACHE_ENTRIES) {
+        PyDict_Clear(tags_cache);
+    }
+    tags_cache_generation = tagger_generation;
+
+    if (tags_cache != NULL) {
+        cached = PyDict_GetItem(tags_cache, key);
+        Py_XINCREF(cached);
+    }
+    RTLOADER_UNLOCK(tags_cache_mutex);
+
+    if (cached != NULL) {
+        retval = PySequence_List(cached);
+        goto done;
+    }
+
+    retval = buildTagsList(cb_tags(id, cardinality));
+    if (retval != NULL) {
+        PyObject *tags = PyList_AsTuple(retval); // new reference
+        // a failure to cache the tags doesn't affect the caller
+        RTLOADER_LOCK(tags_cache_mutex);
+        if (tags == NULL || tags_cache == NULL || PyDict_SetItem(tags_cache, key, tags) == -1) {
+            PyErr_Clear();
+        }
+        RTLOADER_UNLOCK(tags_cache_mutex);
+        Py_XDECREF(tags);
+    }
+
+done:
+    Py_XDECREF(cached);
+    Py_XDECREF(key);
+    PyGILState_Release(gstate);
+    return retval;
+}
+
+/*! \fn PyObject *tag(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief builds a tag list as per the entity id and cardinality passed as method
     arguments.
     \param self A PyObject* pointer to the tagger module.
@@ -81,7 +157,7 @@ PyObject *buildTagsList(char **tags)
     callback, please read more about the internals of the registered callback.
     There are important memory considerations so please keep that in mind.
 */
-PyObject *tag(PyObject *self, PyObject *args)
+PyObject *tag(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     if (cb_tags == NULL) {
         // Py_RETURN_NONE macro increases the refcount on Py_None
@@ -90,7 +166,7 @@ PyObject *tag(PyObject *self, PyObject *args)
 
     char *id;
     int cardinality;
-    if (!parseArgs(args, &id, &cardinality)) {
+    if (!parseArgs(RTLOADER_FASTCALL_FORWARD, &id, &cardinality)) {
         return NULL;
     }
 
@@ -105,10 +181,10 @@ PyObject *tag(PyObject *self, PyObject *args)
         return NULL;
     }
 
-    return buildTagsList(cb_tags(id, cardinality));
+    return fetchTags(id, cardinality);
 }
 
-/*! \fn PyObject *get_tag(PyObject *self, PyObject *args)
+/*! \fn PyObject *get_tag(PyObject *self, RTLOADER_FASTCALL_ARGS)
     \brief builds a tag list as per the entity id and cardinality passed as
     arguments.
     \param self A PyObject* pointer to the tagger module.
@@ -123,7 +199,7 @@ PyObject *tag(PyObject *self, PyObject *args)
     the registered callback. There are important memory considerations so please
     keep that in mind.
 */
-PyObject *get_tags(PyObject *self, PyObject *args)
+PyObject *get_tags(PyObject *self, RTLOADER_FASTCALL_ARGS)
 {
     if (cb_tags == NULL) {
         // Py_RETURN_NONE macro increases the refcount on Py_None
@@ -132,7 +208,7 @@ PyObject *get_tags(PyObject *self, PyObject *args)
 
     char *id;
     int highCard;
-    if (!parseArgs(args, &id, &highCard)) {
+    if (!parseArgs(RTLOADER_FASTCALL_FORWARD, &id, &highCard)) {
         return NULL;
     }
 
@@ -143,7 +219,7 @@ PyObject *get_tags(PyObject *self, PyObject *args)
         cardinality = DATADOG_AGENT_RTLOADER_TAGGER_LOW;
     }
 
-    return buildTagsList(cb_tags(id, cardinality));
+    return fetchTags(id, cardinality);
 }
 
 void _set_tags_cb(cb_tags_t cb)
@@ -151,9 +227,14 @@ void _set_tags_cb(cb_tags_t cb)
     cb_tags = cb;
 }
 
+void _set_tagger_generation(unsigned long long generation)
+{
+    tagger_generation = generation;
+}
+
 static PyMethodDef methods[] = {
-    { "tag", (PyCFunction)tag, METH_VARARGS, "Get tags for an entity." },
-    { "get_tags", (PyCFunction)get_tags, METH_VARARGS, "(Deprecated) Get tags for an entity." },
+    { "tag", (PyCFunction)tag, RTLOADER_METH_FASTCALL, "Get tags for an entity." },
+    { "get_tags", (PyCFunction)get_tags, RTLOADER_METH_FASTCALL, "(Deprecated) Get tags for an entity." },
     { NULL, NULL } // guards
 };
 
@@ -178,6 +259,7 @@ static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, TAGGER_MODULE_NA
 PyMODINIT_FUNC PyInit_tagger(void)
 {
     PyObject *module = PyModule_Create(&module_def);
+    RTLOADER_MODULE_GIL_NOT_USED(module);
     add_constants(module);
     return module;
 }
@@ -40,6 +40,13 @@
     tagger generate tags. This memory should be freed with the cgo_free helper
     available when done.
 */
+/*! \fn void _set_tagger_generation(unsigned long long)
+    \brief Sets the tagger store generation used to invalidate cached `tag` and
+    `get_tags` results.
+    \param generation The current tagger generation, 0 disables the cache.
+
+    Must be called with the GIL held.
+*/
 
 #include <Python.h>
 #include <rtloader_types.h>
@@ -59,6 +66,7 @@ void Py2_init_tagger();
 #endif
 
 void _set_tags_cb(cb_tags_t);
+void _set_tagger_generation(unsigned long long);
 
 #ifdef __cplusplus
 }
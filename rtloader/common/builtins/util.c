@@ -4,6 +4,7 @@
 // Copyright 2019-present Datadog, Inc.
 #include "util.h"
 #include "datadog_agent.h"
+#include "free_threading.h"
 #include "util.h"
 
 #include <stringutils.h>
@@ -24,7 +25,9 @@ static struct PyModuleDef module_def = { PyModuleDef_HEAD_INIT, UTIL_MODULE_NAME
 
 PyMODINIT_FUNC PyInit_util(void)
 {
-    return PyModule_Create(&module_def);
+    PyObject *m = PyModule_Create(&module_def);
+    RTLOADER_MODULE_GIL_NOT_USED(m);
+    return m;
 }
 #elif defined(DATADOG_AGENT_TWO)
 // in Python2 keep the object alive for the program lifetime
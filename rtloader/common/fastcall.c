@@ -0,0 +1,180 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/).
+// Copyright 2019-present Datadog, Inc.
+#include "fastcall.h"
+
+#include <limits.h>
+#include <stdarg.h>
+#include <string.h>
+
+/*! \fn static const char *type_name(PyObject *obj)
+    \brief Returns the type name used in the conversion error messages.
+*/
+static const char *type_name(PyObject *obj)
+{
+    return obj == Py_None ? "None" : Py_TYPE(obj)->tp_name;
+}
+
+/*! \fn static int check_nargs(Py_ssize_t nargs, const char *format)
+    \brief Checks the number of arguments against the format, raising a TypeError worded
+    like `PyArg_ParseTuple` ones if it doesn't match.
+    \return an int value - non-zero for success; zero for failure.
+*/
+static int check_nargs(Py_ssize_t nargs, const char *format)
+{
+    Py_ssize_t min = -1;
+    Py_ssize_t max = 0;
+    const char *f;
+
+    for (f = format; *f; f++) {
+        if (*f == '|') {
+            min = max;
+        } else if (*f != '#') {
+            max++;
+        }
+    }
+    if (min < 0) {
+        min = max;
+    }
+
+    if (nargs >= min && nargs <= max) {
+        return 1;
+    }
+
+    Py_ssize_t expected = nargs < min ? min : max;
+    PyErr_Format(PyExc_TypeError, "function takes %s %zd argument%s (%zd given)",
+                 min == max ? "exactly" : nargs < min ? "at least" : "at most", expected,
+                 expected == 1 ? "" : "s", nargs);
+    return 0;
+}
+
+/*! \fn static int as_long(PyObject *arg, long *value)
+    \brief Converts an integer argument, rejecting floats like `PyArg_ParseTuple` does.
+    \return an int value - non-zero for success; zero for failure.
+*/
+static int as_long(PyObject *arg, long *value)
+{
+    if (PyFloat_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "integer argument expected, got float");
+        return 0;
+    }
+    *value = PyLong_AsLong(arg);
+    return !(*value == -1 && PyErr_Occurred());
+}
+
+int parse_fastcall_args(PyObject *const *args, Py_ssize_t nargs, const char *format, ...)
+{
+    if (!check_nargs(nargs, format)) {
+        return 0;
+    }
+
+    va_list va;
+    va_start(va, format);
+
+    int ok = 1;
+    Py_ssize_t i = 0;
+    const char *f;
+    for (f = format; *f && i < nargs; f++) {
+        PyObject *arg = args[i]; // borrowed
+        long lvalue;
+        double dvalue;
+
+        switch (*f) {
+        case '|':
+            continue;
+        case 'O':
+            *va_arg(va, PyObject **) = arg;
+            break;
+        case 's':
+            if (f[1] == '#') {
+                const char **str = va_arg(va, const char **);
+                Py_ssize_t *size = va_arg(va, Py_ssize_t *);
+                f++;
+                if (PyUnicode_Check(arg)) {
+                    *str = PyUnicode_AsUTF8AndSize(arg, size);
+                    ok = *str != NULL;
+                } else if (PyBytes_Check(arg)) {
+                    *str = PyBytes_AS_STRING(arg);
+                    *size = PyBytes_GET_SIZE(arg);
+                } else {
+                    PyErr_Format(PyExc_TypeError, "argument %zd must be str or read-only bytes-like object, not %.50s",
+                                 i + 1, type_name(arg));
+                    ok = 0;
+                }
+            } else {
+                const char **str = va_arg(va, const char **);
+                Py_ssize_t size = 0;
+                if (!PyUnicode_Check(arg)) {
+                    PyErr_Format(PyExc_TypeError, "argument %zd must be str, not %.50s", i + 1, type_name(arg));
+                    ok = 0;
+                } else if ((*str = PyUnicode_AsUTF8AndSize(arg, &size)) == NULL) {
+                    ok = 0;
+                } else if ((Py_ssize_t)strlen(*str) != size) {
+                    PyErr_SetString(PyExc_ValueError, "embedded null character");
+                    ok = 0;
+                }
+            }
+            break;
+        case 'i':
+            if (!(ok = as_long(arg, &lvalue))) {
+                break;
+            }
+            if (lvalue > INT_MAX || lvalue < INT_MIN) {
+                PyErr_SetString(PyExc_OverflowError, lvalue > INT_MAX ? "signed integer is greater than maximum"
+                                                                      : "signed integer is less than minimum");
+                ok = 0;
+                break;
+            }
+            *va_arg(va, int *) = (int)lvalue;
+            break;
+        case 'b':
+            if (!(ok = as_long(arg, &lvalue))) {
+                break;
+            }
+            if (lvalue > UCHAR_MAX || lvalue < 0) {
+                PyErr_SetString(PyExc_OverflowError, lvalue > UCHAR_MAX ? "unsigned byte integer is greater than maximum"
+                                                                        : "unsigned byte integer is less than minimum");
+                ok = 0;
+                break;
+            }
+            *va_arg(va, unsigned char *) = (unsigned char)lvalue;
+            break;
+        case 'L':
+            if (PyFloat_Check(arg)) {
+                PyErr_SetString(PyExc_TypeError, "integer argument expected, got float");
+                ok = 0;
+                break;
+            }
+            *va_arg(va, long long *) = PyLong_AsLongLong(arg);
+            ok = !PyErr_Occurred();
+            break;
+        case 'd':
+        case 'f':
+            dvalue = PyFloat_AsDouble(arg);
+            if (dvalue == -1.0 && PyErr_Occurred()) {
+                ok = 0;
+                break;
+            }
+            if (*f == 'd') {
+                *va_arg(va, double *) = dvalue;
+            } else {
+                *va_arg(va, float *) = (float)dvalue;
+            }
+            break;
+        default:
+            PyErr_Format(PyExc_SystemError, "bad format char '%c' passed to parse_fastcall_args", *f);
+            ok = 0;
+            break;
+        }
+
+        if (!ok) {
+            break;
+        }
+        i++;
+    }
+
+    va_end(va);
+    return ok;
+}
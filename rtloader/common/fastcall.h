@@ -0,0 +1,70 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/).
+// Copyright 2019-present Datadog, Inc.
+#ifndef DATADOG_AGENT_RTLOADER_FASTCALL_H
+#define DATADOG_AGENT_RTLOADER_FASTCALL_H
+
+/*! \file fastcall.h
+    \brief RtLoader builtin calling convention helpers.
+
+    Builtins defined with these macros use the `METH_FASTCALL` calling convention with
+    Python 3: the interpreter hands over the positional arguments as a C array instead of
+    packing them in a tuple, and `RTLOADER_PARSE_ARGS` unpacks them with `parse_fastcall_args`.
+    With Python 2 the macros expand to the usual `METH_VARARGS` and `PyArg_ParseTuple`, so the
+    same function body serves both backends.
+*/
+/*! \def RTLOADER_FASTCALL_ARGS
+    \brief Parameter list, following `self`, of a builtin registered with `RTLOADER_METH_FASTCALL`.
+*/
+/*! \def RTLOADER_FASTCALL_FORWARD
+    \brief Forwards the `RTLOADER_FASTCALL_ARGS` of a builtin to a helper taking them as well.
+*/
+/*! \def RTLOADER_METH_FASTCALL
+    \brief `PyMethodDef` flags of a builtin taking `RTLOADER_FASTCALL_ARGS`.
+*/
+/*! \def RTLOADER_PARSE_ARGS
+    \brief Unpacks the arguments of a builtin taking `RTLOADER_FASTCALL_ARGS`, the format and
+    the variadic pointers follow the `PyArg_ParseTuple` conventions.
+*/
+/*! \fn int parse_fastcall_args(PyObject *const *args, Py_ssize_t nargs, const char *format, ...)
+    \brief Unpacks an array of positional arguments into C values, python3 only.
+    \param args A PyObject* array of borrowed references to the arguments.
+    \param nargs The number of arguments in the array.
+    \param format The conversion string, see below.
+    \return an int value - non-zero for success; zero for failure, with a python error set.
+
+    This is a lean replacement for `PyArg_ParseTuple` on a `METH_FASTCALL` argument array,
+    supporting the subset of the format units the builtins use: `O` (borrowed object), `s`
+    (UTF-8 string owned by the object), `s#` (string or bytes and its `Py_ssize_t` length),
+    `i` (int), `L` (long long), `b` (unsigned char), `d` (double), `f` (float) and `|` to
+    mark the start of the optional arguments. Errors are raised with the same types and
+    messages as `PyArg_ParseTuple`.
+*/
+
+#include <Python.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef DATADOG_AGENT_THREE
+#    define RTLOADER_FASTCALL_ARGS PyObject *const *args, Py_ssize_t nargs
+#    define RTLOADER_FASTCALL_FORWARD args, nargs
+#    define RTLOADER_METH_FASTCALL METH_FASTCALL
+#    define RTLOADER_PARSE_ARGS(format, ...) parse_fastcall_args(args, nargs, format, __VA_ARGS__)
+
+int parse_fastcall_args(PyObject *const *args, Py_ssize_t nargs, const char *format, ...);
+#else
+#    define RTLOADER_FASTCALL_ARGS PyObject *args
+#    define RTLOADER_FASTCALL_FORWARD args
+#    define RTLOADER_METH_FASTCALL METH_VARARGS
+#    define RTLOADER_PARSE_ARGS(format, ...) PyArg_ParseTuple(args, format, __VA_ARGS__)
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,53 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/).
+// Copyright 2019-present Datadog, Inc.
+#ifndef DATADOG_AGENT_RTLOADER_FREE_THREADING_H
+#define DATADOG_AGENT_RTLOADER_FREE_THREADING_H
+
+/*! \file free_threading.h
+    \brief RtLoader helpers for the free-threaded builds of CPython.
+
+    The free-threaded builds (3.13t and later) define `Py_GIL_DISABLED`: builtins are then
+    called concurrently and the state they share between calls, such as their caches, has to
+    be guarded by a mutex. With the other builds the GIL serializes the calls and the macros
+    expand to nothing.
+*/
+/*! \def RTLOADER_MUTEX
+    \brief Defines a static mutex guarding the shared state of a builtin.
+*/
+/*! \def RTLOADER_LOCK
+    \brief Locks a mutex defined with `RTLOADER_MUTEX`. The mutex isn't reentrant: no
+    callback nor Python code that could call the builtin again must run while it is held.
+*/
+/*! \def RTLOADER_UNLOCK
+    \brief Unlocks a mutex defined with `RTLOADER_MUTEX`.
+*/
+/*! \def RTLOADER_MODULE_GIL_NOT_USED
+    \brief Declares that a builtin module is safe to run without the GIL, which the
+    interpreter otherwise enables again when a single-phase initialization module is imported.
+*/
+
+#include <Python.h>
+
+#ifdef Py_GIL_DISABLED
+#    define RTLOADER_MUTEX(name) static PyMutex name = { 0 }
+#    define RTLOADER_LOCK(name) PyMutex_Lock(&name)
+#    define RTLOADER_UNLOCK(name) PyMutex_Unlock(&name)
+#    define RTLOADER_MODULE_GIL_NOT_USED(module)                          \
+        do {                                                              \
+            if ((module) != NULL) {                                       \
+                PyUnstable_Module_SetGIL((module), Py_MOD_GIL_NOT_USED); \
+            }                                                             \
+        } while (0)
+#else
+#    define RTLOADER_MUTEX(name) typedef int rtloader_unused_##name
+#    define RTLOADER_LOCK(name)
+#    define RTLOADER_UNLOCK(name)
+#    define RTLOADER_MODULE_GIL_NOT_USED(module) \
+        do {                                     \
+        } while (0)
+#endif
+
+#endif
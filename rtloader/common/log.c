@@ -7,15 +7,45 @@
 // these must be set by the Agent
 static cb_log_t cb_log = NULL;
 
+// messages below this level are dropped without calling cb_log, 0 lets all of them through
+static volatile int log_level_threshold = 0;
+
 void _set_log_cb(cb_log_t cb)
 {
     cb_log = cb;
 }
 
+void _set_log_level(int log_level)
+{
+    log_level_threshold = log_level;
+}
+
+int _get_log_level()
+{
+    return log_level_threshold;
+}
+
+int _is_log_level_enabled(int log_level)
+{
+    switch (log_level) {
+    case DATADOG_AGENT_TRACE:
+    case DATADOG_AGENT_DEBUG:
+    case DATADOG_AGENT_INFO:
+    case DATADOG_AGENT_WARNING:
+    case DATADOG_AGENT_ERROR:
+    case DATADOG_AGENT_CRITICAL:
+        break;
+    default:
+        // the agent logs unknown levels as INFO
+        log_level = DATADOG_AGENT_INFO;
+    }
+    return log_level >= log_level_threshold;
+}
+
 // Logs a message to the agent logger. Caller is in charge of freeing the
 // message if needed.
 void agent_log(log_level_t log_level, char *message) {
-    if (cb_log == NULL || message == NULL) {
+    if (cb_log == NULL || message == NULL || !_is_log_level_enabled(log_level)) {
         return;
     }
     cb_log(message, log_level);
@@ -27,10 +27,32 @@ extern "C" {
 */
 void _set_log_cb(cb_log_t);
 
+/*! \fn void _set_log_level(int)
+    \brief Sets the lowest log level forwarded to the agent logger.
+    \param log_level The effective log level of the agent, one of log_level_t, 0 forwards
+    all the messages.
+
+    Messages below this level are dropped by rtloader without calling back into the agent.
+*/
+void _set_log_level(int);
+
+/*! \fn int _get_log_level()
+    \brief Returns the lowest log level forwarded to the agent logger, see `_set_log_level`.
+*/
+int _get_log_level();
+
+/*! \fn int _is_log_level_enabled(int)
+    \brief Returns whether messages of the given log level are forwarded to the agent logger.
+    \param log_level The log level of the message, unknown levels are handled as INFO.
+*/
+int _is_log_level_enabled(int);
+
 /*! \fn void agent_log( log_level_t, const char *)
     \brief Logs the message to the agent loggers.
     \param log_level_t The log level to use to log the message.
     \param const char* A pointer to the message.
+
+    The message is dropped if its level is filtered, see `_set_log_level`.
 */
 void agent_log(log_level_t, char *);
 
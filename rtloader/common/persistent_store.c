@@ -0,0 +1,578 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/).
+// Copyright 2019-present Datadog, Inc.
+#include "persistent_store.h"
+#include "rtloader_mem.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#    include <fcntl.h>
+#    include <sys/file.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <sys/uio.h>
+#    include <unistd.h>
+
+// file layout: an header made of the magic and the format version, followed by the records.
+// Each record is made of its checksum, the key length and the value length, all encoded as
+// little-endian 32 bits integers, followed by the key and the value.
+#    define STORE_MAGIC "DDPCACHE"
+#    define STORE_MAGIC_LEN 8
+#    define STORE_VERSION 1
+#    define STORE_HEADER_LEN 16
+#    define RECORD_HEADER_LEN 12
+
+// stores are compacted once overwritten records make more than half of a file of at least
+// this size
+#    define COMPACTION_MIN_SIZE (1 << 20)
+#    define INITIAL_BUCKETS 64
+
+#    define FNV_OFFSET_BASIS 2166136261u
+#    define FNV_PRIME 16777619u
+
+struct persistent_store_mapping_s {
+    char *addr;
+    size_t len;
+    int refs; // atomic, values can be released without holding the lock of the store
+};
+
+typedef struct index_entry_s {
+    struct index_entry_s *next;
+    uint32_t hash;
+    size_t offset; // offset of the record in the file
+    size_t key_len;
+    size_t value_len;
+    char *key; // allocated along with the entry
+} index_entry_t;
+
+struct persistent_store_s {
+    char *path;
+    int fd;
+    int lock_fd;
+    size_t size; // end of the last valid record
+    size_t live; // length of the records referenced by the index
+    index_entry_t **buckets;
+    size_t nbuckets;
+    size_t count;
+    persistent_store_mapping_t *mapping; // may not cover the latest records
+};
+
+static uint32_t fnv1a(uint32_t hash, const char *data, size_t len)
+{
+    size_t i;
+    for (i = 0; i < len; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static void put_u32(unsigned char *buf, uint32_t value)
+{
+    buf[0] = value & 0xff;
+    buf[1] = (value >> 8) & 0xff;
+    buf[2] = (value >> 16) & 0xff;
+    buf[3] = (value >> 24) & 0xff;
+}
+
+static uint32_t get_u32(const char *buf)
+{
+    const unsigned char *b = (const unsigned char *)buf;
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+static uint32_t record_checksum(const unsigned char *lengths, const char *key, size_t key_len, const char *value,
+                                size_t value_len)
+{
+    uint32_t hash = fnv1a(FNV_OFFSET_BASIS, (const char *)lengths, 8);
+    hash = fnv1a(hash, key, key_len);
+    return fnv1a(hash, value, value_len);
+}
+
+static size_t record_len(const index_entry_t *entry)
+{
+    return RECORD_HEADER_LEN + entry->key_len + entry->value_len;
+}
+
+static int write_all(int fd, const char *buf, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = write(fd, buf, len);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        buf += n;
+        len -= n;
+    }
+    return 1;
+}
+
+static char *path_with_suffix(const char *path, const char *suffix)
+{
+    size_t len = strlen(path);
+    char *res = _malloc(len + strlen(suffix) + 1);
+    if (res == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    memcpy(res, path, len);
+    strcpy(res + len, suffix);
+    return res;
+}
+
+/*
+ * mappings
+ */
+
+static persistent_store_mapping_t *map_file(int fd, size_t len)
+{
+    persistent_store_mapping_t *mapping = _malloc(sizeof(*mapping));
+    if (mapping == NULL) {
+        errno = ENOMEM;
+        return NULL;
+    }
+
+    mapping->addr = mmap(NULL, len, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping->addr == MAP_FAILED) {
+        int err = errno;
+        _free(mapping);
+        errno = err;
+        return NULL;
+    }
+    mapping->len = len;
+    mapping->refs = 1;
+    return mapping;
+}
+
+void persistent_store_mapping_release(persistent_store_mapping_t *mapping)
+{
+    if (mapping == NULL || __sync_sub_and_fetch(&mapping->refs, 1) > 0) {
+        return;
+    }
+    munmap(mapping->addr, mapping->len);
+    _free(mapping);
+}
+
+/*! \fn static int ensure_mapped(persistent_store_t *store, size_t end)
+    \brief Remaps the store file if the current mapping doesn't cover the first `end` bytes.
+    \return an int value - 1 for success; 0 for failure with `errno` set.
+
+    The previous mapping is released, it is only unmapped once no value points into it.
+*/
+static int ensure_mapped(persistent_store_t *store, size_t end)
+{
+    if (store->mapping != NULL && store->mapping->len >= end) {
+        return 1;
+    }
+
+    persistent_store_mapping_t *mapping = map_file(store->fd, store->size);
+    if (mapping == NULL) {
+        return 0;
+    }
+    persistent_store_mapping_release(store->mapping);
+    store->mapping = mapping;
+    return 1;
+}
+
+/*
+ * index
+ */
+
+static index_entry_t **find_entry(persistent_store_t *store, const char *key, size_t key_len, uint32_t hash)
+{
+    index_entry_t **link = &store->buckets[hash % store->nbuckets];
+    while (*link != NULL) {
+        index_entry_t *entry = *link;
+        if (entry->hash == hash && entry->key_len == key_len && memcmp(entry->key, key, key_len) == 0) {
+            break;
+        }
+        link = &entry->next;
+    }
+    return link;
+}
+
+static void grow_index(persistent_store_t *store)
+{
+    size_t nbuckets = store->nbuckets * 2;
+    index_entry_t **buckets = _malloc(sizeof(*buckets) * nbuckets);
+    if (buckets == NULL) {
+        // lookups get slower but keep working
+        return;
+    }
+    memset(buckets, 0, sizeof(*buckets) * nbuckets);
+
+    size_t i;
+    for (i = 0; i < store->nbuckets; i++) {
+        index_entry_t *entry = store->buckets[i];
+        while (entry != NULL) {
+            index_entry_t *next = entry->next;
+            entry->next = buckets[entry->hash % nbuckets];
+            buckets[entry->hash % nbuckets] = entry;
+            entry = next;
+        }
+    }
+    _free(store->buckets);
+    store->buckets = buckets;
+    store->nbuckets = nbuckets;
+}
+
+/*! \fn static int index_record(persistent_store_t *store, const char *key, size_t key_len, size_t offset, size_t value_len)
+    \brief Points the key to the record at `offset`, replacing its previous record if any.
+    \return an int value - 1 for success; 0 for failure with `errno` set.
+*/
+static int index_record(persistent_store_t *store, const char *key, size_t key_len, size_t offset, size_t value_len)
+{
+    uint32_t hash = fnv1a(FNV_OFFSET_BASIS, key, key_len);
+    index_entry_t **link = find_entry(store, key, key_len, hash);
+    index_entry_t *entry = *link;
+
+    if (entry != NULL) {
+        store->live -= record_len(entry);
+    } else {
+        entry = _malloc(sizeof(*entry) + key_len);
+        if (entry == NULL) {
+            errno = ENOMEM;
+            return 0;
+        }
+        entry->next = NULL;
+        entry->hash = hash;
+        entry->key_len = key_len;
+        entry->key = (char *)(entry + 1);
+        memcpy(entry->key, key, key_len);
+        *link = entry;
+        store->count++;
+    }
+    entry->offset = offset;
+    entry->value_len = value_len;
+    store->live += record_len(entry);
+
+    if (store->count > store->nbuckets / 4 * 3) {
+        grow_index(store);
+    }
+    return 1;
+}
+
+/*! \fn static int load_records(persistent_store_t *store, size_t file_size)
+    \brief Indexes the records of the store file, dropping the ones following the first
+    truncated or corrupted record.
+    \return an int value - 1 for success; 0 for failure with `errno` set.
+*/
+static int load_records(persistent_store_t *store, size_t file_size)
+{
+    store->size = file_size;
+    if (!ensure_mapped(store, file_size)) {
+        return 0;
+    }
+
+    const char *data = store->mapping->addr;
+    if (memcmp(data, STORE_MAGIC, STORE_MAGIC_LEN) != 0 || get_u32(data + STORE_MAGIC_LEN) != STORE_VERSION) {
+        errno = EINVAL;
+        return 0;
+    }
+
+    size_t offset = STORE_HEADER_LEN;
+    while (file_size - offset >= RECORD_HEADER_LEN) {
+        const char *record = data + offset;
+        size_t key_len = get_u32(record + 4);
+        size_t value_len = get_u32(record + 8);
+
+        if (key_len > file_size - offset - RECORD_HEADER_LEN
+            || value_len > file_size - offset - RECORD_HEADER_LEN - key_len) {
+            break;
+        }
+        const char *key = record + RECORD_HEADER_LEN;
+        if (record_checksum((const unsigned char *)record + 4, key, key_len, key + key_len, value_len)
+            != get_u32(record)) {
+            break;
+        }
+        if (!index_record(store, key, key_len, offset, value_len)) {
+            return 0;
+        }
+        offset += RECORD_HEADER_LEN + key_len + value_len;
+    }
+
+    if (offset < file_size) {
+        if (ftruncate(store->fd, offset) != 0) {
+            return 0;
+        }
+        store->size = offset;
+    }
+    return 1;
+}
+
+static int write_header(int fd)
+{
+    char header[STORE_HEADER_LEN] = { 0 };
+    memcpy(header, STORE_MAGIC, STORE_MAGIC_LEN);
+    put_u32((unsigned char *)header + STORE_MAGIC_LEN, STORE_VERSION);
+    return write_all(fd, header, sizeof(header));
+}
+
+/*! \fn static int compact(persistent_store_t *store)
+    \brief Copies the live records to a new file that replaces the store file.
+    \return an int value - 1 for success; 0 for failure with `errno` set, the store is left
+    untouched in that case.
+*/
+static int compact(persistent_store_t *store)
+{
+    size_t *offsets = NULL;
+    char *tmp_path = NULL;
+    int fd = -1;
+    int err;
+    size_t i, n = 0;
+    size_t offset = STORE_HEADER_LEN;
+
+    if (!ensure_mapped(store, store->size)) {
+        return 0;
+    }
+    if (!(offsets = _malloc(sizeof(*offsets) * (store->count + 1)))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    if (!(tmp_path = path_with_suffix(store->path, ".tmp"))) {
+        goto error;
+    }
+    fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0600);
+    if (fd < 0 || !write_header(fd)) {
+        goto error;
+    }
+
+    for (i = 0; i < store->nbuckets; i++) {
+        index_entry_t *entry;
+        for (entry = store->buckets[i]; entry != NULL; entry = entry->next) {
+            if (!write_all(fd, store->mapping->addr + entry->offset, record_len(entry))) {
+                goto error;
+            }
+            offsets[n++] = offset;
+            offset += record_len(entry);
+        }
+    }
+    if (fsync(fd) != 0 || rename(tmp_path, store->path) != 0) {
+        goto error;
+    }
+
+    // the file is replaced, the index can point to the new records
+    n = 0;
+    for (i = 0; i < store->nbuckets; i++) {
+        index_entry_t *entry;
+        for (entry = store->buckets[i]; entry != NULL; entry = entry->next) {
+            entry->offset = offsets[n++];
+        }
+    }
+    close(store->fd);
+    store->fd = fd;
+    store->size = offset;
+    persistent_store_mapping_release(store->mapping);
+    store->mapping = NULL;
+
+    _free(offsets);
+    _free(tmp_path);
+    return 1;
+
+error:
+    err = errno;
+    if (fd >= 0) {
+        close(fd);
+        unlink(tmp_path);
+    }
+    _free(offsets);
+    _free(tmp_path);
+    errno = err;
+    return 0;
+}
+
+persistent_store_t *persistent_store_open(const char *path)
+{
+    persistent_store_t *store = NULL;
+    char *lock_path = NULL;
+    struct stat st;
+    int err;
+
+    if (!(store = _malloc(sizeof(*store)))) {
+        errno = ENOMEM;
+        return NULL;
+    }
+    memset(store, 0, sizeof(*store));
+    store->fd = -1;
+    store->lock_fd = -1;
+
+    store->nbuckets = INITIAL_BUCKETS;
+    if (!(store->buckets = _malloc(sizeof(*store->buckets) * store->nbuckets))) {
+        errno = ENOMEM;
+        goto error;
+    }
+    memset(store->buckets, 0, sizeof(*store->buckets) * store->nbuckets);
+
+    if (!(store->path = path_with_suffix(path, "")) || !(lock_path = path_with_suffix(path, ".lock"))) {
+        goto error;
+    }
+
+    // the lock is held as long as the lock file is open
+    store->lock_fd = open(lock_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (store->lock_fd < 0 || flock(store->lock_fd, LOCK_EX | LOCK_NB) != 0) {
+        goto error;
+    }
+
+    store->fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0600);
+    if (store->fd < 0 || fstat(store->fd, &st) != 0) {
+        goto error;
+    }
+
+    if ((size_t)st.st_size < STORE_HEADER_LEN) {
+        // new store, or one that was never fully initialized
+        if (ftruncate(store->fd, 0) != 0 || !write_header(store->fd)) {
+            goto error;
+        }
+        store->size = STORE_HEADER_LEN;
+    } else if (!load_records(store, st.st_size)) {
+        goto error;
+    }
+
+    _free(lock_path);
+    return store;
+
+error:
+    err = errno;
+    persistent_store_close(store);
+    _free(lock_path);
+    errno = err;
+    return NULL;
+}
+
+void persistent_store_close(persistent_store_t *store)
+{
+    if (store == NULL) {
+        return;
+    }
+
+    size_t i;
+    for (i = 0; store->buckets != NULL && i < store->nbuckets; i++) {
+        index_entry_t *entry = store->buckets[i];
+        while (entry != NULL) {
+            index_entry_t *next = entry->next;
+            _free(entry);
+            entry = next;
+        }
+    }
+    persistent_store_mapping_release(store->mapping);
+    if (store->fd >= 0) {
+        close(store->fd);
+    }
+    if (store->lock_fd >= 0) {
+        close(store->lock_fd);
+    }
+    _free(store->buckets);
+    _free(store->path);
+    _free(store);
+}
+
+int persistent_store_write(persistent_store_t *store, const char *key, size_t key_len, const char *value,
+                           size_t value_len)
+{
+    if (key_len > UINT32_MAX || value_len > UINT32_MAX) {
+        errno = EFBIG;
+        return 0;
+    }
+
+    unsigned char header[RECORD_HEADER_LEN];
+    put_u32(header + 4, (uint32_t)key_len);
+    put_u32(header + 8, (uint32_t)value_len);
+    put_u32(header, record_checksum(header + 4, key, key_len, value, value_len));
+
+    struct iovec iov[3] = {
+        { header, RECORD_HEADER_LEN },
+        { (void *)key, key_len },
+        { (void *)value, value_len },
+    };
+    size_t len = RECORD_HEADER_LEN + key_len + value_len;
+    ssize_t n;
+    do {
+        n = writev(store->fd, iov, 3);
+    } while (n < 0 && errno == EINTR);
+
+    size_t offset = store->size;
+    if (n != (ssize_t)len) {
+        int err = n < 0 ? errno : ENOSPC;
+        // drop the partial record
+        if (ftruncate(store->fd, offset) != 0) {
+            // the corrupted tail will be dropped on the next open
+        }
+        errno = err;
+        return 0;
+    }
+    store->size += len;
+
+    if (!index_record(store, key, key_len, offset, value_len)) {
+        int err = errno;
+        if (ftruncate(store->fd, offset) == 0) {
+            store->size = offset;
+        }
+        errno = err;
+        return 0;
+    }
+
+    if (store->size >= COMPACTION_MIN_SIZE && store->size - STORE_HEADER_LEN > store->live * 2) {
+        // the write succeeded, failing to compact only wastes disk space for now
+        compact(store);
+    }
+    return 1;
+}
+
+int persistent_store_read(persistent_store_t *store, const char *key, size_t key_len, const char **value,
+                          size_t *value_len, persistent_store_mapping_t **mapping)
+{
+    index_entry_t *entry = *find_entry(store, key, key_len, fnv1a(FNV_OFFSET_BASIS, key, key_len));
+    if (entry == NULL) {
+        return 0;
+    }
+    if (!ensure_mapped(store, entry->offset + record_len(entry))) {
+        return -1;
+    }
+
+    *value = store->mapping->addr + entry->offset + RECORD_HEADER_LEN + entry->key_len;
+    *value_len = entry->value_len;
+    __sync_fetch_and_add(&store->mapping->refs, 1);
+    *mapping = store->mapping;
+    return 1;
+}
+
+#else
+
+persistent_store_t *persistent_store_open(const char *path)
+{
+    errno = ENOSYS;
+    return NULL;
+}
+
+void persistent_store_close(persistent_store_t *store)
+{
+}
+
+int persistent_store_write(persistent_store_t *store, const char *key, size_t key_len, const char *value,
+                           size_t value_len)
+{
+    errno = ENOSYS;
+    return 0;
+}
+
+int persistent_store_read(persistent_store_t *store, const char *key, size_t key_len, const char **value,
+                          size_t *value_len, persistent_store_mapping_t **mapping)
+{
+    errno = ENOSYS;
+    return -1;
+}
+
+void persistent_store_mapping_release(persistent_store_mapping_t *mapping)
+{
+}
+
+#endif
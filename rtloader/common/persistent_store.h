@@ -0,0 +1,87 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog
+// (https://www.datadoghq.com/).
+// Copyright 2019-present Datadog, Inc.
+#ifndef DATADOG_AGENT_RTLOADER_PERSISTENT_STORE_H
+#define DATADOG_AGENT_RTLOADER_PERSISTENT_STORE_H
+
+/*! \file persistent_store.h
+    \brief RtLoader persistent key/value store header file.
+
+    The persistent store keeps the values written with `datadog_agent.write_persistent_cache`
+    in a single append-only file. Every write appends a checksummed record made of the key
+    and the value, an in-memory index maps each key to its latest record and reads are served
+    from a read-only memory mapping of the file. Once most of the file is made of overwritten
+    records, the live ones are copied to a new file that atomically replaces the old one.
+
+    Only one process can open a store at a time, this is enforced with an advisory lock on
+    a `<path>.lock` file. A truncated or corrupted tail, e.g. after a crash in the middle of
+    a write, is dropped when the store is opened. The store isn't thread safe, callers are
+    expected to serialize the calls - rtloader does it with the GIL or, in the free-threaded
+    builds, with a mutex. Memory mappings of the file are reference counted so that values
+    read before the file was remapped or compacted stay valid until they are released, which
+    is thread safe. Not available on Windows.
+*/
+/*! \fn persistent_store_t *persistent_store_open(const char *path)
+    \brief Opens, or creates, the store file at the given path and indexes its records.
+    \param path The path of the store file.
+    \return A persistent_store_t * pointer to the store, NULL in case of error with `errno`
+    set accordingly - `EWOULDBLOCK` if another process holds the store.
+*/
+/*! \fn void persistent_store_close(persistent_store_t *store)
+    \brief Closes the store and releases its resources. NULL is a no-op.
+    \param store The store to close.
+
+    Mappings acquired with `persistent_store_read` remain valid until they are released.
+*/
+/*! \fn int persistent_store_write(persistent_store_t *store, const char *key, size_t key_len, const char *value, size_t value_len)
+    \brief Stores the value for the key, replacing any previous value.
+    \param store The store to write to.
+    \param key The key, not necessarily NULL-terminated.
+    \param key_len The length of the key.
+    \param value The value, not necessarily NULL-terminated.
+    \param value_len The length of the value.
+    \return an int value - 1 for success; 0 for failure with `errno` set accordingly.
+*/
+/*! \fn int persistent_store_read(persistent_store_t *store, const char *key, size_t key_len, const char **value, size_t *value_len, persistent_store_mapping_t **mapping)
+    \brief Looks up the value of the key without copying it.
+    \param store The store to read from.
+    \param key The key, not necessarily NULL-terminated.
+    \param key_len The length of the key.
+    \param value A pointer set to the value, it is not NULL-terminated.
+    \param value_len A pointer set to the length of the value.
+    \param mapping A pointer set to the mapping the value points into.
+    \return an int value - 1 if the key was found; 0 if it wasn't; -1 for failure with
+    `errno` set accordingly.
+
+    The value points into a memory mapping of the store file and is only valid until the
+    mapping is released with `persistent_store_mapping_release`.
+*/
+/*! \fn void persistent_store_mapping_release(persistent_store_mapping_t *mapping)
+    \brief Releases a mapping acquired with `persistent_store_read`.
+    \param mapping The mapping to release.
+*/
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct persistent_store_s persistent_store_t;
+typedef struct persistent_store_mapping_s persistent_store_mapping_t;
+
+persistent_store_t *persistent_store_open(const char *path);
+void persistent_store_close(persistent_store_t *store);
+int persistent_store_write(persistent_store_t *store, const char *key, size_t key_len, const char *value,
+                           size_t value_len);
+int persistent_store_read(persistent_store_t *store, const char *key, size_t key_len, const char **value,
+                          size_t *value_len, persistent_store_mapping_t **mapping);
+void persistent_store_mapping_release(persistent_store_mapping_t *mapping);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,6 +4,7 @@
 // Copyright 2019-present Datadog, Inc.
 #include "rtloader_mem.h"
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -19,6 +20,122 @@ static rtloader_free_t rt_free = free;
 
 // these must be set by the Agent
 static cb_memory_tracker_t cb_memory_tracker = NULL;
+static cb_memory_tracker_batch_t cb_memory_tracker_batch = NULL;
+
+// When a batch callback is set allocations are recorded in per-thread buffers
+// instead of calling into the Agent on every operation. Buffers are linked
+// together so that they can all be drained by `_flush_memory_tracker`, they're
+// never freed since threads don't notify us when they exit.
+#define MEM_RECORDS_PER_THREAD 512
+
+// The buffers are aligned to a cache line so that the lock and count of a thread
+// don't share one with the buffer of another thread.
+#define MEM_RECORDS_ALIGNMENT 64
+
+typedef struct mem_records_s {
+    volatile int lock;
+    size_t count;
+    rtloader_mem_record_t records[MEM_RECORDS_PER_THREAD];
+    struct mem_records_s *next;
+} __attribute__((aligned(MEM_RECORDS_ALIGNMENT))) mem_records_t;
+
+static mem_records_t *volatile mem_records_list = NULL;
+static __thread mem_records_t *thread_mem_records = NULL;
+
+// Temporary allocations of the builtins are bump allocated from a per-thread
+// arena and released all at once by `_arena_reset` once the callback using them
+// returned. The first chunk of each thread is reused by the following calls and,
+// like the memory records, is never freed nor tracked. The chunks added when it
+// is full are tracked and freed by the reset.
+#define ARENA_CHUNK_SIZE (16 * 1024)
+#define ARENA_ALIGNMENT 16
+#define ARENA_ALIGN(sz) (((sz) + ARENA_ALIGNMENT - 1) & ~((size_t)ARENA_ALIGNMENT - 1))
+
+typedef struct arena_chunk_s {
+    struct arena_chunk_s *next;
+    size_t size;
+    size_t used;
+} arena_chunk_t;
+
+#define ARENA_HEADER_SIZE ARENA_ALIGN(sizeof(arena_chunk_t))
+
+static __thread arena_chunk_t *thread_arena = NULL;
+static __thread arena_chunk_t *thread_arena_current = NULL;
+
+static void spin_lock(volatile int *lock) {
+    while (__sync_lock_test_and_set(lock, 1)) {
+    }
+}
+
+static void spin_unlock(volatile int *lock) {
+    __sync_lock_release(lock);
+}
+
+static mem_records_t *get_thread_mem_records(void) {
+    if (thread_mem_records != NULL) {
+        return thread_mem_records;
+    }
+
+    // use the raw allocator, this must not be tracked. It doesn't take an alignment, the
+    // buffer is aligned within a larger allocation, which is fine since it is never freed.
+    char *buf = (char *)rt_malloc(sizeof(mem_records_t) + MEM_RECORDS_ALIGNMENT - 1);
+    if (buf == NULL) {
+        return NULL;
+    }
+    mem_records_t *records = (mem_records_t *)(((uintptr_t)buf + MEM_RECORDS_ALIGNMENT - 1) & ~(uintptr_t)(MEM_RECORDS_ALIGNMENT - 1));
+    memset(records, 0, sizeof(mem_records_t));
+
+    do {
+        records->next = mem_records_list;
+    } while (!__sync_bool_compare_and_swap(&mem_records_list, records->next, records));
+
+    thread_mem_records = records;
+    return records;
+}
+
+// The records are copied out under the buffer lock and the callback is called
+// once it's released, so that a slow callback doesn't block the allocations of
+// the thread nor the other flushes. Batches may thus be delivered out of order,
+// a free can be reported before the allocation it pairs with.
+static void flush_mem_records(mem_records_t *records) {
+    rtloader_mem_record_t batch[MEM_RECORDS_PER_THREAD];
+    size_t count = 0;
+
+    spin_lock(&records->lock);
+    count = records->count;
+    memcpy(batch, records->records, count * sizeof(rtloader_mem_record_t));
+    records->count = 0;
+    spin_unlock(&records->lock);
+
+    cb_memory_tracker_batch_t cb = cb_memory_tracker_batch;
+    if (count > 0 && cb) {
+        cb(batch, count);
+    }
+}
+
+// returns 0 if the operation couldn't be recorded and should be reported to
+// the synchronous callback instead.
+static int record_mem_op(void *ptr, size_t sz, rtloader_mem_ops_t op) {
+    mem_records_t *records = get_thread_mem_records();
+    if (records == NULL) {
+        return 0;
+    }
+
+    for (;;) {
+        spin_lock(&records->lock);
+        if (records->count < MEM_RECORDS_PER_THREAD) {
+            rtloader_mem_record_t *record = &records->records[records->count++];
+            record->ptr = ptr;
+            record->sz = sz;
+            record->op = op;
+            spin_unlock(&records->lock);
+            return 1;
+        }
+        spin_unlock(&records->lock);
+
+        flush_mem_records(records);
+    }
+}
 
 void _set_memory_tracker_cb(cb_memory_tracker_t cb) {
 
@@ -34,12 +151,42 @@ cb_memory_tracker_t _get_memory_tracker_cb(void) {
     return cb_memory_tracker;
 }
 
+void _set_memory_tracker_batch_cb(cb_memory_tracker_batch_t cb) {
+    // deliver what was recorded for the previous callback, if any
+    if (cb_memory_tracker_batch) {
+        _flush_memory_tracker();
+    }
+
+    // Memory barrier for a little bit of safety on sets
+    __sync_synchronize();
+    cb_memory_tracker_batch = cb;
+}
+
+void _flush_memory_tracker(void) {
+    mem_records_t *records = NULL;
+
+    for (records = mem_records_list; records != NULL; records = records->next) {
+        if (records->count > 0) {
+            flush_mem_records(records);
+        }
+    }
+}
+
+void _flush_thread_memory_tracker(void) {
+    if (thread_mem_records != NULL && thread_mem_records->count > 0) {
+        flush_mem_records(thread_mem_records);
+    }
+}
+
 void *_malloc(size_t sz) {
     void *ptr = NULL;
     ptr = rt_malloc(sz);
 
     // This is currently thread-unsafe, so be sure to set the callback before
     // running this code.
+    if (ptr && cb_memory_tracker_batch && record_mem_op(ptr, sz, DATADOG_AGENT_RTLOADER_ALLOCATION)) {
+        return ptr;
+    }
     if (ptr && cb_memory_tracker) {
         cb_memory_tracker(ptr, sz, DATADOG_AGENT_RTLOADER_ALLOCATION);
     }
@@ -52,11 +199,91 @@ void _free(void *ptr) {
 
     // This is currently thread-unsafe, so be sure to set the callback before
     // running this code.
+    if (ptr && cb_memory_tracker_batch && record_mem_op(ptr, 0, DATADOG_AGENT_RTLOADER_FREE)) {
+        return;
+    }
     if (ptr && cb_memory_tracker) {
         cb_memory_tracker(ptr, 0, DATADOG_AGENT_RTLOADER_FREE);
     }
 }
 
+static arena_chunk_t *get_thread_arena(void) {
+    if (thread_arena != NULL) {
+        return thread_arena;
+    }
+
+    // use the raw allocator, this must not be tracked
+    arena_chunk_t *chunk = (arena_chunk_t *)rt_malloc(ARENA_HEADER_SIZE + ARENA_CHUNK_SIZE);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    chunk->next = NULL;
+    chunk->size = ARENA_CHUNK_SIZE;
+    chunk->used = 0;
+
+    thread_arena = chunk;
+    thread_arena_current = chunk;
+    return chunk;
+}
+
+rtloader_arena_mark_t _arena_mark(void) {
+    rtloader_arena_mark_t mark = { NULL, 0 };
+
+    if (get_thread_arena() != NULL) {
+        mark.chunk = thread_arena_current;
+        mark.used = thread_arena_current->used;
+    }
+    return mark;
+}
+
+void *_arena_malloc(size_t sz) {
+    if (get_thread_arena() == NULL) {
+        return NULL;
+    }
+
+    arena_chunk_t *chunk = thread_arena_current;
+    sz = ARENA_ALIGN(sz);
+    if (chunk->size - chunk->used < sz) {
+        size_t size = sz > ARENA_CHUNK_SIZE ? sz : ARENA_CHUNK_SIZE;
+        arena_chunk_t *next = (arena_chunk_t *)_malloc(ARENA_HEADER_SIZE + size);
+        if (next == NULL) {
+            return NULL;
+        }
+        next->next = NULL;
+        next->size = size;
+        next->used = 0;
+
+        chunk->next = next;
+        thread_arena_current = chunk = next;
+    }
+
+    void *ptr = (char *)chunk + ARENA_HEADER_SIZE + chunk->used;
+    chunk->used += sz;
+    return ptr;
+}
+
+void _arena_reset(rtloader_arena_mark_t mark) {
+    arena_chunk_t *chunk = (arena_chunk_t *)mark.chunk;
+    if (chunk == NULL) {
+        // the arena couldn't be allocated when the mark was taken, nothing was
+        // allocated before it
+        chunk = thread_arena;
+        if (chunk == NULL) {
+            return;
+        }
+    }
+
+    arena_chunk_t *next = chunk->next;
+    while (next != NULL) {
+        arena_chunk_t *tmp = next->next;
+        _free(next);
+        next = tmp;
+    }
+    chunk->next = NULL;
+    chunk->used = mark.used;
+    thread_arena_current = chunk;
+}
+
 char *strdupe(const char *s1) {
     char * s2 = NULL;
 
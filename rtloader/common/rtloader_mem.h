@@ -46,6 +46,28 @@ void _set_memory_tracker_cb(cb_memory_tracker_t);
 */
 cb_memory_tracker_t _get_memory_tracker_cb(void);
 
+/*! \fn void _set_memory_tracker_batch_cb(cb_memory_tracker_batch_t cb)
+    \brief Sets a callback to be used by rtloader to report memory tracking stats in bulk.
+    \param object A function pointer to the callback function.
+
+    Once set, allocations and frees are recorded in per-thread buffers and reported to the
+    callback when a buffer is full or gets flushed, instead of calling the memory tracker
+    callback on every operation. The callback may be called concurrently and batches may be
+    reported out of order, a free can be reported before the matching allocation. Like
+    `_set_memory_tracker_cb` this is thread unsafe, be sure to call it early on.
+*/
+void _set_memory_tracker_batch_cb(cb_memory_tracker_batch_t);
+
+/*! \fn void _flush_memory_tracker(void)
+    \brief Reports the memory operations recorded by every thread to the batch callback.
+*/
+void _flush_memory_tracker(void);
+
+/*! \fn void _flush_thread_memory_tracker(void)
+    \brief Reports the memory operations recorded by the calling thread to the batch callback.
+*/
+void _flush_thread_memory_tracker(void);
+
 /*! \fn void *_malloc(size_t sz)
     \brief Basic malloc wrapper that will also keep memory stats if enabled.
     \param sz the number of bytes to allocate.
@@ -64,6 +86,40 @@ void *_malloc(size_t sz);
 */
 void _free(void *ptr);
 
+/*! rtloader_arena_mark_t
+    \brief A position in the arena of the calling thread, see `_arena_mark`.
+*/
+typedef struct rtloader_arena_mark_s {
+    void *chunk;
+    size_t used;
+} rtloader_arena_mark_t;
+
+/*! \fn rtloader_arena_mark_t _arena_mark(void)
+    \brief Returns the current position in the arena of the calling thread.
+
+    Everything allocated with `_arena_malloc` after the mark is released at once by passing it
+    to `_arena_reset`. Marks can be nested as long as they are reset in the reverse order.
+*/
+rtloader_arena_mark_t _arena_mark(void);
+
+/*! \fn void *_arena_malloc(size_t sz)
+    \brief Allocates short-lived memory from the arena of the calling thread.
+    \param sz the number of bytes to allocate.
+    \return a pointer aligned for any type, or NULL if the memory couldn't be allocated.
+
+    The memory is released by the `_arena_reset` call of an earlier mark and must never be
+    passed to `_free`. This is meant for the temporary buffers of the builtins, which only live
+    until the callback they are passed to returns: they don't cost a malloc/free pair nor a
+    memory tracker record, unless they outgrow the chunk kept by the thread.
+*/
+void *_arena_malloc(size_t sz);
+
+/*! \fn void _arena_reset(rtloader_arena_mark_t mark)
+    \brief Releases everything allocated from the arena of the calling thread since the mark.
+    \param mark the position returned by `_arena_mark`.
+*/
+void _arena_reset(rtloader_arena_mark_t mark);
+
 #ifdef __cplusplus
 #    ifndef __GLIBC__
 #        define __THROW
@@ -3,7 +3,9 @@
 // This product includes software developed at Datadog (https://www.datadoghq.com/).
 // Copyright 2019-present Datadog, Inc.
 #include <stdlib.h>
+#include <string.h>
 
+#include "free_threading.h"
 #include "rtloader_mem.h"
 #include "rtloader_types.h"
 #include "stringutils.h"
@@ -13,6 +15,13 @@ PyObject * yload = NULL;
 PyObject * ydump = NULL;
 PyObject * loader = NULL;
 PyObject * dumper = NULL;
+PyObject * interned_strings = NULL;
+PyObject * jloads = NULL;
+
+RTLOADER_MUTEX(yaml_mutex);
+// guards the intern table and its number of users
+RTLOADER_MUTEX(interned_strings_mutex);
+static int interned_strings_users = 0;
 
 /**
  * returns a C (NULL terminated UTF-8) string from a python string.
@@ -72,20 +81,186 @@ char *as_string(PyObject *object)
     return retval;
 }
 
-int init_stringutils(void) {
+/**
+ * returns a borrowed C (NULL terminated UTF-8) string from a python string.
+ *
+ * \param object  A Python string to be converted to C-string.
+ *
+ * \return A standard C string (NULL terminated character pointer) or NULL in
+ * case of error. The returned pointer is owned by the python object, must NOT
+ * be freed by the caller and is only valid as long as `object` is alive.
+ */
+const char *as_borrowed_utf8(PyObject *object)
+{
+    if (object == NULL) {
+        return NULL;
+    }
+
+    const char *retval = NULL;
+
+// DATADOG_AGENT_THREE implementation is the default
+#ifdef DATADOG_AGENT_TWO
+    if (!PyString_Check(object) && !PyUnicode_Check(object)) {
+        return NULL;
+    }
+
+    if (PyUnicode_Check(object)) {
+        // PyString_AsString would use the default encoding, ASCII, and fail on anything
+        // else. There is no UTF-8 buffer cached on unicode objects, the encoded string is
+        // kept alive by copying it to the arena of the calling thread.
+        PyObject *encoded = PyUnicode_AsUTF8String(object);
+        if (encoded == NULL) {
+            PyErr_Clear();
+            return NULL;
+        }
+        size_t size = PyString_GET_SIZE(encoded) + 1;
+        char *copy = (char *)_arena_malloc(size);
+        if (copy != NULL) {
+            memcpy(copy, PyString_AS_STRING(encoded), size);
+        }
+        Py_DECREF(encoded);
+        return copy;
+    }
+    retval = PyString_AsString(object);
+#else
+    if (PyBytes_Check(object)) {
+        // We already have an encoded string, we suppose it has the correct encoding (UTF-8)
+        return PyBytes_AS_STRING(object);
+    } else if (!PyUnicode_Check(object)) {
+        return NULL;
+    }
+
+    // the UTF-8 representation is cached on the unicode object (and is the object
+    // data itself for ASCII strings), no copy is involved
+    retval = PyUnicode_AsUTF8AndSize(object, NULL);
+#endif
+    if (retval == NULL) {
+        // the string could not be encoded
+        PyErr_Clear();
+    }
+
+    return retval;
+}
+
+/**
+ * returns a C (NULL terminated UTF-8) string from a python string, interning it.
+ *
+ * \param object  A Python string to be converted to C-string.
+ *
+ * \return A standard C string (NULL terminated character pointer) or NULL in
+ * case of error. The returned pointer is owned by the intern table and must
+ * NOT be freed by the caller. It remains valid until the caller calls
+ * release_interned_strings().
+ */
+char *as_interned_string(PyObject *object)
+{
+    if (object == NULL || interned_strings == NULL) {
+        return NULL;
+    }
+
+    PyObject *encoded = NULL;
+
+// DATADOG_AGENT_THREE implementation is the default
+#ifdef DATADOG_AGENT_TWO
+    if (!PyString_Check(object) && !PyUnicode_Check(object)) {
+        return NULL;
+    }
+#else
+    if (!PyBytes_Check(object) && !PyUnicode_Check(object)) {
+        return NULL;
+    }
+#endif
+
+    // borrowed reference, python strings cache their hash so this lookup doesn't
+    // allocate anything. The table is only cleared once it has no users so the
+    // reference stays valid after the lock is released.
+    RTLOADER_LOCK(interned_strings_mutex);
+    encoded = PyDict_GetItem(interned_strings, object);
+    RTLOADER_UNLOCK(interned_strings_mutex);
+    if (encoded != NULL) {
+        return PyBytes_AS_STRING(encoded);
+    }
+
+#ifdef DATADOG_AGENT_TWO
+    if (PyString_Check(object)) {
+#else
+    if (PyBytes_Check(object)) {
+#endif
+        // We already have an encoded string, we suppose it has the correct encoding (UTF-8)
+        encoded = object;
+        Py_INCREF(encoded);
+    } else {
+        encoded = PyUnicode_AsEncodedString(object, "UTF-8", "strict");
+        if (encoded == NULL) {
+            // PyUnicode_AsEncodedString might raise an error if the codec raised an
+            // exception
+            PyErr_Clear();
+            return NULL;
+        }
+    }
+
+    // another thread may have interned the string in the meantime, keep its copy
+    RTLOADER_LOCK(interned_strings_mutex);
+#ifdef DATADOG_AGENT_TWO
+    PyObject *interned = PyDict_SetItem(interned_strings, object, encoded) == 0 ? encoded : NULL;
+#else
+    PyObject *interned = PyDict_SetDefault(interned_strings, object, encoded); // borrowed
+#endif
+    RTLOADER_UNLOCK(interned_strings_mutex);
+    Py_XDECREF(encoded);
+    if (interned == NULL) {
+        PyErr_Clear();
+        return NULL;
+    }
+
+    return PyBytes_AS_STRING(interned);
+}
+
+void acquire_interned_strings(void)
+{
+    RTLOADER_LOCK(interned_strings_mutex);
+    // strings returned to previous users aren't referenced anymore, this is the right
+    // time to bound the table
+    if (interned_strings_users == 0 && interned_strings != NULL
+        && PyDict_Size(interned_strings) > MAX_INTERNED_STRINGS) {
+        PyDict_Clear(interned_strings);
+    }
+    interned_strings_users++;
+    RTLOADER_UNLOCK(interned_strings_mutex);
+}
+
+void release_interned_strings(void)
+{
+    RTLOADER_LOCK(interned_strings_mutex);
+    interned_strings_users--;
+    RTLOADER_UNLOCK(interned_strings_mutex);
+}
+
+/**
+ * imports pyyaml and caches its load and dump functions, along with the loader and
+ * dumper they are called with. Importing pyyaml is deferred to its first use since
+ * its C-extension pulls a lot of code in, which slows the startup down.
+ *
+ * \return 1 if the references are cached, 0 otherwise with the python error set.
+ */
+static int load_yaml(void) {
     PyObject *yaml = NULL;
-    int ret = EXIT_FAILURE;
+    int ret = 0;
+
+    RTLOADER_LOCK(yaml_mutex);
+    if (yload != NULL) {
+        ret = 1;
+        goto done;
+    }
 
     char module_name[] = "yaml";
     yaml = PyImport_ImportModule(module_name);
     if (yaml == NULL) {
         goto done;
     }
-
-    // get pyyaml load()
-    char load_name[] = "load";
-    yload = PyObject_GetAttrString(yaml, load_name);
-    if (yload == NULL) {
+    // the import can release the GIL, another thread may have cached the references meanwhile
+    if (yload != NULL) {
+        ret = 1;
         goto done;
     }
 
@@ -101,13 +276,6 @@ int init_stringutils(void) {
         }
     }
 
-    // get pyyaml dump()
-    char dump_name[] = "dump";
-    ydump = PyObject_GetAttrString(yaml, dump_name);
-    if (ydump == NULL) {
-        goto done;
-    }
-
     char c_dumper_name[] = "CSafeDumper";
     dumper = PyObject_GetAttrString(yaml, c_dumper_name);
     if (dumper == NULL) {
@@ -119,13 +287,63 @@ int init_stringutils(void) {
         }
     }
 
-    ret = EXIT_SUCCESS;
+    // get pyyaml dump()
+    char dump_name[] = "dump";
+    ydump = PyObject_GetAttrString(yaml, dump_name);
+    if (ydump == NULL) {
+        goto done;
+    }
+
+    // get pyyaml load(), set last as it tells the references are cached
+    char load_name[] = "load";
+    yload = PyObject_GetAttrString(yaml, load_name);
+    if (yload == NULL) {
+        goto done;
+    }
+
+    ret = 1;
 
 done:
+    if (!ret) {
+        Py_CLEAR(loader);
+        Py_CLEAR(dumper);
+        Py_CLEAR(ydump);
+    }
+    RTLOADER_UNLOCK(yaml_mutex);
     Py_XDECREF(yaml);
     return ret;
 }
 
+int init_stringutils(void) {
+    PyObject *json = NULL;
+    int ret = EXIT_FAILURE;
+
+    interned_strings = PyDict_New();
+    if (interned_strings == NULL) {
+        goto done;
+    }
+
+    // json is part of the standard library and ships with its C accelerator so,
+    // unlike pyyaml without libyaml, decoding stays fast everywhere.
+    char json_module_name[] = "json";
+    json = PyImport_ImportModule(json_module_name);
+    if (json == NULL) {
+        goto done;
+    }
+
+    char loads_name[] = "loads";
+    jloads = PyObject_GetAttrString(json, loads_name);
+    if (jloads == NULL) {
+        goto done;
+    }
+
+    ret = EXIT_SUCCESS;
+
+done:
+    Py_XDECREF(json);
+    return ret;
+}
+
 PyObject *from_yaml(const char *data) {
     PyObject *args = NULL;
     PyObject *kwargs = NULL;
@@ -134,7 +352,7 @@ PyObject *from_yaml(const char *data) {
     if (!data) {
         goto done;
     }
-    if (yload == NULL) {
+    if (!load_yaml()) {
         goto done;
     }
 
@@ -154,12 +372,29 @@ done:
     return retval;
 }
 
+PyObject *from_json(const char *data) {
+    if (!data) {
+        return NULL;
+    }
+    if (jloads == NULL) {
+        return NULL;
+    }
+
+    return PyObject_CallFunction(jloads, "s", data);
+}
+
 char *as_yaml(PyObject *object) {
     char *retval = NULL;
     PyObject *dumped = NULL;
+    PyObject *args = NULL;
+    PyObject *kwargs = NULL;
 
-    PyObject *args = PyTuple_New(0);
-    PyObject *kwargs = Py_BuildValue("{s:O, s:O}", "data", object, "Dumper", dumper);
+    if (!load_yaml()) {
+        goto done;
+    }
+
+    args = PyTuple_New(0);
+    kwargs = Py_BuildValue("{s:O, s:O}", "data", object, "Dumper", dumper);
 
     dumped = PyObject_Call(ydump, args, kwargs);
     if (dumped == NULL) {
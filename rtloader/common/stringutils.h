@@ -15,18 +15,19 @@
     Please make sure to properly initialize stringutils before using.
 */
 /*! \fn int init_stringutils(void)
-    \brief Initializes stringutils; grabbing and caching the python relevant pyyaml objects.
+    \brief Initializes stringutils; creating the intern table and caching `json.loads`.
     \return int The success of the operation `EXIT_SUCCESS` (0) or `EXIT_FAILURE` (1).
-    \sa as_yaml, from_yaml
-
-    The function must be called before using the yaml helper functions in the module.
-    Typically this is expected to be done during initialization. The routine grabs the
-    pyyaml load and dump method references, and attempts to grab references to the pyyaml
-    C-extension CSafeLoader and CSafeDumper, these are more performant, but more importantly
-    do not incur in a 30Mb unnecessary RSS excess. If the C-extensions are not available
-    it falls back to its python variants: SafeLoader and SafeDumper. They're all cached
-    and so `as_yaml`, and `from_yaml1` will not need to grab new references and will be able
-    to call them directly.
+    \sa as_yaml, from_yaml, from_json
+
+    The function must be called before using the helper functions in the module.
+    Typically this is expected to be done during initialization. Importing pyyaml is left to
+    the first call to `as_yaml` or `from_yaml` so that it doesn't slow the startup down: it
+    grabs the pyyaml load and dump method references, and attempts to grab references to the
+    pyyaml C-extension CSafeLoader and CSafeDumper, these are more performant, but more
+    importantly do not incur in a 30Mb unnecessary RSS excess. If the C-extensions are not
+    available it falls back to its python variants: SafeLoader and SafeDumper. They're all
+    cached and so the following calls will not need to grab new references and will be able
+    to call them directly. The `json.loads` reference used by `from_json` is cached here.
 */
 /*! \fn char *as_string(PyObject * object)
     \brief Returns a Python object representation for the supplied YAML C-string.
@@ -36,15 +37,67 @@
     The returned C-string is allocated by this function and should subsequently be freed by
     the caller. This function should not set errors on the python interpreter.
 */
+/*! \fn const char *as_borrowed_utf8(PyObject * object)
+    \brief Returns the UTF-8 C-string representation of the supplied python string without
+    copying it.
+    \param object The python string we wish to get the C-string representation of.
+    \return const char * representation of the supplied string. In case of error NULL is returned.
+    \sa as_string
+
+    The returned C-string is owned by the python object and must not be freed. It is only
+    valid while the object is alive, so this should only be used for values that are read
+    synchronously - e.g. by a callback - while the GIL is held. Use `as_string` when the
+    string needs to outlive the object. On Python 2, unicode objects are encoded to a copy
+    allocated with `_arena_malloc`, which is valid until the `_arena_reset` of the caller.
+    This function should not set errors on the python interpreter.
+*/
+/*! \fn char *as_interned_string(PyObject * object)
+    \brief Returns the interned C-string representation of the supplied python string.
+    \param object The python string we wish to get the C-string representation of.
+    \return char * representation of the supplied string. In case of error NULL is returned.
+    \sa acquire_interned_strings
+
+    The returned C-string is owned by the intern table shared by all the callers and must
+    not be freed, it is valid until the caller calls `release_interned_strings`. Strings
+    seen for the first time are encoded and stored in the table, subsequent lookups of the
+    same string do not allocate any memory. This function should not set errors on the
+    python interpreter, and must be called with the GIL held, if the build has one.
+*/
+/*! \fn void acquire_interned_strings(void)
+    \brief Registers the caller as a user of the intern table, to be called before
+    `as_interned_string`.
+
+    The table is bounded here: every interned string is dropped once it grew over
+    MAX_INTERNED_STRINGS entries, unless other threads are still using it.
+*/
+/*! \fn void release_interned_strings(void)
+    \brief Unregisters a user of the intern table, invalidating the C-strings it got from
+    `as_interned_string`.
+*/
+/*! \def MAX_INTERNED_STRINGS
+    \brief Maximum number of entries in the intern table before it gets reset.
+*/
 /*! \fn PyObject *from_yaml(const char * object)
     \brief Returns a Python object representation for the supplied YAML C-string.
     \param object The YAML C-string representation of the object we wish to deserialize.
     \return PyObject * pointer to the python object representation of the supplied yaml C
-    string. In case of error, NULL will be returned.
+    string. In case of error, NULL will be returned, if pyyaml couldn't be imported the
+    python error is left set.
 
     The returned Python object is a new reference and should subsequently be DECREF'd when
     no longer used, wanted by the caller.
 */
+/*! \fn PyObject *from_json(const char * object)
+    \brief Returns a Python object representation for the supplied JSON C-string.
+    \param object The JSON C-string representation of the object we wish to deserialize.
+    \return PyObject * pointer to the python object representation of the supplied JSON C
+    string. In case of error, NULL will be returned and the python error is left set.
+
+    Decoding goes through the `json.loads` reference cached by `init_stringutils`. Note
+    that on Python2 strings are decoded as `unicode` objects, callers needing `str` should
+    stick to `from_yaml`. The returned Python object is a new reference and should
+    subsequently be DECREF'd when no longer used, wanted by the caller.
+*/
 /*! \fn char *as_yaml(PyObject * object)
     \brief Returns a C string YAML representation for the supplied Python object.
     \param object The python object whose YAML representation we want.
@@ -70,9 +123,16 @@ extern "C" {
 
 int init_stringutils(void);
 char *as_string(PyObject *);
+const char *as_borrowed_utf8(PyObject *);
+char *as_interned_string(PyObject *);
+void acquire_interned_strings(void);
+void release_interned_strings(void);
 PyObject *from_yaml(const char *);
+PyObject *from_json(const char *);
 char *as_yaml(PyObject *);
 
+#define MAX_INTERNED_STRINGS 10000
+
 #ifdef DATADOG_AGENT_THREE
 #    define PyStringFromCString(x) PyUnicode_FromString(x)
 #elif defined(DATADOG_AGENT_TWO)
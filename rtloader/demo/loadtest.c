@@ -0,0 +1,347 @@
+// Unless explicitly stated otherwise all files in this repository are licensed
+// under the Apache License Version 2.0.
+// This product includes software developed at Datadog (https://www.datadoghq.com/).
+// Copyright 2019-present Datadog, Inc.
+
+// Load test of the python checks: runs thousands of instances of the synthetic check
+// defined in demo/loadtest_check.py from several threads, the way the collector workers
+// of the agent do, and reports the throughput of the builtins, the time spent waiting for
+// the GIL and the memory usage of the process over time.
+
+// These headers can be found in rtloader/include and rtloader/common directories
+#include "datadog_agent_rtloader.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+typedef struct {
+    int instances;
+    int workers;
+    int duration;
+    int interval;
+    int metrics;
+    int tags;
+    int tag_cardinality;
+    int events;
+    int service_checks;
+} options_t;
+
+typedef struct {
+    int id;
+    int first;
+    int count;
+    // number of runs, failed runs and time spent waiting for the GIL in nanoseconds
+    atomic_ullong runs;
+    atomic_ullong failures;
+    atomic_ullong gil_wait_ns;
+} worker_t;
+
+static rtloader_t *rtloader;
+static rtloader_pyobject_t **checks;
+static atomic_int stopping;
+
+static atomic_ullong metrics_count;
+static atomic_ullong events_count;
+static atomic_ullong service_checks_count;
+
+static unsigned long long now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// rss_kb returns the resident set size of the process, falling back to its peak when
+// /proc isn't available
+static long rss_kb(void)
+{
+    long pages = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+    if (f != NULL) {
+        int ok = fscanf(f, "%*s %ld", &pages) == 1;
+        fclose(f);
+        if (ok) {
+            return pages * (sysconf(_SC_PAGESIZE) / 1024);
+        }
+    }
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+}
+
+static void submitMetric(char *id, metric_type_t mt, char *name, double val, char **tags, char *hostname,
+                         bool flush_first_val)
+{
+    atomic_fetch_add(&metrics_count, 1);
+}
+
+static void submitMetricBatch(char *id, metric_batch_t *batch)
+{
+    atomic_fetch_add(&metrics_count, batch->count);
+}
+
+static void submitEvent(char *id, event_t *event)
+{
+    atomic_fetch_add(&events_count, 1);
+}
+
+static void submitServiceCheck(char *id, char *name, int status, char **tags, char *hostname, char *message)
+{
+    atomic_fetch_add(&service_checks_count, 1);
+}
+
+static void *run_worker(void *arg)
+{
+    worker_t *worker = arg;
+    int i = 0;
+
+    while (!atomic_load(&stopping) && worker->count > 0) {
+        // like a collector worker, hold the GIL for the duration of a single check run
+        unsigned long long start = now_ns();
+        rtloader_gilstate_t state = ensure_gil(rtloader);
+        atomic_fetch_add(&worker->gil_wait_ns, now_ns() - start);
+
+        char *result = run_check(rtloader, checks[worker->first + i]);
+        if (result == NULL || result[0] != '\0') {
+            atomic_fetch_add(&worker->failures, 1);
+            if (atomic_load(&worker->failures) == 1) {
+                fprintf(stderr, "worker %d: check run failed: %s\n", worker->id,
+                        result != NULL ? result : get_error(rtloader));
+            }
+        }
+        if (result != NULL) {
+            rtloader_free(rtloader, result);
+        }
+
+        release_gil(rtloader, state);
+        atomic_fetch_add(&worker->runs, 1);
+        i = (i + 1) % worker->count;
+    }
+    return NULL;
+}
+
+static int load_checks(const options_t *opts)
+{
+    rtloader_pyobject_t *py_module = NULL;
+    rtloader_pyobject_t *py_class = NULL;
+    char instance[256];
+    char check_id[64];
+
+    rtloader_gilstate_t state = ensure_gil(rtloader);
+    run_simple_string(rtloader, "import sys; sys.path.insert(0, './demo')");
+
+    if (!get_class(rtloader, "loadtest_check", &py_module, &py_class)) {
+        fprintf(stderr, "error getting the loadtest check class: %s\n", get_error(rtloader));
+        release_gil(rtloader, state);
+        return 0;
+    }
+
+    checks = calloc(opts->instances, sizeof(*checks));
+    if (checks == NULL) {
+        fprintf(stderr, "unable to allocate the check instances\n");
+        release_gil(rtloader, state);
+        return 0;
+    }
+
+    snprintf(instance, sizeof(instance),
+             "{metrics: %d, tags: %d, tag_cardinality: %d, events: %d, service_checks: %d}", opts->metrics,
+             opts->tags, opts->tag_cardinality, opts->events, opts->service_checks);
+    int i;
+    for (i = 0; i < opts->instances; i++) {
+        snprintf(check_id, sizeof(check_id), "loadtest:%d", i);
+        if (!get_check(rtloader, py_class, "", instance, check_id, "loadtest", &checks[i])) {
+            fprintf(stderr, "error loading check instance %d: %s\n", i, get_error(rtloader));
+            release_gil(rtloader, state);
+            return 0;
+        }
+    }
+
+    release_gil(rtloader, state);
+    return 1;
+}
+
+static void report(const char *label, double elapsed, double period, worker_t *workers, int nworkers,
+                   unsigned long long *last)
+{
+    unsigned long long runs = 0, failures = 0, gil_wait_ns = 0;
+    int i;
+    for (i = 0; i < nworkers; i++) {
+        runs += atomic_load(&workers[i].runs);
+        failures += atomic_load(&workers[i].failures);
+        gil_wait_ns += atomic_load(&workers[i].gil_wait_ns);
+    }
+    unsigned long long current[] = { runs, atomic_load(&metrics_count), atomic_load(&events_count),
+                                     atomic_load(&service_checks_count), gil_wait_ns };
+    unsigned long long delta_runs = current[0] - last[0];
+
+    printf("%-5s %6.1fs runs/s=%-9.0f metrics/s=%-11.0f events/s=%-9.0f service_checks/s=%-9.0f "
+           "gil_wait/run=%.3fms failures=%llu rss=%ldKB\n",
+           label, elapsed, delta_runs / period, (current[1] - last[1]) / period, (current[2] - last[2]) / period,
+           (current[3] - last[3]) / period, delta_runs ? (current[4] - last[4]) / 1e6 / delta_runs : 0.0, failures,
+           rss_kb());
+    fflush(stdout);
+    memcpy(last, current, sizeof(current));
+}
+
+static void usage(void)
+{
+    printf("Please run: loadtest [options] <2|3> [path_to_python_home]. For example:\n\n");
+    printf("loadtest -n 5000 -w 4 -d 60 3 $VIRTUAL_ENV\n\n");
+    printf("Options:\n");
+    printf("  -n <count>  number of check instances (default: 1000)\n");
+    printf("  -w <count>  number of worker threads running the checks (default: 4)\n");
+    printf("  -d <secs>   duration of the test (default: 30)\n");
+    printf("  -i <secs>   interval between reports (default: 1)\n");
+    printf("  -m <count>  metrics submitted by each run (default: 10)\n");
+    printf("  -t <count>  tags of each submission (default: 5)\n");
+    printf("  -c <count>  distinct values each tag takes (default: 10)\n");
+    printf("  -e <count>  events submitted by each run (default: 0)\n");
+    printf("  -s <count>  service checks submitted by each run (default: 1)\n");
+}
+
+int main(int argc, char *argv[])
+{
+    options_t opts = { 1000, 4, 30, 1, 10, 5, 10, 0, 1 };
+    int opt;
+    while ((opt = getopt(argc, argv, "n:w:d:i:m:t:c:e:s:h")) != -1) {
+        switch (opt) {
+        case 'n':
+            opts.instances = atoi(optarg);
+            break;
+        case 'w':
+            opts.workers = atoi(optarg);
+            break;
+        case 'd':
+            opts.duration = atoi(optarg);
+            break;
+        case 'i':
+            opts.interval = atoi(optarg);
+            break;
+        case 'm':
+            opts.metrics = atoi(optarg);
+            break;
+        case 't':
+            opts.tags = atoi(optarg);
+            break;
+        case 'c':
+            opts.tag_cardinality = atoi(optarg);
+            break;
+        case 'e':
+            opts.events = atoi(optarg);
+            break;
+        case 's':
+            opts.service_checks = atoi(optarg);
+            break;
+        default:
+            usage();
+            return 1;
+        }
+    }
+    if (optind >= argc || opts.instances <= 0 || opts.workers <= 0 || opts.duration <= 0 || opts.interval <= 0) {
+        usage();
+        return 1;
+    }
+
+    // Python home
+    char *python_home = NULL;
+    if (optind + 1 < argc) {
+        python_home = argv[optind + 1];
+    }
+
+    char *init_error = NULL;
+    if (strcmp(argv[optind], "2") == 0) {
+        rtloader = make2(python_home, "", &init_error);
+    } else if (strcmp(argv[optind], "3") == 0) {
+        rtloader = make3(python_home, "", &init_error);
+    } else {
+        printf("Unrecognized version: %s\n", argv[optind]);
+        return 2;
+    }
+    if (!rtloader) {
+        printf("Unable to init Python%s: %s\n", argv[optind], init_error);
+        return 1;
+    }
+
+    set_cgo_free_cb(rtloader, free);
+    set_submit_metric_cb(rtloader, submitMetric);
+    set_submit_metric_batch_cb(rtloader, submitMetricBatch);
+    set_submit_event_cb(rtloader, submitEvent);
+    set_submit_service_check_cb(rtloader, submitServiceCheck);
+
+    if (!init(rtloader)) {
+        printf("Error initializing rtloader: %s\n", get_error(rtloader));
+        return 1;
+    }
+
+    long rss_before = rss_kb();
+    unsigned long long start = now_ns();
+    if (!load_checks(&opts)) {
+        return 1;
+    }
+    printf("Loaded %d check instances in %.1fs, rss grew by %ldKB\n", opts.instances, (now_ns() - start) / 1e9,
+           rss_kb() - rss_before);
+
+    // split the instances between the workers like the collector spreads checks across its runners
+    if (opts.workers > opts.instances) {
+        opts.workers = opts.instances;
+    }
+    worker_t *workers = calloc(opts.workers, sizeof(*workers));
+    pthread_t *threads = calloc(opts.workers, sizeof(*threads));
+    if (workers == NULL || threads == NULL) {
+        fprintf(stderr, "unable to allocate the workers\n");
+        return 1;
+    }
+    int i;
+    for (i = 0; i < opts.workers; i++) {
+        workers[i].id = i;
+        workers[i].first = i * opts.instances / opts.workers;
+        workers[i].count = (i + 1) * opts.instances / opts.workers - workers[i].first;
+    }
+
+    start = now_ns();
+    for (i = 0; i < opts.workers; i++) {
+        if (pthread_create(&threads[i], NULL, run_worker, &workers[i]) != 0) {
+            fprintf(stderr, "unable to start worker %d\n", i);
+            return 1;
+        }
+    }
+
+    unsigned long long last[5] = { 0 };
+    int elapsed;
+    for (elapsed = opts.interval; elapsed <= opts.duration; elapsed += opts.interval) {
+        sleep(opts.interval);
+        report("", (now_ns() - start) / 1e9, opts.interval, workers, opts.workers, last);
+    }
+
+    atomic_store(&stopping, 1);
+    for (i = 0; i < opts.workers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    double total = (now_ns() - start) / 1e9;
+    memset(last, 0, sizeof(last));
+    report("total", total, total, workers, opts.workers, last);
+
+    rtloader_gilstate_t state = ensure_gil(rtloader);
+    for (i = 0; i < opts.instances; i++) {
+        rtloader_decref(rtloader, checks[i]);
+    }
+    release_gil(rtloader, state);
+    free(checks);
+    free(workers);
+    free(threads);
+
+    destroy(rtloader);
+    return 0;
+}
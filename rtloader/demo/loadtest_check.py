@@ -0,0 +1,49 @@
+# Unless explicitly stated otherwise all files in this repository are licensed
+# under the Apache License Version 2.0.
+# This product includes software developed at Datadog (https://www.datadoghq.com/).
+# Copyright 2019-present Datadog, Inc.
+from datadog_checks.base import AgentCheck
+
+
+class LoadTestCheck(AgentCheck):
+    """Synthetic check submitting a configurable amount of data on every run.
+
+    Instance options:
+        metrics: number of gauges submitted per run
+        tags: number of tags of every submission
+        tag_cardinality: number of distinct values each tag takes across the runs
+        events: number of events submitted per run
+        service_checks: number of service checks submitted per run
+    """
+
+    def __init__(self, name, init_config, instances):
+        super(LoadTestCheck, self).__init__(name, init_config, instances)
+        self.runs = 0
+
+    def check(self, instance):
+        metrics = int(instance.get('metrics', 10))
+        tags = int(instance.get('tags', 5))
+        cardinality = max(int(instance.get('tag_cardinality', 10)), 1)
+        events = int(instance.get('events', 0))
+        service_checks = int(instance.get('service_checks', 1))
+
+        for i in range(metrics):
+            value = (self.runs + i) % cardinality
+            metric_tags = ['tag{}:value{}'.format(j, value) for j in range(tags)]
+            self.gauge('loadtest.metric{}'.format(i), float(i), tags=metric_tags)
+
+        for i in range(events):
+            self.event(
+                {
+                    'timestamp': 0,
+                    'event_type': 'loadtest',
+                    'msg_title': 'loadtest event {}'.format(i),
+                    'msg_text': 'run {}'.format(self.runs),
+                    'tags': ['tag{}:value{}'.format(j, self.runs % cardinality) for j in range(tags)],
+                }
+            )
+
+        for i in range(service_checks):
+            self.service_check('loadtest.can_run{}'.format(i), AgentCheck.OK)
+
+        self.runs += 1
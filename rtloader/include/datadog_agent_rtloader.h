@@ -126,6 +126,17 @@ DATADOG_AGENT_RTLOADER_API void release_gil(rtloader_t *, rtloader_gilstate_t);
 DATADOG_AGENT_RTLOADER_API int get_class(rtloader_t *rtloader, const char *name, rtloader_pyobject_t **py_module,
                                          rtloader_pyobject_t **py_class);
 
+/*! \fn void clear_class_cache(rtloader_t *rtloader, const char *name)
+    \brief Drops the classes cached by `get_class`.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param name A constant C-string with the name of the module to drop, NULL to drop all.
+
+    `get_class` caches the class found in each module and reuses it for as long as the
+    module object in `sys.modules` stays the same. Call this to force the next `get_class`
+    call to import the module and look the class up again. The GIL must be held.
+*/
+DATADOG_AGENT_RTLOADER_API void clear_class_cache(rtloader_t *rtloader, const char *name);
+
 /*! \fn int get_attr_string(rtloader_t *rtloader, rtloader_pyobject_t *py_class, const char *attr_name, char **value)
     \brief Attempts to get a string attribute from the supplied python class, by name.
     \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
@@ -197,6 +208,21 @@ DATADOG_AGENT_RTLOADER_API char *run_check(rtloader_t *, rtloader_pyobject_t *ch
 */
 DATADOG_AGENT_RTLOADER_API void cancel_check(rtloader_t *, rtloader_pyobject_t *check);
 
+/*! \fn int interrupt_check(rtloader_t *, rtloader_pyobject_t *check)
+    \brief Interrupts a check instance that is currently running by raising a `TimeoutError`
+    in the thread running it.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param check A rtloader_pyobject_t * pointer to the check instance we wish to interrupt.
+    \return 1 if the check was running and got interrupted, 0 otherwise.
+    \sa rtloader_pyobject_t, rtloader_t
+
+    The interruption is cooperative: the exception is raised the next time the interpreter
+    runs python code in that thread, a check blocked in a C extension is only interrupted
+    once it returns to python. Must be called with the GIL held. Only available with the
+    Python 3 backend.
+*/
+DATADOG_AGENT_RTLOADER_API int interrupt_check(rtloader_t *, rtloader_pyobject_t *check);
+
 /*! \fn char **get_checks_warnings(rtloader_t *, rtloader_pyobject_t *check)
     \brief Get all warnings, if any, for a check instance.
     \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
@@ -356,6 +382,20 @@ DATADOG_AGENT_RTLOADER_API int handle_crashes(const int, char **error);
 */
 DATADOG_AGENT_RTLOADER_API char *get_integration_list(rtloader_t *);
 
+/*! \fn int preload_modules(rtloader_t *, const char **modules)
+    \brief Imports python modules ahead of their first use.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param modules A NULL-terminated array of C-strings with the names of the modules to import.
+    \return The number of modules that couldn't be imported.
+    \sa rtloader_t
+
+    Meant to be called right after `init` so that import-heavy integrations are warm, and
+    their bytecode compiled, before their checks are first scheduled. Every module is
+    attempted, on failure the errors of all the failed imports are reported together and
+    can be fetched with `get_error`. The GIL must be held.
+*/
+DATADOG_AGENT_RTLOADER_API int preload_modules(rtloader_t *, const char **modules);
+
 /*! \fn char *get_interpreter_memory_usage(rtloader_t *)
     \brief Routine to get python interpreter memory usage (pympler).
     \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
@@ -376,6 +416,17 @@ DATADOG_AGENT_RTLOADER_API char *get_interpreter_memory_usage(rtloader_t *);
 */
 DATADOG_AGENT_RTLOADER_API void set_submit_metric_cb(rtloader_t *, cb_submit_metric_t);
 
+/*! \fn void set_submit_metric_batch_cb(rtloader_t *, cb_submit_metric_batch_t)
+    \brief Sets the submit metric batch callback to be used by rtloader for batched metric
+    submission.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param cb A function pointer with cb_submit_metric_batch_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
+DATADOG_AGENT_RTLOADER_API void set_submit_metric_batch_cb(rtloader_t *, cb_submit_metric_batch_t);
+
 /*! \fn void set_submit_service_check_cb(rtloader_t *, cb_submit_service_check_t)
     \brief Sets the submit service_check callback to be used by rtloader for service_check
     submission.
@@ -404,6 +455,17 @@ DATADOG_AGENT_RTLOADER_API void set_submit_event_cb(rtloader_t *, cb_submit_even
 */
 DATADOG_AGENT_RTLOADER_API void set_submit_histogram_bucket_cb(rtloader_t *, cb_submit_histogram_bucket_t);
 
+/*! \fn void set_submit_histogram_buckets_cb(rtloader_t *, cb_submit_histogram_buckets_t)
+    \brief Sets the submit histogram buckets callback to be used by rtloader for the
+    submission of all the buckets of a histogram at once.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param cb A function pointer with cb_submit_histogram_buckets_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
+DATADOG_AGENT_RTLOADER_API void set_submit_histogram_buckets_cb(rtloader_t *, cb_submit_histogram_buckets_t);
+
 /*! \fn void set_submit_event_platform_event_cb(rtloader_t *, cb_submit_event_platform_event_t)
     \brief Sets the submit event callback to be used by rtloader for event-platform event.
     \param cb A function pointer with cb_submit_event_platform_event_t prototype to the callback
@@ -413,6 +475,18 @@ DATADOG_AGENT_RTLOADER_API void set_submit_histogram_bucket_cb(rtloader_t *, cb_
 */
 DATADOG_AGENT_RTLOADER_API void set_submit_event_platform_event_cb(rtloader_t *, cb_submit_event_platform_event_t);
 
+/*! \fn void set_submit_event_platform_events_cb(rtloader_t *, cb_submit_event_platform_events_t)
+    \brief Sets the submit event callback to be used by rtloader for batched event-platform
+    events.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param cb A function pointer with cb_submit_event_platform_events_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO. The
+    raw events point into the python objects and are only valid for the duration of the call.
+*/
+DATADOG_AGENT_RTLOADER_API void set_submit_event_platform_events_cb(rtloader_t *, cb_submit_event_platform_events_t);
+
 // DATADOG_AGENT API
 /*! \fn void set_get_version_cb(rtloader_t *, cb_get_version_t)
     \brief Sets a callback to be used by rtloader to collect the agent version.
@@ -434,6 +508,17 @@ DATADOG_AGENT_RTLOADER_API void set_get_version_cb(rtloader_t *, cb_get_version_
 */
 DATADOG_AGENT_RTLOADER_API void set_get_config_cb(rtloader_t *, cb_get_config_t);
 
+/*! \fn void set_config_generation(rtloader_t *, unsigned long long)
+    \brief Sets the current generation of the agent configuration.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param generation The configuration generation, 0 disables caching.
+
+    Once a non-zero generation is set `datadog_agent.get_config` caches the values returned
+    by the `cb_get_config_t` callback, they are dropped whenever a different generation is
+    set. The caller must hold the GIL.
+*/
+DATADOG_AGENT_RTLOADER_API void set_config_generation(rtloader_t *, unsigned long long);
+
 /*! \fn void set_headers_cb(rtloader_t *, cb_headers_t)
     \brief Sets a callback to be used by rtloader to collect the typical HTTP headers for
     agent requests.
@@ -489,6 +574,17 @@ DATADOG_AGENT_RTLOADER_API void set_tracemalloc_enabled_cb(rtloader_t *, cb_trac
 */
 DATADOG_AGENT_RTLOADER_API void set_log_cb(rtloader_t *, cb_log_t);
 
+/*! \fn void set_log_level(rtloader_t *, int)
+    \brief Sets the effective log level of the agent.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param log_level The lowest log_level_t forwarded to the `cb_log_t` callback, 0 forwards
+    all the messages.
+
+    Messages logged below this level by the checks are dropped by rtloader without calling
+    back into the agent. The level is also returned by `datadog_agent.get_log_level`.
+*/
+DATADOG_AGENT_RTLOADER_API void set_log_level(rtloader_t *, int);
+
 /*! \fn void set_set_check_metadata_cb(rtloader_t *, cb_set_check_metadata_t)
     \brief Sets a callback to be used by rtloader to allow setting metadata for a given
     check instance.
@@ -511,6 +607,18 @@ DATADOG_AGENT_RTLOADER_API void set_set_check_metadata_cb(rtloader_t *, cb_set_c
 */
 DATADOG_AGENT_RTLOADER_API void set_set_external_tags_cb(rtloader_t *, cb_set_external_tags_t);
 
+/*! \fn void set_set_external_tags_batch_cb(rtloader_t *, cb_set_external_tags_batch_t)
+    \brief Sets a callback to be used by rtloader to set the external tags of all the hostnames
+    passed to `set_external_tags` at once.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param object A function pointer with cb_set_external_tags_batch_t prototype to the callback
+    function.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO. When set,
+    it is used instead of the one set with `set_set_external_tags_cb`.
+*/
+DATADOG_AGENT_RTLOADER_API void set_set_external_tags_batch_cb(rtloader_t *, cb_set_external_tags_batch_t);
+
 // _UTIL API
 /*! \fn void set_get_subprocess_output_cb(rtloader_t *rtloader, cb_get_subprocess_output_t)
     \brief Sets a callback to be used by rtloader to run subprocess commands and collect their
@@ -523,6 +631,24 @@ DATADOG_AGENT_RTLOADER_API void set_set_external_tags_cb(rtloader_t *, cb_set_ex
 */
 DATADOG_AGENT_RTLOADER_API void set_get_subprocess_output_cb(rtloader_t *rtloader, cb_get_subprocess_output_t cb);
 
+/*! \fn void set_subprocess_output_stream_cbs(rtloader_t *rtloader, cb_start_subprocess_t, cb_read_subprocess_output_t)
+    \brief Sets the callbacks to be used by rtloader to run subprocess commands and stream
+    their output.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param start A function pointer with cb_start_subprocess_t prototype to the callback
+    function starting a command and returning a handle to it.
+    \param read A function pointer with cb_read_subprocess_output_t prototype to the callback
+    function returning the next chunk of the command stdout.
+
+    The read callback returns a NULL chunk once the output is exhausted, along with the
+    command stderr and exit code, the handle isn't valid anymore then. Reading with a non-zero
+    `cancel` kills the command and releases the handle. Chunks, stderr and exception strings
+    are freed by rtloader with the cgo_free helper. The callbacks are called without the GIL.
+    They're expected to be provided by the rtloader caller - in go-context: CGO.
+*/
+DATADOG_AGENT_RTLOADER_API void set_subprocess_output_stream_cbs(rtloader_t *rtloader, cb_start_subprocess_t start,
+                                                                 cb_read_subprocess_output_t read);
+
 // CGO API
 /*! \fn void set_cgo_free_cb(rtloader_t *rtloader, cb_cgo_free_t cb)
     \brief Sets a callback to be used by rtloader to free memory allocated by the
@@ -537,6 +663,30 @@ DATADOG_AGENT_RTLOADER_API void set_get_subprocess_output_cb(rtloader_t *rtloade
 */
 DATADOG_AGENT_RTLOADER_API void set_cgo_free_cb(rtloader_t *, cb_cgo_free_t);
 
+/*! \fn void set_memory_tracker_batch_cb(rtloader_t *rtloader, cb_memory_tracker_batch_t cb)
+    \brief Sets a callback to be used by rtloader to report memory tracking stats in bulk.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param object A function pointer to the callback function.
+
+    Once set, it replaces the callback set with `set_memory_tracker_cb`: memory operations
+    are recorded in per-thread buffers and reported when a buffer fills up, at the end of
+    each `run_check` and on `flush_memory_tracker` calls. The callback must not allocate
+    memory through rtloader. It may be called concurrently, batches aren't ordered between
+    each other, a free can thus be reported before the matching allocation.
+
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
+DATADOG_AGENT_RTLOADER_API void set_memory_tracker_batch_cb(rtloader_t *, cb_memory_tracker_batch_t);
+
+/*! \fn void flush_memory_tracker(rtloader_t *rtloader)
+    \brief Reports the memory operations recorded by every thread to the batch callback.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+
+    Meant to be called periodically so that operations recorded by threads not running
+    checks are eventually reported. The GIL doesn't need to be held.
+*/
+DATADOG_AGENT_RTLOADER_API void flush_memory_tracker(rtloader_t *);
+
 // TAGGER API
 /*! \fn void set_tags_cb(rtloader_t *, cb_tags_t)
     \brief Sets a callback to be used by rtloader for setting the relevant tags.
@@ -552,6 +702,17 @@ DATADOG_AGENT_RTLOADER_API void set_cgo_free_cb(rtloader_t *, cb_cgo_free_t);
 */
 DATADOG_AGENT_RTLOADER_API void set_tags_cb(rtloader_t *, cb_tags_t);
 
+/*! \fn void set_tagger_generation(rtloader_t *, unsigned long long)
+    \brief Sets the current generation of the agent tagger store.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param generation The tagger generation, 0 disables caching.
+
+    Once a non-zero generation is set `tagger.tag` and `tagger.get_tags` cache the tags
+    returned by the `cb_tags_t` callback per entity and cardinality, they are dropped
+    whenever a different generation is set. The caller must hold the GIL.
+*/
+DATADOG_AGENT_RTLOADER_API void set_tagger_generation(rtloader_t *, unsigned long long);
+
 // KUBEUTIL API
 /*! \fn void set_get_connection_info_cb(rtloader_t *, cb_get_connection_info_t)
     \brief Sets a callback to be used by rtloader for kubernetes connection information
@@ -576,6 +737,20 @@ DATADOG_AGENT_RTLOADER_API void set_get_connection_info_cb(rtloader_t *, cb_get_
 */
 DATADOG_AGENT_RTLOADER_API void set_is_excluded_cb(rtloader_t *, cb_is_excluded_t);
 
+/*! \fn void set_is_excluded_many_cb(rtloader_t *, cb_is_excluded_many_t)
+    \brief Sets a callback to be used by rtloader to determine which containers of a set
+    are excluded from metric collection.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param object A function pointer with cb_is_excluded_many_t function prototype to the
+    callback function.
+
+    The callback receives the container names, image names and namespaces (NULL when not
+    provided) as arrays of `count` C-strings, and sets the non-zero result of each excluded
+    container in the `count` ints results array. None of the arrays are owned by the callback.
+    The callback is expected to be provided by the rtloader caller - in go-context: CGO.
+*/
+DATADOG_AGENT_RTLOADER_API void set_is_excluded_many_cb(rtloader_t *, cb_is_excluded_many_t);
+
 /*! \fn void set_write_persistent_cache_cb(rtloader_t *, cb_write_persistent_cache_t)
     \brief Sets a callback to be used by rtloader to allow storing a value for a given
     check instance.
@@ -598,6 +773,23 @@ DATADOG_AGENT_RTLOADER_API void set_write_persistent_cache_cb(rtloader_t *, cb_w
 */
 DATADOG_AGENT_RTLOADER_API void set_read_persistent_cache_cb(rtloader_t *, cb_read_persistent_cache_t);
 
+/*! \fn int set_persistent_cache_store(rtloader_t *, const char *)
+    \brief Backs the persistent cache builtins with a memory-mapped store file.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param path The path of the store file, NULL closes the current store.
+    \return An integer with the success of the operation, the error is set on failure.
+
+    `datadog_agent.write_persistent_cache` appends the values to a single file instead of
+    writing one file per key through the CGO callback, and `datadog_agent.read_persistent_cache`
+    and `datadog_agent.read_persistent_cache_view` serve them from a memory mapping of that
+    file. Keys missing from the store are still read with the `cb_read_persistent_cache_t`
+    callback, so values written before the store was enabled remain readable. Only one process
+    can open a given store. Not available on Windows.
+
+    The caller must hold the GIL.
+*/
+DATADOG_AGENT_RTLOADER_API int set_persistent_cache_store(rtloader_t *, const char *path);
+
 /*! \fn void set_obfuscate_sql_cb(rtloader_t *, cb_obfuscate_sql_t)
     \brief Sets a callback to be used by rtloader to allow retrieving a value for a given
     check instance.
@@ -620,6 +812,25 @@ DATADOG_AGENT_RTLOADER_API void set_obfuscate_sql_cb(rtloader_t *, cb_obfuscate_
 */
 DATADOG_AGENT_RTLOADER_API void set_obfuscate_sql_exec_plan_cb(rtloader_t *, cb_obfuscate_sql_exec_plan_t);
 
+/*! \fn void set_obfuscation_cache_size(rtloader_t *, size_t)
+    \brief Sets the maximum number of obfuscation results cached by rtloader.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param size The maximum number of cached results, 0 (the default) disables the cache.
+
+    `datadog_agent.obfuscate_sql` and `datadog_agent.obfuscate_sql_exec_plan` results are
+    cached by input and options, so statements submitted over and over by database checks
+    don't cross into the agent each time. The least recently used results are evicted once
+    the cache is full.
+*/
+DATADOG_AGENT_RTLOADER_API void set_obfuscation_cache_size(rtloader_t *, size_t);
+
+/*! \fn void get_obfuscation_cache_stats(rtloader_t *, obfuscation_cache_stats_t *)
+    \brief Retrieves a snapshot of the obfuscation cache counters.
+    \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
+    \param stats A pointer to obfuscation_cache_stats_t structure that will be updated with the new values.
+*/
+DATADOG_AGENT_RTLOADER_API void get_obfuscation_cache_stats(rtloader_t *, obfuscation_cache_stats_t *);
+
 /*! \fn void set_get_process_start_time_cb(rtloader_t *, cb_get_process_start_time_t)
     \brief Sets a callback to be used by rtloader to retrieve agent process start time.
     \param rtloader_t A rtloader_t * pointer to the RtLoader instance.
@@ -643,6 +854,19 @@ DATADOG_AGENT_RTLOADER_API void init_pymem_stats(rtloader_t *);
 */
 DATADOG_AGENT_RTLOADER_API void get_pymem_stats(rtloader_t *, pymem_stats_t *);
 
+/*! \fn int get_check_runtime_stats(rtloader_t *, const char *, check_runtime_stats_t *)
+    \brief Retrieve the resources used by a check since the last call for the same check.
+    \param rtloader A pointer to the RtLoader instance.
+    \param check_id A C-string with the ID of the check.
+    \param stats A pointer to check_runtime_stats_t structure that will be updated with the values.
+    \return 1 if stats were accumulated for the check, 0 otherwise.
+
+    Stats are accumulated by each `run_check` call and reset once retrieved. Allocations are
+    only accounted for once `init_pymem_stats` installed the allocator hooks. Only available
+    with the Python 3 backend.
+*/
+DATADOG_AGENT_RTLOADER_API int get_check_runtime_stats(rtloader_t *, const char *, check_runtime_stats_t *);
+
 /*! \fn void set_obfuscate_mongodb_string_cb(rtloader_t *, cb_obfuscate_mongodb_string_t)
     \brief Sets a callback to be used by rtloader to allow retrieving a value for a given
     check instance.
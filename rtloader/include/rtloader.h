@@ -77,6 +77,18 @@ public:
     */
     virtual bool getClass(const char *module, RtLoaderPyObject *&pyModule, RtLoaderPyObject *&pyClass) = 0;
 
+    //! clearClassCache member.
+    /*!
+      \param module A C-string with the name of the module to drop from the cache, NULL to
+      drop every module.
+
+      Backends may cache the classes returned by getClass, this drops the cached entries so
+      that the next getClass call looks the class up again.
+    */
+    virtual void clearClassCache(const char *module)
+    {
+    }
+
     //! Pure virtual getAttrString member.
     /*!
       \param obj The python object we wish to get the string attribute by name from.
@@ -115,6 +127,19 @@ public:
     */
     virtual void cancelCheck(RtLoaderPyObject *check) = 0;
 
+    //! interruptCheck member.
+    /*!
+      \param check The python object pointer to the check we wish to interrupt.
+      \return A boolean indicating if the check was running and got interrupted.
+
+      Raises an exception in the thread running the check, which is delivered the next time
+      the interpreter checks for pending events. Must be called with the GIL held.
+    */
+    virtual bool interruptCheck(RtLoaderPyObject *check)
+    {
+        return false;
+    }
+
     //! Pure virtual getCheckWarnings member.
     /*!
       \param check The python object pointer to the check we wish to collect existing warnings for.
@@ -228,6 +253,16 @@ public:
       \return A yaml-encoded C-string with the list of every datadog integration wheel installed.
     */
     virtual char *getIntegrationList() = 0;
+
+    //! preloadModules member.
+    /*!
+      \param modules A NULL-terminated array of C-strings with the names of the modules to import.
+      \return The number of modules that couldn't be imported.
+
+      Imports the given modules ahead of their first use, which also compiles their bytecode.
+      The import errors are reported together in the RtLoader error.
+    */
+    virtual int preloadModules(const char **modules) = 0;
 #define _PY_MEM_MODULE "utils.py_mem"
 #define _PY_MEM_SUMMARY_FUNC "get_mem_stats"
     virtual char *getInterpreterMemoryUsage() = 0;
@@ -241,6 +276,15 @@ public:
     */
     virtual void setSubmitMetricCb(cb_submit_metric_t) = 0;
 
+    //! setSubmitMetricBatchCb member.
+    /*!
+      \param A cb_submit_metric_batch_t function pointer to the CGO callback.
+
+      Batches of metrics are submitted from go-land in a single call, this allows us to set
+      the CGO callback.
+    */
+    virtual void setSubmitMetricBatchCb(cb_submit_metric_batch_t) = 0;
+
     //! setSubmitServiceCheckCb member.
     /*!
       \param A cb_submit_service_check_t function pointer to the CGO callback.
@@ -265,6 +309,15 @@ public:
     */
     virtual void setSubmitHistogramBucketCb(cb_submit_histogram_bucket_t) = 0;
 
+    //! setSubmitHistogramBucketsCb member.
+    /*!
+      \param A cb_submit_histogram_buckets_t function pointer to the CGO callback.
+
+      All the buckets of a histogram are submitted from go-land in a single call, this allows
+      us to set the CGO callback.
+    */
+    virtual void setSubmitHistogramBucketsCb(cb_submit_histogram_buckets_t) = 0;
+
     //! setSubmitEventPlatformEventCb member.
     /*!
       \param A cb_submit_event_platform_event_t function pointer to the CGO callback.
@@ -273,6 +326,15 @@ public:
     */
     virtual void setSubmitEventPlatformEventCb(cb_submit_event_platform_event_t) = 0;
 
+    //! setSubmitEventPlatformEventsCb member.
+    /*!
+      \param A cb_submit_event_platform_events_t function pointer to the CGO callback.
+
+      Batches of events are submitted from go-land in a single call, this allows us to set
+      the CGO callback.
+    */
+    virtual void setSubmitEventPlatformEventsCb(cb_submit_event_platform_events_t) = 0;
+
     // datadog_agent API
 
     //! setGetVersionCb member.
@@ -291,6 +353,15 @@ public:
     */
     virtual void setGetConfigCb(cb_get_config_t) = 0;
 
+    //! setConfigGeneration member.
+    /*!
+      \param generation The current Agent configuration generation.
+
+      Enables caching of the agent configuration values, cached values are dropped each
+      time the generation changes. Must be called with the GIL held.
+    */
+    virtual void setConfigGeneration(unsigned long long generation) = 0;
+
     //! setHeadersCb member.
     /*!
       \param A cb_headers_t function pointer to the CGO callback.
@@ -336,6 +407,14 @@ public:
     */
     virtual void setLogCb(cb_log_t) = 0;
 
+    //! setLogLevel member.
+    /*!
+      \param log_level The lowest log level forwarded to the agent logger.
+
+      Messages below this level are dropped by rtloader without calling the CGO callback.
+    */
+    virtual void setLogLevel(int log_level) = 0;
+
     //! setCheckMetadataCb member.
     /*!
       \param A cb_set_check_metadata_t function pointer to the CGO callback.
@@ -354,6 +433,15 @@ public:
     */
     virtual void setSetExternalTagsCb(cb_set_external_tags_t) = 0;
 
+    //! setExternalTagsBatchCb member.
+    /*!
+      \param A cb_set_external_tags_batch_t function pointer to the CGO callback.
+
+      This allows us to set the CGO callback receiving, in a single call, the tags of all the
+      hostnames passed to `set_external_tags`. It takes precedence over the per-host callback.
+    */
+    virtual void setSetExternalTagsBatchCb(cb_set_external_tags_batch_t) = 0;
+
     // _util API
     //! setSubprocessOutputCb member.
     /*!
@@ -364,6 +452,17 @@ public:
     */
     virtual void setSubprocessOutputCb(cb_get_subprocess_output_t) = 0;
 
+    //! setSubprocessOutputStreamCbs member.
+    /*!
+      \param A cb_start_subprocess_t function pointer to the CGO callback starting a command.
+      \param A cb_read_subprocess_output_t function pointer to the CGO callback reading the
+      output of a started command.
+
+      This allows us to set the relevant CGO callbacks that will allow streaming the output
+      of subprocess commands run from go-land.
+    */
+    virtual void setSubprocessOutputStreamCbs(cb_start_subprocess_t, cb_read_subprocess_output_t) = 0;
+
     // CGO API
     //! setCGOFreeCb member.
     /*!
@@ -376,6 +475,22 @@ public:
     */
     virtual void setCGOFreeCb(cb_cgo_free_t) = 0;
 
+    //! setMemoryTrackerBatchCb member.
+    /*!
+      \param A cb_memory_tracker_batch_t function pointer to the CGO callback.
+
+      This allows us to set the CGO callback that will receive the memory operations
+      recorded by rtloader in bulk. Records are flushed at the end of each check run,
+      when a thread record buffer is full, or with flushMemoryTracker.
+    */
+    virtual void setMemoryTrackerBatchCb(cb_memory_tracker_batch_t) = 0;
+
+    //! flushMemoryTracker member.
+    /*!
+      Reports the memory operations recorded by every thread to the batch callback.
+    */
+    virtual void flushMemoryTracker() = 0;
+
     // tagger API
     //! setTagsCb member.
     /*!
@@ -386,6 +501,15 @@ public:
     */
     virtual void setTagsCb(cb_tags_t) = 0;
 
+    //! setTaggerGeneration member.
+    /*!
+      \param generation The current Agent tagger store generation.
+
+      Enables caching of the tags returned by the tagger callback, cached tags are dropped
+      each time the generation changes. Must be called with the GIL held.
+    */
+    virtual void setTaggerGeneration(unsigned long long generation) = 0;
+
     // kubeutil API
     //! setGetConnectionInfoCb member.
     /*!
@@ -406,6 +530,15 @@ public:
     */
     virtual void setIsExcludedCb(cb_is_excluded_t) = 0;
 
+    //! setIsExcludedManyCb member.
+    /*!
+      \param A cb_is_excluded_many_t function pointer to the CGO callback.
+
+      This allows us to set the relevant CGO callback to verify if a set of containers
+      are excluded from collection in a single call.
+    */
+    virtual void setIsExcludedManyCb(cb_is_excluded_many_t) = 0;
+
     //! setWritePersistentCacheCb member.
     /*!
       \param A cb_write_persistent_cache_t function pointer to the CGO callback.
@@ -424,6 +557,17 @@ public:
     */
     virtual void setReadPersistentCacheCb(cb_read_persistent_cache_t) = 0;
 
+    //! setPersistentCacheStore member.
+    /*!
+      \param path The path of the store file, NULL closes the current store.
+      \return A boolean indicating the success or failure of the operation.
+
+      Backs the persistent cache builtins with a memory-mapped store instead of the CGO
+      callbacks, the callbacks are only used for the keys missing from the store. The error
+      is set on failure. The GIL must be held.
+    */
+    virtual bool setPersistentCacheStore(const char *path) = 0;
+
     //! setObfuscateSqlCb member.
     /*!
       \param A cb_obfuscate_sql_t function pointer to the CGO callback.
@@ -442,6 +586,23 @@ public:
     */
     virtual void setObfuscateSqlExecPlanCb(cb_obfuscate_sql_exec_plan_t) = 0;
 
+    //! setObfuscationCacheSize member.
+    /*!
+      \param size The maximum number of cached obfuscation results, 0 disables the cache.
+
+      Enables caching of the `obfuscate_sql` and `obfuscate_sql_exec_plan` results, the least
+      recently used ones are evicted once the cache is full.
+    */
+    virtual void setObfuscationCacheSize(size_t size) = 0;
+
+    //! getObfuscationCacheStats member.
+    /*!
+      \param stats Stats snapshot output.
+
+      Retrieve a snapshot of the obfuscation cache counters.
+    */
+    virtual void getObfuscationCacheStats(obfuscation_cache_stats_t &stats) = 0;
+
     //! setGetProcessStartTimeCb member.
     /*!
       \param A cb_get_process_start_time_t function pointer to the CGO callback.
@@ -469,6 +630,20 @@ public:
     {
     }
 
+    //! popCheckRuntimeStats member.
+    /*!
+      \param checkId The ID of the check we want the stats for.
+      \param stats Stats output.
+      \return A boolean indicating if stats were found for the check.
+
+      Retrieve the runtime stats accumulated by a check since the last call, these are
+      reset by the call.
+    */
+    virtual bool popCheckRuntimeStats(const char *checkId, check_runtime_stats_t &stats)
+    {
+        return false;
+    }
+
     //! setObfuscateMongoDBStringCb member.
     /*!
       \param A cb_obfuscate_mongodb_string_t function pointer to the CGO callback.
@@ -40,6 +40,12 @@ typedef enum {
     DATADOG_AGENT_RTLOADER_FREE,
 } rtloader_mem_ops_t;
 
+typedef struct rtloader_mem_record_s {
+    void *ptr;
+    size_t sz;
+    rtloader_mem_ops_t op;
+} rtloader_mem_record_t;
+
 typedef void *(*rtloader_malloc_t)(size_t);
 typedef void (*rtloader_free_t)(void *);
 
@@ -72,6 +78,26 @@ typedef struct event_s {
     char *event_type;
 } event_t;
 
+/*! metric_batch_t
+    \brief Columnar representation of a batch of metric samples.
+
+    Every array holds `count` entries, sample `i` being made of `types[i]`, `names[i]`,
+    `values[i]`, `hostnames[i]` and `flush_first_values[i]`. Tags for all the samples are
+    stored in the flat `tags` array: the tags of sample `i` start at index `tags_offsets[i]`
+    and are NULL-terminated, so `&tags[tags_offsets[i]]` can be consumed like any other tags
+    array.
+*/
+typedef struct metric_batch_s {
+    int count;
+    metric_type_t *types;
+    char **names;
+    double *values;
+    char **hostnames;
+    bool *flush_first_values;
+    int *tags_offsets;
+    char **tags;
+} metric_batch_t;
+
 typedef struct py_info_s {
     const char *version; // returned by Py_GetInfo(); is static string owned by python
     char *path; // allocated within getPyInfo()
@@ -90,6 +116,27 @@ typedef struct pymem_stats_s {
     size_t inuse, alloc;
 } pymem_stats_t;
 
+typedef struct obfuscation_cache_stats_s {
+    // number of obfuscation results currently cached
+    size_t entries;
+    // lookups answered from the cache, and lookups that had to call into the agent
+    size_t hits, misses;
+    // results dropped to make room for new ones
+    size_t evictions;
+} obfuscation_cache_stats_t;
+
+typedef struct check_runtime_stats_s {
+    // number of check runs accounted for
+    size_t runs;
+    // bytes requested by the python allocators while the check ran
+    size_t alloc;
+    // wall clock time spent running the check, in nanoseconds
+    unsigned long long wall_time_ns;
+    // CPU time of the thread running the check, in nanoseconds. Python code only
+    // runs with the GIL held so this approximates the GIL hold time.
+    unsigned long long cpu_time_ns;
+} check_runtime_stats_t;
+
 /*
  * custom builtins
  */
@@ -98,14 +145,21 @@ typedef struct pymem_stats_s {
 //
 // (id, metric_type, metric_name, value, tags, hostname, flush_first_value)
 typedef void (*cb_submit_metric_t)(char *, metric_type_t, char *, double, char **, char *, bool);
+// (id, batch)
+typedef void (*cb_submit_metric_batch_t)(char *, metric_batch_t *);
 // (id, sc_name, status, tags, hostname, message)
 typedef void (*cb_submit_service_check_t)(char *, char *, int, char **, char *, char *);
 // (id, event)
 typedef void (*cb_submit_event_t)(char *, event_t *);
 // (id, metric_name, value, lower_bound, upper_bound, monotonic, hostname, tags, flush_first_value)
 typedef void (*cb_submit_histogram_bucket_t)(char *, char *, long long, float, float, int, char *, char **, bool);
+// (id, metric_name, count, values, lower_bounds, upper_bounds, monotonic, hostname, tags, flush_first_value)
+typedef void (*cb_submit_histogram_buckets_t)(char *, char *, int, long long *, float *, float *, int, char *, char **,
+                                              bool);
 // (id, event, event_type)
 typedef void (*cb_submit_event_platform_event_t)(char *, char *, int, char *);
+// (id, count, events, event_sizes, event_type)
+typedef void (*cb_submit_event_platform_events_t)(char *, int, char **, int *, char *);
 
 // datadog_agent
 //
@@ -127,6 +181,10 @@ typedef void (*cb_log_t)(char *, int);
 typedef void (*cb_set_check_metadata_t)(char *, char *, char *);
 // (hostname, source_type_name, list of tags)
 typedef void (*cb_set_external_tags_t)(char *, char *, char **);
+// (buffer, size) - the buffer holds one entry per hostname, made of the hostname, the
+// source_type, a uint32 number of tags and the tags. Every string is a uint32 length followed
+// by its UTF-8 bytes, without NULL terminator, integers being in the native byte order.
+typedef void (*cb_set_external_tags_batch_t)(char *, int);
 // (key, value)
 typedef void (*cb_write_persistent_cache_t)(char *, char *);
 // (value)
@@ -143,6 +201,10 @@ typedef char *(*cb_obfuscate_mongodb_string_t)(char *, char **);
 // _util
 // (argv, env, stdout, stderr, ret_code, exception)
 typedef void (*cb_get_subprocess_output_t)(char **, char **, char **, char **, int *, char **);
+// (argv, env, handle, exception)
+typedef void (*cb_start_subprocess_t)(char **, char **, int *, char **);
+// (handle, cancel, chunk, chunk_len, stderr, ret_code, exception)
+typedef void (*cb_read_subprocess_output_t)(int, int, char **, int *, char **, int *, char **);
 
 // CGO API
 //
@@ -150,6 +212,7 @@ typedef void (*cb_get_subprocess_output_t)(char **, char **, char **, char **, i
 //
 typedef void (*cb_cgo_free_t)(void *);
 typedef void (*cb_memory_tracker_t)(void *, size_t sz, rtloader_mem_ops_t op);
+typedef void (*cb_memory_tracker_batch_t)(rtloader_mem_record_t *, size_t);
 
 // tagger
 //
@@ -165,6 +228,8 @@ typedef void (*cb_get_connection_info_t)(char **);
 //
 // (container_name, image_name, namespace, bool_result)
 typedef int (*cb_is_excluded_t)(char *, char *, char *);
+// (count, container_names, image_names, namespaces, bool_results)
+typedef void (*cb_is_excluded_many_t)(int, char **, char **, char **, int *);
 
 #ifdef __cplusplus
 }
@@ -286,6 +286,11 @@ int get_class(rtloader_t *rtloader, const char *name, rtloader_pyobject_t **py_m
         : 0;
 }
 
+void clear_class_cache(rtloader_t *rtloader, const char *name)
+{
+    AS_TYPE(RtLoader, rtloader)->clearClassCache(name);
+}
+
 int get_attr_string(rtloader_t *rtloader, rtloader_pyobject_t *py_class, const char *attr_name, char **value)
 {
     return AS_TYPE(RtLoader, rtloader)->getAttrString(AS_TYPE(RtLoaderPyObject, py_class), attr_name, *value);
@@ -322,6 +327,11 @@ void cancel_check(rtloader_t *rtloader, rtloader_pyobject_t *check)
     AS_TYPE(RtLoader, rtloader)->cancelCheck(AS_TYPE(RtLoaderPyObject, check));
 }
 
+int interrupt_check(rtloader_t *rtloader, rtloader_pyobject_t *check)
+{
+    return AS_TYPE(RtLoader, rtloader)->interruptCheck(AS_TYPE(RtLoaderPyObject, check)) ? 1 : 0;
+}
+
 char **get_checks_warnings(rtloader_t *rtloader, rtloader_pyobject_t *check)
 {
     return AS_TYPE(RtLoader, rtloader)->getCheckWarnings(AS_TYPE(RtLoaderPyObject, check));
@@ -468,6 +478,11 @@ void set_submit_metric_cb(rtloader_t *rtloader, cb_submit_metric_t cb)
     AS_TYPE(RtLoader, rtloader)->setSubmitMetricCb(cb);
 }
 
+void set_submit_metric_batch_cb(rtloader_t *rtloader, cb_submit_metric_batch_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setSubmitMetricBatchCb(cb);
+}
+
 void set_submit_service_check_cb(rtloader_t *rtloader, cb_submit_service_check_t cb)
 {
     AS_TYPE(RtLoader, rtloader)->setSubmitServiceCheckCb(cb);
@@ -483,11 +498,21 @@ void set_submit_histogram_bucket_cb(rtloader_t *rtloader, cb_submit_histogram_bu
     AS_TYPE(RtLoader, rtloader)->setSubmitHistogramBucketCb(cb);
 }
 
+void set_submit_histogram_buckets_cb(rtloader_t *rtloader, cb_submit_histogram_buckets_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setSubmitHistogramBucketsCb(cb);
+}
+
 void set_submit_event_platform_event_cb(rtloader_t *rtloader, cb_submit_event_platform_event_t cb)
 {
     AS_TYPE(RtLoader, rtloader)->setSubmitEventPlatformEventCb(cb);
 }
 
+void set_submit_event_platform_events_cb(rtloader_t *rtloader, cb_submit_event_platform_events_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setSubmitEventPlatformEventsCb(cb);
+}
+
 /*
  * datadog_agent API
  */
@@ -502,6 +527,11 @@ void set_get_config_cb(rtloader_t *rtloader, cb_get_config_t cb)
     AS_TYPE(RtLoader, rtloader)->setGetConfigCb(cb);
 }
 
+void set_config_generation(rtloader_t *rtloader, unsigned long long generation)
+{
+    AS_TYPE(RtLoader, rtloader)->setConfigGeneration(generation);
+}
+
 void set_headers_cb(rtloader_t *rtloader, cb_headers_t cb)
 {
     AS_TYPE(RtLoader, rtloader)->setHeadersCb(cb);
@@ -527,6 +557,11 @@ void set_log_cb(rtloader_t *rtloader, cb_log_t cb)
     AS_TYPE(RtLoader, rtloader)->setLogCb(cb);
 }
 
+void set_log_level(rtloader_t *rtloader, int log_level)
+{
+    AS_TYPE(RtLoader, rtloader)->setLogLevel(log_level);
+}
+
 void set_set_check_metadata_cb(rtloader_t *rtloader, cb_set_check_metadata_t cb)
 {
     AS_TYPE(RtLoader, rtloader)->setSetCheckMetadataCb(cb);
@@ -537,6 +572,16 @@ void set_set_external_tags_cb(rtloader_t *rtloader, cb_set_external_tags_t cb)
     AS_TYPE(RtLoader, rtloader)->setSetExternalTagsCb(cb);
 }
 
+void set_set_external_tags_batch_cb(rtloader_t *rtloader, cb_set_external_tags_batch_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setSetExternalTagsBatchCb(cb);
+}
+
+int preload_modules(rtloader_t *rtloader, const char **modules)
+{
+    return AS_TYPE(RtLoader, rtloader)->preloadModules(modules);
+}
+
 char *get_integration_list(rtloader_t *rtloader)
 {
     return AS_TYPE(RtLoader, rtloader)->getIntegrationList();
@@ -557,6 +602,11 @@ void set_read_persistent_cache_cb(rtloader_t *rtloader, cb_read_persistent_cache
     AS_TYPE(RtLoader, rtloader)->setReadPersistentCacheCb(cb);
 }
 
+int set_persistent_cache_store(rtloader_t *rtloader, const char *path)
+{
+    return AS_TYPE(RtLoader, rtloader)->setPersistentCacheStore(path) ? 1 : 0;
+}
+
 void set_obfuscate_sql_cb(rtloader_t *rtloader, cb_obfuscate_sql_t cb)
 {
     AS_TYPE(RtLoader, rtloader)->setObfuscateSqlCb(cb);
@@ -567,6 +617,19 @@ void set_obfuscate_sql_exec_plan_cb(rtloader_t *rtloader, cb_obfuscate_sql_exec_
     AS_TYPE(RtLoader, rtloader)->setObfuscateSqlExecPlanCb(cb);
 }
 
+void set_obfuscation_cache_size(rtloader_t *rtloader, size_t size)
+{
+    AS_TYPE(RtLoader, rtloader)->setObfuscationCacheSize(size);
+}
+
+void get_obfuscation_cache_stats(rtloader_t *rtloader, obfuscation_cache_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    AS_TYPE(RtLoader, rtloader)->getObfuscationCacheStats(*stats);
+}
+
 void set_get_process_start_time_cb(rtloader_t *rtloader, cb_get_process_start_time_t cb)
 {
     AS_TYPE(RtLoader, rtloader)->setGetProcessStartTimeCb(cb);
@@ -585,6 +648,12 @@ void set_get_subprocess_output_cb(rtloader_t *rtloader, cb_get_subprocess_output
     AS_TYPE(RtLoader, rtloader)->setSubprocessOutputCb(cb);
 }
 
+void set_subprocess_output_stream_cbs(rtloader_t *rtloader, cb_start_subprocess_t start,
+                                      cb_read_subprocess_output_t read)
+{
+    AS_TYPE(RtLoader, rtloader)->setSubprocessOutputStreamCbs(start, read);
+}
+
 /*
  * CGO API
  */
@@ -593,6 +662,16 @@ void set_cgo_free_cb(rtloader_t *rtloader, cb_cgo_free_t cb)
     AS_TYPE(RtLoader, rtloader)->setCGOFreeCb(cb);
 }
 
+void set_memory_tracker_batch_cb(rtloader_t *rtloader, cb_memory_tracker_batch_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setMemoryTrackerBatchCb(cb);
+}
+
+void flush_memory_tracker(rtloader_t *rtloader)
+{
+    AS_TYPE(RtLoader, rtloader)->flushMemoryTracker();
+}
+
 /*
  * tagger API
  */
@@ -601,6 +680,11 @@ void set_tags_cb(rtloader_t *rtloader, cb_tags_t cb)
     AS_TYPE(RtLoader, rtloader)->setTagsCb(cb);
 }
 
+void set_tagger_generation(rtloader_t *rtloader, unsigned long long generation)
+{
+    AS_TYPE(RtLoader, rtloader)->setTaggerGeneration(generation);
+}
+
 /*
  * kubeutil API
  */
@@ -617,6 +701,11 @@ void set_is_excluded_cb(rtloader_t *rtloader, cb_is_excluded_t cb)
     AS_TYPE(RtLoader, rtloader)->setIsExcludedCb(cb);
 }
 
+void set_is_excluded_many_cb(rtloader_t *rtloader, cb_is_excluded_many_t cb)
+{
+    AS_TYPE(RtLoader, rtloader)->setIsExcludedManyCb(cb);
+}
+
 /*
  * python allocator stats API
  */
@@ -632,3 +721,11 @@ void get_pymem_stats(rtloader_t *rtloader, pymem_stats_t *stats)
     }
     AS_TYPE(RtLoader, rtloader)->getPymemStats(*stats);
 }
+
+int get_check_runtime_stats(rtloader_t *rtloader, const char *check_id, check_runtime_stats_t *stats)
+{
+    if (stats == NULL) {
+        return 0;
+    }
+    return AS_TYPE(RtLoader, rtloader)->popCheckRuntimeStats(check_id, *stats) ? 1 : 0;
+}
@@ -22,17 +22,23 @@ import (
 #include "datadog_agent_rtloader.h"
 
 extern void submitMetric(char *, metric_type_t, char *, double, char **, char *, bool);
+extern void submitMetricBatch(char *, metric_batch_t *);
 extern void submitServiceCheck(char *, char *, int, char **, char *, char *);
 extern void submitEvent(char*, event_t*);
 extern void submitHistogramBucket(char *, char *, long long, float, float, int, char *, char **, bool);
+extern void submitHistogramBuckets(char *, char *, int, long long *, float *, float *, int, char *, char **, bool);
 extern void submitEventPlatformEvent(char *, char *, int, char *);
+extern void submitEventPlatformEvents(char *, int, char **, int *, char *);
 
 static void initAggregatorTests(rtloader_t *rtloader) {
    set_submit_metric_cb(rtloader, submitMetric);
+   set_submit_metric_batch_cb(rtloader, submitMetricBatch);
    set_submit_service_check_cb(rtloader, submitServiceCheck);
    set_submit_event_cb(rtloader, submitEvent);
    set_submit_histogram_bucket_cb(rtloader, submitHistogramBucket);
+   set_submit_histogram_buckets_cb(rtloader, submitHistogramBuckets);
    set_submit_event_platform_event_cb(rtloader, submitEventPlatformEvent);
+   set_submit_event_platform_events_cb(rtloader, submitEventPlatformEvents);
 }
 */
 import "C"
@@ -56,8 +62,26 @@ var (
 	lowerBound      float64
 	upperBound      float64
 	monotonic       bool
+	batch           []metric
+	buckets         []bucket
+	rawEvents       [][]byte
 )
 
+type metric struct {
+	metricType      int
+	name            string
+	value           float64
+	tags            []string
+	hostname        string
+	flushFirstValue bool
+}
+
+type bucket struct {
+	value      int
+	lowerBound float64
+	upperBound float64
+}
+
 type event struct {
 	title          string
 	text           string
@@ -86,6 +110,9 @@ func resetOuputValues() {
 	lowerBound = 1.0
 	upperBound = 1.0
 	monotonic = false
+	batch = nil
+	buckets = nil
+	rawEvents = nil
 }
 
 func setUp() error {
@@ -172,6 +199,32 @@ func submitMetric(id *C.char, mt C.metric_type_t, mname *C.char, val C.double, t
 	flushFirstValue = bool(fFirstValue)
 }
 
+//export submitMetricBatch
+func submitMetricBatch(id *C.char, b *C.metric_batch_t) {
+	checkID = C.GoString(id)
+
+	count := int(b.count)
+	types := unsafe.Slice(b.types, count)
+	names := unsafe.Slice(b.names, count)
+	values := unsafe.Slice(b.values, count)
+	hostnames := unsafe.Slice(b.hostnames, count)
+	flushFirstValues := unsafe.Slice(b.flush_first_values, count)
+	tagsOffsets := unsafe.Slice(b.tags_offsets, count)
+
+	for i := 0; i < count; i++ {
+		m := metric{
+			metricType:      int(types[i]),
+			name:            C.GoString(names[i]),
+			value:           float64(values[i]),
+			hostname:        C.GoString(hostnames[i]),
+			flushFirstValue: bool(flushFirstValues[i]),
+		}
+		t := (**C.char)(unsafe.Add(unsafe.Pointer(b.tags), uintptr(tagsOffsets[i])*unsafe.Sizeof(*b.tags)))
+		m.tags = append(m.tags, charArrayToSlice(t)...)
+		batch = append(batch, m)
+	}
+}
+
 //export submitServiceCheck
 func submitServiceCheck(id *C.char, name *C.char, level C.int, t **C.char, hname *C.char, message *C.char) {
 	checkID = C.GoString(id)
@@ -235,9 +288,40 @@ func submitHistogramBucket(id *C.char, cMetricName *C.char, cVal C.longlong, cLo
 	flushFirstValue = bool(fFirstValue)
 }
 
+//export submitHistogramBuckets
+func submitHistogramBuckets(id *C.char, cMetricName *C.char, cCount C.int, cValues *C.longlong, cLowerBounds *C.float, cUpperBounds *C.float, cMonotonic C.int, cHostname *C.char, t **C.char, fFirstValue C.bool) {
+	checkID = C.GoString(id)
+	name = C.GoString(cMetricName)
+	monotonic = (cMonotonic != 0)
+	hostname = C.GoString(cHostname)
+	if t != nil {
+		tags = append(tags, charArrayToSlice(t)...)
+	}
+	flushFirstValue = bool(fFirstValue)
+
+	count := int(cCount)
+	values := unsafe.Slice(cValues, count)
+	lowerBounds := unsafe.Slice(cLowerBounds, count)
+	upperBounds := unsafe.Slice(cUpperBounds, count)
+	for i := 0; i < count; i++ {
+		buckets = append(buckets, bucket{int(values[i]), float64(lowerBounds[i]), float64(upperBounds[i])})
+	}
+}
+
 //export submitEventPlatformEvent
 func submitEventPlatformEvent(id *C.char, _rawEventPtr *C.char, _rawEventSize C.int, _eventType *C.char) {
 	checkID = C.GoString(id)
 	rawEvent = C.GoBytes(unsafe.Pointer(_rawEventPtr), _rawEventSize)
 	eventType = C.GoString(_eventType)
 }
+
+//export submitEventPlatformEvents
+func submitEventPlatformEvents(id *C.char, count C.int, _rawEventPtrs **C.char, _rawEventSizes *C.int, _eventType *C.char) {
+	checkID = C.GoString(id)
+	ptrs := unsafe.Slice(_rawEventPtrs, int(count))
+	sizes := unsafe.Slice(_rawEventSizes, int(count))
+	for i := range ptrs {
+		rawEvents = append(rawEvents, C.GoBytes(unsafe.Pointer(ptrs[i]), sizes[i]))
+	}
+	eventType = C.GoString(_eventType)
+}
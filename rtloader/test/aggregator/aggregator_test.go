@@ -7,6 +7,7 @@ package testaggregator
 
 import (
 	"fmt"
+	"math"
 	"os"
 	"regexp"
 	"testing"
@@ -106,6 +107,38 @@ func TestSubmitMetric_FlushFirstValue(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestSubmitMetricInternedTags(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	out, err := run(`
+	aggregator.submit_metric(None, 'id', aggregator.GAUGE, 'name', 1.0, ['foo', b'bar'], 'myhost')
+	aggregator.submit_metric(None, 'id', aggregator.GAUGE, 'name', 2.0, ['foo', b'bar', 'baz'], 'myhost')
+	`)
+
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if value != 2.0 {
+		t.Fatalf("Unexpected value: %f", value)
+	}
+	expected := []string{"foo", "bar", "foo", "bar", "baz"}
+	if len(tags) != len(expected) {
+		t.Fatalf("Unexpected tags length: %d", len(tags))
+	}
+	for i := range expected {
+		if tags[i] != expected[i] {
+			t.Fatalf("Unexpected tags: %v", tags)
+		}
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestSubmitMetricParsingError(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -144,6 +177,63 @@ func TestSubmitMetricTagsError(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestSubmitMetricsBatch(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	out, err := run(`aggregator.submit_metrics_batch(None, 'id', [(aggregator.GAUGE, 'name', -99.0, ['foo', 21, 'bar', ["hey"]], 'myhost'), (aggregator.MONOTONIC_COUNT, 'other', 42.0, [], '', True)])`)
+
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if checkID != "id" {
+		t.Fatalf("Unexpected id value: %s", checkID)
+	}
+	if len(batch) != 2 {
+		t.Fatalf("Unexpected batch length: %d", len(batch))
+	}
+
+	m := batch[0]
+	if m.metricType != 0 || m.name != "name" || m.value != -99.0 || m.hostname != "myhost" || m.flushFirstValue {
+		t.Fatalf("Unexpected first metric: %+v", m)
+	}
+	if len(m.tags) != 2 || m.tags[0] != "foo" || m.tags[1] != "bar" {
+		t.Fatalf("Unexpected first metric tags: %v", m.tags)
+	}
+
+	m = batch[1]
+	if m.metricType != 3 || m.name != "other" || m.value != 42.0 || m.hostname != "" || !m.flushFirstValue {
+		t.Fatalf("Unexpected second metric: %+v", m)
+	}
+	if len(m.tags) != 0 {
+		t.Fatalf("Unexpected second metric tags: %v", m.tags)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestSubmitMetricsBatchParsingError(t *testing.T) {
+	helpers.ResetMemoryStats()
+
+	out, err := run(`aggregator.submit_metrics_batch(None, 'id', [(aggregator.GAUGE, 'name', -99.0, [], 'myhost'), ('not a tuple')])`)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "TypeError: metrics must be tuples" {
+		t.Errorf("wrong printed value: '%s'", out)
+	}
+	if len(batch) != 0 {
+		t.Fatalf("Unexpected batch length: %d", len(batch))
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestSubmitServiceCheck(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -456,6 +546,69 @@ func TestSubmitHistogramBucket(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestSubmitHistogramBuckets(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	out, err := run(`aggregator.submit_histogram_buckets(None, 'id', 'name', [3, 7], [0.0, 1.0], [1.0, float('inf')], 1, 'myhost', ['foo', 21, 'bar'], True)`)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if checkID != "id" {
+		t.Fatalf("Unexpected id value: %s", checkID)
+	}
+	if name != "name" {
+		t.Fatalf("Unexpected name value: %s", name)
+	}
+	if monotonic != true {
+		t.Fatalf("Unexpected monotonic value: %v", monotonic)
+	}
+	if hostname != "myhost" {
+		t.Fatalf("Unexpected hostname value: %s", hostname)
+	}
+	if flushFirstValue != true {
+		t.Fatalf("Unexpected flushFirstValue value: %v", flushFirstValue)
+	}
+	if len(tags) != 2 || tags[0] != "foo" || tags[1] != "bar" {
+		t.Fatalf("Unexpected tags: %v", tags)
+	}
+	if len(buckets) != 2 {
+		t.Fatalf("Unexpected buckets length: %d", len(buckets))
+	}
+	if buckets[0] != (bucket{3, 0.0, 1.0}) {
+		t.Fatalf("Unexpected first bucket: %+v", buckets[0])
+	}
+	if buckets[1].value != 7 || buckets[1].lowerBound != 1.0 || !math.IsInf(buckets[1].upperBound, 1) {
+		t.Fatalf("Unexpected second bucket: %+v", buckets[1])
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestSubmitHistogramBucketsLengthMismatch(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	out, err := run(`aggregator.submit_histogram_buckets(None, 'id', 'name', [3, 7], [0.0], [1.0, 2.0], 1, 'myhost', [])`)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "ValueError: values and bounds must have the same length" {
+		t.Errorf("wrong printed value: '%s'", out)
+	}
+	if len(buckets) != 0 {
+		t.Fatalf("Unexpected buckets length: %d", len(buckets))
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestSubmitEventPlatformEvent(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -495,3 +648,68 @@ func TestSubmitEventPlatformEvent(t *testing.T) {
 	// Check for leaks
 	helpers.AssertMemoryUsage(t)
 }
+
+func TestSubmitEventPlatformEventBuffer(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	out, err := run(`aggregator.submit_event_platform_event(None, 'id', bytearray(b'raw-event'), 'dbm-sample')`)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if string(rawEvent) != "raw-event" || eventType != "dbm-sample" {
+		t.Fatalf("Unexpected event: '%s' '%s'", rawEvent, eventType)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestSubmitEventPlatformEvents(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	out, err := run(`aggregator.submit_event_platform_events(None, 'id', ['first', b'second', memoryview(b'third'), ''], 'dbm-sample')`)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if checkID != "id" || eventType != "dbm-sample" {
+		t.Fatalf("Unexpected id or event type: '%s' '%s'", checkID, eventType)
+	}
+	if len(rawEvents) != 4 {
+		t.Fatalf("Unexpected events length: %d", len(rawEvents))
+	}
+	for i, expected := range []string{"first", "second", "third", ""} {
+		if string(rawEvents[i]) != expected {
+			t.Fatalf("Unexpected event %d: '%s'", i, rawEvents[i])
+		}
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestSubmitEventPlatformEventsParsingError(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	out, err := run(`aggregator.submit_event_platform_events(None, 'id', ['first', 2], 'dbm-sample')`)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "TypeError: raw event must be a string or a bytes-like object, not int" {
+		t.Errorf("wrong printed value: '%s'", out)
+	}
+	if len(rawEvents) != 0 {
+		t.Fatalf("Unexpected events length: %d", len(rawEvents))
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
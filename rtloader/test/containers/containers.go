@@ -21,16 +21,19 @@ import (
 #include "datadog_agent_rtloader.h"
 
 extern int is_excluded(char *, char *, char *);
+extern void is_excluded_many(int, char **, char **, char **, int *);
 
 static void initContainersTests(rtloader_t *rtloader) {
    set_is_excluded_cb(rtloader, is_excluded);
+   set_is_excluded_many_cb(rtloader, is_excluded_many);
 }
 */
 import "C"
 
 var (
-	rtloader *C.rtloader_t
-	tmpfile  *os.File
+	rtloader            *C.rtloader_t
+	tmpfile             *os.File
+	isExcludedManyCalls int
 )
 
 type message struct {
@@ -106,3 +109,15 @@ func is_excluded(name *C.char, image *C.char, namespace *C.char) C.int {
 	}
 	return 0
 }
+
+//export is_excluded_many
+func is_excluded_many(count C.int, names **C.char, images **C.char, namespaces **C.char, results *C.int) {
+	isExcludedManyCalls++
+	goNames := unsafe.Slice(names, count)
+	goResults := unsafe.Slice(results, count)
+	for i := range goNames {
+		if C.GoString(goNames[i]) == "foo" {
+			goResults[i] = 1
+		}
+	}
+}
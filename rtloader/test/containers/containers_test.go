@@ -91,3 +91,46 @@ func TestIsExcludedErrorTypeImage(t *testing.T) {
 	// Check for leaks
 	helpers.AssertMemoryUsage(t)
 }
+
+func TestIsExcludedMany(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+	isExcludedManyCalls = 0
+
+	code := fmt.Sprintf(`
+	with open(r'%s', 'w') as f:
+		f.write("{},{}".format(
+			containers.is_excluded_many([('foo', 'bar', 'ns'), ('baz', 'bar'), ('foo', 'baz')]),
+			containers.is_excluded_many([]),
+		))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "[True, False, True],[]" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if isExcludedManyCalls != 1 {
+		t.Errorf("Unexpected number of callback calls: %d", isExcludedManyCalls)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestIsExcludedManyErrorNotTuple(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	out, err := run(`containers.is_excluded_many(['foo'])`)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "TypeError: containers must be tuples" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
@@ -6,11 +6,13 @@
 package testdatadogagent
 
 import (
+	"encoding/binary"
 	"encoding/json"
 	"fmt"
 	"os"
 	"runtime"
 	"strings"
+	"sync/atomic"
 	"time"
 	"unsafe"
 
@@ -34,6 +36,7 @@ extern void getVersion(char **);
 extern void headers(char **);
 extern void setCheckMetadata(char*, char*, char*);
 extern void setExternalHostTags(char*, char*, char**);
+extern void setExternalHostTagsBatch(char*, int);
 extern void writePersistentCache(char*, char*);
 extern char* readPersistentCache(char*);
 extern char* obfuscateSQL(char*, char*, char**);
@@ -64,10 +67,18 @@ static void initDatadogAgentTests(rtloader_t *rtloader) {
 import "C"
 
 var (
-	rtloader *C.rtloader_t
-	tmpfile  *os.File
+	rtloader         *C.rtloader_t
+	tmpfile          *os.File
+	getConfigCalls   int
+	getHostnameCalls int
+	obfuscateCalls   int32
+	// number of obfuscations of slowQuery running at once
+	obfuscateRunning    int32
+	obfuscateMaxRunning int32
 )
 
+const slowQuery = "select pg_sleep(0.2)"
+
 type message struct {
 	Name string `yaml:"name"`
 	Body string `yaml:"body"`
@@ -136,6 +147,56 @@ except Exception as e:
 	return strings.TrimSpace(string(output)), err
 }
 
+func setConfigGeneration(generation uint64) {
+	runtime.LockOSThread()
+	state := C.ensure_gil(rtloader)
+
+	C.set_config_generation(rtloader, C.ulonglong(generation))
+
+	C.release_gil(rtloader, state)
+	runtime.UnlockOSThread()
+}
+
+func setExternalTagsBatch(enabled bool) {
+	var cb C.cb_set_external_tags_batch_t
+	if enabled {
+		cb = C.cb_set_external_tags_batch_t(C.setExternalHostTagsBatch)
+	}
+	C.set_set_external_tags_batch_cb(rtloader, cb)
+}
+
+func setLogLevel(level int) {
+	C.set_log_level(rtloader, C.int(level))
+}
+
+func setPersistentCacheStore(path string) bool {
+	var cPath *C.char
+	if path != "" {
+		cPath = (*C.char)(helpers.TrackedCString(path))
+		defer C._free(unsafe.Pointer(cPath))
+	}
+
+	runtime.LockOSThread()
+	state := C.ensure_gil(rtloader)
+
+	ret := C.set_persistent_cache_store(rtloader, cPath) == 1
+
+	C.release_gil(rtloader, state)
+	runtime.UnlockOSThread()
+
+	return ret
+}
+
+func setObfuscationCacheSize(size int) {
+	C.set_obfuscation_cache_size(rtloader, C.size_t(size))
+}
+
+func getObfuscationCacheStats() C.obfuscation_cache_stats_t {
+	var stats C.obfuscation_cache_stats_t
+	C.get_obfuscation_cache_stats(rtloader, &stats)
+	return stats
+}
+
 //export getVersion
 func getVersion(in **C.char) {
 	*in = (*C.char)(helpers.TrackedCString("1.2.3"))
@@ -143,6 +204,7 @@ func getVersion(in **C.char) {
 
 //export getConfig
 func getConfig(key *C.char, in **C.char) {
+	getConfigCalls++
 
 	goKey := C.GoString(key)
 	switch goKey {
@@ -152,6 +214,8 @@ func getConfig(key *C.char, in **C.char) {
 		m := message{C.GoString(key), "Hello", 123456}
 		b, _ := yaml.Marshal(m)
 		*in = (*C.char)(helpers.TrackedCString(string(b)))
+	case "foo_json":
+		*in = (*C.char)(helpers.TrackedCString(`{"name":"foo_json","body":"Hello","time":123456}`))
 	default:
 		*in = (*C.char)(helpers.TrackedCString("null"))
 	}
@@ -171,6 +235,8 @@ func headers(in **C.char) {
 
 //export getHostname
 func getHostname(in **C.char) {
+	getHostnameCalls++
+
 	*in = (*C.char)(helpers.TrackedCString("localfoobar"))
 }
 
@@ -230,6 +296,32 @@ func setExternalHostTags(hostname *C.char, sourceType *C.char, tags **C.char) {
 	f.WriteString("\n")
 }
 
+//export setExternalHostTagsBatch
+func setExternalHostTagsBatch(buffer *C.char, size C.int) {
+	buf := C.GoBytes(unsafe.Pointer(buffer), size)
+	readString := func() string {
+		l := binary.NativeEndian.Uint32(buf)
+		s := string(buf[4 : 4+l])
+		buf = buf[4+l:]
+		return s
+	}
+
+	f, _ := os.OpenFile(tmpfile.Name(), os.O_APPEND|os.O_RDWR|os.O_CREATE, 0666)
+	defer f.Close()
+
+	// write the entries the same way setExternalHostTags does
+	for len(buf) > 0 {
+		entry := []string{readString(), readString()}
+		count := binary.NativeEndian.Uint32(buf)
+		buf = buf[4:]
+		for i := uint32(0); i < count; i++ {
+			entry = append(entry, readString())
+		}
+		f.WriteString(strings.Join(entry, ","))
+		f.WriteString("\n")
+	}
+}
+
 //export writePersistentCache
 func writePersistentCache(key, value *C.char) {
 	keyName := C.GoString(key)
@@ -267,6 +359,8 @@ type sqlConfig struct {
 
 //export obfuscateSQL
 func obfuscateSQL(rawQuery, opts *C.char, errResult **C.char) *C.char {
+	atomic.AddInt32(&obfuscateCalls, 1)
+
 	var sqlOpts sqlConfig
 	optStr := C.GoString(opts)
 	if optStr == "" {
@@ -278,6 +372,17 @@ func obfuscateSQL(rawQuery, opts *C.char, errResult **C.char) *C.char {
 	}
 	s := C.GoString(rawQuery)
 	switch s {
+	case slowQuery:
+		running := atomic.AddInt32(&obfuscateRunning, 1)
+		for {
+			peak := atomic.LoadInt32(&obfuscateMaxRunning)
+			if running <= peak || atomic.CompareAndSwapInt32(&obfuscateMaxRunning, peak, running) {
+				break
+			}
+		}
+		time.Sleep(200 * time.Millisecond)
+		atomic.AddInt32(&obfuscateRunning, -1)
+		return (*C.char)(helpers.TrackedCString("select pg_sleep(?)"))
 	case "select * from table where id = 1":
 		obfuscatedQuery := obfuscate.ObfuscatedQuery{
 			Query: "select * from table where id = ?",
@@ -305,6 +410,8 @@ func obfuscateSQL(rawQuery, opts *C.char, errResult **C.char) *C.char {
 
 //export obfuscateSQLExecPlan
 func obfuscateSQLExecPlan(rawQuery *C.char, normalize C.bool, errResult **C.char) *C.char {
+	atomic.AddInt32(&obfuscateCalls, 1)
+
 	switch C.GoString(rawQuery) {
 	case "raw-json-plan":
 		if bool(normalize) {
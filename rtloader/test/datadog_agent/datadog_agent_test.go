@@ -8,8 +8,11 @@ package testdatadogagent
 import (
 	"fmt"
 	"os"
+	"path/filepath"
 	"regexp"
+	"runtime"
 	"strconv"
+	"sync/atomic"
 	"testing"
 
 	"github.com/DataDog/datadog-agent/rtloader/test/helpers"
@@ -74,6 +77,68 @@ func TestGetConfig(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestGetConfigJSON(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	code := fmt.Sprintf(`
+	d = datadog_agent.get_config("foo_json")
+	with open(r'%s', 'w') as f:
+		f.write("{}:{}:{}".format(d.get('name'), d.get('body'), d.get('time')))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "foo_json:Hello:123456" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestGetConfigCache(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	setConfigGeneration(1)
+	defer setConfigGeneration(0)
+	getConfigCalls = 0
+
+	code := fmt.Sprintf(`
+	d = datadog_agent.get_config("foo_json")
+	d["name"] = "mutated"
+	d = datadog_agent.get_config("foo_json")
+	l = datadog_agent.get_config("log_level")
+	l = datadog_agent.get_config("log_level")
+	with open(r'%s', 'w') as f:
+		f.write("{}:{}:{}".format(d.get('name'), d.get('body'), l))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "foo_json:Hello:warning" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if getConfigCalls != 2 {
+		t.Errorf("Expected 2 calls to the get_config callback, got %d", getConfigCalls)
+	}
+
+	// a new generation drops the cached values
+	setConfigGeneration(2)
+	if _, err := run(code); err != nil {
+		t.Fatal(err)
+	}
+	if getConfigCalls != 4 {
+		t.Errorf("Expected 4 calls to the get_config callback, got %d", getConfigCalls)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestHeaders(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -120,6 +185,43 @@ func TestGetHostname(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestGetHostnameCache(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	setConfigGeneration(1)
+	defer setConfigGeneration(0)
+	getHostnameCalls = 0
+
+	code := fmt.Sprintf(`
+	datadog_agent.get_hostname()
+	with open(r'%s', 'w') as f:
+		f.write(datadog_agent.get_hostname())
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "localfoobar" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if getHostnameCalls != 1 {
+		t.Errorf("Expected 1 call to the get_hostname callback, got %d", getHostnameCalls)
+	}
+
+	// a new generation drops the cached value
+	setConfigGeneration(2)
+	if _, err := run(code); err != nil {
+		t.Fatal(err)
+	}
+	if getHostnameCalls != 2 {
+		t.Errorf("Expected 2 calls to the get_hostname callback, got %d", getHostnameCalls)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestGetClustername(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -179,6 +281,30 @@ func TestLog(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestLogLevel(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	setLogLevel(20)
+	defer setLogLevel(0)
+
+	code := `
+	assert datadog_agent.get_log_level() == 20
+	datadog_agent.log("warning message", 30)
+	datadog_agent.log("debug message", 10)
+	`
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "[30]warning message" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestSetCheckMetadata(t *testing.T) {
 	code := `
 	datadog_agent.set_check_metadata("redis:test:12345", "version.raw", "5.0.6")
@@ -261,6 +387,33 @@ func TestSetExternalTagsUnicode(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestSetExternalTagsBatch(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	setExternalTagsBatch(true)
+	defer setExternalTagsBatch(false)
+
+	code := `
+	tags = [
+		('hostname', {'source_type': [u'tag1', 123, 'tag2']}),
+		('hostname2', {}),
+		('hostname3', {'source_type3': ['tag3', [], u'tag4']}),
+	]
+	datadog_agent.set_external_tags(tags)
+	`
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "hostname,source_type,tag1,tag2\nhostname3,source_type3,tag3,tag4" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestSetExternalTagsNotList(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -444,6 +597,56 @@ func TestReadPersistentCache(t *testing.T) {
 	}
 }
 
+func TestPersistentCacheStore(t *testing.T) {
+	if runtime.GOOS == "windows" {
+		t.Skip("the persistent cache store isn't available on Windows")
+	}
+	helpers.ResetMemoryStats()
+
+	path := filepath.Join(t.TempDir(), "cache.db")
+	if !setPersistentCacheStore(path) {
+		t.Fatal("Could not open the persistent cache store")
+	}
+
+	code := fmt.Sprintf(`
+	datadog_agent.write_persistent_cache("12345", "someothervalue")
+	view = datadog_agent.read_persistent_cache_view("12345")
+	datadog_agent.write_persistent_cache("12345", "storedvalue")
+	data = datadog_agent.read_persistent_cache("12345")
+	assert type(data) == type("")
+	with open(r'%s', 'w') as f:
+		f.write("{}:{}:{}".format(data, bytes(view).decode(), datadog_agent.read_persistent_cache("missing")))
+	del view
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	// keys missing from the store are read with the callback
+	if out != "storedvalue:someothervalue:somevalue" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// values survive the store being reopened
+	if !setPersistentCacheStore("") || !setPersistentCacheStore(path) {
+		t.Fatal("Could not reopen the persistent cache store")
+	}
+	code = fmt.Sprintf(`
+	with open(r'%s', 'w') as f:
+		f.write(bytes(datadog_agent.read_persistent_cache_view("12345")).decode())
+	`, tmpfile.Name())
+	out, err = run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "storedvalue" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	setPersistentCacheStore("")
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestObfuscateSql(t *testing.T) {
 	helpers.ResetMemoryStats()
 
@@ -541,6 +744,89 @@ func TestObfuscateSQLErrors(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestObfuscateSqlCache(t *testing.T) {
+	helpers.ResetMemoryStats()
+
+	setObfuscationCacheSize(2)
+	defer setObfuscationCacheSize(0)
+	obfuscateCalls = 0
+
+	code := fmt.Sprintf(`
+	q = "select * from table where id = 1"
+	results = [datadog_agent.obfuscate_sql(q) for _ in range(3)]
+	results.append(datadog_agent.obfuscate_sql(q, '{"replace_digits": true}'))
+	results.append(datadog_agent.obfuscate_sql_exec_plan('raw-json-plan'))
+	results.append(datadog_agent.obfuscate_sql(q))
+	with open(r'%s', 'w') as f:
+		f.write("{}:{}:{}".format(len(set(results[:3])), json.loads(results[3])['query'], results[4]))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "1:select * from table where id = ?:obfuscated" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	// the plan evicted the least recently used query
+	if obfuscateCalls != 4 {
+		t.Errorf("Expected 4 calls to the obfuscation callbacks, got %d", obfuscateCalls)
+	}
+	stats := getObfuscationCacheStats()
+	if stats.entries != 2 || stats.hits != 2 || stats.misses != 4 || stats.evictions != 2 {
+		t.Errorf("Unexpected cache stats: %+v", stats)
+	}
+
+	// errors aren't cached
+	code = `
+	for _ in range(2):
+		try:
+			datadog_agent.obfuscate_sql("")
+		except RuntimeError:
+			pass
+	`
+	if _, err := run(code); err != nil {
+		t.Fatal(err)
+	}
+	if obfuscateCalls != 6 {
+		t.Errorf("Expected 6 calls to the obfuscation callbacks, got %d", obfuscateCalls)
+	}
+
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestObfuscateSqlReleasesGIL(t *testing.T) {
+	helpers.ResetMemoryStats()
+
+	atomic.StoreInt32(&obfuscateMaxRunning, 0)
+
+	code := fmt.Sprintf(`
+	import threading
+	results = []
+	def obfuscate():
+		results.append(datadog_agent.obfuscate_sql("%s"))
+	threads = [threading.Thread(target=obfuscate) for _ in range(2)]
+	for thread in threads:
+		thread.start()
+	for thread in threads:
+		thread.join()
+	with open(r'%s', 'w') as f:
+		f.write(",".join(results))
+	`, slowQuery, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "select pg_sleep(?),select pg_sleep(?)" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	// the second thread got the GIL while the first one was in the callback
+	if peak := atomic.LoadInt32(&obfuscateMaxRunning); peak != 2 {
+		t.Errorf("Expected the obfuscations to overlap, got %d running at once", peak)
+	}
+
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestObfuscateSqlExecPlan(t *testing.T) {
 	helpers.ResetMemoryStats()
 
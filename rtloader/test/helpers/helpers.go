@@ -21,6 +21,8 @@ var (
 	Allocations = expvar.Int{}
 	// Frees tracks number of memory frees
 	Frees = expvar.Int{}
+	// Batches tracks number of calls to the batch memory tracker
+	Batches = expvar.Int{}
 )
 
 // TestMemoryTracker is the method exposed to the RTLoader for memory tracking
@@ -33,3 +35,13 @@ func TestMemoryTracker(ptr unsafe.Pointer, sz C.size_t, op C.rtloader_mem_ops_t)
 		Frees.Add(1)
 	}
 }
+
+// TestMemoryTrackerBatch is the method exposed to the RTLoader for batched memory tracking
+//
+//export TestMemoryTrackerBatch
+func TestMemoryTrackerBatch(records *C.rtloader_mem_record_t, count C.size_t) {
+	Batches.Add(1)
+	for _, r := range unsafe.Slice(records, int(count)) {
+		TestMemoryTracker(r.ptr, r.sz, r.op)
+	}
+}
@@ -22,6 +22,11 @@ void initTestMemoryTracker(void) {
 	set_memory_tracker_cb(TestMemoryTracker);
 }
 
+void TestMemoryTrackerBatch(rtloader_mem_record_t *, size_t);
+void initTestMemoryTrackerBatch(rtloader_t *rtloader, bool enabled) {
+	set_memory_tracker_batch_cb(rtloader, enabled ? TestMemoryTrackerBatch : NULL);
+}
+
 */
 import "C"
 
@@ -30,6 +35,11 @@ func InitMemoryTracker() {
 	C.initTestMemoryTracker()
 }
 
+// InitMemoryTrackerBatch enables or disables batched RTLoader memory tracking
+func InitMemoryTrackerBatch(rtloader unsafe.Pointer, enabled bool) {
+	C.initTestMemoryTrackerBatch((*C.rtloader_t)(rtloader), C.bool(enabled))
+}
+
 // TrackedCString retruns an allocation-tracked pointer to a string
 func TrackedCString(str string) unsafe.Pointer {
 	cstr := C.CString(str)
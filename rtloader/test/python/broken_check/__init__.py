@@ -0,0 +1,6 @@
+# Check failing to import, for testing purposes
+def fail():
+    raise ValueError("broken check")
+
+
+fail()
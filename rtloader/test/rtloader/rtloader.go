@@ -116,6 +116,24 @@ func getError() string {
 	return C.GoString(C.get_error(rtloader))
 }
 
+func getClassError(module string) string {
+	var pyModule *C.rtloader_pyobject_t
+	var pyClass *C.rtloader_pyobject_t
+
+	runtime.LockOSThread()
+	state := C.ensure_gil(rtloader)
+
+	moduleStr := (*C.char)(helpers.TrackedCString(module))
+	defer C._free(unsafe.Pointer(moduleStr))
+
+	C.get_class(rtloader, moduleStr, &pyModule, &pyClass)
+
+	C.release_gil(rtloader, state)
+	runtime.UnlockOSThread()
+
+	return C.GoString(C.get_error(rtloader))
+}
+
 func hasError() bool {
 	runtime.LockOSThread()
 	state := C.ensure_gil(rtloader)
@@ -345,3 +363,73 @@ func setModuleAttrString(module string, attr string, value string) {
 	C.release_gil(rtloader, state)
 	runtime.UnlockOSThread()
 }
+
+func setMemoryTrackerBatch(enabled bool) {
+	helpers.InitMemoryTrackerBatch(unsafe.Pointer(rtloader), enabled)
+}
+
+func flushMemoryTracker() {
+	C.flush_memory_tracker(rtloader)
+}
+
+// getFakeCheckClasses looks the fake check class up twice, clearing the class
+// cache in between the lookups when clearCache is set, and reports whether
+// the same class was returned both times.
+func getFakeCheckClasses(clearCache bool) (bool, error) {
+	var module, class, module2, class2 *C.rtloader_pyobject_t
+
+	runtime.LockOSThread()
+	state := C.ensure_gil(rtloader)
+	defer func() {
+		C.release_gil(rtloader, state)
+		runtime.UnlockOSThread()
+	}()
+
+	classStr := (*C.char)(helpers.TrackedCString("fake_check"))
+	defer C._free(unsafe.Pointer(classStr))
+
+	if C.get_class(rtloader, classStr, &module, &class) != 1 {
+		return false, fmt.Errorf(C.GoString(C.get_error(rtloader)))
+	}
+	defer C.rtloader_decref(rtloader, module)
+	defer C.rtloader_decref(rtloader, class)
+
+	if clearCache {
+		C.clear_class_cache(rtloader, classStr)
+	}
+
+	if C.get_class(rtloader, classStr, &module2, &class2) != 1 {
+		return false, fmt.Errorf(C.GoString(C.get_error(rtloader)))
+	}
+	defer C.rtloader_decref(rtloader, module2)
+	defer C.rtloader_decref(rtloader, class2)
+
+	return module == module2 && class == class2, nil
+}
+
+func preloadModules(modules []string) (int, string) {
+	cModules := make([]*C.char, 0, len(modules)+1)
+	for _, m := range modules {
+		cModules = append(cModules, (*C.char)(helpers.TrackedCString(m)))
+	}
+	cModules = append(cModules, nil)
+	defer func() {
+		for _, m := range cModules[:len(modules)] {
+			C._free(unsafe.Pointer(m))
+		}
+	}()
+
+	runtime.LockOSThread()
+	state := C.ensure_gil(rtloader)
+
+	failures := int(C.preload_modules(rtloader, &cModules[0]))
+	errStr := ""
+	if failures != 0 {
+		errStr = C.GoString(C.get_error(rtloader))
+	}
+
+	C.release_gil(rtloader, state)
+	runtime.UnlockOSThread()
+
+	return failures, errStr
+}
@@ -113,6 +113,31 @@ func TestGetError(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestGetErrorRepeatedTraceback(t *testing.T) {
+	if common.UsingTwo {
+		t.Skip("tracebacks are always rendered with python2")
+	}
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	errorStr := getClassError("broken_check")
+	if !strings.Contains(errorStr, "Traceback (most recent call last)") || !strings.HasSuffix(errorStr, "ValueError: broken check\n") {
+		t.Fatalf("Wrong error string returned: %s", errorStr)
+	}
+
+	// the traceback of the same error is only rendered once per interval
+	for i, times := range []string{"1 time", "2 times"} {
+		errorStr = getClassError("broken_check")
+		expected := "unable to import module 'broken_check': ValueError: broken check\n(traceback omitted, raised " + times + " at "
+		if !strings.HasPrefix(errorStr, expected) || !strings.Contains(errorStr, "broken_check/__init__.py:3 since it was last reported") {
+			t.Fatalf("Wrong error string returned for repeat %d: %s", i+1, errorStr)
+		}
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestHasError(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -143,6 +168,48 @@ func TestGetCheck(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestGetClassCache(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	for _, clearCache := range []bool{false, true} {
+		same, err := getFakeCheckClasses(clearCache)
+		if err != nil {
+			t.Fatal(err)
+		}
+		// the module isn't reloaded so the class is the same, cached or not
+		if !same {
+			t.Fatalf("expected the same class to be returned (clear cache: %v)", clearCache)
+		}
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestPreloadModules(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	failures, errStr := preloadModules([]string{"fake_check", "does_not_exist", "json", "does_not_exist_either"})
+	if failures != 2 {
+		t.Fatalf("expected 2 modules to fail to import, got %d: %s", failures, errStr)
+	}
+	for _, m := range []string{"'does_not_exist'", "'does_not_exist_either'"} {
+		if !strings.Contains(errStr, m) {
+			t.Errorf("error doesn't report module %s: %s", m, errStr)
+		}
+	}
+
+	failures, errStr = preloadModules([]string{"fake_check", "json"})
+	if failures != 0 {
+		t.Fatalf("expected every module to be imported, got %d failures: %s", failures, errStr)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestRunCheck(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -161,6 +228,35 @@ func TestRunCheck(t *testing.T) {
 	helpers.AssertMemoryUsage(t)
 }
 
+func TestRunCheckMemoryTrackerBatch(t *testing.T) {
+	setMemoryTrackerBatch(true)
+	defer setMemoryTrackerBatch(false)
+
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+	helpers.Batches.Set(0)
+
+	res, err := runFakeCheck()
+
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	if res != "" {
+		t.Fatal(res)
+	}
+
+	// records of the run are flushed before returning from run_check, the
+	// result string is freed afterwards
+	flushMemoryTracker()
+	if helpers.Batches.Value() == 0 {
+		t.Fatal("memory operations weren't reported through the batch callback")
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
 func TestGetCheckWarnings(t *testing.T) {
 	// Reset memory counters
 	helpers.ResetMemoryStats()
@@ -31,8 +31,9 @@ static void initTaggerTests(rtloader_t *rtloader) {
 import "C"
 
 var (
-	rtloader *C.rtloader_t
-	tmpfile  *os.File
+	rtloader  *C.rtloader_t
+	tmpfile   *os.File
+	tagsCalls int
 )
 
 func setUp() error {
@@ -94,9 +95,18 @@ except Exception as e:
 	return strings.TrimSpace(string(output)), err
 }
 
+func setTaggerGeneration(generation uint64) {
+	runtime.LockOSThread()
+	state := C.ensure_gil(rtloader)
+	C.set_tagger_generation(rtloader, C.ulonglong(generation))
+	C.release_gil(rtloader, state)
+	runtime.UnlockOSThread()
+}
+
 //revive:disable
 //export Tags
 func Tags(id *C.char, cardinality C.int) **C.char {
+	tagsCalls++
 	goID := C.GoString(id)
 
 	if goID != "base" {
@@ -228,3 +228,43 @@ func TestTagsErrorType(t *testing.T) {
 	// Check for leaks
 	helpers.AssertMemoryUsage(t)
 }
+
+func TestTagCache(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	setTaggerGeneration(1)
+	defer setTaggerGeneration(0)
+	tagsCalls = 0
+
+	code := fmt.Sprintf(`
+	import json
+	tags = tagger.tag("base", tagger.LOW)
+	tags.append("d")
+	tagger.tag("base", tagger.HIGH)
+	with open(r'%s', 'w') as f:
+		f.write(json.dumps(tagger.tag("base", tagger.LOW) + tagger.get_tags("base", True)))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "[\"a\", \"b\", \"c\", \"A\", \"B\", \"C\"]" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+	if tagsCalls != 2 {
+		t.Errorf("Tags should be called once per entity and cardinality, got %d calls", tagsCalls)
+	}
+
+	// a new generation invalidates the cached tags
+	setTaggerGeneration(2)
+	if _, err := run(`tagger.tag("base", tagger.LOW)`); err != nil {
+		t.Fatal(err)
+	}
+	if tagsCalls != 3 {
+		t.Errorf("Tags should be called again after a generation change, got %d calls", tagsCalls)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
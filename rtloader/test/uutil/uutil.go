@@ -21,10 +21,13 @@ import (
 #include "datadog_agent_rtloader.h"
 
 extern void getSubprocessOutput(char **, char **, char **, char **, int*, char **);
+extern void startSubprocess(char **, char **, int *, char **);
+extern void readSubprocessOutput(int, int, char **, int *, char **, int *, char **);
 
 static void init_utilTests(rtloader_t *rtloader) {
    set_cgo_free_cb(rtloader, _free);
    set_get_subprocess_output_cb(rtloader, getSubprocessOutput);
+   set_subprocess_output_stream_cbs(rtloader, startSubprocess, readSubprocessOutput);
 }
 */
 import "C"
@@ -124,3 +127,32 @@ func getSubprocessOutput(cargs **C.char, cenv **C.char, cstdout **C.char, cstder
 		*cexception = (*C.char)(helpers.TrackedCString(exception))
 	}
 }
+
+//export startSubprocess
+func startSubprocess(cargs **C.char, cenv **C.char, handle *C.int, cexception **C.char) {
+	args = charArrayToSlice(cargs)
+	env = charArrayToSlice(cenv)
+	if setException {
+		*cexception = (*C.char)(helpers.TrackedCString(exception))
+		return
+	}
+	*handle = 42
+}
+
+//export readSubprocessOutput
+func readSubprocessOutput(handle C.int, cancel C.int, chunk **C.char, chunkLen *C.int, cstderr **C.char, cretCode *C.int, cexception **C.char) {
+	if handle != 42 {
+		*cexception = (*C.char)(helpers.TrackedCString("unknown handle"))
+		return
+	}
+	if cancel == 0 && stdout != "" {
+		// hand the output over in small chunks to exercise the line splitting
+		n := min(len(stdout), 4)
+		*chunk = (*C.char)(helpers.TrackedCString(stdout[:n]))
+		*chunkLen = C.int(n)
+		stdout = stdout[n:]
+		return
+	}
+	*cstderr = (*C.char)(helpers.TrackedCString(stderr))
+	*cretCode = C.int(retCode)
+}
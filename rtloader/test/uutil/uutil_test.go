@@ -315,3 +315,70 @@ func TestGetSubprocessOutputEnv(t *testing.T) {
 	// Check for leaks
 	helpers.AssertMemoryUsage(t)
 }
+
+func TestSubprocessOutputStream(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	stdout = "first line\nsecond\nlast"
+	stderr = "warning"
+	retCode = 2
+	code := fmt.Sprintf(`
+	stream = _util.subprocess_output_stream(["ls"], env={"FOO": "BAR"})
+	lines = list(stream)
+	with open(r'%s', 'w') as f:
+		f.write(repr(lines) + " | " + stream.stderr + " | " + str(stream.returncode))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "['first line\\n', 'second\\n', 'last'] | warning | 2" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestSubprocessOutputStreamClose(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	stdout = "first line\nsecond\n"
+	code := fmt.Sprintf(`
+	stream = _util.subprocess_output_stream(["ls"])
+	line = next(stream)
+	stream.close()
+	with open(r'%s', 'w') as f:
+		f.write(line.strip() + " | " + str(list(stream)))
+	`, tmpfile.Name())
+	out, err := run(code)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "first line | []" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
+
+func TestSubprocessOutputStreamException(t *testing.T) {
+	// Reset memory counters
+	helpers.ResetMemoryStats()
+
+	setException = true
+	exception = "could not start command"
+	out, err := run(`_util.subprocess_output_stream(["ls"])`)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if out != "Exception: could not start command" {
+		t.Errorf("Unexpected printed value: '%s'", out)
+	}
+
+	// Check for leaks
+	helpers.AssertMemoryUsage(t)
+}
@@ -12,6 +12,7 @@
 #include "cgo_free.h"
 #include "containers.h"
 #include "datadog_agent.h"
+#include "free_threading.h"
 #include "kubeutil.h"
 #include "rtloader_mem.h"
 #include "stringutils.h"
@@ -19,8 +20,22 @@
 #include "util.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <sstream>
 
+#ifdef _WIN32
+#    include <windows.h>
+#else
+#    include <time.h>
+#endif
+
+// guards Three::_classCache in the free-threaded builds
+RTLOADER_MUTEX(classCacheMutex);
+// guards Three::_errorTracebacks in the free-threaded builds
+RTLOADER_MUTEX(errorTracebacksMutex);
+
 extern "C" DATADOG_AGENT_RTLOADER_API RtLoader *create(const char *python_home, const char *python_exe,
                                                        cb_memory_tracker_t memtrack_cb)
 {
@@ -32,6 +47,9 @@ extern "C" DATADOG_AGENT_RTLOADER_API void destroy(RtLoader *p)
     delete p;
 }
 
+const int Three::_tracebackIntervalSec;
+const size_t Three::_errorTracebacksMax;
+
 Three::Three(const char *python_home, const char *python_exe, cb_memory_tracker_t memtrack_cb)
     : RtLoader(memtrack_cb)
     , _pythonHome(NULL)
@@ -39,9 +57,12 @@ Three::Three(const char *python_home, const char *python_exe, cb_memory_tracker_
     , _baseClass(NULL)
     , _pythonPaths()
     , _pymallocPrev{ 0 }
-    , _pymemInuse(0)
-    , _pymemAlloc(0)
 {
+    for (size_t i = 0; i < _pymemShardsCount; i++) {
+        _pymemShards[i].inuse.store(0, std::memory_order_relaxed);
+        _pymemShards[i].alloc.store(0, std::memory_order_relaxed);
+    }
+
     initPythonHome(python_home);
 
     // If not empty, set our Python interpreter path
@@ -55,6 +76,7 @@ Three::~Three()
     // For more information on why Py_Finalize() isn't called here please
     // refer to the header file or the doxygen documentation.
     PyEval_RestoreThread(_threadState);
+    clearClassCache(NULL);
     Py_XDECREF(_baseClass);
 }
 
@@ -254,6 +276,43 @@ bool Three::getClass(const char *module, RtLoaderPyObject *&pyModule, RtLoaderPy
     PyObject *obj_module = NULL;
     PyObject *obj_class = NULL;
 
+    // Autodiscovery schedules the same checks over and over, skip the import and the
+    // `dir()` walk of `_findSubclassOf` as long as the module wasn't replaced in
+    // `sys.modules` and still exposes the same class (it could have been reloaded).
+    PyObject *cached_module = NULL;
+    PyObject *cached_class = NULL;
+    RTLOADER_LOCK(classCacheMutex);
+    std::map<std::string, std::pair<PyObject *, PyObject *> >::iterator cached = _classCache.find(module);
+    if (cached != _classCache.end()) {
+        cached_module = cached->second.first;
+        cached_class = cached->second.second;
+        Py_INCREF(cached_module);
+        Py_INCREF(cached_class);
+    }
+    RTLOADER_UNLOCK(classCacheMutex);
+
+    if (cached_module != NULL) {
+        // borrowed reference
+        PyObject *current = PyDict_GetItemString(PyImport_GetModuleDict(), module);
+        bool valid = current == cached_module;
+        if (valid) {
+            PyObject *name = PyObject_GetAttrString(cached_class, "__name__");
+            PyObject *attr = name != NULL ? PyObject_GetAttr(current, name) : NULL;
+            valid = attr == cached_class;
+            Py_XDECREF(attr);
+            Py_XDECREF(name);
+            PyErr_Clear();
+        }
+        if (valid) {
+            pyModule = reinterpret_cast<RtLoaderPyObject *>(cached_module);
+            pyClass = reinterpret_cast<RtLoaderPyObject *>(cached_class);
+            return true;
+        }
+        Py_DECREF(cached_module);
+        Py_DECREF(cached_class);
+        clearClassCache(module);
+    }
+
     obj_module = PyImport_ImportModule(module);
     if (obj_module == NULL) {
         std::ostringstream err;
@@ -272,11 +331,43 @@ bool Three::getClass(const char *module, RtLoaderPyObject *&pyModule, RtLoaderPy
         return false;
     }
 
+    // the cache holds its own references
+    Py_INCREF(obj_module);
+    Py_INCREF(obj_class);
+    clearClassCache(module);
+    RTLOADER_LOCK(classCacheMutex);
+    _classCache[module] = std::make_pair(obj_module, obj_class);
+    RTLOADER_UNLOCK(classCacheMutex);
+
     pyModule = reinterpret_cast<RtLoaderPyObject *>(obj_module);
     pyClass = reinterpret_cast<RtLoaderPyObject *>(obj_class);
     return true;
 }
 
+void Three::clearClassCache(const char *module)
+{
+    std::map<std::string, std::pair<PyObject *, PyObject *> > cleared;
+
+    // the references are released once the mutex is unlocked, as it may run finalizers
+    RTLOADER_LOCK(classCacheMutex);
+    if (module != NULL) {
+        std::map<std::string, std::pair<PyObject *, PyObject *> >::iterator it = _classCache.find(module);
+        if (it != _classCache.end()) {
+            cleared.insert(*it);
+            _classCache.erase(it);
+        }
+    } else {
+        cleared.swap(_classCache);
+    }
+    RTLOADER_UNLOCK(classCacheMutex);
+
+    std::map<std::string, std::pair<PyObject *, PyObject *> >::iterator it;
+    for (it = cleared.begin(); it != cleared.end(); ++it) {
+        Py_XDECREF(it->second.first);
+        Py_XDECREF(it->second.second);
+    }
+}
+
 bool Three::getCheck(RtLoaderPyObject *py_class, const char *init_config_str, const char *instance_str,
                      const char *check_id_str, const char *check_name, const char *agent_config_str,
                      RtLoaderPyObject *&check)
@@ -431,6 +522,70 @@ done:
     return true;
 }
 
+// CPU time consumed by the calling thread, in nanoseconds. Returns 0 when not
+// available on the platform.
+static unsigned long long threadCpuTimeNs()
+{
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    // FILETIME is expressed in 100ns intervals
+    return (k.QuadPart + u.QuadPart) * 100;
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+        return 0;
+    }
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+void Three::accountCheckRun(PyObject *py_check, const check_runtime_stats_t &run)
+{
+    char check_id_attr[] = "check_id";
+    PyObject *py_check_id = PyObject_GetAttrString(py_check, check_id_attr);
+    if (py_check_id == NULL) {
+        PyErr_Clear();
+        return;
+    }
+
+    const char *check_id = as_borrowed_utf8(py_check_id);
+    if (check_id != NULL && check_id[0] != '\0') {
+        std::lock_guard<std::mutex> lock(_checkRuntimeStatsMutex);
+        check_runtime_stats_t &stats = _checkRuntimeStats[check_id];
+        stats.runs++;
+        stats.alloc += run.alloc;
+        stats.wall_time_ns += run.wall_time_ns;
+        stats.cpu_time_ns += run.cpu_time_ns;
+    }
+    Py_XDECREF(py_check_id);
+}
+
+bool Three::popCheckRuntimeStats(const char *checkId, check_runtime_stats_t &stats)
+{
+    if (checkId == NULL) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_checkRuntimeStatsMutex);
+    std::map<std::string, check_runtime_stats_t>::iterator it = _checkRuntimeStats.find(checkId);
+    if (it == _checkRuntimeStats.end()) {
+        return false;
+    }
+    stats = it->second;
+    _checkRuntimeStats.erase(it);
+    return true;
+}
+
 char *Three::runCheck(RtLoaderPyObject *check)
 {
     if (check == NULL) {
@@ -445,7 +600,45 @@ char *Three::runCheck(RtLoaderPyObject *check)
     char run[] = "run";
     PyObject *result = NULL;
 
+    // allocations are attributed to the thread running the check, other checks
+    // running while the GIL is released account for their own threads.
+    check_runtime_stats_t usage = {};
+    size_t alloc_start = threadPymemAlloc();
+    unsigned long long cpu_start = threadCpuTimeNs();
+    std::chrono::steady_clock::time_point wall_start = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(_runningChecksMutex);
+        _runningChecks[py_check] = RunningCheck{ PyThread_get_thread_ident(), false };
+    }
+
     result = PyObject_CallMethod(py_check, run, NULL);
+
+    {
+        std::lock_guard<std::mutex> lock(_runningChecksMutex);
+        std::map<PyObject *, RunningCheck>::iterator it = _runningChecks.find(py_check);
+        if (it != _runningChecks.end()) {
+            // an interruption that came too late must not hit whatever this thread runs next
+            if (it->second.interrupted) {
+                PyThreadState_SetAsyncExc(it->second.threadId, NULL);
+            }
+            _runningChecks.erase(it);
+        }
+    }
+
+    usage.wall_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wall_start).count();
+    usage.cpu_time_ns = threadCpuTimeNs() - cpu_start;
+    usage.alloc = threadPymemAlloc() - alloc_start;
+    if (result != NULL) {
+        accountCheckRun(py_check, usage);
+    } else {
+        // failing runs are accounted for too, preserve the error for the caller
+        PyObject *ptype, *pvalue, *ptraceback;
+        PyErr_Fetch(&ptype, &pvalue, &ptraceback);
+        accountCheckRun(py_check, usage);
+        PyErr_Restore(ptype, pvalue, ptraceback);
+    }
+
     if (result == NULL || !PyUnicode_Check(result)) {
         setError("error invoking 'run' method: " + _fetchPythonError());
         goto done;
@@ -460,6 +653,8 @@ char *Three::runCheck(RtLoaderPyObject *check)
 
 done:
     Py_XDECREF(result);
+    // report the allocations of this run while the check is still accountable for them
+    _flush_thread_memory_tracker();
     return ret;
 }
 
@@ -482,6 +677,26 @@ void Three::cancelCheck(RtLoaderPyObject *check)
     Py_XDECREF(result);
 }
 
+bool Three::interruptCheck(RtLoaderPyObject *check)
+{
+    if (check == NULL) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_runningChecksMutex);
+    std::map<PyObject *, RunningCheck>::iterator it = _runningChecks.find(reinterpret_cast<PyObject *>(check));
+    if (it == _runningChecks.end() || it->second.interrupted) {
+        return false;
+    }
+
+    // the check's `run` method reports the exception like any other failure of the check
+    if (PyThreadState_SetAsyncExc(it->second.threadId, PyExc_TimeoutError) != 1) {
+        return false;
+    }
+    it->second.interrupted = true;
+    return true;
+}
+
 char **Three::getCheckWarnings(RtLoaderPyObject *check)
 {
     if (check == NULL) {
@@ -632,10 +847,10 @@ PyObject *Three::_findSubclassOf(PyObject *base, PyObject *module)
             goto done;
         }
 
-        // get symbol name, as_string returns a new object that we have to free
-        char *symbol_name = as_string(symbol);
+        // get symbol name, the string is borrowed from `symbol` and must not be freed
+        const char *symbol_name = as_borrowed_utf8(symbol);
         if (symbol_name == NULL) {
-            // as_string returns NULL if `symbol` is not a string object
+            // as_borrowed_utf8 returns NULL if `symbol` is not a string object
             // and raises TypeError. Let's clear the error and keep going.
             PyErr_Clear();
             continue;
@@ -644,7 +859,6 @@ PyObject *Three::_findSubclassOf(PyObject *base, PyObject *module)
         // get symbol instance. It's a new ref but in case of success we don't
         // DecRef since we return it and the caller will be owner
         klass = PyObject_GetAttrString(module, symbol_name);
-        ::_free(symbol_name);
         if (klass == NULL) {
             PyErr_Clear();
             continue;
@@ -703,6 +917,75 @@ done:
     return klass;
 }
 
+std::string Three::_fetchPythonErrorRepeat(PyObject *ptype, PyObject *pvalue, PyObject *ptraceback,
+                                           unsigned long long &repeats) const
+{
+    repeats = 0;
+
+    // the innermost frame is where the exception was raised
+    PyTracebackObject *tb = reinterpret_cast<PyTracebackObject *>(ptraceback);
+    while (tb->tb_next != NULL) {
+        tb = tb->tb_next;
+    }
+#if PY_VERSION_HEX >= 0x03090000
+    PyCodeObject *code = PyFrame_GetCode(tb->tb_frame);
+#else
+    PyCodeObject *code = tb->tb_frame->f_code;
+    Py_INCREF(code);
+#endif
+    const char *filename = as_borrowed_utf8(code->co_filename);
+    if (filename == NULL) {
+        Py_DECREF(code);
+        PyErr_Clear();
+        return "";
+    }
+    // recent versions compute the line number lazily
+    int lineno = tb->tb_lineno >= 0 ? tb->tb_lineno : PyCode_Addr2Line(code, tb->tb_lasti);
+    std::ostringstream where;
+    where << filename << ":" << lineno;
+    Py_DECREF(code);
+
+    const char *type_name = reinterpret_cast<PyTypeObject *>(ptype)->tp_name;
+    std::string location = std::string(type_name) + " at " + where.str();
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    RTLOADER_LOCK(errorTracebacksMutex);
+    std::map<std::string, ErrorTraceback>::iterator it = _errorTracebacks.find(location);
+    if (it == _errorTracebacks.end()) {
+        if (_errorTracebacks.size() >= _errorTracebacksMax) {
+            _errorTracebacks.clear();
+        }
+        ErrorTraceback rendering = { now, 0 };
+        _errorTracebacks[location] = rendering;
+        RTLOADER_UNLOCK(errorTracebacksMutex);
+        return "";
+    }
+    if (now - it->second.rendered >= std::chrono::seconds(_tracebackIntervalSec)) {
+        repeats = it->second.repeats;
+        it->second.rendered = now;
+        it->second.repeats = 0;
+        RTLOADER_UNLOCK(errorTracebacksMutex);
+        return "";
+    }
+    repeats = ++it->second.repeats;
+    RTLOADER_UNLOCK(errorTracebacksMutex);
+
+    // same format as the last line of the traceback
+    std::ostringstream ret_val;
+    ret_val << type_name;
+    PyObject *pvalue_obj = PyObject_Str(pvalue);
+    const char *msg = pvalue_obj != NULL ? as_borrowed_utf8(pvalue_obj) : NULL;
+    if (msg != NULL && msg[0] != '\0') {
+        ret_val << ": " << msg;
+    }
+    Py_XDECREF(pvalue_obj);
+    PyErr_Clear();
+
+    ret_val << "\n(traceback omitted, raised " << repeats << " time" << (repeats == 1 ? "" : "s") << " at "
+            << where.str() << " since it was last reported)\n";
+    return ret_val.str();
+}
+
 std::string Three::_fetchPythonError() const
 {
     std::string ret_val = "";
@@ -725,8 +1008,14 @@ std::string Three::_fetchPythonError() const
     // PyErr_NormalizeException returns void, no need to check its return value
     PyErr_NormalizeException(&ptype, &pvalue, &ptraceback);
 
-    // There's a traceback, try to format it nicely
+    // There's a traceback, try to format it nicely unless it was recently
     if (ptraceback != NULL) {
+        unsigned long long repeats = 0;
+        ret_val = _fetchPythonErrorRepeat(ptype, pvalue, ptraceback, repeats);
+        if (ret_val != "") {
+            goto done;
+        }
+
         traceback = PyImport_ImportModule("traceback");
         if (traceback != NULL) {
             char fname[] = "format_exception";
@@ -754,11 +1043,19 @@ std::string Three::_fetchPythonError() const
                             ret_val = "";
                             goto done;
                         }
-                        char *item = as_string(s);
+                        const char *item = as_borrowed_utf8(s);
+                        if (item == NULL) {
+                            continue;
+                        }
                         // traceback.format_exception returns a list of strings, each ending in a *newline*
                         // and some containing internal newlines. No need to add any CRLF/newlines.
                         ret_val += item;
-                        ::_free(item);
+                    }
+                    if (repeats > 0) {
+                        std::ostringstream omitted;
+                        omitted << "(raised " << repeats << " more time" << (repeats == 1 ? "" : "s")
+                                << " since this traceback was last reported)\n";
+                        ret_val += omitted.str();
                     }
                 }
             }
@@ -773,18 +1070,20 @@ std::string Three::_fetchPythonError() const
         PyObject *pvalue_obj = PyObject_Str(pvalue);
         if (pvalue_obj != NULL) {
             // we know pvalue_obj is a string (we just casted it), no need to PyUnicode_Check()
-            char *ret = as_string(pvalue_obj);
-            ret_val += ret;
-            ::_free(ret);
+            const char *ret = as_borrowed_utf8(pvalue_obj);
+            if (ret != NULL) {
+                ret_val += ret;
+            }
             Py_XDECREF(pvalue_obj);
         }
     } else if (ptype != NULL) {
         PyObject *ptype_obj = PyObject_Str(ptype);
         if (ptype_obj != NULL) {
             // we know ptype_obj is a string (we just casted it), no need to PyUnicode_Check()
-            char *ret = as_string(ptype_obj);
-            ret_val += ret;
-            ::_free(ret);
+            const char *ret = as_borrowed_utf8(ptype_obj);
+            if (ret != NULL) {
+                ret_val += ret;
+            }
             Py_XDECREF(ptype_obj);
         }
     }
@@ -870,6 +1169,11 @@ void Three::setSubmitMetricCb(cb_submit_metric_t cb)
     _set_submit_metric_cb(cb);
 }
 
+void Three::setSubmitMetricBatchCb(cb_submit_metric_batch_t cb)
+{
+    _set_submit_metric_batch_cb(cb);
+}
+
 void Three::setSubmitServiceCheckCb(cb_submit_service_check_t cb)
 {
     _set_submit_service_check_cb(cb);
@@ -885,11 +1189,21 @@ void Three::setSubmitHistogramBucketCb(cb_submit_histogram_bucket_t cb)
     _set_submit_histogram_bucket_cb(cb);
 }
 
+void Three::setSubmitHistogramBucketsCb(cb_submit_histogram_buckets_t cb)
+{
+    _set_submit_histogram_buckets_cb(cb);
+}
+
 void Three::setSubmitEventPlatformEventCb(cb_submit_event_platform_event_t cb)
 {
     _set_submit_event_platform_event_cb(cb);
 }
 
+void Three::setSubmitEventPlatformEventsCb(cb_submit_event_platform_events_t cb)
+{
+    _set_submit_event_platform_events_cb(cb);
+}
+
 void Three::setGetVersionCb(cb_get_version_t cb)
 {
     _set_get_version_cb(cb);
@@ -900,6 +1214,11 @@ void Three::setGetConfigCb(cb_get_config_t cb)
     _set_get_config_cb(cb);
 }
 
+void Three::setConfigGeneration(unsigned long long generation)
+{
+    _set_config_generation(generation);
+}
+
 void Three::setHeadersCb(cb_headers_t cb)
 {
     _set_headers_cb(cb);
@@ -925,6 +1244,11 @@ void Three::setLogCb(cb_log_t cb)
     _set_log_cb(cb);
 }
 
+void Three::setLogLevel(int log_level)
+{
+    _set_log_level(log_level);
+}
+
 void Three::setSetCheckMetadataCb(cb_set_check_metadata_t cb)
 {
     _set_set_check_metadata_cb(cb);
@@ -935,21 +1259,46 @@ void Three::setSetExternalTagsCb(cb_set_external_tags_t cb)
     _set_set_external_tags_cb(cb);
 }
 
+void Three::setSetExternalTagsBatchCb(cb_set_external_tags_batch_t cb)
+{
+    _set_set_external_tags_batch_cb(cb);
+}
+
 void Three::setSubprocessOutputCb(cb_get_subprocess_output_t cb)
 {
     _set_get_subprocess_output_cb(cb);
 }
 
+void Three::setSubprocessOutputStreamCbs(cb_start_subprocess_t start, cb_read_subprocess_output_t read)
+{
+    _set_subprocess_output_stream_cbs(start, read);
+}
+
 void Three::setCGOFreeCb(cb_cgo_free_t cb)
 {
     _set_cgo_free_cb(cb);
 }
 
+void Three::setMemoryTrackerBatchCb(cb_memory_tracker_batch_t cb)
+{
+    _set_memory_tracker_batch_cb(cb);
+}
+
+void Three::flushMemoryTracker()
+{
+    _flush_memory_tracker();
+}
+
 void Three::setTagsCb(cb_tags_t cb)
 {
     _set_tags_cb(cb);
 }
 
+void Three::setTaggerGeneration(unsigned long long generation)
+{
+    _set_tagger_generation(generation);
+}
+
 void Three::setGetConnectionInfoCb(cb_get_connection_info_t cb)
 {
     _set_get_connection_info_cb(cb);
@@ -960,6 +1309,11 @@ void Three::setIsExcludedCb(cb_is_excluded_t cb)
     _set_is_excluded_cb(cb);
 }
 
+void Three::setIsExcludedManyCb(cb_is_excluded_many_t cb)
+{
+    _set_is_excluded_many_cb(cb);
+}
+
 void Three::setWritePersistentCacheCb(cb_write_persistent_cache_t cb)
 {
     _set_write_persistent_cache_cb(cb);
@@ -970,6 +1324,15 @@ void Three::setReadPersistentCacheCb(cb_read_persistent_cache_t cb)
     _set_read_persistent_cache_cb(cb);
 }
 
+bool Three::setPersistentCacheStore(const char *path)
+{
+    if (!_set_persistent_cache_store(path)) {
+        setError(std::string("could not open the persistent cache store: ") + strerror(errno));
+        return false;
+    }
+    return true;
+}
+
 void Three::setObfuscateSqlCb(cb_obfuscate_sql_t cb)
 {
     _set_obfuscate_sql_cb(cb);
@@ -980,6 +1343,16 @@ void Three::setObfuscateSqlExecPlanCb(cb_obfuscate_sql_exec_plan_t cb)
     _set_obfuscate_sql_exec_plan_cb(cb);
 }
 
+void Three::setObfuscationCacheSize(size_t size)
+{
+    _set_obfuscation_cache_size(size);
+}
+
+void Three::getObfuscationCacheStats(obfuscation_cache_stats_t &stats)
+{
+    _get_obfuscation_cache_stats(&stats);
+}
+
 void Three::setGetProcessStartTimeCb(cb_get_process_start_time_t cb)
 {
     _set_get_process_start_time_cb(cb);
@@ -1048,6 +1421,36 @@ done:
     return wheels;
 }
 
+// preloadModules imports the given modules, reporting every failure at once.
+int Three::preloadModules(const char **modules)
+{
+    if (modules == NULL) {
+        return 0;
+    }
+
+    std::ostringstream err;
+    int failures = 0;
+
+    // keep importing after a failure so that every error can be reported at once
+    for (const char **module = modules; *module != NULL; module++) {
+        PyObject *obj_module = PyImport_ImportModule(*module);
+        if (obj_module == NULL) {
+            if (failures > 0) {
+                err << "; ";
+            }
+            err << "unable to import module '" << *module << "': " << _fetchPythonError();
+            failures++;
+            continue;
+        }
+        Py_XDECREF(obj_module);
+    }
+
+    if (failures > 0) {
+        setError(err.str());
+    }
+    return failures;
+}
+
 // getInterpreterMemoryUsage return a dict with the python interpreters memory
 // usage snapshot. The returned dict must be freed by calling....
 char *Three::getInterpreterMemoryUsage()
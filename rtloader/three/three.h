@@ -14,6 +14,7 @@
 #endif
 
 #include <atomic>
+#include <chrono>
 #include <map>
 #include <mutex>
 #include <string>
@@ -63,6 +64,7 @@ public:
     void GILRelease(rtloader_gilstate_t);
 
     bool getClass(const char *module, RtLoaderPyObject *&pyModule, RtLoaderPyObject *&pyClass);
+    void clearClassCache(const char *module);
     bool getAttrString(RtLoaderPyObject *obj, const char *attributeName, char *&value) const;
     bool getCheck(RtLoaderPyObject *py_class, const char *init_config_str, const char *instance_str,
                   const char *check_id_str, const char *check_name, const char *agent_config_str,
@@ -70,6 +72,7 @@ public:
 
     char *runCheck(RtLoaderPyObject *check);
     void cancelCheck(RtLoaderPyObject *check);
+    bool interruptCheck(RtLoaderPyObject *check);
     char **getCheckWarnings(RtLoaderPyObject *check);
     char *getCheckDiagnoses(RtLoaderPyObject *check);
     void decref(RtLoaderPyObject *obj);
@@ -87,49 +90,65 @@ public:
 
     // Python Helpers
     char *getIntegrationList();
+    int preloadModules(const char **modules);
     char *getInterpreterMemoryUsage();
 
     // aggregator API
     void setSubmitMetricCb(cb_submit_metric_t);
+    void setSubmitMetricBatchCb(cb_submit_metric_batch_t);
     void setSubmitServiceCheckCb(cb_submit_service_check_t);
     void setSubmitEventCb(cb_submit_event_t);
     void setSubmitHistogramBucketCb(cb_submit_histogram_bucket_t);
+    void setSubmitHistogramBucketsCb(cb_submit_histogram_buckets_t);
     void setSubmitEventPlatformEventCb(cb_submit_event_platform_event_t);
+    void setSubmitEventPlatformEventsCb(cb_submit_event_platform_events_t);
 
     // datadog_agent API
     void setGetVersionCb(cb_get_version_t);
     void setGetConfigCb(cb_get_config_t);
+    void setConfigGeneration(unsigned long long);
     void setHeadersCb(cb_headers_t);
     void setGetHostnameCb(cb_get_hostname_t);
     void setGetClusternameCb(cb_get_clustername_t);
     void setGetTracemallocEnabledCb(cb_tracemalloc_enabled_t);
     void setLogCb(cb_log_t);
+    void setLogLevel(int);
     void setSetCheckMetadataCb(cb_set_check_metadata_t);
     void setSetExternalTagsCb(cb_set_external_tags_t);
+    void setSetExternalTagsBatchCb(cb_set_external_tags_batch_t);
     void setWritePersistentCacheCb(cb_write_persistent_cache_t);
     void setReadPersistentCacheCb(cb_read_persistent_cache_t);
+    bool setPersistentCacheStore(const char *path);
     void setObfuscateSqlCb(cb_obfuscate_sql_t);
     void setObfuscateSqlExecPlanCb(cb_obfuscate_sql_exec_plan_t);
+    void setObfuscationCacheSize(size_t);
+    void getObfuscationCacheStats(obfuscation_cache_stats_t &);
     void setGetProcessStartTimeCb(cb_get_process_start_time_t);
     void setObfuscateMongoDBStringCb(cb_obfuscate_mongodb_string_t);
 
     void initPymemStats();
     void getPymemStats(pymem_stats_t &);
+    bool popCheckRuntimeStats(const char *checkId, check_runtime_stats_t &stats);
 
     // _util API
     virtual void setSubprocessOutputCb(cb_get_subprocess_output_t);
+    virtual void setSubprocessOutputStreamCbs(cb_start_subprocess_t, cb_read_subprocess_output_t);
 
     // CGO API
     void setCGOFreeCb(cb_cgo_free_t);
+    void setMemoryTrackerBatchCb(cb_memory_tracker_batch_t);
+    void flushMemoryTracker();
 
     // tagger
     void setTagsCb(cb_tags_t);
+    void setTaggerGeneration(unsigned long long);
 
     // kubeutil
     void setGetConnectionInfoCb(cb_get_connection_info_t);
 
     // containers
     void setIsExcludedCb(cb_is_excluded_t);
+    void setIsExcludedManyCb(cb_is_excluded_many_t);
 
 private:
     //! initPythonHome member.
@@ -181,6 +200,30 @@ private:
     */
     std::string _fetchPythonError() const;
 
+    //! _fetchPythonErrorRepeat member.
+    /*!
+      \brief Checks whether the traceback of an error raised from the same location was
+      rendered recently.
+      \param ptype The normalized exception type.
+      \param pvalue The normalized exception value.
+      \param ptraceback The exception traceback.
+      \param repeats Set to the number of times the error was raised since its traceback was
+      last rendered.
+      \return The short description of the error when its traceback was rendered less than
+      `_tracebackInterval` ago, an empty string when the traceback should be rendered.
+    */
+    std::string _fetchPythonErrorRepeat(PyObject *ptype, PyObject *pvalue, PyObject *ptraceback,
+                                        unsigned long long &repeats) const;
+
+    //! ErrorTraceback struct.
+    /*!
+      \brief Last rendering of the traceback of the errors raised from a code location.
+    */
+    struct ErrorTraceback {
+        std::chrono::steady_clock::time_point rendered; //!< When the traceback was rendered.
+        unsigned long long repeats; //!< Errors raised since then, their traceback was omitted.
+    };
+
     /*! PyPaths type prototype
       \typedef PyPaths defines a vector of strings.
     */
@@ -189,8 +232,15 @@ private:
     wchar_t *_pythonHome; /*!< unicode string with the PYTHONHOME for the underlying interpreter */
     wchar_t *_pythonExe; /*!< unicode string with the path to the executable of the underlying interpreter */
     PyObject *_baseClass; /*!< PyObject * pointer to the base Agent check class */
+    //! Module name to the (module, check class) references found by getClass.
+    std::map<std::string, std::pair<PyObject *, PyObject *> > _classCache;
     PyPaths _pythonPaths; /*!< string vector containing paths in the PYTHONPATH */
     PyThreadState *_threadState; /*!< PyThreadState * pointer to the saved Python interpreter thread state */
+    //! Traceback renderings keyed by exception type and code location, guarded by the GIL or,
+    //! in the free-threaded builds, by a mutex.
+    mutable std::map<std::string, ErrorTraceback> _errorTracebacks;
+    static const int _tracebackIntervalSec = 300; //!< Minimum delay between two renderings of a traceback.
+    static const size_t _errorTracebacksMax = 1024; //!< Maximum number of code locations tracked.
 
     //! pymallocAlloc member.
     /*!
@@ -280,9 +330,57 @@ private:
     */
     static void pyrawFreeCb(void *ctx, void *ptr);
 
+    //! threadPymemAlloc static member.
+    /*!
+      \brief Total number of bytes allocated by the python allocators from the calling thread.
+    */
+    static size_t threadPymemAlloc();
+
+    //! accountCheckRun member.
+    /*!
+      \brief Adds the resources used by a check run to its runtime stats.
+      \param py_check The check instance that ran.
+      \param run The resources used by the run, `runs` is ignored.
+    */
+    void accountCheckRun(PyObject *py_check, const check_runtime_stats_t &run);
+
+    std::map<std::string, check_runtime_stats_t> _checkRuntimeStats; //!< Runtime stats per check ID.
+    std::mutex _checkRuntimeStatsMutex; //!< Guards _checkRuntimeStats.
+
+    //! RunningCheck struct.
+    /*!
+      \brief A check instance being run by runCheck.
+    */
+    struct RunningCheck {
+        unsigned long threadId; //!< Identifier of the thread running the check.
+        bool interrupted; //!< Whether interruptCheck raised an exception in that thread.
+    };
+    std::map<PyObject *, RunningCheck> _runningChecks; //!< Checks currently running, per instance.
+    std::mutex _runningChecksMutex; //!< Guards _runningChecks.
+
     PyObjectArenaAllocator _pymallocPrev; //!< Previous value of the global python arena allocator backend.
-    std::atomic_size_t _pymemInuse; //!< Number of bytes currently allocated.
-    std::atomic_size_t _pymemAlloc; //!< Total number of bytes allocated  since the start of the process.
+    //! PymemShard struct.
+    /*!
+      \brief Allocation counters updated by a subset of the threads, see pymemShard.
+
+      Shards are aligned to a cache line so that threads updating different shards don't
+      contend on the same line.
+    */
+    struct alignas(64) PymemShard {
+        std::atomic_size_t inuse; //!< Number of bytes currently allocated, may wrap if freed from another shard.
+        std::atomic_size_t alloc; //!< Total number of bytes allocated since the start of the process.
+    };
+
+    //! pymemShard member.
+    /*!
+      \brief Returns the allocation counters shard of the calling thread.
+    */
+    PymemShard &pymemShard();
+
+    static const size_t _pymemShardsCount = 32; //!< Number of allocation counters shards.
+    //! Allocation counters, aggregated by getPymemStats. Static since the alignment of the
+    //! members of a `new`ed object isn't honored before C++17.
+    static PymemShard _pymemShards[_pymemShardsCount];
 };
 
 #endif
@@ -23,6 +23,15 @@
 #    include <malloc/malloc.h>
 #endif
 
+// Bytes allocated by the current thread, used to attribute allocations to the
+// check running on it.
+static thread_local size_t _threadPymemAlloc = 0;
+
+size_t Three::threadPymemAlloc()
+{
+    return _threadPymemAlloc;
+}
+
 void Three::initPymemStats()
 {
     PyObject_GetArenaAllocator(&_pymallocPrev);
@@ -43,10 +52,28 @@ void Three::initPymemStats()
     PyMem_SetAllocator(PYMEM_DOMAIN_RAW, &alloc_raw);
 }
 
+Three::PymemShard Three::_pymemShards[Three::_pymemShardsCount];
+
+// Counters are sharded by thread and only aggregated when the stats are read,
+// allocating threads thus don't contend on a single atomic. The stats don't
+// need to be a consistent snapshot, relaxed ordering is enough.
+Three::PymemShard &Three::pymemShard()
+{
+    static std::atomic_size_t nextShard(0);
+    static thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % _pymemShardsCount;
+    return _pymemShards[shard];
+}
+
 void Three::getPymemStats(pymem_stats_t &s)
 {
-    s.inuse = _pymemInuse;
-    s.alloc = _pymemAlloc;
+    s.inuse = 0;
+    s.alloc = 0;
+    for (size_t i = 0; i < _pymemShardsCount; i++) {
+        // inuse of a single shard wraps around when memory gets freed by another
+        // thread, unsigned arithmetic makes the sum correct regardless.
+        s.inuse += _pymemShards[i].inuse.load(std::memory_order_relaxed);
+        s.alloc += _pymemShards[i].alloc.load(std::memory_order_relaxed);
+    }
 }
 
 // Tracking allocations by Pymalloc. Pymalloc is the optimized
@@ -59,8 +86,10 @@ void *Three::pymallocAlloc(size_t size)
 {
     void *ptr = _pymallocPrev.alloc(_pymallocPrev.ctx, size);
     if (ptr != NULL) {
-        _pymemInuse += size;
-        _pymemAlloc += size;
+        PymemShard &shard = pymemShard();
+        shard.inuse.fetch_add(size, std::memory_order_relaxed);
+        shard.alloc.fetch_add(size, std::memory_order_relaxed);
+        _threadPymemAlloc += size;
     }
     return ptr;
 }
@@ -68,7 +97,7 @@ void *Three::pymallocAlloc(size_t size)
 void Three::pymallocFree(void *ptr, size_t size)
 {
     _pymallocPrev.free(_pymallocPrev.ctx, ptr, size);
-    _pymemInuse -= size;
+    pymemShard().inuse.fetch_sub(size, std::memory_order_relaxed);
 }
 
 void *Three::pymallocAllocCb(void *ctx, size_t size)
@@ -110,8 +139,10 @@ void Three::pyrawTrackAlloc(void *ptr)
         return;
     }
     size_t size = pyrawAllocSize(ptr);
-    _pymemInuse += size;
-    _pymemAlloc += size;
+    PymemShard &shard = pymemShard();
+    shard.inuse.fetch_add(size, std::memory_order_relaxed);
+    shard.alloc.fetch_add(size, std::memory_order_relaxed);
+    _threadPymemAlloc += size;
 }
 
 void Three::pyrawTrackFree(void *ptr)
@@ -120,7 +151,7 @@ void Three::pyrawTrackFree(void *ptr)
         return;
     }
     size_t size = pyrawAllocSize(ptr);
-    _pymemInuse -= size;
+    pymemShard().inuse.fetch_sub(size, std::memory_order_relaxed);
 }
 
 void *Three::pyrawMalloc(size_t size)
@@ -20,7 +20,9 @@
 #include "util.h"
 
 #include <algorithm>
+#include <cerrno>
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 
 extern "C" DATADOG_AGENT_RTLOADER_API RtLoader *create(const char *python_home, const char *python_exe,
@@ -453,6 +455,8 @@ char *Two::runCheck(RtLoaderPyObject *check)
 
 done:
     Py_XDECREF(result);
+    // report the allocations of this run while the check is still accountable for them
+    _flush_thread_memory_tracker();
     return ret_copy;
 }
 
@@ -868,6 +872,11 @@ void Two::setSubmitMetricCb(cb_submit_metric_t cb)
     _set_submit_metric_cb(cb);
 }
 
+void Two::setSubmitMetricBatchCb(cb_submit_metric_batch_t cb)
+{
+    _set_submit_metric_batch_cb(cb);
+}
+
 void Two::setSubmitServiceCheckCb(cb_submit_service_check_t cb)
 {
     _set_submit_service_check_cb(cb);
@@ -883,11 +892,21 @@ void Two::setSubmitHistogramBucketCb(cb_submit_histogram_bucket_t cb)
     _set_submit_histogram_bucket_cb(cb);
 }
 
+void Two::setSubmitHistogramBucketsCb(cb_submit_histogram_buckets_t cb)
+{
+    _set_submit_histogram_buckets_cb(cb);
+}
+
 void Two::setSubmitEventPlatformEventCb(cb_submit_event_platform_event_t cb)
 {
     _set_submit_event_platform_event_cb(cb);
 }
 
+void Two::setSubmitEventPlatformEventsCb(cb_submit_event_platform_events_t cb)
+{
+    _set_submit_event_platform_events_cb(cb);
+}
+
 void Two::setGetVersionCb(cb_get_version_t cb)
 {
     _set_get_version_cb(cb);
@@ -898,6 +917,11 @@ void Two::setGetConfigCb(cb_get_config_t cb)
     _set_get_config_cb(cb);
 }
 
+void Two::setConfigGeneration(unsigned long long generation)
+{
+    _set_config_generation(generation);
+}
+
 void Two::setHeadersCb(cb_headers_t cb)
 {
     _set_headers_cb(cb);
@@ -923,6 +947,11 @@ void Two::setLogCb(cb_log_t cb)
     _set_log_cb(cb);
 }
 
+void Two::setLogLevel(int log_level)
+{
+    _set_log_level(log_level);
+}
+
 void Two::setSetCheckMetadataCb(cb_set_check_metadata_t cb)
 {
     _set_set_check_metadata_cb(cb);
@@ -933,21 +962,46 @@ void Two::setSetExternalTagsCb(cb_set_external_tags_t cb)
     _set_set_external_tags_cb(cb);
 }
 
+void Two::setSetExternalTagsBatchCb(cb_set_external_tags_batch_t cb)
+{
+    _set_set_external_tags_batch_cb(cb);
+}
+
 void Two::setSubprocessOutputCb(cb_get_subprocess_output_t cb)
 {
     _set_get_subprocess_output_cb(cb);
 }
 
+void Two::setSubprocessOutputStreamCbs(cb_start_subprocess_t start, cb_read_subprocess_output_t read)
+{
+    _set_subprocess_output_stream_cbs(start, read);
+}
+
 void Two::setCGOFreeCb(cb_cgo_free_t cb)
 {
     _set_cgo_free_cb(cb);
 }
 
+void Two::setMemoryTrackerBatchCb(cb_memory_tracker_batch_t cb)
+{
+    _set_memory_tracker_batch_cb(cb);
+}
+
+void Two::flushMemoryTracker()
+{
+    _flush_memory_tracker();
+}
+
 void Two::setTagsCb(cb_tags_t cb)
 {
     _set_tags_cb(cb);
 }
 
+void Two::setTaggerGeneration(unsigned long long generation)
+{
+    _set_tagger_generation(generation);
+}
+
 void Two::setGetConnectionInfoCb(cb_get_connection_info_t cb)
 {
     _set_get_connection_info_cb(cb);
@@ -958,6 +1012,11 @@ void Two::setIsExcludedCb(cb_is_excluded_t cb)
     _set_is_excluded_cb(cb);
 }
 
+void Two::setIsExcludedManyCb(cb_is_excluded_many_t cb)
+{
+    _set_is_excluded_many_cb(cb);
+}
+
 void Two::setWritePersistentCacheCb(cb_write_persistent_cache_t cb)
 {
     _set_write_persistent_cache_cb(cb);
@@ -968,6 +1027,15 @@ void Two::setReadPersistentCacheCb(cb_read_persistent_cache_t cb)
     _set_read_persistent_cache_cb(cb);
 }
 
+bool Two::setPersistentCacheStore(const char *path)
+{
+    if (!_set_persistent_cache_store(path)) {
+        setError(std::string("could not open the persistent cache store: ") + strerror(errno));
+        return false;
+    }
+    return true;
+}
+
 void Two::setObfuscateSqlCb(cb_obfuscate_sql_t cb)
 {
     _set_obfuscate_sql_cb(cb);
@@ -978,6 +1046,16 @@ void Two::setObfuscateSqlExecPlanCb(cb_obfuscate_sql_exec_plan_t cb)
     _set_obfuscate_sql_exec_plan_cb(cb);
 }
 
+void Two::setObfuscationCacheSize(size_t size)
+{
+    _set_obfuscation_cache_size(size);
+}
+
+void Two::getObfuscationCacheStats(obfuscation_cache_stats_t &stats)
+{
+    _get_obfuscation_cache_stats(&stats);
+}
+
 void Two::setGetProcessStartTimeCb(cb_get_process_start_time_t cb)
 {
     _set_get_process_start_time_cb(cb);
@@ -1046,6 +1124,36 @@ done:
     return wheels;
 }
 
+// preloadModules imports the given modules, reporting every failure at once.
+int Two::preloadModules(const char **modules)
+{
+    if (modules == NULL) {
+        return 0;
+    }
+
+    std::ostringstream err;
+    int failures = 0;
+
+    // keep importing after a failure so that every error can be reported at once
+    for (const char **module = modules; *module != NULL; module++) {
+        PyObject *obj_module = PyImport_ImportModule(*module);
+        if (obj_module == NULL) {
+            if (failures > 0) {
+                err << "; ";
+            }
+            err << "unable to import module '" << *module << "': " << _fetchPythonError();
+            failures++;
+            continue;
+        }
+        Py_XDECREF(obj_module);
+    }
+
+    if (failures > 0) {
+        setError(err.str());
+    }
+    return failures;
+}
+
 // getInterpreterMemoryUsage return a dict with the python interpreters memory
 // usage snapshot. The returned dict must be freed by calling....
 char *Two::getInterpreterMemoryUsage()
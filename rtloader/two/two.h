@@ -85,46 +85,61 @@ public:
 
     // Python Helpers
     char *getIntegrationList();
+    int preloadModules(const char **modules);
     char *getInterpreterMemoryUsage();
 
     // aggregator API
     void setSubmitMetricCb(cb_submit_metric_t);
+    void setSubmitMetricBatchCb(cb_submit_metric_batch_t);
     void setSubmitServiceCheckCb(cb_submit_service_check_t);
     void setSubmitEventCb(cb_submit_event_t);
     void setSubmitHistogramBucketCb(cb_submit_histogram_bucket_t);
+    void setSubmitHistogramBucketsCb(cb_submit_histogram_buckets_t);
     void setSubmitEventPlatformEventCb(cb_submit_event_platform_event_t);
+    void setSubmitEventPlatformEventsCb(cb_submit_event_platform_events_t);
 
     // datadog_agent API
     void setGetVersionCb(cb_get_version_t);
     void setGetConfigCb(cb_get_config_t);
+    void setConfigGeneration(unsigned long long);
     void setHeadersCb(cb_headers_t);
     void setGetHostnameCb(cb_get_hostname_t);
     void setGetClusternameCb(cb_get_clustername_t);
     void setGetTracemallocEnabledCb(cb_tracemalloc_enabled_t);
     void setLogCb(cb_log_t);
+    void setLogLevel(int);
     void setSetCheckMetadataCb(cb_set_check_metadata_t);
     void setSetExternalTagsCb(cb_set_external_tags_t);
+    void setSetExternalTagsBatchCb(cb_set_external_tags_batch_t);
     void setWritePersistentCacheCb(cb_write_persistent_cache_t);
     void setReadPersistentCacheCb(cb_read_persistent_cache_t);
+    bool setPersistentCacheStore(const char *path);
     void setObfuscateSqlCb(cb_obfuscate_sql_t);
     void setObfuscateSqlExecPlanCb(cb_obfuscate_sql_exec_plan_t);
+    void setObfuscationCacheSize(size_t);
+    void getObfuscationCacheStats(obfuscation_cache_stats_t &);
     void setGetProcessStartTimeCb(cb_get_process_start_time_t);
     void setObfuscateMongoDBStringCb(cb_obfuscate_mongodb_string_t);
 
     // _util API
     virtual void setSubprocessOutputCb(cb_get_subprocess_output_t);
+    virtual void setSubprocessOutputStreamCbs(cb_start_subprocess_t, cb_read_subprocess_output_t);
 
     // CGO API
     void setCGOFreeCb(cb_cgo_free_t);
+    void setMemoryTrackerBatchCb(cb_memory_tracker_batch_t);
+    void flushMemoryTracker();
 
     // tagger
     void setTagsCb(cb_tags_t);
+    void setTaggerGeneration(unsigned long long);
 
     // kubeutil
     void setGetConnectionInfoCb(cb_get_connection_info_t);
 
     // containers
     void setIsExcludedCb(cb_is_excluded_t);
+    void setIsExcludedManyCb(cb_is_excluded_many_t);
 
 private:
     //! initPythonHome member.
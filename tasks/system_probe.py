@@ -422,6 +422,18 @@ def ninja_cgo_type_files(nw):
             "pkg/network/protocols/postgres/types.go": [
                 "pkg/network/ebpf/c/protocols/postgres/types.h",
             ],
+            "pkg/network/protocols/redis/types.go": [
+                "pkg/network/ebpf/c/protocols/redis/types.h",
+            ],
+            "pkg/network/protocols/amqp/types.go": [
+                "pkg/network/ebpf/c/protocols/amqp/types.h",
+            ],
+            "pkg/network/protocols/mysql/types.go": [
+                "pkg/network/ebpf/c/protocols/mysql/types.h",
+            ],
+            "pkg/network/protocols/mongo/types.go": [
+                "pkg/network/ebpf/c/protocols/mongo/types.h",
+            ],
             "pkg/ebpf/telemetry/types.go": [
                 "pkg/ebpf/c/telemetry_types.h",
             ],